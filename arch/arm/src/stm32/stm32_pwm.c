@@ -4378,6 +4378,12 @@ static int pwm_start(struct pwm_lowerhalf_s *dev,
 #ifdef CONFIG_PWM_MULTICHAN
       int i;
 
+      /* Hold the update event while the preload registers are written so
+       * that the new duties of all channels take effect in the same period.
+       */
+
+      pwm_modifyreg(priv, STM32_GTIM_CR1_OFFSET, 0, GTIM_CR1_UDIS);
+
       for (i = 0; ret == OK && i < CONFIG_PWM_NCHANNELS; i++)
         {
           /* Break the loop if all following channels are not configured */
@@ -4395,6 +4401,8 @@ static int pwm_start(struct pwm_lowerhalf_s *dev,
                                     info->channels[i].duty);
             }
         }
+
+      pwm_modifyreg(priv, STM32_GTIM_CR1_OFFSET, GTIM_CR1_UDIS, 0);
 #else
       ret = pwm_duty_update(dev, priv->channels[0].channel, info->duty);
 #endif /* CONFIG_PWM_MULTICHAN */
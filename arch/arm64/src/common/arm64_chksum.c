@@ -0,0 +1,126 @@
+/****************************************************************************
+ * arch/arm64/src/common/arm64_chksum.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <arm_neon.h>
+
+#include <nuttx/arch.h>
+
+#ifdef CONFIG_ARCH_HAVE_NET_CHKSUM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each 32-byte step adds at most 2 * 0xffff to every 32-bit lane, flush
+ * the lanes into the 64-bit accumulator before they can overflow.
+ */
+
+#define CHKSUM_BLOCK_STEPS  0x8000
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_chksum_partial
+ *
+ * Description:
+ *   Return the one's complement sum of the 16-bit words of a buffer using
+ *   the Advanced SIMD unit.  32 bytes are loaded per step and pairwise
+ *   added into 32-bit lanes, which are widened into 64-bit lanes once per
+ *   block.  The tail is summed with scalar loads.
+ *
+ * Input Parameters:
+ *   data - The start of the buffer
+ *   len  - The length of the buffer in bytes
+ *
+ * Returned Value:
+ *   The unfolded one's complement sum of the buffer.
+ *
+ ****************************************************************************/
+
+uint32_t up_chksum_partial(FAR const void *data, size_t len)
+{
+  FAR const uint8_t *ptr = data;
+  uint64x2_t acc64 = vdupq_n_u64(0);
+  uint64_t sum;
+  uint16_t half;
+
+  while (len >= 32)
+    {
+      uint32x4_t acc0 = vdupq_n_u32(0);
+      uint32x4_t acc1 = vdupq_n_u32(0);
+      size_t steps = len / 32;
+
+      if (steps > CHKSUM_BLOCK_STEPS)
+        {
+          steps = CHKSUM_BLOCK_STEPS;
+        }
+
+      len -= steps * 32;
+
+      /* Two independent accumulators hide the latency of vpadalq */
+
+      while (steps-- > 0)
+        {
+          acc0 = vpadalq_u16(acc0, vreinterpretq_u16_u8(vld1q_u8(ptr)));
+          acc1 = vpadalq_u16(acc1,
+                             vreinterpretq_u16_u8(vld1q_u8(ptr + 16)));
+          ptr += 32;
+        }
+
+      acc64 = vpadalq_u32(acc64, acc0);
+      acc64 = vpadalq_u32(acc64, acc1);
+    }
+
+  sum = vgetq_lane_u64(acc64, 0) + vgetq_lane_u64(acc64, 1);
+
+  while (len >= 2)
+    {
+      memcpy(&half, ptr, sizeof(half));
+      sum += half;
+      ptr += 2;
+      len -= 2;
+    }
+
+  /* A trailing odd byte is the low byte of a little endian word */
+
+  if (len > 0)
+    {
+      sum += *ptr;
+    }
+
+  sum = (sum & 0xffffffff) + (sum >> 32);
+  sum = (sum & 0xffffffff) + (sum >> 32);
+
+  return (uint32_t)sum;
+}
+
+#endif /* CONFIG_ARCH_HAVE_NET_CHKSUM */
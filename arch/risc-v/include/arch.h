@@ -97,6 +97,12 @@ struct arch_addrenv_s
   uintptr_t heapvbase;
   size_t    heapsize;
 
+  /* The size of the .text mapped from another address environment, these
+   * pages are not freed with this one.
+   */
+
+  size_t    textshared;
+
   /* The page directory root (satp) value */
 
   uintptr_t satp;
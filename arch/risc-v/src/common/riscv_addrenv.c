@@ -315,6 +315,121 @@ static int create_region(arch_addrenv_t *addrenv, uintptr_t vaddr,
   return npages;
 }
 
+/****************************************************************************
+ * Name: reserve_region
+ *
+ * Description:
+ *   Allocate the final level page tables of a region, but no memory.  The
+ *   pages are allocated on page faults by riscv_fillheap().
+ *
+ * Input Parameters:
+ *   addrenv - Describes the address environment
+ *   vaddr - Base virtual address for the mapping
+ *   size - Size of the region in bytes
+ *
+ * Returned value:
+ *   Amount of pages reserved on success; a negated errno value on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HEAP_DEMAND_ZERO
+static int reserve_region(arch_addrenv_t *addrenv, uintptr_t vaddr,
+                          size_t size)
+{
+  uintptr_t vend   = vaddr + size;
+  size_t    pgsize = mmu_get_region_size(ARCH_SPGTS);
+
+  /* Create mappings for the lower level tables */
+
+  map_spgtables(addrenv, vaddr);
+
+  for (vaddr &= ~(pgsize - 1); vaddr < vend; vaddr += pgsize)
+    {
+      if (!riscv_get_pgtable(addrenv, vaddr))
+        {
+          return -ENOMEM;
+        }
+    }
+
+  return MM_NPAGES(size);
+}
+#endif
+
+/****************************************************************************
+ * Name: share_region
+ *
+ * Description:
+ *   Map a region of another address environment to the same physical
+ *   memory in this one.  Only the page tables are allocated.
+ *
+ * Input Parameters:
+ *   addrenv - Describes the address environment
+ *   src - The address environment that owns the physical memory
+ *   vaddr - Base virtual address for the mapping
+ *   size - Size of the region in bytes
+ *   mmuflags - MMU flags to use
+ *
+ * Returned value:
+ *   Amount of pages mapped on success; a negated errno value on failure
+ *
+ ****************************************************************************/
+
+static int share_region(arch_addrenv_t *addrenv, arch_addrenv_t *src,
+                        uintptr_t vaddr, size_t size, uint64_t mmuflags)
+{
+  uintptr_t ptlast;
+  uintptr_t ptprev;
+  uintptr_t paddr;
+  uint32_t  ptlevel;
+  int       npages;
+  int       i;
+
+  npages    = MM_NPAGES(size);
+  ptprev    = riscv_pgvaddr(addrenv->spgtables[ARCH_SPGTS - 1]);
+  ptlevel   = ARCH_SPGTS;
+
+  /* Create mappings for the lower level tables */
+
+  map_spgtables(addrenv, vaddr);
+
+  for (i = 0; i < npages; i++, vaddr += MM_PGSIZE)
+    {
+      /* Get the final level table, allocate it if there is none yet */
+
+      paddr = mmu_pte_to_paddr(mmu_ln_getentry(ptlevel, ptprev, vaddr));
+
+      if (!paddr)
+        {
+          paddr = mm_pgalloc(1);
+          if (!paddr)
+            {
+              return -ENOMEM;
+            }
+
+          mmu_ln_setentry(ptlevel, ptprev, paddr, vaddr, MMU_UPGT_FLAGS);
+          riscv_pgwipe(paddr);
+        }
+
+      ptlast = riscv_pgvaddr(paddr);
+
+      /* Then map the page of the other address environment */
+
+      paddr = up_addrenv_find_page(src, vaddr);
+      if (!paddr)
+        {
+          return -EINVAL;
+        }
+
+      mmu_ln_setentry(ptlevel + 1, ptlast, paddr, vaddr, mmuflags);
+    }
+
+  /* Flush the data cache, so the changes are committed to memory */
+
+  __DMB();
+
+  return npages;
+}
+
 /****************************************************************************
  * Name: vaddr_is_shm
  *
@@ -340,38 +455,40 @@ static inline bool vaddr_is_shm(uintptr_t vaddr)
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: up_addrenv_create
+ * Name: vaddr_is_shared
  *
  * Description:
- *   This function is called when a new task is created in order to
- *   instantiate an address environment for the new task group.
- *   up_addrenv_create() is essentially the allocator of the physical
- *   memory for the new task.
+ *   Check if a vaddr is part of the .text mapped from another address
+ *   environment
  *
  * Input Parameters:
- *   textsize - The size (in bytes) of the .text address environment needed
- *     by the task.  This region may be read/execute only.
- *   datasize - The size (in bytes) of the .data/.bss address environment
- *     needed by the task.  This region may be read/write only.  NOTE: The
- *     actual size of the data region that is allocated will include a
- *     OS private reserved region at the beginning.  The size of the
- *     private, reserved region is give by ARCH_DATA_RESERVE_SIZE.
- *   heapsize - The initial size (in bytes) of the heap address environment
- *     needed by the task.  This region may be read/write only.
- *   addrenv - The location to return the representation of the task address
- *     environment.
+ *   addrenv - Describes the address environment
+ *   vaddr - Virtual address to check
  *
- * Returned Value:
- *   Zero (OK) on success; a negated errno value on failure.
+ * Returned value:
+ *   true if it is; false if not
  *
  ****************************************************************************/
 
-int up_addrenv_create(size_t textsize, size_t datasize, size_t heapsize,
-                      arch_addrenv_t *addrenv)
+static inline bool vaddr_is_shared(const arch_addrenv_t *addrenv,
+                                   uintptr_t vaddr)
+{
+  return vaddr >= addrenv->textvbase &&
+         vaddr < addrenv->textvbase + addrenv->textshared;
+}
+
+/****************************************************************************
+ * Name: create_addrenv
+ *
+ * Description:
+ *   Create an address environment, with the .text region of another one
+ *   if text is not NULL.  See up_addrenv_create().
+ *
+ ****************************************************************************/
+
+static int create_addrenv(arch_addrenv_t *text, size_t textsize,
+                          size_t datasize, size_t heapsize,
+                          arch_addrenv_t *addrenv)
 {
   int       ret;
   uintptr_t resvbase;
@@ -439,7 +556,26 @@ int up_addrenv_create(size_t textsize, size_t datasize, size_t heapsize,
 
   /* Map each region in turn */
 
-  ret = create_region(addrenv, textbase, textsize, MMU_UTEXT_FLAGS);
+  if (text != NULL)
+    {
+      if (text->textvbase != textbase)
+        {
+          ret = -EINVAL;
+          goto errout;
+        }
+
+      /* Record the shared pages first, they must not be freed on error */
+
+      addrenv->textvbase  = textbase;
+      addrenv->textshared = MM_PGALIGNUP(textsize);
+
+      ret = share_region(addrenv, text, textbase, textsize,
+                         MMU_UTEXT_FLAGS);
+    }
+  else
+    {
+      ret = create_region(addrenv, textbase, textsize, MMU_UTEXT_FLAGS);
+    }
 
   if (ret < 0)
     {
@@ -455,7 +591,11 @@ int up_addrenv_create(size_t textsize, size_t datasize, size_t heapsize,
       goto errout;
     }
 
+#ifdef CONFIG_ARCH_HEAP_DEMAND_ZERO
+  ret = reserve_region(addrenv, heapbase, heapsize);
+#else
   ret = create_region(addrenv, heapbase, heapsize, MMU_UDATA_FLAGS);
+#endif
 
   if (ret < 0)
     {
@@ -494,6 +634,73 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_addrenv_create
+ *
+ * Description:
+ *   This function is called when a new task is created in order to
+ *   instantiate an address environment for the new task group.
+ *   up_addrenv_create() is essentially the allocator of the physical
+ *   memory for the new task.
+ *
+ * Input Parameters:
+ *   textsize - The size (in bytes) of the .text address environment needed
+ *     by the task.  This region may be read/execute only.
+ *   datasize - The size (in bytes) of the .data/.bss address environment
+ *     needed by the task.  This region may be read/write only.  NOTE: The
+ *     actual size of the data region that is allocated will include a
+ *     OS private reserved region at the beginning.  The size of the
+ *     private, reserved region is give by ARCH_DATA_RESERVE_SIZE.
+ *   heapsize - The initial size (in bytes) of the heap address environment
+ *     needed by the task.  This region may be read/write only.
+ *   addrenv - The location to return the representation of the task address
+ *     environment.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int up_addrenv_create(size_t textsize, size_t datasize, size_t heapsize,
+                      arch_addrenv_t *addrenv)
+{
+  return create_addrenv(NULL, textsize, datasize, heapsize, addrenv);
+}
+
+/****************************************************************************
+ * Name: up_addrenv_create_shared
+ *
+ * Description:
+ *   Create an address environment like up_addrenv_create(), except that
+ *   the .text region maps the physical pages of the .text region of
+ *   another address environment.  That one must not be destroyed before
+ *   this one.
+ *
+ * Input Parameters:
+ *   text - The address environment that owns the .text pages.
+ *   textsize - The size (in bytes) of the .text address environment.
+ *   datasize - The size (in bytes) of the .data/.bss address environment.
+ *   heapsize - The initial size (in bytes) of the heap address environment.
+ *   addrenv - The location to return the representation of the task address
+ *     environment.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int up_addrenv_create_shared(arch_addrenv_t *text, size_t textsize,
+                             size_t datasize, size_t heapsize,
+                             arch_addrenv_t *addrenv)
+{
+  DEBUGASSERT(text);
+  return create_addrenv(text, textsize, datasize, heapsize, addrenv);
+}
+
 /****************************************************************************
  * Name: up_addrenv_destroy
  *
@@ -549,12 +756,15 @@ int up_addrenv_destroy(arch_addrenv_t *addrenv)
             {
               if (!vaddr_is_shm(vaddr))
                 {
-                  /* Free the allocated pages, but not from SHM area */
+                  /* Free the allocated pages, but not from SHM area and
+                   * not the .text of another address environment
+                   */
 
                   for (j = 0; j < ENTRIES_PER_PGT; j++)
                     {
                       paddr = mmu_pte_to_paddr(ptlast[j]);
-                      if (paddr)
+                      if (paddr &&
+                          !vaddr_is_shared(addrenv, vaddr + j * MM_PGSIZE))
                         {
                           mm_pgfree(paddr, 1);
                         }
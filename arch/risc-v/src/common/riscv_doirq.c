@@ -87,6 +87,20 @@ uintreg_t *riscv_doirq(int irq, uintreg_t *regs)
   DEBUGASSERT(up_current_regs() == NULL);
   up_set_current_regs(regs);
 
+#if defined(CONFIG_ARCH_RV_ISA_V) && defined(CONFIG_RISCV_STRING_RVV)
+  /* The vector string functions may be called by the handler.  Save the
+   * vector state of the interrupted thread and mark the unit clean in
+   * hardware, so the state is only reloaded if the handler used it.
+   */
+
+  if (*running_task != NULL)
+    {
+      riscv_savevpu(regs, riscv_vpuregs(*running_task));
+      CLEAR_CSR(CSR_STATUS, MSTATUS_VS);
+      SET_CSR(CSR_STATUS, MSTATUS_VS_CLEAN);
+    }
+#endif
+
   /* Deliver the IRQ */
 
   irq_dispatch(irq, regs);
@@ -123,6 +137,14 @@ uintreg_t *riscv_doirq(int irq, uintreg_t *regs)
 
       *running_task = tcb;
     }
+#if defined(CONFIG_ARCH_RV_ISA_V) && defined(CONFIG_RISCV_STRING_RVV)
+  else if ((READ_CSR(CSR_STATUS) & MSTATUS_VS) == MSTATUS_VS_DIRTY)
+    {
+      /* The handler used the vector unit, give the thread its state back */
+
+      riscv_restorevpu(tcb->xcp.regs, riscv_vpuregs(tcb));
+    }
+#endif
 
   /* Set current_regs to NULL to indicate that we are no longer in an
    * interrupt handler.
@@ -30,11 +30,12 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
-#ifdef CONFIG_PAGING
+#if defined(CONFIG_PAGING) || defined(CONFIG_ARCH_HEAP_DEMAND_ZERO)
 #  include <nuttx/pgalloc.h>
 #endif
 
-#ifdef CONFIG_PAGING
+#if defined(CONFIG_PAGING) || defined(CONFIG_ARCH_HEAP_DEMAND_ZERO)
+#  include "addrenv.h"
 #  include "pgalloc.h"
 #  include "riscv_mmu.h"
 #endif
@@ -243,6 +244,69 @@ int riscv_fillpage(int mcause, void *regs, void *args)
 }
 #endif /* CONFIG_PAGING */
 
+/****************************************************************************
+ * Name: riscv_fillheap
+ *
+ * Description:
+ *   This function is the page fault handler with demand-zero heaps.  A
+ *   fault in the heap region of the current address environment maps a
+ *   zeroed page there, any other fault is an exception.
+ *
+ * Input Parameters:
+ *   mcause - The machine cause of the exception.
+ *   regs   - A pointer to the register state at the time of the exception.
+ *   args   - A pointer to any additional arguments.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HEAP_DEMAND_ZERO
+int riscv_fillheap(int mcause, void *regs, void *args)
+{
+  struct addrenv_s *addrenv = this_task()->addrenv_curr;
+  arch_addrenv_t   *env;
+  irqstate_t        flags;
+  uintptr_t         paddr;
+  uintptr_t         vaddr;
+
+  vaddr = MM_PGALIGNDOWN(READ_CSR(CSR_TVAL));
+  if (addrenv == NULL)
+    {
+      return riscv_exception(mcause, regs, args);
+    }
+
+  env = &addrenv->addrenv;
+  if (vaddr < env->heapvbase || vaddr >= env->heapvbase + env->heapsize)
+    {
+      return riscv_exception(mcause, regs, args);
+    }
+
+  /* Another CPU may have faulted on the same page */
+
+  flags = enter_critical_section();
+  if (up_addrenv_find_page(env, vaddr) == 0)
+    {
+      paddr = mm_pgalloc(1);
+      if (!paddr)
+        {
+          leave_critical_section(flags);
+          _alert("PANIC!!! out of pages for heap: %" PRIxPTR "\n", vaddr);
+          return riscv_exception(mcause, regs, args);
+        }
+
+      riscv_pgwipe(paddr);
+      riscv_map_pages(env, &paddr, 1, vaddr, MMU_UDATA_FLAGS);
+    }
+
+  leave_critical_section(flags);
+
+  mmu_invalidate_tlb_by_vaddr(vaddr);
+  return 0;
+}
+#endif /* CONFIG_ARCH_HEAP_DEMAND_ZERO */
+
 /****************************************************************************
  * Name: riscv_exception_attach
  *
@@ -287,9 +351,12 @@ void riscv_exception_attach(void)
 
   irq_attach(RISCV_IRQ_INSTRUCTIONPF, riscv_exception, NULL);
 
-#ifdef CONFIG_PAGING
+#if defined(CONFIG_PAGING)
   irq_attach(RISCV_IRQ_LOADPF, riscv_fillpage, NULL);
   irq_attach(RISCV_IRQ_STOREPF, riscv_fillpage, NULL);
+#elif defined(CONFIG_ARCH_HEAP_DEMAND_ZERO)
+  irq_attach(RISCV_IRQ_LOADPF, riscv_fillheap, NULL);
+  irq_attach(RISCV_IRQ_STOREPF, riscv_fillheap, NULL);
 #else
   irq_attach(RISCV_IRQ_LOADPF, riscv_exception, NULL);
   irq_attach(RISCV_IRQ_STOREPF, riscv_exception, NULL);
@@ -400,6 +400,7 @@ void riscv_netinitialize(void);
 uintreg_t *riscv_doirq(int irq, uintreg_t *regs);
 int riscv_exception(int mcause, void *regs, void *args);
 int riscv_fillpage(int mcause, void *regs, void *args);
+int riscv_fillheap(int mcause, void *regs, void *args);
 int riscv_misaligned(int irq, void *context, void *arg);
 
 /* Debug ********************************************************************/
@@ -28,6 +28,7 @@
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/param.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -37,10 +38,12 @@
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
+#include <poll.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/mqueue.h>
 #include <nuttx/arch.h>
+#include <nuttx/cache.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/audio/audio.h>
 #include <nuttx/mutex.h>
@@ -78,6 +81,14 @@ struct audio_upperhalf_s
   mutex_t           lock;             /* Supports mutual exclusion */
   FAR struct audio_lowerhalf_s *dev;  /* lower-half state */
   struct file      *usermq;           /* User mode app's message queue */
+#ifdef CONFIG_AUDIO_MMAP
+  struct audio_ring_s ring;           /* The mmap()'ed ring, if base set */
+  uint64_t          hw_ptr;           /* Bytes played or recorded */
+  uint64_t          appl_ptr;         /* Bytes written or read */
+  uint32_t          avail_min;        /* The poll() threshold */
+  bool              xrun;             /* An underrun or overrun happened */
+  FAR struct pollfd *fds[CONFIG_AUDIO_MMAP_NPOLLWAITERS];
+#endif
 };
 
 /****************************************************************************
@@ -95,6 +106,13 @@ static ssize_t  audio_write(FAR struct file *filep,
 static int      audio_ioctl(FAR struct file *filep,
                             int cmd,
                             unsigned long arg);
+#ifdef CONFIG_AUDIO_MMAP
+static int      audio_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+static int      audio_poll(FAR struct file *filep,
+                           FAR struct pollfd *fds,
+                           bool setup);
+#endif
 #ifdef CONFIG_AUDIO_MULTI_SESSION
 static int      audio_start(FAR struct audio_upperhalf_s *upper,
                             FAR void *session);
@@ -123,6 +141,11 @@ static const struct file_operations g_audioops =
   audio_write, /* write */
   NULL,        /* seek */
   audio_ioctl, /* ioctl */
+#ifdef CONFIG_AUDIO_MMAP
+  audio_mmap,  /* mmap */
+  NULL,        /* truncate */
+  audio_poll,  /* poll */
+#endif
 };
 
 /****************************************************************************
@@ -227,6 +250,9 @@ static int audio_close(FAR struct file *filep)
 
       lower->ops->shutdown(lower);
       upper->usermq = NULL;
+#ifdef CONFIG_AUDIO_MMAP
+      upper->ring.base = NULL;
+#endif
     }
 
   ret = OK;
@@ -339,6 +365,182 @@ static int audio_start(FAR struct audio_upperhalf_s *upper)
   return ret;
 }
 
+#ifdef CONFIG_AUDIO_MMAP
+/****************************************************************************
+ * Name: audio_ring_avail
+ *
+ * Description:
+ *   Return the bytes that the application may write to, or read from, the
+ *   ring.  Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static uint32_t audio_ring_avail(FAR struct audio_upperhalf_s *upper)
+{
+  uint32_t size = upper->ring.period_bytes * upper->ring.periods;
+
+  if (upper->ring.playback)
+    {
+      return upper->appl_ptr < upper->hw_ptr ? 0 :
+             size - (uint32_t)(upper->appl_ptr - upper->hw_ptr);
+    }
+
+  return MIN(upper->hw_ptr - upper->appl_ptr, size);
+}
+
+/****************************************************************************
+ * Name: audio_ring_events
+ *
+ * Description:
+ *   Return the poll events of the ring.  Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static pollevent_t audio_ring_events(FAR struct audio_upperhalf_s *upper)
+{
+  pollevent_t ready = upper->ring.playback ? POLLOUT : POLLIN;
+
+  if (upper->ring.base == NULL)
+    {
+      return 0;
+    }
+
+  if (upper->xrun)
+    {
+      return ready | POLLERR;
+    }
+
+  return audio_ring_avail(upper) >= upper->avail_min ? ready : 0;
+}
+
+/****************************************************************************
+ * Name: audio_ring_cache
+ *
+ * Description:
+ *   Hand bytes from..to of the ring over between the CPU and the hardware:
+ *   The samples written by the application are cleaned from the cache
+ *   before they are played, and the recorded ones are invalidated before
+ *   they are read.
+ *
+ ****************************************************************************/
+
+static void audio_ring_cache(FAR struct audio_upperhalf_s *upper,
+                             uint64_t from, uint64_t to)
+{
+#ifdef CONFIG_ARCH_DCACHE
+  uint32_t size = upper->ring.period_bytes * upper->ring.periods;
+  uintptr_t start;
+  uint32_t len;
+
+  while (from < to)
+    {
+      start = (uintptr_t)upper->ring.base + from % size;
+      len   = MIN(to - from, size - from % size);
+
+      if (upper->ring.playback)
+        {
+          up_clean_dcache(start, start + len);
+        }
+      else
+        {
+          up_invalidate_dcache(start, start + len);
+        }
+
+      from += len;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: audio_mmap_sync
+ *
+ * Description:
+ *   Handle the AUDIOIOC_MMAPSYNC ioctl command
+ *
+ ****************************************************************************/
+
+static int audio_mmap_sync(FAR struct audio_upperhalf_s *upper,
+                           FAR struct audio_mmap_sync_s *sync)
+{
+  uint32_t size = upper->ring.period_bytes * upper->ring.periods;
+  irqstate_t flags;
+  uint64_t from;
+  uint64_t limit;
+  int ret = OK;
+
+  if (sync == NULL || upper->ring.base == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  if ((sync->flags & AUDIO_MMAP_SYNC_APPL) != 0)
+    {
+      /* The application may write up to one ring ahead of the hardware,
+       * and read up to the hardware.
+       */
+
+      limit = upper->ring.playback ? upper->hw_ptr + size : upper->hw_ptr;
+      if (sync->appl_ptr < upper->appl_ptr || sync->appl_ptr > limit)
+        {
+          leave_critical_section(flags);
+          return -EINVAL;
+        }
+
+      from             = upper->appl_ptr;
+      upper->appl_ptr  = sync->appl_ptr;
+      if (upper->ring.playback)
+        {
+          audio_ring_cache(upper, from, upper->appl_ptr);
+        }
+    }
+
+  if ((sync->flags & AUDIO_MMAP_SYNC_AVAIL_MIN) != 0)
+    {
+      upper->avail_min = MAX(MIN(sync->avail_min, size), 1);
+    }
+
+  if (!upper->ring.playback)
+    {
+      audio_ring_cache(upper, upper->appl_ptr, upper->hw_ptr);
+    }
+
+  sync->avail_min    = upper->avail_min;
+  sync->hw_ptr       = upper->hw_ptr;
+  sync->appl_ptr     = upper->appl_ptr;
+  sync->avail        = audio_ring_avail(upper);
+  sync->period_bytes = upper->ring.period_bytes;
+  sync->buffer_bytes = size;
+
+  if (upper->xrun)
+    {
+      ret = -EPIPE;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_ring_reset
+ *
+ * Description:
+ *   Rewind the positions, when the stream stops.
+ *
+ ****************************************************************************/
+
+static void audio_ring_reset(FAR struct audio_upperhalf_s *upper)
+{
+  irqstate_t flags = enter_critical_section();
+
+  upper->hw_ptr   = 0;
+  upper->appl_ptr = 0;
+  upper->xrun     = false;
+  leave_critical_section(flags);
+}
+#endif /* CONFIG_AUDIO_MMAP */
+
 /****************************************************************************
  * Name: audio_ioctl
  *
@@ -418,6 +620,9 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           /* Call the lower-half driver initialize handler */
 
           ret = lower->ops->shutdown(lower);
+#ifdef CONFIG_AUDIO_MMAP
+          upper->ring.base = NULL;
+#endif
         }
         break;
 
@@ -465,10 +670,28 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 #endif
               upper->started = false;
             }
+
+#ifdef CONFIG_AUDIO_MMAP
+          audio_ring_reset(upper);
+#endif
         }
         break;
 #endif /* CONFIG_AUDIO_EXCLUDE_STOP */
 
+#ifdef CONFIG_AUDIO_MMAP
+      /* AUDIOIOC_MMAPSYNC - Exchange the positions in the mmap()'ed ring
+       *
+       *   ioctl argument:  pointer to an audio_mmap_sync_s structure
+       */
+
+      case AUDIOIOC_MMAPSYNC:
+        {
+          ret = audio_mmap_sync(upper,
+                  (FAR struct audio_mmap_sync_s *)((uintptr_t)arg));
+        }
+        break;
+#endif
+
       /* AUDIOIOC_PAUSE - Pause the audio stream.
        *
        *   ioctl argument:  Audio session
@@ -870,6 +1093,161 @@ static inline void audio_underrun(FAR struct audio_upperhalf_s *upper,
     }
 }
 
+#ifdef CONFIG_AUDIO_MMAP
+/****************************************************************************
+ * Name: audio_period
+ *
+ * Description:
+ *   Advance the hardware position by a period and wake up the pollers.  A
+ *   playback that catches up with the application underruns, a capture that
+ *   overwrites what the application did not read yet overruns.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void audio_period(FAR struct audio_upperhalf_s *upper)
+{
+  uint32_t size = upper->ring.period_bytes * upper->ring.periods;
+  pollevent_t events;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  upper->hw_ptr += upper->ring.period_bytes;
+  if (upper->ring.playback ? upper->hw_ptr > upper->appl_ptr :
+                             upper->hw_ptr - upper->appl_ptr > size)
+    {
+      upper->xrun = true;
+    }
+
+  events = audio_ring_events(upper);
+  leave_critical_section(flags);
+
+  if (events != 0)
+    {
+      poll_notify(upper->fds, CONFIG_AUDIO_MMAP_NPOLLWAITERS, events);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mmap
+ *
+ * Description:
+ *   Map the ring of the lower half.  The first mapping switches the lower
+ *   half to the ring mode, with the period size of AUDIOIOC_SETBUFFERINFO.
+ *
+ ****************************************************************************/
+
+static int audio_mmap(FAR struct file *filep,
+                      FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  size_t size;
+  int ret;
+
+  if (lower->ops->getring == NULL)
+    {
+      return -ENODEV;
+    }
+
+  ret = nxmutex_lock(&upper->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (upper->ring.base == NULL)
+    {
+      ret = lower->ops->getring(lower, &upper->ring);
+      if (ret < 0)
+        {
+          upper->ring.base = NULL;
+          goto errout_with_lock;
+        }
+
+      audio_ring_reset(upper);
+      upper->avail_min = upper->ring.period_bytes;
+    }
+
+  size = upper->ring.period_bytes * upper->ring.periods;
+  if (map->offset < 0 || map->length == 0 ||
+      map->offset + map->length > size)
+    {
+      ret = -EINVAL;
+      goto errout_with_lock;
+    }
+
+  map->vaddr = upper->ring.base + map->offset;
+
+errout_with_lock:
+  nxmutex_unlock(&upper->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_poll
+ *
+ * Description:
+ *   Wait until avail_min bytes of the mmap()'ed ring may be written or
+ *   read.
+ *
+ ****************************************************************************/
+
+static int audio_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  FAR struct pollfd **slot;
+  pollevent_t events;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  flags = enter_critical_section();
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_AUDIO_MMAP_NPOLLWAITERS; i++)
+        {
+          if (upper->fds[i] == NULL)
+            {
+              break;
+            }
+        }
+
+      if (i >= CONFIG_AUDIO_MMAP_NPOLLWAITERS)
+        {
+          ret = -EBUSY;
+          goto errout;
+        }
+
+      upper->fds[i] = fds;
+      fds->priv     = &upper->fds[i];
+
+      events = audio_ring_events(upper);
+      if (events != 0)
+        {
+          poll_notify(&fds, 1, events);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+#endif /* CONFIG_AUDIO_MMAP */
+
 /****************************************************************************
  * Name: audio_callback
  *
@@ -970,6 +1348,16 @@ static void audio_callback(FAR void *handle, uint16_t reason,
         }
         break;
 
+#ifdef CONFIG_AUDIO_MMAP
+      /* Lower-half driver has played or recorded a period of the ring */
+
+      case AUDIO_CALLBACK_PERIOD:
+        {
+          audio_period(upper);
+        }
+        break;
+#endif
+
       default:
         {
           auderr("ERROR: Unknown callback reason code %d\n", reason);
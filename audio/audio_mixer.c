@@ -0,0 +1,1018 @@
+/****************************************************************************
+ * audio/audio_mixer.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The mixer drives one output device in the ring mode and registers a
+ * number of streams, each of which looks like a plain output device to its
+ * clients.  Every period of the ring that the device completed is refilled
+ * by the high priority work queue in one pass: each running stream is
+ * converted to 16-bit stereo, resampled to the rate of the device if needed,
+ * weighted with its volume and summed up, and the sum is saturated into the
+ * ring.  The streams never touch the device themselves, so they may come
+ * and go while it plays.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/cache.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mixer.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SCHED_HPWORK
+#  error "The audio mixer requires CONFIG_SCHED_HPWORK"
+#endif
+
+/* The ring holds 16-bit stereo frames */
+
+#define MIXER_FRAME_BYTES   4
+
+/* The resampler: 8 taps, 32 phases, Q14 coefficients and Q16 positions.  A
+ * stream may play at up to four times the rate of the device.
+ */
+
+#define MIXER_TAPS          8
+#define MIXER_PHASE_SHIFT   11
+#define MIXER_COEF_SHIFT    14
+#define MIXER_ONE           0x10000
+#define MIXER_MAXSTEP       4
+
+/* Volumes are Q8, 256 is unity gain */
+
+#define MIXER_VOLUME_SHIFT  8
+#define MIXER_VOLUME_ONE    (1 << MIXER_VOLUME_SHIFT)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct audio_mixer_s;
+
+/* One client stream */
+
+struct audio_stream_s
+{
+  /* This is our appearance to the outside world.  This *MUST* be the first
+   * element of the structure so that we can freely cast between types
+   * struct audio_lowerhalf and struct audio_stream_s.
+   */
+
+  struct audio_lowerhalf_s dev;
+
+  FAR struct audio_mixer_s *mixer;  /* The mixer of the stream */
+  struct dq_queue_s pendq;          /* Buffers not played completely yet */
+  uint32_t step;                    /* Input frames per output frame, Q16 */
+  uint32_t phase;                   /* Position behind hist[7][], Q16 */
+  int16_t hist[MIXER_TAPS][2];      /* The last input frames played */
+  uint16_t volume;                  /* Q8 */
+  uint8_t channels;                 /* 1 or 2 */
+  uint8_t bpsamp;                   /* Bytes per sample: 1, 2 or 4 */
+  bool reserved;                    /* Opened by a client */
+  bool running;                     /* Started and not stopped */
+  bool paused;                      /* Paused, neither played nor consumed */
+  bool final;                       /* The last buffer was enqueued */
+};
+
+/* The mixer and the output device */
+
+struct audio_mixer_s
+{
+  FAR struct audio_lowerhalf_s *lower; /* The output device */
+  struct audio_ring_s ring;            /* The ring of the output device */
+  FAR int32_t *acc;                    /* The sum of one period */
+  FAR int16_t *in;                     /* The input of one stream */
+  struct work_s work;                  /* Refills the ring */
+  atomic_int pending;                  /* Periods to be refilled */
+  apb_samp_t period;                   /* Next period to be refilled */
+  apb_samp_t frames;                   /* Frames per period */
+  uint32_t rate;                       /* Sample rate of the device */
+  int nrunning;                        /* Number of running streams */
+  mutex_t lock;                        /* Protects the streams and the ring */
+  int nstreams;                        /* Number of streams */
+  struct audio_stream_s streams[1];    /* The streams, more may follow */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps);
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps);
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev);
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb);
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg);
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev);
+
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_audio_mixer_ops =
+{
+  audio_mixer_getcaps,       /* getcaps        */
+  audio_mixer_configure,     /* configure      */
+  audio_mixer_shutdown,      /* shutdown       */
+  audio_mixer_start,         /* start          */
+  audio_mixer_stop,          /* stop           */
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  audio_mixer_pause,         /* pause          */
+  audio_mixer_resume,        /* resume         */
+#endif
+  NULL,                      /* allocbuffer    */
+  NULL,                      /* freebuffer     */
+  audio_mixer_enqueuebuffer, /* enqueue_buffer */
+  NULL,                      /* cancel_buffer  */
+  audio_mixer_ioctl,         /* ioctl          */
+  NULL,                      /* read           */
+  NULL,                      /* write          */
+  audio_mixer_reserve,       /* reserve        */
+  audio_mixer_release,       /* release        */
+  NULL                       /* getring        */
+};
+
+/* The polyphase lowpass filter of the resampler.  Row n interpolates at
+ * n / 32 of the way from tap 3 to tap 4, with a cutoff at 0.9 of the
+ * Nyquist frequency of the stream.  Every row sums up to 1 << 14.
+ */
+
+static const int16_t g_mixer_coef[1 << (16 - MIXER_PHASE_SHIFT)]
+                                 [MIXER_TAPS] =
+{
+  {   230,   -739,   1352,  14716,   1352,   -739,    230,    -18 },
+  {   202,   -621,    940,  14698,   1789,   -859,    257,    -22 },
+  {   176,   -506,    552,  14635,   2248,   -981,    285,    -25 },
+  {   150,   -396,    190,  14530,   2729,  -1103,    313,    -29 },
+  {   125,   -290,   -146,  14385,   3228,  -1225,    340,    -33 },
+  {   102,   -190,   -454,  14195,   3745,  -1344,    366,    -36 },
+  {    80,    -97,   -735,  13967,   4277,  -1459,    391,    -40 },
+  {    60,     -9,   -988,  13698,   4822,  -1569,    413,    -43 },
+  {    41,     71,  -1214,  13395,   5377,  -1673,    433,    -46 },
+  {    24,    144,  -1412,  13055,   5940,  -1769,    451,    -49 },
+  {     9,    210,  -1583,  12680,   6509,  -1855,    465,    -51 },
+  {    -4,    268,  -1727,  12275,   7079,  -1930,    475,    -52 },
+  {   -16,    319,  -1846,  11842,   7650,  -1992,    480,    -53 },
+  {   -26,    363,  -1939,  11381,   8216,  -2039,    481,    -53 },
+  {   -34,    399,  -2009,  10897,   8777,  -2071,    477,    -52 },
+  {   -40,    428,  -2055,  10390,   9328,  -2085,    467,    -49 },
+  {   -45,    451,  -2080,   9867,   9865,  -2080,    451,    -45 },
+  {   -49,    467,  -2085,   9328,  10390,  -2055,    428,    -40 },
+  {   -52,    477,  -2071,   8777,  10897,  -2009,    399,    -34 },
+  {   -53,    481,  -2039,   8216,  11381,  -1939,    363,    -26 },
+  {   -53,    480,  -1992,   7650,  11842,  -1846,    319,    -16 },
+  {   -52,    475,  -1930,   7079,  12275,  -1727,    268,     -4 },
+  {   -51,    465,  -1855,   6509,  12680,  -1583,    210,      9 },
+  {   -49,    451,  -1769,   5940,  13055,  -1412,    144,     24 },
+  {   -46,    433,  -1673,   5377,  13395,  -1214,     71,     41 },
+  {   -43,    413,  -1569,   4822,  13698,   -988,     -9,     60 },
+  {   -40,    391,  -1459,   4277,  13967,   -735,    -97,     80 },
+  {   -36,    366,  -1344,   3745,  14195,   -454,   -190,    102 },
+  {   -33,    340,  -1225,   3228,  14385,   -146,   -290,    125 },
+  {   -29,    313,  -1103,   2729,  14530,    190,   -396,    150 },
+  {   -25,    285,   -981,   2248,  14635,    552,   -506,    176 },
+  {   -22,    257,   -859,   1789,  14698,    940,   -621,    202 },
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_convert
+ *
+ * Description:
+ *   Convert up to 'nframes' frames of a buffer to 16-bit stereo.  Return
+ *   the number of frames converted.
+ *
+ ****************************************************************************/
+
+static apb_samp_t audio_mixer_convert(FAR struct audio_stream_s *stream,
+                                      FAR struct ap_buffer_s *apb,
+                                      FAR int16_t *out, apb_samp_t nframes)
+{
+  FAR const uint8_t *src = apb->samp + apb->curbyte;
+  apb_samp_t nsamples;
+  apb_samp_t avail;
+  apb_samp_t i;
+
+  avail = (apb->nbytes - apb->curbyte) /
+          (stream->bpsamp * stream->channels);
+  if (nframes > avail)
+    {
+      nframes = avail;
+    }
+
+  nsamples = nframes * stream->channels;
+  apb->curbyte += nsamples * stream->bpsamp;
+
+  /* Convert the samples in place at the end of the output, then spread the
+   * mono samples to both channels from the front.
+   */
+
+  if (stream->channels == 1)
+    {
+      out += nsamples;
+    }
+
+  switch (stream->bpsamp)
+    {
+      case 1:
+        for (i = 0; i < nsamples; i++)
+          {
+            out[i] = (int16_t)((src[i] - 128) << 8);
+          }
+        break;
+
+      case 2:
+        memcpy(out, src, nsamples * sizeof(int16_t));
+        break;
+
+      default:
+        for (i = 0; i < nsamples; i++)
+          {
+            out[i] = ((FAR const int32_t *)src)[i] >> 16;
+          }
+        break;
+    }
+
+  if (stream->channels == 1)
+    {
+      out -= nsamples;
+      for (i = 0; i < nframes; i++)
+        {
+          out[2 * i]     = out[nsamples + i];
+          out[2 * i + 1] = out[nsamples + i];
+        }
+    }
+
+  return nframes;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_fetch
+ *
+ * Description:
+ *   Take 'nframes' frames of 16-bit stereo from the buffers of a stream.
+ *   The buffers that were played completely are returned to the client,
+ *   and silence fills in for the frames that did not arrive in time.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_fetch(FAR struct audio_stream_s *stream,
+                              FAR int16_t *out, apb_samp_t nframes)
+{
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+  apb_samp_t n;
+
+  while (nframes > 0 &&
+         (apb = (FAR struct ap_buffer_s *)dq_peek(&stream->pendq)) != NULL)
+    {
+      n        = audio_mixer_convert(stream, apb, out, nframes);
+      out     += 2 * n;
+      nframes -= n;
+
+      if (n == 0 || apb->curbyte >= apb->nbytes)
+        {
+          flags = enter_critical_section();
+          dq_remfirst(&stream->pendq);
+          leave_critical_section(flags);
+
+          if ((apb->flags & AUDIO_APB_FINAL) != 0)
+            {
+              stream->final = true;
+            }
+
+          apb_free(apb);
+          stream->dev.upper(stream->dev.priv, AUDIO_CALLBACK_DEQUEUE,
+                            apb, OK);
+        }
+    }
+
+  memset(out, 0, nframes * 2 * sizeof(int16_t));
+}
+
+/****************************************************************************
+ * Name: audio_mixer_add
+ *
+ * Description:
+ *   Add one period of a stream to the sum, at the rate of the device.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_add(FAR struct audio_mixer_s *mixer,
+                            FAR struct audio_stream_s *stream)
+{
+  FAR const int16_t *coef;
+  FAR const int16_t *x;
+  FAR int32_t *acc = mixer->acc;
+  FAR int16_t *in = mixer->in;
+  int32_t volume = stream->volume;
+  apb_samp_t nframes = mixer->frames;
+  apb_samp_t needed;
+  uint32_t phase;
+  int32_t l;
+  int32_t r;
+  apb_samp_t i;
+  int k;
+
+  if (stream->step == MIXER_ONE)
+    {
+      /* The stream plays at the rate of the device */
+
+      audio_mixer_fetch(stream, in, nframes);
+      for (i = 0; i < 2 * nframes; i++)
+        {
+          acc[i] += in[i] * volume;
+        }
+
+      return;
+    }
+
+  /* Output frame i is interpolated between the frames 3 and 4 of the
+   * window that starts at in[] frame (phase + i * step) >> 16.  The last
+   * frames of the previous period precede the new ones.
+   */
+
+  phase  = stream->phase;
+  needed = (phase + (nframes - 1) * stream->step) >> 16;
+
+  memcpy(in, stream->hist, sizeof(stream->hist));
+  audio_mixer_fetch(stream, in + 2 * MIXER_TAPS, needed);
+
+  for (i = 0; i < nframes; i++, phase += stream->step)
+    {
+      x    = in + 2 * (phase >> 16);
+      coef = g_mixer_coef[(phase & (MIXER_ONE - 1)) >> MIXER_PHASE_SHIFT];
+      l    = 0;
+      r    = 0;
+
+      for (k = 0; k < MIXER_TAPS; k++)
+        {
+          l += x[2 * k] * coef[k];
+          r += x[2 * k + 1] * coef[k];
+        }
+
+      acc[2 * i]     += (l >> MIXER_COEF_SHIFT) * volume;
+      acc[2 * i + 1] += (r >> MIXER_COEF_SHIFT) * volume;
+    }
+
+  memcpy(stream->hist, in + 2 * needed, sizeof(stream->hist));
+  stream->phase = phase - (needed << 16);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stopped
+ *
+ * Description:
+ *   Return the buffers of a stream and tell the client that it stopped.
+ *   The output device is stopped with the last stream.  Called with the
+ *   mixer locked.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_stopped(FAR struct audio_stream_s *stream)
+{
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&stream->pendq);
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      apb_free(apb);
+      stream->dev.upper(stream->dev.priv, AUDIO_CALLBACK_DEQUEUE, apb, OK);
+    }
+
+  stream->running = false;
+  stream->paused  = false;
+  stream->final   = false;
+
+  if (--mixer->nrunning == 0)
+    {
+      mixer->lower->ops->stop(mixer->lower);
+    }
+
+  stream->dev.upper(stream->dev.priv, AUDIO_CALLBACK_COMPLETE, NULL, OK);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_fill
+ *
+ * Description:
+ *   Mix the next period of the ring.  Called with the mixer locked.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_fill(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_stream_s *stream;
+  FAR int32_t *acc = mixer->acc;
+  FAR int16_t *out;
+  apb_samp_t i;
+  int32_t s;
+  int n;
+
+  memset(acc, 0, mixer->frames * 2 * sizeof(int32_t));
+
+  for (n = 0; n < mixer->nstreams; n++)
+    {
+      stream = &mixer->streams[n];
+      if (stream->running && !stream->paused)
+        {
+          audio_mixer_add(mixer, stream);
+          if (stream->final && dq_peek(&stream->pendq) == NULL)
+            {
+              audio_mixer_stopped(stream);
+            }
+        }
+    }
+
+  out = (FAR int16_t *)(mixer->ring.base +
+                        mixer->period * mixer->ring.period_bytes);
+
+  for (i = 0; i < mixer->frames * 2; i++)
+    {
+      s = acc[i] >> MIXER_VOLUME_SHIFT;
+      out[i] = s > INT16_MAX ? INT16_MAX : s < INT16_MIN ? INT16_MIN : s;
+    }
+
+  up_clean_dcache((uintptr_t)out,
+                  (uintptr_t)out + mixer->ring.period_bytes);
+
+  if (++mixer->period >= mixer->ring.periods)
+    {
+      mixer->period = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_worker
+ *
+ * Description:
+ *   Refill the periods that the output device completed, in ring order.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_worker(FAR void *arg)
+{
+  FAR struct audio_mixer_s *mixer = arg;
+
+  nxmutex_lock(&mixer->lock);
+  while (atomic_load(&mixer->pending) > 0)
+    {
+      if (mixer->nrunning == 0)
+        {
+          atomic_store(&mixer->pending, 0);
+          break;
+        }
+
+      audio_mixer_fill(mixer);
+      atomic_fetch_sub(&mixer->pending, 1);
+    }
+
+  nxmutex_unlock(&mixer->lock);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_callback
+ *
+ * Description:
+ *   The output device completed a period.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status)
+{
+  FAR struct audio_mixer_s *mixer = arg;
+
+  if (reason == AUDIO_CALLBACK_PERIOD)
+    {
+      atomic_fetch_add(&mixer->pending, 1);
+      work_queue(HPWORK, &mixer->work, audio_mixer_worker, mixer, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_getcaps
+ *
+ * Description: Get the audio device capabilities
+ *
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps)
+{
+  DEBUGASSERT(caps && caps->ac_len >= sizeof(struct audio_caps_s));
+
+  caps->ac_format.hw  = 0;
+  caps->ac_controls.w = 0;
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_QUERY:
+        caps->ac_channels = 2;
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_format.hw     = 1 << (AUDIO_FMT_PCM - 1);
+            caps->ac_controls.b[0] = AUDIO_TYPE_OUTPUT | AUDIO_TYPE_FEATURE;
+          }
+        else
+          {
+            caps->ac_controls.b[0] = AUDIO_SUBFMT_END;
+          }
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        caps->ac_channels = 2;
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_controls.hw[0] = AUDIO_SAMP_RATE_DEF_ALL;
+          }
+        break;
+
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_subtype == AUDIO_FU_UNDEF)
+          {
+            caps->ac_controls.b[0] = AUDIO_FU_VOLUME;
+          }
+        break;
+
+      default:
+        caps->ac_subtype = 0;
+        caps->ac_channels = 0;
+        break;
+    }
+
+  return caps->ac_len;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_configure
+ *
+ * Description:
+ *   Configure the format or the volume of a stream.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps)
+{
+  FAR struct audio_stream_s *stream = (FAR struct audio_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  uint32_t rate;
+  int ret = OK;
+
+  nxmutex_lock(&mixer->lock);
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_format.hw != AUDIO_FU_VOLUME ||
+            caps->ac_controls.hw[0] > 1000)
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        stream->volume = caps->ac_controls.hw[0] * MIXER_VOLUME_ONE / 1000;
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        rate = caps->ac_controls.hw[0];
+        if (stream->running || rate == 0 ||
+            rate > mixer->rate * MIXER_MAXSTEP ||
+            (caps->ac_channels != 1 && caps->ac_channels != 2) ||
+            (caps->ac_controls.b[2] != 8 && caps->ac_controls.b[2] != 16 &&
+             caps->ac_controls.b[2] != 32))
+          {
+            ret = stream->running ? -EBUSY : -EINVAL;
+            break;
+          }
+
+        stream->step     = ((uint64_t)rate << 16) / mixer->rate;
+        stream->channels = caps->ac_channels;
+        stream->bpsamp   = caps->ac_controls.b[2] / 8;
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_shutdown
+ ****************************************************************************/
+
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_stream_s *stream = (FAR struct audio_stream_s *)dev;
+
+  stream->step     = MIXER_ONE;
+  stream->volume   = MIXER_VOLUME_ONE;
+  stream->channels = 2;
+  stream->bpsamp   = 2;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_start
+ *
+ * Description:
+ *   Start mixing a stream.  The output device is started with the first
+ *   stream, once all of its periods were filled.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_stream_s *stream = (FAR struct audio_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  apb_samp_t i;
+  int ret = OK;
+
+  nxmutex_lock(&mixer->lock);
+  if (stream->running)
+    {
+      goto out;
+    }
+
+  memset(stream->hist, 0, sizeof(stream->hist));
+  stream->phase   = 0;
+  stream->final   = false;
+  stream->paused  = false;
+  stream->running = true;
+
+  if (mixer->nrunning++ == 0)
+    {
+      atomic_store(&mixer->pending, 0);
+      mixer->period = 0;
+      for (i = 0; i < mixer->ring.periods; i++)
+        {
+          audio_mixer_fill(mixer);
+        }
+
+      ret = mixer->lower->ops->start(mixer->lower);
+      if (ret < 0)
+        {
+          mixer->nrunning--;
+          stream->running = false;
+        }
+    }
+
+out:
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stop
+ ****************************************************************************/
+
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_stream_s *stream = (FAR struct audio_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+
+  nxmutex_lock(&mixer->lock);
+  if (stream->running)
+    {
+      audio_mixer_stopped(stream);
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_pause and audio_mixer_resume
+ *
+ * Description:
+ *   A paused stream is left out of the mix, the others play on.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_stream_s *stream = (FAR struct audio_stream_s *)dev;
+
+  nxmutex_lock(&stream->mixer->lock);
+  stream->paused = true;
+  nxmutex_unlock(&stream->mixer->lock);
+  return OK;
+}
+
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_stream_s *stream = (FAR struct audio_stream_s *)dev;
+
+  nxmutex_lock(&stream->mixer->lock);
+  stream->paused = false;
+  nxmutex_unlock(&stream->mixer->lock);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_enqueuebuffer
+ ****************************************************************************/
+
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_stream_s *stream = (FAR struct audio_stream_s *)dev;
+  irqstate_t flags;
+
+  /* Take a reference for the mixer, the buffer is only queued here and
+   * played by the worker.
+   */
+
+  apb_reference(apb);
+  apb->curbyte = 0;
+
+  flags = enter_critical_section();
+  dq_addlast(&apb->dq_entry, &stream->pendq);
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_ioctl
+ ****************************************************************************/
+
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg)
+{
+#ifdef CONFIG_AUDIO_DRIVER_SPECIFIC_BUFFERS
+  FAR struct ap_buffer_info_s *bufinfo;
+#endif
+
+  switch (cmd)
+    {
+#ifdef CONFIG_AUDIO_DRIVER_SPECIFIC_BUFFERS
+      case AUDIOIOC_GETBUFFERINFO:
+        bufinfo              = (FAR struct ap_buffer_info_s *)arg;
+        bufinfo->buffer_size = CONFIG_AUDIO_BUFFER_NUMBYTES;
+        bufinfo->nbuffers    = CONFIG_AUDIO_NUM_BUFFERS;
+        return OK;
+#endif
+
+      default:
+        return -ENOTTY;
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_reserve and audio_mixer_release
+ ****************************************************************************/
+
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_stream_s *stream = (FAR struct audio_stream_s *)dev;
+  int ret = OK;
+
+  nxmutex_lock(&stream->mixer->lock);
+  if (stream->reserved)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      stream->reserved = true;
+    }
+
+  nxmutex_unlock(&stream->mixer->lock);
+  return ret;
+}
+
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_stream_s *stream = (FAR struct audio_stream_s *)dev;
+
+  nxmutex_lock(&stream->mixer->lock);
+  if (stream->running)
+    {
+      audio_mixer_stopped(stream);
+    }
+
+  stream->reserved = false;
+  nxmutex_unlock(&stream->mixer->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Mix several streams into the ring of one output device.  Each stream
+ *   is registered as the audio device "<name><n>".
+ *
+ * Input Parameters:
+ *   name     - The name of the streams, "pcm_mix" for example.
+ *   lower    - The output device, which must support the ring mode.
+ *   nstreams - The number of streams to register.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR const char *name,
+                           FAR struct audio_lowerhalf_s *lower,
+                           int nstreams)
+{
+  FAR struct audio_stream_s *stream;
+  FAR struct audio_mixer_s *mixer;
+  struct ap_buffer_info_s bufinfo;
+  struct audio_caps_s caps;
+  char devname[32];
+  int ret;
+  int i;
+
+  DEBUGASSERT(name != NULL && lower != NULL && nstreams > 0);
+
+  if (lower->ops->getring == NULL || lower->ops->stop == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  mixer = kmm_zalloc(sizeof(struct audio_mixer_s) +
+                     (nstreams - 1) * sizeof(struct audio_stream_s));
+  if (mixer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  mixer->lower    = lower;
+  mixer->rate     = CONFIG_AUDIO_MIXER_RATE;
+  mixer->frames   = CONFIG_AUDIO_MIXER_PERIOD_FRAMES;
+  mixer->nstreams = nstreams;
+  nxmutex_init(&mixer->lock);
+
+  mixer->acc = kmm_malloc(mixer->frames * 2 * sizeof(int32_t));
+  mixer->in  = kmm_malloc((mixer->frames * MIXER_MAXSTEP +
+                           MIXER_TAPS + 1) * 2 * sizeof(int16_t));
+  if (mixer->acc == NULL || mixer->in == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  /* Set up the output device for the ring of the mixer */
+
+  lower->upper = audio_mixer_callback;
+  lower->priv  = mixer;
+
+  if (lower->ops->reserve != NULL)
+    {
+      ret = lower->ops->reserve(lower);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  memset(&caps, 0, sizeof(caps));
+  caps.ac_len            = sizeof(caps);
+  caps.ac_type           = AUDIO_TYPE_OUTPUT;
+  caps.ac_channels       = 2;
+  caps.ac_controls.hw[0] = mixer->rate;
+  caps.ac_controls.b[2]  = 16;
+
+  ret = lower->ops->configure(lower, &caps);
+  if (ret < 0)
+    {
+      goto errout_with_reserve;
+    }
+
+  bufinfo.buffer_size = mixer->frames * MIXER_FRAME_BYTES;
+  bufinfo.nbuffers    = CONFIG_AUDIO_MIXER_PERIODS;
+
+  ret = lower->ops->ioctl(lower, AUDIOIOC_SETBUFFERINFO,
+                          (unsigned long)&bufinfo);
+  if (ret >= 0)
+    {
+      ret = lower->ops->getring(lower, &mixer->ring);
+    }
+
+  if (ret < 0)
+    {
+      goto errout_with_reserve;
+    }
+
+  DEBUGASSERT(mixer->ring.playback &&
+              mixer->ring.period_bytes ==
+              mixer->frames * MIXER_FRAME_BYTES);
+
+  /* Register the streams */
+
+  for (i = 0; i < nstreams; i++)
+    {
+      stream = &mixer->streams[i];
+      stream->dev.ops = &g_audio_mixer_ops;
+      stream->mixer   = mixer;
+      audio_mixer_shutdown(&stream->dev);
+
+      snprintf(devname, sizeof(devname), "%s%d", name, i);
+      ret = audio_register(devname, &stream->dev);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to register %s: %d\n", devname, ret);
+
+          /* The streams that were registered stay in use */
+
+          if (i > 0)
+            {
+              return ret;
+            }
+
+          goto errout_with_reserve;
+        }
+    }
+
+  return OK;
+
+errout_with_reserve:
+  lower->ops->shutdown(lower);
+  if (lower->ops->release != NULL)
+    {
+      lower->ops->release(lower);
+    }
+
+errout:
+  kmm_free(mixer->in);
+  kmm_free(mixer->acc);
+  nxmutex_destroy(&mixer->lock);
+  kmm_free(mixer);
+  return ret;
+}
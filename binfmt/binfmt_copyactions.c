@@ -69,6 +69,7 @@ int binfmt_copyactions(FAR const posix_spawn_file_actions_t **copy,
 {
   FAR struct spawn_general_file_action_s *entry;
   FAR struct spawn_general_file_action_s *prev;
+  FAR struct spawn_general_file_action_s *next;
   FAR struct spawn_close_file_action_s *close;
   FAR struct spawn_open_file_action_s *open;
   FAR struct spawn_open_file_action_s *tmp;
@@ -113,9 +114,14 @@ int binfmt_copyactions(FAR const posix_spawn_file_actions_t **copy,
       return -ENOMEM;
     }
 
+  /* Copy the actions in order, each copy is linked to the previous copy.
+   * The list of the caller is left as it is.
+   */
+
   for (entry = (FAR struct spawn_general_file_action_s *)actions,
-       prev = NULL; entry != NULL; prev = entry, entry = entry->flink)
+       prev = NULL; entry != NULL; entry = entry->flink)
     {
+      next = buffer;
       switch (entry->action)
         {
           case SPAWN_FILE_ACTION_CLOSE:
@@ -160,8 +166,10 @@ int binfmt_copyactions(FAR const posix_spawn_file_actions_t **copy,
             break;
 
           default:
-            break;
+            continue;
         }
+
+      prev = next;
     }
 
   return OK;
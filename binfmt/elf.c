@@ -34,6 +34,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/binfmt/binfmt.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
 
 #ifdef CONFIG_ELF
 
@@ -53,6 +54,25 @@
 #  define CONFIG_ELF_STACKSIZE 2048
 #endif
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The .text of a program loaded before, it is mapped into every new
+ * instance of the same file.
+ */
+
+#ifdef CONFIG_ELF_SHARED_TEXT
+struct elf_text_s
+{
+  FAR char        *path;     /* Path of the program, NULL if unused */
+  ino_t            ino;      /* Serial number of the file */
+  off_t            size;     /* Length of the file */
+  struct timespec  mtime;    /* Time of last modification of the file */
+  FAR addrenv_t   *textenv;  /* Owner of the .text pages */
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -75,10 +95,170 @@ static struct binfmt_s g_elfbinfmt =
   elf_unloadbinary, /* unload */
 };
 
+#ifdef CONFIG_ELF_SHARED_TEXT
+static struct elf_text_s g_elf_text[CONFIG_ELF_SHARED_TEXT_NENTRIES];
+static mutex_t g_elf_textlock = NXMUTEX_INITIALIZER;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_ELF_SHARED_TEXT
+/****************************************************************************
+ * Name: elf_text_free
+ *
+ * Description:
+ *   Forget the .text of a program.  The pages are freed with the last
+ *   instance that still uses them.
+ *
+ ****************************************************************************/
+
+static void elf_text_free(FAR struct elf_text_s *text)
+{
+  addrenv_drop(text->textenv, false);
+  kmm_free(text->path);
+
+  text->textenv = NULL;
+  text->path    = NULL;
+}
+
+/****************************************************************************
+ * Name: elf_text_match
+ *
+ * Description:
+ *   Check if the file being loaded is the one the .text was loaded from.
+ *
+ ****************************************************************************/
+
+static bool elf_text_match(FAR const struct elf_text_s *text,
+                           FAR const struct mod_loadinfo_s *loadinfo)
+{
+  return text->ino == loadinfo->fileino &&
+         text->size == loadinfo->filelen &&
+         text->mtime.tv_sec == loadinfo->filemtime.tv_sec &&
+         text->mtime.tv_nsec == loadinfo->filemtime.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: elf_text_find
+ *
+ * Description:
+ *   Give the load the .text of an earlier load of the same file, if there
+ *   is one.
+ *
+ ****************************************************************************/
+
+static void elf_text_find(FAR const char *filename,
+                          FAR struct mod_loadinfo_s *loadinfo)
+{
+  int i;
+
+  nxmutex_lock(&g_elf_textlock);
+
+  for (i = 0; i < CONFIG_ELF_SHARED_TEXT_NENTRIES; i++)
+    {
+      FAR struct elf_text_s *text = &g_elf_text[i];
+
+      if (text->path != NULL && strcmp(text->path, filename) == 0)
+        {
+          if (elf_text_match(text, loadinfo))
+            {
+              addrenv_take(text->textenv);
+              loadinfo->textenv   = text->textenv;
+              loadinfo->textvalid = true;
+            }
+          else
+            {
+              /* The file was replaced, its old .text is of no use */
+
+              elf_text_free(text);
+            }
+
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_elf_textlock);
+}
+
+/****************************************************************************
+ * Name: elf_text_insert
+ *
+ * Description:
+ *   Keep the .text that the load allocated for the next instances.  An
+ *   unused entry is taken, or else one whose program has no instance.
+ *
+ ****************************************************************************/
+
+static void elf_text_insert(FAR const char *filename,
+                            FAR const struct mod_loadinfo_s *loadinfo)
+{
+  FAR struct elf_text_s *victim = NULL;
+  FAR char *path;
+  size_t len;
+  int i;
+
+  if (loadinfo->textenv == NULL || loadinfo->textvalid)
+    {
+      return;
+    }
+
+  len  = strlen(filename) + 1;
+  path = kmm_malloc(len);
+  if (path == NULL)
+    {
+      return;
+    }
+
+  memcpy(path, filename, len);
+  nxmutex_lock(&g_elf_textlock);
+
+  for (i = 0; i < CONFIG_ELF_SHARED_TEXT_NENTRIES; i++)
+    {
+      FAR struct elf_text_s *text = &g_elf_text[i];
+
+      if (text->path == NULL)
+        {
+          if (victim == NULL || victim->path != NULL)
+            {
+              victim = text;
+            }
+        }
+      else if (strcmp(text->path, filename) == 0)
+        {
+          /* Another load of the same file was faster */
+
+          victim = NULL;
+          break;
+        }
+      else if (victim == NULL && text->textenv->refs == 1)
+        {
+          victim = text;
+        }
+    }
+
+  if (victim != NULL)
+    {
+      if (victim->path != NULL)
+        {
+          elf_text_free(victim);
+        }
+
+      addrenv_take(loadinfo->textenv);
+      victim->textenv = loadinfo->textenv;
+      victim->ino     = loadinfo->fileino;
+      victim->size    = loadinfo->filelen;
+      victim->mtime   = loadinfo->filemtime;
+      victim->path    = path;
+      path            = NULL;
+    }
+
+  nxmutex_unlock(&g_elf_textlock);
+  kmm_free(path);
+}
+#endif
+
 /****************************************************************************
  * Name: elf_loadbinary
  *
@@ -108,6 +288,15 @@ static int elf_loadbinary(FAR struct binary_s *binp,
       return ret;
     }
 
+#ifdef CONFIG_ELF_SHARED_TEXT
+  /* A fully linked program may reuse the .text of an earlier instance */
+
+  if (loadinfo.ehdr.e_type == ET_EXEC)
+    {
+      elf_text_find(filename, &loadinfo);
+    }
+#endif
+
   /* Load the program binary */
 
   ret = modlib_load_with_addrenv(&loadinfo);
@@ -225,6 +414,10 @@ static int elf_loadbinary(FAR struct binary_s *binp,
     }
 #endif
 
+#ifdef CONFIG_ELF_SHARED_TEXT
+  elf_text_insert(filename, &loadinfo);
+#endif
+
   modlib_uninitialize(&loadinfo);
   return OK;
 
@@ -35,6 +35,8 @@
 #include <sys/types.h>
 #include <crypto/aes.h>
 
+#include "aes_accel.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -844,6 +846,25 @@ void aes_ct_bitslice_decrypt(unsigned num_rounds,
 
 int aes_setkey(FAR AES_CTX *ctx, FAR const uint8_t *key, int len)
 {
+#ifdef HAVE_AES_ACCEL
+  /* Keep the plain key schedule for the AES instructions of the CPU */
+
+  ctx->accel = (aes_accel_probe() & AES_ACCEL_AES) != 0;
+  if (ctx->accel)
+    {
+      ctx->num_rounds = aes_keysched_base(ctx->sk, key, len);
+      if (ctx->num_rounds == 0)
+        {
+          return -1;
+        }
+
+      aes_accel_setkey(ctx);
+      return 0;
+    }
+#else
+  ctx->accel = 0;
+#endif
+
   ctx->num_rounds = aes_ct_keysched(ctx->sk, key, len);
   if (ctx->num_rounds == 0)
     {
@@ -857,6 +878,14 @@ int aes_setkey(FAR AES_CTX *ctx, FAR const uint8_t *key, int len)
 void aes_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
                      FAR uint8_t *dst, size_t num_blocks)
 {
+#ifdef HAVE_AES_ACCEL
+  if (ctx->accel)
+    {
+      aes_accel_encrypt_ecb(ctx, src, dst, num_blocks);
+      return;
+    }
+#endif
+
   while (num_blocks > 0)
     {
       uint32_t q[8];
@@ -907,6 +936,14 @@ void aes_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
 void aes_decrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
                      FAR uint8_t *dst, size_t num_blocks)
 {
+#ifdef HAVE_AES_ACCEL
+  if (ctx->accel)
+    {
+      aes_accel_decrypt_ecb(ctx, src, dst, num_blocks);
+      return;
+    }
+#endif
+
   while (num_blocks > 0)
     {
       uint32_t q[8];
@@ -0,0 +1,373 @@
+/****************************************************************************
+ * crypto/aes_accel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The AES kernels that use the instructions of the CPU: AES-NI on x86_64,
+ * the Armv8 Cryptographic Extension on arm64 and Zkne/Zknd on RV64.  They
+ * take no data dependent branches or table lookups, like the bitsliced
+ * code of aes.c, and run an order of magnitude faster.  All of them use
+ * the equivalent inverse cipher of FIPS-197 for decryption, so the
+ * decryption round keys are the encryption ones in reverse order, with
+ * InvMixColumns applied to the inner ones.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <crypto/aes.h>
+
+#include "aes_accel.h"
+
+#ifdef HAVE_AES_ACCEL
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if defined(AES_ACCEL_X86_64)
+typedef long long aes_block_t __attribute__((vector_size(16)));
+#elif defined(AES_ACCEL_ARM64)
+typedef uint8_t aes_block_t __attribute__((vector_size(16)));
+#else
+typedef uint64_t aes_block_t __attribute__((vector_size(16)));
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The result of aes_accel_probe(), -1 until the CPU was asked */
+
+static int g_aes_accel = -1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline aes_block_t aes_load(FAR const void *src)
+{
+  aes_block_t x;
+
+  memcpy(&x, src, sizeof(x));
+  return x;
+}
+
+static inline void aes_store(FAR void *dst, aes_block_t x)
+{
+  memcpy(dst, &x, sizeof(x));
+}
+
+#if defined(AES_ACCEL_X86_64)
+
+static unsigned int aes_cpu_probe(void)
+{
+  unsigned int features = 0;
+  uint32_t eax = 1;
+  uint32_t ebx;
+  uint32_t ecx = 0;
+  uint32_t edx;
+
+  __asm__("cpuid" : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx));
+
+  if (ecx & (1 << 25))
+    {
+      features |= AES_ACCEL_AES;
+    }
+
+  if (ecx & (1 << 1))
+    {
+      features |= AES_ACCEL_CLMUL;
+    }
+
+  return features;
+}
+
+static inline aes_block_t aes_invmix(aes_block_t x)
+{
+  __asm__("aesimc %0, %0" : "+x"(x));
+  return x;
+}
+
+static void aes_encrypt_block(FAR const uint8_t *rk, unsigned nr,
+                              FAR const uint8_t *src, FAR uint8_t *dst)
+{
+  aes_block_t s = aes_load(src) ^ aes_load(rk);
+  unsigned i;
+
+  for (i = 1; i < nr; i++)
+    {
+      __asm__("aesenc %1, %0" : "+x"(s) : "x"(aes_load(rk + 16 * i)));
+    }
+
+  __asm__("aesenclast %1, %0" : "+x"(s) : "x"(aes_load(rk + 16 * nr)));
+  aes_store(dst, s);
+}
+
+static void aes_decrypt_block(FAR const uint8_t *dk, unsigned nr,
+                              FAR const uint8_t *src, FAR uint8_t *dst)
+{
+  aes_block_t s = aes_load(src) ^ aes_load(dk);
+  unsigned i;
+
+  for (i = 1; i < nr; i++)
+    {
+      __asm__("aesdec %1, %0" : "+x"(s) : "x"(aes_load(dk + 16 * i)));
+    }
+
+  __asm__("aesdeclast %1, %0" : "+x"(s) : "x"(aes_load(dk + 16 * nr)));
+  aes_store(dst, s);
+}
+
+#elif defined(AES_ACCEL_ARM64)
+
+static unsigned int aes_cpu_probe(void)
+{
+  unsigned int features = 0;
+  uint64_t isar0;
+
+  /* ID_AA64ISAR0_EL1.AES is 1 for AESE and friends, 2 adds PMULL */
+
+  __asm__("mrs %0, id_aa64isar0_el1" : "=r"(isar0));
+
+  switch ((isar0 >> 4) & 0xf)
+    {
+      case 2:
+        features |= AES_ACCEL_CLMUL;
+
+        /* Fall through */
+
+      case 1:
+        features |= AES_ACCEL_AES;
+        break;
+
+      default:
+        break;
+    }
+
+  return features;
+}
+
+static inline aes_block_t aes_invmix(aes_block_t x)
+{
+  __asm__(".arch_extension crypto\n"
+          "aesimc %0.16b, %0.16b" : "+w"(x));
+  return x;
+}
+
+/* AESE adds the round key before SubBytes, so the last key is added
+ * separately.
+ */
+
+static void aes_encrypt_block(FAR const uint8_t *rk, unsigned nr,
+                              FAR const uint8_t *src, FAR uint8_t *dst)
+{
+  aes_block_t s = aes_load(src);
+  unsigned i;
+
+  for (i = 0; i < nr - 1; i++)
+    {
+      __asm__(".arch_extension crypto\n"
+              "aese %0.16b, %1.16b\n"
+              "aesmc %0.16b, %0.16b"
+              : "+w"(s) : "w"(aes_load(rk + 16 * i)));
+    }
+
+  __asm__(".arch_extension crypto\n"
+          "aese %0.16b, %1.16b" : "+w"(s) : "w"(aes_load(rk + 16 * i)));
+  aes_store(dst, s ^ aes_load(rk + 16 * nr));
+}
+
+static void aes_decrypt_block(FAR const uint8_t *dk, unsigned nr,
+                              FAR const uint8_t *src, FAR uint8_t *dst)
+{
+  aes_block_t s = aes_load(src);
+  unsigned i;
+
+  for (i = 0; i < nr - 1; i++)
+    {
+      __asm__(".arch_extension crypto\n"
+              "aesd %0.16b, %1.16b\n"
+              "aesimc %0.16b, %0.16b"
+              : "+w"(s) : "w"(aes_load(dk + 16 * i)));
+    }
+
+  __asm__(".arch_extension crypto\n"
+          "aesd %0.16b, %1.16b" : "+w"(s) : "w"(aes_load(dk + 16 * i)));
+  aes_store(dst, s ^ aes_load(dk + 16 * nr));
+}
+
+#elif defined(AES_ACCEL_RV64)
+
+/* RISC-V has no portable way to ask for the scalar crypto extensions, so
+ * they are taken for granted if the compiler targets them.
+ */
+
+static unsigned int aes_cpu_probe(void)
+{
+#ifdef __riscv_zbkc
+  return AES_ACCEL_AES | AES_ACCEL_CLMUL;
+#else
+  return AES_ACCEL_AES;
+#endif
+}
+
+/* The Zkne and Zknd instructions return one half of the state, the half
+ * selected by the order of the two source halves.
+ */
+
+#define AES_RV64_OP(op, a, b) \
+  ({ \
+    uint64_t r__; \
+    __asm__(op " %0, %1, %2" : "=r"(r__) : "r"(a), "r"(b)); \
+    r__; \
+  })
+
+static inline aes_block_t aes_invmix(aes_block_t x)
+{
+  aes_block_t r;
+  uint64_t lo = x[0];
+  uint64_t hi = x[1];
+
+  __asm__("aes64im %0, %1" : "=r"(lo) : "r"(lo));
+  __asm__("aes64im %0, %1" : "=r"(hi) : "r"(hi));
+  r[0] = lo;
+  r[1] = hi;
+  return r;
+}
+
+static void aes_encrypt_block(FAR const uint8_t *rk, unsigned nr,
+                              FAR const uint8_t *src, FAR uint8_t *dst)
+{
+  aes_block_t s = aes_load(src) ^ aes_load(rk);
+  aes_block_t k;
+  uint64_t lo;
+  uint64_t hi;
+  unsigned i;
+
+  for (i = 1; i < nr; i++)
+    {
+      k    = aes_load(rk + 16 * i);
+      lo   = AES_RV64_OP("aes64esm", s[0], s[1]);
+      hi   = AES_RV64_OP("aes64esm", s[1], s[0]);
+      s[0] = lo ^ k[0];
+      s[1] = hi ^ k[1];
+    }
+
+  k    = aes_load(rk + 16 * nr);
+  lo   = AES_RV64_OP("aes64es", s[0], s[1]);
+  hi   = AES_RV64_OP("aes64es", s[1], s[0]);
+  s[0] = lo ^ k[0];
+  s[1] = hi ^ k[1];
+  aes_store(dst, s);
+}
+
+static void aes_decrypt_block(FAR const uint8_t *dk, unsigned nr,
+                              FAR const uint8_t *src, FAR uint8_t *dst)
+{
+  aes_block_t s = aes_load(src) ^ aes_load(dk);
+  aes_block_t k;
+  uint64_t lo;
+  uint64_t hi;
+  unsigned i;
+
+  for (i = 1; i < nr; i++)
+    {
+      k    = aes_load(dk + 16 * i);
+      lo   = AES_RV64_OP("aes64dsm", s[0], s[1]);
+      hi   = AES_RV64_OP("aes64dsm", s[1], s[0]);
+      s[0] = lo ^ k[0];
+      s[1] = hi ^ k[1];
+    }
+
+  k    = aes_load(dk + 16 * nr);
+  lo   = AES_RV64_OP("aes64ds", s[0], s[1]);
+  hi   = AES_RV64_OP("aes64ds", s[1], s[0]);
+  s[0] = lo ^ k[0];
+  s[1] = hi ^ k[1];
+  aes_store(dst, s);
+}
+
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+unsigned int aes_accel_probe(void)
+{
+  if (g_aes_accel < 0)
+    {
+      g_aes_accel = aes_cpu_probe();
+    }
+
+  return g_aes_accel;
+}
+
+void aes_accel_setkey(FAR AES_CTX *ctx)
+{
+  FAR const uint8_t *rk = (FAR const uint8_t *)ctx->sk;
+  FAR uint8_t *dk = (FAR uint8_t *)ctx->sk_exp;
+  unsigned nr = ctx->num_rounds;
+  unsigned i;
+
+  memcpy(dk, rk + 16 * nr, 16);
+  for (i = 1; i < nr; i++)
+    {
+      aes_store(dk + 16 * i, aes_invmix(aes_load(rk + 16 * (nr - i))));
+    }
+
+  memcpy(dk + 16 * nr, rk, 16);
+}
+
+void aes_accel_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                           FAR uint8_t *dst, size_t num_blocks)
+{
+  FAR const uint8_t *rk = (FAR const uint8_t *)ctx->sk;
+
+  while (num_blocks-- > 0)
+    {
+      aes_encrypt_block(rk, ctx->num_rounds, src, dst);
+      src += 16;
+      dst += 16;
+    }
+}
+
+void aes_accel_decrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                           FAR uint8_t *dst, size_t num_blocks)
+{
+  FAR const uint8_t *dk = (FAR const uint8_t *)ctx->sk_exp;
+
+  while (num_blocks-- > 0)
+    {
+      aes_decrypt_block(dk, ctx->num_rounds, src, dst);
+      src += 16;
+      dst += 16;
+    }
+}
+
+#endif /* HAVE_AES_ACCEL */
@@ -0,0 +1,162 @@
+/****************************************************************************
+ * crypto/aes_accel.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __CRYPTO_AES_ACCEL_H
+#define __CRYPTO_AES_ACCEL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <crypto/aes.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The kernels load the round keys and the data as byte strings, which only
+ * matches the word layout of aes.c on little endian CPUs.
+ */
+
+#if defined(CONFIG_CRYPTO_AES_ACCEL) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#  if defined(__x86_64__)
+#    define AES_ACCEL_X86_64 1
+#  elif defined(__aarch64__)
+#    define AES_ACCEL_ARM64 1
+#  elif defined(__riscv) && __riscv_xlen == 64 && \
+        defined(__riscv_zkne) && defined(__riscv_zknd)
+#    define AES_ACCEL_RV64 1
+#  endif
+#endif
+
+#if defined(AES_ACCEL_X86_64) || defined(AES_ACCEL_ARM64) || \
+    defined(AES_ACCEL_RV64)
+#  define HAVE_AES_ACCEL 1
+#endif
+
+/* The instructions found by aes_accel_probe() */
+
+#define AES_ACCEL_AES   (1 << 0) /* The AES round instructions */
+#define AES_ACCEL_CLMUL (1 << 1) /* The 64-bit carry-less multiply */
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef HAVE_AES_ACCEL
+
+/****************************************************************************
+ * Name: aes_accel_clmul
+ *
+ * Description:
+ *   Return the 128-bit carry-less product of 'a' and 'b'.  Only call it if
+ *   aes_accel_probe() found AES_ACCEL_CLMUL.
+ *
+ ****************************************************************************/
+
+static inline void aes_accel_clmul(uint64_t a, uint64_t b,
+                                   FAR uint64_t *hi, FAR uint64_t *lo)
+{
+#if defined(AES_ACCEL_X86_64)
+  typedef long long v2di __attribute__((vector_size(16)));
+  v2di x;
+  v2di y;
+
+  x[0] = a;
+  x[1] = 0;
+  y[0] = b;
+  y[1] = 0;
+  __asm__("pclmulqdq $0x00, %1, %0" : "+x"(x) : "x"(y));
+  *lo = (uint64_t)x[0];
+  *hi = (uint64_t)x[1];
+#elif defined(AES_ACCEL_ARM64)
+  typedef uint64_t v2du __attribute__((vector_size(16)));
+  v2du x;
+  v2du y;
+  v2du r;
+
+  x[0] = a;
+  x[1] = 0;
+  y[0] = b;
+  y[1] = 0;
+  __asm__(".arch_extension crypto\n"
+          "pmull %0.1q, %1.1d, %2.1d" : "=w"(r) : "w"(x), "w"(y));
+  *lo = r[0];
+  *hi = r[1];
+#elif defined(AES_ACCEL_RV64)
+  __asm__("clmul %0, %1, %2" : "=r"(*lo) : "r"(a), "r"(b));
+  __asm__("clmulh %0, %1, %2" : "=r"(*hi) : "r"(a), "r"(b));
+#endif
+}
+
+#endif /* HAVE_AES_ACCEL */
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef HAVE_AES_ACCEL
+
+/****************************************************************************
+ * Name: aes_accel_probe
+ *
+ * Description:
+ *   Return the AES_ACCEL_* instructions that this CPU implements.  The
+ *   CPU is only asked once.
+ *
+ ****************************************************************************/
+
+unsigned int aes_accel_probe(void);
+
+/****************************************************************************
+ * Name: aes_accel_setkey
+ *
+ * Description:
+ *   Derive the decryption round keys in ctx->sk_exp from the encryption
+ *   round keys in ctx->sk, which are in the FIPS-197 order.
+ *
+ ****************************************************************************/
+
+void aes_accel_setkey(FAR AES_CTX *ctx);
+
+/****************************************************************************
+ * Name: aes_accel_encrypt_ecb and aes_accel_decrypt_ecb
+ *
+ * Description:
+ *   Encrypt or decrypt 'num_blocks' blocks with the AES instructions.
+ *
+ ****************************************************************************/
+
+void aes_accel_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                           FAR uint8_t *dst, size_t num_blocks);
+void aes_accel_decrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                           FAR uint8_t *dst, size_t num_blocks);
+
+#endif /* HAVE_AES_ACCEL */
+
+#endif /* __CRYPTO_AES_ACCEL_H */
@@ -146,6 +146,137 @@ static void chacha_ivsetup(FAR chacha_ctx *x,
   x->input[15] = U8TO32_LITTLE(iv + 4);
 }
 
+#ifdef CONFIG_CRYPTO_CHACHA_SIMD
+
+/* Four blocks are computed at once, one in each lane of the vectors, which
+ * the compiler maps to the 128-bit registers of NEON, MVE, SSE2 or RVV.
+ */
+
+#define CHACHA_SIMD_BLOCKS 4
+#define CHACHA_SIMD_BYTES  (CHACHA_SIMD_BLOCKS * 64)
+
+typedef uint32_t chacha_vec_t
+  __attribute__((vector_size(CHACHA_SIMD_BLOCKS * sizeof(uint32_t))));
+
+#ifdef __clang__
+#  define VSHUFFLE(a, b, i0, i1, i2, i3) \
+     __builtin_shufflevector(a, b, i0, i1, i2, i3)
+#else
+#  define VSHUFFLE(a, b, i0, i1, i2, i3) \
+     __builtin_shuffle(a, b, (chacha_vec_t){ i0, i1, i2, i3 })
+#endif
+
+#define VROTATE(v, c) (((v) << (c)) | ((v) >> (32 - (c))))
+
+#define VQUARTERROUND(a, b, c, d)                   \
+  do                                                \
+    {                                               \
+      a += b; d = VROTATE(d ^ a, 16);               \
+      c += d; b = VROTATE(b ^ c, 12);               \
+      a += b; d = VROTATE(d ^ a, 8);                \
+      c += d; b = VROTATE(b ^ c, 7);                \
+    }                                               \
+  while (0)
+
+static void chacha_encrypt_simd(FAR chacha_ctx *x,
+                                FAR const uint8_t *m,
+                                FAR uint8_t *c)
+{
+  chacha_vec_t v[16];
+  chacha_vec_t j[16];
+  chacha_vec_t t[4];
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+  uint32_t w;
+#endif
+  u_int i;
+  u_int k;
+
+  for (k = 0; k < 16; k++)
+    {
+      for (i = 0; i < CHACHA_SIMD_BLOCKS; i++)
+        {
+          j[k][i] = x->input[k];
+        }
+    }
+
+  /* Block i uses the counter + i, with the carry into input[13] */
+
+  for (i = 0; i < CHACHA_SIMD_BLOCKS; i++)
+    {
+      j[12][i] = PLUS(x->input[12], i);
+      j[13][i] = PLUS(x->input[13], j[12][i] < x->input[12]);
+    }
+
+  memcpy(v, j, sizeof(v));
+  for (i = 20; i > 0; i -= 2)
+    {
+      VQUARTERROUND(v[0], v[4], v[8], v[12]);
+      VQUARTERROUND(v[1], v[5], v[9], v[13]);
+      VQUARTERROUND(v[2], v[6], v[10], v[14]);
+      VQUARTERROUND(v[3], v[7], v[11], v[15]);
+      VQUARTERROUND(v[0], v[5], v[10], v[15]);
+      VQUARTERROUND(v[1], v[6], v[11], v[12]);
+      VQUARTERROUND(v[2], v[7], v[8], v[13]);
+      VQUARTERROUND(v[3], v[4], v[9], v[14]);
+    }
+
+  for (k = 0; k < 16; k++)
+    {
+      v[k] += j[k];
+    }
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  /* Transpose each group of four words, so that every vector holds 16
+   * bytes of one block.
+   */
+
+  for (k = 0; k < 16; k += 4)
+    {
+      t[0] = VSHUFFLE(v[k + 0], v[k + 1], 0, 4, 1, 5);
+      t[1] = VSHUFFLE(v[k + 0], v[k + 1], 2, 6, 3, 7);
+      t[2] = VSHUFFLE(v[k + 2], v[k + 3], 0, 4, 1, 5);
+      t[3] = VSHUFFLE(v[k + 2], v[k + 3], 2, 6, 3, 7);
+      v[k + 0] = VSHUFFLE(t[0], t[2], 0, 1, 4, 5);
+      v[k + 1] = VSHUFFLE(t[0], t[2], 2, 3, 6, 7);
+      v[k + 2] = VSHUFFLE(t[1], t[3], 0, 1, 4, 5);
+      v[k + 3] = VSHUFFLE(t[1], t[3], 2, 3, 6, 7);
+    }
+
+  for (i = 0; i < CHACHA_SIMD_BLOCKS; i++)
+    {
+      for (k = 0; k < 4; k++)
+        {
+          t[0] = v[4 * k + i];
+#ifndef KEYSTREAM_ONLY
+          memcpy(&t[1], m + 64 * i + 16 * k, sizeof(t[1]));
+          t[0] ^= t[1];
+#endif
+          memcpy(c + 64 * i + 16 * k, &t[0], sizeof(t[0]));
+        }
+    }
+#else
+  for (i = 0; i < CHACHA_SIMD_BLOCKS; i++)
+    {
+      for (k = 0; k < 16; k++)
+        {
+          w = v[k][i];
+#ifndef KEYSTREAM_ONLY
+          w = XOR(w, U8TO32_LITTLE(m + 64 * i + 4 * k));
+#endif
+          U32TO8_LITTLE(c + 64 * i + 4 * k, w);
+        }
+    }
+#endif
+
+  x->input[12] = PLUS(x->input[12], CHACHA_SIMD_BLOCKS);
+  if (x->input[12] < CHACHA_SIMD_BLOCKS)
+    {
+      x->input[13] = PLUSONE(x->input[13]);
+    }
+}
+
+#endif /* CONFIG_CRYPTO_CHACHA_SIMD */
+
 static void chacha_encrypt_bytes(FAR chacha_ctx *x,
                                  FAR const uint8_t *m,
                                  FAR uint8_t *c,
@@ -187,6 +318,18 @@ static void chacha_encrypt_bytes(FAR chacha_ctx *x,
   uint8_t tmp[64];
   u_int i;
 
+#ifdef CONFIG_CRYPTO_CHACHA_SIMD
+  while (bytes >= CHACHA_SIMD_BYTES)
+    {
+      chacha_encrypt_simd(x, m, c);
+      bytes -= CHACHA_SIMD_BYTES;
+      c += CHACHA_SIMD_BYTES;
+#ifndef KEYSTREAM_ONLY
+      m += CHACHA_SIMD_BYTES;
+#endif
+    }
+
+#endif
   if (!bytes)
     {
       return;
@@ -38,6 +38,8 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/mutex.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/crypto/crypto.h>
 
 /****************************************************************************
@@ -53,11 +55,61 @@ int crypto_drivers_num = 0;
 
 static mutex_t g_crypto_lock = NXMUTEX_INITIALIZER;
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/* The requests queued by crypto_dispatch(), in the order they came */
+
+static TAILQ_HEAD(, cryptop) g_crypto_queue =
+  TAILQ_HEAD_INITIALIZER(g_crypto_queue);
+static spinlock_t g_crypto_qlock = SP_UNLOCKED;
+static struct work_s g_crypto_work;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/* Run all requests in the queue, so that a batch queued at once costs
+ * one wakeup of the worker.  A single worker keeps the requests of each
+ * session in order.
+ */
+
+static void crypto_worker(FAR void *arg)
+{
+  FAR struct cryptop *crp;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&g_crypto_qlock);
+      crp = TAILQ_FIRST(&g_crypto_queue);
+      if (crp != NULL)
+        {
+          TAILQ_REMOVE(&g_crypto_queue, crp, crp_next);
+        }
+
+      spin_unlock_irqrestore(&g_crypto_qlock, flags);
+
+      if (crp == NULL)
+        {
+          break;
+        }
+
+      crypto_invoke(crp);
+      crp->crp_flags |= CRYPTO_F_DONE;
+      crp->crp_callback(crp);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
-/* Create a new session. */
+/* Create a new session.  With 'hard' 0 any driver will do and hardware
+ * drivers are preferred, a positive 'hard' only takes hardware drivers and
+ * a negative one only software drivers.
+ */
 
 int crypto_newsession(FAR uint64_t *sid,
                       FAR struct cryptoini *cri,
@@ -68,7 +120,7 @@ int crypto_newsession(FAR uint64_t *sid,
   uint32_t hid2 = -1;
   FAR struct cryptocap *cpc;
   FAR struct cryptoini *cr;
-  int turn = 0;
+  int turn = hard < 0;
   int err;
 
   if (crypto_drivers == NULL)
@@ -624,6 +676,37 @@ migrate:
   return 0;
 }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/* Queue a crypto request for the crypto worker, which calls crp_callback
+ * once the request completed.
+ */
+
+int crypto_dispatch(FAR struct cryptop *crp)
+{
+  irqstate_t flags;
+  bool idle;
+
+  if (crp == NULL || crp->crp_callback == NULL)
+    {
+      return -EINVAL;
+    }
+
+  crp->crp_flags &= ~CRYPTO_F_DONE;
+
+  flags = spin_lock_irqsave(&g_crypto_qlock);
+  idle = TAILQ_EMPTY(&g_crypto_queue);
+  TAILQ_INSERT_TAIL(&g_crypto_queue, crp, crp_next);
+  spin_unlock_irqrestore(&g_crypto_qlock, flags);
+
+  if (idle && work_available(&g_crypto_work))
+    {
+      work_queue(LPWORK, &g_crypto_work, crypto_worker, NULL, 0);
+    }
+
+  return OK;
+}
+#endif
+
 /* Release a set of crypto descriptors. */
 
 void crypto_freereq(FAR struct cryptop *crp)
@@ -0,0 +1,565 @@
+/****************************************************************************
+ * crypto/crypto_bench.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The benchmark mode of the crypto tests: /proc/cryptobench drives the
+ * registered drivers through the same crypto_invoke() and crypto_dispatch()
+ * calls as the CIOCCRYPT and CIOCASYNCCRYPT requests of /dev/crypto.  The
+ * known answer tests of testmngr.c run at boot, before the drivers are
+ * registered and the work queues run, so the benchmark waits for a reader.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/param.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/crypto/crypto.h>
+
+#include <crypto/cryptodev.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each measurement runs enough requests of one size to process
+ * CBENCH_BYTES bytes, and at least CBENCH_MINREQS requests.  The async
+ * path keeps up to CBENCH_DEPTH requests queued.
+ */
+
+#define CBENCH_MINSIZE 64
+#define CBENCH_MAXSIZE 65536
+#define CBENCH_BYTES   CONFIG_CRYPTO_CRYPTODEV_BENCHMARK_BYTES
+#define CBENCH_MINREQS 16
+#define CBENCH_DEPTH   8
+#define CBENCH_LINELEN 64
+
+/* Sizes 64, 256, ..., 65536 */
+
+#define CBENCH_NSIZES  6
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+#  define CBENCH_NPATHS 2
+#else
+#  define CBENCH_NPATHS 1
+#endif
+
+/* The header, and one line per algorithm, driver, size and path */
+
+#define CBENCH_TEXTLEN \
+  (CBENCH_LINELEN * (1 + nitems(g_cbench_algs) * 2 * CBENCH_NSIZES * \
+                     CBENCH_NPATHS))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct cbench_alg_s
+{
+  FAR const char *name;
+  int alg;
+  int klen;   /* Key bytes, 0 for a plain hash */
+  bool cipher;
+};
+
+/* One algorithm on one driver */
+
+struct cbench_s
+{
+  FAR const struct cbench_alg_s *alg;
+  uint64_t sid;
+  size_t size;
+  FAR uint8_t *src;
+  FAR uint8_t *dst;
+  uint8_t key[36];
+  uint8_t iv[16];
+  uint8_t mac[64];
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  sem_t done;      /* Posted for each completed request */
+  clock_t latency; /* Sum of the dispatch to completion times */
+#endif
+};
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+struct cbench_req_s
+{
+  FAR struct cryptop *crp;
+  FAR struct cbench_s *bench;
+  clock_t start;
+};
+#endif
+
+/* The open /proc/cryptobench, which holds the whole table */
+
+struct cbench_file_s
+{
+  struct procfs_file_s base;
+  FAR char *text;
+  size_t len;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int cbench_open(FAR struct file *filep, FAR const char *relpath,
+                       int oflags, mode_t mode);
+static int cbench_close(FAR struct file *filep);
+static ssize_t cbench_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen);
+static int cbench_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct cbench_alg_s g_cbench_algs[] =
+{
+  {
+    "aes-128-cbc", CRYPTO_AES_CBC, 16, true
+  },
+  {
+    "aes-256-cbc", CRYPTO_AES_CBC, 32, true
+  },
+
+  /* The AES-CTR key is followed by the 4 bytes of nonce */
+
+  {
+    "aes-128-ctr", CRYPTO_AES_CTR, 16 + 4, true
+  },
+  {
+    "aes-256-ctr", CRYPTO_AES_CTR, 32 + 4, true
+  },
+  {
+    "sha256", CRYPTO_SHA2_256, 0, false
+  },
+  {
+    "hmac-sha256", CRYPTO_SHA2_256_HMAC, 32, false
+  },
+};
+
+static const struct procfs_operations g_cbench_operations =
+{
+  cbench_open,  /* open */
+  cbench_close, /* close */
+  cbench_read,  /* read */
+  NULL,         /* write */
+  NULL,         /* poll */
+  NULL,         /* dup */
+  NULL,         /* opendir */
+  NULL,         /* closedir */
+  NULL,         /* readdir */
+  NULL,         /* rewinddir */
+  cbench_stat   /* stat */
+};
+
+static const struct procfs_entry_s g_cbench_procfs =
+{
+  "cryptobench", &g_cbench_operations
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Fill in a request the way cryptodev does for CIOCCRYPT */
+
+static void cbench_prepare(FAR struct cbench_s *b, FAR struct cryptop *crp)
+{
+  FAR struct cryptodesc *crd = crp->crp_desc;
+
+  crd->crd_skip = 0;
+  crd->crd_len = b->size;
+  crd->crd_inject = 0;
+  crd->crd_flags = b->alg->cipher ? CRD_F_ENCRYPT : 0;
+  crd->crd_alg = b->alg->alg;
+  crd->crd_key = (caddr_t)b->key;
+  crd->crd_klen = b->alg->klen * 8;
+
+  crp->crp_ilen = b->size;
+  crp->crp_buf = b->src;
+  crp->crp_sid = b->sid;
+  crp->crp_flags = CRYPTO_F_IOV;
+  crp->crp_etype = 0;
+
+  if (b->alg->cipher)
+    {
+      crp->crp_iv = (caddr_t)b->iv;
+      crp->crp_dst = (caddr_t)b->dst;
+      crp->crp_mac = NULL;
+    }
+  else
+    {
+      crp->crp_iv = NULL;
+      crp->crp_dst = NULL;
+      crp->crp_mac = (caddr_t)b->mac;
+    }
+}
+
+/* Run the requests one after the other with crypto_invoke(), as
+ * CIOCCRYPT does.
+ */
+
+static int cbench_sync(FAR struct cbench_s *b, int nreqs,
+                       FAR clock_t *elapsed, FAR clock_t *latency)
+{
+  FAR struct cryptop *crp;
+  clock_t start;
+  int ret = OK;
+  int i;
+
+  crp = crypto_getreq(1);
+  if (crp == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  start = perf_gettime();
+  for (i = 0; i < nreqs; i++)
+    {
+      cbench_prepare(b, crp);
+      crypto_invoke(crp);
+      if (crp->crp_etype != 0)
+        {
+          ret = crp->crp_etype;
+          break;
+        }
+    }
+
+  *elapsed = perf_gettime() - start;
+  *latency = *elapsed / nreqs;
+  crypto_freereq(crp);
+  return ret;
+}
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static int cbench_done(FAR struct cryptop *crp)
+{
+  FAR struct cbench_req_s *req = crp->crp_opaque;
+
+  /* The crypto worker completes one request at a time */
+
+  req->bench->latency += perf_gettime() - req->start;
+  nxsem_post(&req->bench->done);
+  return OK;
+}
+
+/* Queue the requests with crypto_dispatch() in batches of CBENCH_DEPTH,
+ * as CIOCASYNCCRYPT does.
+ */
+
+static int cbench_async(FAR struct cbench_s *b, int nreqs,
+                        FAR clock_t *elapsed, FAR clock_t *latency)
+{
+  struct cbench_req_s reqs[CBENCH_DEPTH];
+  clock_t start;
+  int queued;
+  int ret = OK;
+  int i;
+  int j;
+
+  memset(reqs, 0, sizeof(reqs));
+  for (j = 0; j < CBENCH_DEPTH; j++)
+    {
+      reqs[j].crp = crypto_getreq(1);
+      if (reqs[j].crp == NULL)
+        {
+          ret = -ENOMEM;
+          goto out;
+        }
+
+      reqs[j].bench = b;
+    }
+
+  nxsem_init(&b->done, 0, 0);
+  b->latency = 0;
+
+  start = perf_gettime();
+  for (i = 0; i < nreqs && ret == OK; i += queued)
+    {
+      for (queued = 0; queued < MIN(CBENCH_DEPTH, nreqs - i); queued++)
+        {
+          FAR struct cryptop *crp = reqs[queued].crp;
+
+          cbench_prepare(b, crp);
+          crp->crp_callback = cbench_done;
+          crp->crp_opaque = &reqs[queued];
+          reqs[queued].start = perf_gettime();
+          ret = crypto_dispatch(crp);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      for (j = 0; j < queued; j++)
+        {
+          nxsem_wait_uninterruptible(&b->done);
+          if (reqs[j].crp->crp_etype != 0)
+            {
+              ret = reqs[j].crp->crp_etype;
+            }
+        }
+
+      if (queued == 0)
+        {
+          break;
+        }
+    }
+
+  *elapsed = perf_gettime() - start;
+  *latency = b->latency / nreqs;
+  nxsem_destroy(&b->done);
+
+out:
+  for (j = 0; j < CBENCH_DEPTH; j++)
+    {
+      crypto_freereq(reqs[j].crp);
+    }
+
+  return ret;
+}
+#endif
+
+/* Measure every size on both paths and append one line for each */
+
+static void cbench_driver(FAR struct cbench_s *b, FAR const char *drv,
+                          FAR char *text, FAR size_t *len)
+{
+  FAR const char *path;
+  FAR char *line;
+  unsigned long freq = MAX(perf_getfreq(), 1);
+  uint64_t kibps;
+  uint64_t usecs;
+  clock_t elapsed;
+  clock_t latency;
+  int nreqs;
+  int ret;
+  int p;
+
+  for (b->size = CBENCH_MINSIZE; b->size <= CBENCH_MAXSIZE; b->size *= 4)
+    {
+      nreqs = MAX(CBENCH_BYTES / b->size, CBENCH_MINREQS);
+      for (p = 0; p < CBENCH_NPATHS; p++)
+        {
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+          if (p > 0)
+            {
+              path = "async";
+              ret = cbench_async(b, nreqs, &elapsed, &latency);
+            }
+          else
+#endif
+            {
+              path = "sync";
+              ret = cbench_sync(b, nreqs, &elapsed, &latency);
+            }
+
+          line = text + *len;
+          if (ret < 0)
+            {
+              *len += snprintf(line, CBENCH_LINELEN,
+                               "%-12s %-3s %-5s %6zu %10s %10d\n",
+                               b->alg->name, drv, path, b->size,
+                               "error", ret);
+            }
+          else
+            {
+              kibps = (uint64_t)b->size * nreqs * freq /
+                      MAX(elapsed, 1) / 1024;
+              usecs = (uint64_t)latency * 1000000 / freq;
+              *len += snprintf(line, CBENCH_LINELEN,
+                               "%-12s %-3s %-5s %6zu %10" PRIu64
+                               " %10" PRIu64 "\n",
+                               b->alg->name, drv, path, b->size,
+                               kibps, usecs);
+            }
+        }
+    }
+}
+
+/* Run every algorithm on the software and on the hardware drivers */
+
+static int cbench_generate(FAR struct cbench_file_s *file)
+{
+  FAR struct cbench_s *b;
+  struct cryptoini cri;
+  int hard;
+  int i;
+
+  b = kmm_zalloc(sizeof(*b));
+  file->text = kmm_malloc(CBENCH_TEXTLEN);
+  if (b != NULL)
+    {
+      b->src = kmm_zalloc(CBENCH_MAXSIZE);
+      b->dst = kmm_zalloc(CBENCH_MAXSIZE);
+    }
+
+  if (b == NULL || b->src == NULL || b->dst == NULL || file->text == NULL)
+    {
+      goto nomem;
+    }
+
+  file->len = snprintf(file->text, CBENCH_LINELEN,
+                       "%-12s %-3s %-5s %6s %10s %10s\n", "algorithm",
+                       "drv", "path", "size", "KiB/s", "latency/us");
+
+  for (i = 0; i < nitems(g_cbench_algs); i++)
+    {
+      b->alg = &g_cbench_algs[i];
+      for (hard = -1; hard <= 1; hard += 2)
+        {
+          memset(&cri, 0, sizeof(cri));
+          cri.cri_alg = b->alg->alg;
+          cri.cri_klen = b->alg->klen * 8;
+          cri.cri_key = (caddr_t)b->key;
+          if (!b->alg->cipher)
+            {
+              cri.cri_sid = -1;
+            }
+
+          /* Skip the drivers that do not implement the algorithm */
+
+          if (crypto_newsession(&b->sid, &cri, hard) < 0)
+            {
+              continue;
+            }
+
+          cbench_driver(b, hard < 0 ? "sw" : "hw", file->text, &file->len);
+          crypto_freesession(b->sid);
+        }
+    }
+
+  kmm_free(b->dst);
+  kmm_free(b->src);
+  kmm_free(b);
+  return OK;
+
+nomem:
+  if (b != NULL)
+    {
+      kmm_free(b->dst);
+      kmm_free(b->src);
+      kmm_free(b);
+    }
+
+  kmm_free(file->text);
+  file->text = NULL;
+  return -ENOMEM;
+}
+
+/* The benchmark runs when /proc/cryptobench is opened */
+
+static int cbench_open(FAR struct file *filep, FAR const char *relpath,
+                       int oflags, mode_t mode)
+{
+  FAR struct cbench_file_s *file;
+  int ret;
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      return -EACCES;
+    }
+
+  file = kmm_zalloc(sizeof(*file));
+  if (file == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = cbench_generate(file);
+  if (ret < 0)
+    {
+      kmm_free(file);
+      return ret;
+    }
+
+  filep->f_priv = file;
+  return OK;
+}
+
+static int cbench_close(FAR struct file *filep)
+{
+  FAR struct cbench_file_s *file = filep->f_priv;
+
+  kmm_free(file->text);
+  kmm_free(file);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+static ssize_t cbench_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct cbench_file_s *file = filep->f_priv;
+  off_t offset = filep->f_pos;
+  ssize_t ret;
+
+  ret = procfs_memcpy(file->text, file->len, buffer, buflen, &offset);
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+static int cbench_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crypto_bench_register
+ *
+ * Description:
+ *   Add /proc/cryptobench.  Each open of it measures the throughput and the
+ *   latency of the algorithms on the software and hardware drivers, which
+ *   are reported in the file.
+ *
+ ****************************************************************************/
+
+int crypto_bench_register(void)
+{
+  return procfs_register(&g_cbench_procfs);
+}
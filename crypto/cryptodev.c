@@ -42,6 +42,8 @@
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/drivers/drivers.h>
@@ -88,6 +90,9 @@ struct csession
   caddr_t mackey;
   int mackeylen;
   int error;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  unsigned int npending;
+#endif
 };
 
 struct fcrypt
@@ -96,8 +101,27 @@ struct fcrypt
   TAILQ_HEAD(cryptkoplist, cryptkop) crpk_ret;
   int sesn;
   FAR struct pollfd *fds;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  TAILQ_HEAD(cryptodev_reqlist, cryptodev_req) crp_ret;
+  mutex_t lock;             /* Protects crp_ret and the pending counts */
+  sem_t drainsem;           /* Posted by the last request after close */
+  unsigned int npending;    /* The requests queued but not completed */
+  bool closing;
+#endif
 };
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/* An asynchronous request, from CIOCASYNCCRYPT until CIOCASYNCFETCH */
+
+struct cryptodev_req
+{
+  TAILQ_ENTRY(cryptodev_req) next;
+  FAR struct fcrypt *fcr;
+  FAR struct csession *cse;
+  struct crypt_aop aop;
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -133,8 +157,20 @@ static FAR struct csession *csecreate(FAR struct fcrypt *, uint64_t,
                                       uint32_t, bool, bool);
 static int csefree(FAR struct csession *);
 
+static int cryptodev_getop(FAR struct csession *,
+                           FAR struct crypt_op *,
+                           FAR struct cryptop **);
+static int cryptodev_putop(FAR struct csession *,
+                           FAR struct crypt_op *,
+                           FAR struct cryptop *);
 static int cryptodev_op(FAR struct csession *,
                         FAR struct crypt_op *);
+static int cryptodev_mop(FAR struct fcrypt *, FAR struct crypt_mop *);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static int cryptodev_cb(FAR struct cryptop *);
+static int cryptodev_submit(FAR struct fcrypt *, FAR struct crypt_mop *);
+static int cryptodev_fetch(FAR struct fcrypt *, FAR struct crypt_mop *);
+#endif
 static int cryptodev_key(FAR struct fcrypt *, FAR struct crypt_kop *);
 static int cryptodevkey_cb(FAR struct cryptkop *);
 static int cryptodev_getkeystatus(FAR struct fcrypt *,
@@ -353,6 +389,15 @@ bail:
             return -EINVAL;
           }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+        /* The queued requests still use the keys of the session */
+
+        if (cse->npending > 0)
+          {
+            return -EBUSY;
+          }
+#endif
+
         csedelete(fcr, cse);
         error = csefree(cse);
         break;
@@ -366,6 +411,17 @@ bail:
 
         error = cryptodev_op(cse, cop);
         break;
+      case CIOCCRYPTM:
+        error = cryptodev_mop(fcr, (FAR struct crypt_mop *)arg);
+        break;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      case CIOCASYNCCRYPT:
+        error = cryptodev_submit(fcr, (FAR struct crypt_mop *)arg);
+        break;
+      case CIOCASYNCFETCH:
+        error = cryptodev_fetch(fcr, (FAR struct crypt_mop *)arg);
+        break;
+#endif
       case CIOCKEY:
         error = cryptodev_key(fcr, (FAR struct crypt_kop *)arg);
         break;
@@ -382,22 +438,21 @@ bail:
   return error;
 }
 
-static int cryptodev_op(FAR struct csession *cse,
-                        FAR struct crypt_op *cop)
+static int cryptodev_getop(FAR struct csession *cse,
+                           FAR struct crypt_op *cop,
+                           FAR struct cryptop **crpp)
 {
   FAR struct cryptop *crp = NULL;
   FAR struct cryptodesc *crde = NULL;
   FAR struct cryptodesc *crda = NULL;
   int error = OK;
-  uint32_t hid;
 
   /* number of requests, not logical and */
 
   crp = crypto_getreq(cse->txform + cse->thash);
   if (crp == NULL)
     {
-      error = -ENOMEM;
-      goto bail;
+      return -ENOMEM;
     }
 
   if (cse->thash)
@@ -494,6 +549,61 @@ static int cryptodev_op(FAR struct csession *cse,
       crp->crp_mac = cop->mac;
     }
 
+  *crpp = crp;
+  return OK;
+
+bail:
+  crypto_freereq(crp);
+  return error;
+}
+
+/* Collect the result of a request built by cryptodev_getop() and release
+ * the request.
+ */
+
+static int cryptodev_putop(FAR struct csession *cse,
+                           FAR struct crypt_op *cop,
+                           FAR struct cryptop *crp)
+{
+  FAR struct cryptodesc *crde = NULL;
+  int error = OK;
+
+  if (cse->txform)
+    {
+      crde = cse->thash ? crp->crp_desc->crd_next : crp->crp_desc;
+    }
+
+  if (crde && (cop->flags & COP_FLAG_UPDATE) == 0)
+    {
+      crde->crd_flags &= ~CRD_F_IV_EXPLICIT;
+    }
+
+  if (cse->error)
+    {
+      error = cse->error;
+    }
+  else if (crp->crp_etype != 0)
+    {
+      error = crp->crp_etype;
+    }
+
+  crypto_freereq(crp);
+  return error;
+}
+
+static int cryptodev_op(FAR struct csession *cse,
+                        FAR struct crypt_op *cop)
+{
+  FAR struct cryptop *crp;
+  uint32_t hid;
+  int error;
+
+  error = cryptodev_getop(cse, cop, &crp);
+  if (error < 0)
+    {
+      return error;
+    }
+
   /* try the fast path first */
 
   crp->crp_flags = CRYPTO_F_IOV | CRYPTO_F_NOQUEUE;
@@ -528,31 +638,184 @@ dispatch:
   crypto_invoke(crp);
 processed:
 
-  if (crde && (cop->flags & COP_FLAG_UPDATE) == 0)
+  return cryptodev_putop(cse, cop, crp);
+}
+
+/* Run a batch of requests one after the other, each one gets its own
+ * status.
+ */
+
+static int cryptodev_mop(FAR struct fcrypt *fcr, FAR struct crypt_mop *mop)
+{
+  FAR struct crypt_aop *aop;
+  FAR struct csession *cse;
+  uint32_t i;
+
+  if (mop->count > 0 && mop->reqs == NULL)
     {
-      crde->crd_flags &= ~CRD_F_IV_EXPLICIT;
+      return -EINVAL;
     }
 
-  if (cse->error)
+  for (i = 0; i < mop->count; i++)
     {
-      error = cse->error;
-      goto bail;
+      aop = &mop->reqs[i];
+      cse = csefind(fcr, aop->op.ses);
+      aop->status = cse != NULL ? cryptodev_op(cse, &aop->op) : -EINVAL;
     }
 
-  if (crp->crp_etype != 0)
+  return OK;
+}
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/* Called by the crypto worker when an asynchronous request completed */
+
+static int cryptodev_cb(FAR struct cryptop *crp)
+{
+  FAR struct cryptodev_req *req = crp->crp_opaque;
+  FAR struct fcrypt *fcr = req->fcr;
+
+  req->aop.status = cryptodev_putop(req->cse, &req->aop.op, crp);
+
+  nxmutex_lock(&fcr->lock);
+  req->cse->npending--;
+  fcr->npending--;
+  TAILQ_INSERT_TAIL(&fcr->crp_ret, req, next);
+  if (fcr->closing)
     {
-      error = crp->crp_etype;
-      goto bail;
+      if (fcr->npending == 0)
+        {
+          nxsem_post(&fcr->drainsem);
+        }
+    }
+  else if (fcr->fds != NULL)
+    {
+      poll_notify(&fcr->fds, 1, POLLIN);
     }
 
-bail:
-  if (crp)
+  nxmutex_unlock(&fcr->lock);
+  return OK;
+}
+
+/* Queue a batch of requests, stopping at the first one that can not be
+ * queued.  The number of queued requests is returned in mop->count.
+ */
+
+static int cryptodev_submit(FAR struct fcrypt *fcr,
+                            FAR struct crypt_mop *mop)
+{
+  FAR struct cryptodev_req *req;
+  FAR struct crypt_aop *aop;
+  FAR struct csession *cse;
+  FAR struct cryptop *crp;
+  int error = OK;
+  uint32_t i;
+
+  if (mop->count > 0 && mop->reqs == NULL)
     {
-      crypto_freereq(crp);
+      return -EINVAL;
     }
 
-  return error;
+  for (i = 0; i < mop->count; i++)
+    {
+      aop = &mop->reqs[i];
+      cse = csefind(fcr, aop->op.ses);
+      if (cse == NULL)
+        {
+          error = -EINVAL;
+          break;
+        }
+
+      req = kmm_zalloc(sizeof(struct cryptodev_req));
+      if (req == NULL)
+        {
+          error = -ENOMEM;
+          break;
+        }
+
+      req->aop = *aop;
+      error = cryptodev_getop(cse, &req->aop.op, &crp);
+      if (error < 0)
+        {
+          kmm_free(req);
+          break;
+        }
+
+      req->fcr = fcr;
+      req->cse = cse;
+      crp->crp_opaque = req;
+      crp->crp_callback = cryptodev_cb;
+      crp->crp_flags = CRYPTO_F_IOV;
+
+      /* Bound the requests that a session may have in flight */
+
+      nxmutex_lock(&fcr->lock);
+      if (cse->npending >= CONFIG_CRYPTO_CRYPTODEV_ASYNC_DEPTH)
+        {
+          nxmutex_unlock(&fcr->lock);
+          crypto_freereq(crp);
+          kmm_free(req);
+          error = -EAGAIN;
+          break;
+        }
+
+      cse->npending++;
+      fcr->npending++;
+      nxmutex_unlock(&fcr->lock);
+
+      error = crypto_dispatch(crp);
+      if (error < 0)
+        {
+          nxmutex_lock(&fcr->lock);
+          cse->npending--;
+          fcr->npending--;
+          nxmutex_unlock(&fcr->lock);
+          crypto_freereq(crp);
+          kmm_free(req);
+          break;
+        }
+    }
+
+  mop->count = i;
+  return i > 0 ? OK : error;
+}
+
+/* Return up to mop->count completed requests in the order they completed */
+
+static int cryptodev_fetch(FAR struct fcrypt *fcr, FAR struct crypt_mop *mop)
+{
+  FAR struct cryptodev_req *req;
+  uint32_t i;
+
+  if (mop->count > 0 && mop->reqs == NULL)
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&fcr->lock);
+  for (i = 0; i < mop->count; i++)
+    {
+      req = TAILQ_FIRST(&fcr->crp_ret);
+      if (req == NULL)
+        {
+          break;
+        }
+
+      TAILQ_REMOVE(&fcr->crp_ret, req, next);
+      mop->reqs[i] = req->aop;
+      kmm_free(req);
+    }
+
+  nxmutex_unlock(&fcr->lock);
+
+  if (i == 0 && mop->count > 0)
+    {
+      return -EAGAIN;
+    }
+
+  mop->count = i;
+  return OK;
 }
+#endif
 
 static int cryptodev_key(FAR struct fcrypt *fcr, FAR struct crypt_kop *kop)
 {
@@ -800,33 +1063,46 @@ static int cryptof_poll(FAR struct file *filep,
                         FAR struct pollfd *fds, bool setup)
 {
   FAR struct fcrypt *fcr = filep->f_priv;
+  int ret = OK;
 
   if (fcr == NULL || fds == NULL)
     {
       return -EINVAL;
     }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  nxmutex_lock(&fcr->lock);
+#endif
+
   if (setup)
     {
-      if (!TAILQ_EMPTY(&fcr->crpk_ret))
+      if (!TAILQ_EMPTY(&fcr->crpk_ret)
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+          || !TAILQ_EMPTY(&fcr->crp_ret)
+#endif
+         )
         {
           poll_notify(&fds, 1, POLLIN);
-          return OK;
         }
-
-      if (fcr->fds)
+      else if (fcr->fds)
         {
-          return -EBUSY;
+          ret = -EBUSY;
+        }
+      else
+        {
+          fcr->fds = fds;
         }
-
-      fcr->fds = fds;
     }
   else
     {
       fcr->fds = NULL;
     }
 
-  return OK;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  nxmutex_unlock(&fcr->lock);
+#endif
+
+  return ret;
 }
 
 /* ARGSUSED */
@@ -836,8 +1112,35 @@ static int cryptof_close(FAR struct file *filep)
   FAR struct fcrypt *fcr = filep->f_priv;
   FAR struct csession *cse;
   FAR struct cryptkop *krp;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  FAR struct cryptodev_req *req;
+  bool wait;
+#endif
   int i;
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  /* Wait for the queued requests, they use the sessions */
+
+  nxmutex_lock(&fcr->lock);
+  fcr->closing = true;
+  wait = fcr->npending > 0;
+  nxmutex_unlock(&fcr->lock);
+
+  if (wait)
+    {
+      nxsem_wait_uninterruptible(&fcr->drainsem);
+    }
+
+  while ((req = TAILQ_FIRST(&fcr->crp_ret)))
+    {
+      TAILQ_REMOVE(&fcr->crp_ret, req, next);
+      kmm_free(req);
+    }
+
+  nxsem_destroy(&fcr->drainsem);
+  nxmutex_destroy(&fcr->lock);
+#endif
+
   while ((cse = TAILQ_FIRST(&fcr->csessions)))
     {
       TAILQ_REMOVE(&fcr->csessions, cse, next);
@@ -899,6 +1202,13 @@ static int cryptof_open(FAR struct file *filep)
     }
 
   TAILQ_INIT(&fcrd->csessions);
+  TAILQ_INIT(&fcrd->crpk_ret);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  TAILQ_INIT(&fcrd->crp_ret);
+  nxmutex_init(&fcrd->lock);
+  nxsem_init(&fcrd->drainsem, 0, 0);
+#endif
+
   TAILQ_FOREACH(cse, &fcr->csessions, next)
     {
       bzero(&crie, sizeof(crie));
@@ -1025,6 +1335,11 @@ static int cryptoioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
         TAILQ_INIT(&fcr->csessions);
         TAILQ_INIT(&fcr->crpk_ret);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+        TAILQ_INIT(&fcr->crp_ret);
+        nxmutex_init(&fcr->lock);
+        nxsem_init(&fcr->drainsem, 0, 0);
+#endif
 
         fd = file_allocate(&g_cryptoinode, 0,
                            0, fcr, 0, true);
@@ -1103,6 +1418,9 @@ static FAR struct csession *csecreate(FAR struct fcrypt *fcr, uint64_t sid,
       cse->txform = txform;
       cse->thash = thash;
       cse->error = 0;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      cse->npending = 0;
+#endif
       cseadd(fcr, cse);
     }
 
@@ -1143,4 +1461,8 @@ void devcrypto_register(void)
 #ifdef CONFIG_CRYPTO_CRYPTODEV_HARDWARE
   hwcr_init();
 #endif
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_BENCHMARK
+  crypto_bench_register();
+#endif
 }
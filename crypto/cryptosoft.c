@@ -391,7 +391,7 @@ int swcr_authenc(FAR struct cryptop *crp)
       axf->reinit(&ctx, iv, ivlen);
     }
 
-  /* Supply MAC with AAD */
+  /* Supply MAC with the AAD of the crp_aad buffer */
 
   if (aad)
     {
@@ -411,7 +411,7 @@ int swcr_authenc(FAR struct cryptop *crp)
 
           /* SPI */
 
-          bcopy(buf + crda->crd_skip, blk, 4);
+          bcopy(aad + crda->crd_skip, blk, 4);
           iskip = 4; /* loop below will start with an offset of 4 */
 
           /* ESN */
@@ -423,7 +423,7 @@ int swcr_authenc(FAR struct cryptop *crp)
       for (i = iskip; i < crda->crd_len; i += axf->hashsize)
         {
           len = MIN(crda->crd_len - i, axf->hashsize - oskip);
-          bcopy(buf + crda->crd_skip + i, blk + oskip, len);
+          bcopy(aad + crda->crd_skip + i, blk + oskip, len);
           bzero(blk + len + oskip, axf->hashsize - len - oskip);
           axf->update(&ctx, blk, axf->hashsize);
           oskip = 0; /* reset initial output offset */
@@ -29,17 +29,23 @@
  ****************************************************************************/
 
 #include <endian.h>
+#include <string.h>
 #include <strings.h>
 #include <sys/param.h>
 #include <crypto/aes.h>
 #include <crypto/gmac.h>
 
+#include "aes_accel.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 void ghash_gfmul(FAR uint32_t *, FAR uint32_t *, FAR uint32_t *);
 void ghash_update_mi(FAR GHASH_CTX *, FAR uint8_t *, size_t);
+#ifdef HAVE_AES_ACCEL
+void ghash_update_clmul(FAR GHASH_CTX *, FAR uint8_t *, size_t);
+#endif
 
 /* Allow overriding with optimized MD function */
 
@@ -116,6 +122,83 @@ void ghash_update_mi(FAR GHASH_CTX *ctx, FAR uint8_t *X, size_t len)
   bcopy(ctx->S, ctx->Z, GMAC_BLOCK_LEN);
 }
 
+#ifdef HAVE_AES_ACCEL
+/* The same as ghash_update_mi() with the carry-less multiply of the CPU.
+ * The blocks are read as big endian 128-bit numbers, in which the most
+ * significant bit is the coefficient of x^0.  The product is computed
+ * with three 64-bit multiplies (Karatsuba), shifted left by one for the
+ * bit reflection and reduced modulo x^128 + x^7 + x^2 + x + 1 with shifts,
+ * as in the Intel white paper on carry-less multiplication and GCM.
+ */
+
+static inline uint64_t ghash_load64(FAR const uint8_t *p)
+{
+  uint64_t x;
+
+  memcpy(&x, p, sizeof(x));
+  return betoh64(x);
+}
+
+static inline void ghash_store64(FAR uint8_t *p, uint64_t x)
+{
+  x = htobe64(x);
+  memcpy(p, &x, sizeof(x));
+}
+
+void ghash_update_clmul(FAR GHASH_CTX *ctx, FAR uint8_t *X, size_t len)
+{
+  uint64_t h1 = ghash_load64(ctx->H);
+  uint64_t h0 = ghash_load64(ctx->H + 8);
+  uint64_t y1 = ghash_load64(ctx->Z);
+  uint64_t y0 = ghash_load64(ctx->Z + 8);
+  uint64_t a1;
+  uint64_t a0;
+  uint64_t b1;
+  uint64_t b0;
+  uint64_t c1;
+  uint64_t c0;
+  uint64_t p3;
+  uint64_t p2;
+  uint64_t p1;
+  uint64_t p0;
+  uint64_t d;
+  size_t i;
+
+  for (i = 0; i < len / GMAC_BLOCK_LEN; i++, X += GMAC_BLOCK_LEN)
+    {
+      y1 ^= ghash_load64(X);
+      y0 ^= ghash_load64(X + 8);
+
+      aes_accel_clmul(y0, h0, &a1, &a0);
+      aes_accel_clmul(y1, h1, &b1, &b0);
+      aes_accel_clmul(y0 ^ y1, h0 ^ h1, &c1, &c0);
+      c1 ^= a1 ^ b1;
+      c0 ^= a0 ^ b0;
+
+      p3 = b1;
+      p2 = b0 ^ c1;
+      p1 = a1 ^ c0;
+      p0 = a0;
+
+      p3 = (p3 << 1) | (p2 >> 63);
+      p2 = (p2 << 1) | (p1 >> 63);
+      p1 = (p1 << 1) | (p0 >> 63);
+      p0 <<= 1;
+
+      /* Fold the bits that the shifts below discard back in first */
+
+      d  = p1 ^ (p0 << 63) ^ (p0 << 62) ^ (p0 << 57);
+      y1 = p3 ^ d ^ (d >> 1) ^ (d >> 2) ^ (d >> 7);
+      y0 = p2 ^ p0 ^ ((p0 >> 1) | (d << 63)) ^ ((p0 >> 2) | (d << 62)) ^
+           ((p0 >> 7) | (d << 57));
+    }
+
+  ghash_store64(ctx->S, y1);
+  ghash_store64(ctx->S + 8, y0);
+  bcopy(ctx->S, ctx->Z, GMAC_BLOCK_LEN);
+}
+#endif
+
 #define AESCTR_NONCESIZE 4
 
 void aes_gmac_init(FAR void *xctx)
@@ -132,6 +215,14 @@ void aes_gmac_setkey(FAR void *xctx, FAR const uint8_t *key, uint16_t klen)
 {
   FAR AES_GMAC_CTX *ctx = xctx;
 
+#ifdef HAVE_AES_ACCEL
+  if (ghash_update == ghash_update_mi &&
+      (aes_accel_probe() & AES_ACCEL_CLMUL) != 0)
+    {
+      ghash_update = ghash_update_clmul;
+    }
+#endif
+
   aes_setkey(&ctx->K, key, klen - AESCTR_NONCESIZE);
 
   /* copy out salt to the counter block */
@@ -12,9 +12,70 @@
  ****************************************************************************/
 
 #include <sys/types.h>
+#include <stdint.h>
 
 #include <crypto/poly1305.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* CPUs with a 64 bit * 64 bit = 128 bit multiplication use three limbs of
+ * 44, 44 and 42 bits instead of five limbs of 26 bits, which takes about
+ * a third of the multiplications.  The limbs are kept in the arrays of
+ * poly1305_state, which are 64 bits wide on these CPUs.
+ */
+
+#if defined(__SIZEOF_INT128__) && __SIZEOF_LONG__ == 8
+#  define POLY1305_64BIT 1
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef POLY1305_64BIT
+
+/* poly1305 implementation using 64 bit * 64 bit = 128 bit multiplication
+ * and 128 bit addition.
+ */
+
+typedef unsigned __int128 poly1305_u128;
+
+/* interpret eight 8 bit unsigned integers as a
+ * 64 bit unsigned integer in little endian
+ */
+
+static uint64_t U8TO64(FAR const unsigned char *p)
+{
+  return (((uint64_t)(p[0] & 0xff)) |
+      ((uint64_t)(p[1] & 0xff) <<  8) |
+      ((uint64_t)(p[2] & 0xff) << 16) |
+      ((uint64_t)(p[3] & 0xff) << 24) |
+      ((uint64_t)(p[4] & 0xff) << 32) |
+      ((uint64_t)(p[5] & 0xff) << 40) |
+      ((uint64_t)(p[6] & 0xff) << 48) |
+      ((uint64_t)(p[7] & 0xff) << 56));
+}
+
+/* store a 64 bit unsigned integer as eight
+ * 8 bit unsigned integers in little endian
+ */
+
+static void U64TO8(FAR unsigned char *p, uint64_t v)
+{
+  p[0] = (v) & 0xff;
+  p[1] = (v >>  8) & 0xff;
+  p[2] = (v >> 16) & 0xff;
+  p[3] = (v >> 24) & 0xff;
+  p[4] = (v >> 32) & 0xff;
+  p[5] = (v >> 40) & 0xff;
+  p[6] = (v >> 48) & 0xff;
+  p[7] = (v >> 56) & 0xff;
+}
+
+#else /* POLY1305_64BIT */
+
 /* poly1305 implementation using 32 bit * 32 bit = 64 bit multiplication
  * and 64 bit addition.
  */
@@ -43,10 +104,123 @@ static void U32TO8(FAR unsigned char *p, unsigned long v)
   p[3] = (v >> 24) & 0xff;
 }
 
+#endif /* POLY1305_64BIT */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef POLY1305_64BIT
+
+void poly1305_begin(FAR poly1305_state *st, FAR const unsigned char *key)
+{
+  uint64_t t0;
+  uint64_t t1;
+
+  /* r &= 0xffffffc0ffffffc0ffffffc0fffffff */
+
+  t0 = U8TO64(&key[0]);
+  t1 = U8TO64(&key[8]);
+
+  st->r[0] = (t0) & 0xffc0fffffff;
+  st->r[1] = ((t0 >> 44) | (t1 << 20)) & 0xfffffc0ffff;
+  st->r[2] = ((t1 >> 24)) & 0x00ffffffc0f;
+
+  /* h = 0 */
+
+  st->h[0] = 0;
+  st->h[1] = 0;
+  st->h[2] = 0;
+
+  /* save pad for later */
+
+  st->pad[0] = U8TO64(&key[16]);
+  st->pad[1] = U8TO64(&key[24]);
+
+  st->leftover = 0;
+  st->final = 0;
+}
+
+static void poly1305_blocks(FAR poly1305_state *st,
+                            FAR const unsigned char *m,
+                            size_t bytes)
+{
+  const uint64_t hibit = (st->final) ? 0 : ((uint64_t)1 << 40); /* 1 << 128 */
+  uint64_t r0;
+  uint64_t r1;
+  uint64_t r2;
+  uint64_t s1;
+  uint64_t s2;
+  uint64_t h0;
+  uint64_t h1;
+  uint64_t h2;
+  uint64_t t0;
+  uint64_t t1;
+  uint64_t c;
+  poly1305_u128 d0;
+  poly1305_u128 d1;
+  poly1305_u128 d2;
+
+  r0 = st->r[0];
+  r1 = st->r[1];
+  r2 = st->r[2];
+
+  s1 = r1 * (5 << 2);
+  s2 = r2 * (5 << 2);
+
+  h0 = st->h[0];
+  h1 = st->h[1];
+  h2 = st->h[2];
+
+  while (bytes >= poly1305_block_size)
+    {
+      /* h += m[i] */
+
+      t0 = U8TO64(m + 0);
+      t1 = U8TO64(m + 8);
+
+      h0 += ((t0) & 0xfffffffffff);
+      h1 += (((t0 >> 44) | (t1 << 20)) & 0xfffffffffff);
+      h2 += (((t1 >> 24)) & 0x3ffffffffff) | hibit;
+
+      /* h *= r */
+
+      d0 = ((poly1305_u128)h0 * r0) +
+          ((poly1305_u128)h1 * s2) +
+          ((poly1305_u128)h2 * s1);
+      d1 = ((poly1305_u128)h0 * r1) +
+          ((poly1305_u128)h1 * r0) +
+          ((poly1305_u128)h2 * s2);
+      d2 = ((poly1305_u128)h0 * r2) +
+          ((poly1305_u128)h1 * r1) +
+          ((poly1305_u128)h2 * r0);
+
+      /* (partial) h %= p */
+
+      c = (uint64_t)(d0 >> 44);
+      h0 = (uint64_t)d0 & 0xfffffffffff;
+      d1 += c;
+      c = (uint64_t)(d1 >> 44);
+      h1 = (uint64_t)d1 & 0xfffffffffff;
+      d2 += c;
+      c = (uint64_t)(d2 >> 42);
+      h2 = (uint64_t)d2 & 0x3ffffffffff;
+      h0 += c * 5;
+      c = (h0 >> 44);
+      h0 = h0 & 0xfffffffffff;
+      h1 += c;
+
+      m += poly1305_block_size;
+      bytes -= poly1305_block_size;
+    }
+
+  st->h[0] = h0;
+  st->h[1] = h1;
+  st->h[2] = h2;
+}
+
+#else /* POLY1305_64BIT */
+
 void poly1305_begin(FAR poly1305_state *st, FAR const unsigned char *key)
 {
   /* r &= 0xffffffc0ffffffc0ffffffc0fffffff */
@@ -189,6 +363,8 @@ static void poly1305_blocks(FAR poly1305_state *st,
   st->h[4] = h4;
 }
 
+#endif /* POLY1305_64BIT */
+
 void poly1305_update(FAR poly1305_state *st,
                      FAR const unsigned char *m,
                      size_t bytes)
@@ -245,6 +421,114 @@ void poly1305_update(FAR poly1305_state *st,
     }
 }
 
+#ifdef POLY1305_64BIT
+
+void poly1305_finish(FAR poly1305_state *st, FAR unsigned char *mac)
+{
+  uint64_t h0;
+  uint64_t h1;
+  uint64_t h2;
+  uint64_t c;
+  uint64_t g0;
+  uint64_t g1;
+  uint64_t g2;
+  uint64_t t0;
+  uint64_t t1;
+
+  /* process the remaining block */
+
+  if (st->leftover)
+    {
+      size_t i = st->leftover;
+      st->buffer[i++] = 1;
+      for (; i < poly1305_block_size; i++)
+        st->buffer[i] = 0;
+      st->final = 1;
+      poly1305_blocks(st, st->buffer, poly1305_block_size);
+    }
+
+  /* fully carry h */
+
+  h0 = st->h[0];
+  h1 = st->h[1];
+  h2 = st->h[2];
+
+  c = (h1 >> 44);
+  h1 &= 0xfffffffffff;
+  h2 += c;
+  c = (h2 >> 42);
+  h2 &= 0x3ffffffffff;
+  h0 += c * 5;
+  c = (h0 >> 44);
+  h0 &= 0xfffffffffff;
+  h1 += c;
+  c = (h1 >> 44);
+  h1 &= 0xfffffffffff;
+  h2 += c;
+  c = (h2 >> 42);
+  h2 &= 0x3ffffffffff;
+  h0 += c * 5;
+  c = (h0 >> 44);
+  h0 &= 0xfffffffffff;
+  h1 += c;
+
+  /* compute h + -p */
+
+  g0 = h0 + 5;
+  c = (g0 >> 44);
+  g0 &= 0xfffffffffff;
+  g1 = h1 + c;
+  c = (g1 >> 44);
+  g1 &= 0xfffffffffff;
+  g2 = h2 + c - ((uint64_t)1 << 42);
+
+  /* select h if h < p, or h + -p if h >= p */
+
+  c = (g2 >> 63) - 1;
+  g0 &= c;
+  g1 &= c;
+  g2 &= c;
+  c = ~c;
+  h0 = (h0 & c) | g0;
+  h1 = (h1 & c) | g1;
+  h2 = (h2 & c) | g2;
+
+  /* h = (h + pad) */
+
+  t0 = st->pad[0];
+  t1 = st->pad[1];
+
+  h0 += ((t0) & 0xfffffffffff);
+  c = (h0 >> 44);
+  h0 &= 0xfffffffffff;
+  h1 += (((t0 >> 44) | (t1 << 20)) & 0xfffffffffff) + c;
+  c = (h1 >> 44);
+  h1 &= 0xfffffffffff;
+  h2 += (((t1 >> 24)) & 0x3ffffffffff) + c;
+  h2 &= 0x3ffffffffff;
+
+  /* mac = h % (2^128) */
+
+  h0 = ((h0) | (h1 << 44));
+  h1 = ((h1 >> 20) | (h2 << 24));
+
+  U64TO8(mac + 0, h0);
+  U64TO8(mac + 8, h1);
+
+  /* zero out the state */
+
+  st->h[0] = 0;
+  st->h[1] = 0;
+  st->h[2] = 0;
+  st->r[0] = 0;
+  st->r[1] = 0;
+  st->r[2] = 0;
+  st->pad[0] = 0;
+  st->pad[1] = 0;
+}
+
+#else /* POLY1305_64BIT */
+
 void poly1305_finish(FAR poly1305_state *st, FAR unsigned char *mac)
 {
   unsigned long h0;
@@ -368,3 +652,5 @@ void poly1305_finish(FAR poly1305_state *st, FAR unsigned char *mac)
   st->pad[2] = 0;
   st->pad[3] = 0;
 }
+
+#endif /* POLY1305_64BIT */
@@ -43,6 +43,8 @@
 #include <sys/time.h>
 #include <crypto/sha2.h>
 
+#include "sha2_accel.h"
+
 /* UNROLLED TRANSFORM LOOP NOTE:
  * You can define SHA2_UNROLL_TRANSFORM to use the unrolled transform
  * loop version for the hash transform rounds (defined using macros
@@ -521,6 +523,28 @@ void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
 
 #endif /* SHA2_UNROLL_TRANSFORM */
 
+/* Run the transform over 'nblocks' blocks, with the SHA-256 instructions
+ * of the CPU if it has them.
+ */
+
+static void sha256blocks(FAR uint32_t *state, FAR const uint8_t *data,
+                         size_t nblocks)
+{
+#ifdef HAVE_SHA2_ACCEL
+  if (sha256_accel_probe())
+    {
+      sha256_accel_transform(state, K256, data, nblocks);
+      return;
+    }
+#endif
+
+  while (nblocks-- > 0)
+    {
+      sha256transform(state, data);
+      data += SHA256_BLOCK_LENGTH;
+    }
+}
+
 void sha256update(FAR SHA2_CTX *context,
                   FAR const void *dataptr,
                   size_t len)
@@ -528,6 +552,7 @@ void sha256update(FAR SHA2_CTX *context,
   FAR const uint8_t *data = dataptr;
   size_t freespace;
   size_t usedspace;
+  size_t nblocks;
 
   /* Calling with no data is valid (we do nothing) */
 
@@ -551,7 +576,7 @@ void sha256update(FAR SHA2_CTX *context,
           context->bitcount[0] += freespace << 3;
           len -= freespace;
           data += freespace;
-          sha256transform(context->state.st32, context->buffer);
+          sha256blocks(context->state.st32, context->buffer, 1);
         }
       else
         {
@@ -567,14 +592,15 @@ void sha256update(FAR SHA2_CTX *context,
         }
     }
 
-  while (len >= SHA256_BLOCK_LENGTH)
+  if (len >= SHA256_BLOCK_LENGTH)
     {
       /* Process as many complete blocks as we can */
 
-      sha256transform(context->state.st32, data);
-      context->bitcount[0] += SHA256_BLOCK_LENGTH << 3;
-      len -= SHA256_BLOCK_LENGTH;
-      data += SHA256_BLOCK_LENGTH;
+      nblocks = len / SHA256_BLOCK_LENGTH;
+      sha256blocks(context->state.st32, data, nblocks);
+      context->bitcount[0] += (uint64_t)nblocks * SHA256_BLOCK_LENGTH << 3;
+      len -= nblocks * SHA256_BLOCK_LENGTH;
+      data += nblocks * SHA256_BLOCK_LENGTH;
     }
 
   if (len > 0)
@@ -625,7 +651,7 @@ void sha256last(FAR SHA2_CTX *context)
 
           /* Do second-to-last transform: */
 
-          sha256transform(context->state.st32, context->buffer);
+          sha256blocks(context->state.st32, context->buffer, 1);
 
           /* And set-up for the last transform: */
 
@@ -651,7 +677,7 @@ void sha256last(FAR SHA2_CTX *context)
 
   /* Final transform: */
 
-  sha256transform(context->state.st32, context->buffer);
+  sha256blocks(context->state.st32, context->buffer, 1);
 }
 
 void sha256final(FAR uint8_t *digest, FAR SHA2_CTX *context)
@@ -0,0 +1,281 @@
+/****************************************************************************
+ * crypto/sha2_accel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The SHA-256 compression function with the instructions of the CPU: the
+ * SHA extensions on x86_64 and the Armv8 SHA2 instructions on arm64.  Both
+ * run four rounds and expand four words of the message schedule at a time,
+ * so the 64 rounds are 16 groups of four, and the schedule words of the
+ * next 12 groups are computed from the 16 words of the previous four.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sha2_accel.h"
+
+#ifdef HAVE_SHA2_ACCEL
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef uint32_t sha256_vec_t __attribute__((vector_size(16)));
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The result of sha256_accel_probe(), -1 until the CPU was asked */
+
+static int g_sha256_accel = -1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline sha256_vec_t sha256_load(FAR const void *src)
+{
+  sha256_vec_t x;
+
+  memcpy(&x, src, sizeof(x));
+  return x;
+}
+
+static inline void sha256_store(FAR void *dst, sha256_vec_t x)
+{
+  memcpy(dst, &x, sizeof(x));
+}
+
+#if defined(SHA2_ACCEL_X86_64)
+
+static bool sha256_cpu_probe(void)
+{
+  uint32_t eax = 0;
+  uint32_t ebx;
+  uint32_t ecx = 0;
+  uint32_t edx;
+  uint32_t ecx1;
+
+  __asm__("cpuid" : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx));
+  if (eax < 7)
+    {
+      return false;
+    }
+
+  /* PSHUFB needs SSSE3 and PBLENDW needs SSE4.1 */
+
+  eax = 1;
+  ecx = 0;
+  __asm__("cpuid" : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx));
+  ecx1 = ecx;
+
+  eax = 7;
+  ecx = 0;
+  __asm__("cpuid" : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx));
+
+  return (ebx & (1 << 29)) != 0 && (ecx1 & (1 << 9)) != 0 &&
+         (ecx1 & (1 << 19)) != 0;
+}
+
+/* SHA256RNDS2 keeps the state as ABEF and CDGH and takes the two schedule
+ * words of its two rounds from the low half of XMM0.
+ */
+
+static void sha256_blocks(FAR uint32_t *state, FAR const uint32_t *k,
+                          FAR const uint8_t *data, size_t nblocks)
+{
+  sha256_vec_t bswap;
+  sha256_vec_t abef;
+  sha256_vec_t cdgh;
+  sha256_vec_t save0;
+  sha256_vec_t save1;
+  sha256_vec_t msg[4];
+  sha256_vec_t tmp;
+  sha256_vec_t wk;
+  unsigned int i;
+
+  bswap[0] = 0x00010203;
+  bswap[1] = 0x04050607;
+  bswap[2] = 0x08090a0b;
+  bswap[3] = 0x0c0d0e0f;
+
+  tmp  = sha256_load(state);
+  cdgh = sha256_load(state + 4);
+  __asm__("pshufd $0xb1, %0, %0" : "+x"(tmp));
+  __asm__("pshufd $0x1b, %0, %0" : "+x"(cdgh));
+  abef = tmp;
+  __asm__("palignr $8, %1, %0" : "+x"(abef) : "x"(cdgh));
+  __asm__("pblendw $0xf0, %1, %0" : "+x"(cdgh) : "x"(tmp));
+
+  while (nblocks-- > 0)
+    {
+      save0 = abef;
+      save1 = cdgh;
+
+      for (i = 0; i < 4; i++)
+        {
+          msg[i] = sha256_load(data + 16 * i);
+          __asm__("pshufb %1, %0" : "+x"(msg[i]) : "x"(bswap));
+        }
+
+      for (i = 0; i < 16; i++)
+        {
+          wk = msg[i & 3] + sha256_load(k + 4 * i);
+          __asm__("sha256rnds2 %2, %1, %0"
+                  : "+x"(cdgh) : "x"(abef), "Yz"(wk));
+          __asm__("pshufd $0x0e, %0, %0" : "+x"(wk));
+          __asm__("sha256rnds2 %2, %1, %0"
+                  : "+x"(abef) : "x"(cdgh), "Yz"(wk));
+
+          if (i < 12)
+            {
+              tmp = msg[(i + 3) & 3];
+              __asm__("sha256msg1 %1, %0"
+                      : "+x"(msg[i & 3]) : "x"(msg[(i + 1) & 3]));
+              __asm__("palignr $4, %1, %0"
+                      : "+x"(tmp) : "x"(msg[(i + 2) & 3]));
+              msg[i & 3] += tmp;
+              __asm__("sha256msg2 %1, %0"
+                      : "+x"(msg[i & 3]) : "x"(msg[(i + 3) & 3]));
+            }
+        }
+
+      abef += save0;
+      cdgh += save1;
+      data += 64;
+    }
+
+  tmp = abef;
+  __asm__("pshufd $0x1b, %0, %0" : "+x"(tmp));
+  __asm__("pshufd $0xb1, %0, %0" : "+x"(cdgh));
+  abef = tmp;
+  __asm__("pblendw $0xf0, %1, %0" : "+x"(abef) : "x"(cdgh));
+  __asm__("palignr $8, %1, %0" : "+x"(cdgh) : "x"(tmp));
+  sha256_store(state, abef);
+  sha256_store(state + 4, cdgh);
+}
+
+#elif defined(SHA2_ACCEL_ARM64)
+
+static bool sha256_cpu_probe(void)
+{
+  uint64_t isar0;
+
+  /* ID_AA64ISAR0_EL1.SHA2 is 1 for SHA256H and friends */
+
+  __asm__("mrs %0, id_aa64isar0_el1" : "=r"(isar0));
+  return ((isar0 >> 12) & 0xf) != 0;
+}
+
+static void sha256_blocks(FAR uint32_t *state, FAR const uint32_t *k,
+                          FAR const uint8_t *data, size_t nblocks)
+{
+  sha256_vec_t abcd;
+  sha256_vec_t efgh;
+  sha256_vec_t save0;
+  sha256_vec_t save1;
+  sha256_vec_t msg[4];
+  sha256_vec_t tmp;
+  sha256_vec_t wk;
+  unsigned int i;
+
+  abcd = sha256_load(state);
+  efgh = sha256_load(state + 4);
+
+  while (nblocks-- > 0)
+    {
+      save0 = abcd;
+      save1 = efgh;
+
+      for (i = 0; i < 4; i++)
+        {
+          msg[i] = sha256_load(data + 16 * i);
+          __asm__("rev32 %0.16b, %0.16b" : "+w"(msg[i]));
+        }
+
+      for (i = 0; i < 16; i++)
+        {
+          wk = msg[i & 3] + sha256_load(k + 4 * i);
+          if (i < 12)
+            {
+              __asm__(".arch_extension crypto\n"
+                      "sha256su0 %0.4s, %1.4s"
+                      : "+w"(msg[i & 3]) : "w"(msg[(i + 1) & 3]));
+            }
+
+          tmp = abcd;
+          __asm__(".arch_extension crypto\n"
+                  "sha256h %q0, %q1, %2.4s"
+                  : "+w"(abcd) : "w"(efgh), "w"(wk));
+          __asm__(".arch_extension crypto\n"
+                  "sha256h2 %q0, %q1, %2.4s"
+                  : "+w"(efgh) : "w"(tmp), "w"(wk));
+
+          if (i < 12)
+            {
+              __asm__(".arch_extension crypto\n"
+                      "sha256su1 %0.4s, %1.4s, %2.4s"
+                      : "+w"(msg[i & 3])
+                      : "w"(msg[(i + 2) & 3]), "w"(msg[(i + 3) & 3]));
+            }
+        }
+
+      abcd += save0;
+      efgh += save1;
+      data += 64;
+    }
+
+  sha256_store(state, abcd);
+  sha256_store(state + 4, efgh);
+}
+
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+bool sha256_accel_probe(void)
+{
+  if (g_sha256_accel < 0)
+    {
+      g_sha256_accel = sha256_cpu_probe();
+    }
+
+  return g_sha256_accel;
+}
+
+void sha256_accel_transform(FAR uint32_t *state, FAR const uint32_t *k,
+                            FAR const uint8_t *data, size_t nblocks)
+{
+  sha256_blocks(state, k, data, nblocks);
+}
+
+#endif /* HAVE_SHA2_ACCEL */
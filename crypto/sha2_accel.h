@@ -0,0 +1,85 @@
+/****************************************************************************
+ * crypto/sha2_accel.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __CRYPTO_SHA2_ACCEL_H
+#define __CRYPTO_SHA2_ACCEL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_CRYPTO_SHA256_ACCEL) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#  if defined(__x86_64__)
+#    define SHA2_ACCEL_X86_64 1
+#  elif defined(__aarch64__)
+#    define SHA2_ACCEL_ARM64 1
+#  endif
+#endif
+
+#if defined(SHA2_ACCEL_X86_64) || defined(SHA2_ACCEL_ARM64)
+#  define HAVE_SHA2_ACCEL 1
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef HAVE_SHA2_ACCEL
+
+/****************************************************************************
+ * Name: sha256_accel_probe
+ *
+ * Description:
+ *   Return true if this CPU implements the SHA-256 instructions.  The CPU
+ *   is only asked once.
+ *
+ ****************************************************************************/
+
+bool sha256_accel_probe(void);
+
+/****************************************************************************
+ * Name: sha256_accel_transform
+ *
+ * Description:
+ *   Run the SHA-256 compression function over 'nblocks' blocks of 64
+ *   bytes, with the 64 round constants in 'k'.  Only call it if
+ *   sha256_accel_probe() returned true.
+ *
+ ****************************************************************************/
+
+void sha256_accel_transform(FAR uint32_t *state, FAR const uint32_t *k,
+                            FAR const uint8_t *data, size_t nblocks);
+
+#endif /* HAVE_SHA2_ACCEL */
+
+#endif /* __CRYPTO_SHA2_ACCEL_H */
@@ -27,20 +27,35 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <string.h>
+#include <inttypes.h>
 #include <poll.h>
 #include <errno.h>
 #include <debug.h>
+#include <syslog.h>
 
 #include <sys/param.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
 
+#include <crypto/chachapoly.h>
+#include <crypto/poly1305.h>
+#include <crypto/sha2.h>
+#ifdef CONFIG_CRYPTO_SW_AES
+#  include <crypto/aes.h>
+#  include <crypto/gmac.h>
+#endif
+
 #ifdef CONFIG_CRYPTO_ALGTEST
 
 #include "testmngr.h"
 
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCHMARK
+#  include "chacha_private.h"
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -106,6 +121,125 @@ static int test_aes(void)
 }
 #endif
 
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCHMARK
+
+/****************************************************************************
+ * Benchmarks
+ ****************************************************************************/
+
+#define BENCH_BUFSIZE 4096
+#define BENCH_LOOPS   CONFIG_CRYPTO_ALGTEST_BENCHMARK_LOOPS
+#define BENCH_BYTES   ((uint64_t)BENCH_BUFSIZE * BENCH_LOOPS)
+
+/* Report the cost of BENCH_BYTES bytes in CPU cycles, which are the perf
+ * counter ticks if the CPU clock is not configured.
+ */
+
+static void bench_report(FAR const char *name, clock_t elapsed)
+{
+  uint64_t cycles = elapsed;
+  uint64_t cpb;
+
+#if CONFIG_CRYPTO_ALGTEST_BENCHMARK_CPUFREQ > 0
+  cycles = cycles * CONFIG_CRYPTO_ALGTEST_BENCHMARK_CPUFREQ * 1000 /
+           MAX(perf_getfreq() / 1000, 1);
+#endif
+
+  cpb = cycles * 100 / BENCH_BYTES;
+  syslog(LOG_INFO, "%-20s %" PRIu64 ".%02" PRIu64 " cycles/byte\n",
+         name, cpb / 100, cpb % 100);
+}
+
+static int bench_kernels(void)
+{
+  static const uint8_t key[32];
+  FAR uint8_t *buf;
+  uint8_t digest[32];
+  poly1305_state poly;
+  chacha_ctx chacha;
+  SHA2_CTX sha2;
+#ifdef CONFIG_CRYPTO_SW_AES
+  AES_GMAC_CTX gmac;
+  AES_CTX aes;
+#endif
+  clock_t start;
+  int i;
+
+  /* The AEAD appends its tag to the ciphertext */
+
+  buf = kmm_zalloc(BENCH_BUFSIZE + CHACHA20POLY1305_AUTHTAG_SIZE);
+  if (buf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  chacha_keysetup(&chacha, key, 256);
+  chacha_ivsetup(&chacha, key, NULL);
+  start = perf_gettime();
+  for (i = 0; i < BENCH_LOOPS; i++)
+    {
+      chacha_encrypt_bytes(&chacha, buf, buf, BENCH_BUFSIZE);
+    }
+
+  bench_report("ChaCha20", perf_gettime() - start);
+
+  start = perf_gettime();
+  for (i = 0; i < BENCH_LOOPS; i++)
+    {
+      poly1305_begin(&poly, key);
+      poly1305_update(&poly, buf, BENCH_BUFSIZE);
+      poly1305_finish(&poly, digest);
+    }
+
+  bench_report("Poly1305", perf_gettime() - start);
+
+  start = perf_gettime();
+  for (i = 0; i < BENCH_LOOPS; i++)
+    {
+      chacha20poly1305_encrypt(buf, buf, BENCH_BUFSIZE, NULL, 0, i, key);
+    }
+
+  bench_report("ChaCha20-Poly1305", perf_gettime() - start);
+
+  start = perf_gettime();
+  for (i = 0; i < BENCH_LOOPS; i++)
+    {
+      sha256init(&sha2);
+      sha256update(&sha2, buf, BENCH_BUFSIZE);
+      sha256final(digest, &sha2);
+    }
+
+  bench_report("SHA-256", perf_gettime() - start);
+
+#ifdef CONFIG_CRYPTO_SW_AES
+  aes_setkey(&aes, key, 16);
+  start = perf_gettime();
+  for (i = 0; i < BENCH_LOOPS; i++)
+    {
+      aes_encrypt_ecb(&aes, buf, buf, BENCH_BUFSIZE / 16);
+    }
+
+  bench_report("AES-128-ECB", perf_gettime() - start);
+
+  /* The GMAC key is the AES-128 key followed by the 4 bytes of salt */
+
+  aes_gmac_init(&gmac);
+  aes_gmac_setkey(&gmac, key, 16 + 4);
+  start = perf_gettime();
+  for (i = 0; i < BENCH_LOOPS; i++)
+    {
+      aes_gmac_update(&gmac, buf, BENCH_BUFSIZE);
+    }
+
+  bench_report("GHASH", perf_gettime() - start);
+#endif
+
+  kmm_free(buf);
+  return OK;
+}
+
+#endif /* CONFIG_CRYPTO_ALGTEST_BENCHMARK */
+
 int crypto_test(void)
 {
 #if defined(CONFIG_CRYPTO_AES)
@@ -115,6 +249,13 @@ int crypto_test(void)
     }
 #endif
 
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCHMARK
+  if (bench_kernels() < 0)
+    {
+      return -1;
+    }
+#endif
+
   return OK;
 }
 
@@ -65,6 +65,7 @@ static int     adc_poll(FAR struct file *filep, FAR struct pollfd *fds,
                         bool setup);
 static int     adc_reset_fifo(FAR struct adc_dev_s *dev);
 static int     adc_samples_on_read(FAR struct adc_dev_s *dev);
+static bool    adc_watermark_reached(FAR struct adc_dev_s *dev);
 
 /****************************************************************************
  * Private Data
@@ -151,6 +152,10 @@ static int adc_open(FAR struct file *filep)
 
                   dev->ad_isovr = false;
 
+                  /* Wake up readers on every sample */
+
+                  dev->ad_watermark = 0;
+
                   /* Finally, Enable the ADC RX interrupt */
 
                   dev->ad_ops->ao_rxint(dev, true);
@@ -272,7 +277,9 @@ static ssize_t adc_read(FAR struct file *filep, FAR char *buffer,
       /* Interrupts must be disabled while accessing the fifo FIFO */
 
       flags = enter_critical_section();
-      while (fifo->af_head == fifo->af_tail)
+      while (fifo->af_head == fifo->af_tail ||
+             ((filep->f_oflags & O_NONBLOCK) == 0 &&
+              !adc_watermark_reached(dev)))
         {
           /* Check if there was an overrun, if set we need to return EIO */
 
@@ -283,7 +290,9 @@ static ssize_t adc_read(FAR struct file *filep, FAR char *buffer,
               goto return_with_irqdisabled;
             }
 
-          /* The receive FIFO is empty -- was non-blocking mode selected? */
+          /* The receive FIFO is empty or a blocking read waits for the
+           * watermark -- was non-blocking mode selected?
+           */
 
           if (filep->f_oflags & O_NONBLOCK)
             {
@@ -441,6 +450,20 @@ static int adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      case ANIOC_SET_WATERMARK:
+        {
+          if (arg >= dev->ad_recv.af_fifosize)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              dev->ad_watermark = arg;
+              ret = OK;
+            }
+        }
+        break;
+
       default:
         {
           /* Those IOCTLs might be used in arch specific section */
@@ -576,6 +599,15 @@ static void adc_notify(FAR struct adc_dev_s *dev)
 {
   FAR struct adc_fifo_s *fifo = &dev->ad_recv;
 
+  /* Wait until the watermark is reached, a DMA block of samples then
+   * costs one wakeup.
+   */
+
+  if (!adc_watermark_reached(dev))
+    {
+      return;
+    }
+
   /* If there are threads waiting on poll() for data to become available,
    * then wake them up now.
    */
@@ -648,7 +680,8 @@ static int adc_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
       /* Should we immediately notify on any of the requested events? */
 
-      if (dev->ad_recv.af_head != dev->ad_recv.af_tail)
+      if (dev->ad_recv.af_head != dev->ad_recv.af_tail &&
+          adc_watermark_reached(dev))
         {
           poll_notify(&fds, 1, POLLIN);
         }
@@ -718,6 +751,26 @@ static int adc_samples_on_read(FAR struct adc_dev_s *dev)
   return ret;
 }
 
+/****************************************************************************
+ * Name: adc_watermark_reached
+ *
+ * Description:
+ *   Check if at least the watermark number of samples is waiting in the
+ *   receive FIFO.  Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static bool adc_watermark_reached(FAR struct adc_dev_s *dev)
+{
+  FAR struct adc_fifo_s *fifo = &dev->ad_recv;
+  size_t used;
+
+  used = (fifo->af_tail - fifo->af_head + fifo->af_fifosize)
+          % fifo->af_fifosize;
+
+  return used > 0 && used >= dev->ad_watermark;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -25,9 +25,19 @@
 #include <nuttx/config.h>
 #include <nuttx/audio/audio_dma.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/queue.h>
 
 #include <debug.h>
+#include <string.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The alignment of the buffers and of the periods, a cache line */
+
+#define AUDIO_DMA_ALIGN 32
 
 /****************************************************************************
  * Private Types
@@ -44,6 +54,9 @@ struct audio_dma_s
   uint8_t fifo_width;
   bool playback;
   bool xrun;
+#ifdef CONFIG_AUDIO_MMAP
+  bool ring;
+#endif
   struct dq_queue_s pendq;
   apb_samp_t buffer_size;
   apb_samp_t buffer_num;
@@ -97,6 +110,10 @@ static int audio_dma_enqueuebuffer(struct audio_lowerhalf_s *dev,
                                    struct ap_buffer_s *apb);
 static int audio_dma_ioctl(struct audio_lowerhalf_s *dev, int cmd,
                            unsigned long arg);
+#ifdef CONFIG_AUDIO_MMAP
+static int audio_dma_getring(struct audio_lowerhalf_s *dev,
+                             struct audio_ring_s *ring);
+#endif
 static void audio_dma_callback(struct dma_chan_s *chan, void *arg,
                                ssize_t len);
 
@@ -123,6 +140,9 @@ static const struct audio_ops_s g_audio_dma_ops =
   .ioctl = audio_dma_ioctl,
   .reserve = audio_dma_reserve,
   .release = audio_dma_release,
+#ifdef CONFIG_AUDIO_MMAP
+  .getring = audio_dma_getring,
+#endif
 };
 
 /****************************************************************************
@@ -257,6 +277,10 @@ static int audio_dma_configure(struct audio_lowerhalf_s *dev,
 
 static int audio_dma_shutdown(struct audio_lowerhalf_s *dev)
 {
+#ifdef CONFIG_AUDIO_MMAP
+  struct audio_dma_s *audio_dma = (struct audio_dma_s *)dev;
+#endif
+
   /* apps enqueued buffers, but doesn't start. stop here to
    * clear audio_dma->pendq.
    */
@@ -269,6 +293,15 @@ static int audio_dma_shutdown(struct audio_lowerhalf_s *dev)
 #endif
 #endif
 
+#ifdef CONFIG_AUDIO_MMAP
+  if (audio_dma->ring)
+    {
+      audio_dma->ring = false;
+      kumm_free(audio_dma->alloc_addr);
+      audio_dma->alloc_addr = NULL;
+    }
+#endif
+
   return OK;
 }
 
@@ -342,7 +375,11 @@ static int audio_dma_resume(struct audio_lowerhalf_s *dev)
 {
   struct audio_dma_s *audio_dma = (struct audio_dma_s *)dev;
 
+#ifdef CONFIG_AUDIO_MMAP
+  if (dq_empty(&audio_dma->pendq) && !audio_dma->ring)
+#else
   if (dq_empty(&audio_dma->pendq))
+#endif
     {
       return -EINVAL;
     }
@@ -357,6 +394,13 @@ static int audio_dma_allocbuffer(struct audio_lowerhalf_s *dev,
   struct audio_dma_s *audio_dma = (struct audio_dma_s *)dev;
   struct ap_buffer_s *apb;
 
+#ifdef CONFIG_AUDIO_MMAP
+  if (audio_dma->ring)
+    {
+      return -EBUSY;
+    }
+#endif
+
   if (bufdesc->numbytes != audio_dma->buffer_size)
     {
       return -EINVAL;
@@ -369,7 +413,7 @@ static int audio_dma_allocbuffer(struct audio_lowerhalf_s *dev,
 
   if (!audio_dma->alloc_addr)
     {
-      audio_dma->alloc_addr = kumm_memalign(32,
+      audio_dma->alloc_addr = kumm_memalign(AUDIO_DMA_ALIGN,
                                             audio_dma->buffer_num *
                                             audio_dma->buffer_size);
       if (!audio_dma->alloc_addr)
@@ -473,6 +517,25 @@ static int audio_dma_ioctl(struct audio_lowerhalf_s *dev, int cmd,
       case AUDIOIOC_SETBUFFERINFO:
         audinfo("AUDIOIOC_GETBUFFERINFO:\n");
         bufinfo                = (struct ap_buffer_info_s *)arg;
+#ifdef CONFIG_AUDIO_MMAP
+        if (audio_dma->ring)
+          {
+            return -EBUSY;
+          }
+
+        /* Round the periods to whole cache lines, so that the cache
+         * maintenance of one period never touches the next one, and
+         * report what was granted.
+         */
+
+        if (bufinfo->buffer_size == 0 || bufinfo->nbuffers < 2)
+          {
+            return -EINVAL;
+          }
+
+        bufinfo->buffer_size   = ALIGN_UP(bufinfo->buffer_size,
+                                          AUDIO_DMA_ALIGN);
+#endif
         audio_dma->buffer_size = bufinfo->buffer_size;
         audio_dma->buffer_num  = bufinfo->nbuffers;
         kumm_free(audio_dma->alloc_addr);
@@ -503,6 +566,57 @@ static int audio_dma_release(struct audio_lowerhalf_s *dev)
   return OK;
 }
 
+#ifdef CONFIG_AUDIO_MMAP
+static int audio_dma_getring(struct audio_lowerhalf_s *dev,
+                             struct audio_ring_s *ring)
+{
+  struct audio_dma_s *audio_dma = (struct audio_dma_s *)dev;
+
+  /* The ring is the memory of the buffers, which are not allocated any
+   * more while it is mapped.
+   */
+
+  if (audio_dma->alloc_index != 0)
+    {
+      return -EBUSY;
+    }
+
+  if (!audio_dma->alloc_addr)
+    {
+      audio_dma->alloc_addr = kumm_memalign(AUDIO_DMA_ALIGN,
+                                            audio_dma->buffer_num *
+                                            audio_dma->buffer_size);
+      if (!audio_dma->alloc_addr)
+        {
+          return -ENOMEM;
+        }
+
+      if (audio_dma->playback)
+        audio_dma->src_addr = up_addrenv_va_to_pa(audio_dma->alloc_addr);
+      else
+        audio_dma->dst_addr = up_addrenv_va_to_pa(audio_dma->alloc_addr);
+    }
+
+  /* Play silence until the application wrote the first period */
+
+  if (audio_dma->playback)
+    {
+      memset(audio_dma->alloc_addr, 0,
+             audio_dma->buffer_num * audio_dma->buffer_size);
+      up_clean_dcache((uintptr_t)audio_dma->alloc_addr,
+                      (uintptr_t)audio_dma->alloc_addr +
+                      audio_dma->buffer_num * audio_dma->buffer_size);
+    }
+
+  audio_dma->ring    = true;
+  ring->base         = audio_dma->alloc_addr;
+  ring->period_bytes = audio_dma->buffer_size;
+  ring->periods      = audio_dma->buffer_num;
+  ring->playback     = audio_dma->playback;
+  return OK;
+}
+#endif
+
 static void audio_dma_callback(struct dma_chan_s *chan,
                                void *arg, ssize_t len)
 {
@@ -510,6 +624,22 @@ static void audio_dma_callback(struct dma_chan_s *chan,
   struct ap_buffer_s *apb;
   bool final = false;
 
+#ifdef CONFIG_AUDIO_MMAP
+  if (audio_dma->ring)
+    {
+      /* The DMA runs over the ring on its own, only report the period */
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      audio_dma->dev.upper(audio_dma->dev.priv, AUDIO_CALLBACK_PERIOD,
+                           NULL, OK, NULL);
+#else
+      audio_dma->dev.upper(audio_dma->dev.priv, AUDIO_CALLBACK_PERIOD,
+                           NULL, OK);
+#endif
+      return;
+    }
+#endif
+
   apb = (struct ap_buffer_s *)dq_remfirst(&audio_dma->pendq);
   if (!apb)
     {
@@ -32,7 +32,9 @@
 #include <stdbool.h>
 
 #include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/mm/mm.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -44,6 +46,17 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_BCH_CACHE
+/* One sector of the sector cache */
+
+struct bchlib_line_s
+{
+  size_t sector;           /* The sector in the line, (size_t)-1 if none */
+  uint32_t age;            /* When the line was last used, for the LRU */
+  bool dirty;              /* true: The line differs from the media */
+};
+#endif
+
 struct bchlib_s
 {
   FAR struct inode *inode; /* I-node of the block driver */
@@ -57,9 +70,32 @@ struct bchlib_s
   bool unlinked;           /* true: The driver has been unlinked */
   FAR uint8_t *buffer;     /* One sector buffer */
 
+#ifdef CONFIG_BCH_CACHE
+  /* With the sector cache, 'buffer' and 'sector' refer to the line used
+   * last and 'dirty' is not used.
+   */
+
+  FAR uint8_t *cache;      /* The sectors of all lines */
+
+  /* The cache lines and the line used last */
+
+  struct bchlib_line_s lines[CONFIG_BCH_CACHE_NSECTORS];
+  FAR struct bchlib_line_s *line;
+  uint32_t age;            /* Incremented on every use of a line */
+  size_t nextsector;       /* The sector after the last read, for read-ahead */
+  uint16_t ndirty;         /* The number of dirty lines */
+#ifdef CONFIG_BCH_CACHE_WRITEBACK
+  struct work_s work;      /* Writes the dirty lines back */
+#endif
+#endif
+
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
 #endif
+
+#ifdef CONFIG_MM_RECLAIM
+  struct mm_reclaim_s reclaim;  /* Drops the sector buffer under pressure */
+#endif
 };
 
 /****************************************************************************
@@ -83,6 +119,21 @@ EXTERN const struct file_operations g_bch_fops;
 
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch, bool discard);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+#ifdef CONFIG_BCH_CACHE
+EXTERN void bchlib_dirtysector(FAR struct bchlib_s *bch);
+EXTERN ssize_t bchlib_readsectors(FAR struct bchlib_s *bch,
+                                  FAR uint8_t *buffer, size_t sector,
+                                  size_t nsectors);
+EXTERN ssize_t bchlib_writesectors(FAR struct bchlib_s *bch,
+                                   FAR const uint8_t *buffer,
+                                   size_t sector, size_t nsectors);
+EXTERN void bchlib_freecache(FAR struct bchlib_s *bch);
+#else
+#  define bchlib_dirtysector(bch) ((bch)->dirty = true)
+#endif
+#ifdef CONFIG_MM_RECLAIM
+EXTERN size_t bchlib_reclaim(FAR void *arg, bool nonblock);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
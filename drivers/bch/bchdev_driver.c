@@ -38,6 +38,7 @@
 #include <debug.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/blkqueue.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/drivers/drivers.h>
 
@@ -431,6 +432,93 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
 #endif
 
+#if defined(CONFIG_FS_BLKQUEUE) && !defined(CONFIG_BCH_ENCRYPTION)
+      /* Submit an asynchronous request to the block driver.  The sectors
+       * in the buffer are written back and dropped first, so that the
+       * request transfers the current data and later reads see its data.
+       */
+
+      case BIOC_SUBMIT:
+        {
+          FAR struct blk_req_s *req =
+            (FAR struct blk_req_s *)((uintptr_t)arg);
+
+          ret = nxmutex_lock(&bch->lock);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          if (req->write && bch->readonly)
+            {
+              ret = -EACCES;
+            }
+          else if (req->start + req->nsectors > bch->nsectors)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              ret = bchlib_flushsector(bch, true);
+            }
+
+          nxmutex_unlock(&bch->lock);
+
+          if (ret >= 0)
+            {
+              req->inode = bch->inode;
+              ret = blk_submit(req);
+            }
+        }
+        break;
+#endif
+
+      case BIOC_DISCARD:
+      case BIOC_ZEROOUT:
+        {
+          FAR const struct blk_range_s *range =
+            (FAR const struct blk_range_s *)((uintptr_t)arg);
+          FAR struct inode *bchinode = bch->inode;
+
+          if (bchinode->u.i_bops->ioctl == NULL)
+            {
+              break;
+            }
+
+          ret = nxmutex_lock(&bch->lock);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          /* The cached sector must not be written back over the range
+           * later, nor be read from the cache with the old data.
+           */
+
+          if (bch->readonly)
+            {
+              ret = -EACCES;
+            }
+          else if (range == NULL || range->start < 0 ||
+                   range->nsectors < 0 ||
+                   range->start + range->nsectors > bch->nsectors)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              ret = bchlib_flushsector(bch, true);
+            }
+
+          nxmutex_unlock(&bch->lock);
+
+          if (ret >= 0)
+            {
+              ret = bchinode->u.i_bops->ioctl(bchinode, cmd, arg);
+            }
+        }
+        break;
+
       case BIOC_FLUSH:
         {
           /* Flush any dirty pages remaining in the cache */
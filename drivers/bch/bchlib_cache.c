@@ -23,10 +23,13 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdbool.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -37,6 +40,16 @@
 #  include <nuttx/crypto/crypto.h>
 #endif
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_BCH_CACHE
+#  define BCH_NLINES       CONFIG_BCH_CACHE_NSECTORS
+#  define BCH_READAHEAD    MIN(CONFIG_BCH_CACHE_READAHEAD, BCH_NLINES)
+#  define BCH_LINE(bch, i) (&(bch)->cache[(size_t)(i) * (bch)->sectsize])
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -60,10 +73,11 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR uint8_t *sectbuf,
+                      size_t sector, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)sectbuf;
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
@@ -71,7 +85,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
       uint32_t T[4];
       uint32_t X[4] =
       {
-        bch->sector, 0, 0, i
+        sector, 0, 0, i
       };
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -89,6 +103,268 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 }
 #endif
 
+/****************************************************************************
+ * Name: bchlib_alloccache
+ *
+ * Description:
+ *   Allocate the sectors of the cache lines unless done already.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BCH_CACHE
+static int bchlib_alloccache(FAR struct bchlib_s *bch)
+{
+  int i;
+
+  if (bch->cache != NULL)
+    {
+      return OK;
+    }
+
+#if CONFIG_BCH_BUFFER_ALIGNMENT != 0
+  bch->cache = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT,
+                            BCH_NLINES * bch->sectsize);
+#else
+  bch->cache = kmm_malloc(BCH_NLINES * bch->sectsize);
+#endif
+  if (bch->cache == NULL)
+    {
+      ferr("Failed to allocate sector cache\n");
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < BCH_NLINES; i++)
+    {
+      bch->lines[i].sector = (size_t)-1;
+      bch->lines[i].age    = 0;
+      bch->lines[i].dirty  = false;
+    }
+
+  bch->ndirty = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_findline
+ *
+ * Description:
+ *   Return the index of the line that caches 'sector' or -1.
+ *
+ ****************************************************************************/
+
+static int bchlib_findline(FAR struct bchlib_s *bch, size_t sector)
+{
+  int i;
+
+  for (i = 0; i < BCH_NLINES; i++)
+    {
+      if (bch->lines[i].sector == sector)
+        {
+          return i;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: bchlib_writelines
+ *
+ * Description:
+ *   Write the 'n' dirty lines starting at line 'i', which cache consecutive
+ *   sectors, to the media with one write.
+ *
+ ****************************************************************************/
+
+static int bchlib_writelines(FAR struct bchlib_s *bch, int i, int n)
+{
+  FAR struct inode *inode = bch->inode;
+  size_t sector = bch->lines[i].sector;
+  ssize_t ret;
+  int k;
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  for (k = 0; k < n; k++)
+    {
+      bch_cypher(bch, BCH_LINE(bch, i + k), sector + k, CYPHER_ENCRYPT);
+    }
+#endif
+
+  ret = inode->u.i_bops->write(inode, BCH_LINE(bch, i), sector, n);
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  for (k = 0; k < n; k++)
+    {
+      bch_cypher(bch, BCH_LINE(bch, i + k), sector + k, CYPHER_DECRYPT);
+    }
+#endif
+
+  if (ret < 0)
+    {
+      ferr("Write failed: %zd\n", ret);
+      return (int)ret;
+    }
+
+  for (k = 0; k < n; k++)
+    {
+      bch->lines[i + k].dirty = false;
+    }
+
+  bch->ndirty -= n;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_flushrun
+ *
+ * Description:
+ *   Write back the dirty line 'i' together with the dirty lines after it
+ *   that cache the sectors after its sector, up to line 'end'.
+ *
+ ****************************************************************************/
+
+static int bchlib_flushrun(FAR struct bchlib_s *bch, int i, int end)
+{
+  int n = 1;
+
+  while (i + n < end && bch->lines[i + n].dirty &&
+         bch->lines[i + n].sector == bch->lines[i].sector + n)
+    {
+      n++;
+    }
+
+  return bchlib_writelines(bch, i, n);
+}
+
+/****************************************************************************
+ * Name: bchlib_evictlines
+ *
+ * Description:
+ *   Choose the 'n' consecutive lines that were used least recently, write
+ *   them back if dirty and make them empty.
+ *
+ * Returned Value:
+ *   The index of the first of the lines or a negated errno value.
+ *
+ ****************************************************************************/
+
+static int bchlib_evictlines(FAR struct bchlib_s *bch, int n)
+{
+  uint32_t oldest = UINT32_MAX;
+  uint32_t age;
+  int first = 0;
+  int ret;
+  int i;
+  int k;
+
+  /* A run is as old as the line used last in it */
+
+  for (i = 0; i + n <= BCH_NLINES; i++)
+    {
+      for (age = 0, k = 0; k < n; k++)
+        {
+          age = MAX(age, bch->lines[i + k].age);
+        }
+
+      if (age < oldest)
+        {
+          oldest = age;
+          first  = i;
+        }
+    }
+
+  for (i = first; i < first + n; i++)
+    {
+      if (bch->lines[i].dirty)
+        {
+          ret = bchlib_flushrun(bch, i, first + n);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      if (&bch->lines[i] == bch->line)
+        {
+          bch->line   = NULL;
+          bch->buffer = NULL;
+          bch->sector = (size_t)-1;
+        }
+
+      bch->lines[i].sector = (size_t)-1;
+      bch->lines[i].age    = 0;
+    }
+
+  return first;
+}
+
+/****************************************************************************
+ * Name: bchlib_dropsectors
+ *
+ * Description:
+ *   Remove the lines of the sectors that are about to be overwritten on the
+ *   media, dirty or not.
+ *
+ ****************************************************************************/
+
+static void bchlib_dropsectors(FAR struct bchlib_s *bch, size_t sector,
+                               size_t nsectors)
+{
+  int i;
+
+  for (i = 0; i < BCH_NLINES; i++)
+    {
+      FAR struct bchlib_line_s *line = &bch->lines[i];
+
+      if (line->sector != (size_t)-1 && line->sector >= sector &&
+          line->sector < sector + nsectors)
+        {
+          if (line->dirty)
+            {
+              line->dirty = false;
+              bch->ndirty--;
+            }
+
+          if (line == bch->line)
+            {
+              bch->line   = NULL;
+              bch->buffer = NULL;
+              bch->sector = (size_t)-1;
+            }
+
+          line->sector = (size_t)-1;
+          line->age    = 0;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: bchlib_writeback
+ *
+ * Description:
+ *   Write the dirty lines back from the work queue.  The teardown cancels
+ *   the work with the lock held, so the lock is only tried here.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BCH_CACHE_WRITEBACK
+static void bchlib_writeback(FAR void *arg)
+{
+  FAR struct bchlib_s *bch = arg;
+
+  if (nxmutex_trylock(&bch->lock) < 0)
+    {
+      work_queue(LPWORK, &bch->work, bchlib_writeback, bch,
+                 MSEC2TICK(CONFIG_BCH_CACHE_WRITEBACK_DELAY));
+      return;
+    }
+
+  bchlib_flushsector(bch, false);
+  nxmutex_unlock(&bch->lock);
+}
+#endif
+#endif /* CONFIG_BCH_CACHE */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -97,13 +373,56 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
  * Name: bchlib_flushsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Flush the current contents of the sector buffer (if dirty).  With the
+ *   sector cache, all dirty lines are flushed in the order of the sectors.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
  *
  ****************************************************************************/
 
+#ifdef CONFIG_BCH_CACHE
+int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
+{
+  int ret;
+  int i;
+  int j;
+
+  while (bch->ndirty > 0)
+    {
+      for (i = -1, j = 0; j < BCH_NLINES; j++)
+        {
+          if (bch->lines[j].dirty &&
+              (i < 0 || bch->lines[j].sector < bch->lines[i].sector))
+            {
+              i = j;
+            }
+        }
+
+      DEBUGASSERT(i >= 0);
+      ret = bchlib_flushrun(bch, i, BCH_NLINES);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (discard)
+    {
+      for (i = 0; i < BCH_NLINES; i++)
+        {
+          bch->lines[i].sector = (size_t)-1;
+          bch->lines[i].age    = 0;
+        }
+
+      bch->line   = NULL;
+      bch->buffer = NULL;
+      bch->sector = (size_t)-1;
+    }
+
+  return OK;
+}
+#else
 int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 {
   FAR struct inode *inode;
@@ -120,7 +439,7 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      bch_cypher(bch, bch->buffer, bch->sector, CYPHER_ENCRYPT);
 #endif
 
       /* Write the sector to the media */
@@ -137,7 +456,7 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, bch->buffer, bch->sector, CYPHER_DECRYPT);
 #endif
 
       /* The sector is now in sync with the media */
@@ -152,18 +471,82 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 
   return (int)ret;
 }
+#endif
 
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Read the current sector contents into buffer
+ *   Read the current sector contents into buffer.  With the sector cache,
+ *   the sector is looked up in the cache first and a miss on a sequential
+ *   read also reads the sectors that follow.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
  *
  ****************************************************************************/
 
+#ifdef CONFIG_BCH_CACHE
+int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
+{
+  FAR struct inode *inode = bch->inode;
+  bool sequential;
+  ssize_t ret;
+  int n = 1;
+  int i;
+  int k;
+
+  ret = bchlib_alloccache(bch);
+  if (ret < 0)
+    {
+      return (int)ret;
+    }
+
+  sequential      = sector == bch->nextsector;
+  bch->nextsector = sector + 1;
+
+  i = bchlib_findline(bch, sector);
+  if (i < 0)
+    {
+      /* Read ahead the sectors that follow up to the first cached one */
+
+      while (sequential && n < BCH_READAHEAD &&
+             sector + n < bch->nsectors &&
+             bchlib_findline(bch, sector + n) < 0)
+        {
+          n++;
+        }
+
+      i = bchlib_evictlines(bch, n);
+      if (i < 0)
+        {
+          return i;
+        }
+
+      ret = inode->u.i_bops->read(inode, BCH_LINE(bch, i), sector, n);
+      if (ret < 0)
+        {
+          ferr("Read failed: %zd\n", ret);
+          return (int)ret;
+        }
+
+      for (k = 0; k < n; k++)
+        {
+#if defined(CONFIG_BCH_ENCRYPTION)
+          bch_cypher(bch, BCH_LINE(bch, i + k), sector + k, CYPHER_DECRYPT);
+#endif
+          bch->lines[i + k].sector = sector + k;
+          bch->lines[i + k].age    = ++bch->age;
+        }
+    }
+
+  bch->lines[i].age = ++bch->age;
+  bch->line         = &bch->lines[i];
+  bch->buffer       = BCH_LINE(bch, i);
+  bch->sector       = sector;
+  return OK;
+}
+#else
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
   FAR struct inode *inode;
@@ -203,9 +586,193 @@ int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 
       bch->sector = sector;
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, bch->buffer, sector, CYPHER_DECRYPT);
 #endif
     }
 
   return (int)ret;
 }
+#endif
+
+/****************************************************************************
+ * Name: bchlib_dirtysector
+ *
+ * Description:
+ *   Mark the line used last dirty after it was written to.  The background
+ *   write-back is started, at once if enough lines are dirty.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BCH_CACHE
+void bchlib_dirtysector(FAR struct bchlib_s *bch)
+{
+  DEBUGASSERT(bch->line != NULL);
+
+  if (!bch->line->dirty)
+    {
+      bch->line->dirty = true;
+      bch->ndirty++;
+    }
+
+#ifdef CONFIG_BCH_CACHE_WRITEBACK
+  if (bch->ndirty >= CONFIG_BCH_CACHE_WRITEBACK_DIRTY)
+    {
+      if (bch->ndirty == CONFIG_BCH_CACHE_WRITEBACK_DIRTY ||
+          work_available(&bch->work))
+        {
+          work_queue(LPWORK, &bch->work, bchlib_writeback, bch, 0);
+        }
+    }
+  else if (work_available(&bch->work))
+    {
+      work_queue(LPWORK, &bch->work, bchlib_writeback, bch,
+                 MSEC2TICK(CONFIG_BCH_CACHE_WRITEBACK_DELAY));
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: bchlib_readsectors
+ *
+ * Description:
+ *   Read whole sectors directly into the user buffer, taking the dirty
+ *   lines of the cache into account.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+ssize_t bchlib_readsectors(FAR struct bchlib_s *bch, FAR uint8_t *buffer,
+                           size_t sector, size_t nsectors)
+{
+  FAR struct inode *inode = bch->inode;
+  ssize_t ret;
+  int i;
+
+  ret = inode->u.i_bops->read(inode, buffer, sector, nsectors);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (bch->cache != NULL)
+    {
+      for (i = 0; i < BCH_NLINES; i++)
+        {
+          FAR struct bchlib_line_s *line = &bch->lines[i];
+
+          if (line->dirty && line->sector >= sector &&
+              line->sector < sector + nsectors)
+            {
+              memcpy(&buffer[(line->sector - sector) * bch->sectsize],
+                     BCH_LINE(bch, i), bch->sectsize);
+            }
+        }
+    }
+
+  bch->nextsector = sector + nsectors;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bchlib_writesectors
+ *
+ * Description:
+ *   Write whole sectors directly from the user buffer.  The lines of these
+ *   sectors are dropped as they would be stale.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+ssize_t bchlib_writesectors(FAR struct bchlib_s *bch,
+                            FAR const uint8_t *buffer, size_t sector,
+                            size_t nsectors)
+{
+  FAR struct inode *inode = bch->inode;
+
+  if (bch->cache != NULL)
+    {
+      bchlib_dropsectors(bch, sector, nsectors);
+    }
+
+  return inode->u.i_bops->write(inode, buffer, sector, nsectors);
+}
+
+/****************************************************************************
+ * Name: bchlib_freecache
+ *
+ * Description:
+ *   Free the sectors of the cache lines.  Dirty lines are lost, so the
+ *   cache must be flushed before.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_freecache(FAR struct bchlib_s *bch)
+{
+  if (bch->cache != NULL)
+    {
+      kmm_free(bch->cache);
+      bch->cache  = NULL;
+      bch->line   = NULL;
+      bch->buffer = NULL;
+      bch->sector = (size_t)-1;
+      bch->ndirty = 0;
+    }
+}
+#endif /* CONFIG_BCH_CACHE */
+
+/****************************************************************************
+ * Name: bchlib_reclaim
+ *
+ * Description:
+ *   Memory reclaim callback: free the sector buffer.  It is allocated again
+ *   by the next bchlib_readsector().  A dirty sector is only written back
+ *   when blocking is allowed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_RECLAIM
+size_t bchlib_reclaim(FAR void *arg, bool nonblock)
+{
+  FAR struct bchlib_s *bch = arg;
+  size_t released = 0;
+  int ret;
+
+  ret = nonblock ? nxmutex_trylock(&bch->lock) : nxmutex_lock(&bch->lock);
+  if (ret < 0)
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_BCH_CACHE
+  if (bch->cache != NULL && (bch->ndirty == 0 ||
+      (!nonblock && bchlib_flushsector(bch, true) >= 0)))
+    {
+      bchlib_freecache(bch);
+      released = BCH_NLINES * bch->sectsize;
+    }
+#else
+
+  if (bch->buffer != NULL && (!bch->dirty ||
+      (!nonblock && bchlib_flushsector(bch, true) >= 0)))
+    {
+      kmm_free(bch->buffer);
+      bch->buffer = NULL;
+      bch->sector = (size_t)-1;
+      released    = bch->sectsize;
+    }
+#endif
+
+  nxmutex_unlock(&bch->lock);
+  return released;
+}
+#endif
@@ -146,8 +146,13 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
           nsectors = bch->nsectors - sector;
         }
 
+#ifdef CONFIG_BCH_CACHE
+      ret = bchlib_readsectors(bch, (FAR uint8_t *)buffer, sector,
+                               nsectors);
+#else
       ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
                                        sector, nsectors);
+#endif
       if (ret < 0)
         {
           ferr("ERROR: Read failed: %d\n", ret);
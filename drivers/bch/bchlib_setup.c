@@ -110,6 +110,17 @@ int bchlib_setup(FAR const char *blkdev, bool readonly, FAR void **handle)
   bch->sectsize = geo.geo_sectorsize;
   bch->sector   = (size_t)-1;
   bch->readonly = readonly;
+#ifdef CONFIG_BCH_CACHE
+  bch->nextsector = (size_t)-1;
+#endif
+
+#ifdef CONFIG_MM_RECLAIM
+  bch->reclaim.reclaim = bchlib_reclaim;
+  bch->reclaim.arg     = bch;
+  bch->reclaim.cost    = MM_RECLAIM_COST_LOW;
+  mm_register_reclaim(&bch->reclaim);
+#endif
+
   *handle = bch;
   return OK;
 
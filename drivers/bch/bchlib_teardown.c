@@ -60,6 +60,20 @@ int bchlib_teardown(FAR void *handle)
       return -EBUSY;
     }
 
+#ifdef CONFIG_MM_RECLAIM
+  mm_unregister_reclaim(&bch->reclaim);
+#endif
+
+#ifdef CONFIG_BCH_CACHE_WRITEBACK
+  /* Stop the background write-back, which may have queued itself again
+   * while it was cancelled.
+   */
+
+  while (work_cancel_sync(LPWORK, &bch->work) >= 0)
+    {
+    }
+#endif
+
   /* Flush any pending data to the block driver */
 
   bchlib_flushsector(bch, false);
@@ -70,10 +84,14 @@ int bchlib_teardown(FAR void *handle)
 
   /* Free the BCH state structure */
 
+#ifdef CONFIG_BCH_CACHE
+  bchlib_freecache(bch);
+#else
   if (bch->buffer)
     {
       kmm_free(bch->buffer);
     }
+#endif
 
   nxmutex_destroy(&bch->lock);
   kmm_free(bch);
@@ -103,7 +103,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
         }
 
       memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      bchlib_dirtysector(bch);
 
       /* Adjust pointers and counts */
 
@@ -131,6 +131,12 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
           nsectors = bch->nsectors - sector;
         }
 
+#ifdef CONFIG_BCH_CACHE
+      /* Write the contiguous sectors, dropping their cache lines */
+
+      ret = bchlib_writesectors(bch, (FAR const uint8_t *)buffer, sector,
+                                nsectors);
+#else
       /* Flush the dirty sector to keep the sector sequence */
 
       ret = bchlib_flushsector(bch, sector <= bch->sector &&
@@ -145,6 +151,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
 
       ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
                                         sector, nsectors);
+#endif
       if (ret < 0)
         {
           ferr("ERROR: Write failed: %d\n", ret);
@@ -181,7 +188,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
       /* Copy the head end of the sector from the user buffer */
 
       memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      bchlib_dirtysector(bch);
 
       /* Adjust counts */
 
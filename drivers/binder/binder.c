@@ -33,6 +33,7 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <assert.h>
@@ -40,6 +41,7 @@
 #include <sched.h>
 
 #include <nuttx/sched.h>
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/android/binder.h>
 #include <nuttx/mutex.h>
@@ -719,7 +721,46 @@ static int binder_close(FAR struct file *filep)
 static ssize_t binder_read(FAR struct file *filep, FAR char *buffer,
                            size_t len)
 {
+#ifdef CONFIG_DRIVERS_BINDER_STATS
+  FAR struct binder_proc *proc = filep->f_priv;
+  FAR struct binder_stats *stats = &proc->context->stats;
+  struct binder_stats snap;
+  struct timespec avg;
+  struct timespec max;
+  irqstate_t flags;
+  uint32_t count;
+  char line[160];
+  int linelen;
+
+  flags = spin_lock_irqsave(&stats->lock);
+  snap = *stats;
+  spin_unlock_irqrestore(&stats->lock, flags);
+
+  count = snap.transactions + snap.replies;
+  perf_convert(count ? snap.latency_total / count : 0, &avg);
+  perf_convert(snap.latency_max, &max);
+
+  linelen = snprintf(line, sizeof(line),
+                     "transactions %" PRIu32 " oneway %" PRIu32
+                     " replies %" PRIu32 "\n"
+                     "latency avg %lu us max %lu us\n",
+                     snap.transactions, snap.oneway, snap.replies,
+                     (unsigned long)(avg.tv_sec * 1000000 +
+                                     avg.tv_nsec / 1000),
+                     (unsigned long)(max.tv_sec * 1000000 +
+                                     max.tv_nsec / 1000));
+  if (filep->f_pos >= linelen)
+    {
+      return 0;
+    }
+
+  len = MIN(len, linelen - filep->f_pos);
+  memcpy(buffer, line + filep->f_pos, len);
+  filep->f_pos += len;
+  return len;
+#else
   return 0;
+#endif
 }
 
 static ssize_t binder_write(FAR struct file *filep, FAR const char *buffer,
@@ -766,6 +807,9 @@ int binder_initialize(void)
   nxmutex_init(&device->context.context_lock);
   nxmutex_init(&device->binder_procs_lock);
   list_initialize(&device->binder_procs_list);
+#ifdef CONFIG_DRIVERS_BINDER_STATS
+  spin_lock_init(&device->context.stats.lock);
+#endif
 
   /* Register the device node. */
 
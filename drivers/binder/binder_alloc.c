@@ -500,22 +500,16 @@ static void binder_alloc_clear_buf(
   FAR struct binder_alloc *alloc, FAR struct binder_buffer *buffer)
 {
   size_t bytes = alloc_buffer_size(alloc, buffer);
-  binder_size_t buffer_offset = 0;
+  unsigned long pgoff;
 
-  while (bytes)
+  if (bytes == 0)
     {
-      unsigned long size;
-      void *page;
-      unsigned long pgoff;
-      void *kptr;
-
-      page = binder_alloc_get_page(alloc, buffer, buffer_offset, &pgoff);
-      size = MIN(bytes, PAGE_SIZE - pgoff);
-      kptr = page + pgoff;
-      memset(kptr, 0, size);
-      bytes -= size;
-      buffer_offset += size;
+      return;
     }
+
+  binder_alloc_get_page(alloc, buffer, 0, &pgoff);
+  binder_alloc_get_page(alloc, buffer, bytes - 1, &pgoff);
+  memset(buffer->user_data, 0, bytes);
 }
 
 static int binder_alloc_do_buffer_copy(
@@ -523,6 +517,9 @@ static int binder_alloc_do_buffer_copy(
   FAR struct binder_buffer *buffer, binder_size_t buffer_offset,
   FAR void *ptr, size_t bytes)
 {
+  unsigned long pgoff;
+  FAR uint8_t *kptr;
+
   /* All copies must be 32-bit aligned and 32-bit size */
 
   if (!check_buffer(alloc, buffer, buffer_offset, bytes))
@@ -530,34 +527,27 @@ static int binder_alloc_do_buffer_copy(
       return -EINVAL;
     }
 
-  while (bytes)
+  if (bytes == 0)
     {
-      unsigned long size;
-      FAR void *page;
-      unsigned long pgoff;
-      FAR void *tmpptr;
-      FAR void *base_ptr;
+      return 0;
+    }
 
-      page = binder_alloc_get_page(alloc, buffer,
-                                   buffer_offset, &pgoff);
-      size = MIN(bytes, (size_t)(PAGE_SIZE - pgoff));
-      base_ptr = page;
-      tmpptr = base_ptr + pgoff;
-      if (to_buffer)
-        {
-          BUG_ON(pgoff + size > PAGE_SIZE);
-          memcpy(tmpptr, ptr, size);
-        }
-      else
-        {
-          BUG_ON(pgoff + size > PAGE_SIZE);
-          memcpy(ptr, tmpptr, size);
-        }
+  /* The buffer area is one contiguous allocation, see binder_alloc_mmap(),
+   * so the pages of a buffer are adjacent and the data is copied in one go
+   * once the first and the last page are known to be present.
+   */
 
-      bytes -= size;
-      pgoff = 0;
-      ptr = ptr + size;
-      buffer_offset += size;
+  binder_alloc_get_page(alloc, buffer, buffer_offset, &pgoff);
+  binder_alloc_get_page(alloc, buffer, buffer_offset + bytes - 1, &pgoff);
+
+  kptr = (FAR uint8_t *)buffer->user_data + buffer_offset;
+  if (to_buffer)
+    {
+      memcpy(kptr, ptr, bytes);
+    }
+  else
+    {
+      memcpy(ptr, kptr, bytes);
     }
 
   return 0;
@@ -36,6 +36,7 @@
 #include <nuttx/android/binder.h>
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/nuttx.h>
 
 /****************************************************************************
@@ -280,10 +281,25 @@ struct binder_priority
  * struct binder_context - information about a binder context node
  */
 
+#ifdef CONFIG_DRIVERS_BINDER_STATS
+struct binder_stats
+{
+  spinlock_t lock;
+  uint32_t transactions;   /* BR_TRANSACTION delivered */
+  uint32_t oneway;         /* ... of which were one-way */
+  uint32_t replies;        /* BR_REPLY delivered */
+  clock_t latency_total;   /* Sum of the queue to delivery times */
+  clock_t latency_max;     /* Longest queue to delivery time */
+};
+#endif
+
 struct binder_context
 {
   FAR struct binder_node * mgr_node;
   mutex_t context_lock;
+#ifdef CONFIG_DRIVERS_BINDER_STATS
+  struct binder_stats stats;
+#endif
 };
 
 /**
@@ -535,6 +551,9 @@ struct binder_transaction
   uid_t sender_euid;
   struct list_node fd_fixups;
   binder_uintptr_t security_ctx;
+#ifdef CONFIG_DRIVERS_BINDER_STATS
+  clock_t stime;           /* perf_gettime() when queued */
+#endif
 
   /**
    * lock: protects from, to_proc, and to_thread
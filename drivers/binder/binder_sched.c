@@ -77,8 +77,20 @@ int binder_get_priority(pid_t pid, FAR struct binder_priority * priority)
 void binder_set_priority(FAR struct binder_thread *thread,
                          FAR const struct binder_priority *desired)
 {
+  struct binder_priority current;
   struct sched_param params;
 
+  /* Most transactions run between threads of the same priority, skip the
+   * scheduler call (and the reschedule it may cause) in that case.
+   */
+
+  if (binder_get_priority(thread->tid, &current) == 0 &&
+      current.sched_policy == desired->sched_policy &&
+      current.sched_prio == desired->sched_prio)
+    {
+      return;
+    }
+
   params.sched_priority = desired->sched_prio;
   sched_setscheduler(thread->tid, desired->sched_policy, &params);
 
@@ -41,6 +41,7 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/android/binder.h>
+#include <nuttx/clock.h>
 #include <nuttx/mutex.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/kmalloc.h>
@@ -226,6 +227,53 @@ static void binder_free_buf(FAR struct binder_proc *proc,
   binder_alloc_free_buf(&proc->alloc, buffer);
 }
 
+#ifdef CONFIG_DRIVERS_BINDER_STATS
+/****************************************************************************
+ * Name: binder_stats_update
+ *
+ * Description:
+ *   Account a transaction delivered to a thread of proc.
+ *
+ * Input Parameters:
+ *   proc - binder_proc receiving the transaction
+ *   t    - binder transaction being delivered
+ *   cmd  - BR_TRANSACTION or BR_REPLY
+ *
+ ****************************************************************************/
+
+static void binder_stats_update(FAR struct binder_proc *proc,
+                                FAR struct binder_transaction *t,
+                                uint32_t cmd)
+{
+  FAR struct binder_stats *stats = &proc->context->stats;
+  clock_t elapsed = perf_gettime() - t->stime;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&stats->lock);
+
+  if (cmd == BR_REPLY)
+    {
+      stats->replies++;
+    }
+  else
+    {
+      stats->transactions++;
+      if (t->flags & TF_ONE_WAY)
+        {
+          stats->oneway++;
+        }
+    }
+
+  stats->latency_total += elapsed;
+  if (elapsed > stats->latency_max)
+    {
+      stats->latency_max = elapsed;
+    }
+
+  spin_unlock_irqrestore(&stats->lock, flags);
+}
+#endif
+
 /****************************************************************************
  * Name: binder_get_txn_from
  *
@@ -1534,6 +1582,9 @@ retry:
         }
 
       binder_debug(BINDER_DEBUG_THREADS, "Send %s", BINDER_BR_STR(cmd));
+#ifdef CONFIG_DRIVERS_BINDER_STATS
+      binder_stats_update(proc, t, cmd);
+#endif
 
       data->code = t->code;
       data->flags = t->flags;
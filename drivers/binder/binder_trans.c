@@ -39,6 +39,7 @@
 #include <sched.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/android/binder.h>
+#include <nuttx/clock.h>
 #include <nuttx/mutex.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/kmalloc.h>
@@ -1457,6 +1458,9 @@ void binder_transaction(FAR struct binder_proc *proc,
 
   complete_work->type = BINDER_WORK_TRANSACTION_COMPLETE;
   tran->work.type = BINDER_WORK_TRANSACTION;
+#ifdef CONFIG_DRIVERS_BINDER_STATS
+  tran->stime = perf_gettime();
+#endif
   if (reply)
     {
       binder_enqueue_thread_work(thread, complete_work);
@@ -45,6 +45,7 @@
 #include <nuttx/can/can_sender.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/irq.h>
+#include <nuttx/wdog.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -93,6 +94,15 @@
 #ifdef CONFIG_CAN_TXREADY
 static void           can_txready_work(FAR void *arg);
 #endif
+static void           can_rxtimeout(wdparm_t arg);
+#ifdef CONFIG_CAN_SOFTFILTER
+static int            can_softfilter_add(FAR struct can_dev_s *dev, int cmd,
+                                         unsigned long arg);
+static int            can_softfilter_del(FAR struct can_dev_s *dev,
+                                         unsigned long arg);
+static bool           can_softfilter_match(FAR struct can_dev_s *dev,
+                                           FAR struct can_hdr_s *hdr);
+#endif
 
 /* Character driver methods */
 
@@ -191,11 +201,216 @@ static FAR struct can_reader_s *init_can_reader(FAR struct file *filep)
   DEBUGASSERT(reader != NULL);
 
   nxsem_init(&reader->fifo.rx_sem, 0, 0);
+  reader->dev   = filep->f_inode->i_private;
   filep->f_priv = reader;
 
   return reader;
 }
 
+/****************************************************************************
+ * Name: can_rxcount
+ *
+ * Description:
+ *   Return the number of messages in the receive FIFO of a reader.
+ *
+ ****************************************************************************/
+
+static int can_rxcount(FAR struct can_rxfifo_s *fifo)
+{
+  int count = fifo->rx_tail - fifo->rx_head;
+
+  return count < 0 ? count + CONFIG_CAN_RXFIFOSIZE : count;
+}
+
+/****************************************************************************
+ * Name: can_rxwakeup
+ *
+ * Description:
+ *   Wake up the reader waiting for the messages in its receive FIFO.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+static void can_rxwakeup(FAR struct can_rxfifo_s *fifo)
+{
+  int sval;
+
+  if (nxsem_get_value(&fifo->rx_sem, &sval) == OK && sval <= 0)
+    {
+      nxsem_post(&fifo->rx_sem);
+    }
+}
+
+/****************************************************************************
+ * Name: can_rxtimeout
+ *
+ * Description:
+ *   The messages of a reader waited rx_timeout for the watermark, deliver
+ *   them now.
+ *
+ ****************************************************************************/
+
+static void can_rxtimeout(wdparm_t arg)
+{
+  FAR struct can_reader_s *reader = (FAR struct can_reader_s *)arg;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (reader->fifo.rx_head != reader->fifo.rx_tail)
+    {
+      can_rxwakeup(&reader->fifo);
+      poll_notify(reader->dev->cd_fds, CONFIG_CAN_NPOLLWAITERS, POLLIN);
+    }
+
+  leave_critical_section(flags);
+}
+
+#ifdef CONFIG_CAN_SOFTFILTER
+/****************************************************************************
+ * Name: can_softfilter_add
+ *
+ * Description:
+ *   Add an acceptance filter that is applied by can_receive(), for the
+ *   lower halves without hardware filters.
+ *
+ * Returned Value:
+ *   The filter ID, CAN_SOFTFILTER_ID or above, on success; a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+static int can_softfilter_add(FAR struct can_dev_s *dev, int cmd,
+                              unsigned long arg)
+{
+  FAR struct can_softfilter_s *filter;
+  int i;
+
+  for (i = 0; i < CONFIG_CAN_NSOFTFILTERS; i++)
+    {
+      if (!dev->cd_filters[i].cf_used)
+        {
+          break;
+        }
+    }
+
+  if (i >= CONFIG_CAN_NSOFTFILTERS)
+    {
+      return -ENOSPC;
+    }
+
+  filter = &dev->cd_filters[i];
+  if (cmd == CANIOC_ADD_STDFILTER)
+    {
+      FAR const struct canioc_stdfilter_s *sf =
+        (FAR const struct canioc_stdfilter_s *)arg;
+
+      filter->cf_id1   = sf->sf_id1;
+      filter->cf_id2   = sf->sf_id2;
+      filter->cf_type  = sf->sf_type;
+      filter->cf_extid = false;
+    }
+  else
+    {
+#ifdef CONFIG_CAN_EXTID
+      FAR const struct canioc_extfilter_s *xf =
+        (FAR const struct canioc_extfilter_s *)arg;
+
+      filter->cf_id1   = xf->xf_id1;
+      filter->cf_id2   = xf->xf_id2;
+      filter->cf_type  = xf->xf_type;
+      filter->cf_extid = true;
+#else
+      return -ENOTTY;
+#endif
+    }
+
+  if (filter->cf_type > CAN_FILTER_RANGE)
+    {
+      return -EINVAL;
+    }
+
+  filter->cf_used = true;
+  dev->cd_nfilters++;
+  return CAN_SOFTFILTER_ID + i;
+}
+
+/****************************************************************************
+ * Name: can_softfilter_del
+ ****************************************************************************/
+
+static int can_softfilter_del(FAR struct can_dev_s *dev, unsigned long arg)
+{
+  unsigned long i = arg - CAN_SOFTFILTER_ID;
+
+  if (i >= CONFIG_CAN_NSOFTFILTERS || !dev->cd_filters[i].cf_used)
+    {
+      return -EINVAL;
+    }
+
+  dev->cd_filters[i].cf_used = false;
+  dev->cd_nfilters--;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: can_softfilter_match
+ *
+ * Description:
+ *   Return true if the message passes one of the software filters.
+ *
+ ****************************************************************************/
+
+static bool can_softfilter_match(FAR struct can_dev_s *dev,
+                                 FAR struct can_hdr_s *hdr)
+{
+  FAR struct can_softfilter_s *filter;
+  uint32_t id = hdr->ch_id;
+  bool extid = false;
+  int i;
+
+#ifdef CONFIG_CAN_EXTID
+  extid = hdr->ch_extid;
+#endif
+
+  for (i = 0; i < CONFIG_CAN_NSOFTFILTERS; i++)
+    {
+      filter = &dev->cd_filters[i];
+      if (!filter->cf_used || filter->cf_extid != extid)
+        {
+          continue;
+        }
+
+      switch (filter->cf_type)
+        {
+          case CAN_FILTER_MASK:
+            if ((id & filter->cf_id2) == (filter->cf_id1 & filter->cf_id2))
+              {
+                return true;
+              }
+            break;
+
+          case CAN_FILTER_DUAL:
+            if (id == filter->cf_id1 || id == filter->cf_id2)
+              {
+                return true;
+              }
+            break;
+
+          case CAN_FILTER_RANGE:
+            if (id >= filter->cf_id1 && id <= filter->cf_id2)
+              {
+                return true;
+              }
+            break;
+        }
+    }
+
+  return false;
+}
+#endif /* CONFIG_CAN_SOFTFILTER */
+
 /****************************************************************************
  * Name: can_open
  *
@@ -307,6 +522,7 @@ static int can_close(FAR struct file *filep)
           ((FAR struct can_reader_s *)filep->f_priv))
         {
           list_delete(node);
+          wd_cancel(&((FAR struct can_reader_s *)node)->rx_wdog);
           kmm_free(node);
           break;
         }
@@ -480,6 +696,10 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
 
           nxsem_post(&fifo->rx_sem);
         }
+      else
+        {
+          wd_cancel(&reader->rx_wdog);
+        }
 
 return_with_irqdisabled:
       leave_critical_section(flags);
@@ -882,6 +1102,62 @@ static int can_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      /* CANIOC_SET_RXWATERMARK: Batch the wakeups of this reader */
+
+      case CANIOC_SET_RXWATERMARK:
+        {
+          FAR const struct canioc_rxwatermark_s *rw =
+            (FAR const struct canioc_rxwatermark_s *)arg;
+
+          if (reader == NULL || rw == NULL ||
+              rw->rw_count >= CONFIG_CAN_RXFIFOSIZE)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          reader->fifo.rx_watermark = rw->rw_count;
+          reader->fifo.rx_timeout   = MSEC2TICK(rw->rw_timeout);
+
+          /* Deliver the messages already waiting for a higher watermark */
+
+          if (reader->fifo.rx_head != reader->fifo.rx_tail)
+            {
+              wd_cancel(&reader->rx_wdog);
+              can_rxwakeup(&reader->fifo);
+            }
+        }
+        break;
+
+#ifdef CONFIG_CAN_SOFTFILTER
+      /* Fall back to software filters if the lower half has none */
+
+      case CANIOC_ADD_STDFILTER:
+      case CANIOC_ADD_EXTFILTER:
+        {
+          ret = dev_ioctl(dev, cmd, arg);
+          if (ret == -ENOTTY)
+            {
+              ret = can_softfilter_add(dev, cmd, arg);
+            }
+        }
+        break;
+
+      case CANIOC_DEL_STDFILTER:
+      case CANIOC_DEL_EXTFILTER:
+        {
+          if (arg >= CAN_SOFTFILTER_ID)
+            {
+              ret = can_softfilter_del(dev, arg);
+            }
+          else
+            {
+              ret = dev_ioctl(dev, cmd, arg);
+            }
+        }
+        break;
+#endif
+
       /* Set specfic can transceiver state */
 
       case CANIOC_SET_TRANSVSTATE:
@@ -956,6 +1232,7 @@ static int can_poll(FAR struct file *filep, FAR struct pollfd *fds,
   FAR struct can_reader_s *reader = NULL;
   pollevent_t eventset = 0;
   irqstate_t flags;
+  int sval;
   int ret;
   int i;
 
@@ -1027,9 +1304,18 @@ static int can_poll(FAR struct file *filep, FAR struct pollfd *fds,
           eventset |= POLLOUT;
         }
 
-      /* Check whether there are messages in the RX FIFO. */
+      /* Check whether there are messages in the RX FIFO, as many as the
+       * watermark or the ones already delivered by can_rxtimeout().
+       */
+
+      if (nxsem_get_value(&reader->fifo.rx_sem, &sval) < 0)
+        {
+          sval = 0;
+        }
 
-      if (reader->fifo.rx_head != reader->fifo.rx_tail
+      if ((reader->fifo.rx_head != reader->fifo.rx_tail &&
+           (sval > 0 ||
+            can_rxcount(&reader->fifo) >= reader->fifo.rx_watermark))
 #ifdef CONFIG_CAN_ERRORS
           || reader->fifo.rx_error != 0
 #endif
@@ -1146,6 +1432,7 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
   int                      ret = -ENOMEM;
   int                      i;
   int                      sval;
+  bool                     notify = false;
 
   caninfo("ID: %" PRId32 " DLC: %d\n", (uint32_t)hdr->ch_id, hdr->ch_dlc);
 
@@ -1206,6 +1493,22 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
         }
     }
 
+#ifdef CONFIG_CAN_SOFTFILTER
+  /* Drop the messages that pass none of the software filters, the errors
+   * are always delivered.
+   */
+
+  if (dev->cd_nfilters > 0 &&
+#ifdef CONFIG_CAN_ERRORS
+      hdr->ch_error == false &&
+#endif
+      !can_softfilter_match(dev, hdr))
+    {
+      leave_critical_section(flags);
+      return OK;
+    }
+#endif
+
   list_for_every(&dev->cd_readers, node)
     {
       FAR struct can_reader_s *reader = (FAR struct can_reader_s *)node;
@@ -1245,6 +1548,24 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
           /* Increment the tail of the circular buffer */
 
           fifo->rx_tail = nexttail;
+          ret = OK;
+
+          /* Below the watermark of the reader, wake it up later */
+
+          sval = can_rxcount(fifo);
+          if (sval < fifo->rx_watermark)
+            {
+              if (sval == 1 && fifo->rx_timeout > 0)
+                {
+                  wd_start(&reader->rx_wdog, fifo->rx_timeout,
+                           can_rxtimeout, (wdparm_t)reader);
+                }
+
+              continue;
+            }
+
+          wd_cancel(&reader->rx_wdog);
+          notify = true;
 
           if (nxsem_get_value(&fifo->rx_sem, &sval) < 0)
             {
@@ -1265,8 +1586,6 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
             {
               nxsem_post(&fifo->rx_sem);
             }
-
-          ret = OK;
         }
 #ifdef CONFIG_CAN_ERRORS
       else
@@ -1282,7 +1601,7 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
    * cd_recv buffer
    */
 
-  if (ret == OK)
+  if (notify)
     {
       poll_notify(dev->cd_fds, CONFIG_CAN_NPOLLWAITERS, POLLIN);
     }
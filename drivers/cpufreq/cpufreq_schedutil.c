@@ -0,0 +1,400 @@
+/****************************************************************************
+ * drivers/cpufreq/cpufreq_schedutil.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The schedutil governor follows the utilization seen by the scheduler.
+ * A sched_note driver accounts the busy time of every CPU at each context
+ * switch and kicks the governor as soon as a task has to wait for a CPU,
+ * instead of waiting for the next sample like ondemand does.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/clock.h>
+#include <nuttx/note/note_driver.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wdog.h>
+#include <sched/sched.h>
+#include <sys/param.h>
+
+#include "cpufreq_internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CPUFREQ_MIN_SAMPLING_INTERVAL   (2 * USEC_PER_TICK)
+
+/* The utilization is scaled to 1024, the frequency chosen leaves 25% of
+ * headroom like the schedutil governor of Linux.
+ */
+
+#define CPUFREQ_UTIL_SCALE              1024
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct cpufreq_schedutil_s
+{
+  struct note_driver_s driver;
+  struct work_s work;
+  struct wdog_s kick;
+  spinlock_t lock;
+  FAR struct cpufreq_policy *policy;
+  unsigned int rate_limit;              /* in us */
+  bool kicked;                          /* The kick is pending */
+  bool pressure;                        /* A task waited for a CPU */
+  clock_t start;                        /* Start of the window */
+  clock_t window;                       /* rate_limit in perf counts */
+  clock_t last[CONFIG_SMP_NCPUS];       /* Last switch of every CPU */
+  clock_t busy[CONFIG_SMP_NCPUS];       /* Busy time in the window */
+  bool running[CONFIG_SMP_NCPUS];       /* A task, not idle, is running */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cpufreq_schedutil_resume(FAR struct note_driver_s *drv,
+                                     FAR struct tcb_s *tcb);
+static void cpufreq_schedutil_worker(FAR void *arg);
+static int cpufreq_gov_schedutil_init(FAR struct cpufreq_policy *policy);
+static int cpufreq_gov_schedutil_exit(FAR struct cpufreq_policy *policy);
+static int cpufreq_gov_schedutil_start(FAR struct cpufreq_policy *policy);
+static void cpufreq_gov_schedutil_stop(FAR struct cpufreq_policy *policy);
+static void cpufreq_gov_schedutil_limits(FAR struct cpufreq_policy *policy);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct note_driver_ops_s g_cpufreq_schedutil_ops =
+{
+  NULL,                       /* add */
+  NULL,                       /* start */
+  NULL,                       /* stop */
+  NULL,                       /* suspend */
+  cpufreq_schedutil_resume,   /* resume */
+};
+
+static struct cpufreq_schedutil_s g_cpufreq_schedutil =
+{
+  {
+#ifdef CONFIG_SCHED_INSTRUMENTATION_FILTER
+    "schedutil",
+    {
+      {
+        NOTE_FILTER_MODE_FLAG_ENABLE | NOTE_FILTER_MODE_FLAG_SWITCH,
+#  ifdef CONFIG_SMP
+        CONFIG_SCHED_INSTRUMENTATION_CPUSET
+#  endif
+      },
+    },
+#endif
+    &g_cpufreq_schedutil_ops
+  }
+};
+
+static struct cpufreq_governor g_cpufreq_gov_schedutil =
+{
+  .name   = "schedutil",
+  .init   = cpufreq_gov_schedutil_init,
+  .exit   = cpufreq_gov_schedutil_exit,
+  .start  = cpufreq_gov_schedutil_start,
+  .stop   = cpufreq_gov_schedutil_stop,
+  .limits = cpufreq_gov_schedutil_limits,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cpufreq_schedutil_waiting
+ *
+ * Description:
+ *   Return true if a task ready to run waits for a CPU.
+ *
+ ****************************************************************************/
+
+static bool cpufreq_schedutil_waiting(FAR struct tcb_s *tcb)
+{
+#ifdef CONFIG_SMP
+  FAR struct tcb_s *next = (FAR struct tcb_s *)list_readytorun()->head;
+#else
+  FAR struct tcb_s *next = tcb->flink;
+#endif
+
+  return next != NULL && !is_idle_task(next);
+}
+
+static void cpufreq_schedutil_kick(wdparm_t arg)
+{
+  FAR struct cpufreq_schedutil_s *data =
+    (FAR struct cpufreq_schedutil_s *)arg;
+  FAR struct cpufreq_policy *policy = data->policy;
+
+  if (policy != NULL)
+    {
+      work_queue(HPWORK, &data->work, cpufreq_schedutil_worker, policy, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: cpufreq_schedutil_resume
+ *
+ * Description:
+ *   Account the busy time of the CPU at the context switch.  The governor
+ *   runs in the work queue, so it is kicked through a watchdog rather than
+ *   queued from the middle of the switch.
+ *
+ ****************************************************************************/
+
+static void cpufreq_schedutil_resume(FAR struct note_driver_s *drv,
+                                     FAR struct tcb_s *tcb)
+{
+  FAR struct cpufreq_schedutil_s *data =
+    (FAR struct cpufreq_schedutil_s *)drv;
+  int cpu = this_cpu();
+  irqstate_t flags;
+  clock_t now;
+  bool kick;
+
+  if (data->policy == NULL)
+    {
+      return;
+    }
+
+  now   = perf_gettime();
+  flags = spin_lock_irqsave(&data->lock);
+
+  if (data->running[cpu])
+    {
+      data->busy[cpu] += now - data->last[cpu];
+    }
+
+  data->last[cpu]    = now;
+  data->running[cpu] = !is_idle_task(tcb);
+
+  if (data->running[cpu] && cpufreq_schedutil_waiting(tcb))
+    {
+      data->pressure = true;
+    }
+
+  kick = !data->kicked &&
+         ((data->pressure && data->policy->cur < data->policy->max) ||
+          now - data->start >= data->window);
+  if (kick)
+    {
+      data->kicked = true;
+    }
+
+  spin_unlock_irqrestore(&data->lock, flags);
+
+  if (kick)
+    {
+      wd_start(&data->kick, 0, cpufreq_schedutil_kick, (wdparm_t)data);
+    }
+}
+
+/****************************************************************************
+ * Name: cpufreq_schedutil_util
+ *
+ * Description:
+ *   Return the utilization of the busiest CPU in the window that ends now,
+ *   and start the next window.
+ *
+ ****************************************************************************/
+
+static unsigned int
+cpufreq_schedutil_util(FAR struct cpufreq_schedutil_s *data,
+                       FAR bool *pressure)
+{
+  unsigned int util = 0;
+  irqstate_t flags;
+  clock_t elapsed;
+  clock_t now;
+  int cpu;
+
+  now     = perf_gettime();
+  flags   = spin_lock_irqsave(&data->lock);
+  elapsed = now - data->start;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (data->running[cpu])
+        {
+          data->busy[cpu] += now - data->last[cpu];
+          data->last[cpu]  = now;
+        }
+
+      if (elapsed > 0)
+        {
+          util = MAX(util, (unsigned int)(data->busy[cpu] *
+                                          CPUFREQ_UTIL_SCALE / elapsed));
+        }
+
+      data->busy[cpu] = 0;
+    }
+
+  *pressure      = data->pressure;
+  data->pressure = false;
+  data->kicked   = false;
+  data->start    = now;
+
+  spin_unlock_irqrestore(&data->lock, flags);
+  return MIN(util, CPUFREQ_UTIL_SCALE);
+}
+
+static void cpufreq_schedutil_worker(FAR void *arg)
+{
+  FAR struct cpufreq_policy *policy = arg;
+  FAR struct cpufreq_schedutil_s *data = policy->governor_data;
+  unsigned int target_freq;
+  unsigned int util;
+  bool pressure;
+
+  util = cpufreq_schedutil_util(data, &pressure);
+
+  /* Go to the highest frequency while tasks wait for a CPU, else follow
+   * the utilization within the limits of the QoS requests.
+   */
+
+  nxmutex_lock(&policy->lock);
+  if (pressure)
+    {
+      target_freq = policy->max;
+    }
+  else
+    {
+      target_freq = (uint64_t)policy->max * util * 5 /
+                    (4 * CPUFREQ_UTIL_SCALE);
+      target_freq = MIN(MAX(target_freq, policy->min), policy->max);
+    }
+
+  cpufreq_driver_target(policy, target_freq, CPUFREQ_RELATION_L);
+  nxmutex_unlock(&policy->lock);
+
+  /* Sample again if no context switch comes before the next window */
+
+  work_queue(HPWORK,
+             &data->work,
+             cpufreq_schedutil_worker,
+             policy,
+             data->rate_limit / USEC_PER_TICK);
+}
+
+static int cpufreq_gov_schedutil_init(FAR struct cpufreq_policy *policy)
+{
+  FAR struct cpufreq_schedutil_s *data = &g_cpufreq_schedutil;
+  static bool registered;
+  int ret;
+
+  if (!registered)
+    {
+      ret = note_driver_register(&data->driver);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      spin_lock_init(&data->lock);
+      registered = true;
+    }
+
+  data->rate_limit = MAX(CPUFREQ_MIN_SAMPLING_INTERVAL,
+                         CONFIG_CPUFREQ_SCHEDUTIL_RATE_LIMIT);
+
+  /* Convert the rate limit to the counts of perf_gettime() */
+
+  data->window = (clock_t)data->rate_limit * perf_getfreq() / USEC_PER_SEC;
+
+  policy->governor_data = data;
+  return 0;
+}
+
+static int cpufreq_gov_schedutil_exit(FAR struct cpufreq_policy *policy)
+{
+  policy->governor_data = NULL;
+  return 0;
+}
+
+static int cpufreq_gov_schedutil_start(FAR struct cpufreq_policy *policy)
+{
+  FAR struct cpufreq_schedutil_s *data = policy->governor_data;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&data->lock);
+  data->start  = perf_gettime();
+  data->kicked = false;
+  data->policy = policy;
+  spin_unlock_irqrestore(&data->lock, flags);
+
+  work_queue(HPWORK,
+             &data->work,
+             cpufreq_schedutil_worker,
+             policy,
+             0);
+  return 0;
+}
+
+static void cpufreq_gov_schedutil_stop(FAR struct cpufreq_policy *policy)
+{
+  FAR struct cpufreq_schedutil_s *data = policy->governor_data;
+
+  data->policy = NULL;
+  wd_cancel(&data->kick);
+
+  if (sched_idletask())
+    {
+      work_cancel(HPWORK, &data->work);
+    }
+  else
+    {
+      work_cancel_sync(HPWORK, &data->work);
+    }
+}
+
+static void cpufreq_gov_schedutil_limits(FAR struct cpufreq_policy *policy)
+{
+  nxmutex_lock(&policy->lock);
+  if (policy->max < policy->cur)
+    {
+      cpufreq_driver_target(policy, policy->max, CPUFREQ_RELATION_H);
+    }
+  else if (policy->min > policy->cur)
+    {
+      cpufreq_driver_target(policy, policy->min, CPUFREQ_RELATION_L);
+    }
+
+  nxmutex_unlock(&policy->lock);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+FAR struct cpufreq_governor *cpufreq_default_governor(void)
+{
+  return &g_cpufreq_gov_schedutil;
+}
@@ -475,7 +475,7 @@ uintptr_t fdt_get_clock_frequency_from_clocks(FAR const void *fdt,
 
   clk_phandle = fdt32_ld(pv + index);
 
-  pv_offset = fdt_node_offset_by_phandle(fdt, clk_phandle);
+  pv_offset = fdt_find_phandle(fdt, clk_phandle);
   if (pv_offset < 0)
     {
       return clock_frequency;
@@ -534,8 +534,7 @@ void fdt_node_from_compat(FAR const void *fdt,
     {
       while (true)
         {
-          offset
-              = fdt_node_offset_by_compatible(fdt, offset, *compatible_ids);
+          offset = fdt_find_compatible(fdt, offset, *compatible_ids);
           if (offset == -FDT_ERR_NOTFOUND)
             {
               break;
@@ -0,0 +1,331 @@
+/****************************************************************************
+ * drivers/devicetree/fdt_index.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/fdt.h>
+#include <nuttx/init.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+
+#include <libfdt.h>
+
+#ifdef CONFIG_DEVICE_TREE_INDEX
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A node with a phandle, in the open addressing hash table */
+
+struct fdt_index_phandle_s
+{
+  uint32_t phandle;                /* 0 for an empty slot */
+  int offset;
+};
+
+/* A string of the compatible property of a node.  The strings of a bucket
+ * are chained in the order of the nodes in the tree.
+ */
+
+struct fdt_index_compat_s
+{
+  FAR const char *name;
+  int offset;
+  int next;                        /* Next string of the bucket, or -1 */
+};
+
+struct fdt_index_s
+{
+  FAR const void *fdt;             /* The tree indexed */
+  FAR struct fdt_index_phandle_s *phandles;
+  FAR struct fdt_index_compat_s *compats;
+  FAR int *buckets;                /* First string of each bucket, or -1 */
+  unsigned int nphandles;          /* Slots of the phandle table */
+  unsigned int nbuckets;           /* Buckets of the compatible table */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct fdt_index_s g_fdt_index;
+static mutex_t g_fdt_index_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static unsigned int fdt_index_hash(FAR const char *name)
+{
+  unsigned int hash = 5381;
+
+  while (*name != '\0')
+    {
+      hash = hash * 33 + (unsigned char)*name++;
+    }
+
+  return hash;
+}
+
+/* The power of 2 at least twice as large as n, for short probe chains */
+
+static unsigned int fdt_index_size(unsigned int n)
+{
+  unsigned int size = 1;
+
+  while (size < 2 * n)
+    {
+      size <<= 1;
+    }
+
+  return size;
+}
+
+/****************************************************************************
+ * Name: fdt_index_build
+ *
+ * Description:
+ *   Walk the tree once and build the phandle hash table and the compatible
+ *   lists.
+ *
+ ****************************************************************************/
+
+static int fdt_index_build(FAR struct fdt_index_s *index,
+                           FAR const void *fdt)
+{
+  FAR struct fdt_index_phandle_s *slot;
+  FAR const char *compat;
+  unsigned int nphandles = 0;
+  unsigned int ncompats = 0;
+  unsigned int bucket;
+  uint32_t phandle;
+  int offset;
+  int len;
+  int i;
+
+  /* Count the phandles and the compatible strings first */
+
+  for (offset = fdt_next_node(fdt, -1, NULL); offset >= 0;
+       offset = fdt_next_node(fdt, offset, NULL))
+    {
+      phandle = fdt_get_phandle(fdt, offset);
+      if (phandle != 0 && phandle != (uint32_t)-1)
+        {
+          nphandles++;
+        }
+
+      compat = fdt_getprop(fdt, offset, "compatible", &len);
+      for (i = 0; compat != NULL && i < len; i += strlen(compat + i) + 1)
+        {
+          ncompats++;
+        }
+    }
+
+  index->nphandles = fdt_index_size(nphandles);
+  index->nbuckets  = fdt_index_size(ncompats);
+  index->phandles  = kmm_zalloc(index->nphandles * sizeof(*index->phandles) +
+                                ncompats * sizeof(*index->compats) +
+                                index->nbuckets * sizeof(int));
+  if (index->phandles == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  index->compats = (FAR struct fdt_index_compat_s *)
+                   (index->phandles + index->nphandles);
+  index->buckets = (FAR int *)(index->compats + ncompats);
+  memset(index->buckets, 0xff, index->nbuckets * sizeof(int));
+
+  ncompats = 0;
+  for (offset = fdt_next_node(fdt, -1, NULL); offset >= 0;
+       offset = fdt_next_node(fdt, offset, NULL))
+    {
+      phandle = fdt_get_phandle(fdt, offset);
+      if (phandle != 0 && phandle != (uint32_t)-1)
+        {
+          slot = &index->phandles[phandle & (index->nphandles - 1)];
+          while (slot->phandle != 0)
+            {
+              if (++slot == index->phandles + index->nphandles)
+                {
+                  slot = index->phandles;
+                }
+            }
+
+          slot->phandle = phandle;
+          slot->offset  = offset;
+        }
+
+      compat = fdt_getprop(fdt, offset, "compatible", &len);
+      for (i = 0; compat != NULL && i < len; i += strlen(compat + i) + 1)
+        {
+          index->compats[ncompats].name   = compat + i;
+          index->compats[ncompats].offset = offset;
+          ncompats++;
+        }
+    }
+
+  /* Chain the strings from the last one so that the buckets list them in
+   * the order of the tree.
+   */
+
+  for (i = ncompats - 1; i >= 0; i--)
+    {
+      bucket = fdt_index_hash(index->compats[i].name) &
+               (index->nbuckets - 1);
+      index->compats[i].next = index->buckets[bucket];
+      index->buckets[bucket] = i;
+    }
+
+  index->fdt = fdt;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fdt_index_get
+ *
+ * Description:
+ *   Return the index of the tree, built on the first lookup, or NULL if
+ *   the lookup has to walk the tree.
+ *
+ ****************************************************************************/
+
+static FAR struct fdt_index_s *fdt_index_get(FAR const void *fdt)
+{
+  FAR struct fdt_index_s *index = &g_fdt_index;
+
+  /* The trees parsed before the heap is ready are not indexed */
+
+  if (!OSINIT_MM_READY() || nxmutex_lock(&g_fdt_index_lock) < 0)
+    {
+      return NULL;
+    }
+
+  if (index->fdt != fdt)
+    {
+      kmm_free(index->phandles);
+      memset(index, 0, sizeof(*index));
+      if (fdt_index_build(index, fdt) < 0)
+        {
+          memset(index, 0, sizeof(*index));
+          index = NULL;
+        }
+    }
+
+  nxmutex_unlock(&g_fdt_index_lock);
+  return index;
+}
+
+#endif /* CONFIG_DEVICE_TREE_INDEX */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fdt_find_compatible
+ *
+ * Description:
+ *   Find the next node after startoffset that is compatible with the
+ *   string, like fdt_node_offset_by_compatible().  With
+ *   CONFIG_DEVICE_TREE_INDEX the lookup uses an index of the tree instead
+ *   of walking it.
+ *
+ ****************************************************************************/
+
+int fdt_find_compatible(FAR const void *fdt, int startoffset,
+                        FAR const char *compatible)
+{
+#ifdef CONFIG_DEVICE_TREE_INDEX
+  FAR struct fdt_index_s *index = fdt_index_get(fdt);
+  FAR struct fdt_index_compat_s *compat;
+  int i;
+
+  if (index != NULL)
+    {
+      i = index->buckets[fdt_index_hash(compatible) &
+                         (index->nbuckets - 1)];
+      for (; i >= 0; i = compat->next)
+        {
+          compat = &index->compats[i];
+          if (compat->offset > startoffset &&
+              strcmp(compat->name, compatible) == 0)
+            {
+              return compat->offset;
+            }
+        }
+
+      return -FDT_ERR_NOTFOUND;
+    }
+#endif
+
+  return fdt_node_offset_by_compatible(fdt, startoffset, compatible);
+}
+
+/****************************************************************************
+ * Name: fdt_find_phandle
+ *
+ * Description:
+ *   Find the node of a phandle, like fdt_node_offset_by_phandle().  With
+ *   CONFIG_DEVICE_TREE_INDEX the lookup uses an index of the tree instead
+ *   of walking it.
+ *
+ ****************************************************************************/
+
+int fdt_find_phandle(FAR const void *fdt, uint32_t phandle)
+{
+#ifdef CONFIG_DEVICE_TREE_INDEX
+  FAR struct fdt_index_s *index;
+  FAR struct fdt_index_phandle_s *slot;
+
+  if (phandle == 0 || phandle == (uint32_t)-1)
+    {
+      return -FDT_ERR_BADPHANDLE;
+    }
+
+  index = fdt_index_get(fdt);
+  if (index != NULL)
+    {
+      slot = &index->phandles[phandle & (index->nphandles - 1)];
+      while (slot->phandle != 0)
+        {
+          if (slot->phandle == phandle)
+            {
+              return slot->offset;
+            }
+
+          if (++slot == index->phandles + index->nphandles)
+            {
+              slot = index->phandles;
+            }
+        }
+
+      return -FDT_ERR_NOTFOUND;
+    }
+#endif
+
+  return fdt_node_offset_by_phandle(fdt, phandle);
+}
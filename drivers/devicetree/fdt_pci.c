@@ -88,8 +88,7 @@ int fdt_pci_ecam_register(FAR const void *fdt)
   memset(&mem, 0, sizeof(mem));
   memset(&io, 0, sizeof(io));
 
-  offset = fdt_node_offset_by_compatible(fdt, -1,
-                                         "pci-host-ecam-generic");
+  offset = fdt_find_compatible(fdt, -1, "pci-host-ecam-generic");
   if (offset < 0)
     {
       return offset;
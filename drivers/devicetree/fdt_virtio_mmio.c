@@ -63,7 +63,7 @@ int fdt_virtio_mmio_devices_register(FAR const void *fdt, int irqbase)
 
   for (; ; )
     {
-      offset = fdt_node_offset_by_compatible(fdt, offset, "virtio,mmio");
+      offset = fdt_find_compatible(fdt, offset, "virtio,mmio");
       if (offset == -FDT_ERR_NOTFOUND)
         {
           break;
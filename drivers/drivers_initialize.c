@@ -30,6 +30,7 @@
 #include <nuttx/fs/loop.h>
 #include <nuttx/fs/smart.h>
 #include <nuttx/fs/loopmtd.h>
+#include <nuttx/init.h>
 #include <nuttx/input/uinput.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/net/loopback.h>
@@ -120,68 +121,84 @@ void drivers_initialize(void)
 
   /* Register devices */
 
-  syslog_initialize();
+  INITCALL(syslog_initialize());
 
 #ifdef CONFIG_SYSEVENT
-  sysevent_dev_init();
+  INITCALL(sysevent_dev_init());
 #endif
 
 #ifdef CONFIG_SERIAL_RTT
-  serial_rtt_initialize();
+  INITCALL(serial_rtt_initialize());
 #endif
 
 #if defined(CONFIG_DEV_NULL)
-  devnull_register();   /* Standard /dev/null */
+  INITCALL(devnull_register());   /* Standard /dev/null */
 #endif
 
 #if defined(CONFIG_DEV_RANDOM)
-  devrandom_register(); /* Standard /dev/random */
+  INITCALL(devrandom_register()); /* Standard /dev/random */
 #endif
 
 #if defined(CONFIG_DEV_URANDOM)
-  devurandom_register();   /* Standard /dev/urandom */
+  INITCALL(devurandom_register());   /* Standard /dev/urandom */
 #endif
 
 #if defined(CONFIG_DEV_ZERO)
-  devzero_register();   /* Standard /dev/zero */
+  INITCALL(devzero_register());   /* Standard /dev/zero */
 #endif
 
 #ifdef CONFIG_DEV_MEM
-  devmem_register();
+  INITCALL(devmem_register());
 #endif
 
 #if defined(CONFIG_DEV_LOOP)
-  loop_register();      /* Standard /dev/loop */
+  INITCALL(loop_register());      /* Standard /dev/loop */
 #endif
 
 #if defined(CONFIG_DEV_ASCII)
-  devascii_register();  /* Non-standard /dev/ascii */
+  INITCALL(devascii_register());  /* Non-standard /dev/ascii */
+#endif
+
+#if defined(CONFIG_DEV_OSBENCH)
+  INITCALL(devosbench_register()); /* Non-standard /dev/osbench */
+#endif
+
+#if defined(CONFIG_DEV_NETBENCH)
+  INITCALL(devnetbench_register()); /* Non-standard /dev/netbench */
+#endif
+
+#if defined(CONFIG_DEV_FSBENCH)
+  INITCALL(devfsbench_register()); /* Non-standard /dev/fsbench */
+#endif
+
+#if defined(CONFIG_DEV_HEAPBENCH)
+  INITCALL(devheapbench_register()); /* Non-standard /dev/heapbench */
 #endif
 
 #if defined(CONFIG_DRIVERS_NOTE)
-  note_initialize();    /* Non-standard /dev/note */
+  INITCALL(note_initialize());    /* Non-standard /dev/note */
 #endif
 
 #if defined(CONFIG_CLK_RPMSG)
-  clk_rpmsg_server_initialize();
+  INITCALL(clk_rpmsg_server_initialize());
 #endif
 
 #if defined(CONFIG_REGULATOR_RPMSG)
-  regulator_rpmsg_server_init();
+  INITCALL(regulator_rpmsg_server_init());
 #endif
 
 #if defined(CONFIG_RESET_RPMSG)
-  reset_rpmsg_server_init();
+  INITCALL(reset_rpmsg_server_init());
 #endif
 
   /* Initialize the serial device driver */
 
 #ifdef CONFIG_RPMSG_UART
-  rpmsg_serialinit();
+  INITCALL(rpmsg_serialinit());
 #endif
 
 #ifdef CONFIG_RAM_UART
-  ram_serialinit();
+  INITCALL(ram_serialinit());
 #endif
 
   /* Initialize the console device driver (if it is other than the standard
@@ -189,121 +206,121 @@ void drivers_initialize(void)
    */
 
 #if defined(CONFIG_LWL_CONSOLE)
-  lwlconsole_init();
+  INITCALL(lwlconsole_init());
 #elif defined(CONFIG_CONSOLE_SYSLOG)
-  syslog_console_init();
+  INITCALL(syslog_console_init());
 #endif
 
 #ifdef CONFIG_UART_HOSTFS
-  uart_hostfs_init();
+  INITCALL(uart_hostfs_init());
 #endif
 
 #ifdef CONFIG_PSEUDOTERM_SUSV1
   /* Register the master pseudo-terminal multiplexor device */
 
-  ptmx_register();
+  INITCALL(ptmx_register());
 #endif
 
 #ifdef CONFIG_SCHED_PERF_EVENTS
-  pmu_initialize();
+  INITCALL(pmu_initialize());
 #endif
 
 #if defined(CONFIG_CRYPTO)
   /* Initialize the HW crypto and /dev/crypto */
 
-  up_cryptoinitialize();
+  INITCALL(up_cryptoinitialize());
 #endif
 
 #ifdef CONFIG_CRYPTO_CRYPTODEV
-  devcrypto_register();
+  INITCALL(devcrypto_register());
 #endif
 
 #ifdef CONFIG_UINPUT_TOUCH
-  uinput_touch_initialize();
+  INITCALL(uinput_touch_initialize());
 #endif
 
 #ifdef CONFIG_UINPUT_BUTTONS
-  uinput_button_initialize();
+  INITCALL(uinput_button_initialize());
 #endif
 
 #ifdef CONFIG_UINPUT_KEYBOARD
-  uinput_keyboard_initialize();
+  INITCALL(uinput_keyboard_initialize());
 #endif
 
 #ifdef CONFIG_NET_LOOPBACK
   /* Initialize the local loopback device */
 
-  localhost_initialize();
+  INITCALL(localhost_initialize());
 #endif
 
 #ifdef CONFIG_NET_TUN
   /* Initialize the TUN device */
 
-  tun_initialize();
+  INITCALL(tun_initialize());
 #endif
 
 #ifdef CONFIG_NETDEV_TELNET
   /* Initialize the Telnet session factory */
 
-  telnet_initialize();
+  INITCALL(telnet_initialize());
 #endif
 
 #ifdef CONFIG_USENSOR
-  usensor_initialize();
+  INITCALL(usensor_initialize());
 #endif
 
 #ifdef CONFIG_SENSORS_RPMSG
-  sensor_rpmsg_initialize();
+  INITCALL(sensor_rpmsg_initialize());
 #endif
 
 #ifdef CONFIG_DEV_RPMSG_SERVER
-  rpmsgdev_server_init();
+  INITCALL(rpmsgdev_server_init());
 #endif
 
 #ifdef CONFIG_BLK_RPMSG_SERVER
-  rpmsgblk_server_init();
+  INITCALL(rpmsgblk_server_init());
 #endif
 
 #ifdef CONFIG_RPMSGMTD_SERVER
-  rpmsgmtd_server_init();
+  INITCALL(rpmsgmtd_server_init());
 #endif
 
 #ifdef CONFIG_NET_USRSOCK_RPMSG_SERVER
   /* Initialize the user socket rpmsg server */
 
-  usrsock_rpmsg_server_initialize();
+  INITCALL(usrsock_rpmsg_server_initialize());
 #endif
 
 #ifdef CONFIG_SMART_DEV_LOOP
-  smart_loop_register_driver();
+  INITCALL(smart_loop_register_driver());
 #endif
 
 #ifdef CONFIG_MTD_LOOP
-  mtd_loop_register();
+  INITCALL(mtd_loop_register());
 #endif
 
 #ifdef CONFIG_DRIVERS_BINDER
-  binder_initialize();
+  INITCALL(binder_initialize());
 #endif
 
 #if defined(CONFIG_PCI) && !defined(CONFIG_PCI_LATE_DRIVERS_REGISTER)
-  pci_register_drivers();
+  INITCALL(pci_register_drivers());
 #endif
 
 #ifdef CONFIG_DRIVERS_VIRTIO
-  virtio_register_drivers();
+  INITCALL(virtio_register_drivers());
 #endif
 
 #ifdef CONFIG_DRIVERS_VHOST
-  vhost_register_drivers();
+  INITCALL(vhost_register_drivers());
 #endif
 
 #ifndef CONFIG_DEV_OPTEE_NONE
-  optee_register();
+  INITCALL(optee_register());
 #endif
 
 #ifdef CONFIG_THERMAL
-  thermal_init();
+  INITCALL(thermal_init());
 #endif
 
   drivers_trace_end();
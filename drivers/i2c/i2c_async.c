@@ -0,0 +1,151 @@
+/****************************************************************************
+ * drivers/i2c/i2c_async.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/i2c/i2c_master.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK
+#  define I2C_ASYNC_WORK HPWORK
+#else
+#  define I2C_ASYNC_WORK LPWORK
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_queue_worker
+ *
+ * Description:
+ *   Perform the queued transfers in order, until the queue is empty.
+ *   Transfers queued meanwhile are performed in the same run.
+ *
+ ****************************************************************************/
+
+static void i2c_queue_worker(FAR void *arg)
+{
+  FAR struct i2c_queue_s *queue = arg;
+  FAR struct i2c_async_s *req;
+  irqstate_t flags;
+  int ret;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&queue->lock);
+      req = (FAR struct i2c_async_s *)sq_remfirst(&queue->pending);
+      spin_unlock_irqrestore(&queue->lock, flags);
+
+      if (req == NULL)
+        {
+          break;
+        }
+
+      ret = I2C_TRANSFER(queue->i2c, req->msgs, req->count);
+      req->callback(req, ret);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_queue_initialize
+ *
+ * Description:
+ *   Initialize the queue of asynchronous transfers of an I2C bus.  All
+ *   users of i2c_transfer_async() on the bus should share one queue.
+ *
+ * Input Parameters:
+ *   queue - The queue to initialize
+ *   i2c   - An instance of the I2C interface to use for the transfers
+ *
+ ****************************************************************************/
+
+void i2c_queue_initialize(FAR struct i2c_queue_s *queue,
+                          FAR struct i2c_master_s *i2c)
+{
+  DEBUGASSERT(queue != NULL && i2c != NULL);
+
+  memset(queue, 0, sizeof(*queue));
+  queue->i2c = i2c;
+  sq_init(&queue->pending);
+  spin_lock_init(&queue->lock);
+}
+
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue an I2C transfer.  The queued transfers are performed back to back
+ *   by I2C_TRANSFER() on a work queue and req->callback is called with the
+ *   result of each.  This function does not block and may be called from an
+ *   interrupt handler.
+ *
+ * Input Parameters:
+ *   queue - The queue of the I2C bus
+ *   req   - The request, with msgs, count and callback set
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int i2c_transfer_async(FAR struct i2c_queue_s *queue,
+                       FAR struct i2c_async_s *req)
+{
+  irqstate_t flags;
+  bool idle;
+
+  if (queue == NULL || req == NULL || req->msgs == NULL ||
+      req->count <= 0 || req->callback == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = spin_lock_irqsave(&queue->lock);
+  idle  = sq_empty(&queue->pending);
+  sq_addlast(&req->node, &queue->pending);
+  spin_unlock_irqrestore(&queue->lock, flags);
+
+  /* A running worker picks up the request itself, only kick an idle one */
+
+  if (idle && work_available(&queue->work))
+    {
+      return work_queue(I2C_ASYNC_WORK, &queue->work, i2c_queue_worker,
+                        queue, 0);
+    }
+
+  return OK;
+}
@@ -0,0 +1,889 @@
+/****************************************************************************
+ * drivers/misc/dev_fsbench.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* /dev/fsbench measures a file system through the VFS.  Reading the
+ * device at position zero runs sequential and random reads and writes,
+ * a metadata workload and, if a source device is given, the mount time
+ * in the configured directory, and returns one line of comma separated
+ * values per benchmark.  Parameters are written as "key=value" pairs:
+ *
+ *   path=<dir>       The directory to work in
+ *   bs=<bytes>       The block size of the reads and writes
+ *   qd=<n>           The number of threads issuing I/O at the same time
+ *   fsize=<bytes>    The size of the test file
+ *   mtd=<dev>        An MTD or FTL device to take the flash counts from
+ *   source=<dev>     The device mounted at path, enables the mount test
+ *   fstype=<type>    The file system type of source
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mtd/mtd.h>
+#include <nuttx/drivers/drivers.h>
+
+#ifdef CONFIG_DEV_FSBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FSBENCH_NOPS      CONFIG_DEV_FSBENCH_NOPS
+#define FSBENCH_NFILES    CONFIG_DEV_FSBENCH_NFILES
+#define FSBENCH_NMOUNTS   CONFIG_DEV_FSBENCH_NMOUNTS
+#define FSBENCH_MAXQD     CONFIG_DEV_FSBENCH_MAXQD
+#define FSBENCH_PRIORITY  CONFIG_DEV_FSBENCH_PRIORITY
+#define FSBENCH_NSAMPLES  MAX(FSBENCH_NOPS, FSBENCH_NFILES)
+#define FSBENCH_LINELEN   128
+#define FSBENCH_FILENAME  "fsbench"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum fsbench_e
+{
+  FSBENCH_SEQWRITE = 0,             /* Sequential writes, then fsync */
+  FSBENCH_SEQREAD,                  /* Sequential reads */
+  FSBENCH_RANDWRITE,                /* Random writes, then fsync */
+  FSBENCH_RANDREAD,                 /* Random reads */
+  FSBENCH_CREATE,                   /* open(O_CREAT) and close */
+  FSBENCH_STAT,                     /* stat() */
+  FSBENCH_UNLINK,                   /* unlink() */
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  FSBENCH_MOUNT,                    /* mount() of source at path */
+#endif
+  FSBENCH_NBENCH
+};
+
+struct fsbench_params_s
+{
+  char path[CONFIG_DEV_FSBENCH_PATHLEN];
+  char mtd[CONFIG_DEV_FSBENCH_PATHLEN];
+  char source[CONFIG_DEV_FSBENCH_PATHLEN];
+  char fstype[16];
+  size_t bs;                        /* Block size */
+  size_t fsize;                     /* Test file size */
+  int qd;                           /* Number of I/O threads */
+};
+
+struct fsbench_s;
+
+struct fsbench_worker_s
+{
+  FAR struct fsbench_s *fb;         /* The run */
+  int index;                        /* Index of the thread */
+};
+
+struct fsbench_s
+{
+  FAR struct fsbench_params_s *params;
+  char name[CONFIG_DEV_FSBENCH_PATHLEN + 16];
+  int bench;                        /* The running benchmark */
+  int nops;                         /* Number of operations taken */
+  int result;                       /* First error of the workers */
+  sem_t go;                         /* Starts the workers */
+  sem_t done;                       /* Posted by each worker on exit */
+  struct fsbench_worker_s workers[FSBENCH_MAXQD];
+  clock_t samples[FSBENCH_NSAMPLES];
+};
+
+struct fsbench_file_s
+{
+  struct fsbench_params_s params;   /* The parameters of the next runs */
+  FAR char *buffer;                 /* The report of the last run */
+  size_t length;                    /* The length of the report */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     fsbench_open(FAR struct file *filep);
+static int     fsbench_close(FAR struct file *filep);
+static ssize_t fsbench_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+static ssize_t fsbench_write(FAR struct file *filep,
+                             FAR const char *buffer, size_t buflen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_fsbench_fops =
+{
+  fsbench_open,   /* open */
+  fsbench_close,  /* close */
+  fsbench_read,   /* read */
+  fsbench_write,  /* write */
+};
+
+static FAR const char * const g_fsbench_names[FSBENCH_NBENCH] =
+{
+  "seqwrite",
+  "seqread",
+  "randwrite",
+  "randread",
+  "create",
+  "stat",
+  "unlink",
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  "mount",
+#endif
+};
+
+/* Only one run at a time, the runs would share the files */
+
+static mutex_t g_fsbench_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fsbench_getarg
+ ****************************************************************************/
+
+static FAR struct fsbench_worker_s *fsbench_getarg(FAR char *argv[])
+{
+  return (FAR struct fsbench_worker_s *)
+         ((uintptr_t)strtoul(argv[1], NULL, 16));
+}
+
+/****************************************************************************
+ * Name: fsbench_random
+ *
+ * Description:
+ *   A xorshift generator, so that the random offsets are the same in
+ *   every run.
+ *
+ ****************************************************************************/
+
+static uint32_t fsbench_random(FAR uint32_t *state)
+{
+  uint32_t x = *state;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+/****************************************************************************
+ * Name: fsbench_worker
+ *
+ * Description:
+ *   An I/O thread.  With a queue depth of n, thread i issues the
+ *   operations i, i + n, i + 2n, ... of the benchmark.
+ *
+ ****************************************************************************/
+
+static int fsbench_worker(int argc, FAR char *argv[])
+{
+  FAR struct fsbench_worker_s *worker = fsbench_getarg(argv);
+  FAR struct fsbench_s *fb = worker->fb;
+  FAR struct fsbench_params_s *params = fb->params;
+  uint32_t seed = 0x9e3779b9 + worker->index;
+  size_t nblocks = params->fsize / params->bs;
+  struct file file;
+  FAR char *buf;
+  clock_t start;
+  off_t offset;
+  ssize_t ret;
+  bool write;
+  bool seq;
+  int i;
+
+  write = fb->bench == FSBENCH_SEQWRITE || fb->bench == FSBENCH_RANDWRITE;
+  seq   = fb->bench == FSBENCH_SEQWRITE || fb->bench == FSBENCH_SEQREAD;
+
+  buf = kmm_malloc(params->bs);
+  ret = buf == NULL ? -ENOMEM :
+        file_open(&file, fb->name, write ? O_WRONLY : O_RDONLY);
+  nxsem_wait_uninterruptible(&fb->go);
+  if (ret < 0)
+    {
+      goto out;
+    }
+
+  memset(buf, worker->index, params->bs);
+  for (i = worker->index; i < fb->nops; i += params->qd)
+    {
+      if (seq)
+        {
+          offset = (off_t)(i % nblocks) * params->bs;
+        }
+      else
+        {
+          offset = (off_t)(fsbench_random(&seed) % nblocks) * params->bs;
+        }
+
+      start = perf_gettime();
+      if (write)
+        {
+          ret = file_pwrite(&file, buf, params->bs, offset);
+        }
+      else
+        {
+          ret = file_pread(&file, buf, params->bs, offset);
+        }
+
+      fb->samples[i] = perf_gettime() - start;
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  file_close(&file);
+
+out:
+  if (ret < 0)
+    {
+      fb->result = ret;
+    }
+
+  kmm_free(buf);
+  nxsem_post(&fb->done);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fsbench_io
+ *
+ * Description:
+ *   Run a read or write benchmark with the configured number of threads.
+ *   The fsync() of the write benchmarks is part of the total time, but not
+ *   of the latency of any single operation.
+ *
+ ****************************************************************************/
+
+static int fsbench_io(FAR struct fsbench_s *fb, FAR clock_t *elapsed)
+{
+  FAR struct fsbench_params_s *params = fb->params;
+  FAR char *argv[2];
+  struct file file;
+  char arg1[32];
+  clock_t start;
+  int nthreads = 0;
+  pid_t pid;
+  int ret = OK;
+  int i;
+
+  fb->nops   = FSBENCH_NOPS;
+  fb->result = OK;
+
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  for (i = 0; i < params->qd; i++)
+    {
+      fb->workers[i].fb    = fb;
+      fb->workers[i].index = i;
+      snprintf(arg1, sizeof(arg1), "%p", &fb->workers[i]);
+      pid = kthread_create("fsbench", FSBENCH_PRIORITY,
+                           CONFIG_DEV_FSBENCH_STACKSIZE, fsbench_worker,
+                           argv);
+      if (pid < 0)
+        {
+          ferr("ERROR: Failed to start the benchmark threads\n");
+          ret = pid;
+          fb->nops = 0;
+          break;
+        }
+
+      nthreads++;
+    }
+
+  start = perf_gettime();
+  for (i = 0; i < nthreads; i++)
+    {
+      nxsem_post(&fb->go);
+    }
+
+  for (i = 0; i < nthreads; i++)
+    {
+      nxsem_wait_uninterruptible(&fb->done);
+    }
+
+  if (ret >= 0 && fb->result >= 0 &&
+      (fb->bench == FSBENCH_SEQWRITE || fb->bench == FSBENCH_RANDWRITE))
+    {
+      ret = file_open(&file, fb->name, O_WRONLY);
+      if (ret >= 0)
+        {
+          ret = file_fsync(&file);
+          file_close(&file);
+        }
+    }
+
+  *elapsed = perf_gettime() - start;
+  return ret < 0 ? ret : fb->result;
+}
+
+/****************************************************************************
+ * Name: fsbench_meta
+ *
+ * Description:
+ *   Run one step of the metadata workload on FSBENCH_NFILES files.
+ *
+ ****************************************************************************/
+
+static int fsbench_meta(FAR struct fsbench_s *fb, FAR clock_t *elapsed)
+{
+  FAR struct fsbench_params_s *params = fb->params;
+  struct file file;
+  struct stat buf;
+  clock_t begin;
+  clock_t start;
+  int ret = OK;
+  int i;
+
+  begin = perf_gettime();
+  for (i = 0; i < FSBENCH_NFILES && ret >= 0; i++)
+    {
+      snprintf(fb->name, sizeof(fb->name), "%s/" FSBENCH_FILENAME ".%d",
+               params->path, i);
+
+      start = perf_gettime();
+      switch (fb->bench)
+        {
+          case FSBENCH_CREATE:
+            ret = file_open(&file, fb->name, O_WRONLY | O_CREAT | O_TRUNC,
+                            0644);
+            if (ret >= 0)
+              {
+                ret = file_close(&file);
+              }
+            break;
+
+          case FSBENCH_STAT:
+            ret = nx_stat(fb->name, &buf, 1);
+            break;
+
+          default:
+            ret = nx_unlink(fb->name);
+            break;
+        }
+
+      fb->samples[i] = perf_gettime() - start;
+    }
+
+  *elapsed = perf_gettime() - begin;
+  fb->nops = i;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fsbench_mount
+ *
+ * Description:
+ *   Unmount path, then mount and unmount source there FSBENCH_NMOUNTS
+ *   times.  The file system is mounted again at the end.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+static int fsbench_mount(FAR struct fsbench_s *fb, FAR clock_t *elapsed)
+{
+  FAR struct fsbench_params_s *params = fb->params;
+  clock_t begin;
+  clock_t start;
+  int ret;
+  int i;
+
+  ret = nx_umount2(params->path, 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  begin = perf_gettime();
+  for (i = 0; i < FSBENCH_NMOUNTS; i++)
+    {
+      start = perf_gettime();
+      ret = nx_mount(params->source, params->path, params->fstype, 0, NULL);
+      fb->samples[i] = perf_gettime() - start;
+      if (ret < 0 || i == FSBENCH_NMOUNTS - 1)
+        {
+          break;
+        }
+
+      ret = nx_umount2(params->path, 0);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  *elapsed = perf_gettime() - begin;
+  fb->nops = ret < 0 ? i : FSBENCH_NMOUNTS;
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: fsbench_mtdstats
+ *
+ * Description:
+ *   Reset (stats == NULL) or read the erase and program counts of the MTD
+ *   device, if one is configured.
+ *
+ ****************************************************************************/
+
+static int fsbench_mtdstats(FAR struct fsbench_params_s *params,
+                            FAR struct mtd_stats_s *stats)
+{
+#ifdef CONFIG_MTD_STATISTICS
+  struct file file;
+  int ret;
+
+  if (params->mtd[0] == '\0')
+    {
+      return -ENODEV;
+    }
+
+  ret = file_open(&file, params->mtd, O_RDONLY);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (stats == NULL)
+    {
+      ret = file_ioctl(&file, MTDIOC_RESETSTATS, 0);
+    }
+  else
+    {
+      ret = file_ioctl(&file, MTDIOC_GETSTATS, (unsigned long)stats);
+    }
+
+  file_close(&file);
+  return ret;
+#else
+  return -ENOSYS;
+#endif
+}
+
+/****************************************************************************
+ * Name: fsbench_compare
+ ****************************************************************************/
+
+static int fsbench_compare(FAR const void *a, FAR const void *b)
+{
+  clock_t x = *(FAR const clock_t *)a;
+  clock_t y = *(FAR const clock_t *)b;
+
+  return x < y ? -1 : x > y;
+}
+
+/****************************************************************************
+ * Name: fsbench_usec
+ ****************************************************************************/
+
+static uint64_t fsbench_usec(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: fsbench_run
+ *
+ * Description:
+ *   Run one benchmark and format its line.  Returns 0 without a line if
+ *   the benchmark does not apply to the parameters.
+ *
+ ****************************************************************************/
+
+static int fsbench_run(FAR struct fsbench_s *fb, int bench, FAR char *line)
+{
+  FAR struct fsbench_params_s *params = fb->params;
+  struct mtd_stats_s stats;
+  clock_t elapsed = 0;
+  uint64_t usec;
+  long nerase = -1;
+  long nprog = -1;
+  bool mtd;
+  int ret;
+  int n;
+
+  fb->bench = bench;
+  fb->nops  = 0;
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  if (bench == FSBENCH_MOUNT &&
+      (params->source[0] == '\0' || params->fstype[0] == '\0'))
+    {
+      return 0;
+    }
+#endif
+
+  mtd = fsbench_mtdstats(params, NULL) >= 0;
+
+  switch (bench)
+    {
+      case FSBENCH_SEQWRITE:
+      case FSBENCH_SEQREAD:
+      case FSBENCH_RANDWRITE:
+      case FSBENCH_RANDREAD:
+        snprintf(fb->name, sizeof(fb->name), "%s/" FSBENCH_FILENAME,
+                 params->path);
+        ret = fsbench_io(fb, &elapsed);
+        break;
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+      case FSBENCH_MOUNT:
+        ret = fsbench_mount(fb, &elapsed);
+        break;
+#endif
+
+      default:
+        ret = fsbench_meta(fb, &elapsed);
+        break;
+    }
+
+  if (ret < 0)
+    {
+      ferr("ERROR: %s failed: %d\n", g_fsbench_names[bench], ret);
+      return ret;
+    }
+
+  if (mtd && fsbench_mtdstats(params, &stats) >= 0)
+    {
+      nerase = stats.nerase;
+      nprog  = stats.nbwrite;
+    }
+
+  n    = fb->nops;
+  usec = MAX(fsbench_usec(elapsed), 1);
+  qsort(fb->samples, n, sizeof(clock_t), fsbench_compare);
+
+  ret = snprintf(line, FSBENCH_LINELEN,
+                 "%s,%zu,%d,%d,%" PRIu64 ",%" PRIu64 ",%" PRIu64
+                 ",%" PRIu64 ",%" PRIu64 ",%ld,%ld\n",
+                 g_fsbench_names[bench], bench <= FSBENCH_RANDREAD ?
+                 params->bs : 0, bench <= FSBENCH_RANDREAD ? params->qd : 1,
+                 n, (uint64_t)n * USEC_PER_SEC / usec,
+                 bench <= FSBENCH_RANDREAD ?
+                 (uint64_t)n * params->bs * USEC_PER_SEC / usec / 1024 : 0,
+                 n > 0 ? fsbench_usec(fb->samples[n / 2]) : 0,
+                 n > 0 ? fsbench_usec(fb->samples[n * 99 / 100]) : 0,
+                 n > 0 ? fsbench_usec(fb->samples[n - 1]) : 0,
+                 nerase, nprog);
+
+  return MIN(ret, FSBENCH_LINELEN - 1);
+}
+
+/****************************************************************************
+ * Name: fsbench_report
+ *
+ * Description:
+ *   Run all benchmarks into a new report.
+ *
+ ****************************************************************************/
+
+static int fsbench_report(FAR struct fsbench_file_s *priv)
+{
+  FAR struct fsbench_s *fb;
+  size_t size;
+  int bench;
+  int ret = OK;
+
+  size = (FSBENCH_NBENCH + 1) * FSBENCH_LINELEN;
+  kmm_free(priv->buffer);
+  priv->length = 0;
+  priv->buffer = kmm_malloc(size);
+  fb = kmm_zalloc(sizeof(struct fsbench_s));
+  if (priv->buffer == NULL || fb == NULL)
+    {
+      kmm_free(fb);
+      return -ENOMEM;
+    }
+
+  fb->params = &priv->params;
+  nxsem_init(&fb->go, 0, 0);
+  nxsem_init(&fb->done, 0, 0);
+
+  priv->length = snprintf(priv->buffer, size, "%s\n",
+                          "bench,bs,qd,ops,iops,kibps,p50_us,p99_us,"
+                          "max_us,erases,programs");
+
+  for (bench = 0; bench < FSBENCH_NBENCH; bench++)
+    {
+      ret = fsbench_run(fb, bench, priv->buffer + priv->length);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      priv->length += ret;
+    }
+
+  snprintf(fb->name, sizeof(fb->name), "%s/" FSBENCH_FILENAME,
+           priv->params.path);
+  nx_unlink(fb->name);
+
+  nxsem_destroy(&fb->done);
+  nxsem_destroy(&fb->go);
+  kmm_free(fb);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: fsbench_prepare
+ *
+ * Description:
+ *   Create the test file of the read benchmarks at its full size.
+ *
+ ****************************************************************************/
+
+static int fsbench_prepare(FAR struct fsbench_params_s *params)
+{
+  char name[CONFIG_DEV_FSBENCH_PATHLEN + 16];
+  struct file file;
+  int ret;
+
+  snprintf(name, sizeof(name), "%s/" FSBENCH_FILENAME, params->path);
+  ret = file_open(&file, name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (ret >= 0)
+    {
+      ret = file_truncate(&file, params->fsize);
+      file_close(&file);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fsbench_open
+ ****************************************************************************/
+
+static int fsbench_open(FAR struct file *filep)
+{
+  FAR struct fsbench_file_s *priv;
+
+  priv = kmm_zalloc(sizeof(struct fsbench_file_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  strlcpy(priv->params.path, CONFIG_DEV_FSBENCH_PATH,
+          sizeof(priv->params.path));
+  priv->params.bs    = CONFIG_DEV_FSBENCH_BLOCKSIZE;
+  priv->params.fsize = CONFIG_DEV_FSBENCH_FILESIZE;
+  priv->params.qd    = 1;
+  filep->f_priv      = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fsbench_close
+ ****************************************************************************/
+
+static int fsbench_close(FAR struct file *filep)
+{
+  FAR struct fsbench_file_s *priv = filep->f_priv;
+
+  kmm_free(priv->buffer);
+  kmm_free(priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fsbench_read
+ ****************************************************************************/
+
+static ssize_t fsbench_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct fsbench_file_s *priv = filep->f_priv;
+  int ret;
+
+  /* Run the benchmarks again for each read from the start */
+
+  if (filep->f_pos == 0 || priv->buffer == NULL)
+    {
+      ret = nxmutex_lock(&g_fsbench_lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = fsbench_prepare(&priv->params);
+      if (ret >= 0)
+        {
+          ret = fsbench_report(priv);
+        }
+
+      nxmutex_unlock(&g_fsbench_lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (filep->f_pos >= priv->length)
+    {
+      return 0;
+    }
+
+  buflen = MIN(buflen, priv->length - filep->f_pos);
+  memcpy(buffer, priv->buffer + filep->f_pos, buflen);
+  filep->f_pos += buflen;
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: fsbench_write
+ *
+ * Description:
+ *   Parse "key=value" pairs for the following runs of this opener.
+ *
+ ****************************************************************************/
+
+static ssize_t fsbench_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  FAR struct fsbench_params_s *params =
+    &((FAR struct fsbench_file_s *)filep->f_priv)->params;
+  FAR char *value;
+  FAR char *save;
+  FAR char *key;
+  FAR char *dst;
+  char line[128];
+  size_t dstlen;
+  long num;
+
+  if (buflen >= sizeof(line))
+    {
+      return -E2BIG;
+    }
+
+  memcpy(line, buffer, buflen);
+  line[buflen] = '\0';
+
+  for (key = strtok_r(line, " \t\n", &save); key != NULL;
+       key = strtok_r(NULL, " \t\n", &save))
+    {
+      value = strchr(key, '=');
+      if (value == NULL)
+        {
+          return -EINVAL;
+        }
+
+      *value++ = '\0';
+      num = strtol(value, NULL, 0);
+      dst = NULL;
+
+      if (strcmp(key, "path") == 0)
+        {
+          dst    = params->path;
+          dstlen = sizeof(params->path);
+        }
+      else if (strcmp(key, "mtd") == 0)
+        {
+          dst    = params->mtd;
+          dstlen = sizeof(params->mtd);
+        }
+      else if (strcmp(key, "source") == 0)
+        {
+          dst    = params->source;
+          dstlen = sizeof(params->source);
+        }
+      else if (strcmp(key, "fstype") == 0)
+        {
+          dst    = params->fstype;
+          dstlen = sizeof(params->fstype);
+        }
+      else if (strcmp(key, "bs") == 0 && num > 0 &&
+               num <= params->fsize)
+        {
+          params->bs = num;
+        }
+      else if (strcmp(key, "fsize") == 0 && num >= params->bs)
+        {
+          params->fsize = num;
+        }
+      else if (strcmp(key, "qd") == 0 && num > 0 && num <= FSBENCH_MAXQD)
+        {
+          params->qd = num;
+        }
+      else
+        {
+          return -EINVAL;
+        }
+
+      if (dst != NULL && strlcpy(dst, value, dstlen) >= dstlen)
+        {
+          dst[0] = '\0';
+          return -ENAMETOOLONG;
+        }
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devfsbench_register
+ *
+ * Description:
+ *   Register /dev/fsbench
+ *
+ ****************************************************************************/
+
+void devfsbench_register(void)
+{
+  register_driver("/dev/fsbench", &g_fsbench_fops, 0666, NULL);
+}
+
+#endif /* CONFIG_DEV_FSBENCH */
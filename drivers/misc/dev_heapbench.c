@@ -0,0 +1,720 @@
+/****************************************************************************
+ * drivers/misc/dev_heapbench.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* /dev/heapbench replays an allocation trace against private heaps of the
+ * configured heap manager, with and without the mempool_multiple front
+ * end.  The trace is written to the device as an array of 8 byte records
+ * in native byte order:
+ *
+ *   uint8_t  op      0 allocate, 1 free, 2 reallocate
+ *   uint8_t  align   log2 of the alignment of an allocation, 0 for none
+ *   uint16_t slot    the block, an index below DEV_HEAPBENCH_NSLOTS
+ *   uint32_t size    the size of an allocation or reallocation
+ *
+ * A write at position zero starts a new trace.  The heap notes carry the
+ * same information (size, alignment, caller and the order of the events)
+ * and can be turned into such records by mapping each address to a slot.
+ * Without a trace a synthetic one is generated.
+ *
+ * Reading the device at position zero replays the trace once on one
+ * thread and once on DEV_HEAPBENCH_NTHREADS threads sharing the heap, and
+ * returns a summary line per heap followed by the fragmentation sampled
+ * every DEV_HEAPBENCH_INTERVAL records of the single thread replay.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <inttypes.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/drivers/drivers.h>
+
+#ifdef CONFIG_DEV_HEAPBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HEAPBENCH_NSLOTS    CONFIG_DEV_HEAPBENCH_NSLOTS
+#define HEAPBENCH_MAXRECS   CONFIG_DEV_HEAPBENCH_MAXRECS
+#define HEAPBENCH_NTHREADS  CONFIG_DEV_HEAPBENCH_NTHREADS
+#define HEAPBENCH_INTERVAL  CONFIG_DEV_HEAPBENCH_INTERVAL
+#define HEAPBENCH_PRIORITY  CONFIG_DEV_HEAPBENCH_PRIORITY
+#define HEAPBENCH_LINELEN   96
+
+#define HEAPBENCH_ALLOC     0
+#define HEAPBENCH_FREE      1
+#define HEAPBENCH_REALLOC   2
+
+#ifdef CONFIG_MM_TLSF_MANAGER
+#  define HEAPBENCH_MANAGER "tlsf"
+#else
+#  define HEAPBENCH_MANAGER "mm_heap"
+#endif
+
+#if defined(CONFIG_MM_HEAP_MEMPOOL) && CONFIG_MM_HEAP_MEMPOOL_THRESHOLD > 0
+#  define HEAPBENCH_NHEAPS  2
+#else
+#  define HEAPBENCH_NHEAPS  1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+begin_packed_struct struct heapbench_rec_s
+{
+  uint8_t  op;                      /* HEAPBENCH_ALLOC, FREE or REALLOC */
+  uint8_t  align;                   /* log2 of the alignment or 0 */
+  uint16_t slot;                    /* The block */
+  uint32_t size;                    /* The size of the block */
+} end_packed_struct;
+
+struct heapbench_s;
+
+struct heapbench_thread_s
+{
+  FAR struct heapbench_s *hb;       /* The run */
+  FAR void *slots[HEAPBENCH_NSLOTS];
+  size_t nfailed;                   /* Allocations that failed */
+};
+
+struct heapbench_s
+{
+  FAR struct mm_heap_s *heap;       /* The heap being measured */
+  FAR const struct heapbench_rec_s *recs;
+  size_t nrecs;                     /* Number of records of the trace */
+  FAR char *series;                 /* Fragmentation lines */
+  size_t serieslen;                 /* Length of the fragmentation lines */
+  size_t seriessize;                /* Size of the series buffer */
+  FAR const char *name;             /* Name of the heap */
+  int peak;                         /* Most bytes in use */
+  sem_t go;                         /* Starts the threads */
+  sem_t done;                       /* Posted by each thread on exit */
+  struct heapbench_thread_s threads[HEAPBENCH_NTHREADS];
+};
+
+struct heapbench_file_s
+{
+  FAR struct heapbench_rec_s *recs; /* The trace written by the user */
+  size_t nrecs;                     /* Number of records of the trace */
+  FAR char *buffer;                 /* The report of the last run */
+  size_t length;                    /* The length of the report */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     heapbench_open(FAR struct file *filep);
+static int     heapbench_close(FAR struct file *filep);
+static ssize_t heapbench_read(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen);
+static ssize_t heapbench_write(FAR struct file *filep,
+                               FAR const char *buffer, size_t buflen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_heapbench_fops =
+{
+  heapbench_open,   /* open */
+  heapbench_close,  /* close */
+  heapbench_read,   /* read */
+  heapbench_write,  /* write */
+};
+
+/* Only one run at a time, the runs would compete for memory */
+
+static mutex_t g_heapbench_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heapbench_getarg
+ ****************************************************************************/
+
+static FAR struct heapbench_thread_s *heapbench_getarg(FAR char *argv[])
+{
+  return (FAR struct heapbench_thread_s *)
+         ((uintptr_t)strtoul(argv[1], NULL, 16));
+}
+
+/****************************************************************************
+ * Name: heapbench_random
+ ****************************************************************************/
+
+static uint32_t heapbench_random(FAR uint32_t *state)
+{
+  uint32_t x = *state;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+/****************************************************************************
+ * Name: heapbench_generate
+ *
+ * Description:
+ *   Generate the synthetic trace used when none was written: mostly small
+ *   blocks with a few large and aligned ones, freed in random order.
+ *
+ ****************************************************************************/
+
+static void heapbench_generate(FAR struct heapbench_rec_s *recs,
+                               size_t nrecs)
+{
+  bool used[HEAPBENCH_NSLOTS];
+  uint32_t seed = 0x2545f491;
+  uint32_t r;
+  size_t i;
+
+  memset(used, 0, sizeof(used));
+  for (i = 0; i < nrecs; i++)
+    {
+      r = heapbench_random(&seed);
+      recs[i].slot  = r % HEAPBENCH_NSLOTS;
+      recs[i].align = 0;
+      recs[i].size  = 0;
+
+      if (!used[recs[i].slot])
+        {
+          recs[i].op   = HEAPBENCH_ALLOC;
+          r            = heapbench_random(&seed);
+          recs[i].size = r % 16 == 0 ? 512 + r % 3584 : 8 + r % 248;
+          if (r % 32 == 1)
+            {
+              recs[i].align = 6;
+            }
+
+          used[recs[i].slot] = true;
+        }
+      else if (r % 8 == 0)
+        {
+          recs[i].op   = HEAPBENCH_REALLOC;
+          recs[i].size = 8 + heapbench_random(&seed) % 1016;
+        }
+      else
+        {
+          recs[i].op = HEAPBENCH_FREE;
+          used[recs[i].slot] = false;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: heapbench_sample
+ *
+ * Description:
+ *   Append the fragmentation of the heap after the given record.  The
+ *   fragmentation is the part of the free memory outside of the largest
+ *   free chunk.
+ *
+ ****************************************************************************/
+
+static void heapbench_sample(FAR struct heapbench_s *hb, size_t index)
+{
+  struct mallinfo info = mm_mallinfo(hb->heap);
+  int frag = info.fordblks > 0 ?
+             (int)(100 - (int64_t)info.mxordblk * 100 / info.fordblks) : 0;
+  int ret;
+
+  hb->peak = MAX(hb->peak, info.uordblks);
+  if (hb->serieslen + HEAPBENCH_LINELEN > hb->seriessize)
+    {
+      return;
+    }
+
+  ret = snprintf(hb->series + hb->serieslen, HEAPBENCH_LINELEN,
+                 "%s,%zu,%d,%d,%d,%d\n", hb->name, index, info.uordblks,
+                 info.fordblks, info.mxordblk, frag);
+  hb->serieslen += MIN(ret, HEAPBENCH_LINELEN - 1);
+}
+
+/****************************************************************************
+ * Name: heapbench_replay
+ *
+ * Description:
+ *   Replay the trace once with the slots of one thread.  Only the thread
+ *   of the single thread replay samples the fragmentation.
+ *
+ ****************************************************************************/
+
+static void heapbench_replay(FAR struct heapbench_thread_s *thread,
+                             bool sample)
+{
+  FAR struct heapbench_s *hb = thread->hb;
+  FAR const struct heapbench_rec_s *rec;
+  FAR void **slot;
+  FAR void *mem;
+  size_t i;
+
+  for (i = 0; i < hb->nrecs; i++)
+    {
+      rec  = &hb->recs[i];
+      slot = &thread->slots[rec->slot % HEAPBENCH_NSLOTS];
+
+      switch (rec->op)
+        {
+          case HEAPBENCH_ALLOC:
+            if (*slot != NULL)
+              {
+                mm_free(hb->heap, *slot);
+              }
+
+            if (rec->align > 0)
+              {
+                *slot = mm_memalign(hb->heap, (size_t)1 << rec->align,
+                                    rec->size);
+              }
+            else
+              {
+                *slot = mm_malloc(hb->heap, rec->size);
+              }
+
+            if (*slot == NULL)
+              {
+                thread->nfailed++;
+              }
+            break;
+
+          case HEAPBENCH_REALLOC:
+            mem = mm_realloc(hb->heap, *slot, rec->size);
+            if (mem == NULL)
+              {
+                thread->nfailed++;
+              }
+            else
+              {
+                *slot = mem;
+              }
+            break;
+
+          default:
+            mm_free(hb->heap, *slot);
+            *slot = NULL;
+            break;
+        }
+
+      if (sample && (i + 1) % HEAPBENCH_INTERVAL == 0)
+        {
+          heapbench_sample(hb, i + 1);
+        }
+    }
+
+  if (sample)
+    {
+      heapbench_sample(hb, hb->nrecs);
+    }
+
+  for (i = 0; i < HEAPBENCH_NSLOTS; i++)
+    {
+      mm_free(hb->heap, thread->slots[i]);
+      thread->slots[i] = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: heapbench_thread
+ ****************************************************************************/
+
+static int heapbench_thread(int argc, FAR char *argv[])
+{
+  FAR struct heapbench_thread_s *thread = heapbench_getarg(argv);
+
+  nxsem_wait_uninterruptible(&thread->hb->go);
+  heapbench_replay(thread, false);
+  nxsem_post(&thread->hb->done);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapbench_nsec
+ ****************************************************************************/
+
+static uint64_t heapbench_nsec(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return MAX((uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec, 1);
+}
+
+/****************************************************************************
+ * Name: heapbench_run
+ *
+ * Description:
+ *   Replay the trace on a new heap and format its summary line.  The
+ *   threaded replay shows the cost of the heap lock: an allocator that
+ *   didn't serialize would reach up to the number of CPUs times 100 in
+ *   the scaling column.
+ *
+ ****************************************************************************/
+
+static int heapbench_run(FAR struct heapbench_s *hb, bool pool,
+                         FAR char *line)
+{
+  FAR char *argv[2];
+  FAR void *region;
+  char arg1[32];
+  uint64_t stops;
+  uint64_t mtops;
+  size_t nfailed = 0;
+  clock_t start;
+  clock_t elapsed;
+  int nthreads = 0;
+  pid_t pid;
+  int ret;
+  int i;
+
+  region = kmm_malloc(CONFIG_DEV_HEAPBENCH_HEAPSIZE);
+  if (region == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  hb->name = pool ? HEAPBENCH_MANAGER "+mempool" : HEAPBENCH_MANAGER;
+  hb->peak = 0;
+  if (pool)
+    {
+      hb->heap = mm_initialize_pool("heapbench", region,
+                                    CONFIG_DEV_HEAPBENCH_HEAPSIZE, NULL);
+    }
+  else
+    {
+      hb->heap = mm_initialize("heapbench", region,
+                               CONFIG_DEV_HEAPBENCH_HEAPSIZE);
+    }
+
+  if (hb->heap == NULL)
+    {
+      kmm_free(region);
+      return -ENOMEM;
+    }
+
+  /* One thread, with the fragmentation samples */
+
+  memset(hb->threads, 0, sizeof(hb->threads));
+  hb->threads[0].hb = hb;
+  start = perf_gettime();
+  heapbench_replay(&hb->threads[0], true);
+  elapsed = perf_gettime() - start;
+  stops = (uint64_t)hb->nrecs * NSEC_PER_SEC / heapbench_nsec(elapsed);
+  nfailed = hb->threads[0].nfailed;
+
+  /* All threads on the same heap */
+
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  for (i = 0; i < HEAPBENCH_NTHREADS; i++)
+    {
+      hb->threads[i].hb      = hb;
+      hb->threads[i].nfailed = 0;
+      snprintf(arg1, sizeof(arg1), "%p", &hb->threads[i]);
+      pid = kthread_create("heapbench", HEAPBENCH_PRIORITY,
+                           CONFIG_DEV_HEAPBENCH_STACKSIZE, heapbench_thread,
+                           argv);
+      if (pid < 0)
+        {
+          ferr("ERROR: Failed to start the benchmark threads\n");
+          break;
+        }
+
+      nthreads++;
+    }
+
+  start = perf_gettime();
+  for (i = 0; i < nthreads; i++)
+    {
+      nxsem_post(&hb->go);
+    }
+
+  for (i = 0; i < nthreads; i++)
+    {
+      nxsem_wait_uninterruptible(&hb->done);
+      nfailed += hb->threads[i].nfailed;
+    }
+
+  elapsed = perf_gettime() - start;
+  mtops   = (uint64_t)hb->nrecs * nthreads * NSEC_PER_SEC /
+            heapbench_nsec(elapsed);
+
+  ret = snprintf(line, HEAPBENCH_LINELEN,
+                 "%s,%zu,%" PRIu64 ",%d,%" PRIu64 ",%" PRIu64 ",%d,%d,%zu\n",
+                 hb->name, hb->nrecs, stops, nthreads, mtops,
+                 stops > 0 ? mtops * 100 / stops : 0, hb->peak,
+                 mm_mallinfo(hb->heap).arena, nfailed);
+
+  mm_uninitialize(hb->heap);
+  kmm_free(region);
+  return MIN(ret, HEAPBENCH_LINELEN - 1);
+}
+
+/****************************************************************************
+ * Name: heapbench_report
+ *
+ * Description:
+ *   Replay the trace on every heap into a new report.
+ *
+ ****************************************************************************/
+
+static int heapbench_report(FAR struct heapbench_file_s *priv)
+{
+  FAR struct heapbench_rec_s *synthetic = NULL;
+  FAR struct heapbench_s *hb;
+  size_t size;
+  int ret = OK;
+  int i;
+
+  hb = kmm_zalloc(sizeof(struct heapbench_s));
+  if (hb == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  hb->recs  = priv->recs;
+  hb->nrecs = priv->nrecs;
+  if (hb->nrecs == 0)
+    {
+      synthetic = kmm_malloc(HEAPBENCH_MAXRECS * sizeof(*synthetic));
+      if (synthetic == NULL)
+        {
+          kmm_free(hb);
+          return -ENOMEM;
+        }
+
+      heapbench_generate(synthetic, HEAPBENCH_MAXRECS);
+      hb->recs  = synthetic;
+      hb->nrecs = HEAPBENCH_MAXRECS;
+    }
+
+  hb->seriessize = HEAPBENCH_NHEAPS * HEAPBENCH_LINELEN *
+                   (hb->nrecs / HEAPBENCH_INTERVAL + 1);
+  size = (HEAPBENCH_NHEAPS + 3) * HEAPBENCH_LINELEN + hb->seriessize;
+
+  kmm_free(priv->buffer);
+  priv->length = 0;
+  priv->buffer = kmm_malloc(size);
+  hb->series   = kmm_malloc(hb->seriessize);
+  if (priv->buffer == NULL || hb->series == NULL)
+    {
+      ret = -ENOMEM;
+      goto out;
+    }
+
+  nxsem_init(&hb->go, 0, 0);
+  nxsem_init(&hb->done, 0, 0);
+
+  priv->length = snprintf(priv->buffer, size, "%s\n",
+                          "heap,ops,ops_per_s,threads,mt_ops_per_s,"
+                          "scaling_pct,peak_used,arena,failed");
+
+  for (i = 0; i < HEAPBENCH_NHEAPS; i++)
+    {
+      ret = heapbench_run(hb, i > 0, priv->buffer + priv->length);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      priv->length += ret;
+    }
+
+  if (ret >= 0)
+    {
+      priv->length += snprintf(priv->buffer + priv->length,
+                               size - priv->length, "\n%s\n",
+                               "heap,op,used,free,largest,frag_pct");
+      memcpy(priv->buffer + priv->length, hb->series, hb->serieslen);
+      priv->length += hb->serieslen;
+    }
+
+  nxsem_destroy(&hb->done);
+  nxsem_destroy(&hb->go);
+
+out:
+  kmm_free(hb->series);
+  kmm_free(synthetic);
+  kmm_free(hb);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: heapbench_open
+ ****************************************************************************/
+
+static int heapbench_open(FAR struct file *filep)
+{
+  FAR struct heapbench_file_s *priv;
+
+  priv = kmm_zalloc(sizeof(struct heapbench_file_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapbench_close
+ ****************************************************************************/
+
+static int heapbench_close(FAR struct file *filep)
+{
+  FAR struct heapbench_file_s *priv = filep->f_priv;
+
+  kmm_free(priv->recs);
+  kmm_free(priv->buffer);
+  kmm_free(priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapbench_read
+ ****************************************************************************/
+
+static ssize_t heapbench_read(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen)
+{
+  FAR struct heapbench_file_s *priv = filep->f_priv;
+  int ret;
+
+  /* Replay the trace again for each read from the start */
+
+  if (filep->f_pos == 0 || priv->buffer == NULL)
+    {
+      ret = nxmutex_lock(&g_heapbench_lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = heapbench_report(priv);
+      nxmutex_unlock(&g_heapbench_lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (filep->f_pos >= priv->length)
+    {
+      return 0;
+    }
+
+  buflen = MIN(buflen, priv->length - filep->f_pos);
+  memcpy(buffer, priv->buffer + filep->f_pos, buflen);
+  filep->f_pos += buflen;
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: heapbench_write
+ *
+ * Description:
+ *   Append trace records.  A write at position zero starts a new trace.
+ *
+ ****************************************************************************/
+
+static ssize_t heapbench_write(FAR struct file *filep,
+                               FAR const char *buffer, size_t buflen)
+{
+  FAR struct heapbench_file_s *priv = filep->f_priv;
+  size_t nrecs = buflen / sizeof(struct heapbench_rec_s);
+
+  if (buflen % sizeof(struct heapbench_rec_s) != 0)
+    {
+      return -EINVAL;
+    }
+
+  if (filep->f_pos == 0)
+    {
+      priv->nrecs = 0;
+    }
+
+  if (priv->nrecs + nrecs > HEAPBENCH_MAXRECS)
+    {
+      return -EFBIG;
+    }
+
+  if (priv->recs == NULL)
+    {
+      priv->recs = kmm_malloc(HEAPBENCH_MAXRECS *
+                              sizeof(struct heapbench_rec_s));
+      if (priv->recs == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  memcpy(&priv->recs[priv->nrecs], buffer, buflen);
+  priv->nrecs  += nrecs;
+  filep->f_pos += buflen;
+  return buflen;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devheapbench_register
+ *
+ * Description:
+ *   Register /dev/heapbench
+ *
+ ****************************************************************************/
+
+void devheapbench_register(void)
+{
+  register_driver("/dev/heapbench", &g_heapbench_fops, 0666, NULL);
+}
+
+#endif /* CONFIG_DEV_HEAPBENCH */
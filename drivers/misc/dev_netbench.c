@@ -0,0 +1,927 @@
+/****************************************************************************
+ * drivers/misc/dev_netbench.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* /dev/netbench measures the network stack over the loopback device.
+ * Reading the device at position zero runs TCP and UDP streams and
+ * request/response exchanges between pairs of kernel threads and returns
+ * one line of comma separated values per benchmark.  Writing
+ * "size=<bytes> conns=<n> cpu=<cpu> ms=<duration>" changes the parameters
+ * of the following runs, cpu=-1 lets the threads run on any CPU.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/signal.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/drivers/drivers.h>
+
+#ifdef CONFIG_DEV_NETBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NETBENCH_MAXCONNS  CONFIG_DEV_NETBENCH_MAXCONNS
+#define NETBENCH_PRIORITY  CONFIG_DEV_NETBENCH_PRIORITY
+#define NETBENCH_PORT      CONFIG_DEV_NETBENCH_PORT
+#define NETBENCH_LINELEN   112
+#define NETBENCH_TIMEOUT   100 /* Socket timeout in ms to check for stop */
+
+#if defined(CONFIG_MM_IOB) && !defined(CONFIG_DISABLE_MOUNTPOINT) && \
+    defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+#  define NETBENCH_IOBSTATS
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum netbench_e
+{
+#ifdef CONFIG_NET_TCP
+  NETBENCH_TCP_STREAM = 0,          /* Client sends, server counts */
+  NETBENCH_TCP_RR,                  /* Client sends, server echoes */
+#endif
+#ifdef CONFIG_NET_UDP
+  NETBENCH_UDP_STREAM,              /* Client sends, server counts */
+  NETBENCH_UDP_RR,                  /* Client sends, server echoes */
+#endif
+  NETBENCH_NBENCH
+};
+
+struct netbench_s;
+
+struct netbench_conn_s
+{
+  FAR struct netbench_s *nb;        /* The run */
+  struct socket client;             /* The sending end */
+  struct socket server;             /* The receiving end */
+  volatile uint64_t nbytes;         /* Payload bytes delivered */
+  volatile uint64_t npkts;          /* Messages or exchanges delivered */
+  volatile uint64_t rtt;            /* Sum of the exchange times */
+};
+
+struct netbench_s
+{
+  int bench;                        /* The running benchmark */
+  size_t size;                      /* Bytes per message */
+  int nconns;                       /* Number of connections */
+  volatile bool stop;               /* Tells the threads to exit */
+  sem_t go;                         /* Starts the threads */
+  sem_t done;                       /* Posted by each thread on exit */
+  struct netbench_conn_s conns[NETBENCH_MAXCONNS];
+};
+
+struct netbench_file_s
+{
+  size_t size;                      /* Bytes per message */
+  int nconns;                       /* Number of connections */
+  int cpu;                          /* The CPU of the threads or -1 */
+  unsigned int msec;                /* Duration of each benchmark */
+  FAR char *buffer;                 /* The report of the last run */
+  size_t length;                    /* The length of the report */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     netbench_open(FAR struct file *filep);
+static int     netbench_close(FAR struct file *filep);
+static ssize_t netbench_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen);
+static ssize_t netbench_write(FAR struct file *filep,
+                              FAR const char *buffer, size_t buflen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_netbench_fops =
+{
+  netbench_open,   /* open */
+  netbench_close,  /* close */
+  netbench_read,   /* read */
+  netbench_write,  /* write */
+};
+
+static FAR const char * const g_netbench_names[NETBENCH_NBENCH] =
+{
+#ifdef CONFIG_NET_TCP
+  "tcp_stream",
+  "tcp_rr",
+#endif
+#ifdef CONFIG_NET_UDP
+  "udp_stream",
+  "udp_rr",
+#endif
+};
+
+/* Only one run at a time, the runs would share the ports */
+
+static mutex_t g_netbench_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_getarg
+ ****************************************************************************/
+
+static FAR struct netbench_conn_s *netbench_getarg(FAR char *argv[])
+{
+  return (FAR struct netbench_conn_s *)
+         ((uintptr_t)strtoul(argv[1], NULL, 16));
+}
+
+/****************************************************************************
+ * Name: netbench_isstream
+ ****************************************************************************/
+
+static bool netbench_isstream(int bench)
+{
+#ifdef CONFIG_NET_TCP
+  if (bench == NETBENCH_TCP_STREAM)
+    {
+      return true;
+    }
+#endif
+
+#ifdef CONFIG_NET_UDP
+  if (bench == NETBENCH_UDP_STREAM)
+    {
+      return true;
+    }
+#endif
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: netbench_istcp
+ ****************************************************************************/
+
+static bool netbench_istcp(int bench)
+{
+#ifdef CONFIG_NET_TCP
+  return bench == NETBENCH_TCP_STREAM || bench == NETBENCH_TCP_RR;
+#else
+  return false;
+#endif
+}
+
+/****************************************************************************
+ * Name: netbench_xfer
+ *
+ * Description:
+ *   Send or receive a whole message.  A TCP message may take several
+ *   calls, a UDP message is always one datagram.  Timeouts are retried
+ *   until the run is stopped.
+ *
+ * Returned Value:
+ *   The size of the message, 0 if the peer closed the connection or a
+ *   negated errno value.
+ *
+ ****************************************************************************/
+
+static ssize_t netbench_xfer(FAR struct netbench_s *nb,
+                             FAR struct socket *psock, FAR char *buf,
+                             bool send)
+{
+  size_t done = 0;
+  ssize_t ret;
+
+  while (done < nb->size)
+    {
+      if (send)
+        {
+          ret = psock_send(psock, buf + done, nb->size - done, 0);
+        }
+      else
+        {
+          ret = psock_recv(psock, buf + done, nb->size - done, 0);
+        }
+
+      if (ret == -EAGAIN && !nb->stop)
+        {
+          continue;
+        }
+      else if (ret <= 0)
+        {
+          return ret;
+        }
+
+      done += ret;
+      if (!netbench_istcp(nb->bench))
+        {
+          break;
+        }
+    }
+
+  return done;
+}
+
+/****************************************************************************
+ * Name: netbench_client
+ *
+ * Description:
+ *   The sending end of a connection.  In the request/response benchmarks
+ *   it also takes the round trip times.
+ *
+ ****************************************************************************/
+
+static int netbench_client(int argc, FAR char *argv[])
+{
+  FAR struct netbench_conn_s *conn = netbench_getarg(argv);
+  FAR struct netbench_s *nb = conn->nb;
+  FAR char *buf;
+  clock_t start;
+  ssize_t ret;
+
+  buf = kmm_zalloc(nb->size);
+  nxsem_wait_uninterruptible(&nb->go);
+
+  while (buf != NULL && !nb->stop)
+    {
+      if (netbench_isstream(nb->bench))
+        {
+          ret = psock_send(&conn->client, buf, nb->size, 0);
+          if (ret < 0 && ret != -EAGAIN)
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      start = perf_gettime();
+      ret = netbench_xfer(nb, &conn->client, buf, true);
+      if (ret > 0)
+        {
+          ret = netbench_xfer(nb, &conn->client, buf, false);
+        }
+
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      conn->rtt    += perf_gettime() - start;
+      conn->nbytes += ret;
+      conn->npkts++;
+    }
+
+  kmm_free(buf);
+  nxsem_post(&nb->done);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_server
+ *
+ * Description:
+ *   The receiving end of a connection, which counts the stream or echoes
+ *   the requests.
+ *
+ ****************************************************************************/
+
+static int netbench_server(int argc, FAR char *argv[])
+{
+  FAR struct netbench_conn_s *conn = netbench_getarg(argv);
+  FAR struct netbench_s *nb = conn->nb;
+  FAR char *buf;
+  ssize_t ret;
+
+  buf = kmm_malloc(nb->size);
+  nxsem_wait_uninterruptible(&nb->go);
+
+  while (buf != NULL && !nb->stop)
+    {
+      if (netbench_isstream(nb->bench))
+        {
+          ret = psock_recv(&conn->server, buf, nb->size, 0);
+          if (ret == -EAGAIN)
+            {
+              continue;
+            }
+          else if (ret <= 0)
+            {
+              break;
+            }
+
+          conn->nbytes += ret;
+          conn->npkts++;
+          continue;
+        }
+
+      ret = netbench_xfer(nb, &conn->server, buf, false);
+      if (ret > 0)
+        {
+          ret = netbench_xfer(nb, &conn->server, buf, true);
+        }
+
+      if (ret <= 0)
+        {
+          break;
+        }
+    }
+
+  kmm_free(buf);
+  nxsem_post(&nb->done);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_settimeout
+ ****************************************************************************/
+
+static int netbench_settimeout(FAR struct socket *psock)
+{
+  struct timeval tv;
+  int ret;
+
+  tv.tv_sec  = 0;
+  tv.tv_usec = NETBENCH_TIMEOUT * USEC_PER_MSEC;
+
+  ret = psock_setsockopt(psock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  if (ret >= 0)
+    {
+      ret = psock_setsockopt(psock, SOL_SOCKET, SO_SNDTIMEO, &tv,
+                             sizeof(tv));
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_addr
+ ****************************************************************************/
+
+static void netbench_addr(FAR struct sockaddr_in *addr, int port)
+{
+  memset(addr, 0, sizeof(*addr));
+  addr->sin_family      = AF_INET;
+  addr->sin_port        = HTONS(port);
+  addr->sin_addr.s_addr = HTONL(INADDR_LOOPBACK);
+}
+
+/****************************************************************************
+ * Name: netbench_connect
+ *
+ * Description:
+ *   Set up the sockets of all connections of a run.  TCP connections are
+ *   accepted from the backlog of one listener, UDP sockets are bound to a
+ *   port per end and connected to each other.
+ *
+ ****************************************************************************/
+
+static int netbench_connect(FAR struct netbench_s *nb)
+{
+  FAR struct netbench_conn_s *conn;
+  struct sockaddr_in addr;
+  struct socket listener;
+  bool tcp = netbench_istcp(nb->bench);
+  int ret = OK;
+  int i;
+
+  memset(&listener, 0, sizeof(listener));
+  if (tcp)
+    {
+      ret = psock_socket(AF_INET, SOCK_STREAM, 0, &listener);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      netbench_addr(&addr, NETBENCH_PORT);
+      ret = psock_bind(&listener, (FAR struct sockaddr *)&addr,
+                       sizeof(addr));
+      if (ret >= 0)
+        {
+          ret = psock_listen(&listener, nb->nconns);
+        }
+    }
+
+  for (i = 0; i < nb->nconns && ret >= 0; i++)
+    {
+      conn = &nb->conns[i];
+      if (tcp)
+        {
+          ret = psock_socket(AF_INET, SOCK_STREAM, 0, &conn->client);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          ret = psock_connect(&conn->client, (FAR struct sockaddr *)&addr,
+                              sizeof(addr));
+          if (ret >= 0)
+            {
+              ret = psock_accept(&listener, NULL, NULL, &conn->server, 0);
+            }
+        }
+      else
+        {
+          struct sockaddr_in peer;
+
+          ret = psock_socket(AF_INET, SOCK_DGRAM, 0, &conn->client);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          ret = psock_socket(AF_INET, SOCK_DGRAM, 0, &conn->server);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          /* The server ends use the ports from NETBENCH_PORT on, the
+           * client ends the ports after them.
+           */
+
+          netbench_addr(&addr, NETBENCH_PORT + i);
+          netbench_addr(&peer, NETBENCH_PORT + NETBENCH_MAXCONNS + i);
+          ret = psock_bind(&conn->server, (FAR struct sockaddr *)&addr,
+                           sizeof(addr));
+          if (ret >= 0)
+            {
+              ret = psock_bind(&conn->client, (FAR struct sockaddr *)&peer,
+                               sizeof(peer));
+            }
+
+          if (ret >= 0)
+            {
+              ret = psock_connect(&conn->client,
+                                  (FAR struct sockaddr *)&addr,
+                                  sizeof(addr));
+            }
+
+          if (ret >= 0)
+            {
+              ret = psock_connect(&conn->server,
+                                  (FAR struct sockaddr *)&peer,
+                                  sizeof(peer));
+            }
+        }
+
+      if (ret >= 0)
+        {
+          ret = netbench_settimeout(&conn->client);
+        }
+
+      if (ret >= 0)
+        {
+          ret = netbench_settimeout(&conn->server);
+        }
+    }
+
+  if (tcp)
+    {
+      psock_close(&listener);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_disconnect
+ ****************************************************************************/
+
+static void netbench_disconnect(FAR struct netbench_s *nb)
+{
+  int i;
+
+  for (i = 0; i < nb->nconns; i++)
+    {
+      if (nb->conns[i].client.s_conn != NULL)
+        {
+          psock_close(&nb->conns[i].client);
+        }
+
+      if (nb->conns[i].server.s_conn != NULL)
+        {
+          psock_close(&nb->conns[i].server);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: netbench_nsec
+ ****************************************************************************/
+
+static uint64_t netbench_nsec(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: netbench_run
+ *
+ * Description:
+ *   Run one benchmark and format its line.
+ *
+ ****************************************************************************/
+
+static int netbench_run(FAR struct netbench_s *nb,
+                        FAR struct netbench_file_s *priv, int bench,
+                        FAR char *line)
+{
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+#endif
+#ifdef NETBENCH_IOBSTATS
+  struct iob_stats_s stats;
+#endif
+  FAR char *argv[2];
+  char arg1[32];
+  uint64_t nbytes = 0;
+  uint64_t npkts = 0;
+  uint64_t rtt = 0;
+  uint64_t nsec;
+  clock_t start;
+  clock_t elapsed;
+  int iobpeak = -1;
+  int nthreads = 0;
+  pid_t pid;
+  int ret;
+  int i;
+
+  memset(nb, 0, sizeof(*nb));
+  nb->bench  = bench;
+  nb->size   = priv->size;
+  nb->nconns = priv->nconns;
+  nxsem_init(&nb->go, 0, 0);
+  nxsem_init(&nb->done, 0, 0);
+
+  ret = netbench_connect(nb);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to connect %s: %d\n",
+           g_netbench_names[bench], ret);
+      goto out;
+    }
+
+#ifdef CONFIG_SMP
+  CPU_ZERO(&cpuset);
+  CPU_SET(priv->cpu, &cpuset);
+#endif
+
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  for (i = 0; i < 2 * nb->nconns; i++)
+    {
+      snprintf(arg1, sizeof(arg1), "%p", &nb->conns[i / 2]);
+      pid = kthread_create(i % 2 ? "netbench_srv" : "netbench_cli",
+                           NETBENCH_PRIORITY,
+                           CONFIG_DEV_NETBENCH_STACKSIZE,
+                           i % 2 ? netbench_server : netbench_client,
+                           argv);
+      if (pid < 0)
+        {
+          ferr("ERROR: Failed to start the benchmark threads\n");
+          ret = pid;
+          break;
+        }
+
+#ifdef CONFIG_SMP
+      if (priv->cpu >= 0)
+        {
+          nxsched_set_affinity(pid, sizeof(cpu_set_t), &cpuset);
+        }
+#endif
+
+      nthreads++;
+    }
+
+#ifdef NETBENCH_IOBSTATS
+  iob_resetstats();
+#endif
+
+  start = perf_gettime();
+  for (i = 0; i < nthreads; i++)
+    {
+      nxsem_post(&nb->go);
+    }
+
+  if (ret >= 0)
+    {
+      nxsig_usleep(priv->msec * USEC_PER_MSEC);
+    }
+
+  /* Take the counts at the end of the measured time, the threads may
+   * still deliver a message while they stop.
+   */
+
+  elapsed = perf_gettime() - start;
+  for (i = 0; i < nb->nconns; i++)
+    {
+      if (netbench_isstream(bench))
+        {
+          nbytes += nb->conns[i].nbytes;
+          npkts  += nb->conns[i].npkts;
+        }
+      else
+        {
+          nbytes += 2 * nb->conns[i].nbytes;
+          npkts  += nb->conns[i].npkts;
+          rtt    += nb->conns[i].rtt;
+        }
+    }
+
+#ifdef NETBENCH_IOBSTATS
+  iob_getstats(&stats);
+  iobpeak = stats.npeak;
+#endif
+
+  nb->stop = true;
+  for (i = 0; i < nthreads; i++)
+    {
+      nxsem_wait_uninterruptible(&nb->done);
+    }
+
+  if (ret >= 0)
+    {
+      /* A TCP stream has no message boundaries, count messages of the
+       * configured size.
+       */
+
+      if (netbench_istcp(bench) && netbench_isstream(bench))
+        {
+          npkts = nbytes / nb->size;
+        }
+
+      nsec = MAX(netbench_nsec(elapsed), 1);
+      ret  = snprintf(line, NETBENCH_LINELEN,
+                      "%s,%zu,%d,%d,%" PRIu64 ",%" PRIu64 ",%" PRIu64
+                      ",%" PRIu64 ",%d\n", g_netbench_names[bench],
+                      nb->size, nb->nconns, priv->cpu,
+                      nbytes * 8 * 1000 / nsec,
+                      npkts * NSEC_PER_SEC / nsec,
+                      npkts > 0 ? (uint64_t)elapsed / npkts : 0,
+                      npkts > 0 ? netbench_nsec(rtt / npkts) : 0,
+                      iobpeak);
+      ret  = MIN(ret, NETBENCH_LINELEN - 1);
+    }
+
+out:
+  netbench_disconnect(nb);
+  nxsem_destroy(&nb->done);
+  nxsem_destroy(&nb->go);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_report
+ *
+ * Description:
+ *   Run all benchmarks into a new report.
+ *
+ ****************************************************************************/
+
+static int netbench_report(FAR struct netbench_file_s *priv)
+{
+  FAR struct netbench_s *nb;
+  size_t size;
+  int bench;
+  int ret = OK;
+
+  size = (NETBENCH_NBENCH + 1) * NETBENCH_LINELEN;
+  kmm_free(priv->buffer);
+  priv->length = 0;
+  priv->buffer = kmm_malloc(size);
+  nb = kmm_zalloc(sizeof(struct netbench_s));
+  if (priv->buffer == NULL || nb == NULL)
+    {
+      kmm_free(nb);
+      return -ENOMEM;
+    }
+
+  priv->length = snprintf(priv->buffer, size, "%s\n",
+                          "bench,size,conns,cpu,mbps,pps,clk_per_pkt,"
+                          "rtt_ns,iob_peak");
+
+  for (bench = 0; bench < NETBENCH_NBENCH; bench++)
+    {
+      ret = netbench_run(nb, priv, bench, priv->buffer + priv->length);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      priv->length += ret;
+    }
+
+  kmm_free(nb);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: netbench_open
+ ****************************************************************************/
+
+static int netbench_open(FAR struct file *filep)
+{
+  FAR struct netbench_file_s *priv;
+
+  priv = kmm_zalloc(sizeof(struct netbench_file_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  priv->size    = CONFIG_DEV_NETBENCH_SIZE;
+  priv->nconns  = 1;
+  priv->cpu     = -1;
+  priv->msec    = CONFIG_DEV_NETBENCH_DURATION;
+  filep->f_priv = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_close
+ ****************************************************************************/
+
+static int netbench_close(FAR struct file *filep)
+{
+  FAR struct netbench_file_s *priv = filep->f_priv;
+
+  kmm_free(priv->buffer);
+  kmm_free(priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_read
+ ****************************************************************************/
+
+static ssize_t netbench_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct netbench_file_s *priv = filep->f_priv;
+  int ret;
+
+  /* Run the benchmarks again for each read from the start */
+
+  if (filep->f_pos == 0 || priv->buffer == NULL)
+    {
+      ret = nxmutex_lock(&g_netbench_lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = netbench_report(priv);
+      nxmutex_unlock(&g_netbench_lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (filep->f_pos >= priv->length)
+    {
+      return 0;
+    }
+
+  buflen = MIN(buflen, priv->length - filep->f_pos);
+  memcpy(buffer, priv->buffer + filep->f_pos, buflen);
+  filep->f_pos += buflen;
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: netbench_write
+ *
+ * Description:
+ *   Parse "key=value" pairs for the following runs of this opener.
+ *
+ ****************************************************************************/
+
+static ssize_t netbench_write(FAR struct file *filep,
+                              FAR const char *buffer, size_t buflen)
+{
+  FAR struct netbench_file_s *priv = filep->f_priv;
+  FAR char *value;
+  FAR char *save;
+  FAR char *key;
+  char line[64];
+  long num;
+
+  if (buflen >= sizeof(line))
+    {
+      return -E2BIG;
+    }
+
+  memcpy(line, buffer, buflen);
+  line[buflen] = '\0';
+
+  for (key = strtok_r(line, " \t\n", &save); key != NULL;
+       key = strtok_r(NULL, " \t\n", &save))
+    {
+      value = strchr(key, '=');
+      if (value == NULL)
+        {
+          return -EINVAL;
+        }
+
+      *value++ = '\0';
+      num = strtol(value, NULL, 0);
+
+      if (strcmp(key, "size") == 0 && num > 0 && num <= UINT16_MAX)
+        {
+          priv->size = num;
+        }
+      else if (strcmp(key, "conns") == 0 && num > 0 &&
+               num <= NETBENCH_MAXCONNS)
+        {
+          priv->nconns = num;
+        }
+      else if (strcmp(key, "cpu") == 0 && num >= -1 &&
+               num < CONFIG_SMP_NCPUS)
+        {
+          priv->cpu = num;
+        }
+      else if (strcmp(key, "ms") == 0 && num > 0)
+        {
+          priv->msec = num;
+        }
+      else
+        {
+          return -EINVAL;
+        }
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devnetbench_register
+ *
+ * Description:
+ *   Register /dev/netbench
+ *
+ ****************************************************************************/
+
+void devnetbench_register(void)
+{
+  register_driver("/dev/netbench", &g_netbench_fops, 0666, NULL);
+}
+
+#endif /* CONFIG_DEV_NETBENCH */
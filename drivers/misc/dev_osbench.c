@@ -0,0 +1,676 @@
+/****************************************************************************
+ * drivers/misc/dev_osbench.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* /dev/osbench measures the latency of the OS primitives.  Reading the
+ * device at position zero runs each benchmark on each CPU in turn and
+ * returns one line of comma separated values per benchmark and CPU, with
+ * the minimum, average, 99th percentile and maximum in nanoseconds, as
+ * measured with perf_gettime().
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mqueue.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/signal.h>
+#include <nuttx/wdog.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/drivers/drivers.h>
+
+#ifdef CONFIG_DEV_OSBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define OSBENCH_NSAMPLES  CONFIG_DEV_OSBENCH_NSAMPLES
+#define OSBENCH_PRIORITY  CONFIG_DEV_OSBENCH_PRIORITY
+#define OSBENCH_LINELEN   80
+#define OSBENCH_MQNAME    "osbench"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum osbench_e
+{
+  OSBENCH_CTXSW = 0,                /* Context switch, semaphore ping-pong */
+  OSBENCH_SEMWAKE,                  /* Semaphore post to waiter running */
+  OSBENCH_MUTEX,                    /* Mutex unlock to waiter owning it */
+#ifndef CONFIG_DISABLE_MQUEUE
+  OSBENCH_MQUEUE,                   /* Message queue round trip */
+#endif
+  OSBENCH_SIGNAL,                   /* Signal sent to sigwaitinfo() return */
+  OSBENCH_WDSTART,                  /* wd_start() of a new timer */
+  OSBENCH_IRQWAKE,                  /* Timer interrupt to thread running */
+  OSBENCH_NBENCH
+};
+
+struct osbench_s
+{
+  int bench;                        /* The running benchmark */
+  volatile bool stop;               /* Tells the peer to exit */
+  volatile clock_t start;           /* Start time of the sample */
+  pid_t peer;                       /* The peer thread */
+  sem_t ping;                       /* Runner to peer */
+  sem_t pong;                       /* Peer to runner */
+  sem_t done;                       /* Posted by each thread on exit */
+  mutex_t mutex;                    /* The mutex of OSBENCH_MUTEX */
+#ifndef CONFIG_DISABLE_MQUEUE
+  struct file mqping;               /* Runner to peer */
+  struct file mqpong;               /* Peer to runner */
+#endif
+  struct wdog_s wdog;               /* The timer of the timer benchmarks */
+  clock_t samples[OSBENCH_NSAMPLES];
+};
+
+struct osbench_file_s
+{
+  FAR char *buffer;                 /* The report of the last run */
+  size_t length;                    /* The length of the report */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     osbench_open(FAR struct file *filep);
+static int     osbench_close(FAR struct file *filep);
+static ssize_t osbench_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_osbench_fops =
+{
+  osbench_open,   /* open */
+  osbench_close,  /* close */
+  osbench_read,   /* read */
+};
+
+static FAR const char * const g_osbench_names[OSBENCH_NBENCH] =
+{
+  "ctxsw",
+  "semwake",
+  "mutex",
+#ifndef CONFIG_DISABLE_MQUEUE
+  "mqueue",
+#endif
+  "signal",
+  "wdstart",
+  "irqwake",
+};
+
+/* Only one run at a time, the benchmarks would disturb each other */
+
+static mutex_t g_osbench_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: osbench_getarg
+ ****************************************************************************/
+
+static FAR struct osbench_s *osbench_getarg(FAR char *argv[])
+{
+  return (FAR struct osbench_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+}
+
+/****************************************************************************
+ * Name: osbench_wdog
+ *
+ * Description:
+ *   The timer expiration of OSBENCH_IRQWAKE, wakes the peer from the
+ *   interrupt level.
+ *
+ ****************************************************************************/
+
+static void osbench_wdog(wdparm_t arg)
+{
+  FAR struct osbench_s *ob = (FAR struct osbench_s *)arg;
+
+  ob->start = perf_gettime();
+  nxsem_post(&ob->ping);
+}
+
+/****************************************************************************
+ * Name: osbench_nop
+ ****************************************************************************/
+
+static void osbench_nop(wdparm_t arg)
+{
+  UNUSED(arg);
+}
+
+/****************************************************************************
+ * Name: osbench_peer
+ *
+ * Description:
+ *   The peer thread, which waits for the runner and takes the samples of
+ *   the wake up latencies.
+ *
+ ****************************************************************************/
+
+static int osbench_peer(int argc, FAR char *argv[])
+{
+  FAR struct osbench_s *ob = osbench_getarg(argv);
+  struct siginfo info;
+  sigset_t set;
+  int i;
+
+  sigemptyset(&set);
+  sigaddset(&set, SIGUSR1);
+  nxsig_procmask(SIG_BLOCK, &set, NULL);
+
+  for (i = 0; ; i = (i + 1) % OSBENCH_NSAMPLES)
+    {
+      switch (ob->bench)
+        {
+          case OSBENCH_CTXSW:
+            nxsem_wait_uninterruptible(&ob->ping);
+            if (ob->stop)
+              {
+                goto out;
+              }
+
+            nxsem_post(&ob->pong);
+            break;
+
+          case OSBENCH_SEMWAKE:
+          case OSBENCH_IRQWAKE:
+            nxsem_wait_uninterruptible(&ob->ping);
+            if (ob->stop)
+              {
+                goto out;
+              }
+
+            ob->samples[i] = perf_gettime() - ob->start;
+            nxsem_post(&ob->pong);
+            break;
+
+          case OSBENCH_MUTEX:
+            nxsem_wait_uninterruptible(&ob->ping);
+            if (ob->stop)
+              {
+                goto out;
+              }
+
+            /* Block on the mutex held by the runner */
+
+            nxmutex_lock(&ob->mutex);
+            ob->samples[i] = perf_gettime() - ob->start;
+            nxmutex_unlock(&ob->mutex);
+            nxsem_post(&ob->pong);
+            break;
+
+#ifndef CONFIG_DISABLE_MQUEUE
+          case OSBENCH_MQUEUE:
+            {
+              char msg[4];
+
+              file_mq_receive(&ob->mqping, msg, sizeof(msg), NULL);
+              if (ob->stop)
+                {
+                  goto out;
+                }
+
+              file_mq_send(&ob->mqpong, msg, sizeof(msg), 0);
+            }
+            break;
+#endif
+
+          case OSBENCH_SIGNAL:
+            nxsig_timedwait(&set, &info, NULL);
+            if (ob->stop)
+              {
+                goto out;
+              }
+
+            ob->samples[i] = perf_gettime() - ob->start;
+            nxsem_post(&ob->pong);
+            break;
+
+          default:
+            goto out;
+        }
+    }
+
+out:
+  nxsem_post(&ob->done);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: osbench_runner
+ *
+ * Description:
+ *   The runner thread, which drives the samples of a benchmark and then
+ *   stops the peer.
+ *
+ ****************************************************************************/
+
+static int osbench_runner(int argc, FAR char *argv[])
+{
+  FAR struct osbench_s *ob = osbench_getarg(argv);
+  clock_t start;
+#ifndef CONFIG_DISABLE_MQUEUE
+  char msg[4] =
+    {
+      0
+    };
+#endif
+
+  int i;
+
+  for (i = 0; i < OSBENCH_NSAMPLES; i++)
+    {
+      switch (ob->bench)
+        {
+          case OSBENCH_CTXSW:
+
+            /* Two switches per round trip */
+
+            start = perf_gettime();
+            nxsem_post(&ob->ping);
+            nxsem_wait_uninterruptible(&ob->pong);
+            ob->samples[i] = (perf_gettime() - start) / 2;
+            break;
+
+          case OSBENCH_SEMWAKE:
+            ob->start = perf_gettime();
+            nxsem_post(&ob->ping);
+            nxsem_wait_uninterruptible(&ob->pong);
+            break;
+
+          case OSBENCH_MUTEX:
+
+            /* Let the peer block on the mutex, then hand it over */
+
+            nxmutex_lock(&ob->mutex);
+            nxsem_post(&ob->ping);
+            ob->start = perf_gettime();
+            nxmutex_unlock(&ob->mutex);
+            nxsem_wait_uninterruptible(&ob->pong);
+            break;
+
+#ifndef CONFIG_DISABLE_MQUEUE
+          case OSBENCH_MQUEUE:
+            start = perf_gettime();
+            file_mq_send(&ob->mqping, msg, sizeof(msg), 0);
+            file_mq_receive(&ob->mqpong, msg, sizeof(msg), NULL);
+            ob->samples[i] = perf_gettime() - start;
+            break;
+#endif
+
+          case OSBENCH_SIGNAL:
+            ob->start = perf_gettime();
+            nxsig_kill(ob->peer, SIGUSR1);
+            nxsem_wait_uninterruptible(&ob->pong);
+            break;
+
+          case OSBENCH_WDSTART:
+            start = perf_gettime();
+            wd_start(&ob->wdog, SEC2TICK(1), osbench_nop, 0);
+            ob->samples[i] = perf_gettime() - start;
+            wd_cancel(&ob->wdog);
+            break;
+
+          case OSBENCH_IRQWAKE:
+            wd_start(&ob->wdog, 1, osbench_wdog, (wdparm_t)ob);
+            nxsem_wait_uninterruptible(&ob->pong);
+            break;
+        }
+    }
+
+  /* Stop the peer */
+
+  ob->stop = true;
+  switch (ob->bench)
+    {
+#ifndef CONFIG_DISABLE_MQUEUE
+      case OSBENCH_MQUEUE:
+        file_mq_send(&ob->mqping, msg, sizeof(msg), 0);
+        break;
+#endif
+
+      case OSBENCH_SIGNAL:
+        nxsig_kill(ob->peer, SIGUSR1);
+        break;
+
+      default:
+        nxsem_post(&ob->ping);
+        break;
+    }
+
+  nxsem_post(&ob->done);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: osbench_compare
+ ****************************************************************************/
+
+static int osbench_compare(FAR const void *a, FAR const void *b)
+{
+  clock_t x = *(FAR const clock_t *)a;
+  clock_t y = *(FAR const clock_t *)b;
+
+  return x < y ? -1 : x > y;
+}
+
+/****************************************************************************
+ * Name: osbench_nsec
+ ****************************************************************************/
+
+static uint64_t osbench_nsec(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: osbench_run
+ *
+ * Description:
+ *   Run one benchmark with both threads on one CPU and format its line.
+ *
+ ****************************************************************************/
+
+static int osbench_run(FAR struct osbench_s *ob, int bench, int cpu,
+                       FAR char *line)
+{
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+#endif
+  FAR char *argv[2];
+  char arg1[32];
+  uint64_t total = 0;
+  int peerprio;
+  pid_t pids[2];
+  int ret;
+  int i;
+
+  ob->bench = bench;
+  ob->stop  = false;
+  nxsem_reset(&ob->ping, 0);
+  nxsem_reset(&ob->pong, 0);
+  memset(ob->samples, 0, sizeof(ob->samples));
+
+  /* The peer preempts the runner to measure the wake up latencies,
+   * both have the same priority for the switches of the ping-pongs.
+   */
+
+  peerprio = bench == OSBENCH_CTXSW ? OSBENCH_PRIORITY :
+             OSBENCH_PRIORITY + 1;
+
+  snprintf(arg1, sizeof(arg1), "%p", ob);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  /* Don't let the threads run before they are pinned */
+
+  sched_lock();
+
+  ob->peer = kthread_create("osbench_peer", peerprio,
+                            CONFIG_DEV_OSBENCH_STACKSIZE, osbench_peer,
+                            argv);
+  pids[0]  = ob->peer;
+  pids[1]  = kthread_create("osbench", OSBENCH_PRIORITY,
+                            CONFIG_DEV_OSBENCH_STACKSIZE, osbench_runner,
+                            argv);
+
+  if (pids[0] < 0 || pids[1] < 0)
+    {
+      sched_unlock();
+      ferr("ERROR: Failed to start the benchmark threads\n");
+      return pids[0] < 0 ? pids[0] : pids[1];
+    }
+
+#ifdef CONFIG_SMP
+  CPU_ZERO(&cpuset);
+  CPU_SET(cpu, &cpuset);
+  nxsched_set_affinity(pids[0], sizeof(cpu_set_t), &cpuset);
+  nxsched_set_affinity(pids[1], sizeof(cpu_set_t), &cpuset);
+#endif
+
+  sched_unlock();
+
+  /* Wait for both threads */
+
+  nxsem_wait_uninterruptible(&ob->done);
+  nxsem_wait_uninterruptible(&ob->done);
+
+  qsort(ob->samples, OSBENCH_NSAMPLES, sizeof(clock_t), osbench_compare);
+  for (i = 0; i < OSBENCH_NSAMPLES; i++)
+    {
+      total += ob->samples[i];
+    }
+
+  ret = snprintf(line, OSBENCH_LINELEN,
+                 "%s,%d,%d,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
+                 "\n", g_osbench_names[bench], cpu, OSBENCH_NSAMPLES,
+                 osbench_nsec(ob->samples[0]),
+                 osbench_nsec(total / OSBENCH_NSAMPLES),
+                 osbench_nsec(ob->samples[OSBENCH_NSAMPLES * 99 / 100]),
+                 osbench_nsec(ob->samples[OSBENCH_NSAMPLES - 1]));
+
+  return MIN(ret, OSBENCH_LINELEN - 1);
+}
+
+/****************************************************************************
+ * Name: osbench_report
+ *
+ * Description:
+ *   Run all benchmarks on all CPUs into a new report.
+ *
+ ****************************************************************************/
+
+static int osbench_report(FAR struct osbench_file_s *priv)
+{
+  FAR struct osbench_s *ob;
+  size_t size;
+  int bench;
+  int cpu;
+  int ret = OK;
+
+  size = (OSBENCH_NBENCH * CONFIG_SMP_NCPUS + 1) * OSBENCH_LINELEN;
+  kmm_free(priv->buffer);
+  priv->length = 0;
+  priv->buffer = kmm_malloc(size);
+  ob = kmm_zalloc(sizeof(struct osbench_s));
+  if (priv->buffer == NULL || ob == NULL)
+    {
+      kmm_free(ob);
+      return -ENOMEM;
+    }
+
+  nxsem_init(&ob->ping, 0, 0);
+  nxsem_init(&ob->pong, 0, 0);
+  nxsem_init(&ob->done, 0, 0);
+  nxmutex_init(&ob->mutex);
+
+#ifndef CONFIG_DISABLE_MQUEUE
+  ret = file_mq_open(&ob->mqping, OSBENCH_MQNAME "ping",
+                     O_RDWR | O_CREAT, 0666, NULL);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = file_mq_open(&ob->mqpong, OSBENCH_MQNAME "pong",
+                     O_RDWR | O_CREAT, 0666, NULL);
+  if (ret < 0)
+    {
+      file_mq_close(&ob->mqping);
+      goto errout;
+    }
+#endif
+
+  priv->length = snprintf(priv->buffer, size, "%s\n",
+                          "bench,cpu,samples,min_ns,avg_ns,p99_ns,max_ns");
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS && ret >= 0; cpu++)
+    {
+      for (bench = 0; bench < OSBENCH_NBENCH; bench++)
+        {
+          ret = osbench_run(ob, bench, cpu, priv->buffer + priv->length);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          priv->length += ret;
+        }
+    }
+
+#ifndef CONFIG_DISABLE_MQUEUE
+  file_mq_close(&ob->mqping);
+  file_mq_close(&ob->mqpong);
+  file_mq_unlink(OSBENCH_MQNAME "ping");
+  file_mq_unlink(OSBENCH_MQNAME "pong");
+
+errout:
+#endif
+  nxmutex_destroy(&ob->mutex);
+  nxsem_destroy(&ob->done);
+  nxsem_destroy(&ob->pong);
+  nxsem_destroy(&ob->ping);
+  kmm_free(ob);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: osbench_open
+ ****************************************************************************/
+
+static int osbench_open(FAR struct file *filep)
+{
+  FAR struct osbench_file_s *priv;
+
+  priv = kmm_zalloc(sizeof(struct osbench_file_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: osbench_close
+ ****************************************************************************/
+
+static int osbench_close(FAR struct file *filep)
+{
+  FAR struct osbench_file_s *priv = filep->f_priv;
+
+  kmm_free(priv->buffer);
+  kmm_free(priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: osbench_read
+ ****************************************************************************/
+
+static ssize_t osbench_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct osbench_file_s *priv = filep->f_priv;
+  int ret;
+
+  /* Run the benchmarks again for each read from the start */
+
+  if (filep->f_pos == 0 || priv->buffer == NULL)
+    {
+      ret = nxmutex_lock(&g_osbench_lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = osbench_report(priv);
+      nxmutex_unlock(&g_osbench_lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (filep->f_pos >= priv->length)
+    {
+      return 0;
+    }
+
+  buflen = MIN(buflen, priv->length - filep->f_pos);
+  memcpy(buffer, priv->buffer + filep->f_pos, buflen);
+  filep->f_pos += buflen;
+  return buflen;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devosbench_register
+ *
+ * Description:
+ *   Register /dev/osbench
+ *
+ ****************************************************************************/
+
+void devosbench_register(void)
+{
+  register_driver("/dev/osbench", &g_osbench_fops, 0444, NULL);
+}
+
+#endif /* CONFIG_DEV_OSBENCH */
@@ -32,6 +32,7 @@
 #include <limits.h>
 #include <debug.h>
 
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
@@ -102,6 +103,13 @@ static int     rpmsgblk_send_recv(FAR struct rpmsgblk_s *priv,
                                   int len, FAR void *data);
 static FAR void *rpmsgblk_get_tx_payload_buffer(FAR struct rpmsgblk_s *priv,
                                                 FAR uint32_t *len);
+#ifdef CONFIG_BLK_RPMSG_DIRECT
+static ssize_t rpmsgblk_direct(FAR struct rpmsgblk_s *priv,
+                               uint32_t command,
+                               FAR const unsigned char *buffer,
+                               blkcnt_t start_sector,
+                               unsigned int nsectors);
+#endif
 
 /* Functions handle the responses from the remote cpu */
 
@@ -143,6 +151,10 @@ static const rpmsg_ept_cb g_rpmsgblk_handler[] =
   [RPMSGBLK_WRITE]    = rpmsgblk_default_handler,
   [RPMSGBLK_GEOMETRY] = rpmsgblk_geometry_handler,
   [RPMSGBLK_IOCTL]    = rpmsgblk_ioctl_handler,
+#ifdef CONFIG_BLK_RPMSG_DIRECT
+  [RPMSGBLK_READ_DIRECT]  = rpmsgblk_default_handler,
+  [RPMSGBLK_WRITE_DIRECT] = rpmsgblk_default_handler,
+#endif
 };
 
 /****************************************************************************
@@ -286,6 +298,15 @@ static ssize_t rpmsgblk_read(FAR struct inode *inode,
       return ret;
     }
 
+#ifdef CONFIG_BLK_RPMSG_DIRECT
+  ret = rpmsgblk_direct(priv, RPMSGBLK_READ_DIRECT, buffer, start_sector,
+                        nsectors);
+  if (ret != -ENOTSUP)
+    {
+      return ret;
+    }
+#endif
+
   /* In block read, iov_len represent the received block number */
 
   iov.iov_base = buffer;
@@ -349,6 +370,15 @@ static ssize_t rpmsgblk_write(FAR struct inode *inode,
       return ret;
     }
 
+#ifdef CONFIG_BLK_RPMSG_DIRECT
+  ret = rpmsgblk_direct(priv, RPMSGBLK_WRITE_DIRECT, buffer, start_sector,
+                        nsectors);
+  if (ret != -ENOTSUP)
+    {
+      return ret;
+    }
+#endif
+
   /* Perform the rpmsg write */
 
   memset(&cookie, 0, sizeof(cookie));
@@ -879,6 +909,76 @@ fail:
   return ret;
 }
 
+/****************************************************************************
+ * Name: rpmsgblk_direct
+ *
+ * Description:
+ *   Perform a direct read or write, the server accesses the buffer in
+ *   place and only sends back the completion.
+ *
+ * Parameters:
+ *   priv         - rpmsg blk handle
+ *   command      - RPMSGBLK_READ_DIRECT or RPMSGBLK_WRITE_DIRECT
+ *   buffer       - the data buffer
+ *   start_sector - the first sector of the transfer
+ *   nsectors     - the number of sectors of the transfer
+ *
+ * Returned Values:
+ *   The number of sectors transferred on success; -ENOTSUP if the buffer
+ *   is not aligned to the data cache lines and has to be copied; another
+ *   negated errno value on any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BLK_RPMSG_DIRECT
+static ssize_t rpmsgblk_direct(FAR struct rpmsgblk_s *priv,
+                               uint32_t command,
+                               FAR const unsigned char *buffer,
+                               blkcnt_t start_sector,
+                               unsigned int nsectors)
+{
+  struct rpmsgblk_direct_s msg;
+  uintptr_t start = (uintptr_t)buffer;
+  uintptr_t end = start + nsectors * priv->geo.geo_sectorsize;
+  size_t linesize = up_get_dcache_linesize();
+  int ret;
+
+  /* A cache line shared with other data cannot be handed over */
+
+  if (linesize != 0 && ((start | end) & (linesize - 1)) != 0)
+    {
+      return -ENOTSUP;
+    }
+
+  /* Write back the data to be written.  Drop the lines of a buffer to be
+   * read, so that no dirty line overwrites the data of the server later.
+   */
+
+  if (command == RPMSGBLK_WRITE_DIRECT)
+    {
+      up_clean_dcache(start, end);
+    }
+  else
+    {
+      up_flush_dcache(start, end);
+    }
+
+  msg.buf         = start;
+  msg.startsector = start_sector;
+  msg.nsectors    = nsectors;
+  msg.sectorsize  = priv->geo.geo_sectorsize;
+
+  ret = rpmsgblk_send_recv(priv, command, true, &msg.header, sizeof(msg),
+                           NULL);
+  if (ret > 0 && command == RPMSGBLK_READ_DIRECT)
+    {
+      up_invalidate_dcache(start, end);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: rpmsgblk_default_handler
  *
@@ -43,6 +43,8 @@
 #define RPMSGBLK_WRITE           4
 #define RPMSGBLK_GEOMETRY        5
 #define RPMSGBLK_IOCTL           6
+#define RPMSGBLK_READ_DIRECT     7
+#define RPMSGBLK_WRITE_DIRECT    8
 
 /****************************************************************************
  * Public Types
@@ -85,6 +87,19 @@ begin_packed_struct struct rpmsgblk_geometry_s
   char                     model[RPMSGBLK_NAME_MAX + 1];
 } end_packed_struct;
 
+/* The data of a direct transfer stays in the buffer of the client, which
+ * the server accesses in place through the shared memory.
+ */
+
+begin_packed_struct struct rpmsgblk_direct_s
+{
+  struct rpmsgblk_header_s header;
+  uint64_t                 buf;
+  uint32_t                 startsector;
+  uint32_t                 nsectors;
+  int32_t                  sectorsize;
+} end_packed_struct;
+
 begin_packed_struct struct rpmsgblk_ioctl_s
 {
   struct rpmsgblk_header_s header;
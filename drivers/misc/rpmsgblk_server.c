@@ -26,6 +26,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mmcsd.h>
 #include <nuttx/fs/fs.h>
@@ -73,6 +74,11 @@ static int rpmsgblk_geometry_handler(FAR struct rpmsg_endpoint *ept,
 static int rpmsgblk_ioctl_handler(FAR struct rpmsg_endpoint *ept,
                                   FAR void *data, size_t len,
                                   uint32_t src, FAR void *priv);
+#ifdef CONFIG_BLK_RPMSG_DIRECT
+static int rpmsgblk_direct_handler(FAR struct rpmsg_endpoint *ept,
+                                   FAR void *data, size_t len,
+                                   uint32_t src, FAR void *priv);
+#endif
 
 /* Functions for creating communication with client cpu */
 
@@ -98,6 +104,10 @@ static const rpmsg_ept_cb g_rpmsgblk_handler[] =
   [RPMSGBLK_WRITE]    = rpmsgblk_write_handler,
   [RPMSGBLK_GEOMETRY] = rpmsgblk_geometry_handler,
   [RPMSGBLK_IOCTL]    = rpmsgblk_ioctl_handler,
+#ifdef CONFIG_BLK_RPMSG_DIRECT
+  [RPMSGBLK_READ_DIRECT]  = rpmsgblk_direct_handler,
+  [RPMSGBLK_WRITE_DIRECT] = rpmsgblk_direct_handler,
+#endif
 };
 
 /****************************************************************************
@@ -221,7 +231,7 @@ static int rpmsgblk_read_handler(FAR struct rpmsg_endpoint *ept,
 
       ret = server->bops->read(server->blknode,
                                (FAR unsigned char *)rsp->buf,
-                               msg->startsector, nsectors);
+                               msg->startsector + read, nsectors);
       rsp->header.result = ret;
       if (rpmsg_send_nocopy(ept, rsp, (ret < 0 ? 0 : ret * msg->sectorsize) +
                                       sizeof(*rsp) - 1) < 0)
@@ -281,6 +291,59 @@ static int rpmsgblk_write_handler(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
+/****************************************************************************
+ * Name: rpmsgblk_direct_handler
+ ****************************************************************************/
+
+#ifdef CONFIG_BLK_RPMSG_DIRECT
+static int rpmsgblk_direct_handler(FAR struct rpmsg_endpoint *ept,
+                                   FAR void *data, size_t len,
+                                   uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgblk_server_s *server = ept->priv;
+  FAR struct rpmsgblk_direct_s *msg = data;
+  FAR unsigned char *buf = (FAR unsigned char *)(uintptr_t)msg->buf;
+  uintptr_t start = (uintptr_t)buf;
+  int ret;
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  if (server->blknode->i_peer == NULL)
+    {
+      msg->header.result = -ENODEV;
+      return rpmsg_send(ept, msg, sizeof(*msg));
+    }
+#endif
+
+  /* The buffer belongs to the client, which took care of its cache lines.
+   * Only the lines of this side have to be kept coherent with the memory.
+   */
+
+  if (msg->header.command == RPMSGBLK_READ_DIRECT)
+    {
+      ret = server->bops->read(server->blknode, buf, msg->startsector,
+                               msg->nsectors);
+      if (ret > 0)
+        {
+          up_clean_dcache(start, start + ret * msg->sectorsize);
+        }
+    }
+  else
+    {
+      up_invalidate_dcache(start, start + msg->nsectors * msg->sectorsize);
+      ret = server->bops->write(server->blknode, buf, msg->startsector,
+                                msg->nsectors);
+    }
+
+  if (ret <= 0)
+    {
+      ferr("block direct transfer failed, ret=%d\n", ret);
+    }
+
+  msg->header.result = ret;
+  return rpmsg_send(ept, msg, sizeof(*msg));
+}
+#endif
+
 /****************************************************************************
  * Name: rpmsgblk_ioctl_handler
  ****************************************************************************/
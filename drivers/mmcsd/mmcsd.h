@@ -27,6 +27,7 @@
 
 #include <nuttx/config.h>
 #include <nuttx/sdio.h>
+#include <nuttx/fs/blkqueue.h>
 #include <stdint.h>
 #include <debug.h>
 
@@ -78,6 +79,9 @@ struct mmcsd_state_s
   int      minor;                              /* Device number */
   struct mmcsd_part_s part[MMCSD_PART_COUNT];  /* Partition data */
   uint32_t partnum;                            /* Partition number */
+#ifdef CONFIG_FS_BLKQUEUE
+  struct blk_queue_s queue;                    /* Asynchronous block requests */
+#endif
 
   /* Status flags */
 
@@ -30,6 +30,7 @@
 
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 
 #include <inttypes.h>
 #include <stdint.h>
@@ -45,6 +46,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/blkqueue.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/clock.h>
 #include <nuttx/arch.h>
@@ -102,6 +104,15 @@
 #  define MMCSD_MULTIBLOCK_LIMIT CONFIG_MMCSD_MULTIBLOCK_LIMIT
 #endif
 
+/* Merged block requests are passed to a scatter-gather DMA in one
+ * multiple block transfer.
+ */
+
+#if defined(CONFIG_FS_BLKQUEUE) && defined(CONFIG_SDIO_DMA_SG) && \
+    MMCSD_MULTIBLOCK_LIMIT != 1
+#  define MMCSD_HAVE_TRANSFERV 1
+#endif
+
 #define MMCSD_CAPACITY(b, s)    ((s) >= 10 ? (b) << ((s) - 10) : (b) >> (10 - (s)))
 
 #ifdef CONFIG_BOARD_COREDUMP_BLKDEV
@@ -178,6 +189,9 @@ static int     mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
 static ssize_t mmcsd_readsingle(FAR struct mmcsd_part_s *part,
                                 FAR uint8_t *buffer, off_t startblock);
 #if MMCSD_MULTIBLOCK_LIMIT != 1
+static ssize_t mmcsd_readmultiplev(FAR struct mmcsd_part_s *part,
+                                   FAR const struct iovec *iov, int iovcnt,
+                                   off_t startblock, size_t nblocks);
 static ssize_t mmcsd_readmultiple(FAR struct mmcsd_part_s *part,
                                   FAR uint8_t *buffer, off_t startblock,
                                   size_t nblocks);
@@ -186,6 +200,9 @@ static ssize_t mmcsd_writesingle(FAR struct mmcsd_part_s *part,
                                  FAR const uint8_t *buffer,
                                  off_t startblock);
 #if MMCSD_MULTIBLOCK_LIMIT != 1
+static ssize_t mmcsd_writemultiplev(FAR struct mmcsd_part_s *part,
+                                    FAR const struct iovec *iov, int iovcnt,
+                                    off_t startblock, size_t nblocks);
 static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
                                    FAR const uint8_t *buffer,
                                    off_t startblock,
@@ -206,6 +223,13 @@ static int     mmcsd_geometry(FAR struct inode *inode,
                               FAR struct geometry *geometry);
 static int     mmcsd_ioctl(FAR struct inode *inode, int cmd,
                            unsigned long arg);
+#ifdef CONFIG_FS_BLKQUEUE
+static int     mmcsd_submit(FAR struct inode *inode,
+                            FAR struct blk_req_s *req);
+#endif
+#ifdef MMCSD_HAVE_TRANSFERV
+static ssize_t mmcsd_transferv(FAR struct blk_req_s *req);
+#endif
 
 /* Initialization/uninitialization/reset ************************************/
 
@@ -242,6 +266,12 @@ static const struct block_operations g_bops =
   mmcsd_write,    /* write    */
   mmcsd_geometry, /* geometry */
   mmcsd_ioctl     /* ioctl    */
+#ifdef CONFIG_FS_BLKQUEUE
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL          /* unlink   */
+#endif
+  , mmcsd_submit  /* submit   */
+#endif
 };
 
 static FAR const char *g_partname[MMCSD_PART_COUNT] =
@@ -1620,17 +1650,18 @@ static ssize_t mmcsd_readsingle(FAR struct mmcsd_part_s *part,
 }
 
 /****************************************************************************
- * Name: mmcsd_readmultiple
+ * Name: mmcsd_readmultiplev
  *
  * Description:
- *   Read multiple, contiguous blocks of data from the physical device.
+ *   Read multiple, contiguous blocks of data from the physical device into
+ *   one buffer or, with a scatter-gather DMA, into several.
  *
  ****************************************************************************/
 
 #if MMCSD_MULTIBLOCK_LIMIT != 1
-static ssize_t mmcsd_readmultiple(FAR struct mmcsd_part_s *part,
-                                  FAR uint8_t *buffer, off_t startblock,
-                                  size_t nblocks)
+static ssize_t mmcsd_readmultiplev(FAR struct mmcsd_part_s *part,
+                                   FAR const struct iovec *iov, int iovcnt,
+                                   off_t startblock, size_t nblocks)
 {
   FAR struct mmcsd_state_s *priv = part->priv;
   size_t nbytes = nblocks << priv->blockshift;
@@ -1639,7 +1670,8 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_part_s *part,
   int ret;
 
   finfo("startblock=%jd nblocks=%zu\n", (intmax_t)startblock, nblocks);
-  DEBUGASSERT(priv != NULL && buffer != NULL);
+  DEBUGASSERT(priv != NULL && iov != NULL && iovcnt > 0);
+  DEBUGASSERT(iovcnt == 1 || (priv->caps & SDIO_CAPS_DMASG) != 0);
 
   /* Check if the card is locked */
 
@@ -1670,11 +1702,16 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_part_s *part,
 
   if ((priv->caps & SDIO_CAPS_DMASUPPORTED) != 0)
     {
-      ret = SDIO_DMAPREFLIGHT(priv->dev, buffer, nbytes);
+      int i;
 
-      if (ret != OK)
+      for (i = 0; i < iovcnt; i++)
         {
-          return ret;
+          ret = SDIO_DMAPREFLIGHT(priv->dev, iov[i].iov_base,
+                                  iov[i].iov_len);
+          if (ret != OK)
+            {
+              return ret;
+            }
         }
     }
 #endif
@@ -1728,7 +1765,15 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_part_s *part,
 #ifdef CONFIG_SDIO_DMA
   if ((priv->caps & SDIO_CAPS_DMASUPPORTED) != 0)
     {
-      ret = SDIO_DMARECVSETUP(priv->dev, buffer, nbytes);
+      if (iovcnt > 1)
+        {
+          ret = SDIO_DMARECVSETUPV(priv->dev, iov, iovcnt);
+        }
+      else
+        {
+          ret = SDIO_DMARECVSETUP(priv->dev, iov[0].iov_base, nbytes);
+        }
+
       if (ret != OK)
         {
           finfo("SDIO_DMARECVSETUP: error %d\n", ret);
@@ -1739,7 +1784,7 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_part_s *part,
   else
 #endif
     {
-      SDIO_RECVSETUP(priv->dev, buffer, nbytes);
+      SDIO_RECVSETUP(priv->dev, iov[0].iov_base, nbytes);
     }
 
 #ifdef CONFIG_MMCSD_MMCSUPPORT
@@ -1793,6 +1838,25 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_part_s *part,
 
   return nblocks;
 }
+
+/****************************************************************************
+ * Name: mmcsd_readmultiple
+ *
+ * Description:
+ *   Read multiple, contiguous blocks of data from the physical device.
+ *
+ ****************************************************************************/
+
+static ssize_t mmcsd_readmultiple(FAR struct mmcsd_part_s *part,
+                                  FAR uint8_t *buffer, off_t startblock,
+                                  size_t nblocks)
+{
+  struct iovec iov;
+
+  iov.iov_base = buffer;
+  iov.iov_len  = nblocks << part->priv->blockshift;
+  return mmcsd_readmultiplev(part, &iov, 1, startblock, nblocks);
+}
 #endif
 
 /****************************************************************************
@@ -1977,19 +2041,19 @@ static ssize_t mmcsd_writesingle(FAR struct mmcsd_part_s *part,
 }
 
 /****************************************************************************
- * Name: mmcsd_writemultiple
+ * Name: mmcsd_writemultiplev
  *
  * Description:
  *   Write multiple, contiguous blocks of data to the physical device.
- *   This function expects that the data to be written is contained in
- *   one large buffer that is pointed to by buffer.
+ *   The data is contained in one buffer or, with a scatter-gather DMA, in
+ *   several.
  *
  ****************************************************************************/
 
 #if MMCSD_MULTIBLOCK_LIMIT != 1
-static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
-                                   FAR const uint8_t *buffer,
-                                   off_t startblock, size_t nblocks)
+static ssize_t mmcsd_writemultiplev(FAR struct mmcsd_part_s *part,
+                                    FAR const struct iovec *iov, int iovcnt,
+                                    off_t startblock, size_t nblocks)
 {
   FAR struct mmcsd_state_s *priv = part->priv;
   size_t nbytes = nblocks << priv->blockshift;
@@ -1999,7 +2063,8 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
   int evret = OK;
 
   finfo("startblock=%jd nblocks=%zu\n", (intmax_t)startblock, nblocks);
-  DEBUGASSERT(priv != NULL && buffer != NULL);
+  DEBUGASSERT(priv != NULL && iov != NULL && iovcnt > 0);
+  DEBUGASSERT(iovcnt == 1 || (priv->caps & SDIO_CAPS_DMASG) != 0);
 
   /* Check if the card is locked or write protected (either via software or
    * via the mechanical write protect on the card)
@@ -2032,11 +2097,16 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
 
   if ((priv->caps & SDIO_CAPS_DMASUPPORTED) != 0)
     {
-      ret = SDIO_DMAPREFLIGHT(priv->dev, buffer, nbytes);
+      int i;
 
-      if (ret != OK)
+      for (i = 0; i < iovcnt; i++)
         {
-          return ret;
+          ret = SDIO_DMAPREFLIGHT(priv->dev, iov[i].iov_base,
+                                  iov[i].iov_len);
+          if (ret != OK)
+            {
+              return ret;
+            }
         }
     }
 #endif
@@ -2167,7 +2237,15 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
 #ifdef CONFIG_SDIO_DMA
   if ((priv->caps & SDIO_CAPS_DMASUPPORTED) != 0)
     {
-      ret = SDIO_DMASENDSETUP(priv->dev, buffer, nbytes);
+      if (iovcnt > 1)
+        {
+          ret = SDIO_DMASENDSETUPV(priv->dev, iov, iovcnt);
+        }
+      else
+        {
+          ret = SDIO_DMASENDSETUP(priv->dev, iov[0].iov_base, nbytes);
+        }
+
       if (ret != OK)
         {
           ferr("SDIO_DMASENDSETUP: error %d\n", ret);
@@ -2178,7 +2256,7 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
   else
 #endif
     {
-      SDIO_SENDSETUP(priv->dev, buffer, nbytes);
+      SDIO_SENDSETUP(priv->dev, iov[0].iov_base, nbytes);
     }
 
   /* If Controller needs DMA setup before write then only send CMD25 now. */
@@ -2254,6 +2332,27 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
 
   return nblocks;
 }
+
+/****************************************************************************
+ * Name: mmcsd_writemultiple
+ *
+ * Description:
+ *   Write multiple, contiguous blocks of data to the physical device.
+ *   This function expects that the data to be written is contained in
+ *   one large buffer that is pointed to by buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
+                                   FAR const uint8_t *buffer,
+                                   off_t startblock, size_t nblocks)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR void *)buffer;
+  iov.iov_len  = nblocks << part->priv->blockshift;
+  return mmcsd_writemultiplev(part, &iov, 1, startblock, nblocks);
+}
 #endif
 
 /****************************************************************************
@@ -2640,6 +2739,145 @@ static int mmcsd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   return ret;
 }
 
+/****************************************************************************
+ * Name: mmcsd_submit
+ *
+ * Description:
+ *   Queue an asynchronous block request.  All partitions of the slot share
+ *   the queue, as they share the bus.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLKQUEUE
+static int mmcsd_submit(FAR struct inode *inode, FAR struct blk_req_s *req)
+{
+  FAR struct mmcsd_state_s *priv;
+  FAR struct mmcsd_part_s *part;
+
+  DEBUGASSERT(inode->i_private);
+  part = inode->i_private;
+  priv = part->priv;
+
+  /* The block size is only known once a card was probed */
+
+  priv->queue.sectsize = priv->blocksize;
+#ifdef MMCSD_HAVE_TRANSFERV
+  priv->queue.maxsegs  = (priv->caps & SDIO_CAPS_DMASG) != 0 ?
+                         CONFIG_MMCSD_SDIO_DMA_SGSEGS : 1;
+#endif
+  return blk_queue_submit(&priv->queue, req);
+}
+#endif
+
+/****************************************************************************
+ * Name: mmcsd_transferv
+ *
+ * Description:
+ *   Transfer a block request and the requests merged into it, whose
+ *   buffers may be apart, with one multiple block transfer of the
+ *   scatter-gather DMA.
+ *
+ ****************************************************************************/
+
+#ifdef MMCSD_HAVE_TRANSFERV
+static ssize_t mmcsd_transferv(FAR struct blk_req_s *req)
+{
+  struct iovec iov[CONFIG_MMCSD_SDIO_DMA_SGSEGS];
+  FAR struct mmcsd_state_s *priv;
+  FAR struct mmcsd_part_s *part;
+  FAR struct blk_req_s *curr;
+  int iovcnt = 0;
+  ssize_t ret;
+
+  DEBUGASSERT(req->inode->i_private);
+  part = req->inode->i_private;
+  priv = part->priv;
+
+  for (curr = req; curr != NULL; curr = curr->next)
+    {
+      size_t len = (size_t)curr->nsectors << priv->blockshift;
+
+      if (iovcnt > 0 &&
+          (FAR uint8_t *)iov[iovcnt - 1].iov_base +
+          iov[iovcnt - 1].iov_len == curr->buffer)
+        {
+          iov[iovcnt - 1].iov_len += len;
+        }
+      else
+        {
+          DEBUGASSERT(iovcnt < CONFIG_MMCSD_SDIO_DMA_SGSEGS);
+          iov[iovcnt].iov_base = curr->buffer;
+          iov[iovcnt].iov_len  = len;
+          iovcnt++;
+        }
+    }
+
+  /* Contiguous memory needs no scatter-gather transfer */
+
+  if (iovcnt == 1)
+    {
+      if (req->write)
+        {
+          return mmcsd_write(req->inode, req->buffer, req->start,
+                             req->total);
+        }
+
+      return mmcsd_read(req->inode, req->buffer, req->start, req->total);
+    }
+
+  /* Without the scatter-gather DMA, which a new card in the slot may lack,
+   * or with too many blocks for one transfer, transfer each request alone.
+   */
+
+  if (req->total > MMCSD_MULTIBLOCK_LIMIT ||
+      (priv->caps & SDIO_CAPS_DMASG) == 0)
+    {
+      for (ret = 0, curr = req; curr != NULL; curr = curr->next)
+        {
+          ssize_t nsectors;
+
+          if (curr->write)
+            {
+              nsectors = mmcsd_write(curr->inode, curr->buffer,
+                                     curr->start, curr->nsectors);
+            }
+          else
+            {
+              nsectors = mmcsd_read(curr->inode, curr->buffer,
+                                    curr->start, curr->nsectors);
+            }
+
+          if (nsectors < 0)
+            {
+              return ret > 0 ? ret : nsectors;
+            }
+
+          ret += nsectors;
+        }
+
+      return ret;
+    }
+
+  ret = mmcsd_lock(priv);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (req->write)
+    {
+      ret = mmcsd_writemultiplev(part, iov, iovcnt, req->start, req->total);
+    }
+  else
+    {
+      ret = mmcsd_readmultiplev(part, iov, iovcnt, req->start, req->total);
+    }
+
+  mmcsd_unlock(priv);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Initialization/uninitialization/reset
  ****************************************************************************/
@@ -4586,6 +4824,12 @@ int mmcsd_slotinitialize(int minor, FAR struct sdio_dev_s *dev)
 
   memset(priv, 0, sizeof(struct mmcsd_state_s));
   nxmutex_init(&priv->lock);
+#ifdef CONFIG_FS_BLKQUEUE
+  blk_queue_init(&priv->queue, 0);
+#ifdef MMCSD_HAVE_TRANSFERV
+  priv->queue.transfer = mmcsd_transferv;
+#endif
+#endif
 
   /* Bind the MMCSD driver to the MMCSD state structure */
 
@@ -4641,6 +4885,9 @@ int mmcsd_slotinitialize(int minor, FAR struct sdio_dev_s *dev)
   return OK;
 
 errout_with_alloc:
+#ifdef CONFIG_FS_BLKQUEUE
+  blk_queue_uninit(&priv->queue);
+#endif
   nxmutex_destroy(&priv->lock);
   kmm_free(priv);
   return ret;
@@ -32,6 +32,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/lib/lib.h>
+#include <nuttx/wqueue.h>
 
 #include <dhara/map.h>
 #include <dhara/nand.h>
@@ -75,6 +76,12 @@ struct dhara_dev_s
 
   struct dq_queue_s readcache;
   dhara_pagecache_t readpage[CONFIG_DHARA_READ_NCACHES];
+
+#if CONFIG_DHARA_BGGC_DELAY > 0
+  /* Background garbage collection, while the device is idle */
+
+  struct work_s gcwork;
+#endif
 };
 
 typedef struct dhara_dev_s dhara_dev_t;
@@ -101,6 +108,9 @@ static int     dhara_ioctl(FAR struct inode *inode,
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
 static int     dhara_unlink(FAR struct inode *inode);
 #endif
+#if CONFIG_DHARA_BGGC_DELAY > 0
+static void    dhara_bggc_worker(FAR void *arg);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -286,6 +296,96 @@ static void dhara_update_readcache(FAR dhara_dev_t *dev,
     }
 }
 
+/****************************************************************************
+ * Name: dhara_bggc_needed
+ *
+ * Description:
+ *   Return true if less than the reserve of the journal is free, so that
+ *   the next writes would have to collect the garbage themselves.
+ *
+ ****************************************************************************/
+
+#if CONFIG_DHARA_BGGC_DELAY > 0
+static bool dhara_bggc_needed(FAR dhara_dev_t *dev)
+{
+  dhara_page_t used = dhara_journal_size(&dev->map.journal);
+
+  return used > dhara_map_size(&dev->map) &&
+         used + CONFIG_DHARA_BGGC_RESERVE * dev->blkper >=
+         dhara_map_capacity(&dev->map);
+}
+
+/****************************************************************************
+ * Name: dhara_bggc_worker
+ *
+ * Description:
+ *   Run some garbage collection steps on the low priority work queue.  Each
+ *   step either reclaims the page at the tail of the journal or moves its
+ *   live sector to the head, so the worker goes on only as long as the
+ *   steps free pages.
+ *
+ ****************************************************************************/
+
+static void dhara_bggc_worker(FAR void *arg)
+{
+  FAR dhara_dev_t *dev = arg;
+  dhara_page_t used;
+  dhara_error_t err;
+  int i;
+
+  /* Never delay a read or write, try again once the device is idle */
+
+  if (nxmutex_trylock(&dev->lock) < 0)
+    {
+      work_queue(LPWORK, &dev->gcwork, dhara_bggc_worker, dev,
+                 MSEC2TICK(CONFIG_DHARA_BGGC_DELAY));
+      return;
+    }
+
+  used = dhara_journal_size(&dev->map.journal);
+  for (i = 0; i < CONFIG_DHARA_BGGC_STEPS; i++)
+    {
+      if (!dhara_bggc_needed(dev))
+        {
+          break;
+        }
+
+      if (dhara_map_gc(&dev->map, &err) < 0)
+        {
+          ferr("Background GC failed err: %s\n", dhara_strerror(err));
+          nxmutex_unlock(&dev->lock);
+          return;
+        }
+    }
+
+  if (i == CONFIG_DHARA_BGGC_STEPS &&
+      dhara_journal_size(&dev->map.journal) < used)
+    {
+      work_queue(LPWORK, &dev->gcwork, dhara_bggc_worker, dev, 0);
+    }
+
+  nxmutex_unlock(&dev->lock);
+}
+#endif
+
+/****************************************************************************
+ * Name: dhara_release
+ *
+ * Description: Free the device after the last close of an unlinked device
+ *
+ ****************************************************************************/
+
+static void dhara_release(FAR dhara_dev_t *dev)
+{
+#if CONFIG_DHARA_BGGC_DELAY > 0
+  work_cancel_sync(LPWORK, &dev->gcwork);
+#endif
+  nxmutex_destroy(&dev->lock);
+  dhara_deinit_readcache(dev);
+  kmm_free(dev->pagebuf);
+  kmm_free(dev);
+}
+
 /****************************************************************************
  * Name: dhara_open
  *
@@ -325,10 +425,7 @@ static int dhara_close(FAR struct inode *inode)
 
   if (dev->refs == 0 && dev->unlinked)
     {
-      nxmutex_destroy(&dev->lock);
-      dhara_deinit_readcache(dev);
-      kmm_free(dev->pagebuf);
-      kmm_free(dev);
+      dhara_release(dev);
     }
 
   return 0;
@@ -418,6 +515,16 @@ static ssize_t dhara_write(FAR struct inode *inode,
       buffer += dev->geo.blocksize;
     }
 
+#if CONFIG_DHARA_BGGC_DELAY > 0
+  /* Each write postpones the background garbage collection */
+
+  if (nwrite > 0)
+    {
+      work_queue(LPWORK, &dev->gcwork, dhara_bggc_worker, dev,
+                 MSEC2TICK(CONFIG_DHARA_BGGC_DELAY));
+    }
+#endif
+
   nxmutex_unlock(&dev->lock);
   return nwrite ? nwrite : ret;
 }
@@ -470,6 +577,41 @@ static int dhara_ioctl(FAR struct inode *inode,
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
 
+  /* The sectors discarded by the file system are dropped from the map, so
+   * that the garbage collection does not move their stale data.
+   */
+
+  if (cmd == BIOC_DISCARD)
+    {
+      FAR const struct blk_range_s *range =
+        (FAR const struct blk_range_s *)((uintptr_t)arg);
+      dhara_sector_t sector;
+      dhara_error_t err;
+
+      if (range == NULL || range->start + range->nsectors >
+          (blkcnt_t)dev->geo.neraseblocks * dev->blkper)
+        {
+          return -EINVAL;
+        }
+
+      ret = OK;
+      nxmutex_lock(&dev->lock);
+      for (sector = range->start;
+           sector < range->start + range->nsectors; sector++)
+        {
+          if (dhara_map_trim(&dev->map, sector, &err) < 0)
+            {
+              ret = dhara_convert_result(err);
+              ferr("Trim sector %lu failed err: %s\n",
+                   (unsigned long)sector, dhara_strerror(err));
+              break;
+            }
+        }
+
+      nxmutex_unlock(&dev->lock);
+      return ret;
+    }
+
   /* No other block driver ioctl commands are not recognized by this
    * driver.  Other possible MTD driver ioctl commands are passed through
    * to the MTD driver (unchanged).
@@ -504,10 +646,7 @@ static int dhara_unlink(FAR struct inode *inode)
 
   if (dev->refs == 0)
     {
-      nxmutex_destroy(&dev->lock);
-      dhara_deinit_readcache(dev);
-      kmm_free(dev->pagebuf);
-      kmm_free(dev);
+      dhara_release(dev);
     }
 
   return 0;
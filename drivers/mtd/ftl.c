@@ -40,6 +40,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/blkqueue.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/drivers/rwbuffer.h>
@@ -70,6 +71,9 @@ struct ftl_struct_s
   struct mtd_geometry_s geo;      /* Device geometry */
 #ifdef FTL_HAVE_RWBUFFER
   struct rwbuffer_s     rwb;      /* Read-ahead/write buffer support */
+#endif
+#ifdef CONFIG_FS_BLKQUEUE
+  struct blk_queue_s    queue;    /* Asynchronous block requests */
 #endif
   uint16_t              blkper;   /* R/W blocks per erase block */
   uint16_t              refs;     /* Number of references */
@@ -104,6 +108,10 @@ static int     ftl_ioctl(FAR struct inode *inode, int cmd,
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
 static int     ftl_unlink(FAR struct inode *inode);
 #endif
+#ifdef CONFIG_FS_BLKQUEUE
+static int     ftl_submit(FAR struct inode *inode,
+                          FAR struct blk_req_s *req);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -120,6 +128,9 @@ static const struct block_operations g_bops =
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , ftl_unlink  /* unlink   */
 #endif
+#ifdef CONFIG_FS_BLKQUEUE
+  , ftl_submit  /* submit   */
+#endif
 };
 
 /****************************************************************************
@@ -258,6 +269,9 @@ static int ftl_close(FAR struct inode *inode)
 
       if (dev->unlinked)
         {
+#ifdef CONFIG_FS_BLKQUEUE
+          blk_queue_uninit(&dev->queue);
+#endif
 #ifdef FTL_HAVE_RWBUFFER
           rwb_uninitialize(&dev->rwb);
 #endif
@@ -753,6 +767,9 @@ static int ftl_unlink(FAR struct inode *inode)
   dev->unlinked = true;
   if (dev->refs == 0)
     {
+#ifdef CONFIG_FS_BLKQUEUE
+      blk_queue_uninit(&dev->queue);
+#endif
 #ifdef FTL_HAVE_RWBUFFER
       rwb_uninitialize(&dev->rwb);
 #endif
@@ -764,6 +781,25 @@ static int ftl_unlink(FAR struct inode *inode)
 }
 #endif
 
+/****************************************************************************
+ * Name: ftl_submit
+ *
+ * Description: Queue an asynchronous block request
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLKQUEUE
+static int ftl_submit(FAR struct inode *inode, FAR struct blk_req_s *req)
+{
+  FAR struct ftl_struct_s *dev;
+
+  DEBUGASSERT(inode->i_private);
+  dev = inode->i_private;
+
+  return blk_queue_submit(&dev->queue, req);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -858,12 +894,19 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
             }
         }
 
+#ifdef CONFIG_FS_BLKQUEUE
+      blk_queue_init(&dev->queue, dev->geo.blocksize);
+#endif
+
       /* Inode private data is a reference to the FTL device structure */
 
       ret = register_blockdriver(path, &g_bops, 0, dev);
       if (ret < 0)
         {
           ferr("ERROR: register_blockdriver failed: %d\n", -ret);
+#ifdef CONFIG_FS_BLKQUEUE
+          blk_queue_uninit(&dev->queue);
+#endif
           kmm_free(dev->lptable);
 out:
 #ifdef FTL_HAVE_RWBUFFER
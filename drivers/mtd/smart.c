@@ -125,6 +125,21 @@
 
 #define SMART_MAX_ALLOCS        10
 
+/* The paged sector cache divides the cache entries into map pages of
+ * consecutive logical sectors.
+ */
+
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+#  define SMART_MAP_PAGESECTORS CONFIG_MTD_SMART_MAP_PAGE_SECTORS
+#  define SMART_CACHE_NENTRIES \
+     (CONFIG_MTD_SMART_SECTOR_CACHE_SIZE / SMART_MAP_PAGESECTORS)
+#  if SMART_CACHE_NENTRIES < 2
+#    error CONFIG_MTD_SMART_SECTOR_CACHE_SIZE must hold two map pages
+#  endif
+#elif defined(CONFIG_MTD_SMART_MINIMIZE_RAM)
+#  define SMART_CACHE_NENTRIES  CONFIG_MTD_SMART_SECTOR_CACHE_SIZE
+#endif
+
 #ifndef CONFIG_MTD_SMART_ALLOC_DEBUG
 #define smart_malloc(d, b, n)   kmm_malloc(b)
 #define smart_zalloc(d, b, n)   kmm_zalloc(b)
@@ -213,7 +228,17 @@ static const uint8_t g_wearbit_to_levelmap4[] =
  * Private Types
  ****************************************************************************/
 
-#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+struct smart_cache_s
+{
+  uint16_t              page;             /* Logical sector / page sectors */
+  uint16_t              birth;            /* The time of the last use */
+
+  /* The physical sectors of the logical sectors of the page */
+
+  uint16_t              physical[SMART_MAP_PAGESECTORS];
+};
+#elif defined(CONFIG_MTD_SMART_MINIMIZE_RAM)
 struct smart_cache_s
 {
   uint16_t              logical;          /* Logical sector number */
@@ -1260,7 +1285,7 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
   if (dev->scache == NULL)
     {
       dev->scache = (FAR struct smart_cache_s *)smart_malloc(dev,
-        CONFIG_MTD_SMART_SECTOR_CACHE_SIZE * sizeof(struct smart_cache_s) +
+        SMART_CACHE_NENTRIES * sizeof(struct smart_cache_s) +
         allocsize, "Sector Cache");
     }
 
@@ -1271,7 +1296,7 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
     }
 
   dev->releasecount = (FAR uint8_t *)dev->scache +
-    (CONFIG_MTD_SMART_SECTOR_CACHE_SIZE * sizeof(struct smart_cache_s));
+    (SMART_CACHE_NENTRIES * sizeof(struct smart_cache_s));
 
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
   if (dev->sectorsperblk > 16)
@@ -1471,7 +1496,8 @@ errout:
  *
  ****************************************************************************/
 
-#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+#if defined(CONFIG_MTD_SMART_MINIMIZE_RAM) && \
+    !defined(CONFIG_MTD_SMART_PAGED_MAP)
 static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
                                      uint16_t logical, uint16_t physical,
                                      int line)
@@ -1556,7 +1582,8 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+#if defined(CONFIG_MTD_SMART_MINIMIZE_RAM) && \
+    !defined(CONFIG_MTD_SMART_PAGED_MAP)
 static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev,
                                    uint16_t logical)
 {
@@ -1695,7 +1722,8 @@ err_out:
  *
  ****************************************************************************/
 
-#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+#if defined(CONFIG_MTD_SMART_MINIMIZE_RAM) && \
+    !defined(CONFIG_MTD_SMART_PAGED_MAP)
 static void smart_update_cache(FAR struct smart_struct_s *dev,
                                uint16_t logical, uint16_t physical)
 {
@@ -1741,6 +1769,224 @@ static void smart_update_cache(FAR struct smart_struct_s *dev,
 }
 #endif
 
+/****************************************************************************
+ * Name: smart_load_mappage
+ *
+ * Description: Return the map page of the paged sector cache that holds
+ *              the logical sector.  A page that is not cached replaces the
+ *              least recently used one and is filled with a single scan of
+ *              the sector headers of the volume.  The page of the system
+ *              sectors is never replaced.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+static FAR struct smart_cache_s *
+smart_load_mappage(FAR struct smart_struct_s *dev, uint16_t logical)
+{
+  FAR struct smart_cache_s *mpage = NULL;
+  struct smart_sect_header_s header;
+  uint16_t logicalsector;
+  uint16_t physical;
+  uint16_t oldest;
+  uint16_t page;
+  uint16_t x;
+  size_t readaddress;
+  int ret;
+
+  page = logical / SMART_MAP_PAGESECTORS;
+
+  for (x = 0; x < dev->cache_entries; x++)
+    {
+      if (dev->scache[x].page == page)
+        {
+          mpage = &dev->scache[x];
+          goto out;
+        }
+    }
+
+  if (dev->cache_entries < SMART_CACHE_NENTRIES)
+    {
+      mpage = &dev->scache[dev->cache_entries];
+    }
+  else
+    {
+      oldest = 0xffff;
+      for (x = 0; x < SMART_CACHE_NENTRIES; x++)
+        {
+          if (dev->scache[x].page != 0 && dev->scache[x].birth <= oldest)
+            {
+              oldest = dev->scache[x].birth;
+              mpage  = &dev->scache[x];
+            }
+        }
+    }
+
+  /* Scan the headers of all physical sectors for the logical sectors of
+   * this page.
+   */
+
+  mpage->page = 0xffff;
+  memset(mpage->physical, 0xff, sizeof(mpage->physical));
+
+  for (physical = 0; physical < dev->totalsectors; physical++)
+    {
+      readaddress = physical * dev->mtdblkspersector * dev->geo.blocksize;
+      ret = MTD_READ(dev->mtd, readaddress,
+                     sizeof(struct smart_sect_header_s),
+                     (FAR uint8_t *)&header);
+      if (ret != sizeof(struct smart_sect_header_s))
+        {
+          return NULL;
+        }
+
+      logicalsector = *((FAR uint16_t *)header.logicalsector);
+      if (logicalsector / SMART_MAP_PAGESECTORS != page)
+        {
+          continue;
+        }
+
+#if CONFIG_SMARTFS_ERASEDSTATE == 0x00
+      if (logicalsector == 0)
+        {
+          continue;
+        }
+#endif
+
+      /* Skip the sectors that are not committed or released */
+
+      if ((header.status & SMART_STATUS_COMMITTED) ==
+              (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED) ||
+          (header.status & SMART_STATUS_RELEASED) !=
+              (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED) ||
+          (header.status & SMART_STATUS_VERBITS) != SMART_STATUS_VERSION)
+        {
+          continue;
+        }
+
+      mpage->physical[logicalsector % SMART_MAP_PAGESECTORS] = physical;
+    }
+
+  mpage->page = page;
+  if (mpage == &dev->scache[dev->cache_entries])
+    {
+      dev->cache_entries++;
+    }
+
+out:
+
+  /* Halve the times of the last use before they wrap around */
+
+  if (dev->cache_nextbirth == 0xffff)
+    {
+      for (x = 0; x < dev->cache_entries; x++)
+        {
+          dev->scache[x].birth >>= 1;
+        }
+
+      dev->cache_nextbirth >>= 1;
+    }
+
+  mpage->birth = dev->cache_nextbirth++;
+  return mpage;
+}
+
+/****************************************************************************
+ * Name: smart_add_sector_to_cache
+ *
+ * Description: Adds a logical to physical sector mapping to the paged
+ *              sector cache.
+ *
+ ****************************************************************************/
+
+static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
+                                     uint16_t logical, uint16_t physical,
+                                     int line)
+{
+  FAR struct smart_cache_s *mpage;
+
+  mpage = smart_load_mappage(dev, logical);
+  if (mpage == NULL)
+    {
+      return -EIO;
+    }
+
+  mpage->physical[logical % SMART_MAP_PAGESECTORS] = physical;
+  dev->cache_lastlog  = logical;
+  dev->cache_lastphys = physical;
+
+  if (dev->debuglevel > 1)
+    {
+      _err("Add Cache sector:  Log=%d, Phys=%d in page %d from line %d\n",
+           logical, physical, mpage->page, line);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: smart_cache_lookup
+ *
+ * Description: Look up the physical mapping of a logical sector in its map
+ *              page, which is loaded if it is not cached.
+ *
+ ****************************************************************************/
+
+static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev,
+                                   uint16_t logical)
+{
+  FAR struct smart_cache_s *mpage;
+  uint16_t physical;
+
+  if (logical == dev->cache_lastlog)
+    {
+      return dev->cache_lastphys;
+    }
+
+  mpage = smart_load_mappage(dev, logical);
+  if (mpage == NULL)
+    {
+      return 0xffff;
+    }
+
+  physical            = mpage->physical[logical % SMART_MAP_PAGESECTORS];
+  dev->cache_lastlog  = logical;
+  dev->cache_lastphys = physical;
+  return physical;
+}
+
+/****************************************************************************
+ * Name: smart_update_cache
+ *
+ * Description: Updates the mapping of a logical sector if its map page is
+ *              cached.  Otherwise the page is read from the volume with the
+ *              new mapping when it is needed.
+ *
+ ****************************************************************************/
+
+static void smart_update_cache(FAR struct smart_struct_s *dev,
+                               uint16_t logical, uint16_t physical)
+{
+  uint16_t page = logical / SMART_MAP_PAGESECTORS;
+  uint16_t x;
+
+  for (x = 0; x < dev->cache_entries; x++)
+    {
+      if (dev->scache[x].page == page)
+        {
+          dev->scache[x].physical[logical % SMART_MAP_PAGESECTORS] =
+            physical;
+          break;
+        }
+    }
+
+  if (dev->cache_lastlog == logical)
+    {
+      dev->cache_lastphys = physical;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: smart_get_wear_level
  *
@@ -2488,13 +2734,24 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 
       dev->sbitmap[logicalsector >> 3] |= 1 << (logicalsector & 0x07);
 
+#ifndef CONFIG_MTD_SMART_PAGED_MAP
       if (logicalsector < SMART_FIRST_ALLOC_SECTOR)
         {
           smart_add_sector_to_cache(dev, logicalsector, winner, __LINE__);
         }
+#endif
 #endif
     }
 
+#ifdef CONFIG_MTD_SMART_PAGED_MAP
+  /* The map pages loaded while duplicate sectors were resolved may point
+   * to the losers, that are released now.
+   */
+
+  dev->cache_entries = 0;
+  dev->cache_lastlog = 0xffff;
+#endif
+
 #if defined (CONFIG_MTD_SMART_WEAR_LEVEL) && (SMART_STATUS_VERSION == 1)
 #ifdef CONFIG_MTD_SMART_CONVERT_WEAR_FORMAT
 
@@ -29,6 +29,7 @@
 #include <errno.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/dmaalloc.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/addrenv.h>
@@ -1344,8 +1345,8 @@ static int e1000_probe(FAR struct pci_device_s *dev)
 
   /* Allocate TX descriptors */
 
-  priv->tx = kmm_memalign(type->desc_align,
-                          E1000_TX_DESC * sizeof(struct e1000_tx_leg_s));
+  priv->tx = mm_dmamemalign(type->desc_align,
+                             E1000_TX_DESC * sizeof(struct e1000_tx_leg_s));
   if (priv->tx == NULL)
     {
       nerr("alloc tx failed\n");
@@ -1354,8 +1355,8 @@ static int e1000_probe(FAR struct pci_device_s *dev)
 
   /* Allocate RX descriptors */
 
-  priv->rx = kmm_memalign(type->desc_align,
-                          E1000_RX_DESC * sizeof(struct e1000_rx_leg_s));
+  priv->rx = mm_dmamemalign(type->desc_align,
+                             E1000_RX_DESC * sizeof(struct e1000_rx_leg_s));
   if (priv->rx == NULL)
     {
       nerr("alloc rx failed\n");
@@ -1428,8 +1429,8 @@ static int e1000_probe(FAR struct pci_device_s *dev)
   return netdev_lower_register(netdev, NET_LL_ETHERNET);
 
 errout:
-  kmm_free(priv->tx);
-  kmm_free(priv->rx);
+  mm_dmafree(priv->tx);
+  mm_dmafree(priv->rx);
 #ifdef CONFIG_NET_MCASTGROUP
   kmm_free(priv->mta);
 #endif
@@ -39,6 +39,7 @@
 #include <nuttx/crc32.h>
 #include <nuttx/arch.h>
 #include <nuttx/irq.h>
+#include <nuttx/dmaalloc.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/wdog.h>
 #include <nuttx/wqueue.h>
@@ -424,7 +425,7 @@ static void ftmac100_init(FAR struct ftmac100_driver_s *priv)
 
   rxdes[CONFIG_FTMAC100_RX_DESC - 1].rxdes1 = FTMAC100_RXDES1_EDORR;
 
-  kmem = kmm_memalign(RX_BUF_SIZE, CONFIG_FTMAC100_RX_DESC * RX_BUF_SIZE);
+  kmem = mm_dmamemalign(RX_BUF_SIZE, CONFIG_FTMAC100_RX_DESC * RX_BUF_SIZE);
 
   ninfo("KMEM=%08x\n", kmem);
 
@@ -29,6 +29,7 @@
 #include <errno.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/dmaalloc.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/addrenv.h>
@@ -1226,8 +1227,8 @@ static int igc_probe(FAR struct pci_device_s *dev)
 
   /* Allocate TX descriptors */
 
-  priv->tx = kmm_memalign(type->desc_align,
-                          IGC_TX_DESC * sizeof(struct igc_tx_leg_s));
+  priv->tx = mm_dmamemalign(type->desc_align,
+                             IGC_TX_DESC * sizeof(struct igc_tx_leg_s));
   if (priv->tx == NULL)
     {
       nerr("alloc tx failed %d\n", errno);
@@ -1236,8 +1237,8 @@ static int igc_probe(FAR struct pci_device_s *dev)
 
   /* Allocate RX descriptors */
 
-  priv->rx = kmm_memalign(type->desc_align,
-                          IGC_RX_DESC * sizeof(struct igc_rx_leg_s));
+  priv->rx = mm_dmamemalign(type->desc_align,
+                             IGC_RX_DESC * sizeof(struct igc_rx_leg_s));
   if (priv->rx == NULL)
     {
       nerr("alloc rx failed %d\n", errno);
@@ -1310,8 +1311,8 @@ static int igc_probe(FAR struct pci_device_s *dev)
   return netdev_lower_register(netdev, NET_LL_ETHERNET);
 
 errout:
-  kmm_free(priv->tx);
-  kmm_free(priv->rx);
+  mm_dmafree(priv->tx);
+  mm_dmafree(priv->rx);
 #ifdef CONFIG_NET_MCASTGROUP
   kmm_free(priv->mta);
 #endif
@@ -24,8 +24,11 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
+
 #include <debug.h>
 #include <errno.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
@@ -54,7 +57,13 @@
 #  define NETDEV_WORK LPWORK
 #endif
 
-#ifdef CONFIG_NETDEV_RSS
+#ifdef CONFIG_NETDEV_NAPI
+#  define NETDEV_RX_BUDGET CONFIG_NETDEV_NAPI_BUDGET
+#else
+#  define NETDEV_RX_BUDGET INT_MAX
+#endif
+
+#if defined(CONFIG_NETDEV_RSS) || defined(CONFIG_NETDEV_MULTIQUEUE)
 #  define NETDEV_THREAD_COUNT CONFIG_SMP_NCPUS
 #else
 #  define NETDEV_THREAD_COUNT 1
@@ -76,10 +85,20 @@ struct netdev_upperhalf_s
   pid_t tid[NETDEV_THREAD_COUNT];
   sem_t sem[NETDEV_THREAD_COUNT];
   sem_t sem_exit[NETDEV_THREAD_COUNT];
+  int   nthreads;
 #else
   struct work_s work;
 #endif
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  unsigned int queue; /* The queue served by the running work */
+#endif
+
+#if CONFIG_NETDEV_NAPI_COALESCE_MAX > 0
+  unsigned int rxavg;      /* Packets per poll pass (units: 1/16) */
+  unsigned int rxcoalesce; /* The RX interrupt coalescing set */
+#endif
+
   /* TX queue for re-queueing replies */
 
 #if CONFIG_IOB_NCHAINS > 0
@@ -221,6 +240,59 @@ netdev_upper_alloc(FAR struct netdev_lowerhalf_s *dev)
   return upper;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_receive
+ *
+ * Description:
+ *   Receive a packet on the queue served by the running work.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static inline FAR netpkt_t *
+netdev_upper_receive(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->nqueues > 1)
+    {
+      return lower->ops->receive_queue(lower, upper->queue);
+    }
+#endif
+
+  return lower->ops->receive(lower);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_transmit
+ *
+ * Description:
+ *   Transmit a packet on the queue served by the running work, which is the
+ *   queue of the CPU that woke it up for sending.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static inline int netdev_upper_transmit(FAR struct netdev_upperhalf_s *upper,
+                                        FAR netpkt_t *pkt)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->nqueues > 1)
+    {
+      return lower->ops->transmit_queue(lower, pkt, upper->queue);
+    }
+#endif
+
+  return lower->ops->transmit(lower, pkt);
+}
+
 /****************************************************************************
  * Name: netdev_upper_can_tx
  *
@@ -297,7 +369,7 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
     }
   else
     {
-      ret = lower->ops->transmit(lower, pkt);
+      ret = netdev_upper_transmit(upper, pkt);
     }
 
   if (ret != OK)
@@ -591,26 +663,39 @@ static void ip_input(FAR struct net_driver_s *dev)
  * Input Parameters:
  *   upper - Reference to the upper half driver structure
  *
+ * Returned Value:
+ *   The number of packets received, at most NETDEV_RX_BUDGET.
+ *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+static int netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
 {
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
   FAR struct net_driver_s       *dev   = &lower->netdev;
   FAR netpkt_t                  *pkt;
+  int                            npkts = 0;
+
+  /* Loop while receive() successfully retrieves valid Ethernet frames.
+   * receive() may mark the frame with d_rxcsumok, the mark only applies to
+   * that one frame.
+   */
 
-  /* Loop while receive() successfully retrieves valid Ethernet frames. */
+  NETDEV_RXCSUM_SET(dev, false);
 
-  while ((pkt = lower->ops->receive(lower)) != NULL)
+  while (npkts < NETDEV_RX_BUDGET &&
+         (pkt = netdev_upper_receive(upper)) != NULL)
     {
+      npkts++;
+
       if (!IFF_IS_UP(dev->d_flags))
         {
           /* Interface down, drop frame */
 
           NETDEV_RXDROPPED(dev);
+          NETDEV_RXCSUM_SET(dev, false);
           netpkt_free(lower, pkt, NETPKT_RX);
           continue;
         }
@@ -637,6 +722,14 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
 #endif
 #if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
     defined(CONFIG_DRIVERS_IEEE80211)
+#ifdef CONFIG_NETDEV_GRO
+          if (dev->d_lltype == NET_LL_ETHERNET)
+            {
+              netdev_gro_input(dev, eth_input);
+              break;
+            }
+#endif
+
           eth_input(dev);
           break;
 #endif
@@ -655,31 +748,156 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
           nerr("Unknown link type %d\n", dev->d_lltype);
           break;
         }
+
+      NETDEV_RXCSUM_SET(dev, false);
     }
+
+#ifdef CONFIG_NETDEV_GRO
+  /* The end of the batch, nothing more to merge */
+
+  netdev_gro_flush(dev, eth_input);
+#endif
+
+  return npkts;
 }
 
 /****************************************************************************
- * Name: netdev_upper_work
+ * Name: netdev_upper_napi_complete
  *
  * Description:
- *   Perform an out-of-cycle poll on a dedicated thread or the worker thread.
+ *   Finish a poll pass: unmask the RX interrupt unless the pass used up the
+ *   budget and adapt the RX interrupt coalescing to the number of packets
+ *   per pass.
  *
  * Input Parameters:
- *   arg - Reference to the upper half driver structure (cast to void *)
+ *   upper - Reference to the upper half driver structure
+ *   queue - The queue that was polled
+ *   npkts - The number of packets received in the pass
+ *
+ * Returned Value:
+ *   True if more packets may be pending and the queue has to be polled
+ *   again.
  *
  ****************************************************************************/
 
-static void netdev_upper_work(FAR void *arg)
+#ifdef CONFIG_NETDEV_NAPI
+static bool netdev_upper_napi_complete(FAR struct netdev_upperhalf_s *upper,
+                                       unsigned int queue, int npkts)
 {
-  FAR struct netdev_upperhalf_s *upper = arg;
+#if CONFIG_NETDEV_NAPI_COALESCE_MAX > 0
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  unsigned int usecs;
+
+  /* Scale the coalescing with the average packets per pass and only
+   * reprogram the driver on a change of an eighth of the range.
+   */
+
+  upper->rxavg = (7 * upper->rxavg + 16 * npkts) / 8;
+  usecs = CONFIG_NETDEV_NAPI_COALESCE_MAX * upper->rxavg /
+          (16 * CONFIG_NETDEV_NAPI_BUDGET);
+  usecs = MIN(usecs, CONFIG_NETDEV_NAPI_COALESCE_MAX);
+
+  if (lower->ops->rxcoalesce != NULL &&
+      (usecs > upper->rxcoalesce ? usecs - upper->rxcoalesce :
+       upper->rxcoalesce - usecs) >= CONFIG_NETDEV_NAPI_COALESCE_MAX / 8)
+    {
+      upper->rxcoalesce = usecs;
+      lower->ops->rxcoalesce(lower, usecs);
+    }
+#endif
+
+  if (npkts >= NETDEV_RX_BUDGET)
+    {
+      return true;
+    }
+
+#if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+  if (upper->lower->ops->rxint != NULL)
+    {
+      upper->lower->ops->rxint(upper->lower, queue, true);
+    }
+#endif
+
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_poll
+ *
+ * Description:
+ *   Poll one queue of the device for received packets and packets to send.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   queue - The queue to poll, zero for a single queue device
+ *
+ * Returned Value:
+ *   True if the receive budget was used up and the queue has to be polled
+ *   again.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_poll(FAR struct netdev_upperhalf_s *upper,
+                              unsigned int queue)
+{
+  int npkts;
 
   /* RX may release quota and driver buffer, so do RX first. */
 
   net_lock();
-  netdev_upper_rxpoll_work(upper);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  upper->queue = queue;
+#endif
+  npkts = netdev_upper_rxpoll_work(upper);
   netdev_upper_txavail_work(upper);
+
+  /* Both may have sent packets, they can be pushed out at once now */
+
+  if (upper->lower->ops->txflush != NULL)
+    {
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+      upper->lower->ops->txflush(upper->lower,
+                                 upper->lower->nqueues > 1 ? queue : 0);
+#else
+      upper->lower->ops->txflush(upper->lower, 0);
+#endif
+    }
+
   net_unlock();
+
+#ifdef CONFIG_NETDEV_NAPI
+  return netdev_upper_napi_complete(upper, queue, npkts);
+#else
+  UNUSED(npkts);
+  return false;
+#endif
+}
+
+/****************************************************************************
+ * Name: netdev_upper_work
+ *
+ * Description:
+ *   Perform an out-of-cycle poll on the worker thread.
+ *
+ * Input Parameters:
+ *   arg - Reference to the upper half driver structure (cast to void *)
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NETDEV_WORK_THREAD
+static void netdev_upper_work(FAR void *arg)
+{
+  FAR struct netdev_upperhalf_s *upper = arg;
+
+  /* Poll again after the work queued meanwhile had its turn */
+
+  if (netdev_upper_poll(upper, 0))
+    {
+      work_queue(NETDEV_WORK, &upper->work, netdev_upper_work, upper, 0);
+    }
 }
+#endif
 
 /****************************************************************************
  * Name: netdev_upper_wait
@@ -716,18 +934,26 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
     (FAR struct netdev_upperhalf_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
   int cpu = atoi(argv[2]);
 
-#ifdef CONFIG_NETDEV_RSS
+#if defined(CONFIG_NETDEV_RSS) || defined(CONFIG_NETDEV_MULTIQUEUE)
   cpu_set_t cpuset;
 
-  CPU_ZERO(&cpuset);
-  CPU_SET(cpu, &cpuset);
-  sched_setaffinity(upper->tid[cpu], sizeof(cpu_set_t), &cpuset);
+  /* With RSS or multiple queues, there is one thread per CPU or queue */
+
+  if (upper->nthreads > 1)
+    {
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpu, &cpuset);
+      sched_setaffinity(upper->tid[cpu], sizeof(cpu_set_t), &cpuset);
+    }
 #endif
 
   while (netdev_upper_wait(&upper->sem[cpu]) == OK &&
          upper->tid[cpu] != INVALID_PROCESS_ID)
     {
-      netdev_upper_work(upper);
+      /* Keep polling while the receive budget is used up */
+
+      while (netdev_upper_poll(upper, cpu) &&
+             upper->tid[cpu] != INVALID_PROCESS_ID);
     }
 
   nwarn("WARNING: Netdev work thread quitting.");
@@ -736,6 +962,32 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
 }
 #endif
 
+/****************************************************************************
+ * Name: netdev_upper_queue_post
+ *
+ * Description:
+ *   Wake up the work thread of a queue.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   queue - The queue the thread serves
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_WORK_THREAD
+static inline void
+netdev_upper_queue_post(FAR struct netdev_upperhalf_s *upper, int queue)
+{
+  int semcount;
+
+  if (nxsem_get_value(&upper->sem[queue], &semcount) == OK &&
+      semcount <= 0)
+    {
+      nxsem_post(&upper->sem[queue]);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_upper_queue_work
  *
@@ -752,18 +1004,17 @@ static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
 
 #ifdef CONFIG_NETDEV_WORK_THREAD
-#  ifdef CONFIG_NETDEV_RSS
-  int cpu = this_cpu();
+#  if defined(CONFIG_NETDEV_RSS) || defined(CONFIG_NETDEV_MULTIQUEUE)
+  /* Wake up the thread of the current CPU, so that a multi-queue device
+   * sends on the queue of the sending CPU.
+   */
+
+  int cpu = upper->nthreads > 1 ? this_cpu() % upper->nthreads : 0;
 #  else
   const int cpu = 0;
 #  endif
-  int semcount;
 
-  if (nxsem_get_value(&upper->sem[cpu], &semcount) == OK &&
-      semcount <= 0)
-    {
-      nxsem_post(&upper->sem[cpu]);
-    }
+  netdev_upper_queue_post(upper, cpu);
 #else
   if (work_available(&upper->work))
     {
@@ -1051,7 +1302,7 @@ static int netdev_upper_ifup(FAR struct net_driver_s *dev)
 
   /* Try to bring up a dedicated thread for work. */
 
-  for (i = 0; i < NETDEV_THREAD_COUNT; i++)
+  for (i = 0; i < upper->nthreads; i++)
     {
       if (upper->tid[i] <= 0)
         {
@@ -1143,6 +1394,18 @@ static int netdev_upper_ioctl(FAR struct net_driver_s *dev, int cmd,
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
 
+#if defined(CONFIG_NETDEV_RSS) && defined(CONFIG_NETDEV_MULTIQUEUE)
+  /* Tell the driver the queue a flow should be steered to for RFS */
+
+  if (cmd == SIOCNOTIFYRECVCPU)
+    {
+      FAR struct netdev_rss_s *rss =
+        (FAR struct netdev_rss_s *)(uintptr_t)arg;
+
+      rss->queue = netdev_lower_cpu_queue(lower, rss->cpu);
+    }
+#endif
+
 #ifdef CONFIG_NETDEV_WIRELESS_HANDLER
   if (lower->iw_ops)
     {
@@ -1193,8 +1456,24 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
   int i;
 #endif
 
-  if (dev == NULL || quota_is_valid(dev) == false || dev->ops == NULL ||
-      dev->ops->transmit == NULL || dev->ops->receive == NULL)
+  if (dev == NULL || quota_is_valid(dev) == false || dev->ops == NULL)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (dev->nqueues > 1)
+    {
+      if (dev->nqueues > CONFIG_SMP_NCPUS ||
+          dev->ops->transmit_queue == NULL ||
+          dev->ops->receive_queue == NULL)
+        {
+          return -EINVAL;
+        }
+    }
+  else
+#endif
+  if (dev->ops->transmit == NULL || dev->ops->receive == NULL)
     {
       return -EINVAL;
     }
@@ -1204,6 +1483,22 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
       return -ENOMEM;
     }
 
+#ifdef CONFIG_NETDEV_WORK_THREAD
+#  ifdef CONFIG_NETDEV_RSS
+  upper->nthreads = NETDEV_THREAD_COUNT;
+#  else
+  upper->nthreads = 1;
+#  endif
+#  ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* A multi-queue device gets one thread per queue */
+
+  if (dev->nqueues > 1)
+    {
+      upper->nthreads = dev->nqueues;
+    }
+#  endif
+#endif
+
   dev->netdev.d_ifup    = netdev_upper_ifup;
   dev->netdev.d_ifdown  = netdev_upper_ifdown;
   dev->netdev.d_txavail = netdev_upper_txavail;
@@ -1344,6 +1639,15 @@ void netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev)
 void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
 {
 #if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+#  ifdef CONFIG_NETDEV_NAPI
+  /* Poll until the device is idle before taking the next interrupt */
+
+  if (dev->ops->rxint != NULL)
+    {
+      dev->ops->rxint(dev, 0, false);
+    }
+#  endif
+
   netdev_upper_queue_work(&dev->netdev);
 #endif
 }
@@ -1367,6 +1671,83 @@ void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev)
 #endif
 }
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet is ready to read on
+ *   one queue of a multi-queue device.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue that received the packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                unsigned int queue)
+{
+#if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+#  ifdef CONFIG_NETDEV_NAPI
+  if (dev->ops->rxint != NULL)
+    {
+      dev->ops->rxint(dev, queue, false);
+    }
+#  endif
+
+  netdev_upper_queue_post(dev->netdev.d_private, queue);
+#endif
+}
+
+/****************************************************************************
+ * Name: netdev_lower_txdone_queue
+ *
+ * Description:
+ *   Notifies the networking layer about a TX packet is sent on one queue
+ *   of a multi-queue device.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue that sent the packet
+ *
+ ****************************************************************************/
+
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev,
+                               unsigned int queue)
+{
+  NETDEV_TXDONE(&dev->netdev);
+#if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+  netdev_upper_queue_post(dev->netdev.d_private, queue);
+#endif
+}
+
+/****************************************************************************
+ * Name: netdev_lower_cpu_queue
+ *
+ * Description:
+ *   Get the queue whose work thread runs on a CPU.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   cpu - The CPU of interest
+ *
+ * Returned Value:
+ *   The queue that is served on the CPU.
+ *
+ ****************************************************************************/
+
+unsigned int netdev_lower_cpu_queue(FAR struct netdev_lowerhalf_s *dev,
+                                    int cpu)
+{
+  /* Thread i serves queue i and is pinned to CPU i, see
+   * netdev_upper_queue_work(), so the CPUs beyond the queues are spread.
+   */
+
+  return dev->nqueues > 1 ? cpu % dev->nqueues : 0;
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_quota_load
  *
@@ -1422,6 +1803,60 @@ FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
   return pkt;
 }
 
+/****************************************************************************
+ * Name: netpkt_alloc_multiple
+ *
+ * Description:
+ *   Allocate up to 'n' netpkt structures at once, the quota and the IOB
+ *   pool are only touched once for the whole batch.
+ *
+ * Input Parameters:
+ *   dev  - The lower half device driver structure
+ *   type - Whether used for TX or RX
+ *   pkts - The array that receives the packets
+ *   n    - The number of packets requested
+ *
+ * Returned Value:
+ *   The number of packets actually allocated
+ *
+ ****************************************************************************/
+
+int netpkt_alloc_multiple(FAR struct netdev_lowerhalf_s *dev,
+                          enum netpkt_type_e type, FAR netpkt_t **pkts,
+                          int n)
+{
+  int quota;
+  int ret;
+  int i;
+
+  if (n <= 0)
+    {
+      return 0;
+    }
+
+  /* Reserve the quota for the whole batch and give back the excess */
+
+  quota = atomic_fetch_sub(&dev->quota[type], n);
+  if (quota < n)
+    {
+      atomic_fetch_add(&dev->quota[type], quota > 0 ? n - quota : n);
+      n = quota > 0 ? quota : 0;
+    }
+
+  ret = n > 0 ? iob_alloc_multiple(pkts, n, false) : 0;
+  if (ret < n)
+    {
+      atomic_fetch_add(&dev->quota[type], n - ret);
+    }
+
+  for (i = 0; i < ret; i++)
+    {
+      iob_reserve(pkts[i], CONFIG_NET_LL_GUARDSIZE);
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: netpkt_free
  *
@@ -1641,3 +2076,138 @@ int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
 
   return i;
 }
+
+/****************************************************************************
+ * Name: netpkt_csum_partial
+ *
+ * Description:
+ *   Prepare a TX packet for hardware TCP/UDP checksum offload.  The L4
+ *   checksum field is seeded with the sum of the pseudo-header, so that
+ *   the hardware only has to add the ones' complement sum of everything
+ *   from 'start' to the end of the packet and store the result at
+ *   'start' + 'offset'.  This also holds for forwarded packets that
+ *   already carry a complete checksum.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *   start  - Returns the offset of the L4 header from the start of the
+ *            frame (including the link layer header)
+ *   offset - Returns the offset of the checksum field within the L4 header
+ *
+ * Returned Value:
+ *   OK if the packet needs the checksum filled in by the hardware.
+ *   -ENOTSUP if the packet is not a TCP/UDP packet or is an IP fragment,
+ *   in which case the packet must be sent as is.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+int netpkt_csum_partial(FAR struct netdev_lowerhalf_s *dev,
+                        FAR netpkt_t *pkt, FAR uint16_t *start,
+                        FAR uint16_t *offset)
+{
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  FAR uint8_t *chksump;
+  uint16_t upperlen;
+  uint16_t iphdrlen;
+  uint16_t csumoff;
+  uint16_t sum;
+  uint8_t proto;
+
+  if (pkt->io_len < 1)
+    {
+      return -ENOTSUP;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if ((ip[0] & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+
+      iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+      if (pkt->io_len < iphdrlen ||
+          ((ipv4->ipoffset[0] << 8 | ipv4->ipoffset[1]) &
+           ~(IP_FLAG_DONTFRAG | IP_FLAG_RESERVED)) != 0)
+        {
+          /* Fragments can only be checksummed as a whole datagram */
+
+          return -ENOTSUP;
+        }
+
+      proto    = ipv4->proto;
+      upperlen = ((uint16_t)ipv4->len[0] << 8 | ipv4->len[1]) - iphdrlen;
+      sum      = chksum(0, (FAR uint8_t *)ipv4->srcipaddr,
+                        2 * sizeof(in_addr_t));
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      /* Extension headers are not handled, the stack does not generate
+       * them for TCP or UDP.
+       */
+
+      iphdrlen = IPv6_HDRLEN;
+      if (pkt->io_len < iphdrlen)
+        {
+          return -ENOTSUP;
+        }
+
+      proto    = ipv6->proto;
+      upperlen = (uint16_t)ipv6->len[0] << 8 | ipv6->len[1];
+      sum      = chksum(0, (FAR uint8_t *)ipv6->srcipaddr,
+                        2 * sizeof(net_ipv6addr_t));
+    }
+  else
+#endif
+    {
+      return -ENOTSUP;
+    }
+
+  /* Offset of the checksum field in the TCP and UDP headers */
+
+  if (proto == IP_PROTO_TCP)
+    {
+      csumoff = 16;
+    }
+  else if (proto == IP_PROTO_UDP)
+    {
+      csumoff = 6;
+    }
+  else
+    {
+      return -ENOTSUP;
+    }
+
+  if (pkt->io_len < iphdrlen + csumoff + 2)
+    {
+      return -ENOTSUP;
+    }
+
+  /* Add the protocol and the length, fold any carry back in */
+
+  sum += upperlen;
+  if (sum < upperlen)
+    {
+      sum++;
+    }
+
+  sum += proto;
+  if (sum < proto)
+    {
+      sum++;
+    }
+
+  chksump    = ip + iphdrlen + csumoff;
+  chksump[0] = sum >> 8;
+  chksump[1] = sum & 0xff;
+
+  *start  = NET_LL_HDRLEN(&dev->netdev) + iphdrlen;
+  *offset = csumoff;
+  return OK;
+}
+#endif
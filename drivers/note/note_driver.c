@@ -1423,8 +1423,9 @@ void sched_note_wdog(uint8_t event, FAR void *handler, FAR const void *arg)
 #endif
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_HEAP
-void sched_note_heap(uint8_t event, FAR void *heap, FAR void *mem,
-                     size_t size, size_t used)
+void sched_note_heap_ip(uint8_t event, FAR void *heap, FAR void *mem,
+                        size_t size, size_t used, size_t align,
+                        uintptr_t ip)
 {
   FAR struct note_driver_s **driver;
   struct note_heap_s note;
@@ -1456,6 +1457,8 @@ void sched_note_heap(uint8_t event, FAR void *heap, FAR void *mem,
           note.mem = mem;
           note.size = size;
           note.used = used;
+          note.align = align;
+          note.caller = ip;
         }
 
       /* Add the note to circular buffer */
@@ -1649,6 +1652,14 @@ void sched_note_vprintf_ip(uint32_t tag, uintptr_t ip, FAR const char *fmt,
                       continue;
                     }
 
+                  if (!infmt && *p == '%')
+                    {
+                      /* "%%" takes no argument */
+
+                      p++;
+                      continue;
+                    }
+
                   infmt = true;
                   var = (FAR void *)&note->npt_data[next];
 
@@ -34,6 +34,7 @@
 #include <inttypes.h>
 #include <poll.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched.h>
 #include <nuttx/sched_note.h>
@@ -70,19 +71,46 @@
 #define get_task_state(s)                                                    \
   ((s) == 0 ? 'X' : ((s) <= LAST_READY_TO_RUN_STATE ? 'R' : 'S'))
 
+/* With per-CPU buffers, the note buffer is split into one circular buffer
+ * for each CPU.  A CPU only takes the lock of its own buffer to add a note,
+ * so that the CPUs do not contend for one lock and its cache line.
+ */
+
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+#  define NOTERAM_NBUFFERS    NCPUS
+#  define NOTERAM_ALIGN       aligned_data(64)
+#  define noteram_this(drv)   (&(drv)->ni_buf[this_cpu()])
+#else
+#  define NOTERAM_NBUFFERS    1
+#  define NOTERAM_ALIGN
+#  define noteram_this(drv)   (&(drv)->ni_buf[0])
+#endif
+
+#define noteram_size(drv)     ((drv)->ni_bufsize / NOTERAM_NBUFFERS)
+#define noteram_base(drv, nb) \
+  ((drv)->ni_buffer + ((nb) - (drv)->ni_buf) * noteram_size(drv))
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* The indexes of the circular buffer of one CPU, or of all of them */
+
+struct noteram_buffer_s
+{
+  volatile unsigned int ni_head;
+  volatile unsigned int ni_tail;
+  volatile unsigned int ni_read;
+  spinlock_t lock;
+} NOTERAM_ALIGN;
+
 struct noteram_driver_s
 {
   struct note_driver_s driver;
   FAR uint8_t *ni_buffer;
   size_t ni_bufsize;
   unsigned int ni_overwrite;
-  volatile unsigned int ni_head;
-  volatile unsigned int ni_tail;
-  volatile unsigned int ni_read;
+  struct noteram_buffer_s ni_buf[NOTERAM_NBUFFERS];
   spinlock_t lock;
   FAR struct pollfd *pfd;
 };
@@ -201,8 +229,16 @@ struct noteram_driver_s g_noteram_driver =
 
 static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
 {
-  drv->ni_tail = drv->ni_head;
-  drv->ni_read = drv->ni_head;
+  FAR struct noteram_buffer_s *nb;
+  irqstate_t flags;
+
+  for (nb = drv->ni_buf; nb < &drv->ni_buf[NOTERAM_NBUFFERS]; nb++)
+    {
+      flags = spin_lock_irqsave_wo_note(&nb->lock);
+      nb->ni_tail = nb->ni_head;
+      nb->ni_read = nb->ni_head;
+      spin_unlock_irqrestore_wo_note(&nb->lock, flags);
+    }
 
   if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
@@ -230,9 +266,9 @@ static inline unsigned int noteram_next(FAR struct noteram_driver_s *drv,
                                         unsigned int offset)
 {
   ndx += offset;
-  if (ndx >= drv->ni_bufsize)
+  if (ndx >= noteram_size(drv))
     {
-      ndx -= drv->ni_bufsize;
+      ndx -= noteram_size(drv);
     }
 
   return ndx;
@@ -252,14 +288,15 @@ static inline unsigned int noteram_next(FAR struct noteram_driver_s *drv,
  *
  ****************************************************************************/
 
-static unsigned int noteram_length(FAR struct noteram_driver_s *drv)
+static unsigned int noteram_length(FAR struct noteram_driver_s *drv,
+                                   FAR struct noteram_buffer_s *nb)
 {
-  unsigned int head = drv->ni_head;
-  unsigned int tail = drv->ni_tail;
+  unsigned int head = nb->ni_head;
+  unsigned int tail = nb->ni_tail;
 
   if (tail > head)
     {
-      head += drv->ni_bufsize;
+      head += noteram_size(drv);
     }
 
   return head - tail;
@@ -279,14 +316,15 @@ static unsigned int noteram_length(FAR struct noteram_driver_s *drv)
  *
  ****************************************************************************/
 
-static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
+static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv,
+                                          FAR struct noteram_buffer_s *nb)
 {
-  unsigned int head = drv->ni_head;
-  unsigned int read = drv->ni_read;
+  unsigned int head = nb->ni_head;
+  unsigned int read = nb->ni_read;
 
   if (read > head)
     {
-      head += drv->ni_bufsize;
+      head += noteram_size(drv);
     }
 
   return head - read;
@@ -309,42 +347,44 @@ static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
  *
  ****************************************************************************/
 
-static void noteram_remove(FAR struct noteram_driver_s *drv)
+static void noteram_remove(FAR struct noteram_driver_s *drv,
+                           FAR struct noteram_buffer_s *nb)
 {
   unsigned int tail;
   unsigned int length;
 
   /* Get the tail index of the circular buffer */
 
-  tail = drv->ni_tail;
-  DEBUGASSERT(tail < drv->ni_bufsize);
+  tail = nb->ni_tail;
+  DEBUGASSERT(tail < noteram_size(drv));
 
   /* Get the length of the note at the tail index */
 
-  length = NOTE_ALIGN(drv->ni_buffer[tail]);
-  DEBUGASSERT(length <= noteram_length(drv));
+  length = NOTE_ALIGN(noteram_base(drv, nb)[tail]);
+  DEBUGASSERT(length <= noteram_length(drv, nb));
 
   /* Increment the tail index to remove the entire note from the circular
    * buffer.
    */
 
-  if (drv->ni_read == drv->ni_tail)
+  if (nb->ni_read == nb->ni_tail)
     {
       /* The read index also needs increment. */
 
-      drv->ni_read = noteram_next(drv, tail, length);
+      nb->ni_read = noteram_next(drv, tail, length);
     }
 
-  drv->ni_tail = noteram_next(drv, tail, length);
+  nb->ni_tail = noteram_next(drv, tail, length);
 }
 
 /****************************************************************************
  * Name: noteram_get
  *
  * Description:
- *   Get the next note from the read index of the circular buffer.
+ *   Get the next note from the read index of a circular buffer.
  *
  * Input Parameters:
+ *   nb     - The circular buffer
  *   buffer - Location to return the next note
  *   buflen - The length of the user provided buffer.
  *
@@ -356,9 +396,10 @@ static void noteram_remove(FAR struct noteram_driver_s *drv)
  ****************************************************************************/
 
 static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
+                           FAR struct noteram_buffer_s *nb,
                            FAR uint8_t *buffer, size_t buflen)
 {
-  FAR struct note_common_s *note;
+  FAR uint8_t *base = noteram_base(drv, nb);
   unsigned int remaining;
   unsigned int read;
   ssize_t notelen;
@@ -368,7 +409,7 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
 
   /* Verify that the circular buffer is not empty */
 
-  circlen = noteram_unread_length(drv);
+  circlen = noteram_unread_length(drv, nb);
   if (circlen <= 0)
     {
       return 0;
@@ -376,13 +417,14 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
 
   /* Get the read index of the circular buffer */
 
-  read = drv->ni_read;
-  DEBUGASSERT(read < drv->ni_bufsize);
+  read = nb->ni_read;
+  DEBUGASSERT(read < noteram_size(drv));
 
-  /* Get the length of the note at the read index */
+  /* Get the length of the note at the read index, the length is the first
+   * byte of the note.
+   */
 
-  note = (FAR struct note_common_s *)&drv->ni_buffer[read];
-  notelen = note->nc_length;
+  notelen = base[read];
   DEBUGASSERT(notelen <= circlen);
 
   /* Is the user buffer large enough to hold the note? */
@@ -391,7 +433,7 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
     {
       /* Skip the large note so that we do not get constipated. */
 
-      drv->ni_read = noteram_next(drv, read, NOTE_ALIGN(notelen));
+      nb->ni_read = noteram_next(drv, read, NOTE_ALIGN(notelen));
 
       /* and return an error */
 
@@ -405,7 +447,7 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
     {
       /* Copy the next byte at the read index */
 
-      *buffer++ = drv->ni_buffer[read];
+      *buffer++ = base[read];
 
       /* Adjust indices and counts */
 
@@ -413,11 +455,68 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
       remaining--;
     }
 
-  drv->ni_read = noteram_next(drv, drv->ni_read, NOTE_ALIGN(notelen));
+  nb->ni_read = noteram_next(drv, nb->ni_read, NOTE_ALIGN(notelen));
 
   return notelen;
 }
 
+/****************************************************************************
+ * Name: noteram_oldest
+ *
+ * Description:
+ *   Return the circular buffer with the oldest unread note, so that the
+ *   notes of the CPUs are read in the order of their timestamps.  The
+ *   buffers are not locked, a note added or removed meanwhile only
+ *   affects the order.
+ *
+ * Returned Value:
+ *   The circular buffer or NULL if all buffers are empty.
+ *
+ ****************************************************************************/
+
+static FAR struct noteram_buffer_s *
+noteram_oldest(FAR struct noteram_driver_s *drv)
+{
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  FAR struct noteram_buffer_s *oldest = NULL;
+  FAR struct noteram_buffer_s *nb;
+  clock_t systime = 0;
+
+  for (nb = drv->ni_buf; nb < &drv->ni_buf[NOTERAM_NBUFFERS]; nb++)
+    {
+      FAR uint8_t *base = noteram_base(drv, nb);
+      struct note_common_s note;
+      FAR uint8_t *ptr = (FAR uint8_t *)&note;
+      unsigned int read = nb->ni_read;
+      size_t i;
+
+      if (noteram_unread_length(drv, nb) < sizeof(note))
+        {
+          continue;
+        }
+
+      /* The note may wrap around the end of the buffer */
+
+      for (i = 0; i < sizeof(note); i++)
+        {
+          ptr[i] = base[read];
+          read = noteram_next(drv, read, 1);
+        }
+
+      if (oldest == NULL || (sclock_t)(note.nc_systime - systime) < 0)
+        {
+          oldest  = nb;
+          systime = note.nc_systime;
+        }
+    }
+
+  return oldest;
+#else
+  return noteram_unread_length(drv, &drv->ni_buf[0]) > 0 ?
+         &drv->ni_buf[0] : NULL;
+#endif
+}
+
 /****************************************************************************
  * Name: noteram_open
  ****************************************************************************/
@@ -427,10 +526,15 @@ static int noteram_open(FAR struct file *filep)
   FAR struct noteram_dump_context_s *ctx;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)
                                      filep->f_inode->i_private;
+  FAR struct noteram_buffer_s *nb;
 
-  /* Reset the read index of the circular buffer */
+  /* Reset the read index of the circular buffers */
+
+  for (nb = drv->ni_buf; nb < &drv->ni_buf[NOTERAM_NBUFFERS]; nb++)
+    {
+      nb->ni_read = nb->ni_tail;
+    }
 
-  drv->ni_read = drv->ni_tail;
   ctx = kmm_zalloc(sizeof(*ctx));
   if (ctx == NULL)
     {
@@ -459,15 +563,22 @@ static ssize_t noteram_read(FAR struct file *filep, FAR char *buffer,
 {
   FAR struct noteram_dump_context_s *ctx = filep->f_priv;
   FAR struct noteram_driver_s *drv = filep->f_inode->i_private;
+  FAR struct noteram_buffer_s *nb;
   FAR struct lib_memoutstream_s stream;
   ssize_t ret;
   irqstate_t flags;
 
   if (ctx->mode == NOTERAM_MODE_READ_BINARY)
     {
-      flags = spin_lock_irqsave_wo_note(&drv->lock);
-      ret = noteram_get(drv, (FAR uint8_t *)buffer, buflen);
-      spin_unlock_irqrestore_wo_note(&drv->lock, flags);
+      nb = noteram_oldest(drv);
+      if (nb == NULL)
+        {
+          return 0;
+        }
+
+      flags = spin_lock_irqsave_wo_note(&nb->lock);
+      ret = noteram_get(drv, nb, (FAR uint8_t *)buffer, buflen);
+      spin_unlock_irqrestore_wo_note(&nb->lock, flags);
     }
   else
     {
@@ -479,9 +590,15 @@ static ssize_t noteram_read(FAR struct file *filep, FAR char *buffer,
 
           /* Get the next note (removing it from the buffer) */
 
-          flags = spin_lock_irqsave_wo_note(&drv->lock);
-          ret = noteram_get(drv, note, sizeof(note));
-          spin_unlock_irqrestore_wo_note(&drv->lock, flags);
+          nb = noteram_oldest(drv);
+          if (nb == NULL)
+            {
+              return 0;
+            }
+
+          flags = spin_lock_irqsave_wo_note(&nb->lock);
+          ret = noteram_get(drv, nb, note, sizeof(note));
+          spin_unlock_irqrestore_wo_note(&nb->lock, flags);
           if (ret <= 0)
             {
               return ret;
@@ -651,7 +768,7 @@ static int noteram_poll(FAR struct file *filep, FAR struct pollfd *fds,
        * don't wait for RX.
        */
 
-      if (noteram_unread_length(drv) > 0)
+      if (noteram_oldest(drv) != NULL)
         {
           spin_unlock_irqrestore_wo_note(&drv->lock, flags);
           poll_notify(&drv->pfd, 1, POLLIN);
@@ -682,7 +799,8 @@ errout:
  *   None
  *
  * Assumptions:
- *   We are within a critical section.
+ *   We are within a critical section.  With per-CPU buffers, only the
+ *   buffer of this CPU is locked.
  *
  ****************************************************************************/
 
@@ -691,21 +809,29 @@ static void noteram_add(FAR struct note_driver_s *driver,
 {
   FAR const char *buf = note;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)driver;
+  FAR struct noteram_buffer_s *nb;
+  FAR uint8_t *base;
   unsigned int head;
   unsigned int remain;
   unsigned int space;
   irqstate_t flags;
 
-  flags = spin_lock_irqsave_wo_note(&drv->lock);
+  /* A thread that moves to another CPU in between only contends for the
+   * lock of the buffer of its old CPU.
+   */
+
+  nb    = noteram_this(drv);
+  base  = noteram_base(drv, nb);
+  flags = spin_lock_irqsave_wo_note(&nb->lock);
 
   if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
-      spin_unlock_irqrestore_wo_note(&drv->lock, flags);
+      spin_unlock_irqrestore_wo_note(&nb->lock, flags);
       return;
     }
 
-  DEBUGASSERT(note != NULL && notelen < drv->ni_bufsize);
-  remain = drv->ni_bufsize - noteram_length(drv);
+  DEBUGASSERT(note != NULL && notelen < noteram_size(drv));
+  remain = noteram_size(drv) - noteram_length(drv, nb);
 
   if (remain <= NOTE_ALIGN(notelen))
     {
@@ -714,7 +840,7 @@ static void noteram_add(FAR struct note_driver_s *driver,
           /* Stop recording if not in overwrite mode */
 
           drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
-          spin_unlock_irqrestore_wo_note(&drv->lock, flags);
+          spin_unlock_irqrestore_wo_note(&nb->lock, flags);
           return;
         }
 
@@ -723,19 +849,19 @@ static void noteram_add(FAR struct note_driver_s *driver,
 
       do
         {
-          noteram_remove(drv);
-          remain = drv->ni_bufsize - noteram_length(drv);
+          noteram_remove(drv, nb);
+          remain = noteram_size(drv) - noteram_length(drv, nb);
         }
       while (remain <= NOTE_ALIGN(notelen));
     }
 
-  head = drv->ni_head;
-  space = drv->ni_bufsize - head;
+  head = nb->ni_head;
+  space = noteram_size(drv) - head;
   space = space < notelen ? space : notelen;
-  memcpy(drv->ni_buffer + head, note, space);
-  memcpy(drv->ni_buffer, buf + space, notelen - space);
-  drv->ni_head = noteram_next(drv, head, NOTE_ALIGN(notelen));
-  spin_unlock_irqrestore_wo_note(&drv->lock, flags);
+  memcpy(base + head, note, space);
+  memcpy(base, buf + space, notelen - space);
+  nb->ni_head = noteram_next(drv, head, NOTE_ALIGN(notelen));
+  spin_unlock_irqrestore_wo_note(&nb->lock, flags);
   poll_notify(&drv->pfd, 1, POLLIN);
 }
 
@@ -1219,10 +1345,12 @@ static int noteram_dump_one(FAR uint8_t *p, FAR struct lib_outstream_s *s,
 
         ret += noteram_dump_header(s, &nmm->nhp_cmn, ctx);
         ret += lib_sprintf(s, "tracing_mark_write: C|%d|Heap Usage|%d|%s"
-                           ": heap: %p size:%" PRIiPTR ", address: %p\n",
+                           ": heap: %p size:%" PRIiPTR ", address: %p"
+                           ", align: %zu, caller: %p\n",
                            pid, nmm->used,
                            name[note->nc_type - NOTE_HEAP_ADD],
-                           nmm->heap, nmm->size, nmm->mem);
+                           nmm->heap, nmm->size, nmm->mem, nmm->align,
+                           (FAR void *)nmm->caller);
       }
       break;
 #endif
@@ -1252,9 +1380,16 @@ static void noteram_dump(FAR struct noteram_driver_s *drv)
 
   while (1)
     {
+      FAR struct noteram_buffer_s *nb;
       ssize_t ret;
 
-      ret = noteram_get(drv, note, sizeof(note));
+      nb = noteram_oldest(drv);
+      if (nb == NULL)
+        {
+          break;
+        }
+
+      ret = noteram_get(drv, nb, note, sizeof(note));
       if (ret <= 0)
         {
           break;
@@ -1317,6 +1452,26 @@ int noteram_register(void)
                          &g_noteram_driver);
 }
 
+/****************************************************************************
+ * Name: noteram_freeze
+ *
+ * Description:
+ *   Stop recording into the circular buffer, as if it ran full in the
+ *   no-overwrite mode, to keep the notes that led to an event of interest.
+ *   Recording restarts when the buffer is cleared or the overwrite mode is
+ *   set again.
+ *
+ * Input Parameters:
+ *   drv - The RAM note driver.
+ *
+ ****************************************************************************/
+
+void noteram_freeze(FAR struct noteram_driver_s *drv)
+{
+  drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
+  poll_notify(&drv->pfd, 1, POLLIN);
+}
+
 /****************************************************************************
  * Name: noteram_initialize
  *
@@ -1344,6 +1499,7 @@ noteram_initialize(FAR const char *devpath, size_t bufsize, bool overwrite)
   size_t len = 0;
 #endif
   int ret;
+  int i;
 
   drv = kmm_malloc(sizeof(*drv) + len + bufsize);
   if (drv == NULL)
@@ -1368,9 +1524,15 @@ noteram_initialize(FAR const char *devpath, size_t bufsize, bool overwrite)
   drv->ni_bufsize = bufsize;
   drv->ni_buffer = (FAR uint8_t *)(drv + 1) + len;
   drv->ni_overwrite = overwrite;
-  drv->ni_head = 0;
-  drv->ni_tail = 0;
-  drv->ni_read = 0;
+  for (i = 0; i < NOTERAM_NBUFFERS; i++)
+    {
+      drv->ni_buf[i].ni_head = 0;
+      drv->ni_buf[i].ni_tail = 0;
+      drv->ni_buf[i].ni_read = 0;
+      spin_lock_init(&drv->ni_buf[i].lock);
+    }
+
+  spin_lock_init(&drv->lock);
   drv->pfd = NULL;
 
   ret = note_driver_register(&drv->driver);
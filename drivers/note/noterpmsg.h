@@ -33,6 +33,26 @@
 
 #define NOTERPMSG_EPT_NAME           "rpmsg-note"
 
+/* The compact encoding is sent on an endpoint of its own, so that a
+ * client and a server that do not agree on it never bind.  Each note is
+ * sent as:
+ *
+ *   uint8_t  Length of the encoded note
+ *   uint8_t  nc_type
+ *   uint8_t  nc_priority
+ *   uint8_t  nc_cpu
+ *   varint   nc_pid
+ *   varint   nc_systime, as the difference to the previous note of the
+ *            rpmsg message, or as it is for the first one
+ *   ...      The rest of the note behind struct note_common_s
+ *
+ * A varint holds 7 bits per byte, the least significant first, and bit 7
+ * is set in all bytes but the last one.
+ */
+
+#define NOTERPMSG_COMPACT_EPT_NAME   "rpmsg-note-compact"
+#define NOTERPMSG_COMPACT_HDRLEN     4
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -121,6 +121,104 @@ static inline void noterpmsg_remove(FAR struct noterpmsg_driver_s *drv)
   drv->tail = noterpmsg_next(drv, tail, notelen);
 }
 
+#ifdef CONFIG_DRIVERS_NOTERPMSG_COMPACT
+static size_t noterpmsg_putvarint(FAR uint8_t *buf, uint64_t value)
+{
+  size_t len = 0;
+
+  while (value >= 0x80)
+    {
+      buf[len++] = (uint8_t)value | 0x80;
+      value >>= 7;
+    }
+
+  buf[len++] = (uint8_t)value;
+  return len;
+}
+
+/* Encode the note at the tail into 'buf' and remove it, see noterpmsg.h.
+ * Returns the encoded length, 0 if the note does not fit into 'space' or
+ * -E2BIG if the note was dropped as its encoding is too long.
+ */
+
+static ssize_t noterpmsg_encode(FAR struct noterpmsg_driver_s *drv,
+                               FAR uint8_t *buf, size_t space,
+                               FAR clock_t *systime)
+{
+  uint8_t raw[UINT8_MAX];
+  uint8_t enc[UINT8_MAX + 2 * NOTERPMSG_COMPACT_HDRLEN + 16];
+  FAR struct note_common_s *note = (FAR struct note_common_s *)raw;
+  size_t notelen = drv->buffer[drv->tail];
+  size_t remain;
+  size_t len;
+
+  remain = CONFIG_DRIVERS_NOTERPMSG_BUFSIZE - drv->tail;
+  remain = remain < notelen ? remain : notelen;
+  memcpy(raw, drv->buffer + drv->tail, remain);
+  memcpy(raw + remain, drv->buffer, notelen - remain);
+
+  DEBUGASSERT(notelen >= sizeof(struct note_common_s));
+
+  enc[1] = note->nc_type;
+  enc[2] = note->nc_priority;
+  enc[3] = note->nc_cpu;
+  len    = NOTERPMSG_COMPACT_HDRLEN;
+  len   += noterpmsg_putvarint(enc + len, (uint32_t)note->nc_pid);
+  len   += noterpmsg_putvarint(enc + len, note->nc_systime - *systime);
+
+  memcpy(enc + len, raw + sizeof(struct note_common_s),
+         notelen - sizeof(struct note_common_s));
+  len += notelen - sizeof(struct note_common_s);
+
+  if (len > space)
+    {
+      return 0;
+    }
+
+  drv->tail = noterpmsg_next(drv, drv->tail, notelen);
+
+  /* A note that grew too long is dropped */
+
+  if (len > UINT8_MAX)
+    {
+      return -E2BIG;
+    }
+
+  enc[0]   = len;
+  *systime = note->nc_systime;
+  memcpy(buf, enc, len);
+  return len;
+}
+
+/* Encode as many notes into an rpmsg buffer as fit.  The first note of
+ * each message carries the full time, so that a lost message does not
+ * shift the time of the following ones.
+ */
+
+static size_t noterpmsg_fill(FAR struct noterpmsg_driver_s *drv,
+                             FAR uint8_t *buffer, size_t space)
+{
+  clock_t systime = 0;
+  ssize_t enclen;
+  size_t len = 0;
+
+  while (drv->tail != drv->head)
+    {
+      enclen = noterpmsg_encode(drv, buffer + len, space - len, &systime);
+      if (enclen == 0)
+        {
+          break;
+        }
+      else if (enclen > 0)
+        {
+          len += enclen;
+        }
+    }
+
+  return len;
+}
+#endif
+
 static bool noterpmsg_transfer(FAR struct noterpmsg_driver_s *drv,
                                bool wait)
 {
@@ -142,6 +240,10 @@ static bool noterpmsg_transfer(FAR struct noterpmsg_driver_s *drv,
           return false;
         }
 
+#ifdef CONFIG_DRIVERS_NOTERPMSG_COMPACT
+      len = noterpmsg_fill(drv, buffer, space);
+#else
+
       if (space < len)
         {
           /* Find the len of large entire note data */
@@ -163,13 +265,13 @@ static bool noterpmsg_transfer(FAR struct noterpmsg_driver_s *drv,
 
       memcpy(buffer, drv->buffer + drv->tail, space);
       memcpy(buffer + space, drv->buffer, len - space);
+      drv->tail = noterpmsg_next(drv, drv->tail, len);
+#endif
 
-      if (rpmsg_send_nocopy(&drv->ept, buffer, len) < 0)
+      if (len == 0 || rpmsg_send_nocopy(&drv->ept, buffer, len) < 0)
         {
           rpmsg_release_tx_buffer(&drv->ept, buffer);
         }
-
-      drv->tail = noterpmsg_next(drv, drv->tail, len);
     }
 }
 
@@ -253,7 +355,12 @@ static void noterpmsg_device_created(FAR struct rpmsg_device *rdev,
     {
       drv->ept.priv = drv;
 
-      ret = rpmsg_create_ept(&drv->ept, rdev, NOTERPMSG_EPT_NAME,
+      ret = rpmsg_create_ept(&drv->ept, rdev,
+#ifdef CONFIG_DRIVERS_NOTERPMSG_COMPACT
+                             NOTERPMSG_COMPACT_EPT_NAME,
+#else
+                             NOTERPMSG_EPT_NAME,
+#endif
                              RPMSG_ADDR_ANY, RPMSG_ADDR_ANY,
                              noterpmsg_ept_cb, NULL);
       if (ret >= 0)
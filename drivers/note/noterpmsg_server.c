@@ -62,6 +62,88 @@ static int noterpmsg_ept_cb(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
+#ifdef CONFIG_DRIVERS_NOTERPMSG_COMPACT
+static size_t noterpmsg_getvarint(FAR const uint8_t *buf, size_t len,
+                                  FAR uint64_t *value)
+{
+  size_t pos = 0;
+  int shift = 0;
+
+  *value = 0;
+  while (pos < len && shift < 64)
+    {
+      *value |= (uint64_t)(buf[pos] & 0x7f) << shift;
+      if ((buf[pos++] & 0x80) == 0)
+        {
+          return pos;
+        }
+
+      shift += 7;
+    }
+
+  return 0;
+}
+
+/* Decode the compact notes of a message, see noterpmsg.h */
+
+static int noterpmsg_compact_ept_cb(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv)
+{
+  FAR const uint8_t *buf = data;
+  uint8_t raw[UINT8_MAX + sizeof(struct note_common_s)];
+  FAR struct note_common_s *note = (FAR struct note_common_s *)raw;
+  clock_t systime = 0;
+  uint64_t value;
+  size_t notelen;
+  size_t pos;
+  size_t n;
+
+  while (len >= NOTERPMSG_COMPACT_HDRLEN)
+    {
+      notelen = buf[0];
+      if (notelen < NOTERPMSG_COMPACT_HDRLEN || notelen > len)
+        {
+          break;
+        }
+
+      note->nc_type     = buf[1];
+      note->nc_priority = buf[2];
+      note->nc_cpu      = buf[3];
+      pos               = NOTERPMSG_COMPACT_HDRLEN;
+
+      n = noterpmsg_getvarint(buf + pos, notelen - pos, &value);
+      if (n == 0)
+        {
+          break;
+        }
+
+      note->nc_pid = (pid_t)value;
+      pos         += n;
+
+      n = noterpmsg_getvarint(buf + pos, notelen - pos, &value);
+      if (n == 0)
+        {
+          break;
+        }
+
+      systime         += (clock_t)value;
+      note->nc_systime = systime;
+      pos             += n;
+
+      memcpy(raw + sizeof(struct note_common_s), buf + pos, notelen - pos);
+      note->nc_length = sizeof(struct note_common_s) + notelen - pos;
+
+      sched_note_add(raw, note->nc_length);
+
+      buf += notelen;
+      len -= notelen;
+    }
+
+  return 0;
+}
+#endif
+
 static void noterpmsg_ns_unbind(FAR struct rpmsg_endpoint *ept)
 {
   FAR struct noterpmsg_server_s *srv = ept->priv;
@@ -74,6 +156,13 @@ static bool noterpmsg_ns_match(FAR struct rpmsg_device *rdev,
                                FAR void *priv, FAR const char *name,
                                uint32_t dest)
 {
+#ifdef CONFIG_DRIVERS_NOTERPMSG_COMPACT
+  if (!strcmp(name, NOTERPMSG_COMPACT_EPT_NAME))
+    {
+      return true;
+    }
+#endif
+
   return !strcmp(name, NOTERPMSG_EPT_NAME);
 }
 
@@ -92,9 +181,20 @@ static void noterpmsg_ns_bind(FAR struct rpmsg_device *rdev,
 
   srv->ept.priv = srv;
 
-  ret = rpmsg_create_ept(&srv->ept, rdev, NOTERPMSG_EPT_NAME,
-                         RPMSG_ADDR_ANY, dest,
-                         noterpmsg_ept_cb, noterpmsg_ns_unbind);
+#ifdef CONFIG_DRIVERS_NOTERPMSG_COMPACT
+  if (!strcmp(name, NOTERPMSG_COMPACT_EPT_NAME))
+    {
+      ret = rpmsg_create_ept(&srv->ept, rdev, name, RPMSG_ADDR_ANY, dest,
+                             noterpmsg_compact_ept_cb, noterpmsg_ns_unbind);
+    }
+  else
+#endif
+    {
+      ret = rpmsg_create_ept(&srv->ept, rdev, NOTERPMSG_EPT_NAME,
+                             RPMSG_ADDR_ANY, dest,
+                             noterpmsg_ept_cb, noterpmsg_ns_unbind);
+    }
+
   if (ret < 0)
     {
       kmm_free(srv);
@@ -27,6 +27,7 @@
 #include <debug.h>
 #include <sys/pciio.h>
 #include <sys/endian.h>
+#include <sys/param.h>
 
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
@@ -1962,6 +1963,59 @@ int pci_connect_irq(FAR struct pci_device_s *dev, FAR int *irq, int num)
     }
 }
 
+/****************************************************************************
+ * Name: pci_alloc_irq_affinity
+ *
+ * Description:
+ *   Allocate up to num MSI or MSI-X vectors and spread them across the
+ *   CPUs, vector n is routed to CPU n modulo the number of CPUs.  Drivers
+ *   bind their queues to the vectors so that the queues are served in
+ *   parallel.  The request is limited to the size of the MSI-X table of the
+ *   device.
+ *
+ * Input Parameters:
+ *   dev - PCI device
+ *   irq - allocated vectors
+ *   num - number of vectors wanted
+ *
+ * Return value:
+ *   Return the number of allocated vectors on succes or negative errno
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int pci_alloc_irq_affinity(FAR struct pci_device_s *dev, FAR int *irq,
+                           int num)
+{
+#ifdef CONFIG_PCI_MSIX
+  uint16_t flags;
+  uint8_t msix = 0;
+#endif
+  int ret;
+
+#ifdef CONFIG_PCI_MSIX
+  pci_get_msi_base(dev, NULL, &msix);
+  if (msix != 0)
+    {
+      /* Table Size is N - 1 encoded */
+
+      pci_read_config_word(dev, msix + PCI_MSIX_FLAGS, &flags);
+      num = MIN(num, (flags & PCI_MSIX_FLAGS_QSIZE) + 1);
+    }
+#endif
+
+  ret = pci_alloc_irq(dev, irq, num);
+
+#if defined(CONFIG_SMP) && defined(CONFIG_ARCH_HAVE_IRQ_AFFINITY)
+  for (num = 0; num < ret; num++)
+    {
+      up_affinity_irq(irq[num], (cpu_set_t)1 << (num % CONFIG_SMP_NCPUS));
+    }
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: pci_register_driver
  *
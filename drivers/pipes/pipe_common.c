@@ -80,6 +80,150 @@ static void pipecommon_wakeup(FAR sem_t *sem)
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_readdone
+ *
+ * Description:
+ *   Notify the writers and the poll waiters after data was removed from
+ *   the pipe.
+ *
+ ****************************************************************************/
+
+static void pipecommon_readdone(FAR struct pipe_dev_s *dev)
+{
+  if (circbuf_used(&dev->d_buffer) <= (dev->d_bufsize - dev->d_polloutthrd))
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
+    }
+
+  pipecommon_wakeup(&dev->d_wrsem);
+}
+
+/****************************************************************************
+ * Name: pipecommon_writedone
+ *
+ * Description:
+ *   Notify the readers and the poll waiters after data was added to the
+ *   pipe.
+ *
+ ****************************************************************************/
+
+static void pipecommon_writedone(FAR struct pipe_dev_s *dev)
+{
+  if (circbuf_used(&dev->d_buffer) > dev->d_pollinthrd)
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+    }
+
+  pipecommon_wakeup(&dev->d_rdsem);
+}
+
+/****************************************************************************
+ * Name: pipecommon_nonblock
+ ****************************************************************************/
+
+static bool pipecommon_nonblock(FAR struct file *filep, unsigned int flags)
+{
+  return (filep->f_oflags & O_NONBLOCK) != 0 ||
+         (flags & SPLICE_F_NONBLOCK) != 0;
+}
+
+/****************************************************************************
+ * Name: pipecommon_waitdata
+ *
+ * Description:
+ *   Wait until the pipe holds data, the same way as pipecommon_read().
+ *
+ * Returned Value:
+ *   The number of bytes in the pipe with d_bflock held.  Zero if there
+ *   are no writers left or a negated errno value, both without d_bflock.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_waitdata(FAR struct pipe_dev_s *dev, bool nonblock)
+{
+  int ret;
+
+  ret = nxrmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (circbuf_is_empty(&dev->d_buffer))
+    {
+      if (dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return 0;
+        }
+
+      nxrmutex_unlock(&dev->d_bflock);
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      ret = nxsem_wait(&dev->d_rdsem);
+      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  return circbuf_used(&dev->d_buffer);
+}
+
+/****************************************************************************
+ * Name: pipecommon_waitspace
+ *
+ * Description:
+ *   Wait until the pipe has free space, the same way as pipecommon_write().
+ *
+ * Returned Value:
+ *   The free space of the pipe with d_bflock held.  A negated errno value
+ *   without d_bflock, -EPIPE if there are no readers left.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_waitspace(FAR struct pipe_dev_s *dev,
+                                    bool nonblock)
+{
+  int ret;
+
+  ret = nxrmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (; ; )
+    {
+      if (dev->d_nreaders <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EPIPE;
+        }
+
+      if (!circbuf_is_full(&dev->d_buffer))
+        {
+          return circbuf_space(&dev->d_buffer);
+        }
+
+      nxrmutex_unlock(&dev->d_bflock);
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      ret = nxsem_wait(&dev->d_wrsem);
+      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -650,6 +794,273 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
     }
 }
 
+/****************************************************************************
+ * Name: pipe_splicein
+ ****************************************************************************/
+
+ssize_t pipe_splicein(FAR struct file *infile, FAR off_t *inoff,
+                      FAR struct file *filep, size_t len,
+                      unsigned int flags)
+{
+  FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+  FAR void *buffer;
+  ssize_t ntotal = 0;
+  ssize_t ret;
+  size_t size;
+
+  DEBUGASSERT(dev);
+
+  ret = pipecommon_waitspace(dev, pipecommon_nonblock(filep, flags));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Read into the free space of the circular buffer, which is at most two
+   * contiguous regions.
+   */
+
+  while ((size_t)ntotal < len)
+    {
+      buffer = circbuf_get_writeptr(&dev->d_buffer, &size);
+      if (size == 0)
+        {
+          break;
+        }
+
+      size = MIN(size, len - ntotal);
+      if (inoff != NULL)
+        {
+          ret = file_pread(infile, buffer, size, *inoff);
+        }
+      else
+        {
+          ret = file_read(infile, buffer, size);
+        }
+
+      if (ret <= 0)
+        {
+          if (ntotal == 0)
+            {
+              ntotal = ret;
+            }
+
+          break;
+        }
+
+      circbuf_writecommit(&dev->d_buffer, ret);
+      ntotal += ret;
+      if (inoff != NULL)
+        {
+          *inoff += ret;
+        }
+
+      if ((size_t)ret < size)
+        {
+          break;
+        }
+    }
+
+  if (ntotal > 0)
+    {
+      pipecommon_writedone(dev);
+    }
+
+  nxrmutex_unlock(&dev->d_bflock);
+  return ntotal;
+}
+
+/****************************************************************************
+ * Name: pipe_spliceout
+ ****************************************************************************/
+
+ssize_t pipe_spliceout(FAR struct file *filep, FAR struct file *outfile,
+                       FAR off_t *outoff, size_t len, unsigned int flags)
+{
+  FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+  FAR void *buffer;
+  ssize_t ntotal = 0;
+  ssize_t ret;
+  size_t size;
+
+  DEBUGASSERT(dev);
+
+  ret = pipecommon_waitdata(dev, pipecommon_nonblock(filep, flags));
+  if (ret <= 0)
+    {
+      return ret;
+    }
+
+  /* Write from the data of the circular buffer, which is at most two
+   * contiguous regions.
+   */
+
+  while ((size_t)ntotal < len)
+    {
+      buffer = circbuf_get_readptr(&dev->d_buffer, &size);
+      if (size == 0)
+        {
+          break;
+        }
+
+      size = MIN(size, len - ntotal);
+      if (outoff != NULL)
+        {
+          ret = file_pwrite(outfile, buffer, size, *outoff);
+        }
+      else
+        {
+          ret = file_write(outfile, buffer, size);
+        }
+
+      if (ret <= 0)
+        {
+          if (ntotal == 0)
+            {
+              ntotal = ret;
+            }
+
+          break;
+        }
+
+      circbuf_readcommit(&dev->d_buffer, ret);
+      ntotal += ret;
+      if (outoff != NULL)
+        {
+          *outoff += ret;
+        }
+
+      if ((size_t)ret < size)
+        {
+          break;
+        }
+    }
+
+  if (ntotal > 0)
+    {
+      pipecommon_readdone(dev);
+    }
+
+  nxrmutex_unlock(&dev->d_bflock);
+  return ntotal;
+}
+
+/****************************************************************************
+ * Name: pipe_tee
+ ****************************************************************************/
+
+ssize_t pipe_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t len, unsigned int flags, bool move)
+{
+  FAR struct pipe_dev_s *indev = infile->f_inode->i_private;
+  FAR struct pipe_dev_s *outdev = outfile->f_inode->i_private;
+  FAR struct pipe_dev_s *first;
+  FAR struct pipe_dev_s *second;
+  FAR void *buffer;
+  size_t ntotal;
+  size_t size;
+  size_t pos;
+  bool closed;
+  int ret;
+
+  DEBUGASSERT(indev && outdev && indev != outdev);
+
+  /* Both pipes are locked at once, always in the same order so that tee()
+   * in the opposite direction can not dead lock.
+   */
+
+  first  = indev < outdev ? indev : outdev;
+  second = indev < outdev ? outdev : indev;
+
+  for (; ; )
+    {
+      ret = nxrmutex_lock(&first->d_bflock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = nxrmutex_lock(&second->d_bflock);
+      if (ret < 0)
+        {
+          nxrmutex_unlock(&first->d_bflock);
+          return ret;
+        }
+
+      if (circbuf_is_empty(&indev->d_buffer))
+        {
+          closed = indev->d_nwriters <= 0 &&
+                   PIPE_IS_POLICY_0(indev->d_flags);
+
+          nxrmutex_unlock(&second->d_bflock);
+          nxrmutex_unlock(&first->d_bflock);
+
+          if (closed)
+            {
+              return 0;
+            }
+          else if (pipecommon_nonblock(infile, flags))
+            {
+              return -EAGAIN;
+            }
+
+          ret = nxsem_wait(&indev->d_rdsem);
+        }
+      else if (circbuf_is_full(&outdev->d_buffer))
+        {
+          closed = outdev->d_nreaders <= 0 &&
+                   PIPE_IS_POLICY_0(outdev->d_flags);
+
+          nxrmutex_unlock(&second->d_bflock);
+          nxrmutex_unlock(&first->d_bflock);
+
+          if (closed)
+            {
+              return -EPIPE;
+            }
+          else if (pipecommon_nonblock(outfile, flags))
+            {
+              return -EAGAIN;
+            }
+
+          ret = nxsem_wait(&outdev->d_wrsem);
+        }
+      else
+        {
+          break;
+        }
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  ntotal = MIN(len, circbuf_used(&indev->d_buffer));
+  ntotal = MIN(ntotal, circbuf_space(&outdev->d_buffer));
+
+  for (pos = 0; pos < ntotal; pos += size)
+    {
+      buffer = circbuf_get_writeptr(&outdev->d_buffer, &size);
+      size   = MIN(size, ntotal - pos);
+      circbuf_peekat(&indev->d_buffer, indev->d_buffer.tail + pos,
+                     buffer, size);
+      circbuf_writecommit(&outdev->d_buffer, size);
+    }
+
+  pipecommon_writedone(outdev);
+
+  if (move)
+    {
+      circbuf_skip(&indev->d_buffer, ntotal);
+      pipecommon_readdone(indev);
+    }
+
+  nxrmutex_unlock(&second->d_bflock);
+  nxrmutex_unlock(&first->d_bflock);
+  return ntotal;
+}
+
 /****************************************************************************
  * Name: pipecommon_poll
  ****************************************************************************/
@@ -0,0 +1,252 @@
+/****************************************************************************
+ * drivers/power/pm/menu_governor.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/clock.h>
+#include <nuttx/config.h>
+
+#include <nuttx/wdog.h>
+#include <sys/types.h>
+#include <stdbool.h>
+
+#include <nuttx/power/pm.h>
+
+#include "pm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MENU_GOVERNOR_NHISTORY CONFIG_PM_GOVERNOR_MENU_HISTORY
+
+/****************************************************************************
+ * Private Type Declarations
+ ****************************************************************************/
+
+struct pm_menu_governor_domain_s
+{
+  /* The time the domain left PM_NORMAL and the time remaining before the
+   * next timer event then, or -1 without timer.
+   */
+
+  clock_t enter;
+  sclock_t next;
+  bool idle;
+
+  /* The recent idle periods, and whether each ended before the timer,
+   * woken up by another interrupt.
+   */
+
+  clock_t duration[MENU_GOVERNOR_NHISTORY];
+  bool early[MENU_GOVERNOR_NHISTORY];
+  uint8_t index;
+};
+
+struct pm_menu_governor_s
+{
+  struct pm_menu_governor_domain_s domain[CONFIG_PM_NDOMAINS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* PM governor methods */
+
+static void menu_governor_statechanged(int domain,
+                                       enum pm_state_e newstate);
+static enum pm_state_e menu_governor_checkstate(int domain);
+static void menu_governor_activity(int domain, int count);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct pm_governor_s g_menu_governor_ops =
+{
+  NULL,                       /* initialize */
+  NULL,                       /* deinitialize */
+  menu_governor_statechanged, /* statechanged */
+  menu_governor_checkstate,   /* checkstate */
+  menu_governor_activity,     /* activity */
+  NULL                        /* priv */
+};
+
+/* The shortest idle period worth entering each state, its exit latency
+ * included.
+ */
+
+static const clock_t g_menu_governor_residency[PM_COUNT] =
+{
+  0,
+  CONFIG_PM_GOVERNOR_MENU_IDLE_RESIDENCY,
+  CONFIG_PM_GOVERNOR_MENU_STANDBY_RESIDENCY,
+  CONFIG_PM_GOVERNOR_MENU_SLEEP_RESIDENCY,
+};
+
+static struct pm_menu_governor_s g_menu_governor;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: menu_governor_predict
+ *
+ * Description:
+ *   Predict the length of the next idle period.  The next timer event
+ *   bounds it.  When most of the recent periods were cut short by other
+ *   interrupts, their average is expected instead.
+ *
+ ****************************************************************************/
+
+static clock_t menu_governor_predict(FAR struct pm_menu_governor_domain_s
+                                     *gdom, sclock_t next)
+{
+  clock_t predict = next < 0 ? (clock_t)-1 : (clock_t)next;
+  clock_t total = 0;
+  int nearly = 0;
+  int i;
+
+  for (i = 0; i < MENU_GOVERNOR_NHISTORY; i++)
+    {
+      if (gdom->early[i])
+        {
+          total += gdom->duration[i];
+          nearly++;
+        }
+    }
+
+  if (2 * nearly > MENU_GOVERNOR_NHISTORY && total / nearly < predict)
+    {
+      predict = total / nearly;
+    }
+
+  return predict;
+}
+
+/****************************************************************************
+ * Name: menu_governor_statechanged
+ ****************************************************************************/
+
+static void menu_governor_statechanged(int domain,
+                                       enum pm_state_e newstate)
+{
+  FAR struct pm_menu_governor_domain_s *gdom;
+  clock_t duration;
+
+  gdom = &g_menu_governor.domain[domain];
+
+  if (newstate != PM_RESTORE)
+    {
+      gdom->enter = clock_systime_ticks();
+      gdom->idle  = true;
+    }
+  else if (gdom->idle)
+    {
+      /* Record how long the domain stayed idle */
+
+      duration = clock_systime_ticks() - gdom->enter;
+
+      gdom->duration[gdom->index] = duration;
+      gdom->early[gdom->index]    = gdom->next < 0 ||
+                                    duration < (clock_t)gdom->next;
+      gdom->index = (gdom->index + 1) % MENU_GOVERNOR_NHISTORY;
+      gdom->idle  = false;
+    }
+}
+
+/****************************************************************************
+ * Name: menu_governor_checkstate
+ ****************************************************************************/
+
+static enum pm_state_e menu_governor_checkstate(int domain)
+{
+  FAR struct pm_menu_governor_domain_s *gdom;
+  FAR struct pm_domain_s *pdom;
+  irqstate_t flags;
+  clock_t predict;
+  int state;
+
+  gdom = &g_menu_governor.domain[domain];
+  pdom = &g_pmdomains[domain];
+  state = PM_NORMAL;
+
+  /* We disable interrupts since pm_stay()/pm_relax() could be simultaneously
+   * invoked, which modifies the stay count which we are about to read
+   */
+
+  flags = spin_lock_irqsave(&pdom->lock);
+
+  /* Find the lowest power-level which is not locked. */
+
+  while (dq_empty(&pdom->wakelock[state]) && state < (PM_COUNT - 1))
+    {
+      state++;
+    }
+
+  spin_unlock_irqrestore(&pdom->lock, flags);
+
+  /* Then the deepest of them worth entering for the predicted period */
+
+  gdom->next = wd_nexttime();
+  predict    = menu_governor_predict(gdom, gdom->next);
+
+  while (state > PM_NORMAL && g_menu_governor_residency[state] > predict)
+    {
+      state--;
+    }
+
+  /* Return the found state */
+
+  return state;
+}
+
+/****************************************************************************
+ * Name: menu_governor_activity
+ ****************************************************************************/
+
+static void menu_governor_activity(int domain, int count)
+{
+  pm_staytimeout(domain, PM_NORMAL, (count ? count : 1) * 1000);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_menu_governor_initialize
+ *
+ * Description:
+ *   Return the menu governor instance.
+ *
+ * Returned Value:
+ *   A pointer to the governor struct. Otherwise NULL is returned on error.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_menu_governor_initialize(void)
+{
+  return &g_menu_governor_ops;
+}
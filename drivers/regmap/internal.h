@@ -79,9 +79,40 @@ struct regmap_s
 
   int reg_stride;
 
+#ifdef CONFIG_REGMAP_CACHE
+  /* Register cache, indexed by the register address divided by the
+   * stride.  The bitmaps tell which entries hold a value and which of
+   * those still have to be written to the device.
+   */
+
+  FAR unsigned int *cache;
+  FAR uint8_t *cache_valid;
+  FAR uint8_t *cache_dirty;
+  unsigned int max_register;
+  FAR const struct regmap_range_s *volatile_ranges;
+  unsigned int n_volatile_ranges;
+  bool cache_only;
+#endif
+
   /* Prevent fragmentation */
 
   mutex_t mutex[0];
 };
 
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_REGMAP_CACHE
+int regmap_cache_init(FAR struct regmap_s *map,
+                      FAR const struct regmap_config_s *config);
+void regmap_cache_exit(FAR struct regmap_s *map);
+bool regmap_cache_get(FAR struct regmap_s *map, unsigned int reg,
+                      FAR unsigned int *val);
+bool regmap_cache_set(FAR struct regmap_s *map, unsigned int reg,
+                      unsigned int val, bool dirty);
+void regmap_cache_drop(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int count);
+#endif
+
 #endif /* __DRIVERS_REGMAP_INTERNAL_H */
@@ -59,6 +59,95 @@ static void regmap_unlock_mutex(FAR void *context)
   nxmutex_unlock(&map->mutex[0]);
 }
 
+#ifdef CONFIG_REGMAP_CACHE
+static unsigned int regmap_get_val(FAR struct regmap_s *map,
+                                   FAR const void *val)
+{
+  switch (map->val_bytes)
+    {
+      case 4:
+        return *(FAR const uint32_t *)val;
+      case 2:
+        return *(FAR const uint16_t *)val;
+      default:
+        return *(FAR const uint8_t *)val;
+    }
+}
+
+static void regmap_put_val(FAR struct regmap_s *map, FAR void *val,
+                           unsigned int ival)
+{
+  switch (map->val_bytes)
+    {
+      case 4:
+        *(FAR uint32_t *)val = ival;
+        break;
+      case 2:
+        *(FAR uint16_t *)val = ival;
+        break;
+      default:
+        *(FAR uint8_t *)val = ival;
+        break;
+    }
+}
+#endif
+
+static int regmap_read_locked(FAR struct regmap_s *map, unsigned int reg,
+                              FAR void *val)
+{
+  int ret;
+
+#ifdef CONFIG_REGMAP_CACHE
+  unsigned int ival;
+
+  if (regmap_cache_get(map, reg, &ival))
+    {
+      regmap_put_val(map, val, ival);
+      return OK;
+    }
+
+  if (map->cache_only)
+    {
+      return -EBUSY;
+    }
+#endif
+
+  ret = map->reg_read(map->bus, reg, val);
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (ret >= 0)
+    {
+      regmap_cache_set(map, reg, regmap_get_val(map, val), false);
+    }
+#endif
+
+  return ret;
+}
+
+static int regmap_write_locked(FAR struct regmap_s *map, unsigned int reg,
+                               unsigned int val)
+{
+  int ret;
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (map->cache_only)
+    {
+      return regmap_cache_set(map, reg, val, true) ? OK : -EBUSY;
+    }
+#endif
+
+  ret = map->reg_write(map->bus, reg, val);
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (ret >= 0)
+    {
+      regmap_cache_set(map, reg, val, false);
+    }
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -138,6 +227,19 @@ FAR struct regmap_s *regmap_init(FAR struct regmap_bus_s *bus,
   map->read  = bus->read;
   map->write = bus->write;
 
+#ifdef CONFIG_REGMAP_CACHE
+  if (regmap_cache_init(map, config) < 0)
+    {
+      if (!config->disable_locking)
+        {
+          nxmutex_destroy(&map->mutex[0]);
+        }
+
+      kmm_free(map);
+      return NULL;
+    }
+#endif
+
   return map;
 }
 
@@ -171,7 +273,7 @@ int regmap_write(FAR struct regmap_s *map, unsigned int reg,
 
   map->lock(map);
 
-  ret = map->reg_write(map->bus, reg, val);
+  ret = regmap_write_locked(map, reg, val);
 
   map->unlock(map);
 
@@ -212,6 +314,19 @@ int regmap_bulk_write(FAR struct regmap_s *map, unsigned int reg,
   DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
 
   map->lock(map);
+
+#ifdef CONFIG_REGMAP_CACHE
+  /* Bulk accesses bypass the cache */
+
+  if (map->cache_only)
+    {
+      ret = -EBUSY;
+      goto out;
+    }
+
+  regmap_cache_drop(map, reg, val_count);
+#endif
+
   if (map->write != NULL)
     {
       ret = map->write(map->bus, val, val_bytes * val_count);
@@ -278,7 +393,7 @@ int regmap_read(FAR struct regmap_s *map, unsigned int reg, FAR void *val)
 
   map->lock(map);
 
-  ret = map->reg_read(map->bus, reg, val);
+  ret = regmap_read_locked(map, reg, val);
 
   map->unlock(map);
   return ret;
@@ -320,6 +435,14 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
 
   map->lock(map);
 
+#ifdef CONFIG_REGMAP_CACHE
+  if (map->cache_only)
+    {
+      map->unlock(map);
+      return -EBUSY;
+    }
+#endif
+
   if (map->read != NULL)
     {
       ret = map->read(map->bus, &reg, map->reg_bytes, val, val_count);
@@ -357,6 +480,62 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
   return ret;
 }
 
+/****************************************************************************
+ * Name: regmap_update_bits
+ *
+ * Description:
+ *   Read-modify-write of the bits of mask in a register.  The new value is
+ *   only written if it differs from the current one.  With the register
+ *   cache the current value comes from the cache.
+ *
+ * Input Parameters:
+ *   map  - regmap handler, from regmap bus init function return.
+ *   reg  - register address to be updated.
+ *   mask - the bits to update.
+ *   val  - the new value of the bits.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions/Limitations:
+ *   None.
+ *
+ ****************************************************************************/
+
+int regmap_update_bits(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int mask, unsigned int val)
+{
+  uint32_t orig = 0;
+  unsigned int tmp;
+  int ret;
+
+  DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
+
+  map->lock(map);
+
+  /* reg_read() stores val_bytes at the start of orig */
+
+  ret = regmap_read_locked(map, reg, &orig);
+  if (ret >= 0)
+    {
+      switch (map->val_bytes)
+        {
+          case 1:
+            orig = *(FAR uint8_t *)&orig;
+            break;
+          case 2:
+            orig = *(FAR uint16_t *)&orig;
+            break;
+        }
+
+      tmp = (orig & ~mask) | (val & mask);
+      ret = tmp != orig ? regmap_write_locked(map, reg, tmp) : OK;
+    }
+
+  map->unlock(map);
+  return ret;
+}
+
 /****************************************************************************
  * Name: regmap_exit
  *
@@ -377,6 +556,10 @@ void regmap_exit(FAR struct regmap_s *map)
       nxmutex_destroy(&map->mutex[0]);
     }
 
+#ifdef CONFIG_REGMAP_CACHE
+  regmap_cache_exit(map);
+#endif
+
   if (map->bus->exit != NULL)
     {
       map->bus->exit(map->bus);
@@ -0,0 +1,360 @@
+/****************************************************************************
+ * drivers/regmap/regmap_cache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/regmap/regmap.h>
+#include <nuttx/bits.h>
+#include <nuttx/kmalloc.h>
+
+#include <debug.h>
+#include <errno.h>
+#include <string.h>
+
+#include "internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest number of registers written in one bus transaction by
+ * regmap_cache_sync().
+ */
+
+#define REGMAP_SYNC_CHUNK 32
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: regmap_cache_index
+ *
+ * Description:
+ *   Get the cache index of a register, or -1 if the register is not
+ *   cached.
+ *
+ ****************************************************************************/
+
+static int regmap_cache_index(FAR struct regmap_s *map, unsigned int reg)
+{
+  unsigned int i;
+
+  if (map->cache == NULL || reg > map->max_register)
+    {
+      return -1;
+    }
+
+  for (i = 0; i < map->n_volatile_ranges; i++)
+    {
+      if (reg >= map->volatile_ranges[i].min &&
+          reg <= map->volatile_ranges[i].max)
+        {
+          return -1;
+        }
+    }
+
+  return reg / map->reg_stride;
+}
+
+/****************************************************************************
+ * Name: regmap_cache_write_run
+ *
+ * Description:
+ *   Write count adjacent registers from first on to the device.  With a
+ *   bulk write method of the bus and an 8 bit layout the run goes out as
+ *   {reg, val1, val2, ...}, the register address auto increment format of
+ *   the I2C and SPI buses.
+ *
+ ****************************************************************************/
+
+static int regmap_cache_write_run(FAR struct regmap_s *map,
+                                  unsigned int first, unsigned int count)
+{
+  uint8_t buf[REGMAP_SYNC_CHUNK + 1];
+  unsigned int i;
+  int ret;
+
+  if (count > 1 && map->write != NULL && map->reg_stride == 1 &&
+      map->reg_bytes == 1 && map->val_bytes == 1)
+    {
+      buf[0] = first;
+      for (i = 0; i < count; i++)
+        {
+          buf[i + 1] = map->cache[first + i];
+        }
+
+      ret = map->write(map->bus, buf, count + 1);
+      return ret < 0 ? ret : OK;
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      ret = map->reg_write(map->bus, (first + i) * map->reg_stride,
+                           map->cache[first + i]);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: regmap_cache_init
+ *
+ * Description:
+ *   Allocate the register cache described by the configuration.
+ *
+ ****************************************************************************/
+
+int regmap_cache_init(FAR struct regmap_s *map,
+                      FAR const struct regmap_config_s *config)
+{
+  unsigned int nregs;
+  size_t bitmap;
+
+  if (config->cache_type == REGMAP_CACHE_NONE)
+    {
+      return OK;
+    }
+
+  if (config->cache_type != REGMAP_CACHE_FLAT)
+    {
+      return -EINVAL;
+    }
+
+  nregs  = config->max_register / map->reg_stride + 1;
+  bitmap = BIT_BYTE(nregs) + 1;
+
+  map->cache = kmm_zalloc(nregs * sizeof(unsigned int) + 2 * bitmap);
+  if (map->cache == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  map->cache_valid       = (FAR uint8_t *)(map->cache + nregs);
+  map->cache_dirty       = map->cache_valid + bitmap;
+  map->max_register      = config->max_register;
+  map->volatile_ranges   = config->volatile_ranges;
+  map->n_volatile_ranges = config->n_volatile_ranges;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: regmap_cache_exit
+ ****************************************************************************/
+
+void regmap_cache_exit(FAR struct regmap_s *map)
+{
+  kmm_free(map->cache);
+  map->cache = NULL;
+}
+
+/****************************************************************************
+ * Name: regmap_cache_get
+ *
+ * Description:
+ *   Get the cached value of a register.  Returns false if the register is
+ *   not cached or its value is not known yet.
+ *
+ ****************************************************************************/
+
+bool regmap_cache_get(FAR struct regmap_s *map, unsigned int reg,
+                      FAR unsigned int *val)
+{
+  int index = regmap_cache_index(map, reg);
+
+  if (index < 0 ||
+      (map->cache_valid[BIT_BYTE(index)] & BIT_BYTE_MASK(index)) == 0)
+    {
+      return false;
+    }
+
+  *val = map->cache[index];
+  return true;
+}
+
+/****************************************************************************
+ * Name: regmap_cache_set
+ *
+ * Description:
+ *   Update the cached value of a register, dirty if the value still has to
+ *   be written to the device.  Returns false if the register is not
+ *   cached.
+ *
+ ****************************************************************************/
+
+bool regmap_cache_set(FAR struct regmap_s *map, unsigned int reg,
+                      unsigned int val, bool dirty)
+{
+  int index = regmap_cache_index(map, reg);
+
+  if (index < 0)
+    {
+      return false;
+    }
+
+  map->cache[index] = val;
+  map->cache_valid[BIT_BYTE(index)] |= BIT_BYTE_MASK(index);
+  if (dirty)
+    {
+      map->cache_dirty[BIT_BYTE(index)] |= BIT_BYTE_MASK(index);
+    }
+  else
+    {
+      map->cache_dirty[BIT_BYTE(index)] &= ~BIT_BYTE_MASK(index);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: regmap_cache_drop
+ *
+ * Description:
+ *   Forget the cached values of count registers from reg on, after an
+ *   access that bypassed the cache.
+ *
+ ****************************************************************************/
+
+void regmap_cache_drop(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int count)
+{
+  int index;
+
+  for (; count > 0; count--, reg += map->reg_stride)
+    {
+      index = regmap_cache_index(map, reg);
+      if (index >= 0)
+        {
+          map->cache_valid[BIT_BYTE(index)] &= ~BIT_BYTE_MASK(index);
+          map->cache_dirty[BIT_BYTE(index)] &= ~BIT_BYTE_MASK(index);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: regmap_cache_only
+ *
+ * Description:
+ *   Defer the register writes, while the device is powered down for
+ *   example.  In cache only mode writes of cached registers only update the
+ *   cache, regmap_cache_sync() writes them to the device later.  Accesses
+ *   that cannot be served by the cache fail with -EBUSY.
+ *
+ * Input Parameters:
+ *   map    - regmap handler, from regmap bus init function return.
+ *   enable - true to enter the cache only mode, false to leave it.
+ *
+ * Assumptions/Limitations:
+ *   None.
+ *
+ ****************************************************************************/
+
+void regmap_cache_only(FAR struct regmap_s *map, bool enable)
+{
+  map->lock(map);
+  map->cache_only = enable;
+  map->unlock(map);
+}
+
+/****************************************************************************
+ * Name: regmap_cache_sync
+ *
+ * Description:
+ *   Write the registers changed in cache only mode to the device.  Runs of
+ *   adjacent registers are written in one bus transaction.
+ *
+ * Input Parameters:
+ *   map - regmap handler, from regmap bus init function return.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions/Limitations:
+ *   None.
+ *
+ ****************************************************************************/
+
+int regmap_cache_sync(FAR struct regmap_s *map)
+{
+  unsigned int nregs;
+  unsigned int first;
+  unsigned int count;
+  unsigned int i;
+  int ret = OK;
+
+  if (map->cache == NULL)
+    {
+      return OK;
+    }
+
+  map->lock(map);
+
+  if (map->cache_only)
+    {
+      map->unlock(map);
+      return -EBUSY;
+    }
+
+  nregs = map->max_register / map->reg_stride + 1;
+  for (first = 0; first < nregs; first += count)
+    {
+      /* Find the next run of dirty registers */
+
+      if ((map->cache_dirty[BIT_BYTE(first)] & BIT_BYTE_MASK(first)) == 0)
+        {
+          count = 1;
+          continue;
+        }
+
+      for (count = 1; first + count < nregs && count < REGMAP_SYNC_CHUNK;
+           count++)
+        {
+          i = first + count;
+          if ((map->cache_dirty[BIT_BYTE(i)] & BIT_BYTE_MASK(i)) == 0)
+            {
+              break;
+            }
+        }
+
+      ret = regmap_cache_write_run(map, first, count);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      for (i = first; i < first + count; i++)
+        {
+          map->cache_dirty[BIT_BYTE(i)] &= ~BIT_BYTE_MASK(i);
+        }
+    }
+
+  map->unlock(map);
+  return ret;
+}
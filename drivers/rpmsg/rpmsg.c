@@ -207,6 +207,59 @@ FAR const char *rpmsg_get_cpuname(FAR struct rpmsg_device *rdev)
   return rpmsg ? rpmsg->ops->get_cpuname(rpmsg) : NULL;
 }
 
+FAR void *rpmsg_shm_alloc(FAR struct rpmsg_endpoint *ept, size_t size,
+                          FAR uint64_t *pa)
+{
+  FAR struct rpmsg_s *rpmsg;
+
+  if (!ept || !pa)
+    {
+      return NULL;
+    }
+
+  rpmsg = rpmsg_get_by_rdev(ept->rdev);
+  if (!rpmsg || !rpmsg->ops->shm_alloc)
+    {
+      return NULL;
+    }
+
+  return rpmsg->ops->shm_alloc(rpmsg, size, pa);
+}
+
+void rpmsg_shm_free(FAR struct rpmsg_endpoint *ept, FAR void *va)
+{
+  FAR struct rpmsg_s *rpmsg;
+
+  if (!ept || !va)
+    {
+      return;
+    }
+
+  rpmsg = rpmsg_get_by_rdev(ept->rdev);
+  if (rpmsg && rpmsg->ops->shm_free)
+    {
+      rpmsg->ops->shm_free(rpmsg, va);
+    }
+}
+
+FAR void *rpmsg_shm_pa2va(FAR struct rpmsg_endpoint *ept, uint64_t pa)
+{
+  FAR struct rpmsg_s *rpmsg;
+
+  if (!ept)
+    {
+      return NULL;
+    }
+
+  rpmsg = rpmsg_get_by_rdev(ept->rdev);
+  if (!rpmsg || !rpmsg->ops->shm_pa2va)
+    {
+      return NULL;
+    }
+
+  return rpmsg->ops->shm_pa2va(rpmsg, pa);
+}
+
 int rpmsg_register_callback(FAR void *priv,
                             rpmsg_dev_cb_t device_created,
                             rpmsg_dev_cb_t device_destroy,
@@ -22,10 +22,13 @@
  * Included Files
  ****************************************************************************/
 
+#include <debug.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
 
 #include <metal/mutex.h>
 #include <metal/sys.h>
@@ -314,6 +317,26 @@ static int rpmsg_port_send_offchannel_raw(FAR struct rpmsg_device *rdev,
   return rpmsg_port_send_offchannel_nocopy(rdev, src, dst, buf, len);
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_rx_frame
+ *
+ * Description:
+ *   Return the first message of the rx buffer that 'rxbuf' points into.
+ *   The hold count of a buffer is kept there for all the messages that it
+ *   carries.
+ *
+ ****************************************************************************/
+
+static FAR struct rpmsg_hdr *
+rpmsg_port_rx_frame(FAR struct rpmsg_port_s *port, FAR void *rxbuf)
+{
+  FAR struct rpmsg_port_queue_s *queue = &port->rxq;
+  FAR struct rpmsg_port_header_s *hdr =
+    RPMSG_PORT_NODE_TO_BUF(queue, RPMSG_PORT_BUF_TO_NODE(queue, rxbuf));
+
+  return (FAR struct rpmsg_hdr *)hdr->buf;
+}
+
 /****************************************************************************
  * Name: rpmsg_port_hold_rx_buffer
  ****************************************************************************/
@@ -321,7 +344,9 @@ static int rpmsg_port_send_offchannel_raw(FAR struct rpmsg_device *rdev,
 static void rpmsg_port_hold_rx_buffer(FAR struct rpmsg_device *rdev,
                                       FAR void *rxbuf)
 {
-  FAR struct rpmsg_hdr *rphdr = RPMSG_LOCATE_HDR(rxbuf);
+  FAR struct rpmsg_port_s *port =
+    metal_container_of(rdev, struct rpmsg_port_s, rdev);
+  FAR struct rpmsg_hdr *rphdr = rpmsg_port_rx_frame(port, rxbuf);
 
   atomic_fetch_add(&rphdr->reserved, 1 << RPMSG_BUF_HELD_SHIFT);
 }
@@ -335,7 +360,7 @@ static void rpmsg_port_release_rx_buffer(FAR struct rpmsg_device *rdev,
 {
   FAR struct rpmsg_port_s *port =
     metal_container_of(rdev, struct rpmsg_port_s, rdev);
-  FAR struct rpmsg_hdr *rphdr = RPMSG_LOCATE_HDR(rxbuf);
+  FAR struct rpmsg_hdr *rphdr = rpmsg_port_rx_frame(port, rxbuf);
   FAR struct rpmsg_port_header_s *hdr =
     metal_container_of(rphdr, struct rpmsg_port_header_s, buf);
   uint32_t reserved =
@@ -403,34 +428,73 @@ static void rpmsg_port_rx_callback(FAR struct rpmsg_port_s *port,
 {
   FAR struct rpmsg_device *rdev = &port->rdev;
   FAR struct rpmsg_hdr *rphdr = (FAR struct rpmsg_hdr *)hdr->buf;
-  FAR void *data = RPMSG_LOCATE_DATA(rphdr);
-  FAR struct rpmsg_endpoint *ept;
+  FAR void *frame = RPMSG_LOCATE_DATA(rphdr);
+  FAR struct rpmsg_endpoint *ept = NULL;
+  uint16_t len = hdr->len - sizeof(struct rpmsg_port_header_s);
+  uint16_t off = 0;
   int status;
 
-  metal_mutex_acquire(&rdev->lock);
-  ept = rpmsg_get_ept_from_addr(rdev, rphdr->dst);
-  rpmsg_ept_incref(ept);
-  metal_mutex_release(&rdev->lock);
-  rpmsg_port_hold_rx_buffer(rdev, data);
+  /* Hold the buffer until all the messages it carries are delivered */
 
-  if (ept != NULL)
+  rpmsg_port_hold_rx_buffer(rdev, frame);
+
+  while (off + sizeof(struct rpmsg_hdr) <= len)
     {
-      if (ept->dest_addr == RPMSG_ADDR_ANY)
+      FAR void *data;
+
+      rphdr = (FAR struct rpmsg_hdr *)(hdr->buf + off);
+      if (off + sizeof(struct rpmsg_hdr) + rphdr->len > len)
         {
-          ept->dest_addr = rphdr->src;
+          rpmsgerr("message at %u exceeds frame length %u\n", off, len);
+          break;
         }
 
-      status = ept->cb(ept, data, rphdr->len, rphdr->src, ept->priv);
-      if (status < 0)
+      data = RPMSG_LOCATE_DATA(rphdr);
+
+      /* A frame usually carries a run of messages for one endpoint.  The
+       * endpoint of the previous message is still referenced, so it is
+       * reused without the lock and the list walk while it stays
+       * registered: rpmsg_destroy_ept() clears ept->rdev.  That leaves the
+       * same window as a callback racing with the destroy after a lookup.
+       * Otherwise drop it and look up the one of this message under a
+       * single acquisition of the device lock.
+       */
+
+      if (ept == NULL || ept->rdev != rdev || ept->addr != rphdr->dst)
         {
-          RPMSG_ASSERT(0, "unexpected callback status\n");
+          metal_mutex_acquire(&rdev->lock);
+          rpmsg_ept_decref(ept);
+          ept = rpmsg_get_ept_from_addr(rdev, rphdr->dst);
+          rpmsg_ept_incref(ept);
+          metal_mutex_release(&rdev->lock);
+        }
+
+      if (ept != NULL)
+        {
+          if (ept->dest_addr == RPMSG_ADDR_ANY)
+            {
+              ept->dest_addr = rphdr->src;
+            }
+
+          status = ept->cb(ept, data, rphdr->len, rphdr->src, ept->priv);
+          if (status < 0)
+            {
+              RPMSG_ASSERT(0, "unexpected callback status\n");
+            }
         }
+
+      off += ALIGN_UP(sizeof(struct rpmsg_hdr) + rphdr->len,
+                      RPMSG_PORT_MSG_ALIGN);
     }
 
-  rpmsg_port_release_rx_buffer(rdev, data);
-  metal_mutex_acquire(&rdev->lock);
-  rpmsg_ept_decref(ept);
-  metal_mutex_release(&rdev->lock);
+  if (ept != NULL)
+    {
+      metal_mutex_acquire(&rdev->lock);
+      rpmsg_ept_decref(ept);
+      metal_mutex_release(&rdev->lock);
+    }
+
+  rpmsg_port_release_rx_buffer(rdev, frame);
 }
 
 /****************************************************************************
@@ -723,6 +787,60 @@ void rpmsg_port_queue_add_buffer(FAR struct rpmsg_port_queue_s *queue,
   rpmsg_port_post(&queue->ready.sem);
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_queue_merge_buffers
+ ****************************************************************************/
+
+uint16_t
+rpmsg_port_queue_merge_buffers(FAR struct rpmsg_port_queue_s *queue,
+                               FAR struct rpmsg_port_header_s *hdr)
+{
+  FAR struct rpmsg_port_header_s *next;
+  FAR struct list_node *node;
+  irqstate_t flags;
+  uint16_t count = 0;
+  uint16_t off;
+  uint16_t len;
+
+  for (; ; )
+    {
+      off = sizeof(struct rpmsg_port_header_s) +
+            ALIGN_UP(hdr->len - sizeof(struct rpmsg_port_header_s),
+                     RPMSG_PORT_MSG_ALIGN);
+
+      /* Producers only add to the tail, so the head stays the same until
+       * it is removed here.
+       */
+
+      flags = spin_lock_irqsave(&queue->ready.lock);
+      node = list_peek_head(&queue->ready.head);
+      if (node == NULL)
+        {
+          spin_unlock_irqrestore(&queue->ready.lock, flags);
+          break;
+        }
+
+      next = RPMSG_PORT_NODE_TO_BUF(queue, node);
+      len = next->len - sizeof(struct rpmsg_port_header_s);
+      if (off + len > queue->len)
+        {
+          spin_unlock_irqrestore(&queue->ready.lock, flags);
+          break;
+        }
+
+      list_delete(node);
+      queue->ready.num--;
+      spin_unlock_irqrestore(&queue->ready.lock, flags);
+
+      memcpy((FAR uint8_t *)hdr + off, next->buf, len);
+      hdr->len = off + len;
+      rpmsg_port_queue_return_buffer(queue, next);
+      count++;
+    }
+
+  return count;
+}
+
 /****************************************************************************
  * Name: rpmsg_port_register
  ****************************************************************************/
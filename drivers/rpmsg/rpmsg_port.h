@@ -35,6 +35,16 @@
 #include <nuttx/rpmsg/rpmsg.h>
 #include <nuttx/rpmsg/rpmsg_port.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A data frame may carry several rpmsg messages back to back, each of them
+ * starting at this alignment from the payload of the frame.
+ */
+
+#define RPMSG_PORT_MSG_ALIGN      8
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -218,6 +228,30 @@ rpmsg_port_queue_get_buffer(FAR struct rpmsg_port_queue_s *queue,
 void rpmsg_port_queue_add_buffer(FAR struct rpmsg_port_queue_s *queue,
                                  FAR struct rpmsg_port_header_s *hdr);
 
+/****************************************************************************
+ * Name: rpmsg_port_queue_merge_buffers
+ *
+ * Description:
+ *   Append the messages of the following buffers of the ready list of the
+ *   queue to the data frame 'hdr', which was just taken from it, as long as
+ *   they fit into one buffer, and return their buffers to the free list.
+ *   The receiver splits the frame again in the rx callback of the port, so
+ *   that several small messages take one transfer and one buffer of the
+ *   peer.  Only the single consumer of the ready list may call this.
+ *
+ * Input Parameters:
+ *   queue - The queue 'hdr' was taken from.
+ *   hdr   - Pointer to the data frame to be extended.
+ *
+ * Returned Value:
+ *   Number of messages appended to the frame.
+ *
+ ****************************************************************************/
+
+uint16_t
+rpmsg_port_queue_merge_buffers(FAR struct rpmsg_port_queue_s *queue,
+                               FAR struct rpmsg_port_header_s *hdr);
+
 /****************************************************************************
  * Name: rpmsg_port_queue_navail
  *
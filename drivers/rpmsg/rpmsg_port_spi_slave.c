@@ -186,6 +186,10 @@ static void rpmsg_port_spi_exchange(FAR struct rpmsg_port_spi_s *rpspi)
       txhdr = rpmsg_port_queue_get_buffer(&rpspi->port.txq, false);
       DEBUGASSERT(txhdr != NULL);
 
+#ifdef CONFIG_RPMSG_PORT_SPI_AGGREGATE
+      rpmsg_port_queue_merge_buffers(&rpspi->port.txq, txhdr);
+#endif
+
       txhdr->cmd = RPMSG_PORT_SPI_CMD_DATA;
       rpspi->txhdr = txhdr;
     }
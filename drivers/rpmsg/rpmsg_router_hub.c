@@ -29,10 +29,15 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdbool.h>
+#include <fcntl.h>
+#include <inttypes.h>
 #include <sys/param.h>
+#include <sys/stat.h>
 
 #include <nuttx/mutex.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/list.h>
+#include <nuttx/fs/procfs.h>
 #include <rpmsg/rpmsg_internal.h>
 
 #include "rpmsg_router.h"
@@ -61,6 +66,71 @@ struct rpmsg_router_hub_s
   mutex_t               lock;
 };
 
+/* A route between the two edges.  ept[0] (r:dst_cpu:name) talks to the
+ * source edge core, ept[1] (r:src_cpu:name) to the dest edge core, and the
+ * statistics are indexed by the endpoint the messages are received by.
+ */
+
+struct rpmsg_router_route_s
+{
+  struct rpmsg_endpoint ept[2];
+#ifdef CONFIG_RPMSG_ROUTER_PROCFS
+  struct list_node      node;       /* Entry of g_rpmsg_router_routes */
+  uint32_t              nmsgs[2];   /* Messages forwarded */
+  uint64_t              nbytes[2];  /* Bytes forwarded */
+  uint32_t              nstalls[2]; /* Waits for a tx buffer */
+  uint32_t              nerrors[2]; /* Messages that failed */
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_RPMSG_ROUTER_PROCFS
+static int rpmsg_router_procfs_open(FAR struct file *filep,
+                                    FAR const char *relpath,
+                                    int oflags, mode_t mode);
+static int rpmsg_router_procfs_close(FAR struct file *filep);
+static ssize_t rpmsg_router_procfs_read(FAR struct file *filep,
+                                        FAR char *buffer, size_t buflen);
+static int rpmsg_router_procfs_dup(FAR const struct file *oldp,
+                                   FAR struct file *newp);
+static int rpmsg_router_procfs_stat(FAR const char *relpath,
+                                    FAR struct stat *buf);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_RPMSG_ROUTER_PROCFS
+static const struct procfs_operations g_rpmsg_router_procfs_ops =
+{
+  rpmsg_router_procfs_open,  /* open */
+  rpmsg_router_procfs_close, /* close */
+  rpmsg_router_procfs_read,  /* read */
+  NULL,                      /* write */
+  NULL,                      /* poll */
+  rpmsg_router_procfs_dup,   /* dup */
+  NULL,                      /* opendir */
+  NULL,                      /* closedir */
+  NULL,                      /* readdir */
+  NULL,                      /* rewinddir */
+  rpmsg_router_procfs_stat   /* stat */
+};
+
+static const struct procfs_entry_s g_rpmsg_router_procfs =
+{
+  "rpmsg_router",
+  &g_rpmsg_router_procfs_ops
+};
+
+static struct list_node g_rpmsg_router_routes =
+  LIST_INITIAL_VALUE(g_rpmsg_router_routes);
+static mutex_t g_rpmsg_router_lock = NXMUTEX_INITIALIZER;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -78,7 +148,7 @@ struct rpmsg_router_hub_s
  *   data - received data
  *   len - received data length
  *   src - source address
- *   priv - save dest edge core rpmsg_endpoint (r:src_cpu:name)
+ *   priv - the route the endpoint belongs to
  *
  * Returned Values:
  *   Returns number of bytes it has sent or negative error value on failure.
@@ -89,16 +159,34 @@ static int rpmsg_router_hub_cb(FAR struct rpmsg_endpoint *ept,
                                FAR void *data, size_t len,
                                uint32_t src, FAR void *priv)
 {
-  FAR struct rpmsg_endpoint *dst_ept = priv;
+  FAR struct rpmsg_router_route_s *route = priv;
+  int i = ept == &route->ept[0] ? 0 : 1;
+  int ret;
 
-  /* Retransmit data to dest edge core */
+  /* Retransmit data to the other edge core */
 
-  if (!dst_ept)
+#ifdef CONFIG_RPMSG_ROUTER_PROCFS
+  ret = rpmsg_trysend(&route->ept[1 - i], data, len);
+  if (ret == RPMSG_ERR_NO_BUFF)
     {
-      return -EINVAL;
+      route->nstalls[i]++;
+      ret = rpmsg_send(&route->ept[1 - i], data, len);
+    }
+
+  if (ret < 0)
+    {
+      route->nerrors[i]++;
     }
+  else
+    {
+      route->nmsgs[i]++;
+      route->nbytes[i] += len;
+    }
+#else
+  ret = rpmsg_send(&route->ept[1 - i], data, len);
+#endif
 
-  return rpmsg_send(dst_ept, data, len);
+  return ret;
 }
 
 /****************************************************************************
@@ -114,20 +202,24 @@ static int rpmsg_router_hub_cb(FAR struct rpmsg_endpoint *ept,
 
 static void rpmsg_router_hub_unbind(FAR struct rpmsg_endpoint *ept)
 {
-  FAR struct rpmsg_endpoint *dst_ept = ept->priv;
+  FAR struct rpmsg_router_route_s *route = ept->priv;
+  int i = ept == &route->ept[0] ? 0 : 1;
 
-  /* Destroy dest edge ept firstly */
+  /* Destroy the ept of the other edge firstly */
 
-  if (dst_ept)
-    {
-      rpmsg_destroy_ept(dst_ept);
-      kmm_free(dst_ept);
-    }
+  rpmsg_destroy_ept(&route->ept[1 - i]);
 
-  /* Destroy source edge ept */
+  /* Destroy the ept of this edge */
 
   rpmsg_destroy_ept(ept);
-  kmm_free(ept);
+
+#ifdef CONFIG_RPMSG_ROUTER_PROCFS
+  nxmutex_lock(&g_rpmsg_router_lock);
+  list_delete(&route->node);
+  nxmutex_unlock(&g_rpmsg_router_lock);
+#endif
+
+  kmm_free(route);
 }
 
 /****************************************************************************
@@ -145,7 +237,8 @@ static void rpmsg_router_hub_unbind(FAR struct rpmsg_endpoint *ept)
 
 static void rpmsg_router_hub_bound(FAR struct rpmsg_endpoint *ept)
 {
-  FAR struct rpmsg_endpoint *src_ept = ept->priv;
+  FAR struct rpmsg_router_route_s *route = ept->priv;
+  FAR struct rpmsg_endpoint *src_ept = &route->ept[0];
   int ret;
 
   /* Create endpoint (r:dst_cpu:name) and send ACK to source edge core */
@@ -229,6 +322,7 @@ static void rpmsg_router_hub_bind(FAR struct rpmsg_device *rdev,
                                   uint32_t dest)
 {
   FAR struct rpmsg_router_hub_s *hub = priv;
+  FAR struct rpmsg_router_route_s *route;
   FAR struct rpmsg_endpoint *src_ept;
   FAR struct rpmsg_endpoint *dst_ept;
   FAR struct rpmsg_device *dst_rdev;
@@ -265,21 +359,22 @@ static void rpmsg_router_hub_bind(FAR struct rpmsg_device *rdev,
            name + RPMSG_ROUTER_NAME_PREFIX_LEN +
            strlen(hub->cpuname[1 - i]));
 
-  src_ept = kmm_zalloc(sizeof(*src_ept));
-  dst_ept = kmm_zalloc(sizeof(*dst_ept));
+  route = kmm_zalloc(sizeof(*route));
+  DEBUGASSERT(route);
 
-  DEBUGASSERT(src_ept && dst_ept);
+  src_ept = &route->ept[0];
+  dst_ept = &route->ept[1];
 
   /* Save information for the ept(r:dst_cpu:name) of the source cpu */
 
-  src_ept->priv = dst_ept;
+  src_ept->priv = route;
   src_ept->rdev = rdev;
   src_ept->dest_addr = dest;
   strlcpy(src_ept->name, name, sizeof(src_ept->name));
 
   /* Create endpoint (r:src_cpu:name) to another dest cpu */
 
-  dst_ept->priv = src_ept;
+  dst_ept->priv = route;
   dst_ept->ns_bound_cb = rpmsg_router_hub_bound;
   ret = rpmsg_create_ept(dst_ept, dst_rdev, dst_name,
                          RPMSG_ADDR_ANY, RPMSG_ADDR_ANY,
@@ -287,9 +382,21 @@ static void rpmsg_router_hub_bind(FAR struct rpmsg_device *rdev,
                          rpmsg_router_hub_unbind);
   if (ret < 0)
     {
-      kmm_free(dst_ept);
-      kmm_free(src_ept);
+      kmm_free(route);
+    }
+#ifdef CONFIG_RPMSG_ROUTER_PROCFS
+  else
+    {
+      nxmutex_lock(&g_rpmsg_router_lock);
+      if (list_is_empty(&g_rpmsg_router_routes))
+        {
+          procfs_register(&g_rpmsg_router_procfs);
+        }
+
+      list_add_tail(&g_rpmsg_router_routes, &route->node);
+      nxmutex_unlock(&g_rpmsg_router_lock);
     }
+#endif
 
   nxmutex_unlock(&hub->lock);
 }
@@ -418,6 +525,112 @@ static void rpmsg_router_destroy(FAR struct rpmsg_device *rdev,
     }
 }
 
+#ifdef CONFIG_RPMSG_ROUTER_PROCFS
+/****************************************************************************
+ * Name: rpmsg_router_procfs_open
+ ****************************************************************************/
+
+static int rpmsg_router_procfs_open(FAR struct file *filep,
+                                    FAR const char *relpath,
+                                    int oflags, mode_t mode)
+{
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      return -EACCES;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: rpmsg_router_procfs_close
+ ****************************************************************************/
+
+static int rpmsg_router_procfs_close(FAR struct file *filep)
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: rpmsg_router_procfs_read
+ *
+ * Description:
+ *   Show one line for each direction of each route, with the edge cores
+ *   the messages come from and go to and the name of the service.
+ *
+ ****************************************************************************/
+
+static ssize_t rpmsg_router_procfs_read(FAR struct file *filep,
+                                        FAR char *buffer, size_t buflen)
+{
+  FAR struct rpmsg_router_route_s *route;
+  off_t offset = filep->f_pos;
+  int i;
+
+  procfs_sprintf(buffer, buflen, &offset,
+                 "%-8s %-8s %-24s %10s %12s %10s %10s\n",
+                 "SRC", "DST", "NAME", "MSGS", "BYTES", "STALLS", "ERRORS");
+
+  nxmutex_lock(&g_rpmsg_router_lock);
+
+  list_for_every_entry(&g_rpmsg_router_routes, route,
+                       struct rpmsg_router_route_s, node)
+    {
+      FAR const char *name = route->ept[0].name +
+                             RPMSG_ROUTER_NAME_PREFIX_LEN +
+                             strlen(rpmsg_get_cpuname(route->ept[1].rdev));
+
+      for (i = 0; i < 2; i++)
+        {
+          procfs_sprintf(buffer, buflen, &offset,
+                         "%-8s %-8s %-24s %10" PRIu32 " %12" PRIu64
+                         " %10" PRIu32 " %10" PRIu32 "\n",
+                         rpmsg_get_cpuname(route->ept[i].rdev),
+                         rpmsg_get_cpuname(route->ept[1 - i].rdev),
+                         name, route->nmsgs[i], route->nbytes[i],
+                         route->nstalls[i], route->nerrors[i]);
+        }
+    }
+
+  nxmutex_unlock(&g_rpmsg_router_lock);
+
+  if (offset < 0)
+    {
+      offset = -offset;
+    }
+  else
+    {
+      offset = 0;
+    }
+
+  filep->f_pos += offset;
+  return offset;
+}
+
+/****************************************************************************
+ * Name: rpmsg_router_procfs_dup
+ ****************************************************************************/
+
+static int rpmsg_router_procfs_dup(FAR const struct file *oldp,
+                                   FAR struct file *newp)
+{
+  newp->f_priv = oldp->f_priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: rpmsg_router_procfs_stat
+ ****************************************************************************/
+
+static int rpmsg_router_procfs_stat(FAR const char *relpath,
+                                    FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
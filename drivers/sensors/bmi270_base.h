@@ -203,6 +203,18 @@
 #define GYRO_RANGE_250          (0x03)
 #define GYRO_RANGE_125          (0x04)
 
+/* Register 0x48 - FIFO_CONFIG_0 */
+
+#define FIFOCONFIG0_STOP_ON_FULL (1 << 0)
+#define FIFOCONFIG0_TIME_EN     (1 << 1)
+
+/* Register 0x49 - FIFO_CONFIG_1 */
+
+#define FIFOCONFIG1_HEADER_EN   (1 << 4)
+#define FIFOCONFIG1_AUX_EN      (1 << 5)
+#define FIFOCONFIG1_ACC_EN      (1 << 6)
+#define FIFOCONFIG1_GYR_EN      (1 << 7)
+
 /* Register 0x7d - PWR_CONF */
 
 #define PWRCONF_APS_ON          (1 << 0)
@@ -218,6 +230,7 @@
 
 /* Register 0x7e - CMD */
 
+#define CMD_FIFO_FLUSH          (0xB0)
 #define CMD_SOFTRESET           (0xB6)
 
 /****************************************************************************
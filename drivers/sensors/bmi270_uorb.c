@@ -49,6 +49,17 @@
 
 #define CONSTANTS_ONE_G 9.8f
 
+#ifdef CONFIG_SENSORS_BMI270_FIFO
+/* A headerless FIFO frame holds the gyro sample, then the accel one */
+
+#  define BMI270_FIFO_FRAME     12
+#  define BMI270_FIFO_NFRAMES   CONFIG_SENSORS_BMI270_FIFO_NFRAMES
+
+/* The output data rate set by bmi270_set_normal_imu() is 100Hz */
+
+#  define BMI270_FIFO_INTERVAL  10000
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -69,6 +80,9 @@ struct bmi270_sensor_s
   bool                       enabled;
 #ifdef CONFIG_SENSORS_BMI270_POLL
   uint32_t                   interval;
+#endif
+#ifdef CONFIG_SENSORS_BMI270_FIFO
+  uint32_t                   latency;
 #endif
   struct bmi270_dev_s        base;
 };
@@ -80,6 +94,15 @@ struct bmi270_sensor_dev_s
 #ifdef CONFIG_SENSORS_BMI270_POLL
   sem_t                  run;
 #endif
+#ifdef CONFIG_SENSORS_BMI270_FIFO
+  uint32_t               latency; /* The batch latency of the FIFO */
+  int16_t                fifo[BMI270_FIFO_NFRAMES * BMI270_FIFO_FRAME / 2];
+  union
+  {
+    struct sensor_accel  accel[BMI270_FIFO_NFRAMES];
+    struct sensor_gyro   gyro[BMI270_FIFO_NFRAMES];
+  } events;
+#endif
 };
 
 /****************************************************************************
@@ -94,6 +117,11 @@ static int bmi270_activate(FAR struct sensor_lowerhalf_s *lower,
 static int bmi270_set_interval(FAR struct sensor_lowerhalf_s *lower,
                                FAR struct file *filep,
                                FAR uint32_t *period_us);
+#ifdef CONFIG_SENSORS_BMI270_FIFO
+static int bmi270_batch(FAR struct sensor_lowerhalf_s *lower,
+                        FAR struct file *filep,
+                        FAR uint32_t *latency_us);
+#endif
 #ifndef CONFIG_SENSORS_BMI270_POLL
 static int bmi270_fetch(FAR struct sensor_lowerhalf_s *lower,
                         FAR struct file *filep,
@@ -120,7 +148,11 @@ static const struct sensor_ops_s g_sensor_ops =
   NULL,                 /* close */
   bmi270_activate,
   bmi270_set_interval,
+#ifdef CONFIG_SENSORS_BMI270_FIFO
+  bmi270_batch,
+#else
   NULL,                 /* batch */
+#endif
 #ifdef CONFIG_SENSORS_BMI270_POLL
   NULL,                 /* fetch */
 #else
@@ -183,6 +215,12 @@ static int bmi270_activate(FAR struct sensor_lowerhalf_s *lower,
 
       bmi270_set_normal_imu(&priv->base);
 
+#ifdef CONFIG_SENSORS_BMI270_FIFO
+      /* Drop the samples left from the last activation */
+
+      bmi270_putreg8(&priv->base, BMI270_CMD, CMD_FIFO_FLUSH);
+#endif
+
 #ifdef CONFIG_SENSORS_BMI270_POLL
       priv->last_update = sensor_get_timestamp();
 
@@ -222,6 +260,88 @@ static int bmi270_set_interval(FAR struct sensor_lowerhalf_s *lower,
   return OK;
 }
 
+#ifdef CONFIG_SENSORS_BMI270_FIFO
+/****************************************************************************
+ * Name: bmi270_fifo_config
+ *
+ * Description:
+ *   Enable the FIFO with the watermark of the smallest batch latency of the
+ *   accel and gyro, or disable it if neither is batched.
+ *
+ ****************************************************************************/
+
+static void bmi270_fifo_config(FAR struct bmi270_sensor_dev_s *dev)
+{
+  FAR struct bmi270_sensor_s *accel = &dev->priv[BMI270_ACCEL_IDX];
+  FAR struct bmi270_sensor_s *gyro  = &dev->priv[BMI270_GYRO_IDX];
+  uint32_t                    latency;
+  uint16_t                    wtm;
+
+  latency = MAX(accel->latency, gyro->latency);
+  if (accel->latency > 0 && gyro->latency > 0)
+    {
+      latency = MIN(accel->latency, gyro->latency);
+    }
+
+  if (latency == dev->latency)
+    {
+      return;
+    }
+
+  if (latency > 0)
+    {
+      /* Stream mode, headerless frames of both sensors.  Nothing is wired
+       * to the watermark interrupt yet, the thread reads the FIFO every
+       * latency, but a board can map it with INT_MAP_DATA.
+       */
+
+      wtm = latency / BMI270_FIFO_INTERVAL * BMI270_FIFO_FRAME;
+      bmi270_putreg8(&gyro->base, BMI270_FIFO_WTM_0, wtm & 0xff);
+      bmi270_putreg8(&gyro->base, BMI270_FIFO_WTM_1, wtm >> 8);
+      bmi270_putreg8(&gyro->base, BMI270_FIFO_CONFIG_0, 0);
+      bmi270_putreg8(&gyro->base, BMI270_FIFO_CONFIG_1,
+                     FIFOCONFIG1_ACC_EN | FIFOCONFIG1_GYR_EN);
+    }
+  else
+    {
+      bmi270_putreg8(&gyro->base, BMI270_FIFO_CONFIG_1, 0);
+    }
+
+  bmi270_putreg8(&gyro->base, BMI270_CMD, CMD_FIFO_FLUSH);
+  dev->latency = latency;
+}
+
+/****************************************************************************
+ * Name: bmi270_batch
+ ****************************************************************************/
+
+static int bmi270_batch(FAR struct sensor_lowerhalf_s *lower,
+                        FAR struct file *filep,
+                        FAR uint32_t *latency_us)
+{
+  FAR struct bmi270_sensor_s     *priv = (FAR struct bmi270_sensor_s *)lower;
+  FAR struct bmi270_sensor_dev_s *dev  = priv->dev;
+
+  /* The batch can not hold more than BMI270_FIFO_NFRAMES samples */
+
+  if (*latency_us > BMI270_FIFO_INTERVAL * BMI270_FIFO_NFRAMES)
+    {
+      *latency_us = BMI270_FIFO_INTERVAL * BMI270_FIFO_NFRAMES;
+    }
+  else if (*latency_us > 0 && *latency_us < BMI270_FIFO_INTERVAL)
+    {
+      *latency_us = BMI270_FIFO_INTERVAL;
+    }
+
+  nxmutex_lock(&dev->lock);
+  priv->latency = *latency_us;
+  bmi270_fifo_config(dev);
+  nxmutex_unlock(&dev->lock);
+
+  return OK;
+}
+#endif
+
 #ifndef CONFIG_SENSORS_BMI270_POLL
 /****************************************************************************
  * Name: bmi270_fetch
@@ -490,6 +610,73 @@ static void bmi270_gyro_data(FAR struct bmi270_sensor_s *priv,
   lower->push_event(lower->priv, &gyro, sizeof(gyro));
 }
 
+#ifdef CONFIG_SENSORS_BMI270_FIFO
+/****************************************************************************
+ * Name: bmi270_fifo_read
+ *
+ * Description:
+ *   Read all the frames in the FIFO and push the samples of each enabled
+ *   sensor as one batch, the last one taken now.
+ *
+ ****************************************************************************/
+
+static void bmi270_fifo_read(FAR struct bmi270_sensor_dev_s *dev)
+{
+  FAR struct bmi270_sensor_s *accel = &dev->priv[BMI270_ACCEL_IDX];
+  FAR struct bmi270_sensor_s *gyro  = &dev->priv[BMI270_GYRO_IDX];
+  FAR int16_t                *frame;
+  uint8_t                     len[2];
+  uint64_t                    now;
+  size_t                      nframes;
+  size_t                      i;
+
+  bmi270_getregs(&gyro->base, BMI270_FIFO_LENGTH_0, len, 2);
+  now = sensor_get_timestamp();
+
+  nframes = (((len[1] & 0x3f) << 8) | len[0]) / BMI270_FIFO_FRAME;
+  nframes = MIN(nframes, BMI270_FIFO_NFRAMES);
+  if (nframes == 0)
+    {
+      return;
+    }
+
+  bmi270_getregs(&gyro->base, BMI270_FIFO_DATA, (FAR uint8_t *)dev->fifo,
+                 nframes * BMI270_FIFO_FRAME);
+
+  if (gyro->enabled)
+    {
+      for (i = 0; i < nframes; i++)
+        {
+          frame = &dev->fifo[i * BMI270_FIFO_FRAME / 2];
+          dev->events.gyro[i].x           = frame[0] * gyro->scale;
+          dev->events.gyro[i].y           = frame[1] * gyro->scale;
+          dev->events.gyro[i].z           = frame[2] * gyro->scale;
+          dev->events.gyro[i].temperature = 0;
+        }
+
+      sensor_push_batch(&gyro->lower, dev->events.gyro,
+                        sizeof(struct sensor_gyro), nframes, now,
+                        BMI270_FIFO_INTERVAL);
+    }
+
+  if (accel->enabled)
+    {
+      for (i = 0; i < nframes; i++)
+        {
+          frame = &dev->fifo[i * BMI270_FIFO_FRAME / 2 + 3];
+          dev->events.accel[i].x           = frame[0] * accel->scale;
+          dev->events.accel[i].y           = frame[1] * accel->scale;
+          dev->events.accel[i].z           = frame[2] * accel->scale;
+          dev->events.accel[i].temperature = 0;
+        }
+
+      sensor_push_batch(&accel->lower, dev->events.accel,
+                        sizeof(struct sensor_accel), nframes, now,
+                        BMI270_FIFO_INTERVAL);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: bmi270_thread
  *
@@ -526,6 +713,17 @@ static int bmi270_thread(int argc, FAR char **argv)
             }
         }
 
+#ifdef CONFIG_SENSORS_BMI270_FIFO
+      if (dev->latency > 0)
+        {
+          /* Sleep for the batch latency and push all samples at once */
+
+          nxsig_usleep(dev->latency);
+          bmi270_fifo_read(dev);
+          continue;
+        }
+#endif
+
       /* Get data */
 
       bmi270_getregs(&gyro->base, BMI270_DATA_8, (FAR uint8_t *)data, 12);
@@ -614,7 +812,11 @@ int bmi270_register_uorb(int devno, FAR struct spi_dev_s *spi)
 #endif
   tmp->lower.ops     = &g_sensor_ops;
   tmp->lower.type    = SENSOR_TYPE_ACCELEROMETER;
+#ifdef CONFIG_SENSORS_BMI270_FIFO
+  tmp->lower.nbuffer = BMI270_FIFO_NFRAMES;
+#else
   tmp->lower.nbuffer = 1;
+#endif
 #ifdef CONFIG_SENSORS_BMI270_POLL
   tmp->enabled       = false;
   tmp->interval      = CONFIG_SENSORS_BMI270_POLL_INTERVAL;
@@ -639,7 +841,11 @@ int bmi270_register_uorb(int devno, FAR struct spi_dev_s *spi)
 #endif
   tmp->lower.ops     = &g_sensor_ops;
   tmp->lower.type    = SENSOR_TYPE_GYROSCOPE;
+#ifdef CONFIG_SENSORS_BMI270_FIFO
+  tmp->lower.nbuffer = BMI270_FIFO_NFRAMES;
+#else
   tmp->lower.nbuffer = 1;
+#endif
 #ifdef CONFIG_SENSORS_BMI270_POLL
   tmp->enabled       = false;
   tmp->interval      = CONFIG_SENSORS_BMI270_POLL_INTERVAL;
@@ -34,10 +34,13 @@
 
 #include <poll.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <nuttx/list.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/circbuf.h>
 #include <nuttx/mutex.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/map.h>
 #include <nuttx/sensors/sensor.h>
 #include <nuttx/lib/lib.h>
 
@@ -118,6 +121,9 @@ struct sensor_upperhalf_s
   struct sensor_state_s          state;  /* The state of sensor device */
   struct circbuf_s   timing;             /* The circular buffer of generation */
   struct circbuf_s   buffer;             /* The circular buffer of data */
+#ifdef CONFIG_SENSORS_MMAP
+  FAR struct sensor_ring_s *ring;        /* The head of the mapped buffer */
+#endif
   rmutex_t           lock;               /* Manages exclusive access to file operations */
   struct list_node   userlist;           /* List of users */
 };
@@ -136,6 +142,10 @@ static ssize_t sensor_write(FAR struct file *filep, FAR const char *buffer,
                             size_t buflen);
 static int     sensor_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
+#ifdef CONFIG_SENSORS_MMAP
+static int     sensor_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
@@ -222,7 +232,11 @@ static const struct file_operations g_sensor_fops =
   sensor_write,   /* write */
   NULL,           /* seek  */
   sensor_ioctl,   /* ioctl */
+#ifdef CONFIG_SENSORS_MMAP
+  sensor_mmap,    /* mmap */
+#else
   NULL,           /* mmap */
+#endif
   NULL,           /* truncate */
   sensor_poll     /* poll  */
 };
@@ -1080,11 +1094,118 @@ errout:
   return ret;
 }
 
+static int sensor_buffer_init(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  size_t bytes = lower->nbuffer * upper->state.esize;
+  FAR void *base = NULL;
+  int ret;
+
+#ifdef CONFIG_SENSORS_MMAP
+  /* The events follow the ring head, so both are mapped at once */
+
+  upper->ring = kmm_zalloc(sizeof(struct sensor_ring_s) + bytes);
+  if (upper->ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->ring->esize   = upper->state.esize;
+  upper->ring->nbuffer = lower->nbuffer;
+  base = upper->ring + 1;
+#endif
+
+  ret = circbuf_init(&upper->buffer, base, bytes);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
+                     TIMING_BUF_ESIZE);
+  if (ret < 0)
+    {
+      circbuf_uninit(&upper->buffer);
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+#ifdef CONFIG_SENSORS_MMAP
+  kmm_free(upper->ring);
+  upper->ring = NULL;
+#endif
+  return ret;
+}
+
+#ifdef CONFIG_SENSORS_MMAP
+#ifdef CONFIG_BUILD_KERNEL
+static int sensor_munmap(FAR struct task_group_s *group,
+                         FAR struct mm_map_entry_s *entry,
+                         FAR void *start, size_t length)
+{
+  if (group && entry)
+    {
+      vm_unmap_region(entry->vaddr, entry->length);
+      mm_map_remove(get_current_mm(), entry);
+    }
+
+  return OK;
+}
+#endif
+
+static int sensor_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  size_t length;
+  int ret = OK;
+
+  /* The ring is only written by the publishers through the upper half */
+
+  if ((map->prot & PROT_WRITE) != 0)
+    {
+      return -EACCES;
+    }
+
+  nxrmutex_lock(&upper->lock);
+  if (!circbuf_is_init(&upper->buffer))
+    {
+      ret = sensor_buffer_init(upper);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  length = sizeof(struct sensor_ring_s) + upper->buffer.size;
+  if (map->offset != 0 || map->length == 0 || map->length > length)
+    {
+      ret = -EINVAL;
+      goto out;
+    }
+
+#ifdef CONFIG_BUILD_KERNEL
+  map->vaddr  = vm_map_region((uintptr_t)upper->ring, length);
+  map->length = length;
+  map->munmap = sensor_munmap;
+  mm_map_add(get_current_mm(), map);
+#else
+  map->vaddr  = upper->ring;
+#endif
+
+out:
+  nxrmutex_unlock(&upper->lock);
+  return ret;
+}
+#endif
+
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes)
 {
   FAR struct sensor_upperhalf_s *upper = priv;
-  FAR struct sensor_lowerhalf_s *lower = upper->lower;
   FAR struct sensor_user_s *user;
   unsigned long envcount;
   int semcount;
@@ -1119,25 +1240,28 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
     {
       /* Initialize sensor buffer when data is first generated */
 
-      ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
-                         upper->state.esize);
-      if (ret < 0)
-        {
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
-
-      ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
-                         TIMING_BUF_ESIZE);
+      ret = sensor_buffer_init(upper);
       if (ret < 0)
         {
-          circbuf_uninit(&upper->buffer);
           nxrmutex_unlock(&upper->lock);
           return ret;
         }
     }
 
+#ifdef CONFIG_SENSORS_MMAP
+  /* Tell the mapped subscribers which events are being overwritten */
+
+  upper->ring->pending += envcount;
+  SP_DMB();
+#endif
+
   circbuf_overwrite(&upper->buffer, data, bytes);
+
+#ifdef CONFIG_SENSORS_MMAP
+  SP_DMB();
+  upper->ring->generation += envcount;
+#endif
+
   sensor_generate_timing(upper, envcount);
   list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
     {
@@ -1212,6 +1336,51 @@ void sensor_remap_vector_raw16(FAR const int16_t *in, FAR int16_t *out,
   memcpy(out, tmp, sizeof(tmp));
 }
 
+/****************************************************************************
+ * Name: sensor_push_batch
+ *
+ * Description:
+ *   This function pushes the samples that a lower half driver read out of
+ *   the hardware fifo at once to the upper half.  The samples are taken at
+ *   a constant rate, so only the time of the last one is known, the
+ *   timestamps of the others are interpolated back from it.  The readers
+ *   are woken up once for the whole batch instead of once per sample.
+ *
+ * Input Parameters:
+ *   lower     - A pointer to an instance of lower half sensor driver.
+ *   data      - The samples, each starting with its uint64_t timestamp.
+ *   esize     - The size of one sample.
+ *   nevents   - The number of samples, the oldest first.
+ *   timestamp - The time of the last sample in microseconds.
+ *   interval  - The time between two samples in microseconds.
+ *
+ * Returned Value:
+ *   The number of bytes pushed; A negated errno value is returned on any
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t sensor_push_batch(FAR struct sensor_lowerhalf_s *lower,
+                          FAR void *data, size_t esize, size_t nevents,
+                          uint64_t timestamp, uint32_t interval)
+{
+  FAR uint8_t *event = data;
+  size_t i;
+
+  if (nevents == 0)
+    {
+      return 0;
+    }
+
+  for (i = 0; i < nevents; i++, event += esize)
+    {
+      *(FAR uint64_t *)event = timestamp -
+                               (uint64_t)(nevents - 1 - i) * interval;
+    }
+
+  return lower->push_event(lower->priv, data, esize * nevents);
+}
+
 /****************************************************************************
  * Name: sensor_register
  *
@@ -1443,5 +1612,9 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *lower,
       circbuf_uninit(&upper->timing);
     }
 
+#ifdef CONFIG_SENSORS_MMAP
+  kmm_free(upper->ring);
+#endif
+
   kmm_free(upper);
 }
@@ -832,6 +832,7 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
   FAR struct sensor_rpmsg_ept_s *sre;
   FAR struct sensor_rpmsg_data_s *msg;
   struct sensor_ustate_s state;
+  uint32_t budget;
   uint64_t now;
   bool updated;
   int ret;
@@ -876,7 +877,15 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
         {
           if (sre->buffer)
             {
-              rpmsg_send_nocopy(&sre->ept, sre->buffer, sre->written);
+              ret = rpmsg_send_nocopy(&sre->ept, sre->buffer,
+                                      sre->written);
+              if (ret < 0)
+                {
+                  rpmsg_release_tx_buffer(&sre->ept, sre->buffer);
+                  snerr("ERROR: push event rpmsg send failed:%d, %s\n",
+                        ret, rpmsg_get_cpuname(sre->ept.rdev));
+                }
+
               sre->buffer = NULL;
             }
 
@@ -919,9 +928,13 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
     }
 
   /* If buffer timeout is expired, do rpmsg_send_nocopy, otherwise using
-   * delay work to send data.
+   * delay work to send data.  The events of all topics for the remote core
+   * share the buffer, which is sent at the latest when the batch latency
+   * of the remote subscribers runs out, or half of their interval if they
+   * do not batch.
    */
 
+  budget = state.latency > 0 ? state.latency : state.interval / 2;
   now = sensor_get_timestamp();
   if (sre->expire <= now && sre->buffer)
     {
@@ -937,10 +950,9 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
     }
   else
     {
-      if (sre->expire == UINT64_MAX ||
-          sre->expire - now > state.interval / 2)
+      if (sre->expire == UINT64_MAX || sre->expire - now > budget)
         {
-          sre->expire = now + state.interval / 2;
+          sre->expire = now + budget;
         }
 
       work_queue(HPWORK, &sre->work, sensor_rpmsg_data_worker, sre,
@@ -97,6 +97,10 @@ static int     uart_putxmitchar(FAR uart_dev_t *dev, int ch,
 static inline ssize_t uart_irqwrite(FAR uart_dev_t *dev,
                                     FAR const char *buffer,
                                     size_t buflen);
+#ifdef CONFIG_SERIAL_TXDMA_DIRECT
+static ssize_t uart_writedirect(FAR uart_dev_t *dev,
+                                FAR const char *buffer, size_t buflen);
+#endif
 static int     uart_tcdrain(FAR uart_dev_t *dev,
                             bool cancelable, clock_t timeout);
 
@@ -433,6 +437,59 @@ static inline ssize_t uart_irqwrite(FAR uart_dev_t *dev,
   return buflen;
 }
 
+/****************************************************************************
+ * Name: uart_writedirect
+ *
+ * Description:
+ *   Send the caller's buffer by DMA without copying it into the TX buffer
+ *   and wait until it is sent.  -EBUSY is returned if the TX buffer or the
+ *   DMA is still busy, the data must be queued to the TX buffer then.
+ *
+ * Assumptions:
+ *   The caller holds the xmit.lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_TXDMA_DIRECT
+static ssize_t uart_writedirect(FAR uart_dev_t *dev,
+                                FAR const char *buffer, size_t buflen)
+{
+  FAR struct uart_dmaxfer_s *xfer = &dev->dmatx;
+  ssize_t nsent;
+
+  uart_disabletxint(dev);
+  if (dev->xmit.head != dev->xmit.tail || xfer->length != 0)
+    {
+      uart_enabletxint(dev);
+      return -EBUSY;
+    }
+
+  xfer->buffer  = (FAR char *)buffer;
+  xfer->length  = buflen;
+  xfer->nbuffer = NULL;
+  xfer->nlength = 0;
+  xfer->nbytes  = 0;
+
+  uart_dmasend(dev);
+  uart_enabletxint(dev);
+
+  /* uart_xmitchars_done() clears the length when the transfer completed.
+   * The buffer belongs to the caller, so the wait can not be aborted.
+   */
+
+  while (xfer->length != 0)
+    {
+      nxsem_wait_uninterruptible(&dev->xmitsem);
+    }
+
+  nsent = xfer->nbytes;
+  xfer->nbytes = 0;
+  xfer->buffer = NULL;
+
+  return nsent > 0 ? nsent : -EIO;
+}
+#endif
+
 /****************************************************************************
  * Name: uart_tcdrain
  *
@@ -1394,6 +1451,26 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
 
   oktoblock = ((filep->f_oflags & O_NONBLOCK) == 0);
 
+#ifdef CONFIG_SERIAL_TXDMA_DIRECT
+  /* Send a large write straight from the caller's buffer if no output
+   * processing would change the data.
+   */
+
+  if (oktoblock && buflen >= CONFIG_SERIAL_TXDMA_DIRECT_MINSIZE &&
+      ((dev->tc_oflag & OPOST) == 0 ||
+       (dev->tc_oflag & (OCRNL | ONLCR | ONLRET)) == 0))
+    {
+      nwritten = uart_writedirect(dev, buffer, buflen);
+      if (nwritten != -EBUSY)
+        {
+          nxmutex_unlock(&dev->xmit.lock);
+          return nwritten;
+        }
+
+      nwritten = buflen;
+    }
+#endif
+
   /* Loop while we still have data to copy to the transmit buffer.
    * we add data to the head of the buffer; uart_xmitchars takes the
    * data from the end of the buffer.
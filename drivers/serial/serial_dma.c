@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <assert.h>
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdint.h>
 #include <debug.h>
@@ -42,8 +43,8 @@
  * Name: uart_recvchars_check_special
  *
  * Description:
- *   Check if the SIGINT character is anywhere in the newly received DMA
- *   buffer.
+ *   Check if the SIGINT character is anywhere in the bytes 'from' to 'to'
+ *   of the DMA transfer.
  *
  *   REVISIT:  We must also remove the SIGINT/SIGTSTP character from the Rx
  *   buffer.  It should not be read as normal data by the caller.
@@ -53,29 +54,53 @@
 #if defined(CONFIG_SERIAL_RXDMA) && \
    (defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
     defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH))
-static int uart_recvchars_check_special(FAR uart_dev_t *dev)
+static int uart_recvchars_check_special(FAR uart_dev_t *dev, size_t from,
+                                        size_t to)
 {
   FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
   int signo;
 
-  /* Check if the valid DMAed data is in one or two contiguous regions */
+  /* The valid DMAed data is in one or two contiguous regions */
 
-  if (xfer->nbytes <= xfer->length)
-    {
-      return uart_check_special(dev, xfer->buffer, xfer->nbytes);
-    }
-  else
+  if (from < xfer->length)
     {
-      /* REVISIT:  Additional signals could be in the second region. */
-
-      signo = uart_check_special(dev, xfer->buffer, xfer->length);
+      signo = uart_check_special(dev, xfer->buffer + from,
+                                 MIN(to, xfer->length) - from);
       if (signo != 0)
         {
           return signo;
         }
+    }
+
+  if (to > xfer->length)
+    {
+      from = MAX(from, xfer->length);
+      return uart_check_special(dev, xfer->nbuffer + from - xfer->length,
+                                to - from);
+    }
+
+  return 0;
+}
+#endif
 
-      return uart_check_special(dev, xfer->nbuffer,
-                                xfer->nbytes - xfer->length);
+/****************************************************************************
+ * Name: uart_recvchars_nbuffered
+ *
+ * Description:
+ *   Return the number of bytes in the RX circular buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+static size_t uart_recvchars_nbuffered(FAR struct uart_buffer_s *rxbuf)
+{
+  if (rxbuf->head >= rxbuf->tail)
+    {
+      return rxbuf->head - rxbuf->tail;
+    }
+  else
+    {
+      return rxbuf->size - rxbuf->tail + rxbuf->head;
     }
 }
 #endif
@@ -141,6 +166,21 @@ void uart_xmitchars_done(FAR uart_dev_t *dev)
   size_t nbytes = xfer->nbytes;
   struct uart_buffer_s *txbuf = &dev->xmit;
 
+#ifdef CONFIG_SERIAL_TXDMA_DIRECT
+  /* A transfer straight from the buffer of uart_write() leaves the TX
+   * circular buffer alone.  The writer takes the number of bytes sent, so
+   * it is woken up even if none were.
+   */
+
+  if (xfer->buffer < txbuf->buffer ||
+      xfer->buffer >= txbuf->buffer + txbuf->size)
+    {
+      xfer->length = xfer->nlength = 0;
+      uart_datasent(dev);
+      return;
+    }
+#endif
+
   /* Skip the update if the tail position change which mean
    * someone reset (e.g. TCOFLUSH) the xmit buffer during DMA.
    */
@@ -286,6 +326,7 @@ void uart_recvchars_dma(FAR uart_dev_t *dev)
       xfer->nlength = 0;
     }
 
+  xfer->nreport = 0;
   uart_dmareceive(dev);
 }
 #endif
@@ -315,33 +356,98 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
    * buffer.
    */
 
-  signo = uart_recvchars_check_special(dev);
+  if (nbytes > xfer->nreport)
+    {
+      signo = uart_recvchars_check_special(dev, xfer->nreport, nbytes);
+    }
 #endif
 
-  /* Move head for nbytes. */
+  /* Move head for the bytes not yet reported by uart_recvchars_update(). */
 
-  rxbuf->head  = (rxbuf->head + nbytes) % rxbuf->size;
-  xfer->nbytes = 0;
-  xfer->length = xfer->nlength = 0;
+  if (nbytes > xfer->nreport)
+    {
+      rxbuf->head = (rxbuf->head + nbytes - xfer->nreport) % rxbuf->size;
+    }
+
+  xfer->nbytes  = 0;
+  xfer->nreport = 0;
+  xfer->length  = xfer->nlength = 0;
 
   /* If any bytes were added to the buffer, inform any waiters there is new
    * incoming data available.
    */
 
-  if (rxbuf->head >= rxbuf->tail)
+  nbytes = uart_recvchars_nbuffered(rxbuf);
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  if (nbytes >= dev->minrecv)
+#else
+  if (nbytes)
+#endif
     {
-      nbytes = rxbuf->head - rxbuf->tail;
+      uart_datareceived(dev);
     }
-  else
+
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+  /* Send the signal if necessary */
+
+  if (signo != 0)
+    {
+      nxsig_tgkill(-1, dev->pid, signo);
+    }
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: uart_recvchars_update
+ *
+ * Description:
+ *   Report the progress of the DMA transfer set up by uart_recvchars_dma()
+ *   without ending it, from a half transfer or an idle line interrupt.  The
+ *   bytes received so far are made available to the readers, which are
+ *   woken up only once CONFIG_SERIAL_RXDMA_WAKEUP bytes are buffered or
+ *   when the line went idle.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_update(FAR uart_dev_t *dev, size_t nbytes, bool idle)
+{
+  FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+  size_t threshold = CONFIG_SERIAL_RXDMA_WAKEUP;
+  size_t minrecv = 1;
+  size_t nbuffered;
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+  int signo = 0;
+#endif
+
+  DEBUGASSERT(nbytes <= xfer->length + xfer->nlength);
+
+  if (nbytes > xfer->nreport)
     {
-      nbytes = rxbuf->size - rxbuf->tail + rxbuf->head;
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+      signo = uart_recvchars_check_special(dev, xfer->nreport, nbytes);
+#endif
+
+      /* The DMA only writes the free space, the head can simply follow */
+
+      rxbuf->head = (rxbuf->head + nbytes - xfer->nreport) % rxbuf->size;
+      xfer->nreport = nbytes;
     }
 
+  nbuffered = uart_recvchars_nbuffered(rxbuf);
+
 #ifdef CONFIG_SERIAL_TERMIOS
-  if (nbytes >= dev->minrecv)
-#else
-  if (nbytes)
+  minrecv = MAX(dev->minrecv, 1);
+  threshold = MAX(threshold, minrecv);
 #endif
+
+  if (nbuffered >= threshold || (idle && nbuffered >= minrecv))
     {
       uart_datareceived(dev);
     }
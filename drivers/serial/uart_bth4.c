@@ -27,7 +27,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/semaphore.h>
-#include <nuttx/circbuf.h>
+#include <nuttx/spscbuf.h>
 
 #include <fcntl.h>
 #include <string.h>
@@ -53,9 +53,10 @@ struct uart_bth4_s
 {
   FAR struct bt_driver_s *drv;
 
-  FAR struct circbuf_s    circbuf;
+  struct spscbuf_s        rxbuf;
 
   sem_t                   recvsem;
+  mutex_t                 recvlock;
 
   uint8_t                 sendbuf[CONFIG_UART_BTH4_TXBUFSIZE];
   size_t                  sendlen;
@@ -133,9 +134,13 @@ static int uart_bth4_receive(FAR struct bt_driver_s *drv,
   irqstate_t flags;
   uint8_t htype;
 
+  /* The critical section serializes the callers of the driver, the reader
+   * takes the data out of the buffer without it.
+   */
+
   flags = enter_critical_section();
 
-  if (circbuf_space(&dev->circbuf) >=
+  if (spscbuf_space(&dev->rxbuf) >=
       buflen + H4_HEADER_SIZE)
     {
       if (type == BT_EVT)
@@ -157,8 +162,8 @@ static int uart_bth4_receive(FAR struct bt_driver_s *drv,
 
       if (ret >= 0)
         {
-          circbuf_write(&dev->circbuf, &htype, H4_HEADER_SIZE);
-          circbuf_write(&dev->circbuf, buffer, buflen);
+          spscbuf_write(&dev->rxbuf, &htype, H4_HEADER_SIZE);
+          spscbuf_write(&dev->rxbuf, buffer, buflen);
           uart_bth4_pollnotify(dev, POLLIN);
         }
     }
@@ -236,26 +241,35 @@ static ssize_t uart_bth4_read(FAR struct file *filep,
 {
   FAR struct inode *inode = filep->f_inode;
   FAR struct uart_bth4_s *dev = inode->i_private;
-  irqstate_t flags;
   ssize_t nread;
+  int ret;
 
-  flags = enter_critical_section();
+  /* There is only one consumer of the lock-free buffer at a time, the
+   * receive callback is the producer.  A receive that completes after the
+   * buffer was found empty posts recvsem, so no wakeup is lost.
+   */
+
+  ret = nxmutex_lock(&dev->recvlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
   for (; ; )
     {
-      nread = circbuf_read(&dev->circbuf, buffer, buflen);
+      nread = spscbuf_read(&dev->rxbuf, buffer, buflen);
       if (nread != 0 || (filep->f_oflags & O_NONBLOCK))
         {
           break;
         }
 
-      while (circbuf_is_empty(&dev->circbuf))
+      while (spscbuf_is_empty(&dev->rxbuf))
         {
           nxsem_wait_uninterruptible(&dev->recvsem);
         }
     }
 
-  leave_critical_section(flags);
+  nxmutex_unlock(&dev->recvlock);
   return nread;
 }
 
@@ -269,6 +283,7 @@ static ssize_t uart_bth4_write(FAR struct file *filep,
   enum bt_buf_type_e type;
   size_t reserved;
   uint8_t *data;
+  uint8_t *pkt;
   size_t pktlen;
   size_t hdrlen;
   int ret;
@@ -289,6 +304,7 @@ static ssize_t uart_bth4_write(FAR struct file *filep,
     }
 
   data = dev->sendbuf + reserved;
+  pkt  = data - H4_HEADER_SIZE;
 
   if (dev->sendlen + buflen > CONFIG_UART_BTH4_TXBUFSIZE - reserved)
     {
@@ -300,11 +316,16 @@ static ssize_t uart_bth4_write(FAR struct file *filep,
          buffer, buflen);
   dev->sendlen += buflen;
 
-  hdr = (FAR union bt_hdr_u *)data;
+  /* The complete packets are sent from where they are in the buffer, the
+   * driver may use the sent data before them as its head room.  Only the
+   * incomplete packet at the end is moved to the start of the buffer.
+   */
 
   for (; ; )
     {
-      switch (*(data - H4_HEADER_SIZE))
+      hdr = (FAR union bt_hdr_u *)(pkt + H4_HEADER_SIZE);
+
+      switch (*pkt)
         {
           case H4_CMD:
             hdrlen = sizeof(struct bt_hci_cmd_hdr_s);
@@ -344,7 +365,7 @@ static ssize_t uart_bth4_write(FAR struct file *filep,
       /* Got the full packet, send out */
 
       ret = dev->drv->send(dev->drv, type,
-                           data, pktlen - H4_HEADER_SIZE);
+                           pkt + H4_HEADER_SIZE, pktlen - H4_HEADER_SIZE);
       if (ret < 0)
         {
           goto err;
@@ -356,13 +377,17 @@ static ssize_t uart_bth4_write(FAR struct file *filep,
           goto out;
         }
 
-      memmove(data - H4_HEADER_SIZE,
-              dev->sendbuf + pktlen, dev->sendlen);
+      pkt += pktlen;
     }
 
 err:
   dev->sendlen = 0;
 out:
+  if (dev->sendlen > 0 && pkt != data - H4_HEADER_SIZE)
+    {
+      memmove(data - H4_HEADER_SIZE, pkt, dev->sendlen);
+    }
+
   nxmutex_unlock(&dev->sendlock);
   return ret < 0 ? ret : buflen;
 }
@@ -415,7 +440,7 @@ static int uart_bth4_poll(FAR struct file *filep, FAR struct pollfd *fds,
           ret = -EBUSY;
         }
 
-      if (!circbuf_is_empty(&dev->circbuf))
+      if (!spscbuf_is_empty(&dev->rxbuf))
         {
           eventset |= POLLIN;
         }
@@ -457,8 +482,7 @@ int uart_bth4_register(FAR const char *path, FAR struct bt_driver_s *drv)
       return -ENOMEM;
     }
 
-  ret = circbuf_init(&dev->circbuf, NULL,
-                     CONFIG_UART_BTH4_RXBUFSIZE);
+  ret = spscbuf_init(&dev->rxbuf, NULL, CONFIG_UART_BTH4_RXBUFSIZE);
   if (ret < 0)
     {
       kmm_free(dev);
@@ -471,6 +495,7 @@ int uart_bth4_register(FAR const char *path, FAR struct bt_driver_s *drv)
 
   nxmutex_init(&dev->sendlock);
   nxmutex_init(&dev->openlock);
+  nxmutex_init(&dev->recvlock);
   nxsem_init(&dev->recvsem, 0, 0);
 
   ret = register_driver(path, &g_uart_bth4_ops, 0666, dev);
@@ -478,8 +503,9 @@ int uart_bth4_register(FAR const char *path, FAR struct bt_driver_s *drv)
     {
       nxmutex_destroy(&dev->sendlock);
       nxmutex_destroy(&dev->openlock);
+      nxmutex_destroy(&dev->recvlock);
       nxsem_destroy(&dev->recvsem);
-      circbuf_uninit(&dev->circbuf);
+      spscbuf_uninit(&dev->rxbuf);
       kmm_free(dev);
     }
 
@@ -0,0 +1,151 @@
+/****************************************************************************
+ * drivers/spi/spi_async.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/spi/spi_transfer.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK
+#  define SPI_ASYNC_WORK HPWORK
+#else
+#  define SPI_ASYNC_WORK LPWORK
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_queue_worker
+ *
+ * Description:
+ *   Perform the queued sequences in order, until the queue is empty.
+ *   Sequences queued meanwhile are performed in the same run.
+ *
+ ****************************************************************************/
+
+static void spi_queue_worker(FAR void *arg)
+{
+  FAR struct spi_queue_s *queue = arg;
+  FAR struct spi_async_s *req;
+  irqstate_t flags;
+  int ret;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&queue->lock);
+      req = (FAR struct spi_async_s *)sq_remfirst(&queue->pending);
+      spin_unlock_irqrestore(&queue->lock, flags);
+
+      if (req == NULL)
+        {
+          break;
+        }
+
+      ret = spi_transfer(queue->spi, req->seq);
+      req->callback(req, ret);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_queue_initialize
+ *
+ * Description:
+ *   Initialize the queue of asynchronous sequences of an SPI bus.  All
+ *   users of spi_transfer_async() on the bus should share one queue.
+ *
+ * Input Parameters:
+ *   queue - The queue to initialize
+ *   spi   - An instance of the SPI device to use for the transfers
+ *
+ ****************************************************************************/
+
+void spi_queue_initialize(FAR struct spi_queue_s *queue,
+                          FAR struct spi_dev_s *spi)
+{
+  DEBUGASSERT(queue != NULL && spi != NULL);
+
+  memset(queue, 0, sizeof(*queue));
+  queue->spi = spi;
+  sq_init(&queue->pending);
+  spin_lock_init(&queue->lock);
+}
+
+/****************************************************************************
+ * Name: spi_transfer_async
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers.  The queued sequences are performed
+ *   back to back by spi_transfer() on a work queue and req->callback is
+ *   called with the result of each.  This function does not block and may
+ *   be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   queue - The queue of the SPI bus
+ *   req   - The request, with seq and callback set
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_transfer_async(FAR struct spi_queue_s *queue,
+                       FAR struct spi_async_s *req)
+{
+  irqstate_t flags;
+  bool idle;
+
+  if (queue == NULL || req == NULL || req->seq == NULL ||
+      req->callback == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = spin_lock_irqsave(&queue->lock);
+  idle  = sq_empty(&queue->pending);
+  sq_addlast(&req->node, &queue->pending);
+  spin_unlock_irqrestore(&queue->lock, flags);
+
+  /* A running worker picks up the request itself, only kick an idle one */
+
+  if (idle && work_available(&queue->work))
+    {
+      return work_queue(SPI_ASYNC_WORK, &queue->work, spi_queue_worker,
+                        queue, 0);
+    }
+
+  return OK;
+}
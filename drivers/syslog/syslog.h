@@ -27,7 +27,10 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdarg.h>
 #include <stdbool.h>
+#include <time.h>
 
 /****************************************************************************
  * Public Data
@@ -228,6 +231,97 @@ int syslog_add_intbuffer(int ch);
 #ifdef CONFIG_SYSLOG_INTBUFFER
 int syslog_flush_intbuffer(bool force);
 #endif
+
+/****************************************************************************
+ * Name: syslog_write_channel
+ *
+ * Description:
+ *   Write a buffer to one channel, waiting for the channel as needed.  A
+ *   newline is expanded to CR-LF if the channel asks for it.
+ *
+ * Returned Value:
+ *   The number of bytes written or a negated errno value on any failure.
+ *
+ ****************************************************************************/
+
+ssize_t syslog_write_channel(FAR syslog_channel_t *channel,
+                             FAR const char *buffer, size_t buflen);
+
+/****************************************************************************
+ * Name: syslog_gettime
+ *
+ * Description:
+ *   Return the time stamp of a message, zero if time stamps are disabled
+ *   or the clock is not ready yet.
+ *
+ ****************************************************************************/
+
+void syslog_gettime(FAR struct timespec *ts);
+
+/****************************************************************************
+ * Name: syslog_prefix
+ *
+ * Description:
+ *   Output the prefix of a message, the time stamp, the CPU, the thread
+ *   and the priority as configured, to a stream.
+ *
+ * Returned Value:
+ *   The number of characters output.
+ *
+ ****************************************************************************/
+
+struct lib_outstream_s;
+int syslog_prefix(FAR struct lib_outstream_s *stream, int priority,
+                  FAR const struct timespec *ts, int cpu, pid_t pid);
+
+/****************************************************************************
+ * Name: syslog_deferred_initialize
+ *
+ * Description:
+ *   Initialize the per-CPU rings and start the thread that formats and
+ *   outputs the queued messages.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_deferred_initialize(void);
+#endif
+
+/****************************************************************************
+ * Name: syslog_deferred_vprintf
+ *
+ * Description:
+ *   Queue a message in the ring of this CPU without formatting it.
+ *
+ * Returned Value:
+ *   A non-negative value if the message was queued or dropped; a negated
+ *   errno value if it must be output at once instead.
+ *
+ * Assumptions:
+ *   May be called from any context.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_deferred_vprintf(int priority, FAR const IPTR char *fmt,
+                            FAR va_list *ap);
+#endif
+
+/****************************************************************************
+ * Name: syslog_deferred_flush
+ *
+ * Description:
+ *   Output the queued messages at once, only after a panic.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+void syslog_deferred_flush(void);
+#endif
 #endif /* CONFIG_SYSLOG */
 
 #undef EXTERN
@@ -0,0 +1,789 @@
+/****************************************************************************
+ * drivers/syslog/syslog_deferred.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/init.h>
+#include <nuttx/clock.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spscbuf.h>
+#include <nuttx/streams.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The records are aligned so that the head of each one can be accessed
+ * in place in the ring.
+ */
+
+#define SYSLOG_RECORD_ALIGN     8
+#define SYSLOG_RECORD_ALIGNUP(n) \
+  (((n) + SYSLOG_RECORD_ALIGN - 1) & ~(SYSLOG_RECORD_ALIGN - 1))
+
+/* The priority of the record that skips the rest of the ring space */
+
+#define SYSLOG_RECORD_PAD       0xff
+
+#define SYSLOG_RING_SIZE \
+  SYSLOG_RECORD_ALIGNUP(CONFIG_SYSLOG_DEFERRED_BUFSIZE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This is one message in the ring.  The format string follows the head,
+ * then the arguments, packed as lib_bsprintf() expects them.
+ */
+
+struct syslog_record_s
+{
+  uint16_t        len;          /* The size of the record, aligned */
+  uint8_t         priority;     /* The priority or SYSLOG_RECORD_PAD */
+  uint8_t         cpu;          /* The CPU that logged the message */
+  uint16_t        fmtlen;       /* The size of the format with the NUL */
+  pid_t           pid;          /* The thread that logged the message */
+  struct timespec ts;           /* The time stamp of the message */
+  char            data[0];      /* The format and the arguments */
+};
+
+/* There is one ring per CPU.  On its CPU it is only written with the
+ * interrupts disabled, so the only producer is never preempted and no
+ * other CPU takes part: the producer needs no lock and the syslog thread
+ * is the only consumer.
+ */
+
+struct syslog_ring_s
+{
+  struct spscbuf_s buf;         /* The records */
+  uint32_t         lost;        /* The messages that did not fit */
+  uint32_t         reported;    /* The lost messages reported already */
+  aligned_data(SYSLOG_RECORD_ALIGN)
+  uint8_t          space[SYSLOG_RING_SIZE];
+};
+
+/* The token bucket of a channel, the credit counts in messages times
+ * TICK_PER_SEC.
+ */
+
+struct syslog_ratelimit_s
+{
+  FAR syslog_channel_t *channel; /* The channel or NULL for a free entry */
+  unsigned int          rate;    /* The messages per second, 0 for all */
+  unsigned int          burst;   /* The messages that may come at once */
+  uint64_t              credit;  /* The messages that may come now */
+  clock_t               stamp;   /* The time the credit was updated */
+  uint32_t              dropped; /* The messages dropped since reported */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_ring_s g_syslog_ring[CONFIG_SMP_NCPUS];
+static struct syslog_ratelimit_s
+g_syslog_ratelimit[CONFIG_SYSLOG_MAX_CHANNELS];
+static sem_t g_syslog_deferred_sem = SEM_INITIALIZER(0);
+static bool g_syslog_deferred_ready;
+static bool g_syslog_deferred_panic;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_deferred_pack
+ *
+ * Description:
+ *   Pack the arguments of a format the way lib_bsprintf() reads them, or
+ *   only measure them if 'dst' is NULL.
+ *
+ * Returned Value:
+ *   The size of the packed arguments.  -ENOTSUP is returned if an argument
+ *   cannot be copied, such as a "%pV" that refers to the caller's frame or
+ *   a negative "%.*s" precision; the message must then be formatted at
+ *   once.
+ *
+ ****************************************************************************/
+
+static ssize_t syslog_deferred_pack(FAR char *dst, size_t size,
+                                    FAR const char *fmt, va_list ap)
+{
+  FAR const char *prec = NULL;
+  bool infmt = false;
+  size_t offset = 0;
+  int star = 0;
+  char c;
+
+#define SYSLOG_PACK(type, value) \
+  do \
+    { \
+      type value__ = (type)(value); \
+      if (dst != NULL && offset + sizeof(value__) <= size) \
+        { \
+          memcpy(dst + offset, &value__, sizeof(value__)); \
+        } \
+      offset += sizeof(value__); \
+    } \
+  while (0)
+
+  while ((c = *fmt++) != '\0')
+    {
+      if (c != '%' && !infmt)
+        {
+          continue;
+        }
+
+      if (!infmt && *fmt == '%')
+        {
+          fmt++;
+          continue;
+        }
+
+      if (!infmt)
+        {
+          prec = NULL;
+          infmt = true;
+        }
+
+      if (c == 'c' || c == 'd' || c == 'i' || c == 'u' ||
+          c == 'o' || c == 'x' || c == 'X')
+        {
+          if (*(fmt - 2) == 'j')
+            {
+              SYSLOG_PACK(intmax_t, va_arg(ap, intmax_t));
+            }
+#ifdef CONFIG_HAVE_LONG_LONG
+          else if (*(fmt - 2) == 'l' && *(fmt - 3) == 'l')
+            {
+              SYSLOG_PACK(long long, va_arg(ap, long long));
+            }
+#endif
+          else if (*(fmt - 2) == 'l')
+            {
+              SYSLOG_PACK(long, va_arg(ap, long));
+            }
+          else if (*(fmt - 2) == 'z')
+            {
+              SYSLOG_PACK(size_t, va_arg(ap, size_t));
+            }
+          else if (*(fmt - 2) == 't')
+            {
+              SYSLOG_PACK(ptrdiff_t, va_arg(ap, ptrdiff_t));
+            }
+          else if (*(fmt - 2) == 'h' && *(fmt - 3) == 'h')
+            {
+              SYSLOG_PACK(char, va_arg(ap, int));
+            }
+          else if (*(fmt - 2) == 'h')
+            {
+              SYSLOG_PACK(short int, va_arg(ap, int));
+            }
+          else
+            {
+              SYSLOG_PACK(int, va_arg(ap, int));
+            }
+
+          infmt = false;
+        }
+      else if (c == 'e' || c == 'f' || c == 'g' || c == 'a' ||
+               c == 'A' || c == 'E' || c == 'F' || c == 'G')
+        {
+#ifdef CONFIG_HAVE_DOUBLE
+          if (*(fmt - 2) == 'h')
+            {
+              SYSLOG_PACK(float, va_arg(ap, double));
+            }
+#  ifdef CONFIG_HAVE_LONG_DOUBLE
+          else if (*(fmt - 2) == 'L')
+            {
+              SYSLOG_PACK(long double, va_arg(ap, long double));
+            }
+#  endif
+          else
+            {
+              SYSLOG_PACK(double, va_arg(ap, double));
+            }
+
+          infmt = false;
+#endif
+        }
+      else if (c == '*')
+        {
+          star = va_arg(ap, int);
+          SYSLOG_PACK(int, star);
+        }
+      else if (c == 's')
+        {
+          FAR const char *value = va_arg(ap, FAR const char *);
+          size_t len;
+          size_t n;
+
+          if (value == NULL)
+            {
+              value = "(null)";
+            }
+
+          /* With a precision exactly that many bytes are packed, "%.*s"
+           * takes it from the argument before the string.
+           */
+
+          if (prec != NULL && *prec == '*')
+            {
+              if (star < 0)
+                {
+                  return -ENOTSUP;
+                }
+
+              len = star;
+              n   = strnlen(value, len);
+            }
+          else if (prec != NULL)
+            {
+              len = strtol(prec, NULL, 10);
+              n   = strnlen(value, len);
+            }
+          else
+            {
+              len = strlen(value) + 1;
+              n   = len;
+            }
+
+          if (dst != NULL && offset + len <= size)
+            {
+              memcpy(dst + offset, value, n);
+              memset(dst + offset + n, 0, len - n);
+            }
+
+          offset += len;
+          infmt = false;
+        }
+      else if (c == 'p')
+        {
+#ifdef CONFIG_LIBC_PRINT_EXTENSION
+          /* "%pB" and "%pV" take a struct va_format and "%pS" looks up a
+           * symbol, none of which may be used after the caller returned.
+           */
+
+          if (*fmt == 'B' || *fmt == 'V' || *fmt == 'S' || *fmt == 's')
+            {
+              return -ENOTSUP;
+            }
+#endif
+
+          SYSLOG_PACK(uintptr_t, va_arg(ap, FAR void *));
+          infmt = false;
+        }
+      else if (c == '.')
+        {
+          prec = fmt;
+        }
+    }
+
+#undef SYSLOG_PACK
+
+  return offset;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_reserve
+ *
+ * Description:
+ *   Return the space for a record of 'len' bytes in the ring, or NULL if
+ *   it is full.  A record never wraps around the end of the ring, the rest
+ *   of the space is skipped with a padding record.
+ *
+ ****************************************************************************/
+
+static FAR struct syslog_record_s *
+syslog_deferred_reserve(FAR struct syslog_ring_s *ring, size_t len)
+{
+  FAR struct syslog_record_s *record;
+  size_t size;
+
+  record = spscbuf_reserve(&ring->buf, &size);
+  if (size > 0 && size < len && size < spscbuf_space(&ring->buf))
+    {
+      record->len      = size;
+      record->priority = SYSLOG_RECORD_PAD;
+      spscbuf_commit(&ring->buf, size);
+
+      record = spscbuf_reserve(&ring->buf, &size);
+    }
+
+  return size >= len ? record : NULL;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_allow
+ *
+ * Description:
+ *   Take one message from the token bucket of a channel.
+ *
+ ****************************************************************************/
+
+static bool syslog_deferred_allow(FAR syslog_channel_t *channel,
+                                  clock_t now)
+{
+  FAR struct syslog_ratelimit_s *slot = NULL;
+  FAR struct syslog_ratelimit_s *rl;
+  uint64_t max;
+  int i;
+
+  for (i = 0; i < CONFIG_SYSLOG_MAX_CHANNELS; i++)
+    {
+      rl = &g_syslog_ratelimit[i];
+      if (rl->channel == channel)
+        {
+          break;
+        }
+      else if (rl->channel == NULL && slot == NULL)
+        {
+          slot = rl;
+        }
+    }
+
+  if (i == CONFIG_SYSLOG_MAX_CHANNELS)
+    {
+      if (slot == NULL || CONFIG_SYSLOG_DEFERRED_RATELIMIT == 0)
+        {
+          return true;
+        }
+
+      rl          = slot;
+      rl->channel = channel;
+      rl->rate    = CONFIG_SYSLOG_DEFERRED_RATELIMIT;
+      rl->burst   = CONFIG_SYSLOG_DEFERRED_BURST;
+      rl->credit  = (uint64_t)rl->burst * TICK_PER_SEC;
+      rl->stamp   = now;
+    }
+
+  if (rl->rate == 0)
+    {
+      return true;
+    }
+
+  max = (uint64_t)rl->burst * TICK_PER_SEC;
+  rl->credit += (uint64_t)(now - rl->stamp) * rl->rate;
+  rl->stamp = now;
+  if (rl->credit > max)
+    {
+      rl->credit = max;
+    }
+
+  if (rl->credit < TICK_PER_SEC)
+    {
+      rl->dropped++;
+      return false;
+    }
+
+  rl->credit -= TICK_PER_SEC;
+
+  if (rl->dropped > 0)
+    {
+      char msg[64];
+      int len;
+
+      len = snprintf(msg, sizeof(msg),
+                     "syslog: %" PRIu32 " messages dropped\n",
+                     rl->dropped);
+      syslog_write_channel(channel, msg, len);
+      rl->dropped = 0;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_write
+ ****************************************************************************/
+
+static void syslog_deferred_write(FAR const char *buffer, size_t buflen,
+                                  bool force)
+{
+  clock_t now;
+  int i;
+
+  if (force)
+    {
+      syslog_write(buffer, buflen);
+      return;
+    }
+
+  now = clock_systime_ticks();
+  for (i = 0; i < CONFIG_SYSLOG_MAX_CHANNELS; i++)
+    {
+      FAR syslog_channel_t *channel = g_syslog_channel[i];
+
+      if (channel == NULL)
+        {
+          break;
+        }
+
+#ifdef CONFIG_SYSLOG_IOCTL
+      if (channel->sc_state & SYSLOG_CHANNEL_DISABLE)
+        {
+          continue;
+        }
+#endif
+
+      if (syslog_deferred_allow(channel, now))
+        {
+          syslog_write_channel(channel, buffer, buflen);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_output
+ *
+ * Description:
+ *   Format a record the same way as nx_vsyslog() does and output it.
+ *
+ ****************************************************************************/
+
+static void syslog_deferred_output(FAR const struct syslog_record_s *record,
+                                   bool force)
+{
+  char line[CONFIG_SYSLOG_DEFERRED_LINELEN];
+  struct lib_memoutstream_s stream;
+  FAR const char *fmt = record->data;
+
+  lib_memoutstream(&stream, line, sizeof(line));
+  syslog_prefix(&stream.common, record->priority, &record->ts,
+                record->cpu, record->pid);
+  lib_bsprintf(&stream.common, fmt, fmt + record->fmtlen);
+
+  if (stream.common.nput == 0 || line[stream.common.nput - 1] != '\n')
+    {
+      if (stream.common.nput == stream.buflen)
+        {
+          stream.common.nput--;
+        }
+
+      lib_stream_putc(&stream.common, '\n');
+    }
+
+#if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
+  /* Reset the terminal style back to normal. */
+
+  lib_stream_puts(&stream.common, "\e[0m", sizeof("\e[0m"));
+#endif
+
+  syslog_deferred_write(line, stream.common.nput, force);
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_drain
+ *
+ * Description:
+ *   Output all records in the rings.  Only the syslog thread, or any
+ *   context after a panic, may call this function.
+ *
+ ****************************************************************************/
+
+static void syslog_deferred_drain(bool force)
+{
+  FAR struct syslog_record_s *record;
+  FAR struct syslog_ring_s *ring;
+  uint32_t lost;
+  size_t size;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      ring = &g_syslog_ring[cpu];
+
+      for (; ; )
+        {
+          record = spscbuf_peek(&ring->buf, &size);
+          if (size == 0)
+            {
+              break;
+            }
+
+          if (record->priority != SYSLOG_RECORD_PAD)
+            {
+              syslog_deferred_output(record, force);
+            }
+
+          spscbuf_consume(&ring->buf, record->len);
+        }
+
+      lost = ring->lost;
+      if (lost != ring->reported)
+        {
+          char msg[64];
+          int len;
+
+          len = snprintf(msg, sizeof(msg),
+                         "syslog: %" PRIu32 " messages lost on CPU%d\n",
+                         lost - ring->reported, cpu);
+          syslog_deferred_write(msg, len, force);
+          ring->reported = lost;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_thread
+ ****************************************************************************/
+
+static int syslog_deferred_thread(int argc, FAR char **argv)
+{
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&g_syslog_deferred_sem);
+      syslog_deferred_drain(false);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_deferred_initialize
+ *
+ * Description:
+ *   Initialize the rings and start the syslog thread.  The messages are
+ *   output at once until then.
+ *
+ ****************************************************************************/
+
+int syslog_deferred_initialize(void)
+{
+  int ret;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      spscbuf_init(&g_syslog_ring[cpu].buf, g_syslog_ring[cpu].space,
+                   sizeof(g_syslog_ring[cpu].space));
+    }
+
+  ret = kthread_create("syslogd", CONFIG_SYSLOG_DEFERRED_PRIORITY,
+                       CONFIG_SYSLOG_DEFERRED_STACKSIZE,
+                       syslog_deferred_thread, NULL);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  g_syslog_deferred_ready = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_vprintf
+ *
+ * Description:
+ *   Queue a message for the syslog thread, which formats and outputs it
+ *   later.  The format string is copied with the arguments, since the
+ *   caller may build it at run time.
+ *
+ * Returned Value:
+ *   The size of the queued record, zero if the ring was full and the
+ *   message was dropped.  A negated errno value is returned if the message
+ *   must be output at once instead.
+ *
+ ****************************************************************************/
+
+int syslog_deferred_vprintf(int priority, FAR const IPTR char *fmt,
+                            FAR va_list *ap)
+{
+  FAR struct syslog_record_s *record;
+  FAR struct syslog_ring_s *ring;
+  irqstate_t flags;
+  size_t fmtlen;
+  ssize_t args;
+  size_t len;
+  va_list copy;
+  int semcount;
+
+  if (!g_syslog_deferred_ready)
+    {
+      return -EAGAIN;
+    }
+
+  if (g_nx_initstate >= OSINIT_PANIC)
+    {
+      /* Output the queued messages before the ones of the panic */
+
+      if (!g_syslog_deferred_panic)
+        {
+          g_syslog_deferred_panic = true;
+          syslog_deferred_drain(true);
+        }
+
+      return -EAGAIN;
+    }
+
+  fmtlen = strlen(fmt) + 1;
+  va_copy(copy, *ap);
+  args = syslog_deferred_pack(NULL, 0, fmt, copy);
+  va_end(copy);
+
+  if (args < 0)
+    {
+      return args;
+    }
+
+  len = offsetof(struct syslog_record_s, data) + fmtlen + args;
+  len = SYSLOG_RECORD_ALIGNUP(len);
+  if (len > UINT16_MAX || len > CONFIG_SYSLOG_DEFERRED_BUFSIZE / 2)
+    {
+      return -E2BIG;
+    }
+
+  flags = up_irq_save();
+  ring = &g_syslog_ring[this_cpu()];
+  record = syslog_deferred_reserve(ring, len);
+  if (record == NULL)
+    {
+      ring->lost++;
+      up_irq_restore(flags);
+      return 0;
+    }
+
+  record->len      = len;
+  record->priority = priority;
+  record->cpu      = this_cpu();
+  record->fmtlen   = fmtlen;
+  record->pid      = nxsched_gettid();
+  syslog_gettime(&record->ts);
+  memcpy(record->data, fmt, fmtlen);
+
+  va_copy(copy, *ap);
+  syslog_deferred_pack(record->data + fmtlen, len -
+                       offsetof(struct syslog_record_s, data) - fmtlen,
+                       fmt, copy);
+  va_end(copy);
+
+  spscbuf_commit(&ring->buf, len);
+  up_irq_restore(flags);
+
+  /* Wake up the syslog thread, which runs at a low priority */
+
+  nxsem_get_value(&g_syslog_deferred_sem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&g_syslog_deferred_sem);
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_flush
+ *
+ * Description:
+ *   Output the queued messages at once after a panic.
+ *
+ ****************************************************************************/
+
+void syslog_deferred_flush(void)
+{
+  if (g_syslog_deferred_ready && g_nx_initstate >= OSINIT_PANIC &&
+      !g_syslog_deferred_panic)
+    {
+      g_syslog_deferred_panic = true;
+      syslog_deferred_drain(true);
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_ratelimit
+ *
+ * Description:
+ *   Limit the messages that the syslog thread outputs to a channel.  The
+ *   messages above the limit are dropped and their number is reported on
+ *   the channel once it accepts messages again.
+ *
+ * Input Parameters:
+ *   channel - The channel to limit
+ *   rate    - The messages per second, 0 for no limit
+ *   burst   - The messages that may be output at once
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int syslog_ratelimit(FAR syslog_channel_t *channel, unsigned int rate,
+                     unsigned int burst)
+{
+  FAR struct syslog_ratelimit_s *rl = NULL;
+  int i;
+
+  for (i = 0; i < CONFIG_SYSLOG_MAX_CHANNELS; i++)
+    {
+      if (g_syslog_ratelimit[i].channel == channel)
+        {
+          rl = &g_syslog_ratelimit[i];
+          break;
+        }
+      else if (g_syslog_ratelimit[i].channel == NULL && rl == NULL)
+        {
+          rl = &g_syslog_ratelimit[i];
+        }
+    }
+
+  if (rl == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  rl->rate    = rate;
+  rl->burst   = burst > 0 ? burst : 1;
+  rl->credit  = (uint64_t)rl->burst * TICK_PER_SEC;
+  rl->stamp   = clock_systime_ticks();
+  rl->channel = channel;
+  return OK;
+}
+
+#endif /* CONFIG_SYSLOG_DEFERRED */
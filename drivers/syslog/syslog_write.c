@@ -95,6 +95,7 @@ static bool syslog_safe_to_block(void)
 static ssize_t syslog_default_write(FAR const char *buffer, size_t buflen)
 {
   size_t nwritten;
+  ssize_t ret;
 
   if (!syslog_safe_to_block())
     {
@@ -227,92 +228,126 @@ static ssize_t syslog_default_write(FAR const char *buffer, size_t buflen)
             }
 #endif
 
-          if (channel->sc_ops->sc_write != NULL)
+          ret = syslog_write_channel(channel, buffer, buflen);
+          if (ret < 0)
             {
-#ifdef CONFIG_SYSLOG_CRLF
-              if (!(channel->sc_state & SYSLOG_CHANNEL_DISABLE_CRLF))
-                {
-                  size_t head;
+              return ret;
+            }
 
-                  for (head = 0; head < buflen; head++)
-                    {
-                      size_t ret;
+          nwritten = ret;
+        }
+    }
 
-                      /* Check for LF */
+  return nwritten;
+}
 
-                      if (buffer[head] != '\n')
-                        {
-                          continue;
-                        }
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
-                      ret = channel->sc_ops->sc_write(channel,
-                                                      buffer + nwritten,
-                                                      head - nwritten);
-                      if (ret < 0)
-                        {
-                          return ret;
-                        }
+/****************************************************************************
+ * Name: syslog_write_channel
+ *
+ * Description:
+ *   Write a buffer to one SYSLOG channel from a context where it is safe
+ *   to block.
+ *
+ * Input Parameters:
+ *   channel - The channel to write to
+ *   buffer  - The buffer containing the data to be output
+ *   buflen  - The number of bytes in the buffer
+ *
+ * Returned Value:
+ *   On success, the number of characters written is returned.  A negated
+ *   errno value is returned on any failure.
+ *
+ ****************************************************************************/
 
-                      /* Add CR */
+ssize_t syslog_write_channel(FAR syslog_channel_t *channel,
+                             FAR const char *buffer, size_t buflen)
+{
+  size_t nwritten = 0;
 
-                      ret = channel->sc_ops->sc_write(channel, "\r\n", 2);
-                      if (ret < 0)
-                        {
-                          return ret;
-                        }
+  if (channel->sc_ops->sc_write != NULL)
+    {
+#ifdef CONFIG_SYSLOG_CRLF
+      if (!(channel->sc_state & SYSLOG_CHANNEL_DISABLE_CRLF))
+        {
+          size_t head;
 
-                      nwritten = head + 1;
-                    }
+          for (head = 0; head < buflen; head++)
+            {
+              size_t ret;
+
+              /* Check for LF */
+
+              if (buffer[head] != '\n')
+                {
+                  continue;
                 }
-#endif
 
-              if (nwritten < buflen)
+              ret = channel->sc_ops->sc_write(channel,
+                                              buffer + nwritten,
+                                              head - nwritten);
+              if (ret < 0)
                 {
-                  ssize_t ret;
+                  return ret;
+                }
 
-                  ret = channel->sc_ops->sc_write(channel,
-                                                  buffer + nwritten,
-                                                  buflen - nwritten);
-                  if (ret < 0)
-                    {
-                      return ret;
-                    }
-                  else
-                    {
-                      nwritten += ret;
-                    }
+              /* Add CR */
+
+              ret = channel->sc_ops->sc_write(channel, "\r\n", 2);
+              if (ret < 0)
+                {
+                  return ret;
                 }
+
+              nwritten = head + 1;
+            }
+        }
+#endif
+
+      if (nwritten < buflen)
+        {
+          ssize_t ret;
+
+          ret = channel->sc_ops->sc_write(channel,
+                                          buffer + nwritten,
+                                          buflen - nwritten);
+          if (ret < 0)
+            {
+              return ret;
             }
           else
             {
-              DEBUGASSERT(channel->sc_ops->sc_putc != NULL);
-              for (nwritten = 0; nwritten < buflen; nwritten++)
-                {
+              nwritten += ret;
+            }
+        }
+    }
+  else
+    {
+      DEBUGASSERT(channel->sc_ops->sc_putc != NULL);
+      for (nwritten = 0; nwritten < buflen; nwritten++)
+        {
 #ifdef CONFIG_SYSLOG_CRLF
-                  /* Check for LF */
+          /* Check for LF */
 
-                  if (buffer[nwritten] == '\n' &&
-                      !(channel->sc_state & SYSLOG_CHANNEL_DISABLE_CRLF))
-                    {
-                      /* Add CR */
+          if (buffer[nwritten] == '\n' &&
+              !(channel->sc_state & SYSLOG_CHANNEL_DISABLE_CRLF))
+            {
+              /* Add CR */
 
-                      channel->sc_ops->sc_putc(channel, '\r');
-                    }
+              channel->sc_ops->sc_putc(channel, '\r');
+            }
 #endif
 
-                  channel->sc_ops->sc_putc(channel, buffer[nwritten]);
-                }
-            }
+          channel->sc_ops->sc_putc(channel, buffer[nwritten]);
         }
     }
 
   return nwritten;
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Name: syslog_write
  *
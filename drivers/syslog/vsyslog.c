@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <stdio.h>
+#include <string.h>
 #include <syslog.h>
 #include <errno.h>
 
@@ -67,47 +68,20 @@ static FAR const char * const g_priority_str[] =
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nx_vsyslog
+ * Name: syslog_gettime
  *
  * Description:
- *   nx_vsyslog() handles the system logging system calls. It is functionally
- *   equivalent to vsyslog() except that (1) the per-process priority
- *   filtering has already been performed and the va_list parameter is
- *   passed by reference.  That is because the va_list is a structure in
- *   some compilers and passing of structures in the NuttX sycalls does
- *   not work.
+ *   Get the time stamp of a message, zero if none is configured or the
+ *   hardware timer is not yet available.
  *
  ****************************************************************************/
 
-int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+void syslog_gettime(FAR struct timespec *ts)
 {
-  struct lib_syslograwstream_s stream;
-  int ret = 0;
-#ifdef CONFIG_SYSLOG_PROCESS_NAME
-  FAR struct tcb_s *tcb = nxsched_get_tcb(nxsched_gettid());
-#endif
-#ifdef CONFIG_SYSLOG_TIMESTAMP
-  struct timespec ts;
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-  struct tm tm;
-  char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
-#  endif
-#endif
-
-  /* Wrap the low-level output in a stream object and let lib_vsprintf
-   * do the work.
-   */
-
-  lib_syslograwstream_open(&stream);
+  ts->tv_sec = 0;
+  ts->tv_nsec = 0;
 
 #ifdef CONFIG_SYSLOG_TIMESTAMP
-  ts.tv_sec = 0;
-  ts.tv_nsec = 0;
-
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-  memset(&tm, 0, sizeof(tm));
-#  endif
-
   /* Get the current time.  Since debug output may be generated very early
    * in the start-up sequence, hardware timer support may not yet be
    * available.
@@ -118,31 +92,73 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_REALTIME)
       /* Use CLOCK_REALTIME if so configured */
 
-      clock_gettime(CLOCK_REALTIME, &ts);
+      clock_gettime(CLOCK_REALTIME, ts);
 #  else
       /* Prefer monotonic when enabled, as it can be synchronized to
        * RTC with clock_resynchronize.
        */
 
-      clock_gettime(CLOCK_MONOTONIC, &ts);
+      clock_gettime(CLOCK_MONOTONIC, ts);
 #  endif
+    }
+#endif
+}
 
-      /* Prepend the message with the current time, if available */
+/****************************************************************************
+ * Name: syslog_prefix
+ *
+ * Description:
+ *   Output the configured prefix of a message, the time stamp, the CPU,
+ *   the thread and so on.
+ *
+ * Input Parameters:
+ *   stream   - The stream to output to
+ *   priority - The priority of the message
+ *   ts       - The time stamp from syslog_gettime()
+ *   cpu      - The CPU that logged the message
+ *   pid      - The thread that logged the message
+ *
+ * Returned Value:
+ *   The number of characters output.
+ *
+ ****************************************************************************/
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-#    if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
-      localtime_r(&ts.tv_sec, &tm);
-#    else
-      gmtime_r(&ts.tv_sec, &tm);
-#    endif
+int syslog_prefix(FAR struct lib_outstream_s *stream, int priority,
+                  FAR const struct timespec *ts, int cpu, pid_t pid)
+{
+  int ret = 0;
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+  FAR struct tcb_s *tcb = nxsched_get_tcb(pid);
+#endif
+#if defined(CONFIG_SYSLOG_TIMESTAMP) && \
+    defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
+  struct tm tm;
+  char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
+#endif
+
+  UNUSED(priority);
+  UNUSED(ts);
+  UNUSED(cpu);
+  UNUSED(pid);
+
+#if defined(CONFIG_SYSLOG_TIMESTAMP) && \
+    defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
+  memset(&tm, 0, sizeof(tm));
+
+  /* Prepend the message with the current time, if available */
+
+  if (ts->tv_sec != 0 || ts->tv_nsec != 0)
+    {
+#  if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
+      localtime_r(&ts->tv_sec, &tm);
+#  else
+      gmtime_r(&ts->tv_sec, &tm);
 #  endif
     }
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
   date_buf[0] = '\0';
   strftime(date_buf, CONFIG_SYSLOG_TIMESTAMP_BUFFER,
            CONFIG_SYSLOG_TIMESTAMP_FORMAT, &tm);
-#  endif
 #endif
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT) || defined(CONFIG_SYSLOG_TIMESTAMP) || \
@@ -150,7 +166,7 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
     defined(CONFIG_SYSLOG_PRIORITY) || defined(CONFIG_SYSLOG_PREFIX) || \
     defined(CONFIG_SYSLOG_PROCESS_NAME)
 
-  ret = lib_sprintf_internal(&stream.common,
+  ret = lib_sprintf_internal(stream,
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
   /* Reset the terminal style. */
 
@@ -204,24 +220,24 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_TIMESTAMP
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
 #    if defined(CONFIG_SYSLOG_TIMESTAMP_FORMAT_MICROSECOND)
-                             , date_buf, ts.tv_nsec / NSEC_PER_USEC
+                             , date_buf, ts->tv_nsec / NSEC_PER_USEC
 #    else
                              , date_buf
 #    endif
 #  else
-                             , (uintmax_t)ts.tv_sec
-                             , ts.tv_nsec / NSEC_PER_USEC
+                             , (uintmax_t)ts->tv_sec
+                             , ts->tv_nsec / NSEC_PER_USEC
 #  endif
 #endif
 
 #if defined(CONFIG_SMP)
-                             , this_cpu()
+                             , cpu
 #endif
 
 #if defined(CONFIG_SYSLOG_PROCESSID)
   /* Prepend the Thread ID */
 
-                             , nxsched_gettid()
+                             , pid
 #endif
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
@@ -245,12 +261,56 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_PROCESS_NAME
   /* Prepend the thread name */
 
-                             , get_task_name(tcb)
+                             , tcb != NULL ? get_task_name(tcb) : ""
 #endif
                     );
 
 #endif /* CONFIG_SYSLOG_COLOR_OUTPUT || CONFIG_SYSLOG_TIMESTAMP || ... */
 
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nx_vsyslog
+ *
+ * Description:
+ *   nx_vsyslog() handles the system logging system calls. It is functionally
+ *   equivalent to vsyslog() except that (1) the per-process priority
+ *   filtering has already been performed and the va_list parameter is
+ *   passed by reference.  That is because the va_list is a structure in
+ *   some compilers and passing of structures in the NuttX sycalls does
+ *   not work.
+ *
+ ****************************************************************************/
+
+int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  struct lib_syslograwstream_s stream;
+  struct timespec ts;
+  int ret;
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Leave the formatting and the output to the syslog thread if it can
+   * take the message.
+   */
+
+  ret = syslog_deferred_vprintf(priority, fmt, ap);
+  if (ret >= 0)
+    {
+      return ret;
+    }
+#endif
+
+  /* Wrap the low-level output in a stream object and let lib_vsprintf
+   * do the work.
+   */
+
+  lib_syslograwstream_open(&stream);
+
+  syslog_gettime(&ts);
+  ret = syslog_prefix(&stream.common, priority, &ts, this_cpu(),
+                      nxsched_gettid());
+
   /* Generate the output */
 
   ret += lib_vsprintf_internal(&stream.common, fmt, *ap);
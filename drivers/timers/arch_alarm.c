@@ -26,6 +26,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/clock.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/timers/arch_alarm.h>
 
 /****************************************************************************
@@ -46,6 +47,16 @@ static FAR struct oneshot_lowerhalf_s *g_oneshot_lower;
 static clock_t g_current_tick;
 #endif
 
+#ifdef CONFIG_HRTIMER
+/* The oneshot timer is shared by the alarm of the system tick and the
+ * alarm of the high resolution timers, it is started for the earlier one.
+ */
+
+static clock_t  g_alarm_tick;
+static bool     g_alarm_active;
+static uint64_t g_hrtimer_alarm = UINT64_MAX;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -97,10 +108,75 @@ static void udelay_coarse(useconds_t microseconds)
     }
 }
 
+#ifdef CONFIG_HRTIMER
+static void oneshot_callback(FAR struct oneshot_lowerhalf_s *lower,
+                             FAR void *arg);
+
+/****************************************************************************
+ * Name: oneshot_restart
+ *
+ * Description:
+ *   Start the oneshot timer for the earlier of the alarm of the system tick
+ *   and the alarm of the high resolution timers.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+static int oneshot_restart(void)
+{
+  struct timespec ts;
+  uint64_t next = g_hrtimer_alarm;
+  uint64_t now;
+
+  if (g_alarm_active && TICK2NSEC((uint64_t)g_alarm_tick) < next)
+    {
+      next = TICK2NSEC((uint64_t)g_alarm_tick);
+    }
+
+  if (next == UINT64_MAX)
+    {
+      return ONESHOT_CANCEL(g_oneshot_lower, &ts);
+    }
+
+  ONESHOT_CURRENT(g_oneshot_lower, &ts);
+  now = clock_time2nsec(&ts);
+
+  clock_nsec2time(&ts, next > now ? next - now : 0);
+  return ONESHOT_START(g_oneshot_lower, oneshot_callback, NULL, &ts);
+}
+#endif
+
 static void oneshot_callback(FAR struct oneshot_lowerhalf_s *lower,
                              FAR void *arg)
 {
   clock_t now;
+
+#ifdef CONFIG_HRTIMER
+  struct timespec ts;
+  uint64_t nsec;
+
+  ONESHOT_CURRENT(g_oneshot_lower, &ts);
+  nsec = clock_time2nsec(&ts);
+
+  if (g_hrtimer_alarm <= nsec)
+    {
+      g_hrtimer_alarm = UINT64_MAX;
+      hrtimer_process(nsec);
+    }
+
+  /* Only the alarm of the high resolution timers may have expired */
+
+  if (!g_alarm_active || TICK2NSEC((uint64_t)g_alarm_tick) > nsec)
+    {
+      oneshot_restart();
+      return;
+    }
+
+  g_alarm_active = false;
+#endif
+
   ONESHOT_TICK_CURRENT(g_oneshot_lower, &now);
 
 #ifdef CONFIG_SCHED_TICKLESS
@@ -277,7 +353,14 @@ int weak_function up_alarm_tick_cancel(FAR clock_t *ticks)
 
   if (g_oneshot_lower != NULL)
     {
+#ifdef CONFIG_HRTIMER
+      /* Keep the oneshot timer running for the high resolution timers */
+
+      g_alarm_active = false;
+      ret = oneshot_restart();
+#else
       ret = ONESHOT_TICK_CANCEL(g_oneshot_lower, ticks);
+#endif
       ONESHOT_TICK_CURRENT(g_oneshot_lower, ticks);
     }
 
@@ -316,6 +399,11 @@ int weak_function up_alarm_tick_start(clock_t ticks)
 
   if (g_oneshot_lower != NULL)
     {
+#ifdef CONFIG_HRTIMER
+      g_alarm_tick   = ticks;
+      g_alarm_active = true;
+      ret = oneshot_restart();
+#else
       clock_t now;
       clock_t delta;
 
@@ -328,12 +416,54 @@ int weak_function up_alarm_tick_start(clock_t ticks)
 
       ret = ONESHOT_TICK_START(g_oneshot_lower, oneshot_callback,
                                NULL, delta);
+#endif
     }
 
   return ret;
 }
 #endif
 
+/****************************************************************************
+ * Name: up_hrtimer_start
+ *
+ * Description:
+ *   Start the alarm of the high resolution timers.  hrtimer_process() will
+ *   be called when the alarm occurs.
+ *
+ * Input Parameters:
+ *   nsec - The absolute time in nanoseconds at which the alarm is expected
+ *          to occur.  UINT64_MAX stops the alarm.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+int weak_function up_hrtimer_start(uint64_t nsec)
+{
+  g_hrtimer_alarm = nsec;
+  return g_oneshot_lower != NULL ? oneshot_restart() : -EAGAIN;
+}
+
+uint64_t weak_function up_hrtimer_gettime(void)
+{
+  struct timespec ts;
+
+  if (g_oneshot_lower == NULL)
+    {
+      return 0;
+    }
+
+  ONESHOT_CURRENT(g_oneshot_lower, &ts);
+  return clock_time2nsec(&ts);
+}
+#endif
+
 /****************************************************************************
  * Name: up_perf_*
  *
@@ -79,6 +79,14 @@
 #define NTB_OUT_SIZE                  16384
 #define TX_MAX_NUM_DPE                32
 
+#ifndef CONFIG_CDCNCM_NRDREQS
+#  define CONFIG_CDCNCM_NRDREQS       1
+#endif
+
+#ifndef CONFIG_CDCNCM_NWRREQS
+#  define CONFIG_CDCNCM_NWRREQS       1
+#endif
+
 /* NCM Transfer Block Parameter Structure */
 
 #define CDC_NCM_NTB16_SUPPORTED      (1 << 0)
@@ -305,11 +313,18 @@ struct cdcncm_driver_s
   FAR struct usbdev_ep_s     *epbulkout;   /* Bulk OUT endpoint */
   uint8_t                     config;      /* Selected configuration number */
 
-  FAR struct usbdev_req_s    *rdreq;       /* Single read request */
-  bool                        rxpending;   /* Packet available in rdreq */
+  /* Read requests, queued on and completed by the endpoint in order */
+
+  FAR struct usbdev_req_s    *rdreqs[CONFIG_CDCNCM_NRDREQS];
+  uint8_t                     rdhead;      /* Next read request to complete */
+  uint8_t                     rxpending;   /* Completed read requests */
+
+  /* Write requests, filled and submitted in order */
 
-  FAR struct usbdev_req_s    *wrreq;       /* Single write request */
-  sem_t                       wrreq_idle;  /* Is the wrreq available? */
+  FAR struct usbdev_req_s    *wrreqs[CONFIG_CDCNCM_NWRREQS];
+  FAR struct usbdev_req_s    *wrreq;       /* Write request being filled */
+  uint8_t                     wrhead;      /* Next write request to fill */
+  sem_t                       wrreq_idle;  /* Count of idle write requests */
   bool                        txdone;      /* Did a write request complete? */
   enum ncm_notify_state_e     notify;      /* State of notify */
   FAR const struct ndp_parser_opts_s
@@ -369,7 +384,8 @@ static int     cdcmbim_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
 /* Interrupt handling */
 
-static void cdcncm_receive(FAR struct cdcncm_driver_s *priv);
+static void cdcncm_receive(FAR struct cdcncm_driver_s *priv,
+                           FAR struct usbdev_req_s *req);
 static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv);
 
 static void cdcncm_interrupt_work(FAR void *arg);
@@ -853,6 +869,18 @@ static void cdcncm_transmit_format(FAR struct cdcncm_driver_s *self,
 
   if (self->dgramcount == 0)
     {
+      /* Wait until a USB device request for Ethernet frame transmissions
+       * becomes available.  The requests are submitted and completed in
+       * order, so the next one in the ring is the one that is idle.
+       */
+
+      while (nxsem_wait(&self->wrreq_idle) != OK)
+        {
+        }
+
+      self->wrreq  = self->wrreqs[self->wrhead];
+      self->wrhead = (self->wrhead + 1) % CONFIG_CDCNCM_NWRREQS;
+
       /* Fill NCB */
 
       tmp = self->wrreq->buf;
@@ -895,7 +923,8 @@ static void cdcncm_transmit_format(FAR struct cdcncm_driver_s *self,
  * Name: cdcncm_transmit_work
  *
  * Description:
- *   Send NTB to the USB device for ethernet frame transmission
+ *   Send NTB to the USB device for ethernet frame transmission.  The other
+ *   write requests are filled with the following datagrams meanwhile.
  *
  * Input Parameters:
  *   arg - Reference to the driver state structure
@@ -916,12 +945,11 @@ static void cdcncm_transmit_work(FAR void *arg)
   int ndpindex;
   int totallen;
 
-  /* Wait until the USB device request for Ethernet frame transmissions
-   * becomes available.
-   */
+  /* Nothing to do if the NTB was sent already */
 
-  while (nxsem_wait(&self->wrreq_idle) != OK)
+  if (self->dgramcount == 0)
     {
+      return;
     }
 
   ncblen   = opts->nthsize;
@@ -1005,10 +1033,11 @@ static int cdcncm_packet_handler(FAR struct cdcncm_driver_s *self,
  *
  ****************************************************************************/
 
-static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
+static void cdcncm_receive(FAR struct cdcncm_driver_s *self,
+                           FAR struct usbdev_req_s *req)
 {
   FAR const struct ndp_parser_opts_s *opts = self->parseropts;
-  FAR uint8_t *tmp = self->rdreq->buf;
+  FAR uint8_t *tmp = req->buf;
   uint32_t ntbmax = g_ntbparameters.ntboutmaxsize;
   uint32_t blocklen;
   uint32_t ndplen;
@@ -1019,7 +1048,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
 
   if (GETUINT32(tmp) != opts->nthsign)
     {
-      uerr("Wrong NTH SIGN, skblen %zu\n", self->rdreq->xfrd);
+      uerr("Wrong NTH SIGN, skblen %zu\n", req->xfrd);
       return;
     }
 
@@ -1059,7 +1088,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
           return;
         }
 
-      tmp = self->rdreq->buf + ndpindex;
+      tmp = req->buf + ndpindex;
 
       if (GETUINT32(tmp) != self->ndpsign)
         {
@@ -1103,7 +1132,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
 
           /* Copy the data from the hardware to self->rx_queue. */
 
-          cdcncm_packet_handler(self, self->rdreq->buf + index, dglen);
+          cdcncm_packet_handler(self, req->buf + index, dglen);
 
           ndplen -= 2 * (opts->dgramitemlen);
         }
@@ -1153,18 +1182,24 @@ static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv)
 static void cdcncm_interrupt_work(FAR void *arg)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)arg;
+  FAR struct usbdev_req_s *req;
   irqstate_t flags;
 
-  /* Check if we received an incoming packet, if so, call cdcncm_receive() */
+  /* Parse the received NTBs in the order of completion, if any, and give
+   * each request back to the endpoint right after.  The other read
+   * requests stay queued meanwhile.
+   */
 
-  if (self->rxpending)
+  while (self->rxpending > 0)
     {
-      cdcncm_receive(self);
+      req = self->rdreqs[self->rdhead];
+      cdcncm_receive(self, req);
       netdev_lower_rxready(&self->dev);
 
       flags = enter_critical_section();
-      self->rxpending = false;
-      EP_SUBMIT(self->epbulkout, self->rdreq);
+      self->rdhead = (self->rdhead + 1) % CONFIG_CDCNCM_NRDREQS;
+      self->rxpending--;
+      EP_SUBMIT(self->epbulkout, req);
       leave_critical_section(flags);
     }
 
@@ -1480,8 +1515,8 @@ static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
     {
       case 0:  /* Normal completion */
         {
-          DEBUGASSERT(!self->rxpending);
-          self->rxpending = true;
+          DEBUGASSERT(self->rxpending < CONFIG_CDCNCM_NRDREQS);
+          self->rxpending++;
           work_queue(ETHWORK, &self->irqwork,
                      cdcncm_interrupt_work, self, 0);
         }
@@ -1493,7 +1528,7 @@ static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
       default: /* Some other error occurred */
         {
           uerr("req->result: %hd\n", req->result);
-          EP_SUBMIT(self->epbulkout, self->rdreq);
+          EP_SUBMIT(self->epbulkout, req);
         }
         break;
     }
@@ -1517,7 +1552,7 @@ static void cdcncm_wrcomplete(FAR struct usbdev_ep_s *ep,
   uinfo("buf: %p, flags 0x%hhx, len %zu, xfrd %zu, result %hd\n",
         req->buf, req->flags, req->len, req->xfrd, req->result);
 
-  /* The single USB device write request is available for upcoming
+  /* The USB device write request is available for upcoming
    * transmissions again.
    */
 
@@ -1583,6 +1618,7 @@ static int cdcncm_setconfig(FAR struct cdcncm_driver_s *self, uint8_t config)
 {
   struct usb_ss_epdesc_s epdesc;
   int ret;
+  int i;
 
   if (config == self->config)
     {
@@ -1635,14 +1671,18 @@ static int cdcncm_setconfig(FAR struct cdcncm_driver_s *self, uint8_t config)
 
   /* Queue read requests in the bulk OUT endpoint */
 
-  DEBUGASSERT(!self->rxpending);
+  DEBUGASSERT(self->rxpending == 0);
 
-  self->rdreq->callback = cdcncm_rdcomplete,
-  ret = EP_SUBMIT(self->epbulkout, self->rdreq);
-  if (ret != OK)
+  self->rdhead = 0;
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      uerr("EP_SUBMIT failed. ret %d\n", ret);
-      goto error;
+      self->rdreqs[i]->callback = cdcncm_rdcomplete;
+      ret = EP_SUBMIT(self->epbulkout, self->rdreqs[i]);
+      if (ret != OK)
+        {
+          uerr("EP_SUBMIT failed. ret %d\n", ret);
+          goto error;
+        }
     }
 
   /* We are successfully configured */
@@ -2478,6 +2518,7 @@ static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
   int ret = OK;
+  int i;
 
   uinfo("\n");
 
@@ -2535,31 +2576,40 @@ static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
 
   /* Pre-allocate read requests. The buffer size is NTB_DEFAULT_IN_SIZE. */
 
-  self->rdreq = usbdev_allocreq(self->epbulkout, NTB_DEFAULT_IN_SIZE);
-  if (self->rdreq == NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
-    }
+      self->rdreqs[i] = usbdev_allocreq(self->epbulkout,
+                                        NTB_DEFAULT_IN_SIZE);
+      if (self->rdreqs[i] == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
 
-  self->rdreq->callback = cdcncm_rdcomplete;
+      self->rdreqs[i]->callback = cdcncm_rdcomplete;
+    }
 
-  /* Pre-allocate a single write request. Buffer size is NTB_OUT_SIZE */
+  /* Pre-allocate write requests. Buffer size is NTB_OUT_SIZE */
 
-  self->wrreq = usbdev_allocreq(self->epbulkin, NTB_OUT_SIZE);
-  if (self->wrreq == NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NWRREQS; i++)
     {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
-    }
+      self->wrreqs[i] = usbdev_allocreq(self->epbulkin, NTB_OUT_SIZE);
+      if (self->wrreqs[i] == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
 
-  self->wrreq->callback = cdcncm_wrcomplete;
+      self->wrreqs[i]->callback = cdcncm_wrcomplete;
+    }
 
-  /* The single write request just allocated is available now. */
+  /* The write requests just allocated are available now. */
 
-  ret = nxsem_init(&self->wrreq_idle, 0, 1);
+  self->wrreq  = self->wrreqs[0];
+  self->wrhead = 0;
+  ret = nxsem_init(&self->wrreq_idle, 0, CONFIG_CDCNCM_NWRREQS);
 
   if (ret != OK)
     {
@@ -2592,6 +2642,7 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
                           FAR struct usbdev_s *dev)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  int i;
 
 #ifdef CONFIG_DEBUG_FEATURES
   if (!driver || !dev)
@@ -2631,10 +2682,13 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
    * been returned to the free list at this time -- we don't check)
    */
 
-  if (self->rdreq != NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      usbdev_freereq(self->epbulkout, self->rdreq);
-      self->rdreq = NULL;
+      if (self->rdreqs[i] != NULL)
+        {
+          usbdev_freereq(self->epbulkout, self->rdreqs[i]);
+          self->rdreqs[i] = NULL;
+        }
     }
 
   /* Free the bulk OUT endpoint */
@@ -2649,12 +2703,17 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
    * of them)
    */
 
-  if (self->wrreq != NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NWRREQS; i++)
     {
-      usbdev_freereq(self->epbulkin, self->wrreq);
-      self->wrreq = NULL;
+      if (self->wrreqs[i] != NULL)
+        {
+          usbdev_freereq(self->epbulkin, self->wrreqs[i]);
+          self->wrreqs[i] = NULL;
+        }
     }
 
+  self->wrreq = NULL;
+
   /* Free the bulk IN endpoint */
 
   if (self->epbulkin)
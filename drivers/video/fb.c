@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/param.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
@@ -39,10 +40,12 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/video/dmabuf.h>
 #include <nuttx/video/fb.h>
 #include <nuttx/clock.h>
 #include <nuttx/wdog.h>
 #include <nuttx/circbuf.h>
+#include <nuttx/wqueue.h>
 
 /****************************************************************************
  * Pre-processor definitions
@@ -67,6 +70,10 @@ struct fb_priv_s
 #ifdef CONFIG_FB_SYNC
   sem_t wait;
 #endif
+
+#ifdef CONFIG_FB_FENCE
+  uint32_t fence;                 /* POLLIN once this pan is released */
+#endif
 };
 
 struct fb_paninfo_s
@@ -76,6 +83,11 @@ struct fb_paninfo_s
   struct wdog_s wdog;             /* VSync offset timer */
 
   FAR struct fb_chardev_s *dev;
+
+#ifdef CONFIG_FB_FENCE
+  uint32_t queued;                /* Pans queued, the fence of the last */
+  uint32_t released;              /* Pans released by the lower half */
+#endif
 };
 
 /* This structure defines one framebuffer device.  Note that which is
@@ -92,6 +104,13 @@ struct fb_chardev_s
   FAR struct fb_priv_s *head;
   FAR struct fb_paninfo_s *paninfo; /* Pan info array */
   size_t paninfo_count;             /* Pan info count */
+#ifdef CONFIG_FB_DAMAGE
+  struct fb_damage_s damage;        /* Areas changed since the last flush */
+  struct work_s damagework;         /* Flushes the damaged areas */
+#endif
+#ifdef CONFIG_VIDEO_DMABUF
+  FAR struct dmabuf_s *dmabuf;      /* Scanned out in place of the plane */
+#endif
 };
 
 struct fb_panelinfo_s
@@ -113,6 +132,7 @@ static int     fb_add_paninfo(FAR struct fb_chardev_s *fb,
                               int overlay);
 static int     fb_clear_paninfo(FAR struct fb_chardev_s *fb,
                                 int overlay);
+static void    fb_pollnotify(FAR struct fb_chardev_s *fb, int overlay);
 static int     fb_open(FAR struct file *filep);
 static int     fb_close(FAR struct file *filep);
 static ssize_t fb_read(FAR struct file *filep, FAR char *buffer,
@@ -138,6 +158,21 @@ static int     fb_sem_wait(FAR struct fb_chardev_s *fb,
 static void    fb_sem_post(FAR struct fb_chardev_s *fb, int overlay);
 #endif
 
+#ifdef CONFIG_FB_FENCE
+static bool    fb_fence_signaled(FAR struct fb_chardev_s *fb,
+                                 FAR struct fb_priv_s *priv);
+#endif
+
+#ifdef CONFIG_FB_DAMAGE
+static void    fb_damage_flush(FAR void *arg);
+static int     fb_damage_report(FAR struct fb_chardev_s *fb,
+                                FAR const struct fb_area_s *area);
+#endif
+
+#ifdef CONFIG_VIDEO_DMABUF
+static int     fb_set_dmabuf(FAR struct fb_chardev_s *fb, int fd);
+#endif
+
 #ifdef CONFIG_BUILD_KERNEL
 static int     fb_munmap(FAR struct task_group_s *group,
                          FAR struct mm_map_entry_s *entry,
@@ -213,6 +248,12 @@ static int fb_add_paninfo(FAR struct fb_chardev_s *fb,
     {
       gwarn("WARNING: circbuf_write(panbuf) failed\n");
     }
+#ifdef CONFIG_FB_FENCE
+  else
+    {
+      fb->paninfo[overlay + 1].queued++;
+    }
+#endif
 
   /* Re-enable interrupts */
 
@@ -247,9 +288,19 @@ static int fb_clear_paninfo(FAR struct fb_chardev_s *fb,
 
   circbuf_reset(panbuf);
 
+#ifdef CONFIG_FB_FENCE
+  /* The dropped pans will never be displayed, release them */
+
+  fb->paninfo[overlay + 1].released = fb->paninfo[overlay + 1].queued;
+#endif
+
   /* Re-enable interrupts */
 
   leave_critical_section(flags);
+
+#ifdef CONFIG_FB_FENCE
+  fb_pollnotify(fb, overlay);
+#endif
   return OK;
 }
 
@@ -367,6 +418,15 @@ static int fb_close(FAR struct file *filep)
 
   leave_critical_section(flags);
 
+#ifdef CONFIG_VIDEO_DMABUF
+  /* Nobody is left to replace the shown DMA buffer */
+
+  if (fb->head == NULL && fb->dmabuf != NULL)
+    {
+      fb_set_dmabuf(fb, -1);
+    }
+#endif
+
 #ifdef CONFIG_FB_SYNC
   nxsem_destroy(&priv->wait);
 #endif
@@ -711,6 +771,31 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
 #endif
 
+#ifdef CONFIG_FB_DAMAGE
+      case FBIOSET_DAMAGE:  /* Report a changed area */
+        {
+          FAR const struct fb_area_s *area =
+            (FAR const struct fb_area_s *)((uintptr_t)arg);
+
+          DEBUGASSERT(fb->vtable != NULL);
+          if (fb->vtable->updatearea == NULL)
+            {
+              ret = -ENOTTY;
+              break;
+            }
+
+          if (area == NULL)
+            {
+              work_cancel(LPWORK, &fb->damagework);
+              fb_damage_flush(fb);
+              break;
+            }
+
+          ret = fb_damage_report(fb, area);
+        }
+        break;
+#endif
+
 #ifdef CONFIG_FB_SYNC
       case FBIO_WAITFORVSYNC:  /* Wait upon vertical sync */
         {
@@ -992,12 +1077,60 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_FB_FENCE
+      case FBIOGET_FENCE:  /* Get the pan fences of the overlay */
+        {
+          FAR struct fb_fence_s *fence =
+            (FAR struct fb_fence_s *)((uintptr_t)arg);
+          FAR struct fb_priv_s *priv = filep->f_priv;
+          FAR struct fb_paninfo_s *paninfo;
+          irqstate_t flags;
+
+          DEBUGASSERT(fence != NULL && priv != NULL);
+
+          paninfo = &fb->paninfo[priv->overlay + 1];
+
+          flags = enter_critical_section();
+          fence->queued   = paninfo->queued;
+          fence->released = paninfo->released;
+          leave_critical_section(flags);
+        }
+        break;
+
+      case FBIOSET_FENCE:  /* Wait for a pan with poll */
+        {
+          FAR struct fb_priv_s *priv = filep->f_priv;
+          irqstate_t flags;
+
+          DEBUGASSERT(priv != NULL);
+
+          flags = enter_critical_section();
+
+          priv->fence = (uint32_t)arg;
+          if (fb_fence_signaled(fb, priv))
+            {
+              poll_notify(priv->fds, CONFIG_VIDEO_FB_NPOLLWAITERS, POLLIN);
+            }
+
+          leave_critical_section(flags);
+        }
+        break;
+#endif
+
       case FBIOPAN_CLEAR:
         {
           ret = fb_clear_paninfo(fb, (int)arg);
         }
         break;
 
+#ifdef CONFIG_VIDEO_DMABUF
+      case FBIOSET_DMABUF:  /* Show a DMA buffer */
+        {
+          ret = fb_set_dmabuf(fb, (int)arg);
+        }
+        break;
+#endif
+
       case FBIOSET_VSYNCOFFSET:
         {
           fb->vsyncoffset = USEC2TICK(arg);
@@ -1274,6 +1407,13 @@ static int fb_poll(FAR struct file *filep, struct pollfd *fds, bool setup)
         {
           poll_notify(&fds, 1, POLLOUT);
         }
+
+#ifdef CONFIG_FB_FENCE
+      if (fb_fence_signaled(fb, priv))
+        {
+          poll_notify(&fds, 1, POLLIN);
+        }
+#endif
     }
   else if (fds->priv != NULL)
     {
@@ -1397,6 +1537,15 @@ static void fb_do_pollnotify(wdparm_t arg)
       /* Notify framebuffer is writable. */
 
       poll_notify(priv->fds, CONFIG_VIDEO_FB_NPOLLWAITERS, POLLOUT);
+
+#ifdef CONFIG_FB_FENCE
+      /* Notify that the pan this file waits for was released */
+
+      if (fb_fence_signaled(paninfo->dev, priv))
+        {
+          poll_notify(priv->fds, CONFIG_VIDEO_FB_NPOLLWAITERS, POLLIN);
+        }
+#endif
     }
 
   leave_critical_section(flags);
@@ -1502,6 +1651,223 @@ static void fb_pollnotify(FAR struct fb_chardev_s *fb, int overlay)
     }
 }
 
+#ifdef CONFIG_FB_FENCE
+
+/****************************************************************************
+ * Name: fb_fence_signaled
+ *
+ * Description:
+ *   Return true if the lower half released the pan that the file waits
+ *   for.  Must be called from within a critical section.
+ *
+ ****************************************************************************/
+
+static bool fb_fence_signaled(FAR struct fb_chardev_s *fb,
+                              FAR struct fb_priv_s *priv)
+{
+  FAR struct fb_paninfo_s *paninfo = &fb->paninfo[priv->overlay + 1];
+
+  return (int32_t)(paninfo->released - priv->fence) >= 0;
+}
+
+#endif /* CONFIG_FB_FENCE */
+
+#ifdef CONFIG_FB_DAMAGE
+
+/****************************************************************************
+ * Name: fb_damage_flush
+ *
+ * Description:
+ *   Update the areas that were damaged since the last flush.  Runs on the
+ *   low priority work queue, as the lower half may take long to transfer
+ *   the pixels to a serial panel.
+ *
+ ****************************************************************************/
+
+static void fb_damage_flush(FAR void *arg)
+{
+  FAR struct fb_chardev_s *fb = arg;
+  struct fb_damage_s damage;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  flags = enter_critical_section();
+  damage = fb->damage;
+  fb->damage.nrects = 0;
+  leave_critical_section(flags);
+
+  for (i = 0; i < damage.nrects; i++)
+    {
+      ret = fb->vtable->updatearea(fb->vtable, &damage.rects[i]);
+      if (ret < 0)
+        {
+          gerr("ERROR: updatearea() failed: %d\n", ret);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fb_damage_report
+ *
+ * Description:
+ *   Clip an area to the plane and add it to the damaged areas.  The first
+ *   area after a flush starts the flush timer, a vsync reported by the
+ *   lower half flushes sooner.
+ *
+ ****************************************************************************/
+
+static int fb_damage_report(FAR struct fb_chardev_s *fb,
+                            FAR const struct fb_area_s *area)
+{
+  struct fb_videoinfo_s vinfo;
+  struct fb_area_s clipped;
+  irqstate_t flags;
+  int ret;
+
+  ret = fb->vtable->getvideoinfo(fb->vtable, &vinfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (area->x >= vinfo.xres || area->y >= vinfo.yres)
+    {
+      return OK;
+    }
+
+  clipped   = *area;
+  clipped.w = MIN(clipped.w, vinfo.xres - clipped.x);
+  clipped.h = MIN(clipped.h, vinfo.yres - clipped.y);
+
+  flags = enter_critical_section();
+
+  fb_damage_add(&fb->damage, &clipped);
+  if (fb->damage.nrects > 0 && work_available(&fb->damagework))
+    {
+      work_queue(LPWORK, &fb->damagework, fb_damage_flush, fb,
+                 MSEC2TICK(CONFIG_FB_DAMAGE_INTERVAL));
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+#endif /* CONFIG_FB_DAMAGE */
+
+#ifdef CONFIG_VIDEO_DMABUF
+/****************************************************************************
+ * Name: fb_set_dmabuf
+ *
+ * Description:
+ *   Show the frame of another driver.  If the lower half can scan it out in
+ *   place, the buffer is held until the next one replaces it, otherwise it
+ *   is copied into the plane memory once.
+ *
+ ****************************************************************************/
+
+static int fb_set_dmabuf(FAR struct fb_chardev_s *fb, int fd)
+{
+  FAR struct dmabuf_s *dmabuf = NULL;
+  FAR struct dmabuf_s *prev;
+  struct fb_videoinfo_s vinfo;
+  struct fb_planeinfo_s pinfo;
+  irqstate_t flags;
+  size_t size;
+  int ret;
+
+  if (fd >= 0)
+    {
+      ret = fb->vtable->getvideoinfo(fb->vtable, &vinfo);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = fb_get_planeinfo(fb, &pinfo, 0);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      dmabuf = dmabuf_get(fd);
+      if (dmabuf == NULL)
+        {
+          return -EBADF;
+        }
+
+      size = (size_t)pinfo.stride * vinfo.yres;
+      if (dmabuf->len < size)
+        {
+          dmabuf_put(dmabuf);
+          return -EINVAL;
+        }
+
+      if (fb->vtable->setscanout == NULL)
+        {
+          dmabuf_begin_cpu(dmabuf);
+          memcpy(pinfo.fbmem, dmabuf->addr, size);
+          dmabuf_end_cpu(dmabuf, false);
+          dmabuf_put(dmabuf);
+
+#ifdef CONFIG_FB_UPDATE
+          if (fb->vtable->updatearea != NULL)
+            {
+              struct fb_area_s area;
+
+              area.x = 0;
+              area.y = 0;
+              area.w = vinfo.xres;
+              area.h = vinfo.yres;
+              return fb->vtable->updatearea(fb->vtable, &area);
+            }
+#endif
+
+          return OK;
+        }
+
+      dmabuf_begin_device(dmabuf);
+      ret = fb->vtable->setscanout(fb->vtable, dmabuf->addr);
+    }
+  else if (fb->vtable->setscanout != NULL)
+    {
+      ret = fb->vtable->setscanout(fb->vtable, NULL);
+    }
+  else
+    {
+      return OK;
+    }
+
+  if (ret < 0)
+    {
+      if (dmabuf != NULL)
+        {
+          dmabuf_end_device(dmabuf, false);
+          dmabuf_put(dmabuf);
+        }
+
+      return ret;
+    }
+
+  /* The display only reads the buffer, it goes back to its driver without
+   * any cache maintenance.
+   */
+
+  flags = enter_critical_section();
+  prev       = fb->dmabuf;
+  fb->dmabuf = dmabuf;
+  leave_critical_section(flags);
+
+  if (prev != NULL)
+    {
+      dmabuf_end_device(prev, false);
+      dmabuf_put(prev);
+    }
+
+  return OK;
+}
+#endif /* CONFIG_VIDEO_DMABUF */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1533,6 +1899,15 @@ void fb_notify_vsync(FAR struct fb_vtable_s *vtable)
           poll_notify(priv->fds, CONFIG_VIDEO_FB_NPOLLWAITERS, POLLPRI);
         }
 
+#ifdef CONFIG_FB_DAMAGE
+      /* Flush the damaged areas now instead of at the flush timer */
+
+      if (fb->damage.nrects > 0)
+        {
+          work_queue(LPWORK, &fb->damagework, fb_damage_flush, fb, 0);
+        }
+#endif
+
       leave_critical_section(flags);
     }
 }
@@ -1591,7 +1966,9 @@ int fb_peek_paninfo(FAR struct fb_vtable_s *vtable,
 /****************************************************************************
  * Name: fb_remove_paninfo
  * Description:
- *   Remove a frame from pan info queue of the specified overlay.
+ *   Remove a frame from pan info queue of the specified overlay.  Call it
+ *   once the hardware no longer scans out the frame, this releases the
+ *   fence of its pan.
  *
  * Input Parameters:
  *   vtable  - Pointer to framebuffer's virtual table.
@@ -1631,6 +2008,13 @@ int fb_remove_paninfo(FAR struct fb_vtable_s *vtable, int overlay)
   ret = circbuf_skip(panbuf, sizeof(union fb_paninfo_u));
   DEBUGASSERT(ret <= 0 || ret == sizeof(union fb_paninfo_u));
 
+#ifdef CONFIG_FB_FENCE
+  if (ret == sizeof(union fb_paninfo_u))
+    {
+      fb->paninfo[overlay + 1].released++;
+    }
+#endif
+
   /* Re-enable interrupts */
 
   leave_critical_section(flags);
@@ -0,0 +1,178 @@
+/****************************************************************************
+ * drivers/video/fb_damage.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Accumulation of the changed areas of a framebuffer */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/video/fb.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fb_area_size
+ ****************************************************************************/
+
+static inline uint32_t fb_area_size(FAR const struct fb_area_s *area)
+{
+  return (uint32_t)area->w * area->h;
+}
+
+/****************************************************************************
+ * Name: fb_area_box
+ *
+ * Description:
+ *   Return the bounding box of two areas in 'box'.
+ *
+ ****************************************************************************/
+
+static void fb_area_box(FAR const struct fb_area_s *a,
+                        FAR const struct fb_area_s *b,
+                        FAR struct fb_area_s *box)
+{
+  uint32_t x1 = MAX((uint32_t)a->x + a->w, (uint32_t)b->x + b->w);
+  uint32_t y1 = MAX((uint32_t)a->y + a->h, (uint32_t)b->y + b->h);
+
+  box->x = MIN(a->x, b->x);
+  box->y = MIN(a->y, b->y);
+  box->w = x1 - box->x;
+  box->h = y1 - box->y;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fb_area_merge
+ *
+ * Description:
+ *   Replace 'dst' with the bounding box of 'dst' and 'src' if the areas
+ *   overlap, or if the box is no larger than the two areas together.
+ *
+ ****************************************************************************/
+
+bool fb_area_merge(FAR struct fb_area_s *dst,
+                   FAR const struct fb_area_s *src)
+{
+  struct fb_area_s box;
+
+  if (src->w == 0 || src->h == 0)
+    {
+      return true;
+    }
+
+  fb_area_box(dst, src, &box);
+
+  /* The areas overlap if the box is narrower and lower than the two areas
+   * side by side.
+   */
+
+  if ((box.w >= dst->w + src->w || box.h >= dst->h + src->h) &&
+      fb_area_size(&box) > fb_area_size(dst) + fb_area_size(src))
+    {
+      return false;
+    }
+
+  *dst = box;
+  return true;
+}
+
+/****************************************************************************
+ * Name: fb_damage_add
+ *
+ * Description:
+ *   Add an area to the damaged areas, merging it with the rectangles that
+ *   it overlaps.  If all rectangles are in use, it is merged with the one
+ *   whose bounding box grows the least.
+ *
+ ****************************************************************************/
+
+void fb_damage_add(FAR struct fb_damage_s *damage,
+                   FAR const struct fb_area_s *area)
+{
+  struct fb_area_s curr = *area;
+  struct fb_area_s box;
+  uint32_t growth;
+  uint32_t best;
+  int found;
+  int i;
+
+  if (curr.w == 0 || curr.h == 0)
+    {
+      return;
+    }
+
+  for (; ; )
+    {
+      /* Absorb every rectangle that the area may be merged with.  The
+       * area grows with each of them, so start over after a merge.
+       */
+
+      for (i = 0; i < damage->nrects; i++)
+        {
+          if (fb_area_merge(&curr, &damage->rects[i]))
+            {
+              damage->rects[i] = damage->rects[--damage->nrects];
+              i = -1;
+            }
+        }
+
+      if (damage->nrects < CONFIG_FB_DAMAGE_NRECTS)
+        {
+          damage->rects[damage->nrects++] = curr;
+          return;
+        }
+
+      /* No room left, merge with the rectangle that grows the least and
+       * look at the others again with the larger area.
+       */
+
+      found = 0;
+      best  = UINT32_MAX;
+
+      for (i = 0; i < damage->nrects; i++)
+        {
+          fb_area_box(&damage->rects[i], &curr, &box);
+          growth = fb_area_size(&box) - fb_area_size(&damage->rects[i]);
+          if (growth < best)
+            {
+              best  = growth;
+              found = i;
+            }
+        }
+
+      fb_area_box(&damage->rects[found], &curr, &box);
+      curr = box;
+      damage->rects[found] = damage->rects[--damage->nrects];
+    }
+}
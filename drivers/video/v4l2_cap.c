@@ -283,6 +283,10 @@ static int capture_enum_fmt(FAR struct file *filep,
                             FAR struct v4l2_fmtdesc *f);
 static int capture_enum_frminterval(FAR struct file *filep,
                                     FAR struct v4l2_frmivalenum *f);
+#ifdef CONFIG_VIDEO_DMABUF
+static int capture_expbuf(FAR struct file *filep,
+                          FAR struct v4l2_exportbuffer *expbuf);
+#endif
 static int capture_enum_frmsize(FAR struct file *filep,
                                 FAR struct v4l2_frmsizeenum *f);
 
@@ -337,7 +341,15 @@ static const struct v4l2_ops_s g_capture_vops =
   capture_s_ext_ctrls_scene,          /* s_ext_ctrls_scene */
   capture_enum_fmt,                   /* enum_fmt */
   capture_enum_frminterval,           /* enum_frminterval */
-  capture_enum_frmsize                /* enum_frmsize */
+  capture_enum_frmsize,               /* enum_frmsize */
+  NULL,                               /* cropcap */
+  NULL,                               /* dqevent */
+  NULL,                               /* subscribe_event */
+  NULL,                               /* decoder_cmd */
+  NULL,                               /* encoder_cmd */
+#ifdef CONFIG_VIDEO_DMABUF
+  capture_expbuf                      /* expbuf */
+#endif
 };
 
 static const struct file_operations g_capture_fops =
@@ -2158,6 +2170,15 @@ static int capture_reqbufs(FAR struct file *filep,
 
       ret = -EPERM;
     }
+#ifdef CONFIG_VIDEO_DMABUF
+  else if (reqbufs->memory == V4L2_MEMORY_MMAP &&
+           video_framebuff_unexport_dmabuf(&type_inf->bufinf, false) < 0)
+    {
+      /* The buffers are still used through DMA buffer descriptors */
+
+      ret = -EBUSY;
+    }
+#endif
   else
     {
       if (reqbufs->count > V4L2_REQBUFS_COUNT_MAX)
@@ -2274,7 +2295,28 @@ static int capture_qbuf(FAR struct file *filep,
       container->buf.length = get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]);
       container->buf.m.userptr = (unsigned long)(type_inf->bufheap +
                                  container->buf.length * buf->index);
+#ifdef CONFIG_VIDEO_DMABUF
+      if (buf->index < V4L2_REQBUFS_COUNT_MAX &&
+          type_inf->bufinf.exported[buf->index] != NULL)
+        {
+          dmabuf_begin_device(type_inf->bufinf.exported[buf->index]);
+        }
+#endif
+    }
+#ifdef CONFIG_VIDEO_DMABUF
+  else if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      /* Capture into the buffer of another driver in place */
+
+      int ret = video_framebuff_import_dmabuf(container,
+                  get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]), true);
+      if (ret < 0)
+        {
+          video_framebuff_free_container(&type_inf->bufinf, container);
+          return ret;
+        }
     }
+#endif
 
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
@@ -2390,6 +2432,19 @@ static int capture_dqbuf(FAR struct file *filep,
     }
 
   memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
+#ifdef CONFIG_VIDEO_DMABUF
+  if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      buf->m.fd = container->dmafd;
+    }
+  else if (buf->memory == V4L2_MEMORY_MMAP &&
+           buf->index < V4L2_REQBUFS_COUNT_MAX &&
+           type_inf->bufinf.exported[buf->index] != NULL)
+    {
+      dmabuf_end_device(type_inf->bufinf.exported[buf->index], true);
+    }
+#endif
+
   video_framebuff_free_container(&type_inf->bufinf, container);
 
   return OK;
@@ -3533,6 +3588,33 @@ static int capture_enum_frminterval(FAR struct file *filep,
   return 0;
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static int capture_expbuf(FAR struct file *filep,
+                          FAR struct v4l2_exportbuffer *expbuf)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR capture_mng_t *cmng = inode->i_private;
+  FAR capture_type_inf_t *type_inf;
+
+  if (cmng == NULL || expbuf == NULL || expbuf->plane != 0)
+    {
+      return -EINVAL;
+    }
+
+  type_inf = get_capture_type_inf(cmng, expbuf->type);
+  if (type_inf == NULL || type_inf->bufheap == NULL)
+    {
+      return -EINVAL;
+    }
+
+  expbuf->fd = video_framebuff_export_dmabuf(&type_inf->bufinf,
+                 expbuf->index, type_inf->bufheap,
+                 get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]),
+                 expbuf->flags & O_CLOEXEC);
+  return expbuf->fd < 0 ? expbuf->fd : OK;
+}
+#endif
+
 /****************************************************************************
  * File Opterations Functions
  ****************************************************************************/
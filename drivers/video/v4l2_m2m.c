@@ -151,6 +151,10 @@ static int codec_decoder_cmd(FAR struct file *filep,
                              FAR struct v4l2_decoder_cmd *cmd);
 static int codec_encoder_cmd(FAR struct file *filep,
                              FAR struct v4l2_encoder_cmd *cmd);
+#ifdef CONFIG_VIDEO_DMABUF
+static int codec_expbuf(FAR struct file *filep,
+                        FAR struct v4l2_exportbuffer *expbuf);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -196,7 +200,10 @@ static const struct v4l2_ops_s g_codec_vops =
   codec_dqevent,         /* dqevent */
   codec_subscribe_event, /* subscribe_event */
   codec_decoder_cmd,     /* decoder_cmd */
-  codec_encoder_cmd      /* encoder_cmd */
+  codec_encoder_cmd,     /* encoder_cmd */
+#ifdef CONFIG_VIDEO_DMABUF
+  codec_expbuf           /* expbuf */
+#endif
 };
 
 static const struct file_operations g_codec_fops =
@@ -300,6 +307,17 @@ static int codec_reqbufs(FAR struct file *filep,
   flags = enter_critical_section();
 
   type_inf = codec_get_type_inf(cfile, reqbufs->type);
+#ifdef CONFIG_VIDEO_DMABUF
+  if (reqbufs->memory == V4L2_MEMORY_MMAP &&
+      video_framebuff_unexport_dmabuf(&type_inf->bufinf, false) < 0)
+    {
+      /* The buffers are still used through DMA buffer descriptors */
+
+      leave_critical_section(flags);
+      return -EBUSY;
+    }
+#endif
+
   video_framebuff_change_mode(&type_inf->bufinf, reqbufs->mode);
   ret = video_framebuff_realloc_container(&type_inf->bufinf,
                                           reqbufs->count);
@@ -410,7 +428,41 @@ static int codec_qbuf(FAR struct file *filep,
       container->buf.length    = buf_size;
       container->buf.m.userptr = (unsigned long)(type_inf->bufheap +
                                  container->buf.length * buf->index);
+#ifdef CONFIG_VIDEO_DMABUF
+      if (buf->index < V4L2_REQBUFS_COUNT_MAX &&
+          type_inf->bufinf.exported[buf->index] != NULL)
+        {
+          dmabuf_begin_device(type_inf->bufinf.exported[buf->index]);
+        }
+#endif
     }
+#ifdef CONFIG_VIDEO_DMABUF
+  else if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      /* Encode or decode the buffer of another driver in place, the
+       * codec writes the capture buffers and reads the output ones.
+       */
+
+      int ret;
+
+      if (V4L2_TYPE_IS_OUTPUT(buf->type))
+        {
+          buf_size = CODEC_OUTPUT_G_BUFSIZE(cmng->codec, cfile->priv);
+        }
+      else
+        {
+          buf_size = CODEC_CAPTURE_G_BUFSIZE(cmng->codec, cfile->priv);
+        }
+
+      ret = video_framebuff_import_dmabuf(container, buf_size,
+                                          !V4L2_TYPE_IS_OUTPUT(buf->type));
+      if (ret < 0)
+        {
+          video_framebuff_free_container(&type_inf->bufinf, container);
+          return ret;
+        }
+    }
+#endif
 
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
@@ -459,6 +511,20 @@ static int codec_dqbuf(FAR struct file *filep,
     }
 
   memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
+#ifdef CONFIG_VIDEO_DMABUF
+  if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      buf->m.fd = container->dmafd;
+    }
+  else if (buf->memory == V4L2_MEMORY_MMAP &&
+           buf->index < V4L2_REQBUFS_COUNT_MAX &&
+           type_inf->bufinf.exported[buf->index] != NULL)
+    {
+      dmabuf_end_device(type_inf->bufinf.exported[buf->index],
+                        !V4L2_TYPE_IS_OUTPUT(buf->type));
+    }
+#endif
+
   video_framebuff_free_container(&type_inf->bufinf, container);
 
   vinfo("%s dequeue done\n", V4L2_TYPE_IS_OUTPUT(buf->type) ?
@@ -807,6 +873,49 @@ int codec_encoder_cmd(FAR struct file *filep,
   return CODEC_ENCODER_CMD(cmng->codec, cfile->priv, cmd);
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static int codec_expbuf(FAR struct file *filep,
+                        FAR struct v4l2_exportbuffer *expbuf)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR codec_mng_t *cmng = inode->i_private;
+  FAR codec_file_t *cfile = filep->f_priv;
+  FAR codec_type_inf_t *type_inf;
+  size_t buf_size;
+
+  if (expbuf == NULL || expbuf->plane != 0)
+    {
+      return -EINVAL;
+    }
+
+  type_inf = codec_get_type_inf(cfile, expbuf->type);
+  if (type_inf == NULL || type_inf->bufheap == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (V4L2_TYPE_IS_OUTPUT(expbuf->type))
+    {
+      buf_size = CODEC_OUTPUT_G_BUFSIZE(cmng->codec, cfile->priv);
+    }
+  else
+    {
+      buf_size = CODEC_CAPTURE_G_BUFSIZE(cmng->codec, cfile->priv);
+    }
+
+  if (buf_size == 0)
+    {
+      return -EINVAL;
+    }
+
+  expbuf->fd = video_framebuff_export_dmabuf(&type_inf->bufinf,
+                                             expbuf->index,
+                                             type_inf->bufheap, buf_size,
+                                             expbuf->flags & O_CLOEXEC);
+  return expbuf->fd < 0 ? expbuf->fd : OK;
+}
+#endif
+
 /* file operations */
 
 static int codec_open(FAR struct file *filep)
@@ -0,0 +1,357 @@
+/****************************************************************************
+ * drivers/video/video_dmabuf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Buffers shared between drivers through file descriptors.  The cache of a
+ * buffer is only maintained when the buffer goes from the CPU to a device
+ * or back, and only if the side that gives it away may have left something
+ * behind in the cache:
+ *
+ *   - The CPU wrote the buffer: It is cleaned before a device uses it.
+ *   - A device wrote the buffer: It is invalidated before the CPU reads.
+ *
+ * A buffer that a device hands on to another device, a frame from a camera
+ * to an encoder for example, is never touched by the CPU or its cache.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <fcntl.h>
+
+#include <nuttx/cache.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/video/dmabuf.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* struct dmabuf_s flags */
+
+#define DMABUF_CPU_DIRTY  (1 << 0) /* The CPU may have dirty cache lines */
+#define DMABUF_CPU_STALE  (1 << 1) /* The CPU may have stale cache lines */
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int dmabuf_open(FAR struct file *filep);
+static int dmabuf_close(FAR struct file *filep);
+static int dmabuf_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+static int dmabuf_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_dmabuf_fops =
+{
+  dmabuf_open,      /* open */
+  dmabuf_close,     /* close */
+  NULL,             /* read */
+  NULL,             /* write */
+  NULL,             /* seek */
+  dmabuf_ioctl,     /* ioctl */
+  dmabuf_mmap,      /* mmap */
+};
+
+static struct inode g_dmabuf_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_dmabuf_fops        /* u */
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int dmabuf_open(FAR struct file *filep)
+{
+  /* A duplicate of the descriptor */
+
+  dmabuf_ref(filep->f_priv);
+  return OK;
+}
+
+static int dmabuf_close(FAR struct file *filep)
+{
+  dmabuf_put(filep->f_priv);
+  return OK;
+}
+
+static int dmabuf_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct dmabuf_s *buf = filep->f_priv;
+  FAR struct dma_buf_sync *sync = (FAR struct dma_buf_sync *)arg;
+
+  if (cmd != DMA_BUF_IOCTL_SYNC)
+    {
+      return -ENOTTY;
+    }
+
+  if (sync == NULL || (sync->flags & DMA_BUF_SYNC_RW) == 0 ||
+      (sync->flags & ~(uint64_t)(DMA_BUF_SYNC_RW | DMA_BUF_SYNC_END)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  if ((sync->flags & DMA_BUF_SYNC_END) == 0)
+    {
+      dmabuf_begin_cpu(buf);
+    }
+  else
+    {
+      dmabuf_end_cpu(buf, (sync->flags & DMA_BUF_SYNC_WRITE) != 0);
+    }
+
+  return OK;
+}
+
+static int dmabuf_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct dmabuf_s *buf = filep->f_priv;
+
+  if (map->offset < 0 || map->length == 0 ||
+      map->offset + map->length > buf->len)
+    {
+      return -EINVAL;
+    }
+
+  map->vaddr = (FAR uint8_t *)buf->addr + map->offset;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dmabuf_alloc
+ *
+ * Description:
+ *   Wrap a buffer of the caller.  The caller holds the only reference and
+ *   may free the memory once dmabuf_shared() is false and it released that
+ *   reference.
+ *
+ ****************************************************************************/
+
+FAR struct dmabuf_s *dmabuf_alloc(FAR void *addr, size_t len)
+{
+  FAR struct dmabuf_s *buf;
+
+  DEBUGASSERT(addr != NULL && len > 0);
+
+  buf = kmm_zalloc(sizeof(struct dmabuf_s));
+  if (buf != NULL)
+    {
+      /* Nothing is known about what the CPU did with the buffer so far */
+
+      buf->addr  = addr;
+      buf->len   = len;
+      buf->flags = DMABUF_CPU_DIRTY;
+      atomic_init(&buf->refs, 1);
+      nxmutex_init(&buf->lock);
+    }
+
+  return buf;
+}
+
+/****************************************************************************
+ * Name: dmabuf_fd
+ *
+ * Description:
+ *   Create a file descriptor that stands for a buffer, as VIDIOC_EXPBUF
+ *   does.  The descriptor holds a reference until it is closed.
+ *
+ ****************************************************************************/
+
+int dmabuf_fd(FAR struct dmabuf_s *buf, int oflags)
+{
+  int fd;
+
+  if ((oflags & ~O_CLOEXEC) != 0)
+    {
+      return -EINVAL;
+    }
+
+  dmabuf_ref(buf);
+  fd = file_allocate(&g_dmabuf_inode, O_RDWR | oflags, 0, buf, 0, true);
+  if (fd < 0)
+    {
+      dmabuf_put(buf);
+    }
+
+  return fd;
+}
+
+/****************************************************************************
+ * Name: dmabuf_get
+ *
+ * Description:
+ *   Import the buffer of a DMA buffer file descriptor.  The buffer stays
+ *   valid until dmabuf_put(), even if the descriptor is closed.
+ *
+ * Input Parameters:
+ *   fd - The DMA buffer file descriptor
+ *
+ * Returned Value:
+ *   The buffer on success; NULL if fd is not a DMA buffer.
+ *
+ ****************************************************************************/
+
+FAR struct dmabuf_s *dmabuf_get(int fd)
+{
+  FAR struct dmabuf_s *buf = NULL;
+  FAR struct file *filep;
+
+  if (fs_getfilep(fd, &filep) < 0)
+    {
+      return NULL;
+    }
+
+  if (filep->f_inode == &g_dmabuf_inode)
+    {
+      buf = dmabuf_ref(filep->f_priv);
+    }
+
+  fs_putfilep(filep);
+  return buf;
+}
+
+/****************************************************************************
+ * Name: dmabuf_ref and dmabuf_put
+ *
+ * Description:
+ *   Take one more reference to a buffer, or release one.  The buffer is
+ *   freed with the last reference, but not the memory that it wraps.
+ *
+ ****************************************************************************/
+
+FAR struct dmabuf_s *dmabuf_ref(FAR struct dmabuf_s *buf)
+{
+  atomic_fetch_add(&buf->refs, 1);
+  return buf;
+}
+
+void dmabuf_put(FAR struct dmabuf_s *buf)
+{
+  if (atomic_fetch_sub(&buf->refs, 1) == 1)
+    {
+      nxmutex_destroy(&buf->lock);
+      kmm_free(buf);
+    }
+}
+
+/****************************************************************************
+ * Name: dmabuf_begin_device and dmabuf_end_device
+ *
+ * Description:
+ *   Hand the buffer over to a device and get it back.  The cache is only
+ *   cleaned if the CPU wrote the buffer since a device used it last; a
+ *   buffer that goes from one device to the next is not touched.
+ *
+ * Input Parameters:
+ *   buf     - The imported buffer
+ *   written - True if the device wrote the buffer
+ *
+ ****************************************************************************/
+
+void dmabuf_begin_device(FAR struct dmabuf_s *buf)
+{
+  nxmutex_lock(&buf->lock);
+  if ((buf->flags & DMABUF_CPU_DIRTY) != 0)
+    {
+      up_clean_dcache((uintptr_t)buf->addr,
+                      (uintptr_t)buf->addr + buf->len);
+      buf->flags &= ~DMABUF_CPU_DIRTY;
+    }
+
+  nxmutex_unlock(&buf->lock);
+}
+
+void dmabuf_end_device(FAR struct dmabuf_s *buf, bool written)
+{
+  if (written)
+    {
+      nxmutex_lock(&buf->lock);
+      buf->flags |= DMABUF_CPU_STALE;
+      nxmutex_unlock(&buf->lock);
+    }
+}
+
+/****************************************************************************
+ * Name: dmabuf_begin_cpu and dmabuf_end_cpu
+ *
+ * Description:
+ *   Bracket an access of the CPU to the buffer, as DMA_BUF_IOCTL_SYNC
+ *   does.  The cache is only invalidated if a device wrote the buffer
+ *   since the CPU looked at it last.
+ *
+ * Input Parameters:
+ *   buf     - The imported buffer
+ *   written - True if the CPU wrote the buffer
+ *
+ ****************************************************************************/
+
+void dmabuf_begin_cpu(FAR struct dmabuf_s *buf)
+{
+  /* Drop what the cache held before a device wrote the buffer.  This is
+   * needed for writes too, the cache lines that are only partly written
+   * would bring the old data back.
+   */
+
+  nxmutex_lock(&buf->lock);
+  if ((buf->flags & DMABUF_CPU_STALE) != 0)
+    {
+      up_invalidate_dcache((uintptr_t)buf->addr,
+                           (uintptr_t)buf->addr + buf->len);
+      buf->flags &= ~DMABUF_CPU_STALE;
+    }
+
+  nxmutex_unlock(&buf->lock);
+}
+
+void dmabuf_end_cpu(FAR struct dmabuf_s *buf, bool written)
+{
+  if (written)
+    {
+      nxmutex_lock(&buf->lock);
+      buf->flags |= DMABUF_CPU_DIRTY;
+      nxmutex_unlock(&buf->lock);
+    }
+}
@@ -52,6 +52,18 @@ static void init_buf_chain(video_framebuff_t *fbuf)
     }
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static void release_dmabuf(vbuf_container_t *cnt)
+{
+  if (cnt->dmabuf != NULL)
+    {
+      dmabuf_end_device(cnt->dmabuf, cnt->dmawr);
+      dmabuf_put(cnt->dmabuf);
+      cnt->dmabuf = NULL;
+    }
+}
+#endif
+
 static inline bool is_last_one(video_framebuff_t *fbuf)
 {
   return fbuf->vbuf_top == fbuf->vbuf_tail;
@@ -95,14 +107,30 @@ void video_framebuff_init(video_framebuff_t *fbuf)
 void video_framebuff_uninit(video_framebuff_t *fbuf)
 {
   video_framebuff_realloc_container(fbuf, 0);
+#ifdef CONFIG_VIDEO_DMABUF
+  video_framebuff_unexport_dmabuf(fbuf, true);
+#endif
   nxmutex_destroy(&fbuf->lock_empty);
 }
 
 int video_framebuff_realloc_container(video_framebuff_t *fbuf, int sz)
 {
   vbuf_container_t *vbuf;
+#ifdef CONFIG_VIDEO_DMABUF
+  int i;
+#endif
 
   nxmutex_lock(&fbuf->lock_empty);
+
+#ifdef CONFIG_VIDEO_DMABUF
+  /* The queued buffers are given up, and so are the shared ones */
+
+  for (i = 0; i < fbuf->container_size; i++)
+    {
+      release_dmabuf(&fbuf->vbuf_alloced[i]);
+    }
+#endif
+
   if (fbuf->container_size == sz)
     {
       nxmutex_unlock(&fbuf->lock_empty);
@@ -161,6 +189,10 @@ vbuf_container_t *video_framebuff_get_container(video_framebuff_t *fbuf)
 void video_framebuff_free_container(video_framebuff_t *fbuf,
                                     vbuf_container_t  *cnt)
 {
+#ifdef CONFIG_VIDEO_DMABUF
+  release_dmabuf(cnt);
+#endif
+
   nxmutex_lock(&fbuf->lock_empty);
   cnt->next = fbuf->vbuf_empty;
   fbuf->vbuf_empty = cnt;
@@ -287,3 +319,115 @@ vbuf_container_t *video_framebuff_pop_curr_container(video_framebuff_t *fbuf)
   spin_unlock_irqrestore(&fbuf->lock_queue, flags);
   return ret;
 }
+
+#ifdef CONFIG_VIDEO_DMABUF
+void video_framebuff_attach_dmabuf(vbuf_container_t *cnt,
+                                   FAR struct dmabuf_s *dmabuf,
+                                   bool write)
+{
+  /* The container holds the reference until it is freed, when the device
+   * gives the buffer back.
+   */
+
+  cnt->dmabuf        = dmabuf;
+  cnt->dmawr         = write;
+  cnt->buf.m.userptr = (unsigned long)dmabuf->addr;
+  cnt->buf.length    = dmabuf->len;
+  dmabuf_begin_device(dmabuf);
+}
+
+int video_framebuff_import_dmabuf(vbuf_container_t *cnt, size_t minsize,
+                                  bool write)
+{
+  FAR struct dmabuf_s *dmabuf;
+  int fd = cnt->buf.m.fd;
+
+  dmabuf = dmabuf_get(fd);
+  if (dmabuf == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (dmabuf->len < minsize)
+    {
+      dmabuf_put(dmabuf);
+      return -EINVAL;
+    }
+
+  cnt->dmafd = fd;
+  video_framebuff_attach_dmabuf(cnt, dmabuf, write);
+  return OK;
+}
+
+/* The exported MMAP buffers are not attached to the containers.  They are
+ * owned by the device, the holders of the file descriptors only borrow
+ * them.
+ */
+
+int video_framebuff_export_dmabuf(video_framebuff_t *fbuf, int index,
+                                  FAR uint8_t *addr, size_t len,
+                                  int oflags)
+{
+  int ret;
+
+  if (index < 0 || index >= fbuf->container_size || addr == NULL)
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&fbuf->lock_empty);
+
+  /* Export every buffer once, so that all descriptors of one buffer share
+   * its cache state.
+   */
+
+  if (fbuf->exported[index] == NULL)
+    {
+      fbuf->exported[index] = dmabuf_alloc(addr + index * len, len);
+    }
+
+  if (fbuf->exported[index] == NULL)
+    {
+      ret = -ENOMEM;
+    }
+  else
+    {
+      ret = dmabuf_fd(fbuf->exported[index], oflags);
+    }
+
+  nxmutex_unlock(&fbuf->lock_empty);
+  return ret;
+}
+
+int video_framebuff_unexport_dmabuf(video_framebuff_t *fbuf, bool force)
+{
+  int i;
+
+  nxmutex_lock(&fbuf->lock_empty);
+
+  /* The buffers may not be freed while anybody else holds them, unless the
+   * device goes away.
+   */
+
+  for (i = 0; i < V4L2_REQBUFS_COUNT_MAX && !force; i++)
+    {
+      if (fbuf->exported[i] != NULL && dmabuf_shared(fbuf->exported[i]))
+        {
+          nxmutex_unlock(&fbuf->lock_empty);
+          return -EBUSY;
+        }
+    }
+
+  for (i = 0; i < V4L2_REQBUFS_COUNT_MAX; i++)
+    {
+      if (fbuf->exported[i] != NULL)
+        {
+          dmabuf_put(fbuf->exported[i]);
+          fbuf->exported[i] = NULL;
+        }
+    }
+
+  nxmutex_unlock(&fbuf->lock_empty);
+  return OK;
+}
+#endif
@@ -29,6 +29,7 @@
 
 #include <nuttx/mutex.h>
 #include <nuttx/spinlock.h>
+#include <nuttx/video/dmabuf.h>
 
 /****************************************************************************
  * Public Types
@@ -38,6 +39,11 @@ struct vbuf_container_s
 {
   struct v4l2_buffer       buf;   /* Buffer information */
   struct vbuf_container_s *next;  /* Pointer to next buffer */
+#ifdef CONFIG_VIDEO_DMABUF
+  FAR struct dmabuf_s     *dmabuf; /* Shared buffer owned by the device */
+  int                      dmafd;  /* File descriptor of V4L2_MEMORY_DMABUF */
+  bool                     dmawr;  /* True: The device writes the buffer */
+#endif
 };
 
 typedef struct vbuf_container_s vbuf_container_t;
@@ -53,6 +59,9 @@ struct video_framebuff_s
   vbuf_container_t *vbuf_top;
   vbuf_container_t *vbuf_tail;
   vbuf_container_t *vbuf_next;
+#ifdef CONFIG_VIDEO_DMABUF
+  FAR struct dmabuf_s *exported[V4L2_REQBUFS_COUNT_MAX]; /* VIDIOC_EXPBUF */
+#endif
 };
 
 typedef struct video_framebuff_s video_framebuff_t;
@@ -87,5 +96,17 @@ void              video_framebuff_capture_done
                        (video_framebuff_t *fbuf);
 void              video_framebuff_change_mode
                        (video_framebuff_t *fbuf, enum v4l2_buf_mode mode);
+#ifdef CONFIG_VIDEO_DMABUF
+void              video_framebuff_attach_dmabuf
+                       (vbuf_container_t *cnt, FAR struct dmabuf_s *dmabuf,
+                        bool write);
+int               video_framebuff_import_dmabuf
+                       (vbuf_container_t *cnt, size_t minsize, bool write);
+int               video_framebuff_export_dmabuf
+                       (video_framebuff_t *fbuf, int index,
+                        FAR uint8_t *addr, size_t len, int oflags);
+int               video_framebuff_unexport_dmabuf
+                       (video_framebuff_t *fbuf, bool force);
+#endif
 
 #endif  /* __DRIVERS_VIDEO_VIDEO_FRAMEBUFF_H */
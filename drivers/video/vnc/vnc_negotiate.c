@@ -516,6 +516,14 @@ int vnc_client_pixelformat(FAR struct vnc_session_s *session,
       return -ENOSYS;
     }
 
+  session->depth  = pixelfmt->depth;
   session->change = true;
+
+#ifdef CONFIG_VNCSERVER_TILEHASH
+  /* The pixels that the client has are in the old format */
+
+  vnc_invalidate_tiles(session);
+#endif
+
   return OK;
 }
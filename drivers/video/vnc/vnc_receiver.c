@@ -291,6 +291,19 @@ int vnc_receiver(FAR struct vnc_session_s *session)
                   rect.w = rfb_getbe16(update->width);
                   rect.h = rfb_getbe16(update->height);
 
+#ifdef CONFIG_VNCSERVER_TILEHASH
+                  /* A non-incremental request means that the client does
+                   * not have the pixels any more, so the tiles that did not
+                   * change must be sent too.
+                   */
+
+                  if (update->incremental == 0)
+                    {
+                      vnc_invalidate_tiles(session);
+                      session->change = true;
+                    }
+#endif
+
                   ret = vnc_update_rectangle(session, &rect, false);
                   if (ret < 0)
                     {
@@ -469,6 +482,9 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
   /* Assume that there are no common encodings (other than RAW) */
 
   session->rre = false;
+#ifdef CONFIG_VNCSERVER_ZRLE
+  session->zrle = false;
+#endif
 
   /* Loop for each client supported encoding */
 
@@ -485,6 +501,12 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
         {
           session->rre = true;
         }
+#ifdef CONFIG_VNCSERVER_ZRLE
+      else if (encoding == RFB_ENCODING_ZRLE)
+        {
+          session->zrle = true;
+        }
+#endif
     }
 
   session->change = true;
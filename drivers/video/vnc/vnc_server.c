@@ -125,6 +125,16 @@ static void vnc_reset_session(FAR struct vnc_session_s *session,
   session->nwhupd  = 0;
   session->change  = true;
 
+#ifdef CONFIG_VNCSERVER_TILEHASH
+  vnc_invalidate_tiles(session);
+#endif
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+  /* The next client starts a new zlib stream */
+
+  vnc_zrle_release(session);
+#endif
+
 #ifdef CONFIG_VNCSERVER_TOUCH
   session->touch.maxpoint = 1;
 #endif
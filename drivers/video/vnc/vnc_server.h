@@ -144,6 +144,17 @@
 #define RFB_STRIDE          (RFB_BYTESPERPIXEL * CONFIG_VNCSERVER_SCREENWIDTH)
 #define RFB_SIZE            (RFB_STRIDE * CONFIG_VNCSERVER_SCREENHEIGHT)
 
+/* Tiles of the local framebuffer whose hashes are kept */
+
+#ifdef CONFIG_VNCSERVER_TILEHASH
+#  define VNC_TILESIZE      CONFIG_VNCSERVER_TILEHASH_SIZE
+#  define VNC_TILECOLS \
+  ((CONFIG_VNCSERVER_SCREENWIDTH + VNC_TILESIZE - 1) / VNC_TILESIZE)
+#  define VNC_TILEROWS \
+  ((CONFIG_VNCSERVER_SCREENHEIGHT + VNC_TILESIZE - 1) / VNC_TILESIZE)
+#  define VNC_NTILES        (VNC_TILECOLS * VNC_TILEROWS)
+#endif
+
 /* RFB Port Number */
 
 #define RFB_PORT_BASE       5900
@@ -205,8 +216,12 @@ struct vnc_session_s
   uint8_t display;             /* Display number (for debug) */
   volatile uint8_t colorfmt;   /* Remote color format (See include/nuttx/fb.h) */
   volatile uint8_t bpp;        /* Remote bits per pixel */
+  volatile uint8_t depth;      /* Remote color depth */
   volatile bool bigendian;     /* True: Remote expect data in big-endian format */
   volatile bool rre;           /* True: Remote supports RRE encoding */
+#ifdef CONFIG_VNCSERVER_ZRLE
+  volatile bool zrle;          /* True: Remote supports ZRLE encoding */
+#endif
   FAR uint8_t *fb;             /* Allocated local frame buffer */
 
   /* VNC client input support */
@@ -226,6 +241,12 @@ struct vnc_session_s
   /* Updater information */
 
   pthread_t updater;           /* Updater thread ID */
+#ifdef CONFIG_VNCSERVER_TILEHASH
+  uint32_t tilehash[VNC_NTILES]; /* Hashes of the tiles sent, 0: unknown */
+#endif
+#ifdef CONFIG_VNCSERVER_ZRLE
+  FAR struct vnc_zrle_s *zrlectx; /* ZRLE encoder state */
+#endif
 
   /* Update list information */
 
@@ -484,6 +505,67 @@ int vnc_rre(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect);
 
 int vnc_raw(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect);
 
+/****************************************************************************
+ * Name: vnc_zrle
+ *
+ * Description:
+ *  Send the framebuffer update using the ZRLE encoding, one 64x64 tile per
+ *  rectangle.  All rectangles of the session share one zlib stream.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if ZRLE coding was not performed (but no error was
+ *   encountered).  Otherwise, the number of bytes sent is returned on
+ *   success or a negated errno value is returned on failure that indicates
+ *   the nature of the failure.  A failure is only returned in cases of a
+ *   network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+int vnc_zrle(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect);
+
+/****************************************************************************
+ * Name: vnc_zrle_release
+ *
+ * Description:
+ *  Free the ZRLE encoder state of a session.  The next connection starts
+ *  with a new zlib stream.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void vnc_zrle_release(FAR struct vnc_session_s *session);
+#endif
+
+/****************************************************************************
+ * Name: vnc_invalidate_tiles
+ *
+ * Description:
+ *  Forget the hashes of the tiles that were sent, so that the next update
+ *  of every tile is sent whether it changed or not.  This is needed when
+ *  the client no longer has the pixels that it was sent.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_TILEHASH
+void vnc_invalidate_tiles(FAR struct vnc_session_s *session);
+#endif
+
 /****************************************************************************
  * Name: vnc_key_map
  *
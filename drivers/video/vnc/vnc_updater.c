@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <string.h>
 #include <sched.h>
 #include <nuttx/irq.h>
@@ -343,6 +344,218 @@ static void vnc_add_queue(FAR struct vnc_session_s *session,
   DEBUGASSERT(session->queuesem.semcount <= CONFIG_VNCSERVER_NUPDATES);
 }
 
+/****************************************************************************
+ * Name: vnc_merge_queue
+ *
+ * Description:
+ *   Grow a queued rectangle to cover a new one if fb_area_merge() allows
+ *   it, so that overlapping updates are not sent twice.  Must be called
+ *   from within a critical section.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle to be merged.
+ *
+ * Returned Value:
+ *   True if a queued rectangle now covers 'rect'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FB_DAMAGE
+static bool vnc_merge_queue(FAR struct vnc_session_s *session,
+                            FAR const struct fb_area_s *rect)
+{
+  FAR struct vnc_fbupdate_s *curr;
+
+  for (curr = (FAR struct vnc_fbupdate_s *)session->updqueue.head;
+       curr != NULL;
+       curr = curr->flink)
+    {
+      if (!curr->whupd && fb_area_merge(&curr->rect, rect))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name: vnc_send_rectangle
+ *
+ * Description:
+ *  Send one rectangle of the local framebuffer with the best encoding that
+ *  the client supports.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   A non-negative value on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int vnc_send_rectangle(FAR struct vnc_session_s *session,
+                              FAR struct fb_area_s *rect)
+{
+  int ret;
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+  /* Attempt to use ZRLE encoding.  It also covers the single color case
+   * that RRE handles.
+   */
+
+  ret = vnc_zrle(session, rect);
+  if (ret != 0)
+    {
+      return ret;
+    }
+#endif
+
+  /* Attempt to use RRE encoding */
+
+  ret = vnc_rre(session, rect);
+  if (ret == 0)
+    {
+      /* Perform the framebuffer update using the default RAW encoding */
+
+      ret = vnc_raw(session, rect);
+    }
+
+  return ret;
+}
+
+#ifdef CONFIG_VNCSERVER_TILEHASH
+
+/****************************************************************************
+ * Name: vnc_tile_hash
+ *
+ * Description:
+ *  Return the FNV-1a hash of a tile of the local framebuffer, taken one
+ *  32-bit word at a time.  Zero is never returned, it marks the tiles
+ *  whose content on the client is unknown.
+ *
+ ****************************************************************************/
+
+static uint32_t vnc_tile_hash(FAR struct vnc_session_s *session,
+                              fb_coord_t x, fb_coord_t y,
+                              fb_coord_t width, fb_coord_t height)
+{
+  FAR const uint8_t *row;
+  uint32_t hash = 0x811c9dc5;
+  uint32_t word;
+  size_t nbytes = (size_t)width * RFB_BYTESPERPIXEL;
+  size_t i;
+
+  row = session->fb + RFB_STRIDE * y + RFB_BYTESPERPIXEL * x;
+  while (height-- > 0)
+    {
+      for (i = 0; i + sizeof(word) <= nbytes; i += sizeof(word))
+        {
+          memcpy(&word, row + i, sizeof(word));
+          hash = (hash ^ word) * 0x01000193;
+        }
+
+      for (; i < nbytes; i++)
+        {
+          hash = (hash ^ row[i]) * 0x01000193;
+        }
+
+      row += RFB_STRIDE;
+    }
+
+  return hash != 0 ? hash : 1;
+}
+
+/****************************************************************************
+ * Name: vnc_update_tiles
+ *
+ * Description:
+ *  Send the tiles of an update rectangle whose content changed since they
+ *  were sent last.  The rectangle is grown to whole tiles, and the changed
+ *  tiles next to each other in a row of tiles are sent as one rectangle.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The update rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   A non-negative value on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int vnc_update_tiles(FAR struct vnc_session_s *session,
+                            FAR const struct fb_area_s *rect)
+{
+  struct fb_area_s run;
+  fb_coord_t x0 = rect->x / VNC_TILESIZE * VNC_TILESIZE;
+  fb_coord_t y0 = rect->y / VNC_TILESIZE * VNC_TILESIZE;
+  fb_coord_t x1 = MIN(rect->x + rect->w, CONFIG_VNCSERVER_SCREENWIDTH);
+  fb_coord_t y1 = MIN(rect->y + rect->h, CONFIG_VNCSERVER_SCREENHEIGHT);
+  fb_coord_t x;
+  fb_coord_t y;
+  fb_coord_t w;
+  uint32_t hash;
+  int index;
+  int ret;
+
+  for (y = y0; y < y1; y += VNC_TILESIZE)
+    {
+      run.y = y;
+      run.w = 0;
+      run.h = MIN(VNC_TILESIZE, CONFIG_VNCSERVER_SCREENHEIGHT - y);
+
+      for (x = x0; x < x1; x += VNC_TILESIZE)
+        {
+          w     = MIN(VNC_TILESIZE, CONFIG_VNCSERVER_SCREENWIDTH - x);
+          index = (y / VNC_TILESIZE) * VNC_TILECOLS + x / VNC_TILESIZE;
+          hash  = vnc_tile_hash(session, x, y, w, run.h);
+
+          if (hash != session->tilehash[index])
+            {
+              /* The tile changed, add it to the run of changed tiles */
+
+              session->tilehash[index] = hash;
+              if (run.w == 0)
+                {
+                  run.x = x;
+                }
+
+              run.w += w;
+              continue;
+            }
+
+          /* The tile did not change, send the run that precedes it */
+
+          if (run.w > 0)
+            {
+              ret = vnc_send_rectangle(session, &run);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              run.w = 0;
+            }
+        }
+
+      if (run.w > 0)
+        {
+          ret = vnc_send_rectangle(session, &run);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_VNCSERVER_TILEHASH */
+
 /****************************************************************************
  * Name: vnc_updater
  *
@@ -400,15 +613,11 @@ static FAR void *vnc_updater(FAR void *arg)
               srcrect->rect.x, srcrect->rect.y,
               srcrect->rect.w, srcrect->rect.h);
 
-      /* Attempt to use RRE encoding */
-
-      ret = vnc_rre(session, &srcrect->rect);
-      if (ret == 0)
-        {
-          /* Perform the framebuffer update using the default RAW encoding */
-
-          ret = vnc_raw(session, &srcrect->rect);
-        }
+#ifdef CONFIG_VNCSERVER_TILEHASH
+      ret = vnc_update_tiles(session, &srcrect->rect);
+#else
+      ret = vnc_send_rectangle(session, &srcrect->rect);
+#endif
 
       /* Release the update structure */
 
@@ -655,6 +864,19 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
               session->change |= change;
             }
 
+#ifdef CONFIG_FB_DAMAGE
+          /* Merge the update into one that is still queued, if any */
+
+          if (!whupd && vnc_merge_queue(session, &intersection))
+            {
+              updinfo("Merged {(%d, %d),(%d, %d)}\n",
+                      intersection.x, intersection.y,
+                      intersection.w, intersection.h);
+              leave_critical_section(flags);
+              return OK;
+            }
+#endif
+
           /* Allocate an update structure... waiting if necessary */
 
           update = vnc_alloc_update(session);
@@ -683,3 +905,25 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: vnc_invalidate_tiles
+ *
+ * Description:
+ *  Forget the hashes of the tiles that were sent, so that the next update
+ *  of every tile is sent whether it changed or not.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_TILEHASH
+void vnc_invalidate_tiles(FAR struct vnc_session_s *session)
+{
+  memset(session->tilehash, 0, sizeof(session->tilehash));
+}
+#endif
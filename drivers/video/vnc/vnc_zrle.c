@@ -0,0 +1,738 @@
+/****************************************************************************
+ * drivers/video/vnc/vnc_zrle.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The ZRLE encoding of RFC 6143, section 7.7.6.  Each tile of 64x64 pixels
+ * is sent as a solid color, as a packed palette, as runs of colors or of
+ * palette indices, or raw, whichever is the smallest, and the result is
+ * compressed with the zlib stream of the session.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <limits.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  undef  CONFIG_DEBUG_GRAPHICS_ERROR
+#  undef  CONFIG_DEBUG_GRAPHICS_WARN
+#  undef  CONFIG_DEBUG_GRAPHICS_INFO
+#  define CONFIG_DEBUG_ERROR          1
+#  define CONFIG_DEBUG_WARN           1
+#  define CONFIG_DEBUG_INFO           1
+#  define CONFIG_DEBUG_GRAPHICS       1
+#  define CONFIG_DEBUG_GRAPHICS_ERROR 1
+#  define CONFIG_DEBUG_GRAPHICS_WARN  1
+#  define CONFIG_DEBUG_GRAPHICS_INFO  1
+#endif
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+
+#include <zlib.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ZRLE_TILESIZE    64                /* Tile width and height */
+#define ZRLE_NPIXELS     (ZRLE_TILESIZE * ZRLE_TILESIZE)
+#define ZRLE_MAXPALETTE  16                /* Largest palette that is tried */
+
+/* The subencodings of a tile */
+
+#define ZRLE_RAW         0                 /* CPIXELs */
+#define ZRLE_SOLID       1                 /* One CPIXEL */
+#define ZRLE_PLAINRLE    128               /* Runs of CPIXELs */
+#define ZRLE_PALETTERLE  128               /* Plus palette size */
+
+/* The largest encoded tile, a raw tile of 32-bit pixels */
+
+#define ZRLE_TILEBUFSIZE (1 + 4 * ZRLE_NPIXELS)
+
+/* The FramebufferUpdate header and the length of the zlib data */
+
+#define ZRLE_HDRSIZE \
+  (SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0)) + 4)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct vnc_zrle_s
+{
+  z_stream zstream;                        /* The zlib stream of the session */
+  uint32_t pixels[ZRLE_NPIXELS];           /* The tile in the remote format */
+  uint32_t palette[ZRLE_MAXPALETTE];       /* The colors of the tile */
+  uint8_t tile[ZRLE_TILEBUFSIZE];          /* The encoded tile */
+  size_t outsize;                          /* Size of out[] */
+  FAR uint8_t *out;                        /* The FramebufferUpdate message */
+};
+
+/* What vnc_zrle_analyze() learned about the runs and colors of a tile */
+
+struct vnc_zrle_stats_s
+{
+  unsigned int npalette;                   /* Colors, > ZRLE_MAXPALETTE if
+                                            * too many */
+  unsigned int nruns;                      /* Runs of one color */
+  unsigned int nsingle;                    /* Runs of just one pixel */
+  size_t runbytes;                         /* Bytes of the run lengths */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_zrle_zalloc and vnc_zrle_zfree
+ *
+ * Description:
+ *   The zlib stream is allocated from the kernel heap.
+ *
+ ****************************************************************************/
+
+static voidpf vnc_zrle_zalloc(voidpf opaque, uInt items, uInt size)
+{
+  return kmm_calloc(items, size);
+}
+
+static void vnc_zrle_zfree(voidpf opaque, voidpf address)
+{
+  kmm_free(address);
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_alloc
+ *
+ * Description:
+ *   Allocate the encoder state and start the zlib stream of the session.
+ *
+ ****************************************************************************/
+
+static FAR struct vnc_zrle_s *vnc_zrle_alloc(void)
+{
+  FAR struct vnc_zrle_s *zrle;
+  size_t outsize;
+  int ret;
+
+  /* Room for the worst case compression of one tile, plus the empty stored
+   * block of the sync flush.  Without a stream deflateBound() assumes the
+   * least compressing settings.
+   */
+
+  outsize = ZRLE_HDRSIZE + deflateBound(Z_NULL, ZRLE_TILEBUFSIZE) + 16;
+
+  zrle = kmm_zalloc(sizeof(struct vnc_zrle_s) + outsize);
+  if (zrle == NULL)
+    {
+      gerr("ERROR: Failed to allocate the ZRLE state\n");
+      return NULL;
+    }
+
+  zrle->zstream.zalloc = vnc_zrle_zalloc;
+  zrle->zstream.zfree  = vnc_zrle_zfree;
+
+  ret = deflateInit2(&zrle->zstream, CONFIG_VNCSERVER_ZRLE_LEVEL,
+                     Z_DEFLATED, CONFIG_VNCSERVER_ZRLE_WINDOWBITS,
+                     CONFIG_VNCSERVER_ZRLE_MEMLEVEL, Z_DEFAULT_STRATEGY);
+  if (ret != Z_OK)
+    {
+      gerr("ERROR: deflateInit2 failed: %d\n", ret);
+      kmm_free(zrle);
+      return NULL;
+    }
+
+  zrle->outsize = outsize;
+  zrle->out     = (FAR uint8_t *)(zrle + 1);
+  return zrle;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_gather
+ *
+ * Description:
+ *   Convert a tile of the local framebuffer to the remote pixel format.
+ *
+ ****************************************************************************/
+
+static int vnc_zrle_gather(FAR struct vnc_session_s *session,
+                           FAR uint32_t *pixels, uint8_t colorfmt,
+                           fb_coord_t x, fb_coord_t y,
+                           fb_coord_t width, fb_coord_t height)
+{
+  FAR const lfb_color_t *src;
+  fb_coord_t col;
+  fb_coord_t row;
+
+  for (row = 0; row < height; row++)
+    {
+      src = (FAR const lfb_color_t *)
+        (session->fb + RFB_STRIDE * (y + row) + RFB_BYTESPERPIXEL * x);
+
+      for (col = 0; col < width; col++, src++)
+        {
+          switch (colorfmt)
+            {
+              case FB_FMT_RGB8_222:
+                *pixels++ = vnc_convert_rgb8_222(*src);
+                break;
+
+              case FB_FMT_RGB8_332:
+                *pixels++ = vnc_convert_rgb8_332(*src);
+                break;
+
+              case FB_FMT_RGB16_555:
+                *pixels++ = vnc_convert_rgb16_555(*src);
+                break;
+
+              case FB_FMT_RGB16_565:
+                *pixels++ = vnc_convert_rgb16_565(*src);
+                break;
+
+              case FB_FMT_RGB32:
+                *pixels++ = vnc_convert_rgb32_888(*src);
+                break;
+
+              default:
+                gerr("ERROR: Unrecognized color format: %d\n", colorfmt);
+                return -EINVAL;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_analyze
+ *
+ * Description:
+ *   Count the runs of the tile and collect its palette.  The palette is
+ *   only looked up at the start of each run.
+ *
+ ****************************************************************************/
+
+static void vnc_zrle_analyze(FAR struct vnc_zrle_s *zrle, size_t npixels,
+                             FAR struct vnc_zrle_stats_s *stats)
+{
+  FAR const uint32_t *pixels = zrle->pixels;
+  size_t runlen = 0;
+  size_t i;
+  unsigned int j;
+
+  memset(stats, 0, sizeof(*stats));
+
+  for (i = 0; i <= npixels; i++)
+    {
+      if (i > 0 && i < npixels && pixels[i] == pixels[i - 1])
+        {
+          runlen++;
+          continue;
+        }
+
+      /* A run ends before this pixel */
+
+      if (runlen > 0)
+        {
+          stats->nruns++;
+          stats->runbytes += (runlen - 1) / 255 + 1;
+          if (runlen == 1)
+            {
+              stats->nsingle++;
+            }
+        }
+
+      if (i == npixels)
+        {
+          break;
+        }
+
+      runlen = 1;
+
+      if (stats->npalette <= ZRLE_MAXPALETTE)
+        {
+          for (j = 0; j < stats->npalette; j++)
+            {
+              if (zrle->palette[j] == pixels[i])
+                {
+                  break;
+                }
+            }
+
+          if (j == stats->npalette)
+            {
+              if (j < ZRLE_MAXPALETTE)
+                {
+                  zrle->palette[j] = pixels[i];
+                }
+
+              stats->npalette++;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_putpixel
+ *
+ * Description:
+ *   Store one CPIXEL.  Three byte CPIXELs hold the least significant bytes
+ *   of the 32-bit pixel, in the byte order of the client.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *vnc_zrle_putpixel(FAR uint8_t *dest, uint32_t pixel,
+                                      unsigned int size, bool bigendian)
+{
+  switch (size)
+    {
+      case 1:
+        *dest = (uint8_t)pixel;
+        break;
+
+      case 2:
+        if (bigendian)
+          {
+            rfb_putbe16(dest, pixel);
+          }
+        else
+          {
+            rfb_putle16(dest, pixel);
+          }
+        break;
+
+      case 3:
+        if (bigendian)
+          {
+            dest[0] = (uint8_t)(pixel >> 16);
+            dest[1] = (uint8_t)(pixel >> 8);
+            dest[2] = (uint8_t)pixel;
+          }
+        else
+          {
+            dest[0] = (uint8_t)pixel;
+            dest[1] = (uint8_t)(pixel >> 8);
+            dest[2] = (uint8_t)(pixel >> 16);
+          }
+        break;
+
+      default:
+        if (bigendian)
+          {
+            rfb_putbe32(dest, pixel);
+          }
+        else
+          {
+            rfb_putle32(dest, pixel);
+          }
+        break;
+    }
+
+  return dest + size;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_putrun
+ *
+ * Description:
+ *   Store the length of a run, minus one, in units of 255.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *vnc_zrle_putrun(FAR uint8_t *dest, size_t runlen)
+{
+  runlen--;
+  while (runlen >= 255)
+    {
+      *dest++ = 255;
+      runlen -= 255;
+    }
+
+  *dest++ = (uint8_t)runlen;
+  return dest;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_index
+ ****************************************************************************/
+
+static uint8_t vnc_zrle_index(FAR const uint32_t *palette,
+                              unsigned int npalette, uint32_t pixel)
+{
+  unsigned int i;
+
+  for (i = 0; i < npalette - 1 && palette[i] != pixel; i++)
+    {
+    }
+
+  return (uint8_t)i;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_tile
+ *
+ * Description:
+ *   Encode the tile in zrle->pixels into zrle->tile with the subencoding
+ *   that gives the fewest bytes.
+ *
+ * Returned Value:
+ *   The size of the encoded tile.
+ *
+ ****************************************************************************/
+
+static size_t vnc_zrle_tile(FAR struct vnc_zrle_s *zrle,
+                            fb_coord_t width, fb_coord_t height,
+                            unsigned int cpsize, bool bigendian)
+{
+  FAR const uint32_t *pixels = zrle->pixels;
+  FAR uint8_t *dest = zrle->tile;
+  struct vnc_zrle_stats_s stats;
+  size_t npixels = (size_t)width * height;
+  size_t best;
+  size_t size;
+  size_t runlen;
+  size_t i;
+  unsigned int npalette;
+  unsigned int bits = 0;
+  unsigned int shift;
+  uint8_t subenc;
+  uint8_t index;
+  fb_coord_t col;
+  fb_coord_t row;
+
+  vnc_zrle_analyze(zrle, npixels, &stats);
+  npalette = stats.npalette;
+
+  /* A tile of one color */
+
+  if (npalette == 1)
+    {
+      *dest++ = ZRLE_SOLID;
+      dest    = vnc_zrle_putpixel(dest, pixels[0], cpsize, bigendian);
+      return dest - zrle->tile;
+    }
+
+  /* Pick the smallest of the other subencodings */
+
+  subenc = ZRLE_RAW;
+  best   = npixels * cpsize;
+
+  size = stats.nruns * cpsize + stats.runbytes;
+  if (size < best)
+    {
+      subenc = ZRLE_PLAINRLE;
+      best   = size;
+    }
+
+  if (npalette <= ZRLE_MAXPALETTE)
+    {
+      bits = npalette <= 2 ? 1 : npalette <= 4 ? 2 : 4;
+
+      size = npalette * cpsize + height * ((width * bits + 7) / 8);
+      if (size < best)
+        {
+          subenc = npalette;
+          best   = size;
+        }
+
+      size = npalette * cpsize + stats.nruns + stats.runbytes -
+             stats.nsingle;
+      if (size < best)
+        {
+          subenc = ZRLE_PALETTERLE + npalette;
+          best   = size;
+        }
+    }
+
+  *dest++ = subenc;
+
+  if (subenc != ZRLE_RAW && subenc != ZRLE_PLAINRLE)
+    {
+      for (i = 0; i < npalette; i++)
+        {
+          dest = vnc_zrle_putpixel(dest, zrle->palette[i], cpsize,
+                                   bigendian);
+        }
+    }
+
+  if (subenc == ZRLE_RAW)
+    {
+      for (i = 0; i < npixels; i++)
+        {
+          dest = vnc_zrle_putpixel(dest, pixels[i], cpsize, bigendian);
+        }
+    }
+  else if (subenc < ZRLE_PLAINRLE)
+    {
+      /* Packed palette indices, the first pixel in the most significant
+       * bits, each row padded to a whole byte.
+       */
+
+      for (row = 0; row < height; row++)
+        {
+          shift = 8;
+          *dest = 0;
+
+          for (col = 0; col < width; col++)
+            {
+              if (shift == 0)
+                {
+                  shift   = 8;
+                  *++dest = 0;
+                }
+
+              shift -= bits;
+              index  = vnc_zrle_index(zrle->palette, npalette, *pixels++);
+              *dest |= index << shift;
+            }
+
+          dest++;
+        }
+    }
+  else
+    {
+      for (i = 0; i < npixels; i += runlen)
+        {
+          for (runlen = 1;
+               i + runlen < npixels && pixels[i + runlen] == pixels[i];
+               runlen++)
+            {
+            }
+
+          if (subenc == ZRLE_PLAINRLE)
+            {
+              dest = vnc_zrle_putpixel(dest, pixels[i], cpsize, bigendian);
+              dest = vnc_zrle_putrun(dest, runlen);
+            }
+          else
+            {
+              index = vnc_zrle_index(zrle->palette, npalette, pixels[i]);
+              if (runlen == 1)
+                {
+                  *dest++ = index;
+                }
+              else
+                {
+                  *dest++ = index | 0x80;
+                  dest    = vnc_zrle_putrun(dest, runlen);
+                }
+            }
+        }
+    }
+
+  DEBUGASSERT(dest - zrle->tile == best + 1);
+  return dest - zrle->tile;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_zrle
+ *
+ * Description:
+ *  Send the framebuffer update using the ZRLE encoding, one 64x64 tile per
+ *  rectangle.  All rectangles of the session share one zlib stream.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if ZRLE coding was not performed (but no error was
+ *   encountered).  Otherwise, the number of bytes sent is returned on
+ *   success or a negated errno value is returned on failure that indicates
+ *   the nature of the failure.  A failure is only returned in cases of a
+ *   network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+int vnc_zrle(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  FAR struct vnc_zrle_s *zrle;
+  FAR const uint8_t *src;
+  fb_coord_t x;
+  fb_coord_t y;
+  fb_coord_t width;
+  fb_coord_t height;
+  unsigned int cpsize;
+  size_t total = 0;
+  size_t size;
+  ssize_t nsent;
+  uint8_t colorfmt;
+  bool bigendian;
+  int ret;
+
+  /* Check if the client supports the ZRLE encoding */
+
+  if (!session->zrle)
+    {
+      return 0;
+    }
+
+  zrle = session->zrlectx;
+  if (zrle == NULL)
+    {
+      zrle = vnc_zrle_alloc();
+      if (zrle == NULL)
+        {
+          return 0;
+        }
+
+      session->zrlectx = zrle;
+    }
+
+  /* Once a tile went into the zlib stream it must be sent, so the pixel
+   * format is sampled only once for the whole rectangle.  A CPIXEL drops
+   * the unused byte of the 32-bit pixels with up to 24 bits of color.
+   */
+
+  colorfmt  = session->colorfmt;
+  bigendian = session->bigendian;
+  cpsize    = (session->bpp + 7) >> 3;
+
+  if (cpsize == 4 && session->depth <= 24)
+    {
+      cpsize = 3;
+    }
+
+  for (y = rect->y; y < rect->y + rect->h; y += height)
+    {
+      height = MIN(ZRLE_TILESIZE, rect->y + rect->h - y);
+
+      for (x = rect->x; x < rect->x + rect->w; x += width)
+        {
+          width = MIN(ZRLE_TILESIZE, rect->x + rect->w - x);
+
+          ret = vnc_zrle_gather(session, zrle->pixels, colorfmt,
+                                x, y, width, height);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          size = vnc_zrle_tile(zrle, width, height, cpsize, bigendian);
+
+          /* Compress the tile and flush it to a byte boundary, so that
+           * the client can decode it from this rectangle alone.
+           */
+
+          zrle->zstream.next_in   = zrle->tile;
+          zrle->zstream.avail_in  = size;
+          zrle->zstream.next_out  = zrle->out + ZRLE_HDRSIZE;
+          zrle->zstream.avail_out = zrle->outsize - ZRLE_HDRSIZE;
+
+          ret = deflate(&zrle->zstream, Z_SYNC_FLUSH);
+          if (ret != Z_OK || zrle->zstream.avail_in != 0 ||
+              zrle->zstream.avail_out == 0)
+            {
+              gerr("ERROR: deflate failed: %d\n", ret);
+              return -EIO;
+            }
+
+          size = zrle->outsize - ZRLE_HDRSIZE - zrle->zstream.avail_out;
+
+          /* Format the FramebufferUpdate message */
+
+          update = (FAR struct rfb_framebufferupdate_s *)zrle->out;
+
+          update->msgtype = RFB_FBUPDATE_MSG;
+          update->padding = 0;
+          rfb_putbe16(update->nrect, 1);
+
+          rfb_putbe16(update->rect[0].xpos, x);
+          rfb_putbe16(update->rect[0].ypos, y);
+          rfb_putbe16(update->rect[0].width, width);
+          rfb_putbe16(update->rect[0].height, height);
+          rfb_putbe32(update->rect[0].encoding, RFB_ENCODING_ZRLE);
+          rfb_putbe32(update->rect[0].data, size);
+
+          /* Send until all of the bytes are out */
+
+          size += ZRLE_HDRSIZE;
+          total += size;
+          src    = zrle->out;
+
+          do
+            {
+              nsent = psock_send(&session->connect, src, size, 0);
+              if (nsent < 0)
+                {
+                  gerr("ERROR: Send FrameBufferUpdate failed: %d\n",
+                       (int)nsent);
+                  return (int)nsent;
+                }
+
+              DEBUGASSERT(nsent <= size);
+              src  += nsent;
+              size -= nsent;
+            }
+          while (size > 0);
+
+          updinfo("Sent ZRLE {(%d, %d),(%d, %d)}\n",
+                  x, y, x + width - 1, y + height - 1);
+        }
+    }
+
+  return total > INT_MAX ? INT_MAX : (int)total;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_release
+ *
+ * Description:
+ *  Free the ZRLE encoder state of a session.  The next connection starts
+ *  with a new zlib stream.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void vnc_zrle_release(FAR struct vnc_session_s *session)
+{
+  if (session->zrlectx != NULL)
+    {
+      deflateEnd(&session->zrlectx->zstream);
+      kmm_free(session->zrlectx);
+      session->zrlectx = NULL;
+    }
+}
@@ -26,11 +26,18 @@
 #include <errno.h>
 #include <stdio.h>
 
+#include <sys/param.h>
+
+#include <nuttx/fs/blkqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/virtio/virtio.h>
+#include <nuttx/wqueue.h>
 
 #include "virtio-blk.h"
 
@@ -43,15 +50,24 @@
 
 /* Block feature bits */
 
+#define VIRTIO_BLK_F_SEG_MAX        2  /* Maximum segments of a request */
 #define VIRTIO_BLK_F_RO             5  /* Disk is read-only */
 #define VIRTIO_BLK_F_BLK_SIZE       6  /* Block size of disk is available */
 #define VIRTIO_BLK_F_FLUSH          9  /* Cache flush command support */
+#define VIRTIO_BLK_F_DISCARD        13 /* Discard command support */
+#define VIRTIO_BLK_F_WRITE_ZEROES   14 /* Write zeroes command support */
 
 /* Block request type */
 
 #define VIRTIO_BLK_T_IN             0  /* READ */
 #define VIRTIO_BLK_T_OUT            1  /* WRITE */
 #define VIRTIO_BLK_T_FLUSH          4  /* FLUSH */
+#define VIRTIO_BLK_T_DISCARD        11 /* DISCARD */
+#define VIRTIO_BLK_T_WRITE_ZEROES   13 /* WRITE_ZEROES */
+
+/* Write zeroes flags */
+
+#define VIRTIO_BLK_WRITE_ZEROES_F_UNMAP 1
 
 /* Block request return status */
 
@@ -64,6 +80,12 @@
 #define VIRTIO_BLK_SECTOR_BITS      9
 #define VIRTIO_BLK_SECTOR_SIZE      (1UL << VIRTIO_BLK_SECTOR_BITS)
 
+/* The most data segments of one request.  Each asynchronous request that
+ * is merged into another adds one segment.
+ */
+
+#define VIRTIO_BLK_MAXSEGS          16
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -84,6 +106,15 @@ begin_packed_struct struct virtio_blk_resp_s
   uint8_t status;
 } end_packed_struct;
 
+/* Block discard and write zeroes segment */
+
+begin_packed_struct struct virtio_blk_range_s
+{
+  uint64_t sector;
+  uint32_t num_sectors;
+  uint32_t flags;
+} end_packed_struct;
+
 begin_packed_struct struct virtio_blk_config_s
 {
   uint64_t capacity;
@@ -112,13 +143,44 @@ begin_packed_struct struct virtio_blk_config_s
   uint32_t secure_erase_sector_alignment;
 } end_packed_struct;
 
+/* One request on the virtqueue, used as its cookie.  The synchronous
+ * requests are waited for with 'sem'.  The asynchronous ones complete the
+ * block requests merged into 'blkreq' on the work queue.
+ */
+
+struct virtio_blk_cmd_s
+{
+  sq_entry_t                    node;           /* In the done or wait list */
+  struct virtio_blk_req_s       req;            /* Block out header */
+  struct virtio_blk_resp_s      resp;           /* Block in header */
+  FAR sem_t                    *sem;            /* Synchronous completion */
+  FAR struct virtqueue_buf     *vb;             /* Synchronous buffers */
+  int                           readable;       /* Device readable buffers */
+  int                           writable;       /* Device writable buffers */
+#ifdef CONFIG_FS_BLKQUEUE
+  FAR struct blk_req_s         *blkreq;         /* Asynchronous requests */
+  FAR struct blk_req_s         *last;           /* The last one of them */
+  unsigned int                  nsegs;          /* Number of them */
+#endif
+};
+
 struct virtio_blk_priv_s
 {
   FAR struct virtio_device     *vdev;           /* Virtio deivce */
   spinlock_t                    lock;           /* Lock */
   uint64_t                      nsectors;       /* Sectore numbers */
   uint32_t                      block_size;     /* Block size */
+  uint32_t                      max_discard;    /* Discard sectors limit */
+  uint32_t                      max_zeroes;     /* Write zeroes limit */
   char                          name[NAME_MAX]; /* Device name */
+#ifdef CONFIG_FS_BLKQUEUE
+  mutex_t                       submitlock;     /* Protects 'held' */
+  FAR struct virtio_blk_cmd_s  *held;           /* Plugged requests */
+  unsigned int                  seg_max;        /* Segments of a request */
+  sq_queue_t                    waiting;        /* Did not fit the vq */
+  sq_queue_t                    done;           /* Completed, not reported */
+  struct work_s                 work;           /* Reports the completions */
+#endif
 };
 
 /****************************************************************************
@@ -143,6 +205,11 @@ static int     virtio_blk_geometry(FAR struct inode *inode,
 static int     virtio_blk_ioctl(FAR struct inode *inode, int cmd,
                                 unsigned long arg);
 static int     virtio_blk_flush(FAR struct virtio_blk_priv_s *priv);
+#ifdef CONFIG_FS_BLKQUEUE
+static int     virtio_blk_submit(FAR struct inode *inode,
+                                 FAR struct blk_req_s *req);
+static void    virtio_blk_worker(FAR void *arg);
+#endif
 
 /* Other functions */
 
@@ -173,6 +240,12 @@ static const struct block_operations g_virtio_blk_bops =
   virtio_blk_write,    /* write    */
   virtio_blk_geometry, /* geometry */
   virtio_blk_ioctl     /* ioctl    */
+#ifdef CONFIG_FS_BLKQUEUE
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL               /* unlink   */
+#endif
+  , virtio_blk_submit  /* submit   */
+#endif
 };
 
 static int g_virtio_blk_idx = 0;
@@ -181,6 +254,222 @@ static int g_virtio_blk_idx = 0;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: virtio_blk_addcmd
+ *
+ * Description:
+ *   Add a request to the virtqueue and notify the device.
+ *
+ * Assumptions:
+ *   priv->lock is held.
+ *
+ ****************************************************************************/
+
+static int virtio_blk_addcmd(FAR struct virtio_blk_priv_s *priv,
+                             FAR struct virtio_blk_cmd_s *cmd)
+{
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[0].vq;
+  int ret;
+
+#ifdef CONFIG_FS_BLKQUEUE
+  if (cmd->blkreq != NULL)
+    {
+      struct virtqueue_buf vb[VIRTIO_BLK_MAXSEGS + 2];
+      FAR struct blk_req_s *req;
+      int nvb = 0;
+
+      /* The block out header, the data of each merged request and the
+       * block in header.
+       */
+
+      vb[nvb].buf = &cmd->req;
+      vb[nvb++].len = VIRTIO_BLK_REQ_HEADER_SIZE;
+
+      for (req = cmd->blkreq; req != NULL; req = req->next)
+        {
+          vb[nvb].buf = req->buffer;
+          vb[nvb++].len = req->nsectors * priv->block_size;
+        }
+
+      vb[nvb].buf = &cmd->resp;
+      vb[nvb++].len = VIRTIO_BLK_RESP_HEADER_SIZE;
+
+      if (cmd->blkreq->write)
+        {
+          ret = virtqueue_add_buffer(vq, vb, nvb - 1, 1, cmd);
+        }
+      else
+        {
+          ret = virtqueue_add_buffer(vq, vb, 1, nvb - 1, cmd);
+        }
+    }
+  else
+#endif
+    {
+      ret = virtqueue_add_buffer(vq, cmd->vb, cmd->readable, cmd->writable,
+                                 cmd);
+    }
+
+  if (ret >= 0)
+    {
+      virtqueue_kick(vq);
+    }
+
+  return ret;
+}
+
+#ifdef CONFIG_FS_BLKQUEUE
+
+/****************************************************************************
+ * Name: virtio_blk_dispatch
+ *
+ * Description:
+ *   Pass a request to the device, or let it wait until the requests in
+ *   flight free enough descriptors.
+ *
+ ****************************************************************************/
+
+static void virtio_blk_dispatch(FAR struct virtio_blk_priv_s *priv,
+                                FAR struct virtio_blk_cmd_s *cmd)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&priv->lock);
+  if (!sq_empty(&priv->waiting) || virtio_blk_addcmd(priv, cmd) < 0)
+    {
+      sq_addlast(&cmd->node, &priv->waiting);
+    }
+
+  spin_unlock_irqrestore(&priv->lock, flags);
+}
+
+/****************************************************************************
+ * Name: virtio_blk_complete
+ *
+ * Description:
+ *   Split the result of an asynchronous request across the block requests
+ *   merged into it, in order, call their completions and free it.
+ *
+ ****************************************************************************/
+
+static void virtio_blk_complete(FAR struct virtio_blk_cmd_s *cmd,
+                                ssize_t ret)
+{
+  FAR struct blk_req_s *req = cmd->blkreq;
+  FAR struct blk_req_s *next;
+
+  kmm_free(cmd);
+
+  while (req != NULL)
+    {
+      /* The completion may free the request */
+
+      next = req->next;
+
+      if (ret < 0)
+        {
+          req->result = ret;
+        }
+      else
+        {
+          req->result = MIN(ret, (ssize_t)req->nsectors);
+          ret        -= req->result;
+        }
+
+      req->complete(req);
+      req = next;
+    }
+}
+
+/****************************************************************************
+ * Name: virtio_blk_worker
+ *
+ * Description:
+ *   Pass the waiting requests to the device, now that some completed, and
+ *   report the completed asynchronous requests.
+ *
+ ****************************************************************************/
+
+static void virtio_blk_worker(FAR void *arg)
+{
+  FAR struct virtio_blk_priv_s *priv = arg;
+  FAR struct virtio_blk_cmd_s *cmd;
+  irqstate_t flags;
+  sq_queue_t done;
+
+  flags = spin_lock_irqsave(&priv->lock);
+
+  while ((cmd = (FAR struct virtio_blk_cmd_s *)
+                sq_peek(&priv->waiting)) != NULL)
+    {
+      if (virtio_blk_addcmd(priv, cmd) < 0)
+        {
+          break;
+        }
+
+      sq_remfirst(&priv->waiting);
+    }
+
+  sq_move(&priv->done, &done);
+  spin_unlock_irqrestore(&priv->lock, flags);
+
+  while ((cmd = (FAR struct virtio_blk_cmd_s *)sq_remfirst(&done)) != NULL)
+    {
+      if (cmd->resp.status != VIRTIO_BLK_S_OK)
+        {
+          vrterr("%s Error\n", cmd->blkreq->write ? "Write" : "Read");
+          virtio_blk_complete(cmd, -EIO);
+        }
+      else
+        {
+          virtio_blk_complete(cmd, cmd->blkreq->total);
+        }
+    }
+}
+
+#endif /* CONFIG_FS_BLKQUEUE */
+
+/****************************************************************************
+ * Name: virtio_blk_handle
+ *
+ * Description:
+ *   Handle a request that the device has completed.
+ *
+ ****************************************************************************/
+
+static void virtio_blk_handle(FAR struct virtio_blk_priv_s *priv,
+                              FAR struct virtio_blk_cmd_s *cmd)
+{
+#ifdef CONFIG_FS_BLKQUEUE
+  irqstate_t flags;
+
+  if (cmd->blkreq != NULL)
+    {
+      /* The block requests are completed on the work queue, where their
+       * completions may submit the next ones.
+       */
+
+      flags = spin_lock_irqsave(&priv->lock);
+      sq_addlast(&cmd->node, &priv->done);
+      spin_unlock_irqrestore(&priv->lock, flags);
+    }
+  else
+    {
+      nxsem_post(cmd->sem);
+    }
+
+  /* Some descriptors are free again for the waiting requests */
+
+  if ((cmd->blkreq != NULL || !sq_empty(&priv->waiting)) &&
+      work_available(&priv->work))
+    {
+      work_queue(LPWORK, &priv->work, virtio_blk_worker, priv, 0);
+    }
+#else
+  nxsem_post(cmd->sem);
+#endif
+}
+
 /****************************************************************************
  * Name: virtio_blk_wait_complete
  *
@@ -190,76 +479,59 @@ static int g_virtio_blk_idx = 0;
  ****************************************************************************/
 
 static void virtio_blk_wait_complete(FAR struct virtqueue *vq,
-                                     FAR sem_t *respsem)
+                                     FAR struct virtio_blk_cmd_s *respcmd)
 {
   FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
-  FAR sem_t *sem;
+  FAR struct virtio_blk_cmd_s *cmd;
 
   if (up_interrupt_context())
     {
       for (; ; )
         {
-          sem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
-          if (sem == respsem)
+          cmd = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
+          if (cmd == respcmd)
             {
               break;
             }
-          else if (sem != NULL)
+          else if (cmd != NULL)
             {
-              nxsem_post(sem);
+              virtio_blk_handle(priv, cmd);
             }
         }
     }
   else
     {
-      nxsem_wait_uninterruptible(respsem);
+      nxsem_wait_uninterruptible(respcmd->sem);
     }
 }
 
 /****************************************************************************
- * Name: virtio_blk_rdwr
+ * Name: virtio_blk_sync
  *
  * Description:
- *   Common function for read and write
+ *   Add a request to the virtqueue and wait for its completion.
  *
  ****************************************************************************/
 
-static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
-                               FAR void *buffer, blkcnt_t startsector,
-                               unsigned int nsectors, bool write)
+static int virtio_blk_sync(FAR struct virtio_blk_priv_s *priv,
+                           FAR struct virtio_blk_cmd_s *cmd,
+                           FAR struct virtqueue_buf *vb,
+                           int readable, int writable)
 {
-  FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
-  FAR struct virtqueue_buf vb[3];
-  struct virtio_blk_resp_s resp;
-  struct virtio_blk_req_s req;
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[0].vq;
   irqstate_t flags;
   sem_t respsem;
-  ssize_t ret;
-  int readnum;
+  int ret;
 
   nxsem_init(&respsem, 0, 0);
-
-  /* Build the block request */
-
-  req.type     = write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
-  req.reserved = 0;
-  req.sector   = startsector * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
-  resp.status  = VIRTIO_BLK_S_IOERR;
-
-  /* Fill the virtqueue buffer:
-   * Buffer 0: the block out header;
-   * Buffer 1: the read/write buffer;
-   * Buffer 2: the block in header, return the status.
-   */
-
-  vb[0].buf = &req;
-  vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
-  vb[1].buf = buffer;
-  vb[1].len = nsectors * priv->block_size;
-  vb[2].buf = &resp;
-  vb[2].len = VIRTIO_BLK_RESP_HEADER_SIZE;
-  readnum = write ? 2 : 1;
+  cmd->sem         = &respsem;
+  cmd->vb          = vb;
+  cmd->readable    = readable;
+  cmd->writable    = writable;
+  cmd->resp.status = VIRTIO_BLK_S_IOERR;
+#ifdef CONFIG_FS_BLKQUEUE
+  cmd->blkreq      = NULL;
+#endif
 
   if (up_interrupt_context())
     {
@@ -267,25 +539,44 @@ static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
     }
 
   flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, readnum, 3 - readnum, &respsem);
-  if (ret < 0)
+#ifdef CONFIG_FS_BLKQUEUE
+  if (!up_interrupt_context() && !sq_empty(&priv->waiting))
     {
-      spin_unlock_irqrestore(&priv->lock, flags);
-      vrterr("virtqueue_add_buffer failed, ret=%zd\n", ret);
-      goto err;
+      /* Queue behind the asynchronous requests, in order */
+
+      sq_addlast(&cmd->node, &priv->waiting);
+      ret = OK;
     }
+  else
+#endif
+    {
+      ret = virtio_blk_addcmd(priv, cmd);
+    }
+
+#ifdef CONFIG_FS_BLKQUEUE
+  if (ret < 0 && !up_interrupt_context())
+    {
+      /* The asynchronous requests fill the virtqueue, wait for them */
+
+      sq_addlast(&cmd->node, &priv->waiting);
+      ret = OK;
+    }
+#endif
 
-  virtqueue_kick(vq);
   spin_unlock_irqrestore(&priv->lock, flags);
+  if (ret < 0)
+    {
+      vrterr("virtqueue_add_buffer failed, ret=%d\n", ret);
+      goto err;
+    }
 
   /* Wait for the request completion */
 
-  virtio_blk_wait_complete(vq, &respsem);
+  virtio_blk_wait_complete(vq, cmd);
 
-  if (resp.status != VIRTIO_BLK_S_OK)
+  if (cmd->resp.status != VIRTIO_BLK_S_OK)
     {
-      vrterr("%s Error\n", write ? "Write" : "Read");
-      ret = -EIO;
+      ret = cmd->resp.status == VIRTIO_BLK_S_UNSUPP ? -ENOTSUP : -EIO;
     }
 
 err:
@@ -294,7 +585,56 @@ err:
       virtqueue_enable_cb_lock(vq, &priv->lock);
     }
 
-  return ret >= 0 ? nsectors : ret;
+  nxsem_destroy(&respsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: virtio_blk_rdwr
+ *
+ * Description:
+ *   Common function for read and write
+ *
+ ****************************************************************************/
+
+static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
+                               FAR void *buffer, blkcnt_t startsector,
+                               unsigned int nsectors, bool write)
+{
+  FAR struct virtqueue_buf vb[3];
+  struct virtio_blk_cmd_s cmd;
+  int readnum;
+  int ret;
+
+  /* Build the block request */
+
+  cmd.req.type     = write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
+  cmd.req.reserved = 0;
+  cmd.req.sector   = startsector * priv->block_size >>
+                     VIRTIO_BLK_SECTOR_BITS;
+
+  /* Fill the virtqueue buffer:
+   * Buffer 0: the block out header;
+   * Buffer 1: the read/write buffer;
+   * Buffer 2: the block in header, return the status.
+   */
+
+  vb[0].buf = &cmd.req;
+  vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
+  vb[1].buf = buffer;
+  vb[1].len = nsectors * priv->block_size;
+  vb[2].buf = &cmd.resp;
+  vb[2].len = VIRTIO_BLK_RESP_HEADER_SIZE;
+  readnum = write ? 2 : 1;
+
+  ret = virtio_blk_sync(priv, &cmd, vb, readnum, 3 - readnum);
+  if (ret < 0)
+    {
+      vrterr("%s Error\n", write ? "Write" : "Read");
+      return ret;
+    }
+
+  return nsectors;
 }
 
 /****************************************************************************
@@ -399,52 +739,99 @@ static int virtio_blk_geometry(FAR struct inode *inode,
 }
 
 /****************************************************************************
- * Name: virtio_blk_ioctl
+ * Name: virtio_blk_flush
  ****************************************************************************/
 
 static int virtio_blk_flush(FAR struct virtio_blk_priv_s *priv)
 {
-  FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
   FAR struct virtqueue_buf vb[2];
-  struct virtio_blk_resp_s resp;
-  struct virtio_blk_req_s req;
-  irqstate_t flags;
-  sem_t respsem;
+  struct virtio_blk_cmd_s cmd;
   int ret;
 
-  nxsem_init(&respsem, 0, 0);
-
   /* Build the block request */
 
-  req.type     = VIRTIO_BLK_T_FLUSH;
-  req.reserved = 0;
-  req.sector   = 0;
-  resp.status  = VIRTIO_BLK_S_IOERR;
+  cmd.req.type     = VIRTIO_BLK_T_FLUSH;
+  cmd.req.reserved = 0;
+  cmd.req.sector   = 0;
 
-  vb[0].buf = &req;
+  vb[0].buf = &cmd.req;
   vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
-  vb[1].buf = &resp;
+  vb[1].buf = &cmd.resp;
   vb[1].len = VIRTIO_BLK_RESP_HEADER_SIZE;
 
-  flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, 1, 1, &respsem);
+  ret = virtio_blk_sync(priv, &cmd, vb, 1, 1);
   if (ret < 0)
     {
-      spin_unlock_irqrestore(&priv->lock, flags);
-      return ret;
+      vrterr("Flush Error\n");
     }
 
-  virtqueue_kick(vq);
-  spin_unlock_irqrestore(&priv->lock, flags);
+  return ret;
+}
 
-  /* Wait for the request completion */
+/****************************************************************************
+ * Name: virtio_blk_range
+ *
+ * Description:
+ *   Discard or write zeroes to a range of sectors, in as many requests as
+ *   the limit of the device needs.
+ *
+ ****************************************************************************/
 
-  nxsem_wait_uninterruptible(&respsem);
-  if (resp.status != VIRTIO_BLK_S_OK)
+static int virtio_blk_range(FAR struct virtio_blk_priv_s *priv,
+                            FAR const struct blk_range_s *range,
+                            uint32_t type, uint32_t max)
+{
+  FAR struct virtqueue_buf vb[3];
+  struct virtio_blk_range_s seg;
+  struct virtio_blk_cmd_s cmd;
+  uint64_t sector;
+  uint64_t nsectors;
+  int ret = OK;
+
+  if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_RO))
     {
-      vrterr("Flush Error\n");
-      ret = -EIO;
+      return -EPERM;
+    }
+
+  if (range->start < 0 || range->nsectors < 0 ||
+      range->start > priv->nsectors ||
+      range->nsectors > priv->nsectors - range->start)
+    {
+      return -EINVAL;
+    }
+
+  /* The limits and the ranges count in 512-byte sectors */
+
+  sector   = range->start * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
+  nsectors = range->nsectors * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
+
+  vb[0].buf = &cmd.req;
+  vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
+  vb[1].buf = &seg;
+  vb[1].len = sizeof(seg);
+  vb[2].buf = &cmd.resp;
+  vb[2].len = VIRTIO_BLK_RESP_HEADER_SIZE;
+
+  while (nsectors > 0)
+    {
+      cmd.req.type     = type;
+      cmd.req.reserved = 0;
+      cmd.req.sector   = 0;
+
+      seg.sector      = sector;
+      seg.num_sectors = MIN(nsectors, max);
+      seg.flags       = 0;
+
+      ret = virtio_blk_sync(priv, &cmd, vb, 2, 1);
+      if (ret < 0)
+        {
+          vrterr("%s Error\n", type == VIRTIO_BLK_T_DISCARD ?
+                 "Discard" : "Write zeroes");
+          break;
+        }
+
+      sector   += seg.num_sectors;
+      nsectors -= seg.num_sectors;
     }
 
   return ret;
@@ -471,11 +858,124 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
             ret = virtio_blk_flush(priv);
           }
         break;
+
+      case BIOC_DISCARD:
+        if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_DISCARD))
+          {
+            ret = virtio_blk_range(priv,
+                                   (FAR const struct blk_range_s *)arg,
+                                   VIRTIO_BLK_T_DISCARD, priv->max_discard);
+          }
+        break;
+
+      case BIOC_ZEROOUT:
+        if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_WRITE_ZEROES))
+          {
+            ret = virtio_blk_range(priv,
+                                   (FAR const struct blk_range_s *)arg,
+                                   VIRTIO_BLK_T_WRITE_ZEROES,
+                                   priv->max_zeroes);
+          }
+        break;
     }
 
   return ret;
 }
 
+/****************************************************************************
+ * Name: virtio_blk_submit
+ *
+ * Description:
+ *   Start an asynchronous block request.  The requests go to the device at
+ *   once, so that it has many of them in flight.  A request that continues
+ *   a plugged one in the same direction is merged into it as one more data
+ *   segment, the memory of them needs not be contiguous.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLKQUEUE
+static int virtio_blk_submit(FAR struct inode *inode,
+                             FAR struct blk_req_s *req)
+{
+  FAR struct virtio_blk_priv_s *priv;
+  FAR struct virtio_blk_cmd_s *held;
+  FAR struct virtio_blk_cmd_s *cmd;
+  int ret;
+
+  DEBUGASSERT(inode->i_private);
+  priv = inode->i_private;
+
+  if (req->write && virtio_has_feature(priv->vdev, VIRTIO_BLK_F_RO))
+    {
+      return -EPERM;
+    }
+
+  cmd = kmm_malloc(sizeof(*cmd));
+  if (cmd == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = nxmutex_lock(&priv->submitlock);
+  if (ret < 0)
+    {
+      kmm_free(cmd);
+      return ret;
+    }
+
+  req->next  = NULL;
+  req->total = req->nsectors;
+
+  held = priv->held;
+  if (held != NULL && held->last->write == req->write &&
+      held->last->start + held->last->nsectors == req->start &&
+      held->nsegs < priv->seg_max)
+    {
+      held->last->next      = req;
+      held->last            = req;
+      held->blkreq->total  += req->nsectors;
+      held->nsegs++;
+    }
+  else
+    {
+      if (held != NULL)
+        {
+          virtio_blk_dispatch(priv, held);
+        }
+
+      cmd->req.type     = req->write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
+      cmd->req.reserved = 0;
+      cmd->req.sector   = req->start * priv->block_size >>
+                          VIRTIO_BLK_SECTOR_BITS;
+      cmd->resp.status  = VIRTIO_BLK_S_IOERR;
+      cmd->sem          = NULL;
+      cmd->blkreq       = req;
+      cmd->last         = req;
+      cmd->nsegs        = 1;
+
+      priv->held = cmd;
+      cmd        = NULL;
+    }
+
+  if (!req->plug)
+    {
+      virtio_blk_dispatch(priv, priv->held);
+      priv->held = NULL;
+    }
+
+  nxmutex_unlock(&priv->submitlock);
+
+  /* The request was merged, the new one is not needed */
+
+  if (cmd != NULL)
+    {
+      kmm_free(cmd);
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_blk_done
  ****************************************************************************/
@@ -483,17 +983,17 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
 static void virtio_blk_done(FAR struct virtqueue *vq)
 {
   FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
-  FAR sem_t *respsem;
+  FAR struct virtio_blk_cmd_s *cmd;
 
   for (; ; )
     {
-      respsem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
-      if (respsem == NULL)
+      cmd = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
+      if (cmd == NULL)
         {
           break;
         }
 
-      nxsem_post(respsem);
+      virtio_blk_handle(priv, cmd);
     }
 }
 
@@ -511,13 +1011,21 @@ static int virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
   priv->vdev = vdev;
   vdev->priv = priv;
   spin_lock_init(&priv->lock);
+#ifdef CONFIG_FS_BLKQUEUE
+  nxmutex_init(&priv->submitlock);
+  sq_init(&priv->waiting);
+  sq_init(&priv->done);
+#endif
 
   /* Initialize the virtio device */
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
-  virtio_negotiate_features(vdev, (1UL << VIRTIO_BLK_F_RO) |
+  virtio_negotiate_features(vdev, (1UL << VIRTIO_BLK_F_SEG_MAX) |
+                                  (1UL << VIRTIO_BLK_F_RO) |
                                   (1UL << VIRTIO_BLK_F_BLK_SIZE) |
-                                  (1UL << VIRTIO_BLK_F_FLUSH), NULL);
+                                  (1UL << VIRTIO_BLK_F_FLUSH) |
+                                  (1UL << VIRTIO_BLK_F_DISCARD) |
+                                  (1UL << VIRTIO_BLK_F_WRITE_ZEROES), NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
   vqname[0]   = "virtio_blk_vq";
@@ -590,6 +1098,39 @@ static int virtio_blk_probe(FAR struct virtio_device *vdev)
       priv->block_size = VIRTIO_BLK_SECTOR_SIZE;
     }
 
+  priv->max_discard = UINT32_MAX;
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_DISCARD))
+    {
+      virtio_read_config_member(priv->vdev, struct virtio_blk_config_s,
+                                max_discard_sectors, &priv->max_discard);
+    }
+
+  priv->max_zeroes = UINT32_MAX;
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_WRITE_ZEROES))
+    {
+      virtio_read_config_member(priv->vdev, struct virtio_blk_config_s,
+                                max_write_zeroes_sectors, &priv->max_zeroes);
+    }
+
+#ifdef CONFIG_FS_BLKQUEUE
+  /* A request needs a descriptor for each data segment and two for the
+   * headers, all of them must fit into the virtqueue.
+   */
+
+  priv->seg_max = MIN(VIRTIO_BLK_MAXSEGS,
+                      vdev->vrings_info[0].vq->vq_nentries - 2);
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_SEG_MAX))
+    {
+      uint32_t seg_max;
+
+      virtio_read_config_member(priv->vdev, struct virtio_blk_config_s,
+                                seg_max, &seg_max);
+      priv->seg_max = MIN(priv->seg_max, seg_max);
+    }
+
+  priv->seg_max = MAX(priv->seg_max, 1);
+#endif
+
   /* Register block driver */
 
   snprintf(priv->name, NAME_MAX, "/dev/virtblk%d", g_virtio_blk_idx);
@@ -617,9 +1158,48 @@ err_with_priv:
 static void virtio_blk_remove(FAR struct virtio_device *vdev)
 {
   FAR struct virtio_blk_priv_s *priv = vdev->priv;
+#ifdef CONFIG_FS_BLKQUEUE
+  FAR struct virtio_blk_cmd_s *cmd;
+#endif
 
   unregister_driver(priv->name);
   virtio_blk_uninit(priv);
+
+#ifdef CONFIG_FS_BLKQUEUE
+  /* Report the completed requests and fail the ones that did not reach the
+   * device.
+   */
+
+  work_cancel_sync(LPWORK, &priv->work);
+
+  while ((cmd = (FAR struct virtio_blk_cmd_s *)
+                sq_remfirst(&priv->done)) != NULL)
+    {
+      virtio_blk_complete(cmd, cmd->resp.status == VIRTIO_BLK_S_OK ?
+                               (ssize_t)cmd->blkreq->total : -EIO);
+    }
+
+  if (priv->held != NULL)
+    {
+      virtio_blk_complete(priv->held, -ENODEV);
+    }
+
+  while ((cmd = (FAR struct virtio_blk_cmd_s *)
+                sq_remfirst(&priv->waiting)) != NULL)
+    {
+      if (cmd->blkreq != NULL)
+        {
+          virtio_blk_complete(cmd, -ENODEV);
+        }
+      else
+        {
+          nxsem_post(cmd->sem);
+        }
+    }
+
+  nxmutex_destroy(&priv->submitlock);
+#endif
+
   kmm_free(priv);
 }
 
@@ -30,6 +30,7 @@
 #include <sys/param.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/dmaalloc.h>
 #include <nuttx/virtio/virtio.h>
 #include <nuttx/virtio/virtio-mmio.h>
 
@@ -767,7 +768,7 @@ static int virtio_mmio_interrupt(int irq, FAR void *context, FAR void *arg)
 static FAR void *virtio_mmio_alloc_buf(FAR struct virtio_device *vdev,
                                        size_t size, size_t align)
 {
-  return kmm_memalign(align, size);
+  return mm_dmamemalign(align, size);
 }
 
 /****************************************************************************
@@ -777,7 +778,7 @@ static FAR void *virtio_mmio_alloc_buf(FAR struct virtio_device *vdev,
 static void virtio_mmio_free_buf(FAR struct virtio_device *vdev,
                                  FAR void *buf)
 {
-  kmm_free(buf);
+  mm_dmafree(buf);
 }
 
 /****************************************************************************
@@ -31,6 +31,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/virtio/virtio.h>
 #include <nuttx/net/wifi_sim.h>
 
@@ -42,7 +43,22 @@
 
 /* Virtio net feature bits */
 
-#define VIRTIO_NET_F_MAC      5
+#define VIRTIO_NET_F_CSUM       0
+#define VIRTIO_NET_F_GUEST_CSUM 1
+#define VIRTIO_NET_F_MAC        5
+#define VIRTIO_NET_F_CTRL_VQ    17
+#define VIRTIO_NET_F_MQ         22
+
+/* Virtio net control commands */
+
+#define VIRTIO_NET_CTRL_MQ              4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET 0
+#define VIRTIO_NET_OK                   0
+
+/* Virtio net header flags */
+
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM 1
+#define VIRTIO_NET_HDR_F_DATA_VALID 2
 
 /* Virtio net header size and packet buffer size */
 
@@ -50,12 +66,35 @@
 #define VIRTIO_NET_LLHDRSIZE  (sizeof(struct virtio_net_llhdr_s))
 #define VIRTIO_NET_BUFSIZE    (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE)
 
-/* Virtio net virtqueue index and number */
+/* Virtio net virtqueue index and number.  The RX and TX virtqueues of the
+ * queue pairs alternate, the control virtqueue follows the last pair.
+ */
 
 #define VIRTIO_NET_RX         0
 #define VIRTIO_NET_TX         1
 #define VIRTIO_NET_NUM        2
 
+#define VIRTIO_NET_RXQ(q)     ((q) * VIRTIO_NET_NUM + VIRTIO_NET_RX)
+#define VIRTIO_NET_TXQ(q)     ((q) * VIRTIO_NET_NUM + VIRTIO_NET_TX)
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+#  define VIRTIO_NET_MAXPAIRS CONFIG_SMP_NCPUS
+#else
+#  define VIRTIO_NET_MAXPAIRS 1
+#endif
+
+#define VIRTIO_NET_MAXVQS     (VIRTIO_NET_MAXPAIRS * VIRTIO_NET_NUM + 1)
+
+/* Number of RX buffers allocated at once when refilling the RX ring */
+
+#define VIRTIO_NET_RXBATCH    8
+
+/* Number of TX buffers queued before the device is notified even if the
+ * burst of packets from the upper half is not complete yet
+ */
+
+#define VIRTIO_NET_TXBATCH    16
+
 #define VIRTIO_NET_MAX_PKT_SIZE \
     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN) + VIRTIO_NET_BUFSIZE)
 #define VIRTIO_NET_MAX_NIOB \
@@ -65,8 +104,8 @@
  * Private Types
  ****************************************************************************/
 
-/* Virtio net header, just define it here for further, now only use it
- * to calculate the virto net header size, see marco VIRTIO_NET_HDRSIZE
+/* Virtio net header, the checksum fields are only used when checksum
+ * offload is negotiated, see CONFIG_NETDEV_CHECKSUM_OFFLOAD
  */
 
 begin_packed_struct struct virtio_net_hdr_s
@@ -97,6 +136,16 @@ begin_packed_struct struct virtio_net_config_s
   uint32_t supported_hash_types;
 } end_packed_struct;
 
+/* Virtio net control command, VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET only */
+
+begin_packed_struct struct virtio_net_ctrl_s
+{
+  uint8_t  class;
+  uint8_t  cmd;
+  uint16_t pairs;
+  uint8_t  ack;
+} end_packed_struct;
+
 struct virtio_net_priv_s
 {
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -110,12 +159,23 @@ struct virtio_net_priv_s
   struct netdev_lowerhalf_s lower;     /* The netdev lowerhalf */
 #endif
 
-  spinlock_t                lock[VIRTIO_NET_NUM];
+  spinlock_t                lock[VIRTIO_NET_MAXVQS];
 
   /* Virtio device information */
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
-  int                       bufnum;    /* TX and RX Buffer number */
+  int                       bufnum;    /* TX and RX Buffer number per queue */
+  int                       npairs;    /* Number of RX/TX queue pairs */
+
+  /* The RX buffers in each RX virtqueue and the TX buffers that were not
+   * notified yet to the device in each TX virtqueue
+   */
+
+  int                       rxnum[VIRTIO_NET_MAXPAIRS];
+  int                       txnum[VIRTIO_NET_MAXPAIRS];
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  sem_t                     ctrlsem;   /* Control command completion */
+#endif
 };
 
 /* Virtio Link Layer Header, follow shows the iob buffer layout:
@@ -152,6 +212,10 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev);
 static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
                            FAR netpkt_t *pkt);
 static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev);
+static int virtio_net_send_queue(FAR struct netdev_lowerhalf_s *dev,
+                                 FAR netpkt_t *pkt, unsigned int queue);
+static netpkt_t *virtio_net_recv_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       unsigned int queue);
 #ifdef CONFIG_NET_MCASTGROUP
 static int virtio_net_addmac(FAR struct netdev_lowerhalf_s *dev,
                              FAR const uint8_t *mac);
@@ -163,6 +227,8 @@ static int virtio_net_ioctl(FAR struct netdev_lowerhalf_s *dev,
                             int cmd, unsigned long arg);
 #endif
 static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev);
+static void virtio_net_txflush(FAR struct netdev_lowerhalf_s *dev,
+                               unsigned int queue);
 
 static int  virtio_net_probe(FAR struct virtio_device *vdev);
 static void virtio_net_remove(FAR struct virtio_device *vdev);
@@ -192,7 +258,16 @@ static const struct netdev_ops_s g_virtio_net_ops =
 #ifdef CONFIG_NETDEV_IOCTL
   virtio_net_ioctl,
 #endif
-  virtio_net_txfree
+  virtio_net_txfree,
+#ifdef CONFIG_NETDEV_NAPI
+  NULL,
+  NULL,
+#endif
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  virtio_net_send_queue,
+  virtio_net_recv_queue,
+#endif
+  virtio_net_txflush
 };
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -215,6 +290,10 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
   FAR struct virtio_net_llhdr_s *hdr;
   struct virtqueue_buf vb[VIRTIO_NET_MAX_NIOB + 1];
   struct iovec iov[VIRTIO_NET_MAX_NIOB];
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+  uint16_t start;
+  uint16_t offset;
+#endif
   int iov_cnt;
   int i;
 
@@ -230,6 +309,19 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
   memset(&hdr->vhdr, 0, sizeof(hdr->vhdr));
   hdr->pkt = pkt;
 
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+  /* Let the device fill in the TCP/UDP checksum */
+
+  if (vq_id % VIRTIO_NET_NUM == VIRTIO_NET_TX &&
+      NETDEV_TXCSUM(&dev->netdev) &&
+      netpkt_csum_partial(dev, pkt, &start, &offset) == OK)
+    {
+      hdr->vhdr.flags       = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+      hdr->vhdr.csum_start  = start;
+      hdr->vhdr.csum_offset = offset;
+    }
+#endif
+
   /* Prepare buffers depends on the feature VIRTIO_F_ANY_LAYOUT */
 
   if (virtio_has_feature(priv->vdev, VIRTIO_F_ANY_LAYOUT))
@@ -264,7 +356,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
     }
 
   vrtinfo("Fill vq=%u, hdr=%p, count=%d\n", vq_id, hdr, iov_cnt);
-  if (vq_id == VIRTIO_NET_RX)
+  if (vq_id % VIRTIO_NET_NUM == VIRTIO_NET_RX)
     {
       return virtqueue_add_buffer_lock(vq, vb, 0, iov_cnt, hdr,
                                        &priv->lock[vq_id]);
@@ -280,61 +372,103 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
  * Name: virtio_net_rxfill
  ****************************************************************************/
 
-static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev,
+                              unsigned int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
-  FAR netpkt_t *pkt;
-  int i;
-
-  for (i = 0; i < priv->bufnum; i++)
+  unsigned int vq_id = VIRTIO_NET_RXQ(queue);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
+  FAR netpkt_t *pkts[VIRTIO_NET_RXBATCH];
+  int npkts;
+  int i = 0;
+  int j;
+
+  while (priv->rxnum[queue] < priv->bufnum)
     {
-      /* IOB Offload, Alloc buffer from RX netpkt */
+      /* IOB Offload, Alloc a batch of buffers from RX netpkt */
 
-      pkt = netpkt_alloc(dev, NETPKT_RX);
-      if (pkt == NULL)
+      npkts = netpkt_alloc_multiple(dev, NETPKT_RX, pkts,
+                                    MIN(priv->bufnum - priv->rxnum[queue],
+                                        VIRTIO_NET_RXBATCH));
+      if (npkts == 0)
         {
           vrtinfo("Has ran out of the RX buffer, i=%d\n", i);
           break;
         }
 
-      /* Preserve data length */
-
-      if (netpkt_setdatalen(dev, pkt, VIRTIO_NET_BUFSIZE) <
-          VIRTIO_NET_BUFSIZE)
+      for (j = 0; j < npkts; j++, i++)
         {
-          vrtwarn("No enough buffer to prepare RX buffer, i=%d\n", i);
-          netpkt_free(dev, pkt, NETPKT_RX);
-          break;
+          /* Preserve data length */
+
+          if (netpkt_setdatalen(dev, pkts[j], VIRTIO_NET_BUFSIZE) <
+              VIRTIO_NET_BUFSIZE)
+            {
+              vrtwarn("No enough buffer to prepare RX buffer, i=%d\n", i);
+              break;
+            }
+
+          /* Add buffer to RX virtqueue */
+
+          virtio_net_addbuffer(dev, vq, pkts[j], vq_id);
+          priv->rxnum[queue]++;
         }
 
-      /* Add buffer to RX virtqueue */
+      if (j < npkts)
+        {
+          /* Release the rest of the batch */
+
+          for (; j < npkts; j++)
+            {
+              netpkt_free(dev, pkts[j], NETPKT_RX);
+            }
 
-      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RX);
+          break;
+        }
     }
 
   if (i > 0)
     {
-      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+      virtqueue_kick_lock(vq, &priv->lock[vq_id]);
     }
 }
 
 /****************************************************************************
- * Name: virtio_net_txfree
+ * Name: virtio_net_txkick
+ *
+ * Description:
+ *   Notify the device of the TX buffers queued since the last notification.
+ *   With VIRTIO_RING_F_EVENT_IDX, the notification is skipped if the device
+ *   is still busy with the buffers queued before.
+ *
  ****************************************************************************/
 
-static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_txkick(FAR struct virtio_net_priv_s *priv,
+                              unsigned int queue)
+{
+  unsigned int vq_id = VIRTIO_NET_TXQ(queue);
+
+  priv->txnum[queue] = 0;
+  virtqueue_kick_lock(priv->vdev->vrings_info[vq_id].vq,
+                      &priv->lock[vq_id]);
+}
+
+/****************************************************************************
+ * Name: virtio_net_txfree_queue
+ ****************************************************************************/
+
+static void virtio_net_txfree_queue(FAR struct netdev_lowerhalf_s *dev,
+                                    unsigned int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  unsigned int vq_id = VIRTIO_NET_TXQ(queue);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
   FAR struct virtio_net_llhdr_s *hdr;
 
   while (1)
     {
       /* Get buffer from tx virtqueue */
 
-      hdr = virtqueue_get_buffer_lock(vq, NULL, NULL,
-                                      &priv->lock[VIRTIO_NET_TX]);
+      hdr = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock[vq_id]);
       if (hdr == NULL)
         {
           break;
@@ -345,6 +479,36 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
     }
 }
 
+/****************************************************************************
+ * Name: virtio_net_txfree
+ ****************************************************************************/
+
+static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int i;
+
+  for (i = 0; i < priv->npairs; i++)
+    {
+      virtio_net_txfree_queue(dev, i);
+    }
+}
+
+/****************************************************************************
+ * Name: virtio_net_txflush
+ ****************************************************************************/
+
+static void virtio_net_txflush(FAR struct netdev_lowerhalf_s *dev,
+                               unsigned int queue)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+
+  if (priv->txnum[queue] > 0)
+    {
+      virtio_net_txkick(priv, queue);
+    }
+}
+
 /****************************************************************************
  * Name: virtio_net_ifup
  ****************************************************************************/
@@ -352,6 +516,7 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int i;
 
 #ifdef CONFIG_NET_IPv4
   vrtinfo("Bringing up: %u.%u.%u.%u\n",
@@ -368,9 +533,12 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   /* Prepare interrupt and packets for receiving */
 
-  virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RX].vq,
-                           &priv->lock[VIRTIO_NET_RX]);
-  virtio_net_rxfill(dev);
+  for (i = 0; i < priv->npairs; i++)
+    {
+      virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RXQ(i)].vq,
+                               &priv->lock[VIRTIO_NET_RXQ(i)]);
+      virtio_net_rxfill(dev, i);
+    }
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   if (priv->lower.wifi == NULL)
@@ -393,7 +561,7 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 
   /* Disable the Ethernet interrupt */
 
-  for (i = 0; i < VIRTIO_NET_NUM; i++)
+  for (i = 0; i < priv->npairs * VIRTIO_NET_NUM; i++)
     {
       virtqueue_disable_cb_lock(priv->vdev->vrings_info[i].vq,
                                 &priv->lock[i]);
@@ -418,9 +586,20 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 
 static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
                            FAR netpkt_t *pkt)
+{
+  return virtio_net_send_queue(dev, pkt, 0);
+}
+
+/****************************************************************************
+ * Name: virtio_net_send_queue
+ ****************************************************************************/
+
+static int virtio_net_send_queue(FAR struct netdev_lowerhalf_s *dev,
+                                 FAR netpkt_t *pkt, unsigned int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  unsigned int vq_id = VIRTIO_NET_TXQ(queue);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
 
   /* Check the send length */
 
@@ -430,20 +609,25 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
       return -EINVAL;
     }
 
-  /* Add buffer to vq and notify the other side */
+  /* Add buffer to vq, the other side is notified once for the whole burst
+   * by virtio_net_txflush(), or earlier if the burst is long.
+   */
 
-  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TX);
-  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  virtio_net_addbuffer(dev, vq, pkt, vq_id);
+  if (++priv->txnum[queue] >= VIRTIO_NET_TXBATCH)
+    {
+      virtio_net_txkick(priv, queue);
+    }
 
   /* Try return Netpkt TX buffer to upper-half. */
 
-  virtio_net_txfree(dev);
+  virtio_net_txfree_queue(dev, queue);
 
   /* If we have no buffer left, enable TX done callback. */
 
   if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+      virtqueue_enable_cb_lock(vq, &priv->lock[vq_id]);
     }
 
   return OK;
@@ -454,39 +638,62 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
  ****************************************************************************/
 
 static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+{
+  return virtio_net_recv_queue(dev, 0);
+}
+
+/****************************************************************************
+ * Name: virtio_net_recv_queue
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       unsigned int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  unsigned int vq_id = VIRTIO_NET_RXQ(queue);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
   FAR struct virtio_net_llhdr_s *hdr;
   irqstate_t flags;
   uint32_t len;
 
   /* Fill the free Netpkt RX buffer to the RX virtqueue */
 
-  virtio_net_rxfill(dev);
+  virtio_net_rxfill(dev, queue);
 
   /* Get received buffer form RX virtqueue */
 
-  flags = spin_lock_irqsave(&priv->lock[VIRTIO_NET_RX]);
+  flags = spin_lock_irqsave(&priv->lock[vq_id]);
   hdr = virtqueue_get_buffer(vq, &len, NULL);
   if (hdr == NULL)
     {
       /* If we have no buffer left, enable RX callback. */
 
       virtqueue_enable_cb(vq);
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      spin_unlock_irqrestore(&priv->lock[vq_id], flags);
 
       vrtinfo("get NULL buffer\n");
       return NULL;
     }
   else
     {
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      spin_unlock_irqrestore(&priv->lock[vq_id], flags);
     }
 
+  priv->rxnum[queue]--;
+
   /* Set the received pkt length */
 
   netpkt_setdatalen(dev, hdr->pkt, len - VIRTIO_NET_HDRSIZE);
+
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+  /* The device has either validated the checksum or, for packets from
+   * another guest on the same host, never computed it at all.
+   */
+
+  NETDEV_RXCSUM_SET(&dev->netdev,
+                    (hdr->vhdr.flags & (VIRTIO_NET_HDR_F_DATA_VALID |
+                                        VIRTIO_NET_HDR_F_NEEDS_CSUM)) != 0);
+#endif
   vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, hdr->pkt, len);
   return hdr->pkt;
 }
@@ -533,7 +740,16 @@ static void virtio_net_rxready(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (priv->npairs > 1)
+    {
+      netdev_lower_rxready_queue((FAR struct netdev_lowerhalf_s *)priv,
+                                 vq->vq_queue_index / VIRTIO_NET_NUM);
+      return;
+    }
+#endif
+
   netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
 }
 
@@ -545,10 +761,96 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (priv->npairs > 1)
+    {
+      netdev_lower_txdone_queue((FAR struct netdev_lowerhalf_s *)priv,
+                                vq->vq_queue_index / VIRTIO_NET_NUM);
+      return;
+    }
+#endif
+
   netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
 }
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/****************************************************************************
+ * Name: virtio_net_ctrldone
+ ****************************************************************************/
+
+static void virtio_net_ctrldone(FAR struct virtqueue *vq)
+{
+  FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
+
+  if (virtqueue_get_buffer(vq, NULL, NULL) != NULL)
+    {
+      nxsem_post(&priv->ctrlsem);
+    }
+}
+
+/****************************************************************************
+ * Name: virtio_net_ctrl_mq
+ *
+ * Description:
+ *   Tell the device how many queue pairs are used.  Until then, it only
+ *   uses the first one.
+ *
+ ****************************************************************************/
+
+static int virtio_net_ctrl_mq(FAR struct virtio_net_priv_s *priv,
+                              uint16_t npairs)
+{
+  FAR struct virtio_device *vdev = priv->vdev;
+  FAR struct virtqueue *vq = vdev->vrings_info[vdev->vrings_num - 1].vq;
+  FAR struct virtio_net_ctrl_s *ctrl;
+  struct virtqueue_buf vb[3];
+  int ret;
+
+  ctrl = virtio_zalloc_buf(vdev, sizeof(*ctrl), 16);
+  if (ctrl == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ctrl->class = VIRTIO_NET_CTRL_MQ;
+  ctrl->cmd   = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+  ctrl->pairs = npairs;
+  ctrl->ack   = UINT8_MAX;
+
+  vb[0].buf = &ctrl->class;
+  vb[0].len = sizeof(ctrl->class) + sizeof(ctrl->cmd);
+  vb[1].buf = &ctrl->pairs;
+  vb[1].len = sizeof(ctrl->pairs);
+  vb[2].buf = &ctrl->ack;
+  vb[2].len = sizeof(ctrl->ack);
+
+  ret = virtqueue_add_buffer(vq, vb, 2, 1, ctrl);
+  if (ret < 0)
+    {
+      virtio_free_buf(vdev, ctrl);
+      return ret;
+    }
+
+  virtqueue_enable_cb(vq);
+  virtqueue_kick(vq);
+
+  /* The device may still write the acknowledgment after a timeout, the
+   * command buffer is given up then.
+   */
+
+  ret = nxsem_tickwait_uninterruptible(&priv->ctrlsem, SEC2TICK(1));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = ctrl->ack == VIRTIO_NET_OK ? OK : -EIO;
+  virtio_free_buf(vdev, ctrl);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_init
  ****************************************************************************/
@@ -556,28 +858,86 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqnames[VIRTIO_NET_NUM];
-  vq_callback callbacks[VIRTIO_NET_NUM];
+  FAR const char *vqnames[VIRTIO_NET_MAXVQS];
+  vq_callback callbacks[VIRTIO_NET_MAXVQS];
+  unsigned int nvqs = VIRTIO_NET_NUM;
+  uint16_t npairs = 1;
+  unsigned int i;
   int ret;
 
-  spin_lock_init(&priv->lock[VIRTIO_NET_RX]);
-  spin_lock_init(&priv->lock[VIRTIO_NET_TX]);
+  for (i = 0; i < VIRTIO_NET_MAXVQS; i++)
+    {
+      spin_lock_init(&priv->lock[i]);
+    }
+
   priv->vdev = vdev;
   vdev->priv = priv;
 
-  /* Initialize the virtio device */
+  /* Initialize the virtio device.  With VIRTIO_RING_F_EVENT_IDX, the
+   * device is only notified of new buffers and only interrupts for used
+   * buffers when the other side waits for them.
+   */
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
   virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+                                  (1UL << VIRTIO_NET_F_CSUM) |
+                                  (1UL << VIRTIO_NET_F_GUEST_CSUM) |
+#endif
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+                                  (1UL << VIRTIO_NET_F_CTRL_VQ) |
+                                  (1UL << VIRTIO_NET_F_MQ) |
+#endif
+                                  VIRTIO_RING_F_EVENT_IDX |
                                   (1UL << VIRTIO_F_ANY_LAYOUT), NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
-  vqnames[VIRTIO_NET_TX]   = "virtio_net_tx";
-  callbacks[VIRTIO_NET_RX] = virtio_net_rxready;
-  callbacks[VIRTIO_NET_TX] = virtio_net_txdone;
-  ret = virtio_create_virtqueues(vdev, 0, VIRTIO_NET_NUM, vqnames,
-                                 callbacks, NULL);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* The control virtqueue follows all the queue pairs of the device, so
+   * multiple queues are only used if there is no more of them than CPUs.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CTRL_VQ) &&
+      virtio_has_feature(vdev, VIRTIO_NET_F_MQ))
+    {
+      virtio_read_config_member(vdev, struct virtio_net_config_s,
+                                max_virtqueue_pairs, &npairs);
+      if (npairs > 1 && npairs <= VIRTIO_NET_MAXPAIRS)
+        {
+          nvqs = npairs * VIRTIO_NET_NUM + 1;
+        }
+      else
+        {
+          npairs = 1;
+        }
+    }
+
+  nxsem_init(&priv->ctrlsem, 0, 0);
+#endif
+
+  for (i = 0; i < npairs * VIRTIO_NET_NUM; i++)
+    {
+      if (i % VIRTIO_NET_NUM == VIRTIO_NET_RX)
+        {
+          vqnames[i]   = "virtio_net_rx";
+          callbacks[i] = virtio_net_rxready;
+        }
+      else
+        {
+          vqnames[i]   = "virtio_net_tx";
+          callbacks[i] = virtio_net_txdone;
+        }
+    }
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (i < nvqs)
+    {
+      vqnames[i]   = "virtio_net_ctrl";
+      callbacks[i] = virtio_net_ctrldone;
+    }
+#endif
+
+  ret = virtio_create_virtqueues(vdev, 0, nvqs, vqnames, callbacks, NULL);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
@@ -586,14 +946,28 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (npairs > 1)
+    {
+      ret = virtio_net_ctrl_mq(priv, npairs);
+      if (ret < 0)
+        {
+          vrtwarn("Failed to use %u queue pairs, ret=%d\n", npairs, ret);
+          npairs = 1;
+        }
+    }
+#endif
+
+  priv->npairs = npairs;
+
 #if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
   priv->bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
 #else
   /* Calculate the virtio network buffer number:
-   * 1/4 for the TX netpkts, 1/4 for the RX netpkts.
+   * 1/4 for the TX netpkts, 1/4 for the RX netpkts, shared by the queues.
    */
 
-  priv->bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4;
+  priv->bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4 / npairs;
 #endif
   priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_RX].info.num_descs /
                      (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
@@ -666,9 +1040,24 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
   /* Initialize the netdev lower half */
 
   netdev = (FAR struct netdev_lowerhalf_s *)priv;
-  netdev->quota[NETPKT_RX] = priv->bufnum;
-  netdev->quota[NETPKT_TX] = priv->bufnum;
+  netdev->quota[NETPKT_RX] = priv->bufnum * priv->npairs;
+  netdev->quota[NETPKT_TX] = priv->bufnum * priv->npairs;
   netdev->ops = &g_virtio_net_ops;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  netdev->nqueues = priv->npairs;
+#endif
+
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CSUM))
+    {
+      netdev->netdev.d_features |= NETDEV_FEATURE_TXCSUM;
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_GUEST_CSUM))
+    {
+      netdev->netdev.d_features |= NETDEV_FEATURE_RXCSUM;
+    }
+#endif
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   /* If the WiFi interfaces has reached the setting value,
@@ -732,6 +1121,9 @@ static void virtio_net_remove(FAR struct virtio_device *vdev)
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   g_netdev_num--;
   wifi_sim_remove(&priv->lower);
+#endif
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  nxsem_destroy(&priv->ctrlsem);
 #endif
   kmm_free(priv);
 }
@@ -209,7 +209,7 @@ virtio_pci_legacy_create_virtqueue(FAR struct virtio_pci_device_s *vpdev,
 #if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
   pci_write_io_word(vpdev->dev,
                     (uintptr_t)(vpdev->ioaddr + VIRTIO_MSI_QUEUE_VECTOR),
-                    VIRTIO_PCI_INT_VQ);
+                    VIRTIO_PCI_INT_QUEUE(vpdev, vq->vq_queue_index));
   pci_read_io_word(vpdev->dev,
                    (uintptr_t)(vpdev->ioaddr + VIRTIO_MSI_QUEUE_VECTOR),
                    &msix_vector);
@@ -30,6 +30,7 @@
 #include <sys/param.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/dmaalloc.h>
 #include <nuttx/virtio/virtio-pci.h>
 
 #include "virtio-pci.h"
@@ -86,9 +87,14 @@ static const struct virtio_memory_ops g_virtio_pci_mmops =
 
 /****************************************************************************
  * Name: virtio_pci_vq_callback
+ *
+ * Description:
+ *   Serve the virtqueues bound to a vector, all of them in polling mode.
+ *
  ****************************************************************************/
 
-static void virtio_pci_vq_callback(FAR struct virtio_pci_device_s *vpdev)
+static void virtio_pci_vq_callback(FAR struct virtio_pci_device_s *vpdev,
+                                   int vector)
 {
   FAR struct virtio_vring_info *vrings_info = vpdev->vdev.vrings_info;
   FAR struct virtqueue *vq;
@@ -96,6 +102,13 @@ static void virtio_pci_vq_callback(FAR struct virtio_pci_device_s *vpdev)
 
   for (i = 0; i < vpdev->vdev.vrings_num; i++)
     {
+#if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
+      if (VIRTIO_PCI_INT_QUEUE(vpdev, i) != vector)
+        {
+          continue;
+        }
+#endif
+
       vq = vrings_info[i].vq;
       if (vq->vq_used_cons_idx != vq->vq_ring.used->idx &&
           vq->callback != NULL)
@@ -113,8 +126,17 @@ static void virtio_pci_vq_callback(FAR struct virtio_pci_device_s *vpdev)
 static int virtio_pci_interrupt(int irq, FAR void *context, FAR void *arg)
 {
   FAR struct virtio_pci_device_s *vpdev = arg;
+  int vector;
+
+  for (vector = VIRTIO_PCI_INT_VQ; vector < vpdev->nirqs; vector++)
+    {
+      if (vpdev->irq[vector] == irq)
+        {
+          virtio_pci_vq_callback(vpdev, vector);
+          break;
+        }
+    }
 
-  virtio_pci_vq_callback(vpdev);
   return OK;
 }
 
@@ -140,7 +162,7 @@ static void virtio_pci_wdog(wdparm_t arg)
   FAR struct virtio_pci_device_s *vpdev =
     (FAR struct virtio_pci_device_s *)arg;
 
-  virtio_pci_vq_callback(vpdev);
+  virtio_pci_vq_callback(vpdev, 0);
   wd_start(&vpdev->wdog, VIRTIO_PCI_WORK_DELAY, virtio_pci_wdog,
            (wdparm_t)vpdev);
 }
@@ -153,7 +175,7 @@ static void virtio_pci_wdog(wdparm_t arg)
 static FAR void *virtio_pci_alloc_buf(FAR struct virtio_device *vdev,
                                       size_t size, size_t align)
 {
-  return kmm_memalign(align, size);
+  return mm_dmamemalign(align, size);
 }
 
 /****************************************************************************
@@ -163,7 +185,7 @@ static FAR void *virtio_pci_alloc_buf(FAR struct virtio_device *vdev,
 static void virtio_pci_free_buf(FAR struct virtio_device *vdev,
                                 FAR void *buf)
 {
-  return kmm_free(buf);
+  mm_dmafree(buf);
 }
 
 /****************************************************************************
@@ -174,6 +196,9 @@ static int virtio_pci_probe(FAR struct pci_device_s *dev)
 {
   FAR struct virtio_pci_device_s *vpdev;
   FAR struct virtio_device *vdev;
+#if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
+  int i;
+#endif
   int ret;
 
   /* We only own devices >= 0x1000 and <= 0x107f: leave the rest. */
@@ -222,20 +247,29 @@ static int virtio_pci_probe(FAR struct pci_device_s *dev)
 
 #if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
 
-  /* Irq init */
+  /* Irq init, the virtqueues are spread over the vectors the device
+   * provides and the vectors over the CPUs.
+   */
 
-  ret = pci_alloc_irq(vpdev->dev, vpdev->irq, VIRTIO_PCI_INT_NUM);
-  if (ret != VIRTIO_PCI_INT_NUM)
+  ret = pci_alloc_irq_affinity(vpdev->dev, vpdev->irq, VIRTIO_PCI_INT_NUM);
+  if (ret <= VIRTIO_PCI_INT_VQ)
     {
       vrterr("Failed to allocate MSI, ret=%d\n", ret);
+      if (ret > 0)
+        {
+          pci_release_irq(vpdev->dev, vpdev->irq, ret);
+        }
+
       goto err_with_enable;
     }
 
-  vrtinfo("Interrupt mode: attaching MSI %d to %p, %d to %p\n",
+  vpdev->nirqs = ret;
+
+  vrtinfo("Interrupt mode: attaching MSI %d to %p, %d queue vectors to %p\n",
           vpdev->irq[VIRTIO_PCI_INT_CFG], virtio_pci_config_changed,
-          vpdev->irq[VIRTIO_PCI_INT_VQ], virtio_pci_interrupt);
+          vpdev->nirqs - VIRTIO_PCI_INT_VQ, virtio_pci_interrupt);
 
-  ret = pci_connect_irq(vpdev->dev, vpdev->irq, VIRTIO_PCI_INT_NUM);
+  ret = pci_connect_irq(vpdev->dev, vpdev->irq, vpdev->nirqs);
   if (ret < 0)
     {
       vrterr("Failed to connect MSI %d\n", ret);
@@ -244,7 +278,10 @@ static int virtio_pci_probe(FAR struct pci_device_s *dev)
 
   irq_attach(vpdev->irq[VIRTIO_PCI_INT_CFG],
              virtio_pci_config_changed, vpdev);
-  irq_attach(vpdev->irq[VIRTIO_PCI_INT_VQ], virtio_pci_interrupt, vpdev);
+  for (i = VIRTIO_PCI_INT_VQ; i < vpdev->nirqs; i++)
+    {
+      irq_attach(vpdev->irq[i], virtio_pci_interrupt, vpdev);
+    }
 #else
   vrtinfo("Polling mode\n");
 #endif
@@ -263,10 +300,13 @@ static int virtio_pci_probe(FAR struct pci_device_s *dev)
 
 err_with_attach:
 #if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
-  irq_detach(vpdev->irq[VIRTIO_PCI_INT_CFG]);
-  irq_detach(vpdev->irq[VIRTIO_PCI_INT_VQ]);
+  for (i = VIRTIO_PCI_INT_CFG; i < vpdev->nirqs; i++)
+    {
+      irq_detach(vpdev->irq[i]);
+    }
+
 err_with_irq:
-  pci_release_irq(vpdev->dev, vpdev->irq, VIRTIO_PCI_INT_NUM);
+  pci_release_irq(vpdev->dev, vpdev->irq, vpdev->nirqs);
 #endif
 err_with_enable:
   pci_clear_master(dev);
@@ -283,13 +323,19 @@ err:
 static void virtio_pci_remove(FAR struct pci_device_s *dev)
 {
   FAR struct virtio_pci_device_s *vpdev = dev->priv;
+#if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
+  int i;
+#endif
 
   virtio_unregister_device(&vpdev->vdev);
 
 #if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
-  irq_detach(vpdev->irq[VIRTIO_PCI_INT_CFG]);
-  irq_detach(vpdev->irq[VIRTIO_PCI_INT_VQ]);
-  pci_release_irq(vpdev->dev, vpdev->irq, VIRTIO_PCI_INT_NUM);
+  for (i = VIRTIO_PCI_INT_CFG; i < vpdev->nirqs; i++)
+    {
+      irq_detach(vpdev->irq[i]);
+    }
+
+  pci_release_irq(vpdev->dev, vpdev->irq, vpdev->nirqs);
 #endif
 
   pci_clear_master(dev);
@@ -412,8 +458,10 @@ int virtio_pci_create_virtqueues(FAR struct virtio_device *vdev,
       goto err;
     }
 
-  up_enable_irq(vpdev->irq[VIRTIO_PCI_INT_CFG]);
-  up_enable_irq(vpdev->irq[VIRTIO_PCI_INT_VQ]);
+  for (i = VIRTIO_PCI_INT_CFG; i < vpdev->nirqs; i++)
+    {
+      up_enable_irq(vpdev->irq[i]);
+    }
 #else
   ret = wd_start(&vpdev->wdog, VIRTIO_PCI_WORK_DELAY, virtio_pci_wdog,
                 (wdparm_t)vpdev);
@@ -443,8 +491,11 @@ void virtio_pci_delete_virtqueues(FAR struct virtio_device *vdev)
   unsigned int i;
 
 #if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
-  up_disable_irq(vpdev->irq[VIRTIO_PCI_INT_CFG]);
-  up_disable_irq(vpdev->irq[VIRTIO_PCI_INT_VQ]);
+  for (i = VIRTIO_PCI_INT_CFG; i < vpdev->nirqs; i++)
+    {
+      up_disable_irq(vpdev->irq[i]);
+    }
+
   vpdev->ops->config_vector(vpdev, false);
 #else
   wd_cancel(&vpdev->wdog);
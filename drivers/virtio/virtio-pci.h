@@ -42,9 +42,18 @@
 
 #define VIRTIO_PCI_MSI_NO_VECTOR         0xffff
 
+#ifndef CONFIG_DRIVERS_VIRTIO_PCI_QUEUE_IRQS
+#  define CONFIG_DRIVERS_VIRTIO_PCI_QUEUE_IRQS 1
+#endif
+
 #define VIRTIO_PCI_INT_CFG               0
 #define VIRTIO_PCI_INT_VQ                1
-#define VIRTIO_PCI_INT_NUM               2
+#define VIRTIO_PCI_INT_NUM               (1 + CONFIG_DRIVERS_VIRTIO_PCI_QUEUE_IRQS)
+
+/* The vector of virtqueue n, the queues share the allocated vectors */
+
+#define VIRTIO_PCI_INT_QUEUE(vpdev, n) \
+  (VIRTIO_PCI_INT_VQ + (n) % ((vpdev)->nirqs - VIRTIO_PCI_INT_VQ))
 
 /****************************************************************************
  * Public Data
@@ -85,6 +94,7 @@ struct virtio_pci_device_s
                                                */
 #if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
   int                                irq[VIRTIO_PCI_INT_NUM];
+  int                                nirqs;   /* Allocated vectors */
 #else
   struct wdog_s                      wdog;
 #endif
@@ -96,7 +96,9 @@ static void btuart_rxwork(FAR void *arg)
 {
   FAR struct btuart_upperhalf_s *upper;
   enum bt_buf_type_e type;
+  FAR uint8_t *pkt;
   unsigned int pktlen;
+  unsigned int rxlen;
   ssize_t nread;
   union
     {
@@ -117,20 +119,26 @@ static void btuart_rxwork(FAR void *arg)
       return;
     }
 
-  upper->rxlen += (uint16_t)nread;
+  /* The complete packets are passed to the stack from where they are in
+   * the buffer, only the incomplete packet at the end of the data is moved
+   * to the start of the buffer.
+   */
 
-  while (upper->rxlen)
+  pkt   = upper->rxbuf;
+  rxlen = upper->rxlen + (uint16_t)nread;
+
+  while (rxlen)
     {
-      hdr = (FAR void *)&upper->rxbuf[H4_HEADER_SIZE];
+      hdr = (FAR void *)&pkt[H4_HEADER_SIZE];
 
-      switch (upper->rxbuf[0])
+      switch (pkt[0])
         {
         case H4_EVT:
-          if (upper->rxlen < H4_HEADER_SIZE +
+          if (rxlen < H4_HEADER_SIZE +
               sizeof(struct bt_hci_evt_hdr_s))
             {
               wlwarn("WARNING: Incomplete HCI event header\n");
-              return;
+              goto out;
             }
 
           type = BT_EVT;
@@ -139,11 +147,11 @@ static void btuart_rxwork(FAR void *arg)
           break;
 
         case H4_ACL:
-          if (upper->rxlen < H4_HEADER_SIZE +
+          if (rxlen < H4_HEADER_SIZE +
               sizeof(struct bt_hci_acl_hdr_s))
             {
               wlwarn("WARNING: Incomplete HCI ACL header\n");
-              return;
+              goto out;
             }
 
           type = BT_ACL_IN;
@@ -152,11 +160,11 @@ static void btuart_rxwork(FAR void *arg)
           break;
 
         case H4_ISO:
-          if (upper->rxlen < H4_HEADER_SIZE +
+          if (rxlen < H4_HEADER_SIZE +
               sizeof(struct bt_hci_iso_hdr_s))
             {
               wlwarn("WARNING: Incomplete HCI ISO header\n");
-              return;
+              goto out;
             }
 
           type = BT_ISO_IN;
@@ -165,26 +173,34 @@ static void btuart_rxwork(FAR void *arg)
           break;
 
         default:
-          wlerr("ERROR: Unknown H4 type %u\n", upper->rxbuf[0]);
-          return;
+          wlerr("ERROR: Unknown H4 type %u\n", pkt[0]);
+          goto out;
         }
 
-      if (upper->rxlen < pktlen)
+      if (rxlen < pktlen)
         {
           wlwarn("WARNING: Incomplete packet: rxlen=%u, pktlen=%u\n",
-                 upper->rxlen, pktlen);
-          return;
+                 rxlen, pktlen);
+          goto out;
         }
 
       /* Pass buffer to the stack */
 
-      BT_DUMP("Received", upper->rxbuf, pktlen);
-      bt_netdev_receive(&upper->dev, type, &upper->rxbuf[H4_HEADER_SIZE],
+      BT_DUMP("Received", pkt, pktlen);
+      bt_netdev_receive(&upper->dev, type, &pkt[H4_HEADER_SIZE],
                         pktlen - H4_HEADER_SIZE);
 
-      upper->rxlen -= pktlen;
-      memmove(upper->rxbuf, upper->rxbuf + pktlen, upper->rxlen);
+      rxlen -= pktlen;
+      pkt   += pktlen;
     }
+
+out:
+  if (pkt != upper->rxbuf)
+    {
+      memmove(upper->rxbuf, pkt, rxlen);
+    }
+
+  upper->rxlen = rxlen;
 }
 
 static void btuart_rxcallback(FAR const struct btuart_lowerhalf_s *lower,
@@ -28,11 +28,13 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <string.h>
 #include <aio.h>
 
 #include <nuttx/queue.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/fs/blkqueue.h>
 
 #ifdef CONFIG_FS_AIO
 
@@ -68,6 +70,9 @@ struct aio_container_s
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t aioc_prio;               /* Priority of the waiting task */
 #endif
+#ifdef CONFIG_FS_BLKQUEUE
+  struct blk_req_s aioc_req;       /* The request to a block device */
+#endif
 };
 
 /****************************************************************************
@@ -220,6 +225,29 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_submit
+ *
+ * Description:
+ *   Submit the transfer directly to the request queue of the block driver
+ *   if the file is a block device and the transfer covers whole sectors.
+ *   The completion of the request signals the client then, without the
+ *   worker thread.
+ *
+ * Input Parameters:
+ *   aioc  - The AIO control block container
+ *   write - true: write to the device, false: read from it
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was submitted.  Otherwise, a negated errno
+ *   value is returned and the transfer should be queued with aio_queue().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLKQUEUE
+int aio_submit(FAR struct aio_container_s *aioc, bool write);
+#endif
+
 /****************************************************************************
  * Name: aio_signal
  *
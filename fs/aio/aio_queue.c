@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <fcntl.h>
 #include <sched.h>
 #include <aio.h>
 #include <assert.h>
@@ -31,6 +32,8 @@
 #include <debug.h>
 
 #include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 
 #include "aio/aio.h"
 
@@ -40,6 +43,44 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: aio_complete
+ *
+ * Description:
+ *   The completion of a request submitted by aio_submit(), called on the
+ *   work queue of the block driver.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLKQUEUE
+static void aio_complete(FAR struct blk_req_s *req)
+{
+  FAR struct aio_container_s *aioc = req->priv;
+  FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
+  pid_t pid = aioc->aioc_pid;
+
+  if (req->result < 0)
+    {
+      ferr("ERROR: Block request failed: %zd\n", req->result);
+      aiocbp->aio_result = req->result;
+    }
+  else
+    {
+      aiocbp->aio_result = req->result *
+                           (aiocbp->aio_nbytes / req->nsectors);
+    }
+
+  /* The request is part of the container */
+
+  aioc_decant(aioc);
+  aio_signal(pid, aiocbp);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: aio_queue
  *
@@ -96,4 +137,66 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
   return ret;
 }
 
+/****************************************************************************
+ * Name: aio_submit
+ *
+ * Description:
+ *   Submit the transfer to the request queue of a block device
+ *
+ * Input Parameters:
+ *   aioc  - The AIO control block container
+ *   write - true: write to the device, false: read from it
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  Otherwise, a negated errno value is returned
+ *   and the transfer is left to aio_queue().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLKQUEUE
+int aio_submit(FAR struct aio_container_s *aioc, bool write)
+{
+  FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
+  FAR struct file *filep = aioc->aioc_filep;
+  FAR struct blk_req_s *req = &aioc->aioc_req;
+  struct geometry geo;
+  int ret;
+
+  /* The worker thread reports the errors of the access mode, and appends
+   * to the file in the order of the calls.
+   */
+
+  if ((filep->f_oflags & (write ? O_WROK : O_RDOK)) == 0 ||
+      (filep->f_oflags & O_APPEND) != 0 || aiocbp->aio_nbytes == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Only the block drivers return the geometry */
+
+  ret = file_ioctl(filep, BIOC_GEOMETRY, (unsigned long)((uintptr_t)&geo));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (geo.geo_sectorsize == 0 ||
+      aiocbp->aio_offset % geo.geo_sectorsize != 0 ||
+      aiocbp->aio_nbytes % geo.geo_sectorsize != 0)
+    {
+      return -EINVAL;
+    }
+
+  memset(req, 0, sizeof(*req));
+  req->buffer   = (FAR uint8_t *)aiocbp->aio_buf;
+  req->start    = aiocbp->aio_offset / geo.geo_sectorsize;
+  req->nsectors = aiocbp->aio_nbytes / geo.geo_sectorsize;
+  req->complete = aio_complete;
+  req->priv     = aioc;
+  req->write    = write;
+
+  return file_ioctl(filep, BIOC_SUBMIT, (unsigned long)((uintptr_t)req));
+}
+#endif
+
 #endif /* CONFIG_FS_AIO */
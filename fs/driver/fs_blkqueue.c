@@ -0,0 +1,310 @@
+/****************************************************************************
+ * fs/driver/fs_blkqueue.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/blkqueue.h>
+
+#ifdef CONFIG_FS_BLKQUEUE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blk_complete
+ *
+ * Description:
+ *   Split the result of a transfer across the requests merged into it, in
+ *   order, and call their completions.
+ *
+ ****************************************************************************/
+
+static void blk_complete(FAR struct blk_req_s *req, ssize_t ret)
+{
+  FAR struct blk_req_s *next;
+
+  while (req != NULL)
+    {
+      /* The completion may free the request */
+
+      next = req->next;
+
+      if (ret < 0)
+        {
+          req->result = ret;
+        }
+      else
+        {
+          req->result = MIN(ret, (ssize_t)req->nsectors);
+          ret        -= req->result;
+        }
+
+      req->complete(req);
+      req = next;
+    }
+}
+
+/****************************************************************************
+ * Name: blk_transfer
+ *
+ * Description:
+ *   Transfer a request and the requests merged into it synchronously.
+ *
+ ****************************************************************************/
+
+static void blk_transfer(FAR struct blk_queue_s *queue,
+                         FAR struct blk_req_s *req)
+{
+  FAR struct inode *inode = req->inode;
+  FAR const struct block_operations *ops = inode->u.i_bops;
+  ssize_t ret = -EACCES;
+
+  if (queue != NULL && queue->transfer != NULL)
+    {
+      ret = queue->transfer(req);
+    }
+  else if (req->write)
+    {
+      if (ops->write != NULL)
+        {
+          ret = ops->write(inode, req->buffer, req->start, req->total);
+        }
+    }
+  else if (ops->read != NULL)
+    {
+      ret = ops->read(inode, req->buffer, req->start, req->total);
+    }
+
+  if (ret < 0)
+    {
+      ferr("ERROR: %s of %u sectors at %" PRIuOFF " failed: %zd\n",
+           req->write ? "Write" : "Read", req->total,
+           (off_t)req->start, ret);
+    }
+
+  blk_complete(req, ret);
+}
+
+/****************************************************************************
+ * Name: blk_queue_merge
+ *
+ * Description:
+ *   Append 'req' to the last request in the queue if the sectors of both
+ *   are adjacent, and their memory too unless the driver can transfer
+ *   into more buffers.
+ *
+ * Assumptions:
+ *   The queue is locked.
+ *
+ ****************************************************************************/
+
+static bool blk_queue_merge(FAR struct blk_queue_s *queue,
+                            FAR struct blk_req_s *tail,
+                            FAR struct blk_req_s *req)
+{
+  FAR struct blk_req_s *last;
+  unsigned int nsegs = 1;
+
+  if (queue->sectsize == 0 || tail->inode != req->inode ||
+      tail->write != req->write || tail->start + tail->total != req->start ||
+      tail->total + req->nsectors > CONFIG_FS_BLKQUEUE_MAXSECTORS)
+    {
+      return false;
+    }
+
+  for (last = tail; last->next != NULL; last = last->next)
+    {
+      if (last->buffer + last->nsectors * queue->sectsize !=
+          last->next->buffer)
+        {
+          nsegs++;
+        }
+    }
+
+  if (last->buffer + last->nsectors * queue->sectsize != req->buffer &&
+      (queue->transfer == NULL || nsegs >= queue->maxsegs))
+    {
+      return false;
+    }
+
+  last->next   = req;
+  tail->total += req->nsectors;
+  return true;
+}
+
+/****************************************************************************
+ * Name: blk_queue_worker
+ *
+ * Description:
+ *   Pass the queued requests to the driver, on the low priority work
+ *   queue.
+ *
+ ****************************************************************************/
+
+static void blk_queue_worker(FAR void *arg)
+{
+  FAR struct blk_queue_s *queue = arg;
+  FAR struct blk_req_s *req;
+
+  for (; ; )
+    {
+      nxmutex_lock(&queue->lock);
+      req = (FAR struct blk_req_s *)dq_remfirst(&queue->pending);
+      nxmutex_unlock(&queue->lock);
+
+      if (req == NULL)
+        {
+          break;
+        }
+
+      blk_transfer(queue, req);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blk_queue_init
+ *
+ * Description:
+ *   Initialize the request queue of a block driver.
+ *
+ ****************************************************************************/
+
+void blk_queue_init(FAR struct blk_queue_s *queue, size_t sectsize)
+{
+  nxmutex_init(&queue->lock);
+  dq_init(&queue->pending);
+  queue->work.worker = NULL;
+  queue->sectsize    = sectsize;
+  queue->transfer    = NULL;
+  queue->maxsegs     = 1;
+}
+
+/****************************************************************************
+ * Name: blk_queue_uninit
+ *
+ * Description:
+ *   Wait for the transfer in progress and fail the requests that did not
+ *   start yet.
+ *
+ ****************************************************************************/
+
+void blk_queue_uninit(FAR struct blk_queue_s *queue)
+{
+  FAR struct blk_req_s *req;
+
+  while (work_cancel_sync(LPWORK, &queue->work) >= 0)
+    {
+    }
+
+  while ((req = (FAR struct blk_req_s *)
+                dq_remfirst(&queue->pending)) != NULL)
+    {
+      blk_complete(req, -ENODEV);
+    }
+
+  nxmutex_destroy(&queue->lock);
+}
+
+/****************************************************************************
+ * Name: blk_queue_submit
+ *
+ * Description:
+ *   Add a request to the queue of a device and start the transfers unless
+ *   the request is plugged.
+ *
+ ****************************************************************************/
+
+int blk_queue_submit(FAR struct blk_queue_s *queue,
+                     FAR struct blk_req_s *req)
+{
+  FAR struct blk_req_s *tail;
+  int ret;
+
+  DEBUGASSERT(req->complete != NULL && req->nsectors > 0);
+
+  req->next  = NULL;
+  req->total = req->nsectors;
+
+  ret = nxmutex_lock(&queue->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  tail = (FAR struct blk_req_s *)dq_tail(&queue->pending);
+  if (tail == NULL || !blk_queue_merge(queue, tail, req))
+    {
+      dq_addlast(&req->node, &queue->pending);
+    }
+
+  if (!req->plug && work_available(&queue->work))
+    {
+      work_queue(LPWORK, &queue->work, blk_queue_worker, queue, 0);
+    }
+
+  nxmutex_unlock(&queue->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blk_submit
+ *
+ * Description:
+ *   Submit a request to its block driver, or transfer it at once if the
+ *   driver has no queue.
+ *
+ ****************************************************************************/
+
+int blk_submit(FAR struct blk_req_s *req)
+{
+  FAR struct inode *inode = req->inode;
+
+  DEBUGASSERT(inode != NULL && inode->u.i_bops != NULL);
+
+  if (inode->u.i_bops->submit != NULL)
+    {
+      return inode->u.i_bops->submit(inode, req);
+    }
+
+  req->next  = NULL;
+  req->total = req->nsectors;
+  blk_transfer(NULL, req);
+  return OK;
+}
+
+#endif /* CONFIG_FS_BLKQUEUE */
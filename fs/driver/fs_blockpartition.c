@@ -237,6 +237,33 @@ static int part_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
         }
         break;
 
+      case BIOC_DISCARD:
+      case BIOC_ZEROOUT:
+        {
+          FAR const struct blk_range_s *range =
+            (FAR const struct blk_range_s *)ptr_arg;
+          struct blk_range_s prange;
+
+          if (parent->u.i_bops->ioctl == NULL)
+            {
+              break;
+            }
+
+          if (range == NULL || range->start < 0 || range->nsectors < 0 ||
+              range->start > dev->nsectors ||
+              range->nsectors > dev->nsectors - range->start)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          prange.start    = range->start + dev->firstsector;
+          prange.nsectors = range->nsectors;
+          ret = parent->u.i_bops->ioctl(parent, cmd,
+                                        (unsigned long)(uintptr_t)&prange);
+        }
+        break;
+
       default:
         if (parent->u.i_bops->ioctl)
           {
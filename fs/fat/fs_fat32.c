@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
@@ -88,6 +89,10 @@ static int     fat_readdir(FAR struct inode *mountpt,
                  FAR struct dirent *entry);
 static int     fat_rewinddir(FAR struct inode *mountpt,
                  FAR struct fs_dirent_s *dir);
+static off_t   fat_telldir(FAR struct inode *mountpt,
+                 FAR struct fs_dirent_s *dir);
+static int     fat_seekdir(FAR struct inode *mountpt,
+                 FAR struct fs_dirent_s *dir, off_t offset);
 
 static int     fat_bind(FAR struct inode *blkdriver, FAR const void *data,
                  FAR void **handle);
@@ -151,7 +156,10 @@ const struct mountpt_operations g_fat_operations =
   fat_rmdir,         /* rmdir */
   fat_rename,        /* rename */
   fat_stat,          /* stat */
-  NULL               /* chstat */
+  NULL,              /* chstat */
+  NULL,              /* syncfs */
+  fat_telldir,       /* telldir */
+  fat_seekdir        /* seekdir */
 };
 
 /****************************************************************************
@@ -613,8 +621,26 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
 
       cluster = ff->ff_startcluster;
       num_traversed = 1;
+      fat_extentadd(ff, 0, cluster);
     }
 
+#ifdef CONFIG_FAT_CLUSTERCACHE
+  /* The cluster chain cache may know a cluster nearer to the position */
+
+  if (cluster != 0 && num_clu > 0 && new_num_clu > 0)
+    {
+      uint32_t cached;
+      int index;
+
+      index = fat_extentlookup(ff, MIN(num_clu, new_num_clu) - 1, &cached);
+      if (index >= num_traversed)
+        {
+          cluster = cached;
+          num_traversed = index + 1;
+        }
+    }
+#endif
+
   /* Traverse the existing chain */
 
   for (i = num_traversed; i < num_clu && i < new_num_clu; i++)
@@ -627,6 +653,8 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
         {
           return -EIO;
         }
+
+      fat_extentadd(ff, i, cluster);
     }
 
   if (read)
@@ -679,6 +707,8 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
           return -EIO;
         }
 
+      fat_extentadd(ff, i, cluster);
+
       /* zero area (2) */
 
       ret = fat_zero_cluster(fs, cluster, 0, clu_size);
@@ -702,6 +732,8 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
           return -EIO;
         }
 
+      fat_extentadd(ff, i, cluster);
+
       /* zero area (3) */
 
       zero_end = filep->f_pos & (clu_size -1);
@@ -739,6 +771,107 @@ out:
   return 0;
 }
 
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+/****************************************************************************
+ * Name: fat_contiguous
+ *
+ * Description:
+ *   Get how many of 'nsectors' sectors from the current sector on are
+ *   consecutive on the media.  The cluster chain is followed past the
+ *   current cluster as long as the next cluster is the adjacent one, so
+ *   that a single multi-sector transfer can cover several clusters.  When
+ *   writing, missing clusters are added to the chain on the way.
+ *
+ * Input Parameters:
+ *   fs       - A reference to the mountpoint
+ *   ff       - A reference to the file, positioned by fat_get_sectors()
+ *   nsectors - The number of sectors wanted
+ *   write    - True if the sectors are written
+ *   last     - Returns the cluster that holds the last sector
+ *
+ * Returned Value:
+ *   The number of consecutive sectors, at most 'nsectors'.
+ *
+ ****************************************************************************/
+
+static unsigned int fat_contiguous(FAR struct fat_mountpt_s *fs,
+                                   FAR struct fat_file_s *ff,
+                                   unsigned int nsectors, bool write,
+                                   FAR uint32_t *last)
+{
+#ifdef CONFIG_FAT_CLUSTERCACHE
+  off_t clu_size = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+  uint32_t index = ff->ff_pos / clu_size;
+#endif
+  uint32_t cluster = ff->ff_currentcluster;
+  unsigned int count = ff->ff_sectorsincluster;
+  off_t next;
+
+  while (count < nsectors)
+    {
+      if (write)
+        {
+          next = fat_extendchain(fs, cluster);
+        }
+      else
+        {
+          next = fat_getcluster(fs, cluster);
+        }
+
+      /* Errors are reported when the next cluster is really needed */
+
+      if (next != cluster + 1)
+        {
+          break;
+        }
+
+      cluster = next;
+      count  += fs->fs_fatsecperclus;
+#ifdef CONFIG_FAT_CLUSTERCACHE
+      fat_extentadd(ff, ++index, cluster);
+#endif
+    }
+
+  *last = cluster;
+  return MIN(count, nsectors);
+}
+
+/****************************************************************************
+ * Name: fat_advance
+ *
+ * Description:
+ *   Move the current sector of the file forward by the 'nsectors' sectors
+ *   just transferred, which may end in a later cluster 'last'.
+ *
+ ****************************************************************************/
+
+static void fat_advance(FAR struct fat_mountpt_s *fs,
+                        FAR struct fat_file_s *ff,
+                        unsigned int nsectors, uint32_t last)
+{
+  unsigned int remaining;
+  unsigned int nclusters;
+
+  if (nsectors > ff->ff_sectorsincluster)
+    {
+      remaining = nsectors - ff->ff_sectorsincluster;
+      nclusters = DIV_ROUND_UP(remaining, fs->fs_fatsecperclus);
+
+      ff->ff_currentcluster   = last;
+      ff->ff_pos             += (off_t)nclusters * fs->fs_fatsecperclus *
+                                fs->fs_hwsectorsize;
+      ff->ff_sectorsincluster = nclusters * fs->fs_fatsecperclus -
+                                remaining;
+    }
+  else
+    {
+      ff->ff_sectorsincluster -= nsectors;
+    }
+
+  ff->ff_currentsector += nsectors;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_read
  ****************************************************************************/
@@ -758,6 +891,7 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
 
 #ifndef CONFIG_FAT_FORCE_INDIRECT
   unsigned int nsectors;
+  uint32_t last;
   bool force_indirect = false;
 #endif
 
@@ -864,13 +998,10 @@ fat_read_restart:
            *
            * Limit the number of sectors that we read on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster and the clusters adjacent to it on the media
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
-            {
-              nsectors = ff->ff_sectorsincluster;
-            }
+          nsectors = fat_contiguous(fs, ff, nsectors, false, &last);
 
           /* We are not sure of the state of the file buffer so
            * the safest thing to do is just invalidate it
@@ -904,9 +1035,8 @@ fat_read_restart:
               goto errout_with_lock;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
-          bytesread                = nsectors * fs->fs_hwsectorsize;
+          fat_advance(fs, ff, nsectors, last);
+          bytesread = nsectors * fs->fs_hwsectorsize;
         }
       else
 #endif /* CONFIG_FAT_FORCE_INDIRECT */
@@ -978,6 +1108,7 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
 
 #ifndef CONFIG_FAT_FORCE_INDIRECT
   unsigned int nsectors;
+  uint32_t last;
   bool force_indirect = false;
 #endif
 
@@ -1062,13 +1193,10 @@ fat_write_restart:
            *
            * Limit the number of sectors that we write on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster and the clusters adjacent to it on the media
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
-            {
-              nsectors = ff->ff_sectorsincluster;
-            }
+          nsectors = fat_contiguous(fs, ff, nsectors, true, &last);
 
           /* We are not sure of the state of the sector cache so the
            * safest thing to do is write back any dirty, cached sector
@@ -1103,10 +1231,9 @@ fat_write_restart:
               goto errout_with_lock;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
-          writesize                = nsectors * fs->fs_hwsectorsize;
-          ff->ff_bflags           |= FFBUFF_MODIFIED;
+          fat_advance(fs, ff, nsectors, last);
+          writesize      = nsectors * fs->fs_hwsectorsize;
+          ff->ff_bflags |= FFBUFF_MODIFIED;
         }
       else
 #endif /* CONFIG_FAT_FORCE_INDIRECT */
@@ -1594,6 +1721,10 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_startcluster     = oldff->ff_startcluster;     /* Start cluster of file on media */
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
+#ifdef CONFIG_FAT_CLUSTERCACHE
+  newff->ff_nextents         = oldff->ff_nextents;         /* Cached cluster chain */
+  memcpy(newff->ff_extents, oldff->ff_extents, sizeof(newff->ff_extents));
+#endif
 
   /* Attach the private date to the struct file instance */
 
@@ -1926,6 +2057,10 @@ static int fat_truncate(FAR struct file *filep, off_t length)
           ret = fat_dirshrink(fs, direntry, length);
         }
 
+      /* The cached cluster chain may include the removed clusters */
+
+      fat_extentinvalidate(ff);
+
       if (ret >= 0)
         {
           /* The truncation has completed without error.  Update the file
@@ -2198,6 +2333,142 @@ errout_with_lock:
   return ERROR;
 }
 
+/****************************************************************************
+ * Name: fat_direntries
+ *
+ * Description:
+ *   Get the number of directory entries per cluster, the unit of the
+ *   directory position cookies.  The cookies are the cluster number and
+ *   the index of the entry in it.  Zero is returned if not all of the
+ *   cookies fit into off_t.
+ *
+ ****************************************************************************/
+
+static off_t fat_direntries(FAR struct fat_mountpt_s *fs)
+{
+  off_t nentries = DIRSEC_NDIRS(fs) * fs->fs_fatsecperclus;
+
+  if ((uint64_t)(fs->fs_nclusters + 2) * nentries > OFF_MAX)
+    {
+      return 0;
+    }
+
+  return nentries;
+}
+
+/****************************************************************************
+ * Name: fat_telldir
+ *
+ * Description: Return a cookie for the current directory position
+ *
+ ****************************************************************************/
+
+static off_t fat_telldir(FAR struct inode *mountpt,
+                         FAR struct fs_dirent_s *dir)
+{
+  FAR struct fat_dirent_s *fdir;
+  FAR struct fat_mountpt_s *fs;
+  off_t nentries;
+
+  /* Recover our private data from the inode instance */
+
+  fs   = mountpt->i_private;
+  fdir = (FAR struct fat_dirent_s *)dir;
+
+  nentries = fat_direntries(fs);
+  if (nentries == 0)
+    {
+      return -EOVERFLOW;
+    }
+
+  /* The FAT12/16 root directory has no clusters, the index counts all of
+   * its entries.
+   */
+
+  return fdir->dir.fd_currcluster * nentries + fdir->dir.fd_index;
+}
+
+/****************************************************************************
+ * Name: fat_seekdir
+ *
+ * Description:
+ *   Move to the directory position of a cookie returned by fat_telldir(),
+ *   without reading the entries in between.
+ *
+ ****************************************************************************/
+
+static int fat_seekdir(FAR struct inode *mountpt,
+                       FAR struct fs_dirent_s *dir, off_t offset)
+{
+  FAR struct fat_dirent_s *fdir;
+  FAR struct fat_mountpt_s *fs;
+  off_t nentries;
+  off_t cluster;
+  unsigned int index;
+  int ret;
+
+  /* Recover our private data from the inode instance */
+
+  fs   = mountpt->i_private;
+  fdir = (FAR struct fat_dirent_s *)dir;
+
+  /* Without cookies the VFS counts the entries */
+
+  nentries = fat_direntries(fs);
+  if (nentries == 0)
+    {
+      return -ENOSYS;
+    }
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = fat_checkmount(fs);
+  if (ret != OK)
+    {
+      goto errout_with_lock;
+    }
+
+  if (fs->fs_type != FSTYPE_FAT32 && fdir->dir.fd_startcluster == 0)
+    {
+      /* Handle the FAT12/16 root directory */
+
+      if (offset >= fs->fs_rootentcnt)
+        {
+          ret = -EINVAL;
+          goto errout_with_lock;
+        }
+
+      cluster = 0;
+      index   = offset;
+      fdir->dir.fd_currsector = fs->fs_rootbase + index / DIRSEC_NDIRS(fs);
+    }
+  else
+    {
+      cluster = offset / nentries;
+      index   = offset % nentries;
+
+      if (cluster < 2 || cluster >= fs->fs_nclusters + 2)
+        {
+          ret = -EINVAL;
+          goto errout_with_lock;
+        }
+
+      fdir->dir.fd_currsector = fat_cluster2sector(fs, cluster) +
+                                index / DIRSEC_NDIRS(fs);
+    }
+
+  fdir->dir.fd_currcluster = cluster;
+  fdir->dir.fd_index       = index;
+
+errout_with_lock:
+  nxmutex_unlock(&fs->fs_lock);
+  return ret;
+}
+
 /****************************************************************************
  * Name: fat_bind
  *
@@ -2251,6 +2522,9 @@ static int fat_bind(FAR struct inode *blkdriver, FAR const void *data,
   ret = fat_mount(fs, true);
   if (ret != 0)
     {
+#ifdef CONFIG_FS_PAGECACHE
+      pagecache_release(&fs->fs_pagecache);
+#endif
       nxmutex_destroy(&fs->fs_lock);
       fs_heap_free(fs);
       return ret;
@@ -2353,6 +2627,11 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FS_PAGECACHE
+  pagecache_release(&fs->fs_pagecache);
+#endif
+
+  fat_freemaprelease(fs);
   nxmutex_destroy(&fs->fs_lock);
   fs_heap_free(fs);
   return OK;
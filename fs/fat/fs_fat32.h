@@ -34,6 +34,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
+#include <nuttx/fs/pagecache.h>
 
 #include "fs_heap.h"
 
@@ -889,8 +890,27 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#ifdef CONFIG_FS_PAGECACHE
+  struct pagecache_s fs_pagecache; /* The sectors in the page cache */
+#endif
+#ifdef CONFIG_FAT_FREEMAP
+  FAR uint8_t *fs_freemap;         /* One bit per cluster, set if in use */
+#endif
 };
 
+#ifdef CONFIG_FAT_CLUSTERCACHE
+/* This structure describes a run of consecutive clusters in the cluster
+ * chain of an opened file.
+ */
+
+struct fat_extent_s
+{
+  uint32_t fe_index;               /* Index of the first cluster in the file */
+  uint32_t fe_cluster;             /* The first cluster of the run */
+  uint32_t fe_count;               /* The number of clusters in the run */
+};
+#endif
+
 /* This structure represents on open file under the mountpoint.  An instance
  * of this structure is retained as struct file specific information on each
  * opened file.
@@ -911,6 +931,13 @@ struct fat_file_s
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   off_t    ff_pos;                 /* Current position in the file */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#ifdef CONFIG_FAT_CLUSTERCACHE
+  uint8_t  ff_nextents;            /* Number of valid entries in ff_extents */
+
+  /* The beginning of the cluster chain, in the order of the file */
+
+  struct fat_extent_s ff_extents[CONFIG_FAT_CLUSTERCACHE_NEXTENTS];
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -1053,6 +1080,23 @@ EXTERN int32_t fat_extendchain(FAR struct fat_mountpt_s *fs,
 
 #define fat_createchain(fs) fat_extendchain(fs, 0)
 
+#ifdef CONFIG_FAT_CLUSTERCACHE
+EXTERN int    fat_extentlookup(FAR struct fat_file_s *ff, uint32_t index,
+                               FAR uint32_t *cluster);
+EXTERN void   fat_extentadd(FAR struct fat_file_s *ff, uint32_t index,
+                            uint32_t cluster);
+#  define fat_extentinvalidate(ff) ((ff)->ff_nextents = 0)
+#else
+#  define fat_extentadd(ff, index, cluster)
+#  define fat_extentinvalidate(ff)
+#endif
+
+#ifdef CONFIG_FAT_FREEMAP
+EXTERN void   fat_freemaprelease(FAR struct fat_mountpt_s *fs);
+#else
+#  define fat_freemaprelease(fs)
+#endif
+
 /* Help for traversing directory trees and accessing directory entries */
 
 EXTERN int    fat_nextdirentry(FAR struct fat_mountpt_s *fs,
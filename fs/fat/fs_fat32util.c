@@ -38,14 +38,170 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
+#include <nuttx/fs/ioctl.h>
 
 #include "inode/inode.h"
 #include "fs_fat32.h"
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int fat_rawread(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
+                       off_t sector, unsigned int nsectors);
+static int fat_rawwrite(FAR struct fat_mountpt_s *fs,
+                        FAR const uint8_t *buffer, off_t sector,
+                        unsigned int nsectors);
+#ifdef CONFIG_FAT_DISCARD
+static void fat_discard(FAR struct fat_mountpt_s *fs, uint32_t cluster,
+                        uint32_t nclusters);
+#endif
+#ifdef CONFIG_FS_PAGECACHE
+static int fat_readpages(FAR void *priv, off_t page, size_t npages,
+                         FAR uint8_t *buffer);
+static int fat_writepages(FAR void *priv, off_t page, size_t npages,
+                          FAR const uint8_t *buffer);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PAGECACHE
+static const struct pagecache_ops_s g_fat_pagecache_ops =
+{
+  fat_readpages,  /* read_pages */
+  fat_writepages  /* write_pages */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: fat_rawread
+ *
+ * Description:
+ *   Read sectors from the block driver
+ *
+ ****************************************************************************/
+
+static int fat_rawread(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
+                       off_t sector, unsigned int nsectors)
+{
+  int ret = -ENODEV;
+  if (fs && fs->fs_blkdriver)
+    {
+      struct inode *inode = fs->fs_blkdriver;
+      if (inode && inode->u.i_bops && inode->u.i_bops->read)
+        {
+          ssize_t nsectorsread = inode->u.i_bops->read(inode, buffer,
+                                                       sector, nsectors);
+          if (nsectorsread == nsectors)
+            {
+              ret = OK;
+            }
+          else if (nsectorsread < 0)
+            {
+              ret = nsectorsread;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_rawwrite
+ *
+ * Description:
+ *   Write sectors to the block driver
+ *
+ ****************************************************************************/
+
+static int fat_rawwrite(FAR struct fat_mountpt_s *fs,
+                        FAR const uint8_t *buffer, off_t sector,
+                        unsigned int nsectors)
+{
+  int ret = -ENODEV;
+  if (fs && fs->fs_blkdriver)
+    {
+      struct inode *inode = fs->fs_blkdriver;
+      if (inode && inode->u.i_bops && inode->u.i_bops->write)
+        {
+          ssize_t nsectorswritten =
+              inode->u.i_bops->write(inode, buffer, sector, nsectors);
+
+          if (nsectorswritten == nsectors)
+            {
+              ret = OK;
+            }
+          else if (nsectorswritten < 0)
+            {
+              ret = nsectorswritten;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_discard
+ *
+ * Description:
+ *   Tell the block driver that the data of a run of freed clusters is no
+ *   longer needed, so that a flash translation layer does not copy it
+ *   during its garbage collection.  The discard is only a hint, failures
+ *   are ignored.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_DISCARD
+static void fat_discard(FAR struct fat_mountpt_s *fs, uint32_t cluster,
+                        uint32_t nclusters)
+{
+  FAR struct inode *inode = fs->fs_blkdriver;
+  struct blk_range_s range;
+  off_t sector;
+
+  sector = fat_cluster2sector(fs, cluster);
+  if (sector < 0 || inode == NULL || inode->u.i_bops == NULL ||
+      inode->u.i_bops->ioctl == NULL)
+    {
+      return;
+    }
+
+  range.start    = sector;
+  range.nsectors = (blkcnt_t)nclusters * fs->fs_fatsecperclus;
+  inode->u.i_bops->ioctl(inode, BIOC_DISCARD,
+                         (unsigned long)((uintptr_t)&range));
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_readpages and fat_writepages
+ *
+ * Description:
+ *   Access the sectors of the block driver for the page cache
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PAGECACHE
+static int fat_readpages(FAR void *priv, off_t page, size_t npages,
+                         FAR uint8_t *buffer)
+{
+  return fat_rawread(priv, buffer, page, npages);
+}
+
+static int fat_writepages(FAR void *priv, off_t page, size_t npages,
+                          FAR const uint8_t *buffer)
+{
+  return fat_rawwrite(priv, buffer, page, npages);
+}
+#endif
+
 /****************************************************************************
  * Name: fat_checkfsinfo
  *
@@ -263,6 +419,225 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+#ifdef CONFIG_FAT_FREEMAP
+/****************************************************************************
+ * Name: fat_freemapbuild
+ *
+ * Description:
+ *   Allocate the free cluster bitmap and fill it by reading the whole FAT
+ *   once.  This also yields the exact number of free clusters.
+ *
+ ****************************************************************************/
+
+static int fat_freemapbuild(FAR struct fat_mountpt_s *fs)
+{
+  FAR uint8_t *freemap;
+  uint32_t nfreeclusters = 0;
+  uint32_t cluster;
+  off_t next;
+
+  freemap = fs_heap_zalloc((fs->fs_nclusters + 7) / 8);
+  if (freemap == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (cluster = 2; cluster < fs->fs_nclusters + 2; cluster++)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next < 0)
+        {
+          fs_heap_free(freemap);
+          return (int)next;
+        }
+      else if (next == 0)
+        {
+          nfreeclusters++;
+        }
+      else
+        {
+          freemap[(cluster - 2) >> 3] |= 1 << ((cluster - 2) & 7);
+        }
+    }
+
+  fs->fs_freemap = freemap;
+
+  if (fs->fs_fsifreecount != nfreeclusters)
+    {
+      fs->fs_fsifreecount = nfreeclusters;
+      if (fs->fs_type == FSTYPE_FAT32)
+        {
+          fs->fs_fsidirty = true;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_freemapmark
+ *
+ * Description:
+ *   Update the free cluster bitmap after a FAT entry was written.
+ *
+ ****************************************************************************/
+
+static void fat_freemapmark(FAR struct fat_mountpt_s *fs, uint32_t cluster,
+                            bool inuse)
+{
+  if (fs->fs_freemap != NULL && cluster >= 2)
+    {
+      uint32_t ndx = cluster - 2;
+
+      if (inuse)
+        {
+          fs->fs_freemap[ndx >> 3] |= 1 << (ndx & 7);
+        }
+      else
+        {
+          fs->fs_freemap[ndx >> 3] &= ~(1 << (ndx & 7));
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_freemapfind
+ *
+ * Description:
+ *   Search the free cluster bitmap for the first free cluster after
+ *   'startcluster', wrapping around at the end of the volume.  Fully used
+ *   bytes are skipped eight clusters at a time.
+ *
+ * Returned Value:
+ *   The free cluster number or 0 if there is no free cluster.
+ *
+ ****************************************************************************/
+
+static uint32_t fat_freemapfind(FAR struct fat_mountpt_s *fs,
+                                uint32_t startcluster)
+{
+  uint32_t nclusters = fs->fs_nclusters;
+  uint32_t ndx = startcluster - 1;
+  uint32_t n = 0;
+
+  while (n < nclusters)
+    {
+      if (ndx >= nclusters)
+        {
+          ndx = 0;
+        }
+
+      if ((ndx & 7) == 0 && ndx + 8 <= nclusters &&
+          fs->fs_freemap[ndx >> 3] == 0xff)
+        {
+          ndx += 8;
+          n   += 8;
+          continue;
+        }
+
+      if ((fs->fs_freemap[ndx >> 3] & (1 << (ndx & 7))) == 0)
+        {
+          return ndx + 2;
+        }
+
+      ndx++;
+      n++;
+    }
+
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_findfree
+ *
+ * Description:
+ *   Find a free cluster, starting the search after 'startcluster'.
+ *
+ * Returned Value:
+ *   <0:error, 0: no free cluster, >=2: free cluster number
+ *
+ ****************************************************************************/
+
+static int32_t fat_findfree(FAR struct fat_mountpt_s *fs,
+                            uint32_t startcluster)
+{
+  off_t    startsector;
+  uint32_t newcluster;
+
+#ifdef CONFIG_FAT_FREEMAP
+  /* Use the bitmap unless it cannot be built.  Then the FAT is searched */
+
+  if (fs->fs_freemap == NULL)
+    {
+      fat_freemapbuild(fs);
+    }
+
+  if (fs->fs_freemap != NULL)
+    {
+      return fat_freemapfind(fs, startcluster);
+    }
+#endif
+
+  /* Loop until (1) we discover that there are not free clusters
+   * (return 0), an errors occurs (return -errno), or (3) we find
+   * the next cluster (return the new cluster number).
+   */
+
+  newcluster = startcluster;
+  for (; ; )
+    {
+      /* Examine the next cluster in the FAT */
+
+      newcluster++;
+      if (newcluster >= fs->fs_nclusters + 2)
+        {
+          /* If we hit the end of the available clusters, then
+           * wrap back to the beginning because we might have
+           * started at a non-optimal place.  But don't continue
+           * past the start cluster.
+           */
+
+          newcluster = 2;
+          if (newcluster > startcluster)
+            {
+              /* We are back past the starting cluster, then there
+               * is no free cluster.
+               */
+
+              return 0;
+            }
+        }
+
+      /* We have a candidate cluster.  Check if the cluster number is
+       * mapped to a group of sectors.
+       */
+
+      startsector = fat_getcluster(fs, newcluster);
+      if (startsector == 0)
+        {
+          /* Found have found a free cluster */
+
+          return newcluster;
+        }
+      else if (startsector < 0)
+        {
+          /* Some error occurred, return the error number */
+
+          return startsector;
+        }
+
+      /* We wrap all the back to the starting cluster?  If so, then
+       * there are no free clusters.
+       */
+
+      if (newcluster == startcluster)
+        {
+          return 0;
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -504,6 +879,14 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   fs->fs_hwsectorsize = geo.geo_sectorsize;
   fs->fs_hwnsectors   = geo.geo_nsectors;
 
+#ifdef CONFIG_FS_PAGECACHE
+  /* Drop the sectors cached before the media was changed */
+
+  pagecache_release(&fs->fs_pagecache);
+  pagecache_init(&fs->fs_pagecache, &g_fat_pagecache_ops, fs,
+                 fs->fs_hwsectorsize);
+#endif
+
   /* Allocate a buffer to hold one hardware sector */
 
   fs->fs_buffer = (FAR uint8_t *)fat_io_alloc(fs->fs_hwsectorsize);
@@ -715,26 +1098,11 @@ int fat_checkmount(struct fat_mountpt_s *fs)
 int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
                unsigned int nsectors)
 {
-  int ret = -ENODEV;
-  if (fs && fs->fs_blkdriver)
-    {
-      struct inode *inode = fs->fs_blkdriver;
-      if (inode && inode->u.i_bops && inode->u.i_bops->read)
-        {
-          ssize_t nsectorsread = inode->u.i_bops->read(inode, buffer,
-                                                       sector, nsectors);
-          if (nsectorsread == nsectors)
-            {
-              ret = OK;
-            }
-          else if (nsectorsread < 0)
-            {
-              ret = nsectorsread;
-            }
-        }
-    }
-
-  return ret;
+#ifdef CONFIG_FS_PAGECACHE
+  return pagecache_read(&fs->fs_pagecache, sector, nsectors, buffer);
+#else
+  return fat_rawread(fs, buffer, sector, nsectors);
+#endif
 }
 
 /****************************************************************************
@@ -748,27 +1116,11 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
 int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
                 unsigned int nsectors)
 {
-  int ret = -ENODEV;
-  if (fs && fs->fs_blkdriver)
-    {
-      struct inode *inode = fs->fs_blkdriver;
-      if (inode && inode->u.i_bops && inode->u.i_bops->write)
-        {
-          ssize_t nsectorswritten =
-              inode->u.i_bops->write(inode, buffer, sector, nsectors);
-
-          if (nsectorswritten == nsectors)
-            {
-              ret = OK;
-            }
-          else if (nsectorswritten < 0)
-            {
-              ret = nsectorswritten;
-            }
-        }
-    }
-
-  return ret;
+#ifdef CONFIG_FS_PAGECACHE
+  return pagecache_write(&fs->fs_pagecache, sector, nsectors, buffer);
+#else
+  return fat_rawwrite(fs, buffer, sector, nsectors);
+#endif
 }
 
 /****************************************************************************
@@ -1096,6 +1448,9 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
+#ifdef CONFIG_FAT_FREEMAP
+      fat_freemapmark(fs, clusterno, nextcluster != 0);
+#endif
       return OK;
     }
 
@@ -1113,6 +1468,10 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
 int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
 {
   int32_t nextcluster;
+#ifdef CONFIG_FAT_DISCARD
+  uint32_t runstart = cluster;
+  uint32_t runlen = 0;
+#endif
   int    ret;
 
   /* Loop while there are clusters in the chain */
@@ -1145,6 +1504,18 @@ int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
           fs->fs_fsidirty = true;
         }
 
+#ifdef CONFIG_FAT_DISCARD
+      /* Discard the freed clusters by runs of consecutive clusters */
+
+      runlen++;
+      if (nextcluster != cluster + 1)
+        {
+          fat_discard(fs, runstart, runlen);
+          runstart = nextcluster;
+          runlen   = 0;
+        }
+#endif
+
       /* Then set up to remove the next cluster */
 
       cluster = nextcluster;
@@ -1168,7 +1539,7 @@ int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
 int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
 {
   off_t    startsector;
-  uint32_t newcluster;
+  int32_t  newcluster;
   uint32_t startcluster;
   int      ret;
 
@@ -1219,66 +1590,16 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
-  /* Loop until (1) we discover that there are not free clusters
-   * (return 0), an errors occurs (return -errno), or (3) we find
-   * the next cluster (return the new cluster number).
-   */
+  /* Find a free cluster (return 0 if there is none, -errno on an error) */
 
-  newcluster = startcluster;
-  for (; ; )
+  newcluster = fat_findfree(fs, startcluster);
+  if (newcluster <= 0)
     {
-      /* Examine the next cluster in the FAT */
-
-      newcluster++;
-      if (newcluster >= fs->fs_nclusters + 2)
-        {
-          /* If we hit the end of the available clusters, then
-           * wrap back to the beginning because we might have
-           * started at a non-optimal place.  But don't continue
-           * past the start cluster.
-           */
-
-          newcluster = 2;
-          if (newcluster > startcluster)
-            {
-              /* We are back past the starting cluster, then there
-               * is no free cluster.
-               */
-
-              return 0;
-            }
-        }
-
-      /* We have a candidate cluster.  Check if the cluster number is
-       * mapped to a group of sectors.
-       */
-
-      startsector = fat_getcluster(fs, newcluster);
-      if (startsector == 0)
-        {
-          /* Found have found a free cluster break out */
-
-          break;
-        }
-      else if (startsector < 0)
-        {
-          /* Some error occurred, return the error number */
-
-          return startsector;
-        }
-
-      /* We wrap all the back to the starting cluster?  If so, then
-       * there are no free clusters.
-       */
-
-      if (newcluster == startcluster)
-        {
-          return 0;
-        }
+      return newcluster;
     }
 
-  /* We get here only if we break out with an available cluster
-   * number in 'newcluster'  Now mark that cluster as in-use.
+  /* We get here only if we found an available cluster number in
+   * 'newcluster'  Now mark that cluster as in-use.
    */
 
   ret = fat_putcluster(fs, newcluster, 0x0fffffff);
@@ -1316,6 +1637,117 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
   return newcluster;
 }
 
+#ifdef CONFIG_FAT_CLUSTERCACHE
+/****************************************************************************
+ * Name: fat_extentlookup
+ *
+ * Description:
+ *   Look up the cluster of the file cluster 'index' in the cluster chain
+ *   cache of the file.  If the cache does not reach that far, the last
+ *   cached cluster before it is returned.
+ *
+ * Returned Value:
+ *   The index in the file of the cluster returned in 'cluster' or -ENOENT
+ *   if nothing is cached.
+ *
+ ****************************************************************************/
+
+int fat_extentlookup(FAR struct fat_file_s *ff, uint32_t index,
+                     FAR uint32_t *cluster)
+{
+  FAR struct fat_extent_s *fe;
+  uint32_t offset;
+  int i;
+
+  for (i = ff->ff_nextents - 1; i >= 0; i--)
+    {
+      fe = &ff->ff_extents[i];
+      if (fe->fe_index <= index)
+        {
+          offset = index - fe->fe_index;
+          if (offset >= fe->fe_count)
+            {
+              offset = fe->fe_count - 1;
+            }
+
+          *cluster = fe->fe_cluster + offset;
+          return fe->fe_index + offset;
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: fat_extentadd
+ *
+ * Description:
+ *   Record that the file cluster 'index' is 'cluster'.  The cache only
+ *   holds the beginning of the chain without gaps, so clusters that do not
+ *   follow the cached ones directly are ignored.  So is a new run if all
+ *   extents are used.
+ *
+ ****************************************************************************/
+
+void fat_extentadd(FAR struct fat_file_s *ff, uint32_t index,
+                   uint32_t cluster)
+{
+  FAR struct fat_extent_s *fe;
+
+  if (ff->ff_nextents == 0)
+    {
+      if (index == 0)
+        {
+          fe             = &ff->ff_extents[0];
+          fe->fe_index   = 0;
+          fe->fe_cluster = cluster;
+          fe->fe_count   = 1;
+          ff->ff_nextents = 1;
+        }
+
+      return;
+    }
+
+  fe = &ff->ff_extents[ff->ff_nextents - 1];
+  if (index != fe->fe_index + fe->fe_count)
+    {
+      return;
+    }
+
+  if (cluster == fe->fe_cluster + fe->fe_count)
+    {
+      fe->fe_count++;
+    }
+  else if (ff->ff_nextents < CONFIG_FAT_CLUSTERCACHE_NEXTENTS)
+    {
+      fe++;
+      fe->fe_index   = index;
+      fe->fe_cluster = cluster;
+      fe->fe_count   = 1;
+      ff->ff_nextents++;
+    }
+}
+#endif
+
+#ifdef CONFIG_FAT_FREEMAP
+/****************************************************************************
+ * Name: fat_freemaprelease
+ *
+ * Description:
+ *   Free the free cluster bitmap when the volume is unmounted.
+ *
+ ****************************************************************************/
+
+void fat_freemaprelease(FAR struct fat_mountpt_s *fs)
+{
+  if (fs->fs_freemap != NULL)
+    {
+      fs_heap_free(fs->fs_freemap);
+      fs->fs_freemap = NULL;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: fat_nextdirentry
  *
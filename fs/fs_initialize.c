@@ -23,6 +23,8 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/fs/pagecache.h>
+#include <nuttx/init.h>
 #include <nuttx/reboot_notifier.h>
 #include <nuttx/trace.h>
 
@@ -82,27 +84,31 @@ void fs_initialize(void)
 {
   fs_trace_begin();
 
-  fs_heap_initialize();
+  INITCALL(fs_heap_initialize());
 
   /* Initial inode, file, and VFS data structures */
 
-  inode_initialize();
+  INITCALL(inode_initialize());
 
-  file_initlk();
+  INITCALL(file_initlk());
 
 #ifdef CONFIG_FS_AIO
   /* Initialize for asynchronous I/O */
 
-  aio_initialize();
+  INITCALL(aio_initialize());
 
 #endif
 
 #ifdef CONFIG_FS_RPMSGFS_SERVER
-  rpmsgfs_server_init();
+  INITCALL(rpmsgfs_server_init());
 #endif
 
 #ifdef CONFIG_FS_NOTIFY
-  notify_initialize();
+  INITCALL(notify_initialize());
+#endif
+
+#ifdef CONFIG_FS_PAGECACHE
+  INITCALL(pagecache_initialize());
 #endif
 
   register_reboot_notifier(&g_sync_nb);
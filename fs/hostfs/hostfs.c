@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
@@ -53,6 +54,14 @@
 
 #define HOSTFS_RETRY_DELAY_MS       10
 
+/* The readahead window starts at this size and doubles with each refill
+ * of a sequential reader, up to CONFIG_FS_HOSTFS_READAHEAD.
+ */
+
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+#  define HOSTFS_RA_MIN  MIN(CONFIG_FS_HOSTFS_READAHEAD, 512)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -236,6 +245,190 @@ static void hostfs_mkpath(FAR struct hostfs_mountpt_s  *fs,
     }
 }
 
+#ifdef HOSTFS_BUFFERED
+
+/****************************************************************************
+ * Name: hostfs_setpos
+ *
+ * Description: Move the host file position to pos, if it is not there.
+ *   With readahead and write-behind the host position runs ahead of or
+ *   behind the local one.
+ *
+ ****************************************************************************/
+
+static int hostfs_setpos(FAR struct hostfs_ofile_s *hf, off_t pos)
+{
+  off_t ret;
+
+  if (hf->pos == pos)
+    {
+      return OK;
+    }
+
+  ret = host_lseek(hf->fd, hf->pos, pos, SEEK_SET);
+  if (ret < 0)
+    {
+      hf->pos = -1;
+      return ret;
+    }
+
+  hf->pos = ret;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hostfs_advance
+ *
+ * Description: Account for nbytes read or written at the host position.
+ *   Writes of an O_APPEND file go to the end, wherever the position was.
+ *
+ ****************************************************************************/
+
+static void hostfs_advance(FAR struct hostfs_ofile_s *hf, ssize_t nbytes,
+                           bool write)
+{
+  if (hf->pos < 0 || (write && (hf->oflags & O_APPEND) != 0))
+    {
+      hf->pos = -1;
+    }
+  else if (nbytes > 0)
+    {
+      hf->pos += nbytes;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: hostfs_flush
+ *
+ * Description: Write the data waiting in the write-behind buffer.  This
+ *   is the barrier before any operation that depends on the host file.
+ *
+ ****************************************************************************/
+
+static int hostfs_flush(FAR struct hostfs_ofile_s *hf)
+{
+#if CONFIG_FS_HOSTFS_WRITEBEHIND > 0
+  ssize_t ret;
+
+  if (hf->wblen == 0)
+    {
+      return OK;
+    }
+
+  ret = hostfs_setpos(hf, hf->wbpos);
+  if (ret >= 0)
+    {
+      ret = host_write(hf->fd, hf->wbbuf, hf->wblen);
+      hostfs_advance(hf, ret, true);
+    }
+
+  /* The data is dropped on an error, like a failed write() had not
+   * written it.
+   */
+
+  hf->wblen = 0;
+  return ret < 0 ? ret : OK;
+#else
+  return OK;
+#endif
+}
+
+/****************************************************************************
+ * Name: hostfs_dropra
+ *
+ * Description: Forget the readahead data, after the file was modified.
+ *
+ ****************************************************************************/
+
+static void hostfs_dropra(FAR struct hostfs_ofile_s *hf)
+{
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  hf->ralen = 0;
+#endif
+}
+
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+
+/****************************************************************************
+ * Name: hostfs_readahead
+ *
+ * Description: Read through the readahead buffer.  Reads that are at
+ *   least as large as the window go to the caller's buffer directly.
+ *
+ ****************************************************************************/
+
+static ssize_t hostfs_readahead(FAR struct hostfs_ofile_s *hf, off_t pos,
+                                FAR char *buffer, size_t buflen)
+{
+  bool seq = pos == hf->ranext;
+  size_t done = 0;
+  ssize_t ret;
+  size_t n;
+
+  if (!seq)
+    {
+      hf->rawin = HOSTFS_RA_MIN;
+    }
+
+  if (pos >= hf->rapos && pos < hf->rapos + (off_t)hf->ralen)
+    {
+      done = MIN(buflen, hf->rapos + hf->ralen - pos);
+      memcpy(buffer, hf->rabuf + (pos - hf->rapos), done);
+    }
+
+  if (done < buflen)
+    {
+      if (seq && hf->ralen > 0)
+        {
+          hf->rawin = MIN(hf->rawin * 2, CONFIG_FS_HOSTFS_READAHEAD);
+        }
+
+      if (hf->rabuf == NULL)
+        {
+          hf->rabuf = fs_heap_malloc(CONFIG_FS_HOSTFS_READAHEAD);
+        }
+
+      ret = hostfs_setpos(hf, pos + done);
+      if (ret < 0)
+        {
+          return done > 0 ? done : ret;
+        }
+
+      if (buflen - done >= hf->rawin || hf->rabuf == NULL)
+        {
+          ret = host_read(hf->fd, buffer + done, buflen - done);
+          hostfs_advance(hf, ret, false);
+          n = ret > 0 ? ret : 0;
+        }
+      else
+        {
+          hf->ralen = 0;
+          ret = host_read(hf->fd, hf->rabuf, hf->rawin);
+          hostfs_advance(hf, ret, false);
+          if (ret > 0)
+            {
+              hf->rapos = pos + done;
+              hf->ralen = ret;
+            }
+
+          n = ret > 0 ? MIN(buflen - done, ret) : 0;
+          memcpy(buffer + done, hf->rabuf, n);
+        }
+
+      if (ret < 0 && done == 0)
+        {
+          return ret;
+        }
+
+      done += n;
+    }
+
+  hf->ranext = pos + done;
+  return done;
+}
+#endif
+
 /****************************************************************************
  * Name: hostfs_open
  ****************************************************************************/
@@ -300,12 +493,30 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
    * file.
    */
 
+#ifdef HOSTFS_BUFFERED
+  hf->pos    = 0;
+#endif
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  hf->rabuf  = NULL;
+  hf->rapos  = 0;
+  hf->ralen  = 0;
+  hf->rawin  = HOSTFS_RA_MIN;
+  hf->ranext = -1;
+#endif
+#if CONFIG_FS_HOSTFS_WRITEBEHIND > 0
+  hf->wbbuf  = NULL;
+  hf->wblen  = 0;
+#endif
+
   if ((oflags & (O_APPEND | O_WRONLY)) == (O_APPEND | O_WRONLY))
     {
       ret = host_lseek(hf->fd, 0, 0, SEEK_END);
       if (ret >= 0)
         {
           filep->f_pos = ret;
+#ifdef HOSTFS_BUFFERED
+          hf->pos      = ret;
+#endif
         }
       else
         {
@@ -420,18 +631,28 @@ static int hostfs_close(FAR struct file *filep)
         }
     }
 
-  /* Close the host file */
+  /* Write what is left in the write-behind buffer and close the host
+   * file
+   */
 
+  ret = hostfs_flush(hf);
   host_close(hf->fd);
 
   /* Now free the pointer */
 
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  fs_heap_free(hf->rabuf);
+#endif
+#if CONFIG_FS_HOSTFS_WRITEBEHIND > 0
+  fs_heap_free(hf->wbbuf);
+#endif
+
   filep->f_priv = NULL;
   fs_heap_free(hf);
 
 okout:
   nxmutex_unlock(&g_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -466,14 +687,39 @@ static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
       return ret;
     }
 
+  /* Written data waiting in the buffer may be read back */
+
+  ret = hostfs_flush(hf);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
   /* Call the host to perform the read */
 
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  ret = hostfs_readahead(hf, filep->f_pos, buffer, buflen);
+#else
+#  ifdef HOSTFS_BUFFERED
+  ret = hostfs_setpos(hf, filep->f_pos);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+#  endif
+
   ret = host_read(hf->fd, buffer, buflen);
+#  ifdef HOSTFS_BUFFERED
+  hostfs_advance(hf, ret, false);
+#  endif
+#endif
+
   if (ret > 0)
     {
       filep->f_pos += ret;
     }
 
+errout_with_lock:
   nxmutex_unlock(&g_lock);
   return ret;
 }
@@ -518,9 +764,58 @@ static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_lock;
     }
 
+  hostfs_dropra(hf);
+
+#if CONFIG_FS_HOSTFS_WRITEBEHIND > 0
+  /* Only a write that goes on where the buffered data ends is added to
+   * it.  The buffer is written when it is full.
+   */
+
+  if (hf->wblen > 0 &&
+      (filep->f_pos != hf->wbpos + (off_t)hf->wblen ||
+       hf->wblen + buflen > CONFIG_FS_HOSTFS_WRITEBEHIND))
+    {
+      ret = hostfs_flush(hf);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+    }
+
+  if (hf->wbbuf == NULL && buflen < CONFIG_FS_HOSTFS_WRITEBEHIND)
+    {
+      hf->wbbuf = fs_heap_malloc(CONFIG_FS_HOSTFS_WRITEBEHIND);
+    }
+
+  if (hf->wbbuf != NULL && buflen < CONFIG_FS_HOSTFS_WRITEBEHIND)
+    {
+      if (hf->wblen == 0)
+        {
+          hf->wbpos = filep->f_pos;
+        }
+
+      memcpy(hf->wbbuf + hf->wblen, buffer, buflen);
+      hf->wblen    += buflen;
+      filep->f_pos += buflen;
+      ret           = buflen;
+      goto errout_with_lock;
+    }
+#endif
+
+#ifdef HOSTFS_BUFFERED
+  ret = hostfs_setpos(hf, filep->f_pos);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+#endif
+
   /* Call the host to perform the write */
 
   ret = host_write(hf->fd, buffer, buflen);
+#ifdef HOSTFS_BUFFERED
+  hostfs_advance(hf, ret, true);
+#endif
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -562,6 +857,22 @@ static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
       return ret;
     }
 
+  ret = hostfs_flush(hf);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+#ifdef HOSTFS_BUFFERED
+  /* The host position is not the file position of this file */
+
+  if (whence == SEEK_CUR)
+    {
+      offset += filep->f_pos;
+      whence  = SEEK_SET;
+    }
+#endif
+
   /* Call our internal routine to perform the seek */
 
   ret = host_lseek(hf->fd, filep->f_pos, offset, whence);
@@ -570,6 +881,11 @@ static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
       filep->f_pos = ret;
     }
 
+#ifdef HOSTFS_BUFFERED
+  hf->pos = ret >= 0 ? ret : -1;
+#endif
+
+errout_with_lock:
   nxmutex_unlock(&g_lock);
   return ret;
 }
@@ -605,6 +921,13 @@ static int hostfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return ret;
     }
 
+  ret = hostfs_flush(hf);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+
   /* Call our internal routine to perform the ioctl */
 
   ret = host_ioctl(hf->fd, cmd, arg);
@@ -667,10 +990,13 @@ static int hostfs_sync(FAR struct file *filep)
       return ret;
     }
 
+  /* The data that is written behind gets to the host first */
+
+  ret = hostfs_flush(hf);
   host_sync(hf->fd);
 
   nxmutex_unlock(&g_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -741,9 +1067,13 @@ static int hostfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
       return ret;
     }
 
-  /* Call the host to perform the read */
+  /* The size must include the data that is written behind */
 
-  ret = host_fstat(hf->fd, buf);
+  ret = hostfs_flush(hf);
+  if (ret >= 0)
+    {
+      ret = host_fstat(hf->fd, buf);
+    }
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -828,6 +1158,15 @@ static int hostfs_ftruncate(FAR struct file *filep, off_t length)
       return ret;
     }
 
+  ret = hostfs_flush(hf);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+
+  hostfs_dropra(hf);
+
   /* Call the host to perform the truncate */
 
   ret = host_ftruncate(hf->fd, length);
@@ -37,6 +37,10 @@
 
 #define HOSTFS_MAX_PATH     256
 
+#if CONFIG_FS_HOSTFS_READAHEAD > 0 || CONFIG_FS_HOSTFS_WRITEBEHIND > 0
+#  define HOSTFS_BUFFERED 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -51,6 +55,21 @@ struct hostfs_ofile_s
   int16_t                   crefs;   /* Reference count */
   mode_t                    oflags;  /* Open mode */
   int                       fd;
+#ifdef HOSTFS_BUFFERED
+  off_t                     pos;     /* Host file position, -1 unknown */
+#endif
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  FAR char                 *rabuf;   /* Readahead buffer */
+  off_t                     rapos;   /* File position of rabuf */
+  size_t                    ralen;   /* Valid bytes in rabuf */
+  size_t                    rawin;   /* Current readahead window */
+  off_t                     ranext;  /* Position of a sequential read */
+#endif
+#if CONFIG_FS_HOSTFS_WRITEBEHIND > 0
+  FAR char                 *wbbuf;   /* Write-behind buffer */
+  off_t                     wbpos;   /* File position of wbbuf */
+  size_t                    wblen;   /* Bytes waiting in wbbuf */
+#endif
   char                      relpath[1];
 };
 
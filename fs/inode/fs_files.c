@@ -56,10 +56,96 @@
 #include "inode/inode.h"
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_FILELIST_LOCKLESS
+/* A fl_files array replaced by files_extend().  The lock-free lookups may
+ * still read it, so it is only freed together with the file list.
+ */
+
+struct files_retired_s
+{
+  FAR struct files_retired_s *next;
+  FAR struct file **files;
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: files_tryref
+ *
+ * Description:
+ *   Increase the reference count of a file unless it is zero, that is the
+ *   file is free or being closed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_REFCOUNT
+static bool files_tryref(FAR struct file *filep)
+{
+  int refs = atomic_load(&filep->f_refs);
+
+  do
+    {
+      if (refs == 0)
+        {
+          return false;
+        }
+    }
+  while (!atomic_compare_exchange_weak(&filep->f_refs, &refs, refs + 1));
+
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: files_fget_lockless
+ *
+ * Description:
+ *   Look up an open file without taking the file list lock.  The rows of
+ *   the file list are never moved or freed while the list is in use, and
+ *   a file is only used once its reference count has been increased.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_FILELIST_LOCKLESS
+static FAR struct file *files_fget_lockless(FAR struct filelist *list,
+                                            int l1, int l2)
+{
+  FAR struct file *filep;
+
+  /* files_extend() stores the new array before the number of rows, so the
+   * array read after the number of rows has at least that many.
+   */
+
+  if (l1 >= atomic_load_explicit(&list->fl_rows, memory_order_acquire))
+    {
+      return NULL;
+    }
+
+  filep = &list->fl_files[l1][l2];
+  if (!files_tryref(filep))
+    {
+      return NULL;
+    }
+
+  /* The file may be reserved by dup2() but not be filled in yet */
+
+  if (filep->f_inode == NULL)
+    {
+      fs_putfilep(filep);
+      return NULL;
+    }
+
+  return filep;
+}
+#endif
+
 /****************************************************************************
  * Name: files_fget_by_index
  ****************************************************************************/
@@ -70,6 +156,13 @@ static FAR struct file *files_fget_by_index(FAR struct filelist *list,
   FAR struct file *filep;
   irqstate_t flags;
 
+#ifdef CONFIG_FS_FILELIST_LOCKLESS
+  if (new == NULL)
+    {
+      return files_fget_lockless(list, l1, l2);
+    }
+#endif
+
   flags = spin_lock_irqsave(NULL);
 
   filep = &list->fl_files[l1][l2];
@@ -80,24 +173,16 @@ static FAR struct file *files_fget_by_index(FAR struct filelist *list,
        * released, At this point we should return a null pointer
        */
 
-      if (filep->f_refs == 0)
+      if (!files_tryref(filep))
         {
           filep = NULL;
         }
-      else
-        {
-          filep->f_refs++;
-        }
     }
   else if (new == NULL)
     {
       filep = NULL;
     }
-  else if (filep->f_refs)
-    {
-      filep->f_refs++;
-    }
-  else
+  else if (!files_tryref(filep))
     {
       filep->f_refs = 2;
       *new = true;
@@ -119,6 +204,9 @@ static FAR struct file *files_fget_by_index(FAR struct filelist *list,
 
 static int files_extend(FAR struct filelist *list, size_t row)
 {
+#ifdef CONFIG_FS_FILELIST_LOCKLESS
+  FAR struct files_retired_s *retired;
+#endif
   FAR struct file **files;
   uint8_t orig_rows;
   FAR void *tmp;
@@ -163,6 +251,20 @@ static int files_extend(FAR struct filelist *list, size_t row)
     }
   while (++i < row);
 
+#ifdef CONFIG_FS_FILELIST_LOCKLESS
+  retired = fs_heap_malloc(sizeof(struct files_retired_s));
+  if (retired == NULL)
+    {
+      while (--i >= orig_rows)
+        {
+          fs_heap_free(files[i]);
+        }
+
+      fs_heap_free(files);
+      return -ENFILE;
+    }
+#endif
+
   flags = spin_lock_irqsave(NULL);
 
   /* To avoid race condition, if the file list is updated by other threads
@@ -180,6 +282,9 @@ static int files_extend(FAR struct filelist *list, size_t row)
         }
 
       fs_heap_free(files);
+#ifdef CONFIG_FS_FILELIST_LOCKLESS
+      fs_heap_free(retired);
+#endif
 
       return OK;
     }
@@ -192,6 +297,26 @@ static int files_extend(FAR struct filelist *list, size_t row)
 
   tmp = list->fl_files;
   list->fl_files = files;
+#ifdef CONFIG_FS_FILELIST_LOCKLESS
+  atomic_store_explicit(&list->fl_rows, row, memory_order_release);
+
+  /* The lookups without the lock may still read the old array */
+
+  if (tmp != NULL && tmp != &list->fl_prefile)
+    {
+      retired->files   = tmp;
+      retired->next    = list->fl_retired;
+      list->fl_retired = retired;
+      retired          = NULL;
+    }
+
+  spin_unlock_irqrestore(NULL, flags);
+
+  if (retired != NULL)
+    {
+      fs_heap_free(retired);
+    }
+#else
   list->fl_rows = row;
 
   spin_unlock_irqrestore(NULL, flags);
@@ -200,6 +325,7 @@ static int files_extend(FAR struct filelist *list, size_t row)
     {
       fs_heap_free(tmp);
     }
+#endif
 
   return OK;
 }
@@ -369,6 +495,9 @@ void files_initlist(FAR struct filelist *list)
   list->fl_crefs = 1;
   list->fl_files = &list->fl_prefile;
   list->fl_prefile = list->fl_prefiles;
+#ifdef CONFIG_FS_FILELIST_LOCKLESS
+  list->fl_retired = NULL;
+#endif
 }
 
 /****************************************************************************
@@ -475,6 +604,9 @@ FAR struct filelist *files_getlist(FAR struct tcb_s *tcb)
 
 void files_putlist(FAR struct filelist *list)
 {
+#ifdef CONFIG_FS_FILELIST_LOCKLESS
+  FAR struct files_retired_s *retired;
+#endif
   int i;
   int j;
 
@@ -506,6 +638,15 @@ void files_putlist(FAR struct filelist *list)
     {
       fs_heap_free(list->fl_files);
     }
+
+#ifdef CONFIG_FS_FILELIST_LOCKLESS
+  while ((retired = list->fl_retired) != NULL)
+    {
+      list->fl_retired = retired->next;
+      fs_heap_free(retired->files);
+      fs_heap_free(retired);
+    }
+#endif
 }
 
 /****************************************************************************
@@ -835,12 +976,17 @@ void fs_reffilep(FAR struct file *filep)
 {
   /* This interface is used to increase the reference count of filep */
 
+#ifdef CONFIG_FS_FILELIST_LOCKLESS
+  DEBUGASSERT(filep);
+  atomic_fetch_add(&filep->f_refs, 1);
+#else
   irqstate_t flags;
 
   DEBUGASSERT(filep);
   flags = spin_lock_irqsave(NULL);
   filep->f_refs++;
   spin_unlock_irqrestore(NULL, flags);
+#endif
 }
 
 /****************************************************************************
@@ -857,16 +1003,25 @@ void fs_reffilep(FAR struct file *filep)
 
 int fs_putfilep(FAR struct file *filep)
 {
+#ifndef CONFIG_FS_FILELIST_LOCKLESS
   irqstate_t flags;
+#endif
   int ret = 0;
   int refs;
 
   DEBUGASSERT(filep);
+
+#ifdef CONFIG_FS_FILELIST_LOCKLESS
+  /* The lookups without the lock increase the count atomically */
+
+  refs = atomic_fetch_sub(&filep->f_refs, 1) - 1;
+#else
   flags = spin_lock_irqsave(NULL);
 
   refs = --filep->f_refs;
 
   spin_unlock_irqrestore(NULL, flags);
+#endif
 
   /* If refs is zero, the close() had called, closing it now. */
 
@@ -0,0 +1,250 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_PSEUDOFS_LOOKUP_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define INODE_CACHE_NOREL UINT8_MAX
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The result of the lookup of one absolute path */
+
+struct inode_cache_s
+{
+  uint32_t gen;                /* Generation of the inode tree, 0: unused */
+  uint32_t hash;               /* Hash of the path */
+  FAR struct inode *node;      /* The inode found, NULL if not found */
+  FAR struct inode *peer;      /* Node to the "left" of the inode */
+  FAR struct inode *parent;    /* Node "above" the inode */
+  uint8_t pathoff;             /* Offset where the search stopped */
+  uint8_t reloff;              /* Offset of relpath or INODE_CACHE_NOREL */
+  char path[CONFIG_PSEUDOFS_LOOKUP_CACHE_PATHLEN];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The lookups run concurrently under the read lock of the inode tree, so
+ * the entries are protected by a lock of their own.
+ */
+
+static struct inode_cache_s g_inode_cache[CONFIG_PSEUDOFS_LOOKUP_CACHE_SIZE];
+static spinlock_t g_inode_cache_lock;
+
+/* Changed by (and only by) modifications of the inode tree, which hold its
+ * write lock.
+ */
+
+static uint32_t g_inode_cache_gen = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_hash
+ *
+ * Description:
+ *   Hash a path (FNV-1a) and return its length.
+ *
+ ****************************************************************************/
+
+static uint32_t inode_cache_hash(FAR const char *path, FAR size_t *len)
+{
+  FAR const char *ptr = path;
+  uint32_t hash = 2166136261u;
+
+  while (*ptr != '\0')
+    {
+      hash ^= (uint8_t)*ptr++;
+      hash *= 16777619u;
+    }
+
+  *len = ptr - path;
+  return hash;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the result of an earlier search for the path of 'desc'.  On a
+ *   hit the search descriptor is filled in as the search would have done.
+ *
+ * Input Parameters:
+ *   desc   - The search descriptor with the absolute path to look up
+ *   result - The location to return the result of the search in
+ *
+ * Returned Value:
+ *   True if the path was cached.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock, for reading at least.
+ *
+ ****************************************************************************/
+
+bool inode_cache_lookup(FAR struct inode_search_s *desc, FAR int *result)
+{
+  FAR struct inode_cache_s *entry;
+  FAR const char *path = desc->path;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+  bool hit = false;
+
+  hash = inode_cache_hash(path, &len);
+  if (len >= CONFIG_PSEUDOFS_LOOKUP_CACHE_PATHLEN)
+    {
+      return false;
+    }
+
+  entry = &g_inode_cache[hash % CONFIG_PSEUDOFS_LOOKUP_CACHE_SIZE];
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+  if (entry->gen == g_inode_cache_gen && entry->hash == hash &&
+      memcmp(entry->path, path, len + 1) == 0)
+    {
+      desc->path    = path + entry->pathoff;
+      desc->node    = entry->node;
+      desc->peer    = entry->peer;
+      desc->parent  = entry->parent;
+      desc->relpath = entry->reloff == INODE_CACHE_NOREL ?
+                      NULL : path + entry->reloff;
+      *result       = entry->node != NULL ? OK : -ENOENT;
+      hit           = true;
+    }
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+  return hit;
+}
+
+/****************************************************************************
+ * Name: inode_cache_add
+ *
+ * Description:
+ *   Remember the result of the search of 'path'.  Only results that depend
+ *   on nothing but the path and the inode tree are cached: an inode or a
+ *   mountpoint that was found, with the relative path still in 'path', or
+ *   a path that does not exist.
+ *
+ * Input Parameters:
+ *   path   - The absolute path that was searched
+ *   desc   - The search descriptor after the search
+ *   result - The result of the search
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock, for reading at least.
+ *
+ ****************************************************************************/
+
+void inode_cache_add(FAR const char *path,
+                     FAR const struct inode_search_s *desc, int result)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+
+  if (result != OK && result != -ENOENT)
+    {
+      return;
+    }
+
+  hash = inode_cache_hash(path, &len);
+  if (len >= CONFIG_PSEUDOFS_LOOKUP_CACHE_PATHLEN ||
+      desc->path < path || desc->path > path + len ||
+      (desc->relpath != NULL &&
+       (desc->relpath < path || desc->relpath > path + len)) ||
+      (result == OK) != (desc->node != NULL))
+    {
+      return;
+    }
+
+  entry = &g_inode_cache[hash % CONFIG_PSEUDOFS_LOOKUP_CACHE_SIZE];
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+  entry->gen     = g_inode_cache_gen;
+  entry->hash    = hash;
+  entry->node    = desc->node;
+  entry->peer    = desc->peer;
+  entry->parent  = desc->parent;
+  entry->pathoff = desc->path - path;
+  entry->reloff  = desc->relpath == NULL ?
+                   INODE_CACHE_NOREL : desc->relpath - path;
+  memcpy(entry->path, path, len + 1);
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+}
+
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Drop all cached lookups because the inode tree changed.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock for writing.
+ *
+ ****************************************************************************/
+
+void inode_cache_invalidate(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+
+  /* Zero marks the unused entries */
+
+  if (++g_inode_cache_gen == 0)
+    {
+      memset(g_inode_cache, 0, sizeof(g_inode_cache));
+      g_inode_cache_gen = 1;
+    }
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+}
+
+#endif /* CONFIG_PSEUDOFS_LOOKUP_CACHE */
@@ -97,6 +97,7 @@ static FAR struct inode *inode_unlink(FAR const char *path)
       inode->i_peer   = NULL;
       inode->i_parent = NULL;
       atomic_fetch_sub(&inode->i_crefs, 1);
+      inode_cache_invalidate();
     }
 
   RELEASE_SEARCH(&desc);
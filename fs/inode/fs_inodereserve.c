@@ -127,6 +127,8 @@ static void inode_insert(FAR struct inode *inode,
       inode->i_parent = parent;
       parent->i_child = inode;
     }
+
+  inode_cache_invalidate();
 }
 
 /****************************************************************************
@@ -466,6 +466,10 @@ static FAR const char *_inode_getcwd(void)
 
 int inode_search(FAR struct inode_search_s *desc)
 {
+#ifdef CONFIG_PSEUDOFS_LOOKUP_CACHE
+  FAR const char *path;
+  FAR char *buffer;
+#endif
   int ret;
 
   /* Perform the common _inode_search() logic.  This does everything except
@@ -489,7 +493,26 @@ int inode_search(FAR struct inode_search_s *desc)
       desc->path = desc->buffer;
     }
 
+#ifdef CONFIG_PSEUDOFS_LOOKUP_CACHE
+  /* Try the results of the earlier searches first.  A soft link followed
+   * on the way may release the path buffer, so the result is only cached
+   * if the buffer is still the same.
+   */
+
+  path   = desc->path;
+  buffer = desc->buffer;
+
+  if (!inode_cache_lookup(desc, &ret))
+    {
+      ret = _inode_search(desc);
+      if (desc->buffer == buffer)
+        {
+          inode_cache_add(path, desc, ret);
+        }
+    }
+#else
   ret = _inode_search(desc);
+#endif
 
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
   if (ret >= 0)
@@ -235,6 +235,55 @@ void inode_runlock(void);
 
 int inode_search(FAR struct inode_search_s *desc);
 
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the result of an earlier search for the path of 'desc'.  On a
+ *   hit the search descriptor is filled in as the search would have done.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock, for reading at least.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PSEUDOFS_LOOKUP_CACHE
+bool inode_cache_lookup(FAR struct inode_search_s *desc, FAR int *result);
+#endif
+
+/****************************************************************************
+ * Name: inode_cache_add
+ *
+ * Description:
+ *   Remember the result of the search of 'path'.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock, for reading at least.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PSEUDOFS_LOOKUP_CACHE
+void inode_cache_add(FAR const char *path,
+                     FAR const struct inode_search_s *desc, int result);
+#endif
+
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Drop all cached lookups because the inode tree changed.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock for writing.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PSEUDOFS_LOOKUP_CACHE
+void inode_cache_invalidate(void);
+#else
+#  define inode_cache_invalidate()
+#endif
+
 /****************************************************************************
  * Name: inode_find
  *
@@ -28,11 +28,14 @@
 #include <fcntl.h>
 #include <string.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/pagecache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 
 #include <sys/stat.h>
 #include <sys/statfs.h>
@@ -50,6 +53,14 @@
 #  error littlefs requires CONFIG_C99_BOOL to be selected
 #endif
 
+#if defined(CONFIG_FS_LITTLEFS_GC) && LFS_VERSION < 0x00020008
+#  error CONFIG_FS_LITTLEFS_HAVE_GC is set, but littlefs is older than v2.8
+#endif
+
+#ifndef CONFIG_FS_LITTLEFS_GC
+#  define littlefs_gc_schedule(fs)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -78,6 +89,12 @@ struct littlefs_mountpt_s
   struct mtd_geometry_s geo;
   struct lfs_config     cfg;
   struct lfs            lfs;
+#ifdef CONFIG_FS_PAGECACHE
+  struct pagecache_s    pagecache;
+#endif
+#ifdef CONFIG_FS_LITTLEFS_GC
+  struct work_s         gc_work;
+#endif
 };
 
 struct littlefs_attr_s
@@ -127,6 +144,8 @@ static int     littlefs_readdir(FAR struct inode *mountpt,
                                 FAR struct dirent *entry);
 static int     littlefs_rewinddir(FAR struct inode *mountpt,
                                   FAR struct fs_dirent_s *dir);
+static int     littlefs_seekdir(FAR struct inode *mountpt,
+                                FAR struct fs_dirent_s *dir, off_t offset);
 
 static int     littlefs_bind(FAR struct inode *driver,
                              FAR const void *data, FAR void **handle);
@@ -150,6 +169,23 @@ static int     littlefs_chstat(FAR struct inode *mountpt,
                                FAR const char *relpath,
                                FAR const struct stat *buf, int flags);
 
+static int     littlefs_readpages(FAR void *priv, off_t page,
+                                  size_t npages, FAR uint8_t *buffer);
+static int     littlefs_writepages(FAR void *priv, off_t page,
+                                   size_t npages, FAR const uint8_t *buffer);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PAGECACHE
+static const struct pagecache_ops_s g_littlefs_pagecache_ops =
+{
+  littlefs_readpages,     /* read_pages */
+  littlefs_writepages     /* write_pages */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -190,7 +226,10 @@ const struct mountpt_operations g_littlefs_operations =
   littlefs_rmdir,         /* rmdir */
   littlefs_rename,        /* rename */
   littlefs_stat,          /* stat */
-  littlefs_chstat         /* chstat */
+  littlefs_chstat,        /* chstat */
+  NULL,                   /* syncfs */
+  NULL,                   /* telldir */
+  littlefs_seekdir        /* seekdir */
 };
 
 /****************************************************************************
@@ -253,6 +292,51 @@ static int littlefs_convert_result(int ret)
     }
 }
 
+#ifdef CONFIG_FS_LITTLEFS_GC
+/****************************************************************************
+ * Name: littlefs_gc_worker
+ *
+ * Description:
+ *   Run the garbage collection of littlefs once the file system has been
+ *   idle for CONFIG_FS_LITTLEFS_GC_DELAY milliseconds.  This fills the
+ *   lookahead buffer of free blocks and compacts the metadata pairs above
+ *   the compaction threshold, so that the foreground writes do not have to.
+ *
+ ****************************************************************************/
+
+static void littlefs_gc_worker(FAR void *arg)
+{
+  FAR struct littlefs_mountpt_s *fs = arg;
+
+  /* Never wait for a busy file system, that is not idle anyway */
+
+  if (nxmutex_trylock(&fs->lock) < 0)
+    {
+      work_queue(LPWORK, &fs->gc_work, littlefs_gc_worker, fs,
+                 MSEC2TICK(CONFIG_FS_LITTLEFS_GC_DELAY));
+      return;
+    }
+
+  lfs_fs_gc(&fs->lfs);
+  nxmutex_unlock(&fs->lock);
+}
+
+/****************************************************************************
+ * Name: littlefs_gc_schedule
+ *
+ * Description:
+ *   Called after each modification, (re)starting the idle period after
+ *   which the garbage collection runs.
+ *
+ ****************************************************************************/
+
+static void littlefs_gc_schedule(FAR struct littlefs_mountpt_s *fs)
+{
+  work_queue(LPWORK, &fs->gc_work, littlefs_gc_worker, fs,
+             MSEC2TICK(CONFIG_FS_LITTLEFS_GC_DELAY));
+}
+#endif
+
 /****************************************************************************
  * Name: littlefs_convert_oflags
  ****************************************************************************/
@@ -432,6 +516,7 @@ static int littlefs_close(FAR struct file *filep)
       ret = littlefs_convert_result(lfs_file_close(&fs->lfs, &priv->file));
     }
 
+  littlefs_gc_schedule(fs);
   nxmutex_unlock(&fs->lock);
   if (priv->refs <= 0)
     {
@@ -535,6 +620,7 @@ static ssize_t littlefs_write(FAR struct file *filep, const char *buffer,
     }
 
 out:
+  littlefs_gc_schedule(fs);
   nxmutex_unlock(&fs->lock);
   return ret;
 }
@@ -622,6 +708,12 @@ static int littlefs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#if LFS_VERSION >= 0x00020008
+      case FIOC_GC:
+        ret = littlefs_convert_result(lfs_fs_gc(&fs->lfs));
+        break;
+
+#endif
       default:
         {
           if (INODE_IS_MTD(drv))
@@ -674,6 +766,7 @@ static int littlefs_sync(FAR struct file *filep)
     }
 
   ret = littlefs_convert_result(lfs_file_sync(&fs->lfs, &priv->file));
+  littlefs_gc_schedule(fs);
   nxmutex_unlock(&fs->lock);
 
   return ret;
@@ -858,6 +951,7 @@ static int littlefs_fchstat(FAR const struct file *filep,
     }
 
 errout:
+  littlefs_gc_schedule(fs);
   nxmutex_unlock(&fs->lock);
   return ret;
 }
@@ -894,6 +988,7 @@ static int littlefs_truncate(FAR struct file *filep, off_t length)
 
   ret = littlefs_convert_result(lfs_file_truncate(&fs->lfs, &priv->file,
                                                   length));
+  littlefs_gc_schedule(fs);
   nxmutex_unlock(&fs->lock);
 
   return ret;
@@ -1072,6 +1167,97 @@ static int littlefs_rewinddir(FAR struct inode *mountpt,
   return ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_seekdir
+ *
+ * Description:
+ *   Move to the entry 'offset' of the directory.  The positions of
+ *   littlefs count the entries from the beginning, like the ones of the
+ *   VFS, and whole metadata blocks are skipped without reading them.
+ *
+ ****************************************************************************/
+
+static int littlefs_seekdir(FAR struct inode *mountpt,
+                            FAR struct fs_dirent_s *dir, off_t offset)
+{
+  FAR struct littlefs_mountpt_s *fs;
+  FAR struct littlefs_dir_s *ldir;
+  int ret;
+
+  /* Recover our private data from the inode instance */
+
+  ldir = (FAR struct littlefs_dir_s *)dir;
+  fs   = mountpt->i_private;
+
+  /* Call the LFS's seekdir function */
+
+  ret = nxmutex_lock(&fs->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = littlefs_convert_result(lfs_dir_seek(&fs->lfs, &ldir->dir,
+                                             offset));
+
+  nxmutex_unlock(&fs->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: littlefs_readpages
+ *
+ * Description:
+ *   Read 'npages' blocks of the driver, for the page cache as well.
+ *
+ ****************************************************************************/
+
+static int littlefs_readpages(FAR void *priv, off_t page, size_t npages,
+                              FAR uint8_t *buffer)
+{
+  FAR struct littlefs_mountpt_s *fs = priv;
+  FAR struct inode *drv = fs->drv;
+  int ret;
+
+  if (INODE_IS_MTD(drv))
+    {
+      ret = MTD_BREAD(drv->u.i_mtd, page, npages, buffer);
+    }
+  else
+    {
+      ret = drv->u.i_bops->read(drv, buffer, page, npages);
+    }
+
+  return ret >= 0 ? OK : ret;
+}
+
+/****************************************************************************
+ * Name: littlefs_writepages
+ *
+ * Description:
+ *   Write 'npages' blocks of the driver, for the page cache as well.
+ *
+ ****************************************************************************/
+
+static int littlefs_writepages(FAR void *priv, off_t page, size_t npages,
+                               FAR const uint8_t *buffer)
+{
+  FAR struct littlefs_mountpt_s *fs = priv;
+  FAR struct inode *drv = fs->drv;
+  int ret;
+
+  if (INODE_IS_MTD(drv))
+    {
+      ret = MTD_BWRITE(drv->u.i_mtd, page, npages, buffer);
+    }
+  else
+    {
+      ret = drv->u.i_bops->write(drv, buffer, page, npages);
+    }
+
+  return ret >= 0 ? OK : ret;
+}
+
 /****************************************************************************
  * Name: littlefs_bind
  *
@@ -1089,22 +1275,15 @@ static int littlefs_read_block(FAR const struct lfs_config *c,
 {
   FAR struct littlefs_mountpt_s *fs = c->context;
   FAR struct mtd_geometry_s *geo = &fs->geo;
-  FAR struct inode *drv = fs->drv;
-  int ret;
 
   block = (block * c->block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
-  if (INODE_IS_MTD(drv))
-    {
-      ret = MTD_BREAD(drv->u.i_mtd, block, size, buffer);
-    }
-  else
-    {
-      ret = drv->u.i_bops->read(drv, buffer, block, size);
-    }
-
-  return ret >= 0 ? OK : ret;
+#ifdef CONFIG_FS_PAGECACHE
+  return pagecache_read(&fs->pagecache, block, size, buffer);
+#else
+  return littlefs_readpages(fs, block, size, buffer);
+#endif
 }
 
 /****************************************************************************
@@ -1117,22 +1296,15 @@ static int littlefs_write_block(FAR const struct lfs_config *c,
 {
   FAR struct littlefs_mountpt_s *fs = c->context;
   FAR struct mtd_geometry_s *geo = &fs->geo;
-  FAR struct inode *drv = fs->drv;
-  int ret;
 
   block = (block * c->block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
-  if (INODE_IS_MTD(drv))
-    {
-      ret = MTD_BWRITE(drv->u.i_mtd, block, size, buffer);
-    }
-  else
-    {
-      ret = drv->u.i_bops->write(drv, buffer, block, size);
-    }
-
-  return ret >= 0 ? OK : ret;
+#ifdef CONFIG_FS_PAGECACHE
+  return pagecache_write(&fs->pagecache, block, size, buffer);
+#else
+  return littlefs_writepages(fs, block, size, buffer);
+#endif
 }
 
 /****************************************************************************
@@ -1153,6 +1325,14 @@ static int littlefs_erase_block(FAR const struct lfs_config *c,
 
       block = block * c->block_size / geo->erasesize;
       ret = MTD_ERASE(drv->u.i_mtd, block, size);
+
+#ifdef CONFIG_FS_PAGECACHE
+      /* The erased blocks read differently now */
+
+      pagecache_invalidate(&fs->pagecache,
+                           block * geo->erasesize / geo->blocksize,
+                           size * geo->erasesize / geo->blocksize);
+#endif
     }
 
   return ret >= 0 ? OK : ret;
@@ -1269,6 +1449,11 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
       goto errout_with_fs;
     }
 
+#ifdef CONFIG_FS_PAGECACHE
+  pagecache_init(&fs->pagecache, &g_littlefs_pagecache_ops, fs,
+                 fs->geo.blocksize);
+#endif
+
   /* Initialize lfs_config structure */
 
   fs->cfg.context        = fs;
@@ -1295,6 +1480,10 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   fs->cfg.lookahead_size = CONFIG_FS_LITTLEFS_LOOKAHEAD_SIZE;
 #endif
 
+#if LFS_VERSION >= 0x00020009
+  fs->cfg.compact_thresh = CONFIG_FS_LITTLEFS_COMPACT_THRESH;
+#endif
+
   /* Then get information about the littlefs filesystem on the devices
    * managed by this driver.
    */
@@ -1339,6 +1528,9 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   return OK;
 
 errout_with_fs:
+#ifdef CONFIG_FS_PAGECACHE
+  pagecache_release(&fs->pagecache);
+#endif
   nxmutex_destroy(&fs->lock);
   fs_heap_free(fs);
 errout_with_block:
@@ -1373,6 +1565,14 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
       return ret;
     }
 
+#ifdef CONFIG_FS_LITTLEFS_GC
+  /* The worker does not wait for the lock, it queues itself again */
+
+  while (work_cancel_sync(LPWORK, &fs->gc_work) >= 0)
+    {
+    }
+#endif
+
   ret = littlefs_convert_result(lfs_unmount(&fs->lfs));
   nxmutex_unlock(&fs->lock);
 
@@ -1398,6 +1598,9 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
 
       /* Release the mountpoint private data */
 
+#ifdef CONFIG_FS_PAGECACHE
+      pagecache_release(&fs->pagecache);
+#endif
       nxmutex_destroy(&fs->lock);
       fs_heap_free(fs);
     }
@@ -1475,6 +1678,7 @@ static int littlefs_unlink(FAR struct inode *mountpt,
     }
 
   ret = littlefs_convert_result(lfs_remove(&fs->lfs, relpath));
+  littlefs_gc_schedule(fs);
   nxmutex_unlock(&fs->lock);
 
   return ret;
@@ -1546,6 +1750,7 @@ static int littlefs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
         }
     }
 
+  littlefs_gc_schedule(fs);
   nxmutex_unlock(&fs->lock);
 
 errout:
@@ -1613,6 +1818,7 @@ static int littlefs_rename(FAR struct inode *mountpt,
 
   ret = littlefs_convert_result(lfs_rename(&fs->lfs, oldrelpath,
                                            newrelpath));
+  littlefs_gc_schedule(fs);
   nxmutex_unlock(&fs->lock);
 
   return ret;
@@ -1766,6 +1972,7 @@ static int littlefs_chstat(FAR struct inode *mountpt,
     }
 
 errout:
+  littlefs_gc_schedule(fs);
   nxmutex_unlock(&fs->lock);
   return ret;
 }
@@ -25,14 +25,17 @@
 #include <nuttx/config.h>
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/param.h>
 
 #include <assert.h>
 #include <debug.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <stdint.h>
 #include <string.h>
 #include <unistd.h>
 
+#include <nuttx/crc64.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/sched.h>
@@ -42,39 +45,74 @@
 #include "fs_heap.h"
 
 /****************************************************************************
- * Public Data
+ * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_FS_RAMMAP_DIRTY
+#  define RAMMAP_PAGESIZE  CONFIG_FS_RAMMAP_PAGESIZE
+#  define RAMMAP_NPAGES(l) (((l) + RAMMAP_PAGESIZE - 1) / RAMMAP_PAGESIZE)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_RAMMAP_DIRTY
+/* With dirty tracking, priv.p of the mapping points to this structure
+ * instead of holding the file and the mapping type.  There is no MMU to
+ * report the pages written, so msync() compares the checksum of each page
+ * with the one taken when the page was last read or written back.
+ */
+
+struct rammap_s
+{
+  FAR struct file *filep;
+  enum mm_map_type_e type;
+  uint64_t sums[1];             /* CRC64 of each page of the file data */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: msync_rammap
+ * Name: rammap_filep and rammap_type
  ****************************************************************************/
 
-static int msync_rammap(FAR struct mm_map_entry_s *entry, FAR void *start,
-                        size_t length, int flags)
+static FAR struct file *rammap_filep(FAR struct mm_map_entry_s *entry)
 {
-  FAR struct file *filep = (FAR void *)((uintptr_t)entry->priv.p & ~3);
-  FAR uint8_t *wrbuffer = start;
-  ssize_t nwrite = 0;
-  off_t offset;
-  off_t fpos;
-  off_t opos;
+#ifdef CONFIG_FS_RAMMAP_DIRTY
+  return ((FAR struct rammap_s *)entry->priv.p)->filep;
+#else
+  return (FAR void *)((uintptr_t)entry->priv.p & ~3);
+#endif
+}
 
-  offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
-  if (length > entry->length - offset)
-    {
-      length = entry->length - offset;
-    }
+static enum mm_map_type_e rammap_type(FAR struct mm_map_entry_s *entry)
+{
+#ifdef CONFIG_FS_RAMMAP_DIRTY
+  return ((FAR struct rammap_s *)entry->priv.p)->type;
+#else
+  return (enum mm_map_type_e)((uintptr_t)entry->priv.p & 3);
+#endif
+}
 
-  opos = file_seek(filep, 0, SEEK_CUR);
-  if (opos < 0)
-    {
-      ferr("ERROR: Get current position failed\n");
-      return opos;
-    }
+/****************************************************************************
+ * Name: rammap_write
+ *
+ * Description:
+ *   Write a part of the mapping back to the file.
+ *
+ ****************************************************************************/
+
+static int rammap_write(FAR struct mm_map_entry_s *entry,
+                        FAR struct file *filep, off_t offset,
+                        size_t length)
+{
+  FAR uint8_t *wrbuffer = (FAR uint8_t *)entry->vaddr + offset;
+  ssize_t nwrite;
+  off_t fpos;
 
   fpos = file_seek(filep, entry->offset + offset, SEEK_SET);
   if (fpos < 0)
@@ -92,14 +130,16 @@ static int msync_rammap(FAR struct mm_map_entry_s *entry, FAR void *start,
            * signal.
            */
 
-          if (nwrite != -EINTR)
+          if (nwrite == -EINTR)
             {
-              /* All other write errors are bad. */
-
-              ferr("ERROR: Write failed: offset=%"PRIdOFF" nwrite=%zd\n",
-                   entry->offset, nwrite);
-              break;
+              continue;
             }
+
+          /* All other write errors are bad. */
+
+          ferr("ERROR: Write failed: offset=%"PRIdOFF" nwrite=%zd\n",
+               entry->offset, nwrite);
+          return nwrite;
         }
 
       /* Increment number of bytes written */
@@ -108,6 +148,112 @@ static int msync_rammap(FAR struct mm_map_entry_s *entry, FAR void *start,
       length   -= nwrite;
     }
 
+  return OK;
+}
+
+/****************************************************************************
+ * Name: rammap_writedirty
+ *
+ * Description:
+ *   Write the pages of a part of the mapping that changed since they were
+ *   last read or written back.  Runs of adjacent dirty pages are written
+ *   at once.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_RAMMAP_DIRTY
+static int rammap_writedirty(FAR struct mm_map_entry_s *entry,
+                             FAR struct file *filep, off_t offset,
+                             size_t length)
+{
+  FAR struct rammap_s *map = entry->priv.p;
+  FAR const uint8_t *vaddr = entry->vaddr;
+  size_t first = offset / RAMMAP_PAGESIZE;
+  size_t last = RAMMAP_NPAGES(offset + length);
+  size_t run = SIZE_MAX;
+  size_t page;
+  size_t len;
+  uint64_t sum;
+  int ret = OK;
+
+  for (page = first; page <= last && ret >= 0; page++)
+    {
+      if (page < last)
+        {
+          len = MIN(RAMMAP_PAGESIZE,
+                    entry->length - page * RAMMAP_PAGESIZE);
+          sum = crc64(vaddr + page * RAMMAP_PAGESIZE, len);
+          if (sum != map->sums[page])
+            {
+              /* Dirty, extend the run */
+
+              map->sums[page] = sum;
+              if (run == SIZE_MAX)
+                {
+                  run = page;
+                }
+
+              continue;
+            }
+        }
+
+      /* A clean page or the end, write the run before */
+
+      if (run != SIZE_MAX)
+        {
+          len = MIN(page * RAMMAP_PAGESIZE, entry->length) -
+                run * RAMMAP_PAGESIZE;
+          ret = rammap_write(entry, filep, run * RAMMAP_PAGESIZE, len);
+          if (ret < 0)
+            {
+              /* Keep the pages dirty */
+
+              for (; run < page; run++)
+                {
+                  map->sums[run] ^= 1;
+                }
+            }
+
+          run = SIZE_MAX;
+        }
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: msync_rammap
+ ****************************************************************************/
+
+static int msync_rammap(FAR struct mm_map_entry_s *entry, FAR void *start,
+                        size_t length, int flags)
+{
+  FAR struct file *filep = rammap_filep(entry);
+  off_t offset;
+  off_t fpos;
+  off_t opos;
+  int ret;
+
+  offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
+  if (length > entry->length - offset)
+    {
+      length = entry->length - offset;
+    }
+
+  opos = file_seek(filep, 0, SEEK_CUR);
+  if (opos < 0)
+    {
+      ferr("ERROR: Get current position failed\n");
+      return opos;
+    }
+
+#ifdef CONFIG_FS_RAMMAP_DIRTY
+  ret = rammap_writedirty(entry, filep, offset, length);
+#else
+  ret = rammap_write(entry, filep, offset, length);
+#endif
+
   /* Restore file pos */
 
   fpos = file_seek(filep, opos, SEEK_SET);
@@ -119,7 +265,7 @@ static int msync_rammap(FAR struct mm_map_entry_s *entry, FAR void *start,
       return fpos;
     }
 
-  return nwrite >= 0 ? 0 : nwrite;
+  return ret;
 }
 
 /****************************************************************************
@@ -131,9 +277,8 @@ static int unmap_rammap(FAR struct task_group_s *group,
                         FAR void *start,
                         size_t length)
 {
-  FAR struct file *filep = (FAR void *)((uintptr_t)entry->priv.p & ~3);
-  enum mm_map_type_e type =
-                    (enum mm_map_type_e)((uintptr_t)entry->priv.p & 3);
+  FAR struct file *filep = rammap_filep(entry);
+  enum mm_map_type_e type = rammap_type(entry);
   FAR void *newaddr = NULL;
   off_t offset;
   int ret = OK;
@@ -174,6 +319,9 @@ static int unmap_rammap(FAR struct task_group_s *group,
         }
 
       fs_putfilep(filep);
+#ifdef CONFIG_FS_RAMMAP_DIRTY
+      fs_heap_free(entry->priv.p);
+#endif
 
       /* Then remove the mapping from the list */
 
@@ -235,6 +383,10 @@ static int unmap_rammap(FAR struct task_group_s *group,
 int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
            enum mm_map_type_e type)
 {
+#ifdef CONFIG_FS_RAMMAP_DIRTY
+  FAR struct rammap_s *map;
+  size_t page;
+#endif
   FAR uint8_t *rdbuffer;
   ssize_t nread;
   off_t fpos;
@@ -330,14 +482,43 @@ int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
   /* Add the buffer to the list of regions */
 
 out:
-  fs_reffilep(filep);
+#ifdef CONFIG_FS_RAMMAP_DIRTY
+  /* Take the checksums of the clean pages */
+
+  map = fs_heap_malloc(sizeof(struct rammap_s) + sizeof(uint64_t) *
+                       (RAMMAP_NPAGES(entry->length) - 1));
+  if (map == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_region;
+    }
+
+  map->filep = filep;
+  map->type  = type;
+  for (page = 0; page < RAMMAP_NPAGES(entry->length); page++)
+    {
+      map->sums[page] =
+        crc64((FAR uint8_t *)entry->vaddr + page * RAMMAP_PAGESIZE,
+              MIN(RAMMAP_PAGESIZE,
+                  entry->length - page * RAMMAP_PAGESIZE));
+    }
+
+  entry->priv.p = map;
+#else
   entry->priv.p = (FAR void *)((uintptr_t)filep | type);
+#endif
+
+  fs_reffilep(filep);
   entry->munmap = unmap_rammap;
   entry->msync = msync_rammap;
 
   ret = mm_map_add(get_current_mm(), entry);
   if (ret < 0)
     {
+      fs_putfilep(filep);
+#ifdef CONFIG_FS_RAMMAP_DIRTY
+      fs_heap_free(map);
+#endif
       goto errout_with_region;
     }
 
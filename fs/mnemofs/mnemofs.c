@@ -1607,6 +1607,20 @@ static int mnemofs_bind(FAR struct inode *driver, FAR const void *data,
       MFS_EXTRA_LOG("BIND", "RW Buffer allocated.");
     }
 
+#if CONFIG_MNEMOFS_WRBATCH > 1
+  sb->wb_buf        = fs_heap_zalloc(MFS_PGSZ(sb) * CONFIG_MNEMOFS_WRBATCH);
+  if (predict_false(sb->wb_buf == NULL))
+    {
+      MFS_LOG("BIND", "Write-back Buffer in-memory allocation error.");
+      ret = -ENOMEM;
+      goto errout_with_rwbuf;
+    }
+  else
+    {
+      MFS_EXTRA_LOG("BIND", "Write-back Buffer allocated.");
+    }
+#endif
+
   /* TODO: Format the superblock in Block 0. */
 
   srand(time(NULL));
@@ -1739,6 +1753,9 @@ static int mnemofs_bind(FAR struct inode *driver, FAR const void *data,
   return ret;
 
 errout_with_rwbuf:
+#if CONFIG_MNEMOFS_WRBATCH > 1
+  fs_heap_free(sb->wb_buf);
+#endif
   fs_heap_free(sb->rw_buf);
   MFS_LOG("BIND", "RW Buffer freed.");
 
@@ -1797,6 +1814,11 @@ static int mnemofs_unbind(FAR void *handle, FAR struct inode **driver,
   nxmutex_destroy(&MFS_LOCK(sb));
   MFS_EXTRA_LOG("UNBIND", "Mutex destroyed.");
 
+#if CONFIG_MNEMOFS_WRBATCH > 1
+  fs_heap_free(sb->wb_buf);
+  MFS_EXTRA_LOG("UNBIND", "Write-back Buffer freed.");
+#endif
+
   fs_heap_free(sb->rw_buf);
   MFS_LOG("UNBIND", "RW Buffer freed.");
 
@@ -205,6 +205,11 @@ struct mfs_sb_s
   struct list_node        lru;
   struct list_node        of;            /* open files. */
   bool                    flush;
+#if CONFIG_MNEMOFS_WRBATCH > 1
+  FAR uint8_t             *wb_buf;       /* Pages waiting to be written */
+  mfs_t                   wb_pg;         /* Page number of first in wb_buf */
+  mfs_t                   wb_n;          /* Number of pages in wb_buf */
+#endif
 };
 
 /* This is for *dir VFS methods. */
@@ -924,6 +929,76 @@ ssize_t mfs_read_page(FAR const struct mfs_sb_s * const sb,
                       FAR char *data, const mfs_t datalen, const off_t page,
                       const mfs_t pgoff);
 
+#if CONFIG_MNEMOFS_WRBATCH > 1
+
+/****************************************************************************
+ * Name: mfs_wb_write
+ *
+ * Description:
+ *   Queue a full page for writing.  The pages queued are written with one
+ *   MTD bwrite when the queue is full, when a page is queued that does not
+ *   follow the queued ones, or on mfs_wb_flush().  Until then, they are
+ *   read from the queue by mfs_read_page().
+ *
+ * Input Parameters:
+ *   sb   - Superblock instance of the device.
+ *   data - Buffer of a page size.
+ *   pg   - Page number.
+ *
+ * Returned Value:
+ *   1 when the page was queued, < 0 on an error writing the queue.
+ *
+ * Assumptions/Limitations:
+ *   This assumes a locked environment when called.
+ *
+ ****************************************************************************/
+
+ssize_t mfs_wb_write(FAR struct mfs_sb_s * const sb, FAR const char *data,
+                     const off_t page);
+
+/****************************************************************************
+ * Name: mfs_wb_flush
+ *
+ * Description:
+ *   Write the pages queued by mfs_wb_write().
+ *
+ * Input Parameters:
+ *   sb - Superblock instance of the device.
+ *
+ * Returned Value:
+ *   0   - OK
+ *   < 0 - Error
+ *
+ * Assumptions/Limitations:
+ *   This assumes a locked environment when called.
+ *
+ ****************************************************************************/
+
+int mfs_wb_flush(FAR struct mfs_sb_s * const sb);
+
+/****************************************************************************
+ * Name: mfs_wb_discard
+ *
+ * Description:
+ *   Drop the pages queued by mfs_wb_write() without writing them.
+ *
+ * Input Parameters:
+ *   sb - Superblock instance of the device.
+ *
+ * Assumptions/Limitations:
+ *   This assumes a locked environment when called.
+ *
+ ****************************************************************************/
+
+void mfs_wb_discard(FAR struct mfs_sb_s * const sb);
+
+#else
+#  define mfs_wb_write(sb, data, pg) \
+     mfs_write_page(sb, data, MFS_PGSZ(sb), pg, 0)
+#  define mfs_wb_flush(sb)   (OK)
+#  define mfs_wb_discard(sb)
+#endif
+
 /****************************************************************************
  * Name: mfs_erase_blk
  *
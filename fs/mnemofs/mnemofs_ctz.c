@@ -552,10 +552,14 @@ int mfs_ctz_wrtnode(FAR struct mfs_sb_s * const sb,
 
           ctz_copyidxptrs(sb, ctz, cur_idx, buf);
 
-          ret = mfs_write_page(sb, buf, MFS_PGSZ(sb), new_pg, 0);
-          if (predict_false(ret == 0))
+          /* The pages of the new CTZ list are consecutive most of the
+           * time, so they are queued to go to the flash together.
+           */
+
+          ret = mfs_wb_write(sb, buf, new_pg);
+          if (predict_false(ret <= 0))
             {
-              ret = -EINVAL;
+              ret = (ret < 0) ? ret : -EINVAL;
               goto errout_with_buf;
             }
 
@@ -587,6 +591,14 @@ int mfs_ctz_wrtnode(FAR struct mfs_sb_s * const sb,
 
   /* Write log. Assumes journal has enough space due to the limit. */
 
+  /* The journal must not refer to pages that are not on the flash yet. */
+
+  ret = mfs_wb_flush(sb);
+  if (predict_false(ret < 0))
+    {
+      goto errout_with_buf;
+    }
+
   finfo("Writing log.");
   *new_loc = ctz;
   ret = mfs_jrnl_wrlog(sb, node, ctz, node->sz);
@@ -596,6 +608,7 @@ int mfs_ctz_wrtnode(FAR struct mfs_sb_s * const sb,
     }
 
 errout_with_buf:
+  mfs_wb_discard(sb);
   fs_heap_free(buf);
 
 errout:
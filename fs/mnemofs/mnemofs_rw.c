@@ -145,6 +145,17 @@ ssize_t mfs_read_page(FAR const struct mfs_sb_s * const sb,
       return -EINVAL;
     }
 
+#if CONFIG_MNEMOFS_WRBATCH > 1
+  if (page >= sb->wb_pg && page < sb->wb_pg + sb->wb_n)
+    {
+      /* The page is still waiting to be written. */
+
+      memcpy(data, sb->wb_buf + (page - sb->wb_pg) * MFS_PGSZ(sb) + pgoff,
+             MIN(datalen, MFS_PGSZ(sb) - pgoff));
+      return 1;
+    }
+#endif
+
   ret = MTD_BREAD(MFS_MTD(sb), page, 1, MFS_RWBUF(sb));
   if (predict_false(ret < 0))
     {
@@ -159,6 +170,69 @@ errout_with_reset:
   return ret;
 }
 
+#if CONFIG_MNEMOFS_WRBATCH > 1
+ssize_t mfs_wb_write(FAR struct mfs_sb_s * const sb, FAR const char *data,
+                     const off_t page)
+{
+  int ret;
+
+  if (predict_false(page > MFS_NPGS(sb)))
+    {
+      return -EINVAL;
+    }
+
+  if (sb->wb_n == CONFIG_MNEMOFS_WRBATCH || (sb->wb_n > 0 &&
+      page != sb->wb_pg + sb->wb_n))
+    {
+      ret = mfs_wb_flush(sb);
+      if (predict_false(ret < 0))
+        {
+          return ret;
+        }
+    }
+
+  if (sb->wb_n == 0)
+    {
+      sb->wb_pg = page;
+    }
+
+  memcpy(sb->wb_buf + sb->wb_n * MFS_PGSZ(sb), data, MFS_PGSZ(sb));
+  sb->wb_n++;
+
+  return 1;
+}
+
+int mfs_wb_flush(FAR struct mfs_sb_s * const sb)
+{
+  ssize_t ret;
+  mfs_t   n = sb->wb_n;
+
+  if (n == 0)
+    {
+      return OK;
+    }
+
+  /* The queue is emptied even on an error, like a failed page write does
+   * not keep the page around either.
+   */
+
+  sb->wb_n = 0;
+
+  ret = MTD_BWRITE(MFS_MTD(sb), sb->wb_pg, n, sb->wb_buf);
+  if (predict_false(ret < 0))
+    {
+      return ret;
+    }
+
+  return ret == n ? OK : -EIO;
+}
+
+void mfs_wb_discard(FAR struct mfs_sb_s * const sb)
+{
+  sb->wb_n = 0;
+}
+#endif
+
 int mfs_erase_blk(FAR const struct mfs_sb_s * const sb, const off_t blk)
 {
   if (predict_false(blk > MFS_NBLKS(sb)))
@@ -59,10 +59,13 @@
 #define NFS_MAXTIMEO       255            /* Max timeout to backoff to */
 #define NFS_MAXREXMIT      100            /* Stop counting after this many */
 #define NFS_RETRANS        10             /* Num of retrans for soft mounts */
-#define NFS_WSIZE          8192           /* Def. write data size <= 8192 */
-#define NFS_RSIZE          8192           /* Def. read data size <= 8192 */
 #define NFS_READDIRSIZE    1024           /* Def. readdir size */
 
+/* Default write and read data sizes */
+
+#define NFS_WSIZE          CONFIG_NFS_WSIZE
+#define NFS_RSIZE          CONFIG_NFS_RSIZE
+
 /* Ideally, NFS_DIRBLKSIZ should be bigger, but I've seen servers with
  * broken NFS/ethernet drivers that won't work with anything bigger (Linux..)
  */
@@ -112,6 +115,7 @@ extern "C"
 EXTERN int nfs_request(FAR struct nfsmount *nmp, int procnum,
                 FAR void *request, size_t reqlen,
                 FAR void *response, size_t resplen);
+EXTERN int nfs_checkreply(FAR void *response);
 EXTERN int  nfs_lookup(FAR struct nfsmount *nmp, FAR const char *filename,
               FAR struct file_handle *fhandle,
               FAR struct nfs_fattr *obj_attributes,
@@ -52,6 +52,7 @@
 #include <nuttx/mutex.h>
 
 #include "rpc.h"
+#include "nfs_node.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -61,6 +62,17 @@
  * Public Types
  ****************************************************************************/
 
+/* The attributes that stat() found for a path */
+
+#ifdef NFS_ATTRCACHE
+struct nfs_attrcache_s
+{
+  FAR char                 *ac_path;          /* Relative path, NULL if unused */
+  clock_t                   ac_expire;        /* When the attributes get stale */
+  struct nfs_fattr          ac_fattr;         /* The attributes */
+};
+#endif
+
 /* Mount structure. One mount structure is allocated for each NFS mount. This
  * structure holds NFS specific information for mount.
  */
@@ -75,10 +87,17 @@ struct nfsmount
   FAR struct rpcclnt       *nm_rpcclnt;       /* RPC state */
   struct sockaddr_storage   nm_nam;           /* Addr of server */
   uint8_t                   nm_fhsize;        /* Size of root file handle (host order) */
-  uint16_t                  nm_rsize;         /* Max size of read RPC */
-  uint16_t                  nm_wsize;         /* Max size of write RPC */
-  uint16_t                  nm_readdirsize;   /* Size of a readdir RPC */
-  uint16_t                  nm_buflen;        /* Size of I/O buffer */
+#ifdef CONFIG_NFS_READDIRPLUS
+  bool                      nm_noplus;        /* Server does not support READDIRPLUS */
+#endif
+  uint32_t                  nm_rsize;         /* Max size of read RPC */
+  uint32_t                  nm_wsize;         /* Max size of write RPC */
+  uint32_t                  nm_readdirsize;   /* Size of a readdir RPC */
+  uint32_t                  nm_buflen;        /* Size of I/O buffer */
+#ifdef NFS_ATTRCACHE
+  struct nfs_attrcache_s    nm_attrcache[CONFIG_NFS_ATTRCACHE_NENTRIES];
+  uint8_t                   nm_attrnext;      /* The entry to replace next */
+#endif
 
   /* Set aside memory on the stack to hold the largest call message.
    * NOTE that for the case of the write call message, it is the reply
@@ -95,6 +114,9 @@ struct nfsmount
     struct rpc_call_mkdir   mkdir;
     struct rpc_call_rmdir   rmdir;
     struct rpc_call_readdir readdir;
+#ifdef CONFIG_NFS_READDIRPLUS
+    struct rpc_call_readdirplus readdirplus;
+#endif
     struct rpc_call_fs      fsstat;
     struct rpc_call_setattr setattr;
     struct rpc_call_fs      fsinfo;
@@ -128,9 +150,9 @@ struct nfs_mount_parameters
 {
   uint8_t          timeo;                  /* Timeout value (in deciseconds) */
   uint8_t          retry;                  /* Max retries */
-  uint16_t         rsize;                  /* Max size of read RPC */
-  uint16_t         wsize;                  /* Max size of write RPC */
-  uint16_t         readdirsize;            /* Size of a readdir RPC */
+  uint32_t         rsize;                  /* Max size of read RPC */
+  uint32_t         wsize;                  /* Max size of write RPC */
+  uint32_t         readdirsize;            /* Size of a readdir RPC */
 };
 
 #endif
@@ -48,8 +48,20 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/types.h>
+
 #include "nfs_proto.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The attributes of files are only trusted for a while */
+
+#if CONFIG_NFS_ATTRCACHE_TIMEOUT > 0
+#  define NFS_ATTRCACHE 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -70,6 +82,9 @@ struct nfsnode
   struct timespec     n_ctime;      /* File creation time */
   nfsfh_t             n_fhandle;    /* NFS File Handle */
   uint64_t            n_size;       /* Current size of file */
+#ifdef NFS_ATTRCACHE
+  clock_t             n_expire;     /* When the attributes get stale */
+#endif
 };
 
 #endif /* __FS_NFS_NFS_NODE_H */
@@ -65,7 +65,7 @@
 #define NFS_VER4                  4
 #define NFS_MAXDGRAMDATA          32768
 #define MAXBSIZE                  64000
-#define NFS_MAXDATA               MAXBSIZE
+#define NFS_MAXDATA               1048576 /* Largest data size of Linux servers */
 #define NFS_MAXPATHLEN            1024
 #define NFS_MAXNAMLEN             255
 #define NFS_MAXPKTHDR             404
@@ -525,6 +525,15 @@ struct READDIR3args
   uint32_t           count;
 };
 
+struct READDIRPLUS3args
+{
+  struct file_handle dir;                           /* Variable length */
+  nfsuint64          cookie;
+  uint8_t            cookieverf[NFSX_V3COOKIEVERF];
+  uint32_t           dircount;
+  uint32_t           maxcount;
+};
+
 /* The READDIR reply is variable length and consists of multiple entries,
  *  each of form:
  *
@@ -535,6 +544,15 @@ struct READDIR3args
  *  Name string (variable size but in multiples of 4 bytes)
  *  Cookie (8 bytes)
  *  next entry (4 bytes)
+ *
+ * The READDIRPLUS reply has the same form, but each entry is followed by
+ * the attributes and the file handle of the entry before the next entry:
+ *
+ *  Attributes follow (4 bytes)
+ *  Attributes (sizeof(struct nfs_fattr), if they follow)
+ *  Handle follows (4 bytes)
+ *  Handle length (4 bytes, if it follows)
+ *  Handle (variable size but in multiples of 4 bytes, if it follows)
  */
 
 struct READDIR3resok
@@ -36,6 +36,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+
 #include "rpc.h"
 #include "nfs.h"
 #include "nfs_proto.h"
@@ -120,7 +122,6 @@ int nfs_request(FAR struct nfsmount *nmp, int procnum,
                 FAR void *response, size_t resplen)
 {
   FAR struct rpcclnt *clnt = nmp->nm_rpcclnt;
-  struct nfs_reply_header replyh;
   int error;
 
   error = rpcclnt_request(clnt, procnum, NFS_PROG, NFS_VER3,
@@ -156,6 +157,25 @@ int nfs_request(FAR struct nfsmount *nmp, int procnum,
         }
     }
 
+  return nfs_checkreply(response);
+}
+
+/****************************************************************************
+ * Name: nfs_checkreply
+ *
+ * Description:
+ *   Verify the NFS level of a reply that was received successfully.
+ *
+ * Returned Value:
+ *   Zero on success; a negative errno value on failure.
+ *
+ ****************************************************************************/
+
+int nfs_checkreply(FAR void *response)
+{
+  struct nfs_reply_header replyh;
+  int error;
+
   memcpy(&replyh, response, sizeof(struct nfs_reply_header));
 
   if (replyh.nfs_status != 0)
@@ -525,4 +545,9 @@ void nfs_attrupdate(FAR struct nfsnode *np, FAR struct nfs_fattr *attributes)
   fxdr_nfsv3time(&attributes->fa_atime, &np->n_atime);
   fxdr_nfsv3time(&attributes->fa_mtime, &np->n_mtime);
   fxdr_nfsv3time(&attributes->fa_ctime, &np->n_ctime);
+
+#ifdef NFS_ATTRCACHE
+  np->n_expire = clock_systime_ticks() +
+                 MSEC2TICK(CONFIG_NFS_ATTRCACHE_TIMEOUT);
+#endif
 }
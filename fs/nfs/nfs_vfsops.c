@@ -48,6 +48,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/statfs.h>
@@ -56,6 +57,7 @@
 #include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <fcntl.h>
@@ -64,8 +66,10 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/lib/lib.h>
 #include <nuttx/fs/nfs.h>
 #include <nuttx/net/netconfig.h>
 
@@ -101,6 +105,10 @@
 #  error "Length of cookie verify in fs_dirent_s is incorrect"
 #endif
 
+#ifndef NFS_ATTRCACHE
+#  define nfs_attrcache_flush(n)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -112,6 +120,25 @@ struct nfs_dir_s
   uint8_t  nfs_fhandle[DIRENT_NFS_MAXHANDLE]; /* File handle (max size allocated) */
   uint8_t  nfs_verifier[DIRENT_NFS_VERFLEN];  /* Cookie verifier */
   uint32_t nfs_cookie[2];                     /* Cookie */
+  bool     nfs_eof;                           /* The last reply ended the directory */
+#ifdef CONFIG_NFS_READDIRPLUS
+  bool     nfs_plus;                          /* nfs_buffer holds a READDIRPLUS reply */
+#  ifdef NFS_ATTRCACHE
+  FAR char *nfs_path;                         /* Relative path of the directory */
+#  endif
+#endif
+  FAR uint32_t *nfs_next;                     /* Next entry in nfs_buffer, or NULL */
+  uint32_t nfs_buflen;                        /* Size of nfs_buffer */
+  uint32_t nfs_buffer[1];                     /* The last reply, actual size is nfs_buflen */
+};
+
+/* One READ or WRITE RPC of a transfer */
+
+struct nfs_xfer_s
+{
+  uint32_t xfer_xid;                          /* Transaction ID, 0 if unused */
+  size_t   xfer_offset;                       /* Offset in the user buffer */
+  size_t   xfer_len;                          /* Length of the data */
 };
 
 /****************************************************************************
@@ -135,6 +162,26 @@ static int     nfs_filechstat(FAR struct nfsmount *nmp,
 static int     nfs_fileopen(FAR struct nfsmount *nmp,
                    FAR struct nfsnode *np, FAR const char *relpath,
                    int oflags, mode_t mode);
+#ifdef NFS_ATTRCACHE
+static int     nfs_fileattr(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np);
+static FAR struct nfs_fattr *nfs_attrcache_get(FAR struct nfsmount *nmp,
+                   FAR const char *relpath);
+static void    nfs_attrcache_put(FAR struct nfsmount *nmp,
+                   FAR const char *relpath,
+                   FAR const struct nfs_fattr *fattr);
+static void    nfs_attrcache_flush(FAR struct nfsmount *nmp);
+#endif
+static int     nfs_xfer_send(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, FAR struct nfs_xfer_s *xfer,
+                   off_t pos, FAR char *buffer, FAR int *stable);
+static int     nfs_xfer_wait(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, FAR struct nfs_xfer_s *xfer,
+                   off_t pos, FAR char *buffer, FAR int *stable,
+                   FAR int *status);
+static ssize_t nfs_transfer(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, off_t pos,
+                   FAR char *buffer, size_t buflen, FAR int *stable);
 
 static int     nfs_open(FAR struct file *filep, FAR const char *relpath,
                    int oflags, mode_t mode);
@@ -155,6 +202,8 @@ static int     nfs_opendir(FAR struct inode *mountpt,
                    FAR const char *relpath, FAR struct fs_dirent_s **dir);
 static int     nfs_closedir(FAR struct inode *mountpt,
                    FAR struct fs_dirent_s *dir);
+static int     nfs_readdir_fill(FAR struct nfsmount *nmp,
+                   FAR struct nfs_dir_s *ndir);
 static int     nfs_readdir(FAR struct inode *mountpt,
                            FAR struct fs_dirent_s *dir,
                            FAR struct dirent *entry);
@@ -334,6 +383,7 @@ static int nfs_filecreate(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
 
   /* Send the NFS request. */
 
+  nfs_attrcache_flush(nmp);
   nfs_statistics(NFSPROC_CREATE);
   ret = nfs_request(nmp, NFSPROC_CREATE,
                     &nmp->nm_msgbuffer.create, reqlen,
@@ -501,6 +551,7 @@ static int nfs_filechstat(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
 
   /* Perform the SETATTR RPC */
 
+  nfs_attrcache_flush(nmp);
   nfs_statistics(NFSPROC_SETATTR);
   ret = nfs_request(nmp, NFSPROC_SETATTR,
                     &nmp->nm_msgbuffer.setattr, reqlen,
@@ -637,6 +688,571 @@ static int nfs_fileopen(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
   return OK;
 }
 
+/****************************************************************************
+ * Name: nfs_fileattr
+ *
+ * Description:
+ *   Get the attributes of an open file from the server again with GETATTR
+ *   if the cached ones are stale.
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef NFS_ATTRCACHE
+static int nfs_fileattr(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  FAR struct rpc_call_fs *getattr;
+  FAR struct rpc_reply_getattr *attr;
+  int ret;
+
+  if ((sclock_t)(np->n_expire - clock_systime_ticks()) > 0)
+    {
+      return OK;
+    }
+
+  getattr = &nmp->nm_msgbuffer.fsinfo;
+  getattr->fs.fsroot.length = txdr_unsigned(np->n_fhsize);
+  memcpy(&getattr->fs.fsroot.handle, &np->n_fhandle, np->n_fhsize);
+
+  nfs_statistics(NFSPROC_GETATTR);
+  ret = nfs_request(nmp, NFSPROC_GETATTR,
+                    getattr, sizeof(uint32_t) + uint32_alignup(np->n_fhsize),
+                    nmp->nm_iobuffer, nmp->nm_buflen);
+  if (ret != OK)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", ret);
+      return ret;
+    }
+
+  attr = (FAR struct rpc_reply_getattr *)nmp->nm_iobuffer;
+  nfs_attrupdate(np, &attr->attr);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_attrcache_get
+ *
+ * Description:
+ *   Return the cached attributes of 'relpath' if they are not stale.
+ *
+ ****************************************************************************/
+
+static FAR struct nfs_fattr *nfs_attrcache_get(FAR struct nfsmount *nmp,
+                                               FAR const char *relpath)
+{
+  clock_t now = clock_systime_ticks();
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_NENTRIES; i++)
+    {
+      FAR struct nfs_attrcache_s *entry = &nmp->nm_attrcache[i];
+
+      if (entry->ac_path != NULL && strcmp(entry->ac_path, relpath) == 0)
+        {
+          if ((sclock_t)(entry->ac_expire - now) <= 0)
+            {
+              return NULL;
+            }
+
+          return &entry->ac_fattr;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: nfs_attrcache_put
+ *
+ * Description:
+ *   Remember the attributes of 'relpath', replacing the oldest entry if
+ *   the path is not cached yet.
+ *
+ ****************************************************************************/
+
+static void nfs_attrcache_put(FAR struct nfsmount *nmp,
+                              FAR const char *relpath,
+                              FAR const struct nfs_fattr *fattr)
+{
+  FAR struct nfs_attrcache_s *entry = NULL;
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_NENTRIES; i++)
+    {
+      if (nmp->nm_attrcache[i].ac_path != NULL &&
+          strcmp(nmp->nm_attrcache[i].ac_path, relpath) == 0)
+        {
+          entry = &nmp->nm_attrcache[i];
+          break;
+        }
+    }
+
+  if (entry == NULL)
+    {
+      entry = &nmp->nm_attrcache[nmp->nm_attrnext];
+      nmp->nm_attrnext = (nmp->nm_attrnext + 1) %
+                         CONFIG_NFS_ATTRCACHE_NENTRIES;
+
+      fs_heap_free(entry->ac_path);
+      entry->ac_path = fs_heap_strdup(relpath);
+      if (entry->ac_path == NULL)
+        {
+          return;
+        }
+    }
+
+  entry->ac_expire = clock_systime_ticks() +
+                     MSEC2TICK(CONFIG_NFS_ATTRCACHE_TIMEOUT);
+  memcpy(&entry->ac_fattr, fattr, sizeof(*fattr));
+}
+
+/****************************************************************************
+ * Name: nfs_attrcache_flush
+ *
+ * Description:
+ *   Forget all cached attributes of paths, before anything is modified.
+ *
+ ****************************************************************************/
+
+static void nfs_attrcache_flush(FAR struct nfsmount *nmp)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_NENTRIES; i++)
+    {
+      fs_heap_free(nmp->nm_attrcache[i].ac_path);
+      nmp->nm_attrcache[i].ac_path = NULL;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: nfs_xfer_send
+ *
+ * Description:
+ *   Send the READ RPC, or the WRITE RPC if 'stable' is not NULL, of one
+ *   part of a transfer.  The data of the part is at xfer_offset in 'buffer'
+ *   and 'pos' is the file position of the start of 'buffer'.
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_xfer_send(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                         FAR struct nfs_xfer_s *xfer, off_t pos,
+                         FAR char *buffer, FAR int *stable)
+{
+  FAR void *request;
+  FAR uint32_t *ptr;
+  size_t reqlen = 0;
+  int procnum;
+
+  /* Write is unique among the RPC calls in that the call message lies in
+   * the I/O buffer.
+   */
+
+  if (stable != NULL)
+    {
+      request = nmp->nm_iobuffer;
+      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
+                  request)->write;
+      procnum = NFSPROC_WRITE;
+    }
+  else
+    {
+      request = &nmp->nm_msgbuffer.read;
+      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
+      procnum = NFSPROC_READ;
+    }
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += uint32_alignup(np->n_fhsize);
+  ptr    += uint32_increment(np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper((uint64_t)(pos + xfer->xfer_offset), ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy the count */
+
+  *ptr++  = txdr_unsigned(xfer->xfer_len);
+  reqlen += sizeof(uint32_t);
+
+  if (stable != NULL)
+    {
+      /* Copy the stable value and the data */
+
+      *ptr++  = txdr_unsigned(*stable);
+      *ptr++  = txdr_unsigned(xfer->xfer_len);
+      reqlen += 2*sizeof(uint32_t);
+
+      memcpy(ptr, buffer + xfer->xfer_offset, xfer->xfer_len);
+      reqlen += uint32_alignup(xfer->xfer_len);
+    }
+
+  nfs_statistics(procnum);
+  return rpcclnt_send_call(nmp->nm_rpcclnt, xfer->xfer_xid, procnum,
+                           NFS_PROG, NFS_VER3, request, reqlen);
+}
+
+/****************************************************************************
+ * Name: nfs_xfer_wait
+ *
+ * Description:
+ *   Wait for the reply to one of the RPCs of a transfer that are in flight.
+ *   The RPCs are all sent again if no reply comes in time, or after
+ *   reconnecting if the connection was lost.  A READ reply is received in
+ *   the I/O buffer and a WRITE reply in the message buffer.
+ *
+ * Returned Value:
+ *   The index in 'xfer' of the RPC whose reply was received, its result is
+ *   returned in 'status'.  A negated errno value if no reply was received.
+ *
+ ****************************************************************************/
+
+static int nfs_xfer_wait(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                         FAR struct nfs_xfer_s *xfer, off_t pos,
+                         FAR char *buffer, FAR int *stable,
+                         FAR int *status)
+{
+  FAR struct rpcclnt *rpc = nmp->nm_rpcclnt;
+  FAR void *response;
+  bool reconnected = false;
+  size_t resplen;
+  uint32_t xid;
+  int retries = 0;
+  int ret;
+  int i;
+
+  if (stable != NULL)
+    {
+      response = &nmp->nm_msgbuffer.write;
+      resplen  = sizeof(struct rpc_reply_write);
+    }
+  else
+    {
+      response = nmp->nm_iobuffer;
+      resplen  = nmp->nm_buflen;
+    }
+
+  for (; ; )
+    {
+      xid = 0;
+      ret = rpcclnt_recv_reply(rpc, &xid, response, resplen);
+      if (xid != 0)
+        {
+          for (i = 0; i < CONFIG_NFS_WINDOW; i++)
+            {
+              if (xfer[i].xfer_xid == xid)
+                {
+                  *status = ret < 0 ? ret : nfs_checkreply(response);
+                  return i;
+                }
+            }
+
+          /* A late reply to an RPC that was sent again */
+
+          finfo("Stale RPC XID %" PRIu32 " returned\n", xid);
+          continue;
+        }
+
+      if (ret == -EAGAIN || ret == -ETIMEDOUT)
+        {
+          if (++retries >= rpc->rc_retry)
+            {
+              return ret;
+            }
+        }
+      else if (ret == -ENOTCONN && !reconnected)
+        {
+          finfo("Reconnect due to timeout\n");
+
+          reconnected = true;
+          ret = rpcclnt_connect(rpc);
+          if (ret != OK)
+            {
+              return ret;
+            }
+        }
+      else
+        {
+          return ret;
+        }
+
+      /* Send the RPCs in flight again */
+
+      for (i = 0; i < CONFIG_NFS_WINDOW; i++)
+        {
+          if (xfer[i].xfer_xid != 0)
+            {
+              ret = nfs_xfer_send(nmp, np, &xfer[i], pos, buffer, stable);
+              if (ret < 0 && ret != -ENOTCONN)
+                {
+                  return ret;
+                }
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nfs_transfer
+ *
+ * Description:
+ *   Read 'buflen' bytes from the file position 'pos' into 'buffer', or
+ *   write them from 'buffer' if 'stable' is not NULL.  The transfer is
+ *   split into RPCs of the read or write size and up to CONFIG_NFS_WINDOW
+ *   of them are in flight at once.  'stable' is the commitment level asked
+ *   for and returns the lowest level that any RPC obtained.
+ *
+ * Returned Value:
+ *   The (non-negative) number of bytes transferred from the start of
+ *   'buffer' on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The caller has exclusive access to the NFS mount structure
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_transfer(FAR struct nfsmount *nmp,
+                            FAR struct nfsnode *np, off_t pos,
+                            FAR char *buffer, size_t buflen,
+                            FAR int *stable)
+{
+  struct nfs_xfer_s xfer[CONFIG_NFS_WINDOW];
+  FAR uint32_t *ptr;
+  size_t attroff = 0;
+  size_t chunk;
+  size_t next = 0;
+  size_t end = buflen;
+  uint32_t count;
+  uint32_t tmp;
+  int nbusy = 0;
+  int status;
+  int ret = OK;
+  int i;
+
+  /* Make sure that the size of the RPCs does not exceed the RPC maximum or
+   * the I/O buffer size.
+   */
+
+  if (stable != NULL)
+    {
+      chunk = nmp->nm_wsize;
+      tmp   = SIZEOF_rpc_call_write(chunk);
+    }
+  else
+    {
+      chunk = nmp->nm_rsize;
+      tmp   = SIZEOF_rpc_reply_read(chunk);
+    }
+
+  if (tmp > nmp->nm_buflen)
+    {
+      chunk -= tmp - nmp->nm_buflen;
+    }
+
+  memset(xfer, 0, sizeof(xfer));
+
+  for (; ; )
+    {
+      /* Keep the window of RPCs full */
+
+      for (i = 0; ret == OK && next < end && i < CONFIG_NFS_WINDOW; i++)
+        {
+          if (xfer[i].xfer_xid != 0)
+            {
+              continue;
+            }
+
+          /* Get a new (non-zero) xid */
+
+          xfer[i].xfer_xid = ++nmp->nm_rpcclnt->rc_xid;
+          if (xfer[i].xfer_xid == 0)
+            {
+              xfer[i].xfer_xid = ++nmp->nm_rpcclnt->rc_xid;
+            }
+
+          xfer[i].xfer_offset = next;
+          xfer[i].xfer_len    = MIN(chunk, end - next);
+
+          /* If the connection was lost, the RPC is sent again after
+           * reconnecting.
+           */
+
+          ret = nfs_xfer_send(nmp, np, &xfer[i], pos, buffer, stable);
+          if (ret == -ENOTCONN)
+            {
+              ret = OK;
+            }
+          else if (ret < 0)
+            {
+              ferr("ERROR: nfs_xfer_send failed: %d\n", ret);
+              xfer[i].xfer_xid = 0;
+              end = next;
+              break;
+            }
+
+          next += xfer[i].xfer_len;
+          nbusy++;
+        }
+
+      if (nbusy == 0)
+        {
+          break;
+        }
+
+      i = nfs_xfer_wait(nmp, np, xfer, pos, buffer, stable, &status);
+      if (i < 0)
+        {
+          /* Only the data before the first RPC in flight is complete */
+
+          ferr("ERROR: nfs_xfer_wait failed: %d\n", i);
+          ret = i;
+
+          for (i = 0; i < CONFIG_NFS_WINDOW; i++)
+            {
+              if (xfer[i].xfer_xid != 0)
+                {
+                  end = MIN(end, xfer[i].xfer_offset);
+                }
+            }
+
+          break;
+        }
+
+      xfer[i].xfer_xid = 0;
+      nbusy--;
+
+      if (status != OK)
+        {
+          ferr("ERROR: nfs_request failed: %d\n", status);
+          goto errout_with_xfer;
+        }
+
+      if (stable != NULL)
+        {
+          /* Get a pointer to the WRITE reply data */
+
+          ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
+
+          /* Parse file_wcc.  First, check if WCC attributes follow. */
+
+          tmp = *ptr++;
+          if (tmp != 0)
+            {
+              /* Yes.. WCC attributes follow.  But we just skip over them. */
+
+              ptr += uint32_increment(sizeof(struct wcc_attr));
+            }
+        }
+      else
+        {
+          ptr = (FAR uint32_t *)
+            &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+        }
+
+      /* Check if normal file attributes follow.  The replies may come in
+       * any order, the ones of the RPC furthest into the file are kept.
+       */
+
+      tmp = *ptr++;
+      if (tmp != 0)
+        {
+          if (xfer[i].xfer_offset >= attroff)
+            {
+              nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+              attroff = xfer[i].xfer_offset;
+            }
+
+          ptr += uint32_increment(sizeof(struct nfs_fattr));
+        }
+
+      if (stable != NULL)
+        {
+          /* Get the count of bytes actually written */
+
+          count = fxdr_unsigned(uint32_t, *ptr);
+          ptr++;
+
+          if (count < 1 || count > xfer[i].xfer_len)
+            {
+              status = -EIO;
+              goto errout_with_xfer;
+            }
+
+          /* Determine the lowest commitment level obtained by any of the
+           * RPCs.
+           */
+
+          tmp = fxdr_unsigned(uint32_t, *ptr);
+          if (*stable == NFSV3WRITE_FILESYNC)
+            {
+              *stable = tmp;
+            }
+          else if (*stable == NFSV3WRITE_DATASYNC &&
+                   tmp == NFSV3WRITE_UNSTABLE)
+            {
+              *stable = tmp;
+            }
+        }
+      else
+        {
+          /* This is followed by the count of data read, an EOF indication
+           * and then the length of the read data followed by the read data
+           * itself.
+           */
+
+          ptr++;
+          tmp   = *ptr++;
+          count = fxdr_unsigned(uint32_t, *ptr);
+          ptr++;
+
+          if (count > xfer[i].xfer_len)
+            {
+              status = -EIO;
+              goto errout_with_xfer;
+            }
+
+          /* Copy the read data into the user buffer */
+
+          memcpy(buffer + xfer[i].xfer_offset, ptr, count);
+
+          /* Check if we hit the end of file */
+
+          if (tmp != 0)
+            {
+              end = MIN(end, xfer[i].xfer_offset + count);
+            }
+        }
+
+      /* The data after a short transfer is not contiguous */
+
+      if (count < xfer[i].xfer_len)
+        {
+          end = MIN(end, xfer[i].xfer_offset + count);
+        }
+
+      continue;
+
+errout_with_xfer:
+      end = MIN(end, xfer[i].xfer_offset);
+      ret = status;
+    }
+
+  return end > 0 ? end : ret;
+}
+
 /****************************************************************************
  * Name: nfs_open
  *
@@ -874,12 +1490,8 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
 {
   FAR struct nfsmount       *nmp;
   FAR struct nfsnode        *np;
-  ssize_t                    readsize;
   ssize_t                    tmp;
-  ssize_t                    bytesread;
-  size_t                     reqlen;
-  FAR uint32_t              *ptr;
-  int                        ret = 0;
+  ssize_t                    ret;
 
   finfo("Read %zu bytes from offset %jd\n",
         buflen, (intmax_t)filep->f_pos);
@@ -898,9 +1510,19 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
   ret = nxmutex_lock(&nmp->nm_lock);
   if (ret < 0)
     {
-      return (ssize_t)ret;
+      return ret;
     }
 
+#ifdef NFS_ATTRCACHE
+  /* Another client may have changed the size of the file */
+
+  ret = nfs_fileattr(nmp, np);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+#endif
+
   /* Get the number of bytes left in the file and truncate read count so that
    * it does not exceed the number of bytes left in the file.
    */
@@ -912,313 +1534,79 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
       finfo("Read size truncated to %zu\n", buflen);
     }
 
-  /* Now loop until we fill the user buffer (or hit the end of the file) */
+  /* Now read until we fill the user buffer (or hit the end of the file) */
 
-  for (bytesread = 0; bytesread < buflen; )
+  ret = nfs_transfer(nmp, np, filep->f_pos, buffer, buflen, NULL);
+  if (ret > 0)
     {
-      /* Make sure that the attempted read size does not exceed the RPC
-       * maximum
-       */
-
-      readsize = buflen - bytesread;
-      if (readsize > nmp->nm_rsize)
-        {
-          readsize = nmp->nm_rsize;
-        }
-
-      /* Make sure that the attempted read size does not exceed the IO buffer
-       * size
-       */
-
-      tmp = SIZEOF_rpc_reply_read(readsize);
-      if (tmp > nmp->nm_buflen)
-        {
-          readsize -= (tmp - nmp->nm_buflen);
-        }
-
-      /* Initialize the request */
-
-      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += uint32_alignup(np->n_fhsize);
-      ptr    += uint32_increment(np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Set the readsize */
-
-      *ptr = txdr_unsigned(readsize);
-      reqlen += sizeof(uint32_t);
-
-      /* Perform the read */
-
-      finfo("Reading %zu bytes\n", readsize);
-      nfs_statistics(NFSPROC_READ);
-      ret = nfs_request(nmp, NFSPROC_READ,
-                        &nmp->nm_msgbuffer.read, reqlen,
-                        nmp->nm_iobuffer, nmp->nm_buflen);
-      if (ret)
-        {
-          ferr("ERROR: nfs_request failed: %d\n", ret);
-          goto errout_with_lock;
-        }
-
-      /* The read was successful.  Get a pointer to the beginning of the NFS
-       * response data.
-       */
-
-      ptr = (FAR uint32_t *)
-        &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
-
-      /* Check if attributes are included in the responses */
-
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. Update the cached file status in the file structure. */
-
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
-        }
-
-      /* This is followed by the count of data read.  Isn't this
-       * the same as the length that is included in the read data?
-       *
-       * Just skip over if for now.
-       */
-
-      ptr++;
-
-      /* Next comes an EOF indication.  Save that in tmp for now. */
-
-      tmp = *ptr++;
-
-      /* Then the length of the read data followed by the read data itself */
-
-      readsize = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
-
-      /* Copy the read data into the user buffer */
-
-      memcpy(buffer, ptr, readsize);
-
-      /* Update the read state data */
-
-      filep->f_pos += readsize;
-      bytesread    += readsize;
-      buffer       += readsize;
-
-      /* Check if we hit the end of file */
-
-      if (tmp != 0)
-        {
-          break;
-        }
+      filep->f_pos += ret;
     }
 
-errout_with_lock:
-  nxmutex_unlock(&nmp->nm_lock);
-  return bytesread > 0 ? bytesread : ret;
-}
-
-/****************************************************************************
- * Name: nfs_write
- *
- * Returned Value:
- *   The (non-negative) number of bytes written on success; a negated errno
- *   value on failure.
- *
- ****************************************************************************/
-
-static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
-                         size_t buflen)
-{
-  FAR struct nfsmount *nmp;
-  FAR struct nfsnode  *np;
-  ssize_t              writesize;
-  ssize_t              bufsize;
-  ssize_t              byteswritten = 0;
-  size_t               reqlen;
-  FAR uint32_t        *ptr;
-  uint32_t             tmp;
-  int                  commit = 0;
-  int                  committed = NFSV3WRITE_FILESYNC;
-  int                  ret;
-
-  finfo("Write %zu bytes to offset %jd\n",
-        buflen, (intmax_t)filep->f_pos);
-
-  /* Sanity checks */
-
-  DEBUGASSERT(filep->f_priv != NULL);
-
-  /* Recover our private data from the struct file instance */
-
-  nmp = filep->f_inode->i_private;
-  np  = (FAR struct nfsnode *)filep->f_priv;
-
-  DEBUGASSERT(nmp != NULL);
-
-  ret = nxmutex_lock(&nmp->nm_lock);
-  if (ret < 0)
-    {
-      return (ssize_t)ret;
-    }
-
-  /* Check if the file size would exceed the range of off_t */
-
-  if (np->n_size + buflen < np->n_size)
-    {
-      ret = -EFBIG;
-      goto errout_with_lock;
-    }
-
-  /* Now loop until we send the entire user buffer */
-
-  for (byteswritten = 0; byteswritten < buflen; )
-    {
-      /* Make sure that the attempted write size does not exceed the RPC
-       * maximum.
-       */
-
-      writesize = buflen - byteswritten;
-      if (writesize > nmp->nm_wsize)
-        {
-          writesize = nmp->nm_wsize;
-        }
-
-      /* Make sure that the attempted read size does not exceed the IO
-       * buffer size.
-       */
-
-      bufsize = SIZEOF_rpc_call_write(writesize);
-      if (bufsize > nmp->nm_buflen)
-        {
-          writesize -= (bufsize - nmp->nm_buflen);
-        }
-
-      /* Initialize the request.  Here we need an offset pointer to the write
-       * arguments, skipping over the RPC header.  Write is unique among the
-       * RPC calls in that the entry RPC calls message lies in the I/O buffer
-       */
-
-      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
-                  nmp->nm_iobuffer)->write;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += uint32_alignup(np->n_fhsize);
-      ptr    += uint32_increment(np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr    += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Copy the count and stable values */
-
-      *ptr++  = txdr_unsigned(writesize);
-      *ptr++  = txdr_unsigned(committed);
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Copy a chunk of the user data into the I/O buffer */
-
-      *ptr++  = txdr_unsigned(writesize);
-      reqlen += sizeof(uint32_t);
-      memcpy(ptr, buffer, writesize);
-      reqlen += uint32_alignup(writesize);
-
-      /* Perform the write */
-
-      nfs_statistics(NFSPROC_WRITE);
-      ret = nfs_request(nmp, NFSPROC_WRITE,
-                        nmp->nm_iobuffer, reqlen,
-                        &nmp->nm_msgbuffer.write,
-                        sizeof(struct rpc_reply_write));
-      if (ret)
-        {
-          ferr("ERROR: nfs_request failed: %d\n", ret);
-          goto errout_with_lock;
-        }
-
-      /* Get a pointer to the WRITE reply data */
-
-      ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
-
-      /* Parse file_wcc.  First, check if WCC attributes follow. */
+#ifdef NFS_ATTRCACHE
+errout_with_lock:
+#endif
+  nxmutex_unlock(&nmp->nm_lock);
+  return ret;
+}
 
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. WCC attributes follow.  But we just skip over them. */
+/****************************************************************************
+ * Name: nfs_write
+ *
+ * Returned Value:
+ *   The (non-negative) number of bytes written on success; a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
 
-          ptr += uint32_increment(sizeof(struct wcc_attr));
-        }
+static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t buflen)
+{
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode  *np;
+  int                  committed = NFSV3WRITE_FILESYNC;
+  ssize_t              ret;
 
-      /* Check if normal file attributes follow */
+  finfo("Write %zu bytes to offset %jd\n",
+        buflen, (intmax_t)filep->f_pos);
 
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. Update the cached file status in the file structure. */
+  /* Sanity checks */
 
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
-        }
+  DEBUGASSERT(filep->f_priv != NULL);
 
-      /* Get the count of bytes actually written */
+  /* Recover our private data from the struct file instance */
 
-      tmp = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
+  nmp = filep->f_inode->i_private;
+  np  = (FAR struct nfsnode *)filep->f_priv;
 
-      if (tmp < 1 || tmp > writesize)
-        {
-          ret = -EIO;
-          goto errout_with_lock;
-        }
+  DEBUGASSERT(nmp != NULL);
 
-      writesize = tmp;
+  ret = nxmutex_lock(&nmp->nm_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
-      /* Determine the lowest commitment level obtained by any of the RPCs. */
+  /* Check if the file size would exceed the range of off_t */
 
-      commit = *ptr++;
-      if (committed == NFSV3WRITE_FILESYNC)
-        {
-          committed = commit;
-        }
-      else if (committed == NFSV3WRITE_DATASYNC &&
-               commit == NFSV3WRITE_UNSTABLE)
-        {
-          committed = commit;
-        }
+  if (np->n_size + buflen < np->n_size)
+    {
+      ret = -EFBIG;
+      goto errout_with_lock;
+    }
 
-      /* Update the read state data */
+  /* Now send the entire user buffer */
 
-      filep->f_pos += writesize;
-      byteswritten += writesize;
-      buffer       += writesize;
+  nfs_attrcache_flush(nmp);
+  ret = nfs_transfer(nmp, np, filep->f_pos, (FAR char *)buffer, buflen,
+                     &committed);
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
     }
 
 errout_with_lock:
   nxmutex_unlock(&nmp->nm_lock);
-  return byteswritten > 0 ? byteswritten : ret;
+  return ret;
 }
 
 /****************************************************************************
@@ -1265,6 +1653,15 @@ static off_t nfs_seek(FAR struct file *filep, off_t offset, int whence)
         break;
 
       case SEEK_END:
+#ifdef NFS_ATTRCACHE
+        ret = nfs_fileattr(nmp, np);
+        if (ret < 0)
+          {
+            nxmutex_unlock(&nmp->nm_lock);
+            return ret;
+          }
+#endif
+
         offset += np->n_size;
         break;
 
@@ -1379,6 +1776,15 @@ static int nfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
       return ret;
     }
 
+#ifdef NFS_ATTRCACHE
+  ret = nfs_fileattr(nmp, np);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&nmp->nm_lock);
+      return ret;
+    }
+#endif
+
   /* Extract the file mode, file type, and file size from the nfsnode
    * structure.
    */
@@ -1496,6 +1902,7 @@ static int nfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
   FAR struct nfs_dir_s *ndir;
   struct file_handle fhandle;
   struct nfs_fattr obj_attributes;
+  uint32_t buflen;
   uint32_t objtype;
   int ret;
 
@@ -1508,12 +1915,26 @@ static int nfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
   /* Recover our private data from the inode instance */
 
   nmp = mountpt->i_private;
-  ndir = fs_heap_zalloc(sizeof(*ndir));
+
+  /* The directory keeps the last reply, so that each readdir() does not
+   * need a new RPC.
+   */
+
+  buflen = SIZEOF_rpc_reply_readdir(nmp->nm_readdirsize);
+  if (buflen > nmp->nm_buflen)
+    {
+      buflen = nmp->nm_buflen;
+    }
+
+  buflen &= ~3;
+  ndir = fs_heap_zalloc(sizeof(*ndir) + buflen - sizeof(uint32_t));
   if (ndir == NULL)
     {
       return -ENOMEM;
     }
 
+  ndir->nfs_buflen = buflen;
+
   ret = nxmutex_lock(&nmp->nm_lock);
   if (ret < 0)
     {
@@ -1547,6 +1968,18 @@ static int nfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
   DEBUGASSERT(fhandle.length <= DIRENT_NFS_MAXHANDLE);
 
   memcpy(ndir->nfs_fhandle, &fhandle.handle, fhandle.length);
+
+#if defined(CONFIG_NFS_READDIRPLUS) && defined(NFS_ATTRCACHE)
+  /* The attributes of the entries are cached by their path.  Without
+   * memory for the path they are just not cached.
+   */
+
+  if (relpath != NULL)
+    {
+      ndir->nfs_path = fs_heap_strdup(relpath);
+    }
+#endif
+
   *dir = &ndir->nfs_base;
   nxmutex_unlock(&nmp->nm_lock);
   return 0;
@@ -1573,59 +2006,65 @@ static int nfs_closedir(FAR struct inode *mountpt,
                         FAR struct fs_dirent_s *dir)
 {
   DEBUGASSERT(dir);
+
+#if defined(CONFIG_NFS_READDIRPLUS) && defined(NFS_ATTRCACHE)
+  fs_heap_free(((FAR struct nfs_dir_s *)dir)->nfs_path);
+#endif
+
   fs_heap_free(dir);
   return 0;
 }
 
 /****************************************************************************
- * Name: nfs_readdir
+ * Name: nfs_readdir_fill
  *
- * Description: Read from directory
+ * Description:
+ *   Request the next block of directory entries into the buffer of the
+ *   directory, with READDIRPLUS if it is enabled and the server supports
+ *   it.
  *
  * Returned Value:
  *   0 on success; a negated errno value on failure.
  *
  ****************************************************************************/
 
-static int nfs_readdir(FAR struct inode *mountpt,
-                       FAR struct fs_dirent_s *dir,
-                       FAR struct dirent *entry)
+static int nfs_readdir_fill(FAR struct nfsmount *nmp,
+                            FAR struct nfs_dir_s *ndir)
 {
-  FAR struct nfsmount *nmp;
-  FAR struct nfs_dir_s *ndir;
-  struct file_handle fhandle;
-  struct nfs_fattr obj_attributes;
+  FAR void *request;
+  FAR uint32_t *ptr;
   uint32_t readsize;
   uint32_t tmp;
-  FAR uint32_t *ptr;
-  FAR uint8_t *name;
-  unsigned int length;
+  int procnum;
   int reqlen;
   int ret;
 
-  finfo("Entry\n");
-
-  /* Sanity checks */
-
-  DEBUGASSERT(mountpt != NULL && mountpt->i_private != NULL);
-
-  /* Recover our private data from the inode instance */
-
-  nmp = mountpt->i_private;
-  ndir = (FAR struct nfs_dir_s *)dir;
+  /* Make sure that the reply fits into the buffer of the directory */
 
-  ret = nxmutex_lock(&nmp->nm_lock);
-  if (ret < 0)
+  readsize = nmp->nm_readdirsize;
+  tmp      = SIZEOF_rpc_reply_readdir(readsize);
+  if (tmp > ndir->nfs_buflen)
     {
-      return ret;
+      readsize -= (tmp - ndir->nfs_buflen);
     }
 
-read_dir:
-  /* Request a block directory entries, copying directory information from
-   * the dirent structure.
-   */
+#ifdef CONFIG_NFS_READDIRPLUS
+retry:
+  ndir->nfs_plus = !nmp->nm_noplus;
+  if (ndir->nfs_plus)
+    {
+      request = &nmp->nm_msgbuffer.readdirplus;
+      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.readdirplus.readdirplus;
+      procnum = NFSPROC_READDIRPLUS;
+    }
+  else
+#endif
+    {
+      request = &nmp->nm_msgbuffer.readdir;
+      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.readdir.readdir;
+      procnum = NFSPROC_READDIR;
+    }
 
-  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.readdir.readdir;
   reqlen  = 0;
 
   /* Copy the variable length, directory file handle */
@@ -1648,30 +2087,40 @@ read_dir:
   ptr    += uint32_increment(DIRENT_NFS_VERFLEN);
   reqlen += DIRENT_NFS_VERFLEN;
 
-  /* Number of directory entries (We currently only process one entry at a
-   * time)
+  /* The size of the reply, READDIRPLUS has the size of the directory
+   * information and then the size of the whole reply.
    */
 
-  readsize = nmp->nm_readdirsize;
-  tmp      = SIZEOF_rpc_reply_readdir(readsize);
-  if (tmp > nmp->nm_buflen)
+  *ptr++   = txdr_unsigned(readsize);
+  reqlen  += sizeof(uint32_t);
+
+#ifdef CONFIG_NFS_READDIRPLUS
+  if (ndir->nfs_plus)
     {
-      readsize -= (tmp - nmp->nm_buflen);
+      *ptr    = txdr_unsigned(readsize);
+      reqlen += sizeof(uint32_t);
     }
-
-  *ptr     = txdr_unsigned(readsize);
-  reqlen  += sizeof(uint32_t);
+#endif
 
   /* And read the directory */
 
-  nfs_statistics(NFSPROC_READDIR);
-  ret = nfs_request(nmp, NFSPROC_READDIR,
-                    &nmp->nm_msgbuffer.readdir, reqlen,
-                    nmp->nm_iobuffer, nmp->nm_buflen);
+  nfs_statistics(procnum);
+  ret = nfs_request(nmp, procnum, request, reqlen,
+                    ndir->nfs_buffer, ndir->nfs_buflen);
+
+#ifdef CONFIG_NFS_READDIRPLUS
+  if (ret == -NFSERR_NOTSUPP && ndir->nfs_plus)
+    {
+      finfo("READDIRPLUS is not supported\n");
+      nmp->nm_noplus = true;
+      goto retry;
+    }
+#endif
+
   if (ret != OK)
     {
       ferr("ERROR: nfs_request failed: %d\n", ret);
-      goto errout_with_lock;
+      return ret;
     }
 
   /* A new group of entries was successfully read.  Process the
@@ -1685,7 +2134,7 @@ read_dir:
    */
 
   ptr = (FAR uint32_t *)
-    &((FAR struct rpc_reply_readdir *)nmp->nm_iobuffer)->readdir;
+    &((FAR struct rpc_reply_readdir *)ndir->nfs_buffer)->readdir;
 
   /* Check if attributes follow, if 0 so Skip over the attributes */
 
@@ -1702,102 +2151,200 @@ read_dir:
   memcpy(ndir->nfs_verifier, ptr, DIRENT_NFS_VERFLEN);
   ptr += uint32_increment(DIRENT_NFS_VERFLEN);
 
-next_entry:
-  /* Check if values follow.  If no values follow, then the EOF indication
-   * will appear next.
-   */
+  /* The values follows indication of the first entry is next */
 
-  tmp = *ptr++;
-  if (tmp == 0)
+  ndir->nfs_next = ptr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_readdir
+ *
+ * Description: Read from directory
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_readdir(FAR struct inode *mountpt,
+                       FAR struct fs_dirent_s *dir,
+                       FAR struct dirent *entry)
+{
+  FAR struct nfsmount *nmp;
+  FAR struct nfs_dir_s *ndir;
+  FAR struct nfs_fattr *fattr;
+  struct file_handle fhandle;
+  struct nfs_fattr obj_attributes;
+  uint32_t tmp;
+  FAR uint32_t *ptr;
+  FAR uint8_t *name;
+  unsigned int length;
+  int ret;
+
+  finfo("Entry\n");
+
+  /* Sanity checks */
+
+  DEBUGASSERT(mountpt != NULL && mountpt->i_private != NULL);
+
+  /* Recover our private data from the inode instance */
+
+  nmp = mountpt->i_private;
+  ndir = (FAR struct nfs_dir_s *)dir;
+
+  ret = nxmutex_lock(&nmp->nm_lock);
+  if (ret < 0)
     {
-      /* No values follow, then the reply should consist only of a 4-byte
-       * end-of-directory indication.
-       */
+      return ret;
+    }
 
-      tmp = *ptr++;
-      if (tmp != 0)
+  for (; ; )
+    {
+      /* Request a block directory entries when the last one is used up */
+
+      if (ndir->nfs_next == NULL)
         {
-          finfo("End of directory\n");
-          ret = -ENOENT;
-          goto errout_with_lock;
+          if (ndir->nfs_eof)
+            {
+              finfo("End of directory\n");
+              ret = -ENOENT;
+              goto errout_with_lock;
+            }
+
+          ret = nfs_readdir_fill(nmp, ndir);
+          if (ret != OK)
+            {
+              goto errout_with_lock;
+            }
         }
 
-      /* What would it mean if there were not data and we not at the end of
-       * file?
+      /* Check if values follow.  If no values follow, then the EOF
+       * indication will appear next.  Without it, the next block is
+       * requested.
        */
 
-       else
+      ptr = ndir->nfs_next;
+      tmp = *ptr++;
+      if (tmp == 0)
         {
-          finfo("No data but not end of directory???\n");
-          goto read_dir;
+          ndir->nfs_eof  = *ptr != 0;
+          ndir->nfs_next = NULL;
+          continue;
         }
-    }
 
-  /* If we are not at the end of the directory listing, then a set of entries
-   * will follow the header.  Each entry is of the form:
-   *
-   *    File ID (8 bytes)
-   *    Name length (4 bytes)
-   *    Name string (variable size but in multiples of 4 bytes)
-   *    Cookie (8 bytes)
-   *    next entry (4 bytes)
-   */
+      /* Each entry is of the form:
+       *
+       *    File ID (8 bytes)
+       *    Name length (4 bytes)
+       *    Name string (variable size but in multiples of 4 bytes)
+       *    Cookie (8 bytes)
+       *    Attributes and file handle (READDIRPLUS only)
+       *    next entry (4 bytes)
+       */
 
-  /* There is an entry. Skip over the file ID and point to the length */
+      /* There is an entry. Skip over the file ID and point to the length */
 
-  ptr += 2;
+      ptr += 2;
 
-  /* Get the length and point to the name */
+      /* Get the length and point to the name */
 
-  tmp    = *ptr++;
-  length = fxdr_unsigned(uint32_t, tmp);
-  name   = (FAR uint8_t *)ptr;
+      tmp    = *ptr++;
+      length = fxdr_unsigned(uint32_t, tmp);
+      name   = (FAR uint8_t *)ptr;
 
-  /* Increment the pointer past the name (allowing for padding). ptr
-   * now points to the cookie.
-   */
+      /* Increment the pointer past the name (allowing for padding). ptr
+       * now points to the cookie.
+       */
 
-  ptr += uint32_increment(length);
+      ptr += uint32_increment(length);
 
-  /* Save the cookie and increment the pointer to the next entry */
+      /* Save the cookie and increment the pointer to the next entry */
 
-  ndir->nfs_cookie[0] = *ptr++;
-  ndir->nfs_cookie[1] = *ptr++;
+      ndir->nfs_cookie[0] = *ptr++;
+      ndir->nfs_cookie[1] = *ptr++;
 
-  /* Return the name of the node to the caller */
+      fattr = NULL;
 
-  if (length > NAME_MAX)
-    {
-      length = NAME_MAX;
-    }
+#ifdef CONFIG_NFS_READDIRPLUS
+      if (ndir->nfs_plus)
+        {
+          /* The attributes and the file handle of the entry follow */
 
-  memcpy(entry->d_name, name, length);
-  entry->d_name[length] = '\0';
-  finfo("name: \"%s\"\n", entry->d_name);
+          if (*ptr++ != 0)
+            {
+              fattr = (FAR struct nfs_fattr *)ptr;
+              ptr  += uint32_increment(sizeof(struct nfs_fattr));
+            }
 
-  if (strcmp(entry->d_name, ".") == 0 ||
-      strcmp(entry->d_name, "..") == 0)
-    {
-      goto next_entry; /* Skip . and .. */
+          if (*ptr++ != 0)
+            {
+              tmp  = fxdr_unsigned(uint32_t, *ptr++);
+              ptr += uint32_increment(tmp);
+            }
+        }
+#endif
+
+      ndir->nfs_next = ptr;
+
+      /* Return the name of the node to the caller */
+
+      if (length > NAME_MAX)
+        {
+          length = NAME_MAX;
+        }
+
+      memcpy(entry->d_name, name, length);
+      entry->d_name[length] = '\0';
+      finfo("name: \"%s\"\n", entry->d_name);
+
+      /* Skip . and .. */
+
+      if (strcmp(entry->d_name, ".") != 0 &&
+          strcmp(entry->d_name, "..") != 0)
+        {
+          break;
+        }
     }
 
-  /* Get the file attributes associated with this name and return
-   * the file type.
-   */
+  if (fattr == NULL)
+    {
+      /* Get the file attributes associated with this name and return
+       * the file type.
+       */
 
-  fhandle.length = (uint32_t)ndir->nfs_fhsize;
-  memcpy(&fhandle.handle, ndir->nfs_fhandle, fhandle.length);
+      fhandle.length = (uint32_t)ndir->nfs_fhsize;
+      memcpy(&fhandle.handle, ndir->nfs_fhandle, fhandle.length);
 
-  ret = nfs_lookup(nmp, entry->d_name, &fhandle, &obj_attributes, NULL);
-  if (ret != OK)
+      ret = nfs_lookup(nmp, entry->d_name, &fhandle, &obj_attributes, NULL);
+      if (ret != OK)
+        {
+          ferr("ERROR: nfs_lookup failed: %d\n", ret);
+          goto errout_with_lock;
+        }
+
+      fattr = &obj_attributes;
+    }
+#if defined(CONFIG_NFS_READDIRPLUS) && defined(NFS_ATTRCACHE)
+  else if (ndir->nfs_path != NULL)
     {
-      ferr("ERROR: nfs_lookup failed: %d\n", ret);
-      goto errout_with_lock;
+      FAR char *path = lib_get_pathbuffer();
+
+      /* Keep the attributes for the stat() that usually follows */
+
+      if (path != NULL)
+        {
+          snprintf(path, PATH_MAX, "%s%s%s", ndir->nfs_path,
+                   ndir->nfs_path[0] != '\0' ? "/" : "", entry->d_name);
+          nfs_attrcache_put(nmp, path, fattr);
+          lib_put_pathbuffer(path);
+        }
     }
+#endif
 
   /* Set the dirent file type */
 
-  tmp = fxdr_unsigned(uint32_t, obj_attributes.fa_type);
+  tmp = fxdr_unsigned(uint32_t, fattr->fa_type);
   switch (tmp)
     {
     default:
@@ -1872,6 +2419,8 @@ static int nfs_rewinddir(FAR struct inode *mountpt,
   memset(&ndir->nfs_verifier, 0, DIRENT_NFS_VERFLEN);
   ndir->nfs_cookie[0] = 0;
   ndir->nfs_cookie[1] = 0;
+  ndir->nfs_next      = NULL;
+  ndir->nfs_eof       = false;
   return OK;
 }
 
@@ -1936,11 +2485,6 @@ static void nfs_decode_args(FAR struct nfs_mount_parameters *nprmt,
       maxio = NFS_MAXDATA;
     }
 
-  if (maxio > MAXBSIZE)
-    {
-      maxio = MAXBSIZE;
-    }
-
   /* Get the maximum amount of data that can be transferred in one write
    * transfer
    */
@@ -2073,7 +2617,8 @@ static int nfs_bind(FAR struct inode *blkdriver, FAR const void *data,
       buflen = tmp;
     }
 
-  /* But don't let the buffer size exceed the MSS of the socket type.
+  /* But don't let the buffer size exceed the MSS of the socket type,
+   * unless the datagrams can be fragmented.
    *
    * In the case where there are multiple network devices with different
    * link layer protocols, each network device may support a different
@@ -2081,10 +2626,12 @@ static int nfs_bind(FAR struct inode *blkdriver, FAR const void *data,
    * that case.
    */
 
+#ifndef CONFIG_NET_IPFRAG
   if (argp->sotype == SOCK_DGRAM && buflen > MIN_UDP_MSS)
     {
       buflen = MIN_UDP_MSS;
     }
+#endif
 
   /* Create an instance of the mountpt state structure */
 
@@ -2097,7 +2644,7 @@ static int nfs_bind(FAR struct inode *blkdriver, FAR const void *data,
 
   /* Save the allocated I/O buffer size */
 
-  nmp->nm_buflen = (uint16_t)buflen;
+  nmp->nm_buflen = buflen;
 
   /* Initialize the allocated mountpt state structure. */
 
@@ -2243,6 +2790,7 @@ static int nfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   /* And free any allocated resources */
 
+  nfs_attrcache_flush(nmp);
   nxmutex_destroy(&nmp->nm_lock);
   fs_heap_free(nmp->nm_rpcclnt);
   fs_heap_free(nmp);
@@ -2505,6 +3053,7 @@ static int nfs_remove(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Perform the REMOVE RPC call */
 
+  nfs_attrcache_flush(nmp);
   nfs_statistics(NFSPROC_REMOVE);
   ret = nfs_request(nmp, NFSPROC_REMOVE,
                     &nmp->nm_msgbuffer.removef, reqlen,
@@ -2628,6 +3177,7 @@ static int nfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Perform the MKDIR RPC */
 
+  nfs_attrcache_flush(nmp);
   nfs_statistics(NFSPROC_MKDIR);
   ret = nfs_request(nmp, NFSPROC_MKDIR,
                     &nmp->nm_msgbuffer.mkdir, reqlen,
@@ -2715,6 +3265,7 @@ static int nfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Perform the RMDIR RPC */
 
+  nfs_attrcache_flush(nmp);
   nfs_statistics(NFSPROC_RMDIR);
   ret = nfs_request(nmp, NFSPROC_RMDIR,
                     &nmp->nm_msgbuffer.rmdir, reqlen,
@@ -2828,6 +3379,7 @@ static int nfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
 
   /* Perform the RENAME RPC */
 
+  nfs_attrcache_flush(nmp);
   nfs_statistics(NFSPROC_RENAME);
   ret = nfs_request(nmp, NFSPROC_RENAME,
                     &nmp->nm_msgbuffer.renamef, reqlen,
@@ -2915,10 +3467,13 @@ static int nfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
                     FAR struct stat *buf)
 {
   FAR struct nfsmount *nmp;
+#ifdef NFS_ATTRCACHE
+  FAR struct nfs_fattr *fattr;
+#endif
   struct file_handle fhandle;
   struct nfs_fattr attributes;
   struct timespec ts;
-  int ret;
+  int ret = OK;
 
   /* Sanity checks */
 
@@ -2939,11 +3494,25 @@ static int nfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Get the file handle attributes of the requested node */
 
-  ret = nfs_findnode(nmp, relpath, &fhandle, &attributes, NULL);
-  if (ret != OK)
+#ifdef NFS_ATTRCACHE
+  fattr = nfs_attrcache_get(nmp, relpath);
+  if (fattr != NULL)
     {
-      ferr("ERROR: nfs_findnode failed: %d\n", ret);
-      goto errout_with_lock;
+      memcpy(&attributes, fattr, sizeof(attributes));
+    }
+  else
+#endif
+    {
+      ret = nfs_findnode(nmp, relpath, &fhandle, &attributes, NULL);
+      if (ret != OK)
+        {
+          ferr("ERROR: nfs_findnode failed: %d\n", ret);
+          goto errout_with_lock;
+        }
+
+#ifdef NFS_ATTRCACHE
+      nfs_attrcache_put(nmp, relpath, &attributes);
+#endif
     }
 
   /* Extract the file mode, file type, and file size. */
@@ -316,6 +316,12 @@ struct rpc_call_readdir
   struct READDIR3args readdir;
 };
 
+struct rpc_call_readdirplus
+{
+  struct rpc_call_header ch;
+  struct READDIRPLUS3args readdirplus;
+};
+
 struct rpc_call_setattr
 {
   struct rpc_call_header ch;
@@ -471,5 +477,10 @@ void rpcclnt_disconnect(FAR struct rpcclnt *rpc);
 int  rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
                      int version, FAR void *request, size_t reqlen,
                      FAR void *response, size_t resplen);
+int  rpcclnt_send_call(FAR struct rpcclnt *rpc, uint32_t xid, int procnum,
+                       int prog, int version, FAR void *request,
+                       size_t reqlen);
+int  rpcclnt_recv_reply(FAR struct rpcclnt *rpc, FAR uint32_t *xid,
+                        FAR void *response, size_t resplen);
 
 #endif /* __FS_NFS_RPC_H */
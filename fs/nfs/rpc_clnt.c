@@ -150,6 +150,7 @@ static int rpcclnt_reply(FAR struct rpcclnt *rpc, uint32_t xid,
                          FAR void *reply, size_t resplen);
 static void rpcclnt_fmtheader(FAR struct rpc_call_header *ch,
                               uint32_t xid, int procid, int prog, int vers);
+static int rpcclnt_status(FAR struct rpc_reply_header *replymsg);
 
 /****************************************************************************
  * Private Functions
@@ -501,6 +502,38 @@ static void rpcclnt_fmtheader(FAR struct rpc_call_header *ch,
   ch->rpc_verf.authlen   = 0;
 }
 
+/****************************************************************************
+ * Name: rpcclnt_status
+ *
+ * Description:
+ *   Verify the RPC level of a returned reply.
+ *
+ ****************************************************************************/
+
+static int rpcclnt_status(FAR struct rpc_reply_header *replymsg)
+{
+  uint32_t tmp;
+
+  tmp = fxdr_unsigned(uint32_t, replymsg->type);
+  if (tmp != RPC_MSGACCEPTED)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  tmp = fxdr_unsigned(uint32_t, replymsg->status);
+  if (tmp == RPC_SUCCESS)
+    {
+      finfo("RPC_SUCCESS\n");
+    }
+  else
+    {
+      ferr("ERROR: Unsupported RPC type: %" PRId32 "\n", tmp);
+      return -EOPNOTSUPP;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -763,8 +796,6 @@ int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
                     int version, FAR void *request, size_t reqlen,
                     FAR void *response, size_t resplen)
 {
-  FAR struct rpc_reply_header *replymsg;
-  uint32_t tmp;
   uint32_t xid;
   int retries = 0;
   int error = 0;
@@ -840,24 +871,69 @@ int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
 
   /* Break down the RPC header and check if it is OK */
 
-  replymsg = (FAR struct rpc_reply_header *)response;
+  return rpcclnt_status((FAR struct rpc_reply_header *)response);
+}
 
-  tmp = fxdr_unsigned(uint32_t, replymsg->type);
-  if (tmp != RPC_MSGACCEPTED)
-    {
-      return -EOPNOTSUPP;
-    }
+/****************************************************************************
+ * Name: rpcclnt_send_call
+ *
+ * Description:
+ *   Format the RPC CALL message with the transaction ID 'xid' and send it
+ *   without waiting for the reply.  This lets the caller have several calls
+ *   outstanding and collect the replies with rpcclnt_recv_reply().  A call
+ *   is re-sent with the same 'xid', so that the server can recognize the
+ *   retransmission.
+ *
+ * Returned Value:
+ *   Returns zero on success or a (negative) errno value on failure.
+ *
+ ****************************************************************************/
 
-  tmp = fxdr_unsigned(uint32_t, replymsg->status);
-  if (tmp == RPC_SUCCESS)
+int rpcclnt_send_call(FAR struct rpcclnt *rpc, uint32_t xid, int procnum,
+                      int prog, int version, FAR void *request,
+                      size_t reqlen)
+{
+  rpcclnt_fmtheader((FAR struct rpc_call_header *)request,
+                    xid, prog, version, procnum);
+
+  rpc_statistics(rpcrequests);
+  return rpcclnt_send(rpc, request, reqlen + sizeof(struct rpc_call_header));
+}
+
+/****************************************************************************
+ * Name: rpcclnt_recv_reply
+ *
+ * Description:
+ *   Receive the next RPC reply, whatever call it belongs to, and return the
+ *   transaction ID of that call in 'xid'.  The RPC level of the returned
+ *   values is verified as by rpcclnt_request().
+ *
+ * Returned Value:
+ *   Returns zero on success or a (negative) errno value on failure.
+ *   -EAGAIN or -ETIMEDOUT are returned if no reply came in time.
+ *
+ ****************************************************************************/
+
+int rpcclnt_recv_reply(FAR struct rpcclnt *rpc, FAR uint32_t *xid,
+                       FAR void *response, size_t resplen)
+{
+  FAR struct rpc_reply_header *replymsg = response;
+  int error;
+
+  error = rpcclnt_receive(rpc, response, resplen);
+  if (error != OK)
     {
-      finfo("RPC_SUCCESS\n");
+      ferr("ERROR: rpcclnt_receive returned: %d\n", error);
+      return error;
     }
-  else
+
+  if (replymsg->rp_direction != rpc_reply)
     {
-      ferr("ERROR: Unsupported RPC type: %" PRId32 "\n", tmp);
-      return -EOPNOTSUPP;
+      ferr("ERROR: Different RPC REPLY returned\n");
+      rpc_statistics(rpcinvalid);
+      return -EPROTO;
     }
 
-  return OK;
+  *xid = fxdr_unsigned(uint32_t, replymsg->rp_xid);
+  return rpcclnt_status(replymsg);
 }
@@ -23,9 +23,11 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/lib/lib.h>
 
@@ -62,13 +64,17 @@ struct inotify_device_s
   int                count;       /* Reference count */
   uint32_t           event_size;  /* Size of the queue (bytes) */
   uint32_t           event_count; /* Number of pending events */
+#if CONFIG_FS_NOTIFY_WAKEUP_DELAY > 0
+  struct work_s      work;        /* Delayed wakeup of the readers */
+#endif
   FAR struct pollfd *fds[CONFIG_FS_NOTIFY_FD_POLLWAITERS];
 };
 
 struct inotify_event_s
 {
-  struct list_node     node;     /* Entry in inotify_device's list */
-  struct inotify_event event;    /* The user-space event */
+  struct list_node            node;  /* Entry in inotify_device's list */
+  FAR struct inotify_watch_s *watch; /* The watch if its last event */
+  struct inotify_event        event; /* The user-space event */
 };
 
 struct inotify_watch_list_s
@@ -85,6 +91,7 @@ struct inotify_watch_s
   uint32_t                         mask;    /* Event mask for this watch */
   FAR struct inotify_device_s     *dev;     /* Associated device */
   FAR struct inotify_watch_list_s *list;    /* Associated watch list */
+  FAR struct inotify_event_s      *last;    /* Last pending event */
 };
 
 struct inotify_global_s
@@ -217,6 +224,7 @@ inotify_alloc_event(int wd, uint32_t mask, uint32_t cookie,
       return NULL;
     }
 
+  event->watch        = NULL;
   event->event.wd     = wd;
   event->event.mask   = mask;
   event->event.cookie = cookie;
@@ -230,21 +238,91 @@ inotify_alloc_event(int wd, uint32_t mask, uint32_t cookie,
   return event;
 }
 
+/****************************************************************************
+ * Name: inotify_event_match
+ *
+ * Description:
+ *   Check if a queued event is the same as a new one.
+ *
+ ****************************************************************************/
+
+static bool inotify_event_match(FAR struct inotify_event_s *event, int wd,
+                                uint32_t mask, uint32_t cookie,
+                                FAR const char *name)
+{
+  return event->event.mask == mask && event->event.wd == wd &&
+         event->event.cookie == cookie &&
+         ((name == NULL && event->event.len == 0) ||
+          (name && event->event.len && !strcmp(name, event->event.name)));
+}
+
+/****************************************************************************
+ * Name: inotify_wakeup
+ *
+ * Description:
+ *   Wake up the readers and pollers of the inotify device.
+ *
+ ****************************************************************************/
+
+static void inotify_wakeup(FAR struct inotify_device_s *dev)
+{
+  int semcnt;
+
+  poll_notify(dev->fds, CONFIG_FS_NOTIFY_FD_POLLWAITERS, POLLIN);
+
+  while (nxsem_get_value(&dev->sem, &semcnt) == 0 && semcnt <= 1)
+    {
+      nxsem_post(&dev->sem);
+    }
+}
+
+/****************************************************************************
+ * Name: inotify_wakeup_work
+ *
+ * Description:
+ *   Wake up the readers once the wakeup delay after the first of a batch of
+ *   events expired.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_NOTIFY_WAKEUP_DELAY > 0
+static void inotify_wakeup_work(FAR void *arg)
+{
+  FAR struct inotify_device_s *dev = arg;
+
+  nxmutex_lock(&dev->lock);
+  if (!list_is_empty(&dev->events))
+    {
+      inotify_wakeup(dev);
+    }
+
+  nxmutex_unlock(&dev->lock);
+}
+#endif
+
 /****************************************************************************
  * Name: inotify_queue_event
  *
  * Description:
- *   Queue an event to the inotify device.
+ *   Queue an event to the inotify device.  An event that is the same as
+ *   the last pending event of its watch is dropped, even if events of other
+ *   watches were queued in between.
  *
  ****************************************************************************/
 
-static void inotify_queue_event(FAR struct inotify_device_s *dev, int wd,
+static void inotify_queue_event(FAR struct inotify_device_s *dev,
+                                FAR struct inotify_watch_s *watch, int wd,
                                 uint32_t mask, uint32_t cookie,
                                 FAR const char *name)
 {
   FAR struct inotify_event_s *event;
   FAR struct inotify_event_s *last;
-  int semcnt;
+
+  if (watch != NULL && watch->last != NULL &&
+      inotify_event_match(watch->last, wd, mask, cookie, name))
+    {
+      return;
+    }
 
   if (!list_is_empty(&dev->events))
     {
@@ -252,10 +330,7 @@ static void inotify_queue_event(FAR struct inotify_device_s *dev, int wd,
 
       last = list_last_entry(&dev->events,
                              struct inotify_event_s, node);
-      if (last->event.mask == mask && last->event.wd == wd &&
-          last->event.cookie == cookie &&
-          ((name == NULL && last->event.len == 0) ||
-           (name && last->event.len && !strcmp(name, last->event.name))))
+      if (inotify_event_match(last, wd, mask, cookie, name))
         {
           return;
         }
@@ -285,12 +360,35 @@ static void inotify_queue_event(FAR struct inotify_device_s *dev, int wd,
   dev->event_size += sizeof(struct inotify_event) + event->event.len;
   list_add_tail(&dev->events, &event->node);
 
-  poll_notify(dev->fds, CONFIG_FS_NOTIFY_FD_POLLWAITERS, POLLIN);
+  /* Remember the last event of the watch, unless it is the overflow */
 
-  while (nxsem_get_value(&dev->sem, &semcnt) == 0 && semcnt <= 1)
+  if (watch != NULL && event->event.wd == wd)
     {
-      nxsem_post(&dev->sem);
+      if (watch->last != NULL)
+        {
+          watch->last->watch = NULL;
+        }
+
+      watch->last  = event;
+      event->watch = watch;
+    }
+
+#if CONFIG_FS_NOTIFY_WAKEUP_DELAY > 0
+  /* Wake up the readers once per batch, but right away on an overflow */
+
+  if (event->event.mask == IN_Q_OVERFLOW)
+    {
+      work_cancel(LPWORK, &dev->work);
+      inotify_wakeup(dev);
+    }
+  else if (work_available(&dev->work))
+    {
+      work_queue(LPWORK, &dev->work, inotify_wakeup_work, dev,
+                 MSEC2TICK(CONFIG_FS_NOTIFY_WAKEUP_DELAY));
     }
+#else
+  inotify_wakeup(dev);
+#endif
 }
 
 /****************************************************************************
@@ -309,6 +407,11 @@ inotify_remove_watch_no_event(FAR struct inotify_watch_s *watch)
   list_delete(&watch->d_node);
   list_delete(&watch->l_node);
   inotify_sub_count(watch->mask);
+  if (watch->last != NULL)
+    {
+      watch->last->watch = NULL;
+    }
+
   fs_heap_free(watch);
 
   if (list_is_empty(&list->watches))
@@ -330,7 +433,7 @@ inotify_remove_watch_no_event(FAR struct inotify_watch_s *watch)
 static void inotify_remove_watch(FAR struct inotify_device_s *dev,
                                  FAR struct inotify_watch_s *watch)
 {
-  inotify_queue_event(dev, watch->wd, IN_IGNORED, 0, NULL);
+  inotify_queue_event(dev, NULL, watch->wd, IN_IGNORED, 0, NULL);
   inotify_remove_watch_no_event(watch);
 }
 
@@ -346,6 +449,11 @@ static void inotify_remove_event(FAR struct inotify_device_s *dev,
                                  FAR struct inotify_event_s *event)
 {
   list_delete(&event->node);
+  if (event->watch != NULL)
+    {
+      event->watch->last = NULL;
+    }
+
   dev->event_size -= sizeof(struct inotify_event) + event->event.len;
   dev->event_count--;
   fs_heap_free(event);
@@ -436,7 +544,13 @@ static int inotify_poll(FAR struct file *filep, FAR struct pollfd *fds,
       goto out;
     }
 
-  if (!list_is_empty(&dev->events))
+  /* Pending events are reported when their batch is complete */
+
+  if (!list_is_empty(&dev->events)
+#if CONFIG_FS_NOTIFY_WAKEUP_DELAY > 0
+      && work_available(&dev->work)
+#endif
+     )
     {
       poll_notify(dev->fds, CONFIG_FS_NOTIFY_FD_POLLWAITERS, POLLIN);
     }
@@ -583,6 +697,9 @@ static int inotify_close(FAR struct file *filep)
 
   nxmutex_unlock(&dev->lock);
   nxmutex_unlock(&g_inotify.lock);
+#if CONFIG_FS_NOTIFY_WAKEUP_DELAY > 0
+  work_cancel_sync(LPWORK, &dev->work);
+#endif
   nxmutex_destroy(&dev->lock);
   nxsem_destroy(&dev->sem);
   fs_heap_free(dev);
@@ -815,7 +932,7 @@ inotify_queue_watch_list_event(FAR struct inotify_watch_list_s *list,
           bool last_iteration = list_is_singular(&list->watches);
 
           nxmutex_lock(&dev->lock);
-          inotify_queue_event(dev, watch->wd, mask, cookie, name);
+          inotify_queue_event(dev, watch, watch->wd, mask, cookie, name);
           if (watch_mask & IN_ONESHOT)
             {
               inotify_remove_watch(dev, watch);
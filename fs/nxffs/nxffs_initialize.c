@@ -122,6 +122,128 @@ const uint8_t g_datamagic[NXFFS_MAGICSIZE] =
 struct nxffs_volume_s g_volume;
 #endif
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_usedblock
+ *
+ * Description:
+ *   Find the first good block in the range from 'block' up to 'end' and
+ *   tell if it holds data.  Every block that holds data begins with an
+ *   inode or a data block header, all blocks after the last inode are
+ *   erased after their block header.
+ *
+ * Returned Value:
+ *   One if the block holds data, zero if it is erased, -ENOSPC if there is
+ *   no good block in the range.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_FAST_MOUNT
+static int nxffs_usedblock(FAR struct nxffs_volume_s *volume,
+                           FAR off_t *block, off_t end)
+{
+  for (; *block < end; (*block)++)
+    {
+      if (nxffs_verifyblock(volume, *block) == OK)
+        {
+          return volume->cache[SIZEOF_NXFFS_BLOCK_HDR] !=
+                 CONFIG_NXFFS_ERASEDSTATE;
+        }
+    }
+
+  return -ENOSPC;
+}
+
+/****************************************************************************
+ * Name: nxffs_lastentry
+ *
+ * Description:
+ *   Skip ahead to an inode in the last blocks that hold data instead of
+ *   walking through all inodes from the first one.  The last block that
+ *   holds data is found with a binary search, then the blocks are searched
+ *   backwards from there for an inode header.
+ *
+ * Input Parameters:
+ *   volume - Identifies the NXFFS volume
+ *   first  - The block of the first inode
+ *   offset - The offset after the first inode.  Updated to the offset
+ *            after the inode that was found.
+ *
+ * Returned Value:
+ *   Zero on success. Otherwise, a negated error is returned indicating the
+ *   nature of the failure.
+ *
+ ****************************************************************************/
+
+static int nxffs_lastentry(FAR struct nxffs_volume_s *volume, off_t first,
+                           FAR off_t *offset)
+{
+  FAR const uint8_t *magic;
+  struct nxffs_entry_s entry;
+  off_t block;
+  off_t lo = first;
+  off_t hi = volume->nblocks;
+  off_t mid;
+  int ret;
+
+  while (hi - lo > 1)
+    {
+      mid = lo + (hi - lo) / 2;
+      block = mid;
+      ret = nxffs_usedblock(volume, &block, hi);
+      if (ret > 0)
+        {
+          lo = block;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  for (block = lo; block > first; block--)
+    {
+      if (nxffs_verifyblock(volume, block) != OK)
+        {
+          continue;
+        }
+
+      /* Inode headers never cross a block boundary.  Only the blocks with
+       * an inode magic are searched, as the search does not stop at the
+       * end of the block.
+       */
+
+      magic = memmem(&volume->cache[SIZEOF_NXFFS_BLOCK_HDR],
+                     volume->geo.blocksize - SIZEOF_NXFFS_BLOCK_HDR,
+                     g_inodemagic, NXFFS_MAGICSIZE);
+      if (magic == NULL)
+        {
+          continue;
+        }
+
+      ret = nxffs_nextentry(volume, block * volume->geo.blocksize +
+                            (magic - volume->cache), &entry);
+      if (ret == OK)
+        {
+          *offset = nxffs_inodeend(volume, &entry);
+          nxffs_freeentry(&entry);
+          finfo("Resume the inode search at offset %jd\n",
+                (intmax_t)*offset);
+          return OK;
+        }
+      else if (ret != -ENOENT)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -402,6 +524,16 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
 
   if (!noinodes)
     {
+#ifdef CONFIG_NXFFS_FAST_MOUNT
+      ret = nxffs_lastentry(volume, volume->inoffset / volume->geo.blocksize,
+                            &offset);
+      if (ret < 0)
+        {
+          ferr("ERROR: nxffs_lastentry failed: %d\n", -ret);
+          return ret;
+        }
+#endif
+
       while (nxffs_nextentry(volume, offset, &entry) == OK)
         {
           /* Discard the entry and guess the next offset. */
@@ -59,6 +59,8 @@ extern const struct procfs_operations g_cpuinfo_operations;
 extern const struct procfs_operations g_cpuload_operations;
 extern const struct procfs_operations g_cpufreq_operations;
 extern const struct procfs_operations g_critmon_operations;
+extern const struct procfs_operations g_critmon_hist_operations;
+extern const struct procfs_operations g_csection_operations;
 extern const struct procfs_operations g_fdt_operations;
 extern const struct procfs_operations g_iobinfo_operations;
 extern const struct procfs_operations g_irq_operations;
@@ -67,11 +69,15 @@ extern const struct procfs_operations g_memdump_operations;
 extern const struct procfs_operations g_mempool_operations;
 extern const struct procfs_operations g_module_operations;
 extern const struct procfs_operations g_pm_operations;
+extern const struct procfs_operations g_profile_operations;
 extern const struct procfs_operations g_proc_operations;
+extern const struct procfs_operations g_stats_operations;
 extern const struct procfs_operations g_tcbinfo_operations;
 extern const struct procfs_operations g_thermal_operations;
 extern const struct procfs_operations g_uptime_operations;
 extern const struct procfs_operations g_version_operations;
+extern const struct procfs_operations g_wakeup_operations;
+extern const struct procfs_operations g_wqueue_operations;
 extern const struct procfs_operations g_pressure_operations;
 
 /* This is not good.  These are implemented in other sub-systems.  Having to
@@ -122,6 +128,13 @@ static const struct procfs_entry_s g_procfs_entries[] =
 
 #ifdef CONFIG_SCHED_CRITMONITOR
   { "critmon",      &g_critmon_operations,  PROCFS_FILE_TYPE   },
+#  ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  { "critmon_hist", &g_critmon_hist_operations, PROCFS_FILE_TYPE },
+#  endif
+#endif
+
+#ifdef CONFIG_SCHED_CSECTION_CALLERS
+  { "csection",     &g_csection_operations, PROCFS_FILE_TYPE   },
 #endif
 
 #if defined(CONFIG_DEVICE_TREE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_FDT)
@@ -190,11 +203,19 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "pressure/**",  &g_pressure_operations, PROCFS_FILE_TYPE   },
 #endif
 
+#ifdef CONFIG_SCHED_LATENCY_MONITOR
+  { "profile",      &g_profile_operations,  PROCFS_FILE_TYPE   },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_PROCESS
   { "self",         &g_proc_operations,     PROCFS_DIR_TYPE    },
   { "self/**",      &g_proc_operations,     PROCFS_UNKOWN_TYPE },
 #endif
 
+#ifdef CONFIG_FS_PROCFS_INCLUDE_STATS
+  { "stats",        &g_stats_operations,    PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_ARCH_HAVE_TCBINFO) && !defined(CONFIG_FS_PROCFS_EXCLUDE_TCBINFO)
   { "tcbinfo",      &g_tcbinfo_operations,  PROCFS_FILE_TYPE   },
 #endif
@@ -211,6 +232,14 @@ static const struct procfs_entry_s g_procfs_entries[] =
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_VERSION
   { "version",      &g_version_operations,  PROCFS_FILE_TYPE   },
 #endif
+
+#ifdef CONFIG_SCHED_WAKEUP_LATENCY
+  { "wakeup",       &g_wakeup_operations,   PROCFS_FILE_TYPE   },
+#endif
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  { "wqueue",       &g_wqueue_operations,   PROCFS_FILE_TYPE   },
+#endif
 };
 
 #ifdef CONFIG_FS_PROCFS_REGISTER
@@ -59,6 +59,22 @@
 
 #define CRITMON_LINELEN 64
 
+/* Output format of "critmon_hist":
+ *
+ *   CPU TYPE               NS      COUNT
+ *   DDD SSSSSSSS  DDDDDDDDDDD DDDDDDDDDD
+ *   CPU TYPE     CALLER                    NS
+ *   DDD SSSSSSSS 0xXXXXXXXX       DDDDDDDDDDD
+ *
+ * NS is the upper bound of the bucket or the longest hold of the call
+ * site in nanoseconds.
+ */
+
+#define HIST_HDR_FMT    "CPU TYPE               NS      COUNT\n"
+#define HIST_BUCKET_FMT "%3d %-8s %12llu %10lu\n"
+#define HIST_TOP_FMT    "CPU TYPE     CALLER                    NS\n"
+#define HIST_HOLDER_FMT "%3d %-8s %-16p %12llu\n"
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -86,6 +102,27 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
 static int     critmon_dup(FAR const struct file *oldp,
                  FAR struct file *newp);
 static int     critmon_stat(FAR const char *relpath, FAR struct stat *buf);
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+static ssize_t critmon_hist_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t critmon_hist_write(FAR struct file *filep,
+                 FAR const char *buffer, size_t buflen);
+static int     critmon_hist_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+static FAR const char * const g_critmon_type[CRITMON_NTYPES] =
+{
+  "preempt",
+  "csection",
+  "irq"
+};
+#endif
 
 /****************************************************************************
  * Public Data
@@ -114,6 +151,26 @@ const struct procfs_operations g_critmon_operations =
   critmon_stat        /* stat */
 };
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+const struct procfs_operations g_critmon_hist_operations =
+{
+  critmon_open,       /* open */
+  critmon_close,      /* close */
+  critmon_hist_read,  /* read */
+  critmon_hist_write, /* write */
+  NULL,               /* poll */
+
+  critmon_dup,        /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  critmon_hist_stat   /* stat */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -135,7 +192,8 @@ static int critmon_open(FAR struct file *filep, FAR const char *relpath,
    * REVISIT:  Write-able proc files could be quite useful.
    */
 
-  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+  if (((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) &&
+      strcmp(relpath, "critmon_hist") != 0)
     {
       ferr("ERROR: Only O_RDONLY supported\n");
       return -EACCES;
@@ -384,6 +442,145 @@ static int critmon_stat(const char *relpath, struct stat *buf)
   return OK;
 }
 
+/****************************************************************************
+ * Name: critmon_hist_read
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+static ssize_t critmon_hist_read(FAR struct file *filep, FAR char *buffer,
+                                 size_t buflen)
+{
+  FAR struct critmon_file_s *attr;
+  FAR struct critmon_hist_s *hist;
+  FAR struct critmon_holder_s *holder;
+  struct timespec ts;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int type;
+  int cpu;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct critmon_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset = filep->f_pos;
+
+  /* First the non-empty buckets of each CPU and kind of hold */
+
+  linesize  = procfs_snprintf(attr->line, CRITMON_LINELEN, HIST_HDR_FMT);
+  copysize  = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+  totalsize = copysize;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      for (type = 0; type < CRITMON_NTYPES; type++)
+        {
+          hist = &g_critmon_hist[cpu][type];
+          for (i = 0; i < CRITMON_NBUCKETS && totalsize < buflen; i++)
+            {
+              if (hist->bucket[i] == 0)
+                {
+                  continue;
+                }
+
+              perf_convert((clock_t)1 << i, &ts);
+
+              linesize   = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                                           HIST_BUCKET_FMT, cpu,
+                                           g_critmon_type[type],
+                                           (unsigned long long)ts.tv_sec *
+                                           NSEC_PER_SEC + ts.tv_nsec,
+                                           (unsigned long)hist->bucket[i]);
+              copysize   = procfs_memcpy(attr->line, linesize,
+                                         buffer + totalsize,
+                                         buflen - totalsize, &offset);
+              totalsize += copysize;
+            }
+        }
+    }
+
+  /* Then the call sites of the longest holds */
+
+  if (totalsize < buflen)
+    {
+      linesize   = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                                   HIST_TOP_FMT);
+      copysize   = procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                                 buflen - totalsize, &offset);
+      totalsize += copysize;
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      for (type = 0; type < CRITMON_NTYPES; type++)
+        {
+          hist = &g_critmon_hist[cpu][type];
+          for (i = 0; i < CONFIG_SCHED_CRITMONITOR_TOPN &&
+                      totalsize < buflen; i++)
+            {
+              holder = &hist->top[i];
+              if (holder->elapsed == 0)
+                {
+                  continue;
+                }
+
+              perf_convert(holder->elapsed, &ts);
+
+              linesize   = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                                           HIST_HOLDER_FMT, cpu,
+                                           g_critmon_type[type],
+                                           holder->caller,
+                                           (unsigned long long)ts.tv_sec *
+                                           NSEC_PER_SEC + ts.tv_nsec);
+              copysize   = procfs_memcpy(attr->line, linesize,
+                                         buffer + totalsize,
+                                         buflen - totalsize, &offset);
+              totalsize += copysize;
+            }
+        }
+    }
+
+  /* Update the file position */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: critmon_hist_write
+ *
+ * Description:
+ *   Any write clears the histograms and the longest holds.
+ *
+ ****************************************************************************/
+
+static ssize_t critmon_hist_write(FAR struct file *filep,
+                                  FAR const char *buffer, size_t buflen)
+{
+  memset(g_critmon_hist, 0, sizeof(g_critmon_hist));
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: critmon_hist_stat
+ ****************************************************************************/
+
+static int critmon_hist_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "critmon_hist" is the name for a read/write file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+#endif /* CONFIG_SCHED_CRITMONITOR_HISTOGRAM */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -81,6 +81,8 @@ static int     iobinfo_open(FAR struct file *filep, FAR const char *relpath,
 static int     iobinfo_close(FAR struct file *filep);
 static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
+static ssize_t iobinfo_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
 static int     iobinfo_dup(FAR const struct file *oldp,
                  FAR struct file *newp);
 static int     iobinfo_stat(FAR const char *relpath, FAR struct stat *buf);
@@ -99,7 +101,7 @@ const struct procfs_operations g_iobinfo_operations =
   iobinfo_open,   /* open */
   iobinfo_close,  /* close */
   iobinfo_read,   /* read */
-  NULL,           /* write */
+  iobinfo_write,  /* write */
   NULL,           /* poll */
   iobinfo_dup,    /* dup */
   NULL,           /* opendir */
@@ -124,18 +126,6 @@ static int iobinfo_open(FAR struct file *filep, FAR const char *relpath,
 
   finfo("Open '%s'\n", relpath);
 
-  /* PROCFS is read-only.  Any attempt to open with any kind of write
-   * access is not permitted.
-   *
-   * REVISIT:  Write-able proc files could be quite useful.
-   */
-
-  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
-    {
-      ferr("ERROR: Only O_RDONLY supported\n");
-      return -EACCES;
-    }
-
   /* Allocate a container to hold the file attributes */
 
   procfile = (FAR struct iobinfo_file_s *)
@@ -199,8 +189,9 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
   /* The first line is the headers */
 
   linesize  = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
-                              "%10s%10s%10s%10s\n",
-                              "ntotal", "nfree", "nwait", "nthrottle");
+                              "%10s%10s%10s%10s%10s\n",
+                              "ntotal", "nfree", "nwait", "nthrottle",
+                              "npeak");
 
   copysize  = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
                             &offset);
@@ -213,20 +204,62 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
 
   iob_getstats(&stats);
   linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
-                               "%10d%10d%10d%10d\n",
+                               "%10d%10d%10d%10d%10d\n",
                                stats.ntotal, stats.nfree,
-                               stats.nwait, stats.nthrottle);
+                               stats.nwait, stats.nthrottle,
+                               stats.npeak);
 
   copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
                              &offset);
   totalsize += copysize;
 
+#if CONFIG_IOB_PCPU_CACHE > 0
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  /* Followed by the per-CPU cache statistics */
+
+  linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                               "%10s%10s%10s\n",
+                               "ncached", "nhits", "nmisses");
+
+  copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                               "%10d%10lu%10lu\n",
+                               stats.ncached, stats.nhits, stats.nmisses);
+
+  copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+#endif
+
   /* Update the file offset */
 
   filep->f_pos += totalsize;
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: iobinfo_write
+ *
+ * Description:
+ *   Any write restarts the high-water mark of the IOB usage.
+ *
+ ****************************************************************************/
+
+static ssize_t iobinfo_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  iob_resetstats();
+  return buflen;
+}
+
 /****************************************************************************
  * Name: iobinfo_dup
  *
@@ -276,10 +309,10 @@ static int iobinfo_dup(FAR const struct file *oldp, FAR struct file *newp)
 
 static int iobinfo_stat(FAR const char *relpath, FAR struct stat *buf)
 {
-  /* "iobinfo" is the name for a read-only file */
+  /* "iobinfo" is readable, writing it resets the high-water mark */
 
   memset(buf, 0, sizeof(struct stat));
-  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
   return OK;
 }
 
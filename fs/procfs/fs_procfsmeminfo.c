@@ -38,6 +38,7 @@
 #include <debug.h>
 #include <ctype.h>
 
+#include <nuttx/dmaalloc.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/pgalloc.h>
 #include <nuttx/progmem.h>
@@ -71,6 +72,9 @@ struct meminfo_file_s
   struct procfs_file_s base;      /* Base open file structure */
   unsigned int linesize;          /* Number of valid characters in line[] */
   char line[MEMINFO_LINELEN];     /* Pre-allocated buffer for formatted lines */
+#ifdef CONFIG_FS_PROCFS_SNAPSHOT
+  struct procfs_snapshot_s snapshot; /* Content for a sequence of reads */
+#endif
 };
 
 #if defined(CONFIG_ARCH_HAVE_PROGMEM) && defined(CONFIG_FS_PROCFS_INCLUDE_PROGMEM)
@@ -85,6 +89,20 @@ struct progmem_info_s
 };
 #endif
 
+#ifdef CONFIG_MM_HEAP_TASKPEAK
+/* The read state handed to meminfo_taskpeak() */
+
+struct meminfo_taskpeak_s
+{
+  FAR struct meminfo_file_s *procfile;
+  FAR char *buffer;
+  size_t buflen;
+  size_t copysize;
+  size_t totalsize;
+  FAR off_t *offset;
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -92,6 +110,11 @@ struct progmem_info_s
 #if defined(CONFIG_ARCH_HAVE_PROGMEM) && defined(CONFIG_FS_PROCFS_INCLUDE_PROGMEM)
 static void    meminfo_progmem(FAR struct progmem_info_s *progmem);
 #endif
+#ifdef CONFIG_MM_HEAP_TASKPEAK
+static void    meminfo_taskpeak(FAR struct tcb_s *tcb, FAR void *arg);
+#endif
+static ssize_t meminfo_render(FAR void *arg, FAR char *buffer,
+                 size_t buflen, off_t offset);
 
 /* File system methods */
 
@@ -223,6 +246,40 @@ static void meminfo_progmem(FAR struct progmem_info_s *progmem)
 }
 #endif
 
+/****************************************************************************
+ * Name: meminfo_taskpeak
+ *
+ * Description:
+ *   Show the current and the peak heap usage of one thread
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_TASKPEAK
+static void meminfo_taskpeak(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct meminfo_taskpeak_s *state = arg;
+  size_t linesize;
+
+  if (state->buflen == 0)
+    {
+      return;
+    }
+
+  state->buffer += state->copysize;
+  state->buflen -= state->copysize;
+
+  linesize = procfs_snprintf(state->procfile->line, MEMINFO_LINELEN,
+                             "%6d%11lu%11lu %s\n", tcb->pid,
+                             (unsigned long)tcb->heap_used,
+                             (unsigned long)tcb->heap_peak,
+                             get_task_name(tcb));
+  state->copysize   = procfs_memcpy(state->procfile->line, linesize,
+                                    state->buffer, state->buflen,
+                                    state->offset);
+  state->totalsize += state->copysize;
+}
+#endif
+
 /****************************************************************************
  * Name: meminfo_open
  ****************************************************************************/
@@ -264,33 +321,29 @@ static int meminfo_close(FAR struct file *filep)
 
   /* Release the file attributes structure */
 
+#ifdef CONFIG_FS_PROCFS_SNAPSHOT
+  procfs_snapshot_free(&procfile->snapshot);
+#endif
   fs_heap_free(procfile);
   filep->f_priv = NULL;
   return OK;
 }
 
 /****************************************************************************
- * Name: meminfo_read
+ * Name: meminfo_render
+ *
+ * Description:
+ *   Generate the content of meminfo from 'offset' on.
+ *
  ****************************************************************************/
 
-static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
-                            size_t buflen)
+static ssize_t meminfo_render(FAR void *arg, FAR char *buffer,
+                              size_t buflen, off_t offset)
 {
-  FAR struct meminfo_file_s *procfile;
+  FAR struct meminfo_file_s *procfile = arg;
   size_t linesize;
   size_t copysize;
   size_t totalsize;
-  off_t offset;
-
-  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
-
-  DEBUGASSERT(buffer != NULL && buflen > 0);
-  offset = filep->f_pos;
-
-  /* Recover our private data from the struct file instance */
-
-  procfile = (FAR struct meminfo_file_s *)filep->f_priv;
-  DEBUGASSERT(procfile);
 
   /* The first line is the headers */
 
@@ -343,6 +396,218 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
+#ifdef CONFIG_MM_HEAP_TCACHE
+  /* Followed by the hit rate of the small chunk cache of each heap */
+
+  if (buflen > 0)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%11s%11s%7s%s\n",
+                                   "tchits", "tcmisses", "hit%", " name");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+    {
+      if (buflen > 0)
+        {
+          struct mm_tcacheinfo_s tcinfo;
+          uint64_t total;
+
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          mm_tcache_info(entry->heap, &tcinfo);
+
+          total      = (uint64_t)tcinfo.hits + tcinfo.misses;
+          linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                       "%11lu%11lu%6lu%% %s\n",
+                                       (unsigned long)tcinfo.hits,
+                                       (unsigned long)tcinfo.misses,
+                                       total == 0 ? 0ul : (unsigned long)
+                                       ((uint64_t)tcinfo.hits * 100 /
+                                        total),
+                                       entry->name);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+    }
+#endif
+
+#ifdef CONFIG_MM_FREE_DELAYLIST_STATS
+  /* Followed by the delay list of each heap */
+
+  if (buflen > 0)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%9s%9s%11s%11s%9s%9s%s\n",
+                                   "dldepth", "dlmax", "dldrains",
+                                   "dlfreed", "dlmaxus", "dlavgus",
+                                   " name");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+    {
+      if (buflen > 0)
+        {
+          struct mm_delayinfo_s dlinfo;
+
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          mm_delaylist_info(entry->heap, &dlinfo);
+          linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                       "%9lu%9lu%11lu%11lu%9lu%9lu %s\n",
+                                       dlinfo.depth, dlinfo.maxdepth,
+                                       dlinfo.ndrain, dlinfo.nfreed,
+                                       dlinfo.maxtime, dlinfo.avgtime,
+                                       entry->name);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+    }
+#endif
+
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+  /* Followed by the fragmentation of the free memory of each heap */
+
+  if (buflen > 0)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%6s%11s%8s%8s%8s%8s%8s%8s%8s%8s%s\n",
+                                   "frag%", "largest", "<64", "<256",
+                                   "<1K", "<4K", "<16K", "<64K", "<256K",
+                                   ">=256K", " name");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+    {
+      if (buflen > 0)
+        {
+          struct mm_fraginfo_s fginfo;
+
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          mm_fraginfo(entry->heap, &fginfo);
+          linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                       "%5u%%%11lu%8lu%8lu%8lu%8lu%8lu%8lu"
+                                       "%8lu%8lu %s\n", fginfo.index,
+                                       (unsigned long)fginfo.largest,
+                                       (unsigned long)fginfo.nfree[0],
+                                       (unsigned long)fginfo.nfree[1],
+                                       (unsigned long)fginfo.nfree[2],
+                                       (unsigned long)fginfo.nfree[3],
+                                       (unsigned long)fginfo.nfree[4],
+                                       (unsigned long)fginfo.nfree[5],
+                                       (unsigned long)fginfo.nfree[6],
+                                       (unsigned long)fginfo.nfree[7],
+                                       entry->name);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+    }
+#endif
+
+#ifdef CONFIG_MM_HEAP_TASKPEAK
+  /* Followed by the heap usage of each thread */
+
+  if (buflen > 0)
+    {
+      struct meminfo_taskpeak_s state;
+
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%6s%11s%11s%s\n",
+                                   "pid", "heapused", "heappeak", " name");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+
+      state.procfile  = procfile;
+      state.buffer    = buffer;
+      state.buflen    = buflen;
+      state.copysize  = copysize;
+      state.totalsize = totalsize;
+      state.offset    = &offset;
+
+      nxsched_foreach(meminfo_taskpeak, &state);
+
+      buffer    = state.buffer;
+      buflen    = state.buflen;
+      copysize  = state.copysize;
+      totalsize = state.totalsize;
+    }
+#endif
+
+#ifdef CONFIG_MM_TLSF_SUBPOOLS
+  /* Followed by the per-CPU pools of each heap */
+
+  if (buflen > 0)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%5s%11s%11s%11s%11s%11s%11s%s\n",
+                                   "pool", "total", "used", "maxused",
+                                   "nalloc", "nsteal", "nremote", " name");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+    {
+      int i;
+
+      for (i = 0; i < CONFIG_SMP_NCPUS && buflen > 0; i++)
+        {
+          struct mm_subpoolinfo_s spinfo;
+
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          mm_subpool_info(entry->heap, i, &spinfo);
+          linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                       "%5d%11lu%11lu%11lu%11lu%11lu%11lu"
+                                       " %s\n", i,
+                                       (unsigned long)spinfo.arena,
+                                       (unsigned long)spinfo.uordblks,
+                                       (unsigned long)spinfo.usmblks,
+                                       (unsigned long)spinfo.nalloc,
+                                       (unsigned long)spinfo.nsteal,
+                                       (unsigned long)spinfo.nremote,
+                                       entry->name);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+    }
+#endif
+
 #ifdef CONFIG_MM_PGALLOC
   if (buflen > 0)
     {
@@ -374,6 +639,31 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
     }
 #endif
 
+#ifdef CONFIG_MM_DMAALLOC
+  if (buflen > 0)
+    {
+      struct dmainfo_s dma_info;
+
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      /* Show DMA allocator information */
+
+      mm_dmainfo(&dma_info);
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%11lu%11lu%11lu%11lu %s\n",
+                                   (unsigned long)dma_info.total,
+                                   (unsigned long)(dma_info.total -
+                                                   dma_info.free),
+                                   (unsigned long)dma_info.free,
+                                   (unsigned long)dma_info.largest, "Dma");
+
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+
 #if defined(CONFIG_ARCH_HAVE_PROGMEM) && defined(CONFIG_FS_PROCFS_INCLUDE_PROGMEM)
   if (buflen > 0)
     {
@@ -401,10 +691,43 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
     }
 #endif
 
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: meminfo_read
+ ****************************************************************************/
+
+static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct meminfo_file_s *procfile;
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct meminfo_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+#ifdef CONFIG_FS_PROCFS_SNAPSHOT
+  ret = procfs_snapshot_read(&procfile->snapshot, meminfo_render, procfile,
+                             buffer, buflen, filep->f_pos);
+#else
+  ret = meminfo_render(procfile, buffer, buflen, filep->f_pos);
+#endif
+
   /* Update the file offset */
 
-  filep->f_pos += totalsize;
-  return totalsize;
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
 }
 
 /****************************************************************************
@@ -676,6 +999,9 @@ static int meminfo_dup(FAR const struct file *oldp, FAR struct file *newp)
   /* The copy the file attributes from the old attributes to the new */
 
   memcpy(newattr, oldattr, sizeof(struct meminfo_file_s));
+#ifdef CONFIG_FS_PROCFS_SNAPSHOT
+  memset(&newattr->snapshot, 0, sizeof(newattr->snapshot));
+#endif
 
   /* Save the new attributes in the new file structure */
 
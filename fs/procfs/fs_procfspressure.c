@@ -32,6 +32,7 @@
 #include <nuttx/fs/procfs.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/queue.h>
 #include <nuttx/spinlock.h>
@@ -175,6 +176,21 @@ static ssize_t pressure_read(FAR struct file *filep, FAR char *buffer,
   ret = procfs_snprintf(buf, sizeof(buf), "remaining %zu, largest:%zu\n",
                         remain, largest);
 
+#ifdef CONFIG_MM_RECLAIM
+  /* Followed by what the reclaim callbacks did about it */
+
+  if (ret < sizeof(buf))
+    {
+      struct mm_reclaiminfo_s info;
+
+      mm_reclaim_info(&info);
+      ret += procfs_snprintf(buf + ret, sizeof(buf) - ret,
+                             "reclaim async:%lu sync:%lu rescued:%lu "
+                             "released:%zu\n", info.nasync, info.nsync,
+                             info.nrescued, info.released);
+    }
+#endif
+
   if (ret > buflen)
     {
       return -ENOMEM;
@@ -422,6 +438,9 @@ void mm_notify_pressure(size_t remaining, size_t largest)
   FAR dq_entry_t *entry;
   FAR dq_entry_t *tmp;
   uint32_t flags;
+#ifdef CONFIG_MM_RECLAIM
+  bool reclaim = false;
+#endif
 
   flags       = spin_lock_irqsave(&g_pressure_lock);
   g_remaining = remaining;
@@ -441,6 +460,14 @@ void mm_notify_pressure(size_t remaining, size_t largest)
           continue;
         }
 
+#ifdef CONFIG_MM_RECLAIM
+      /* A threshold set by user space is crossed, let the kernel caches
+       * give memory back too.
+       */
+
+      reclaim = true;
+#endif
+
       /* If lasttick is CLOCK_MAX, it means that the event is triggered
        * for the first time and we should always send notifications.
        */
@@ -467,5 +494,12 @@ void mm_notify_pressure(size_t remaining, size_t largest)
     }
 
   spin_unlock_irqrestore(&g_pressure_lock, flags);
+
+#ifdef CONFIG_MM_RECLAIM
+  if (reclaim)
+    {
+      mm_reclaim();
+    }
+#endif
 }
 
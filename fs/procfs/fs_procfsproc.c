@@ -56,6 +56,7 @@
 #include <nuttx/fs/procfs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mm/mm.h>
+#include <nuttx/pgalloc.h>
 #include <nuttx/queue.h>
 #include <nuttx/lib/lib.h>
 
@@ -132,6 +133,9 @@ struct proc_file_s
   FAR const struct proc_node_s *node; /* Describes the file node */
   pid_t pid;                          /* Task/thread ID */
   char line[STATUS_LINELEN];          /* Pre-allocated buffer for formatted lines */
+#ifdef CONFIG_FS_PROCFS_SNAPSHOT
+  struct procfs_snapshot_s snapshot;  /* Content for a sequence of reads */
+#endif
 };
 
 /* This structure describes one open "directory" */
@@ -216,6 +220,8 @@ static ssize_t proc_groupenv(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
 #endif
+static ssize_t proc_render(FAR void *arg, FAR char *buffer,
+                 size_t buflen, off_t offset);
 
 /* File system methods */
 
@@ -982,6 +988,40 @@ static ssize_t proc_heapcheck_write(FAR struct proc_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_stackpages
+ *
+ * Description:
+ *   Count the pages of a user stack that were touched, with demand-zero
+ *   heaps this is the high-water mark of the stack in pages.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HEAP_DEMAND_ZERO
+static size_t proc_stackpages(FAR struct tcb_s *tcb)
+{
+  uintptr_t vaddr = MM_PGALIGNDOWN(tcb->stack_base_ptr);
+  uintptr_t vend = (uintptr_t)tcb->stack_base_ptr + tcb->adj_stack_size;
+  size_t npages = 0;
+
+  if ((tcb->flags & TCB_FLAG_TTYPE_MASK) == TCB_FLAG_TTYPE_KERNEL ||
+      tcb->addrenv_own == NULL)
+    {
+      return 0;
+    }
+
+  for (; vaddr < vend; vaddr += MM_PGSIZE)
+    {
+      if (up_addrenv_find_page(&tcb->addrenv_own->addrenv, vaddr) != 0)
+        {
+          npages++;
+        }
+    }
+
+  return npages;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_stack
  ****************************************************************************/
@@ -1044,6 +1084,24 @@ static ssize_t proc_stack(FAR struct proc_file_s *procfile,
   buffer    += copysize;
   remaining -= copysize;
 
+#ifdef CONFIG_ARCH_HEAP_DEMAND_ZERO
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the pages of the stack allocated so far */
+
+  linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN, "%-12s%zu\n",
+                               "StackPages:", proc_stackpages(tcb));
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                             &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+#endif
+
 #ifdef CONFIG_STACK_COLORATION
   if (totalsize >= buflen)
     {
@@ -1567,30 +1625,30 @@ static int proc_close(FAR struct file *filep)
 
   /* Release the file container structure */
 
+#ifdef CONFIG_FS_PROCFS_SNAPSHOT
+  procfs_snapshot_free(&procfile->snapshot);
+#endif
   fs_heap_free(procfile);
   filep->f_priv = NULL;
   return OK;
 }
 
 /****************************************************************************
- * Name: proc_read
+ * Name: proc_render
+ *
+ * Description:
+ *   Generate the content of a task file from 'offset' on.
+ *
  ****************************************************************************/
 
-static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
-                         size_t buflen)
+static ssize_t proc_render(FAR void *arg, FAR char *buffer,
+                           size_t buflen, off_t offset)
 {
-  FAR struct proc_file_s *procfile;
+  FAR struct proc_file_s *procfile = arg;
   FAR struct tcb_s *tcb;
   irqstate_t flags;
   ssize_t ret;
 
-  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
-
-  /* Recover our private data from the struct file instance */
-
-  procfile = (FAR struct proc_file_s *)filep->f_priv;
-  DEBUGASSERT(procfile != NULL);
-
   /* Verify that the thread is still valid */
 
   flags = enter_critical_section();
@@ -1607,48 +1665,48 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
   switch (procfile->node->node)
     {
     case PROC_STATUS: /* Task/thread status */
-      ret = proc_status(procfile, tcb, buffer, buflen, filep->f_pos);
+      ret = proc_status(procfile, tcb, buffer, buflen, offset);
       break;
 
     case PROC_CMDLINE: /* Task command line */
-      ret = proc_cmdline(procfile, tcb, buffer, buflen, filep->f_pos);
+      ret = proc_cmdline(procfile, tcb, buffer, buflen, offset);
       break;
 
 #ifndef CONFIG_SCHED_CPULOAD_NONE
     case PROC_LOADAVG: /* Average CPU utilization */
-      ret = proc_loadavg(procfile, tcb, buffer, buflen, filep->f_pos);
+      ret = proc_loadavg(procfile, tcb, buffer, buflen, offset);
       break;
 #endif
 #ifdef CONFIG_SCHED_CRITMONITOR
     case PROC_CRITMON: /* Critical section monitor */
-      ret = proc_critmon(procfile, tcb, buffer, buflen, filep->f_pos);
+      ret = proc_critmon(procfile, tcb, buffer, buflen, offset);
       break;
 #endif
 #if CONFIG_MM_BACKTRACE >= 0
     case PROC_HEAP: /* Task heap info */
-      ret = proc_heap(procfile, tcb, buffer, buflen, filep->f_pos);
+      ret = proc_heap(procfile, tcb, buffer, buflen, offset);
       break;
 #endif
 #ifdef CONFIG_DEBUG_MM
     case PROC_HEAP_CHECK: /* Task heap check flag */
-      ret = proc_heapcheck(procfile, tcb, buffer, buflen, filep->f_pos);
+      ret = proc_heapcheck(procfile, tcb, buffer, buflen, offset);
       break;
 #endif
     case PROC_STACK: /* Task stack info */
-      ret = proc_stack(procfile, tcb, buffer, buflen, filep->f_pos);
+      ret = proc_stack(procfile, tcb, buffer, buflen, offset);
       break;
 
     case PROC_GROUP_STATUS: /* Task group status */
-      ret = proc_groupstatus(procfile, tcb, buffer, buflen, filep->f_pos);
+      ret = proc_groupstatus(procfile, tcb, buffer, buflen, offset);
       break;
 
     case PROC_GROUP_FD: /* Group file descriptors */
-      ret = proc_groupfd(procfile, tcb, buffer, buflen, filep->f_pos);
+      ret = proc_groupfd(procfile, tcb, buffer, buflen, offset);
       break;
 
 #if !defined(CONFIG_DISABLE_ENVIRON) && !defined(CONFIG_FS_PROCFS_EXCLUDE_ENVIRON)
     case PROC_GROUP_ENV: /* Group environment variables */
-      ret = proc_groupenv(procfile, tcb, buffer, buflen, filep->f_pos);
+      ret = proc_groupenv(procfile, tcb, buffer, buflen, offset);
       break;
 #endif
 
@@ -1658,6 +1716,32 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
     }
 
   leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: proc_read
+ ****************************************************************************/
+
+static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
+                         size_t buflen)
+{
+  FAR struct proc_file_s *procfile;
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct proc_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile != NULL);
+
+#ifdef CONFIG_FS_PROCFS_SNAPSHOT
+  ret = procfs_snapshot_read(&procfile->snapshot, proc_render, procfile,
+                             buffer, buflen, filep->f_pos);
+#else
+  ret = proc_render(procfile, buffer, buflen, filep->f_pos);
+#endif
 
   /* Update the file offset */
 
@@ -1745,6 +1829,9 @@ static int proc_dup(FAR const struct file *oldp, FAR struct file *newp)
   /* The copy the file information from the old container to the new */
 
   memcpy(newfile, oldfile, sizeof(struct proc_file_s));
+#ifdef CONFIG_FS_PROCFS_SNAPSHOT
+  memset(&newfile->snapshot, 0, sizeof(newfile->snapshot));
+#endif
 
   /* Save the new container in the new file structure */
 
@@ -0,0 +1,339 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsstats.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/sched.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifdef CONFIG_FS_PROCFS_INCLUDE_STATS
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct stats_file_s
+{
+  struct procfs_file_s base;         /* Base open file structure */
+#ifdef CONFIG_FS_PROCFS_SNAPSHOT
+  struct procfs_snapshot_s snapshot; /* Content for a sequence of reads */
+#endif
+};
+
+/* The read state handed to stats_task() */
+
+struct stats_state_s
+{
+  FAR char *buffer;
+  size_t buflen;
+  size_t totalsize;
+  off_t offset;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void    stats_task(FAR struct tcb_s *tcb, FAR void *arg);
+static ssize_t stats_render(FAR void *arg, FAR char *buffer,
+                 size_t buflen, off_t offset);
+
+/* File system methods */
+
+static int     stats_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     stats_close(FAR struct file *filep);
+static ssize_t stats_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     stats_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     stats_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_stats_operations =
+{
+  stats_open,        /* open */
+  stats_close,       /* close */
+  stats_read,        /* read */
+  NULL,              /* write */
+  NULL,              /* poll */
+
+  stats_dup,         /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  stats_stat         /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stats_task
+ *
+ * Description:
+ *   Append the record of one task or thread.
+ *
+ ****************************************************************************/
+
+static void stats_task(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct stats_state_s *state = arg;
+  struct procfs_taskstats_s stats;
+#ifndef CONFIG_SCHED_CPULOAD_NONE
+  struct cpuload_s cpuload;
+#endif
+
+  if (state->totalsize >= state->buflen)
+    {
+      return;
+    }
+
+  memset(&stats, 0, sizeof(stats));
+  stats.pid       = tcb->pid;
+  stats.group     = tcb->group ? tcb->group->tg_pid : -1;
+  stats.flags     = tcb->flags;
+  stats.state     = tcb->task_state;
+  stats.priority  = tcb->sched_priority;
+#ifdef CONFIG_SMP
+  stats.cpu       = tcb->cpu;
+#endif
+#ifndef CONFIG_SCHED_CPULOAD_NONE
+  if (clock_cpuload(tcb->pid, &cpuload) == OK)
+    {
+      stats.cputotal  = cpuload.total;
+      stats.cpuactive = cpuload.active;
+    }
+#endif
+
+  stats.stacksize = tcb->adj_stack_size;
+#ifdef CONFIG_MM_HEAP_TASKPEAK
+  stats.heapused  = tcb->heap_used;
+  stats.heappeak  = tcb->heap_peak;
+#endif
+  strlcpy(stats.name, get_task_name(tcb), sizeof(stats.name));
+
+  state->totalsize += procfs_memcpy((FAR const char *)&stats,
+                                    sizeof(stats),
+                                    state->buffer + state->totalsize,
+                                    state->buflen - state->totalsize,
+                                    &state->offset);
+}
+
+/****************************************************************************
+ * Name: stats_render
+ *
+ * Description:
+ *   Generate the records of all tasks from 'offset' on, in one pass over
+ *   the tasks.
+ *
+ ****************************************************************************/
+
+static ssize_t stats_render(FAR void *arg, FAR char *buffer,
+                            size_t buflen, off_t offset)
+{
+  struct stats_state_s state;
+
+  state.buffer    = buffer;
+  state.buflen    = buflen;
+  state.totalsize = 0;
+  state.offset    = offset;
+
+  nxsched_foreach(stats_task, &state);
+  return state.totalsize;
+}
+
+/****************************************************************************
+ * Name: stats_open
+ ****************************************************************************/
+
+static int stats_open(FAR struct file *filep, FAR const char *relpath,
+                      int oflags, mode_t mode)
+{
+  FAR struct stats_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct stats_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stats_close
+ ****************************************************************************/
+
+static int stats_close(FAR struct file *filep)
+{
+  FAR struct stats_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct stats_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+#ifdef CONFIG_FS_PROCFS_SNAPSHOT
+  procfs_snapshot_free(&attr->snapshot);
+#endif
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stats_read
+ ****************************************************************************/
+
+static ssize_t stats_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  FAR struct stats_file_s *attr;
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct stats_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+#ifdef CONFIG_FS_PROCFS_SNAPSHOT
+  ret = procfs_snapshot_read(&attr->snapshot, stats_render, attr,
+                             buffer, buflen, filep->f_pos);
+#else
+  ret = stats_render(attr, buffer, buflen, filep->f_pos);
+#endif
+
+  /* Update the file offset */
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: stats_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int stats_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct stats_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Allocate a new container, the snapshot is not shared */
+
+  newattr = fs_heap_zalloc(sizeof(struct stats_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stats_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int stats_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "stats" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_FS_PROCFS_INCLUDE_STATS */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -28,9 +28,12 @@
 #include <sys/types.h>
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
 
 #include <nuttx/fs/procfs.h>
 
+#include "fs_heap.h"
+
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
 
 /****************************************************************************
@@ -210,4 +213,95 @@ void procfs_sprintf(FAR char *buf, size_t size, FAR off_t *offset,
   *offset -= copysize;
 }
 
+/****************************************************************************
+ * Name: procfs_snapshot_read
+ *
+ * Description:
+ *   Read a procfs file from a snapshot of its content.  The snapshot is
+ *   generated with 'render' when the file is read at position zero, or for
+ *   the first read, and is grown until the whole content fits.
+ *
+ * Input Parameters:
+ *   snapshot - The snapshot of the open file
+ *   render   - Generates the content of the file
+ *   arg      - The argument of 'render'
+ *   buffer   - The user's receive buffer
+ *   buflen   - The size of the user's receive buffer
+ *   offset   - The file position
+ *
+ * Returned Value:
+ *   The number of bytes returned, or a negated errno value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PROCFS_SNAPSHOT
+ssize_t procfs_snapshot_read(FAR struct procfs_snapshot_s *snapshot,
+                             procfs_render_t render, FAR void *arg,
+                             FAR char *buffer, size_t buflen,
+                             off_t offset)
+{
+  ssize_t ret;
+
+  if (offset == 0 || snapshot->buffer == NULL)
+    {
+      if (snapshot->size == 0)
+        {
+          snapshot->size = CONFIG_FS_PROCFS_SNAPSHOT_SIZE;
+        }
+
+      for (; ; )
+        {
+          if (snapshot->buffer == NULL)
+            {
+              snapshot->buffer = fs_heap_malloc(snapshot->size);
+              if (snapshot->buffer == NULL)
+                {
+                  return -ENOMEM;
+                }
+            }
+
+          ret = render(arg, snapshot->buffer, snapshot->size, 0);
+          if (ret < 0)
+            {
+              snapshot->length = 0;
+              return ret;
+            }
+
+          /* A full buffer may have truncated the content, allocate twice
+           * the size and generate the content again.
+           */
+
+          if ((size_t)ret < snapshot->size)
+            {
+              snapshot->length = ret;
+              break;
+            }
+
+          fs_heap_free(snapshot->buffer);
+          snapshot->buffer = NULL;
+          snapshot->size  *= 2;
+        }
+    }
+
+  return procfs_memcpy(snapshot->buffer, snapshot->length, buffer, buflen,
+                       &offset);
+}
+
+/****************************************************************************
+ * Name: procfs_snapshot_free
+ *
+ * Description:
+ *   Release the snapshot of an open file.
+ *
+ ****************************************************************************/
+
+void procfs_snapshot_free(FAR struct procfs_snapshot_s *snapshot)
+{
+  fs_heap_free(snapshot->buffer);
+  snapshot->buffer = NULL;
+  snapshot->size   = 0;
+  snapshot->length = 0;
+}
+#endif
+
 #endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
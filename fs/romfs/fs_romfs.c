@@ -413,6 +413,19 @@ static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
       buflen = bytesleft;
     }
 
+  /* Memory mapped media is copied from directly, in one piece instead of
+   * sector by sector.
+   */
+
+  if (rm->rm_xipbase != NULL)
+    {
+      memcpy(userbuffer, rm->rm_xipbase + rf->rf_startoffset + filep->f_pos,
+             buflen);
+      filep->f_pos += buflen;
+      readsize      = buflen;
+      buflen        = 0;
+    }
+
   /* Loop until either (1) all data has been transferred, or (2) an
    * error occurs.
    */
@@ -165,6 +165,9 @@ struct romfs_nodeinfo_s
   uint32_t rn_size;                        /* Size (if file) */
 #ifdef CONFIG_FS_ROMFS_CACHE_NODE
   FAR struct romfs_nodeinfo_s **rn_child;  /* The node array for link to lower level */
+#ifdef CONFIG_FS_ROMFS_HASH_INDEX
+  FAR uint16_t *rn_hash;                   /* Hash table of rn_child indexes */
+#endif
   uint16_t rn_count;                       /* The count of node in rn_child level */
   uint8_t  rn_namesize;                    /* The length of name of the entry */
   char     rn_name[1];                     /* The name to the entry */
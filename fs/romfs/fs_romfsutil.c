@@ -48,6 +48,13 @@
 #define LINK_FOLLOWED     1
 #define NODEINFO_NINCR    4
 
+/* Directories with fewer entries get no hash index, the binary search is
+ * as fast for them.
+ */
+
+#define ROMFS_HASH_MINENTRIES 8
+#define ROMFS_HASH_EMPTY      UINT16_MAX
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -313,6 +320,86 @@ static int romfs_nodeinfo_compare(FAR const void *a, FAR const void *b)
 }
 #endif
 
+/****************************************************************************
+ * Name: romfs_hashname/romfs_hashsize
+ *
+ * Description:
+ *   Hash a name (FNV-1a) and return the size of the hash table of a
+ *   directory, a power of two at least twice the number of its entries.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_HASH_INDEX
+static uint32_t romfs_hashname(FAR const char *name, size_t len)
+{
+  uint32_t hash = 2166136261u;
+
+  while (len-- > 0)
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+static size_t romfs_hashsize(uint16_t count)
+{
+  size_t size = ROMFS_HASH_MINENTRIES;
+
+  while (size < 2 * (size_t)count)
+    {
+      size <<= 1;
+    }
+
+  return size;
+}
+
+/****************************************************************************
+ * Name: romfs_buildhash
+ *
+ * Description:
+ *   Build the hash index of a cached directory.  Without memory for it,
+ *   the directory is searched by name instead.
+ *
+ ****************************************************************************/
+
+static void romfs_buildhash(FAR struct romfs_nodeinfo_s *nodeinfo)
+{
+  FAR struct romfs_nodeinfo_s *child;
+  size_t mask;
+  size_t ndx;
+  uint16_t i;
+
+  if (nodeinfo->rn_count < ROMFS_HASH_MINENTRIES)
+    {
+      return;
+    }
+
+  mask = romfs_hashsize(nodeinfo->rn_count) - 1;
+  nodeinfo->rn_hash = fs_heap_malloc((mask + 1) * sizeof(uint16_t));
+  if (nodeinfo->rn_hash == NULL)
+    {
+      return;
+    }
+
+  memset(nodeinfo->rn_hash, 0xff, (mask + 1) * sizeof(uint16_t));
+
+  for (i = 0; i < nodeinfo->rn_count; i++)
+    {
+      child = nodeinfo->rn_child[i];
+      ndx   = romfs_hashname(child->rn_name, child->rn_namesize) & mask;
+
+      while (nodeinfo->rn_hash[ndx] != ROMFS_HASH_EMPTY)
+        {
+          ndx = (ndx + 1) & mask;
+        }
+
+      nodeinfo->rn_hash[ndx] = i;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_searchdir
  *
@@ -330,6 +417,33 @@ static inline int romfs_searchdir(FAR struct romfs_mountpt_s *rm,
   FAR struct romfs_nodeinfo_s **cnodeinfo;
   struct romfs_entryname_s entry;
 
+#ifdef CONFIG_FS_ROMFS_HASH_INDEX
+  if (nodeinfo->rn_hash != NULL)
+    {
+      FAR struct romfs_nodeinfo_s *child;
+      size_t mask;
+      size_t ndx;
+
+      mask = romfs_hashsize(nodeinfo->rn_count) - 1;
+      ndx  = romfs_hashname(entryname, entrylen) & mask;
+
+      while (nodeinfo->rn_hash[ndx] != ROMFS_HASH_EMPTY)
+        {
+          child = nodeinfo->rn_child[nodeinfo->rn_hash[ndx]];
+          if (child->rn_namesize == entrylen &&
+              memcmp(child->rn_name, entryname, entrylen) == 0)
+            {
+              memcpy(nodeinfo, child, sizeof(*nodeinfo));
+              return 0;
+            }
+
+          ndx = (ndx + 1) & mask;
+        }
+
+      return -ENOENT;
+    }
+#endif
+
   entry.re_name = entryname;
   entry.re_len = entrylen;
   cnodeinfo = bsearch(&entry, nodeinfo->rn_child, nodeinfo->rn_count,
@@ -414,7 +528,7 @@ static int romfs_cachenode(FAR struct romfs_mountpt_s *rm,
   char childname[NAME_MAX + 1];
   uint32_t linkoffset;
   uint32_t info;
-  uint8_t num = 0;
+  size_t num = 0;
   size_t nsize;
   int ret;
 
@@ -462,18 +576,24 @@ static int romfs_cachenode(FAR struct romfs_mountpt_s *rm,
           if (child == NULL || nodeinfo->rn_count == num - 1)
             {
               FAR void *tmp;
+              size_t incr;
+
+              /* Grow the array geometrically, so that large directories
+               * are not copied over and over while they are cached.
+               */
 
-              tmp = fs_heap_realloc(nodeinfo->rn_child,
-                    (num + NODEINFO_NINCR) * sizeof(*nodeinfo->rn_child));
+              incr = num > NODEINFO_NINCR ? num : NODEINFO_NINCR;
+              tmp  = fs_heap_realloc(nodeinfo->rn_child,
+                     (num + incr) * sizeof(*nodeinfo->rn_child));
               if (tmp == NULL)
                 {
                   return -ENOMEM;
                 }
 
               nodeinfo->rn_child = tmp;
-              memset(nodeinfo->rn_child + num, 0, NODEINFO_NINCR *
+              memset(nodeinfo->rn_child + num, 0, incr *
                      sizeof(*nodeinfo->rn_child));
-              num += NODEINFO_NINCR;
+              num += incr;
             }
 
           child = &nodeinfo->rn_child[nodeinfo->rn_count++];
@@ -502,6 +622,10 @@ static int romfs_cachenode(FAR struct romfs_mountpt_s *rm,
             sizeof(*nodeinfo->rn_child), romfs_nodeinfo_compare);
     }
 
+#ifdef CONFIG_FS_ROMFS_HASH_INDEX
+  romfs_buildhash(nodeinfo);
+#endif
+
   return 0;
 }
 #endif
@@ -873,6 +997,9 @@ void romfs_freenode(FAR struct romfs_nodeinfo_s *nodeinfo)
         }
 
       fs_heap_free(nodeinfo->rn_child);
+#ifdef CONFIG_FS_ROMFS_HASH_INDEX
+      fs_heap_free(nodeinfo->rn_hash);
+#endif
     }
 
   fs_heap_free(nodeinfo);
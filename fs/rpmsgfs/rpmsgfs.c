@@ -36,6 +36,8 @@
 #include <debug.h>
 #include <limits.h>
 
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
 #include <nuttx/lib/lib.h>
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
@@ -51,6 +53,28 @@
 
 #define RPMSGFS_RETRY_DELAY_MS       10
 
+#if CONFIG_FS_RPMSGFS_READAHEAD > 0 || CONFIG_FS_RPMSGFS_WRITEBEHIND > 0
+#  define RPMSGFS_BUFFERED 1
+#endif
+
+/* The readahead window starts at this size and doubles with each refill
+ * of a sequential reader, up to CONFIG_FS_RPMSGFS_READAHEAD.
+ */
+
+#if CONFIG_FS_RPMSGFS_READAHEAD > 0
+#  define RPMSGFS_RA_MIN  MIN(CONFIG_FS_RPMSGFS_READAHEAD, 512)
+#endif
+
+/* With batched requests a read-only file is opened with the first
+ * readahead window, and directories are read through a buffer of entries.
+ */
+
+#if defined(CONFIG_FS_RPMSGFS_BATCH) && CONFIG_FS_RPMSGFS_READAHEAD > 0
+#  define RPMSGFS_OPEN_READAHEAD 1
+#endif
+
+#define RPMSGFS_DIRBUF_SIZE 1024
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -59,6 +83,11 @@ struct rpmsgfs_dir_s
 {
   struct fs_dirent_s base;
   FAR void *dir;
+#ifdef CONFIG_FS_RPMSGFS_BATCH
+  FAR char *buf;                       /* Entries read ahead */
+  size_t off;                          /* Offset of the next entry */
+  size_t len;                          /* Valid bytes in buf */
+#endif
 };
 
 /* This structure describes the state of one open file.  This structure
@@ -71,7 +100,34 @@ struct rpmsgfs_ofile_s
   int16_t                    crefs;    /* Reference count */
   mode_t                     oflags;   /* Open mode */
   int                        fd;
+#ifdef RPMSGFS_BUFFERED
+  off_t                      pos;      /* Remote file position, -1 unknown */
+#endif
+#if CONFIG_FS_RPMSGFS_READAHEAD > 0
+  FAR char                   *rabuf;   /* Readahead buffer */
+  off_t                      rapos;    /* File position of rabuf */
+  size_t                     ralen;    /* Valid bytes in rabuf */
+  size_t                     rawin;    /* Current readahead window */
+  off_t                      ranext;   /* Position of a sequential read */
+#endif
+#if CONFIG_FS_RPMSGFS_WRITEBEHIND > 0
+  FAR char                   *wbbuf;   /* Write-behind buffer */
+  off_t                      wbpos;    /* File position of wbbuf */
+  size_t                     wblen;    /* Bytes waiting in wbbuf */
+#endif
+};
+
+/* A cached result of stat() */
+
+#if CONFIG_FS_RPMSGFS_STAT_TTL > 0
+struct rpmsgfs_statcache_s
+{
+  FAR char                   *path;    /* Remote path, NULL if unused */
+  clock_t                    expire;   /* When the result gets stale */
+  unsigned int               gen;      /* fs_statgen of the result */
+  struct stat                buf;      /* The result */
 };
+#endif
 
 /* This structure represents the overall mountpoint state.  An instance of
  * this structure is retained as inode private data on each mountpoint that
@@ -85,6 +141,11 @@ struct rpmsgfs_mountpt_s
   char                       fs_root[PATH_MAX];
   void                       *handle;
   int                        timeout;  /* Connect timeout */
+#if CONFIG_FS_RPMSGFS_STAT_TTL > 0
+  struct rpmsgfs_statcache_s fs_stat[CONFIG_FS_RPMSGFS_STAT_NCACHE];
+  int                        fs_statnext; /* The entry to replace next */
+  atomic_uint                fs_statgen;  /* Bumped by any modification */
+#endif
 };
 
 /****************************************************************************
@@ -252,6 +313,10 @@ static void rpmsgfs_mkpath(FAR struct rpmsgfs_mountpt_s *fs,
       strlcat(path, &relpath[first], pathlen - strlen(path));
     }
 
+  /* Wait for the remote root until it answered once, not before each
+   * request.
+   */
+
   while (fs->timeout > 0)
     {
       struct stat buf;
@@ -260,6 +325,7 @@ static void rpmsgfs_mkpath(FAR struct rpmsgfs_mountpt_s *fs,
       ret = rpmsgfs_client_stat(fs->handle, fs->fs_root, &buf);
       if (ret == 0)
         {
+          fs->timeout = 0;
           break;
         }
 
@@ -268,6 +334,353 @@ static void rpmsgfs_mkpath(FAR struct rpmsgfs_mountpt_s *fs,
     }
 }
 
+#ifdef RPMSGFS_BUFFERED
+
+/****************************************************************************
+ * Name: rpmsgfs_setpos
+ *
+ * Description: Move the remote file position to pos, if it is not there.
+ *   With readahead and write-behind the remote position runs ahead of or
+ *   behind the local one.
+ *
+ ****************************************************************************/
+
+static int rpmsgfs_setpos(FAR struct rpmsgfs_mountpt_s *fs,
+                          FAR struct rpmsgfs_ofile_s *hf, off_t pos)
+{
+  off_t ret;
+
+  if (hf->pos == pos)
+    {
+      return OK;
+    }
+
+  ret = rpmsgfs_client_lseek(fs->handle, hf->fd, pos, SEEK_SET);
+  if (ret < 0)
+    {
+      hf->pos = -1;
+      return ret;
+    }
+
+  hf->pos = ret;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_advance
+ *
+ * Description: Account for nbytes read or written at the remote position.
+ *   Writes of an O_APPEND file go to the end, wherever the position was.
+ *
+ ****************************************************************************/
+
+static void rpmsgfs_advance(FAR struct rpmsgfs_ofile_s *hf, ssize_t nbytes,
+                            bool write)
+{
+  if (hf->pos < 0 || (write && (hf->oflags & O_APPEND) != 0))
+    {
+      hf->pos = -1;
+    }
+  else if (nbytes > 0)
+    {
+      hf->pos += nbytes;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: rpmsgfs_flush
+ *
+ * Description: Send the data waiting in the write-behind buffer.  This is
+ *   the barrier before any operation that depends on the remote file.
+ *
+ ****************************************************************************/
+
+static int rpmsgfs_flush(FAR struct rpmsgfs_mountpt_s *fs,
+                         FAR struct rpmsgfs_ofile_s *hf)
+{
+#if CONFIG_FS_RPMSGFS_WRITEBEHIND > 0
+  ssize_t ret;
+
+  if (hf->wblen == 0)
+    {
+      return OK;
+    }
+
+  ret = rpmsgfs_setpos(fs, hf, hf->wbpos);
+  if (ret >= 0)
+    {
+      /* All of the buffer goes out in one request, that is acknowledged
+       * only once.
+       */
+
+      ret = rpmsgfs_client_write(fs->handle, hf->fd, hf->wbbuf, hf->wblen);
+      rpmsgfs_advance(hf, ret, true);
+    }
+
+  /* The data is dropped on an error, like a failed write() had not
+   * written it.
+   */
+
+  hf->wblen = 0;
+  return ret < 0 ? ret : OK;
+#else
+  return OK;
+#endif
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_dropra
+ *
+ * Description: Forget the readahead data, after the file was modified.
+ *
+ ****************************************************************************/
+
+static void rpmsgfs_dropra(FAR struct rpmsgfs_ofile_s *hf)
+{
+#if CONFIG_FS_RPMSGFS_READAHEAD > 0
+  hf->ralen = 0;
+#endif
+}
+
+#if CONFIG_FS_RPMSGFS_READAHEAD > 0
+
+/****************************************************************************
+ * Name: rpmsgfs_readahead
+ *
+ * Description: Read through the readahead buffer.  Reads that are at
+ *   least as large as the window go to the caller's buffer directly.
+ *
+ ****************************************************************************/
+
+static ssize_t rpmsgfs_readahead(FAR struct rpmsgfs_mountpt_s *fs,
+                                 FAR struct rpmsgfs_ofile_s *hf, off_t pos,
+                                 FAR char *buffer, size_t buflen)
+{
+  bool seq = pos == hf->ranext;
+  size_t done = 0;
+  ssize_t ret;
+  size_t n;
+
+  if (!seq)
+    {
+      hf->rawin = RPMSGFS_RA_MIN;
+    }
+
+  if (pos >= hf->rapos && pos < hf->rapos + (off_t)hf->ralen)
+    {
+      done = MIN(buflen, hf->rapos + hf->ralen - pos);
+      memcpy(buffer, hf->rabuf + (pos - hf->rapos), done);
+    }
+
+  if (done < buflen)
+    {
+      if (seq && hf->ralen > 0)
+        {
+          hf->rawin = MIN(hf->rawin * 2, CONFIG_FS_RPMSGFS_READAHEAD);
+        }
+
+      if (hf->rabuf == NULL)
+        {
+          hf->rabuf = fs_heap_malloc(CONFIG_FS_RPMSGFS_READAHEAD);
+        }
+
+      ret = rpmsgfs_setpos(fs, hf, pos + done);
+      if (ret < 0)
+        {
+          return done > 0 ? done : ret;
+        }
+
+      if (buflen - done >= hf->rawin || hf->rabuf == NULL)
+        {
+          ret = rpmsgfs_client_read(fs->handle, hf->fd, buffer + done,
+                                    buflen - done);
+          rpmsgfs_advance(hf, ret, false);
+          n = ret > 0 ? ret : 0;
+        }
+      else
+        {
+          hf->ralen = 0;
+          ret = rpmsgfs_client_read(fs->handle, hf->fd, hf->rabuf,
+                                    hf->rawin);
+          rpmsgfs_advance(hf, ret, false);
+          if (ret > 0)
+            {
+              hf->rapos = pos + done;
+              hf->ralen = ret;
+            }
+
+          n = ret > 0 ? MIN(buflen - done, ret) : 0;
+          memcpy(buffer + done, hf->rabuf, n);
+        }
+
+      if (ret < 0 && done == 0)
+        {
+          return ret;
+        }
+
+      done += n;
+    }
+
+  hf->ranext = pos + done;
+  return done;
+}
+#endif
+
+#if CONFIG_FS_RPMSGFS_STAT_TTL > 0
+
+/****************************************************************************
+ * Name: rpmsgfs_statcache_get
+ *
+ * Description: Look up a result of stat() that is not stale yet.
+ *
+ ****************************************************************************/
+
+static bool rpmsgfs_statcache_get(FAR struct rpmsgfs_mountpt_s *fs,
+                                  FAR const char *path,
+                                  FAR struct stat *buf)
+{
+  clock_t now = clock_systime_ticks();
+  int i;
+
+  for (i = 0; i < CONFIG_FS_RPMSGFS_STAT_NCACHE; i++)
+    {
+      FAR struct rpmsgfs_statcache_s *entry = &fs->fs_stat[i];
+
+      if (entry->path != NULL && strcmp(entry->path, path) == 0)
+        {
+          if ((sclock_t)(entry->expire - now) <= 0 ||
+              entry->gen != atomic_load(&fs->fs_statgen))
+            {
+              return false;
+            }
+
+          memcpy(buf, &entry->buf, sizeof(*buf));
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_statcache_put
+ *
+ * Description: Remember a result of stat() of the remote side, unless
+ *   something was modified since gen was read before the request.
+ *
+ ****************************************************************************/
+
+static void rpmsgfs_statcache_put(FAR struct rpmsgfs_mountpt_s *fs,
+                                  FAR const char *path,
+                                  FAR const struct stat *buf,
+                                  unsigned int gen)
+{
+  FAR struct rpmsgfs_statcache_s *entry = NULL;
+  int i;
+
+  if (gen != atomic_load(&fs->fs_statgen))
+    {
+      return;
+    }
+
+  for (i = 0; i < CONFIG_FS_RPMSGFS_STAT_NCACHE; i++)
+    {
+      if (fs->fs_stat[i].path != NULL &&
+          strcmp(fs->fs_stat[i].path, path) == 0)
+        {
+          entry = &fs->fs_stat[i];
+          break;
+        }
+    }
+
+  if (entry == NULL)
+    {
+      entry = &fs->fs_stat[fs->fs_statnext];
+      fs->fs_statnext = (fs->fs_statnext + 1) %
+                        CONFIG_FS_RPMSGFS_STAT_NCACHE;
+
+      fs_heap_free(entry->path);
+      entry->path = fs_heap_strdup(path);
+      if (entry->path == NULL)
+        {
+          return;
+        }
+    }
+
+  entry->expire = clock_systime_ticks() +
+                  MSEC2TICK(CONFIG_FS_RPMSGFS_STAT_TTL);
+  entry->gen    = gen;
+  memcpy(&entry->buf, buf, sizeof(*buf));
+}
+#endif
+
+/****************************************************************************
+ * Name: rpmsgfs_statcache_flush
+ *
+ * Description: Forget all cached results of stat(), after anything was
+ *   modified.  This needs no lock, so it is called after the modification
+ *   is done, and also drops the results of requests still outstanding.
+ *
+ ****************************************************************************/
+
+static void rpmsgfs_statcache_flush(FAR struct rpmsgfs_mountpt_s *fs)
+{
+#if CONFIG_FS_RPMSGFS_STAT_TTL > 0
+  atomic_fetch_add(&fs->fs_statgen, 1);
+#endif
+}
+
+#ifdef RPMSGFS_OPEN_READAHEAD
+
+/****************************************************************************
+ * Name: rpmsgfs_openread
+ *
+ * Description: Open a read-only file and fill its readahead buffer with
+ *   the first window in the same round trip.
+ *
+ ****************************************************************************/
+
+static int rpmsgfs_openread(FAR struct rpmsgfs_mountpt_s *fs,
+                            FAR struct rpmsgfs_ofile_s *hf,
+                            FAR const char *path, int oflags, mode_t mode)
+{
+  size_t count = hf->rawin;
+  struct stat buf;
+#if CONFIG_FS_RPMSGFS_STAT_TTL > 0
+  unsigned int gen = atomic_load(&fs->fs_statgen);
+#endif
+  int fd;
+
+  if ((oflags & O_WROK) != 0)
+    {
+      return rpmsgfs_client_open(fs->handle, path, oflags, mode);
+    }
+
+  hf->rabuf = fs_heap_malloc(CONFIG_FS_RPMSGFS_READAHEAD);
+  if (hf->rabuf == NULL)
+    {
+      return rpmsgfs_client_open(fs->handle, path, oflags, mode);
+    }
+
+  fd = rpmsgfs_client_openread(fs->handle, path, oflags, mode,
+                               hf->rabuf, &count, &buf);
+  if (fd < 0)
+    {
+      return fd;
+    }
+
+  hf->pos    = count;
+  hf->ralen  = count;
+  hf->ranext = 0;
+
+#if CONFIG_FS_RPMSGFS_STAT_TTL > 0
+  rpmsgfs_statcache_put(fs, path, &buf, gen);
+#endif
+  return fd;
+}
+#endif
+
 /****************************************************************************
  * Name: rpmsgfs_open
  ****************************************************************************/
@@ -322,9 +735,28 @@ static int rpmsgfs_open(FAR struct file *filep, FAR const char *relpath,
 
   rpmsgfs_mkpath(fs, relpath, path, PATH_MAX);
 
+#ifdef RPMSGFS_BUFFERED
+  hf->pos    = 0;
+#endif
+#if CONFIG_FS_RPMSGFS_READAHEAD > 0
+  hf->rabuf  = NULL;
+  hf->rapos  = 0;
+  hf->ralen  = 0;
+  hf->rawin  = RPMSGFS_RA_MIN;
+  hf->ranext = -1;
+#endif
+#if CONFIG_FS_RPMSGFS_WRITEBEHIND > 0
+  hf->wbbuf  = NULL;
+  hf->wblen  = 0;
+#endif
+
   /* Try to open the file in the host file system */
 
+#ifdef RPMSGFS_OPEN_READAHEAD
+  hf->fd = rpmsgfs_openread(fs, hf, path, oflags, mode);
+#else
   hf->fd = rpmsgfs_client_open(fs->handle, path, oflags, mode);
+#endif
   if (hf->fd < 0)
     {
       /* Error opening file */
@@ -337,12 +769,20 @@ static int rpmsgfs_open(FAR struct file *filep, FAR const char *relpath,
    * file.
    */
 
+  if ((oflags & (O_CREAT | O_TRUNC)) != 0)
+    {
+      rpmsgfs_statcache_flush(fs);
+    }
+
   if ((oflags & (O_APPEND | O_WRONLY)) == (O_APPEND | O_WRONLY))
     {
       ret = rpmsgfs_client_lseek(fs->handle, hf->fd, 0, SEEK_END);
       if (ret >= 0)
         {
           filep->f_pos = ret;
+#ifdef RPMSGFS_BUFFERED
+          hf->pos      = ret;
+#endif
         }
       else
         {
@@ -369,6 +809,9 @@ static int rpmsgfs_open(FAR struct file *filep, FAR const char *relpath,
   goto errout_with_lock;
 
 errout_with_buffer:
+#if CONFIG_FS_RPMSGFS_READAHEAD > 0
+  fs_heap_free(hf->rabuf);
+#endif
   fs_heap_free(hf);
 
 errout_with_lock:
@@ -457,18 +900,32 @@ static int rpmsgfs_close(FAR struct file *filep)
         }
     }
 
-  /* Close the host file */
+  /* Send what is left in the write-behind buffer and close the host
+   * file
+   */
 
+  ret = rpmsgfs_flush(fs, hf);
   rpmsgfs_client_close(fs->handle, hf->fd);
+  if ((hf->oflags & O_WROK) != 0)
+    {
+      rpmsgfs_statcache_flush(fs);
+    }
 
   /* Now free the pointer */
 
+#if CONFIG_FS_RPMSGFS_READAHEAD > 0
+  fs_heap_free(hf->rabuf);
+#endif
+#if CONFIG_FS_RPMSGFS_WRITEBEHIND > 0
+  fs_heap_free(hf->wbbuf);
+#endif
+
   filep->f_priv = NULL;
   fs_heap_free(hf);
 
 okout:
   nxmutex_unlock(&fs->fs_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -503,14 +960,39 @@ static ssize_t rpmsgfs_read(FAR struct file *filep, FAR char *buffer,
       return ret;
     }
 
+  /* Written data waiting to be sent may be read back */
+
+  ret = rpmsgfs_flush(fs, hf);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
   /* Call the host to perform the read */
 
+#if CONFIG_FS_RPMSGFS_READAHEAD > 0
+  ret = rpmsgfs_readahead(fs, hf, filep->f_pos, buffer, buflen);
+#else
+#  ifdef RPMSGFS_BUFFERED
+  ret = rpmsgfs_setpos(fs, hf, filep->f_pos);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+#  endif
+
   ret = rpmsgfs_client_read(fs->handle, hf->fd, buffer, buflen);
+#  ifdef RPMSGFS_BUFFERED
+  rpmsgfs_advance(hf, ret, false);
+#  endif
+#endif
+
   if (ret > 0)
     {
       filep->f_pos += ret;
     }
 
+errout_with_lock:
   nxmutex_unlock(&fs->fs_lock);
   return ret;
 }
@@ -555,15 +1037,65 @@ static ssize_t rpmsgfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_lock;
     }
 
+  rpmsgfs_dropra(hf);
+
+#if CONFIG_FS_RPMSGFS_WRITEBEHIND > 0
+  /* Only a write that goes on where the buffered data ends is added to
+   * it.  The buffer is sent when it is full.
+   */
+
+  if (hf->wblen > 0 &&
+      (filep->f_pos != hf->wbpos + (off_t)hf->wblen ||
+       hf->wblen + buflen > CONFIG_FS_RPMSGFS_WRITEBEHIND))
+    {
+      ret = rpmsgfs_flush(fs, hf);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+    }
+
+  if (hf->wbbuf == NULL && buflen < CONFIG_FS_RPMSGFS_WRITEBEHIND)
+    {
+      hf->wbbuf = fs_heap_malloc(CONFIG_FS_RPMSGFS_WRITEBEHIND);
+    }
+
+  if (hf->wbbuf != NULL && buflen < CONFIG_FS_RPMSGFS_WRITEBEHIND)
+    {
+      if (hf->wblen == 0)
+        {
+          hf->wbpos = filep->f_pos;
+        }
+
+      memcpy(hf->wbbuf + hf->wblen, buffer, buflen);
+      hf->wblen    += buflen;
+      filep->f_pos += buflen;
+      ret           = buflen;
+      goto errout_with_lock;
+    }
+#endif
+
+#ifdef RPMSGFS_BUFFERED
+  ret = rpmsgfs_setpos(fs, hf, filep->f_pos);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+#endif
+
   /* Call the host to perform the write */
 
   ret = rpmsgfs_client_write(fs->handle, hf->fd, buffer, buflen);
+#ifdef RPMSGFS_BUFFERED
+  rpmsgfs_advance(hf, ret, true);
+#endif
   if (ret > 0)
     {
       filep->f_pos += ret;
     }
 
 errout_with_lock:
+  rpmsgfs_statcache_flush(fs);
   nxmutex_unlock(&fs->fs_lock);
   return ret;
 }
@@ -599,6 +1131,22 @@ static off_t rpmsgfs_seek(FAR struct file *filep, off_t offset, int whence)
       return ret;
     }
 
+  ret = rpmsgfs_flush(fs, hf);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+#ifdef RPMSGFS_BUFFERED
+  /* The remote position is not the file position of this file */
+
+  if (whence == SEEK_CUR)
+    {
+      offset += filep->f_pos;
+      whence  = SEEK_SET;
+    }
+#endif
+
   /* Call our internal routine to perform the seek */
 
   ret = rpmsgfs_client_lseek(fs->handle, hf->fd, offset, whence);
@@ -607,6 +1155,11 @@ static off_t rpmsgfs_seek(FAR struct file *filep, off_t offset, int whence)
       filep->f_pos = ret;
     }
 
+#ifdef RPMSGFS_BUFFERED
+  hf->pos = ret >= 0 ? ret : -1;
+#endif
+
+errout_with_lock:
   nxmutex_unlock(&fs->fs_lock);
   return ret;
 }
@@ -642,6 +1195,13 @@ static int rpmsgfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return ret;
     }
 
+  ret = rpmsgfs_flush(fs, hf);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&fs->fs_lock);
+      return ret;
+    }
+
   /* Call our internal routine to perform the ioctl */
 
   ret = rpmsgfs_client_ioctl(fs->handle, hf->fd, cmd, arg);
@@ -689,10 +1249,13 @@ static int rpmsgfs_sync(FAR struct file *filep)
       return ret;
     }
 
+  /* The data that is written behind gets to the remote first */
+
+  ret = rpmsgfs_flush(fs, hf);
   rpmsgfs_client_sync(fs->handle, hf->fd);
 
   nxmutex_unlock(&fs->fs_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -763,9 +1326,13 @@ static int rpmsgfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
       return ret;
     }
 
-  /* Call the host to perform the read */
+  /* The size must include the data that is written behind */
 
-  ret = rpmsgfs_client_fstat(fs->handle, hf->fd, buf);
+  ret = rpmsgfs_flush(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_fstat(fs->handle, hf->fd, buf);
+    }
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -812,6 +1379,7 @@ static int rpmsgfs_fchstat(FAR const struct file *filep,
   /* Call the host to perform the change */
 
   ret = rpmsgfs_client_fchstat(fs->handle, hf->fd, buf, flags);
+  rpmsgfs_statcache_flush(fs);
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -850,9 +1418,19 @@ static int rpmsgfs_truncate(FAR struct file *filep, off_t length)
       return ret;
     }
 
+  ret = rpmsgfs_flush(fs, hf);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&fs->fs_lock);
+      return ret;
+    }
+
+  rpmsgfs_dropra(hf);
+
   /* Call the host to perform the truncate */
 
   ret = rpmsgfs_client_ftruncate(fs->handle, hf->fd, length);
+  rpmsgfs_statcache_flush(fs);
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -894,13 +1472,14 @@ static int rpmsgfs_opendir(FAR struct inode *mountpt,
       return -ENOMEM;
     }
 
-  /* Take the lock */
-
-  ret = nxmutex_lock(&fs->fs_lock);
-  if (ret < 0)
+#ifdef CONFIG_FS_RPMSGFS_BATCH
+  rdir->buf = fs_heap_malloc(RPMSGFS_DIRBUF_SIZE);
+  if (rdir->buf == NULL)
     {
+      ret = -ENOMEM;
       goto errout_with_rdir;
     }
+#endif
 
   /* Append to the host's root directory */
 
@@ -912,19 +1491,18 @@ static int rpmsgfs_opendir(FAR struct inode *mountpt,
   if (rdir->dir == NULL)
     {
       ret = -ENOENT;
-      goto errout_with_lock;
+      goto errout_with_rdir;
     }
 
   *dir = (FAR struct fs_dirent_s *)rdir;
-  nxmutex_unlock(&fs->fs_lock);
   lib_put_pathbuffer(path);
   return OK;
 
-errout_with_lock:
-  nxmutex_unlock(&fs->fs_lock);
-
 errout_with_rdir:
   lib_put_pathbuffer(path);
+#ifdef CONFIG_FS_RPMSGFS_BATCH
+  fs_heap_free(rdir->buf);
+#endif
   fs_heap_free(rdir);
   return ret;
 }
@@ -941,7 +1519,6 @@ static int rpmsgfs_closedir(FAR struct inode *mountpt,
 {
   FAR struct rpmsgfs_mountpt_s *fs;
   FAR struct rpmsgfs_dir_s *rdir;
-  int ret;
 
   /* Sanity checks */
 
@@ -952,19 +1529,13 @@ static int rpmsgfs_closedir(FAR struct inode *mountpt,
   fs = mountpt->i_private;
   rdir = (FAR struct rpmsgfs_dir_s *)dir;
 
-  /* Take the lock */
-
-  ret = nxmutex_lock(&fs->fs_lock);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
   /* Call the host's closedir function */
 
   rpmsgfs_client_closedir(fs->handle, rdir->dir);
 
-  nxmutex_unlock(&fs->fs_lock);
+#ifdef CONFIG_FS_RPMSGFS_BATCH
+  fs_heap_free(rdir->buf);
+#endif
   fs_heap_free(rdir);
   return OK;
 }
@@ -982,6 +1553,9 @@ static int rpmsgfs_readdir(FAR struct inode *mountpt,
 {
   FAR struct rpmsgfs_mountpt_s *fs;
   FAR struct rpmsgfs_dir_s *rdir;
+#ifdef CONFIG_FS_RPMSGFS_BATCH
+  FAR struct rpmsgfs_dirent_s *ent;
+#endif
   int ret;
 
   /* Sanity checks */
@@ -993,19 +1567,42 @@ static int rpmsgfs_readdir(FAR struct inode *mountpt,
   fs = mountpt->i_private;
   rdir = (FAR struct rpmsgfs_dir_s *)dir;
 
-  /* Take the lock */
+#ifdef CONFIG_FS_RPMSGFS_BATCH
+  /* Fetch as many entries as fit into one message when all of the
+   * previous ones were returned
+   */
 
-  ret = nxmutex_lock(&fs->fs_lock);
-  if (ret < 0)
+  if (rdir->off >= rdir->len)
     {
-      return ret;
+      rdir->off = 0;
+      rdir->len = RPMSGFS_DIRBUF_SIZE;
+      ret = rpmsgfs_client_readdirs(fs->handle, rdir->dir, rdir->buf,
+                                    &rdir->len);
+      if (ret <= 0)
+        {
+          rdir->len = 0;
+          return ret < 0 ? ret : -ENOENT;
+        }
+    }
+
+  ent = (FAR struct rpmsgfs_dirent_s *)(rdir->buf + rdir->off);
+  if (ent->reclen <= sizeof(*ent) || ent->reclen > rdir->len - rdir->off)
+    {
+      rdir->len = 0;
+      return -EIO;
     }
 
+  strlcpy(entry->d_name, ent->name,
+          MIN(sizeof(entry->d_name), ent->reclen - sizeof(*ent)));
+  entry->d_type = ent->type;
+  rdir->off    += ent->reclen;
+  ret           = OK;
+#else
   /* Call the host OS's readdir function */
 
   ret = rpmsgfs_client_readdir(fs->handle, rdir->dir, entry);
+#endif
 
-  nxmutex_unlock(&fs->fs_lock);
   return ret;
 }
 
@@ -1021,7 +1618,6 @@ static int rpmsgfs_rewinddir(FAR struct inode *mountpt,
 {
   FAR struct rpmsgfs_mountpt_s *fs;
   FAR struct rpmsgfs_dir_s *rdir;
-  int ret;
 
   /* Sanity checks */
 
@@ -1032,19 +1628,15 @@ static int rpmsgfs_rewinddir(FAR struct inode *mountpt,
   fs = mountpt->i_private;
   rdir = (FAR struct rpmsgfs_dir_s *)dir;
 
-  /* Take the lock */
-
-  ret = nxmutex_lock(&fs->fs_lock);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
   /* Call the host and let it do all the work */
 
   rpmsgfs_client_rewinddir(fs->handle, rdir->dir);
 
-  nxmutex_unlock(&fs->fs_lock);
+#ifdef CONFIG_FS_RPMSGFS_BATCH
+  rdir->off = 0;
+  rdir->len = 0;
+#endif
+
   return OK;
 }
 
@@ -1209,6 +1801,13 @@ static int rpmsgfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       return ret;
     }
 
+#if CONFIG_FS_RPMSGFS_STAT_TTL > 0
+  for (ret = 0; ret < CONFIG_FS_RPMSGFS_STAT_NCACHE; ret++)
+    {
+      fs_heap_free(fs->fs_stat[ret].path);
+    }
+#endif
+
   nxmutex_destroy(&fs->fs_lock);
   fs_heap_free(fs);
   return 0;
@@ -1234,16 +1833,9 @@ static int rpmsgfs_statfs(FAR struct inode *mountpt, FAR struct statfs *buf)
 
   fs = mountpt->i_private;
 
-  ret = nxmutex_lock(&fs->fs_lock);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
   ret = rpmsgfs_client_statfs(fs->handle, fs->fs_root, buf);
   buf->f_type = RPMSGFS_MAGIC;
 
-  nxmutex_unlock(&fs->fs_lock);
   return ret;
 }
 
@@ -1274,13 +1866,6 @@ static int rpmsgfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
       return -ENOMEM;
     }
 
-  ret = nxmutex_lock(&fs->fs_lock);
-  if (ret < 0)
-    {
-      lib_put_pathbuffer(path);
-      return ret;
-    }
-
   /* Append to the host's root directory */
 
   rpmsgfs_mkpath(fs, relpath, path, PATH_MAX);
@@ -1288,8 +1873,8 @@ static int rpmsgfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host fs to perform the unlink */
 
   ret = rpmsgfs_client_unlink(fs->handle, path);
+  rpmsgfs_statcache_flush(fs);
 
-  nxmutex_unlock(&fs->fs_lock);
   lib_put_pathbuffer(path);
   return ret;
 }
@@ -1322,13 +1907,6 @@ static int rpmsgfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
       return -ENOMEM;
     }
 
-  ret = nxmutex_lock(&fs->fs_lock);
-  if (ret < 0)
-    {
-      lib_put_pathbuffer(path);
-      return ret;
-    }
-
   /* Append to the host's root directory */
 
   rpmsgfs_mkpath(fs, relpath, path, PATH_MAX);
@@ -1336,8 +1914,8 @@ static int rpmsgfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the mkdir */
 
   ret = rpmsgfs_client_mkdir(fs->handle, path, mode);
+  rpmsgfs_statcache_flush(fs);
 
-  nxmutex_unlock(&fs->fs_lock);
   lib_put_pathbuffer(path);
   return ret;
 }
@@ -1363,21 +1941,12 @@ int rpmsgfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   fs = mountpt->i_private;
 
-  /* Take the lock */
-
   path = lib_get_pathbuffer();
   if (path == NULL)
     {
       return -ENOMEM;
     }
 
-  ret = nxmutex_lock(&fs->fs_lock);
-  if (ret < 0)
-    {
-      lib_put_pathbuffer(path);
-      return ret;
-    }
-
   /* Append to the host's root directory */
 
   rpmsgfs_mkpath(fs, relpath, path, PATH_MAX);
@@ -1385,8 +1954,8 @@ int rpmsgfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host FS to do the mkdir */
 
   ret = rpmsgfs_client_rmdir(fs->handle, path);
+  rpmsgfs_statcache_flush(fs);
 
-  nxmutex_unlock(&fs->fs_lock);
   lib_put_pathbuffer(path);
   return ret;
 }
@@ -1427,14 +1996,6 @@ int rpmsgfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
 
   fs = mountpt->i_private;
 
-  ret = nxmutex_lock(&fs->fs_lock);
-  if (ret < 0)
-    {
-      lib_put_pathbuffer(oldpath);
-      lib_put_pathbuffer(newpath);
-      return ret;
-    }
-
   /* Append to the host's root directory */
 
   strlcpy(oldpath, fs->fs_root, PATH_MAX);
@@ -1445,8 +2006,8 @@ int rpmsgfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
   /* Call the host FS to do the mkdir */
 
   ret = rpmsgfs_client_rename(fs->handle, oldpath, newpath);
+  rpmsgfs_statcache_flush(fs);
 
-  nxmutex_unlock(&fs->fs_lock);
   lib_put_pathbuffer(oldpath);
   lib_put_pathbuffer(newpath);
   return ret;
@@ -1464,6 +2025,9 @@ static int rpmsgfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 {
   FAR struct rpmsgfs_mountpt_s *fs;
   FAR char *path;
+#if CONFIG_FS_RPMSGFS_STAT_TTL > 0
+  unsigned int gen;
+#endif
   int ret;
 
   /* Sanity checks */
@@ -1480,6 +2044,15 @@ static int rpmsgfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
       return -ENOMEM;
     }
 
+  /* Append to the host's root directory */
+
+  rpmsgfs_mkpath(fs, relpath, path, PATH_MAX);
+
+  /* Call the host FS to do the stat operation.  The lock only protects
+   * the cache, other requests may be sent while this one is outstanding.
+   */
+
+#if CONFIG_FS_RPMSGFS_STAT_TTL > 0
   ret = nxmutex_lock(&fs->fs_lock);
   if (ret < 0)
     {
@@ -1487,15 +2060,26 @@ static int rpmsgfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
       return ret;
     }
 
-  /* Append to the host's root directory */
-
-  rpmsgfs_mkpath(fs, relpath, path, PATH_MAX);
+  if (rpmsgfs_statcache_get(fs, path, buf))
+    {
+      nxmutex_unlock(&fs->fs_lock);
+      lib_put_pathbuffer(path);
+      return OK;
+    }
 
-  /* Call the host FS to do the stat operation */
+  gen = atomic_load(&fs->fs_statgen);
+  nxmutex_unlock(&fs->fs_lock);
 
   ret = rpmsgfs_client_stat(fs->handle, path, buf);
+  if (ret >= 0 && nxmutex_lock(&fs->fs_lock) >= 0)
+    {
+      rpmsgfs_statcache_put(fs, path, buf, gen);
+      nxmutex_unlock(&fs->fs_lock);
+    }
+#else
+  ret = rpmsgfs_client_stat(fs->handle, path, buf);
+#endif
 
-  nxmutex_unlock(&fs->fs_lock);
   lib_put_pathbuffer(path);
   return ret;
 }
@@ -1528,13 +2112,6 @@ static int rpmsgfs_chstat(FAR struct inode *mountpt, FAR const char *relpath,
       return -ENOMEM;
     }
 
-  ret = nxmutex_lock(&fs->fs_lock);
-  if (ret < 0)
-    {
-      lib_put_pathbuffer(path);
-      return ret;
-    }
-
   /* Append to the host's root directory */
 
   rpmsgfs_mkpath(fs, relpath, path, PATH_MAX);
@@ -1542,8 +2119,8 @@ static int rpmsgfs_chstat(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the chstat operation */
 
   ret = rpmsgfs_client_chstat(fs->handle, path, buf, flags);
+  rpmsgfs_statcache_flush(fs);
 
-  nxmutex_unlock(&fs->fs_lock);
   lib_put_pathbuffer(path);
   return ret;
 }
@@ -58,6 +58,8 @@
 #define RPMSGFS_STAT            20
 #define RPMSGFS_FCHSTAT         21
 #define RPMSGFS_CHSTAT          22
+#define RPMSGFS_READDIRS        23
+#define RPMSGFS_OPENREAD        24
 
 /****************************************************************************
  * Public Types
@@ -168,6 +170,25 @@ begin_packed_struct struct rpmsgfs_readdir_s
   char                    name[0];
 } end_packed_struct;
 
+/* RPMSGFS_READDIRS returns as many entries as fit into 'size' bytes, the
+ * result is the number of entries and 0 at the end of the directory.
+ */
+
+begin_packed_struct struct rpmsgfs_dirent_s
+{
+  uint16_t                reclen;   /* Length of the entry with its name */
+  uint8_t                 type;
+  char                    name[0];
+} end_packed_struct;
+
+begin_packed_struct struct rpmsgfs_readdirs_s
+{
+  struct rpmsgfs_header_s header;
+  int32_t                 fd;
+  uint32_t                size;     /* Space for entries, bytes used */
+  char                    buf[0];   /* struct rpmsgfs_dirent_s entries */
+} end_packed_struct;
+
 #define rpmsgfs_rewinddir_s rpmsgfs_close_s
 #define rpmsgfs_closedir_s rpmsgfs_close_s
 
@@ -214,6 +235,20 @@ begin_packed_struct struct rpmsgfs_fchstat_s
 
 #define rpmsgfs_chstat_s rpmsgfs_fchstat_s
 
+/* RPMSGFS_OPENREAD opens a file, returns fstat() of it and, if it is a
+ * regular file, the first 'count' bytes of it in one round trip.
+ */
+
+begin_packed_struct struct rpmsgfs_openread_s
+{
+  struct rpmsgfs_header_s    header;
+  int32_t                    flags;
+  int32_t                    mode;
+  uint32_t                   count;   /* Bytes to read, bytes read */
+  struct rpmsgfs_stat_priv_s buf;
+  char                       data[0]; /* The pathname, the data read */
+} end_packed_struct;
+
 /****************************************************************************
  * Internal function prototypes
  ****************************************************************************/
@@ -239,6 +274,12 @@ int       rpmsgfs_client_ftruncate(FAR void *handle, int fd, off_t length);
 FAR void *rpmsgfs_client_opendir(FAR void *handle, FAR const char *name);
 int       rpmsgfs_client_readdir(FAR void *handle, FAR void *dirp,
                                  FAR struct dirent *entry);
+int       rpmsgfs_client_readdirs(FAR void *handle, FAR void *dirp,
+                                  FAR void *buf, FAR size_t *size);
+int       rpmsgfs_client_openread(FAR void *handle,
+                                  FAR const char *pathname, int flags,
+                                  int mode, FAR void *buf,
+                                  FAR size_t *count, FAR struct stat *st);
 void      rpmsgfs_client_rewinddir(FAR void *handle, FAR void *dirp);
 int       rpmsgfs_client_bind(FAR void **handle, FAR const char *cpuname);
 int       rpmsgfs_client_unbind(FAR void *handle);
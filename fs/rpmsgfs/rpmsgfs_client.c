@@ -56,6 +56,15 @@ struct rpmsgfs_cookie_s
   FAR void *data;
 };
 
+/* The buffers of rpmsgfs_client_openread() */
+
+struct rpmsgfs_openread_arg_s
+{
+  FAR void        *buf;
+  size_t          count;
+  FAR struct stat *st;
+};
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -78,6 +87,12 @@ static int rpmsgfs_statfs_handler(FAR struct rpmsg_endpoint *ept,
 static int rpmsgfs_stat_handler(FAR struct rpmsg_endpoint *ept,
                                  FAR void *data, size_t len,
                                  uint32_t src, FAR void *priv);
+static int rpmsgfs_readdirs_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv);
+static int rpmsgfs_openread_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv);
 static void rpmsgfs_device_created(struct rpmsg_device *rdev,
                                    FAR void *priv_);
 static void rpmsgfs_device_destroy(struct rpmsg_device *rdev,
@@ -118,12 +133,35 @@ static const rpmsg_ept_cb g_rpmsgfs_handler[] =
   [RPMSGFS_STAT]      = rpmsgfs_stat_handler,
   [RPMSGFS_FCHSTAT]   = rpmsgfs_default_handler,
   [RPMSGFS_CHSTAT]    = rpmsgfs_default_handler,
+  [RPMSGFS_READDIRS]  = rpmsgfs_readdirs_handler,
+  [RPMSGFS_OPENREAD]  = rpmsgfs_openread_handler,
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+static void rpmsgfs_unpack_stat(FAR struct stat *buf,
+                                FAR const struct rpmsgfs_stat_priv_s *priv)
+{
+  buf->st_dev          = priv->dev;
+  buf->st_ino          = priv->ino;
+  buf->st_mode         = priv->mode;
+  buf->st_nlink        = priv->nlink;
+  buf->st_uid          = priv->uid;
+  buf->st_gid          = priv->gid;
+  buf->st_rdev         = priv->rdev;
+  buf->st_size         = priv->size;
+  buf->st_atim.tv_sec  = priv->atim_sec;
+  buf->st_atim.tv_nsec = priv->atim_nsec;
+  buf->st_mtim.tv_sec  = priv->mtim_sec;
+  buf->st_mtim.tv_nsec = priv->mtim_nsec;
+  buf->st_ctim.tv_sec  = priv->ctim_sec;
+  buf->st_ctim.tv_nsec = priv->ctim_nsec;
+  buf->st_blksize      = priv->blksize;
+  buf->st_blocks       = priv->blocks;
+}
+
 static int rpmsgfs_default_handler(FAR struct rpmsg_endpoint *ept,
                                    FAR void *data, size_t len,
                                    uint32_t src, FAR void *priv)
@@ -251,22 +289,52 @@ static int rpmsgfs_stat_handler(FAR struct rpmsg_endpoint *ept,
   cookie->result = header->result;
   if (cookie->result >= 0)
     {
-      buf->st_dev          = rsp->buf.dev;
-      buf->st_ino          = rsp->buf.ino;
-      buf->st_mode         = rsp->buf.mode;
-      buf->st_nlink        = rsp->buf.nlink;
-      buf->st_uid          = rsp->buf.uid;
-      buf->st_gid          = rsp->buf.gid;
-      buf->st_rdev         = rsp->buf.rdev;
-      buf->st_size         = rsp->buf.size;
-      buf->st_atim.tv_sec  = rsp->buf.atim_sec;
-      buf->st_atim.tv_nsec = rsp->buf.atim_nsec;
-      buf->st_mtim.tv_sec  = rsp->buf.mtim_sec;
-      buf->st_mtim.tv_nsec = rsp->buf.mtim_nsec;
-      buf->st_ctim.tv_sec  = rsp->buf.ctim_sec;
-      buf->st_ctim.tv_nsec = rsp->buf.ctim_nsec;
-      buf->st_blksize      = rsp->buf.blksize;
-      buf->st_blocks       = rsp->buf.blocks;
+      rpmsgfs_unpack_stat(buf, &rsp->buf);
+    }
+
+  rpmsg_post(ept, &cookie->sem);
+
+  return 0;
+}
+
+static int rpmsgfs_readdirs_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgfs_header_s *header = data;
+  FAR struct rpmsgfs_cookie_s *cookie =
+      (FAR struct rpmsgfs_cookie_s *)(uintptr_t)header->cookie;
+  FAR struct rpmsgfs_readdirs_s *rsp = data;
+  FAR struct iovec *iov = cookie->data;
+
+  cookie->result = header->result;
+  if (cookie->result >= 0)
+    {
+      iov->iov_len = MIN(iov->iov_len, MIN(rsp->size, len - sizeof(*rsp)));
+      memcpy(iov->iov_base, rsp->buf, iov->iov_len);
+    }
+
+  rpmsg_post(ept, &cookie->sem);
+
+  return 0;
+}
+
+static int rpmsgfs_openread_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgfs_header_s *header = data;
+  FAR struct rpmsgfs_cookie_s *cookie =
+      (FAR struct rpmsgfs_cookie_s *)(uintptr_t)header->cookie;
+  FAR struct rpmsgfs_openread_s *rsp = data;
+  FAR struct rpmsgfs_openread_arg_s *arg = cookie->data;
+
+  cookie->result = header->result;
+  if (cookie->result >= 0)
+    {
+      rpmsgfs_unpack_stat(arg->st, &rsp->buf);
+      arg->count = MIN(arg->count, MIN(rsp->count, len - sizeof(*rsp)));
+      memcpy(arg->buf, rsp->data, arg->count);
     }
 
   rpmsg_post(ept, &cookie->sem);
@@ -447,6 +515,42 @@ int rpmsgfs_client_open(FAR void *handle, FAR const char *pathname,
           (struct rpmsgfs_header_s *)msg, len, NULL);
 }
 
+int rpmsgfs_client_openread(FAR void *handle, FAR const char *pathname,
+                            int flags, int mode, FAR void *buf,
+                            FAR size_t *count, FAR struct stat *st)
+{
+  FAR struct rpmsgfs_s *priv = handle;
+  FAR struct rpmsgfs_openread_s *msg;
+  struct rpmsgfs_openread_arg_s arg;
+  uint32_t space;
+  size_t len;
+  int ret;
+
+  len = sizeof(*msg) + strlen(pathname) + 1;
+
+  msg = rpmsgfs_get_tx_payload_buffer(priv, &space);
+  if (!msg)
+    {
+      return -ENOMEM;
+    }
+
+  DEBUGASSERT(len <= space);
+
+  arg.buf   = buf;
+  arg.count = *count;
+  arg.st    = st;
+
+  msg->flags = flags;
+  msg->mode  = mode;
+  msg->count = *count;
+  strlcpy(msg->data, pathname, space - sizeof(*msg));
+
+  ret = rpmsgfs_send_recv(priv, RPMSGFS_OPENREAD, false,
+          (struct rpmsgfs_header_s *)msg, len, &arg);
+  *count = ret >= 0 ? arg.count : 0;
+  return ret;
+}
+
 int rpmsgfs_client_close(FAR void *handle, int fd)
 {
   struct rpmsgfs_close_s msg =
@@ -723,6 +827,29 @@ int rpmsgfs_client_readdir(FAR void *handle, FAR void *dirp,
           (struct rpmsgfs_header_s *)&msg, sizeof(msg), entry);
 }
 
+int rpmsgfs_client_readdirs(FAR void *handle, FAR void *dirp,
+                            FAR void *buf, FAR size_t *size)
+{
+  struct iovec iov =
+    {
+      .iov_base = buf,
+      .iov_len  = *size,
+    };
+
+  struct rpmsgfs_readdirs_s msg =
+  {
+    .fd   = (uintptr_t)dirp,
+    .size = *size,
+  };
+
+  int ret;
+
+  ret = rpmsgfs_send_recv(handle, RPMSGFS_READDIRS, true,
+          (struct rpmsgfs_header_s *)&msg, sizeof(msg), &iov);
+  *size = ret > 0 ? iov.iov_len : 0;
+  return ret;
+}
+
 void rpmsgfs_client_rewinddir(FAR void *handle, FAR void *dirp)
 {
   struct rpmsgfs_rewinddir_s msg =
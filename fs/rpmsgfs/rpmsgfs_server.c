@@ -124,6 +124,12 @@ static int rpmsgfs_fchstat_handler(FAR struct rpmsg_endpoint *ept,
 static int rpmsgfs_chstat_handler(FAR struct rpmsg_endpoint *ept,
                                   FAR void *data, size_t len,
                                   uint32_t src, FAR void *priv);
+static int rpmsgfs_readdirs_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv);
+static int rpmsgfs_openread_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv);
 
 static bool rpmsgfs_ns_match(FAR struct rpmsg_device *rdev,
                              FAR void *priv_, FAR const char *name,
@@ -163,12 +169,35 @@ static const rpmsg_ept_cb g_rpmsgfs_handler[] =
   [RPMSGFS_STAT]      = rpmsgfs_stat_handler,
   [RPMSGFS_FCHSTAT]   = rpmsgfs_fchstat_handler,
   [RPMSGFS_CHSTAT]    = rpmsgfs_chstat_handler,
+  [RPMSGFS_READDIRS]  = rpmsgfs_readdirs_handler,
+  [RPMSGFS_OPENREAD]  = rpmsgfs_openread_handler,
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+static void rpmsgfs_pack_stat(FAR struct rpmsgfs_stat_priv_s *priv,
+                              FAR const struct stat *buf)
+{
+  priv->dev       = buf->st_dev;
+  priv->ino       = buf->st_ino;
+  priv->mode      = buf->st_mode;
+  priv->nlink     = buf->st_nlink;
+  priv->uid       = buf->st_uid;
+  priv->gid       = buf->st_gid;
+  priv->rdev      = buf->st_rdev;
+  priv->size      = buf->st_size;
+  priv->atim_sec  = buf->st_atim.tv_sec;
+  priv->atim_nsec = buf->st_atim.tv_nsec;
+  priv->mtim_sec  = buf->st_mtim.tv_sec;
+  priv->mtim_nsec = buf->st_mtim.tv_nsec;
+  priv->ctim_sec  = buf->st_ctim.tv_sec;
+  priv->ctim_nsec = buf->st_ctim.tv_nsec;
+  priv->blksize   = buf->st_blksize;
+  priv->blocks    = buf->st_blocks;
+}
+
 static int rpmsgfs_alloc_file(FAR struct rpmsgfs_server_s *priv,
                               FAR struct file **filep)
 {
@@ -536,22 +565,7 @@ static int rpmsgfs_fstat_handler(FAR struct rpmsg_endpoint *ept,
       ret = file_fstat(filep, &buf);
       if (ret >= 0)
         {
-          msg->buf.dev       = buf.st_dev;
-          msg->buf.ino       = buf.st_ino;
-          msg->buf.mode      = buf.st_mode;
-          msg->buf.nlink     = buf.st_nlink;
-          msg->buf.uid       = buf.st_uid;
-          msg->buf.gid       = buf.st_gid;
-          msg->buf.rdev      = buf.st_rdev;
-          msg->buf.size      = buf.st_size;
-          msg->buf.atim_sec  = buf.st_atim.tv_sec;
-          msg->buf.atim_nsec = buf.st_atim.tv_nsec;
-          msg->buf.mtim_sec  = buf.st_mtim.tv_sec;
-          msg->buf.mtim_nsec = buf.st_mtim.tv_nsec;
-          msg->buf.ctim_sec  = buf.st_ctim.tv_sec;
-          msg->buf.ctim_nsec = buf.st_ctim.tv_nsec;
-          msg->buf.blksize   = buf.st_blksize;
-          msg->buf.blocks    = buf.st_blocks;
+          rpmsgfs_pack_stat(&msg->buf, &buf);
         }
     }
 
@@ -757,22 +771,7 @@ static int rpmsgfs_stat_handler(FAR struct rpmsg_endpoint *ept,
   ret = nx_stat(msg->pathname, &buf, 1);
   if (ret >= 0)
     {
-      msg->buf.dev       = buf.st_dev;
-      msg->buf.ino       = buf.st_ino;
-      msg->buf.mode      = buf.st_mode;
-      msg->buf.nlink     = buf.st_nlink;
-      msg->buf.uid       = buf.st_uid;
-      msg->buf.gid       = buf.st_gid;
-      msg->buf.rdev      = buf.st_rdev;
-      msg->buf.size      = buf.st_size;
-      msg->buf.atim_sec  = buf.st_atim.tv_sec;
-      msg->buf.atim_nsec = buf.st_atim.tv_nsec;
-      msg->buf.mtim_sec  = buf.st_mtim.tv_sec;
-      msg->buf.mtim_nsec = buf.st_mtim.tv_nsec;
-      msg->buf.ctim_sec  = buf.st_ctim.tv_sec;
-      msg->buf.ctim_nsec = buf.st_ctim.tv_nsec;
-      msg->buf.blksize   = buf.st_blksize;
-      msg->buf.blocks    = buf.st_blocks;
+      rpmsgfs_pack_stat(&msg->buf, &buf);
     }
 
   msg->header.result = ret;
@@ -880,6 +879,136 @@ out:
   return rpmsg_send(ept, msg, sizeof(*msg));
 }
 
+static int rpmsgfs_readdirs_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgfs_readdirs_s *msg = data;
+  FAR struct rpmsgfs_readdirs_s *rsp;
+  FAR struct rpmsgfs_dirent_s *ent;
+  FAR struct dirent *entry;
+  FAR void *dir;
+  uint32_t space;
+  size_t used = 0;
+  size_t size;
+  int ret = -ENOENT;
+
+  rsp = rpmsg_get_tx_payload_buffer(ept, &space, true);
+  if (rsp == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  *rsp  = *msg;
+  space = MIN(space - sizeof(*rsp), msg->size);
+
+  dir = rpmsgfs_get_dir(priv, msg->fd);
+  if (dir != NULL)
+    {
+      ret = 0;
+
+      /* An entry cannot be given back to the directory, so the next one
+       * is only read while the longest name still fits.  The name of the
+       * first one is truncated like RPMSGFS_READDIR does.
+       */
+
+      while (space - used > sizeof(*ent) &&
+             (used == 0 || space - used >= sizeof(*ent) + NAME_MAX + 1))
+        {
+          entry = readdir(dir);
+          if (entry == NULL)
+            {
+              break;
+            }
+
+          ent  = (FAR struct rpmsgfs_dirent_s *)(rsp->buf + used);
+          size = MIN(space - used - sizeof(*ent),
+                     strlen(entry->d_name) + 1);
+
+          strlcpy(ent->name, entry->d_name, size);
+          ent->type   = entry->d_type;
+          ent->reclen = sizeof(*ent) + size;
+          used       += ent->reclen;
+          ret++;
+        }
+    }
+
+  rsp->header.result = ret;
+  rsp->size          = used;
+  if (rpmsg_send_nocopy(ept, rsp, sizeof(*rsp) + used) < 0)
+    {
+      rpmsg_release_tx_buffer(ept, rsp);
+    }
+
+  return 0;
+}
+
+static int rpmsgfs_openread_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgfs_openread_s *msg = data;
+  FAR struct rpmsgfs_openread_s *rsp;
+  FAR struct file *filep;
+  struct stat buf;
+  ssize_t nread = 0;
+  uint32_t space;
+  int ret;
+  int fd;
+
+  rsp = rpmsg_get_tx_payload_buffer(ept, &space, true);
+  if (rsp == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  *rsp = *msg;
+
+  ret = fd = rpmsgfs_alloc_file(priv, &filep);
+  if (ret < 0)
+    {
+      goto out;
+    }
+
+  ret = file_open(filep, msg->data, msg->flags, msg->mode);
+  if (ret < 0)
+    {
+      filep->f_inode = NULL;
+      goto out;
+    }
+
+  ret = file_fstat(filep, &buf);
+  if (ret < 0)
+    {
+      file_close(filep);
+      goto out;
+    }
+
+  rpmsgfs_pack_stat(&rsp->buf, &buf);
+
+  /* Only a regular file is read ahead, reading a device could lose data */
+
+  if (S_ISREG(buf.st_mode))
+    {
+      nread = file_read(filep, rsp->data,
+                        MIN(msg->count, space - sizeof(*rsp)));
+      if (nread < 0)
+        {
+          nread = 0;
+        }
+    }
+
+out:
+  rsp->header.result = ret < 0 ? ret : fd;
+  rsp->count         = nread;
+  if (rpmsg_send_nocopy(ept, rsp, sizeof(*rsp) + nread) < 0)
+    {
+      rpmsg_release_tx_buffer(ept, rsp);
+    }
+
+  return 0;
+}
+
 static bool rpmsgfs_ns_match(FAR struct rpmsg_device *rdev,
                              FAR void *priv_, FAR const char *name,
                              uint32_t dest)
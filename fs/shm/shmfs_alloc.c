@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <stdbool.h>
+#include <sys/param.h>
 
 #include <nuttx/arch.h>
 #include <nuttx/cache.h>
@@ -35,6 +36,14 @@
 #include "shm/shmfs.h"
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_SHMFS_LARGE_PAGES
+#  define CONFIG_FS_SHMFS_LARGE_PAGES 1
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -100,24 +109,42 @@ FAR struct shmfs_object_s *shmfs_alloc_object(size_t length)
    */
 
   size_t i = 0;
+  size_t j;
+  size_t n;
   FAR void **pages;
   size_t n_pages = MM_NPAGES(length);
+  size_t chunk = CONFIG_FS_SHMFS_LARGE_PAGES;
+  uintptr_t paddr;
 
   object = fs_heap_zalloc(sizeof(struct shmfs_object_s) +
                       (n_pages - 1) * sizeof(object->paddr));
 
   if (object)
     {
+      /* Take the pages in physically contiguous runs of a large page while
+       * the page pool has them, single pages make up the rest.
+       */
+
       pages = &object->paddr;
-      for (; i < n_pages; i++)
+      while (i < n_pages)
         {
-          pages[i] = (FAR void *)mm_pgalloc(1);
-          if (!pages[i])
+          n     = MIN(chunk, n_pages - i);
+          paddr = n > 1 ? mm_pgalloc(n) : 0;
+          if (paddr == 0)
             {
-              break;
+              n     = 1;
+              chunk = 1;
+              paddr = mm_pgalloc(1);
+              if (paddr == 0)
+                {
+                  break;
+                }
             }
-          else
+
+          for (j = 0; j < n; j++, i++)
             {
+              pages[i] = (FAR void *)(paddr + (j << MM_PGSHIFT));
+
               /* Clear the page memory (requirement for truncate) */
 
               up_addrenv_page_wipe((uintptr_t)pages[i]);
@@ -156,14 +183,22 @@ void shmfs_free_object(FAR struct shmfs_object_s *object)
       kumm_free(object->paddr);
 #elif defined(CONFIG_BUILD_KERNEL)
       size_t i;
+      size_t n;
       size_t n_pages = MM_NPAGES(object->length);
       FAR void **pages = &object->paddr;
-      for (i = 0; i < n_pages; i++)
+
+      /* Return the physically contiguous runs of pages at once */
+
+      for (i = 0; i < n_pages && pages[i]; i += n)
         {
-          if (pages[i])
+          n = 1;
+          while (i + n < n_pages &&
+                 pages[i + n] == (FAR char *)pages[i] + (n << MM_PGSHIFT))
             {
-              mm_pgfree((uintptr_t)pages[i], 1);
+              n++;
             }
+
+          mm_pgfree((uintptr_t)pages[i], n);
         }
 #endif
 
@@ -53,6 +53,10 @@ static int sock_file_ioctl(FAR struct file *filep, int cmd,
 static int sock_file_poll(FAR struct file *filep, struct pollfd *fds,
                           bool setup);
 static int sock_file_truncate(FAR struct file *filep, off_t length);
+#ifdef CONFIG_NET_SOCKET_MMAP
+static int sock_file_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -66,7 +70,11 @@ static const struct file_operations g_sock_fileops =
   sock_file_write,    /* write */
   NULL,               /* seek */
   sock_file_ioctl,    /* ioctl */
+#ifdef CONFIG_NET_SOCKET_MMAP
+  sock_file_mmap,     /* mmap */
+#else
   NULL,               /* mmap */
+#endif
   sock_file_truncate, /* truncate */
   sock_file_poll      /* poll */
 };
@@ -147,6 +155,21 @@ static int sock_file_truncate(FAR struct file *filep, off_t length)
   return -EINVAL;
 }
 
+#ifdef CONFIG_NET_SOCKET_MMAP
+static int sock_file_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map)
+{
+  FAR struct socket *psock = filep->f_priv;
+
+  if (psock->s_sockif == NULL || psock->s_sockif->si_mmap == NULL)
+    {
+      return -ENODEV;
+    }
+
+  return psock->s_sockif->si_mmap(psock, map);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
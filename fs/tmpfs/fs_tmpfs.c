@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <stdint.h>
@@ -94,6 +95,14 @@ static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+static int  tmpfs_fill_file(FAR struct tmpfs_file_s *tfo, size_t start,
+              size_t end);
+static FAR uint8_t *tmpfs_get_chunk(FAR struct tmpfs_file_s *tfo,
+              size_t index, FAR size_t *alloc);
+static void tmpfs_read_chunks(FAR struct tmpfs_file_s *tfo, size_t pos,
+              FAR uint8_t *buffer, size_t len);
+static void tmpfs_write_chunks(FAR struct tmpfs_file_s *tfo, size_t pos,
+              FAR const uint8_t *buffer, size_t len);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_release_file(FAR struct tmpfs_file_s *tfo);
@@ -129,6 +138,12 @@ static int  tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
               unsigned int index, FAR void *arg);
 static int  tmpfs_foreach(FAR struct tmpfs_directory_s *tdo,
               tmpfs_foreach_t callout, FAR void *arg);
+#ifdef CONFIG_MM_RECLAIM
+static size_t tmpfs_trim_directory(FAR struct tmpfs_directory_s *tdo);
+static int  tmpfs_reclaim_callout(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index, FAR void *arg);
+static size_t tmpfs_reclaim(FAR void *arg, bool nonblock);
+#endif
 
 /* File system operations */
 
@@ -157,6 +172,8 @@ static int  tmpfs_readdir(FAR struct inode *mountpt,
               FAR struct dirent *entry);
 static int  tmpfs_rewinddir(FAR struct inode *mountpt,
               FAR struct fs_dirent_s *dir);
+static int  tmpfs_seekdir(FAR struct inode *mountpt,
+              FAR struct fs_dirent_s *dir, off_t offset);
 static int  tmpfs_bind(FAR struct inode *blkdriver, FAR const void *data,
               FAR void **handle);
 static int  tmpfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
@@ -208,7 +225,10 @@ const struct mountpt_operations g_tmpfs_operations =
   tmpfs_rmdir,      /* rmdir */
   tmpfs_rename,     /* rename */
   tmpfs_stat,       /* stat */
-  NULL              /* chstat */
+  NULL,             /* chstat */
+  NULL,             /* syncfs */
+  NULL,             /* telldir */
+  tmpfs_seekdir     /* seekdir */
 };
 
 /****************************************************************************
@@ -266,82 +286,337 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
 
 /****************************************************************************
  * Name: tmpfs_realloc_file
+ *
+ * Description:
+ *   Change the size of a file.  The chunks beyond the new end of the file
+ *   are freed and the data after it is zeroed.  A file that grows gets no
+ *   new memory here, the added range is a hole until it is written.
+ *
  ****************************************************************************/
 
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
                               size_t newsize)
 {
+  FAR uint8_t **newchunks;
   FAR uint8_t *newdata;
+  size_t nchunks;
   size_t allocsize;
   size_t delta;
+  size_t i;
 
-  /* Are we growing or shrinking the object? */
-
-  if (newsize <= tfo->tfo_alloc)
+  nchunks = TMPFS_NCHUNKS(newsize);
+  if (nchunks > 1)
     {
-      /* Shrinking ... Shrink unconditionally if the size is shrinking to
-       * zero.
-       */
-
-      if (newsize == 0)
+      if (tfo->tfo_chunks == NULL)
         {
-          /* Free the file object */
+          /* The file outgrows its single chunk.  Move that into the first
+           * entry of a new chunk table, at the full chunk size.
+           */
 
-          fs_heap_free(tfo->tfo_data);
-          tfo->tfo_data = NULL;
-          tfo->tfo_alloc = 0;
-          tfo->tfo_size = 0;
-          return OK;
+          newchunks = fs_heap_zalloc(nchunks * sizeof(FAR uint8_t *));
+          if (newchunks == NULL)
+            {
+              return -ENOMEM;
+            }
+
+          if (tfo->tfo_data != NULL)
+            {
+              DEBUGASSERT(tfo->tfo_alloc <= TMPFS_CHUNKSIZE);
+
+              newdata = fs_heap_realloc(tfo->tfo_data, TMPFS_CHUNKSIZE);
+              if (newdata == NULL)
+                {
+                  fs_heap_free(newchunks);
+                  return -ENOMEM;
+                }
+
+              memset(newdata + tfo->tfo_alloc, 0,
+                     TMPFS_CHUNKSIZE - tfo->tfo_alloc);
+              newchunks[0]   = newdata;
+              tfo->tfo_alloc = TMPFS_CHUNKSIZE;
+              tfo->tfo_data  = NULL;
+            }
+
+          tfo->tfo_chunks  = newchunks;
+          tfo->tfo_nchunks = nchunks;
         }
-      else if (newsize > 0)
+      else if (nchunks > tfo->tfo_nchunks)
         {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
+          newchunks = fs_heap_realloc(tfo->tfo_chunks,
+                                      nchunks * sizeof(FAR uint8_t *));
+          if (newchunks == NULL)
+            {
+              return -ENOMEM;
+            }
 
-          delta = tfo->tfo_alloc - newsize;
+          memset(&newchunks[tfo->tfo_nchunks], 0,
+                 (nchunks - tfo->tfo_nchunks) * sizeof(FAR uint8_t *));
+          tfo->tfo_chunks  = newchunks;
+          tfo->tfo_nchunks = nchunks;
+        }
+      else if (nchunks < tfo->tfo_nchunks)
+        {
+          for (i = nchunks; i < tfo->tfo_nchunks; i++)
+            {
+              if (tfo->tfo_chunks[i] != NULL)
+                {
+                  fs_heap_free(tfo->tfo_chunks[i]);
+                  tfo->tfo_alloc -= TMPFS_CHUNKSIZE;
+                }
+            }
 
-          /* We should make sure the shrunked memory be zero */
+          /* Keep the larger table if it cannot be shrunk */
 
-          memset(tfo->tfo_data + newsize, 0, delta);
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
+          newchunks = fs_heap_realloc(tfo->tfo_chunks,
+                                      nchunks * sizeof(FAR uint8_t *));
+          if (newchunks != NULL)
             {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
-
-              tfo->tfo_size = newsize;
-              return OK;
+              tfo->tfo_chunks = newchunks;
             }
+
+          tfo->tfo_nchunks = nchunks;
+        }
+
+      /* Zero the data after the new end of the file in its last chunk */
+
+      newdata = tfo->tfo_chunks[nchunks - 1];
+      if (newsize < tfo->tfo_size && newdata != NULL)
+        {
+          delta = newsize - (nchunks - 1) * TMPFS_CHUNKSIZE;
+          memset(newdata + delta, 0, TMPFS_CHUNKSIZE - delta);
         }
+
+      tfo->tfo_size = newsize;
+      return OK;
     }
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
+  /* The file fits into a single chunk.  If it had a chunk table, keep only
+   * its first chunk.
    */
 
-  allocsize = newsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
-  if (allocsize < newsize)
+  if (tfo->tfo_chunks != NULL)
     {
-      /* There must have been an integer overflow */
+      for (i = 1; i < tfo->tfo_nchunks; i++)
+        {
+          fs_heap_free(tfo->tfo_chunks[i]);
+        }
 
-      return -ENOMEM;
+      tfo->tfo_data    = tfo->tfo_chunks[0];
+      tfo->tfo_alloc   = tfo->tfo_data != NULL ? TMPFS_CHUNKSIZE : 0;
+      fs_heap_free(tfo->tfo_chunks);
+      tfo->tfo_chunks  = NULL;
+      tfo->tfo_nchunks = 0;
     }
 
-  /* Realloc the file object */
+  /* Shrink unconditionally if the size is shrinking to zero. */
 
-  newdata = fs_heap_realloc(tfo->tfo_data, allocsize);
-  if (newdata == NULL)
+  if (newsize == 0)
     {
-      return -ENOMEM;
+      /* Free the file data */
+
+      fs_heap_free(tfo->tfo_data);
+      tfo->tfo_data  = NULL;
+      tfo->tfo_alloc = 0;
+      tfo->tfo_size  = 0;
+      return OK;
+    }
+  else if (newsize < tfo->tfo_alloc)
+    {
+      /* Otherwise, don't realloc unless the object has shrunk by a lot. */
+
+      delta = tfo->tfo_alloc - newsize;
+
+      /* We should make sure the shrunked memory be zero */
+
+      memset(tfo->tfo_data + newsize, 0, delta);
+      if (delta > CONFIG_FS_TMPFS_FILE_FREEGUARD)
+        {
+          /* Added some additional amount to the new size to account
+           * frequent reallocations.
+           */
+
+          allocsize = newsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+          newdata   = fs_heap_realloc(tfo->tfo_data, allocsize);
+          if (newdata != NULL)
+            {
+              tfo->tfo_alloc = allocsize;
+              tfo->tfo_data  = newdata;
+            }
+        }
+    }
+
+  tfo->tfo_size = newsize;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_fill_file
+ *
+ * Description:
+ *   Allocate the memory of the range from 'start' up to 'end' of a file,
+ *   which must lie within the size of the file.  The new memory is zeroed.
+ *
+ ****************************************************************************/
+
+static int tmpfs_fill_file(FAR struct tmpfs_file_s *tfo, size_t start,
+                           size_t end)
+{
+  FAR uint8_t *newdata;
+  size_t allocsize;
+  size_t i;
+
+  DEBUGASSERT(end <= tfo->tfo_size);
+
+  if (start >= end)
+    {
+      return OK;
+    }
+
+  if (tfo->tfo_chunks == NULL)
+    {
+      if (end <= tfo->tfo_alloc)
+        {
+          return OK;
+        }
+
+      /* Added some additional amount to the new size to account frequent
+       * reallocations, but never beyond the chunk size.
+       */
+
+      allocsize = end + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+      if (allocsize < end)
+        {
+          /* There must have been an integer overflow */
+
+          return -ENOMEM;
+        }
+
+      if (allocsize > TMPFS_CHUNKSIZE)
+        {
+          allocsize = TMPFS_CHUNKSIZE;
+        }
+
+      newdata = fs_heap_realloc(tfo->tfo_data, allocsize);
+      if (newdata == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      memset(newdata + tfo->tfo_alloc, 0, allocsize - tfo->tfo_alloc);
+      tfo->tfo_alloc = allocsize;
+      tfo->tfo_data  = newdata;
+      return OK;
     }
 
-  /* Return the new address of the reallocated file object */
+  for (i = start / TMPFS_CHUNKSIZE; i < TMPFS_NCHUNKS(end); i++)
+    {
+      if (tfo->tfo_chunks[i] == NULL)
+        {
+          tfo->tfo_chunks[i] = fs_heap_zalloc(TMPFS_CHUNKSIZE);
+          if (tfo->tfo_chunks[i] == NULL)
+            {
+              return -ENOMEM;
+            }
+
+          tfo->tfo_alloc += TMPFS_CHUNKSIZE;
+        }
+    }
 
-  tfo->tfo_alloc = allocsize;
-  tfo->tfo_size  = newsize;
-  tfo->tfo_data  = newdata;
   return OK;
 }
 
+/****************************************************************************
+ * Name: tmpfs_get_chunk
+ *
+ * Description:
+ *   Return the chunk 'index' of a file and the number of bytes allocated
+ *   for it.  A hole is returned as NULL with no bytes.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_get_chunk(FAR struct tmpfs_file_s *tfo,
+                                    size_t index, FAR size_t *alloc)
+{
+  if (tfo->tfo_chunks == NULL)
+    {
+      DEBUGASSERT(index == 0);
+      *alloc = tfo->tfo_alloc;
+      return tfo->tfo_data;
+    }
+
+  DEBUGASSERT(index < tfo->tfo_nchunks);
+  *alloc = tfo->tfo_chunks[index] != NULL ? TMPFS_CHUNKSIZE : 0;
+  return tfo->tfo_chunks[index];
+}
+
+/****************************************************************************
+ * Name: tmpfs_read_chunks
+ *
+ * Description:
+ *   Copy file data out of the chunks.  Holes read as zeros.
+ *
+ ****************************************************************************/
+
+static void tmpfs_read_chunks(FAR struct tmpfs_file_s *tfo, size_t pos,
+                              FAR uint8_t *buffer, size_t len)
+{
+  FAR uint8_t *chunk;
+  size_t offset;
+  size_t alloc;
+  size_t ncopy;
+  size_t n;
+
+  while (len > 0)
+    {
+      chunk  = tmpfs_get_chunk(tfo, pos / TMPFS_CHUNKSIZE, &alloc);
+      offset = pos % TMPFS_CHUNKSIZE;
+      n      = MIN(len, TMPFS_CHUNKSIZE - offset);
+      ncopy  = offset < alloc ? MIN(n, alloc - offset) : 0;
+
+      if (ncopy > 0)
+        {
+          memcpy(buffer, chunk + offset, ncopy);
+        }
+
+      memset(buffer + ncopy, 0, n - ncopy);
+
+      buffer += n;
+      pos    += n;
+      len    -= n;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_write_chunks
+ *
+ * Description:
+ *   Copy file data into the chunks, which tmpfs_fill_file() allocated.
+ *
+ ****************************************************************************/
+
+static void tmpfs_write_chunks(FAR struct tmpfs_file_s *tfo, size_t pos,
+                               FAR const uint8_t *buffer, size_t len)
+{
+  FAR uint8_t *chunk;
+  size_t offset;
+  size_t alloc;
+  size_t n;
+
+  while (len > 0)
+    {
+      chunk  = tmpfs_get_chunk(tfo, pos / TMPFS_CHUNKSIZE, &alloc);
+      offset = pos % TMPFS_CHUNKSIZE;
+      n      = MIN(len, TMPFS_CHUNKSIZE - offset);
+
+      DEBUGASSERT(offset + n <= alloc);
+      memcpy(chunk + offset, buffer, n);
+
+      buffer += n;
+      pos    += n;
+      len    -= n;
+    }
+}
+
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
  ****************************************************************************/
@@ -379,7 +654,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     {
       tmpfs_unlock_file(tfo);
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_realloc_file(tfo, 0);
       fs_heap_free(tfo);
     }
 
@@ -578,6 +853,7 @@ tmpfs_alloc_file(FAR struct tmpfs_directory_s *parent)
   tfo->tfo_parent = parent;
   tfo->tfo_flags  = 0;
   tfo->tfo_size   = 0;
+  tfo->tfo_chunks = NULL;
   tfo->tfo_data   = NULL;
 
   nxrmutex_init(&tfo->tfo_lock);
@@ -1176,8 +1452,13 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
        */
 
       tmptfo             = (FAR struct tmpfs_file_s *)to;
-      tmpbuf->tsf_alloc += sizeof(struct tmpfs_file_s);
-      tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+      tmpbuf->tsf_alloc += sizeof(struct tmpfs_file_s) +
+                           tmptfo->tfo_nchunks * sizeof(FAR uint8_t *);
+      if (to->to_alloc > tmptfo->tfo_size)
+        {
+          tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+        }
+
       tmpbuf->tsf_files++;
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
@@ -1253,7 +1534,7 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_realloc_file(tfo, 0);
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
@@ -1269,6 +1550,129 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
   return TMPFS_DELETED;
 }
 
+/****************************************************************************
+ * Name: tmpfs_trim_directory
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_RECLAIM
+static size_t tmpfs_trim_directory(FAR struct tmpfs_directory_s *tdo)
+{
+  FAR struct tmpfs_dirent_s *newentry;
+  size_t released;
+  size_t objsize;
+
+  objsize = SIZEOF_TMPFS_DIRECTORY(tdo->tdo_nentries);
+  if (objsize >= tdo->tdo_alloc)
+    {
+      return 0;
+    }
+
+  released = tdo->tdo_alloc - objsize;
+
+  if (objsize == 0)
+    {
+      fs_heap_free(tdo->tdo_entry);
+      tdo->tdo_entry = NULL;
+      tdo->tdo_alloc = 0;
+      return released;
+    }
+
+  newentry = fs_heap_realloc(tdo->tdo_entry, objsize);
+  if (newentry == NULL)
+    {
+      return 0;
+    }
+
+  tdo->tdo_entry = newentry;
+  tdo->tdo_alloc = objsize;
+  return released;
+}
+
+/****************************************************************************
+ * Name: tmpfs_reclaim_callout
+ ****************************************************************************/
+
+static int tmpfs_reclaim_callout(FAR struct tmpfs_directory_s *tdo,
+                                 unsigned int index, FAR void *arg)
+{
+  FAR struct tmpfs_object_s *to = tdo->tdo_entry[index].tde_object;
+  FAR size_t *released = arg;
+
+  if (to->to_type == TMPFS_DIRECTORY)
+    {
+      *released += tmpfs_trim_directory((FAR struct tmpfs_directory_s *)to);
+    }
+  else
+    {
+      FAR struct tmpfs_file_s *tfo = (FAR struct tmpfs_file_s *)to;
+      FAR uint8_t *newdata;
+
+      /* Only the reference taken by tmpfs_foreach() is allowed.  Open or
+       * mapped files keep their buffer where it is.  Only the files of one
+       * chunk have a growth guard.
+       */
+
+      if (tfo->tfo_refs > 1 || tfo->tfo_chunks != NULL ||
+          tfo->tfo_size >= tfo->tfo_alloc)
+        {
+          return TMPFS_CONTINUE;
+        }
+
+      if (tfo->tfo_size == 0)
+        {
+          fs_heap_free(tfo->tfo_data);
+          *released     += tfo->tfo_alloc;
+          tfo->tfo_data  = NULL;
+          tfo->tfo_alloc = 0;
+        }
+      else
+        {
+          newdata = fs_heap_realloc(tfo->tfo_data, tfo->tfo_size);
+          if (newdata != NULL)
+            {
+              *released     += tfo->tfo_alloc - tfo->tfo_size;
+              tfo->tfo_data  = newdata;
+              tfo->tfo_alloc = tfo->tfo_size;
+            }
+        }
+    }
+
+  return TMPFS_CONTINUE;
+}
+
+/****************************************************************************
+ * Name: tmpfs_reclaim
+ *
+ * Description:
+ *   Called by the memory manager when the heap runs low.  Give back the
+ *   growth guard kept at the end of every file and directory that is not
+ *   currently in use.
+ *
+ ****************************************************************************/
+
+static size_t tmpfs_reclaim(FAR void *arg, bool nonblock)
+{
+  FAR struct tmpfs_s *fs = arg;
+  FAR struct tmpfs_directory_s *tdo;
+  size_t released = 0;
+
+  /* The walk below waits for the lock of every object, so it is only done
+   * from the work queue.
+   */
+
+  if (nonblock || tmpfs_lock(fs) < 0)
+    {
+      return 0;
+    }
+
+  tdo = (FAR struct tmpfs_directory_s *)fs->tfs_root.tde_object;
+  tmpfs_foreach(tdo, tmpfs_reclaim_callout, &released);
+  released += tmpfs_trim_directory(tdo);
+  tmpfs_unlock(fs);
+  return released;
+}
+#endif
+
 /****************************************************************************
  * Name: tmpfs_foreach
  ****************************************************************************/
@@ -1574,15 +1978,8 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
-  if (tfo->tfo_data != NULL)
-    {
-      memcpy(buffer, &tfo->tfo_data[startpos], nread);
-      filep->f_pos += nread;
-    }
-  else
-    {
-      DEBUGASSERT(tfo->tfo_size == 0 && nread == 0);
-    }
+  tmpfs_read_chunks(tfo, startpos, (FAR uint8_t *)buffer, nread);
+  filep->f_pos += nread;
 
   /* Release the lock on the file */
 
@@ -1601,6 +1998,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   ssize_t nwritten;
   off_t startpos;
   off_t endpos;
+  size_t oldsize;
   int ret;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
@@ -1632,6 +2030,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   nwritten = buflen;
   endpos   = startpos + buflen;
+  oldsize  = tfo->tfo_size;
 
   if (endpos > tfo->tfo_size)
     {
@@ -1644,17 +2043,23 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
         }
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Allocate the chunks that are written */
 
-  if (tfo->tfo_data != NULL)
-    {
-      memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
-    }
-  else
+  ret = tmpfs_fill_file(tfo, startpos, endpos);
+  if (ret < 0)
     {
-      DEBUGASSERT(tfo->tfo_size == 0 && nwritten == 0);
+      if (endpos > oldsize)
+        {
+          tmpfs_realloc_file(tfo, oldsize);
+        }
+
+      goto errout_with_lock;
     }
 
+  /* Copy data from the user buffer to the memory object */
+
+  tmpfs_write_chunks(tfo, startpos, (FAR const uint8_t *)buffer, nwritten);
+
   filep->f_pos = endpos;
 
   /* Release the lock on the file */
@@ -1763,6 +2168,9 @@ static int tmpfs_unmap(FAR struct task_group_s *group,
 static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
 {
   FAR struct tmpfs_file_s *tfo;
+  FAR uint8_t *chunk;
+  size_t alloc;
+  size_t index;
   int ret = -EINVAL;
 
   DEBUGASSERT(filep->f_priv != NULL);
@@ -1776,7 +2184,27 @@ static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
   if (map->offset >= 0 && map->offset < tfo->tfo_size &&
       map->length && map->offset + map->length <= tfo->tfo_size)
     {
-      map->vaddr = tfo->tfo_data + map->offset;
+      /* Only a range within one chunk can be mapped directly.  The holes
+       * in it are allocated, as the mapping may be written.
+       */
+
+      index = map->offset / TMPFS_CHUNKSIZE;
+      if (index != (map->offset + map->length - 1) / TMPFS_CHUNKSIZE)
+        {
+          return -ENOTTY;
+        }
+
+      tmpfs_lock_file(tfo);
+      ret = tmpfs_fill_file(tfo, map->offset, map->offset + map->length);
+      chunk = tmpfs_get_chunk(tfo, index, &alloc);
+      tmpfs_unlock_file(tfo);
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      map->vaddr = chunk + map->offset % TMPFS_CHUNKSIZE;
       map->priv.p = tfo;
       map->munmap = tmpfs_unmap;
       ret = mm_map_add(get_current_mm(), map);
@@ -1830,8 +2258,25 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     {
       FAR uintptr_t *ptr = (FAR uintptr_t *)arg;
 
-      *ptr = (uintptr_t)tfo->tfo_data;
-      return OK;
+      /* Only a file of one chunk is contiguous in memory */
+
+      ret = tmpfs_lock_file(tfo);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (tfo->tfo_chunks != NULL)
+        {
+          ret = -ENOTTY;
+        }
+      else
+        {
+          ret = tmpfs_fill_file(tfo, 0, tfo->tfo_size);
+          *ptr = (uintptr_t)tfo->tfo_data;
+        }
+
+      tmpfs_unlock_file(tfo);
     }
 
   return ret;
@@ -1956,29 +2401,15 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
   oldsize = tfo->tfo_size;
   if (oldsize != length)
     {
-      /* The size is changing.. up or down.  Reallocate the file memory. */
-
-      ret = tmpfs_realloc_file(tfo, (size_t)length);
-      if (ret < 0)
-        {
-          goto errout_with_lock;
-        }
-
-      /* If the size has increased, then we need to zero the newly added
-       * memory.
+      /* The size is changing.. up or down.  Reallocate the file memory.
+       * The range that is added reads as zeros until it is written.
        */
 
-      if (length > oldsize)
-        {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
-        }
-
-      ret = OK;
+      ret = tmpfs_realloc_file(tfo, (size_t)length);
     }
 
   /* Release the lock on the file */
 
-errout_with_lock:
   tmpfs_unlock_file(tfo);
   return ret;
 }
@@ -2171,6 +2602,44 @@ static int tmpfs_rewinddir(FAR struct inode *mountpt,
   return OK;
 }
 
+/****************************************************************************
+ * Name: tmpfs_seekdir
+ ****************************************************************************/
+
+static int tmpfs_seekdir(FAR struct inode *mountpt,
+                         FAR struct fs_dirent_s *dir, off_t offset)
+{
+  FAR struct tmpfs_directory_s *tdo;
+  FAR struct tmpfs_dir_s *tdir;
+
+  finfo("mountpt: %p dir: %p\n",  mountpt, dir);
+  DEBUGASSERT(mountpt != NULL && dir != NULL);
+
+  /* Get the directory structure from the dir argument and lock it */
+
+  tdir = (FAR struct tmpfs_dir_s *)dir;
+  tdo = tdir->tf_tdo;
+  DEBUGASSERT(tdo != NULL);
+
+  tmpfs_lock_directory(tdo);
+
+  /* The entries are read from the end of the directory, so the index of
+   * the next entry is 'offset' entries before its end.
+   */
+
+  if (offset < tdo->tdo_nentries)
+    {
+      tdir->tf_index = tdo->tdo_nentries - offset;
+    }
+  else
+    {
+      tdir->tf_index = 0;
+    }
+
+  tmpfs_unlock_directory(tdo);
+  return OK;
+}
+
 /****************************************************************************
  * Name: tmpfs_bind
  ****************************************************************************/
@@ -2210,6 +2679,13 @@ static int tmpfs_bind(FAR struct inode *blkdriver, FAR const void *data,
 
   nxrmutex_init(&fs->tfs_lock);
 
+#ifdef CONFIG_MM_RECLAIM
+  fs->tfs_reclaim.reclaim = tmpfs_reclaim;
+  fs->tfs_reclaim.arg     = fs;
+  fs->tfs_reclaim.cost    = MM_RECLAIM_COST_MEDIUM;
+  mm_register_reclaim(&fs->tfs_reclaim);
+#endif
+
   /* Return the new file system handle */
 
   *handle = (FAR void *)fs;
@@ -2231,11 +2707,20 @@ static int tmpfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
         handle, blkdriver, flags);
   DEBUGASSERT(fs != NULL && fs->tfs_root.tde_object != NULL);
 
+#ifdef CONFIG_MM_RECLAIM
+  /* Make sure a reclaim isn't running on this instance */
+
+  mm_unregister_reclaim(&fs->tfs_reclaim);
+#endif
+
   /* Lock the file system */
 
   ret = tmpfs_lock(fs);
   if (ret < 0)
     {
+#ifdef CONFIG_MM_RECLAIM
+      mm_register_reclaim(&fs->tfs_reclaim);
+#endif
       return ret;
     }
 
@@ -2414,7 +2899,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_realloc_file(tfo, 0);
       fs_heap_free(tfo);
     }
 
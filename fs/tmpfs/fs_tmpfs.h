@@ -30,6 +30,7 @@
 #include <stdint.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/mm/mm.h>
 #include <nuttx/mutex.h>
 
 /****************************************************************************
@@ -40,6 +41,20 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* The size of the chunks of the file data.  Without chunks, the data of
+ * every file is one chunk that grows as needed.
+ */
+
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+#  define TMPFS_CHUNKSIZE ((size_t)CONFIG_FS_TMPFS_CHUNKSIZE)
+#else
+#  define TMPFS_CHUNKSIZE SIZE_MAX
+#endif
+
+/* The number of chunks that hold a file of 'n' bytes */
+
+#define TMPFS_NCHUNKS(n) ((n) == 0 ? 0 : ((n) - 1) / TMPFS_CHUNKSIZE + 1)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -117,16 +132,24 @@ struct tmpfs_file_s
 
   rmutex_t tfo_lock;
 
-  size_t   tfo_alloc;    /* Allocated size of the file object */
+  size_t   tfo_alloc;    /* Allocated size of the file data */
   uint8_t  tfo_type;     /* See enum tmpfs_objtype_e */
   uint8_t  tfo_refs;     /* Reference count */
   FAR struct tmpfs_directory_s *tfo_parent;
 
   /* Remaining fields are unique to a directory object */
 
-  uint8_t       tfo_flags; /* See TFO_FLAG_* definitions */
-  size_t        tfo_size;  /* Valid file size */
-  FAR uint8_t  *tfo_data;  /* File data starts here */
+  uint8_t       tfo_flags;   /* See TFO_FLAG_* definitions */
+  size_t        tfo_size;    /* Valid file size */
+
+  /* A file of one chunk keeps it in tfo_data, which is allocated only as
+   * large as needed.  Larger files have a table of chunks, each of them
+   * TMPFS_CHUNKSIZE bytes or NULL if it was never written.
+   */
+
+  size_t        tfo_nchunks; /* Number of entries of tfo_chunks */
+  FAR uint8_t **tfo_chunks;  /* Chunk table or NULL */
+  FAR uint8_t  *tfo_data;    /* Data of a file of one chunk */
 };
 
 /* This structure represents one instance of a TMPFS file system */
@@ -137,6 +160,9 @@ struct tmpfs_s
 
   FAR struct tmpfs_dirent_s tfs_root;
   rmutex_t tfs_lock;
+#ifdef CONFIG_MM_RECLAIM
+  struct mm_reclaim_s tfs_reclaim;
+#endif
 };
 
 /* This is the type used the tmpfs_statfs_callout to accumulate memory
@@ -107,6 +107,12 @@ int file_close_without_clear(FAR struct file *filep)
 
   if (inode)
     {
+#ifdef CONFIG_FS_POLL_CACHE
+      /* The poll caches must not refer to the file after the close */
+
+      poll_cache_close(filep);
+#endif
+
       file_closelk(filep);
 
       /* Close the file, driver, or mountpoint. */
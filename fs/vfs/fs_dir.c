@@ -243,6 +243,25 @@ static off_t seek_mountptdir(FAR struct file *filep, off_t offset)
   struct dirent entry;
   off_t pos;
 
+  /* Let the file system move to the position directly if it can.  -ENOSYS
+   * means that it cannot for this directory.
+   */
+
+  if (offset > 0 && inode->u.i_mops->seekdir != NULL)
+    {
+      int ret;
+
+      ret = inode->u.i_mops->seekdir(inode, dir, offset);
+      if (ret >= 0)
+        {
+          return offset;
+        }
+      else if (ret != -ENOSYS)
+        {
+          return ret;
+        }
+    }
+
   /* Determine a starting point for the seek. If the seek
    * is "forward" from the current position, then we will
    * start at the current position. Otherwise, we will
@@ -465,7 +484,9 @@ static ssize_t dir_read(FAR struct file *filep, FAR char *buffer,
   FAR struct fs_dirent_s *dir = filep->f_priv;
 #ifndef CONFIG_DISABLE_MOUNTPOINT
   FAR struct inode *inode = dir->fd_root;
+  off_t pos;
 #endif
+  size_t nread = 0;
   int ret;
 
   /* Verify that we were provided with a valid directory structure */
@@ -475,38 +496,64 @@ static ssize_t dir_read(FAR struct file *filep, FAR char *buffer,
       return -EINVAL;
     }
 
-  /* The way we handle the readdir depends on the type of inode
-   * that we are dealing with.
+  /* Return as many entries as fit into the buffer, so that getdents() can
+   * list a directory with a few calls.
    */
 
-#ifndef CONFIG_DISABLE_MOUNTPOINT
-  if (INODE_IS_MOUNTPT(inode))
+  do
     {
-      ret = inode->u.i_mops->readdir(inode, dir,
-                                     (FAR struct dirent *)buffer);
-    }
-  else
+      FAR struct dirent *entry = (FAR struct dirent *)(buffer + nread);
+
+      /* The way we handle the readdir depends on the type of inode
+       * that we are dealing with.
+       */
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+      if (INODE_IS_MOUNTPT(inode))
+        {
+          ret = inode->u.i_mops->readdir(inode, dir, entry);
+        }
+      else
 #endif
-    {
-      /* The node is part of the root pseudo file system */
+        {
+          /* The node is part of the root pseudo file system */
 
-      ret = read_pseudodir(dir, (FAR struct dirent *)buffer);
-    }
+          ret = read_pseudodir(dir, entry);
+        }
 
-  /* ret < 0 is an error. Special case: ret = -ENOENT is end of file */
+      if (ret < 0)
+        {
+          break;
+        }
 
-  if (ret < 0)
-    {
-      if (ret == -ENOENT)
+      /* The position is a cookie of the file system, if it has one, or
+       * the number of entries read.
+       */
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+      if (INODE_IS_MOUNTPT(inode) && inode->u.i_mops->telldir != NULL &&
+          (pos = inode->u.i_mops->telldir(inode, dir)) >= 0)
+        {
+          filep->f_pos = pos;
+        }
+      else
+#endif
         {
-          ret = 0;
+          filep->f_pos++;
         }
 
-      return ret;
+      nread += sizeof(struct dirent);
     }
+  while (nread + sizeof(struct dirent) <= buflen);
 
-  filep->f_pos++;
-  return sizeof(struct dirent);
+  /* ret < 0 is an error. Special case: ret = -ENOENT is end of file */
+
+  if (nread > 0 || ret == -ENOENT)
+    {
+      return nread;
+    }
+
+  return ret;
 }
 
 static off_t dir_seek(FAR struct file *filep, off_t offset, int whence)
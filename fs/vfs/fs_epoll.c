@@ -40,6 +40,7 @@
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 
 #include "inode/inode.h"
 #include "fs_heap.h"
@@ -50,9 +51,14 @@
 
 struct epoll_node_s
 {
-  struct list_node         node;
+  struct list_node         node;     /* Entry in the setup or free list */
+  struct list_node         ready;    /* Entry in the ready list */
   epoll_data_t             data;
-  bool                     notified;
+  pollevent_t              revents;  /* The events not reported yet */
+  bool                     queued;   /* The node is in the ready list */
+  bool                     disabled; /* EPOLLONESHOT reported, wait for
+                                      * EPOLL_CTL_MOD.
+                                      */
   struct pollfd            pfd;
   FAR struct epoll_head_s *eph;
 };
@@ -65,19 +71,16 @@ struct epoll_head_s
   int                   crefs;
   mutex_t               lock;
   sem_t                 sem;
-  struct list_node      setup;    /* The setup list, store all the setuped
-                                   * epoll node.
+  spinlock_t            spinlock; /* Protects the ready list, which the
+                                   * poll callbacks modify.
                                    */
-  struct list_node      teardown; /* The teardown list, store all the epoll
-                                   * node notified after epoll_wait finish,
-                                   * these epoll node should be setup again
-                                   * to check the pending poll notification.
+  struct list_node      setup;    /* The setup list, store all the epoll
+                                   * nodes.  They stay set up from
+                                   * epoll_ctl() until they are deleted.
                                    */
-  struct list_node      oneshot;  /* The oneshot list, store all the epoll
-                                   * node notified after epoll_wait and with
-                                   * EPOLLONESHOT events, these oneshot epoll
-                                   * nodes can be reset by epoll_ctl (move
-                                   * from oneshot list to the setup list).
+  struct list_node      ready;    /* The ready list, store all the epoll
+                                   * nodes whose events changed since the
+                                   * last epoll_wait() reported them.
                                    */
   struct list_node      free;     /* The free list, store all the freed epoll
                                    * node.
@@ -98,9 +101,9 @@ static int epoll_do_open(FAR struct file *filep);
 static int epoll_do_close(FAR struct file *filep);
 static int epoll_do_poll(FAR struct file *filep,
                          FAR struct pollfd *fds, bool setup);
-static int epoll_setup(FAR epoll_head_t *eph);
-static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
-                          int maxevents);
+static void epoll_unqueue(FAR epoll_head_t *eph, FAR epoll_node_t *epn);
+static int epoll_drain(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
+                       int maxevents);
 
 /****************************************************************************
  * Private Data
@@ -240,9 +243,9 @@ static int epoll_do_create(int size, int flags)
 
   epn = (FAR epoll_node_t *)(eph + 1);
 
+  spin_lock_init(&eph->spinlock);
   list_initialize(&eph->setup);
-  list_initialize(&eph->teardown);
-  list_initialize(&eph->oneshot);
+  list_initialize(&eph->ready);
   list_initialize(&eph->extend);
   list_initialize(&eph->free);
   for (i = 0; i < size; i++)
@@ -267,61 +270,42 @@ static int epoll_do_create(int size, int flags)
 }
 
 /****************************************************************************
- * Name: epoll_setup
+ * Name: epoll_unqueue
  *
  * Description:
- *   Setup all the fd.
+ *   Remove a node from the ready list and forget the events it did not
+ *   report yet.  The node must be torn down.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
- *
- * Returned Value:
- *   Positive on success, negative on fail
+ *   epn       - The epoll node pointer
  *
  ****************************************************************************/
 
-static int epoll_setup(FAR epoll_head_t *eph)
+static void epoll_unqueue(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
 {
-  FAR epoll_node_t *tepn;
-  FAR epoll_node_t *epn;
-  int ret;
+  irqstate_t flags;
 
-  ret = nxmutex_lock(&eph->lock);
-  if (ret < 0)
+  flags = spin_lock_irqsave(&eph->spinlock);
+  if (epn->queued)
     {
-      return ret;
-    }
-
-  list_for_every_entry_safe(&eph->teardown, epn, tepn, epoll_node_t, node)
-    {
-      /* Setup again to check the notified pollfd last epoll_wait() to
-       * cover the situation several poll event pending on one fd.
-       */
-
-      epn->notified    = false;
-      epn->pfd.revents = 0;
-      ret = poll_fdsetup(epn->pfd.fd, &epn->pfd, true);
-      if (ret < 0)
-        {
-          ferr("epoll setup failed, fd=%d, events=%08" PRIx32 ", ret=%d\n",
-               epn->pfd.fd, epn->pfd.events, ret);
-          break;
-        }
-
-      list_delete(&epn->node);
-      list_add_tail(&eph->setup, &epn->node);
+      list_delete(&epn->ready);
+      epn->queued = false;
     }
 
-  nxmutex_unlock(&eph->lock);
-  return ret;
+  epn->revents     = 0;
+  epn->pfd.revents = 0;
+  spin_unlock_irqrestore(&eph->spinlock, flags);
 }
 
 /****************************************************************************
- * Name: epoll_teardown
+ * Name: epoll_drain
  *
  * Description:
- *   Teardown all the notifed fd and check the notified fd's event with user
- *   expected event.
+ *   Report the events of the nodes in the ready list.  The nodes stay set
+ *   up, the poll callbacks add them to the ready list again on the next
+ *   change of their events.  Only a level-triggered node is set up again
+ *   after reporting, to check if it is still ready.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -329,50 +313,73 @@ static int epoll_setup(FAR epoll_head_t *eph)
  *   maxevents - The epoll events array size
  *
  * Returned Value:
- *   Return the number of fd that notifed and the events is also user
- *   expected.
+ *   Return the number of events reported.
  *
  ****************************************************************************/
 
-static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
-                          int maxevents)
+static int epoll_drain(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
+                       int maxevents)
 {
+  struct list_node rearm;
   FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
+  pollevent_t revents;
+  irqstate_t flags;
+  int ret;
   int i = 0;
 
+  list_initialize(&rearm);
   nxmutex_lock(&eph->lock);
 
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  while (i < maxevents)
     {
-      /* Only check the notifed fd */
+      flags = spin_lock_irqsave(&eph->spinlock);
+      if (list_is_empty(&eph->ready))
+        {
+          spin_unlock_irqrestore(&eph->spinlock, flags);
+          break;
+        }
 
-      if (!epn->notified)
+      epn = container_of(list_remove_head(&eph->ready), epoll_node_t,
+                         ready);
+      epn->queued  = false;
+      revents      = epn->revents;
+      epn->revents = 0;
+      if ((epn->pfd.events & EPOLLONESHOT) != 0)
+        {
+          epn->disabled = true;
+        }
+
+      spin_unlock_irqrestore(&eph->spinlock, flags);
+
+      if (revents == 0)
         {
           continue;
         }
 
-      /* Teradown all the notified fd */
+      evs[i].data     = epn->data;
+      evs[i++].events = revents;
 
-      poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
-      list_delete(&epn->node);
+      /* Tear a level-triggered node down now and set it up again once all
+       * events are collected, so that it is reported once per call.
+       */
 
-      if (epn->pfd.revents != 0 && i < maxevents)
+      if ((epn->pfd.events & (EPOLLET | EPOLLONESHOT)) == 0)
         {
-          evs[i].data     = epn->data;
-          evs[i++].events = epn->pfd.revents;
-          if ((epn->pfd.events & EPOLLONESHOT) != 0)
-            {
-              list_add_tail(&eph->oneshot, &epn->node);
-            }
-          else
-            {
-              list_add_tail(&eph->teardown, &epn->node);
-            }
+          poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+          epoll_unqueue(eph, epn);
+          list_add_tail(&rearm, &epn->ready);
         }
-      else
+    }
+
+  list_for_every_entry_safe(&rearm, epn, tepn, epoll_node_t, ready)
+    {
+      list_delete(&epn->ready);
+      ret = poll_fdsetup(epn->pfd.fd, &epn->pfd, true);
+      if (ret < 0)
         {
-          list_add_tail(&eph->teardown, &epn->node);
+          ferr("epoll setup failed, fd=%d, events=%08" PRIx32 ", ret=%d\n",
+               epn->pfd.fd, epn->pfd.events, ret);
         }
     }
 
@@ -385,7 +392,7 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
  *
  * Description:
  *   The default epoll callback function, this function do the final step of
- *   poll notification.
+ *   poll notification.  It may run in an interrupt handler.
  *
  * Input Parameters:
  *   fds - The fds
@@ -398,15 +405,102 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
 static void epoll_default_cb(FAR struct pollfd *fds)
 {
   FAR epoll_node_t *epn = fds->arg;
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
+  bool wake = false;
   int semcount = 0;
 
-  epn->notified = true;
-  if (fds->revents != 0)
+  /* Collect the events in the node, a driver only reports changes */
+
+  flags = spin_lock_irqsave(&eph->spinlock);
+  epn->revents |= fds->revents;
+  fds->revents  = 0;
+  if (epn->revents != 0 && !epn->disabled && !epn->queued)
+    {
+      list_add_tail(&eph->ready, &epn->ready);
+      epn->queued = true;
+      wake        = true;
+    }
+
+  spin_unlock_irqrestore(&eph->spinlock, flags);
+
+  if (wake)
     {
-      nxsem_get_value(&epn->eph->sem, &semcount);
+      nxsem_get_value(&eph->sem, &semcount);
       if (semcount < 1)
         {
-          nxsem_post(&epn->eph->sem);
+          nxsem_post(&eph->sem);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_wait_events
+ *
+ * Description:
+ *   Wait for events and report them, the common part of epoll_wait() and
+ *   epoll_pwait().
+ *
+ * Input Parameters:
+ *   eph       - The epoll head pointer
+ *   evs       - The epoll events array
+ *   maxevents - The epoll events array size
+ *   timeout   - The timeout in milliseconds, -1 to wait forever
+ *   sigmask   - The signal mask while waiting, NULL to keep the mask
+ *
+ * Returned Value:
+ *   The number of events reported, or a negated errno value.
+ *
+ ****************************************************************************/
+
+static int epoll_wait_events(FAR epoll_head_t *eph,
+                             FAR struct epoll_event *evs, int maxevents,
+                             int timeout, FAR const sigset_t *sigmask)
+{
+  sigset_t oldsigmask;
+  int ret;
+
+  if (evs == NULL || maxevents <= 0)
+    {
+      return -EINVAL;
+    }
+
+  for (; ; )
+    {
+      ret = epoll_drain(eph, evs, maxevents);
+      if (ret > 0 || timeout == 0)
+        {
+          return ret;
+        }
+
+      /* Wait the poll ready */
+
+      if (sigmask != NULL)
+        {
+          nxsig_procmask(SIG_SETMASK, sigmask, &oldsigmask);
+        }
+
+      if (timeout > 0)
+        {
+          ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
+        }
+      else
+        {
+          ret = nxsem_wait(&eph->sem);
+        }
+
+      if (sigmask != NULL)
+        {
+          nxsig_procmask(SIG_SETMASK, &oldsigmask, NULL);
+        }
+
+      if (ret == -ETIMEDOUT)
+        {
+          return epoll_drain(eph, evs, maxevents);
+        }
+      else if (ret < 0)
+        {
+          return ret;
         }
     }
 }
@@ -480,6 +574,9 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
   FAR struct file *filep;
   FAR epoll_head_t *eph;
   FAR epoll_node_t *epn;
+  epoll_data_t data;
+  pollevent_t events;
+  bool disabled;
   int ret;
   int i;
 
@@ -495,6 +592,21 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
       goto err_without_lock;
     }
 
+  /* Look up the fd, all the nodes are in the setup list */
+
+  list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
+    {
+      if (epn->pfd.fd == fd)
+        {
+          break;
+        }
+    }
+
+  if (&epn->node == &eph->setup)
+    {
+      epn = NULL;
+    }
+
   switch (op)
     {
       case EPOLL_CTL_ADD:
@@ -502,31 +614,10 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 
         /* Check repetition */
 
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
+        if (epn != NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
-          }
-
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
+            ret = -EEXIST;
+            goto err;
           }
 
         if (list_is_empty(&eph->free))
@@ -556,7 +647,9 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         epn = container_of(list_remove_head(&eph->free), epoll_node_t, node);
         epn->eph         = eph;
         epn->data        = ev->data;
-        epn->notified    = false;
+        epn->revents     = 0;
+        epn->queued      = false;
+        epn->disabled    = false;
         epn->pfd.events  = ev->events | POLLALWAYS;
         epn->pfd.fd      = fd;
         epn->pfd.arg     = epn;
@@ -566,6 +659,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         ret = poll_fdsetup(fd, &epn->pfd, true);
         if (ret < 0)
           {
+            epoll_unqueue(eph, epn);
             list_add_tail(&eph->free, &epn->node);
             goto err;
           }
@@ -575,112 +669,58 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 
       case EPOLL_CTL_DEL:
         finfo("%p CTL DEL: fd=%d\n", eph, fd);
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
+        if (epn == NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                poll_fdsetup(fd, &epn->pfd, false);
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
-          }
-
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
+            ret = -ENOENT;
+            goto err;
           }
 
+        poll_fdsetup(fd, &epn->pfd, false);
+        epoll_unqueue(eph, epn);
+        list_delete(&epn->node);
+        list_add_tail(&eph->free, &epn->node);
         break;
 
       case EPOLL_CTL_MOD:
         finfo("%p CTL MOD: fd=%d ev=%08" PRIx32 "\n", eph, fd, ev->events);
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
+        if (epn == NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                if (epn->pfd.events != (ev->events | POLLALWAYS))
-                  {
-                    poll_fdsetup(fd, &epn->pfd, false);
-
-                    epn->notified    = false;
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events | POLLALWAYS;
-                    epn->pfd.fd      = fd;
-                    epn->pfd.revents = 0;
-
-                    ret = poll_fdsetup(fd, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-                  }
-
-                goto out;
-              }
+            ret = -ENOENT;
+            goto err;
           }
 
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                if (epn->pfd.events != (ev->events | POLLALWAYS))
-                  {
-                    epn->notified    = false;
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events | POLLALWAYS;
-                    epn->pfd.fd      = fd;
-                    epn->pfd.revents = 0;
-
-                    ret = poll_fdsetup(fd, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-
-                    list_delete(&epn->node);
-                    list_add_tail(&eph->setup, &epn->node);
-                  }
-
-                goto out;
-              }
-          }
+        /* Set the node up again, this also rearms an EPOLLONESHOT node
+         * and reports the events that are pending already.
+         */
+
+        poll_fdsetup(fd, &epn->pfd, false);
+        epoll_unqueue(eph, epn);
+
+        data             = epn->data;
+        disabled         = epn->disabled;
+        events           = epn->pfd.events;
+        epn->data        = ev->data;
+        epn->disabled    = false;
+        epn->pfd.events  = ev->events | POLLALWAYS;
 
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
+        ret = poll_fdsetup(fd, &epn->pfd, true);
+        if (ret < 0)
           {
-            if (epn->pfd.fd == fd)
-              {
-                epn->notified    = false;
-                epn->data        = ev->data;
-                epn->pfd.events  = ev->events | POLLALWAYS;
-                epn->pfd.fd      = fd;
-                epn->pfd.revents = 0;
-
-                ret = poll_fdsetup(fd, &epn->pfd, true);
-                if (ret < 0)
-                  {
-                    goto err;
-                  }
+            /* Keep the fd registered with its previous events, as Linux
+             * does, and only drop it if it cannot be set up at all.
+             */
 
+            epn->data       = data;
+            epn->disabled   = disabled;
+            epn->pfd.events = events;
+
+            if (poll_fdsetup(fd, &epn->pfd, true) < 0)
+              {
                 list_delete(&epn->node);
-                list_add_tail(&eph->setup, &epn->node);
-                break;
+                list_add_tail(&eph->free, &epn->node);
               }
+
+            goto err;
           }
 
         break;
@@ -690,7 +730,6 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         goto err;
     }
 
-out:
   nxmutex_unlock(&eph->lock);
   fs_putfilep(filep);
   return OK;
@@ -711,7 +750,6 @@ int epoll_pwait(int epfd, FAR struct epoll_event *evs,
 {
   FAR struct file *filep;
   FAR epoll_head_t *eph;
-  sigset_t oldsigmask;
   int ret;
 
   eph = epoll_head_from_fd(epfd, &filep);
@@ -720,52 +758,16 @@ int epoll_pwait(int epfd, FAR struct epoll_event *evs,
       goto out;
     }
 
-retry:
-  ret = epoll_setup(eph);
+  ret = epoll_wait_events(eph, evs, maxevents, timeout, sigmask);
+  fs_putfilep(filep);
   if (ret < 0)
     {
-      goto err;
-    }
-
-  /* Wait the poll ready */
-
-  nxsig_procmask(SIG_SETMASK, sigmask, &oldsigmask);
-
-  if (timeout == 0)
-    {
-      ret = -ETIMEDOUT;
-    }
-  else if (timeout > 0)
-    {
-      ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
-    }
-  else
-    {
-      ret = nxsem_wait(&eph->sem);
-    }
-
-  nxsig_procmask(SIG_SETMASK, &oldsigmask, NULL);
-  if (ret < 0 && ret != -ETIMEDOUT)
-    {
-      goto err;
-    }
-  else /* ret >= 0 or ret == -ETIMEDOUT */
-    {
-      int num = epoll_teardown(eph, evs, maxevents);
-      if (num == 0 && ret >= 0)
-        {
-          goto retry;
-        }
-
-      ret = num;
+      set_errno(-ret);
+      goto out;
     }
 
-  fs_putfilep(filep);
   return ret;
 
-err:
-  fs_putfilep(filep);
-  set_errno(-ret);
 out:
   ferr("epoll wait failed:%d, timeout:%d\n", errno, timeout);
   return ERROR;
@@ -795,49 +797,16 @@ int epoll_wait(int epfd, FAR struct epoll_event *evs,
       goto out;
     }
 
-retry:
-  ret = epoll_setup(eph);
+  ret = epoll_wait_events(eph, evs, maxevents, timeout, NULL);
+  fs_putfilep(filep);
   if (ret < 0)
     {
-      goto err;
-    }
-
-  /* Wait the poll ready */
-
-  if (timeout == 0)
-    {
-      ret = -ETIMEDOUT;
-    }
-  else if (timeout > 0)
-    {
-      ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
-    }
-  else
-    {
-      ret = nxsem_wait(&eph->sem);
-    }
-
-  if (ret < 0 && ret != -ETIMEDOUT)
-    {
-      goto err;
-    }
-  else /* ret >= 0 or ret == -ETIMEDOUT */
-    {
-      int num = epoll_teardown(eph, evs, maxevents);
-      if (num == 0 && ret >= 0)
-        {
-          goto retry;
-        }
-
-      ret = num;
+      set_errno(-ret);
+      goto out;
     }
 
-  fs_putfilep(filep);
   return ret;
 
-err:
-  fs_putfilep(filep);
-  set_errno(-ret);
 out:
   ferr("epoll wait failed:%d, timeout:%d\n", errno, timeout);
   return ERROR;
@@ -0,0 +1,442 @@
+/****************************************************************************
+ * fs/vfs/fs_pagecache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+#include <nuttx/fs/pagecache.h>
+#include <nuttx/mm/mm.h>
+
+#include "fs_heap.h"
+
+#ifdef CONFIG_FS_PAGECACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PAGECACHE_NBUCKETS 64
+
+#define PAGECACHE_HASH(m, p) \
+  ((((uintptr_t)(m) >> 4) ^ (uintptr_t)(p)) & (PAGECACHE_NBUCKETS - 1))
+
+#define PAGECACHE_PAGESIZE(m) \
+  (sizeof(struct pagecache_page_s) + (m)->pagesize)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached page */
+
+struct pagecache_page_s
+{
+  dq_entry_t lru;                      /* Entry in g_pagecache_lru */
+  FAR struct pagecache_page_s *hnext;  /* Next page in the hash bucket */
+  FAR struct pagecache_s *mapping;     /* The mapping of the page */
+  off_t page;                          /* The page number in the mapping */
+  uint8_t data[1];                     /* The content of the page */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static mutex_t g_pagecache_lock = NXMUTEX_INITIALIZER;
+
+/* All pages, the least recently used one first */
+
+static dq_queue_t g_pagecache_lru;
+
+/* The pages hashed by mapping and page number */
+
+static FAR struct pagecache_page_s *g_pagecache_hash[PAGECACHE_NBUCKETS];
+
+/* The memory used by the pages */
+
+static size_t g_pagecache_size;
+
+#ifdef CONFIG_MM_RECLAIM
+static struct mm_reclaim_s g_pagecache_reclaim;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_find
+ ****************************************************************************/
+
+static FAR struct pagecache_page_s *
+pagecache_find(FAR struct pagecache_s *mapping, off_t page)
+{
+  FAR struct pagecache_page_s *pg;
+
+  for (pg = g_pagecache_hash[PAGECACHE_HASH(mapping, page)]; pg != NULL;
+       pg = pg->hnext)
+    {
+      if (pg->mapping == mapping && pg->page == page)
+        {
+          return pg;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: pagecache_remove
+ ****************************************************************************/
+
+static void pagecache_remove(FAR struct pagecache_page_s *pg)
+{
+  FAR struct pagecache_page_s **prev;
+
+  for (prev = &g_pagecache_hash[PAGECACHE_HASH(pg->mapping, pg->page)];
+       *prev != pg; prev = &(*prev)->hnext)
+    {
+      DEBUGASSERT(*prev != NULL);
+    }
+
+  *prev = pg->hnext;
+  dq_rem(&pg->lru, &g_pagecache_lru);
+  g_pagecache_size -= PAGECACHE_PAGESIZE(pg->mapping);
+  fs_heap_free(pg);
+}
+
+/****************************************************************************
+ * Name: pagecache_lock
+ ****************************************************************************/
+
+static void pagecache_lock(void)
+{
+  /* The stale pages must be dropped, so retry if a signal interrupts */
+
+  while (nxmutex_lock(&g_pagecache_lock) < 0)
+    {
+    }
+}
+
+/****************************************************************************
+ * Name: pagecache_insert
+ *
+ * Description:
+ *   Add a copy of a page to the cache, or update the cached copy, making it
+ *   the most recently used page.  The least recently used pages are dropped
+ *   to stay within the size of the cache.  Failing to cache the page is no
+ *   error.
+ *
+ ****************************************************************************/
+
+static void pagecache_insert(FAR struct pagecache_s *mapping, off_t page,
+                             FAR const uint8_t *data)
+{
+  size_t size = PAGECACHE_PAGESIZE(mapping);
+  FAR struct pagecache_page_s *pg;
+  int hash;
+
+  pg = pagecache_find(mapping, page);
+  if (pg != NULL)
+    {
+      memcpy(pg->data, data, mapping->pagesize);
+      dq_rem(&pg->lru, &g_pagecache_lru);
+      dq_addlast(&pg->lru, &g_pagecache_lru);
+      return;
+    }
+
+  if (size > CONFIG_FS_PAGECACHE_SIZE)
+    {
+      return;
+    }
+
+  while (g_pagecache_size + size > CONFIG_FS_PAGECACHE_SIZE)
+    {
+      pagecache_remove((FAR struct pagecache_page_s *)
+                       dq_peek(&g_pagecache_lru));
+    }
+
+  pg = fs_heap_malloc(size);
+  if (pg == NULL)
+    {
+      return;
+    }
+
+  hash            = PAGECACHE_HASH(mapping, page);
+  pg->mapping     = mapping;
+  pg->page        = page;
+  pg->hnext       = g_pagecache_hash[hash];
+  memcpy(pg->data, data, mapping->pagesize);
+
+  g_pagecache_hash[hash] = pg;
+  dq_addlast(&pg->lru, &g_pagecache_lru);
+  g_pagecache_size += size;
+}
+
+/****************************************************************************
+ * Name: pagecache_reclaim
+ *
+ * Description:
+ *   Memory reclaim callback: drop all pages.  They are always clean.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_RECLAIM
+static size_t pagecache_reclaim(FAR void *arg, bool nonblock)
+{
+  FAR dq_entry_t *entry;
+  size_t released;
+  int ret;
+
+  ret = nonblock ? nxmutex_trylock(&g_pagecache_lock) :
+                   nxmutex_lock(&g_pagecache_lock);
+  if (ret < 0)
+    {
+      return 0;
+    }
+
+  released = g_pagecache_size;
+  while ((entry = dq_peek(&g_pagecache_lru)) != NULL)
+    {
+      pagecache_remove((FAR struct pagecache_page_s *)entry);
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+  return released;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_initialize
+ *
+ * Description:
+ *   Initialize the page cache, called from fs_initialize().
+ *
+ ****************************************************************************/
+
+void pagecache_initialize(void)
+{
+#ifdef CONFIG_MM_RECLAIM
+  g_pagecache_reclaim.reclaim = pagecache_reclaim;
+  g_pagecache_reclaim.cost    = MM_RECLAIM_COST_LOW;
+  mm_register_reclaim(&g_pagecache_reclaim);
+#endif
+}
+
+/****************************************************************************
+ * Name: pagecache_init
+ *
+ * Description:
+ *   Initialize a mapping.  No pages are cached for it yet.
+ *
+ ****************************************************************************/
+
+void pagecache_init(FAR struct pagecache_s *mapping,
+                    FAR const struct pagecache_ops_s *ops, FAR void *priv,
+                    size_t pagesize)
+{
+  DEBUGASSERT(ops != NULL && pagesize > 0);
+
+  mapping->ops      = ops;
+  mapping->priv     = priv;
+  mapping->pagesize = pagesize;
+}
+
+/****************************************************************************
+ * Name: pagecache_read
+ *
+ * Description:
+ *   Read 'npages' pages starting at page number 'page'.  They are copied
+ *   from the cache if all of them are cached, otherwise they are read from
+ *   the backing store with one request and added to the cache.
+ *
+ ****************************************************************************/
+
+int pagecache_read(FAR struct pagecache_s *mapping, off_t page,
+                   size_t npages, FAR uint8_t *buffer)
+{
+  FAR struct pagecache_page_s *pg;
+  size_t i;
+  int ret;
+
+  if (nxmutex_lock(&g_pagecache_lock) >= 0)
+    {
+      for (i = 0; i < npages; i++)
+        {
+          if (pagecache_find(mapping, page + i) == NULL)
+            {
+              break;
+            }
+        }
+
+      if (i == npages)
+        {
+          for (i = 0; i < npages; i++)
+            {
+              pg = pagecache_find(mapping, page + i);
+              memcpy(&buffer[i * mapping->pagesize], pg->data,
+                     mapping->pagesize);
+              dq_rem(&pg->lru, &g_pagecache_lru);
+              dq_addlast(&pg->lru, &g_pagecache_lru);
+            }
+
+          nxmutex_unlock(&g_pagecache_lock);
+          return OK;
+        }
+
+      nxmutex_unlock(&g_pagecache_lock);
+    }
+
+  /* Read the pages without the lock so that the file systems on other
+   * devices are not held up by this one.
+   */
+
+  ret = mapping->ops->read_pages(mapping->priv, page, npages, buffer);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (nxmutex_lock(&g_pagecache_lock) >= 0)
+    {
+      for (i = 0; i < npages; i++)
+        {
+          pagecache_insert(mapping, page + i,
+                           &buffer[i * mapping->pagesize]);
+        }
+
+      nxmutex_unlock(&g_pagecache_lock);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pagecache_write
+ *
+ * Description:
+ *   Write 'npages' pages starting at page number 'page' through to the
+ *   backing store and keep them in the cache.
+ *
+ ****************************************************************************/
+
+int pagecache_write(FAR struct pagecache_s *mapping, off_t page,
+                    size_t npages, FAR const uint8_t *buffer)
+{
+  size_t i;
+  int ret;
+
+  ret = mapping->ops->write_pages(mapping->priv, page, npages, buffer);
+  if (ret < 0)
+    {
+      /* The content of the pages on the media is unknown now */
+
+      pagecache_invalidate(mapping, page, npages);
+      return ret;
+    }
+
+  if (nxmutex_lock(&g_pagecache_lock) >= 0)
+    {
+      for (i = 0; i < npages; i++)
+        {
+          pagecache_insert(mapping, page + i,
+                           &buffer[i * mapping->pagesize]);
+        }
+
+      nxmutex_unlock(&g_pagecache_lock);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pagecache_invalidate
+ *
+ * Description:
+ *   Drop the cached copies of 'npages' pages starting at page number
+ *   'page'.
+ *
+ ****************************************************************************/
+
+void pagecache_invalidate(FAR struct pagecache_s *mapping, off_t page,
+                          size_t npages)
+{
+  FAR struct pagecache_page_s *pg;
+  size_t i;
+
+  pagecache_lock();
+
+  for (i = 0; i < npages; i++)
+    {
+      pg = pagecache_find(mapping, page + i);
+      if (pg != NULL)
+        {
+          pagecache_remove(pg);
+        }
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+}
+
+/****************************************************************************
+ * Name: pagecache_release
+ *
+ * Description:
+ *   Drop all pages of a mapping.
+ *
+ ****************************************************************************/
+
+void pagecache_release(FAR struct pagecache_s *mapping)
+{
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *next;
+
+  pagecache_lock();
+
+  for (entry = dq_peek(&g_pagecache_lru); entry != NULL; entry = next)
+    {
+      FAR struct pagecache_page_s *pg = (FAR struct pagecache_page_s *)entry;
+
+      next = dq_next(entry);
+      if (pg->mapping == mapping)
+        {
+          pagecache_remove(pg);
+        }
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+}
+
+#endif /* CONFIG_FS_PAGECACHE */
@@ -451,6 +451,22 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
   kfds = fds;
 #endif
 
+#ifdef CONFIG_FS_POLL_CACHE
+  /* Poll with the setup kept from the previous call */
+
+  if (nfds > 0)
+    {
+      ret = poll_cache(kfds, nfds, timeout);
+      if (ret >= 0)
+        {
+          count = ret;
+          ret   = OK;
+        }
+
+      goto out_with_kfds;
+    }
+#endif
+
   /* Set up the poll structure */
 
   nxsem_init(&sem, 0, 0);
@@ -526,6 +542,10 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
 
   nxsem_destroy(&sem);
 
+#ifdef CONFIG_FS_POLL_CACHE
+out_with_kfds:
+#endif
+
 #ifdef CONFIG_BUILD_KERNEL
   /* Copy the events back to user */
 
@@ -0,0 +1,623 @@
+/****************************************************************************
+ * fs/vfs/fs_pollcache.c
+ *
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* poll() and select() normally set up every descriptor with its driver on
+ * entry and tear all of them down again on return, so a thread that keeps
+ * polling the same large set pays for the whole set on every call.  With
+ * the poll cache the setup of a thread stays in place from one call to the
+ * next as long as the thread polls the same descriptors for the same
+ * events.  The drivers queue the nodes of the ready descriptors like epoll
+ * does, a call only sets up again the nodes that were ready, to check that
+ * they still are.
+ *
+ * The cache does not hold references to the files.  Instead, the close of a
+ * file tears down the nodes of all caches that refer to it, under the lock
+ * that protects the caches.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <poll.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/list.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+
+#include "sched/sched.h"
+#include "fs_heap.h"
+
+#ifdef CONFIG_FS_POLL_CACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct poll_cache_node_s
+{
+  struct pollfd             pfd;     /* The setup with the driver */
+  FAR struct file          *filep;   /* The file of pfd.fd, NULL if none */
+  FAR struct poll_cache_s  *cache;   /* The cache of the node */
+  struct list_node          ready;   /* Entry in the ready list */
+  pollevent_t               revents; /* The events collected */
+  bool                      queued;  /* In the ready list */
+};
+
+struct poll_cache_s
+{
+  struct list_node          node;    /* Entry in g_poll_cache_list */
+  struct list_node          ready;   /* The nodes with events */
+  spinlock_t                lock;    /* Protects the ready list */
+  sem_t                     sem;     /* Posted on new events */
+  bool                      stale;   /* The setup needs to be rebuilt */
+  nfds_t                    nfds;    /* The number of nodes set up */
+  nfds_t                    nalloc;  /* The number of nodes allocated */
+  FAR struct poll_cache_node_s *nodes;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The list of the caches of all threads and the lock that protects all of
+ * them.  The lock is recursive because releasing a file reference inside
+ * the lock may close the file.
+ */
+
+static struct list_node g_poll_cache_list =
+  LIST_INITIAL_VALUE(g_poll_cache_list);
+static rmutex_t g_poll_cache_lock = NXRMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: poll_cache_cb
+ *
+ * Description:
+ *   The poll callback of the cached nodes.  Collect the events in the node
+ *   and queue it in the ready list.  It may run in an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void poll_cache_cb(FAR struct pollfd *fds)
+{
+  FAR struct poll_cache_node_s *pcn = fds->arg;
+  FAR struct poll_cache_s *pc = pcn->cache;
+  irqstate_t flags;
+  bool wake = false;
+  int semcount = 0;
+
+  flags = spin_lock_irqsave(&pc->lock);
+  pcn->revents |= fds->revents;
+  fds->revents  = 0;
+  if (pcn->revents != 0 && !pcn->queued)
+    {
+      list_add_tail(&pc->ready, &pcn->ready);
+      pcn->queued = true;
+      wake        = true;
+    }
+
+  spin_unlock_irqrestore(&pc->lock, flags);
+
+  if (wake)
+    {
+      nxsem_get_value(&pc->sem, &semcount);
+      if (semcount < 1)
+        {
+          nxsem_post(&pc->sem);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: poll_cache_unqueue
+ *
+ * Description:
+ *   Remove a node from the ready list and forget its events.
+ *
+ ****************************************************************************/
+
+static void poll_cache_unqueue(FAR struct poll_cache_s *pc,
+                               FAR struct poll_cache_node_s *pcn)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&pc->lock);
+  if (pcn->queued)
+    {
+      list_delete(&pcn->ready);
+      pcn->queued = false;
+    }
+
+  pcn->revents     = 0;
+  pcn->pfd.revents = 0;
+  spin_unlock_irqrestore(&pc->lock, flags);
+}
+
+/****************************************************************************
+ * Name: poll_cache_error
+ *
+ * Description:
+ *   Report POLLERR for a node that is not set up, because its setup failed
+ *   or because its file was closed.  The whole setup is rebuilt on the next
+ *   call.
+ *
+ ****************************************************************************/
+
+static void poll_cache_error(FAR struct poll_cache_s *pc,
+                             FAR struct poll_cache_node_s *pcn)
+{
+  pcn->filep       = NULL;
+  pcn->pfd.revents = POLLERR;
+  pc->stale        = true;
+  poll_cache_cb(&pcn->pfd);
+}
+
+/****************************************************************************
+ * Name: poll_cache_teardown
+ *
+ * Description:
+ *   Tear down all nodes of a cache.
+ *
+ ****************************************************************************/
+
+static void poll_cache_teardown(FAR struct poll_cache_s *pc)
+{
+  FAR struct poll_cache_node_s *pcn;
+  nfds_t i;
+
+  for (i = 0; i < pc->nfds; i++)
+    {
+      pcn = &pc->nodes[i];
+      if (pcn->filep != NULL)
+        {
+          file_poll(pcn->filep, &pcn->pfd, false);
+          pcn->filep = NULL;
+        }
+
+      poll_cache_unqueue(pc, pcn);
+    }
+
+  pc->nfds = 0;
+}
+
+/****************************************************************************
+ * Name: poll_cache_match
+ *
+ * Description:
+ *   Check if the cache is set up for the descriptors and events of fds.
+ *
+ ****************************************************************************/
+
+static bool poll_cache_match(FAR struct poll_cache_s *pc,
+                             FAR const struct pollfd *fds, nfds_t nfds)
+{
+  nfds_t i;
+
+  if (pc->stale || pc->nfds != nfds)
+    {
+      return false;
+    }
+
+  for (i = 0; i < nfds; i++)
+    {
+      if (pc->nodes[i].pfd.fd != fds[i].fd ||
+          pc->nodes[i].pfd.events != fds[i].events)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: poll_cache_build
+ *
+ * Description:
+ *   Replace the setup of the cache by a setup of the descriptors of fds.
+ *
+ ****************************************************************************/
+
+static int poll_cache_build(FAR struct poll_cache_s *pc,
+                            FAR const struct pollfd *fds, nfds_t nfds)
+{
+  FAR struct poll_cache_node_s *pcn;
+  FAR struct file *filep;
+  nfds_t i;
+  int ret;
+
+  poll_cache_teardown(pc);
+  pc->stale = false;
+
+  if (nfds > pc->nalloc)
+    {
+      pcn = fs_heap_malloc(nfds * sizeof(struct poll_cache_node_s));
+      if (pcn == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      fs_heap_free(pc->nodes);
+      pc->nodes  = pcn;
+      pc->nalloc = nfds;
+    }
+
+  for (i = 0; i < nfds; i++)
+    {
+      pcn = &pc->nodes[i];
+
+      pcn->pfd.fd      = fds[i].fd;
+      pcn->pfd.events  = fds[i].events;
+      pcn->pfd.revents = 0;
+      pcn->pfd.arg     = pcn;
+      pcn->pfd.cb      = poll_cache_cb;
+      pcn->pfd.priv    = NULL;
+      pcn->filep       = NULL;
+      pcn->cache       = pc;
+      pcn->revents     = 0;
+      pcn->queued      = false;
+    }
+
+  /* Count the nodes before the setup, the close of a file may walk them */
+
+  pc->nfds = nfds;
+
+  for (i = 0; i < nfds; i++)
+    {
+      pcn = &pc->nodes[i];
+      if (pcn->pfd.fd < 0)
+        {
+          continue;
+        }
+
+      ret = fs_getfilep(pcn->pfd.fd, &filep);
+      if (ret >= 0)
+        {
+          ret = file_poll(filep, &pcn->pfd, true);
+          if (ret >= 0)
+            {
+              pcn->filep = filep;
+            }
+
+          fs_putfilep(filep);
+        }
+
+      if (ret < 0)
+        {
+          poll_cache_error(pc, pcn);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: poll_cache_drain
+ *
+ * Description:
+ *   Report the events of the nodes in the ready list.  A driver reports
+ *   only the changes of the events, so each ready node is set up again to
+ *   get the events right now.  A node that is still ready stays in the
+ *   ready list to be checked again by the next call.
+ *
+ * Returned Value:
+ *   The number of entries of fds with events.
+ *
+ ****************************************************************************/
+
+static int poll_cache_drain(FAR struct poll_cache_s *pc,
+                            FAR struct pollfd *fds)
+{
+  FAR struct poll_cache_node_s *pcn;
+  FAR struct poll_cache_node_s *tmp;
+  struct list_node check;
+  pollevent_t revents;
+  irqstate_t flags;
+  int count = 0;
+  int ret;
+
+  list_initialize(&check);
+
+  flags = spin_lock_irqsave(&pc->lock);
+  while (!list_is_empty(&pc->ready))
+    {
+      pcn = container_of(list_remove_head(&pc->ready),
+                         struct poll_cache_node_s, ready);
+      list_add_tail(&check, &pcn->ready);
+    }
+
+  spin_unlock_irqrestore(&pc->lock, flags);
+
+  /* The nodes in the check list stay marked as queued, so the callbacks
+   * only collect their events until they are checked.
+   */
+
+  list_for_every_entry_safe(&check, pcn, tmp, struct poll_cache_node_s,
+                            ready)
+    {
+      flags = spin_lock_irqsave(&pc->lock);
+      list_delete(&pcn->ready);
+      pcn->queued = false;
+      spin_unlock_irqrestore(&pc->lock, flags);
+
+      if (pcn->filep != NULL)
+        {
+          file_poll(pcn->filep, &pcn->pfd, false);
+          poll_cache_unqueue(pc, pcn);
+          ret = file_poll(pcn->filep, &pcn->pfd, true);
+          if (ret < 0)
+            {
+              poll_cache_error(pc, pcn);
+            }
+        }
+      else
+        {
+          poll_cache_cb(&pcn->pfd);
+        }
+
+      flags   = spin_lock_irqsave(&pc->lock);
+      revents = pcn->revents;
+      spin_unlock_irqrestore(&pc->lock, flags);
+
+      if (revents != 0)
+        {
+          fds[pcn - pc->nodes].revents = revents;
+          count++;
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: poll_cache_get
+ *
+ * Description:
+ *   Get the cache of the running thread, allocate it on the first call.
+ *
+ ****************************************************************************/
+
+static FAR struct poll_cache_s *poll_cache_get(void)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  FAR struct poll_cache_s *pc = rtcb->pollcache;
+
+  if (pc == NULL)
+    {
+      pc = fs_heap_zalloc(sizeof(struct poll_cache_s));
+      if (pc == NULL)
+        {
+          return NULL;
+        }
+
+      list_initialize(&pc->ready);
+      spin_lock_init(&pc->lock);
+      nxsem_init(&pc->sem, 0, 0);
+
+      list_add_tail(&g_poll_cache_list, &pc->node);
+      rtcb->pollcache = pc;
+    }
+
+  return pc;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: poll_cache
+ *
+ * Description:
+ *   The poll() operation with the setup kept in the cache of the running
+ *   thread.  Only the revents fields of fds are written.
+ *
+ * Input Parameters:
+ *   fds     - List of structures describing file descriptors to be
+ *             monitored
+ *   nfds    - The number of entries in the list, not zero
+ *   timeout - The timeout in milliseconds, negative for no timeout
+ *
+ * Returned Value:
+ *   The number of structures that have non-zero revents fields, zero on a
+ *   timeout; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int poll_cache(FAR struct pollfd *fds, nfds_t nfds, int timeout)
+{
+  FAR struct poll_cache_s *pc;
+  clock_t deadline = 0;
+  clock_t now;
+  nfds_t i;
+  int count = 0;
+  int ret = OK;
+
+  if (timeout > 0)
+    {
+      deadline = clock_systime_ticks() + MSEC2TICK((clock_t)timeout);
+    }
+
+  nxrmutex_lock(&g_poll_cache_lock);
+
+  pc = poll_cache_get();
+  if (pc == NULL)
+    {
+      ret = -ENOMEM;
+      goto out;
+    }
+
+  if (!poll_cache_match(pc, fds, nfds))
+    {
+      ret = poll_cache_build(pc, fds, nfds);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  for (i = 0; i < nfds; i++)
+    {
+      fds[i].revents = 0;
+    }
+
+  for (; ; )
+    {
+      count = poll_cache_drain(pc, fds);
+      if (count > 0 || timeout == 0)
+        {
+          break;
+        }
+
+      /* Wait without the lock, the close of a file may need it */
+
+      nxrmutex_unlock(&g_poll_cache_lock);
+
+      if (timeout > 0)
+        {
+          now = clock_systime_ticks();
+          if ((sclock_t)(deadline - now) > 0)
+            {
+              ret = nxsem_tickwait(&pc->sem, deadline - now);
+            }
+          else
+            {
+              ret = -ETIMEDOUT;
+            }
+        }
+      else
+        {
+          ret = nxsem_wait(&pc->sem);
+        }
+
+      nxrmutex_lock(&g_poll_cache_lock);
+
+      if (ret == -ETIMEDOUT)
+        {
+          /* Return zero (OK) in the event of a timeout, unless events
+           * came in at the last moment.
+           */
+
+          count = poll_cache_drain(pc, fds);
+          ret   = OK;
+          break;
+        }
+      else if (ret < 0)
+        {
+          break;
+        }
+    }
+
+out:
+  nxrmutex_unlock(&g_poll_cache_lock);
+  return ret < 0 ? ret : count;
+}
+
+/****************************************************************************
+ * Name: poll_cache_close
+ *
+ * Description:
+ *   Tear down the cached setup of a file that is being closed.  The nodes
+ *   of the file report POLLERR and their caches are rebuilt on the next
+ *   call.
+ *
+ * Input Parameters:
+ *   filep - The file being closed
+ *
+ ****************************************************************************/
+
+void poll_cache_close(FAR struct file *filep)
+{
+  FAR struct poll_cache_node_s *pcn;
+  FAR struct poll_cache_s *pc;
+  nfds_t i;
+
+  if (list_is_empty(&g_poll_cache_list))
+    {
+      return;
+    }
+
+  nxrmutex_lock(&g_poll_cache_lock);
+
+  list_for_every_entry(&g_poll_cache_list, pc, struct poll_cache_s, node)
+    {
+      for (i = 0; i < pc->nfds; i++)
+        {
+          pcn = &pc->nodes[i];
+          if (pcn->filep == filep)
+            {
+              file_poll(filep, &pcn->pfd, false);
+              poll_cache_unqueue(pc, pcn);
+              poll_cache_error(pc, pcn);
+            }
+        }
+    }
+
+  nxrmutex_unlock(&g_poll_cache_lock);
+}
+
+/****************************************************************************
+ * Name: poll_cache_release
+ *
+ * Description:
+ *   Tear down and free the cache of an exiting thread.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the exiting thread
+ *
+ ****************************************************************************/
+
+void poll_cache_release(FAR struct tcb_s *tcb)
+{
+  FAR struct poll_cache_s *pc = tcb->pollcache;
+
+  if (pc == NULL)
+    {
+      return;
+    }
+
+  nxrmutex_lock(&g_poll_cache_lock);
+  poll_cache_teardown(pc);
+  list_delete(&pc->node);
+  tcb->pollcache = NULL;
+  nxrmutex_unlock(&g_poll_cache_lock);
+
+  nxsem_destroy(&pc->sem);
+  fs_heap_free(pc->nodes);
+  fs_heap_free(pc);
+}
+
+#endif /* CONFIG_FS_POLL_CACHE */
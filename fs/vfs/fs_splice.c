@@ -0,0 +1,318 @@
+/****************************************************************************
+ * fs/vfs/fs_splice.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/semaphore.h>
+
+#ifdef CONFIG_PIPES
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SPLICE_F_ALL (SPLICE_F_MOVE | SPLICE_F_NONBLOCK | SPLICE_F_MORE | \
+                      SPLICE_F_GIFT)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice_wait
+ *
+ * Description:
+ *   Wait until the end of a splice() that is not a pipe can be read or
+ *   written without blocking.  The pipe is locked while the data is
+ *   transferred, so a socket, for example, must not block then.
+ *
+ ****************************************************************************/
+
+static int splice_wait(FAR struct file *filep, pollevent_t events)
+{
+  struct pollfd fds;
+  sem_t sem;
+  int ret;
+
+  if (INODE_IS_MOUNTPT(filep->f_inode) ||
+      (filep->f_oflags & O_NONBLOCK) != 0)
+    {
+      return OK;
+    }
+
+  nxsem_init(&sem, 0, 0);
+
+  fds.fd      = -1;
+  fds.events  = events;
+  fds.revents = 0;
+  fds.arg     = &sem;
+  fds.cb      = poll_default_cb;
+  fds.priv    = NULL;
+
+  ret = file_poll(filep, &fds, true);
+  if (ret < 0)
+    {
+      /* The file can not be polled, just try the transfer */
+
+      ret = OK;
+      goto errout;
+    }
+
+  if (fds.revents == 0)
+    {
+      ret = nxsem_wait(&sem);
+    }
+
+  file_poll(filep, &fds, false);
+
+errout:
+  nxsem_destroy(&sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the standard splice function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoff,
+                    FAR struct file *outfile, FAR off_t *outoff,
+                    size_t len, unsigned int flags)
+{
+  bool inpipe  = INODE_IS_PIPE(infile->f_inode);
+  bool outpipe = INODE_IS_PIPE(outfile->f_inode);
+  int ret;
+
+  if ((flags & ~SPLICE_F_ALL) != 0)
+    {
+      return -EINVAL;
+    }
+
+  if ((infile->f_oflags & O_RDOK) == 0 || (outfile->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  if ((inpipe && inoff != NULL) || (outpipe && outoff != NULL))
+    {
+      return -ESPIPE;
+    }
+
+  if ((outfile->f_oflags & O_APPEND) != 0)
+    {
+      return -EINVAL;
+    }
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  if (inpipe && outpipe)
+    {
+      if (infile->f_inode == outfile->f_inode)
+        {
+          return -EINVAL;
+        }
+
+      return pipe_tee(infile, outfile, len, flags, true);
+    }
+  else if (inpipe)
+    {
+      ret = splice_wait(outfile, POLLOUT);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      return pipe_spliceout(infile, outfile, outoff, len, flags);
+    }
+  else if (outpipe)
+    {
+      ret = splice_wait(infile, POLLIN);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      return pipe_splicein(infile, inoff, outfile, len, flags);
+    }
+
+  /* One end must be a pipe */
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   splice() moves up to 'len' bytes between two file descriptors, one of
+ *   which must be a pipe.  The data is transferred directly between the
+ *   buffer of the pipe and the other file, without the copy into and out
+ *   of a user buffer that read() and write() would do.  This is not a
+ *   POSIX interface, it follows the Linux splice() interface.
+ *
+ * Input Parameters:
+ *   fd_in   - The descriptor to read from
+ *   off_in  - NULL for a pipe.  Otherwise, if not NULL, the offset to read
+ *             from, which is updated, and the file offset is not changed.
+ *   fd_out  - The descriptor to write to
+ *   off_out - As 'off_in' for 'fd_out'
+ *   len     - The maximum number of bytes to move
+ *   flags   - A bit mask of SPLICE_F_* flags, only SPLICE_F_NONBLOCK has
+ *             an effect
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at the end of the input.  On error, -1
+ *   is returned, and errno is set appropriately.
+ *
+ *   EAGAIN - SPLICE_F_NONBLOCK was given or the pipe is non-blocking and
+ *            the transfer would block.
+ *   EINVAL - Neither descriptor is a pipe, both refer to the same pipe,
+ *            the output is opened with O_APPEND or 'flags' is not valid.
+ *   ESPIPE - An offset is given for a pipe.
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out, FAR off_t *off_out,
+               size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  ret = fs_getfilep(fd_in, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd_out, &outfile);
+  if (ret < 0)
+    {
+      fs_putfilep(infile);
+      goto errout;
+    }
+
+  ret = file_splice(infile, off_in, outfile, off_out, len, flags);
+  fs_putfilep(outfile);
+  fs_putfilep(infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: tee
+ *
+ * Description:
+ *   tee() copies up to 'len' bytes from the pipe 'fd_in' to the pipe
+ *   'fd_out' without removing them from 'fd_in'.  This is not a POSIX
+ *   interface, it follows the Linux tee() interface.
+ *
+ * Returned Value:
+ *   The number of bytes copied, zero if 'fd_in' is empty and has no
+ *   writers.  On error, -1 is returned, and errno is set appropriately.
+ *
+ *   EAGAIN - SPLICE_F_NONBLOCK was given or a pipe is non-blocking and the
+ *            copy would block.
+ *   EINVAL - A descriptor is not a pipe, both refer to the same pipe or
+ *            'flags' is not valid.
+ *
+ ****************************************************************************/
+
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  ret = fs_getfilep(fd_in, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd_out, &outfile);
+  if (ret < 0)
+    {
+      fs_putfilep(infile);
+      goto errout;
+    }
+
+  if (!INODE_IS_PIPE(infile->f_inode) || !INODE_IS_PIPE(outfile->f_inode) ||
+      infile->f_inode == outfile->f_inode || (flags & ~SPLICE_F_ALL) != 0)
+    {
+      ret = -EINVAL;
+    }
+  else if ((infile->f_oflags & O_RDOK) == 0 ||
+           (outfile->f_oflags & O_WROK) == 0)
+    {
+      ret = -EBADF;
+    }
+  else if (len > 0)
+    {
+      ret = pipe_tee(infile, outfile, len, flags, false);
+    }
+
+  fs_putfilep(outfile);
+  fs_putfilep(infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+#endif /* CONFIG_PIPES */
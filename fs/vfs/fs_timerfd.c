@@ -33,6 +33,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/mutex.h>
 
 #include <sys/ioctl.h>
@@ -63,9 +64,15 @@ struct timerfd_priv_s
   mutex_t                   lock;    /* Enforces device exclusive access */
   FAR timerfd_waiter_sem_t *rdsems;  /* List of blocking readers */
   int                       clock;   /* Clock to use as the timing base */
+#ifdef CONFIG_HRTIMER
+  uint64_t                  delay;   /* If non-zero, used to reset repetitive
+                                      * timers (nanoseconds) */
+  struct hrtimer_s          hrtimer; /* The timer that provides the timing */
+#else
   int                       delay;   /* If non-zero, used to reset repetitive
                                       * timers */
   struct wdog_s             wdog;    /* The watchdog that provides the timing */
+#endif
   timerfd_t                 counter; /* timerfd counter */
   uint8_t                   crefs;   /* References counts on timerfd (max: 255) */
 
@@ -156,7 +163,11 @@ static FAR struct timerfd_priv_s *timerfd_allocdev(void)
 
 static void timerfd_destroy(FAR struct timerfd_priv_s *dev)
 {
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&dev->hrtimer);
+#else
   wd_cancel(&dev->wdog);
+#endif
   nxmutex_unlock(&dev->lock);
   nxmutex_destroy(&dev->lock);
   fs_heap_free(dev);
@@ -402,7 +413,14 @@ static void timerfd_timeout(wdparm_t arg)
 
   if (dev->delay > 0)
     {
+#ifdef CONFIG_HRTIMER
+      /* Relative to the last expiration, the period does not drift */
+
+      hrtimer_start_absnsec(&dev->hrtimer, dev->hrtimer.expired + dev->delay,
+                            timerfd_timeout, arg);
+#else
       wd_start(&dev->wdog, dev->delay, timerfd_timeout, arg);
+#endif
     }
 
 #ifdef CONFIG_TIMER_FD_POLL
@@ -488,7 +506,11 @@ int timerfd_settime(int fd, int flags,
   FAR struct timerfd_priv_s *dev;
   FAR struct file *filep;
   irqstate_t intflags;
+#ifdef CONFIG_HRTIMER
+  uint64_t expired;
+#else
   sclock_t delay;
+#endif
   int ret;
 
   /* Some sanity checks */
@@ -528,6 +550,10 @@ int timerfd_settime(int fd, int flags,
 
   if (old_value)
     {
+#ifdef CONFIG_HRTIMER
+      clock_nsec2time(&old_value->it_value, hrtimer_gettime(&dev->hrtimer));
+      clock_nsec2time(&old_value->it_interval, dev->delay);
+#else
       /* Get the number of ticks before the underlying watchdog expires */
 
       delay = wd_gettime(&dev->wdog);
@@ -536,13 +562,18 @@ int timerfd_settime(int fd, int flags,
 
       clock_ticks2time(&old_value->it_value, delay);
       clock_ticks2time(&old_value->it_interval, dev->delay);
+#endif
     }
 
   /* Disarm the timer (in case the timer was already armed when
    * timerfd_settime() is called).
    */
 
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&dev->hrtimer);
+#else
   wd_cancel(&dev->wdog);
+#endif
 
   /* Clear expiration counter */
 
@@ -559,6 +590,25 @@ int timerfd_settime(int fd, int flags,
       return OK;
     }
 
+#ifdef CONFIG_HRTIMER
+  /* Setup up any repetitive timer, then start the high resolution timer.
+   * A time in the past or now expires at once.
+   */
+
+  dev->delay = clock_time2nsec(&new_value->it_interval);
+
+  if ((flags & TFD_TIMER_ABSTIME) != 0)
+    {
+      expired = hrtimer_abstime2nsec(dev->clock, &new_value->it_value);
+    }
+  else
+    {
+      expired = hrtimer_curtime() + clock_time2nsec(&new_value->it_value);
+    }
+
+  ret = hrtimer_start_absnsec(&dev->hrtimer, expired, timerfd_timeout,
+                              (wdparm_t)dev);
+#else
   /* Setup up any repetitive timer */
 
   delay = clock_time2ticks(&new_value->it_interval);
@@ -598,6 +648,7 @@ int timerfd_settime(int fd, int flags,
   /* Then start the watchdog */
 
   ret = wd_start(&dev->wdog, delay, timerfd_timeout, (wdparm_t)dev);
+#endif
   if (ret < 0)
     {
       leave_critical_section(intflags);
@@ -619,7 +670,9 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 {
   FAR struct timerfd_priv_s *dev;
   FAR struct file *filep;
+#ifndef CONFIG_HRTIMER
   sclock_t ticks;
+#endif
   int ret;
 
   /* Some sanity checks */
@@ -646,6 +699,10 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 
   dev = (FAR struct timerfd_priv_s *)filep->f_priv;
 
+#ifdef CONFIG_HRTIMER
+  clock_nsec2time(&curr_value->it_value, hrtimer_gettime(&dev->hrtimer));
+  clock_nsec2time(&curr_value->it_interval, dev->delay);
+#else
   /* Get the number of ticks before the underlying watchdog expires */
 
   ticks = wd_gettime(&dev->wdog);
@@ -654,6 +711,7 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 
   clock_ticks2time(&curr_value->it_value, ticks);
   clock_ticks2time(&curr_value->it_interval, dev->delay);
+#endif
   fs_putfilep(filep);
   return OK;
 
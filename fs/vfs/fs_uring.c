@@ -0,0 +1,855 @@
+/****************************************************************************
+ * fs/vfs/fs_uring.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/io_uring.h>
+#include <stdbool.h>
+#include <poll.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <debug.h>
+
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
+#include "fs_heap.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The states of a request that did not complete at once */
+
+#define URING_ARMED   0  /* Waiting for the poll events */
+#define URING_READY   1  /* The poll events arrived */
+#define URING_QUEUED  2  /* Queued to the worker thread */
+#define URING_DONE    3  /* Completed by the worker thread */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct uring_s;
+
+/* One operation that did not complete in io_uring_enter() */
+
+struct uring_req_s
+{
+  dq_entry_t node;               /* Entry in the active requests */
+  FAR struct uring_s *ring;      /* The ring of the request */
+  FAR struct file *filep;        /* The file to operate on */
+  struct io_uring_sqe sqe;       /* Copy of the submission entry */
+  struct pollfd fds;             /* Waits for the file to be ready */
+  struct work_s work;            /* Runs the operation on the worker */
+  ssize_t res;                   /* The result of the operation */
+  volatile uint8_t state;        /* See URING_* definitions */
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  uint8_t prio;                  /* Priority of the submitting thread */
+#endif
+};
+
+/* The kernel side of a ring.  The indices that the kernel writes are kept
+ * here too, the copies in the shared memory are only written.
+ */
+
+struct uring_s
+{
+  mutex_t lock;                  /* Serializes io_uring_enter() */
+  sem_t wait;                    /* Posted when a request finishes */
+  spinlock_t splock;             /* Protects the state of the requests */
+  dq_queue_t active;             /* The requests that did not complete */
+  unsigned int nactive;          /* The number of active requests */
+
+  /* The shared memory */
+
+  FAR struct io_uring_rings *rings;
+  FAR struct io_uring_sqe *sqes;
+  FAR struct io_uring_cqe *cqes;
+  uint32_t sq_entries;           /* The size of the submission ring */
+  uint32_t cq_entries;           /* The size of the completion ring */
+  uint32_t sq_head;              /* Next entry to take */
+  uint32_t cq_tail;              /* Next entry to fill */
+#ifdef CONFIG_BUILD_KERNEL
+  FAR struct task_group_s *group; /* The owner of the shared memory */
+#endif
+  uint8_t crefs;                 /* References counts on the ring */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int uring_open(FAR struct file *filep);
+static int uring_close(FAR struct file *filep);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_uring_fops =
+{
+  uring_open,   /* open */
+  uring_close   /* close */
+};
+
+static struct inode g_uring_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_uring_fops         /* u */
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static bool uring_ispow2(uint32_t n)
+{
+  return n != 0 && (n & (n - 1)) == 0;
+}
+
+/****************************************************************************
+ * Name: uring_perform
+ *
+ * Description:
+ *   Perform the operation of a request, which may block.
+ *
+ ****************************************************************************/
+
+static ssize_t uring_perform(FAR struct uring_req_s *req)
+{
+  FAR struct io_uring_sqe *sqe = &req->sqe;
+#ifdef CONFIG_NET
+  FAR struct socket *psock;
+#endif
+
+  switch (sqe->opcode)
+    {
+      case IORING_OP_NOP:
+        return 0;
+
+      case IORING_OP_READ:
+        if (sqe->off < 0)
+          {
+            return file_read(req->filep, sqe->addr, sqe->len);
+          }
+
+        return file_pread(req->filep, sqe->addr, sqe->len, sqe->off);
+
+      case IORING_OP_WRITE:
+        if (sqe->off < 0)
+          {
+            return file_write(req->filep, sqe->addr, sqe->len);
+          }
+
+        return file_pwrite(req->filep, sqe->addr, sqe->len, sqe->off);
+
+      case IORING_OP_FSYNC:
+        return file_fsync(req->filep);
+
+#ifdef CONFIG_NET
+      case IORING_OP_SEND:
+      case IORING_OP_RECV:
+        psock = file_socket(req->filep);
+        if (psock == NULL)
+          {
+            return -ENOTSOCK;
+          }
+
+        if (sqe->opcode == IORING_OP_SEND)
+          {
+            return psock_send(psock, sqe->addr, sqe->len, sqe->op_flags);
+          }
+
+        return psock_recv(psock, sqe->addr, sqe->len, sqe->op_flags);
+#endif
+
+      default:
+        return -EINVAL;
+    }
+}
+
+/****************************************************************************
+ * Name: uring_commit
+ *
+ * Description:
+ *   Add a completion to the completion ring.  There is always room, as no
+ *   more operations are submitted than the ring can take.
+ *
+ * Assumptions:
+ *   The ring is locked, in the context of the owner of the shared memory.
+ *
+ ****************************************************************************/
+
+static void uring_commit(FAR struct uring_s *ring, uint64_t user_data,
+                         ssize_t res)
+{
+  FAR struct io_uring_cqe *cqe;
+
+  cqe            = &ring->cqes[ring->cq_tail & (ring->cq_entries - 1)];
+  cqe->user_data = user_data;
+  cqe->res       = res;
+  cqe->flags     = 0;
+
+  ring->cq_tail++;
+  ring->rings->cq_tail = ring->cq_tail;
+}
+
+/****************************************************************************
+ * Name: uring_pending
+ *
+ * Description:
+ *   Return the number of completions in the completion ring that the
+ *   application did not take yet.
+ *
+ ****************************************************************************/
+
+static uint32_t uring_pending(FAR struct uring_s *ring)
+{
+  uint32_t pending = ring->cq_tail - ring->rings->cq_head;
+
+  /* Do not trust an application that moved the head past the tail */
+
+  return pending > ring->cq_entries ? ring->cq_entries : pending;
+}
+
+/****************************************************************************
+ * Name: uring_free
+ *
+ * Description:
+ *   Release the file of a request and free it.
+ *
+ ****************************************************************************/
+
+static void uring_free(FAR struct uring_req_s *req)
+{
+  if (req->filep != NULL)
+    {
+      fs_putfilep(req->filep);
+    }
+
+  fs_heap_free(req);
+}
+
+/****************************************************************************
+ * Name: uring_finish
+ *
+ * Description:
+ *   Move a request to a new state and wake up io_uring_enter().  This is
+ *   called from the poll callbacks and the worker thread.
+ *
+ ****************************************************************************/
+
+static void uring_finish(FAR struct uring_req_s *req, uint8_t from,
+                         uint8_t to)
+{
+  FAR struct uring_s *ring = req->ring;
+  irqstate_t flags;
+  bool wake = false;
+
+  flags = spin_lock_irqsave(&ring->splock);
+  if (req->state == from)
+    {
+      req->state = to;
+      wake       = true;
+    }
+
+  spin_unlock_irqrestore(&ring->splock, flags);
+
+  if (wake)
+    {
+      nxsem_post(&ring->wait);
+    }
+}
+
+/****************************************************************************
+ * Name: uring_poll_cb
+ *
+ * Description:
+ *   The poll callback of the requests that wait for their file.
+ *
+ ****************************************************************************/
+
+static void uring_poll_cb(FAR struct pollfd *fds)
+{
+  uring_finish(fds->arg, URING_ARMED, URING_READY);
+}
+
+/****************************************************************************
+ * Name: uring_worker
+ *
+ * Description:
+ *   Perform the operation of a request on the low priority worker thread.
+ *
+ ****************************************************************************/
+
+static void uring_worker(FAR void *arg)
+{
+  FAR struct uring_req_s *req = arg;
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  uint8_t prio = req->prio;
+#endif
+
+  req->res = uring_perform(req);
+  uring_finish(req, URING_QUEUED, URING_DONE);
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  /* Restore the low priority worker thread default priority */
+
+  lpwork_restorepriority(prio);
+#endif
+}
+
+/****************************************************************************
+ * Name: uring_queue
+ *
+ * Description:
+ *   Schedule the operation of a request on the low priority work queue,
+ *   like the AIO requests.
+ *
+ ****************************************************************************/
+
+static int uring_queue(FAR struct uring_req_s *req)
+{
+  int ret;
+
+  req->state = URING_QUEUED;
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  /* Prohibit context switches until we complete the queuing */
+
+  sched_lock();
+
+  /* Make sure that the low-priority worker thread is running at at least
+   * the priority of the submitting thread.
+   */
+
+  req->prio = nxsched_self()->sched_priority;
+  lpwork_boostpriority(req->prio);
+#endif
+
+  ret = work_queue(LPWORK, &req->work, uring_worker, req, 0);
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if (ret < 0)
+    {
+      lpwork_restorepriority(req->prio);
+    }
+
+  sched_unlock();
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: uring_reap
+ *
+ * Description:
+ *   Move the finished requests to the completion ring.  The requests whose
+ *   file became ready start their operation on the worker thread.
+ *
+ * Assumptions:
+ *   The ring is locked, in the context of the owner of the shared memory.
+ *
+ ****************************************************************************/
+
+static void uring_reap(FAR struct uring_s *ring)
+{
+  FAR struct uring_req_s *req;
+  FAR dq_entry_t *next;
+  FAR dq_entry_t *entry;
+  ssize_t res;
+  int ret;
+
+  for (entry = dq_peek(&ring->active); entry != NULL; entry = next)
+    {
+      next = dq_next(entry);
+      req  = (FAR struct uring_req_s *)entry;
+
+      if (req->state == URING_READY)
+        {
+          file_poll(req->filep, &req->fds, false);
+
+          if (req->sqe.opcode != IORING_OP_POLL_ADD)
+            {
+              ret = uring_queue(req);
+              if (ret >= 0)
+                {
+                  continue;
+                }
+
+              res = ret;
+            }
+          else
+            {
+              res = req->fds.revents;
+            }
+        }
+      else if (req->state == URING_DONE)
+        {
+          res = req->res;
+        }
+      else
+        {
+          continue;
+        }
+
+      dq_rem(&req->node, &ring->active);
+      ring->nactive--;
+      uring_commit(ring, req->sqe.user_data, res);
+      uring_free(req);
+    }
+}
+
+/****************************************************************************
+ * Name: uring_submit
+ *
+ * Description:
+ *   Start the operation of one submission entry.  It completes at once
+ *   unless the file is not ready yet or the entry asks for the worker
+ *   thread.
+ *
+ * Assumptions:
+ *   The ring is locked, in the context of the owner of the shared memory.
+ *
+ ****************************************************************************/
+
+static void uring_submit(FAR struct uring_s *ring,
+                         FAR const struct io_uring_sqe *sqe)
+{
+  FAR struct uring_req_s *req;
+  irqstate_t flags;
+  bool posted = false;
+  bool ready;
+  ssize_t res;
+  int ret;
+
+  req = fs_heap_zalloc(sizeof(struct uring_req_s));
+  if (req == NULL)
+    {
+      uring_commit(ring, sqe->user_data, -ENOMEM);
+      return;
+    }
+
+  req->ring = ring;
+  req->sqe  = *sqe;
+
+  if (sqe->opcode != IORING_OP_NOP)
+    {
+      ret = fs_getfilep(sqe->fd, &req->filep);
+      if (ret < 0)
+        {
+          req->filep = NULL;
+          res = ret;
+          goto out;
+        }
+    }
+
+  if ((sqe->flags & IOSQE_ASYNC) != 0)
+    {
+      ret = uring_queue(req);
+      if (ret < 0)
+        {
+          res = ret;
+          goto out;
+        }
+
+      goto active;
+    }
+
+  /* Wait for the file to become ready instead of blocking in the
+   * operation.  Regular files and files without a poll method are always
+   * ready.
+   */
+
+  switch (sqe->opcode)
+    {
+      case IORING_OP_POLL_ADD:
+        req->fds.events = sqe->op_flags;
+        break;
+
+      case IORING_OP_READ:
+      case IORING_OP_RECV:
+        req->fds.events = POLLIN;
+        break;
+
+      case IORING_OP_WRITE:
+      case IORING_OP_SEND:
+        req->fds.events = POLLOUT;
+        break;
+
+      default:
+        res = uring_perform(req);
+        goto out;
+    }
+
+  if (sqe->opcode != IORING_OP_POLL_ADD &&
+      (INODE_IS_MOUNTPT(req->filep->f_inode) ||
+       INODE_IS_BLOCK(req->filep->f_inode) ||
+       INODE_IS_MTD(req->filep->f_inode)))
+    {
+      res = uring_perform(req);
+      goto out;
+    }
+
+  req->fds.fd  = sqe->fd;
+  req->fds.arg = req;
+  req->fds.cb  = uring_poll_cb;
+  req->state   = URING_ARMED;
+
+  ret = file_poll(req->filep, &req->fds, true);
+  if (ret < 0)
+    {
+      res = sqe->opcode == IORING_OP_POLL_ADD ? ret : uring_perform(req);
+      goto out;
+    }
+
+  flags = spin_lock_irqsave(&ring->splock);
+  ready = req->fds.revents != 0;
+  if (ready)
+    {
+      posted     = req->state == URING_READY;
+      req->state = URING_DONE;
+    }
+
+  spin_unlock_irqrestore(&ring->splock, flags);
+
+  if (ready)
+    {
+      /* Take back the wake-up of a callback during the setup */
+
+      if (posted)
+        {
+          nxsem_trywait(&ring->wait);
+        }
+
+      file_poll(req->filep, &req->fds, false);
+      res = sqe->opcode == IORING_OP_POLL_ADD ? req->fds.revents :
+                                                uring_perform(req);
+      goto out;
+    }
+
+active:
+  dq_addlast(&req->node, &ring->active);
+  ring->nactive++;
+  return;
+
+out:
+  uring_commit(ring, sqe->user_data, res);
+  uring_free(req);
+}
+
+/****************************************************************************
+ * Name: uring_destroy
+ *
+ * Description:
+ *   Stop the requests that did not complete and free the ring.
+ *
+ ****************************************************************************/
+
+static void uring_destroy(FAR struct uring_s *ring)
+{
+  FAR struct uring_req_s *req;
+
+  while ((req = (FAR struct uring_req_s *)
+                dq_remfirst(&ring->active)) != NULL)
+    {
+      if (req->state == URING_ARMED || req->state == URING_READY)
+        {
+          file_poll(req->filep, &req->fds, false);
+        }
+      else
+        {
+          while (work_cancel_sync(LPWORK, &req->work) >= 0)
+            {
+            }
+        }
+
+      uring_free(req);
+    }
+
+  nxsem_destroy(&ring->wait);
+  nxmutex_destroy(&ring->lock);
+  fs_heap_free(ring);
+}
+
+static int uring_open(FAR struct file *filep)
+{
+  FAR struct uring_s *ring = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&ring->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (ring->crefs >= 255)
+    {
+      /* More than 255 opens; uint8_t would overflow to zero */
+
+      ret = -EMFILE;
+    }
+  else
+    {
+      ring->crefs++;
+    }
+
+  nxmutex_unlock(&ring->lock);
+  return ret;
+}
+
+static int uring_close(FAR struct file *filep)
+{
+  FAR struct uring_s *ring = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&ring->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (--ring->crefs > 0)
+    {
+      nxmutex_unlock(&ring->lock);
+      return OK;
+    }
+
+  nxmutex_unlock(&ring->lock);
+  uring_destroy(ring);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: io_uring_setup
+ *
+ * Description:
+ *   Create a ring file descriptor for the shared rings described by 'p'.
+ *
+ * Input Parameters:
+ *   entries - The size of the submission ring, a power of two
+ *   p       - The memory of the rings and the size of the completion ring
+ *
+ * Returned Value:
+ *   The new file descriptor on success; -1 (ERROR) with errno set on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int io_uring_setup(unsigned int entries, FAR struct io_uring_params *p)
+{
+  FAR struct uring_s *ring;
+  int ret;
+
+  if (p == NULL || p->rings == NULL || p->sqes == NULL || p->cqes == NULL ||
+      !uring_ispow2(entries) || !uring_ispow2(p->cq_entries) ||
+      entries > CONFIG_FS_URING_MAXENTRIES ||
+      p->cq_entries > CONFIG_FS_URING_MAXENTRIES)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ring = fs_heap_zalloc(sizeof(struct uring_s));
+  if (ring == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  nxmutex_init(&ring->lock);
+  nxsem_init(&ring->wait, 0, 0);
+  spin_lock_init(&ring->splock);
+  dq_init(&ring->active);
+
+  ring->rings      = p->rings;
+  ring->sqes       = p->sqes;
+  ring->cqes       = p->cqes;
+  ring->sq_entries = entries;
+  ring->cq_entries = p->cq_entries;
+  ring->crefs      = 1;
+#ifdef CONFIG_BUILD_KERNEL
+  ring->group      = nxsched_self()->group;
+#endif
+
+  p->rings->sq_head = 0;
+  p->rings->sq_tail = 0;
+  p->rings->cq_head = 0;
+  p->rings->cq_tail = 0;
+
+  ret = file_allocate(&g_uring_inode, O_RDWR | O_CLOEXEC, 0, ring, 0, true);
+  if (ret < 0)
+    {
+      nxsem_destroy(&ring->wait);
+      nxmutex_destroy(&ring->lock);
+      fs_heap_free(ring);
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: io_uring_enter
+ *
+ * Description:
+ *   Submit up to 'to_submit' entries of the submission ring, and with
+ *   IORING_ENTER_GETEVENTS wait until at least 'min_complete' completions
+ *   are in the completion ring.  Taking many entries in one call is the
+ *   point of the ring: the application pays for one kernel entry only.
+ *
+ * Input Parameters:
+ *   fd           - The ring file descriptor
+ *   to_submit    - The maximum number of entries to submit
+ *   min_complete - The completions to wait for
+ *   flags        - IORING_ENTER_* flags
+ *
+ * Returned Value:
+ *   The number of entries submitted on success; -1 (ERROR) with errno set
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int io_uring_enter(int fd, unsigned int to_submit,
+                   unsigned int min_complete, unsigned int flags)
+{
+  FAR struct uring_s *ring;
+  FAR struct file *filep;
+  struct io_uring_sqe sqe;
+  unsigned int submitted = 0;
+  uint32_t tail;
+  int ret;
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (filep->f_inode != &g_uring_inode)
+    {
+      ret = -EBADF;
+      goto errout_with_filep;
+    }
+
+  ring = filep->f_priv;
+
+#ifdef CONFIG_BUILD_KERNEL
+  /* Only the owner of the shared memory can access it */
+
+  if (ring->group != nxsched_self()->group)
+    {
+      ret = -EPERM;
+      goto errout_with_filep;
+    }
+#endif
+
+  ret = nxmutex_lock(&ring->lock);
+  if (ret < 0)
+    {
+      goto errout_with_filep;
+    }
+
+  uring_reap(ring);
+
+  /* Do not submit more than the completion ring can take */
+
+  tail = ring->rings->sq_tail;
+  while (submitted < to_submit && ring->sq_head != tail &&
+         (uint32_t)(tail - ring->sq_head) <= ring->sq_entries &&
+         ring->nactive + uring_pending(ring) < ring->cq_entries)
+    {
+      sqe = ring->sqes[ring->sq_head & (ring->sq_entries - 1)];
+      ring->sq_head++;
+      ring->rings->sq_head = ring->sq_head;
+
+      uring_submit(ring, &sqe);
+      submitted++;
+    }
+
+  if (submitted == 0 && to_submit > 0 && ring->sq_head != tail)
+    {
+      ret = -EBUSY;
+      goto errout_with_lock;
+    }
+
+  if ((flags & IORING_ENTER_GETEVENTS) != 0)
+    {
+      while (uring_pending(ring) < min_complete && ring->nactive > 0)
+        {
+          nxmutex_unlock(&ring->lock);
+          ret = nxsem_wait(&ring->wait);
+          nxmutex_lock(&ring->lock);
+
+          if (ret < 0)
+            {
+              if (submitted == 0)
+                {
+                  goto errout_with_lock;
+                }
+
+              break;
+            }
+
+          uring_reap(ring);
+        }
+    }
+
+  nxmutex_unlock(&ring->lock);
+  fs_putfilep(filep);
+  return submitted;
+
+errout_with_lock:
+  nxmutex_unlock(&ring->lock);
+errout_with_filep:
+  fs_putfilep(filep);
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
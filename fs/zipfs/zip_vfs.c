@@ -23,9 +23,11 @@
  ****************************************************************************/
 
 #include <assert.h>
+#include <debug.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <string.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <nuttx/mutex.h>
@@ -37,6 +39,16 @@
 
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+/* The size of the inflate window a seek point keeps */
+
+#  define ZIPFS_WINSIZE (1 << MAX_WBITS)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -54,11 +66,54 @@ struct zipfs_mountpt_s
   char abspath[1];
 };
 
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+/* A place in a deflated entry where decompression can start over */
+
+struct zipfs_point_s
+{
+  off_t out;                      /* Offset in the uncompressed data */
+  off_t in;                       /* Offset of the first byte to inflate */
+  int bits;                       /* Bits of the byte before 'in' left */
+  unsigned int wlen;              /* Length of the window */
+  unsigned char window[1];        /* The inflate window at 'out' */
+};
+
+/* A block of uncompressed data in the cache shared by all files */
+
+#  if CONFIG_ZIPFS_CACHE_NBLOCKS > 0
+struct zipfs_cache_s
+{
+  FAR struct zipfs_mountpt_s *fs; /* The mount, NULL if the block is free */
+  off_t dataoff;                  /* The entry, by the offset of its data */
+  off_t block;                    /* Number of the block in the entry */
+  uint32_t age;                   /* When the block was used last */
+  bool busy;                      /* The block is being filled */
+  size_t len;                     /* Valid bytes in data */
+  FAR unsigned char *data;        /* CONFIG_ZIPFS_CACHE_BLOCKSIZE bytes */
+};
+#  endif
+#endif
+
 struct zipfs_file_s
 {
   unzFile uf;
   mutex_t lock;
   FAR char *seekbuf;
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  FAR struct zipfs_mountpt_s *fs;
+  bool direct;                    /* The data is read without minizip */
+  bool deflated;                  /* The data is deflated, not stored */
+  struct file zf;                 /* The zip file to read the data from */
+  z_stream zs;                    /* Inflate stream of a deflated entry */
+  off_t dataoff;                  /* Offset of the data in the zip file */
+  off_t csize;                    /* Compressed size of the entry */
+  off_t usize;                    /* Uncompressed size of the entry */
+  off_t inpos;                    /* Compressed bytes given to zs */
+  off_t outpos;                   /* Uncompressed offset of zs */
+  FAR unsigned char *inbuf;       /* Input buffer of zs */
+  int npoints;                    /* Number of seek points */
+  FAR struct zipfs_point_s *points[CONFIG_ZIPFS_SEEK_NPOINTS];
+#endif
   char relpath[1];
 };
 
@@ -122,6 +177,12 @@ static zlib_filefunc64_def zipfs_real_ops =
   NULL
 };
 
+#if defined(CONFIG_ZIPFS_SEEK_INDEX) && CONFIG_ZIPFS_CACHE_NBLOCKS > 0
+static mutex_t g_zipfs_cache_lock = NXMUTEX_INITIALIZER;
+static struct zipfs_cache_s g_zipfs_cache[CONFIG_ZIPFS_CACHE_NBLOCKS];
+static uint32_t g_zipfs_cache_age;
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -239,6 +300,526 @@ static int zipfs_convert_result(int ziperr)
     }
 }
 
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+
+/****************************************************************************
+ * Name: zipfs_index_open
+ *
+ * Description:
+ *   Prepare reading the current entry of fp->uf without minizip.  Entries
+ *   that are neither stored nor deflated, or that are encrypted, are left
+ *   to minizip.
+ *
+ ****************************************************************************/
+
+static int zipfs_index_open(FAR struct zipfs_file_s *fp)
+{
+  unz_file_info64 file_info;
+  int ret;
+
+  fp->direct  = false;
+  fp->inbuf   = NULL;
+  fp->npoints = 0;
+
+  ret = unzGetCurrentFileInfo64(fp->uf, &file_info, NULL, 0,
+                                NULL, 0, NULL, 0);
+  ret = zipfs_convert_result(ret);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if ((file_info.compression_method != 0 &&
+       file_info.compression_method != Z_DEFLATED) ||
+      (file_info.flag & 1) != 0)
+    {
+      return zipfs_convert_result(unzOpenCurrentFile(fp->uf));
+    }
+
+  /* Open the entry raw, only to learn where its data starts */
+
+  ret = zipfs_convert_result(unzOpenCurrentFile2(fp->uf, NULL, NULL, 1));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  fp->dataoff  = unzGetCurrentFileZStreamPos64(fp->uf);
+  fp->csize    = file_info.compressed_size;
+  fp->usize    = file_info.uncompressed_size;
+  fp->deflated = file_info.compression_method == Z_DEFLATED;
+  fp->inpos    = 0;
+  fp->outpos   = 0;
+
+  ret = file_open(&fp->zf, fp->fs->abspath, O_RDONLY);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (fp->deflated)
+    {
+      memset(&fp->zs, 0, sizeof(fp->zs));
+      if (inflateInit2(&fp->zs, -MAX_WBITS) != Z_OK)
+        {
+          file_close(&fp->zf);
+          return -ENOMEM;
+        }
+    }
+
+  fp->direct = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: zipfs_index_close
+ ****************************************************************************/
+
+static void zipfs_index_close(FAR struct zipfs_file_s *fp)
+{
+  int i;
+
+  if (!fp->direct)
+    {
+      return;
+    }
+
+  if (fp->deflated)
+    {
+      inflateEnd(&fp->zs);
+    }
+
+  for (i = 0; i < fp->npoints; i++)
+    {
+      fs_heap_free(fp->points[i]);
+    }
+
+  fs_heap_free(fp->inbuf);
+  file_close(&fp->zf);
+  fp->direct = false;
+}
+
+/****************************************************************************
+ * Name: zipfs_index_addpoint
+ *
+ * Description:
+ *   Remember the state of the inflate stream, which is at the end of a
+ *   deflate block, as a seek point.
+ *
+ ****************************************************************************/
+
+static void zipfs_index_addpoint(FAR struct zipfs_file_s *fp)
+{
+  FAR struct zipfs_point_s *point;
+  uInt wlen = ZIPFS_WINSIZE;
+
+  point = fs_heap_malloc(sizeof(*point) + ZIPFS_WINSIZE);
+  if (point == NULL)
+    {
+      return;
+    }
+
+  if (inflateGetDictionary(&fp->zs, point->window, &wlen) != Z_OK)
+    {
+      fs_heap_free(point);
+      return;
+    }
+
+  point->out  = fp->outpos;
+  point->in   = fp->inpos - fp->zs.avail_in;
+  point->bits = fp->zs.data_type & 7;
+  point->wlen = wlen;
+
+  fp->points[fp->npoints++] = point;
+}
+
+/****************************************************************************
+ * Name: zipfs_index_restart
+ *
+ * Description:
+ *   Restart the inflate stream at a seek point, or at the start of the
+ *   entry if point is NULL.
+ *
+ ****************************************************************************/
+
+static int zipfs_index_restart(FAR struct zipfs_file_s *fp,
+                               FAR struct zipfs_point_s *point)
+{
+  unsigned char byte;
+  ssize_t nread;
+
+  if (inflateReset(&fp->zs) != Z_OK)
+    {
+      return -EIO;
+    }
+
+  fp->zs.avail_in = 0;
+
+  if (point == NULL)
+    {
+      fp->inpos  = 0;
+      fp->outpos = 0;
+      return OK;
+    }
+
+  /* The point may be in the middle of a byte, the bits of it not consumed
+   * yet are fed to the stream first.
+   */
+
+  if (point->bits > 0)
+    {
+      nread = file_pread(&fp->zf, &byte, 1, fp->dataoff + point->in - 1);
+      if (nread != 1)
+        {
+          return nread < 0 ? nread : -EIO;
+        }
+
+      inflatePrime(&fp->zs, point->bits, byte >> (8 - point->bits));
+    }
+
+  inflateSetDictionary(&fp->zs, point->window, point->wlen);
+
+  fp->inpos  = point->in;
+  fp->outpos = point->out;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: zipfs_index_inflate
+ *
+ * Description:
+ *   Decompress up to len bytes from where the inflate stream is.  Seek
+ *   points are added on the way whenever the stream is at the end of a
+ *   deflate block CONFIG_ZIPFS_SEEK_SPAN bytes after the last one.
+ *
+ ****************************************************************************/
+
+static ssize_t zipfs_index_inflate(FAR struct zipfs_file_s *fp,
+                                   FAR unsigned char *buf, size_t len)
+{
+  size_t done = 0;
+  ssize_t nread;
+  off_t last;
+  int ret;
+
+  if (fp->inbuf == NULL)
+    {
+      fp->inbuf = fs_heap_malloc(CONFIG_ZIPFS_SEEK_BUFSIZE);
+      if (fp->inbuf == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  while (done < len && fp->outpos < fp->usize)
+    {
+      if (fp->zs.avail_in == 0)
+        {
+          nread = MIN(fp->csize - fp->inpos, CONFIG_ZIPFS_SEEK_BUFSIZE);
+          if (nread > 0)
+            {
+              nread = file_pread(&fp->zf, fp->inbuf, nread,
+                                 fp->dataoff + fp->inpos);
+            }
+
+          if (nread <= 0)
+            {
+              return done > 0 ? done : (nread < 0 ? nread : -EIO);
+            }
+
+          fp->inpos       += nread;
+          fp->zs.next_in   = fp->inbuf;
+          fp->zs.avail_in  = nread;
+        }
+
+      fp->zs.next_out  = buf + done;
+      fp->zs.avail_out = len - done;
+
+      ret = inflate(&fp->zs, Z_BLOCK);
+      if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR)
+        {
+          ferr("ERROR: inflate failed: %d\n", ret);
+          return done > 0 ? done : -EIO;
+        }
+
+      fp->outpos += len - done - fp->zs.avail_out;
+      done        = len - fp->zs.avail_out;
+
+      if (ret == Z_STREAM_END)
+        {
+          break;
+        }
+
+      /* Bit 7 of data_type is set at the end of a block, bit 6 too if it
+       * was the last one.
+       */
+
+      last = fp->npoints > 0 ? fp->points[fp->npoints - 1]->out : 0;
+      if ((fp->zs.data_type & 0xc0) == 0x80 &&
+          fp->npoints < CONFIG_ZIPFS_SEEK_NPOINTS &&
+          fp->outpos - last >= CONFIG_ZIPFS_SEEK_SPAN)
+        {
+          zipfs_index_addpoint(fp);
+        }
+    }
+
+  return done;
+}
+
+/****************************************************************************
+ * Name: zipfs_index_seek
+ *
+ * Description:
+ *   Move the inflate stream to offset pos of the uncompressed data.  It
+ *   restarts at the closest seek point before pos, unless the stream is
+ *   closer already, and decompresses from there.
+ *
+ ****************************************************************************/
+
+static int zipfs_index_seek(FAR struct zipfs_file_s *fp, off_t pos)
+{
+  FAR struct zipfs_point_s *point = NULL;
+  ssize_t ret;
+  int i;
+
+  if (pos == fp->outpos)
+    {
+      return OK;
+    }
+
+  for (i = fp->npoints - 1; i >= 0; i--)
+    {
+      if (fp->points[i]->out <= pos)
+        {
+          point = fp->points[i];
+          break;
+        }
+    }
+
+  if (pos < fp->outpos || (point != NULL && point->out > fp->outpos))
+    {
+      ret = zipfs_index_restart(fp, point);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (fp->seekbuf == NULL)
+    {
+      fp->seekbuf = fs_heap_malloc(CONFIG_ZIPFS_SEEK_BUFSIZE);
+      if (fp->seekbuf == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  while (fp->outpos < pos)
+    {
+      ret = zipfs_index_inflate(fp, (FAR unsigned char *)fp->seekbuf,
+                                MIN(pos - fp->outpos,
+                                    CONFIG_ZIPFS_SEEK_BUFSIZE));
+      if (ret <= 0)
+        {
+          return ret < 0 ? ret : -EIO;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: zipfs_index_readat
+ *
+ * Description:
+ *   Read the uncompressed data at offset pos of the entry.
+ *
+ ****************************************************************************/
+
+static ssize_t zipfs_index_readat(FAR struct zipfs_file_s *fp,
+                                  FAR unsigned char *buf, size_t len,
+                                  off_t pos)
+{
+  int ret;
+
+  if (pos >= fp->usize)
+    {
+      return 0;
+    }
+
+  len = MIN(len, fp->usize - pos);
+
+  if (!fp->deflated)
+    {
+      return file_pread(&fp->zf, buf, len, fp->dataoff + pos);
+    }
+
+  ret = zipfs_index_seek(fp, pos);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return zipfs_index_inflate(fp, buf, len);
+}
+
+#  if CONFIG_ZIPFS_CACHE_NBLOCKS > 0
+
+/****************************************************************************
+ * Name: zipfs_cache_read
+ *
+ * Description:
+ *   Read a deflated entry through the cache of uncompressed blocks that all
+ *   open files share.  A block missing from the cache is decompressed into
+ *   the least recently used one.
+ *
+ ****************************************************************************/
+
+static ssize_t zipfs_cache_read(FAR struct zipfs_file_s *fp,
+                                FAR char *buffer, size_t buflen, off_t pos)
+{
+  FAR struct zipfs_cache_s *victim;
+  FAR struct zipfs_cache_s *cache;
+  size_t done = 0;
+  ssize_t ret = 0;
+  off_t block;
+  size_t off;
+  int i;
+
+  while (done < buflen && pos < fp->usize)
+    {
+      block  = pos / CONFIG_ZIPFS_CACHE_BLOCKSIZE;
+      off    = pos % CONFIG_ZIPFS_CACHE_BLOCKSIZE;
+      cache  = NULL;
+      victim = NULL;
+
+      nxmutex_lock(&g_zipfs_cache_lock);
+      for (i = 0; i < CONFIG_ZIPFS_CACHE_NBLOCKS; i++)
+        {
+          FAR struct zipfs_cache_s *entry = &g_zipfs_cache[i];
+
+          if (entry->fs == fp->fs && entry->dataoff == fp->dataoff &&
+              entry->block == block)
+            {
+              cache = entry;
+              break;
+            }
+
+          if (!entry->busy && (victim == NULL ||
+              (victim->fs != NULL &&
+               (entry->fs == NULL || entry->age < victim->age))))
+            {
+              victim = entry;
+            }
+        }
+
+      if (cache == NULL && victim == NULL)
+        {
+          /* All blocks are being filled by other readers, this one does
+           * without the cache.
+           */
+
+          nxmutex_unlock(&g_zipfs_cache_lock);
+          ret = zipfs_index_readat(fp, (FAR unsigned char *)buffer + done,
+                                   buflen - done, pos);
+          if (ret > 0)
+            {
+              done += ret;
+            }
+
+          break;
+        }
+
+      if (cache == NULL)
+        {
+          /* Take the block out of the cache while it is filled, so that
+           * the lock is not held while decompressing.
+           */
+
+          if (victim->data == NULL)
+            {
+              victim->data = fs_heap_malloc(CONFIG_ZIPFS_CACHE_BLOCKSIZE);
+              if (victim->data == NULL)
+                {
+                  nxmutex_unlock(&g_zipfs_cache_lock);
+                  ret = -ENOMEM;
+                  break;
+                }
+            }
+
+          victim->fs   = NULL;
+          victim->busy = true;
+          nxmutex_unlock(&g_zipfs_cache_lock);
+
+          ret = zipfs_index_readat(fp, victim->data,
+                                   CONFIG_ZIPFS_CACHE_BLOCKSIZE,
+                                   block * CONFIG_ZIPFS_CACHE_BLOCKSIZE);
+
+          nxmutex_lock(&g_zipfs_cache_lock);
+          victim->busy = false;
+          victim->age  = 0;
+          if (ret <= 0)
+            {
+              nxmutex_unlock(&g_zipfs_cache_lock);
+              break;
+            }
+
+          victim->fs      = fp->fs;
+          victim->dataoff = fp->dataoff;
+          victim->block   = block;
+          victim->len     = ret;
+          cache           = victim;
+        }
+
+      cache->age = ++g_zipfs_cache_age;
+      if (off >= cache->len)
+        {
+          nxmutex_unlock(&g_zipfs_cache_lock);
+          break;
+        }
+
+      ret = MIN(buflen - done, cache->len - off);
+      memcpy(buffer + done, cache->data + off, ret);
+      nxmutex_unlock(&g_zipfs_cache_lock);
+
+      done += ret;
+      pos  += ret;
+    }
+
+  return done > 0 ? done : ret;
+}
+
+/****************************************************************************
+ * Name: zipfs_cache_drop
+ *
+ * Description:
+ *   Free the cached blocks of a mount that goes away.
+ *
+ ****************************************************************************/
+
+static void zipfs_cache_drop(FAR struct zipfs_mountpt_s *fs)
+{
+  int i;
+
+  nxmutex_lock(&g_zipfs_cache_lock);
+  for (i = 0; i < CONFIG_ZIPFS_CACHE_NBLOCKS; i++)
+    {
+      FAR struct zipfs_cache_s *entry = &g_zipfs_cache[i];
+
+      if (entry->fs == fs)
+        {
+          fs_heap_free(entry->data);
+          entry->data = NULL;
+          entry->fs   = NULL;
+          entry->age  = 0;
+        }
+    }
+
+  nxmutex_unlock(&g_zipfs_cache_lock);
+}
+#  endif
+#endif /* CONFIG_ZIPFS_SEEK_INDEX */
+
 static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
                       int oflags, mode_t mode)
 {
@@ -273,7 +854,12 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
       goto err_with_zip;
     }
 
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  fp->fs = fs;
+  ret = zipfs_index_open(fp);
+#else
   ret = zipfs_convert_result(unzOpenCurrentFile(fp->uf));
+#endif
   if (ret < 0)
     {
       goto err_with_zip;
@@ -303,6 +889,10 @@ static int zipfs_close(FAR struct file *filep)
   FAR struct zipfs_file_s *fp = filep->f_priv;
   int ret;
 
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  zipfs_index_close(fp);
+#endif
+
   ret = zipfs_convert_result(unzClose(fp->uf));
   nxmutex_destroy(&fp->lock);
   fs_heap_free(fp->seekbuf);
@@ -317,7 +907,28 @@ static ssize_t zipfs_read(FAR struct file *filep, FAR char *buffer,
   ssize_t ret;
 
   nxmutex_lock(&fp->lock);
-  ret = zipfs_convert_result(unzReadCurrentFile(fp->uf, buffer, buflen));
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  if (fp->direct)
+    {
+#  if CONFIG_ZIPFS_CACHE_NBLOCKS > 0
+      if (fp->deflated)
+        {
+          ret = zipfs_cache_read(fp, buffer, buflen, filep->f_pos);
+        }
+      else
+#  endif
+        {
+          ret = zipfs_index_readat(fp, (FAR unsigned char *)buffer, buflen,
+                                   filep->f_pos);
+        }
+    }
+  else
+#endif
+    {
+      ret = unzReadCurrentFile(fp->uf, buffer, buflen);
+      ret = zipfs_convert_result(ret);
+    }
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -394,6 +1005,24 @@ static off_t zipfs_seek(FAR struct file *filep, off_t offset,
         goto err_with_lock;
     }
 
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  /* The data is read at the file position, nothing to do here */
+
+  if (fp->direct)
+    {
+      if (offset < 0)
+        {
+          ret = -EINVAL;
+        }
+      else
+        {
+          filep->f_pos = offset;
+        }
+
+      goto err_with_lock;
+    }
+#endif
+
   if (filep->f_pos == offset)
     {
       goto err_with_lock;
@@ -609,6 +1238,10 @@ static int zipfs_bind(FAR struct inode *driver, FAR const void *data,
 static int zipfs_unbind(FAR void *handle, FAR struct inode **driver,
                         unsigned int flags)
 {
+#if defined(CONFIG_ZIPFS_SEEK_INDEX) && CONFIG_ZIPFS_CACHE_NBLOCKS > 0
+  zipfs_cache_drop(handle);
+#endif
+
   fs_heap_free(handle);
   return OK;
 }
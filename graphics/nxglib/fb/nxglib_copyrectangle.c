@@ -80,6 +80,16 @@ void NXGL_FUNCNAME(nxgl_copyrectangle, NXGLIB_SUFFIX)
   width = dest->pt2.x - dest->pt1.x + 1;
   rows  = dest->pt2.y - dest->pt1.y + 1;
 
+#ifdef CONFIG_NX_ARCH_ACCEL
+  /* Let the 2D engine copy the large rectangles */
+
+  if (width * rows >= CONFIG_NX_ARCH_ACCEL_MINPIXELS &&
+      up_nxgl_copyrectangle(pinfo, dest, src, origin, srcstride) >= 0)
+    {
+      return;
+    }
+#endif
+
 #if NXGLIB_BITSPERPIXEL < 8
   /* REVISIT: Doesn't the following assume 8 pixels in a byte */
 
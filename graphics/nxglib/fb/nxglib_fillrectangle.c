@@ -82,6 +82,16 @@ void NXGL_FUNCNAME(nxgl_fillrectangle, NXGLIB_SUFFIX)
   width  = rect->pt2.x - rect->pt1.x + 1;
   rows   = rect->pt2.y - rect->pt1.y + 1;
 
+#ifdef CONFIG_NX_ARCH_ACCEL
+  /* Let the 2D engine fill the large rectangles */
+
+  if (width * rows >= CONFIG_NX_ARCH_ACCEL_MINPIXELS &&
+      up_nxgl_fillrectangle(pinfo, rect, color) >= 0)
+    {
+      return;
+    }
+#endif
+
   /* Get the address of the first byte in the first line to write */
 
   line   = pinfo->fbmem + rect->pt1.y * stride + NXGL_SCALEX(rect->pt1.x);
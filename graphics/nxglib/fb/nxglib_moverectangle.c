@@ -130,6 +130,16 @@ void NXGL_FUNCNAME(nxgl_moverectangle, NXGLIB_SUFFIX)
   width = rect->pt2.x - rect->pt1.x + 1;
   rows  = rect->pt2.y - rect->pt1.y + 1;
 
+#ifdef CONFIG_NX_ARCH_ACCEL
+  /* Let the 2D engine move the large rectangles */
+
+  if (width * rows >= CONFIG_NX_ARCH_ACCEL_MINPIXELS &&
+      up_nxgl_moverectangle(pinfo, rect, offset) >= 0)
+    {
+      return;
+    }
+#endif
+
 #if NXGLIB_BITSPERPIXEL < 8
 #  ifdef CONFIG_NX_PACKEDMSFIRST
 
@@ -30,9 +30,12 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <string.h>
 
 #include <nuttx/nx/nxglib.h>
 
+#include "nxglib_wideblit.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -78,12 +81,15 @@
 
 #  define NXGL_SCALEX(x)           (x)
 #  define NXGL_PIXEL_T             uint8_t
+#  define NXGL_WIDEFILL(d,v,n)     memset((d), (v), (n))
 
 #elif NXGLIB_BITSPERPIXEL == 16
 
 #  define NXGL_SCALEX(x)           ((x) << 1)
 #  define NXGL_PIXEL_T             uint16_t
 #  define NXGL_BLENDER             nxglib_rgb565_blend
+#  define NXGL_WIDEFILL            nxgl_widefill16
+#  define NXGL_WIDEBLEND           nxgl_blendrun16
 
 #elif NXGLIB_BITSPERPIXEL == 24
 
@@ -96,6 +102,8 @@
 #  define NXGL_SCALEX(x)           ((x) << 2)
 #  define NXGL_PIXEL_T             uint32_t
 #  define NXGL_BLENDER             nxglib_rgb24_blend
+#  define NXGL_WIDEFILL            nxgl_widefill32
+#  define NXGL_WIDEBLEND           nxgl_blendrun32
 
 #endif
 
@@ -173,6 +181,21 @@
 #endif /* CONFIG_NX_ANTIALIASING */
 #else /* NXGLIB_BITSPERPIXEL == 16 || NXGLIB_BITSPERPIXEL == 32 */
 
+#ifdef CONFIG_NX_WIDEBLIT
+
+/* Fill one word at a time and leave the copies to the C library, which is
+ * word wide or tuned for the architecture.  memmove() also gets the rows
+ * of nxgl_moverectangle() right that move to the right within themselves.
+ */
+
+#  define NXGL_MEMSET(dest,value,width) \
+   NXGL_WIDEFILL((FAR NXGL_PIXEL_T *)(dest), (value), (width))
+
+#  define NXGL_MEMCPY(dest,src,width) \
+   memmove((dest), (src), NXGL_SCALEX(width))
+
+#else /* CONFIG_NX_WIDEBLIT */
+
 #  define NXGL_MEMSET(dest,value,width) \
    { \
      FAR NXGL_PIXEL_T *_ptr = (FAR NXGL_PIXEL_T*)(dest); \
@@ -194,14 +217,21 @@
        } \
    }
 
+#endif /* CONFIG_NX_WIDEBLIT */
+
 #ifdef CONFIG_NX_ANTIALIASING
 
+#ifdef CONFIG_NX_WIDEBLIT
+#  define NXGL_BLEND(dest,color1,frac) \
+   NXGL_WIDEBLEND((FAR NXGL_PIXEL_T *)(dest), (color1), (frac), 1)
+#else
 #  define NXGL_BLEND(dest,color1,frac) \
    { \
      FAR NXGL_PIXEL_T *_dptr = (FAR NXGL_PIXEL_T*)(dest); \
      NXGL_PIXEL_T color2 = *_dptr; \
      *_dptr = NXGL_BLENDER(color1, color2, frac); \
    }
+#endif
 
 #endif /* CONFIG_NX_ANTIALIASING */
 #endif /* NXGLIB_BITSPERPIXEL */
@@ -31,6 +31,8 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "nxglib_wideblit.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -148,10 +150,14 @@ static inline void nxgl_fillrun_16bpp(FAR uint16_t *run,
    * the end
    */
 
+#ifdef CONFIG_NX_WIDEBLIT
+  nxgl_widefill16(run, (uint16_t)color, npixels);
+#else
   while (npixels-- > 0)
     {
       *run++ = (uint16_t)color;
     }
+#endif
 }
 
 #elif NXGLIB_BITSPERPIXEL == 24
@@ -178,10 +184,14 @@ static inline void nxgl_fillrun_32bpp(FAR uint32_t *run,
    * the end
    */
 
+#ifdef CONFIG_NX_WIDEBLIT
+  nxgl_widefill32(run, (uint32_t)color, npixels);
+#else
   while (npixels-- > 0)
     {
       *run++ = (uint32_t)color;
     }
+#endif
 }
 #else
 #  error "Unsupported value of NXGLIB_BITSPERPIXEL"
@@ -0,0 +1,225 @@
+/****************************************************************************
+ * graphics/nxglib/nxglib_wideblit.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __GRAPHICS_NXGLIB_NXGLIB_WIDEBLIT_H
+#define __GRAPHICS_NXGLIB_NXGLIB_WIDEBLIT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <fixedmath.h>
+
+#ifdef CONFIG_NX_WIDEBLIT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The runs are written one nxgl_word_t at a time.  That is a 128-bit
+ * vector if the CPU has a vector unit (NEON, MVE or SSE2) that the compiler
+ * was told to use, otherwise a native word.
+ */
+
+#if defined(__ARM_NEON) || defined(__ARM_FEATURE_MVE) || defined(__SSE2__)
+#  define NXGL_HAVE_VECTOR 1
+#endif
+
+/* The parts of the RGB888 and the spread out RGB565 pixels that may be
+ * multiplied by an 8-bit or a 5-bit weight without overflowing into each
+ * other.
+ */
+
+#define NXGL_RB888_MASK    0x00ff00ff
+#define NXGL_G888_MASK     0x0000ff00
+#define NXGL_RGB565X_MASK  0x07e0f81f
+
+/* Blend the RGB888 pixels in 'd' as nxglib_rgb24_blend() does, given the
+ * weighted components of the foreground color.  'd' may be a scalar or a
+ * vector.
+ */
+
+#define NXGL_BLEND888(d, crb, cg, na) \
+  ((((((d) & NXGL_RB888_MASK) * (na) + (crb)) >> 8) & NXGL_RB888_MASK) | \
+   (((((d) & NXGL_G888_MASK) * (na) + (cg)) >> 8) & NXGL_G888_MASK))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef NXGL_HAVE_VECTOR
+typedef uint32_t nxgl_word_t __attribute__((vector_size(16), may_alias));
+#else
+typedef uintptr_t nxgl_word_t __attribute__((may_alias));
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxgl_wideword
+ *
+ * Description:
+ *   Return a word with every 32-bit part set to 'pattern'.
+ *
+ ****************************************************************************/
+
+static inline nxgl_word_t nxgl_wideword(uint32_t pattern)
+{
+  nxgl_word_t word;
+  size_t i;
+
+  for (i = 0; i < sizeof(word); i += sizeof(pattern))
+    {
+      memcpy((FAR uint8_t *)&word + i, &pattern, sizeof(pattern));
+    }
+
+  return word;
+}
+
+/****************************************************************************
+ * Name: nxgl_widefill16 and nxgl_widefill32
+ *
+ * Description:
+ *   Fill a run of 16- or 32-bit pixels with one color.  The pixels up to
+ *   the first word boundary are written one at a time, the ones after it
+ *   one word at a time.
+ *
+ ****************************************************************************/
+
+static inline void nxgl_widefill16(FAR uint16_t *dest, uint16_t color,
+                                   size_t npixels)
+{
+  nxgl_word_t word = nxgl_wideword(color | (uint32_t)color << 16);
+  FAR nxgl_word_t *wdest;
+
+  while (npixels > 0 && ((uintptr_t)dest & (sizeof(word) - 1)) != 0)
+    {
+      *dest++ = color;
+      npixels--;
+    }
+
+  wdest = (FAR nxgl_word_t *)dest;
+  while (npixels >= sizeof(word) / sizeof(*dest))
+    {
+      *wdest++ = word;
+      npixels -= sizeof(word) / sizeof(*dest);
+    }
+
+  dest = (FAR uint16_t *)wdest;
+  while (npixels-- > 0)
+    {
+      *dest++ = color;
+    }
+}
+
+static inline void nxgl_widefill32(FAR uint32_t *dest, uint32_t color,
+                                   size_t npixels)
+{
+  nxgl_word_t word = nxgl_wideword(color);
+  FAR nxgl_word_t *wdest;
+
+  while (npixels > 0 && ((uintptr_t)dest & (sizeof(word) - 1)) != 0)
+    {
+      *dest++ = color;
+      npixels--;
+    }
+
+  wdest = (FAR nxgl_word_t *)dest;
+  while (npixels >= sizeof(word) / sizeof(*dest))
+    {
+      *wdest++ = word;
+      npixels -= sizeof(word) / sizeof(*dest);
+    }
+
+  dest = (FAR uint32_t *)wdest;
+  while (npixels-- > 0)
+    {
+      *dest++ = color;
+    }
+}
+
+/****************************************************************************
+ * Name: nxgl_blendrun16 and nxgl_blendrun32
+ *
+ * Description:
+ *   Blend one color onto a run of RGB565 or RGB888 pixels, like
+ *   nxglib_rgb565_blend() and nxglib_rgb24_blend() do for one pixel.  The
+ *   components are spread out so that they are all weighted with one
+ *   multiplication, with 5 and 8 bits of weight respectively.
+ *
+ ****************************************************************************/
+
+static inline void nxgl_blendrun16(FAR uint16_t *dest, uint16_t color,
+                                   ub16_t frac, size_t npixels)
+{
+  uint32_t a = (frac >= b16ONE) ? 32 : frac >> 11;
+  uint32_t cx = ((color | (uint32_t)color << 16) & NXGL_RGB565X_MASK) * a;
+  uint32_t x;
+
+  while (npixels-- > 0)
+    {
+      x = (*dest | (uint32_t)*dest << 16) & NXGL_RGB565X_MASK;
+      x = ((x * (32 - a) + cx) >> 5) & NXGL_RGB565X_MASK;
+      *dest++ = (uint16_t)(x | x >> 16);
+    }
+}
+
+static inline void nxgl_blendrun32(FAR uint32_t *dest, uint32_t color,
+                                   ub16_t frac, size_t npixels)
+{
+  uint32_t a = (frac >= b16ONE) ? 256 : frac >> 8;
+  uint32_t crb = (color & NXGL_RB888_MASK) * a;
+  uint32_t cg = (color & NXGL_G888_MASK) * a;
+#ifdef NXGL_HAVE_VECTOR
+  nxgl_word_t word;
+
+  /* Blend four pixels at a time, the vector unit does the masking and
+   * the multiplications of all lanes at once.
+   */
+
+  while (npixels >= sizeof(word) / sizeof(*dest))
+    {
+      memcpy(&word, dest, sizeof(word));
+      word = NXGL_BLEND888(word, crb, cg, 256 - a);
+      memcpy(dest, &word, sizeof(word));
+      dest    += sizeof(word) / sizeof(*dest);
+      npixels -= sizeof(word) / sizeof(*dest);
+    }
+#endif
+
+  while (npixels-- > 0)
+    {
+      *dest = NXGL_BLEND888(*dest, crb, cg, 256 - a);
+      dest++;
+    }
+}
+
+#endif /* CONFIG_NX_WIDEBLIT */
+#endif /* __GRAPHICS_NXGLIB_NXGLIB_WIDEBLIT_H */
@@ -45,6 +45,7 @@ typedef struct aes_ctx
   uint32_t sk_exp[120];
 
   unsigned num_rounds;
+  int accel;                  /* sk holds plain round keys for aes_accel.c */
 } AES_CTX;
 
 int aes_setkey(FAR AES_CTX *, FAR const uint8_t *, int);
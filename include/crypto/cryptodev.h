@@ -206,6 +206,8 @@ struct cryptop
   int crp_flags;
   int crp_aadlen;
 
+  TAILQ_ENTRY(cryptop) crp_next; /* The request queue of crypto_dispatch */
+
 #define CRYPTO_F_IMBUF 0x0001   /* Input/output are mbuf chains, otherwise contig */
 #define CRYPTO_F_IOV 0x0002     /* Input/output are uio */
 #define CRYPTO_F_REL 0x0004     /* Must return data in same place */
@@ -366,6 +368,23 @@ struct crypt_op
   caddr_t aad;
 };
 
+/* One request of a batch, see CIOCCRYPTM, CIOCASYNCCRYPT and
+ * CIOCASYNCFETCH.
+ */
+
+struct crypt_aop
+{
+  struct crypt_op op;
+  uint32_t reqid;     /* tags the request for the caller */
+  int status;         /* returns: 0 or a negated errno value */
+};
+
+struct crypt_mop
+{
+  uint32_t count;     /* # of requests, returns: # handled */
+  FAR struct crypt_aop *reqs;
+};
+
 /* hamc buffer, software & hardware need it */
 
 extern const uint8_t hmac_ipad_buffer[HMAC_MAX_BLOCK_LEN];
@@ -388,6 +407,16 @@ extern const uint8_t hmac_opad_buffer[HMAC_MAX_BLOCK_LEN];
 #define CIOCKEYRET              105
 #define CIOCASYMFEAT            106
 
+/* CIOCCRYPTM runs a struct crypt_mop of requests at once and sets the
+ * status of each one.  CIOCASYNCCRYPT queues them instead and returns
+ * the number queued in count, the fd polls readable when CIOCASYNCFETCH
+ * can return completed requests, with their reqid and status.
+ */
+
+#define CIOCCRYPTM              107
+#define CIOCASYNCCRYPT          108
+#define CIOCASYNCFETCH          109
+
 int crypto_newsession(FAR uint64_t *, FAR struct cryptoini *, int);
 int crypto_freesession(uint64_t);
 int crypto_register(uint32_t, FAR int *,
@@ -399,6 +428,9 @@ int crypto_kregister(uint32_t, FAR int *,
 int crypto_unregister(uint32_t, int);
 int crypto_get_driverid(uint8_t);
 int crypto_invoke(FAR struct cryptop *);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+int crypto_dispatch(FAR struct cryptop *);
+#endif
 int crypto_kinvoke(FAR struct cryptkop *);
 int crypto_getfeat(FAR int *);
 
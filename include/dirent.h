@@ -160,6 +160,7 @@ int        versionsort(FAR const struct dirent **a,
                        FAR const struct dirent **b);
 
 int        dirfd(FAR DIR *dirp);
+ssize_t    getdents(int fd, FAR void *dirp, size_t count);
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -503,6 +503,8 @@ float pid_controller(FAR pid_controller_f32_t *pid, float err);
 void pi_antiwindup_enable(FAR pid_controller_f32_t *pid, float KC,
                           bool enable);
 void pi_ireset_enable(FAR pid_controller_f32_t *pid, bool enable);
+void pi_controller_v(FAR pid_controller_f32_t *pid, FAR const float *err,
+                     FAR float *out, size_t n);
 
 /* Transformation functions */
 
@@ -513,6 +515,18 @@ void park_transform(FAR phase_angle_f32_t *angle, FAR ab_frame_f32_t *ab,
 void inv_park_transform(FAR phase_angle_f32_t *angle, FAR dq_frame_f32_t *dq,
                         FAR ab_frame_f32_t *ab);
 
+/* Transformations of arrays of frames */
+
+void clarke_transform_v(FAR abc_frame_f32_t *abc, FAR ab_frame_f32_t *ab,
+                        size_t n);
+void inv_clarke_transform_v(FAR ab_frame_f32_t *ab,
+                            FAR abc_frame_f32_t *abc, size_t n);
+void park_transform_v(FAR phase_angle_f32_t *angle, FAR ab_frame_f32_t *ab,
+                      FAR dq_frame_f32_t *dq, size_t n);
+void inv_park_transform_v(FAR phase_angle_f32_t *angle,
+                          FAR dq_frame_f32_t *dq, FAR ab_frame_f32_t *ab,
+                          size_t n);
+
 /* Phase angle related functions */
 
 void angle_norm(FAR float *angle, float per, float bottom, float top);
@@ -523,6 +537,8 @@ void phase_angle_update(FAR struct phase_angle_f32_s *angle, float val);
 
 void svm3_init(FAR struct svm3_state_f32_s *s);
 void svm3(FAR struct svm3_state_f32_s *s, FAR ab_frame_f32_t *ab);
+void svm3_v(FAR struct svm3_state_f32_s *s, FAR ab_frame_f32_t *ab,
+            size_t n);
 void svm3_current_correct(FAR struct svm3_state_f32_s *s,
                           FAR float *c0, FAR float *c1, FAR float *c2);
 
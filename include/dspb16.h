@@ -484,6 +484,8 @@ b16_t pid_controller_b16(FAR pid_controller_b16_t *pid, b16_t err);
 void pi_antiwindup_enable_b16(FAR pid_controller_b16_t *pid, b16_t KC,
                               bool enable);
 void pi_ireset_enable_b16(FAR pid_controller_b16_t *pid, bool enable);
+void pi_controller_v_b16(FAR pid_controller_b16_t *pid, FAR const b16_t *err,
+                         FAR b16_t *out, size_t n);
 
 /* Transformation functions */
 
@@ -495,6 +497,19 @@ void park_transform_b16(FAR phase_angle_b16_t *angle, FAR ab_frame_b16_t *ab,
 void inv_park_transform_b16(FAR phase_angle_b16_t *angle,
                             FAR dq_frame_b16_t *dq, FAR ab_frame_b16_t *ab);
 
+/* Transformations of arrays of frames */
+
+void clarke_transform_v_b16(FAR abc_frame_b16_t *abc,
+                            FAR ab_frame_b16_t *ab, size_t n);
+void inv_clarke_transform_v_b16(FAR ab_frame_b16_t *ab,
+                                FAR abc_frame_b16_t *abc, size_t n);
+void park_transform_v_b16(FAR phase_angle_b16_t *angle,
+                          FAR ab_frame_b16_t *ab, FAR dq_frame_b16_t *dq,
+                          size_t n);
+void inv_park_transform_v_b16(FAR phase_angle_b16_t *angle,
+                              FAR dq_frame_b16_t *dq, FAR ab_frame_b16_t *ab,
+                              size_t n);
+
 /* Phase angle related functions */
 
 void angle_norm_b16(FAR b16_t *angle, b16_t per, b16_t bottom, b16_t top);
@@ -505,6 +520,8 @@ void phase_angle_update_b16(FAR struct phase_angle_b16_s *angle, b16_t val);
 
 void svm3_init_b16(FAR struct svm3_state_b16_s *s);
 void svm3_b16(FAR struct svm3_state_b16_s *s, FAR ab_frame_b16_t *ab);
+void svm3_v_b16(FAR struct svm3_state_b16_s *s, FAR ab_frame_b16_t *ab,
+                size_t n);
 void svm3_current_correct_b16(FAR struct svm3_state_b16_s *s,
                               b16_t *c0, b16_t *c1, b16_t *c2);
 
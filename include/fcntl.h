@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <stdint.h>
 
 /****************************************************************************
@@ -154,6 +155,13 @@
 #define F_SEAL_WRITE        0x0008 /* Prevent writes */
 #define F_SEAL_FUTURE_WRITE 0x0010 /* Prevent future writes while mapped */
 
+/* Flags of splice(), tee() and vmsplice() */
+
+#define SPLICE_F_MOVE       0x0001 /* Move pages instead of copying (ignored) */
+#define SPLICE_F_NONBLOCK   0x0002 /* Do not block on the pipe */
+#define SPLICE_F_MORE       0x0004 /* More data will follow (ignored) */
+#define SPLICE_F_GIFT       0x0008 /* The user pages are a gift (ignored) */
+
 /* int creat(const char *path, mode_t mode);
  *
  * is equivalent to open with O_WRONLY|O_CREAT|O_TRUNC.
@@ -215,6 +223,12 @@ int fcntl(int fd, int cmd, ...);
 
 int posix_fallocate(int fd, off_t offset, off_t len);
 
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out, FAR off_t *off_out,
+               size_t len, unsigned int flags);
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags);
+ssize_t vmsplice(int fd, FAR const struct iovec *iov, size_t nr_segs,
+                 unsigned int flags);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -36,6 +36,12 @@
 
 #define MQ_NONBLOCK O_NONBLOCK
 
+/* mq_flags of mq_open() with O_CREAT: The messages are file descriptors
+ * that are passed to the receiver (non-standard, see CONFIG_MQ_FDPASS).
+ */
+
+#define MQ_FDPASS   (1 << 24)
+
 /****************************************************************************
  * Public Type Declarations
  ****************************************************************************/
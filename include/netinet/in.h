@@ -114,6 +114,9 @@
 #define IP_TTL                (__SO_PROTOCOL + 14) /* The IP TTL (time to live)
                                                     * of IP packets sent by the
                                                     * network stack */
+#define IP_RECVERR            (__SO_PROTOCOL + 15) /* Control data type of the
+                                                    * extended errors read with
+                                                    * MSG_ERRQUEUE */
 
 /* SOL_IPV6 protocol-level socket options. */
 
@@ -136,6 +139,9 @@
                                                     * field */
 #define IPV6_RECVHOPLIMIT     (__SO_PROTOCOL + 11) /* Access the hop limit field */
 #define IPV6_HOPLIMIT         (__SO_PROTOCOL + 12) /* Hop limit */
+#define IPV6_RECVERR          (__SO_PROTOCOL + 13) /* Control data type of the
+                                                    * extended errors read with
+                                                    * MSG_ERRQUEUE */
 
 /* Values used with SIOCSIFMCFILTER and SIOCGIFMCFILTER ioctl's */
 
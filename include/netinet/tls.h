@@ -0,0 +1,87 @@
+/****************************************************************************
+ * include/netinet/tls.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NETINET_TLS_H
+#define __INCLUDE_NETINET_TLS_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/socket.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Kernel TLS (SOL_TLS) socket options.  The keys of a TLS session are
+ * installed after the handshake, the kernel then frames and encrypts the
+ * data sent on the TCP socket.  The layout follows the Linux kTLS one.
+ */
+
+#define TLS_TX                          1  /* Install the transmit keys */
+#define TLS_RX                          2  /* Install the receive keys */
+
+#define TLS_1_2_VERSION                 0x0303
+
+#define TLS_CIPHER_AES_GCM_128          51
+#define TLS_CIPHER_AES_GCM_128_IV_SIZE  8
+#define TLS_CIPHER_AES_GCM_128_KEY_SIZE 16
+#define TLS_CIPHER_AES_GCM_128_SALT_SIZE 4
+#define TLS_CIPHER_AES_GCM_128_TAG_SIZE 16
+#define TLS_CIPHER_AES_GCM_128_REC_SEQ_SIZE 8
+
+#define TLS_CIPHER_CHACHA20_POLY1305    54
+#define TLS_CIPHER_CHACHA20_POLY1305_IV_SIZE 12
+#define TLS_CIPHER_CHACHA20_POLY1305_KEY_SIZE 32
+#define TLS_CIPHER_CHACHA20_POLY1305_TAG_SIZE 16
+#define TLS_CIPHER_CHACHA20_POLY1305_REC_SEQ_SIZE 8
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct tls_crypto_info
+{
+  uint16_t version;                 /* TLS_1_2_VERSION */
+  uint16_t cipher_type;             /* TLS_CIPHER_* */
+};
+
+struct tls12_crypto_info_aes_gcm_128
+{
+  struct tls_crypto_info info;
+  uint8_t iv[TLS_CIPHER_AES_GCM_128_IV_SIZE];
+  uint8_t key[TLS_CIPHER_AES_GCM_128_KEY_SIZE];
+  uint8_t salt[TLS_CIPHER_AES_GCM_128_SALT_SIZE];
+  uint8_t rec_seq[TLS_CIPHER_AES_GCM_128_REC_SEQ_SIZE];
+};
+
+struct tls12_crypto_info_chacha20_poly1305
+{
+  struct tls_crypto_info info;
+  uint8_t iv[TLS_CIPHER_CHACHA20_POLY1305_IV_SIZE];
+  uint8_t key[TLS_CIPHER_CHACHA20_POLY1305_KEY_SIZE];
+  uint8_t rec_seq[TLS_CIPHER_CHACHA20_POLY1305_REC_SEQ_SIZE];
+};
+
+#endif /* __INCLUDE_NETINET_TLS_H */
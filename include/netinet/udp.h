@@ -33,6 +33,18 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* UDP protocol (SOL_UDP) socket options */
+
+#define UDP_SEGMENT     103  /* Split sends into datagrams of this size (int),
+                              * 0 disables the segmentation */
+#define UDP_GRO         104  /* Coalesce received datagrams (int boolean),
+                              * the segment size is then reported with a
+                              * SOL_UDP/UDP_GRO control message */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
 /* UDP header as specified by RFC 768, August 1980. */
 
 struct udphdr
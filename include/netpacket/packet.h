@@ -30,6 +30,40 @@
 #include <nuttx/config.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Packet socket options (level SOL_PACKET) */
+
+#define PACKET_RX_RING        5  /* Set up a memory-mapped RX ring (struct
+                                  * tpacket_req3) */
+#define PACKET_STATISTICS     6  /* Get and reset the ring statistics
+                                  * (struct tpacket_stats_v3) */
+#define PACKET_VERSION        10 /* Select the ring frame format */
+
+/* Ring frame formats, only TPACKET_V3 is supported */
+
+#define TPACKET_V1            0
+#define TPACKET_V2            1
+#define TPACKET_V3            2
+
+/* Status of a ring block, owned by the kernel or by user space */
+
+#define TP_STATUS_KERNEL      0
+#define TP_STATUS_USER        (1 << 0)
+#define TP_STATUS_LOSING      (1 << 2) /* Frames were dropped */
+#define TP_STATUS_BLK_TMO     (1 << 5) /* Retired by the block timeout */
+
+/* Alignment of the block headers and the frames in a block */
+
+#define TPACKET_ALIGNMENT     16
+#define TPACKET_ALIGN(x)      (((x) + TPACKET_ALIGNMENT - 1) & \
+                               ~(TPACKET_ALIGNMENT - 1))
+
+#define TPACKET3_HDRLEN       (TPACKET_ALIGN(sizeof(struct tpacket3_hdr)) + \
+                               sizeof(struct sockaddr_ll))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -45,4 +79,94 @@ struct sockaddr_ll
   unsigned char  sll_addr[8];
 };
 
+/* The ring set up with PACKET_RX_RING is tp_block_nr blocks of
+ * tp_block_size bytes each, mapped into user space with mmap() on the
+ * socket.  The kernel fills one block at a time with received frames and
+ * passes the block to user space by setting TP_STATUS_USER in its
+ * block_status, once it is full or tp_retire_blk_tov milliseconds after
+ * its first frame.  User space hands the block back by writing
+ * TP_STATUS_KERNEL.
+ */
+
+struct tpacket_req3
+{
+  unsigned int tp_block_size;       /* Size of a block */
+  unsigned int tp_block_nr;         /* Number of blocks */
+  unsigned int tp_frame_size;       /* Maximum size of a frame */
+  unsigned int tp_frame_nr;         /* tp_block_nr * frames per block */
+  unsigned int tp_retire_blk_tov;   /* Block timeout in milliseconds */
+  unsigned int tp_sizeof_priv;      /* Private area size per block */
+  unsigned int tp_feature_req_word; /* Not used */
+};
+
+struct tpacket_stats_v3
+{
+  unsigned int tp_packets;          /* Frames received */
+  unsigned int tp_drops;            /* Frames dropped, the ring was full */
+  unsigned int tp_freeze_q_cnt;     /* Not used */
+};
+
+struct tpacket_bd_ts
+{
+  unsigned int ts_sec;
+  union
+  {
+    unsigned int ts_usec;
+    unsigned int ts_nsec;
+  };
+};
+
+struct tpacket_hdr_v1
+{
+  uint32_t block_status;            /* TP_STATUS_KERNEL or TP_STATUS_USER */
+  uint32_t num_pkts;                /* The number of frames in the block */
+  uint32_t offset_to_first_pkt;     /* From the start of the block */
+  uint32_t blk_len;                 /* The used length of the block */
+  uint64_t seq_num;                 /* Sequence number of the block */
+  struct tpacket_bd_ts ts_first_pkt;
+  struct tpacket_bd_ts ts_last_pkt;
+};
+
+union tpacket_bd_header_u
+{
+  struct tpacket_hdr_v1 bh1;
+};
+
+struct tpacket_block_desc
+{
+  uint32_t version;
+  uint32_t offset_to_priv;
+  union tpacket_bd_header_u hdr;
+};
+
+struct tpacket_hdr_variant1
+{
+  uint32_t tp_rxhash;
+  uint32_t tp_vlan_tci;
+  uint16_t tp_vlan_tpid;
+  uint16_t tp_padding;
+};
+
+/* The header of each frame in a block, followed by a struct sockaddr_ll
+ * at TPACKET_ALIGN(sizeof(struct tpacket3_hdr)) and by the frame data at
+ * tp_mac.
+ */
+
+struct tpacket3_hdr
+{
+  uint32_t tp_next_offset;          /* To the next frame, 0 if the last */
+  uint32_t tp_sec;
+  uint32_t tp_nsec;
+  uint32_t tp_snaplen;              /* The captured length */
+  uint32_t tp_len;                  /* The length on the wire */
+  uint32_t tp_status;
+  uint16_t tp_mac;                  /* To the link layer header */
+  uint16_t tp_net;                  /* To the network layer header */
+  union
+  {
+    struct tpacket_hdr_variant1 hv1;
+  };
+  uint8_t  tp_padding[8];
+};
+
 #endif /* __INCLUDE_NETPACKET_PACKET_H */
@@ -263,6 +263,9 @@ struct addrenv_s
   struct arch_addrenv_s addrenv; /* The address environment page directory  */
   struct work_s         work;    /* Worker to free address environment      */
   int                   refs;    /* Users of address environment            */
+#ifdef CONFIG_ARCH_HAVE_ADDRENV_SHARED_TEXT
+  FAR struct addrenv_s *text;    /* Owner of the shared .text, or NULL      */
+#endif
 };
 
 typedef struct addrenv_s addrenv_t;
@@ -217,6 +217,7 @@ struct adc_dev_s
   sem_t                       ad_recvsem;    /* Used to wakeup user waiting for space in ad_recv.buffer */
   struct adc_fifo_s           ad_recv;       /* Describes receive FIFO */
   bool                        ad_isovr;      /* Flag to indicate an ADC overrun */
+  uint16_t                    ad_watermark;  /* Samples to buffer before waking readers */
 
   /* The following is a list of poll structures of threads waiting for
    * driver events.  The 'struct pollfd' reference for each open is also
@@ -65,9 +65,13 @@
                                                  * IN: None
                                                  * OUT: Number of samples
                                                  * waiting to be read */
+#define ANIOC_SET_WATERMARK     _ANIOC(0x0007)  /* Set the number of
+                                                 * samples to wait for
+                                                 * IN: Number of samples
+                                                 * OUT: None */
 
 #define AN_FIRST          0x0001          /* First common command */
-#define AN_NCMDS          6               /* Number of common commands */
+#define AN_NCMDS          7               /* Number of common commands */
 
 /* User defined ioctl commands are also supported. These will be forwarded
  * by the upper-half driver to the lower-half driver via the ioctl()
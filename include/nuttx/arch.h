@@ -1096,6 +1096,35 @@ int up_addrenv_create(size_t textsize, size_t datasize, size_t heapsize,
                       FAR arch_addrenv_t *addrenv);
 #endif
 
+/****************************************************************************
+ * Name: up_addrenv_create_shared
+ *
+ * Description:
+ *   Create an address environment like up_addrenv_create(), except that
+ *   the .text region maps the physical pages of the .text region of
+ *   another address environment instead of allocating new pages.  The
+ *   other address environment must not be destroyed before this one.
+ *
+ * Input Parameters:
+ *   text - The address environment that owns the .text pages.
+ *   textsize - The size (in bytes) of the .text address environment.
+ *   datasize - The size (in bytes) of the .data/.bss address environment.
+ *   heapsize - The initial size (in bytes) of the heap address environment.
+ *   addrenv - The location to return the representation of the task address
+ *     environment.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_ARCH_ADDRENV) && \
+    defined(CONFIG_ARCH_HAVE_ADDRENV_SHARED_TEXT)
+int up_addrenv_create_shared(FAR arch_addrenv_t *text, size_t textsize,
+                             size_t datasize, size_t heapsize,
+                             FAR arch_addrenv_t *addrenv);
+#endif
+
 /****************************************************************************
  * Name: up_addrenv_destroy
  *
@@ -2034,6 +2063,49 @@ int up_alarm_tick_start(clock_t ticks);
 #  endif
 #endif
 
+/****************************************************************************
+ * Name: up_hrtimer_start
+ *
+ * Description:
+ *   Start the alarm of the high resolution timers.  hrtimer_process() will
+ *   be called when the alarm occurs.  The alarm is independent of the
+ *   alarm of the system tick, the architecture has to multiplex both on
+ *   its timer if needed.
+ *
+ *   Provided by platform-specific code and called from the RTOS base code.
+ *
+ * Input Parameters:
+ *   nsec - The absolute time of CLOCK_MONOTONIC in nanoseconds at which
+ *          the alarm is expected to occur.  UINT64_MAX stops the alarm.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+int up_hrtimer_start(uint64_t nsec);
+#endif
+
+/****************************************************************************
+ * Name: up_hrtimer_gettime
+ *
+ * Description:
+ *   Return the time of CLOCK_MONOTONIC in nanoseconds, with the full
+ *   resolution of the timer of the architecture.
+ *
+ *   Provided by platform-specific code and called from the RTOS base code.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+uint64_t up_hrtimer_gettime(void);
+#endif
+
 /****************************************************************************
  * Name: up_timer_cancel
  *
@@ -2237,6 +2309,33 @@ void up_tls_initialize(FAR struct tls_info_s *info);
 
 /* See prototype in include/nuttx/spinlock.h */
 
+/****************************************************************************
+ * Name: up_chksum_partial
+ *
+ * Description:
+ *   Return the one's complement sum of the 16-bit words of a buffer, as
+ *   used by the Internet checksum of the network stack.  The words are
+ *   loaded in native byte order and paired starting from the first byte of
+ *   'data', a trailing odd byte is summed as if padded with a zero byte.
+ *   'data' may have any alignment.  The caller folds the result into 16
+ *   bits, so the returned value may use all 32 bits.
+ *
+ *   This function must be provided via the architecture-specific logic if
+ *   CONFIG_ARCH_HAVE_NET_CHKSUM is selected.
+ *
+ * Input Parameters:
+ *   data - The start of the buffer
+ *   len  - The length of the buffer in bytes
+ *
+ * Returned Value:
+ *   The unfolded one's complement sum of the buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_NET_CHKSUM
+uint32_t up_chksum_partial(FAR const void *data, size_t len);
+#endif
+
 /****************************************************************************
  * Name: up_fetchadd8, up_fetchadd16, and up_fetchadd32
  *
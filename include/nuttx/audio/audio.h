@@ -94,6 +94,12 @@
  * AUDIOIOC_STOP - Stop Audio streaming
  *
  *   ioctl argument:  None
+ *
+ * AUDIOIOC_MMAPSYNC - Exchange the positions in the mmap()'ed ring
+ *
+ *   ioctl argument:  Pointer to the audio_mmap_sync_s structure.  Returns
+ *                    -EPIPE after an underrun or an overrun, until the
+ *                    stream is stopped.
  */
 
 #define AUDIOIOC_GETCAPS            _AUDIOIOC(1)
@@ -117,6 +123,7 @@
 #define AUDIOIOC_GETLATENCY         _AUDIOIOC(19)
 #define AUDIOIOC_FLUSH              _AUDIOIOC(20)
 #define AUDIOIOC_GETPOSITION        _AUDIOIOC(21)
+#define AUDIOIOC_MMAPSYNC           _AUDIOIOC(22)
 
 /* Audio Device Types *******************************************************/
 
@@ -331,6 +338,12 @@
 #define AUDIO_CALLBACK_COMPLETE     0x03
 #define AUDIO_CALLBACK_MESSAGE      0x04
 #define AUDIO_CALLBACK_UNDERRUN     0x05
+#define AUDIO_CALLBACK_PERIOD       0x06
+
+/* audio_mmap_sync_s flags **************************************************/
+
+#define AUDIO_MMAP_SYNC_APPL        0x01  /* Set appl_ptr */
+#define AUDIO_MMAP_SYNC_AVAIL_MIN   0x02  /* Set avail_min */
 
 /* Audio Pipeline Buffer (AP Buffer) flags **********************************/
 
@@ -456,6 +469,45 @@ struct ap_buffer_info_s
   apb_samp_t  buffer_size;  /* Preferred size of the buffers */
 };
 
+/* This structure exchanges the positions in the ring of samples that an
+ * application mmap()'ed, as the hw_ptr and appl_ptr of ALSA.  Both count
+ * the bytes since the stream was started, their value modulo the size of
+ * the ring is the offset in the ring.
+ *
+ *   - Playback: The samples up to appl_ptr are written, the hardware has
+ *     played the ones up to hw_ptr.
+ *   - Capture: The samples up to hw_ptr are recorded, the application has
+ *     read the ones up to appl_ptr.
+ *
+ * poll() reports POLLOUT, or POLLIN for a capture, once avail_min bytes may
+ * be written or read.
+ */
+
+struct audio_mmap_sync_s
+{
+  uint32_t flags;           /* AUDIO_MMAP_SYNC_* */
+  uint32_t avail_min;       /* The wakeup threshold, one period by default */
+  uint64_t hw_ptr;          /* Returned: Position of the hardware */
+  uint64_t appl_ptr;        /* Position of the application */
+  uint32_t avail;           /* Returned: Bytes to write or to read */
+  uint32_t period_bytes;    /* Returned: Size of a period */
+  uint32_t buffer_bytes;    /* Returned: Size of the ring */
+};
+
+#ifdef CONFIG_AUDIO_MMAP
+/* This structure describes the ring that the lower half plays or records
+ * over and over, from AUDIOIOC_START to AUDIOIOC_STOP.
+ */
+
+struct audio_ring_s
+{
+  FAR uint8_t *base;        /* Start of the ring */
+  apb_samp_t  period_bytes; /* One AUDIO_CALLBACK_PERIOD per period */
+  apb_samp_t  periods;      /* The number of periods of the ring */
+  bool        playback;     /* True: Output, false: Input */
+};
+#endif
+
 /* This structure describes an Audio Pipeline Buffer */
 
 struct ap_buffer_s
@@ -709,6 +761,17 @@ struct audio_ops_s
 #else
   CODE int (*release)(FAR struct audio_lowerhalf_s *dev);
 #endif
+
+#ifdef CONFIG_AUDIO_MMAP
+  /* Switch to the ring mode and describe the ring, with the period size of
+   * AUDIOIOC_SETBUFFERINFO.  No buffers are enqueued in this mode, the
+   * lower half reports every period with AUDIO_CALLBACK_PERIOD and runs on
+   * until it is stopped.  It leaves the ring mode at shutdown.
+   */
+
+  CODE int (*getring)(FAR struct audio_lowerhalf_s *dev,
+                      FAR struct audio_ring_s *ring);
+#endif
 };
 
 /* This structure is the generic form of state structure used by lower half
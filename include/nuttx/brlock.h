@@ -0,0 +1,239 @@
+/****************************************************************************
+ * include/nuttx/brlock.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_BRLOCK_H
+#define __INCLUDE_NUTTX_BRLOCK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The reader counters of the CPUs are kept in separate cache lines, so
+ * that the readers of different CPUs never share one.
+ */
+
+#ifndef BRLOCK_CPU_ALIGN
+#  define BRLOCK_CPU_ALIGN 64
+#endif
+
+#define BRLOCK_INITIALIZER {0}
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* A big-reader lock is a reader-writer spinlock for data that is read
+ * very often and written rarely.  A reader only touches the counter of its
+ * own CPU, a writer takes the writer flag and then waits for the counters
+ * of all CPUs to drain.  Both sides run with the local interrupts disabled
+ * and must not block.
+ */
+
+struct brlock_cpu_s
+{
+  atomic_int readers aligned_data(BRLOCK_CPU_ALIGN); /* Readers of the CPU */
+};
+
+typedef struct
+{
+  atomic_int writer;                   /* Non-zero while a writer holds or
+                                        * waits for the lock */
+#ifdef CONFIG_SMP
+  struct brlock_cpu_s cpu[CONFIG_SMP_NCPUS];
+#endif
+} brlock_t;
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: brlock_init
+ *
+ * Description:
+ *   Initialize a big-reader lock to the unlocked state.
+ *
+ ****************************************************************************/
+
+static inline_function void brlock_init(FAR brlock_t *lock)
+{
+#ifdef CONFIG_SMP
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      atomic_store(&lock->cpu[i].readers, 0);
+    }
+#endif
+
+  atomic_store(&lock->writer, 0);
+}
+
+/****************************************************************************
+ * Name: brlock_read_lock_irqsave
+ *
+ * Description:
+ *   Disable the local interrupts and take the lock for reading.  Only the
+ *   reader counter of this CPU is written unless a writer is pending.  The
+ *   read lock may be taken recursively on the same CPU.
+ *
+ * Input Parameters:
+ *   lock - A reference to the big-reader lock
+ *
+ * Returned Value:
+ *   The interrupt state to pass to brlock_read_unlock_irqrestore().
+ *
+ ****************************************************************************/
+
+static inline_function irqstate_t
+brlock_read_lock_irqsave(FAR brlock_t *lock)
+{
+  irqstate_t flags = up_irq_save();
+#ifdef CONFIG_SMP
+  FAR atomic_int *readers = &lock->cpu[this_cpu()].readers;
+
+  /* A reader that already holds the lock on this CPU must not back off,
+   * the pending writer waits for it anyway.
+   */
+
+  while (atomic_fetch_add(readers, 1) == 0 &&
+         atomic_load(&lock->writer) != 0)
+    {
+      /* A writer holds or waits for the lock, back off so that it can see
+       * the counter of this CPU drain, and wait for it to complete.
+       */
+
+      atomic_fetch_sub(readers, 1);
+      while (atomic_load(&lock->writer) != 0)
+        {
+          SP_DSB();
+        }
+    }
+
+  SP_DMB();
+#endif
+
+  return flags;
+}
+
+/****************************************************************************
+ * Name: brlock_read_unlock_irqrestore
+ *
+ * Description:
+ *   Release the read lock taken by brlock_read_lock_irqsave() and restore
+ *   the local interrupts.
+ *
+ ****************************************************************************/
+
+static inline_function void
+brlock_read_unlock_irqrestore(FAR brlock_t *lock, irqstate_t flags)
+{
+#ifdef CONFIG_SMP
+  SP_DMB();
+  atomic_fetch_sub(&lock->cpu[this_cpu()].readers, 1);
+#endif
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: brlock_write_lock_irqsave
+ *
+ * Description:
+ *   Disable the local interrupts and take the lock for writing.  The
+ *   caller spins until the readers of all CPUs have left.  The CPU must
+ *   not hold the read lock itself.
+ *
+ * Input Parameters:
+ *   lock - A reference to the big-reader lock
+ *
+ * Returned Value:
+ *   The interrupt state to pass to brlock_write_unlock_irqrestore().
+ *
+ ****************************************************************************/
+
+static inline_function irqstate_t
+brlock_write_lock_irqsave(FAR brlock_t *lock)
+{
+  irqstate_t flags = up_irq_save();
+#ifdef CONFIG_SMP
+  int expect = 0;
+  int i;
+
+  /* Serialize the writers first */
+
+  while (!atomic_compare_exchange_weak(&lock->writer, &expect, 1))
+    {
+      expect = 0;
+      SP_DSB();
+    }
+
+  /* Then sweep the reader counters of all CPUs */
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      while (atomic_load(&lock->cpu[i].readers) != 0)
+        {
+          SP_DSB();
+        }
+    }
+
+  SP_DMB();
+#endif
+
+  return flags;
+}
+
+/****************************************************************************
+ * Name: brlock_write_unlock_irqrestore
+ *
+ * Description:
+ *   Release the write lock taken by brlock_write_lock_irqsave() and
+ *   restore the local interrupts.
+ *
+ ****************************************************************************/
+
+static inline_function void
+brlock_write_unlock_irqrestore(FAR brlock_t *lock, irqstate_t flags)
+{
+#ifdef CONFIG_SMP
+  SP_DMB();
+  atomic_store(&lock->writer, 0);
+#endif
+
+  up_irq_restore(flags);
+}
+
+#endif /* __INCLUDE_NUTTX_BRLOCK_H */
@@ -39,6 +39,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mutex.h>
+#include <nuttx/wdog.h>
 
 #ifdef CONFIG_CAN_TXREADY
 #  include <nuttx/wqueue.h>
@@ -303,6 +304,19 @@
  *                   is returned with the errno variable set to indicate the
  *                   nature of the error.
  *   Dependencies:   None
+ *
+ * CANIOC_SET_RXWATERMARK
+ *   Description:    Batch the wakeups of this reader.  read() and poll()
+ *                   wait until rw_count messages are buffered or until
+ *                   rw_timeout milliseconds passed since the first one.
+ *                   A count of 0 or 1 wakes up on every message, a
+ *                   timeout of 0 waits for rw_count messages without limit.
+ *
+ *   Argument:       A pointer to struct canioc_rxwatermark_s
+ *   returned Value: Zero (OK) is returned on success.  Otherwise -1 (ERROR)
+ *                   is returned with the errno variable set to indicate the
+ *                   nature of the error.
+ *   Dependencies:   None
  */
 
 #define CANIOC_RTR                _CANIOC(1)
@@ -324,9 +338,10 @@
 #define CANIOC_GET_STATE          _CANIOC(17)
 #define CANIOC_SET_TRANSVSTATE    _CANIOC(18)
 #define CANIOC_GET_TRANSVSTATE    _CANIOC(19)
+#define CANIOC_SET_RXWATERMARK    _CANIOC(20)
 
 #define CAN_FIRST                 0x0001         /* First common command */
-#define CAN_NCMDS                 19             /* 20 common commands   */
+#define CAN_NCMDS                 20             /* 20 common commands   */
 
 /* User defined ioctl commands are also supported. These will be forwarded
  * by the upper-half CAN driver to the lower-half CAN driver via the
@@ -499,6 +514,12 @@
 #define CAN_FILTER_DUAL           1  /* Dual address match */
 #define CAN_FILTER_RANGE          2  /* Match a range of addresses */
 
+/* The IDs of the filters that the upper half applies in software, when the
+ * lower half has no hardware filters, start at this value.
+ */
+
+#define CAN_SOFTFILTER_ID         0x4000
+
 /* the state is default state. Indicates that the can controller is closed */
 
 #define CAN_STATE_STOP            0
@@ -644,6 +665,8 @@ struct can_rxfifo_s
 #endif
   uint8_t       rx_head;                 /* Index to the head [IN] in the circular buffer */
   uint8_t       rx_tail;                 /* Index to the tail [OUT] in the circular buffer */
+  uint8_t       rx_watermark;            /* Wake up readers at this many messages */
+  sclock_t      rx_timeout;              /* ... or this many ticks after the first */
                                          /* Circular buffer of CAN messages */
   struct can_msg_s rx_buffer[CONFIG_CAN_RXFIFOSIZE];
 };
@@ -801,8 +824,23 @@ struct can_reader_s
 {
   struct list_node     list;
   struct can_rxfifo_s  fifo;             /* Describes receive FIFO */
+  struct wdog_s        rx_wdog;          /* Ends the wait for rx_watermark */
+  FAR struct can_dev_s *dev;             /* The device of the reader */
 };
 
+#ifdef CONFIG_CAN_SOFTFILTER
+/* An acceptance filter applied by the upper half, see CAN_SOFTFILTER_ID */
+
+struct can_softfilter_s
+{
+  uint32_t             cf_id1;           /* See canioc_stdfilter_s */
+  uint32_t             cf_id2;
+  uint8_t              cf_type;          /* See CAN_FILTER_* definitions */
+  bool                 cf_extid;         /* Match extended IDs */
+  bool                 cf_used;          /* The entry is in use */
+};
+#endif
+
 struct can_transv_s
 {
   FAR const struct can_transv_ops_s *ct_ops;    /* Arch-specific operations */
@@ -826,6 +864,10 @@ struct can_dev_s
   FAR void            *cd_priv;          /* Used by the arch-specific logic */
   FAR struct can_transv_s *cd_transv;    /* Describes CAN transceiver */
   FAR struct pollfd   *cd_fds[CONFIG_CAN_NPOLLWAITERS];
+#ifdef CONFIG_CAN_SOFTFILTER
+  uint8_t              cd_nfilters;      /* Number of software filters */
+  struct can_softfilter_s cd_filters[CONFIG_CAN_NSOFTFILTERS];
+#endif
 };
 
 /* Structures used with ioctl calls */
@@ -903,6 +945,14 @@ struct canioc_extfilter_s
 };
 #endif
 
+/* CANIOC_SET_RXWATERMARK: */
+
+struct canioc_rxwatermark_s
+{
+  uint8_t               rw_count;        /* Messages to wait for */
+  uint32_t              rw_timeout;      /* Longest wait in milliseconds */
+};
+
 /* CANIOC_ADD_STDFILTER: */
 
 struct canioc_stdfilter_s
@@ -312,6 +312,22 @@ typedef int64_t sclock_t;
 typedef int32_t sclock_t;
 #endif
 
+/* The time page published by the kernel to user space.  The kernel updates
+ * it every tick, odd values of seq mark an update in progress.  Readers
+ * retry until seq is the same even value before and after the copy.
+ */
+
+#ifdef CONFIG_CLOCK_VDSO
+struct clock_vdso_s
+{
+  volatile uint32_t seq;        /* Update sequence, zero before the first */
+  volatile time_t   mono_sec;   /* CLOCK_MONOTONIC at the last update */
+  volatile long     mono_nsec;
+  volatile time_t   base_sec;   /* CLOCK_REALTIME - CLOCK_MONOTONIC */
+  volatile long     base_nsec;
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -340,6 +356,14 @@ EXTERN volatile clock_t g_system_ticks;
 #  endif
 #endif
 
+/* The time page of the user-space clock_gettime(), it lives in the user
+ * blob and is found by the kernel through struct userspace_s.
+ */
+
+#if defined(CONFIG_CLOCK_VDSO) && !defined(__KERNEL__)
+EXTERN struct clock_vdso_s g_clock_vdso;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -38,6 +38,17 @@
 
 #define crc32   crc32full
 
+/* CRC-32C (Castagnoli), as used by iSCSI, SCTP, ext4 and btrfs.
+ * CRC32C_CHECK is the CRC-32C of the string "123456789":
+ *
+ *   assert(crc32c((FAR const uint8_t *)"123456789", 9) == CRC32C_CHECK);
+ */
+
+#define CRC32C_POLY   0x1edc6f41
+#define CRC32C_INIT   0xffffffff
+#define CRC32C_XOROUT 0xffffffff
+#define CRC32C_CHECK  0xe3069283
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -70,6 +81,28 @@ uint32_t crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val);
 
 uint32_t crc32(FAR const uint8_t *src, size_t len);
 
+/****************************************************************************
+ * Name: crc32cpart
+ *
+ * Description:
+ *   Continue CRC-32C calculation on a part of the buffer.  The value is
+ *   neither inverted on entry nor on return, start with CRC32C_INIT and
+ *   invert the final value with CRC32C_XOROUT.
+ *
+ ****************************************************************************/
+
+uint32_t crc32cpart(FAR const uint8_t *src, size_t len, uint32_t crc32cval);
+
+/****************************************************************************
+ * Name: crc32c
+ *
+ * Description:
+ *   Return the CRC-32C of the contents of the 'src' buffer, length 'len'.
+ *
+ ****************************************************************************/
+
+uint32_t crc32c(FAR const uint8_t *src, size_t len);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
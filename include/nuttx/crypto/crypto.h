@@ -84,6 +84,10 @@ int aes_cypher(FAR void *out, FAR const void *in, size_t size,
 int crypto_test(void);
 #endif
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_BENCHMARK
+int crypto_bench_register(void);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
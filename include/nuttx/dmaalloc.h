@@ -0,0 +1,186 @@
+/****************************************************************************
+ * include/nuttx/dmaalloc.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_DMAALLOC_H
+#define __INCLUDE_NUTTX_DMAALLOC_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/kmalloc.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+/* CONFIG_MM_DMAALLOC - Enable the DMA buffer allocator
+ * CONFIG_MM_DMAALLOC_GRANSIZE - The granule size of the DMA region.  All
+ *   buffers start on and are rounded up to a granule, so it must be a
+ *   power of two no smaller than the data cache line.
+ *
+ * Dependencies:  CONFIG_GRAN
+ *
+ * Without CONFIG_MM_DMAALLOC the interfaces below map to the kernel heap,
+ * so drivers can use them unconditionally.
+ */
+
+#ifndef CONFIG_MM_DMAALLOC
+#  define mm_dmamemalign(a, s)  kmm_memalign(a, s)
+#  define mm_dmaalloc(s)        kmm_malloc(s)
+#  define mm_dmazalloc(s)       kmm_zalloc(s)
+#  define mm_dmafree(m)         kmm_free(m)
+#else
+
+#define MM_DMA_GRANSIZE         CONFIG_MM_DMAALLOC_GRANSIZE
+#define MM_DMA_ALIGNUP(a)       (((uintptr_t)(a) + MM_DMA_GRANSIZE - 1) & \
+                                 ~(uintptr_t)(MM_DMA_GRANSIZE - 1))
+
+#define mm_dmaalloc(s)          mm_dmamemalign(MM_DMA_GRANSIZE, s)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Form in which the state of the DMA allocator is returned */
+
+struct dmainfo_s
+{
+  size_t        total;      /* The size of the DMA region */
+  size_t        free;       /* The free memory in the DMA region */
+  size_t        largest;    /* The largest free block in the DMA region */
+  unsigned long nfallback;  /* Buffers taken from the kernel heap instead */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: mm_dmainitialize
+ *
+ * Description:
+ *   Hand a reserved, physically contiguous region to the DMA allocator.
+ *   This is normally called once from the board initialization logic with
+ *   a region that is excluded from the heaps (and, where the hardware
+ *   allows it, mapped non-cacheable).
+ *
+ * Input Parameters:
+ *   heap_start - The start of the region that will hold the DMA buffers
+ *   heap_size  - The size (in bytes) of that region
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_dmainitialize(FAR void *heap_start, size_t heap_size);
+
+/****************************************************************************
+ * Name: mm_dmamemalign
+ *
+ * Description:
+ *   Allocate a DMA buffer.  The buffer starts on a boundary of at least
+ *   CONFIG_MM_DMAALLOC_GRANSIZE and 'alignment', and its size is rounded
+ *   up to the granule size, so it never shares a cache line with other
+ *   data and cache maintenance never needs to handle partial lines.
+ *
+ *   The buffer comes from the DMA region.  If there is no DMA region or
+ *   it is exhausted, the buffer is taken from the kernel heap with the
+ *   same alignment guarantees.
+ *
+ * Input Parameters:
+ *   alignment - The required alignment, a power of two or zero
+ *   size      - The size of the buffer
+ *
+ * Returned Value:
+ *   The buffer on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR void *mm_dmamemalign(size_t alignment, size_t size);
+
+/****************************************************************************
+ * Name: mm_dmazalloc
+ *
+ * Description:
+ *   Like mm_dmaalloc() but the buffer is cleared.
+ *
+ ****************************************************************************/
+
+FAR void *mm_dmazalloc(size_t size);
+
+/****************************************************************************
+ * Name: mm_dmafree
+ *
+ * Description:
+ *   Return a buffer allocated by mm_dmamemalign(), mm_dmaalloc() or
+ *   mm_dmazalloc().
+ *
+ * Input Parameters:
+ *   mem - The buffer to free, NULL is ignored
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_dmafree(FAR void *mem);
+
+/****************************************************************************
+ * Name: mm_dmainfo
+ *
+ * Description:
+ *   Return information about the DMA allocator.
+ *
+ * Input Parameters:
+ *   info - Memory location to return the DMA allocator info.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_dmainfo(FAR struct dmainfo_s *info);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_MM_DMAALLOC */
+#endif /* __INCLUDE_NUTTX_DMAALLOC_H */
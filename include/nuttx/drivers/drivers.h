@@ -94,6 +94,54 @@ void devnull_register(void);
 void devascii_register(void);
 #endif
 
+/****************************************************************************
+ * Name: devosbench_register
+ *
+ * Description:
+ *   Register /dev/osbench
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_OSBENCH
+void devosbench_register(void);
+#endif
+
+/****************************************************************************
+ * Name: devnetbench_register
+ *
+ * Description:
+ *   Register /dev/netbench
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_NETBENCH
+void devnetbench_register(void);
+#endif
+
+/****************************************************************************
+ * Name: devfsbench_register
+ *
+ * Description:
+ *   Register /dev/fsbench
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_FSBENCH
+void devfsbench_register(void);
+#endif
+
+/****************************************************************************
+ * Name: devheapbench_register
+ *
+ * Description:
+ *   Register /dev/heapbench
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_HEAPBENCH
+void devheapbench_register(void);
+#endif
+
 /****************************************************************************
  * Name: devrandom_register
  *
@@ -31,10 +31,16 @@
 
 #include <nuttx/list.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_SCHED_EVENTS_NBUCKETS
+#  define CONFIG_SCHED_EVENTS_NBUCKETS 0
+#endif
+
 /* Initializers */
 
 #define NXEVENT_INITIALIZER(e, v) {LIST_INITIAL_VALUE((e).list), (v)}
@@ -49,6 +55,7 @@
 
 #define NXEVENT_POST_ALL     (1 << 0) /* Bit 0: Post ALL */
 #define NXEVENT_POST_SET     (1 << 1) /* Bit 1: Set event after post */
+#define NXEVENT_POST_NOSCHED (1 << 2) /* Bit 2: Caller holds sched_lock() */
 
 /****************************************************************************
  * Public Type Definitions
@@ -62,6 +69,16 @@ struct nxevent_s
 {
   struct list_node         list;    /* Waiting list of nxevent_wait_t */
   volatile nxevent_mask_t  events;  /* Pending Events */
+#if CONFIG_SCHED_EVENTS_NBUCKETS > 0
+  uint16_t                 used;    /* Buckets with an initialized list */
+
+  /* The waiters that only expect events of one bucket, event n belongs to
+   * the bucket n % CONFIG_SCHED_EVENTS_NBUCKETS.  The other waiters are in
+   * the list above.
+   */
+
+  struct list_node         bucket[CONFIG_SCHED_EVENTS_NBUCKETS];
+#endif
 };
 
 #ifdef CONFIG_FS_NAMED_EVENTS
@@ -161,6 +178,10 @@ int nxevent_reset(FAR nxevent_t *event, nxevent_mask_t events);
  *   Posting differs from setting in that posted events are merged together
  *   with the current set of events tracked by the event object.
  *
+ *   With NXEVENT_POST_NOSCHED the caller holds the scheduler lock, and the
+ *   woken tasks only run at its sched_unlock().  This batches the context
+ *   switches of several posts into one.
+ *
  * Input Parameters:
  *   event  - Address of the event object
  *   events - Set of events to post to event
@@ -453,6 +453,48 @@ int fdt_load_prop_u32(FAR const void *fdt, int offset,
                       FAR const char *property, int index,
                       FAR uint32_t *value);
 
+/****************************************************************************
+ * Name: fdt_find_compatible
+ *
+ * Description:
+ *   Find the next node after startoffset that is compatible with the
+ *   string, like fdt_node_offset_by_compatible().  With
+ *   CONFIG_DEVICE_TREE_INDEX the lookup uses an index of the tree, built
+ *   on the first lookup, instead of walking the tree.  The tree must not
+ *   change afterwards.
+ *
+ * Input Parameters:
+ *   fdt - The pointer to the raw FDT.
+ *   startoffset - Only the nodes after this offset match, -1 for all.
+ *   compatible - The compatible string to match.
+ *
+ * Returns:
+ *   The offset of the node on success, -FDT_ERR_NOTFOUND if there is no
+ *   more compatible node.
+ *
+ ****************************************************************************/
+
+int fdt_find_compatible(FAR const void *fdt, int startoffset,
+                        FAR const char *compatible);
+
+/****************************************************************************
+ * Name: fdt_find_phandle
+ *
+ * Description:
+ *   Find the node of a phandle, like fdt_node_offset_by_phandle(), through
+ *   the index of CONFIG_DEVICE_TREE_INDEX if it is enabled.
+ *
+ * Input Parameters:
+ *   fdt - The pointer to the raw FDT.
+ *   phandle - The phandle of the node.
+ *
+ * Returns:
+ *   The offset of the node on success, a negative libfdt error otherwise.
+ *
+ ****************************************************************************/
+
+int fdt_find_phandle(FAR const void *fdt, uint32_t phandle);
+
 /****************************************************************************
  * Name: pci_ecam_register_from_fdt
  *
@@ -0,0 +1,179 @@
+/****************************************************************************
+ * include/nuttx/fs/blkqueue.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_BLKQUEUE_H
+#define __INCLUDE_NUTTX_FS_BLKQUEUE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+#include <nuttx/wqueue.h>
+
+#ifdef CONFIG_FS_BLKQUEUE
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct inode;
+struct blk_req_s;
+
+/* Called once the transfer of a request is over, in the context of the
+ * work queue.  The request belongs to the submitter again and may be freed
+ * by the callback.
+ */
+
+typedef CODE void (*blk_complete_t)(FAR struct blk_req_s *req);
+
+/* Transfers a request and the requests merged into it, whose buffers may
+ * be apart, and returns the sectors transferred or a negated errno.
+ */
+
+typedef CODE ssize_t (*blk_transfer_t)(FAR struct blk_req_s *req);
+
+/* One asynchronous sector transfer.  The submitter fills in all fields but
+ * 'node', 'next', 'total' and 'result', and keeps the request and the
+ * buffer valid until the completion is called.
+ */
+
+struct blk_req_s
+{
+  dq_entry_t node;              /* Entry in the queue of the device */
+  FAR struct blk_req_s *next;   /* The requests merged into this one */
+  FAR struct inode *inode;      /* The block driver to transfer with */
+  FAR uint8_t *buffer;          /* The data of the sectors */
+  blkcnt_t start;               /* The first sector */
+  unsigned int nsectors;        /* The number of sectors */
+  unsigned int total;           /* The sectors of all merged requests */
+  ssize_t result;               /* Sectors transferred or negated errno */
+  blk_complete_t complete;      /* Called when the transfer is over */
+  FAR void *priv;               /* For use by the submitter */
+  bool write;                   /* true: Write the sectors */
+  bool plug;                    /* true: More requests follow at once */
+};
+
+/* The request queue of one device.  A request that continues the last one
+ * in the queue, in the same direction and memory, is merged into it.
+ * Requests with 'plug' set are held back so that the requests that follow
+ * them can merge, the next request without it starts the transfers.
+ *
+ * A driver that can transfer into several buffers at once, with a
+ * scatter-gather DMA, sets 'transfer' and 'maxsegs' after
+ * blk_queue_init().  Requests then also merge if their memory is apart,
+ * as long as a transfer needs no more than 'maxsegs' buffers.
+ */
+
+struct blk_queue_s
+{
+  mutex_t lock;                 /* Protects 'pending' */
+  dq_queue_t pending;           /* The requests not started yet */
+  struct work_s work;           /* Passes the requests to the driver */
+  size_t sectsize;              /* The sector size, no merging while 0 */
+  blk_transfer_t transfer;      /* Scatter-gather transfer or NULL */
+  unsigned int maxsegs;         /* Buffers of one transfer of 'transfer' */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: blk_queue_init
+ *
+ * Description:
+ *   Initialize the request queue of a block driver.
+ *
+ * Input Parameters:
+ *   queue    - The queue to initialize
+ *   sectsize - The sector size of the device, zero if not known yet
+ *
+ ****************************************************************************/
+
+void blk_queue_init(FAR struct blk_queue_s *queue, size_t sectsize);
+
+/****************************************************************************
+ * Name: blk_queue_uninit
+ *
+ * Description:
+ *   Wait for the transfer in progress and complete the requests that did
+ *   not start yet with -ENODEV, before the driver frees the queue.
+ *
+ ****************************************************************************/
+
+void blk_queue_uninit(FAR struct blk_queue_s *queue);
+
+/****************************************************************************
+ * Name: blk_queue_submit
+ *
+ * Description:
+ *   Add a request to the queue of a device, the implementation of the
+ *   submit method of the block drivers that have a queue.  The transfers
+ *   use the read and write methods of 'req->inode'.
+ *
+ * Returned Value:
+ *   Zero (OK), the result is reported to the completion of the request.
+ *
+ ****************************************************************************/
+
+int blk_queue_submit(FAR struct blk_queue_s *queue,
+                     FAR struct blk_req_s *req);
+
+/****************************************************************************
+ * Name: blk_submit
+ *
+ * Description:
+ *   Submit a request to the block driver 'req->inode'.  A driver without a
+ *   submit method transfers the sectors at once and the completion is
+ *   called before this function returns.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was accepted, the completion reports its
+ *   result.  A negated errno value if not, the completion is not called.
+ *
+ ****************************************************************************/
+
+int blk_submit(FAR struct blk_req_s *req);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_FS_BLKQUEUE */
+#endif /* __INCLUDE_NUTTX_FS_BLKQUEUE_H */
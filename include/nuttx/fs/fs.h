@@ -183,6 +183,7 @@ struct statfs;
 struct pollfd;
 struct mtd_dev_s;
 struct tcb_s;
+struct blk_req_s;
 
 /* The internal representation of type DIR is just a container for an inode
  * reference, and the path of directory.
@@ -293,6 +294,10 @@ struct block_operations
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   CODE int     (*unlink)(FAR struct inode *inode);
 #endif
+#ifdef CONFIG_FS_BLKQUEUE
+  CODE int     (*submit)(FAR struct inode *inode,
+                         FAR struct blk_req_s *req);
+#endif
 };
 
 /* This structure is provided by a filesystem to describe a mount point.
@@ -376,6 +381,18 @@ struct mountpt_operations
   CODE int     (*chstat)(FAR struct inode *mountpt, FAR const char *relpath,
                          FAR const struct stat *buf, int flags);
   CODE int     (*syncfs)(FAR struct inode *mountpt);
+
+  /* Optional directory position operations.  telldir() returns a cookie
+   * for the position of the entry that readdir() returns next.  Without
+   * it the position is the number of entries read since opendir().
+   * seekdir() moves to such a position without reading the entries in
+   * between.  Position 0 is always the beginning of the directory.
+   */
+
+  CODE off_t   (*telldir)(FAR struct inode *mountpt,
+                          FAR struct fs_dirent_s *dir);
+  CODE int     (*seekdir)(FAR struct inode *mountpt,
+                          FAR struct fs_dirent_s *dir, off_t offset);
 };
 #endif /* CONFIG_DISABLE_MOUNTPOINT */
 
@@ -476,7 +493,7 @@ struct file
 {
   int               f_oflags;   /* Open mode flags */
 #ifdef CONFIG_FS_REFCOUNT
-  int               f_refs;     /* Reference count */
+  atomic_int        f_refs;     /* Reference count */
 #endif
   off_t             f_pos;      /* File position */
   FAR struct inode *f_inode;    /* Driver or file system interface */
@@ -507,9 +524,12 @@ struct file
 
 struct filelist
 {
-  uint8_t           fl_rows;    /* The number of rows of fl_files array */
+  atomic_uchar      fl_rows;    /* The number of rows of fl_files array */
   uint8_t           fl_crefs;   /* The references to filelist */
   FAR struct file **fl_files;   /* The pointer of two layer file descriptors array */
+#ifdef CONFIG_FS_FILELIST_LOCKLESS
+  FAR void         *fl_retired; /* Replaced fl_files arrays, see files_extend() */
+#endif
 
   /* Pre-allocated files to avoid allocator access during thread creation
    * phase, For functional safety requirements, increase
@@ -1534,6 +1554,21 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
 ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
                       FAR off_t *offset, size_t count);
 
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the standard splice function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PIPES
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoff,
+                    FAR struct file *outfile, FAR off_t *outoff,
+                    size_t len, unsigned int flags);
+#endif
+
 /****************************************************************************
  * Name: file_seek
  *
@@ -1684,6 +1719,56 @@ int file_fcntl(FAR struct file *filep, int cmd, ...);
 
 int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 
+#ifdef CONFIG_FS_POLL_CACHE
+/****************************************************************************
+ * Name: poll_cache
+ *
+ * Description:
+ *   The poll() operation with the setup kept in the cache of the running
+ *   thread from one call to the next.  Only the revents fields of fds are
+ *   written.
+ *
+ * Input Parameters:
+ *   fds     - List of structures describing file descriptors to be
+ *             monitored
+ *   nfds    - The number of entries in the list, not zero
+ *   timeout - The timeout in milliseconds, negative for no timeout
+ *
+ * Returned Value:
+ *   The number of structures that have non-zero revents fields, zero on a
+ *   timeout; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int poll_cache(FAR struct pollfd *fds, unsigned int nfds, int timeout);
+
+/****************************************************************************
+ * Name: poll_cache_close
+ *
+ * Description:
+ *   Tear down the cached poll setup of a file that is being closed.
+ *
+ * Input Parameters:
+ *   filep - The file being closed
+ *
+ ****************************************************************************/
+
+void poll_cache_close(FAR struct file *filep);
+
+/****************************************************************************
+ * Name: poll_cache_release
+ *
+ * Description:
+ *   Tear down and free the poll cache of an exiting thread.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the exiting thread
+ *
+ ****************************************************************************/
+
+void poll_cache_release(FAR struct tcb_s *tcb);
+#endif
+
 /****************************************************************************
  * Name: file_fstat
  *
@@ -1809,6 +1894,36 @@ int nx_unlink(FAR const char *pathname);
 int file_pipe(FAR struct file *filep[2], size_t bufsize, int flags);
 #endif
 
+/****************************************************************************
+ * Name: pipe_splicein, pipe_spliceout and pipe_tee
+ *
+ * Description:
+ *   The pipe side of splice() and tee().  pipe_splicein() reads from
+ *   'infile' straight into the buffer of the pipe 'filep' and
+ *   pipe_spliceout() writes to 'outfile' straight from it, so the data is
+ *   copied once instead of through a user buffer.  pipe_tee() copies the
+ *   data of the pipe 'infile' to the pipe 'outfile', removing it from
+ *   'infile' only if 'move' is true.
+ *
+ *   They block like read() and write() of the pipe unless it is opened
+ *   with O_NONBLOCK or 'flags' includes SPLICE_F_NONBLOCK.
+ *
+ * Returned Value:
+ *   The number of bytes transferred, zero at the end of the input.  A
+ *   negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PIPES
+ssize_t pipe_splicein(FAR struct file *infile, FAR off_t *inoff,
+                      FAR struct file *filep, size_t len,
+                      unsigned int flags);
+ssize_t pipe_spliceout(FAR struct file *filep, FAR struct file *outfile,
+                       FAR off_t *outoff, size_t len, unsigned int flags);
+ssize_t pipe_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t len, unsigned int flags, bool move);
+#endif
+
 /****************************************************************************
  * Name: nx_mkfifo
  *
@@ -107,6 +107,7 @@
 #define _PINCTRLBASE    (0x4000) /* Pinctrl driver ioctl commands */
 #define _PCIBASE        (0x4100) /* Pci ioctl commands */
 #define _I3CBASE        (0x4200) /* I3C driver ioctl commands */
+#define _DMABUFBASE     (0x4300) /* DMA buffer ioctl commands */
 #define _WLIOCBASE      (0x8b00) /* Wireless modules ioctl network commands */
 
 /* boardctl() commands share the same number space */
@@ -232,6 +233,10 @@
 #define FIOC_XIPBASE        _FIOC(0x0015) /* IN:  uinptr_t *
                                            * OUT: Current file xip base address
                                            */
+#define FIOC_GC             _FIOC(0x0016) /* IN:  None
+                                           * OUT: None, the garbage collection
+                                           * of the file system has run
+                                           */
 
 /* NuttX file system ioctl definitions **************************************/
 
@@ -346,6 +351,27 @@
                                            *      to return sector numbers.
                                            * OUT: Data return in user-provided
                                            *      buffer. */
+#define BIOC_SUBMIT     _BIOC(0x0011)     /* Submit an asynchronous block
+                                           * request (kernel only).
+                                           * IN:  Pointer to a struct
+                                           *      blk_req_s, 'inode' is set
+                                           *      by the driver.
+                                           * OUT: None, the result is
+                                           *      reported to the completion
+                                           *      of the request. */
+#define BIOC_DISCARD    _BIOC(0x0012)     /* Tell the device that the data of
+                                           * a range of sectors is no longer
+                                           * needed, e.g. freed by a file
+                                           * system.
+                                           * IN:  Pointer to a struct
+                                           *      blk_range_s
+                                           * OUT: None, the content of the
+                                           *      sectors is undefined. */
+#define BIOC_ZEROOUT    _BIOC(0x0013)     /* Set a range of sectors to zero
+                                           * without transferring the data.
+                                           * IN:  Pointer to a struct
+                                           *      blk_range_s
+                                           * OUT: None */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -740,6 +766,13 @@
 #define _I3CIOCVALID(c)   (_IOC_TYPE(c)==_I3CBASE)
 #define _I3CIOC(nr)       _IOC(_I3CBASE,nr)
 
+/* DMA buffer ioctl definitions *********************************************/
+
+/* see nuttx/include/video/dmabuf.h */
+
+#define _DMABUFIOCVALID(c) (_IOC_TYPE(c)==_DMABUFBASE)
+#define _DMABUFIOC(nr)     _IOC(_DMABUFBASE,nr)
+
 /* Force Feedback driver command definitions ********************************/
 
 /* see nuttx/include/input/ff.h */
@@ -765,6 +798,14 @@ struct pipe_peek_s
   size_t size;
 };
 
+/* The sectors of BIOC_DISCARD and BIOC_ZEROOUT */
+
+struct blk_range_s
+{
+  blkcnt_t start;               /* The first sector */
+  blkcnt_t nsectors;            /* The number of sectors */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
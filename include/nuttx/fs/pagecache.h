@@ -0,0 +1,169 @@
+/****************************************************************************
+ * include/nuttx/fs/pagecache.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_PAGECACHE_H
+#define __INCLUDE_NUTTX_FS_PAGECACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_FS_PAGECACHE
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* How the page cache accesses the pages of a mapping.  Both functions
+ * transfer 'npages' whole pages starting at page number 'page' and return
+ * zero (OK) or a negated errno value.  They are called in the context of
+ * the page cache function that needs them.
+ */
+
+struct pagecache_ops_s
+{
+  CODE int (*read_pages)(FAR void *priv, off_t page, size_t npages,
+                         FAR uint8_t *buffer);
+  CODE int (*write_pages)(FAR void *priv, off_t page, size_t npages,
+                          FAR const uint8_t *buffer);
+};
+
+/* The pages of one backing store, usually the block or MTD driver that
+ * a file system is mounted on.  The pages of all mappings share the memory
+ * of the page cache and are replaced in LRU order.  The user of a mapping
+ * serializes the accesses to it, like with the lock of the file system.
+ */
+
+struct pagecache_s
+{
+  FAR const struct pagecache_ops_s *ops; /* Accesses the backing store */
+  FAR void *priv;                        /* The argument of 'ops' */
+  size_t pagesize;                       /* The size of the pages */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: pagecache_initialize
+ *
+ * Description:
+ *   Initialize the page cache, called from fs_initialize().
+ *
+ ****************************************************************************/
+
+void pagecache_initialize(void);
+
+/****************************************************************************
+ * Name: pagecache_init
+ *
+ * Description:
+ *   Initialize a mapping.  No pages are cached for it yet.
+ *
+ * Input Parameters:
+ *   mapping  - The mapping to initialize
+ *   ops      - Reads and writes the pages of the backing store
+ *   priv     - The argument of 'ops'
+ *   pagesize - The size of the pages, e.g. the sector size of a device
+ *
+ ****************************************************************************/
+
+void pagecache_init(FAR struct pagecache_s *mapping,
+                    FAR const struct pagecache_ops_s *ops, FAR void *priv,
+                    size_t pagesize);
+
+/****************************************************************************
+ * Name: pagecache_read
+ *
+ * Description:
+ *   Read 'npages' pages starting at page number 'page'.  They are copied
+ *   from the cache if all of them are cached, otherwise they are read from
+ *   the backing store with one request and added to the cache.
+ *
+ * Returned Value:
+ *   Zero (OK) on success or a negated errno value.
+ *
+ ****************************************************************************/
+
+int pagecache_read(FAR struct pagecache_s *mapping, off_t page,
+                   size_t npages, FAR uint8_t *buffer);
+
+/****************************************************************************
+ * Name: pagecache_write
+ *
+ * Description:
+ *   Write 'npages' pages starting at page number 'page' through to the
+ *   backing store and keep them in the cache.
+ *
+ * Returned Value:
+ *   Zero (OK) on success or a negated errno value.
+ *
+ ****************************************************************************/
+
+int pagecache_write(FAR struct pagecache_s *mapping, off_t page,
+                    size_t npages, FAR const uint8_t *buffer);
+
+/****************************************************************************
+ * Name: pagecache_invalidate
+ *
+ * Description:
+ *   Drop the cached copies of 'npages' pages starting at page number
+ *   'page', for example because the backing store erased them.
+ *
+ ****************************************************************************/
+
+void pagecache_invalidate(FAR struct pagecache_s *mapping, off_t page,
+                          size_t npages);
+
+/****************************************************************************
+ * Name: pagecache_release
+ *
+ * Description:
+ *   Drop all pages of a mapping, which may then be freed or initialized
+ *   again.
+ *
+ ****************************************************************************/
+
+void pagecache_release(FAR struct pagecache_s *mapping);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_FS_PAGECACHE */
+#endif /* __INCLUDE_NUTTX_FS_PAGECACHE_H */
@@ -117,6 +117,47 @@ struct procfs_file_s
   FAR const struct procfs_entry_s *procfsentry;
 };
 
+#ifdef CONFIG_FS_PROCFS_SNAPSHOT
+/* The content of a procfs file generated once for a sequence of reads.
+ * Reads at file position zero generate a new snapshot, the following reads
+ * return the rest of the same snapshot.
+ */
+
+struct procfs_snapshot_s
+{
+  FAR char *buffer;                             /* Generated content */
+  size_t size;                                  /* Size of the buffer */
+  size_t length;                                /* Length of the content */
+};
+
+/* Generate the content of a procfs file from 'offset' on into 'buffer',
+ * returning the number of bytes generated or a negated errno value.
+ */
+
+typedef CODE ssize_t (*procfs_render_t)(FAR void *arg, FAR char *buffer,
+                                         size_t buflen, off_t offset);
+#endif
+
+#ifdef CONFIG_FS_PROCFS_INCLUDE_STATS
+/* One record of the binary /proc/stats file, one per task or thread */
+
+struct procfs_taskstats_s
+{
+  pid_t    pid;                                 /* Task/thread ID */
+  pid_t    group;                               /* ID of the task group */
+  uint32_t flags;                               /* See TCB_FLAG_* */
+  uint8_t  state;                               /* See enum tstate_e */
+  uint8_t  priority;                            /* Current priority */
+  int16_t  cpu;                                 /* CPU of the thread */
+  uint64_t cputotal;                            /* Ticks of the load period */
+  uint64_t cpuactive;                           /* Ticks the thread ran */
+  uint64_t stacksize;                           /* Size of the stack */
+  uint64_t heapused;                            /* Heap owned by the thread */
+  uint64_t heappeak;                            /* Peak of heapused */
+  char     name[CONFIG_TASK_NAME_SIZE + 1];     /* Name of the thread */
+};
+#endif
+
 /* The generic proc/ pseudo directory structure */
 
 struct procfs_dir_priv_s
@@ -245,6 +286,47 @@ int procfs_snprintf(FAR char *buf, size_t size,
 void procfs_sprintf(FAR char *buf, size_t size, FAR off_t *offset,
                     FAR const IPTR char *format, ...) printf_like(4, 5);
 
+/****************************************************************************
+ * Name: procfs_snapshot_read
+ *
+ * Description:
+ *   Read a procfs file from a snapshot of its content.  The snapshot is
+ *   generated with 'render' when the file is read at position zero, or for
+ *   the first read, and is grown until the whole content fits.  All reads
+ *   of a sequence are served from the same snapshot, so the file content is
+ *   consistent and 'render' runs once per sequence instead of once per
+ *   read.
+ *
+ * Input Parameters:
+ *   snapshot - The snapshot of the open file
+ *   render   - Generates the content of the file
+ *   arg      - The argument of 'render'
+ *   buffer   - The user's receive buffer
+ *   buflen   - The size of the user's receive buffer
+ *   offset   - The file position
+ *
+ * Returned Value:
+ *   The number of bytes returned, or a negated errno value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PROCFS_SNAPSHOT
+ssize_t procfs_snapshot_read(FAR struct procfs_snapshot_s *snapshot,
+                             procfs_render_t render, FAR void *arg,
+                             FAR char *buffer, size_t buflen,
+                             off_t offset);
+
+/****************************************************************************
+ * Name: procfs_snapshot_free
+ *
+ * Description:
+ *   Release the snapshot of an open file.
+ *
+ ****************************************************************************/
+
+void procfs_snapshot_free(FAR struct procfs_snapshot_s *snapshot);
+#endif
+
 /****************************************************************************
  * Name: procfs_register
  *
@@ -0,0 +1,114 @@
+/****************************************************************************
+ * include/nuttx/futex.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FUTEX_H
+#define __INCLUDE_NUTTX_FUTEX_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef CONFIG_FUTEX
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: nxfutex_wait
+ *
+ * Description:
+ *   Atomically check that the 32-bit word at 'addr' still holds 'val' and,
+ *   if so, block the calling thread until nxfutex_wake() is called for the
+ *   same address, a signal is received or the timeout expires.  The check
+ *   and the wait are atomic with respect to nxfutex_wake().
+ *
+ *   The word itself is never modified.  Callers build their own protocol
+ *   on top of the word with atomic operations and only enter the kernel
+ *   when they must wait.  Wakeups may be spurious; the caller must always
+ *   recheck its condition.
+ *
+ * Input Parameters:
+ *   addr    - The address of the futex word
+ *   val     - The value the futex word is expected to hold
+ *   clockid - The clock used as the time base for 'abstime'
+ *   abstime - The absolute time of the timeout or NULL to wait forever
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the thread was woken by nxfutex_wake().  A
+ *   negated errno value is returned on failure:
+ *
+ *   -EAGAIN    - The futex word did not hold 'val'
+ *   -EINTR     - The wait was interrupted by a signal
+ *   -ETIMEDOUT - The timeout expired
+ *   -EINVAL    - 'addr' is NULL or misaligned
+ *   -EFAULT    - 'addr' is not in the user space of the calling process
+ *
+ ****************************************************************************/
+
+int nxfutex_wait(FAR volatile uint32_t *addr, uint32_t val,
+                 clockid_t clockid, FAR const struct timespec *abstime);
+
+/****************************************************************************
+ * Name: nxfutex_wake
+ *
+ * Description:
+ *   Wake up to 'nwake' threads waiting in nxfutex_wait() on 'addr'.
+ *
+ * Input Parameters:
+ *   addr  - The address of the futex word
+ *   nwake - The maximum number of threads to wake
+ *
+ * Returned Value:
+ *   The number of threads woken is returned on success.  A negated errno
+ *   value is returned on failure:
+ *
+ *   -EINVAL - 'addr' is NULL or misaligned
+ *   -EFAULT - 'addr' is not in the user space of the calling process
+ *
+ ****************************************************************************/
+
+int nxfutex_wake(FAR volatile uint32_t *addr, int nwake);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* CONFIG_FUTEX */
+#endif /* __INCLUDE_NUTTX_FUTEX_H */
@@ -27,10 +27,14 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/compiler.h>
 #include <nuttx/lib/math32.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/queue.h>
 
+#include <stddef.h>
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -82,6 +86,15 @@
 #define hashtable_for_every_possible_safe(table, item, temp, key) \
   sq_for_every_safe(&table[HASH(key, hashtable_bits(table))], item, temp)
 
+/* Iterate over the entries of a resizable hashtable with the given hash
+ * value.  The callback must compare the keys, different keys may have the
+ * same hash value.
+ */
+
+#define rhashtable_for_every_possible(table, item, hash) \
+  for ((item) = rhashtable_first(table, hash); (item) != NULL; \
+       (item) = rhashtable_next(item))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -99,4 +112,148 @@
 typedef dq_queue_t hash_head_t;
 typedef dq_entry_t hash_node_t;
 
+/* A resizable hashtable.  Unlike the fixed tables above, the bucket array
+ * grows and shrinks with the number of entries.  A resize moves a few
+ * buckets of the old array on each insertion or removal instead of moving
+ * all entries at once, so no single operation pays for the whole table.
+ * An entry keeps its hash value, which the table needs to move it.
+ *
+ * The table has no lock of its own, the users protect it with the lock of
+ * the data it indexes, as with the fixed tables.
+ */
+
+typedef struct rhash_node_s
+{
+  hash_node_t node;                /* Entry in the bucket */
+  uint32_t    hash;                /* The hash value of the key */
+} rhash_node_t;
+
+struct rhashtable_s
+{
+  FAR hash_head_t *buckets;        /* The bucket array */
+  FAR hash_head_t *old;            /* The array being moved by a resize */
+  uint32_t         mask;           /* The number of buckets minus one */
+  uint32_t         oldmask;        /* The same for the old array */
+  uint32_t         oldpos;         /* The next bucket of the old array */
+  uint32_t         minmask;        /* The initial mask, the table does not
+                                    * shrink below it */
+  uint32_t         seed;           /* The seed of rhashtable_hash() */
+  size_t           count;          /* The number of entries */
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rhashtable_hash
+ *
+ * Description:
+ *   Hash an integer key with the random seed of the table, so that the
+ *   distribution of the entries cannot be predicted from outside.  Keys
+ *   of variable length can be hashed with siphash() by the user and the
+ *   result passed as the hash value.
+ *
+ ****************************************************************************/
+
+static inline_function uint32_t
+rhashtable_hash(FAR const struct rhashtable_s *table, uint32_t key)
+{
+  uint32_t hash = key ^ table->seed;
+
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6b;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: rhashtable_init
+ *
+ * Description:
+ *   Initialize a resizable hashtable with 2^bits buckets and a random
+ *   seed.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int rhashtable_init(FAR struct rhashtable_s *table, unsigned int bits);
+
+/****************************************************************************
+ * Name: rhashtable_fini
+ *
+ * Description:
+ *   Free the bucket arrays of a table.  The entries are not touched.
+ *
+ ****************************************************************************/
+
+void rhashtable_fini(FAR struct rhashtable_s *table);
+
+/****************************************************************************
+ * Name: rhashtable_add
+ *
+ * Description:
+ *   Add an entry with the given hash value, which may start a resize.  A
+ *   table that cannot grow for lack of memory keeps working with longer
+ *   buckets.
+ *
+ ****************************************************************************/
+
+void rhashtable_add(FAR struct rhashtable_s *table, FAR rhash_node_t *node,
+                    uint32_t hash);
+
+/****************************************************************************
+ * Name: rhashtable_delete
+ *
+ * Description:
+ *   Remove an entry from the table.
+ *
+ ****************************************************************************/
+
+void rhashtable_delete(FAR struct rhashtable_s *table,
+                       FAR rhash_node_t *node);
+
+/****************************************************************************
+ * Name: rhashtable_first
+ *
+ * Description:
+ *   Return the first entry with the given hash value, NULL if none.
+ *
+ ****************************************************************************/
+
+FAR rhash_node_t *rhashtable_first(FAR struct rhashtable_s *table,
+                                   uint32_t hash);
+
+/****************************************************************************
+ * Name: rhashtable_next
+ *
+ * Description:
+ *   Return the next entry with the hash value of node, NULL if none.  The
+ *   node must still be in the table.
+ *
+ ****************************************************************************/
+
+FAR rhash_node_t *rhashtable_next(FAR rhash_node_t *node);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* __INCLUDE_NUTTX_HASHTABLE_H */
@@ -0,0 +1,220 @@
+/****************************************************************************
+ * include/nuttx/hrtimer.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_HRTIMER_H
+#define __INCLUDE_NUTTX_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/tree.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/wdog.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HRTIMER_ISACTIVE(h)   ((h)->func != NULL)
+
+/****************************************************************************
+ * Public Type Declarations
+ ****************************************************************************/
+
+/* A high resolution timer.  Unlike the watchdog timers, the expiration of
+ * a high resolution timer is kept in nanoseconds of CLOCK_MONOTONIC, and
+ * the timer is driven by its own alarm of the architecture instead of the
+ * system tick.  The expiration function has the form of a watchdog
+ * function, it is called from the interrupt level as well.
+ */
+
+struct hrtimer_s
+{
+  RB_ENTRY(hrtimer_s) node;      /* Supports the tree of active timers */
+  wdparm_t            arg;       /* Callback argument */
+  wdentry_t           func;      /* Function to execute when delay expires */
+  uint64_t            expired;   /* Absolute expiration time in nanoseconds */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   This function adds a high resolution timer to the active timer tree.
+ *   The specified function at 'func' will be called from the interrupt
+ *   level after the specified number of nanoseconds has elapsed.  High
+ *   resolution timers may be started from the interrupt level, from the
+ *   expiration function of the timer itself for example.
+ *
+ *   High resolution timers execute only once.  Calling hrtimer_start()
+ *   again on an active timer replaces its expiration time and function.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer
+ *   delay   - Delay in nanoseconds
+ *   func    - Function to call on timeout
+ *   arg     - Parameter to pass to func
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *hrtimer, uint64_t delay,
+                  wdentry_t func, wdparm_t arg);
+
+/****************************************************************************
+ * Name: hrtimer_start_absnsec
+ *
+ * Description:
+ *   This function is the same as hrtimer_start(), except that the timer
+ *   expires at an absolute time in nanoseconds of CLOCK_MONOTONIC.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer
+ *   nsec    - Absolute expiration time in nanoseconds
+ *   func    - Function to call on timeout
+ *   arg     - Parameter to pass to func
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_start_absnsec(FAR struct hrtimer_s *hrtimer, uint64_t nsec,
+                          wdentry_t func, wdparm_t arg);
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   This function cancels a currently running high resolution timer.  High
+ *   resolution timers may be cancelled from the interrupt level.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer to cancel
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success;  A negated errno value is returned to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *hrtimer);
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   This function returns the time remaining before the specified high
+ *   resolution timer expires.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer
+ *
+ * Returned Value:
+ *   The time in nanoseconds remaining until the timer expires.  Zero means
+ *   either that the timer is not active or that it has already expired.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(FAR struct hrtimer_s *hrtimer);
+
+/****************************************************************************
+ * Name: hrtimer_curtime
+ *
+ * Description:
+ *   Return the current time of CLOCK_MONOTONIC in nanoseconds, the time
+ *   base of the high resolution timers.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_curtime(void);
+
+/****************************************************************************
+ * Name: hrtimer_abstime2nsec
+ *
+ * Description:
+ *   Convert an absolute time of a clock to the time base of the high
+ *   resolution timers.  A time in the past is converted to the current
+ *   time.
+ *
+ * Input Parameters:
+ *   clockid - The clock of the absolute time
+ *   abstime - The absolute time to convert
+ *
+ * Returned Value:
+ *   The absolute time in nanoseconds of CLOCK_MONOTONIC.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_abstime2nsec(clockid_t clockid,
+                              FAR const struct timespec *abstime);
+
+/****************************************************************************
+ * Name: hrtimer_process
+ *
+ * Description:
+ *   Run the expiration functions of the high resolution timers that have
+ *   expired and start the alarm of the next one.  Called by the
+ *   architecture specific logic when the alarm started with
+ *   up_hrtimer_start() expires.
+ *
+ * Input Parameters:
+ *   nsec - The current time in nanoseconds
+ *
+ * Assumptions:
+ *   Called from the interrupt level.
+ *
+ ****************************************************************************/
+
+void hrtimer_process(uint64_t nsec);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __INCLUDE_NUTTX_HRTIMER_H */
@@ -34,6 +34,12 @@
 
 #include <nuttx/fs/ioctl.h>
 
+#ifdef CONFIG_I2C_ASYNC
+#  include <nuttx/queue.h>
+#  include <nuttx/spinlock.h>
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -270,6 +276,35 @@ struct i2c_transfer_s
   size_t msgc;                /* Number of messages in the array. */
 };
 
+#ifdef CONFIG_I2C_ASYNC
+/* An asynchronous I2C transfer as handled by i2c_transfer_async().  The
+ * request is owned by the caller until its callback runs.
+ */
+
+struct i2c_async_s;
+typedef CODE void (*i2c_async_callback_t)(FAR struct i2c_async_s *req,
+                                          int result);
+
+struct i2c_async_s
+{
+  sq_entry_t node;                /* Used internally */
+  FAR struct i2c_msg_s *msgs;     /* The messages of the transfer */
+  int count;                      /* Number of messages */
+  i2c_async_callback_t callback;  /* Called with the result when done */
+  FAR void *arg;                  /* For the use of the caller */
+};
+
+/* The queue of asynchronous transfers of one I2C bus */
+
+struct i2c_queue_s
+{
+  FAR struct i2c_master_s *i2c;   /* The I2C bus */
+  sq_queue_t pending;             /* Submitted requests, in order */
+  spinlock_t lock;                /* Protects pending */
+  struct work_s work;             /* Performs the requests */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -383,6 +418,47 @@ int i2c_read(FAR struct i2c_master_s *dev,
              FAR const struct i2c_config_s *config,
              FAR uint8_t *buffer, int buflen);
 
+#ifdef CONFIG_I2C_ASYNC
+
+/****************************************************************************
+ * Name: i2c_queue_initialize
+ *
+ * Description:
+ *   Initialize the queue of asynchronous transfers of an I2C bus.  All
+ *   users of i2c_transfer_async() on the bus should share one queue.
+ *
+ * Input Parameters:
+ *   queue - The queue to initialize
+ *   i2c   - An instance of the I2C interface to use for the transfers
+ *
+ ****************************************************************************/
+
+void i2c_queue_initialize(FAR struct i2c_queue_s *queue,
+                          FAR struct i2c_master_s *i2c);
+
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue an I2C transfer.  The queued transfers are performed back to back
+ *   by I2C_TRANSFER() on a work queue and req->callback is called with the
+ *   result of each.  This function does not block and may be called from an
+ *   interrupt handler.
+ *
+ * Input Parameters:
+ *   queue - The queue of the I2C bus
+ *   req   - The request, with msgs, count and callback set
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int i2c_transfer_async(FAR struct i2c_queue_s *queue,
+                       FAR struct i2c_async_s *req);
+
+#endif /* CONFIG_I2C_ASYNC */
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -32,6 +32,14 @@
 
 #include <stdint.h>
 
+#ifdef CONFIG_INITCALL_DEBUG
+#  include <nuttx/clock.h>
+#endif
+
+#ifdef CONFIG_INITCALL_ASYNC
+#  include <nuttx/semaphore.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -47,6 +55,23 @@
 #define OSINIT_IDLELOOP()        (g_nx_initstate >= OSINIT_IDLELOOP)
 #define OSINIT_OS_INITIALIZING() (g_nx_initstate  < OSINIT_OSREADY)
 
+/* Run one initialization call.  With CONFIG_INITCALL_DEBUG the time spent
+ * in the call is reported to the syslog, like initcall_debug of Linux.
+ */
+
+#ifdef CONFIG_INITCALL_DEBUG
+#  define INITCALL(call) \
+     do \
+       { \
+         clock_t __start = perf_gettime(); \
+         call; \
+         nx_initcall_report(#call, __start); \
+       } \
+     while (0)
+#else
+#  define INITCALL(call) call
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -75,6 +100,23 @@ enum nx_initstate_e
   OSINIT_PANIC     = 7   /* Fatal error happened. */
 };
 
+#ifdef CONFIG_INITCALL_ASYNC
+/* An initialization call run by nx_initcall_async() in a kernel thread of
+ * its own.  The structure must stay valid until the call has completed.
+ */
+
+struct initcall_s
+{
+  FAR struct initcall_s *flink;          /* Link in the list of calls */
+  FAR struct initcall_s *const *deps;    /* NULL terminated calls to wait for */
+  FAR const char *name;                  /* Name of the kernel thread */
+  CODE int (*func)(FAR void *arg);       /* The initialization function */
+  FAR void *arg;                         /* Its argument */
+  sem_t done;                            /* Posted when func() returned */
+  int result;                            /* The value func() returned */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -104,6 +146,77 @@ EXTERN volatile uint8_t g_nx_initstate;  /* See enum nx_initstate_e */
 
 void nx_start(void);
 
+/* Functions contained in nx_initcall.c *************************************/
+
+#ifdef CONFIG_INITCALL_DEBUG
+/****************************************************************************
+ * Name: nx_initcall_report
+ *
+ * Description:
+ *   Report the time spent in an initialization call, see INITCALL().
+ *
+ * Input Parameters:
+ *   name  - The name of the call
+ *   start - The perf_gettime() value when the call started
+ *
+ ****************************************************************************/
+
+void nx_initcall_report(FAR const char *name, clock_t start);
+#endif
+
+#ifdef CONFIG_INITCALL_ASYNC
+/****************************************************************************
+ * Name: nx_initcall_async
+ *
+ * Description:
+ *   Run an initialization call in a kernel thread, in parallel with the
+ *   rest of the boot.  Slow probes, of the flash or of a SD card for
+ *   example, then do not delay the independent ones.  The thread waits
+ *   for the calls in deps first.  The application is started only when
+ *   all the calls have completed.
+ *
+ * Input Parameters:
+ *   call - The call to run, initialized by this function
+ *   name - The name of the call
+ *   func - The initialization function
+ *   arg  - Its argument
+ *   deps - NULL terminated calls that must complete first, or NULL
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if the thread could not be
+ *   started.  The call then ran synchronously.
+ *
+ ****************************************************************************/
+
+int nx_initcall_async(FAR struct initcall_s *call, FAR const char *name,
+                      CODE int (*func)(FAR void *arg), FAR void *arg,
+                      FAR struct initcall_s *const *deps);
+
+/****************************************************************************
+ * Name: nx_initcall_wait
+ *
+ * Description:
+ *   Wait for an initialization call started by nx_initcall_async(), before
+ *   mounting the file system of the device it registers for example.
+ *
+ * Returned Value:
+ *   The value returned by the initialization function.
+ *
+ ****************************************************************************/
+
+int nx_initcall_wait(FAR struct initcall_s *call);
+
+/****************************************************************************
+ * Name: nx_initcall_wait_all
+ *
+ * Description:
+ *   Wait for all the initialization calls started by nx_initcall_async().
+ *
+ ****************************************************************************/
+
+void nx_initcall_wait_all(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #ifndef __ASSEMBLY__
+#  include <sys/types.h>
 #  include <stdint.h>
 #  include <stdbool.h>
 #endif
@@ -197,6 +198,52 @@ int irq_attach(int irq, xcpt_t isr, FAR void *arg);
 int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
                       int priority, int stack_size);
 
+/****************************************************************************
+ * Name: irq_attach_thread_shared
+ *
+ * Description:
+ *   Configure the IRQ subsystem so that IRQ number 'irq' is dispatched to
+ *   'isrthread' in the handler thread of 'owner', an IRQ attached by
+ *   irq_attach_thread() before.  The owner is detached after the IRQs
+ *   sharing its thread.
+ *
+ * Input Parameters:
+ *   irq - Irq num
+ *   isr - Function to be called when the IRQ occurs, called in interrupt
+ *   context.
+ *   If isr is NULL the default handler is installed(irq_default_handler).
+ *   isrthread - called in thread context
+ *   arg - privdate data
+ *   owner - Irq num owning the handler thread
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_attach_thread_shared(int irq, xcpt_t isr, xcpt_t isrthread,
+                             FAR void *arg, int owner);
+
+/****************************************************************************
+ * Name: irq_thread_affinity
+ *
+ * Description:
+ *   Bind the handler thread of a threaded IRQ, and the IRQs it serves, to
+ *   the CPUs of 'cpuset'.
+ *
+ * Input Parameters:
+ *   irq    - Irq num
+ *   cpuset - The CPUs to run on
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+int irq_thread_affinity(int irq, cpu_set_t cpuset);
+#endif
+
 /****************************************************************************
  * Name: irq_attach_wqueue
  *
@@ -71,6 +71,10 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#ifdef CONFIG_LIBM_FLOAT_FAST
+#include <stddef.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -255,6 +259,9 @@ long double powl  (long double b, long double e);
 #endif
 
 float       expf  (float x);
+#ifdef CONFIG_LIBM_FLOAT_FAST
+void        expf_v(FAR const float *x, FAR float *y, size_t n);
+#endif
 float       exp2f (float x);
 float       expm1f(float x);
 #ifdef CONFIG_HAVE_DOUBLE
@@ -402,6 +409,10 @@ long double frexpl(long double x, FAR int *exp);
 /* Trigonometric Functions **************************************************/
 
 void        sincosf(float, FAR float *, FAR float *);
+#ifdef CONFIG_LIBM_FLOAT_FAST
+void        sincosf_v(FAR const float *x, FAR float *s, FAR float *c,
+                      size_t n);
+#endif
 #ifdef CONFIG_HAVE_DOUBLE
 void        sincos(double, FAR double *, FAR double *);
 #endif
@@ -30,6 +30,8 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
+#include <time.h>
 #include <elf.h>
 
 #include <nuttx/addrenv.h>
@@ -169,6 +171,9 @@ struct module_s
   uint16_t nsect;                      /* Number of entries in sectalloc array */
 #endif
   int dynamic;                         /* Module is a dynamic shared object */
+#ifdef CONFIG_SYMTAB_HASHED
+  FAR struct symtab_hash_s *exphash;   /* Hash index of modinfo.exports */
+#endif
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MODULE)
   size_t textsize;                     /* Size of the kernel .text memory allocation */
   size_t datasize;                     /* Size of the kernel .bss/.data memory allocation */
@@ -251,6 +256,20 @@ struct mod_loadinfo_s
   FAR addrenv_t     *addrenv;    /* Address environment */
   FAR addrenv_t     *oldenv;     /* Saved address environment */
 #endif
+
+  /* Shared .text.
+   *
+   * textenv - The address environment that owns the .text pages mapped into
+   *   addrenv.  It is allocated when the image is loaded or, if textvalid,
+   *   holds the .text of an earlier load of the same file.
+   */
+
+#ifdef CONFIG_ELF_SHARED_TEXT
+  ino_t             fileino;     /* Serial number of the file */
+  struct timespec   filemtime;   /* Time of last modification of the file */
+  FAR addrenv_t     *textenv;    /* Owner of the .text pages */
+  bool              textvalid;   /* The .text of textenv is loaded */
+#endif
 };
 
 /****************************************************************************
@@ -57,6 +57,12 @@
 #  define CONFIG_IOB_THROTTLE 0
 #endif
 
+/* Per-CPU I/O buffer caches are disabled unless a cache size is given */
+
+#if !defined(CONFIG_IOB_PCPU_CACHE)
+#  define CONFIG_IOB_PCPU_CACHE 0
+#endif
+
 /* Some I/O buffers should be allocated */
 
 #if !defined(CONFIG_IOB_NBUFFERS)
@@ -168,6 +174,12 @@ struct iob_stats_s
   int nfree;
   int nwait;
   int nthrottle;
+  int npeak;                  /* Most buffers in use since the last reset */
+#if CONFIG_IOB_PCPU_CACHE > 0
+  int ncached;                /* Buffers held in the per-CPU caches */
+  unsigned long nhits;        /* Allocations served by a per-CPU cache */
+  unsigned long nmisses;      /* Allocations that had to refill a cache */
+#endif
 };
 
 /****************************************************************************
@@ -221,6 +233,28 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_multiple
+ *
+ * Description:
+ *   Try to allocate up to 'n' I/O buffers in a single critical section
+ *   without waiting for buffers to become free.  The buffers are returned
+ *   as separate, unchained I/O buffers.
+ *
+ * Input Parameters:
+ *   iobs      - The array that receives the allocated I/O buffers
+ *   n         - The number of I/O buffers requested
+ *   throttled - An indication of the IOB allocation is "throttled"
+ *
+ * Returned Value:
+ *   The number of I/O buffers actually allocated, zero if none is free.
+ *   With CONFIG_IOB_PCPU_CACHE, fewer than 'n' are only returned after the
+ *   caches of all CPUs were drained.
+ *
+ ****************************************************************************/
+
+int iob_alloc_multiple(FAR struct iob_s **iobs, int n, bool throttled);
+
 #ifdef CONFIG_IOB_ALLOC
 /****************************************************************************
  * Name: iob_alloc_dynamic
@@ -363,6 +397,17 @@ void iob_notifier_teardown(int key);
 
 void iob_free_chain(FAR struct iob_s *iob);
 
+/****************************************************************************
+ * Name: iob_free_chain_batch
+ *
+ * Description:
+ *   Free an entire buffer chain like iob_free_chain(), but return all of
+ *   the I/O buffers to the free list in a single critical section.
+ *
+ ****************************************************************************/
+
+void iob_free_chain_batch(FAR struct iob_s *iob);
+
 /****************************************************************************
  * Name: iob_add_queue
  *
@@ -486,6 +531,25 @@ int iob_copyin(FAR struct iob_s *iob, FAR const uint8_t *src,
 int iob_trycopyin(FAR struct iob_s *iob, FAR const uint8_t *src,
                   unsigned int len, int offset, bool throttled);
 
+/****************************************************************************
+ * Name: iob_copyin_chksum / iob_trycopyin_chksum
+ *
+ * Description:
+ *  Same as iob_copyin() / iob_trycopyin(), and accumulate the raw change
+ *  sum of the copied data into 'sum' in the same pass.  The 16-bit words of
+ *  the sum are paired from the first byte of 'src'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+int iob_copyin_chksum(FAR struct iob_s *iob, FAR const uint8_t *src,
+                      unsigned int len, int offset, bool throttled,
+                      FAR uint16_t *sum);
+int iob_trycopyin_chksum(FAR struct iob_s *iob, FAR const uint8_t *src,
+                         unsigned int len, int offset, bool throttled,
+                         FAR uint16_t *sum);
+#endif
+
 /****************************************************************************
  * Name: iob_copyout
  *
@@ -545,6 +609,23 @@ int iob_clone_partial(FAR struct iob_s *iob1, unsigned int len,
                       int offset1, FAR struct iob_s *iob2,
                       int offset2, bool throttled, bool block);
 
+/****************************************************************************
+ * Name: iob_clone_partial_chksum
+ *
+ * Description:
+ *   Same as iob_clone_partial(), and accumulate the raw change sum of the
+ *   copied data into 'sum' in the same pass.  The 16-bit words of the sum
+ *   are paired from 'offset1'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+int iob_clone_partial_chksum(FAR struct iob_s *iob1, unsigned int len,
+                             int offset1, FAR struct iob_s *iob2,
+                             int offset2, bool throttled, bool block,
+                             FAR uint16_t *sum);
+#endif
+
 /****************************************************************************
  * Name: iob_concat
  *
@@ -691,6 +772,17 @@ void iob_dump(FAR const char *msg, FAR struct iob_s *iob, unsigned int len,
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
     !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
 void iob_getstats(FAR struct iob_stats_s *stats);
+
+/****************************************************************************
+ * Name: iob_resetstats
+ *
+ * Description:
+ *   Restart the high-water mark of the IOB usage statistics at the current
+ *   usage, before a benchmark run for example.
+ *
+ ****************************************************************************/
+
+void iob_resetstats(void);
 #endif
 
 #endif /* CONFIG_MM_IOB */
@@ -45,6 +45,7 @@
 #  define kasan_start()
 #  define kasan_stop()
 #  define kasan_debugpoint(t,a,s) 0
+#  define kasan_region_enable(addr, enable) 0
 #  define kasan_init_early()
 #else
 
@@ -132,6 +133,25 @@ void kasan_register(FAR void *addr, FAR size_t *size);
 
 void kasan_unregister(FAR void *addr);
 
+/****************************************************************************
+ * Name: kasan_region_enable
+ *
+ * Description:
+ *   Enable or disable the access check of a monitored memory range.  The
+ *   range stays poisoned and unpoisoned while disabled, so the check can be
+ *   enabled again at any time.
+ *
+ * Input Parameters:
+ *   addr   - range start address, as passed to kasan_register()
+ *   enable - true to check the accesses to the range
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT if the range is not monitored.
+ *
+ ****************************************************************************/
+
+int kasan_region_enable(FAR const void *addr, bool enable);
+
 /****************************************************************************
  * Name: kasan_reset_tag
  *
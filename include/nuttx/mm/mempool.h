@@ -47,6 +47,11 @@
 #  define MEMPOOL_ALIGN       CONFIG_MM_DEFAULT_ALIGNMENT
 #endif
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+#  define MEMPOOL_HISTOGRAM_NBUCKETS \
+     (CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM_MAXSIZE / MEMPOOL_ALIGN + 1)
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 #  define MEMPOOL_REALBLOCKSIZE(pool) (ALIGN_UP((pool)->blocksize + \
                                        sizeof(struct mempool_backtrace_s), \
@@ -93,6 +98,43 @@ struct mempool_procfs_entry_s
 };
 #endif
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+/* This structure describes the allocation size histogram of a multiple
+ * mempool.  Bucket i counts the requests of up to (i + 1) * MEMPOOL_ALIGN
+ * bytes not counted by bucket i - 1, the last bucket counts all requests
+ * larger than CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM_MAXSIZE.
+ */
+
+struct mempool_histogram_s
+{
+  FAR const char *name;
+  FAR struct mempool_histogram_s *next;
+  unsigned int count[MEMPOOL_HISTOGRAM_NBUCKETS]; /* Requests by size */
+  unsigned int fallback;                          /* Requests not served */
+};
+#endif
+
+/* This structure describes one entry of a recorded allocation size
+ * histogram, entries are sorted by increasing size.
+ */
+
+struct mempool_profile_s
+{
+  size_t        size;       /* The request size */
+  unsigned long count;      /* The number of requests of this size */
+};
+
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+/* This structure describes the blocks a pool caches on one CPU */
+
+struct mempool_cache_s
+{
+  FAR sq_entry_t *head;     /* The cached free blocks */
+  size_t          count;    /* The number of cached blocks */
+  spinlock_t      lock;     /* Taken by the owner and by reclaiming CPUs */
+};
+#endif
+
 /* This structure describes memory buffer pool */
 
 struct mempool_s
@@ -116,6 +158,9 @@ struct mempool_s
   size_t     nalloc;  /* The number of used block in mempool */
   spinlock_t lock;    /* The protect lock to mempool */
   sem_t      waitsem; /* The semaphore of waiter get free block */
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+  struct mempool_cache_s cache[CONFIG_SMP_NCPUS]; /* The per-CPU caches */
+#endif
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
   struct mempool_procfs_entry_s procfs; /* The entry of procfs */
 #endif
@@ -309,6 +354,39 @@ void mempool_procfs_register(FAR struct mempool_procfs_entry_s *entry,
 void mempool_procfs_unregister(FAR struct mempool_procfs_entry_s *entry);
 #endif
 
+/****************************************************************************
+ * Name: mempool_procfs_register_histogram
+ *
+ * Description:
+ *   Add an allocation size histogram to the procfs file system.
+ *
+ * Input Parameters:
+ *   hist - The histogram to be registered.
+ *   name - The name of the multiple mempool.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+void mempool_procfs_register_histogram(FAR struct mempool_histogram_s *hist,
+                                       FAR const char *name);
+#endif
+
+/****************************************************************************
+ * Name: mempool_procfs_unregister_histogram
+ *
+ * Description:
+ *   Remove an allocation size histogram from the procfs file system.
+ *
+ * Input Parameters:
+ *   hist - The histogram to be unregistered.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+void
+mempool_procfs_unregister_histogram(FAR struct mempool_histogram_s *hist);
+#endif
+
 /****************************************************************************
  * Name: mempool_multiple_init
  *
@@ -527,6 +605,66 @@ struct mallinfo_task
 mempool_multiple_info_task(FAR struct mempool_multiple_s *mpool,
                            FAR const struct malltask *task);
 
+/****************************************************************************
+ * Name: mempool_multiple_profile
+ *
+ * Description:
+ *   Derive the block sizes of a multiple mempool from a recorded allocation
+ *   size histogram.  Request sizes are rounded up to MEMPOOL_ALIGN and the
+ *   requests larger than 'threshold' are ignored.  The block sizes are
+ *   chosen among the recorded sizes so that the memory wasted by rounding
+ *   every request up to its block size is minimal.
+ *
+ * Input Parameters:
+ *   profile   - The recorded histogram, sorted by increasing size.
+ *   nprofile  - The number of entries in the histogram.
+ *   threshold - The largest request size served by the pools.
+ *   poolsize  - The array that receives the derived block sizes.
+ *   npools    - The maximum number of block sizes to derive.
+ *   alloc     - The function used to allocate scratch memory.
+ *   free      - The function used to free the scratch memory.
+ *   arg       - The argument passed to alloc and free.
+ *
+ * Returned Value:
+ *   The number of block sizes stored in poolsize, sorted by increasing
+ *   size.  Zero is returned if the histogram is empty or unsorted, or if
+ *   no scratch memory is available.
+ *
+ ****************************************************************************/
+
+size_t mempool_multiple_profile(FAR const struct mempool_profile_s *profile,
+                                size_t nprofile, size_t threshold,
+                                FAR size_t *poolsize, size_t npools,
+                                mempool_multiple_alloc_t alloc,
+                                mempool_multiple_free_t free,
+                                FAR void *arg);
+
+/****************************************************************************
+ * Name: board_mempool_profile
+ *
+ * Description:
+ *   Return the recorded allocation size histogram used to derive the block
+ *   sizes of the heap mempool.  This function must be provided by the board
+ *   logic when CONFIG_MM_HEAP_MEMPOOL_PROFILE is selected.  It is called
+ *   while the heap is initialized, long before any file system is
+ *   available, so the histogram normally lives in a constant table
+ *   generated from the output of /proc/mempool.
+ *
+ * Input Parameters:
+ *   name    - The name of the heap.
+ *   profile - The location to return the histogram.
+ *
+ * Returned Value:
+ *   The number of entries in the histogram, zero to keep the default block
+ *   sizes for this heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_PROFILE
+size_t board_mempool_profile(FAR const char *name,
+                             FAR const struct mempool_profile_s **profile);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -176,6 +176,99 @@ struct mempool_init_s
   size_t            dict_expendsize;
 };
 
+#ifdef CONFIG_MM_TLSF_SUBPOOLS
+/* Statistics of one per-CPU pool of a TLSF heap */
+
+struct mm_subpoolinfo_s
+{
+  size_t arena;    /* The memory owned by the pool */
+  size_t uordblks; /* The memory in use */
+  size_t usmblks;  /* The maximum memory in use */
+  size_t nalloc;   /* The number of allocations served */
+  size_t nsteal;   /* Allocations served after another pool failed */
+  size_t nremote;  /* The number of frees queued by other CPUs */
+};
+#endif
+
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+/* The free chunks of a heap are counted in MM_FRAG_NBUCKETS size classes.
+ * Class 0 holds the chunks below 64 bytes, each following class covers
+ * four times the sizes of the previous one and the last class holds
+ * everything above.
+ */
+
+#  define MM_FRAG_NBUCKETS     8
+#  define MM_FRAG_BUCKET_SHIFT 6
+
+/* Fragmentation of the free memory of one heap */
+
+struct mm_fraginfo_s
+{
+  size_t free;                      /* The free memory */
+  size_t largest;                   /* The largest free chunk */
+  unsigned int index;               /* Free memory not in 'largest' (%) */
+  size_t nfree[MM_FRAG_NBUCKETS];   /* Free chunks in each size class */
+};
+#endif
+
+#ifdef CONFIG_MM_RECLAIM
+/* The cost of running a reclaim callback.  Cheaper callbacks run first. */
+
+#  define MM_RECLAIM_COST_LOW    0  /* Drop a cache, no I/O */
+#  define MM_RECLAIM_COST_MEDIUM 1  /* Walk a data structure */
+#  define MM_RECLAIM_COST_HIGH   2  /* Write data back to the media */
+
+/* A subsystem that caches memory it can give back, see
+ * mm_register_reclaim().  The callback returns the number of bytes it
+ * released.  If 'nonblock' is true it runs in the context of a failing
+ * allocation and must not block: it may only try to take its locks.
+ */
+
+typedef CODE size_t (*mm_reclaim_t)(FAR void *arg, bool nonblock);
+
+struct mm_reclaim_s
+{
+  FAR struct mm_reclaim_s *flink;
+  mm_reclaim_t reclaim;             /* Release as much memory as possible */
+  FAR void *arg;                    /* The argument of 'reclaim' */
+  uint8_t cost;                     /* See MM_RECLAIM_COST_* */
+};
+
+/* Reclaim statistics */
+
+struct mm_reclaiminfo_s
+{
+  unsigned long nasync;             /* Runs on the work queue */
+  unsigned long nsync;              /* Runs from a failing allocation */
+  unsigned long nrescued;           /* Allocations that succeeded after */
+  size_t released;                  /* Total bytes released */
+};
+#endif
+
+#ifdef CONFIG_MM_FREE_DELAYLIST_STATS
+/* Statistics of the delay list of one heap */
+
+struct mm_delayinfo_s
+{
+  unsigned long depth;     /* Chunks waiting on the list */
+  unsigned long maxdepth;  /* The largest number of waiting chunks */
+  unsigned long ndrain;    /* The number of drains */
+  unsigned long nfreed;    /* Chunks freed by the drains */
+  unsigned long maxtime;   /* The longest drain in microseconds */
+  unsigned long avgtime;   /* The average drain in microseconds */
+};
+#endif
+
+#ifdef CONFIG_MM_HEAP_TCACHE
+/* Statistics of the per-CPU small chunk cache of one heap */
+
+struct mm_tcacheinfo_s
+{
+  size_t hits;     /* Allocations served from the cache */
+  size_t misses;   /* Cacheable allocations that went to the heap */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -278,6 +371,11 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size) malloc_like1(2);
 
 void mm_free_delaylist(FAR struct mm_heap_s *heap);
 
+#ifdef CONFIG_MM_FREE_DELAYLIST_STATS
+void mm_delaylist_info(FAR struct mm_heap_s *heap,
+                       FAR struct mm_delayinfo_s *info);
+#endif
+
 /* Functions contained in kmm_malloc.c **************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -405,6 +503,36 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
 size_t mm_heapfree(FAR struct mm_heap_s *heap);
 size_t mm_heapfree_largest(FAR struct mm_heap_s *heap);
 
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+void mm_fraginfo(FAR struct mm_heap_s *heap,
+                 FAR struct mm_fraginfo_s *info);
+#endif
+
+/* Functions contained in mm_tlsf.c *****************************************/
+
+#ifdef CONFIG_MM_TLSF_SUBPOOLS
+void mm_subpool_info(FAR struct mm_heap_s *heap, int index,
+                     FAR struct mm_subpoolinfo_s *info);
+#endif
+
+/* Functions contained in mm_reclaim.c **************************************/
+
+#ifdef CONFIG_MM_RECLAIM
+void mm_register_reclaim(FAR struct mm_reclaim_s *entry);
+void mm_unregister_reclaim(FAR struct mm_reclaim_s *entry);
+void mm_reclaim(void);
+size_t mm_reclaim_sync(size_t size);
+void mm_reclaim_rescued(void);
+void mm_reclaim_info(FAR struct mm_reclaiminfo_s *info);
+#endif
+
+/* Functions contained in mm_tcache.c ***************************************/
+
+#ifdef CONFIG_MM_HEAP_TCACHE
+void mm_tcache_info(FAR struct mm_heap_s *heap,
+                    FAR struct mm_tcacheinfo_s *info);
+#endif
+
 /* Functions contained in kmm_mallinfo.c ************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -122,6 +122,9 @@ struct mqueue_inode_s
 #else
   uint16_t maxmsgsize;        /* Max size of message in message queue */
 #endif
+#ifdef CONFIG_MQ_FDPASS
+  bool fdpass;                /* The messages are file descriptors */
+#endif
 #ifndef CONFIG_DISABLE_MQUEUE_NOTIFICATION
   pid_t ntpid;                /* Notification: Receiving Task's PID */
   struct sigevent ntevent;    /* Notification description */
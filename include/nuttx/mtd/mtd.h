@@ -32,7 +32,10 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <errno.h>
+#include <string.h>
 
+#include <nuttx/compiler.h>
 #include <nuttx/fs/ioctl.h>
 
 /****************************************************************************
@@ -77,15 +80,30 @@
                                              *      erased state of the MTD cell */
 #define MTDIOC_ERASESECTORS _MTDIOC(0x000c) /* IN: Pointer to mtd_erase_s structure
                                              * OUT: None */
+#define MTDIOC_GETSTATS     _MTDIOC(0x000d) /* IN:  Pointer to write-able struct
+                                             *      mtd_stats_s in which to
+                                             *      receive the statistics
+                                             * OUT: Statistics of the MTD */
+#define MTDIOC_RESETSTATS   _MTDIOC(0x000e) /* IN:  None
+                                             * OUT: Statistics restarted */
 
 /* Macros to hide implementation */
 
+#ifdef CONFIG_MTD_STATISTICS
+#define MTD_ERASE(d,s,n)   mtd_stats_erase(d,s,n)
+#define MTD_BREAD(d,s,n,b) mtd_stats_bread(d,s,n,b)
+#define MTD_BWRITE(d,s,n,b)mtd_stats_bwrite(d,s,n,b)
+#define MTD_READ(d,s,n,b)  mtd_stats_read(d,s,n,b)
+#define MTD_WRITE(d,s,n,b) mtd_stats_write(d,s,n,b)
+#define MTD_IOCTL(d,c,a)   mtd_stats_ioctl(d,c,a)
+#else
 #define MTD_ERASE(d,s,n)   ((d)->erase   ? (d)->erase(d,s,n)    : (-ENOSYS))
 #define MTD_BREAD(d,s,n,b) ((d)->bread   ? (d)->bread(d,s,n,b)  : (-ENOSYS))
 #define MTD_BWRITE(d,s,n,b)((d)->bwrite  ? (d)->bwrite(d,s,n,b) : (-ENOSYS))
 #define MTD_READ(d,s,n,b)  ((d)->read    ? (d)->read(d,s,n,b)   : (-ENOSYS))
 #define MTD_WRITE(d,s,n,b) ((d)->write   ? (d)->write(d,s,n,b)  : (-ENOSYS))
 #define MTD_IOCTL(d,c,a)   ((d)->ioctl   ? (d)->ioctl(d,c,a)    : (-ENOSYS))
+#endif
 #define MTD_ISBAD(d,b)     ((d)->isbad   ? (d)->isbad(d,b)      : (-ENOSYS))
 #define MTD_MARKBAD(d,b)   ((d)->markbad ? (d)->markbad(d,b)    : (-ENOSYS))
 
@@ -150,6 +168,19 @@ struct mtd_erase_s
   uint32_t nblocks;     /* Number of blocks to be erased */
 };
 
+/* The statistics of an MTD returned by MTDIOC_GETSTATS.  Only successful
+ * operations are counted.
+ */
+
+struct mtd_stats_s
+{
+  uint32_t nerase;      /* Number of erase blocks erased */
+  uint32_t nbread;      /* Number of read/write blocks read */
+  uint32_t nbwrite;     /* Number of read/write blocks programmed */
+  uint64_t nread;       /* Number of bytes read with MTD_READ() */
+  uint64_t nwrite;      /* Number of bytes programmed with MTD_WRITE() */
+};
+
 /* This structure defines the interface to a simple memory technology device.
  * It will likely need to be extended in the future to support more complex
  * devices.
@@ -207,8 +238,138 @@ struct mtd_dev_s
   /* Name of this MTD device */
 
   FAR const char *name;
+
+#ifdef CONFIG_MTD_STATISTICS
+  /* Statistics of the accesses through the MTD_xxx() accessors */
+
+  struct mtd_stats_s stats;
+#endif
 };
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_STATISTICS
+static inline_function int mtd_stats_erase(FAR struct mtd_dev_s *dev,
+                                           off_t startblock, size_t nblocks)
+{
+  int ret = dev->erase ? dev->erase(dev, startblock, nblocks) : -ENOSYS;
+
+  if (ret >= 0)
+    {
+      dev->stats.nerase += nblocks;
+    }
+
+  return ret;
+}
+
+static inline_function ssize_t mtd_stats_bread(FAR struct mtd_dev_s *dev,
+                                               off_t startblock,
+                                               size_t nblocks,
+                                               FAR uint8_t *buffer)
+{
+  ssize_t ret = dev->bread ? dev->bread(dev, startblock, nblocks, buffer) :
+                             -ENOSYS;
+
+  if (ret > 0)
+    {
+      dev->stats.nbread += ret;
+    }
+
+  return ret;
+}
+
+static inline_function ssize_t mtd_stats_bwrite(FAR struct mtd_dev_s *dev,
+                                                off_t startblock,
+                                                size_t nblocks,
+                                                FAR const uint8_t *buffer)
+{
+  ssize_t ret = dev->bwrite ?
+                dev->bwrite(dev, startblock, nblocks, buffer) : -ENOSYS;
+
+  if (ret > 0)
+    {
+      dev->stats.nbwrite += ret;
+    }
+
+  return ret;
+}
+
+static inline_function ssize_t mtd_stats_read(FAR struct mtd_dev_s *dev,
+                                              off_t offset, size_t nbytes,
+                                              FAR uint8_t *buffer)
+{
+  ssize_t ret = dev->read ? dev->read(dev, offset, nbytes, buffer) :
+                            -ENOSYS;
+
+  if (ret > 0)
+    {
+      dev->stats.nread += ret;
+    }
+
+  return ret;
+}
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+static inline_function ssize_t mtd_stats_write(FAR struct mtd_dev_s *dev,
+                                               off_t offset, size_t nbytes,
+                                               FAR const uint8_t *buffer)
+{
+  ssize_t ret = dev->write ? dev->write(dev, offset, nbytes, buffer) :
+                             -ENOSYS;
+
+  if (ret > 0)
+    {
+      dev->stats.nwrite += ret;
+    }
+
+  return ret;
+}
+#endif
+
+static inline_function int mtd_stats_ioctl(FAR struct mtd_dev_s *dev,
+                                           int cmd, unsigned long arg)
+{
+  int ret;
+
+  /* The statistics are kept here, above the driver */
+
+  if (cmd == MTDIOC_GETSTATS)
+    {
+      *(FAR struct mtd_stats_s *)((uintptr_t)arg) = dev->stats;
+      return OK;
+    }
+  else if (cmd == MTDIOC_RESETSTATS)
+    {
+      memset(&dev->stats, 0, sizeof(dev->stats));
+      return OK;
+    }
+
+  ret = dev->ioctl ? dev->ioctl(dev, cmd, arg) : -ENOSYS;
+  if (ret >= 0)
+    {
+      if (cmd == MTDIOC_ERASESECTORS)
+        {
+          dev->stats.nerase += ((FAR struct mtd_erase_s *)
+                                ((uintptr_t)arg))->nblocks;
+        }
+      else if (cmd == MTDIOC_BULKERASE)
+        {
+          struct mtd_geometry_s geo;
+
+          if (dev->ioctl(dev, MTDIOC_GEOMETRY,
+                         (unsigned long)((uintptr_t)&geo)) >= 0)
+            {
+              dev->stats.nerase += geo.neraseblocks;
+            }
+        }
+    }
+
+  return ret;
+}
+#endif /* CONFIG_MTD_STATISTICS */
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
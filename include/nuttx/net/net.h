@@ -137,10 +137,11 @@ typedef uint8_t sockcaps_t;
  * a given address family.
  */
 
-struct file;    /* Forward reference */
-struct stat;    /* Forward reference */
-struct socket;  /* Forward reference */
-struct pollfd;  /* Forward reference */
+struct file;           /* Forward reference */
+struct stat;           /* Forward reference */
+struct socket;         /* Forward reference */
+struct pollfd;         /* Forward reference */
+struct mm_map_entry_s; /* Forward reference */
 
 struct sock_intf_s
 {
@@ -180,6 +181,21 @@ struct sock_intf_s
   CODE ssize_t    (*si_sendfile)(FAR struct socket *psock,
                     FAR struct file *infile, FAR off_t *offset,
                     size_t count);
+#endif
+  CODE int        (*si_sendmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
+  CODE int        (*si_recvmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags, FAR struct timespec *timeout);
+#ifdef CONFIG_NET_RECVIOB
+  CODE ssize_t    (*si_recviob)(FAR struct socket *psock,
+                    FAR struct iob_s **iob, int flags,
+                    FAR struct sockaddr *from, FAR socklen_t *fromlen);
+#endif
+#ifdef CONFIG_NET_SOCKET_MMAP
+  CODE int        (*si_mmap)(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map);
 #endif
 };
 
@@ -206,6 +222,14 @@ struct socket_conn_s
   FAR struct devif_callback_s *list;
   FAR struct devif_callback_s *list_tail;
 
+#ifdef CONFIG_NET_CONN_LOCK
+  /* Protects the connection data (such as the read-ahead queue) that may be
+   * accessed without holding the network lock.
+   */
+
+  rmutex_t      s_lock;
+#endif
+
   /* Socket options */
 
 #ifdef CONFIG_NET_SOCKOPTS
@@ -380,6 +404,63 @@ int net_trylock(void);
 
 void net_unlock(void);
 
+/****************************************************************************
+ * Name: conn_lock
+ *
+ * Description:
+ *   Take the lock of a socket connection.  The network lock may or may not
+ *   be held, but net_lock() must not be called with the connection lock
+ *   held.
+ *
+ * Input Parameters:
+ *   sconn - The common prologue of the connection to be locked
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CONN_LOCK
+void conn_lock(FAR struct socket_conn_s *sconn);
+#else
+#  define conn_lock(s)
+#endif
+
+/****************************************************************************
+ * Name: conn_unlock
+ *
+ * Description:
+ *   Release the lock of a socket connection.
+ *
+ * Input Parameters:
+ *   sconn - The common prologue of the connection to be unlocked
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CONN_LOCK
+void conn_unlock(FAR struct socket_conn_s *sconn);
+#else
+#  define conn_unlock(s)
+#endif
+
+/****************************************************************************
+ * Name: conn_lock_init
+ *
+ * Description:
+ *   Initialize the lock of a socket connection.  Must be called each time
+ *   the connection is (re-)allocated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CONN_LOCK
+#  define conn_lock_init(s) nxrmutex_init(&(s)->s_lock)
+#else
+#  define conn_lock_init(s)
+#endif
+
 /****************************************************************************
  * Name: net_sem_timedwait
  *
@@ -928,6 +1009,97 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends a batch of messages on a socket.  It is the
+ *   internal OS interface of sendmmsg(), see psock_sendmsg() for the
+ *   differences.  The address family handles the whole batch at once if it
+ *   provides si_sendmmsg(), otherwise the messages are sent one at a time
+ *   with psock_sendmsg().
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to send, msg_len is set to the bytes sent
+ *   vlen      The number of messages in msgvec
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent, which is less than vlen if an error
+ *   occurred after at least one message was sent.  A negated errno value
+ *   is returned if the first message could not be sent.
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives a batch of messages from a socket.  It is the
+ *   internal OS interface of recvmmsg(), see psock_recvmsg() for the
+ *   differences.  The address family handles the whole batch at once if it
+ *   provides si_recvmmsg(), otherwise the messages are received one at a
+ *   time with psock_recvmsg().
+ *
+ *   With MSG_WAITFORONE only the first message may block.  The timeout,
+ *   if not NULL, is checked after each received message as on Linux.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to receive, msg_len is set to the bytes received
+ *   vlen      The number of messages in msgvec
+ *   flags     Receive flags
+ *   timeout   The time after which no further message is received or NULL
+ *
+ * Returned Value:
+ *   The number of messages received, which is less than vlen if an error
+ *   occurred after at least one message was received.  A negated errno
+ *   value is returned if no message was received.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout);
+
+/****************************************************************************
+ * Name: psock_recviob
+ *
+ * Description:
+ *   psock_recviob() receives data from a socket without copying it.  The
+ *   I/O buffer chain that holds the data is handed over to the caller,
+ *   which owns it afterwards and must release it with iob_free_chain().
+ *
+ *   A stream socket hands over all of the data buffered so far, a datagram
+ *   socket hands over one datagram.  This is intended for in-kernel
+ *   consumers, like protocol bridges, that would otherwise copy the data
+ *   out of the I/O buffers only to put it into new ones.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   iob       The location to return the I/O buffer chain in
+ *   flags     Receive flags, MSG_PEEK is not supported
+ *   from      Address of source of a datagram (may be NULL)
+ *   fromlen   The length of the address structure
+ *
+ * Returned Value:
+ *   The number of bytes in the returned I/O buffer chain.  Zero is
+ *   returned with no chain when the peer has performed an orderly
+ *   shutdown.  Otherwise a negated errno value is returned, -EOPNOTSUPP if
+ *   the socket does not support this operation.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECVIOB
+ssize_t psock_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                      int flags, FAR struct sockaddr *from,
+                      FAR socklen_t *fromlen);
+#endif
+
 /****************************************************************************
  * Name: psock_send
  *
@@ -75,6 +75,10 @@
 #  include <nuttx/wqueue.h>
 #endif
 
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NET_STATISTICS_PERCPU)
+#  include <nuttx/sched.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -102,21 +106,35 @@
 /* Helper macros for network device statistics */
 
 #ifdef CONFIG_NETDEV_STATISTICS
-#  define NETDEV_RESET_STATISTICS(dev) \
-     memset(&(dev)->d_statistics, 0, sizeof(struct netdev_statistics_s))
+#  ifdef CONFIG_NET_STATISTICS_PERCPU
+#    define _NETDEV_STATS(dev) ((dev)->d_statistics_cpu[this_cpu()].stats)
+#    define NETDEV_RESET_STATISTICS(dev) \
+       do \
+         { \
+           memset(&(dev)->d_statistics, 0, \
+                  sizeof(struct netdev_statistics_s)); \
+           memset((dev)->d_statistics_cpu, 0, \
+                  sizeof((dev)->d_statistics_cpu)); \
+         } \
+       while (0)
+#  else
+#    define _NETDEV_STATS(dev) ((dev)->d_statistics)
+#    define NETDEV_RESET_STATISTICS(dev) \
+       memset(&(dev)->d_statistics, 0, sizeof(struct netdev_statistics_s))
+#  endif
 
-#  define _NETDEV_STATISTIC(dev,name) ((dev)->d_statistics.name++)
+#  define _NETDEV_STATISTIC(dev,name) (_NETDEV_STATS(dev).name++)
 #  define _NETDEV_ERROR(dev,name) \
      do \
        { \
-         (dev)->d_statistics.name++; \
-         (dev)->d_statistics.errors++; \
+         _NETDEV_STATS(dev).name++; \
+         _NETDEV_STATS(dev).errors++; \
        } \
      while (0)
 
 #define _NETDEV_BYTES(dev,name) \
     do { \
-        (dev)->d_statistics.name += (dev)->d_len; \
+        _NETDEV_STATS(dev).name += (dev)->d_len; \
     } while (0)
 
 #  if CONFIG_NETDEV_STATISTICS_LOG_PERIOD > 0
@@ -192,6 +210,48 @@
 #  define NETDEV_ERRORS(dev)
 #endif
 
+/* Hardware offload features advertised by the driver in d_features */
+
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+#  define NETDEV_FEATURE_TXCSUM   (1 << 0) /* Fills in TCP/UDP checksums */
+#  define NETDEV_FEATURE_RXCSUM   (1 << 1) /* Verifies TCP/UDP checksums */
+
+#  define NETDEV_TXCSUM(dev)      (((dev)->d_features & \
+                                    NETDEV_FEATURE_TXCSUM) != 0)
+#  define NETDEV_RXCSUM_OK(dev)   ((dev)->d_rxcsumok)
+#  define NETDEV_RXCSUM_SET(dev,ok) \
+     do { (dev)->d_rxcsumok = (ok); } while (0)
+#else
+#  define NETDEV_TXCSUM(dev)      false
+#  define NETDEV_RXCSUM_OK(dev)   false
+#  define NETDEV_RXCSUM_SET(dev,ok)
+#endif
+
+/* Record or drop the checksum of the application data accumulated while
+ * it was copied into d_iob.
+ */
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+#  define NETDEV_SNDSUM_SET(dev,sum,len) \
+     do { (dev)->d_sndsum = (sum); (dev)->d_sndsumlen = (len); } while (0)
+#  define NETDEV_SNDSUM_CLEAR(dev) \
+     do { (dev)->d_sndsumlen = 0; } while (0)
+#else
+#  define NETDEV_SNDSUM_SET(dev,sum,len)
+#  define NETDEV_SNDSUM_CLEAR(dev)
+#endif
+
+/* Number of TCP segments merged into the packet that is being processed,
+ * zero if it was not merged.
+ */
+
+#ifdef CONFIG_NETDEV_GRO
+#  define NETDEV_GRO_SEGS(dev)    ((dev)->d_gro.iob == NULL ? \
+                                   (dev)->d_gro.nsegs : 0)
+#else
+#  define NETDEV_GRO_SEGS(dev)    0
+#endif
+
 /* There are some helper pointers for accessing the contents of the IP
  * headers
  */
@@ -220,6 +280,26 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_NETDEV_DEMUX_CACHE
+/* The connection that the last packet of one protocol received on a device
+ * was delivered to, together with the addresses and ports of the packet.
+ * It is only valid as long as the connections of the protocol have not
+ * changed since, which is tracked by a generation count.
+ */
+
+struct netdev_demux_s
+{
+  FAR void *conn;         /* The connection found last, NULL if none */
+  uint32_t  gen;          /* The generation of the connections then */
+  uint16_t  lport;        /* The destination port of the packet */
+  uint16_t  rport;        /* The source port of the packet */
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  bool      ipv6;         /* The packet was an IPv6 packet */
+#endif
+  union ip_binding_u u;   /* The destination and source address */
+};
+#endif
+
 #ifdef CONFIG_NETDEV_STATISTICS
 /* If CONFIG_NETDEV_STATISTICS is enabled and if the driver supports
  * statistics, then this structure holds the counts of network driver
@@ -261,6 +341,15 @@ struct netdev_statistics_s
   struct work_s logwork;   /* For periodic log work */
 #endif
 };
+
+#ifdef CONFIG_NET_STATISTICS_PERCPU
+/* The counts of one CPU, in cache lines of its own */
+
+struct aligned_data(CONFIG_NET_STATISTICS_ALIGN) netdev_statistics_cpu_s
+{
+  struct netdev_statistics_s stats;
+};
+#endif
 #endif
 
 #if defined(CONFIG_NET_6LOWPAN) || defined(CONFIG_NET_BLUETOOTH) || \
@@ -293,11 +382,25 @@ struct netdev_ifaddr6_s
 #ifdef CONFIG_NETDEV_RSS
 struct netdev_rss_s
 {
-  int      cpu;  /* CPU ID */
-  uint32_t hash; /* Hash value with packet */
+  int      cpu;   /* CPU ID */
+  uint32_t hash;  /* Hash value with packet */
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  int      queue; /* Queue served on that CPU, filled by the upper half */
+#endif
 };
 #endif // CONFIG_NETDEV_RSS
 
+#ifdef CONFIG_NETDEV_GRO
+/* The TCP segment held back by the receive offload, see netdev_gro_input */
+
+struct netdev_gro_s
+{
+  FAR struct iob_s *iob;  /* The held segment with the merged payload */
+  uint16_t mss;           /* Payload size of the first merged segment */
+  uint8_t  nsegs;         /* Number of segments merged into the packet */
+};
+#endif
+
 /* This structure collects information that is specific to a specific network
  * interface driver.  If the hardware platform supports only a single
  * instance of this structure.
@@ -338,6 +441,9 @@ struct net_driver_s
 #endif
 
   uint16_t d_pktsize;           /* Maximum packet size */
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+  uint8_t d_features;           /* See NETDEV_FEATURE_* definitions */
+#endif
 
   /* Link layer address */
 
@@ -474,6 +580,34 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NET_CHKSUM_COPY
+  /* The raw change sum of the d_sndlen bytes of application data,
+   * accumulated while the data was copied into d_iob.  d_sndsumlen is the
+   * number of bytes covered by d_sndsum and is only trusted while it
+   * matches d_sndlen.  Any change of d_iob invalidates it.
+   */
+
+  uint16_t d_sndsum;
+  uint16_t d_sndsumlen;
+#endif
+
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+  /* Set by the driver when the hardware has already verified the L4
+   * checksum of the packet that is being passed to the network input
+   * function.  Cleared again once the packet has been processed.
+   */
+
+  bool d_rxcsumok;
+#endif
+
+#ifdef CONFIG_NETDEV_GRO
+  /* TCP segment held back for merging with the next segments of the same
+   * flow received in one batch.
+   */
+
+  struct netdev_gro_s d_gro;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -490,6 +624,14 @@ struct net_driver_s
    */
 
   struct netdev_statistics_s d_statistics;
+
+#ifdef CONFIG_NET_STATISTICS_PERCPU
+  /* The counts of the network stack are kept per CPU and summed up with
+   * d_statistics by netdev_statistics_get().
+   */
+
+  struct netdev_statistics_cpu_s d_statistics_cpu[CONFIG_SMP_NCPUS];
+#endif
 #endif
 
 #if defined(CONFIG_NET_TIMESTAMP)
@@ -528,6 +670,19 @@ struct net_driver_s
   FAR struct devif_callback_s *d_conncb_tail; /* This is the list tail */
   FAR struct devif_callback_s *d_devcb;
 
+#ifdef CONFIG_NETDEV_DEMUX_CACHE
+  /* The connections the last packets were delivered to, see tcp_active()
+   * and udp_active().
+   */
+
+#  ifdef CONFIG_NET_TCP
+  struct netdev_demux_s d_tcpdemux;
+#  endif
+#  ifdef CONFIG_NET_UDP
+  struct netdev_demux_s d_udpdemux;
+#  endif
+#endif
+
   /* Driver callbacks */
 
   CODE int (*d_ifup)(FAR struct net_driver_s *dev);
@@ -810,6 +965,33 @@ void netdev_carrier_off(FAR struct net_driver_s *dev);
 
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
 
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy 'len' bytes from 'src' to 'dest' and accumulate the raw change
+ *   sum of the copied data in the same pass, so that the data is only
+ *   touched once.
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call, zero
+ *          on the first call.
+ *   dest - The destination of the copy.
+ *   src  - The data to copy and to include in the checksum.
+ *   len  - Length of the data.
+ *   odd  - Whether the previous call ended in the middle of a 16-bit
+ *          word, updated on return.  Should be false on the first call.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dest,
+                     FAR const uint8_t *src, uint16_t len, FAR bool *odd);
+#endif
+
 /****************************************************************************
  * Name: chksum_iob
  *
@@ -1202,6 +1384,50 @@ void netdev_iob_release(FAR struct net_driver_s *dev);
 FAR struct iob_s *netdev_iob_clone(FAR struct net_driver_s *dev,
                                    bool throttled);
 
+/****************************************************************************
+ * Name: netdev_gro_input
+ *
+ * Description:
+ *   Generic receive offload.  Hold the received Ethernet frame in d_iob if
+ *   it is an in-order TCP data segment for this host, merging it into the
+ *   segment already held when both belong to the same flow.  Any other
+ *   frame flushes the held segment and is given to 'input' directly.
+ *   The driver must call netdev_gro_flush() at the end of each receive
+ *   batch.
+ *
+ * Input Parameters:
+ *   dev   - The network device, d_iob holds the received frame
+ *   input - The link layer input function of the driver
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+void netdev_gro_input(FAR struct net_driver_s *dev,
+                      CODE void (*input)(FAR struct net_driver_s *dev));
+
+/****************************************************************************
+ * Name: netdev_gro_flush
+ *
+ * Description:
+ *   Give the segment held by netdev_gro_input() to 'input'.  The frame
+ *   in d_iob, if any, is preserved.
+ *
+ * Input Parameters:
+ *   dev   - The network device
+ *   input - The link layer input function of the driver
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+void netdev_gro_flush(FAR struct net_driver_s *dev,
+                      CODE void (*input)(FAR struct net_driver_s *dev));
+#endif
+
 /****************************************************************************
  * Name: netdev_ipv6_add/del
  *
@@ -1347,4 +1573,21 @@ int netdev_ipv6_foreach(FAR struct net_driver_s *dev,
 void netdev_statistics_log(FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: netdev_statistics_get
+ *
+ * Description:
+ *   Return the statistics of a network device summed up over all CPUs.
+ *
+ * Input Parameters:
+ *   dev   - The network device
+ *   stats - The location to return the statistics in
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_STATISTICS
+void netdev_statistics_get(FAR struct net_driver_s *dev,
+                           FAR struct netdev_statistics_s *stats);
+#endif
+
 #endif /* __INCLUDE_NUTTX_NET_NETDEV_H */
@@ -119,6 +119,15 @@ struct netdev_lowerhalf_s
 
   atomic_int quota[NETPKT_TYPENUM];
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Number of RX/TX queue pairs, set before registering, up to one per
+   * CPU.  Zero or one means a single queue and the receive / transmit
+   * operations are used, otherwise receive_queue / transmit_queue.
+   */
+
+  uint8_t nqueues;
+#endif
+
   /* The structure used by net stack.
    * Note: Do not change its fields unless you know what you are doing.
    *
@@ -172,6 +181,41 @@ struct netdev_ops_s
   /* reclaim - try to reclaim packets sent by netdev. */
 
   CODE void (*reclaim)(FAR struct netdev_lowerhalf_s *dev);
+
+#ifdef CONFIG_NETDEV_NAPI
+  /* rxint - Mask (enable false) or unmask the RX interrupt of a queue, zero
+   *   for a single queue device.  Called from netdev_lower_rxready() in
+   *   interrupt context too.  Unmasking must raise the interrupt if
+   *   packets are already pending.
+   * rxcoalesce - Delay the RX interrupt by up to usecs microseconds to
+   *   batch packets, zero for no delay.
+   */
+
+  CODE void (*rxint)(FAR struct netdev_lowerhalf_s *dev,
+                     unsigned int queue, bool enable);
+  CODE void (*rxcoalesce)(FAR struct netdev_lowerhalf_s *dev,
+                          unsigned int usecs);
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* transmit_queue / receive_queue - Like transmit / receive, but on one
+   *   of the nqueues queues of a multi-queue device.  A queue is only
+   *   served by its own work thread.
+   */
+
+  CODE int (*transmit_queue)(FAR struct netdev_lowerhalf_s *dev,
+                             FAR netpkt_t *pkt, unsigned int queue);
+  CODE FAR netpkt_t *(*receive_queue)(FAR struct netdev_lowerhalf_s *dev,
+                                      unsigned int queue);
+#endif
+
+  /* txflush - Optional, called after each burst of transmit calls on a
+   *   queue, zero for a single queue device.  The driver may notify the
+   *   hardware once here instead of once per packet.
+   */
+
+  CODE void (*txflush)(FAR struct netdev_lowerhalf_s *dev,
+                       unsigned int queue);
 };
 
 /* This structure is a set of wireless handlers, leave unsupported operations
@@ -308,6 +352,63 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet is ready to read on
+ *   one queue of a multi-queue device.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue that received the packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                unsigned int queue);
+#endif
+
+/****************************************************************************
+ * Name: netdev_lower_txdone_queue
+ *
+ * Description:
+ *   Notifies the networking layer about a TX packet is sent on one queue
+ *   of a multi-queue device.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue that sent the packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev,
+                               unsigned int queue);
+#endif
+
+/****************************************************************************
+ * Name: netdev_lower_cpu_queue
+ *
+ * Description:
+ *   Get the queue whose work thread runs on a CPU, e.g. to steer the flows
+ *   consumed on that CPU to it.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   cpu - The CPU of interest
+ *
+ * Returned Value:
+ *   The queue that is served on the CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+unsigned int netdev_lower_cpu_queue(FAR struct netdev_lowerhalf_s *dev,
+                                    int cpu);
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_quota_load
  *
@@ -341,6 +442,28 @@ int netdev_lower_quota_load(FAR struct netdev_lowerhalf_s *dev,
 FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
                            enum netpkt_type_e type);
 
+/****************************************************************************
+ * Name: netpkt_alloc_multiple
+ *
+ * Description:
+ *   Allocate up to 'n' netpkt structures at once, used to refill RX rings
+ *   without paying the quota and IOB pool overhead for every packet.
+ *
+ * Input Parameters:
+ *   dev  - The lower half device driver structure
+ *   type - Whether used for TX or RX
+ *   pkts - The array that receives the packets
+ *   n    - The number of packets requested
+ *
+ * Returned Value:
+ *   The number of packets actually allocated
+ *
+ ****************************************************************************/
+
+int netpkt_alloc_multiple(FAR struct netdev_lowerhalf_s *dev,
+                          enum netpkt_type_e type, FAR netpkt_t **pkts,
+                          int n);
+
 /****************************************************************************
  * Name: netpkt_free
  *
@@ -510,6 +633,36 @@ bool netpkt_is_fragmented(FAR netpkt_t *pkt);
 int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
                   FAR struct iovec *iov, int iovcnt);
 
+/****************************************************************************
+ * Name: netpkt_csum_partial
+ *
+ * Description:
+ *   Prepare a TX packet for hardware TCP/UDP checksum offload.  Drivers
+ *   that set NETDEV_FEATURE_TXCSUM in d_features must call this for each
+ *   packet they transmit: the network stack leaves the L4 checksum of its
+ *   own packets for the hardware.  On success the checksum field holds the
+ *   pseudo-header sum and the hardware must add the sum of the bytes from
+ *   'start' to the end of the frame and store the result at
+ *   'start' + 'offset'.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *   start  - Returns the offset of the L4 header in the frame
+ *   offset - Returns the offset of the checksum field in the L4 header
+ *
+ * Returned Value:
+ *   OK if the hardware has to fill in the checksum, -ENOTSUP if the packet
+ *   must be sent as is.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+int netpkt_csum_partial(FAR struct netdev_lowerhalf_s *dev,
+                        FAR netpkt_t *pkt, FAR uint16_t *start,
+                        FAR uint16_t *offset);
+#endif
+
 /****************************************************************************
  * Name: netpkt_tryadd_queue
  *
@@ -45,6 +45,7 @@
 
 #include <stdint.h>
 
+#include <nuttx/compiler.h>
 #include <nuttx/net/netconfig.h>
 
 #include <nuttx/net/ip.h>
@@ -67,12 +68,25 @@
 #  include <nuttx/net/mld.h>
 #endif
 
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_STATISTICS_PERCPU)
+#  include <nuttx/sched.h>
+#endif
+
 #ifdef CONFIG_NET_STATISTICS
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* The statistics are updated through g_netstats, which is the copy of the
+ * running CPU if there is one copy per CPU.  Use net_stats_get() to read
+ * them.
+ */
+
+#ifdef CONFIG_NET_STATISTICS_PERCPU
+#  define g_netstats (g_netstats_cpu[this_cpu()].stats)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -116,17 +130,43 @@ struct net_stats_s
 #endif
 };
 
+#ifdef CONFIG_NET_STATISTICS_PERCPU
+/* The statistics counted by one CPU, in cache lines of its own */
+
+struct aligned_data(CONFIG_NET_STATISTICS_ALIGN) net_stats_cpu_s
+{
+  struct net_stats_s stats;
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
 /* This is the structure in which the statistics are gathered. */
 
+#ifdef CONFIG_NET_STATISTICS_PERCPU
+extern struct net_stats_cpu_s g_netstats_cpu[CONFIG_SMP_NCPUS];
+#else
 extern struct net_stats_s g_netstats;
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: net_stats_get
+ *
+ * Description:
+ *   Return the network layer statistics summed up over all CPUs.
+ *
+ * Input Parameters:
+ *   stats - The location to return the statistics in
+ *
+ ****************************************************************************/
+
+void net_stats_get(FAR struct net_stats_s *stats);
+
 #endif /* CONFIG_NET_STATISTICS */
 #endif /* __INCLUDE_NUTTX_NET_NETSTATS_H */
@@ -196,6 +196,10 @@ struct tcp_stats_s
   net_stats_t syndrop;    /* Number of dropped SYNs due to too few
                            * available connections */
   net_stats_t synrst;     /* Number of SYNs for closed ports triggering a RST */
+#ifdef CONFIG_NETDEV_DEMUX_CACHE
+  net_stats_t demuxhit;   /* Number of segments found in the demux cache */
+  net_stats_t demuxmiss;  /* Number of segments not found in the cache */
+#endif
 };
 #endif
 
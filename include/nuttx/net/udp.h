@@ -89,6 +89,10 @@ struct udp_stats_s
   net_stats_t recv;         /* Number of received UDP segments */
   net_stats_t sent;         /* Number of sent UDP segments */
   net_stats_t chkerr;       /* Number of UDP segments with a bad checksum */
+#ifdef CONFIG_NETDEV_DEMUX_CACHE
+  net_stats_t demuxhit;     /* Number of datagrams found in the demux cache */
+  net_stats_t demuxmiss;    /* Number of datagrams not found in the cache */
+#endif
 };
 #endif
 
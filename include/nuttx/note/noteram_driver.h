@@ -113,6 +113,18 @@ int noteram_register(void);
 
 FAR struct note_driver_s *
 noteram_initialize(FAR const char *devpath, size_t bufsize, bool overwrite);
+
+/****************************************************************************
+ * Name: noteram_freeze
+ *
+ * Description:
+ *   Stop recording into the circular buffer of a RAM note driver to keep
+ *   the notes that led to an event of interest.  Recording restarts when
+ *   the buffer is cleared or the overwrite mode is set again.
+ *
+ ****************************************************************************/
+
+void noteram_freeze(FAR struct noteram_driver_s *drv);
 #endif
 
 #endif /* defined(__KERNEL__) || defined(CONFIG_BUILD_FLAT) */
@@ -507,6 +507,46 @@ void nxgl_circletraps(FAR const struct nxgl_point_s *center,
 uint32_t nxglib_rgb24_blend(uint32_t color1, uint32_t color2, ub16_t frac1);
 uint16_t nxglib_rgb565_blend(uint16_t color1, uint16_t color2, ub16_t frac1);
 
+#ifdef CONFIG_NX_ARCH_ACCEL
+
+/****************************************************************************
+ * Name: up_nxgl_fillrectangle, up_nxgl_copyrectangle and
+ *       up_nxgl_moverectangle
+ *
+ * Description:
+ *   Architecture specific hooks that fill, copy or move a rectangle of a
+ *   framebuffer with a 2D engine, such as the STM32 DMA2D.  The framebuffer
+ *   renderers call them for the rectangles of at least
+ *   CONFIG_NX_ARCH_ACCEL_MINPIXELS pixels, with the arguments of
+ *   nxgl_fillrectangle_*bpp(), nxgl_copyrectangle_*bpp() and
+ *   nxgl_moverectangle_*bpp().  The pixel format is in pinfo->bpp.
+ *
+ *   The operation must be complete, and the CPU caches coherent with the
+ *   framebuffer, when the hook returns.
+ *
+ * Returned Value:
+ *   Zero (OK) if the engine did the operation.  A negated errno value,
+ *   like -ENOSYS for an unsupported format, makes the renderer fall back
+ *   to the CPU.
+ *
+ ****************************************************************************/
+
+struct fb_planeinfo_s;
+
+int up_nxgl_fillrectangle(FAR struct fb_planeinfo_s *pinfo,
+                          FAR const struct nxgl_rect_s *rect,
+                          nxgl_mxpixel_t color);
+int up_nxgl_copyrectangle(FAR struct fb_planeinfo_s *pinfo,
+                          FAR const struct nxgl_rect_s *dest,
+                          FAR const void *src,
+                          FAR const struct nxgl_point_s *origin,
+                          unsigned int srcstride);
+int up_nxgl_moverectangle(FAR struct fb_planeinfo_s *pinfo,
+                          FAR const struct nxgl_rect_s *rect,
+                          FAR const struct nxgl_point_s *offset);
+
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -833,6 +833,27 @@ void pci_release_irq(FAR struct pci_device_s *dev, FAR int *irq, int num);
 
 int pci_connect_irq(FAR struct pci_device_s *dev, FAR int *irq, int num);
 
+/****************************************************************************
+ * Name: pci_alloc_irq_affinity
+ *
+ * Description:
+ *   Allocate up to num MSI or MSI-X vectors spread across the CPUs, vector
+ *   n is routed to CPU n modulo the number of CPUs.
+ *
+ * Input Parameters:
+ *   dev - PCI device
+ *   irq - allocated vectors
+ *   num - number of vectors wanted
+ *
+ * Return value:
+ *   Return the number of allocated vectors on succes or negative errno
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int pci_alloc_irq_affinity(FAR struct pci_device_s *dev, FAR int *irq,
+                           int num);
+
 /****************************************************************************
  * Name: pci_register_driver
  *
@@ -67,6 +67,10 @@
 
 #define PERF_IOC_FLAG_GROUP            1
 
+/* The most addresses of a PERF_SAMPLE_CALLCHAIN sample */
+
+#define PERF_MAX_STACK_DEPTH           32
+
 #define PERF_EVENT_FLAG_ARCH           0x000fffff
 #define PERF_EVENT_FLAG_USER_READ_CNT  0x80000000
 
@@ -704,6 +708,16 @@ enum perf_event_type_e
   PERF_RECORD_MAX,      /* non-ABI */
 };
 
+/* The return addresses of a PERF_SAMPLE_CALLCHAIN sample, the sampled
+ * instruction pointer first.
+ */
+
+struct perf_callchain_entry
+{
+  uint64_t nr;
+  uint64_t ip[PERF_MAX_STACK_DEPTH];
+};
+
 struct perf_sample_data_s
 {
 /* Fields set by perf_sample_data_init() unconditionally,
@@ -0,0 +1,152 @@
+/****************************************************************************
+ * include/nuttx/rcu.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RCU_H
+#define __INCLUDE_NUTTX_RCU_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Read-copy-update for kernel data that is read very often and written
+ * rarely, the route table or the list of network devices for example.
+ *
+ * The readers run with the local interrupts disabled between
+ * rcu_read_lock() and rcu_read_unlock() and must not block, they write no
+ * shared memory at all.  A writer publishes a new version of the data with
+ * rcu_assign_pointer() and must call synchronize_rcu() before it frees the
+ * old version:  synchronize_rcu() runs a function on all other CPUs, which
+ * only completes once every read side section that may still see the old
+ * version has left.  The writers have to be serialized by the caller, with
+ * a mutex for example.
+ */
+
+/****************************************************************************
+ * Name: rcu_dereference
+ *
+ * Description:
+ *   Fetch a pointer published with rcu_assign_pointer(), within a read
+ *   side section.
+ *
+ ****************************************************************************/
+
+#define rcu_dereference(p)  (*(FAR volatile typeof(p) *)&(p))
+
+/****************************************************************************
+ * Name: rcu_assign_pointer
+ *
+ * Description:
+ *   Publish a pointer to new data, the initialization of the data is
+ *   visible to the readers before the pointer.
+ *
+ ****************************************************************************/
+
+#define rcu_assign_pointer(p, v) \
+  do \
+    { \
+      SP_DMB(); \
+      rcu_dereference(p) = (v); \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: synchronize_rcu
+ *
+ * Description:
+ *   Wait until all read side sections that were running on the other CPUs
+ *   when the function was called have left.  Without SMP no read side
+ *   section can be running when a thread calls this function.
+ *
+ * Assumptions:
+ *   Called from the normal tasking context, not within a read side
+ *   section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+void synchronize_rcu(void);
+#else
+#  define synchronize_rcu()
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rcu_read_lock
+ *
+ * Description:
+ *   Enter a read side section.  The sections may be nested.
+ *
+ * Returned Value:
+ *   The interrupt state to pass to rcu_read_unlock().
+ *
+ ****************************************************************************/
+
+static inline_function irqstate_t rcu_read_lock(void)
+{
+  return up_irq_save();
+}
+
+/****************************************************************************
+ * Name: rcu_read_unlock
+ *
+ * Description:
+ *   Leave a read side section entered with rcu_read_lock().
+ *
+ ****************************************************************************/
+
+static inline_function void rcu_read_unlock(irqstate_t flags)
+{
+  up_irq_restore(flags);
+}
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_RCU_H */
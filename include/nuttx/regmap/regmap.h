@@ -41,6 +41,22 @@
 
 struct regmap_bus_s;
 
+/* Register cache types, see regmap_config_s. */
+
+enum regmap_cache_type_e
+{
+  REGMAP_CACHE_NONE = 0,       /* Every access goes to the bus */
+  REGMAP_CACHE_FLAT,           /* One entry per register up to max_register */
+};
+
+/* A range of registers, min and max included. */
+
+struct regmap_range_s
+{
+  unsigned int min;
+  unsigned int max;
+};
+
 /* Single byte register read/write. */
 
 typedef CODE int (*reg_read_t)(FAR struct regmap_bus_s *bus,
@@ -100,6 +116,25 @@ struct regmap_config_s
    */
 
   bool disable_locking;
+
+#ifdef CONFIG_REGMAP_CACHE
+  /* The type of the register cache.  A cached register is read from the
+   * bus only once, later reads return the value last read or written.
+   */
+
+  enum regmap_cache_type_e cache_type;
+
+  /* The highest register address held in the cache. */
+
+  unsigned int max_register;
+
+  /* Registers that the hardware changes by itself, these are never
+   * cached.
+   */
+
+  FAR const struct regmap_range_s *volatile_ranges;
+  unsigned int n_volatile_ranges;
+#endif
 };
 
 struct regmap_s;
@@ -312,6 +347,75 @@ int regmap_read(FAR struct regmap_s *map, unsigned int reg,
 int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
                      FAR void *val, unsigned int val_count);
 
+/****************************************************************************
+ * Name: regmap_update_bits
+ *
+ * Description:
+ *   Read-modify-write of the bits of mask in a register.  The new value is
+ *   only written if it differs from the current one.  With the register
+ *   cache the current value comes from the cache.
+ *
+ * Input Parameters:
+ *   map  - regmap handler, from regmap bus init function return.
+ *   reg  - register address to be updated.
+ *   mask - the bits to update.
+ *   val  - the new value of the bits.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions/Limitations:
+ *   None.
+ *
+ ****************************************************************************/
+
+int regmap_update_bits(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int mask, unsigned int val);
+
+#ifdef CONFIG_REGMAP_CACHE
+
+/****************************************************************************
+ * Name: regmap_cache_only
+ *
+ * Description:
+ *   Defer the register writes, while the device is powered down for
+ *   example.  In cache only mode writes of cached registers only update the
+ *   cache, regmap_cache_sync() writes them to the device later.  Accesses
+ *   that cannot be served by the cache fail with -EBUSY.
+ *
+ * Input Parameters:
+ *   map    - regmap handler, from regmap bus init function return.
+ *   enable - true to enter the cache only mode, false to leave it.
+ *
+ * Assumptions/Limitations:
+ *   None.
+ *
+ ****************************************************************************/
+
+void regmap_cache_only(FAR struct regmap_s *map, bool enable);
+
+/****************************************************************************
+ * Name: regmap_cache_sync
+ *
+ * Description:
+ *   Write the registers changed in cache only mode to the device.  Runs of
+ *   adjacent registers are written in one bus transaction.
+ *
+ * Input Parameters:
+ *   map - regmap handler, from regmap bus init function return.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions/Limitations:
+ *   None.
+ *
+ ****************************************************************************/
+
+int regmap_cache_sync(FAR struct regmap_s *map);
+
+#endif /* CONFIG_REGMAP_CACHE */
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -65,6 +65,9 @@ struct rpmsg_s
  * wait: wait sem.
  * post: post sem.
  * get_cpuname: get cpu name.
+ * shm_alloc: allocate memory shared with the remote cpu, optional.
+ * shm_free: free the memory allocated by shm_alloc, optional.
+ * shm_pa2va: translate an address from the remote cpu, optional.
  */
 
 struct rpmsg_ops_s
@@ -76,6 +79,10 @@ struct rpmsg_ops_s
   CODE void (*dump)(FAR struct rpmsg_s *rpmsg);
   CODE FAR const char *(*get_local_cpuname)(FAR struct rpmsg_s *rpmsg);
   CODE FAR const char *(*get_cpuname)(FAR struct rpmsg_s *rpmsg);
+  CODE FAR void *(*shm_alloc)(FAR struct rpmsg_s *rpmsg, size_t size,
+                              FAR uint64_t *pa);
+  CODE void (*shm_free)(FAR struct rpmsg_s *rpmsg, FAR void *va);
+  CODE FAR void *(*shm_pa2va)(FAR struct rpmsg_s *rpmsg, uint64_t pa);
 };
 
 CODE typedef void (*rpmsg_dev_cb_t)(FAR struct rpmsg_device *rdev,
@@ -105,6 +112,11 @@ int rpmsg_post(FAR struct rpmsg_endpoint *ept, FAR sem_t *sem);
 FAR const char *rpmsg_get_local_cpuname(FAR struct rpmsg_device *rdev);
 FAR const char *rpmsg_get_cpuname(FAR struct rpmsg_device *rdev);
 
+FAR void *rpmsg_shm_alloc(FAR struct rpmsg_endpoint *ept, size_t size,
+                          FAR uint64_t *pa);
+void rpmsg_shm_free(FAR struct rpmsg_endpoint *ept, FAR void *va);
+FAR void *rpmsg_shm_pa2va(FAR struct rpmsg_endpoint *ept, uint64_t pa);
+
 int rpmsg_register_callback(FAR void *priv,
                             rpmsg_dev_cb_t device_created,
                             rpmsg_dev_cb_t device_destroy,
@@ -44,6 +44,7 @@
 #include <nuttx/semaphore.h>
 #include <nuttx/queue.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/map.h>
@@ -74,6 +75,10 @@
 #  define CONFIG_SCHED_SPORADIC_MAXREPL 3
 #endif
 
+#ifndef CONFIG_SIG_PREALLOC_TCB_ACTIONS
+#  define CONFIG_SIG_PREALLOC_TCB_ACTIONS 0
+#endif
+
 /* Scheduling monitor */
 
 #ifndef CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD
@@ -100,6 +105,19 @@
 #  define CONFIG_SCHED_CRITMONITOR_MAXTIME_WDOG -1
 #endif
 
+/* Bucket n of a critical section monitor histogram counts the holds that
+ * took [2^(n-1), 2^n) perf ticks, the last bucket all longer ones.
+ */
+
+#define CRITMON_NBUCKETS           32
+
+/* The kinds of holds a critical section monitor histogram is kept for */
+
+#define CRITMON_PREEMPTION         0  /* sched_lock() */
+#define CRITMON_CSECTION           1  /* enter_critical_section() */
+#define CRITMON_IRQ                2  /* Interrupt handler */
+#define CRITMON_NTYPES             3
+
 /* Task Management Definitions **********************************************/
 
 /* Special task IDS.  Any negative PID is invalid. */
@@ -134,6 +152,7 @@
 #define TCB_FLAG_FORCED_CANCEL     (1 << 13)                     /* Bit 13: Pthread cancel is forced */
 #define TCB_FLAG_JOIN_COMPLETED    (1 << 14)                     /* Bit 14: Pthread join completed */
 #define TCB_FLAG_FREE_TCB          (1 << 15)                     /* Bit 15: Free tcb after exit */
+#define TCB_FLAG_POOL_STACK        (1 << 16)                     /* Bit 16: Stack of the stack pool */
 
 /* Values for struct task_group tg_flags */
 
@@ -387,6 +406,26 @@ struct child_status_s
 };
 #endif
 
+/* struct sigq_s ************************************************************/
+
+/* The following defines the queue structure within each TCB to hold queued
+ * signal actions that need action by the task
+ */
+
+struct sigq_s
+{
+  FAR struct sigq_s *flink;      /* Forward link */
+  union
+  {
+    void (*sighandler)(int signo, siginfo_t *info, void *context);
+  } action;                      /* Signal action */
+  sigset_t  mask;                /* Additional signals to mask while the
+                                  * the signal-catching function executes */
+  siginfo_t info;                /* Signal information */
+  uint8_t   type;                /* (Used to manage allocations) */
+};
+typedef struct sigq_s sigq_t;
+
 /* struct dspace_s **********************************************************/
 
 /* This structure describes a reference counted D-Space region.
@@ -573,6 +612,20 @@ struct task_group_s
   struct mm_map_s tg_mm_map;        /* Task group virtual memory mappings   */
 };
 
+/* struct wakeup_stat_s *****************************************************/
+
+/* The wakeup latencies of a thread or a band of priorities */
+
+#ifdef CONFIG_SCHED_WAKEUP_LATENCY
+struct wakeup_stat_s
+{
+  uint32_t count;                        /* Number of wakeups               */
+  clock_t  min;                          /* Shortest wakeup latency         */
+  clock_t  max;                          /* Longest wakeup latency          */
+  uint64_t sum;                          /* Sum of the wakeup latencies     */
+};
+#endif
+
 /* struct tcb_s *************************************************************/
 
 /* This is the common part of the task control block (TCB).
@@ -651,6 +704,12 @@ struct tcb_s
 #endif
 
   struct wdog_s waitdog;                 /* All timed waits use this timer  */
+#ifdef CONFIG_HRTIMER
+  struct hrtimer_s waithrtimer;          /* Timed sleeps use this timer     */
+#endif
+#ifdef CONFIG_SCHED_TIMER_SLACK
+  clock_t  timerslack;                   /* Timer slack of timed waits      */
+#endif
 
   /* Stack-Related Fields ***************************************************/
 
@@ -673,6 +732,12 @@ struct tcb_s
 
   FAR void *waitobj;                     /* Object thread waiting on        */
 
+#ifdef CONFIG_FS_POLL_CACHE
+  /* File System Control Fields *********************************************/
+
+  FAR struct poll_cache_s *pollcache;    /* Poll setup kept across calls    */
+#endif
+
   /* POSIX Signal Control Fields ********************************************/
 
   sigset_t   sigprocmask;                /* Signals that are blocked        */
@@ -680,6 +745,11 @@ struct tcb_s
   sq_queue_t sigpendactionq;             /* List of pending signal actions  */
   sq_queue_t sigpostedq;                 /* List of posted signals          */
   siginfo_t  *sigunbinfo;                /* Signal info when task unblocked */
+  sigset_t   sigpendactionset;           /* Standard signals in sigpendactionq */
+#if CONFIG_SIG_PREALLOC_TCB_ACTIONS > 0
+  uint32_t   sigactionbusy;              /* Slots of sigaction[] in use     */
+  sigq_t     sigaction[CONFIG_SIG_PREALLOC_TCB_ACTIONS];
+#endif
 
   /* Robust mutex support ***************************************************/
 
@@ -692,6 +762,9 @@ struct tcb_s
 #ifndef CONFIG_SCHED_CPULOAD_NONE
   clock_t ticks;                         /* Number of ticks on this thread  */
 #endif
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+  unsigned int cpuload_epoch;            /* Load epoch of ticks             */
+#endif
 
   /* Pre-emption monitor support ********************************************/
 
@@ -715,6 +788,18 @@ struct tcb_s
   void   *crit_max_caller;               /* Caller of max critical section  */
 #endif
 
+#ifdef CONFIG_SCHED_WAKEUP_LATENCY
+  clock_t wakeup_start;                  /* Time when made ready-to-run     */
+  struct wakeup_stat_s wakeup_stat;      /* Wakeup latencies of the thread  */
+#endif
+
+  /* Heap usage tracking ****************************************************/
+
+#ifdef CONFIG_MM_HEAP_TASKPEAK
+  size_t heap_used;                      /* Heap memory owned by the thread */
+  size_t heap_peak;                      /* Peak of heap_used               */
+#endif
+
   /* State save areas *******************************************************/
 
   /* The form and content of these fields are platform-specific.            */
@@ -740,6 +825,12 @@ struct tcb_s
   size_t level_deepest;
   size_t level;
 #endif
+
+#ifdef CONFIG_SCHED_LATENCY_MONITOR
+  clock_t latency_time[CONFIG_SCHED_LATENCY_MONITOR_DEPTH];
+  size_t latency_level;
+  bool latency_busy;
+#endif
 };
 
 /* struct task_tcb_s ********************************************************/
@@ -829,6 +920,24 @@ begin_packed_struct struct tcbinfo_s
   end_packed_struct reg_off; /* Refer to https://sourceware.org/gdb/current/onlinedocs/gdb.html/Standard-Target-Features.html */
 } end_packed_struct;
 
+/* The histogram of one kind of hold on one CPU, and the call sites of the
+ * longest holds.  Each call site only appears once, with its longest hold.
+ */
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+struct critmon_holder_s
+{
+  FAR void *caller;                      /* Call site or interrupt handler  */
+  clock_t   elapsed;                     /* Longest hold of the call site   */
+};
+
+struct critmon_hist_s
+{
+  uint32_t bucket[CRITMON_NBUCKETS];
+  struct critmon_holder_s top[CONFIG_SCHED_CRITMONITOR_TOPN];
+};
+#endif
+
 /* This is the callback type used by nxsched_foreach() */
 
 typedef CODE void (*nxsched_foreach_t)(FAR struct tcb_s *tcb, FAR void *arg);
@@ -874,6 +983,13 @@ EXTERN clock_t g_premp_max[CONFIG_SMP_NCPUS];
 EXTERN clock_t g_crit_max[CONFIG_SMP_NCPUS];
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 */
 
+/* Histograms of the holds of each CPU */
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+EXTERN struct critmon_hist_s
+g_critmon_hist[CONFIG_SMP_NCPUS][CRITMON_NTYPES];
+#endif
+
 /* g_running_tasks[] holds a references to the running task for each CPU.
  * It is valid only when up_interrupt_context() returns true.
  */
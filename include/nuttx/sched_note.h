@@ -475,6 +475,8 @@ struct note_heap_s
   FAR void *mem;
   size_t size;
   size_t used;
+  size_t align;                      /* Alignment asked by memalign() */
+  uintptr_t caller;                  /* Return address of the allocator */
 };
 
 struct note_printf_s
@@ -670,10 +672,22 @@ void sched_note_wdog(uint8_t event, FAR void *handler, FAR const void *arg);
 #endif
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_HEAP
-void sched_note_heap(uint8_t event, FAR void *heap, FAR void *mem,
-                     size_t size, size_t used);
+void sched_note_heap_ip(uint8_t event, FAR void *heap, FAR void *mem,
+                        size_t size, size_t used, size_t align,
+                        uintptr_t ip);
+
+/* Expanded in the allocators, the return address is the caller of the
+ * allocator.
+ */
+
+#  define sched_note_heap(e,h,m,s,c) \
+          sched_note_heap_ip(e,h,m,s,c,0,(uintptr_t)return_address(0))
+#  define sched_note_heap_align(e,h,m,s,c,a) \
+          sched_note_heap_ip(e,h,m,s,c,a,(uintptr_t)return_address(0))
 #else
+#  define sched_note_heap_ip(e,h,m,s,c,a,ip)
 #  define sched_note_heap(e,h,m,s,c)
+#  define sched_note_heap_align(e,h,m,s,c,a)
 #endif
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
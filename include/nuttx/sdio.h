@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -482,6 +483,7 @@
 #define SDIO_CAPS_8BIT            0x10 /* Bit 4=1: Supports 8 bit operation */
 #define SDIO_CAPS_4BIT_ONLY       0x20 /* Bit 5=1: Supports 4-bit only operation */
 #define SDIO_CAPS_MMC_HS_MODE     0x40 /* Bit 6=1: Supports eMMC high speed mode */
+#define SDIO_CAPS_DMASG           0x80 /* Bit 7=1: Supports scatter-gather DMA */
 
 /****************************************************************************
  * Name: SDIO_STATUS
@@ -900,6 +902,58 @@
 #  define SDIO_DMASENDSETUP(dev,buffer,len) (-ENOSYS)
 #endif
 
+/****************************************************************************
+ * Name: SDIO_DMARECVSETUPV
+ *
+ * Description:
+ *   Setup to perform a read DMA into several buffers, like
+ *   SDIO_DMARECVSETUP does for one.  The controller programs a descriptor
+ *   for each buffer, e.g. in the ADMA2 descriptor table of an SDHCI, so
+ *   that the blocks of one multiple block transfer are scattered across
+ *   the buffers in order.  The length of each buffer is a multiple of the
+ *   block size.  Only used if SDIO_CAPS_DMASG is reported.
+ *
+ * Input Parameters:
+ *   dev    - An instance of the SDIO device interface
+ *   iov    - The memory to DMA into
+ *   iovcnt - The number of buffers in 'iov'
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SDIO_DMA_SG
+#  define SDIO_DMARECVSETUPV(dev,iov,iovcnt) \
+    ((dev)->dmarecvsetupv(dev,iov,iovcnt))
+#else
+#  define SDIO_DMARECVSETUPV(dev,iov,iovcnt) (-ENOSYS)
+#endif
+
+/****************************************************************************
+ * Name: SDIO_DMASENDSETUPV
+ *
+ * Description:
+ *   Setup to perform a write DMA from several buffers, like
+ *   SDIO_DMASENDSETUP does for one.  See SDIO_DMARECVSETUPV.
+ *
+ * Input Parameters:
+ *   dev    - An instance of the SDIO device interface
+ *   iov    - The memory to DMA from
+ *   iovcnt - The number of buffers in 'iov'
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SDIO_DMA_SG
+#  define SDIO_DMASENDSETUPV(dev,iov,iovcnt) \
+    ((dev)->dmasendsetupv(dev,iov,iovcnt))
+#else
+#  define SDIO_DMASENDSETUPV(dev,iov,iovcnt) (-ENOSYS)
+#endif
+
 /****************************************************************************
  * Name: SDIO_GOTEXTCSD
  *
@@ -1039,6 +1093,12 @@ struct sdio_dev_s
                              size_t buflen);
   CODE int   (*dmasendsetup)(FAR struct sdio_dev_s *dev,
                              FAR const uint8_t *buffer, size_t buflen);
+#ifdef CONFIG_SDIO_DMA_SG
+  CODE int   (*dmarecvsetupv)(FAR struct sdio_dev_s *dev,
+                              FAR const struct iovec *iov, int iovcnt);
+  CODE int   (*dmasendsetupv)(FAR struct sdio_dev_s *dev,
+                              FAR const struct iovec *iov, int iovcnt);
+#endif
 #endif /* CONFIG_SDIO_DMA */
   CODE void  (*gotextcsd)(FAR struct sdio_dev_s *dev,
                           FAR const uint8_t *buffer);
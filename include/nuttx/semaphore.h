@@ -42,10 +42,10 @@
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 #  if CONFIG_SEM_PREALLOCHOLDERS > 0
-/* semcount, flags, waitlist, hhead */
+/* semcount, flags, waitlist, hhead, holder */
 
 #    define NXSEM_INITIALIZER(c, f) \
-       {(c), (f), SEM_WAITLIST_INITIALIZER, NULL}
+       {(c), (f), SEM_WAITLIST_INITIALIZER, NULL, SEMHOLDER_INITIALIZER}
 #  else
 /* semcount, flags, waitlist, holder[2] */
 
@@ -640,6 +640,33 @@ void sensor_remap_vector_raw16(FAR const int16_t *in, FAR int16_t *out,
  * "Upper Half" Sensor Driver Interfaces
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sensor_push_batch
+ *
+ * Description:
+ *   This function pushes the samples that a lower half driver read out of
+ *   the hardware fifo at once to the upper half, with the timestamps
+ *   interpolated back from the time of the last sample.  The readers are
+ *   woken up once for the whole batch.
+ *
+ * Input Parameters:
+ *   lower     - A pointer to an instance of lower half sensor driver.
+ *   data      - The samples, each starting with its uint64_t timestamp.
+ *   esize     - The size of one sample.
+ *   nevents   - The number of samples, the oldest first.
+ *   timestamp - The time of the last sample in microseconds.
+ *   interval  - The time between two samples in microseconds.
+ *
+ * Returned Value:
+ *   The number of bytes pushed; A negated errno value is returned on any
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t sensor_push_batch(FAR struct sensor_lowerhalf_s *lower,
+                          FAR void *data, size_t esize, size_t nevents,
+                          uint64_t timestamp, uint32_t interval);
+
 /****************************************************************************
  * Name: sensor_register
  *
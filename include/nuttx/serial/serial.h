@@ -142,6 +142,7 @@ struct uart_dmaxfer_s
   size_t           length;  /* Length of first DMA buffer */
   size_t           nlength; /* Length of next DMA buffer */
   size_t           nbytes;  /* Bytes actually transferred by DMA from both buffers */
+  size_t           nreport; /* Bytes passed on by uart_recvchars_update() */
 };
 #endif /* CONFIG_SERIAL_RXDMA || CONFIG_SERIAL_TXDMA */
 
@@ -518,6 +519,27 @@ void uart_recvchars_dma(FAR uart_dev_t *dev);
 void uart_recvchars_done(FAR uart_dev_t *dev);
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_update
+ *
+ * Description:
+ *  Make the first 'nbytes' bytes of the running RX DMA transfer available
+ *  to the readers without ending the transfer.  This is called from the
+ *  half transfer or the idle line interrupt of a lower half whose DMA keeps
+ *  running until the region given by uart_recvchars_dma() is full, who
+ *  then calls uart_recvchars_done() as usual.  The readers are woken up
+ *  once CONFIG_SERIAL_RXDMA_WAKEUP bytes are buffered or if 'idle' tells
+ *  that the line went idle.
+ *
+ * Assumptions/Limitations:
+ *  This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_update(FAR uart_dev_t *dev, size_t nbytes, bool idle);
+#endif
+
 /****************************************************************************
  * Name: uart_reset_sem
  *
@@ -36,6 +36,12 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/spi/spi.h>
 
+#ifdef CONFIG_SPI_ASYNC
+#  include <nuttx/queue.h>
+#  include <nuttx/spinlock.h>
+#  include <nuttx/wqueue.h>
+#endif
+
 #ifdef CONFIG_SPI_EXCHANGE
 
 /* SPI Character Driver IOCTL Commands **************************************/
@@ -114,6 +120,34 @@ struct spi_sequence_s
   FAR struct spi_trans_s *trans;
 };
 
+#ifdef CONFIG_SPI_ASYNC
+/* An asynchronous SPI sequence as handled by spi_transfer_async().  The
+ * request is owned by the caller until its callback runs.
+ */
+
+struct spi_async_s;
+typedef CODE void (*spi_async_callback_t)(FAR struct spi_async_s *req,
+                                          int result);
+
+struct spi_async_s
+{
+  sq_entry_t node;                /* Used internally */
+  FAR struct spi_sequence_s *seq; /* The sequence to perform */
+  spi_async_callback_t callback;  /* Called with the result when done */
+  FAR void *arg;                  /* For the use of the caller */
+};
+
+/* The queue of asynchronous sequences of one SPI bus */
+
+struct spi_queue_s
+{
+  FAR struct spi_dev_s *spi;      /* The SPI bus */
+  sq_queue_t pending;             /* Submitted requests, in order */
+  spinlock_t lock;                /* Protects pending */
+  struct work_s work;             /* Performs the requests */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -137,6 +171,47 @@ struct spi_sequence_s
 
 int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
 
+#ifdef CONFIG_SPI_ASYNC
+
+/****************************************************************************
+ * Name: spi_queue_initialize
+ *
+ * Description:
+ *   Initialize the queue of asynchronous sequences of an SPI bus.  All
+ *   users of spi_transfer_async() on the bus should share one queue.
+ *
+ * Input Parameters:
+ *   queue - The queue to initialize
+ *   spi   - An instance of the SPI device to use for the transfers
+ *
+ ****************************************************************************/
+
+void spi_queue_initialize(FAR struct spi_queue_s *queue,
+                          FAR struct spi_dev_s *spi);
+
+/****************************************************************************
+ * Name: spi_transfer_async
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers.  The queued sequences are performed
+ *   back to back by spi_transfer() on a work queue and req->callback is
+ *   called with the result of each.  This function does not block and may
+ *   be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   queue - The queue of the SPI bus
+ *   req   - The request, with seq and callback set
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_transfer_async(FAR struct spi_queue_s *queue,
+                       FAR struct spi_async_s *req);
+
+#endif /* CONFIG_SPI_ASYNC */
+
 /****************************************************************************
  * Name: spi_register
  *
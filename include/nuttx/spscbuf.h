@@ -0,0 +1,255 @@
+/****************************************************************************
+ * include/nuttx/spscbuf.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SPSCBUF_H
+#define __INCLUDE_NUTTX_SPSCBUF_H
+
+/* A circular buffer for exactly one producer and one consumer that may
+ * run concurrently, on different CPUs or one in an interrupt handler,
+ * without any lock.  The producer publishes data by storing the head with
+ * release semantics after writing it and the consumer frees space by
+ * storing the tail with release semantics after reading it.  The head and
+ * the tail are kept on separate cache lines, each with a copy of the other
+ * index, so that the two sides only touch the cache line of the other one
+ * when their copy is exhausted.
+ *
+ * The producer calls the spscbuf_reserve(), spscbuf_commit() and
+ * spscbuf_write() functions, the consumer the spscbuf_peek(),
+ * spscbuf_consume() and spscbuf_read() functions.  More producers or more
+ * consumers need a lock of their own side, like struct circbuf_s does.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/atomic.h>
+#include <nuttx/compiler.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_LIBC_SPSCBUF_ALIGN
+#  define CONFIG_LIBC_SPSCBUF_ALIGN 64
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The indexes run from 0 to 2 * size - 1, so that a full buffer can be
+ * told from an empty one for any size.
+ */
+
+struct spscbuf_s
+{
+  FAR uint8_t *base;              /* The buffer space */
+  unsigned int size;              /* The size of the buffer space */
+  bool         external;          /* The buffer space is the caller's */
+
+  /* Written by the producer only */
+
+  aligned_data(CONFIG_LIBC_SPSCBUF_ALIGN) atomic_uint head;
+  unsigned int tailcache;         /* The tail last seen by the producer */
+
+  /* Written by the consumer only */
+
+  aligned_data(CONFIG_LIBC_SPSCBUF_ALIGN) atomic_uint tail;
+  unsigned int headcache;         /* The head last seen by the consumer */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: spscbuf_init
+ *
+ * Description:
+ *   Initialize an empty buffer.  Neither side may use it meanwhile.
+ *
+ * Input Parameters:
+ *   buf   - Address of the buffer to be used.
+ *   base  - The buffer space or NULL to allocate 'bytes' of it.
+ *   bytes - The size of the buffer space.
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int spscbuf_init(FAR struct spscbuf_s *buf, FAR void *base, size_t bytes);
+
+/****************************************************************************
+ * Name: spscbuf_uninit
+ *
+ * Description:
+ *   Free the buffer space if it was allocated by spscbuf_init().
+ *
+ ****************************************************************************/
+
+void spscbuf_uninit(FAR struct spscbuf_s *buf);
+
+/****************************************************************************
+ * Name: spscbuf_reset
+ *
+ * Description:
+ *   Drop the content of the buffer.  Neither side may use it meanwhile.
+ *
+ ****************************************************************************/
+
+void spscbuf_reset(FAR struct spscbuf_s *buf);
+
+/****************************************************************************
+ * Name: spscbuf_used
+ *
+ * Description:
+ *   Return the number of bytes in the buffer.  The value is exact for the
+ *   consumer and only a snapshot for anybody else.
+ *
+ ****************************************************************************/
+
+size_t spscbuf_used(FAR struct spscbuf_s *buf);
+
+/****************************************************************************
+ * Name: spscbuf_space
+ *
+ * Description:
+ *   Return the free space of the buffer.  The value is exact for the
+ *   producer and only a snapshot for anybody else.
+ *
+ ****************************************************************************/
+
+size_t spscbuf_space(FAR struct spscbuf_s *buf);
+
+/****************************************************************************
+ * Name: spscbuf_is_empty
+ ****************************************************************************/
+
+bool spscbuf_is_empty(FAR struct spscbuf_s *buf);
+
+/****************************************************************************
+ * Name: spscbuf_reserve
+ *
+ * Description:
+ *   Return the contiguous free space at the head of the buffer for the
+ *   producer to write into.  The data is not visible to the consumer until
+ *   it is committed with spscbuf_commit().
+ *
+ * Input Parameters:
+ *   buf  - Address of the buffer to be used.
+ *   size - Returns the size of the contiguous free space, zero if full.
+ *
+ * Returned Value:
+ *   The address of the free space.
+ *
+ ****************************************************************************/
+
+FAR void *spscbuf_reserve(FAR struct spscbuf_s *buf, FAR size_t *size);
+
+/****************************************************************************
+ * Name: spscbuf_commit
+ *
+ * Description:
+ *   Publish 'bytes' bytes that the producer wrote at the address returned
+ *   by spscbuf_reserve().
+ *
+ ****************************************************************************/
+
+void spscbuf_commit(FAR struct spscbuf_s *buf, size_t bytes);
+
+/****************************************************************************
+ * Name: spscbuf_write
+ *
+ * Description:
+ *   Copy up to 'bytes' bytes into the buffer and publish them.
+ *
+ * Returned Value:
+ *   The number of bytes written, less than 'bytes' if the buffer is full.
+ *
+ ****************************************************************************/
+
+size_t spscbuf_write(FAR struct spscbuf_s *buf, FAR const void *src,
+                     size_t bytes);
+
+/****************************************************************************
+ * Name: spscbuf_peek
+ *
+ * Description:
+ *   Return the contiguous data at the tail of the buffer for the consumer
+ *   to read in place.  The data stays in the buffer until it is released
+ *   with spscbuf_consume().
+ *
+ * Input Parameters:
+ *   buf  - Address of the buffer to be used.
+ *   size - Returns the size of the contiguous data, zero if empty.
+ *
+ * Returned Value:
+ *   The address of the data.
+ *
+ ****************************************************************************/
+
+FAR void *spscbuf_peek(FAR struct spscbuf_s *buf, FAR size_t *size);
+
+/****************************************************************************
+ * Name: spscbuf_consume
+ *
+ * Description:
+ *   Release 'bytes' bytes of the data returned by spscbuf_peek() to the
+ *   producer.
+ *
+ ****************************************************************************/
+
+void spscbuf_consume(FAR struct spscbuf_s *buf, size_t bytes);
+
+/****************************************************************************
+ * Name: spscbuf_read
+ *
+ * Description:
+ *   Copy up to 'bytes' bytes out of the buffer and release them.
+ *
+ * Returned Value:
+ *   The number of bytes read, less than 'bytes' if the buffer ran empty.
+ *
+ ****************************************************************************/
+
+size_t spscbuf_read(FAR struct spscbuf_s *buf, FAR void *dst, size_t bytes);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+#endif /* __INCLUDE_NUTTX_SPSCBUF_H */
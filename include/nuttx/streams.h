@@ -375,7 +375,8 @@ void lib_memsostream(FAR struct lib_memsostream_s *stream,
  *   stream  - User allocated, uninitialized instance of stream
  *             to be initialized
  *   handle  - User provided FILE instance (must have been opened for
- *             the correct access).
+ *             the correct access).  lib_stdoutstream writes it with the
+ *             _unlocked functions, so hold flockfile() on it while in use.
  *
  * Returned Value:
  *   None (User allocated instance initialized).
@@ -29,6 +29,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -57,6 +59,29 @@ struct symtab_s
   FAR const void *sym_value; /* The value associated with the string */
 };
 
+#ifdef CONFIG_SYMTAB_HASHED
+/* struct symtab_hash_s is an index of a symbol table by the GNU hash of the
+ * names, as DT_GNU_HASH is for ELF files.  A bloom filter rejects most of
+ * the names that are not in the table without touching the table, and the
+ * others are only compared with the names in the same bucket whose hash
+ * matches.  The index does not modify the table and becomes stale if the
+ * table changes.
+ */
+
+struct symtab_hash_s
+{
+  FAR const struct symtab_s *symtab; /* The indexed symbol table */
+  int nsyms;                         /* The number of symbols in symtab */
+  uint32_t bloommask;                /* The number of bloom words - 1 */
+  uint32_t bucketmask;               /* The number of buckets - 1 */
+  FAR uint32_t *bloom;               /* Bloom filter, two bits per name */
+  FAR uint32_t *buckets;             /* First entry of each bucket, and
+                                      * one past the last bucket */
+  FAR uint32_t *hashes;              /* The hash of each entry */
+  FAR uint32_t *order;               /* The symtab index of each entry */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -121,6 +146,53 @@ symtab_findbyvalue(FAR const struct symtab_s *symtab,
 
 void symtab_sortbyname(FAR struct symtab_s *symtab, int nsyms);
 
+#ifdef CONFIG_SYMTAB_HASHED
+/****************************************************************************
+ * Name: symtab_hash_create
+ *
+ * Description:
+ *   Build the hash index of a symbol table.  The table must stay unchanged
+ *   as long as the index is used.
+ *
+ * Returned Value:
+ *   The index on success; NULL if it could not be allocated.
+ *
+ ****************************************************************************/
+
+FAR struct symtab_hash_s *
+symtab_hash_create(FAR const struct symtab_s *symtab, int nsyms);
+
+/****************************************************************************
+ * Name: symtab_hash_destroy
+ *
+ * Description:
+ *   Free the hash index of a symbol table.  The table itself is not freed.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void symtab_hash_destroy(FAR struct symtab_hash_s *hash);
+
+/****************************************************************************
+ * Name: symtab_findbyhash
+ *
+ * Description:
+ *   Find the symbol with the matching name through the hash index of a
+ *   symbol table.  The lookup time does not depend on nsyms.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findbyhash(FAR const struct symtab_hash_s *hash,
+                  FAR const char *name);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
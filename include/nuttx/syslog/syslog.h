@@ -395,6 +395,30 @@ int syslog_flush(void);
 int nx_vsyslog(int priority, FAR const IPTR char *src, FAR va_list *ap);
 #endif
 
+/****************************************************************************
+ * Name: syslog_ratelimit
+ *
+ * Description:
+ *   Limit the rate of the messages that the deferred syslog thread outputs
+ *   to a channel.  The messages above the limit are dropped and counted,
+ *   the count is output once the channel accepts messages again.
+ *
+ * Input Parameters:
+ *   channel - The channel to limit
+ *   rate    - The messages per second, 0 for no limit
+ *   burst   - The number of messages that may be output at once
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_ratelimit(FAR syslog_channel_t *channel, unsigned int rate,
+                     unsigned int burst);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -89,6 +89,10 @@
  *  ioctl argument: A read-only reference to struct pwm_info_s that provides
  *  the characteristics of the pulsed output.
  *
+ *  With CONFIG_PWM_MULTICHAN the duties of all channels are changed by one
+ *  call.  If the frequency is unchanged, lower halves should apply them
+ *  together at the next period, without restarting the timer.
+ *
  * PWMIOC_GETCHARACTERISTICS - Get the currently selected characteristics of
  *                             the pulsed output (independent of whether the
  *                             output is start or stopped).
@@ -1128,6 +1128,24 @@ struct sensor_ustate_s
   uint64_t generation;         /* The recent generation of circular buffer */
 };
 
+/* This structure is the head of the circular buffer that mmap() maps read
+ * only from a sensor device with CONFIG_SENSORS_MMAP.  The events follow
+ * it, event n at offset sizeof(struct sensor_ring_s) +
+ * (n % nbuffer) * esize.  The upper half increases pending before it
+ * writes events and generation after, so a subscriber copies event n with
+ * n < generation in place and the copy is valid if pending - n <= nbuffer
+ * still holds after it, otherwise the event was overwritten meanwhile.
+ * Both counters must be loaded with acquire semantics for that.
+ */
+
+struct sensor_ring_s
+{
+  uint32_t esize;              /* The element size of circular buffer */
+  uint32_t nbuffer;            /* The number of events that the circular buffer can hold */
+  uint32_t generation;         /* The number of events published */
+  uint32_t pending;            /* The number of events published or being written */
+};
+
 /* This structure describes the register info for the user sensor */
 
 #ifdef CONFIG_USENSOR
@@ -0,0 +1,219 @@
+/****************************************************************************
+ * include/nuttx/video/dmabuf.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_VIDEO_DMABUF_H
+#define __INCLUDE_NUTTX_VIDEO_DMABUF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mutex.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A DMA buffer is a file descriptor that stands for a buffer of a driver,
+ * like the ones that VIDIOC_EXPBUF returns.  It may be passed to other
+ * drivers that then use the memory in place, and mapped with mmap() to
+ * access the pixels.  The CPU must bracket its accesses with
+ * DMA_BUF_IOCTL_SYNC so that the cache is only maintained when the buffer
+ * changes hands between the CPU and the devices.
+ */
+
+#define DMA_BUF_SYNC_READ      (1 << 0)  /* The CPU reads the buffer */
+#define DMA_BUF_SYNC_WRITE     (1 << 1)  /* The CPU writes the buffer */
+#define DMA_BUF_SYNC_RW        (DMA_BUF_SYNC_READ | DMA_BUF_SYNC_WRITE)
+#define DMA_BUF_SYNC_START     (0 << 2)  /* The CPU access begins */
+#define DMA_BUF_SYNC_END       (1 << 2)  /* The CPU access is over */
+
+/* Begin or end a CPU access to the buffer.
+ *
+ * Argument: A reference to struct dma_buf_sync
+ */
+
+#define DMA_BUF_IOCTL_SYNC     _DMABUFIOC(0x0001)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct dma_buf_sync
+{
+  uint64_t flags;                        /* DMA_BUF_SYNC_* */
+};
+
+#ifdef CONFIG_VIDEO_DMABUF
+
+/* The buffer behind a DMA buffer file descriptor */
+
+struct dmabuf_s
+{
+  FAR void *addr;                        /* Start of the buffer */
+  size_t len;                            /* Size of the buffer */
+  atomic_int refs;                       /* The file and the importers */
+  mutex_t lock;                          /* Protects flags */
+  uint8_t flags;                         /* See video_dmabuf.c */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: dmabuf_alloc
+ *
+ * Description:
+ *   Wrap a buffer of the caller.  The caller holds the only reference and
+ *   may free the memory once dmabuf_shared() is false and it released that
+ *   reference.
+ *
+ * Input Parameters:
+ *   addr - The start of the buffer, aligned to the cache lines
+ *   len  - The size of the buffer
+ *
+ * Returned Value:
+ *   The buffer on success; NULL if out of memory.
+ *
+ ****************************************************************************/
+
+FAR struct dmabuf_s *dmabuf_alloc(FAR void *addr, size_t len);
+
+/****************************************************************************
+ * Name: dmabuf_fd
+ *
+ * Description:
+ *   Create a file descriptor that stands for a buffer, as VIDIOC_EXPBUF
+ *   does.  The descriptor holds a reference until it is closed.
+ *
+ * Input Parameters:
+ *   buf    - The buffer
+ *   oflags - O_CLOEXEC or 0
+ *
+ * Returned Value:
+ *   A new file descriptor on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dmabuf_fd(FAR struct dmabuf_s *buf, int oflags);
+
+/****************************************************************************
+ * Name: dmabuf_get
+ *
+ * Description:
+ *   Import the buffer of a DMA buffer file descriptor.  The buffer stays
+ *   valid until dmabuf_put(), even if the descriptor is closed.
+ *
+ * Input Parameters:
+ *   fd - The DMA buffer file descriptor
+ *
+ * Returned Value:
+ *   The buffer on success; NULL if fd is not a DMA buffer.
+ *
+ ****************************************************************************/
+
+FAR struct dmabuf_s *dmabuf_get(int fd);
+
+/****************************************************************************
+ * Name: dmabuf_ref and dmabuf_put
+ *
+ * Description:
+ *   Take one more reference to a buffer, or release one.  The buffer is
+ *   freed with the last reference, but not the memory that it wraps.
+ *
+ ****************************************************************************/
+
+FAR struct dmabuf_s *dmabuf_ref(FAR struct dmabuf_s *buf);
+void dmabuf_put(FAR struct dmabuf_s *buf);
+
+/****************************************************************************
+ * Name: dmabuf_shared
+ *
+ * Description:
+ *   Return true if anybody but the caller holds a reference to a buffer,
+ *   so that its memory may not be freed yet.
+ *
+ ****************************************************************************/
+
+static inline bool dmabuf_shared(FAR struct dmabuf_s *buf)
+{
+  return atomic_load(&buf->refs) > 1;
+}
+
+/****************************************************************************
+ * Name: dmabuf_begin_device and dmabuf_end_device
+ *
+ * Description:
+ *   Hand the buffer over to a device and get it back.  The cache is only
+ *   cleaned if the CPU wrote the buffer since a device used it last; a
+ *   buffer that goes from one device to the next is not touched.
+ *
+ * Input Parameters:
+ *   buf     - The imported buffer
+ *   written - True if the device wrote the buffer
+ *
+ ****************************************************************************/
+
+void dmabuf_begin_device(FAR struct dmabuf_s *buf);
+void dmabuf_end_device(FAR struct dmabuf_s *buf, bool written);
+
+/****************************************************************************
+ * Name: dmabuf_begin_cpu and dmabuf_end_cpu
+ *
+ * Description:
+ *   Bracket an access of the CPU to the buffer, as DMA_BUF_IOCTL_SYNC
+ *   does.  The cache is only invalidated if a device wrote the buffer
+ *   since the CPU looked at it last.
+ *
+ * Input Parameters:
+ *   buf     - The imported buffer
+ *   written - True if the CPU wrote the buffer
+ *
+ ****************************************************************************/
+
+void dmabuf_begin_cpu(FAR struct dmabuf_s *buf);
+void dmabuf_end_cpu(FAR struct dmabuf_s *buf, bool written);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_VIDEO_DMABUF */
+#endif /* __INCLUDE_NUTTX_VIDEO_DMABUF_H */
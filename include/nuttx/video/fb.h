@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <errno.h>
 #include <debug.h>
@@ -310,6 +311,31 @@
 #define FBIOSET_VSYNCOFFSET   _FBIOC(0x001a)  /* Set VSync offset in usec
                                                * Argument:             int */
 
+#ifdef CONFIG_FB_DAMAGE
+#define FBIOSET_DAMAGE        _FBIOC(0x001d)  /* Report a changed area,
+                                               * flushed at the next vsync
+                                               * or NULL to flush now
+                                               * Argument: read-only struct
+                                               *           fb_area_s* */
+#endif
+
+#ifdef CONFIG_FB_FENCE
+#define FBIOGET_FENCE         _FBIOC(0x001e)  /* Get the pan fences of the
+                                               * selected overlay
+                                               * Argument: writable struct
+                                               *           fb_fence_s* */
+#define FBIOSET_FENCE         _FBIOC(0x001f)  /* Report POLLIN once the pan
+                                               * with this fence is released
+                                               * Argument:        uint32_t */
+#endif
+
+#ifdef CONFIG_VIDEO_DMABUF
+#define FBIOSET_DMABUF        _FBIOC(0x0020)  /* Show a DMA buffer with the
+                                               * layout of the plane, or -1
+                                               * to show the plane again
+                                               * Argument:             int */
+#endif
+
 /* Linux Support ************************************************************/
 
 #define FBIOGET_VSCREENINFO   _FBIOC(0x001b)  /* Get video variable info */
@@ -537,6 +563,31 @@ struct fb_area_s
   fb_coord_t h;           /* Height of the area */
 };
 
+#ifdef CONFIG_FB_DAMAGE
+/* This structure accumulates the changed areas of a framebuffer.  Areas
+ * that overlap are merged, so the rectangles never cover a pixel twice.
+ */
+
+struct fb_damage_s
+{
+  uint8_t nrects;         /* Number of valid rectangles */
+  struct fb_area_s rects[CONFIG_FB_DAMAGE_NRECTS];
+};
+#endif
+
+#ifdef CONFIG_FB_FENCE
+/* This structure describes the pans of an overlay.  Each pan is numbered
+ * in the order it was queued, its number is its fence.  The pan, and the
+ * buffer it shows, is released once the lower half no longer scans it out.
+ */
+
+struct fb_fence_s
+{
+  uint32_t queued;        /* The fence of the last queued pan */
+  uint32_t released;      /* The fence of the last released pan */
+};
+#endif
+
 #ifdef CONFIG_FB_OVERLAY
 /* This structure describes the transparency. */
 
@@ -828,6 +879,15 @@ struct fb_vtable_s
   int (*pandisplay)(FAR struct fb_vtable_s *vtable,
                     FAR struct fb_planeinfo_s *pinfo);
 
+#ifdef CONFIG_VIDEO_DMABUF
+  /* The following are provided only if the video hardware can scan out a
+   * buffer outside of the plane memory, the frame of a camera or a decoder
+   * for example.  NULL selects the plane memory again.
+   */
+
+  int (*setscanout)(FAR struct fb_vtable_s *vtable, FAR void *addr);
+#endif
+
   /* Specific Controls ******************************************************/
 
   /* Set the frequency of the framebuffer update panel (0: disable refresh) */
@@ -1048,7 +1108,9 @@ int fb_peek_paninfo(FAR struct fb_vtable_s *vtable,
 /****************************************************************************
  * Name: fb_remove_paninfo
  * Description:
- *   Remove a frame from pan info queue of the specified overlay.
+ *   Remove a frame from pan info queue of the specified overlay.  Call it
+ *   once the hardware no longer scans out the frame, this releases the
+ *   fence of its pan.
  *
  * Input Parameters:
  *   vtable  - Pointer to framebuffer's virtual table.
@@ -1077,6 +1139,48 @@ int fb_remove_paninfo(FAR struct fb_vtable_s *vtable, int overlay);
 
 int fb_paninfo_count(FAR struct fb_vtable_s *vtable, int overlay);
 
+#ifdef CONFIG_FB_DAMAGE
+
+/****************************************************************************
+ * Name: fb_area_merge
+ *
+ * Description:
+ *   Replace 'dst' with the bounding box of 'dst' and 'src' if the areas
+ *   overlap, or if the box is no larger than the two areas together, i.e.
+ *   if updating the box costs no more than updating both.
+ *
+ * Input Parameters:
+ *   dst - The area to grow.
+ *   src - The area to add to 'dst'.
+ *
+ * Returned Value:
+ *   True if 'dst' now covers 'src'.
+ *
+ ****************************************************************************/
+
+bool fb_area_merge(FAR struct fb_area_s *dst,
+                   FAR const struct fb_area_s *src);
+
+/****************************************************************************
+ * Name: fb_damage_add
+ *
+ * Description:
+ *   Add an area to the damaged areas.  The area is merged with the
+ *   rectangles that overlap it.  Once all CONFIG_FB_DAMAGE_NRECTS
+ *   rectangles are in use, it is merged with the rectangle that grows the
+ *   least.  The caller serializes the access to 'damage'.
+ *
+ * Input Parameters:
+ *   damage - The damaged areas.
+ *   area   - The area that changed.
+ *
+ ****************************************************************************/
+
+void fb_damage_add(FAR struct fb_damage_s *damage,
+                   FAR const struct fb_area_s *area);
+
+#endif
+
 /****************************************************************************
  * Name: fb_register_device
  *
@@ -147,6 +147,8 @@ struct v4l2_ops_s
                           FAR struct v4l2_decoder_cmd *cmd);
   CODE int (*encoder_cmd)(FAR struct file *filep,
                           FAR struct v4l2_encoder_cmd *cmd);
+  CODE int (*expbuf)(FAR struct file *filep,
+                     FAR struct v4l2_exportbuffer *exp);
 };
 
 /****************************************************************************
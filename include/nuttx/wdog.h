@@ -88,6 +88,9 @@ struct wdog_s
   FAR void          *picbase;    /* PIC base address */
 #endif
   clock_t            expired;    /* Timer associated with the absoulute time */
+#ifdef CONFIG_WDOG_QUEUE_HEAP
+  FAR struct wdog_s *child;      /* First child in the watchdog heap */
+#endif
 };
 
 /****************************************************************************
@@ -335,6 +338,24 @@ int wd_cancel_irq(FAR struct wdog_s *wdog);
 
 sclock_t wd_gettime(FAR struct wdog_s *wdog);
 
+/****************************************************************************
+ * Name: wd_nexttime
+ *
+ * Description:
+ *   This function returns the time remaining before the first active
+ *   watchdog timer expires, the next timer event in tickless mode.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the first watchdog expires.
+ *   A negative value means that no watchdog is active.
+ *
+ ****************************************************************************/
+
+sclock_t wd_nexttime(void);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
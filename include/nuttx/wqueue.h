@@ -261,6 +261,9 @@ struct work_s
   worker_t  worker;              /* Work callback */
   FAR void *arg;                 /* Callback argument */
   FAR struct kwork_wqueue_s *wq; /* Work queue */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  clock_t   stime;               /* perf_gettime() when work was queued */
+#endif
 };
 
 /* This is an enumeration of the various events that may be
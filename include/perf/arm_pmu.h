@@ -161,6 +161,7 @@ static inline bool test_and_set_bit(unsigned long nr,
  ****************************************************************************/
 
 uint64_t armpmu_event_update(struct perf_event_s *event);
+void armpmu_event_set_period(struct perf_event_s *event);
 int armpmu_driver_init(FAR void *fn);
 int armpmu_map_event(struct perf_event_s *event,
                      const unsigned (*event_map)[PERF_COUNT_HW_MAX],
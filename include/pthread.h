@@ -364,6 +364,14 @@ typedef struct pthread_barrierattr_s pthread_barrierattr_t;
 #  define __PTHREAD_BARRIERATTR_T_DEFINED 1
 #endif
 
+#ifdef CONFIG_FUTEX
+struct pthread_barrier_s
+{
+  unsigned int      count;    /* Number of threads to wait for */
+  volatile uint32_t arrived;  /* Number of threads that have arrived */
+  volatile uint32_t cycle;    /* Futex word, advanced on each release */
+};
+#else
 struct pthread_barrier_s
 {
   sem_t        sem;
@@ -371,6 +379,7 @@ struct pthread_barrier_s
   unsigned int wait_count;
   mutex_t      mutex;
 };
+#endif
 
 #ifndef __PTHREAD_BARRIER_T_DEFINED
 typedef struct pthread_barrier_s pthread_barrier_t;
@@ -398,6 +407,17 @@ typedef struct pthread_rwlockattr_s pthread_rwlockattr_t;
 #  define __PTHREAD_RWLOCKATTR_T_DEFINED 1
 #endif
 
+#ifdef CONFIG_FUTEX
+struct pthread_rwlock_s
+{
+  volatile uint32_t state;    /* Reader count, PTHREAD_RWLOCK_WRITER if held
+                               * for writing */
+  volatile uint32_t waiters;  /* Number of threads waiting for the lock */
+  volatile uint32_t seq;      /* Futex word, advanced on each release */
+};
+
+#define PTHREAD_RWLOCK_WRITER       0x80000000
+#else
 struct pthread_rwlock_s
 {
   pthread_mutex_t lock;
@@ -406,15 +426,20 @@ struct pthread_rwlock_s
   unsigned int num_writers;
   bool write_in_progress;
 };
+#endif
 
 #ifndef __PTHREAD_RWLOCK_T_DEFINED
 typedef struct pthread_rwlock_s pthread_rwlock_t;
 #  define __PTHREAD_RWLOCK_T_DEFINED 1
 #endif
 
+#ifdef CONFIG_FUTEX
+#define PTHREAD_RWLOCK_INITIALIZER  {0, 0, 0}
+#else
 #define PTHREAD_RWLOCK_INITIALIZER  {PTHREAD_MUTEX_INITIALIZER, \
                                      PTHREAD_COND_INITIALIZER, \
                                      0, 0, false}
+#endif
 
 #ifdef CONFIG_PTHREAD_SPINLOCKS
 /* This (non-standard) structure represents a pthread spinlock */
@@ -118,9 +118,10 @@ struct sem_s
 #ifdef CONFIG_PRIORITY_INHERITANCE
 #  if CONFIG_SEM_PREALLOCHOLDERS > 0
   FAR struct semholder_s *hhead; /* List of holders of semaphore counts */
-#  else
-  struct semholder_s holder;     /* Slot for old and new holder */
 #  endif
+  struct semholder_s holder;     /* Slot for the first holder, further
+                                  * holders come from the preallocated
+                                  * holders */
 #endif
 #ifdef CONFIG_PRIORITY_PROTECT
   uint8_t ceiling;               /* The priority ceiling owned by mutex  */
@@ -134,10 +135,10 @@ typedef struct sem_s sem_t;
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 #  if CONFIG_SEM_PREALLOCHOLDERS > 0
-/* semcount, flags, waitlist, hhead */
+/* semcount, flags, waitlist, hhead, holder */
 
 #    define SEM_INITIALIZER(c) \
-       {(c), 0, SEM_WAITLIST_INITIALIZER, NULL}
+       {(c), 0, SEM_WAITLIST_INITIALIZER, NULL, SEMHOLDER_INITIALIZER}
 #  else
 /* semcount, flags, waitlist, holder[2] */
 
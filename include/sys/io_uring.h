@@ -0,0 +1,161 @@
+/****************************************************************************
+ * include/sys/io_uring.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_IO_URING_H
+#define __INCLUDE_SYS_IO_URING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Operations of a submission queue entry */
+
+#define IORING_OP_NOP        0  /* Complete with zero */
+#define IORING_OP_READ       1  /* read(), or pread() if 'off' >= 0 */
+#define IORING_OP_WRITE      2  /* write(), or pwrite() if 'off' >= 0 */
+#define IORING_OP_FSYNC      3  /* fsync() */
+#define IORING_OP_POLL_ADD   4  /* Wait for 'op_flags' poll events */
+#define IORING_OP_SEND       5  /* send() with 'op_flags' */
+#define IORING_OP_RECV       6  /* recv() with 'op_flags' */
+
+/* Flags of a submission queue entry */
+
+#define IOSQE_ASYNC          (1 << 0) /* Always run on the worker thread */
+
+/* Flags of io_uring_enter() */
+
+#define IORING_ENTER_GETEVENTS (1 << 0) /* Wait for 'min_complete' */
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* One operation to submit */
+
+struct io_uring_sqe
+{
+  uint8_t  opcode;              /* IORING_OP_* */
+  uint8_t  flags;               /* IOSQE_* */
+  int      fd;                  /* The file descriptor to operate on */
+  off_t    off;                 /* The file offset, -1 for the position */
+  FAR void *addr;               /* The buffer */
+  size_t   len;                 /* The length of the buffer */
+  uint32_t op_flags;            /* Poll events or send()/recv() flags */
+  uint64_t user_data;           /* Returned in the completion */
+};
+
+/* The result of one operation */
+
+struct io_uring_cqe
+{
+  uint64_t user_data;           /* From the submission queue entry */
+  int32_t  res;                 /* Result, a negated errno value on error */
+  uint32_t flags;               /* Unused, zero */
+};
+
+/* The indices of the rings.  They count up and wrap, the entry of an
+ * index is at that index modulo the size of the ring.  Each of them is
+ * only written by one side.
+ */
+
+struct io_uring_rings
+{
+  uint32_t sq_head;             /* Next entry taken by the kernel */
+  uint32_t sq_tail;             /* Next entry filled by the application */
+  uint32_t cq_head;             /* Next entry taken by the application */
+  uint32_t cq_tail;             /* Next entry filled by the kernel */
+};
+
+/* The memory of the rings, allocated by the application and shared with
+ * the kernel until the ring is closed.
+ */
+
+struct io_uring_params
+{
+  uint32_t cq_entries;                /* The size of the completion ring */
+  FAR struct io_uring_rings *rings;   /* The indices of both rings */
+  FAR struct io_uring_sqe *sqes;      /* The submission ring */
+  FAR struct io_uring_cqe *cqes;      /* The completion ring */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: io_uring_setup
+ *
+ * Description:
+ *   Create a ring file descriptor for the rings described by 'p', with
+ *   'entries' entries in the submission ring.  Both sizes must be powers of
+ *   two.
+ *
+ * Returned Value:
+ *   The new file descriptor on success.  Otherwise, -1 is returned and
+ *   errno is set: EINVAL if a size is not a power of two or too large,
+ *   ENOMEM, EMFILE.
+ *
+ ****************************************************************************/
+
+int io_uring_setup(unsigned int entries, FAR struct io_uring_params *p);
+
+/****************************************************************************
+ * Name: io_uring_enter
+ *
+ * Description:
+ *   Submit up to 'to_submit' entries of the submission ring, and with
+ *   IORING_ENTER_GETEVENTS wait until at least 'min_complete' completions
+ *   are in the completion ring.
+ *
+ * Returned Value:
+ *   The number of entries submitted.  Otherwise, -1 is returned and errno
+ *   is set: EBADF, EBUSY if no entry could be submitted because the
+ *   completion ring could overflow, EINTR.
+ *
+ ****************************************************************************/
+
+int io_uring_enter(int fd, unsigned int to_submit,
+                   unsigned int min_complete, unsigned int flags);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_SYS_IO_URING_H */
@@ -69,12 +69,29 @@
  *
  *      char myname[CONFIG_TASK_NAME_SIZE];
  *      prctl(PR_GET_NAME_EXT, myname, pid);
+ *
+ *  PR_SET_TIMERSLACK
+ *    Set the timer slack of the calling thread to the value in nanoseconds
+ *    of optional arg1 (unsigned long).  The expiration of the timed waits
+ *    of the thread is rounded up to a multiple of the slack so that nearby
+ *    timers expire together.  A value of zero resets the slack to the
+ *    default.  Requires CONFIG_SCHED_TIMER_SLACK.  As an example:
+ *
+ *      prctl(PR_SET_TIMERSLACK, 1000000);
+ *
+ *  PR_GET_TIMERSLACK
+ *    Return the timer slack of the calling thread in nanoseconds as the
+ *    returned value of prctl(), INT_MAX if it does not fit.  As an example:
+ *
+ *      slack = prctl(PR_GET_TIMERSLACK);
  */
 
-#define PR_SET_NAME     1
-#define PR_GET_NAME     2
-#define PR_SET_NAME_EXT 3
-#define PR_GET_NAME_EXT 4
+#define PR_SET_NAME       1
+#define PR_GET_NAME       2
+#define PR_SET_NAME_EXT   3
+#define PR_GET_NAME_EXT   4
+#define PR_SET_TIMERSLACK 5
+#define PR_GET_TIMERSLACK 6
 
 /****************************************************************************
  * Public Type Definitions
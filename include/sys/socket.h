@@ -136,9 +136,11 @@
 #define MSG_ERRQUEUE     0x002000 /* Fetch message from error queue.  */
 #define MSG_NOSIGNAL     0x004000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE         0x008000 /* Sender will send more.  */
+#define MSG_WAITFORONE   0x010000 /* recvmmsg(): block for the first message only */
 #define MSG_CMSG_CLOEXEC 0x100000 /* Set close_on_exit for file
                                    * descriptor received through SCM_RIGHTS.
                                    */
+#define MSG_ZEROCOPY    0x4000000 /* Send without copying, see SO_ZEROCOPY */
 
 /* Protocol levels supported by get/setsockopt(): */
 
@@ -220,6 +222,15 @@
 #define SO_PEERCRED     18 /* Return the credentials of the peer process
                             * connected to this socket.
                             */
+#define SO_REUSEPORT    19 /* Allow sockets to share a local port, spreading
+                            * the incoming traffic over them (get/set).
+                            * arg: pointer to integer containing a boolean
+                            * value
+                            */
+#define SO_ZEROCOPY     60 /* Allow MSG_ZEROCOPY sends and report their
+                            * completion on the error queue.
+                            * arg: integer value
+                            */
 
 /* The options are unsupported but included for compatibility
  * and portability
@@ -234,6 +245,7 @@
 #define SOL_IPV6        IPPROTO_IPV6 /* See options in include/netinet/ip6.h */
 #define SOL_TCP         IPPROTO_TCP  /* See options in include/netinet/tcp.h */
 #define SOL_UDP         IPPROTO_UDP  /* See options in include/netinit/udp.h */
+#define SOL_TLS         282          /* See options in include/netinet/tls.h */
 
 /* Bluetooth-level operations. */
 
@@ -242,6 +254,10 @@
 #define SOL_SCO         17 /* See options in include/netpacket/bluetooth.h */
 #define SOL_RFCOMM      18 /* See options in include/netpacket/bluetooth.h */
 
+/* Packet socket operations. */
+
+#define SOL_PACKET      263 /* See options in include/netpacket/packet.h */
+
 /* Protocol-level socket options may begin with this value */
 
 #define __SO_PROTOCOL  16
@@ -295,6 +311,16 @@
 #define SCM_SECURITY    0x03    /* rw: security label */
 #define SCM_TIMESTAMP   SO_TIMESTAMP
 
+/* Origins and codes of the extended errors read with MSG_ERRQUEUE */
+
+#define SO_EE_ORIGIN_NONE          0
+#define SO_EE_ORIGIN_LOCAL         1
+#define SO_EE_ORIGIN_ICMP          2
+#define SO_EE_ORIGIN_ICMP6         3
+#define SO_EE_ORIGIN_ZEROCOPY      5
+
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
+
 /* Desired design of maximum size and alignment (see RFC2553) */
 
 #define SS_MAXSIZE   128               /* Implementation-defined maximum size. */
@@ -370,6 +396,30 @@ struct msghdr
   unsigned int msg_flags;
 };
 
+/* One message of a sendmmsg()/recvmmsg() batch */
+
+struct mmsghdr
+{
+  struct msghdr msg_hdr;        /* The message */
+  unsigned int msg_len;         /* Number of bytes transferred */
+};
+
+/* Extended error read with MSG_ERRQUEUE as IP_RECVERR or IPV6_RECVERR
+ * control data.  A zero-copy completion reports that the MSG_ZEROCOPY
+ * sends numbered ee_info to ee_data no longer reference the user data.
+ */
+
+struct sock_extended_err
+{
+  uint32_t ee_errno;   /* Error number */
+  uint8_t  ee_origin;  /* Where the error originated, SO_EE_ORIGIN_* */
+  uint8_t  ee_type;    /* Type */
+  uint8_t  ee_code;    /* Code, SO_EE_CODE_* */
+  uint8_t  ee_pad;
+  uint32_t ee_info;    /* Additional information */
+  uint32_t ee_data;    /* Other data */
+};
+
 struct cmsghdr
 {
   unsigned long cmsg_len;       /* Data byte count, including hdr */
@@ -457,6 +507,12 @@ int getpeername(int sockfd, FAR struct sockaddr *addr,
 ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
 ssize_t sendmsg(int sockfd, FAR struct msghdr *msg, int flags);
 
+struct timespec; /* Forward reference */
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+
 #if CONFIG_FORTIFY_SOURCE > 0
 fortify_function(send) ssize_t send(int sockfd, FAR const void *buf,
                                     size_t len, int flags)
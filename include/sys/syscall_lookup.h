@@ -93,6 +93,13 @@ SYSCALL_LOOKUP(nxsem_wait,                 1)
   SYSCALL_LOOKUP(nxsem_getprioceiling,     2)
 #endif
 
+/* Futex wait/wake */
+
+#ifdef CONFIG_FUTEX
+  SYSCALL_LOOKUP(nxfutex_wait,             4)
+  SYSCALL_LOOKUP(nxfutex_wake,             2)
+#endif
+
 /* Named semaphores */
 
 #ifdef CONFIG_FS_NAMED_SEMAPHORES
@@ -168,7 +175,11 @@ SYSCALL_LOOKUP(clock_nanosleep,            4)
  */
 
 SYSCALL_LOOKUP(clock,                      0)
-SYSCALL_LOOKUP(clock_gettime,              2)
+#ifdef CONFIG_CLOCK_VDSO
+  SYSCALL_LOOKUP(nxclock_gettime,          2)
+#else
+  SYSCALL_LOOKUP(clock_gettime,            2)
+#endif
 SYSCALL_LOOKUP(clock_settime,              2)
 #ifdef CONFIG_CLOCK_TIMEKEEPING
   SYSCALL_LOOKUP(adjtime,                  2)
@@ -223,6 +234,10 @@ SYSCALL_LOOKUP(pwrite,                     4)
 #ifdef CONFIG_SIGNAL_FD
   SYSCALL_LOOKUP(signalfd,                 3)
 #endif
+#ifdef CONFIG_FS_URING
+  SYSCALL_LOOKUP(io_uring_setup,           2)
+  SYSCALL_LOOKUP(io_uring_enter,           4)
+#endif
 
 /* Board support */
 
@@ -274,6 +289,11 @@ SYSCALL_LOOKUP(munmap,                     2)
   SYSCALL_LOOKUP(nx_mkfifo,                3)
 #endif
 
+#ifdef CONFIG_PIPES
+  SYSCALL_LOOKUP(splice,                   6)
+  SYSCALL_LOOKUP(tee,                      4)
+#endif
+
 #ifndef CONFIG_DISABLE_MOUNTPOINT
   SYSCALL_LOOKUP(mount,                    5)
   SYSCALL_LOOKUP(mkdir,                    2)
@@ -308,7 +328,9 @@ SYSCALL_LOOKUP(munmap,                     2)
 /* The following are defined if pthreads are enabled */
 
 #ifndef CONFIG_DISABLE_PTHREAD
+#ifndef CONFIG_FUTEX
   SYSCALL_LOOKUP(pthread_barrier_wait,     1)
+#endif
   SYSCALL_LOOKUP(pthread_cancel,           1)
   SYSCALL_LOOKUP(pthread_cond_broadcast,   1)
   SYSCALL_LOOKUP(pthread_cond_signal,      1)
@@ -375,9 +397,11 @@ SYSCALL_LOOKUP(munmap,                     2)
   SYSCALL_LOOKUP(recv,                     4)
   SYSCALL_LOOKUP(recvfrom,                 6)
   SYSCALL_LOOKUP(recvmsg,                  3)
+  SYSCALL_LOOKUP(recvmmsg,                 5)
   SYSCALL_LOOKUP(send,                     4)
   SYSCALL_LOOKUP(sendto,                   6)
   SYSCALL_LOOKUP(sendmsg,                  3)
+  SYSCALL_LOOKUP(sendmmsg,                 4)
   SYSCALL_LOOKUP(setsockopt,               5)
   SYSCALL_LOOKUP(shutdown,                 2)
   SYSCALL_LOOKUP(socket,                   3)
@@ -808,6 +808,24 @@ typedef struct v4l2_buffer v4l2_buffer_t;
 
 #define V4L2_BUF_FLAG_LAST                      0x00100000
 
+/* struct v4l2_exportbuffer
+ * Parameter of ioctl(VIDIOC_EXPBUF).  The buffer of a queue is returned
+ * as a DMA buffer file descriptor (see include/nuttx/video/dmabuf.h) that
+ * may be queued to another driver with V4L2_MEMORY_DMABUF.
+ */
+
+struct v4l2_exportbuffer
+{
+  uint32_t type;                  /* enum #v4l2_buf_type */
+  uint32_t index;                 /* Buffer id */
+  uint32_t plane;                 /* Plane, only 0 is supported */
+  uint32_t flags;                 /* O_CLOEXEC or 0 */
+  int32_t  fd;                    /* Driver sets the file descriptor */
+  uint32_t reserved[11];
+};
+
+typedef struct v4l2_exportbuffer v4l2_exportbuffer_t;
+
 struct v4l2_fmtdesc
 {
   uint16_t index;                           /* Format number      */
@@ -1470,7 +1488,9 @@ struct v4l2_decoder_cmd
 
 #define VIDIOC_QBUF                   _VIDIOC(0x000f)
 
-/* Export a buffer as a DMABUF file descriptor */
+/* Export a buffer as a DMABUF file descriptor
+ * Address pointing to struct v4l2_exportbuffer
+ */
 
 #define VIDIOC_EXPBUF                 _VIDIOC(0x0010)
 
@@ -0,0 +1,61 @@
+/****************************************************************************
+ * libs/libc/dirent/lib_getdents.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dirent.h>
+#include <unistd.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: getdents
+ *
+ * Description:
+ *   The getdents() function reads as many directory entries as fit into
+ *   the buffer from the directory open on 'fd', with a single call into
+ *   the file system.  The entries are consecutive struct dirent instances.
+ *   lseek() with SEEK_CUR returns the position after the last entry read,
+ *   to be used with seekdir().
+ *
+ * Input Parameters:
+ *   fd    -- A file descriptor of an open directory, like from dirfd()
+ *   dirp  -- The buffer to receive the entries
+ *   count -- The size of the buffer, at least sizeof(struct dirent)
+ *
+ * Returned Value:
+ *   The number of bytes read, a multiple of sizeof(struct dirent), or 0 at
+ *   the end of the directory.  On error, -1 is returned, and errno is set
+ *   to indicate the cause of the error.
+ *
+ *   EINVAL - The buffer is too small for one entry.
+ *
+ ****************************************************************************/
+
+ssize_t getdents(int fd, FAR void *dirp, size_t count)
+{
+  return read(fd, dirp, count);
+}
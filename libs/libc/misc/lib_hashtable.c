@@ -0,0 +1,264 @@
+/****************************************************************************
+ * libs/libc/misc/lib_hashtable.c
+ *
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+
+#include <nuttx/hashtable.h>
+#include <nuttx/lib/lib.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of old buckets moved by each insertion or removal during a
+ * resize.  Moving two buckets per operation finishes a resize before the
+ * table needs the next one.
+ */
+
+#define RHASHTABLE_MOVE 2
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rhashtable_bucket
+ *
+ * Description:
+ *   Return the bucket of a hash value.  The entries of an old bucket that
+ *   has not been moved yet stay there, new entries of that bucket are
+ *   added there too, so that each hash value has exactly one bucket.
+ *
+ ****************************************************************************/
+
+static FAR hash_head_t *rhashtable_bucket(FAR struct rhashtable_s *table,
+                                          uint32_t hash)
+{
+  if (table->old != NULL && (hash & table->oldmask) >= table->oldpos)
+    {
+      return &table->old[hash & table->oldmask];
+    }
+
+  return &table->buckets[hash & table->mask];
+}
+
+/****************************************************************************
+ * Name: rhashtable_alloc
+ ****************************************************************************/
+
+static FAR hash_head_t *rhashtable_alloc(uint32_t mask)
+{
+  FAR hash_head_t *buckets;
+  uint32_t i;
+
+  buckets = lib_malloc((mask + 1) * sizeof(hash_head_t));
+  if (buckets != NULL)
+    {
+      for (i = 0; i <= mask; i++)
+        {
+          dq_init(&buckets[i]);
+        }
+    }
+
+  return buckets;
+}
+
+/****************************************************************************
+ * Name: rhashtable_move
+ *
+ * Description:
+ *   Move some buckets of the old array to the current one, free the old
+ *   array once it is empty.
+ *
+ ****************************************************************************/
+
+static void rhashtable_move(FAR struct rhashtable_s *table)
+{
+  FAR rhash_node_t *node;
+  FAR hash_head_t *bucket;
+  int i;
+
+  for (i = 0; i < RHASHTABLE_MOVE && table->old != NULL; i++)
+    {
+      bucket = &table->old[table->oldpos];
+      while ((node = (FAR rhash_node_t *)dq_remfirst(bucket)) != NULL)
+        {
+          dq_addlast(&node->node, &table->buckets[node->hash & table->mask]);
+        }
+
+      if (table->oldpos++ == table->oldmask)
+        {
+          lib_free(table->old);
+          table->old = NULL;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: rhashtable_resize
+ *
+ * Description:
+ *   Start moving the entries to a new array of buckets.
+ *
+ ****************************************************************************/
+
+static void rhashtable_resize(FAR struct rhashtable_s *table, uint32_t mask)
+{
+  FAR hash_head_t *buckets;
+
+  buckets = rhashtable_alloc(mask);
+  if (buckets == NULL)
+    {
+      return;
+    }
+
+  table->old     = table->buckets;
+  table->oldmask = table->mask;
+  table->oldpos  = 0;
+  table->buckets = buckets;
+  table->mask    = mask;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rhashtable_init
+ ****************************************************************************/
+
+int rhashtable_init(FAR struct rhashtable_s *table, unsigned int bits)
+{
+  DEBUGASSERT(bits < 32);
+
+  table->mask    = (1u << bits) - 1;
+  table->minmask = table->mask;
+  table->buckets = rhashtable_alloc(table->mask);
+  if (table->buckets == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  table->old   = NULL;
+  table->count = 0;
+  table->seed  = arc4random();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: rhashtable_fini
+ ****************************************************************************/
+
+void rhashtable_fini(FAR struct rhashtable_s *table)
+{
+  lib_free(table->old);
+  lib_free(table->buckets);
+  table->old     = NULL;
+  table->buckets = NULL;
+}
+
+/****************************************************************************
+ * Name: rhashtable_add
+ ****************************************************************************/
+
+void rhashtable_add(FAR struct rhashtable_s *table, FAR rhash_node_t *node,
+                    uint32_t hash)
+{
+  node->hash = hash;
+  dq_addfirst(&node->node, rhashtable_bucket(table, hash));
+  table->count++;
+
+  /* Grow once there are more entries than buckets */
+
+  if (table->old == NULL && table->count > table->mask &&
+      table->mask < (UINT32_MAX >> 1))
+    {
+      rhashtable_resize(table, (table->mask << 1) | 1);
+    }
+
+  rhashtable_move(table);
+}
+
+/****************************************************************************
+ * Name: rhashtable_delete
+ ****************************************************************************/
+
+void rhashtable_delete(FAR struct rhashtable_s *table,
+                       FAR rhash_node_t *node)
+{
+  dq_rem(&node->node, rhashtable_bucket(table, node->hash));
+  table->count--;
+
+  /* Shrink once a quarter of the buckets would do */
+
+  if (table->old == NULL && table->mask > table->minmask &&
+      table->count < (table->mask >> 2))
+    {
+      rhashtable_resize(table, table->mask >> 1);
+    }
+
+  rhashtable_move(table);
+}
+
+/****************************************************************************
+ * Name: rhashtable_first
+ ****************************************************************************/
+
+FAR rhash_node_t *rhashtable_first(FAR struct rhashtable_s *table,
+                                   uint32_t hash)
+{
+  FAR rhash_node_t *node;
+
+  node = (FAR rhash_node_t *)dq_peek(rhashtable_bucket(table, hash));
+  while (node != NULL && node->hash != hash)
+    {
+      node = (FAR rhash_node_t *)dq_next(&node->node);
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: rhashtable_next
+ ****************************************************************************/
+
+FAR rhash_node_t *rhashtable_next(FAR rhash_node_t *node)
+{
+  uint32_t hash = node->hash;
+
+  do
+    {
+      node = (FAR rhash_node_t *)dq_next(&node->node);
+    }
+  while (node != NULL && node->hash != hash);
+
+  return node;
+}
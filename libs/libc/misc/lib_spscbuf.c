@@ -0,0 +1,328 @@
+/****************************************************************************
+ * libs/libc/misc/lib_spscbuf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+
+#include <nuttx/spscbuf.h>
+#include <nuttx/lib/lib.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spscbuf_count
+ *
+ * Description:
+ *   Return the number of bytes between the indexes 'tail' and 'head'.
+ *
+ ****************************************************************************/
+
+static inline unsigned int spscbuf_count(FAR struct spscbuf_s *buf,
+                                         unsigned int head,
+                                         unsigned int tail)
+{
+  return head >= tail ? head - tail : head + 2 * buf->size - tail;
+}
+
+/****************************************************************************
+ * Name: spscbuf_advance
+ ****************************************************************************/
+
+static inline unsigned int spscbuf_advance(FAR struct spscbuf_s *buf,
+                                           unsigned int index,
+                                           size_t bytes)
+{
+  index += bytes;
+  if (index >= 2 * buf->size)
+    {
+      index -= 2 * buf->size;
+    }
+
+  return index;
+}
+
+/****************************************************************************
+ * Name: spscbuf_offset
+ *
+ * Description:
+ *   Return the offset in the buffer space of an index.
+ *
+ ****************************************************************************/
+
+static inline unsigned int spscbuf_offset(FAR struct spscbuf_s *buf,
+                                          unsigned int index)
+{
+  return index >= buf->size ? index - buf->size : index;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spscbuf_init
+ ****************************************************************************/
+
+int spscbuf_init(FAR struct spscbuf_s *buf, FAR void *base, size_t bytes)
+{
+  DEBUGASSERT(buf);
+  DEBUGASSERT(!base || bytes);
+
+  if (bytes > UINT_MAX / 2)
+    {
+      return -EINVAL;
+    }
+
+  buf->external = !!base;
+
+  if (!base && bytes)
+    {
+      base = lib_malloc(bytes);
+      if (!base)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  buf->base      = base;
+  buf->size      = bytes;
+  buf->tailcache = 0;
+  buf->headcache = 0;
+  atomic_store_explicit(&buf->head, 0, memory_order_relaxed);
+  atomic_store_explicit(&buf->tail, 0, memory_order_release);
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: spscbuf_uninit
+ ****************************************************************************/
+
+void spscbuf_uninit(FAR struct spscbuf_s *buf)
+{
+  DEBUGASSERT(buf);
+
+  if (!buf->external)
+    {
+      lib_free(buf->base);
+    }
+
+  buf->base = NULL;
+  buf->size = 0;
+  spscbuf_reset(buf);
+}
+
+/****************************************************************************
+ * Name: spscbuf_reset
+ ****************************************************************************/
+
+void spscbuf_reset(FAR struct spscbuf_s *buf)
+{
+  DEBUGASSERT(buf);
+
+  buf->tailcache = 0;
+  buf->headcache = 0;
+  atomic_store_explicit(&buf->head, 0, memory_order_relaxed);
+  atomic_store_explicit(&buf->tail, 0, memory_order_release);
+}
+
+/****************************************************************************
+ * Name: spscbuf_used
+ ****************************************************************************/
+
+size_t spscbuf_used(FAR struct spscbuf_s *buf)
+{
+  unsigned int tail = atomic_load_explicit(&buf->tail, memory_order_acquire);
+  unsigned int head = atomic_load_explicit(&buf->head, memory_order_acquire);
+
+  return spscbuf_count(buf, head, tail);
+}
+
+/****************************************************************************
+ * Name: spscbuf_space
+ ****************************************************************************/
+
+size_t spscbuf_space(FAR struct spscbuf_s *buf)
+{
+  unsigned int head = atomic_load_explicit(&buf->head, memory_order_acquire);
+  unsigned int tail = atomic_load_explicit(&buf->tail, memory_order_acquire);
+
+  return buf->size - spscbuf_count(buf, head, tail);
+}
+
+/****************************************************************************
+ * Name: spscbuf_is_empty
+ ****************************************************************************/
+
+bool spscbuf_is_empty(FAR struct spscbuf_s *buf)
+{
+  return spscbuf_used(buf) == 0;
+}
+
+/****************************************************************************
+ * Name: spscbuf_reserve
+ ****************************************************************************/
+
+FAR void *spscbuf_reserve(FAR struct spscbuf_s *buf, FAR size_t *size)
+{
+  unsigned int head = atomic_load_explicit(&buf->head, memory_order_relaxed);
+  unsigned int used = spscbuf_count(buf, head, buf->tailcache);
+  unsigned int off = spscbuf_offset(buf, head);
+
+  /* Only look at the tail of the consumer when the space known so far is
+   * used up, the acquire pairs with the release in spscbuf_consume().
+   */
+
+  if (used == buf->size)
+    {
+      buf->tailcache = atomic_load_explicit(&buf->tail,
+                                            memory_order_acquire);
+      used = spscbuf_count(buf, head, buf->tailcache);
+    }
+
+  *size = MIN(buf->size - used, buf->size - off);
+  return buf->base + off;
+}
+
+/****************************************************************************
+ * Name: spscbuf_commit
+ ****************************************************************************/
+
+void spscbuf_commit(FAR struct spscbuf_s *buf, size_t bytes)
+{
+  unsigned int head = atomic_load_explicit(&buf->head, memory_order_relaxed);
+
+  DEBUGASSERT(bytes <= buf->size - spscbuf_count(buf, head,
+                                                 buf->tailcache));
+
+  atomic_store_explicit(&buf->head, spscbuf_advance(buf, head, bytes),
+                        memory_order_release);
+}
+
+/****************************************************************************
+ * Name: spscbuf_write
+ ****************************************************************************/
+
+size_t spscbuf_write(FAR struct spscbuf_s *buf, FAR const void *src,
+                     size_t bytes)
+{
+  FAR void *dst;
+  size_t written = 0;
+  size_t size;
+
+  /* The free space is at most two contiguous regions */
+
+  while (written < bytes)
+    {
+      dst = spscbuf_reserve(buf, &size);
+      if (size == 0)
+        {
+          break;
+        }
+
+      size = MIN(size, bytes - written);
+      memcpy(dst, (FAR const uint8_t *)src + written, size);
+      spscbuf_commit(buf, size);
+      written += size;
+    }
+
+  return written;
+}
+
+/****************************************************************************
+ * Name: spscbuf_peek
+ ****************************************************************************/
+
+FAR void *spscbuf_peek(FAR struct spscbuf_s *buf, FAR size_t *size)
+{
+  unsigned int tail = atomic_load_explicit(&buf->tail, memory_order_relaxed);
+  unsigned int used = spscbuf_count(buf, buf->headcache, tail);
+  unsigned int off = spscbuf_offset(buf, tail);
+
+  /* Only look at the head of the producer when the data known so far is
+   * used up, the acquire pairs with the release in spscbuf_commit().
+   */
+
+  if (used == 0)
+    {
+      buf->headcache = atomic_load_explicit(&buf->head,
+                                            memory_order_acquire);
+      used = spscbuf_count(buf, buf->headcache, tail);
+    }
+
+  *size = MIN(used, buf->size - off);
+  return buf->base + off;
+}
+
+/****************************************************************************
+ * Name: spscbuf_consume
+ ****************************************************************************/
+
+void spscbuf_consume(FAR struct spscbuf_s *buf, size_t bytes)
+{
+  unsigned int tail = atomic_load_explicit(&buf->tail, memory_order_relaxed);
+
+  DEBUGASSERT(bytes <= spscbuf_count(buf, buf->headcache, tail));
+
+  atomic_store_explicit(&buf->tail, spscbuf_advance(buf, tail, bytes),
+                        memory_order_release);
+}
+
+/****************************************************************************
+ * Name: spscbuf_read
+ ****************************************************************************/
+
+size_t spscbuf_read(FAR struct spscbuf_s *buf, FAR void *dst, size_t bytes)
+{
+  FAR void *src;
+  size_t nread = 0;
+  size_t size;
+
+  /* The data is at most two contiguous regions */
+
+  while (nread < bytes)
+    {
+      src = spscbuf_peek(buf, &size);
+      if (size == 0)
+        {
+          break;
+        }
+
+      size = MIN(size, bytes - nread);
+      memcpy((FAR uint8_t *)dst + nread, src, size);
+      spscbuf_consume(buf, size);
+      nread += size;
+    }
+
+  return nread;
+}
@@ -140,6 +140,47 @@ int modlib_insertsymtab(FAR struct module_s *modp,
                         FAR Elf_Shdr *shdr,
                         FAR Elf_Sym *sym);
 
+/****************************************************************************
+ * Name: modlib_findexport
+ *
+ * Description:
+ *   Find a symbol that a module exports, through the hash index of its
+ *   symbol table if it has one.
+ *
+ * Input Parameters:
+ *   modp - Module state information
+ *   name - The name of the symbol
+ *
+ * Returned Value:
+ *   The symbol table entry; NULL if the module does not export the symbol.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+modlib_findexport(FAR struct module_s *modp, FAR const char *name);
+
+/****************************************************************************
+ * Name: modlib_findsymbol
+ *
+ * Description:
+ *   Find a symbol in a symbol table of the base code.  The kernel symbol
+ *   table selected by modlib_setsymtab() is searched through its hash
+ *   index, which is built on the first use.
+ *
+ * Input Parameters:
+ *   exports  - Pointer to the symbol table
+ *   nexports - Number of symbols in the symbol table
+ *   name     - The name of the symbol
+ *
+ * Returned Value:
+ *   The symbol table entry; NULL if the table has no such symbol.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+modlib_findsymbol(FAR const struct symtab_s *exports, int nexports,
+                  FAR const char *name);
+
 /****************************************************************************
  * Name: modlib_findglobal
  *
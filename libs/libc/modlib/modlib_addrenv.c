@@ -52,6 +52,60 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: modlib_addrenv_share
+ *
+ * Description:
+ *   Create the address environment of a fully linked executable on the
+ *   .text pages of loadinfo->textenv.  Those pages are the same in every
+ *   instance, the first load allocates a new owner of .text for the later
+ *   ones.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_SHARED_TEXT
+static int modlib_addrenv_share(FAR struct mod_loadinfo_s *loadinfo,
+                                size_t textsize, size_t datasize,
+                                size_t heapsize)
+{
+  int ret;
+
+  if (loadinfo->textenv == NULL)
+    {
+      loadinfo->textenv = addrenv_allocate();
+      if (loadinfo->textenv == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      loadinfo->textvalid = false;
+
+      ret = up_addrenv_create(textsize, 0, 0, &loadinfo->textenv->addrenv);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  ret = up_addrenv_create_shared(&loadinfo->textenv->addrenv, textsize,
+                                 datasize, heapsize,
+                                 &loadinfo->addrenv->addrenv);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The .text pages live as long as the address environment */
+
+  addrenv_take(loadinfo->textenv);
+  loadinfo->addrenv->text = loadinfo->textenv;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -105,7 +159,17 @@ int modlib_addrenv_alloc(FAR struct mod_loadinfo_s *loadinfo,
 
   addrenv = &loadinfo->addrenv->addrenv;
 
-  ret = up_addrenv_create(textsize, datasize, heapsize, addrenv);
+#ifdef CONFIG_ELF_SHARED_TEXT
+  if (loadinfo->ehdr.e_type == ET_EXEC)
+    {
+      ret = modlib_addrenv_share(loadinfo, textsize, datasize, heapsize);
+    }
+  else
+#endif
+    {
+      ret = up_addrenv_create(textsize, datasize, heapsize, addrenv);
+    }
+
   if (ret < 0)
     {
       berr("ERROR: up_addrenv_create failed: %d\n", ret);
@@ -1053,7 +1053,7 @@ int modlib_bind(FAR struct module_s *modp,
    * contents to memory and invalidating the I cache).
    */
 
-  if (loadinfo->textsize > 0)
+  if (loadinfo->textsize > 0 && loadinfo->xipbase == 0)
     {
       up_coherent_dcache(loadinfo->textalloc, loadinfo->textsize);
     }
@@ -76,6 +76,10 @@ static inline int modlib_fileinfo(FAR struct mod_loadinfo_s *loadinfo)
   loadinfo->fileuid  = buf.st_uid;
   loadinfo->filegid  = buf.st_gid;
   loadinfo->filemode = buf.st_mode;
+#ifdef CONFIG_ELF_SHARED_TEXT
+  loadinfo->fileino   = buf.st_ino;
+  loadinfo->filemtime = buf.st_mtim;
+#endif
   return OK;
 }
 
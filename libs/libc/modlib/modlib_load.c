@@ -103,10 +103,11 @@ static int modlib_section_alloc(FAR struct mod_loadinfo_s *loadinfo,
     }
   else if (loadinfo->xipbase != 0)
     {
-      loadinfo->sectalloc[idx] = loadinfo->xipbase + shdr->sh_offset;
+      /* Executed in place, there is nothing to allocate or to free */
+
       if (loadinfo->textalloc == 0)
         {
-          loadinfo->textalloc = loadinfo->sectalloc[idx];
+          loadinfo->textalloc = loadinfo->xipbase + shdr->sh_offset;
         }
     }
   else
@@ -275,6 +276,60 @@ static int modlib_vma2lma(FAR struct mod_loadinfo_s *loadinfo,
 }
 #endif
 
+/****************************************************************************
+ * Name: modlib_xipbase
+ *
+ * Description:
+ *   Find the GOT and, if the file can be executed in place, its address.
+ *   The read-only sections of a position independent file reach the data
+ *   through the GOT and are never written by the relocations, so they can
+ *   stay where they are on memory mapped storage, as long as their
+ *   alignment is kept there.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+static void modlib_xipbase(FAR struct mod_loadinfo_s *loadinfo)
+{
+  uintptr_t xipbase = 0;
+  int i;
+
+  loadinfo->gotindex = modlib_findsection(loadinfo, ".got");
+  if (loadinfo->gotindex < 0)
+    {
+      return;
+    }
+
+  binfo("GOT section found! index %d\n", loadinfo->gotindex);
+
+  /* A shared object is loaded as one block with its data */
+
+  if (loadinfo->ehdr.e_type == ET_DYN ||
+      ioctl(loadinfo->filfd, FIOC_XIPBASE,
+            (unsigned long)&xipbase) < 0 || xipbase == 0)
+    {
+      return;
+    }
+
+  for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      FAR Elf_Shdr *shdr = &loadinfo->shdr[i];
+
+      if ((shdr->sh_flags & (SHF_ALLOC | SHF_WRITE)) == SHF_ALLOC &&
+          shdr->sh_addralign > 1 &&
+          ((xipbase + shdr->sh_offset) & (shdr->sh_addralign - 1)) != 0)
+        {
+          binfo("Section %d is misaligned in place, copy the file\n", i);
+          return;
+        }
+    }
+
+  binfo("can use xipbase %zu\n", xipbase);
+  loadinfo->xipbase = xipbase;
+}
+
 /****************************************************************************
  * Name: modlib_set_emptysect_vma
  *
@@ -325,6 +380,7 @@ static inline int modlib_loadfile(FAR struct mod_loadinfo_s *loadinfo)
 {
   FAR uint8_t *text = (FAR uint8_t *)loadinfo->textalloc;
   FAR uint8_t *data = (FAR uint8_t *)loadinfo->datastart;
+  FAR uint8_t *xip;
   int ret;
   int i;
 
@@ -421,9 +477,22 @@ static inline int modlib_loadfile(FAR struct mod_loadinfo_s *loadinfo)
 
           if ((shdr->sh_flags & SHF_WRITE) == 0 && loadinfo->xipbase != 0)
             {
+              /* Execute in place, wherever the section is in the file */
+
+              xip  = (FAR uint8_t *)(loadinfo->xipbase + shdr->sh_offset);
+              pptr = &xip;
               goto skipload;
             }
 
+#ifdef CONFIG_ELF_SHARED_TEXT
+          if (pptr == &text && loadinfo->textvalid)
+            {
+              /* The shared .text is already there */
+
+              goto skipload;
+            }
+#endif
+
           /* SHT_NOBITS indicates that there is no data in the file for the
            * section.
            */
@@ -550,16 +619,7 @@ int modlib_load(FAR struct mod_loadinfo_s *loadinfo)
       goto errout_with_buffers;
     }
 
-  loadinfo->gotindex = modlib_findsection(loadinfo, ".got");
-  if (loadinfo->gotindex >= 0)
-    {
-      binfo("GOT section found! index %d\n", loadinfo->gotindex);
-      if (ioctl(loadinfo->filfd, FIOC_XIPBASE,
-                (unsigned long)&loadinfo->xipbase) >= 0)
-        {
-          binfo("can use xipbase %zu\n", loadinfo->xipbase);
-        }
-    }
+  modlib_xipbase(loadinfo);
 
   /* Determine total size to allocate */
 
@@ -706,16 +766,11 @@ int modlib_load_with_addrenv(FAR struct mod_loadinfo_s *loadinfo)
       goto errout_with_buffers;
     }
 
+  /* The text is copied into the address environment, the storage is not
+   * mapped there.
+   */
+
   loadinfo->gotindex = modlib_findsection(loadinfo, ".got");
-  if (loadinfo->gotindex >= 0)
-    {
-      binfo("GOT section found! index %d\n", loadinfo->gotindex);
-      if (ioctl(loadinfo->filfd, FIOC_XIPBASE,
-                (unsigned long)&loadinfo->xipbase) >= 0)
-        {
-          binfo("can use xipbase %zu\n", loadinfo->xipbase);
-        }
-    }
 
   /* Determine total size to allocate */
 
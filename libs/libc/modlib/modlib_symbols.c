@@ -203,9 +203,7 @@ static int modlib_symcallback(FAR struct module_s *modp, FAR void *arg)
 
   /* Check if this module exports a symbol of that name */
 
-  exportinfo->symbol = symtab_findbyname(modp->modinfo.exports,
-                                         exportinfo->name,
-                                         modp->modinfo.nexports);
+  exportinfo->symbol = modlib_findexport(modp, exportinfo->name);
 
   if (exportinfo->symbol != NULL)
     {
@@ -408,8 +406,7 @@ int modlib_symvalue(FAR struct module_s *modp,
 
         if (symbol == NULL)
           {
-            symbol = symtab_findbyname(exports, exportinfo.name,
-                                       nexports);
+            symbol = modlib_findsymbol(exports, nexports, exportinfo.name);
           }
 
         /* Was the symbol found from any exporter? */
@@ -545,6 +542,12 @@ int modlib_insertsymtab(FAR struct module_s *modp,
 #ifdef CONFIG_SYMTAB_ORDEREDBYNAME
           symtab_sortbyname(symbol, symcount);
 #endif
+
+#ifdef CONFIG_SYMTAB_HASHED
+          /* Without the index the lookups are only slower */
+
+          modp->exphash = symtab_hash_create(symbol, symcount);
+#endif
         }
       else
         {
@@ -639,4 +642,46 @@ void modlib_freesymtab(FAR struct module_s *modp)
 
       lib_free((FAR void *)symbol);
     }
+
+#ifdef CONFIG_SYMTAB_HASHED
+  if (modp->exphash != NULL)
+    {
+      symtab_hash_destroy(modp->exphash);
+      modp->exphash = NULL;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: modlib_findexport
+ *
+ * Description:
+ *   Find a symbol that a module exports, through the hash index of its
+ *   symbol table if it has one.
+ *
+ * Input Parameters:
+ *   modp - Module state information
+ *   name - The name of the symbol
+ *
+ * Returned Value:
+ *   The symbol table entry; NULL if the module does not export the symbol.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+modlib_findexport(FAR struct module_s *modp, FAR const char *name)
+{
+#ifdef CONFIG_SYMTAB_HASHED
+  /* The module may have replaced the table in its initializer */
+
+  if (modp->exphash != NULL &&
+      modp->exphash->symtab == modp->modinfo.exports &&
+      modp->exphash->nsyms == modp->modinfo.nexports)
+    {
+      return symtab_findbyhash(modp->exphash, name);
+    }
+#endif
+
+  return symtab_findbyname(modp->modinfo.exports, name,
+                           modp->modinfo.nexports);
 }
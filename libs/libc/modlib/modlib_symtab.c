@@ -32,6 +32,8 @@
 #include <nuttx/lib/modlib.h>
 #include <nuttx/symtab.h>
 
+#include "modlib/modlib.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -66,6 +68,12 @@ extern int CONFIG_MODLIB_NSYMBOLS_VAR;
 static FAR const struct symtab_s *g_modlib_symtab;
 static int g_modlib_nsymbols;
 
+#ifdef CONFIG_SYMTAB_HASHED
+/* Hash index of g_modlib_symtab, built on the first lookup */
+
+static FAR struct symtab_hash_s *g_modlib_symhash;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -128,5 +136,62 @@ void modlib_setsymtab(FAR const struct symtab_s *symtab, int nsymbols)
   modlib_registry_lock();
   g_modlib_symtab   = symtab;
   g_modlib_nsymbols = nsymbols;
+
+#ifdef CONFIG_SYMTAB_HASHED
+  if (g_modlib_symhash != NULL)
+    {
+      symtab_hash_destroy(g_modlib_symhash);
+      g_modlib_symhash = NULL;
+    }
+#endif
+
+  modlib_registry_unlock();
+}
+
+/****************************************************************************
+ * Name: modlib_findsymbol
+ *
+ * Description:
+ *   Find a symbol in a symbol table of the base code.  The kernel symbol
+ *   table selected by modlib_setsymtab() is searched through its hash
+ *   index, which is built on the first use.
+ *
+ * Input Parameters:
+ *   exports  - Pointer to the symbol table
+ *   nexports - Number of symbols in the symbol table
+ *   name     - The name of the symbol
+ *
+ * Returned Value:
+ *   The symbol table entry; NULL if the table has no such symbol.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+modlib_findsymbol(FAR const struct symtab_s *exports, int nexports,
+                  FAR const char *name)
+{
+#ifdef CONFIG_SYMTAB_HASHED
+  FAR const struct symtab_s *symbol;
+
+  modlib_registry_lock();
+  if (exports != NULL && exports == g_modlib_symtab &&
+      nexports == g_modlib_nsymbols)
+    {
+      if (g_modlib_symhash == NULL)
+        {
+          g_modlib_symhash = symtab_hash_create(exports, nexports);
+        }
+
+      if (g_modlib_symhash != NULL)
+        {
+          symbol = symtab_findbyhash(g_modlib_symhash, name);
+          modlib_registry_unlock();
+          return symbol;
+        }
+    }
+
   modlib_registry_unlock();
+#endif
+
+  return symtab_findbyname(exports, name, nexports);
 }
@@ -66,6 +66,13 @@ int modlib_uninitialize(FAR struct mod_loadinfo_s *loadinfo)
       loadinfo->filfd = -1;
     }
 
+#ifdef CONFIG_ELF_SHARED_TEXT
+  /* Release the owner of the .text, addrenv holds its own reference */
+
+  addrenv_drop(loadinfo->textenv, false);
+  loadinfo->textenv = NULL;
+#endif
+
   return OK;
 }
 
@@ -0,0 +1,173 @@
+/****************************************************************************
+ * libs/libc/pthread/pthread_barrier_futex.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+#include <errno.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/futex.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BARRIER_ARRIVED(b)  ((FAR atomic_uint *)&(b)->arrived)
+#define BARRIER_CYCLE(b)    ((FAR atomic_uint *)&(b)->cycle)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_barrier_init
+ *
+ * Description:
+ *   The pthread_barrier_init() function initializes the barrier referenced
+ *   by 'barrier'.  The barrier needs no kernel resources.
+ *
+ * Input Parameters:
+ *   barrier - the barrier to be initialized
+ *   attr - barrier attributes to be used in the initialization.
+ *   count - the number of threads that must call pthread_barrier_wait()
+ *     before any of them successfully return from the call.
+ *
+ * Returned Value:
+ *   0 (OK) on success or EINVAL if 'barrier' is NULL or 'count' is zero.
+ *
+ ****************************************************************************/
+
+int pthread_barrier_init(FAR pthread_barrier_t *barrier,
+                         FAR const pthread_barrierattr_t *attr,
+                         unsigned int count)
+{
+  UNUSED(attr);
+
+  if (!barrier || count == 0)
+    {
+      return EINVAL;
+    }
+
+  barrier->count   = count;
+  barrier->arrived = 0;
+  barrier->cycle   = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pthread_barrier_destroy
+ *
+ * Description:
+ *   The pthread_barrier_destroy() function destroys the barrier referenced
+ *   by 'barrier'.
+ *
+ * Input Parameters:
+ *   barrier - the barrier to be destroyed
+ *
+ * Returned Value:
+ *   0 (OK) on success, EINVAL if 'barrier' is NULL or EBUSY if threads are
+ *   waiting on the barrier.
+ *
+ ****************************************************************************/
+
+int pthread_barrier_destroy(FAR pthread_barrier_t *barrier)
+{
+  if (!barrier)
+    {
+      return EINVAL;
+    }
+
+  if (atomic_load(BARRIER_ARRIVED(barrier)) != 0)
+    {
+      return EBUSY;
+    }
+
+  barrier->count = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pthread_barrier_wait
+ *
+ * Description:
+ *   The pthread_barrier_wait() function synchronizes participating threads
+ *   at the barrier referenced by 'barrier'.  The calling thread blocks until
+ *   the required number of threads have called pthread_barrier_wait().
+ *
+ *   Arrival is counted with an atomic operation in user space.  Only the
+ *   threads that have to wait, and the last thread to arrive if anybody
+ *   waits, enter the kernel.
+ *
+ * Input Parameters:
+ *   barrier - the barrier to wait on
+ *
+ * Returned Value:
+ *   PTHREAD_BARRIER_SERIAL_THREAD is returned to one arbitrary thread and
+ *   zero to each of the other threads.  EINVAL is returned if 'barrier' is
+ *   NULL.
+ *
+ ****************************************************************************/
+
+int pthread_barrier_wait(FAR pthread_barrier_t *barrier)
+{
+  unsigned int cycle;
+
+  if (!barrier)
+    {
+      return EINVAL;
+    }
+
+  cycle = atomic_load(BARRIER_CYCLE(barrier));
+
+  if (atomic_fetch_add(BARRIER_ARRIVED(barrier), 1) + 1 >= barrier->count)
+    {
+      /* We are the last to arrive.  Reset the barrier for the next cycle
+       * before releasing the others.
+       */
+
+      atomic_store(BARRIER_ARRIVED(barrier), 0);
+      atomic_fetch_add(BARRIER_CYCLE(barrier), 1);
+
+      if (barrier->count > 1)
+        {
+          nxfutex_wake(&barrier->cycle, INT_MAX);
+        }
+
+      return PTHREAD_BARRIER_SERIAL_THREAD;
+    }
+
+  /* Wakeups may be spurious, so wait until the cycle has advanced */
+
+  while (atomic_load(BARRIER_CYCLE(barrier)) == cycle)
+    {
+      nxfutex_wait(&barrier->cycle, cycle, CLOCK_REALTIME, NULL);
+    }
+
+  return OK;
+}
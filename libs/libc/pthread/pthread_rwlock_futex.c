@@ -0,0 +1,282 @@
+/****************************************************************************
+ * libs/libc/pthread/pthread_rwlock_futex.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+#include <errno.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/futex.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RWLOCK_STATE(l)       ((FAR atomic_uint *)&(l)->state)
+#define RWLOCK_WAITERS(l)     ((FAR atomic_uint *)&(l)->waiters)
+#define RWLOCK_SEQ(l)         ((FAR atomic_uint *)&(l)->seq)
+
+/* Waiting readers are counted in the low half of 'waiters' and waiting
+ * writers in the high half.  New readers stay out while a writer waits.
+ */
+
+#define RWLOCK_READER_WAITER  0x00000001
+#define RWLOCK_WRITER_WAITER  0x00010000
+
+#define RWLOCK_MAX_READERS    (PTHREAD_RWLOCK_WRITER - 1)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int tryrdlock(FAR pthread_rwlock_t *rw_lock)
+{
+  unsigned int state = atomic_load(RWLOCK_STATE(rw_lock));
+
+  do
+    {
+      if ((state & PTHREAD_RWLOCK_WRITER) != 0 ||
+          atomic_load(RWLOCK_WAITERS(rw_lock)) >= RWLOCK_WRITER_WAITER)
+        {
+          return EBUSY;
+        }
+      else if (state == RWLOCK_MAX_READERS)
+        {
+          return EAGAIN;
+        }
+    }
+  while (!atomic_compare_exchange_weak(RWLOCK_STATE(rw_lock), &state,
+                                       state + 1));
+
+  return OK;
+}
+
+static int trywrlock(FAR pthread_rwlock_t *rw_lock)
+{
+  unsigned int state = 0;
+
+  if (!atomic_compare_exchange_strong(RWLOCK_STATE(rw_lock), &state,
+                                      PTHREAD_RWLOCK_WRITER))
+    {
+      return EBUSY;
+    }
+
+  return OK;
+}
+
+static void rwlock_wake(FAR pthread_rwlock_t *rw_lock)
+{
+  atomic_fetch_add(RWLOCK_SEQ(rw_lock), 1);
+  nxfutex_wake(&rw_lock->seq, INT_MAX);
+}
+
+static int rwlock_wait(FAR pthread_rwlock_t *rw_lock, unsigned int waiter,
+                       CODE int (*trylock)(FAR pthread_rwlock_t *),
+                       clockid_t clockid, FAR const struct timespec *ts)
+{
+  unsigned int seq;
+  int err;
+  int ret;
+
+  /* Announce the waiter before sampling the futex word so that an unlock
+   * racing with us always sees it and advances the word.
+   */
+
+  atomic_fetch_add(RWLOCK_WAITERS(rw_lock), waiter);
+
+  for (; ; )
+    {
+      seq = atomic_load(RWLOCK_SEQ(rw_lock));
+      err = trylock(rw_lock);
+      if (err != EBUSY)
+        {
+          break;
+        }
+
+      ret = nxfutex_wait(&rw_lock->seq, seq, clockid, ts);
+      if (ret == -ETIMEDOUT || ret == -EINVAL)
+        {
+          err = -ret;
+          break;
+        }
+    }
+
+  atomic_fetch_sub(RWLOCK_WAITERS(rw_lock), waiter);
+
+  /* A writer that gives up may have been holding back readers */
+
+  if (err != OK && waiter == RWLOCK_WRITER_WAITER &&
+      atomic_load(RWLOCK_WAITERS(rw_lock)) != 0)
+    {
+      rwlock_wake(rw_lock);
+    }
+
+  return err;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int pthread_rwlock_init(FAR pthread_rwlock_t *lock,
+                        FAR const pthread_rwlockattr_t *attr)
+{
+  UNUSED(attr);
+
+  lock->state   = 0;
+  lock->waiters = 0;
+  lock->seq     = 0;
+  return OK;
+}
+
+int pthread_rwlock_destroy(FAR pthread_rwlock_t *lock)
+{
+  if (atomic_load(RWLOCK_STATE(lock)) != 0 ||
+      atomic_load(RWLOCK_WAITERS(lock)) != 0)
+    {
+      return EBUSY;
+    }
+
+  return OK;
+}
+
+int pthread_rwlock_unlock(FAR pthread_rwlock_t *rw_lock)
+{
+  unsigned int state = atomic_load(RWLOCK_STATE(rw_lock));
+  unsigned int newstate;
+
+  do
+    {
+      if (state == PTHREAD_RWLOCK_WRITER)
+        {
+          newstate = 0;
+        }
+      else if (state > 0 && state <= RWLOCK_MAX_READERS)
+        {
+          newstate = state - 1;
+        }
+      else
+        {
+          return EINVAL;
+        }
+    }
+  while (!atomic_compare_exchange_weak(RWLOCK_STATE(rw_lock), &state,
+                                       newstate));
+
+  /* Only enter the kernel if the lock became free and someone waits */
+
+  if (newstate == 0 && atomic_load(RWLOCK_WAITERS(rw_lock)) != 0)
+    {
+      rwlock_wake(rw_lock);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pthread_rwlock_rdlock
+ *
+ * Description:
+ *   Locks a read/write lock for reading.  The lock is taken with an atomic
+ *   operation in user space; the kernel is only entered to wait while the
+ *   lock is held or requested for writing.
+ *
+ ****************************************************************************/
+
+int pthread_rwlock_tryrdlock(FAR pthread_rwlock_t *rw_lock)
+{
+  return tryrdlock(rw_lock);
+}
+
+int pthread_rwlock_clockrdlock(FAR pthread_rwlock_t *rw_lock,
+                               clockid_t clockid,
+                               FAR const struct timespec *ts)
+{
+  int err = tryrdlock(rw_lock);
+
+  if (err == EBUSY)
+    {
+      err = rwlock_wait(rw_lock, RWLOCK_READER_WAITER, tryrdlock,
+                        clockid, ts);
+    }
+
+  return err;
+}
+
+int pthread_rwlock_timedrdlock(FAR pthread_rwlock_t *rw_lock,
+                               FAR const struct timespec *ts)
+{
+  return pthread_rwlock_clockrdlock(rw_lock, CLOCK_REALTIME, ts);
+}
+
+int pthread_rwlock_rdlock(FAR pthread_rwlock_t *rw_lock)
+{
+  return pthread_rwlock_timedrdlock(rw_lock, NULL);
+}
+
+/****************************************************************************
+ * Name: pthread_rwlock_wrlock
+ *
+ * Description:
+ *   Locks a read/write lock for writing.  The lock is taken with an atomic
+ *   operation in user space; the kernel is only entered to wait while the
+ *   lock is held.
+ *
+ ****************************************************************************/
+
+int pthread_rwlock_trywrlock(FAR pthread_rwlock_t *rw_lock)
+{
+  return trywrlock(rw_lock);
+}
+
+int pthread_rwlock_clockwrlock(FAR pthread_rwlock_t *rw_lock,
+                               clockid_t clockid,
+                               FAR const struct timespec *ts)
+{
+  int err = trywrlock(rw_lock);
+
+  if (err == EBUSY)
+    {
+      err = rwlock_wait(rw_lock, RWLOCK_WRITER_WAITER, trywrlock,
+                        clockid, ts);
+    }
+
+  return err;
+}
+
+int pthread_rwlock_timedwrlock(FAR pthread_rwlock_t *rw_lock,
+                               FAR const struct timespec *ts)
+{
+  return pthread_rwlock_clockwrlock(rw_lock, CLOCK_REALTIME, ts);
+}
+
+int pthread_rwlock_wrlock(FAR pthread_rwlock_t *rw_lock)
+{
+  return pthread_rwlock_timedwrlock(rw_lock, NULL);
+}
@@ -83,9 +83,8 @@ int nxsem_init(FAR sem_t *sem, int pshared, unsigned int value)
 #ifdef CONFIG_PRIORITY_INHERITANCE
 #  if CONFIG_SEM_PREALLOCHOLDERS > 0
   sem->hhead = NULL;
-#  else
-  INITIALIZE_SEMHOLDER(&sem->holder);
 #  endif
+  INITIALIZE_SEMHOLDER(&sem->holder);
 #endif
   return OK;
 }
@@ -37,7 +37,11 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <math.h>
+#include <stdbool.h>
+#include <string.h>
 
 #include <sys/param.h>
 
@@ -47,6 +51,36 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBC_FLOATINGPOINT_EXACT
+
+/* The digits are computed with the tables of powers of five of Ryu (Ulf
+ * Adams, "Ryu: Fast Float-to-String Conversion", PLDI 2018).  One 64 by
+ * 128 bit multiplication gives the 18 or 19 leading digits of a normal
+ * number exactly, which is enough to round it correctly to 17 digits.
+ */
+
+#define DTOA_MANT_BITS      52
+#define DTOA_EXP_MASK       0x7ff
+#define DTOA_EXP_BIAS       1023
+#define DTOA_POW5_BITS      125
+#define DTOA_POW5_INV_BITS  125
+
+/* A subnormal x = m * 2^-1074 is scaled to x * 10^325 = m * 5^325 / 2^749
+ * with a small bignum instead.
+ */
+
+#define DTOA_SUB_POW5       325
+#define DTOA_SUB_SHIFT      749
+#define DTOA_SUB_WORDS      26
+#define DTOA_SUB_WORD       (DTOA_SUB_SHIFT / 32)
+#define DTOA_SUB_BIT        (DTOA_SUB_SHIFT % 32)
+#define DTOA_SUB_MASK       ((UINT32_C(1) << DTOA_SUB_BIT) - 1)
+#define DTOA_POW5_13        UINT32_C(1220703125)
+
+#define DTOA_LEAD_DIG       18
+
+#else
+
 /* A bit of CPP trickery -- construct the floating-point value 10 ** DBL_DIG
  * by pasting the value of DBL_DIG onto '1e' to
  */
@@ -72,6 +106,347 @@
 #define MIN_MANT_INT  ((uint64_t)MIN_MANT)
 #define MIN_MANT_EXP  DBL_DIG
 
+#endif
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT_EXACT
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint64_t g_dtoa_pow10[] =
+{
+  UINT64_C(1),
+  UINT64_C(10),
+  UINT64_C(100),
+  UINT64_C(1000),
+  UINT64_C(10000),
+  UINT64_C(100000),
+  UINT64_C(1000000),
+  UINT64_C(10000000),
+  UINT64_C(100000000),
+  UINT64_C(1000000000),
+  UINT64_C(10000000000),
+  UINT64_C(100000000000),
+  UINT64_C(1000000000000),
+  UINT64_C(10000000000000),
+  UINT64_C(100000000000000),
+  UINT64_C(1000000000000000),
+  UINT64_C(10000000000000000),
+  UINT64_C(100000000000000000),
+  UINT64_C(1000000000000000000),
+  UINT64_C(10000000000000000000)
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* ceil(log2(5^e)), floor(log10(2^e)) and floor(log10(5^e)) as in Ryu */
+
+static inline uint32_t dtoa_pow5bits(int32_t e)
+{
+  return (uint32_t)(((e * 1217359) >> 19) + 1);
+}
+
+static inline uint32_t dtoa_log10pow2(int32_t e)
+{
+  return (uint32_t)(e * 78913) >> 18;
+}
+
+static inline uint32_t dtoa_log10pow5(int32_t e)
+{
+  return (uint32_t)(e * 732923) >> 20;
+}
+
+/* Return the high half of a * b and store the low half in lo */
+
+static inline uint64_t dtoa_umul128(uint64_t a, uint64_t b,
+                                    FAR uint64_t *lo)
+{
+#ifdef __SIZEOF_INT128__
+  __uint128_t p = (__uint128_t)a * b;
+
+  *lo = (uint64_t)p;
+  return (uint64_t)(p >> 64);
+#else
+  uint64_t a0 = (uint32_t)a;
+  uint64_t a1 = a >> 32;
+  uint64_t b0 = (uint32_t)b;
+  uint64_t b1 = b >> 32;
+  uint64_t p00 = a0 * b0;
+  uint64_t p01 = a0 * b1;
+  uint64_t p10 = a1 * b0;
+  uint64_t mid = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+
+  *lo = (mid << 32) | (uint32_t)p00;
+  return a1 * b1 + (mid >> 32) + (p01 >> 32) + (p10 >> 32);
+#endif
+}
+
+/* Return floor(m * mul / 2^j) for a 128 bit mul and 64 < j < 128 */
+
+static uint64_t dtoa_mulshift(uint64_t m, FAR const uint64_t *mul, int j)
+{
+  uint64_t lo;
+  uint64_t hi;
+  uint64_t mid;
+
+  mid = dtoa_umul128(m, mul[0], &lo);
+  hi  = dtoa_umul128(m, mul[1], &lo);
+  lo += mid;
+  hi += lo < mid;
+
+  j -= 64;
+  return (hi << (64 - j)) | (lo >> j);
+}
+
+/* Return the leading digits of a subnormal x = m * 2^-1074 */
+
+static uint64_t dtoa_lead_subnormal(uint64_t m, FAR int32_t *e10,
+                                    FAR bool *exact)
+{
+  uint32_t n[DTOA_SUB_WORDS];
+  uint64_t lead;
+  uint64_t t;
+  int i;
+  int j;
+
+  memset(n, 0, sizeof(n));
+  n[0] = (uint32_t)m;
+  n[1] = (uint32_t)(m >> 32);
+
+  for (i = 0; i < DTOA_SUB_POW5 / 13; i++)
+    {
+      for (t = 0, j = 0; j < DTOA_SUB_WORDS; j++)
+        {
+          t += (uint64_t)n[j] * DTOA_POW5_13;
+          n[j] = (uint32_t)t;
+          t >>= 32;
+        }
+    }
+
+  /* Split n into the integer part and the fraction, and move digits
+   * from the fraction until there are enough.
+   */
+
+  lead = ((uint64_t)n[DTOA_SUB_WORD + 2] << (64 - DTOA_SUB_BIT)) |
+         ((uint64_t)n[DTOA_SUB_WORD + 1] << (32 - DTOA_SUB_BIT)) |
+         (n[DTOA_SUB_WORD] >> DTOA_SUB_BIT);
+  n[DTOA_SUB_WORD] &= DTOA_SUB_MASK;
+  *e10 = -DTOA_SUB_POW5;
+
+  while (lead < g_dtoa_pow10[DTOA_LEAD_DIG - 1])
+    {
+      for (t = 0, j = 0; j <= DTOA_SUB_WORD; j++)
+        {
+          t += (uint64_t)n[j] * 10;
+          n[j] = (uint32_t)t;
+          t >>= 32;
+        }
+
+      lead = lead * 10 + (n[DTOA_SUB_WORD] >> DTOA_SUB_BIT);
+      n[DTOA_SUB_WORD] &= DTOA_SUB_MASK;
+      (*e10)--;
+    }
+
+  *exact = true;
+  for (j = 0; j <= DTOA_SUB_WORD; j++)
+    {
+      *exact &= n[j] == 0;
+    }
+
+  return lead;
+}
+
+/****************************************************************************
+ * Name: dtoa_lead
+ *
+ * Description:
+ *   Return the leading 18 or 19 digits of a positive, finite x, so that
+ *   x = lead * 10^e10 + tail with 0 <= tail < 10^e10.  exact tells if the
+ *   tail is zero.  Integers below 2^56 may come with 17 digits only, but
+ *   are always exact.
+ *
+ ****************************************************************************/
+
+static uint64_t dtoa_lead(double x, FAR int32_t *e10, FAR bool *exact)
+{
+  uint64_t bits;
+  uint64_t mv;
+  uint64_t vr;
+  uint64_t pow5;
+  int32_t e2;
+  int32_t q;
+  int32_t i;
+  int32_t k;
+
+  memcpy(&bits, &x, sizeof(bits));
+  mv = bits & ((UINT64_C(1) << DTOA_MANT_BITS) - 1);
+  e2 = (int32_t)(bits >> DTOA_MANT_BITS) & DTOA_EXP_MASK;
+  if (e2 == 0)
+    {
+      return dtoa_lead_subnormal(mv, e10, exact);
+    }
+
+  /* x = mv * 2^e2 */
+
+  mv = (mv | (UINT64_C(1) << DTOA_MANT_BITS)) << 2;
+  e2 -= DTOA_EXP_BIAS + DTOA_MANT_BITS + 2;
+
+  if (e2 >= 0)
+    {
+      /* lead = mv * 2^e2 / 10^q, exact if 5^q divides mv */
+
+      q  = dtoa_log10pow2(e2) - (e2 > 3);
+      k  = DTOA_POW5_INV_BITS + dtoa_pow5bits(q) - 1;
+      vr = dtoa_mulshift(mv, g_dtoa_pow5_inv[q], -e2 + q + k);
+      *e10 = q;
+
+      for (pow5 = 1, i = 0; i < q && i < 24; i++)
+        {
+          pow5 *= 5;
+        }
+
+      *exact = q < 24 && mv % pow5 == 0;
+    }
+  else
+    {
+      /* lead = mv * 5^i / 2^q, exact if 2^q divides mv */
+
+      q  = dtoa_log10pow5(-e2) - (-e2 > 1);
+      i  = -e2 - q;
+      k  = dtoa_pow5bits(i) - DTOA_POW5_BITS;
+      vr = dtoa_mulshift(mv, g_dtoa_pow5[i], q - k);
+      *e10 = q + e2;
+      *exact = q < 64 && (mv & ((UINT64_C(1) << q) - 1)) == 0;
+    }
+
+  return vr;
+}
+
+/* Store the n decimal digits of mant */
+
+static void dtoa_digits(FAR char *digits, uint64_t mant, int n)
+{
+  uint32_t lo;
+  int i;
+
+  while (n > 9)
+    {
+      lo = (uint32_t)(mant % 1000000000);
+      mant /= 1000000000;
+      for (i = 0; i < 9; i++)
+        {
+          digits[--n] = lo % 10 + '0';
+          lo /= 10;
+        }
+    }
+
+  for (lo = (uint32_t)mant; n > 0; lo /= 10)
+    {
+      digits[--n] = lo % 10 + '0';
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int __dtoa_engine(double x, FAR struct dtoa_s *dtoa, int max_digits,
+                  int max_decimals)
+{
+  int32_t exp = 0;
+  uint8_t flags = 0;
+  int i;
+
+  if (x < 0)
+    {
+      flags |= DTOA_MINUS;
+      x = -x;
+    }
+
+  if (x == 0)
+    {
+      flags |= DTOA_ZERO;
+      for (i = 0; i < max_digits; i++)
+        {
+          dtoa->digits[i] = '0';
+        }
+    }
+  else if (isnan(x))
+    {
+      flags |= DTOA_NAN;
+    }
+  else if (isinf(x))
+    {
+      flags |= DTOA_INF;
+    }
+  else
+    {
+      uint64_t lead;
+      uint64_t mant;
+      uint64_t half;
+      uint64_t rem;
+      int32_t e10;
+      bool exact;
+      int ndigs;
+
+      lead = dtoa_lead(x, &e10, &exact);
+      ndigs = DTOA_LEAD_DIG - 1;
+      while (lead >= g_dtoa_pow10[ndigs])
+        {
+          ndigs++;
+        }
+
+      exp = e10 + ndigs - 1;
+      if (max_decimals >= 0)
+        {
+          max_digits = MIN(max_digits, max_decimals + exp + 1);
+        }
+
+      if (max_digits > 0)
+        {
+          /* Round to nearest, ties to even.  A tie is only exact if
+           * nothing follows the leading digits.
+           */
+
+          mant = lead / g_dtoa_pow10[ndigs - max_digits];
+          rem  = lead - mant * g_dtoa_pow10[ndigs - max_digits];
+          half = g_dtoa_pow10[ndigs - max_digits] / 2;
+          if (rem > half || (rem == half && (!exact || (mant & 1) != 0)))
+            {
+              if (++mant == g_dtoa_pow10[max_digits])
+                {
+                  mant /= 10;
+                  exp++;
+                }
+            }
+        }
+      else
+        {
+          /* All digits are below the last decimal: x becomes 0 or one
+           * unit of the last decimal.
+           */
+
+          half = 5 * g_dtoa_pow10[ndigs - 1];
+          mant = max_digits == 0 && (lead > half ||
+                                     (lead == half && !exact));
+          exp += (int32_t)mant;
+          max_digits = 1;
+        }
+
+      dtoa_digits(dtoa->digits, mant, max_digits);
+    }
+
+  dtoa->digits[max_digits] = '\0';
+  dtoa->flags = flags;
+  dtoa->exp = exp;
+  return max_digits;
+}
+
+#else
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -144,7 +519,7 @@ int __dtoa_engine(double x, FAR struct dtoa_s *dtoa, int max_digits,
        * the right of the decimal point in dtoa->digits.
        */
 
-      if (max_decimals != 0)
+      if (max_decimals > 0)
         {
           max_digits = MIN(max_digits, max_decimals + MAX(exp + 1, 0));
         }
@@ -181,3 +556,5 @@ int __dtoa_engine(double x, FAR struct dtoa_s *dtoa, int max_digits,
   dtoa->exp = exp;
   return max_digits;
 }
+
+#endif /* CONFIG_LIBC_FLOATINGPOINT_EXACT */
@@ -49,7 +49,13 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define DTOA_MAX_DIG        DBL_DIG
+#ifdef CONFIG_LIBC_FLOATINGPOINT_EXACT
+#  define DTOA_MAX_DIG      17    /* Enough to tell all doubles apart */
+#  define DTOA_POW5_NUM     326
+#  define DTOA_POW5_INV_NUM 342
+#else
+#  define DTOA_MAX_DIG      DBL_DIG
+#endif
 
 #define DTOA_MINUS          1
 #define DTOA_ZERO           2
@@ -177,14 +183,23 @@ struct dtoa_s
  * Public Data
  ****************************************************************************/
 
+#ifdef CONFIG_LIBC_FLOATINGPOINT_EXACT
+extern const uint64_t g_dtoa_pow5[DTOA_POW5_NUM][2];
+extern const uint64_t g_dtoa_pow5_inv[DTOA_POW5_INV_NUM][2];
+#else
 extern const double g_dtoa_scale_up[];
 extern const double g_dtoa_scale_down[];
 extern const double g_dtoa_round[];
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+/* Convert x to max_digits significant digits, but to no more than
+ * max_decimals digits after the decimal point if max_decimals >= 0.
+ */
+
 int __dtoa_engine(double x, FAR struct dtoa_s *dtoa, int max_digits,
                   int max_decimals);
 
@@ -40,6 +40,20 @@ int fgetc_unlocked(FAR FILE *stream)
   unsigned char ch;
   ssize_t ret;
 
+#ifndef CONFIG_STDIO_DISABLE_BUFFERING
+  /* Take the character right away from the read-ahead data */
+
+#  if CONFIG_NUNGET_CHARS > 0
+  if (stream != NULL && stream->fs_nungotten == 0 &&
+      stream->fs_bufpos < stream->fs_bufread)
+#  else
+  if (stream != NULL && stream->fs_bufpos < stream->fs_bufread)
+#  endif
+    {
+      return (unsigned char)*stream->fs_bufpos++;
+    }
+#endif
+
   ret = lib_fread_unlocked(&ch, 1, stream);
   if (ret > 0)
     {
@@ -24,6 +24,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <fcntl.h>
 #include <stdio.h>
 #include "libc.h"
 
@@ -40,6 +41,22 @@ int fputc_unlocked(int c, FAR FILE *stream)
   unsigned char buf = (unsigned char)c;
   int ret;
 
+#ifndef CONFIG_STDIO_DISABLE_BUFFERING
+  /* Store the character right away if the buffer is used for writing and
+   * does not have to be flushed afterwards.
+   */
+
+  if (stream != NULL && stream->fs_bufstart != NULL &&
+      stream->fs_bufread == stream->fs_bufstart &&
+      stream->fs_bufpos + 1 < stream->fs_bufend &&
+      (stream->fs_oflags & O_WROK) != 0 &&
+      (c != '\n' || (stream->fs_flags & __FS_FLAG_LBF) == 0))
+    {
+      *stream->fs_bufpos++ = buf;
+      return c;
+    }
+#endif
+
   ret = lib_fwrite_unlocked(&buf, 1, stream);
   if (ret > 0)
     {
@@ -67,6 +67,7 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
   size_t offset = 0;
   size_t ret = 0;
   size_t len = 0;
+  int star = 0;
   char c;
 
   while ((c = *fmt++) != '\0')
@@ -78,9 +79,19 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
           continue;
         }
 
+      if (!infmt && *fmt == '%')
+        {
+          /* "%%" takes no argument */
+
+          lib_stream_putc(s, *fmt++);
+          ret++;
+          continue;
+        }
+
       if (!infmt)
         {
           len = 0;
+          prec = NULL;
           infmt = true;
           memset(fmtstr, 0, sizeof(fmtstr));
         }
@@ -163,7 +174,8 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
         }
       else if (c == '*')
         {
-          sprintf(fmtstr + len - 1, "%d", var->i);
+          star = var->i;
+          sprintf(fmtstr + len - 1, "%d", star);
           len = strlen(fmtstr);
           offset += sizeof(var->i);
         }
@@ -171,7 +183,12 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
         {
           FAR const char *value = data + offset;
 
-          if (prec != NULL)
+          if (prec != NULL && *prec == '*')
+            {
+              offset += star;
+              prec = NULL;
+            }
+          else if (prec != NULL)
             {
               offset += strtol(prec, NULL, 10);
               prec = NULL;
@@ -194,6 +194,25 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
     {
       for (; ; )
         {
+#if !defined(CONFIG_ARCH_ROMGETC) && !defined(CONFIG_AVR_HAS_MEMX_PTR)
+          /* Write the text up to the next conversion in one go */
+
+          pnt = fmt;
+          while (*fmt != '\0' && *fmt != '%')
+            {
+              fmt++;
+            }
+
+#  ifdef CONFIG_LIBC_NUMBERED_ARGS
+          if (fmt != pnt && stream != NULL)
+#  else
+          if (fmt != pnt)
+#  endif
+            {
+              stream_puts(pnt, fmt - pnt, stream);
+            }
+#endif
+
           c = fmt_char(fmt);
           if (c == '\0')
             {
@@ -564,8 +583,8 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
           int n;
           uint8_t sign;         /* Sign character (or 0) */
           uint8_t ndigs;        /* Number of digits to convert */
-          uint8_t ndecimal;     /* Digits after decimal (for 'f' format), 0 if
-                                 * no limit */
+          int ndecimal;         /* Digits after decimal (for 'f' format), -1
+                                 * if no limit */
 
           flags &= ~FL_FLTUPP;
 
@@ -581,7 +600,7 @@ flt_oper:
           if (c == 'e')
             {
               ndigs = prec + 1;
-              ndecimal = 0;
+              ndecimal = -1;
               flags |= FL_FLTEXP;
             }
           else if (c == 'f')
@@ -592,8 +611,8 @@ flt_oper:
             }
           else
             {
-              ndigs = prec;
-              ndecimal = 0;
+              ndigs = prec > 0 ? prec : 1;
+              ndecimal = -1;
             }
 
           if (ndigs > DTOA_MAX_DIG)
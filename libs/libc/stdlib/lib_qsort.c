@@ -48,70 +48,134 @@
 
 #include <sys/types.h>
 #include <sys/param.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define swapcode(TYPE, parmi, parmj, n) \
-  { \
-    long i = (n) / sizeof(TYPE); \
-    register FAR TYPE *pi = (FAR TYPE *)(parmi); \
-    register FAR TYPE *pj = (FAR TYPE *)(parmj); \
-    do { \
-      register TYPE t = *pi; \
-      *pi++ = *pj; \
-      *pj++ = t; \
-    } while (--i > 0); \
-  }
-
-#define SWAPINIT(a, width) \
-  swaptype = (uintptr_t)a % sizeof(long) || \
-  width % sizeof(long) ? 2 : width == sizeof(long) ? 0 : 1;
-
-#define swap(a, b) \
-  if (swaptype == 0) \
-    { \
-      long t = *(FAR long *)(a); \
-      *(FAR long *)(a) = *(FAR long *)(b); \
-      *(FAR long *)(b) = t; \
-    } \
-  else \
-    { \
-      swapfunc(a, b, width, swaptype); \
-    }
+/* Ranges below this size are sorted by insertion */
+
+#define QSORT_INSERTION   16
+
+/* The pivot is the median of three ninthers above this size */
+
+#define QSORT_NINTHER     128
+
+/* A presorted range is finished by insertion if that takes no more than
+ * this many moves.
+ */
+
+#define QSORT_PARTIAL     8
+
+/* How the elements are swapped: As one 32-bit or 64-bit word, as a number
+ * of longs or byte by byte.
+ */
 
-#define vecswap(a, b, n) if ((n) > 0) swapfunc(a, b, n, swaptype)
+#define QSORT_SWAP_INT32  0
+#define QSORT_SWAP_INT64  1
+#define QSORT_SWAP_LONG   2
+#define QSORT_SWAP_CHAR   3
+
+#define elem(b, i)        ((FAR char *)(b) + (size_t)(i) * width)
 
 /****************************************************************************
- * Private Function Prototypes
+ * Private Types
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype);
-static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *));
+typedef CODE int (*qsort_compar_t)(FAR const void *, FAR const void *);
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype)
+/****************************************************************************
+ * Name: qsort_swaptype
+ *
+ * Description:
+ *   Select the widest swap that fits the alignment of the array.
+ *
+ ****************************************************************************/
+
+static int qsort_swaptype(FAR void *base, size_t width)
 {
-  if (swaptype <= 1)
+  if (width == sizeof(uint32_t) &&
+      (uintptr_t)base % sizeof(uint32_t) == 0)
+    {
+      return QSORT_SWAP_INT32;
+    }
+  else if (width == sizeof(uint64_t) &&
+           (uintptr_t)base % sizeof(uint64_t) == 0)
     {
-      swapcode(long, a, b, n)
+      return QSORT_SWAP_INT64;
     }
-  else
+  else if ((uintptr_t)base % sizeof(long) == 0 &&
+           width % sizeof(long) == 0)
     {
-      swapcode(char, a, b, n)
+      return QSORT_SWAP_LONG;
     }
+
+  return QSORT_SWAP_CHAR;
 }
 
-static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *))
+static inline_function void qsort_swap(FAR char *a, FAR char *b,
+                                       size_t width, int swaptype)
+{
+  size_t i;
+
+  switch (swaptype)
+    {
+      case QSORT_SWAP_INT32:
+        {
+          uint32_t t = *(FAR uint32_t *)a;
+          *(FAR uint32_t *)a = *(FAR uint32_t *)b;
+          *(FAR uint32_t *)b = t;
+        }
+        break;
+
+      case QSORT_SWAP_INT64:
+        {
+          uint64_t t = *(FAR uint64_t *)a;
+          *(FAR uint64_t *)a = *(FAR uint64_t *)b;
+          *(FAR uint64_t *)b = t;
+        }
+        break;
+
+      case QSORT_SWAP_LONG:
+        for (i = 0; i < width; i += sizeof(long))
+          {
+            long t = *(FAR long *)(a + i);
+            *(FAR long *)(a + i) = *(FAR long *)(b + i);
+            *(FAR long *)(b + i) = t;
+          }
+        break;
+
+      default:
+        for (i = 0; i < width; i++)
+          {
+            char t = a[i];
+            a[i] = b[i];
+            b[i] = t;
+          }
+        break;
+    }
+}
+
+/* Swap the n bytes at a and b, n is a multiple of the width */
+
+static void qsort_vecswap(FAR char *a, FAR char *b, size_t n,
+                          size_t width, int swaptype)
+{
+  for (; n > 0; n -= width, a += width, b += width)
+    {
+      qsort_swap(a, b, width, swaptype);
+    }
+}
+
+static FAR char *qsort_med3(FAR char *a, FAR char *b, FAR char *c,
+                            qsort_compar_t compar)
 {
   return compar(a, b) < 0 ?
          (compar(b, c) < 0 ? b : (compar(a, c) < 0 ? c : a)) :
@@ -119,50 +183,125 @@ static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
 }
 
 /****************************************************************************
- * Public Function
+ * Name: qsort_insertion
+ *
+ * Description:
+ *   Sort a range by insertion.  If 'limit' is non-zero, give up and return
+ *   false once more than 'limit' elements had to be moved.
+ *
  ****************************************************************************/
 
+static bool qsort_insertion(FAR char *base, size_t nel, size_t width,
+                            int swaptype, qsort_compar_t compar,
+                            size_t limit)
+{
+  FAR char *end = elem(base, nel);
+  FAR char *pm;
+  FAR char *pl;
+  size_t moves = 0;
+
+  for (pm = base + width; pm < end; pm += width)
+    {
+      for (pl = pm; pl > base && compar(pl - width, pl) > 0; pl -= width)
+        {
+          qsort_swap(pl, pl - width, width, swaptype);
+        }
+
+      if (pl != pm)
+        {
+          moves += (pm - pl) / width;
+          if (limit != 0 && moves > limit)
+            {
+              return false;
+            }
+        }
+    }
+
+  return true;
+}
+
 /****************************************************************************
- * Name: qsort
+ * Name: qsort_heapsort
  *
  * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
+ *   Sort a range in O(n log n) whatever the input, for the ranges on which
+ *   quicksort keeps partitioning badly.
  *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
- *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
- *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
+ ****************************************************************************/
+
+static void qsort_siftdown(FAR char *base, size_t root, size_t nel,
+                           size_t width, int swaptype,
+                           qsort_compar_t compar)
+{
+  size_t child;
+
+  while ((child = 2 * root + 1) < nel)
+    {
+      if (child + 1 < nel &&
+          compar(elem(base, child), elem(base, child + 1)) < 0)
+        {
+          child++;
+        }
+
+      if (compar(elem(base, root), elem(base, child)) >= 0)
+        {
+          break;
+        }
+
+      qsort_swap(elem(base, root), elem(base, child), width, swaptype);
+      root = child;
+    }
+}
+
+static void qsort_heapsort(FAR char *base, size_t nel, size_t width,
+                           int swaptype, qsort_compar_t compar)
+{
+  size_t i;
+
+  for (i = nel / 2; i-- > 0; )
+    {
+      qsort_siftdown(base, i, nel, width, swaptype, compar);
+    }
+
+  while (--nel > 0)
+    {
+      qsort_swap(base, elem(base, nel), width, swaptype);
+      qsort_siftdown(base, 0, nel, width, swaptype, compar);
+    }
+}
+
+/****************************************************************************
+ * Name: qsort_shuffle
  *
- *   (Based on description from OpenGroup.org).
+ * Description:
+ *   Swap a few elements of a range that partitioned badly, this breaks up
+ *   the patterns that would make the next pivots bad as well.
  *
- * Returned Value:
- *   The qsort() function will not return a value.
+ ****************************************************************************/
+
+static void qsort_shuffle(FAR char *base, size_t nel, size_t width,
+                          int swaptype)
+{
+  if (nel >= QSORT_INSERTION)
+    {
+      qsort_swap(base, elem(base, nel / 4), width, swaptype);
+      qsort_swap(elem(base, nel - 1), elem(base, nel - nel / 4),
+                 width, swaptype);
+    }
+}
+
+/****************************************************************************
+ * Name: qsort_sort
  *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ * Description:
+ *   Introsort: Quicksort with the three-way partitioning of Bentley and
+ *   McIlroy, that recurses into the smaller part only and falls back to
+ *   heapsort once 'depth' bad levels were used up.
  *
  ****************************************************************************/
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+static void qsort_sort(FAR char *base, size_t nel, size_t width,
+                       int swaptype, qsort_compar_t compar, int depth)
 {
   FAR char *pa;
   FAR char *pb;
@@ -171,126 +310,199 @@ void qsort(FAR void *base, size_t nel, size_t width,
   FAR char *pl;
   FAR char *pm;
   FAR char *pn;
-  int swaptype;
-  int swap_cnt;
-  int d;
-  int r;
-
-loop:
-  SWAPINIT(base, width);
-  swap_cnt = 0;
+  size_t nleft;
+  size_t nright;
+  size_t d;
+  size_t r;
+  bool swapped;
+  int ret;
 
-  if (nel < 7)
+  for (; ; )
     {
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      if (nel < QSORT_INSERTION)
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          qsort_insertion(base, nel, width, swaptype, compar, 0);
+          return;
         }
 
-      return;
-    }
+      if (depth-- <= 0)
+        {
+          qsort_heapsort(base, nel, width, swaptype, compar);
+          return;
+        }
+
+      /* Choose the pivot and move it to the front */
 
-  pm = (FAR char *)base + (nel / 2) * width;
-  if (nel > 7)
-    {
       pl = base;
-      pn = (FAR char *)base + (nel - 1) * width;
-      if (nel > 40)
+      pm = elem(base, nel / 2);
+      pn = elem(base, nel - 1);
+      if (nel > QSORT_NINTHER)
         {
           d  = (nel / 8) * width;
-          pl = med3(pl, pl + d, pl + 2 * d, compar);
-          pm = med3(pm - d, pm, pm + d, compar);
-          pn = med3(pn - 2 * d, pn - d, pn, compar);
+          pl = qsort_med3(pl, pl + d, pl + 2 * d, compar);
+          pm = qsort_med3(pm - d, pm, pm + d, compar);
+          pn = qsort_med3(pn - 2 * d, pn - d, pn, compar);
         }
 
-      pm = med3(pl, pm, pn, compar);
-    }
+      pm = qsort_med3(pl, pm, pn, compar);
+      qsort_swap(base, pm, width, swaptype);
 
-  swap(base, pm);
-  pa = pb = (FAR char *)base + width;
+      /* Partition into: = pivot, < pivot, > pivot, = pivot */
 
-  pc = pd = (FAR char *)base + (nel - 1) * width;
-  for (; ; )
-    {
-      while (pb <= pc && (r = compar(pb, base)) <= 0)
+      swapped = false;
+      pa = pb = base + width;
+      pc = pd = elem(base, nel - 1);
+      for (; ; )
         {
-          if (r == 0)
+          while (pb <= pc && (ret = compar(pb, base)) <= 0)
             {
-              swap_cnt = 1;
-              swap(pa, pb);
-              pa += width;
+              if (ret == 0)
+                {
+                  swapped = true;
+                  qsort_swap(pa, pb, width, swaptype);
+                  pa += width;
+                }
+
+              pb += width;
             }
 
-          pb += width;
-        }
+          while (pb <= pc && (ret = compar(pc, base)) >= 0)
+            {
+              if (ret == 0)
+                {
+                  swapped = true;
+                  qsort_swap(pc, pd, width, swaptype);
+                  pd -= width;
+                }
+
+              pc -= width;
+            }
 
-      while (pb <= pc && (r = compar(pc, base)) >= 0)
-        {
-          if (r == 0)
+          if (pb > pc)
             {
-              swap_cnt = 1;
-              swap(pc, pd);
-              pd -= width;
+              break;
             }
 
+          qsort_swap(pb, pc, width, swaptype);
+          swapped = true;
+          pb += width;
           pc -= width;
         }
 
-      if (pb > pc)
+      /* Move the elements equal to the pivot to the middle */
+
+      pn = elem(base, nel);
+      r  = MIN(pa - base, pb - pa);
+      qsort_vecswap(base, pb - r, r, width, swaptype);
+
+      r  = MIN(pd - pc, pn - pd - width);
+      qsort_vecswap(pb, pn - r, r, width, swaptype);
+
+      nleft  = (pb - pa) / width;
+      nright = (pd - pc) / width;
+
+      /* Nothing had to be swapped, the range may already be sorted.  Try
+       * to finish it by insertion, but give up soon if it is not.
+       */
+
+      if (!swapped &&
+          qsort_insertion(base, nleft, width, swaptype, compar,
+                          QSORT_PARTIAL) &&
+          qsort_insertion(pn - nright * width, nright, width, swaptype,
+                          compar, QSORT_PARTIAL))
         {
-          break;
+          return;
         }
 
-      swap(pb, pc);
-      swap_cnt = 1;
-      pb      += width;
-      pc      -= width;
-    }
-
-  if (swap_cnt == 0)
-    {
-      /* Switch to insertion sort */
+      /* A lopsided partition hints at a pattern, break it up */
 
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      if (MIN(nleft, nright) < nel / 8)
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          qsort_shuffle(base, nleft, width, swaptype);
+          qsort_shuffle(pn - nright * width, nright, width, swaptype);
         }
 
-      return;
+      /* Recurse into the smaller part and iterate on the larger one, so
+       * that the stack never holds more than log2(nel) frames.
+       */
+
+      if (nleft < nright)
+        {
+          qsort_sort(base, nleft, width, swaptype, compar, depth);
+          base = pn - nright * width;
+          nel  = nright;
+        }
+      else
+        {
+          qsort_sort(pn - nright * width, nright, width, swaptype, compar,
+                     depth);
+          nel  = nleft;
+        }
     }
+}
 
-  pn = (FAR char *)base + nel * width;
-  r  = MIN(pa - (FAR char *)base, pb - pa);
-  vecswap(base, pb - r, r);
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes:
+ *   The partitioning is the one of Bentley & McIlroy's "Engineering a Sort
+ *   Function" from the original BSD version.  As in introsort, the number
+ *   of levels is bounded by 2 * log2(nel) after which heapsort takes over,
+ *   so the worst case is O(nel log nel) comparisons and O(log nel) stack,
+ *   and nothing is allocated.
+ *
+ ****************************************************************************/
 
-  r  = MIN(pd - pc, pn - pd - width);
-  vecswap(pb, pn - r, r);
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int(*compar)(FAR const void *, FAR const void *))
+{
+  int depth = 0;
+  size_t n;
 
-  if ((r = pb - pa) > width)
+  if (nel < 2 || width == 0)
     {
-      qsort(base, r / width, width, compar);
+      return;
     }
 
-  if ((r = pd - pc) > width)
+  for (n = nel; n > 1; n >>= 1)
     {
-      /* Iterate rather than recurse to save stack space */
-
-      base = pn - r;
-      nel = r / width;
-      goto loop;
+      depth += 2;
     }
+
+  qsort_sort(base, nel, width, qsort_swaptype(base, width), compar, depth);
 }
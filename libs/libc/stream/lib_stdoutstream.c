@@ -53,7 +53,7 @@ static void stdoutstream_putc(FAR struct lib_outstream_s *self, int ch)
 
   do
     {
-      result = fputc(ch, stream->handle);
+      result = fputc_unlocked(ch, stream->handle);
       if (result != EOF)
         {
           self->nput++;
@@ -86,7 +86,7 @@ static ssize_t stdoutstream_puts(FAR struct lib_outstream_s *self,
 
   do
     {
-      result = fwrite(buffer, 1, len, stream->handle);
+      result = lib_fwrite_unlocked(buffer, len, stream->handle);
       if (result >= 0)
         {
           self->nput += result;
@@ -133,7 +133,8 @@ static int stdoutstream_flush(FAR struct lib_outstream_s *self)
  *   outstream - User allocated, uninitialized instance of struct
  *               lib_stdoutstream_s to be initialized.
  *   handle    - User provided FILE instance (must have been opened for
- *               write access).
+ *               write access).  The stream is written with the _unlocked
+ *               functions, so hold flockfile() on it while in use.
  *
  * Returned Value:
  *   None (User allocated instance initialized).
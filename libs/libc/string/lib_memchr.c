@@ -26,10 +26,24 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WORDSIZE     sizeof(uintptr_t)
+#define UNALIGNED(x) (((uintptr_t)(x) & (WORDSIZE - 1)) != 0)
+
+/* HASZERO() is non-zero if any byte of the word is zero */
+
+#define ONES         ((uintptr_t)-1 / 0xff)
+#define HIGHS        (ONES << 7)
+#define HASZERO(x)   (((x) - ONES) & ~(x) & HIGHS)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -53,10 +67,37 @@
 FAR void *memchr(FAR const void *s, int c, size_t n)
 {
   FAR const unsigned char *p = (FAR const unsigned char *)s;
+  FAR const uintptr_t *w;
+  uintptr_t mask;
+
+  c = (unsigned char)c;
+  while (n != 0 && UNALIGNED(p))
+    {
+      if (*p == c)
+        {
+          return (FAR void *)p;
+        }
+
+      p++;
+      n--;
+    }
+
+  /* Skip the words that do not contain c, a word XORed with c in every
+   * byte then has no zero byte.
+   */
+
+  mask = ONES * c;
+  w = (FAR const uintptr_t *)p;
+  while (n >= WORDSIZE && !HASZERO(*w ^ mask))
+    {
+      w++;
+      n -= WORDSIZE;
+    }
 
-  while (n--)
+  p = (FAR const unsigned char *)w;
+  while (n-- != 0)
     {
-      if (*p == (unsigned char)c)
+      if (*p == c)
         {
           return (FAR void *)p;
         }
@@ -26,10 +26,18 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WORDSIZE    sizeof(uintptr_t)
+#define UNALIGNED(x) (((uintptr_t)(x) & (WORDSIZE - 1)) != 0)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -42,6 +50,34 @@ int memcmp(FAR const void *s1, FAR const void *s2, size_t n)
   FAR unsigned char *p1 = (FAR unsigned char *)s1;
   FAR unsigned char *p2 = (FAR unsigned char *)s2;
 
+  /* Skip the equal words if both buffers can be aligned together.  The
+   * first difference is then located byte by byte below.
+   */
+
+  if (n >= 2 * WORDSIZE &&
+      (((uintptr_t)p1 ^ (uintptr_t)p2) & (WORDSIZE - 1)) == 0)
+    {
+      while (UNALIGNED(p1))
+        {
+          if (*p1 != *p2)
+            {
+              return *p1 < *p2 ? -1 : 1;
+            }
+
+          p1++;
+          p2++;
+          n--;
+        }
+
+      while (n >= WORDSIZE &&
+             *(FAR const uintptr_t *)p1 == *(FAR const uintptr_t *)p2)
+        {
+          p1 += WORDSIZE;
+          p2 += WORDSIZE;
+          n  -= WORDSIZE;
+        }
+    }
+
   while (n-- > 0)
     {
       if (*p1 < *p2)
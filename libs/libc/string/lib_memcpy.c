@@ -26,10 +26,18 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WORDSIZE    sizeof(uintptr_t)
+#define UNALIGNED(x) (((uintptr_t)(x) & (WORDSIZE - 1)) != 0)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -45,6 +53,45 @@ FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
   FAR unsigned char *pout = (FAR unsigned char *)dest;
   FAR unsigned char *pin  = (FAR unsigned char *)src;
+
+  /* Copy a word at a time if both buffers can be aligned together */
+
+  if (n >= 4 * WORDSIZE &&
+      (((uintptr_t)pout ^ (uintptr_t)pin) & (WORDSIZE - 1)) == 0)
+    {
+      FAR uintptr_t *wout;
+      FAR const uintptr_t *win;
+
+      while (UNALIGNED(pout))
+        {
+          *pout++ = *pin++;
+          n--;
+        }
+
+      wout = (FAR uintptr_t *)pout;
+      win  = (FAR const uintptr_t *)pin;
+
+      while (n >= 4 * WORDSIZE)
+        {
+          wout[0] = win[0];
+          wout[1] = win[1];
+          wout[2] = win[2];
+          wout[3] = win[3];
+          wout += 4;
+          win  += 4;
+          n    -= 4 * WORDSIZE;
+        }
+
+      while (n >= WORDSIZE)
+        {
+          *wout++ = *win++;
+          n -= WORDSIZE;
+        }
+
+      pout = (FAR unsigned char *)wout;
+      pin  = (FAR unsigned char *)win;
+    }
+
   while (n-- > 0)
     {
       *pout++ = *pin++;
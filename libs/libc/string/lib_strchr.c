@@ -26,10 +26,24 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WORDSIZE     sizeof(uintptr_t)
+#define UNALIGNED(x) (((uintptr_t)(x) & (WORDSIZE - 1)) != 0)
+
+/* HASZERO() is non-zero if any byte of the word is zero */
+
+#define ONES         ((uintptr_t)-1 / 0xff)
+#define HIGHS        (ONES << 7)
+#define HASZERO(x)   (((x) - ONES) & ~(x) & HIGHS)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -52,9 +66,36 @@
 #undef strchr /* See mm/README.txt */
 FAR char *strchr(FAR const char *s, int c)
 {
-  for (; ; s++)
+  FAR const uintptr_t *w;
+  uintptr_t mask;
+
+  while (UNALIGNED(s))
+    {
+      if (*s == (char)c)
+        {
+          return (FAR char *)s;
+        }
+
+      if (*s == '\0')
+        {
+          return NULL;
+        }
+
+      s++;
+    }
+
+  /* Skip the words that hold neither c nor the terminator */
+
+  mask = ONES * (unsigned char)c;
+  w = (FAR const uintptr_t *)s;
+  while (!HASZERO(*w) && !HASZERO(*w ^ mask))
+    {
+      w++;
+    }
+
+  for (s = (FAR const char *)w; ; s++)
     {
-      if (*s == c)
+      if (*s == (char)c)
         {
           return (FAR char *)s;
         }
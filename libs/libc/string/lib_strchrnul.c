@@ -26,10 +26,24 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WORDSIZE     sizeof(uintptr_t)
+#define UNALIGNED(x) (((uintptr_t)(x) & (WORDSIZE - 1)) != 0)
+
+/* HASZERO() is non-zero if any byte of the word is zero */
+
+#define ONES         ((uintptr_t)-1 / 0xff)
+#define HIGHS        (ONES << 7)
+#define HASZERO(x)   (((x) - ONES) & ~(x) & HIGHS)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -52,12 +66,35 @@
 #undef strchrnul /* See mm/README.txt */
 FAR char *strchrnul(FAR const char *s, int c)
 {
-  if (s)
+  FAR const uintptr_t *w;
+  uintptr_t mask;
+
+  if (s == NULL)
     {
-      while (*s != '\0' && *s != c)
+      return NULL;
+    }
+
+  while (UNALIGNED(s))
+    {
+      if (*s == '\0' || *s == (char)c)
         {
-          s++;
+          return (FAR char *)s;
         }
+
+      s++;
+    }
+
+  mask = ONES * (unsigned char)c;
+  w = (FAR const uintptr_t *)s;
+  while (!HASZERO(*w) && !HASZERO(*w ^ mask))
+    {
+      w++;
+    }
+
+  s = (FAR const char *)w;
+  while (*s != '\0' && *s != (char)c)
+    {
+      s++;
     }
 
   return (FAR char *)s;
@@ -26,10 +26,24 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WORDSIZE     sizeof(uintptr_t)
+#define UNALIGNED(x) (((uintptr_t)(x) & (WORDSIZE - 1)) != 0)
+
+/* HASZERO() is non-zero if any byte of the word is zero */
+
+#define ONES         ((uintptr_t)-1 / 0xff)
+#define HIGHS        (ONES << 7)
+#define HASZERO(x)   (((x) - ONES) & ~(x) & HIGHS)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -39,6 +53,41 @@
 int strcmp(FAR const char *cs, FAR const char *ct)
 {
   register int result;
+
+  /* Skip the equal words if both strings can be aligned together.  A word
+   * that holds the terminator ends the loop, the bytes are then compared
+   * one by one below.
+   */
+
+  if ((((uintptr_t)cs ^ (uintptr_t)ct) & (WORDSIZE - 1)) == 0)
+    {
+      FAR const uintptr_t *w1;
+      FAR const uintptr_t *w2;
+
+      while (UNALIGNED(cs))
+        {
+          if ((result = (unsigned char)*cs - (unsigned char)*ct) != 0 ||
+              *cs == '\0')
+            {
+              return result;
+            }
+
+          cs++;
+          ct++;
+        }
+
+      w1 = (FAR const uintptr_t *)cs;
+      w2 = (FAR const uintptr_t *)ct;
+      while (*w1 == *w2 && !HASZERO(*w1))
+        {
+          w1++;
+          w2++;
+        }
+
+      cs = (FAR const char *)w1;
+      ct = (FAR const char *)w2;
+    }
+
   for (; ; )
     {
       if ((result = (unsigned char)*cs - (unsigned char)*ct++) != 0 ||
@@ -26,10 +26,24 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WORDSIZE     sizeof(uintptr_t)
+#define UNALIGNED(x) (((uintptr_t)(x) & (WORDSIZE - 1)) != 0)
+
+/* HASZERO() is non-zero if any byte of the word is zero */
+
+#define ONES         ((uintptr_t)-1 / 0xff)
+#define HIGHS        (ONES << 7)
+#define HASZERO(x)   (((x) - ONES) & ~(x) & HIGHS)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -38,8 +52,35 @@
 #undef strlen /* See mm/README.txt */
 size_t strlen(FAR const char *s)
 {
-  FAR const char *sc;
-  for (sc = s; *sc != '\0'; ++sc);
+  FAR const char *sc = s;
+  FAR const uintptr_t *w;
+
+  /* Test a word at a time once aligned.  An aligned word never crosses a
+   * page, so reading past the terminator cannot fault.
+   */
+
+  while (UNALIGNED(sc))
+    {
+      if (*sc == '\0')
+        {
+          return sc - s;
+        }
+
+      sc++;
+    }
+
+  w = (FAR const uintptr_t *)sc;
+  while (!HASZERO(*w))
+    {
+      w++;
+    }
+
+  sc = (FAR const char *)w;
+  while (*sc != '\0')
+    {
+      sc++;
+    }
+
   return sc - s;
 }
 #endif
@@ -26,10 +26,24 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WORDSIZE     sizeof(uintptr_t)
+#define UNALIGNED(x) (((uintptr_t)(x) & (WORDSIZE - 1)) != 0)
+
+/* HASZERO() is non-zero if any byte of the word is zero */
+
+#define ONES         ((uintptr_t)-1 / 0xff)
+#define HIGHS        (ONES << 7)
+#define HASZERO(x)   (((x) - ONES) & ~(x) & HIGHS)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -38,8 +52,34 @@
 #undef strnlen /* See mm/README.txt */
 size_t strnlen(FAR const char *s, size_t maxlen)
 {
-  FAR const char *sc;
-  for (sc = s; maxlen != 0 && *sc != '\0'; maxlen--, ++sc);
+  FAR const char *sc = s;
+  FAR const uintptr_t *w;
+
+  while (maxlen != 0 && UNALIGNED(sc))
+    {
+      if (*sc == '\0')
+        {
+          return sc - s;
+        }
+
+      sc++;
+      maxlen--;
+    }
+
+  w = (FAR const uintptr_t *)sc;
+  while (maxlen >= WORDSIZE && !HASZERO(*w))
+    {
+      w++;
+      maxlen -= WORDSIZE;
+    }
+
+  sc = (FAR const char *)w;
+  while (maxlen != 0 && *sc != '\0')
+    {
+      sc++;
+      maxlen--;
+    }
+
   return sc - s;
 }
 #endif
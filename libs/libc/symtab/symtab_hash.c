@@ -0,0 +1,257 @@
+/****************************************************************************
+ * libs/libc/symtab/symtab_hash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/symtab.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The second bit of a name in its bloom word, as DT_GNU_HASH does */
+
+#define SYMTAB_BLOOM_SHIFT 6
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_gnuhash
+ *
+ * Description:
+ *   The hash function of DT_GNU_HASH, h = h * 33 + c.
+ *
+ ****************************************************************************/
+
+static uint32_t symtab_gnuhash(FAR const char *name)
+{
+  uint32_t h = 5381;
+
+  while (*name != '\0')
+    {
+      h = (h << 5) + h + (unsigned char)*name++;
+    }
+
+  return h;
+}
+
+/****************************************************************************
+ * Name: symtab_pow2
+ *
+ * Description:
+ *   The smallest power of two that is not less than n.
+ *
+ ****************************************************************************/
+
+static uint32_t symtab_pow2(uint32_t n)
+{
+  uint32_t size = 1;
+
+  while (size < n)
+    {
+      size <<= 1;
+    }
+
+  return size;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hash_create
+ *
+ * Description:
+ *   Build the hash index of a symbol table.  The table must stay unchanged
+ *   as long as the index is used.
+ *
+ * Returned Value:
+ *   The index on success; NULL if it could not be allocated.
+ *
+ ****************************************************************************/
+
+FAR struct symtab_hash_s *
+symtab_hash_create(FAR const struct symtab_s *symtab, int nsyms)
+{
+  FAR struct symtab_hash_s *hash;
+  FAR uint32_t *names;
+  uint32_t nbloom;
+  uint32_t nbuckets;
+  uint32_t h;
+  uint32_t b;
+  int i;
+
+  DEBUGASSERT(symtab != NULL || nsyms == 0);
+
+  /* About two names per bucket and four per bloom word */
+
+  nbuckets = symtab_pow2(nsyms / 2);
+  nbloom   = symtab_pow2(nsyms / 4);
+
+  /* The index and the hashes in table order in one allocation */
+
+  hash = lib_malloc(sizeof(struct symtab_hash_s) +
+                    sizeof(uint32_t) * (nbloom + nbuckets + 1 + 3 * nsyms));
+  if (hash == NULL)
+    {
+      return NULL;
+    }
+
+  hash->symtab     = symtab;
+  hash->nsyms      = nsyms;
+  hash->bloommask  = nbloom - 1;
+  hash->bucketmask = nbuckets - 1;
+  hash->bloom      = (FAR uint32_t *)(hash + 1);
+  hash->buckets    = hash->bloom + nbloom;
+  hash->hashes     = hash->buckets + nbuckets + 1;
+  hash->order      = hash->hashes + nsyms;
+  names            = hash->order + nsyms;
+
+  memset(hash->bloom, 0, sizeof(uint32_t) * (nbloom + nbuckets + 1));
+
+  /* Hash the names, fill the bloom filter and count the names per bucket */
+
+  for (i = 0; i < nsyms; i++)
+    {
+      h = symtab_gnuhash(symtab[i].sym_name);
+      names[i] = h;
+
+      hash->bloom[(h >> 5) & hash->bloommask] |=
+        (UINT32_C(1) << (h & 31)) |
+        (UINT32_C(1) << ((h >> SYMTAB_BLOOM_SHIFT) & 31));
+      hash->buckets[(h & hash->bucketmask) + 1]++;
+    }
+
+  for (b = 0; b < nbuckets; b++)
+    {
+      hash->buckets[b + 1] += hash->buckets[b];
+    }
+
+  /* Sort the entries by bucket.  The entries of a bucket keep the order of
+   * the table, so the first one of duplicated names is found.
+   */
+
+  for (i = 0; i < nsyms; i++)
+    {
+      h = names[i];
+      b = h & hash->bucketmask;
+
+      hash->hashes[hash->buckets[b]] = h;
+      hash->order[hash->buckets[b]++] = i;
+    }
+
+  /* The bucket starts moved to the start of the next bucket */
+
+  for (b = nbuckets; b > 0; b--)
+    {
+      hash->buckets[b] = hash->buckets[b - 1];
+    }
+
+  hash->buckets[0] = 0;
+  return hash;
+}
+
+/****************************************************************************
+ * Name: symtab_hash_destroy
+ *
+ * Description:
+ *   Free the hash index of a symbol table.  The table itself is not freed.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void symtab_hash_destroy(FAR struct symtab_hash_s *hash)
+{
+  lib_free(hash);
+}
+
+/****************************************************************************
+ * Name: symtab_findbyhash
+ *
+ * Description:
+ *   Find the symbol with the matching name through the hash index of a
+ *   symbol table.  The lookup time does not depend on nsyms.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findbyhash(FAR const struct symtab_hash_s *hash,
+                  FAR const char *name)
+{
+  FAR const struct symtab_s *sym;
+  uint32_t word;
+  uint32_t h;
+  uint32_t i;
+  uint32_t end;
+
+  DEBUGASSERT(hash != NULL && name != NULL);
+
+#ifdef CONFIG_SYMTAB_DECORATED
+  if (name[0] == '_')
+    {
+      name++;
+    }
+#endif
+
+  h    = symtab_gnuhash(name);
+  word = hash->bloom[(h >> 5) & hash->bloommask];
+  if (((word >> (h & 31)) & (word >> ((h >> SYMTAB_BLOOM_SHIFT) & 31)) &
+       1) == 0)
+    {
+      return NULL;
+    }
+
+  i   = hash->buckets[h & hash->bucketmask];
+  end = hash->buckets[(h & hash->bucketmask) + 1];
+
+  for (; i < end; i++)
+    {
+      if (hash->hashes[i] == h)
+        {
+          sym = &hash->symtab[hash->order[i]];
+          if (strcmp(name, sym->sym_name) == 0)
+            {
+              return sym;
+            }
+        }
+    }
+
+  return NULL;
+}
@@ -0,0 +1,106 @@
+/****************************************************************************
+ * libs/libc/time/lib_clock_gettime.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/spinlock.h>
+
+#if defined(CONFIG_CLOCK_VDSO) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The time page, updated by the kernel every tick */
+
+struct clock_vdso_s g_clock_vdso;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   Get the current value of the specified time clock.  CLOCK_MONOTONIC,
+ *   CLOCK_BOOTTIME and CLOCK_REALTIME are read from the time page without
+ *   entering the kernel, the other clocks go through nxclock_gettime().
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  FAR struct clock_vdso_s *vdso = &g_clock_vdso;
+  struct timespec base;
+  uint32_t seq;
+
+  if (tp == NULL || clock_id < 0 || clock_id > CLOCK_BOOTTIME)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  if (clock_id != CLOCK_MONOTONIC && clock_id != CLOCK_BOOTTIME &&
+      clock_id != CLOCK_REALTIME)
+    {
+      nxclock_gettime(clock_id, tp);
+      return OK;
+    }
+
+  do
+    {
+      seq = vdso->seq;
+      if (seq == 0)
+        {
+          /* The kernel did not publish the time yet */
+
+          nxclock_gettime(clock_id, tp);
+          return OK;
+        }
+
+      SP_DMB();
+      tp->tv_sec    = vdso->mono_sec;
+      tp->tv_nsec   = vdso->mono_nsec;
+      base.tv_sec   = vdso->base_sec;
+      base.tv_nsec  = vdso->base_nsec;
+      SP_DMB();
+    }
+  while ((seq & 1) != 0 || seq != vdso->seq);
+
+  if (clock_id == CLOCK_REALTIME)
+    {
+      clock_timespec_add(&base, tp, tp);
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_CLOCK_VDSO && !__KERNEL__ */
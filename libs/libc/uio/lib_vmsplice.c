@@ -0,0 +1,82 @@
+/****************************************************************************
+ * libs/libc/uio/lib_vmsplice.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <errno.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vmsplice()
+ *
+ * Description:
+ *   vmsplice() transfers the user buffers of 'iov' into the write end of
+ *   the pipe 'fd' or, for the read end, the data of the pipe into them.
+ *   Pipe buffers do not reference user memory here, so this is the same as
+ *   writev() or readv() and the SPLICE_F_GIFT flag has no effect.  This is
+ *   not a POSIX interface, it follows the Linux vmsplice() interface.
+ *
+ * Input Parameters:
+ *   fd      - A descriptor of a pipe
+ *   iov     - Array of buffer descriptors
+ *   nr_segs - Number of elements in iov[]
+ *   flags   - A bit mask of SPLICE_F_* flags
+ *
+ * Returned Value:
+ *   The number of bytes transferred.  On error, -1 is returned, and errno
+ *   is set appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t vmsplice(int fd, FAR const struct iovec *iov, size_t nr_segs,
+                 unsigned int flags)
+{
+  int oflags;
+
+  if (nr_segs > INT_MAX)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  oflags = fcntl(fd, F_GETFL);
+  if (oflags < 0)
+    {
+      return ERROR;
+    }
+
+  if ((oflags & O_ACCMODE) == O_RDONLY)
+    {
+      return readv(fd, iov, nr_segs);
+    }
+
+  return writev(fd, iov, nr_segs);
+}
@@ -350,3 +350,37 @@ float pid_controller(FAR pid_controller_f32_t *pid, float err)
 
   return pid->out;
 }
+
+/****************************************************************************
+ * Name: pi_controller_v
+ *
+ * Description:
+ *   Run n PI controllers at once, the d and q current controllers of
+ *   several motors for example.  Each controller gets its own error, as
+ *   with pi_controller().
+ *
+ * Input Parameters:
+ *   pid - (in/out) array of n PI controllers
+ *   err - (in) array of n errors
+ *   out - (out) array of n controller outputs
+ *   n   - number of controllers
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pi_controller_v(FAR pid_controller_f32_t *pid, FAR const float *err,
+                     FAR float *out, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(pid != NULL);
+  LIBDSP_DEBUGASSERT(err != NULL);
+  LIBDSP_DEBUGASSERT(out != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      out[i] = pi_controller(&pid[i], err[i]);
+    }
+}
@@ -353,3 +353,37 @@ b16_t pid_controller_b16(FAR pid_controller_b16_t *pid, b16_t err)
 
   return pid->out;
 }
+
+/****************************************************************************
+ * Name: pi_controller_v_b16
+ *
+ * Description:
+ *   Run n PI controllers at once, the d and q current controllers of
+ *   several motors for example.  Each controller gets its own error, as
+ *   with pi_controller_b16().
+ *
+ * Input Parameters:
+ *   pid - (in/out) array of n PI controllers
+ *   err - (in) array of n errors
+ *   out - (out) array of n controller outputs
+ *   n   - number of controllers
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pi_controller_v_b16(FAR pid_controller_b16_t *pid, FAR const b16_t *err,
+                         FAR b16_t *out, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(pid != NULL);
+  LIBDSP_DEBUGASSERT(err != NULL);
+  LIBDSP_DEBUGASSERT(out != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      out[i] = pi_controller_b16(&pid[i], err[i]);
+    }
+}
@@ -435,3 +435,33 @@ void svm3_init(FAR struct svm3_state_f32_s *s)
 
   memset(s, 0, sizeof(struct svm3_state_f32_s));
 }
+
+/****************************************************************************
+ * Name: svm3_v
+ *
+ * Description:
+ *   Space vector modulation of n motors at once, see svm3().
+ *
+ * Input Parameters:
+ *   s    - (in/out) array of n SVM states
+ *   v_ab - (in) array of n voltage vectors in the alpha-beta frame
+ *   n    - number of motors
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void svm3_v(FAR struct svm3_state_f32_s *s, FAR ab_frame_f32_t *v_ab,
+            size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(s != NULL);
+  LIBDSP_DEBUGASSERT(v_ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      svm3(&s[i], &v_ab[i]);
+    }
+}
@@ -436,3 +436,33 @@ void svm3_init_b16(FAR struct svm3_state_b16_s *s)
 
   memset(s, 0, sizeof(struct svm3_state_b16_s));
 }
+
+/****************************************************************************
+ * Name: svm3_v_b16
+ *
+ * Description:
+ *   Space vector modulation of n motors at once, see svm3_b16().
+ *
+ * Input Parameters:
+ *   s    - (in/out) array of n SVM states
+ *   v_ab - (in) array of n voltage vectors in the alpha-beta frame
+ *   n    - number of motors
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void svm3_v_b16(FAR struct svm3_state_b16_s *s, FAR ab_frame_b16_t *v_ab,
+                size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(s != NULL);
+  LIBDSP_DEBUGASSERT(v_ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      svm3_b16(&s[i], &v_ab[i]);
+    }
+}
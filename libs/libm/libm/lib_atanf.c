@@ -32,11 +32,43 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "libm.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FLOAT_FAST
+float atanf(float x)
+{
+  float ax = fabsf(x);
+  float y = 0.0F;
+  float z;
+
+  /* Reduce |x| to [0, tan(pi/8)] with atan(x) = pi/2 - atan(1/x) and
+   * atan(x) = pi/4 + atan((x - 1) / (x + 1)).
+   */
+
+  if (ax > 2.414213562373095F)
+    {
+      y  = M_PI_2_F;
+      ax = -1.0F / ax;
+    }
+  else if (ax > 0.4142135623730950F)
+    {
+      y  = (float)M_PI_4;
+      ax = (ax - 1.0F) / (ax + 1.0F);
+    }
+
+  z  = ax * ax;
+  y += (((8.05374449538e-2F * z - 1.38776856032e-1F) * z +
+         1.99777106478e-1F) * z - 3.33329491539e-1F) * z * ax + ax;
+
+  return copysignf(y, x);
+}
+#else
 float atanf(float x)
 {
   return asinf(x / sqrtf(x * x + 1.0F));
 }
+#endif
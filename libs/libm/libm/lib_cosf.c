@@ -30,11 +30,26 @@
 
 #include <math.h>
 
+#include "libm.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FLOAT_FAST
+float cosf(float x)
+{
+  float r;
+  float y;
+  int n;
+
+  n = lib_rempio2f(x, &r);
+  y = (n & 1) ? lib_sinkf(r) : lib_coskf(r);
+  return ((n + 1) & 2) ? -y : y;
+}
+#else
 float cosf(float x)
 {
   return sinf(x + M_PI_2_F);
 }
+#endif
@@ -37,6 +37,7 @@
  * Private Data
  ****************************************************************************/
 
+#ifndef CONFIG_LIBM_FLOAT_FAST
 static float _flt_inv_fact[] =
 {
   1.0 / 1.0,                    /* 1/0! */
@@ -51,11 +52,45 @@ static float _flt_inv_fact[] =
   1.0 / 362880.0,               /* 1/9! */
   1.0 / 3628800.0,              /* 1/10! */
 };
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FLOAT_FAST
+float expf(float x)
+{
+  float p;
+  int k;
+
+  if (x >= LIB_EXPF_MIN && x <= LIB_EXPF_MAX)
+    {
+      p = lib_expkf(x, &k);
+      return p * lib_exp2if(k);
+    }
+
+  if (isnanf(x))
+    {
+      return x;
+    }
+
+  if (x > LIB_EXPF_OVERFLOW)
+    {
+      return INFINITY_F;
+    }
+
+  if (x < LIB_EXPF_UNDERFLOW)
+    {
+      return 0.0F;
+    }
+
+  /* 2^k is out of the normal range, let scalbnf() round the result */
+
+  p = lib_expkf(x, &k);
+  return scalbnf(p, k);
+}
+#else
 float expf(float x)
 {
   size_t int_part;
@@ -109,3 +144,4 @@ float expf(float x)
       return value;
     }
 }
+#endif
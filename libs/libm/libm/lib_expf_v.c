@@ -0,0 +1,82 @@
+/****************************************************************************
+ * libs/libm/libm/lib_expf_v.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+
+#include "libm.h"
+
+#ifdef CONFIG_LIBM_FLOAT_FAST
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: expf_v
+ *
+ * Description:
+ *   Compute expf() of n values, see sincosf_v() for the vectorization.
+ *
+ * Input Parameters:
+ *   x - The arguments
+ *   y - The results, may be x
+ *   n - The number of values
+ *
+ ****************************************************************************/
+
+void expf_v(FAR const float *x, FAR float *y, size_t n)
+{
+  size_t big = 0;
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      big += !(x[i] >= LIB_EXPF_MIN && x[i] <= LIB_EXPF_MAX);
+    }
+
+  if (big != 0)
+    {
+      for (i = 0; i < n; i++)
+        {
+          y[i] = expf(x[i]);
+        }
+
+      return;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      float p;
+      int k;
+
+      p = lib_expkf(x[i], &k);
+      y[i] = p * lib_exp2if(k);
+    }
+}
+
+#endif /* CONFIG_LIBM_FLOAT_FAST */
@@ -0,0 +1,91 @@
+/****************************************************************************
+ * libs/libm/libm/lib_librempio2f.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+
+#include "libm.h"
+
+#ifdef CONFIG_LIBM_FLOAT_FAST
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The double reduction is accurate below 2^28, pi/2 in two parts of which
+ * the first has 33 bits.
+ */
+
+#define LIB_PIO2_MAX    268435456.0F
+#define LIB_PIO2_1      1.57079632673412561417e+00
+#define LIB_PIO2_1T     6.07710050650619224932e-11
+
+/* Adding and subtracting 1.5 * 2^52 rounds a double to an integer */
+
+#define LIB_RINT_SHIFT  6755399441055744.0
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_rempio2f
+ *
+ * Description:
+ *   Reduce x to r = x - n * pi/2 in [-pi/4, pi/4] and return n.  Only
+ *   the two lowest bits of n are meaningful.
+ *
+ ****************************************************************************/
+
+int lib_rempio2f(float x, FAR float *r)
+{
+#ifdef CONFIG_HAVE_DOUBLE
+  double n;
+#endif
+
+  if (fabsf(x) < LIB_PIO2F_MAX)
+    {
+      return lib_rempio2kf(x, r);
+    }
+
+#ifdef CONFIG_HAVE_DOUBLE
+  if (fabsf(x) < LIB_PIO2_MAX)
+    {
+      n  = ((double)x * M_2_PI + LIB_RINT_SHIFT) - LIB_RINT_SHIFT;
+      *r = (float)(((double)x - n * LIB_PIO2_1) - n * LIB_PIO2_1T);
+      return (int)n;
+    }
+#endif
+
+  /* Too large for the reduction, or not finite.  The result is no longer
+   * accurate, but stays in [-1, 1] as with the Taylor series version.
+   */
+
+  return lib_rempio2kf(fmodf(x, 2 * M_PI_F), r);
+}
+
+#endif /* CONFIG_LIBM_FLOAT_FAST */
@@ -28,6 +28,8 @@
 
 #include <math.h>
 
+#include "libm.h"
+
 /* Disable sincos optimization for all functions in this file,
  * otherwise gcc would generate infinite calls.
  * Refer to gcc PR46926.
@@ -40,9 +42,27 @@
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FLOAT_FAST
+void sincosf(float x, FAR float *s, FAR float *c)
+{
+  float r;
+  int n;
+
+  if (fabsf(x) < LIB_SINF_TINY)
+    {
+      *s = x;
+      *c = 1.0F;
+      return;
+    }
+
+  n = lib_rempio2f(x, &r);
+  lib_sincoskf(r, n, s, c);
+}
+#else
 nooptimiziation_function
 void sincosf(float x, FAR float *s, FAR float *c)
 {
   *s = sinf(x);
   *c = cosf(x);
 }
+#endif
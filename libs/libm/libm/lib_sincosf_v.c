@@ -0,0 +1,86 @@
+/****************************************************************************
+ * libs/libm/libm/lib_sincosf_v.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+
+#include "libm.h"
+
+#ifdef CONFIG_LIBM_FLOAT_FAST
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sincosf_v
+ *
+ * Description:
+ *   Compute sincosf() of n values.  The second loop has no branches and no
+ *   calls, so that the compiler vectorizes it for NEON, MVE or RVV when
+ *   vectorization is enabled.  It is taken unless some argument is out of
+ *   its range, which the cheap first loop finds out.
+ *
+ * Input Parameters:
+ *   x - The arguments
+ *   s - The sines, s or c may be x
+ *   c - The cosines
+ *   n - The number of values
+ *
+ ****************************************************************************/
+
+void sincosf_v(FAR const float *x, FAR float *s, FAR float *c, size_t n)
+{
+  size_t big = 0;
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      big += !(fabsf(x[i]) < LIB_PIO2F_MAX);
+    }
+
+  if (big != 0)
+    {
+      for (i = 0; i < n; i++)
+        {
+          sincosf(x[i], &s[i], &c[i]);
+        }
+
+      return;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      float r;
+      int q;
+
+      q = lib_rempio2kf(x[i], &r);
+      lib_sincoskf(r, q, &s[i], &c[i]);
+    }
+}
+
+#endif /* CONFIG_LIBM_FLOAT_FAST */
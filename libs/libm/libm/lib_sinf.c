@@ -31,10 +31,13 @@
 #include <sys/types.h>
 #include <math.h>
 
+#include "libm.h"
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifndef CONFIG_LIBM_FLOAT_FAST
 static float _flt_inv_fact[] =
 {
   1.0 / 1.0,                    /* 1 / 1! */
@@ -44,11 +47,31 @@ static float _flt_inv_fact[] =
   1.0 / 362880.0,               /* 1 / 9! */
   1.0 / 39916800.0,             /* 1 / 11! */
 };
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FLOAT_FAST
+float sinf(float x)
+{
+  float r;
+  float y;
+  int n;
+
+  /* sin(x) is x to float precision, including -0 */
+
+  if (fabsf(x) < LIB_SINF_TINY)
+    {
+      return x;
+    }
+
+  n = lib_rempio2f(x, &r);
+  y = (n & 1) ? lib_coskf(r) : lib_sinkf(r);
+  return (n & 2) ? -y : y;
+}
+#else
 float sinf(float x)
 {
   float x_squared;
@@ -101,3 +124,4 @@ float sinf(float x)
 
   return sin_x;
 }
+#endif
@@ -29,15 +29,60 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
+#include <math.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FLOAT_FAST
+
+/* The float reduction to [-pi/4, pi/4] is accurate below LIB_PIO2F_MAX.
+ * The first three parts of pi/2 have at most 11 bits, so that their
+ * products with n < 2^13 are exact.
+ */
+
+#define LIB_PIO2F_MAX       8192.0F
+#define LIB_PIO2F_1         1.5703125F
+#define LIB_PIO2F_2         4.837512969970703125e-4F
+#define LIB_PIO2F_3         7.549533620476723e-8F
+#define LIB_PIO2F_4         2.5633440682570896e-12F
+
+/* ln(2) in two parts for expf(), k * LIB_LN2F_1 is exact for |k| < 2^12 */
+
+#define LIB_LN2F_1          0.693359375F
+#define LIB_LN2F_2          -2.12194440e-4F
+
+/* sin(x) rounds to x below 2^-12 */
+
+#define LIB_SINF_TINY       2.44140625e-4F
+
+/* The range of lib_expkf(), and where expf() overflows or underflows */
+
+#define LIB_EXPF_MIN        -87.0F
+#define LIB_EXPF_MAX        88.0F
+#define LIB_EXPF_OVERFLOW   88.72283905206835F
+#define LIB_EXPF_UNDERFLOW  -103.97208404541015625F
+
+/* Adding and subtracting 1.5 * 2^23 rounds a float to an integer */
+
+#define LIB_RINTF_SHIFT     12582912.0F
+
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FLOAT_FAST
+union lib_floatbits_u
+{
+  float    f;
+  uint32_t i;
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -64,6 +109,115 @@ double lib_expi(size_t n);
 
 float lib_sqrtapprox(float x);
 
+#ifdef CONFIG_LIBM_FLOAT_FAST
+
+/* Defined in lib_librempio2f.c */
+
+int lib_rempio2f(float x, FAR float *r);
+
+/****************************************************************************
+ * Name: lib_rempio2kf
+ *
+ * Description:
+ *   Reduce |x| < LIB_PIO2F_MAX to r = x - n * pi/2 in [-pi/4, pi/4] and
+ *   return n.  lib_rempio2f() also takes the larger arguments.
+ *
+ *   These inline kernels have no branches, so that the compiler may
+ *   vectorize the loops of sincosf_v() and expf_v().
+ *
+ ****************************************************************************/
+
+static inline int lib_rempio2kf(float x, FAR float *r)
+{
+  float n = (x * (float)M_2_PI + LIB_RINTF_SHIFT) - LIB_RINTF_SHIFT;
+
+  *r = (((x - n * LIB_PIO2F_1) - n * LIB_PIO2F_2) - n * LIB_PIO2F_3) -
+       n * LIB_PIO2F_4;
+  return (int)n;
+}
+
+/****************************************************************************
+ * Name: lib_sinkf and lib_coskf
+ *
+ * Description:
+ *   sin(r) and cos(r) on [-pi/4, pi/4], minimax polynomials of degree 7
+ *   and 8 that are good to the last bit of a float.
+ *
+ ****************************************************************************/
+
+static inline float lib_sinkf(float r)
+{
+  float z = r * r;
+
+  return ((-1.9515295891e-4F * z + 8.3321608736e-3F) * z -
+          1.6666654611e-1F) * z * r + r;
+}
+
+static inline float lib_coskf(float r)
+{
+  float z = r * r;
+
+  return ((2.443315711809948e-5F * z - 1.388731625493765e-3F) * z +
+          4.166664568298827e-2F) * z * z - 0.5F * z + 1.0F;
+}
+
+/****************************************************************************
+ * Name: lib_sincoskf
+ *
+ * Description:
+ *   sin(x) and cos(x) from r and n of lib_rempio2kf().
+ *
+ ****************************************************************************/
+
+static inline void lib_sincoskf(float r, int n, FAR float *s, FAR float *c)
+{
+  float sr = lib_sinkf(r);
+  float cr = lib_coskf(r);
+  float sx = (n & 1) ? cr : sr;
+  float cx = (n & 1) ? sr : cr;
+
+  *s = (n & 2) ? -sx : sx;
+  *c = ((n + 1) & 2) ? -cx : cx;
+}
+
+/****************************************************************************
+ * Name: lib_expkf
+ *
+ * Description:
+ *   Return e^r and k with e^x = e^r * 2^k, |r| <= ln(2) / 2.  2^k is a
+ *   normal float for x in [LIB_EXPF_MIN, LIB_EXPF_MAX].
+ *
+ ****************************************************************************/
+
+static inline float lib_expkf(float x, FAR int *k)
+{
+  float n = (x * (float)M_LOG2E + LIB_RINTF_SHIFT) - LIB_RINTF_SHIFT;
+  float r = (x - n * LIB_LN2F_1) - n * LIB_LN2F_2;
+
+  *k = (int)n;
+  return (((((1.9875691500e-4F * r + 1.3981999507e-3F) * r +
+             8.3334519073e-3F) * r + 4.1665795894e-2F) * r +
+             1.6666665459e-1F) * r + 5.0000001201e-1F) * r * r + r + 1.0F;
+}
+
+/****************************************************************************
+ * Name: lib_exp2if
+ *
+ * Description:
+ *   2^k for k in [-126, 127].
+ *
+ ****************************************************************************/
+
+static inline float lib_exp2if(int k)
+{
+  union lib_floatbits_u u;
+
+  u.i = (uint32_t)(k + 127) << 23;
+  return u.f;
+}
+
+#endif /* CONFIG_LIBM_FLOAT_FAST */
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -53,6 +53,31 @@
 #  define iobinfo                _none
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+/* The caches are only filled with buffers above the throttle reserve, and
+ * all of them together must leave some of those to the global free list.
+ */
+
+#if CONFIG_IOB_PCPU_CACHE > 0 && \
+    CONFIG_IOB_PCPU_CACHE * CONFIG_SMP_NCPUS >= \
+    CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE
+#  error CONFIG_IOB_PCPU_CACHE too large for CONFIG_IOB_NBUFFERS
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#if CONFIG_IOB_PCPU_CACHE > 0
+struct iob_pcpu_s
+{
+  spinlock_t ic_lock;         /* Taken by iob_pcpu_drain() on another CPU */
+  FAR struct iob_s *ic_head;  /* LIFO list of cached I/O buffers */
+  uint16_t ic_count;          /* Number of I/O buffers in ic_head */
+  unsigned long ic_hits;      /* Allocations served from the cache */
+  unsigned long ic_misses;    /* Allocations that found the cache empty */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -83,6 +108,10 @@ extern sem_t g_iob_sem;
 
 extern volatile int16_t g_iob_count;
 
+/* The lowest value of g_iob_count since the last iob_resetstats() */
+
+extern int16_t g_iob_minfree;
+
 #if CONFIG_IOB_THROTTLE > 0
 extern sem_t g_throttle_sem;
 
@@ -100,10 +129,38 @@ extern volatile int16_t g_qentry_count;
 
 extern volatile spinlock_t g_iob_lock;
 
+#if CONFIG_IOB_PCPU_CACHE > 0
+/* Per-CPU I/O buffer caches.  Each cache is accessed by its own CPU with
+ * local interrupts disabled and its ic_lock held, other CPUs only take
+ * the lock to drain it.  Buffers in a cache are accounted as allocated
+ * from the global free list.
+ */
+
+extern struct iob_pcpu_s g_iob_pcpu[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_pcpu_drain
+ *
+ * Description:
+ *   Return the I/O buffers held in the caches of all CPUs to the global
+ *   free list, handing them to waiting allocations first.  This is done
+ *   before an allocation fails or waits, so that no buffer is stranded in
+ *   the cache of another CPU.
+ *
+ * Returned Value:
+ *   The number of I/O buffers returned.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PCPU_CACHE > 0
+int iob_pcpu_drain(void);
+#endif
+
 /****************************************************************************
  * Name: iob_alloc_qentry
  *
@@ -146,6 +146,11 @@ static FAR struct iob_s *iob_tryalloc_internal(bool throttled)
           g_iob_count--;
           DEBUGASSERT(g_iob_count >= 0);
 
+          if (g_iob_count < g_iob_minfree)
+            {
+              g_iob_minfree = g_iob_count;
+            }
+
 #if CONFIG_IOB_THROTTLE > 0
           /* The throttle semaphore is used to throttle the number of
            * free buffers that are available.  It is used to prevent
@@ -173,6 +178,110 @@ static FAR struct iob_s *iob_tryalloc_internal(bool throttled)
   return NULL;
 }
 
+/****************************************************************************
+ * Name: iob_alloc_batch
+ *
+ * Description:
+ *   Take up to 'n' I/O buffers from the global free list with a single
+ *   acquisition of g_iob_lock.  Returns the number of buffers taken.
+ *
+ ****************************************************************************/
+
+static int iob_alloc_batch(FAR struct iob_s **iobs, int n, bool throttled)
+{
+  FAR struct iob_s *iob;
+  int i;
+
+  spin_lock(&g_iob_lock);
+  for (i = 0; i < n; i++)
+    {
+      iob = iob_tryalloc_internal(throttled);
+      if (iob == NULL)
+        {
+          break;
+        }
+
+      iobs[i] = iob;
+    }
+
+  spin_unlock(&g_iob_lock);
+  return i;
+}
+
+#if CONFIG_IOB_PCPU_CACHE > 0
+/****************************************************************************
+ * Name: iob_pcpu_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of the current CPU.  If the cache is
+ *   empty, refill it from the global free list with a single acquisition
+ *   of g_iob_lock.  The refill only takes buffers that are available to
+ *   throttled allocations so that the throttle reserve stays in the
+ *   global free list.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_pcpu_alloc(bool throttled)
+{
+  FAR struct iob_pcpu_s *cache;
+  FAR struct iob_s *iob;
+  FAR struct iob_s *next;
+  irqstate_t flags;
+  int i;
+
+  /* Disabling local interrupts keeps us on this CPU, the lock is only
+   * contended by iob_pcpu_drain().
+   */
+
+  flags = up_irq_save();
+  cache = &g_iob_pcpu[this_cpu()];
+  spin_lock(&cache->ic_lock);
+
+  iob = cache->ic_head;
+  if (iob != NULL)
+    {
+      cache->ic_head = iob->io_flink;
+      cache->ic_count--;
+      cache->ic_hits++;
+      spin_unlock(&cache->ic_lock);
+      up_irq_restore(flags);
+
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+      return iob;
+    }
+
+  cache->ic_misses++;
+
+  spin_lock(&g_iob_lock);
+  iob = iob_tryalloc_internal(throttled);
+  if (iob != NULL)
+    {
+      for (i = 1; i < CONFIG_IOB_PCPU_BATCH; i++)
+        {
+          next = iob_tryalloc_internal(true);
+          if (next == NULL)
+            {
+              break;
+            }
+
+          next->io_flink = cache->ic_head;
+          cache->ic_head = next;
+          cache->ic_count++;
+        }
+    }
+
+  spin_unlock(&g_iob_lock);
+  spin_unlock(&cache->ic_lock);
+  up_irq_restore(flags);
+  return iob;
+}
+#endif
+
 /****************************************************************************
  * Name: iob_allocwait
  *
@@ -201,6 +310,21 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
   sem = &g_iob_sem;
 #endif
 
+#if CONFIG_IOB_PCPU_CACHE > 0
+  /* Try the cache of this CPU first.  Before waiting, return the buffers
+   * cached by all CPUs to the global free list so that we do not sleep
+   * while free buffers sit in another cache.
+   */
+
+  iob = iob_pcpu_alloc(throttled);
+  if (iob != NULL)
+    {
+      return iob;
+    }
+
+  iob_pcpu_drain();
+#endif
+
   /* The following must be atomic; interrupt must be disabled so that there
    * is no conflict with interrupt level I/O buffer allocations.  This is
    * not as bad as it sounds because interrupts will be re-enabled while
@@ -330,6 +454,19 @@ FAR struct iob_s *iob_alloc(bool throttled)
 
 FAR struct iob_s *iob_tryalloc(bool throttled)
 {
+#if CONFIG_IOB_PCPU_CACHE > 0
+  FAR struct iob_s *iob;
+
+  /* Fail only after the caches of the other CPUs were drained */
+
+  iob = iob_pcpu_alloc(throttled);
+  if (iob == NULL && iob_pcpu_drain() > 0)
+    {
+      iob = iob_pcpu_alloc(throttled);
+    }
+
+  return iob;
+#else
   FAR struct iob_s *iob;
   irqstate_t flags;
 
@@ -341,6 +478,71 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   iob = iob_tryalloc_internal(throttled);
   spin_unlock_irqrestore(&g_iob_lock, flags);
   return iob;
+#endif
+}
+
+/****************************************************************************
+ * Name: iob_alloc_multiple
+ *
+ * Description:
+ *   Try to allocate up to 'n' I/O buffers in a single critical section
+ *   without waiting for buffers to become free.
+ *
+ ****************************************************************************/
+
+int iob_alloc_multiple(FAR struct iob_s **iobs, int n, bool throttled)
+{
+#if CONFIG_IOB_PCPU_CACHE > 0
+  FAR struct iob_pcpu_s *cache;
+  FAR struct iob_s *iob;
+#endif
+  irqstate_t flags;
+  int i = 0;
+
+  DEBUGASSERT(iobs != NULL && n >= 0);
+
+  flags = up_irq_save();
+
+#if CONFIG_IOB_PCPU_CACHE > 0
+  /* Drain the cache of this CPU first */
+
+  cache = &g_iob_pcpu[this_cpu()];
+  spin_lock(&cache->ic_lock);
+  while (i < n && cache->ic_head != NULL)
+    {
+      iob            = cache->ic_head;
+      cache->ic_head = iob->io_flink;
+      cache->ic_count--;
+      cache->ic_hits++;
+
+      iob->io_flink  = NULL;
+      iob->io_len    = 0;
+      iob->io_offset = 0;
+      iob->io_pktlen = 0;
+      iobs[i++]      = iob;
+    }
+
+  spin_unlock(&cache->ic_lock);
+#endif
+
+  if (i < n)
+    {
+      i += iob_alloc_batch(&iobs[i], n - i, throttled);
+    }
+
+#if CONFIG_IOB_PCPU_CACHE > 0
+  /* Report a short batch only after the caches of the other CPUs were
+   * drained.
+   */
+
+  if (i < n && iob_pcpu_drain() > 0)
+    {
+      i += iob_alloc_batch(&iobs[i], n - i, throttled);
+    }
+#endif
+
+  up_irq_restore(flags);
+  return i;
 }
 
 #ifdef CONFIG_IOB_ALLOC
@@ -33,6 +33,9 @@
 #include <debug.h>
 
 #include <nuttx/mm/iob.h>
+#ifdef CONFIG_NET_CHKSUM_COPY
+#  include <nuttx/net/netdev.h>
+#endif
 
 #include "iob.h"
 
@@ -86,11 +89,7 @@ static int iob_next(FAR struct iob_s *iob, bool throttled, bool block)
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: iob_clone_partial
+ * Name: iob_clone_partial_internal
  *
  * Description:
  *   Duplicate the data from partial bytes of iob1 to iob2
@@ -103,6 +102,7 @@ static int iob_next(FAR struct iob_s *iob, bool throttled, bool block)
  *   offset2   - Offset of destination iobs_s
  *   throttled - An indication of the IOB allocation is "throttled"
  *   block     - Flag of Enable/Disable nonblocking operation
+ *   sum       - Accumulate the checksum of the copied data if not NULL
  *
  * Returned Value:
  *   == 0  - Partial clone successfully.
@@ -110,15 +110,22 @@ static int iob_next(FAR struct iob_s *iob, bool throttled, bool block)
  *
  ****************************************************************************/
 
-int iob_clone_partial(FAR struct iob_s *iob1, unsigned int len,
-                      int offset1, FAR struct iob_s *iob2,
-                      int offset2, bool throttled, bool block)
+static int iob_clone_partial_internal(FAR struct iob_s *iob1,
+                                      unsigned int len, int offset1,
+                                      FAR struct iob_s *iob2, int offset2,
+                                      bool throttled, bool block,
+                                      FAR uint16_t *sum)
 {
   FAR uint8_t *src;
   FAR uint8_t *dest;
   unsigned int ncopy;
   unsigned int avail1;
   unsigned int avail2;
+#ifdef CONFIG_NET_CHKSUM_COPY
+  bool odd = false;
+#else
+  UNUSED(sum);
+#endif
   int ret;
 
   /* Copy the total packet size from the I/O buffer at the head of the
@@ -189,7 +196,16 @@ int iob_clone_partial(FAR struct iob_s *iob1, unsigned int len,
 
       len -= ncopy;
 
-      memcpy(dest, src, ncopy);
+#ifdef CONFIG_NET_CHKSUM_COPY
+      if (sum != NULL)
+        {
+          *sum = chksum_copy(*sum, dest, src, ncopy, &odd);
+        }
+      else
+#endif
+        {
+          memcpy(dest, src, ncopy);
+        }
 
       offset1      += ncopy;
       offset2      += ncopy;
@@ -237,6 +253,59 @@ int iob_clone_partial(FAR struct iob_s *iob1, unsigned int len,
   return 0;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_clone_partial
+ *
+ * Description:
+ *   Duplicate the data from partial bytes of iob1 to iob2
+ *
+ * Input Parameters:
+ *   iob1      - Pointer to source iob_s
+ *   len       - Number of bytes to copy
+ *   offset1   - Offset of source iobs_s
+ *   iob2      - Pointer to destination iob_s
+ *   offset2   - Offset of destination iobs_s
+ *   throttled - An indication of the IOB allocation is "throttled"
+ *   block     - Flag of Enable/Disable nonblocking operation
+ *
+ * Returned Value:
+ *   == 0  - Partial clone successfully.
+ *   < 0   - No available to clone to destination iob.
+ *
+ ****************************************************************************/
+
+int iob_clone_partial(FAR struct iob_s *iob1, unsigned int len,
+                      int offset1, FAR struct iob_s *iob2,
+                      int offset2, bool throttled, bool block)
+{
+  return iob_clone_partial_internal(iob1, len, offset1, iob2, offset2,
+                                    throttled, block, NULL);
+}
+
+/****************************************************************************
+ * Name: iob_clone_partial_chksum
+ *
+ * Description:
+ *   Same as iob_clone_partial(), and accumulate the raw change sum of the
+ *   copied data into 'sum' in the same pass.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+int iob_clone_partial_chksum(FAR struct iob_s *iob1, unsigned int len,
+                             int offset1, FAR struct iob_s *iob2,
+                             int offset2, bool throttled, bool block,
+                             FAR uint16_t *sum)
+{
+  return iob_clone_partial_internal(iob1, len, offset1, iob2, offset2,
+                                    throttled, block, sum);
+}
+#endif
+
 /****************************************************************************
  * Name: iob_clone
  *
@@ -33,6 +33,9 @@
 #include <debug.h>
 
 #include <nuttx/mm/iob.h>
+#ifdef CONFIG_NET_CHKSUM_COPY
+#  include <nuttx/net/netdev.h>
+#endif
 
 #include "iob.h"
 
@@ -45,7 +48,8 @@
  *
  * Description:
  *  Copy data 'len' bytes from a user buffer into the I/O buffer chain,
- *  starting at 'offset', extending the chain as necessary.
+ *  starting at 'offset', extending the chain as necessary.  If 'sum' is
+ *  not NULL, the checksum of the copied data is accumulated into it.
  *
  * Returned Value:
  *  The number of uncopied bytes left if >= 0 OR a negative error code.
@@ -54,7 +58,8 @@
 
 static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
                                unsigned int len, int offset,
-                               bool throttled, bool can_block)
+                               bool throttled, bool can_block,
+                               FAR uint16_t *sum)
 {
   FAR struct iob_s *head = iob;
   FAR struct iob_s *next;
@@ -62,6 +67,11 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
   unsigned int ncopy;
   unsigned int avail;
   unsigned int total = len;
+#ifdef CONFIG_NET_CHKSUM_COPY
+  bool odd = false;
+#else
+  UNUSED(sum);
+#endif
 
   iobinfo("iob=%p len=%u offset=%d\n", iob, len, offset);
   DEBUGASSERT(iob && src);
@@ -161,7 +171,17 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 
       /* Copy from the user buffer to the I/O buffer.  */
 
-      memcpy(dest, src, ncopy);
+#ifdef CONFIG_NET_CHKSUM_COPY
+      if (sum != NULL)
+        {
+          *sum = chksum_copy(*sum, dest, src, ncopy, &odd);
+        }
+      else
+#endif
+        {
+          memcpy(dest, src, ncopy);
+        }
+
       iobinfo("iob=%p Copy %u bytes new len=%u\n",
               iob, ncopy, iob->io_len);
 
@@ -227,7 +247,7 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 int iob_copyin(FAR struct iob_s *iob, FAR const uint8_t *src,
                unsigned int len, int offset, bool throttled)
 {
-  return iob_copyin_internal(iob, src, len, offset, throttled, true);
+  return iob_copyin_internal(iob, src, len, offset, throttled, true, NULL);
 }
 
 /****************************************************************************
@@ -243,5 +263,41 @@ int iob_copyin(FAR struct iob_s *iob, FAR const uint8_t *src,
 int iob_trycopyin(FAR struct iob_s *iob, FAR const uint8_t *src,
                   unsigned int len, int offset, bool throttled)
 {
-  return iob_copyin_internal(iob, src, len, offset, throttled, false);
+  return iob_copyin_internal(iob, src, len, offset, throttled, false,
+                             NULL);
+}
+
+/****************************************************************************
+ * Name: iob_copyin_chksum
+ *
+ * Description:
+ *  Copy data 'len' bytes from a user buffer into the I/O buffer chain,
+ *  starting at 'offset', extending the chain as necessary, and accumulate
+ *  the raw change sum of the copied data into 'sum' in the same pass.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+int iob_copyin_chksum(FAR struct iob_s *iob, FAR const uint8_t *src,
+                      unsigned int len, int offset, bool throttled,
+                      FAR uint16_t *sum)
+{
+  return iob_copyin_internal(iob, src, len, offset, throttled, true, sum);
+}
+
+/****************************************************************************
+ * Name: iob_trycopyin_chksum
+ *
+ * Description:
+ *  Same as iob_copyin_chksum() BUT without waiting if buffers are not
+ *  available.
+ *
+ ****************************************************************************/
+
+int iob_trycopyin_chksum(FAR struct iob_s *iob, FAR const uint8_t *src,
+                         unsigned int len, int offset, bool throttled,
+                         FAR uint16_t *sum)
+{
+  return iob_copyin_internal(iob, src, len, offset, throttled, false, sum);
 }
+#endif /* CONFIG_NET_CHKSUM_COPY */
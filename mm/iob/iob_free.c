@@ -32,6 +32,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/sched.h>
 #ifdef CONFIG_IOB_ALLOC
 #  include <nuttx/kmalloc.h>
 #endif
@@ -63,10 +64,302 @@
 
 #define IOB_MASK      (IOB_DIVIDER - 1)
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_free_locked
+ *
+ * Description:
+ *   Add one I/O buffer to the head of the free or the committed list.  The
+ *   caller must hold g_iob_lock.
+ *
+ * Returned Value:
+ *   The semaphore that the caller must post after releasing g_iob_lock, or
+ *   NULL if the buffer was put on the free list.
+ *
+ ****************************************************************************/
+
+static FAR sem_t *iob_free_locked(FAR struct iob_s *iob)
+{
+  FAR sem_t *sem = NULL;
+
+  /* Which list?  If there is a task waiting for an IOB, then put
+   * the IOB on either the free list or on the committed list where
+   * it is reserved for that allocation (and not available to
+   * iob_tryalloc()). This is true for both throttled and non-throttled
+   * cases.
+   */
+
+#if CONFIG_IOB_THROTTLE > 0
+  if ((g_iob_count < 0) ||
+      ((g_iob_count >= CONFIG_IOB_THROTTLE) &&
+       (g_throttle_count < 0)))
+#else
+  if (g_iob_count < 0)
+#endif
+    {
+      iob->io_flink   = g_iob_committed;
+      g_iob_committed = iob;
+
+#if CONFIG_IOB_THROTTLE > 0
+      if (g_iob_count < 0)
+        {
+          g_iob_count++;
+          sem = &g_iob_sem;
+        }
+      else
+        {
+          g_throttle_count++;
+          sem = &g_throttle_sem;
+        }
+#else
+      g_iob_count++;
+      sem = &g_iob_sem;
+#endif
+    }
+  else
+    {
+      g_iob_count++;
+#if CONFIG_IOB_THROTTLE > 0
+      if (g_iob_count > CONFIG_IOB_THROTTLE)
+        {
+          g_throttle_count++;
+        }
+#endif
+
+      iob->io_flink   = g_iob_freelist;
+      g_iob_freelist  = iob;
+    }
+
+  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
+
+#if CONFIG_IOB_THROTTLE > 0
+  DEBUGASSERT(g_throttle_count <=
+              (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
+#endif
+
+  return sem;
+}
+
+/****************************************************************************
+ * Name: iob_free_notify
+ *
+ * Description:
+ *   Signal the IOB notifier if the number of available I/O buffers reached
+ *   a multiple of the notification divider since 'before' was sampled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_NOTIFIER
+static void iob_free_notify(int16_t before)
+{
+  int16_t navail;
+
+  /* Check if the IOB was claimed by a thread that is blocked waiting
+   * for an IOB.
+   */
+
+  navail = iob_navail(false);
+  if (navail > 0 && (navail & ~IOB_MASK) != (before & ~IOB_MASK))
+    {
+      /* Signal any threads that have requested a signal notification
+       * when an IOB becomes available.
+       */
+
+      iob_notifier_signal();
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: iob_free_pool
+ *
+ * Description:
+ *   Return one I/O buffer to the global free list, or hand it to a waiting
+ *   allocation through the committed list.
+ *
+ ****************************************************************************/
+
+static void iob_free_pool(FAR struct iob_s *iob)
+{
+  FAR sem_t *sem;
+  irqstate_t flags;
+#ifdef CONFIG_IOB_NOTIFIER
+  int16_t before;
+#endif
+
+  /* Free the I/O buffer by adding it to the head of the free or the
+   * committed list. We don't know what context we are called from so
+   * we use extreme measures to protect the free list:  We disable
+   * interrupts very briefly.
+   */
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+#ifdef CONFIG_IOB_NOTIFIER
+  before = iob_navail(false);
+#endif
+  sem = iob_free_locked(iob);
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  if (sem != NULL)
+    {
+      nxsem_post(sem);
+    }
+
+#ifdef CONFIG_IOB_NOTIFIER
+  iob_free_notify(before);
+#endif
+}
+
+#if CONFIG_IOB_PCPU_CACHE > 0
+/****************************************************************************
+ * Name: iob_pcpu_bypass
+ *
+ * Description:
+ *   Return true if freed I/O buffers must go to the global free list
+ *   directly:  Either a task is waiting for a buffer or the global free
+ *   list is exhausted and iob_navail() would not see the buffer.
+ *
+ ****************************************************************************/
+
+static bool iob_pcpu_bypass(void)
+{
+#if CONFIG_IOB_THROTTLE > 0
+  if (g_throttle_count <= 0)
+    {
+      return true;
+    }
+#endif
+
+  return g_iob_count <= 0;
+}
+
+/****************************************************************************
+ * Name: iob_pcpu_free
+ *
+ * Description:
+ *   Try to put a freed I/O buffer into the cache of the current CPU.  When
+ *   the cache is full, a batch of cached buffers is moved back to the global
+ *   free list.  When the cache must be bypassed, the whole cache is flushed
+ *   so that no buffer is withheld from a waiter.
+ *
+ * Returned Value:
+ *   True if the I/O buffer was cached; false if the caller must return it
+ *   to the global free list.
+ *
+ ****************************************************************************/
+
+static bool iob_pcpu_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_pcpu_s *cache;
+  FAR struct iob_s *flush = NULL;
+  FAR struct iob_s *tmp;
+  irqstate_t flags;
+  bool cached = true;
+  int nflush = 0;
+
+  /* Disabling local interrupts keeps us on this CPU, the lock is only
+   * contended by iob_pcpu_drain().
+   */
+
+  flags = up_irq_save();
+  cache = &g_iob_pcpu[this_cpu()];
+  spin_lock(&cache->ic_lock);
+
+  if (iob_pcpu_bypass())
+    {
+      nflush = cache->ic_count;
+      cached = false;
+    }
+  else if (cache->ic_count >= CONFIG_IOB_PCPU_CACHE)
+    {
+      nflush = CONFIG_IOB_PCPU_BATCH;
+    }
+
+  for (; nflush > 0; nflush--)
+    {
+      tmp            = cache->ic_head;
+      cache->ic_head = tmp->io_flink;
+      tmp->io_flink  = flush;
+      flush          = tmp;
+      cache->ic_count--;
+    }
+
+  if (cached)
+    {
+      iob->io_flink  = cache->ic_head;
+      cache->ic_head = iob;
+      cache->ic_count++;
+    }
+
+  spin_unlock(&cache->ic_lock);
+  up_irq_restore(flags);
+
+  /* Return the flushed buffers to the global free list */
+
+  while (flush != NULL)
+    {
+      tmp = flush->io_flink;
+      iob_free_pool(flush);
+      flush = tmp;
+    }
+
+  return cached;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#if CONFIG_IOB_PCPU_CACHE > 0
+/****************************************************************************
+ * Name: iob_pcpu_drain
+ *
+ * Description:
+ *   Return the I/O buffers held in the caches of all CPUs to the global
+ *   free list.
+ *
+ ****************************************************************************/
+
+int iob_pcpu_drain(void)
+{
+  FAR struct iob_pcpu_s *cache;
+  FAR struct iob_s *flush;
+  FAR struct iob_s *tmp;
+  irqstate_t flags;
+  int ndrained = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &g_iob_pcpu[cpu];
+      if (cache->ic_head == NULL)
+        {
+          continue;
+        }
+
+      flags = spin_lock_irqsave(&cache->ic_lock);
+      flush           = cache->ic_head;
+      ndrained       += cache->ic_count;
+      cache->ic_head  = NULL;
+      cache->ic_count = 0;
+      spin_unlock_irqrestore(&cache->ic_lock, flags);
+
+      while (flush != NULL)
+        {
+          tmp = flush->io_flink;
+          iob_free_pool(flush);
+          flush = tmp;
+        }
+    }
+
+  return ndrained;
+}
+#endif
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -79,10 +372,6 @@
 FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 {
   FAR struct iob_s *next = iob->io_flink;
-  irqstate_t flags;
-#ifdef CONFIG_IOB_NOTIFIER
-  int16_t navail;
-#endif
 
   iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
           iob, iob->io_pktlen, iob->io_len, next);
@@ -126,91 +415,115 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
     }
 #endif
 
-  /* Free the I/O buffer by adding it to the head of the free or the
-   * committed list. We don't know what context we are called from so
-   * we use extreme measures to protect the free list:  We disable
-   * interrupts very briefly.
+#if CONFIG_IOB_PCPU_CACHE > 0
+  /* Return the I/O buffer to the cache of this CPU if possible, any
+   * buffers that overflow the cache go back to the global free list.
    */
 
-  flags = spin_lock_irqsave(&g_iob_lock);
+  if (iob_pcpu_free(iob))
+    {
+      return next;
+    }
+#endif
 
-  /* Which list?  If there is a task waiting for an IOB, then put
-   * the IOB on either the free list or on the committed list where
-   * it is reserved for that allocation (and not available to
-   * iob_tryalloc()). This is true for both throttled and non-throttled
-   * cases.
-   */
+  iob_free_pool(iob);
 
+  /* And return the I/O buffer after the one that was freed */
+
+  return next;
+}
+
+/****************************************************************************
+ * Name: iob_free_chain_batch
+ *
+ * Description:
+ *   Free an entire buffer chain, returning all of the I/O buffers to the
+ *   free list in a single critical section.
+ *
+ ****************************************************************************/
+
+void iob_free_chain_batch(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next;
+  FAR sem_t *sem;
+  irqstate_t flags;
+  int niobsem = 0;
 #if CONFIG_IOB_THROTTLE > 0
-  if ((g_iob_count < 0) ||
-      ((g_iob_count >= CONFIG_IOB_THROTTLE) &&
-       (g_throttle_count < 0)))
-#else
-  if (g_iob_count < 0)
+  int nthrottlesem = 0;
+#endif
+#ifdef CONFIG_IOB_NOTIFIER
+  int16_t before;
 #endif
-    {
-      FAR sem_t *sem;
 
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
+  iobinfo("iob=%p\n", iob);
 
-#if CONFIG_IOB_THROTTLE > 0
-      if (g_iob_count < 0)
+#ifdef CONFIG_IOB_ALLOC
+  /* Buffers with a custom free callback cannot be released in the
+   * critical section, free them first.
+   */
+
+  while (iob != NULL && iob->io_free != NULL)
+    {
+      iob = iob_free(iob);
+    }
+
+  for (next = iob; next != NULL && next->io_flink != NULL; )
+    {
+      if (next->io_flink->io_free != NULL)
         {
-          g_iob_count++;
-          sem = &g_iob_sem;
+          next->io_flink = iob_free(next->io_flink);
         }
       else
         {
-          g_throttle_count++;
-          sem = &g_throttle_sem;
+          next = next->io_flink;
         }
-#else
-      g_iob_count++;
-      sem = &g_iob_sem;
+    }
 #endif
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-      nxsem_post(sem);
+
+  if (iob == NULL)
+    {
+      return;
     }
-  else
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+#ifdef CONFIG_IOB_NOTIFIER
+  before = iob_navail(false);
+#endif
+
+  for (; iob != NULL; iob = next)
     {
-      g_iob_count++;
+      next = iob->io_flink;
+      sem  = iob_free_locked(iob);
+      if (sem == &g_iob_sem)
+        {
+          niobsem++;
+        }
 #if CONFIG_IOB_THROTTLE > 0
-      if (g_iob_count > CONFIG_IOB_THROTTLE)
+      else if (sem == &g_throttle_sem)
         {
-          g_throttle_count++;
+          nthrottlesem++;
         }
 #endif
-
-      iob->io_flink   = g_iob_freelist;
-      g_iob_freelist  = iob;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
     }
 
-  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
-
-#if CONFIG_IOB_THROTTLE > 0
-  DEBUGASSERT(g_throttle_count <=
-              (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
-#endif
+  spin_unlock_irqrestore(&g_iob_lock, flags);
 
-#ifdef CONFIG_IOB_NOTIFIER
-  /* Check if the IOB was claimed by a thread that is blocked waiting
-   * for an IOB.
-   */
+  /* Wake up the tasks that received a committed buffer */
 
-  navail = iob_navail(false);
-  if (navail > 0 && (navail & IOB_MASK) == 0)
+  for (; niobsem > 0; niobsem--)
     {
-      /* Signal any threads that have requested a signal notification
-       * when an IOB becomes available.
-       */
+      nxsem_post(&g_iob_sem);
+    }
 
-      iob_notifier_signal();
+#if CONFIG_IOB_THROTTLE > 0
+  for (; nthrottlesem > 0; nthrottlesem--)
+    {
+      nxsem_post(&g_throttle_sem);
     }
 #endif
 
-  /* And return the I/O buffer after the one that was freed */
-
-  return next;
+#ifdef CONFIG_IOB_NOTIFIER
+  iob_free_notify(before);
+#endif
 }
@@ -50,6 +50,8 @@ void iob_free_queue(FAR struct iob_queue_s *qhead)
 {
   FAR struct iob_qentry_s *iobq;
   FAR struct iob_qentry_s *nextq;
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
   FAR struct iob_s *iob;
 
   /* Detach the list from the queue head so first for safety (should be safe
@@ -76,10 +78,23 @@ void iob_free_queue(FAR struct iob_queue_s *qhead)
       iob_free_qentry(iobq);
       iobq = nextq;
 
-      /* Free the I/O chain */
+      /* Append the I/O chain to the list of buffers to free */
 
-      iob_free_chain(iob);
+      if (tail == NULL)
+        {
+          head = iob;
+        }
+      else
+        {
+          tail->io_flink = iob;
+        }
+
+      for (tail = iob; tail->io_flink != NULL; tail = tail->io_flink);
     }
+
+  /* Free all of the I/O chains at once */
+
+  iob_free_chain_batch(head);
 }
 
 #endif /* CONFIG_IOB_NCHAINS > 0 */
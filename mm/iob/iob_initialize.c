@@ -97,6 +97,10 @@ sem_t g_iob_sem = SEM_INITIALIZER(0);
 
 volatile int16_t g_iob_count = CONFIG_IOB_NBUFFERS;
 
+/* The low-water mark of g_iob_count */
+
+int16_t g_iob_minfree = CONFIG_IOB_NBUFFERS;
+
 #if CONFIG_IOB_THROTTLE > 0
 
 sem_t g_throttle_sem = SEM_INITIALIZER(0);
@@ -117,6 +121,12 @@ volatile int16_t g_qentry_count = CONFIG_IOB_NCHAINS;
 
 volatile spinlock_t g_iob_lock = SP_UNLOCKED;
 
+#if CONFIG_IOB_PCPU_CACHE > 0
+/* Per-CPU I/O buffer caches */
+
+struct iob_pcpu_s g_iob_pcpu[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <nuttx/mm/iob.h>
+#include <nuttx/spinlock.h>
 
 #include "iob.h"
 
@@ -54,6 +55,10 @@
 
 void iob_getstats(FAR struct iob_stats_s *stats)
 {
+#if CONFIG_IOB_PCPU_CACHE > 0
+  int cpu;
+#endif
+
   stats->ntotal = CONFIG_IOB_NBUFFERS;
 
   stats->nfree = g_iob_count;
@@ -67,6 +72,10 @@ void iob_getstats(FAR struct iob_stats_s *stats)
       stats->nwait = 0;
     }
 
+  /* Buffers held in the per-CPU caches count as used */
+
+  stats->npeak = CONFIG_IOB_NBUFFERS - g_iob_minfree;
+
 #if CONFIG_IOB_THROTTLE > 0
   stats->nthrottle = g_throttle_count;
   if (stats->nthrottle < 0)
@@ -78,6 +87,39 @@ void iob_getstats(FAR struct iob_stats_s *stats)
     {
       stats->nthrottle = 0;
     }
+
+#if CONFIG_IOB_PCPU_CACHE > 0
+  /* Sum up the per-CPU caches.  The values are sampled without locking. */
+
+  stats->ncached = 0;
+  stats->nhits   = 0;
+  stats->nmisses = 0;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      stats->ncached += g_iob_pcpu[cpu].ic_count;
+      stats->nhits   += g_iob_pcpu[cpu].ic_hits;
+      stats->nmisses += g_iob_pcpu[cpu].ic_misses;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: iob_resetstats
+ *
+ * Description:
+ *   Restart the high-water mark of the IOB usage statistics at the current
+ *   usage.
+ *
+ ****************************************************************************/
+
+void iob_resetstats(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+  g_iob_minfree = g_iob_count < 0 ? 0 : g_iob_count;
+  spin_unlock_irqrestore(&g_iob_lock, flags);
 }
 
 #endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
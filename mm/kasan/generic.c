@@ -29,7 +29,10 @@
 #include <nuttx/compiler.h>
 #include <nuttx/spinlock.h>
 
+#include <sys/param.h>
+
 #include <assert.h>
+#include <errno.h>
 #include <stdint.h>
 
 /****************************************************************************
@@ -59,6 +62,7 @@ struct kasan_region_s
 {
   uintptr_t begin;
   uintptr_t end;
+  bool      enabled;
   uintptr_t shadow[1];
 };
 
@@ -68,6 +72,11 @@ struct kasan_region_s
 
 static FAR struct kasan_region_s *g_region[CONFIG_MM_KASAN_REGIONS];
 static size_t g_region_count;
+
+/* The span of all regions, for a fast exit on other addresses */
+
+static uintptr_t g_region_begin = UINTPTR_MAX;
+static uintptr_t g_region_end;
 static spinlock_t g_lock;
 
 /****************************************************************************
@@ -75,16 +84,26 @@ static spinlock_t g_lock;
  ****************************************************************************/
 
 static inline_function FAR uintptr_t *
-kasan_mem_to_shadow(FAR const void *ptr, size_t size,
+kasan_mem_to_shadow(FAR const void *ptr, size_t size, bool check,
                     FAR unsigned int *bit)
 {
   uintptr_t addr = (uintptr_t)ptr;
   size_t i;
 
+  if (addr < g_region_begin || addr >= g_region_end)
+    {
+      return NULL;
+    }
+
   for (i = 0; i < g_region_count; i++)
     {
       if (addr >= g_region[i]->begin && addr < g_region[i]->end)
         {
+          if (check && !g_region[i]->enabled)
+            {
+              return NULL;
+            }
+
           DEBUGASSERT(addr + size <= g_region[i]->end);
           addr -= g_region[i]->begin;
           addr /= KASAN_SHADOW_SCALE;
@@ -104,7 +123,7 @@ kasan_is_poisoned(FAR const void *addr, size_t size)
   unsigned int nbit;
   uintptr_t mask;
 
-  p = kasan_mem_to_shadow(addr, size, &bit);
+  p = kasan_mem_to_shadow(addr, size, true, &bit);
   if (p == NULL)
     {
       return kasan_global_is_poisoned(addr, size);
@@ -155,7 +174,7 @@ static void kasan_set_poison(FAR const void *addr, size_t size,
   unsigned int nbit;
   uintptr_t mask;
 
-  p = kasan_mem_to_shadow(addr, size, &bit);
+  p = kasan_mem_to_shadow(addr, size, false, &bit);
   if (p == NULL)
     {
       return;
@@ -200,6 +219,22 @@ static void kasan_set_poison(FAR const void *addr, size_t size,
   spin_unlock_irqrestore(&g_lock, flags);
 }
 
+static void kasan_update_span(void)
+{
+  uintptr_t begin = UINTPTR_MAX;
+  uintptr_t end = 0;
+  size_t i;
+
+  for (i = 0; i < g_region_count; i++)
+    {
+      begin = MIN(begin, g_region[i]->begin);
+      end   = MAX(end, g_region[i]->end);
+    }
+
+  g_region_begin = begin;
+  g_region_end   = end;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -228,13 +263,15 @@ void kasan_register(FAR void *addr, FAR size_t *size)
   region = (FAR struct kasan_region_s *)
     ((FAR char *)addr + *size - KASAN_REGION_SIZE(*size));
 
-  region->begin = (uintptr_t)addr;
-  region->end   = region->begin + *size;
+  region->begin   = (uintptr_t)addr;
+  region->end     = region->begin + *size;
+  region->enabled = true;
 
   flags = spin_lock_irqsave(&g_lock);
 
   DEBUGASSERT(g_region_count <= CONFIG_MM_KASAN_REGIONS);
   g_region[g_region_count++] = region;
+  kasan_update_span();
 
   spin_unlock_irqrestore(&g_lock, flags);
 
@@ -256,9 +293,31 @@ void kasan_unregister(FAR void *addr)
           g_region_count--;
           memmove(&g_region[i], &g_region[i + 1],
                   (g_region_count - i) * sizeof(g_region[0]));
+          kasan_update_span();
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_lock, flags);
+}
+
+int kasan_region_enable(FAR const void *addr, bool enable)
+{
+  irqstate_t flags;
+  int ret = -ENOENT;
+  size_t i;
+
+  flags = spin_lock_irqsave(&g_lock);
+  for (i = 0; i < g_region_count; i++)
+    {
+      if (g_region[i]->begin == (uintptr_t)addr)
+        {
+          g_region[i]->enabled = enable;
+          ret = 0;
           break;
         }
     }
 
   spin_unlock_irqrestore(&g_lock, flags);
+  return ret;
 }
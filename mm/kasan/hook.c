@@ -94,6 +94,12 @@
 #  define MM_KASAN_WATCHPOINT 0
 #endif
 
+#ifdef CONFIG_MM_KASAN_SAMPLE_SHIFT
+#  define MM_KASAN_SAMPLE_MASK ((1u << CONFIG_MM_KASAN_SAMPLE_SHIFT) - 1)
+#else
+#  define MM_KASAN_SAMPLE_MASK 0
+#endif
+
 #define KASAN_INIT_VALUE 0xcafe
 
 /****************************************************************************
@@ -119,6 +125,10 @@ static struct kasan_watchpoint_s g_watchpoint[MM_KASAN_WATCHPOINT];
 static uint32_t g_region_init;
 #endif
 
+#if MM_KASAN_SAMPLE_MASK > 0
+static unsigned int g_sample;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -223,6 +233,17 @@ static void kasan_check_watchpoint(FAR const void *addr, size_t size,
 }
 #endif
 
+static inline_function bool kasan_sample(void)
+{
+#if MM_KASAN_SAMPLE_MASK > 0
+  /* Only one of 2^n accesses is checked, races on the counter are fine */
+
+  return (++g_sample & MM_KASAN_SAMPLE_MASK) == 0;
+#else
+  return true;
+#endif
+}
+
 static inline void kasan_check_report(FAR const void *addr, size_t size,
                                       bool is_write,
                                       FAR void *return_address)
@@ -241,7 +262,7 @@ static inline void kasan_check_report(FAR const void *addr, size_t size,
 #  endif
 
 #  ifndef CONFIG_MM_KASAN_NONE
-  if (predict_false(kasan_is_poisoned(addr, size)))
+  if (kasan_sample() && predict_false(kasan_is_poisoned(addr, size)))
     {
       kasan_report(addr, size, is_write, return_address);
     }
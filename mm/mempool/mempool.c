@@ -229,6 +229,169 @@ mempool_memdump_free_callback(FAR struct mempool_s *pool,
 }
 #endif
 
+static inline FAR void *mempool_prepare_block(FAR struct mempool_s *pool,
+                                              FAR void *blk)
+{
+  blk = kasan_unpoison(blk, pool->blocksize);
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(blk, MM_ALLOC_MAGIC, pool->blocksize);
+#endif
+
+#if CONFIG_MM_BACKTRACE >= 0
+  mempool_add_backtrace(pool, (FAR struct mempool_backtrace_s *)
+                              ((FAR char *)blk + pool->blocksize));
+#endif
+  return blk;
+}
+
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+static inline bool mempool_cacheable(FAR struct mempool_s *pool,
+                                     FAR void *blk)
+{
+  /* Blocked waiters are only woken by the slow path and the interrupt
+   * reserve must go back to its own queue.
+   */
+
+  if (pool->wait && pool->expandsize == 0)
+    {
+      return false;
+    }
+
+  return pool->ibase == NULL || (FAR char *)blk < pool->ibase ||
+         (FAR char *)blk >= pool->ibase + pool->interruptsize;
+}
+
+static FAR void *mempool_cache_allocate(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_cache_s *cache;
+  FAR sq_entry_t *blk;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  cache = &pool->cache[this_cpu()];
+  spin_lock(&cache->lock);
+  blk   = cache->head;
+  if (blk != NULL)
+    {
+      cache->head = blk->flink;
+      cache->count--;
+      blk->flink  = NULL;
+    }
+
+  spin_unlock(&cache->lock);
+  up_irq_restore(flags);
+  return blk;
+}
+
+static bool mempool_cache_release(FAR struct mempool_s *pool,
+                                  FAR void *blk)
+{
+  FAR struct mempool_cache_s *cache;
+  irqstate_t flags;
+  bool ret = false;
+
+  if (!mempool_cacheable(pool, blk))
+    {
+      return false;
+    }
+
+  flags = up_irq_save();
+  cache = &pool->cache[this_cpu()];
+  spin_lock(&cache->lock);
+  if (cache->count < CONFIG_MM_MEMPOOL_CACHE_SIZE)
+    {
+#  if CONFIG_MM_BACKTRACE >= 0
+      FAR struct mempool_backtrace_s *buf =
+        (FAR struct mempool_backtrace_s *)((FAR char *)blk +
+                                           pool->blocksize);
+
+      /* Check double free or out of out of bounds */
+
+      DEBUGASSERT(buf->magic == MEMPOOL_MAGIC_ALLOC);
+      buf->magic = MEMPOOL_MAGIC_FREE;
+#  endif
+
+#  ifdef CONFIG_MM_FILL_ALLOCATIONS
+      memset(blk, MM_FREE_MAGIC, pool->blocksize);
+#  endif
+
+      ((FAR sq_entry_t *)blk)->flink = cache->head;
+      cache->head = blk;
+      cache->count++;
+      kasan_poison(blk, pool->blocksize);
+      ret = true;
+    }
+
+  spin_unlock(&cache->lock);
+  up_irq_restore(flags);
+  return ret;
+}
+
+/* The number of blocks held by the per-CPU caches.  Cached blocks are
+ * free, but are still accounted in nalloc.
+ */
+
+static size_t mempool_cache_count(FAR struct mempool_s *pool)
+{
+  size_t count = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      count += pool->cache[cpu].count;
+    }
+
+  return count;
+}
+
+/* Return the blocks cached by all CPUs to the free queue, so that blocks
+ * freed on another CPU are not stranded when the queue runs empty.  The
+ * caller must hold pool->lock.  Returns true if any block was reclaimed.
+ */
+
+static bool mempool_cache_reclaim(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_cache_s *cache;
+  FAR sq_entry_t *blk;
+  bool ret = false;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &pool->cache[cpu];
+      spin_lock(&cache->lock);
+      while ((blk = cache->head) != NULL)
+        {
+          cache->head = blk->flink;
+          sq_addlast(blk, &pool->queue);
+          pool->nalloc--;
+          ret = true;
+        }
+
+      cache->count = 0;
+      spin_unlock(&cache->lock);
+    }
+
+  return ret;
+}
+
+/* Return the cached blocks to the free queue.  Only used when the pool
+ * is no longer in use.
+ */
+
+static void mempool_cache_flush(FAR struct mempool_s *pool)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&pool->lock);
+  mempool_cache_reclaim(pool);
+  spin_unlock_irqrestore(&pool->lock, flags);
+}
+#else
+#  define mempool_cache_count(pool) 0
+#  define mempool_cache_reclaim(pool) false
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -258,6 +421,9 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
   sq_init(&pool->iqueue);
   sq_init(&pool->equeue);
   pool->nalloc = 0;
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+  memset(pool->cache, 0, sizeof(pool->cache));
+#endif
   if (pool->interruptsize >= blocksize)
     {
       size_t ninterrupt = pool->interruptsize / blocksize;
@@ -342,9 +508,22 @@ FAR void *mempool_allocate(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   irqstate_t flags;
 
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+  blk = mempool_cache_allocate(pool);
+  if (blk != NULL)
+    {
+      return mempool_prepare_block(pool, blk);
+    }
+#endif
+
 retry:
   flags = spin_lock_irqsave(&pool->lock);
   blk = mempool_remove_queue(pool, &pool->queue);
+  if (blk == NULL && mempool_cache_reclaim(pool))
+    {
+      blk = mempool_remove_queue(pool, &pool->queue);
+    }
+
   if (blk == NULL)
     {
       if (up_interrupt_context())
@@ -395,16 +574,7 @@ retry:
 
   pool->nalloc++;
   spin_unlock_irqrestore(&pool->lock, flags);
-  blk = kasan_unpoison(blk, pool->blocksize);
-#ifdef CONFIG_MM_FILL_ALLOCATIONS
-  memset(blk, MM_ALLOC_MAGIC, pool->blocksize);
-#endif
-
-#if CONFIG_MM_BACKTRACE >= 0
-  mempool_add_backtrace(pool, (FAR struct mempool_backtrace_s *)
-                              ((FAR char *)blk + pool->blocksize));
-#endif
-  return blk;
+  return mempool_prepare_block(pool, blk);
 }
 
 /****************************************************************************
@@ -420,12 +590,23 @@ retry:
 
 void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 {
-  irqstate_t flags = spin_lock_irqsave(&pool->lock);
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  irqstate_t flags;
 #if CONFIG_MM_BACKTRACE >= 0
   FAR struct mempool_backtrace_s *buf =
     (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
+#endif
+
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+  if (mempool_cache_release(pool, blk))
+    {
+      return;
+    }
+#endif
+
+  flags = spin_lock_irqsave(&pool->lock);
 
+#if CONFIG_MM_BACKTRACE >= 0
   /* Check double free or out of out of bounds */
 
   DEBUGASSERT(buf->magic == MEMPOOL_MAGIC_ALLOC);
@@ -487,14 +668,16 @@ void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  size_t ncached;
   irqstate_t flags;
 
   DEBUGASSERT(pool != NULL && info != NULL);
 
   flags = spin_lock_irqsave(&pool->lock);
-  info->ordblks = sq_count(&pool->queue);
+  ncached = mempool_cache_count(pool);
+  info->ordblks = sq_count(&pool->queue) + ncached;
   info->iordblks = sq_count(&pool->iqueue);
-  info->aordblks = pool->nalloc;
+  info->aordblks = pool->nalloc - ncached;
   info->arena = sq_count(&pool->equeue) * sizeof(sq_entry_t) +
     (info->aordblks + info->ordblks + info->iordblks) * blocksize;
   spin_unlock_irqrestore(&pool->lock, flags);
@@ -532,7 +715,8 @@ mempool_info_task(FAR struct mempool_s *pool,
     {
       irqstate_t flags = spin_lock_irqsave(&pool->lock);
       size_t count = sq_count(&pool->queue) +
-                     sq_count(&pool->iqueue);
+                     sq_count(&pool->iqueue) +
+                     mempool_cache_count(pool);
 
       spin_unlock_irqrestore(&pool->lock, flags);
       info.aordblks += count;
@@ -540,8 +724,10 @@ mempool_info_task(FAR struct mempool_s *pool,
     }
   else if (task->pid == PID_MM_ALLOC)
     {
-      info.aordblks += pool->nalloc;
-      info.uordblks += pool->nalloc * blocksize;
+      size_t count = pool->nalloc - mempool_cache_count(pool);
+
+      info.aordblks += count;
+      info.uordblks += count * blocksize;
     }
 #if CONFIG_MM_BACKTRACE >= 0
   else
@@ -610,6 +796,10 @@ int mempool_deinit(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   size_t count = 0;
 
+#if CONFIG_MM_MEMPOOL_CACHE_SIZE > 0
+  mempool_cache_flush(pool);
+#endif
+
   if (pool->nalloc != 0)
     {
       return -EBUSY;
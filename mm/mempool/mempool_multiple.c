@@ -29,12 +29,22 @@
 #include <syslog.h>
 #include <sys/param.h>
 
+#include <nuttx/atomic.h>
 #include <nuttx/mutex.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/mempool.h>
 #include <nuttx/mm/kasan.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+#  define mempool_multiple_record(mpool, size)
+#  define mempool_multiple_fallback(mpool)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -93,12 +103,47 @@ struct mempool_multiple_s
   size_t                        dict_col_num_log2;
   size_t                        dict_row_num;
   FAR struct mpool_dict_s     **dict;
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+  /* The sizes of all requests made to this multiple mempool */
+
+  struct mempool_histogram_s    histogram;
+#endif
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+static inline void
+mempool_multiple_record(FAR struct mempool_multiple_s *mpool, size_t size)
+{
+  size_t index = size > 0 ? (size - 1) / MEMPOOL_ALIGN : 0;
+
+  if (mpool == NULL)
+    {
+      return;
+    }
+
+  if (index >= MEMPOOL_HISTOGRAM_NBUCKETS)
+    {
+      index = MEMPOOL_HISTOGRAM_NBUCKETS - 1;
+    }
+
+  atomic_fetch_add((FAR atomic_uint *)&mpool->histogram.count[index], 1);
+}
+
+static inline void
+mempool_multiple_fallback(FAR struct mempool_multiple_s *mpool)
+{
+  if (mpool != NULL)
+    {
+      atomic_fetch_add((FAR atomic_uint *)&mpool->histogram.fallback, 1);
+    }
+}
+#endif
+
 static inline FAR struct mempool_s *
 mempool_multiple_find(FAR struct mempool_multiple_s *mpool, size_t size)
 {
@@ -502,6 +547,14 @@ mempool_multiple_init(FAR const char *name,
          mpool->dict_row_num * sizeof(FAR struct mpool_dict_s *));
   nxrmutex_init(&mpool->lock);
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+  memset(&mpool->histogram, 0, sizeof(mpool->histogram));
+  if (name != NULL)
+    {
+      mempool_procfs_register_histogram(&mpool->histogram, name);
+    }
+#endif
+
   return mpool;
 
 err_with_pools:
@@ -538,9 +591,12 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
   FAR struct mempool_s *end;
   FAR struct mempool_s *pool;
 
+  mempool_multiple_record(mpool, size);
+
   pool = mempool_multiple_find(mpool, size);
   if (pool == NULL)
     {
+      mempool_multiple_fallback(mpool);
       return NULL;
     }
 
@@ -556,6 +612,7 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
     }
   while (++pool < end);
 
+  mempool_multiple_fallback(mpool);
   return NULL;
 }
 
@@ -870,6 +927,10 @@ void mempool_multiple_deinit(FAR struct mempool_multiple_s *mpool)
       return;
     }
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+  mempool_procfs_unregister_histogram(&mpool->histogram);
+#endif
+
   for (i = 0; i < mpool->npools; i++)
     {
       DEBUGVERIFY(mempool_deinit(mpool->pools + i));
@@ -892,3 +953,189 @@ void mempool_multiple_deinit(FAR struct mempool_multiple_s *mpool)
   nxrmutex_destroy(&mpool->lock);
   mpool->free(mpool->arg, mpool);
 }
+
+/****************************************************************************
+ * Name: mempool_multiple_profile
+ *
+ * Description:
+ *   Derive the block sizes of a multiple mempool from a recorded allocation
+ *   size histogram.  Serving the requests of sizes s[j] .. s[i] from one
+ *   pool of block size s[i] wastes
+ *
+ *     waste(j, i) = s[i] * (C[i] - C[j - 1]) - (S[i] - S[j - 1])
+ *
+ *   bytes, where C and S are the prefix sums of the request counts and of
+ *   the requested bytes.  The minimal total waste with k pools is found by
+ *   dynamic programming over the distinct sizes.
+ *
+ * Input Parameters:
+ *   profile   - The recorded histogram, sorted by increasing size.
+ *   nprofile  - The number of entries in the histogram.
+ *   threshold - The largest request size served by the pools.
+ *   poolsize  - The array that receives the derived block sizes.
+ *   npools    - The maximum number of block sizes to derive.
+ *   alloc     - The function used to allocate scratch memory.
+ *   free      - The function used to free the scratch memory.
+ *   arg       - The argument passed to alloc and free.
+ *
+ * Returned Value:
+ *   The number of block sizes stored in poolsize, zero on any failure.
+ *
+ ****************************************************************************/
+
+size_t mempool_multiple_profile(FAR const struct mempool_profile_s *profile,
+                                size_t nprofile, size_t threshold,
+                                FAR size_t *poolsize, size_t npools,
+                                mempool_multiple_alloc_t alloc,
+                                mempool_multiple_free_t free,
+                                FAR void *arg)
+{
+  FAR uint64_t *count;
+  FAR uint64_t *bytes;
+  FAR uint64_t *prev;
+  FAR uint64_t *cost;
+  FAR uint64_t *swap;
+  FAR size_t *sizes;
+  FAR size_t *split;
+  FAR void *scratch;
+  size_t stride = nprofile + 1;
+  size_t ret = 0;
+  size_t n = 0;
+  size_t i;
+  size_t j;
+  size_t k;
+
+  if (profile == NULL || nprofile == 0 || npools == 0)
+    {
+      return 0;
+    }
+
+  npools = MIN(npools, nprofile);
+
+  /* count[], bytes[] and sizes[] are indexed from 1, split[k][i] records
+   * the smallest size served by pool k when pools 0 .. k serve the sizes
+   * 1 .. i.
+   */
+
+  scratch = alloc(arg, sizeof(uint64_t),
+                  stride * (4 * sizeof(uint64_t) +
+                            (npools + 1) * sizeof(size_t)));
+  if (scratch == NULL)
+    {
+      return 0;
+    }
+
+  count = scratch;
+  bytes = count + stride;
+  prev  = bytes + stride;
+  cost  = prev + stride;
+  sizes = (FAR size_t *)(cost + stride);
+  split = sizes + stride;
+
+  /* Merge the entries that round up to the same size */
+
+  count[0] = 0;
+  bytes[0] = 0;
+
+  for (i = 0; i < nprofile; i++)
+    {
+      size_t size = ALIGN_UP(profile[i].size, MEMPOOL_ALIGN);
+
+      if (size == 0 || profile[i].count == 0)
+        {
+          continue;
+        }
+
+      if (size > threshold)
+        {
+          break;
+        }
+
+      if (n > 0 && size < sizes[n])
+        {
+          goto out;
+        }
+
+      if (n == 0 || size != sizes[n])
+        {
+          n++;
+          sizes[n] = size;
+          count[n] = count[n - 1];
+          bytes[n] = bytes[n - 1];
+        }
+
+      count[n] += profile[i].count;
+      bytes[n] += (uint64_t)profile[i].count * profile[i].size;
+    }
+
+  if (n == 0)
+    {
+      goto out;
+    }
+
+  /* Every size gets its own pool if there are enough pools */
+
+  if (n <= npools)
+    {
+      for (i = 1; i <= n; i++)
+        {
+          poolsize[i - 1] = sizes[i];
+        }
+
+      ret = n;
+      goto out;
+    }
+
+  /* A single pool serves the sizes 1 .. i */
+
+  for (i = 1; i <= n; i++)
+    {
+      prev[i] = sizes[i] * count[i] - bytes[i];
+    }
+
+  /* Add pool k serving the sizes j .. i to the best k pools for the sizes
+   * 1 .. j - 1.
+   */
+
+  for (k = 1; k < npools; k++)
+    {
+      for (i = k + 1; i <= n; i++)
+        {
+          cost[i] = UINT64_MAX;
+          for (j = k + 1; j <= i; j++)
+            {
+              uint64_t waste = prev[j - 1] +
+                               sizes[i] * (count[i] - count[j - 1]) -
+                               (bytes[i] - bytes[j - 1]);
+
+              if (waste < cost[i])
+                {
+                  cost[i] = waste;
+                  split[k * stride + i] = j;
+                }
+            }
+        }
+
+      swap = prev;
+      prev = cost;
+      cost = swap;
+    }
+
+  /* Walk back from the largest size, the largest pool must serve it */
+
+  i = n;
+  for (k = npools; k-- > 0; )
+    {
+      poolsize[k] = sizes[i];
+      if (k > 0)
+        {
+          i = split[k * stride + i] - 1;
+        }
+    }
+
+  ret = npools;
+
+out:
+  free(arg, scratch);
+  return ret;
+}
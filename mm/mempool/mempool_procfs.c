@@ -91,6 +91,10 @@ const struct procfs_operations g_mempool_operations =
 
 static FAR struct mempool_procfs_entry_s *g_mempool_procfs = NULL;
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+static FAR struct mempool_histogram_s *g_mempool_histogram = NULL;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -125,6 +129,61 @@ static int mempool_close(FAR struct file *filep)
   return 0;
 }
 
+/****************************************************************************
+ * Name: mempool_histogram_line
+ *
+ * Description:
+ *   Format line 'index' of a histogram: the header, one line for each
+ *   non-empty bucket and the number of requests not served by any pool.
+ *   The sizes are printed as the upper bound of each bucket, which is the
+ *   format expected by board_mempool_profile().
+ *
+ * Returned Value:
+ *   The length of the line, zero if the line is empty.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+static size_t
+mempool_histogram_line(FAR struct mempool_file_s *procfile,
+                       FAR const struct mempool_histogram_s *hist,
+                       size_t index)
+{
+  unsigned int count;
+
+  if (index == 0)
+    {
+      return procfs_snprintf(procfile->line, MEMPOOLINFO_LINELEN,
+                             "%12s:%11s%11s\n", hist->name, "size",
+                             "count");
+    }
+  else if (index < MEMPOOL_HISTOGRAM_NBUCKETS)
+    {
+      count = hist->count[index - 1];
+      if (count == 0)
+        {
+          return 0;
+        }
+
+      return procfs_snprintf(procfile->line, MEMPOOLINFO_LINELEN,
+                             "%13s%11zu%11u\n", "",
+                             index * MEMPOOL_ALIGN, count);
+    }
+  else if (index == MEMPOOL_HISTOGRAM_NBUCKETS)
+    {
+      return procfs_snprintf(procfile->line, MEMPOOLINFO_LINELEN,
+                             "%13s%11s%11u\n", "", "larger",
+                             hist->count[MEMPOOL_HISTOGRAM_NBUCKETS - 1]);
+    }
+  else
+    {
+      return procfs_snprintf(procfile->line, MEMPOOLINFO_LINELEN,
+                             "%13s%11s%11u\n", "", "fallback",
+                             hist->fallback);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: mempool_read
  ****************************************************************************/
@@ -133,6 +192,10 @@ static ssize_t mempool_read(FAR struct file *filep, FAR char *buffer,
                             size_t buflen)
 {
   FAR const struct mempool_procfs_entry_s *entry;
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+  FAR const struct mempool_histogram_s *hist;
+  size_t i;
+#endif
   FAR struct mempool_file_s *procfile;
   size_t linesize;
   size_t copysize;
@@ -174,6 +237,30 @@ static ssize_t mempool_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+  /* Then the allocation size histogram of each multiple mempool */
+
+  for (hist = g_mempool_histogram; hist != NULL; hist = hist->next)
+    {
+      for (i = 0; i <= MEMPOOL_HISTOGRAM_NBUCKETS + 1 && totalsize < buflen;
+           i++)
+        {
+          linesize = mempool_histogram_line(procfile, hist, i);
+          if (linesize == 0)
+            {
+              continue;
+            }
+
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+    }
+#endif
+
   filep->f_pos += totalsize;
   return totalsize;
 }
@@ -264,3 +351,51 @@ void mempool_procfs_unregister(FAR struct mempool_procfs_entry_s *entry)
         }
     }
 }
+
+/****************************************************************************
+ * Name: mempool_procfs_register_histogram
+ *
+ * Description:
+ *   Add an allocation size histogram to the procfs file system.
+ *
+ * Input Parameters:
+ *   hist - The histogram to be registered.
+ *   name - The name of the multiple mempool.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_HISTOGRAM
+void mempool_procfs_register_histogram(FAR struct mempool_histogram_s *hist,
+                                       FAR const char *name)
+{
+  hist->name = name;
+  hist->next = g_mempool_histogram;
+  g_mempool_histogram = hist;
+}
+
+/****************************************************************************
+ * Name: mempool_procfs_unregister_histogram
+ *
+ * Description:
+ *   Remove an allocation size histogram from the procfs file system.
+ *
+ * Input Parameters:
+ *   hist - The histogram to be unregistered.
+ *
+ ****************************************************************************/
+
+void
+mempool_procfs_unregister_histogram(FAR struct mempool_histogram_s *hist)
+{
+  FAR struct mempool_histogram_s **cur;
+
+  for (cur = &g_mempool_histogram; *cur != NULL; cur = &(*cur)->next)
+    {
+      if (*cur == hist)
+        {
+          *cur = hist->next;
+          break;
+        }
+    }
+}
+#endif
@@ -0,0 +1,272 @@
+/****************************************************************************
+ * mm/mm_gran/mm_dmaalloc.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/dmaalloc.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/lib/math32.h>
+#include <nuttx/mm/gran.h>
+
+#ifdef CONFIG_MM_DMAALLOC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if !IS_POWER_OF_2(CONFIG_MM_DMAALLOC_GRANSIZE)
+#  error CONFIG_MM_DMAALLOC_GRANSIZE must be a power of two
+#endif
+
+#define MM_DMA_LOG2GRAN  LOG2_CEIL(CONFIG_MM_DMAALLOC_GRANSIZE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This sits in the granule just below each buffer handed out from the DMA
+ * region and records how much to give back.  That granule holds no buffer
+ * data, so the node never shares a cache line with the buffer.
+ */
+
+struct mm_dmanode_s
+{
+  size_t size;  /* The size of the block, including this granule */
+};
+
+static_assert(sizeof(struct mm_dmanode_s) <= MM_DMA_GRANSIZE,
+              "Error size for struct mm_dmanode_s\n");
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The state of the DMA allocator */
+
+static GRAN_HANDLE g_dmaalloc;
+static uintptr_t g_dmastart;
+static uintptr_t g_dmaend;
+static unsigned long g_dmanfallback;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_dmainitialize
+ *
+ * Description:
+ *   Hand a reserved, physically contiguous region to the DMA allocator.
+ *
+ * Input Parameters:
+ *   heap_start - The start of the region that will hold the DMA buffers
+ *   heap_size  - The size (in bytes) of that region
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_dmainitialize(FAR void *heap_start, size_t heap_size)
+{
+  DEBUGASSERT(g_dmaalloc == NULL);
+
+  g_dmaalloc = gran_initialize(heap_start, heap_size,
+                               MM_DMA_LOG2GRAN, MM_DMA_LOG2GRAN);
+  DEBUGASSERT(g_dmaalloc != NULL);
+
+  g_dmastart = (uintptr_t)heap_start;
+  g_dmaend   = g_dmastart + heap_size;
+}
+
+/****************************************************************************
+ * Name: mm_dmamemalign
+ *
+ * Description:
+ *   Allocate a granule aligned DMA buffer, from the DMA region if possible
+ *   and from the kernel heap otherwise.
+ *
+ * Input Parameters:
+ *   alignment - The required alignment, a power of two or zero
+ *   size      - The size of the buffer
+ *
+ * Returned Value:
+ *   The buffer on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR void *mm_dmamemalign(size_t alignment, size_t size)
+{
+  FAR struct mm_dmanode_s *node;
+  uintptr_t base;
+  uintptr_t ret;
+  size_t total;
+
+  if (alignment < MM_DMA_GRANSIZE)
+    {
+      alignment = MM_DMA_GRANSIZE;
+    }
+
+  DEBUGASSERT(IS_POWER_OF_2(alignment));
+
+  size = MM_DMA_ALIGNUP(size > 0 ? size : 1);
+  if (size == 0 || size + alignment < size)
+    {
+      return NULL;
+    }
+
+  if (g_dmaalloc != NULL)
+    {
+      /* The extra alignment leaves room for the aligned buffer and the
+       * granule holding the node below it.
+       */
+
+      total = size + alignment;
+      base  = (uintptr_t)gran_alloc(g_dmaalloc, total);
+      if (base != 0)
+        {
+          ret = (base + MM_DMA_GRANSIZE + alignment - 1) &
+                ~(uintptr_t)(alignment - 1);
+
+          /* Give the unused granules before the node and after the buffer
+           * back, so only one granule is lost to the node.
+           */
+
+          if (ret - MM_DMA_GRANSIZE > base)
+            {
+              gran_free(g_dmaalloc, (FAR void *)base,
+                        ret - MM_DMA_GRANSIZE - base);
+            }
+
+          if (ret + size < base + total)
+            {
+              gran_free(g_dmaalloc, (FAR void *)(ret + size),
+                        base + total - ret - size);
+            }
+
+          node = (FAR struct mm_dmanode_s *)(ret - MM_DMA_GRANSIZE);
+          node->size = size + MM_DMA_GRANSIZE;
+          return (FAR void *)ret;
+        }
+    }
+
+  /* There is no DMA region or it is exhausted, fall back to the kernel
+   * heap with the same alignment and rounding.
+   */
+
+  atomic_fetch_add((FAR atomic_ulong *)&g_dmanfallback, 1);
+  return kmm_memalign(alignment, size);
+}
+
+/****************************************************************************
+ * Name: mm_dmazalloc
+ *
+ * Description:
+ *   Like mm_dmaalloc() but the buffer is cleared.
+ *
+ ****************************************************************************/
+
+FAR void *mm_dmazalloc(size_t size)
+{
+  FAR void *mem;
+
+  mem = mm_dmaalloc(size);
+  if (mem != NULL)
+    {
+      memset(mem, 0, size);
+    }
+
+  return mem;
+}
+
+/****************************************************************************
+ * Name: mm_dmafree
+ *
+ * Description:
+ *   Return a buffer allocated by mm_dmamemalign(), mm_dmaalloc() or
+ *   mm_dmazalloc().
+ *
+ * Input Parameters:
+ *   mem - The buffer to free, NULL is ignored
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_dmafree(FAR void *mem)
+{
+  FAR struct mm_dmanode_s *node;
+
+  if ((uintptr_t)mem > g_dmastart && (uintptr_t)mem < g_dmaend)
+    {
+      node = (FAR struct mm_dmanode_s *)((uintptr_t)mem - MM_DMA_GRANSIZE);
+      gran_free(g_dmaalloc, node, node->size);
+    }
+  else if (mem != NULL)
+    {
+      kmm_free(mem);
+    }
+}
+
+/****************************************************************************
+ * Name: mm_dmainfo
+ *
+ * Description:
+ *   Return information about the DMA allocator.
+ *
+ * Input Parameters:
+ *   info - Memory location to return the DMA allocator info.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_dmainfo(FAR struct dmainfo_s *info)
+{
+  struct graninfo_s graninfo;
+
+  DEBUGASSERT(info != NULL);
+  memset(info, 0, sizeof(*info));
+
+  if (g_dmaalloc != NULL)
+    {
+      gran_info(g_dmaalloc, &graninfo);
+
+      info->total   = (size_t)graninfo.ngranules << MM_DMA_LOG2GRAN;
+      info->free    = (size_t)graninfo.nfree << MM_DMA_LOG2GRAN;
+      info->largest = (size_t)graninfo.mxfree << MM_DMA_LOG2GRAN;
+    }
+
+  info->nfallback = atomic_load((FAR atomic_ulong *)&g_dmanfallback);
+}
+
+#endif /* CONFIG_MM_DMAALLOC */
@@ -31,9 +31,11 @@
 
 #include <nuttx/mutex.h>
 #include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/lib/math32.h>
 #include <nuttx/mm/mempool.h>
+#include <nuttx/wqueue.h>
 
 #include <assert.h>
 #include <sys/types.h>
@@ -108,6 +110,27 @@
 #  define MM_ADD_BACKTRACE(heap, ptr)
 #endif
 
+/* Charge the size of an allocated node to the thread owning it, or give
+ * it back.
+ */
+
+#ifdef CONFIG_MM_HEAP_TASKPEAK
+#  define MM_TASK_ALLOC(node) \
+     mm_taskusage((node)->pid, (ssize_t)MM_SIZEOF_NODE(node))
+#  define MM_TASK_FREE(node) \
+     mm_taskusage((node)->pid, -(ssize_t)MM_SIZEOF_NODE(node))
+#else
+#  define MM_TASK_ALLOC(node)
+#  define MM_TASK_FREE(node)
+#endif
+
+/* Only the heaps used by the OS ask the subsystems to release memory */
+
+#if defined(CONFIG_MM_RECLAIM) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_HEAP_RECLAIM
+#endif
+
 /* All other definitions derive from these two */
 
 #define MM_MIN_CHUNK     (1 << MM_MIN_SHIFT)
@@ -161,6 +184,18 @@
 #define MM_PREVNODE_IS_ALLOC(node) (((node)->size & MM_PREVFREE_BIT) == 0)
 #define MM_PREVNODE_IS_FREE(node) (((node)->size & MM_PREVFREE_BIT) != 0)
 
+/* Per-CPU small chunk cache: one bin for each chunk size from MM_MIN_CHUNK
+ * up to MM_TCACHE_MAXCHUNK in steps of MM_ALIGN.
+ */
+
+#ifdef CONFIG_MM_HEAP_TCACHE
+#  define MM_TCACHE_MAXCHUNK \
+     MM_ALIGN_UP(CONFIG_MM_HEAP_TCACHE_MAXSIZE + MM_ALLOCNODE_OVERHEAD)
+#  define MM_TCACHE_NBINS \
+     ((MM_TCACHE_MAXCHUNK - MM_MIN_CHUNK) / MM_ALIGN + 1)
+#  define MM_TCACHE_NDX(size) (((size) - MM_MIN_CHUNK) / MM_ALIGN)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -217,6 +252,21 @@ struct mm_delaynode_s
   FAR struct mm_delaynode_s *flink;
 };
 
+#ifdef CONFIG_MM_HEAP_TCACHE
+/* This describes the small chunk cache of one CPU */
+
+struct mm_tcache_s
+{
+#ifdef CONFIG_SMP
+  spinlock_t lock;                      /* Taken by a remote flush */
+#endif
+  FAR struct mm_delaynode_s *bin[MM_TCACHE_NBINS];
+  uint8_t count[MM_TCACHE_NBINS];       /* Number of chunks in each bin */
+  size_t hits;                          /* Allocations served */
+  size_t misses;                        /* Allocations not served */
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -253,12 +303,33 @@ struct mm_heap_s
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
 
-  /* Free delay list, as sometimes we can't do free immdiately. */
+  /* Free delay list, as sometimes we can't do free immdiately.  Chunks
+   * are pushed onto mm_delaylist without a lock from any CPU or context.
+   * Only the owner of mm_delaydrain takes them off: it moves the whole
+   * list to mm_delaylocal and frees them from there in batches.
+   */
+
+  FAR struct mm_delaynode_s *mm_delaylist;
+  FAR struct mm_delaynode_s *mm_delaylocal;
+  unsigned int mm_delaydrain;
+  unsigned long mm_delaycount;
+
+#ifdef CONFIG_MM_FREE_DELAYLIST_WORK
+  struct work_s mm_delaywork;
+#endif
+
+#ifdef CONFIG_MM_FREE_DELAYLIST_STATS
+  unsigned long mm_delaymaxcount;       /* Largest depth of the list */
+  unsigned long mm_delayndrain;         /* Number of drains */
+  unsigned long mm_delaynfreed;         /* Chunks freed by the drains */
+  clock_t mm_delaymaxtime;              /* Longest drain */
+  clock_t mm_delaytotaltime;            /* Time spent in all drains */
+#endif
 
-  FAR struct mm_delaynode_s *mm_delaylist[CONFIG_SMP_NCPUS];
+  /* Per-CPU cache of small free chunks */
 
-#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
-  size_t mm_delaycount[CONFIG_SMP_NCPUS];
+#ifdef CONFIG_MM_HEAP_TCACHE
+  struct mm_tcache_s mm_tcache[CONFIG_SMP_NCPUS];
 #endif
 
   /* The is a multiple mempool of the heap */
@@ -301,6 +372,26 @@ void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
 
 void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay);
 
+/* Functions contained in mm_malloc.c ***************************************/
+
+#ifdef CONFIG_MM_FREE_DELAYLIST_WORK
+void mm_delaylist_worker(FAR void *arg);
+#endif
+
+/* Functions contained in mm_taskusage.c ************************************/
+
+#ifdef CONFIG_MM_HEAP_TASKPEAK
+void mm_taskusage(pid_t pid, ssize_t delta);
+#endif
+
+/* Functions contained in mm_tcache.c ***************************************/
+
+#ifdef CONFIG_MM_HEAP_TCACHE
+FAR void *mm_tcache_alloc(FAR struct mm_heap_s *heap, size_t size);
+bool mm_tcache_free(FAR struct mm_heap_s *heap, FAR void *mem);
+bool mm_tcache_flush(FAR struct mm_heap_s *heap);
+#endif
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
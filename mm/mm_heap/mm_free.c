@@ -30,6 +30,8 @@
 #include <debug.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/init.h>
 #include <nuttx/sched.h>
 #include <nuttx/mm/mm.h>
 #include <nuttx/mm/kasan.h>
@@ -44,13 +46,13 @@
 static void add_delaylist(FAR struct mm_heap_s *heap, FAR void *mem)
 {
 #if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR atomic_ulong *list = (FAR atomic_ulong *)&heap->mm_delaylist;
   FAR struct mm_delaynode_s *tmp = mem;
-  irqstate_t flags;
+  unsigned long count;
+  unsigned long head;
 
   /* Delay the deallocation until a more appropriate time. */
 
-  flags = up_irq_save();
-
 #  ifdef CONFIG_DEBUG_ASSERTIONS
   FAR struct mm_freenode_s *node;
 
@@ -58,14 +60,40 @@ static void add_delaylist(FAR struct mm_heap_s *heap, FAR void *mem)
   DEBUGASSERT(MM_NODE_IS_ALLOC(node));
 #  endif
 
-  tmp->flink = heap->mm_delaylist[this_cpu()];
-  heap->mm_delaylist[this_cpu()] = tmp;
+  /* Push the chunk onto the list.  Any CPU and any interrupt handler may
+   * push at the same time, the compare-and-swap simply retries.
+   */
 
-#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
-  heap->mm_delaycount[this_cpu()]++;
-#endif
+  head = atomic_load(list);
+  do
+    {
+      tmp->flink = (FAR struct mm_delaynode_s *)head;
+    }
+  while (!atomic_compare_exchange_weak(list, &head, (unsigned long)tmp));
 
-  up_irq_restore(flags);
+  count = atomic_fetch_add((FAR atomic_ulong *)&heap->mm_delaycount, 1) + 1;
+  UNUSED(count);
+
+#  ifdef CONFIG_MM_FREE_DELAYLIST_STATS
+  if (count > heap->mm_delaymaxcount)
+    {
+      heap->mm_delaymaxcount = count;
+    }
+#  endif
+
+#  ifdef CONFIG_MM_FREE_DELAYLIST_WORK
+  /* Let the low priority worker drain the list once it stops being empty.
+   * The work queue can't be touched during a context switch, that case is
+   * left to the next allocation.
+   */
+
+  if (head == 0 && OSINIT_OS_READY() &&
+      work_available(&heap->mm_delaywork) &&
+      (up_interrupt_context() || _SCHED_GETTID() >= 0))
+    {
+      work_queue(LPWORK, &heap->mm_delaywork, mm_delaylist_worker, heap, 0);
+    }
+#  endif
 #endif
 }
 
@@ -130,6 +158,7 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
   node = (FAR struct mm_freenode_s *)
          ((FAR char *)kasan_reset_tag(mem) - MM_SIZEOF_ALLOCNODE);
   nodesize = MM_SIZEOF_NODE(node);
+  MM_TASK_FREE(node);
 
   /* Sanity check against double-frees */
 
@@ -245,12 +274,24 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   if (heap->mm_mpool)
     {
+#ifdef CONFIG_SCHED_INSTRUMENTATION_HEAP
+      ssize_t size = mempool_multiple_alloc_size(heap->mm_mpool, mem);
+#endif
+
       if (mempool_multiple_free(heap->mm_mpool, mem) >= 0)
         {
+          sched_note_heap(NOTE_HEAP_FREE, heap, mem, size, heap->mm_curused);
           return;
         }
     }
 #endif
 
+#ifdef CONFIG_MM_HEAP_TCACHE
+  if (mm_tcache_free(heap, mem))
+    {
+      return;
+    }
+#endif
+
   mm_delayfree(heap, mem, CONFIG_MM_FREE_DELAYCOUNT_MAX > 0);
 }
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <string.h>
 #include <assert.h>
 #include <debug.h>
@@ -69,6 +70,7 @@ static FAR void *mempool_memalign(FAR void *arg, size_t alignment,
     {
       node = (FAR struct mm_allocnode_s *)
       ((uintptr_t)ret - MM_SIZEOF_ALLOCNODE);
+      MM_TASK_FREE(node);
       node->pid = PID_MM_MEMPOOL;
     }
 
@@ -335,6 +337,31 @@ mm_initialize_pool(FAR const char *name,
 
   heap = mm_initialize(name, heap_start, heap_size);
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_PROFILE
+  /* Replace the default block sizes with the ones derived from the
+   * allocation size histogram recorded for this heap, if any.
+   */
+
+  if (init == &def)
+    {
+      FAR const struct mempool_profile_s *profile = NULL;
+      size_t nprofile;
+      size_t npools;
+
+      nprofile = board_mempool_profile(name, &profile);
+      npools   = mempool_multiple_profile(profile, nprofile, def.threshold,
+                   poolsize, MIN(CONFIG_MM_HEAP_MEMPOOL_PROFILE_NPOOLS,
+                                 MEMPOOL_NPOOLS),
+                   (mempool_multiple_alloc_t)mempool_memalign,
+                   (mempool_multiple_free_t)mm_free, heap);
+      if (npools > 0)
+        {
+          def.npools    = npools;
+          def.threshold = poolsize[npools - 1];
+        }
+    }
+#endif
+
   /* Initialize the multiple mempool in heap */
 
   if (init != NULL && init->poolsize != NULL && init->npools != 0)
@@ -371,6 +398,16 @@ void mm_uninitialize(FAR struct mm_heap_s *heap)
 {
   int i;
 
+#ifdef CONFIG_MM_FREE_DELAYLIST_WORK
+#  if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  work_cancel_sync(LPWORK, &heap->mm_delaywork);
+#  endif
+#endif
+
+#ifdef CONFIG_MM_HEAP_TCACHE
+  mm_tcache_flush(heap);
+#endif
+
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   mempool_multiple_deinit(heap->mm_mpool);
 #endif
@@ -28,6 +28,7 @@
 
 #include <assert.h>
 #include <debug.h>
+#include <string.h>
 
 #include <nuttx/mm/mm.h>
 
@@ -216,3 +217,61 @@ size_t mm_heapfree_largest(FAR struct mm_heap_s *heap)
 
   return 0;
 }
+
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+/****************************************************************************
+ * Name: mm_fraginfo
+ *
+ * Description:
+ *   Return the free memory, the largest free chunk, the fragmentation index
+ *   and the free chunk size histogram of the heap.
+ *
+ ****************************************************************************/
+
+void mm_fraginfo(FAR struct mm_heap_s *heap,
+                 FAR struct mm_fraginfo_s *info)
+{
+  FAR struct mm_freenode_s *node;
+  size_t nodesize;
+  int ndx;
+
+  memset(info, 0, sizeof(*info));
+
+  DEBUGVERIFY(mm_lock(heap));
+
+  /* The free nodes of all size classes form one list in size order */
+
+  for (node = heap->mm_nodelist[0].flink; node != NULL; node = node->flink)
+    {
+      nodesize = MM_SIZEOF_NODE(node);
+      if (nodesize == 0)
+        {
+          continue;
+        }
+
+      info->free += nodesize;
+      if (nodesize > info->largest)
+        {
+          info->largest = nodesize;
+        }
+
+      for (ndx = 0; ndx < MM_FRAG_NBUCKETS - 1; ndx++)
+        {
+          if (nodesize < ((size_t)1 << (MM_FRAG_BUCKET_SHIFT + 2 * ndx)))
+            {
+              break;
+            }
+        }
+
+      info->nfree[ndx]++;
+    }
+
+  mm_unlock(heap);
+
+  if (info->free > 0)
+    {
+      info->index = (uint64_t)(info->free - info->largest) * 100 /
+                    info->free;
+    }
+}
+#endif
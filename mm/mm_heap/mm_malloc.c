@@ -31,10 +31,14 @@
 #include <string.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
 #include <nuttx/mm/mm.h>
 #include <nuttx/mm/kasan.h>
 #include <nuttx/sched.h>
 #include <nuttx/sched_note.h>
+#include <nuttx/signal.h>
 
 #include "mm_heap/mm.h"
 
@@ -50,7 +54,13 @@
  *  added because of CONFIG_MM_FREE_DELAYCOUNT_MAX.
  *  Set force to true to free all the memory in delay list immediately, set
  *  to false will only free delaylist when time is up if
- *  CONFIG_MM_FREE_DELAYCOUNT_MAX is enabled.
+ *  CONFIG_MM_FREE_DELAYCOUNT_MAX is enabled, and at most
+ *  CONFIG_MM_FREE_DELAYLIST_BATCH chunks if that is not zero.
+ *
+ *  Only one CPU drains the list at a time, the others return at once and
+ *  leave the work to it.  A forced drain that may block waits for the
+ *  other drainer instead, since the chunks it holds may be what the
+ *  caller needs.
  *
  *  Return true if there is memory freed.
  *
@@ -60,51 +70,113 @@ static bool free_delaylist(FAR struct mm_heap_s *heap, bool force)
 {
   bool ret = false;
 #if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR atomic_ulong *list = (FAR atomic_ulong *)&heap->mm_delaylist;
   FAR struct mm_delaynode_s *tmp;
-  irqstate_t flags;
-
-  /* Move the delay list to local */
-
-  flags = up_irq_save();
+  unsigned long nfreed = 0;
+  bool refilled = false;
+#  ifdef CONFIG_MM_FREE_DELAYLIST_STATS
+  clock_t elapsed;
+  clock_t start;
+#  endif
 
-  tmp = heap->mm_delaylist[this_cpu()];
+  /* Test if the delayed is empty */
 
-#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
-  if (tmp == NULL ||
-      (!force &&
-        heap->mm_delaycount[this_cpu()] < CONFIG_MM_FREE_DELAYCOUNT_MAX))
+  if (heap->mm_delaylocal == NULL && atomic_load(list) == 0)
     {
-      up_irq_restore(flags);
       return false;
     }
 
-  heap->mm_delaycount[this_cpu()] = 0;
-#endif
+#  if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
+  if (!force &&
+      atomic_load((FAR atomic_ulong *)&heap->mm_delaycount) <
+      CONFIG_MM_FREE_DELAYCOUNT_MAX)
+    {
+      return false;
+    }
+#  endif
 
-  heap->mm_delaylist[this_cpu()] = NULL;
+  while (atomic_exchange((FAR atomic_uint *)&heap->mm_delaydrain, 1) != 0)
+    {
+      /* The drainer may have been preempted with the chunks taken off the
+       * delay list, so sleep to let it run.
+       */
 
-  up_irq_restore(flags);
+      if (!force || !OSINIT_OS_READY() || up_interrupt_context() ||
+          sched_idletask() || _SCHED_GETTID() < 0)
+        {
+          return false;
+        }
 
-  /* Test if the delayed is empty */
+      nxsig_usleep(USEC_PER_TICK);
+    }
 
-  ret = tmp != NULL;
+#  ifdef CONFIG_MM_FREE_DELAYLIST_STATS
+  start = perf_gettime();
+#  endif
 
-  while (tmp)
+  for (; ; )
     {
       FAR void *address;
 
+#  if CONFIG_MM_FREE_DELAYLIST_BATCH > 0
+      if (!force && nfreed >= CONFIG_MM_FREE_DELAYLIST_BATCH)
+        {
+          break;
+        }
+#  endif
+
+      /* Move the delay list to local once the local one runs dry.  The
+       * chunks which fail to be freed go back to the delay list, so it is
+       * taken only once to make sure the loop ends.
+       */
+
+      if (heap->mm_delaylocal == NULL)
+        {
+          if (refilled)
+            {
+              break;
+            }
+
+          heap->mm_delaylocal = (FAR struct mm_delaynode_s *)
+                                atomic_exchange(list, 0);
+          refilled = true;
+
+          if (heap->mm_delaylocal == NULL)
+            {
+              break;
+            }
+        }
+
       /* Get the first delayed deallocation */
 
+      tmp = heap->mm_delaylocal;
+      heap->mm_delaylocal = tmp->flink;
       address = tmp;
-      tmp = tmp->flink;
-
-      /* The address should always be non-NULL since that was checked in the
-       * 'while' condition above.
-       */
+      nfreed++;
 
       mm_delayfree(heap, address, false);
     }
 
+  atomic_fetch_sub((FAR atomic_ulong *)&heap->mm_delaycount, nfreed);
+
+#  ifdef CONFIG_MM_FREE_DELAYLIST_STATS
+  if (nfreed > 0)
+    {
+      elapsed = perf_gettime() - start;
+
+      heap->mm_delayndrain++;
+      heap->mm_delaynfreed    += nfreed;
+      heap->mm_delaytotaltime += elapsed;
+      if (elapsed > heap->mm_delaymaxtime)
+        {
+          heap->mm_delaymaxtime = elapsed;
+        }
+    }
+#  endif
+
+  atomic_store((FAR atomic_uint *)&heap->mm_delaydrain, 0);
+
+  ret = nfreed > 0;
 #endif
   return ret;
 }
@@ -144,7 +216,8 @@ void mm_mempool_dump_handle(FAR struct mempool_s *pool, FAR void *arg)
  * Name: mm_free_delaylist
  *
  * Description:
- *   force freeing the delaylist of this heap.
+ *   force freeing the delaylist of this heap.  The chunks held by the
+ *   per-CPU small chunk caches are returned to the heap as well.
  *
  ****************************************************************************/
 
@@ -153,8 +226,65 @@ void mm_free_delaylist(FAR struct mm_heap_s *heap)
   if (heap)
     {
        free_delaylist(heap, true);
+#ifdef CONFIG_MM_HEAP_TCACHE
+       mm_tcache_flush(heap);
+#endif
+    }
+}
+
+#ifdef CONFIG_MM_FREE_DELAYLIST_WORK
+/****************************************************************************
+ * Name: mm_delaylist_worker
+ *
+ * Description:
+ *   Drain the delay list of the heap passed in 'arg'.  This runs on the low
+ *   priority work queue, queued when a chunk is pushed onto an empty delay
+ *   list, so freeing chunks from interrupt handlers doesn't leave the work
+ *   to the next allocation.
+ *
+ ****************************************************************************/
+
+void mm_delaylist_worker(FAR void *arg)
+{
+  free_delaylist(arg, true);
+}
+#endif
+
+#ifdef CONFIG_MM_FREE_DELAYLIST_STATS
+/****************************************************************************
+ * Name: mm_delaylist_info
+ *
+ * Description:
+ *   Return the depth and the drain statistics of the delay list of 'heap'.
+ *
+ ****************************************************************************/
+
+void mm_delaylist_info(FAR struct mm_heap_s *heap,
+                       FAR struct mm_delayinfo_s *info)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  struct timespec ts;
+#endif
+
+  memset(info, 0, sizeof(*info));
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  info->depth    = atomic_load((FAR atomic_ulong *)&heap->mm_delaycount);
+  info->maxdepth = heap->mm_delaymaxcount;
+  info->ndrain   = heap->mm_delayndrain;
+  info->nfreed   = heap->mm_delaynfreed;
+
+  perf_convert(heap->mm_delaymaxtime, &ts);
+  info->maxtime  = ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+
+  if (info->ndrain > 0)
+    {
+      perf_convert(heap->mm_delaytotaltime / info->ndrain, &ts);
+      info->avgtime = ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
     }
+#endif
 }
+#endif
 
 /****************************************************************************
  * Name: mm_malloc
@@ -173,6 +303,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   size_t alignsize;
   size_t nodesize;
   FAR void *ret = NULL;
+#ifdef MM_HEAP_RECLAIM
+  size_t largest;
+#endif
   int ndx;
 
   /* Free the delay list first */
@@ -185,11 +318,21 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       ret = mempool_multiple_alloc(heap->mm_mpool, size);
       if (ret != NULL)
         {
+          sched_note_heap(NOTE_HEAP_ALLOC, heap, ret, size,
+                          heap->mm_curused);
           return ret;
         }
     }
 #endif
 
+#ifdef CONFIG_MM_HEAP_TCACHE
+  ret = mm_tcache_alloc(heap, size);
+  if (ret != NULL)
+    {
+      return ret;
+    }
+#endif
+
   /* Adjust the size to account for (1) the size of the allocated node and
    * (2) to make sure that it is aligned with MM_ALIGN and its size is at
    * least MM_MIN_CHUNK.
@@ -328,11 +471,16 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
                       heap->mm_curused);
     }
 
+#ifdef MM_HEAP_RECLAIM
+  largest = mm_heapfree_largest(heap);
+#endif
+
   mm_unlock(heap);
 
   if (ret)
     {
       MM_ADD_BACKTRACE(heap, node);
+      MM_TASK_ALLOC(node);
       ret = kasan_unpoison(ret, nodesize - MM_ALLOCNODE_OVERHEAD);
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
       memset(ret, MM_ALLOC_MAGIC, alignsize - MM_ALLOCNODE_OVERHEAD);
@@ -351,6 +499,30 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 #endif
 
+#ifdef CONFIG_MM_HEAP_TCACHE
+  /* Try again after returning the cached chunks to the heap */
+
+  else if (mm_tcache_flush(heap))
+    {
+      return mm_malloc(heap, size);
+    }
+#endif
+
+#ifdef MM_HEAP_RECLAIM
+  /* Try again after the caching subsystems released some memory */
+
+  else if (mm_reclaim_sync(size) > 0)
+    {
+      ret = mm_malloc(heap, size);
+      if (ret != NULL)
+        {
+          mm_reclaim_rescued();
+        }
+
+      return ret;
+    }
+#endif
+
 #ifdef CONFIG_DEBUG_MM
   else if (MM_INTERNAL_HEAP(heap))
     {
@@ -408,6 +580,17 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 #endif
 
+#ifdef MM_HEAP_RECLAIM
+  /* Ask the caching subsystems to give memory back if this allocation
+   * failed or left the heap too fragmented for the next one.
+   */
+
+  if (ret == NULL || largest < CONFIG_MM_RECLAIM_WATERMARK)
+    {
+      mm_reclaim();
+    }
+#endif
+
   DEBUGASSERT(ret == NULL || ((uintptr_t)ret) % MM_ALIGN == 0);
   return ret;
 }
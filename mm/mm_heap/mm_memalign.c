@@ -82,6 +82,8 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
       node = mempool_multiple_memalign(heap->mm_mpool, alignment, size);
       if (node != NULL)
         {
+          sched_note_heap_align(NOTE_HEAP_ALLOC, heap, node, size,
+                                heap->mm_curused, alignment);
           return node;
         }
     }
@@ -278,12 +280,13 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
       heap->mm_maxused = heap->mm_curused;
     }
 
-  sched_note_heap(NOTE_HEAP_ALLOC, heap, (FAR void *)alignedchunk, size,
-                  heap->mm_curused);
+  sched_note_heap_align(NOTE_HEAP_ALLOC, heap, (FAR void *)alignedchunk,
+                        size, heap->mm_curused, alignment);
 
   mm_unlock(heap);
 
   MM_ADD_BACKTRACE(heap, node);
+  MM_TASK_ALLOC(node);
 
   alignedchunk = (uintptr_t)kasan_unpoison((FAR const void *)alignedchunk,
                                            size - MM_ALLOCNODE_OVERHEAD);
@@ -92,6 +92,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       newmem = mempool_multiple_realloc(heap->mm_mpool, oldmem, size);
       if (newmem != NULL)
         {
+          sched_note_heap(NOTE_HEAP_FREE, heap, oldmem, 0, heap->mm_curused);
+          sched_note_heap(NOTE_HEAP_ALLOC, heap, newmem, size,
+                          heap->mm_curused);
           return newmem;
         }
       else if (size <= heap->mm_threshold ||
@@ -144,6 +147,8 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
   oldsize = MM_SIZEOF_NODE(oldnode);
   if (newsize <= oldsize)
     {
+      MM_TASK_FREE(oldnode);
+
       /* Handle the special case where we are not going to change the size
        * of the allocation.
        */
@@ -160,6 +165,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
       mm_unlock(heap);
       MM_ADD_BACKTRACE(heap, oldnode);
+      MM_TASK_ALLOC(oldnode);
 
       return oldmem;
     }
@@ -193,6 +199,8 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       size_t takeprev;
       size_t takenext;
 
+      MM_TASK_FREE(oldnode);
+
       /* Check if we can extend into the previous chunk and if the
        * previous chunk is smaller than the next chunk.
        */
@@ -389,6 +397,8 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
                       heap->mm_curused);
       mm_unlock(heap);
       MM_ADD_BACKTRACE(heap, (FAR char *)newmem - MM_SIZEOF_ALLOCNODE);
+      MM_TASK_ALLOC((FAR struct mm_allocnode_s *)
+                    ((FAR char *)newmem - MM_SIZEOF_ALLOCNODE));
 
       newmem = kasan_unpoison(newmem, MM_SIZEOF_NODE(oldnode) -
                               MM_ALLOCNODE_OVERHEAD);
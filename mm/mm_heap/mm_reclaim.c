@@ -0,0 +1,270 @@
+/****************************************************************************
+ * mm/mm_heap/mm_reclaim.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <debug.h>
+#include <sched.h>
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+#if defined(CONFIG_MM_RECLAIM) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The registered subsystems sorted by cost and the mutex protecting the
+ * list.  The mutex is held while the callbacks run, so unregistering waits
+ * for a running reclaim to finish.
+ */
+
+static FAR struct mm_reclaim_s *g_mm_reclaim;
+static mutex_t g_mm_reclaim_lock = NXMUTEX_INITIALIZER;
+
+static struct work_s g_mm_reclaim_work;
+static clock_t g_mm_reclaim_last;
+
+static struct mm_reclaiminfo_s g_mm_reclaim_info;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_reclaim_run
+ *
+ * Description:
+ *   Run the callbacks, cheapest first, until 'size' bytes were released.
+ *   The caller holds g_mm_reclaim_lock.
+ *
+ ****************************************************************************/
+
+static size_t mm_reclaim_run(size_t size, bool nonblock)
+{
+  FAR struct mm_reclaim_s *entry;
+  size_t released = 0;
+
+  for (entry = g_mm_reclaim; entry != NULL && released < size;
+       entry = entry->flink)
+    {
+      released += entry->reclaim(entry->arg, nonblock);
+    }
+
+  g_mm_reclaim_info.released += released;
+  return released;
+}
+
+/****************************************************************************
+ * Name: mm_reclaim_worker
+ ****************************************************************************/
+
+static void mm_reclaim_worker(FAR void *arg)
+{
+  nxmutex_lock(&g_mm_reclaim_lock);
+
+  mm_reclaim_run(SIZE_MAX, false);
+  g_mm_reclaim_info.nasync++;
+  g_mm_reclaim_last = clock_systime_ticks();
+
+  nxmutex_unlock(&g_mm_reclaim_lock);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_register_reclaim
+ *
+ * Description:
+ *   Register a subsystem that can give memory back to the heaps.  The
+ *   entries are kept sorted by entry->cost so the cheapest callbacks run
+ *   first.
+ *
+ * Input Parameters:
+ *   entry - The callback, its argument and cost, owned by the caller until
+ *           it is unregistered
+ *
+ ****************************************************************************/
+
+void mm_register_reclaim(FAR struct mm_reclaim_s *entry)
+{
+  FAR struct mm_reclaim_s **prev;
+
+  DEBUGASSERT(entry != NULL && entry->reclaim != NULL);
+
+  nxmutex_lock(&g_mm_reclaim_lock);
+
+  for (prev = &g_mm_reclaim; *prev != NULL; prev = &(*prev)->flink)
+    {
+      if ((*prev)->cost > entry->cost)
+        {
+          break;
+        }
+    }
+
+  entry->flink = *prev;
+  *prev = entry;
+
+  nxmutex_unlock(&g_mm_reclaim_lock);
+}
+
+/****************************************************************************
+ * Name: mm_unregister_reclaim
+ *
+ * Description:
+ *   Remove a subsystem registered with mm_register_reclaim().  On return
+ *   its callback is not running and won't be called again.
+ *
+ ****************************************************************************/
+
+void mm_unregister_reclaim(FAR struct mm_reclaim_s *entry)
+{
+  FAR struct mm_reclaim_s **prev;
+
+  nxmutex_lock(&g_mm_reclaim_lock);
+
+  for (prev = &g_mm_reclaim; *prev != NULL; prev = &(*prev)->flink)
+    {
+      if (*prev == entry)
+        {
+          *prev = entry->flink;
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_mm_reclaim_lock);
+}
+
+/****************************************************************************
+ * Name: mm_reclaim
+ *
+ * Description:
+ *   Ask the registered subsystems to release the memory they cache.  The
+ *   request is handed to the low priority work queue, so this may be called
+ *   from any context, including with a heap locked.  Requests closer than
+ *   CONFIG_MM_RECLAIM_INTERVAL to the previous reclaim are ignored.
+ *
+ ****************************************************************************/
+
+void mm_reclaim(void)
+{
+  if (g_mm_reclaim == NULL || !work_available(&g_mm_reclaim_work))
+    {
+      return;
+    }
+
+  if (g_mm_reclaim_last != 0 &&
+      clock_systime_ticks() - g_mm_reclaim_last <
+      MSEC2TICK(CONFIG_MM_RECLAIM_INTERVAL))
+    {
+      return;
+    }
+
+  work_queue(LPWORK, &g_mm_reclaim_work, mm_reclaim_worker, NULL, 0);
+}
+
+/****************************************************************************
+ * Name: mm_reclaim_sync
+ *
+ * Description:
+ *   Called by an allocation that is about to fail.  Run the callbacks in
+ *   the context of the caller, cheapest first, until at least 'size' bytes
+ *   were released.  The callbacks are told not to block because the caller
+ *   may hold any lock.  Nothing is done from interrupt handlers, the idle
+ *   thread, or if a reclaim is already running.
+ *
+ * Input Parameters:
+ *   size - The size of the failed allocation
+ *
+ * Returned Value:
+ *   The number of bytes released.  If non-zero the allocation is worth
+ *   retrying.
+ *
+ ****************************************************************************/
+
+size_t mm_reclaim_sync(size_t size)
+{
+  size_t released;
+
+  if (g_mm_reclaim == NULL || !OSINIT_OS_READY() ||
+      up_interrupt_context() || sched_idletask())
+    {
+      return 0;
+    }
+
+  /* This also stops the recursion if a callback allocates memory */
+
+  if (nxmutex_trylock(&g_mm_reclaim_lock) < 0)
+    {
+      return 0;
+    }
+
+  released = mm_reclaim_run(size, true);
+  g_mm_reclaim_info.nsync++;
+
+  nxmutex_unlock(&g_mm_reclaim_lock);
+  return released;
+}
+
+/****************************************************************************
+ * Name: mm_reclaim_rescued
+ *
+ * Description:
+ *   Count an allocation that succeeded after mm_reclaim_sync().
+ *
+ ****************************************************************************/
+
+void mm_reclaim_rescued(void)
+{
+  atomic_fetch_add((FAR atomic_ulong *)&g_mm_reclaim_info.nrescued, 1);
+}
+
+/****************************************************************************
+ * Name: mm_reclaim_info
+ *
+ * Description:
+ *   Return the reclaim statistics.
+ *
+ ****************************************************************************/
+
+void mm_reclaim_info(FAR struct mm_reclaiminfo_s *info)
+{
+  *info = g_mm_reclaim_info;
+}
+
+#endif /* CONFIG_MM_RECLAIM && (CONFIG_BUILD_FLAT || __KERNEL__) */
@@ -0,0 +1,97 @@
+/****************************************************************************
+ * mm/mm_heap/mm_taskusage.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+#ifdef CONFIG_MM_HEAP_TASKPEAK
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_taskusage
+ *
+ * Description:
+ *   Add 'delta' bytes to the heap usage of the thread 'pid' and update its
+ *   peak.  Chunks owned by the heap itself (negative pids) and by threads
+ *   that have exited are ignored.
+ *
+ * Input Parameters:
+ *   pid   - The owner of the chunk
+ *   delta - The size allocated (positive) or freed (negative)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_taskusage(pid_t pid, ssize_t delta)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+
+  if (pid < 0)
+    {
+      return;
+    }
+
+  /* The critical section keeps the TCB from going away under us */
+
+  flags = enter_critical_section();
+
+  tcb = nxsched_get_tcb(pid);
+  if (tcb != NULL)
+    {
+      if (delta < 0 && tcb->heap_used < (size_t)-delta)
+        {
+          tcb->heap_used = 0;
+        }
+      else
+        {
+          tcb->heap_used += delta;
+        }
+
+      if (tcb->heap_used > tcb->heap_peak)
+        {
+          tcb->heap_peak = tcb->heap_used;
+        }
+    }
+
+  leave_critical_section(flags);
+#endif
+}
+
+#endif /* CONFIG_MM_HEAP_TASKPEAK */
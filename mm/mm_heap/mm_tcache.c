@@ -0,0 +1,347 @@
+/****************************************************************************
+ * mm/mm_heap/mm_tcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mm/kasan.h>
+#include <nuttx/sched_note.h>
+
+#include "mm_heap/mm.h"
+
+#ifdef CONFIG_MM_HEAP_TCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The cache of the current CPU is only touched with interrupts disabled.
+ * In SMP mode a flush may also empty the cache of another CPU, so each
+ * cache has its own spinlock as well.
+ */
+
+#ifdef CONFIG_SMP
+#  define mm_tcache_lock(t)   spin_lock(&(t)->lock)
+#  define mm_tcache_unlock(t) spin_unlock(&(t)->lock)
+#else
+#  define mm_tcache_lock(t)
+#  define mm_tcache_unlock(t)
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tcache_nodesize
+ *
+ * Description:
+ *   Return the chunk size mm_malloc() would use for a request of 'size'
+ *   bytes, or zero if such a chunk is never cached.
+ *
+ ****************************************************************************/
+
+static size_t mm_tcache_nodesize(size_t size)
+{
+  if (size > CONFIG_MM_HEAP_TCACHE_MAXSIZE)
+    {
+      return 0;
+    }
+
+  if (size < MM_MIN_CHUNK - MM_ALLOCNODE_OVERHEAD)
+    {
+      size = MM_MIN_CHUNK - MM_ALLOCNODE_OVERHEAD;
+    }
+
+  return MM_ALIGN_UP(size + MM_ALLOCNODE_OVERHEAD);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tcache_alloc
+ *
+ * Description:
+ *   Take a chunk large enough for 'size' bytes from the cache of the
+ *   current CPU without taking the heap mutex.
+ *
+ * Returned Value:
+ *   The allocated memory or NULL if the cache has no suitable chunk.
+ *
+ ****************************************************************************/
+
+FAR void *mm_tcache_alloc(FAR struct mm_heap_s *heap, size_t size)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR struct mm_delaynode_s *chunk;
+  FAR struct mm_tcache_s *tcache;
+  FAR void *ret;
+  irqstate_t flags;
+  size_t nodesize;
+  int ndx;
+
+  nodesize = mm_tcache_nodesize(size);
+  if (nodesize == 0)
+    {
+      return NULL;
+    }
+
+  ndx = MM_TCACHE_NDX(nodesize);
+
+  flags  = up_irq_save();
+  tcache = &heap->mm_tcache[this_cpu()];
+  mm_tcache_lock(tcache);
+
+  chunk = tcache->bin[ndx];
+  if (chunk != NULL)
+    {
+      tcache->bin[ndx] = chunk->flink;
+      tcache->count[ndx]--;
+      tcache->hits++;
+    }
+  else
+    {
+      tcache->misses++;
+    }
+
+  mm_tcache_unlock(tcache);
+  up_irq_restore(flags);
+
+  if (chunk == NULL)
+    {
+      return NULL;
+    }
+
+  /* The chunk never left the allocated state, only the owner changes */
+
+  MM_ADD_BACKTRACE(heap, (FAR char *)chunk - MM_SIZEOF_ALLOCNODE);
+  MM_TASK_ALLOC((FAR struct mm_allocnode_s *)
+                ((FAR char *)chunk - MM_SIZEOF_ALLOCNODE));
+  sched_note_heap(NOTE_HEAP_ALLOC, heap, chunk, nodesize,
+                  heap->mm_curused);
+
+  ret = kasan_unpoison(chunk, nodesize - MM_ALLOCNODE_OVERHEAD);
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(ret, MM_ALLOC_MAGIC, nodesize - MM_ALLOCNODE_OVERHEAD);
+#endif
+
+  return ret;
+#else
+  return NULL;
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_tcache_free
+ *
+ * Description:
+ *   Put a small chunk into the cache of the current CPU instead of
+ *   returning it to the heap.
+ *
+ * Returned Value:
+ *   true if the chunk was cached, false if the caller must free it.
+ *
+ ****************************************************************************/
+
+bool mm_tcache_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR struct mm_delaynode_s *chunk;
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_tcache_s *tcache;
+  irqstate_t flags;
+  size_t nodesize;
+  bool cached = false;
+  int ndx;
+#ifdef CONFIG_MM_HEAP_TASKPEAK
+  pid_t pid = PID_MM_FREE;
+#endif
+
+  chunk    = kasan_reset_tag(mem);
+  node     = (FAR struct mm_allocnode_s *)
+             ((FAR char *)chunk - MM_SIZEOF_ALLOCNODE);
+  nodesize = MM_SIZEOF_NODE(node);
+
+  if (nodesize > MM_TCACHE_MAXCHUNK)
+    {
+      return false;
+    }
+
+  /* Sanity check against double-frees */
+
+  DEBUGASSERT(MM_NODE_IS_ALLOC(node));
+
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(mem, MM_FREE_MAGIC, nodesize - MM_ALLOCNODE_OVERHEAD);
+#endif
+
+  kasan_poison(mem, nodesize - MM_ALLOCNODE_OVERHEAD);
+
+  ndx = MM_TCACHE_NDX(nodesize);
+
+  flags  = up_irq_save();
+  tcache = &heap->mm_tcache[this_cpu()];
+  mm_tcache_lock(tcache);
+
+  if (tcache->count[ndx] < CONFIG_MM_HEAP_TCACHE_NCHUNKS)
+    {
+#ifdef CONFIG_MM_HEAP_TASKPEAK
+      /* A cached chunk belongs to the heap rather than to a thread */
+
+      pid              = node->pid;
+      node->pid        = PID_MM_FREE;
+#endif
+      chunk->flink     = tcache->bin[ndx];
+      tcache->bin[ndx] = chunk;
+      tcache->count[ndx]++;
+      cached           = true;
+    }
+
+  mm_tcache_unlock(tcache);
+  up_irq_restore(flags);
+
+  if (cached)
+    {
+#ifdef CONFIG_MM_HEAP_TASKPEAK
+      mm_taskusage(pid, -(ssize_t)nodesize);
+#endif
+      sched_note_heap(NOTE_HEAP_FREE, heap, mem, nodesize,
+                      heap->mm_curused);
+    }
+
+  return cached;
+#else
+  return false;
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_tcache_flush
+ *
+ * Description:
+ *   Return the chunks of all CPU caches to the heap.
+ *
+ * Returned Value:
+ *   true if any chunk was returned to the heap.
+ *
+ ****************************************************************************/
+
+bool mm_tcache_flush(FAR struct mm_heap_s *heap)
+{
+  bool ret = false;
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR struct mm_delaynode_s *chunk;
+  FAR struct mm_delaynode_s *list;
+  FAR struct mm_tcache_s *tcache;
+  irqstate_t flags;
+  int cpu;
+  int ndx;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      tcache = &heap->mm_tcache[cpu];
+      list   = NULL;
+
+      /* Detach the chunks of each bin and chain them into one list */
+
+      flags = up_irq_save();
+      mm_tcache_lock(tcache);
+
+      for (ndx = 0; ndx < MM_TCACHE_NBINS; ndx++)
+        {
+          while ((chunk = tcache->bin[ndx]) != NULL)
+            {
+              tcache->bin[ndx] = chunk->flink;
+              chunk->flink     = list;
+              list             = chunk;
+            }
+
+          tcache->count[ndx] = 0;
+        }
+
+      mm_tcache_unlock(tcache);
+      up_irq_restore(flags);
+
+      /* Then free them with the heap mutex */
+
+      while (list != NULL)
+        {
+          chunk = list;
+          list  = list->flink;
+
+          mm_delayfree(heap, chunk, false);
+          ret = true;
+        }
+    }
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_tcache_info
+ *
+ * Description:
+ *   Return the hit statistics of the small chunk caches of 'heap'.
+ *
+ ****************************************************************************/
+
+void mm_tcache_info(FAR struct mm_heap_s *heap,
+                    FAR struct mm_tcacheinfo_s *info)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR struct mm_tcache_s *tcache;
+  irqstate_t flags;
+  int cpu;
+#endif
+
+  memset(info, 0, sizeof(*info));
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      tcache = &heap->mm_tcache[cpu];
+
+      flags = up_irq_save();
+      mm_tcache_lock(tcache);
+
+      info->hits   += tcache->hits;
+      info->misses += tcache->misses;
+
+      mm_tcache_unlock(tcache);
+      up_irq_restore(flags);
+    }
+#endif
+}
+
+#endif /* CONFIG_MM_HEAP_TCACHE */
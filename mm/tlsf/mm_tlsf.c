@@ -54,6 +54,32 @@
 #  define MEMPOOL_NPOOLS (CONFIG_MM_HEAP_MEMPOOL_THRESHOLD / tlsf_align_size())
 #endif
 
+#if CONFIG_MM_REGIONS > 1
+#  define MM_NREGIONS(heap)  ((heap)->mm_nregions)
+#else
+#  define MM_NREGIONS(heap)  1
+#endif
+
+/* With CONFIG_MM_TLSF_SUBPOOLS every CPU gets a TLSF sub-pool of its own.
+ * Blocks freed by another CPU are queued back to the owner of the block,
+ * which only works where interrupts can be disabled.
+ */
+
+#ifdef CONFIG_MM_TLSF_SUBPOOLS
+#  define MM_NSUBPOOLS       CONFIG_SMP_NCPUS
+#  if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+#    define MM_REMOTE_FREE
+#  endif
+#else
+#  define MM_NSUBPOOLS       1
+#endif
+
+/* A region is only split between the sub-pools if every share gets at
+ * least this size, otherwise the first sub-pool takes it all.
+ */
+
+#define MM_SUBPOOL_MINSIZE   (4 * tlsf_size())
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -63,25 +89,54 @@ struct mm_delaynode_s
   FAR struct mm_delaynode_s *flink;
 };
 
-struct mm_heap_s
+/* This describes one TLSF pool of a heap.  Without CONFIG_MM_TLSF_SUBPOOLS
+ * the heap has a single pool owning all regions.
+ */
+
+struct mm_subpool_s
 {
   /* Mutually exclusive access to this data set is enforced with
    * the following un-named mutex.
    */
 
-  mutex_t mm_lock;
+  mutex_t lock;
 
-  /* This is the size of the heap provided to mm */
+  tlsf_t tlsf; /* The tlfs context */
 
-  size_t mm_heapsize;
+  /* This is the part of each heap region owned by the pool */
+
+  FAR void *start[CONFIG_MM_REGIONS];
+  FAR void *end[CONFIG_MM_REGIONS];
+
+  /* This is the size of the memory owned by the pool */
+
+  size_t heapsize;
+
+  /* This is the pool maximum used memory size */
+
+  size_t maxused;
 
-  /* This is the heap maximum used memory size */
+  /* This is the current used size of the pool */
 
-  size_t mm_maxused;
+  size_t curused;
 
-  /* This is the current used size of the heap */
+#ifdef CONFIG_MM_TLSF_SUBPOOLS
+  /* Blocks freed by other CPUs, returned by the next user of the pool */
 
-  size_t mm_curused;
+  spinlock_t remotelock;
+  FAR struct mm_delaynode_s *remote;
+
+  size_t nalloc;  /* The number of allocations served */
+  size_t nsteal;  /* Allocations served after another pool failed */
+  size_t nremote; /* The number of frees queued by other CPUs */
+#endif
+};
+
+struct mm_heap_s
+{
+  /* This is the size of the heap provided to mm */
+
+  size_t mm_heapsize;
 
   /* This is the first and last of the heap */
 
@@ -92,7 +147,11 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
-  tlsf_t mm_tlsf; /* The tlfs context */
+  /* The TLSF pools of the heap, one for each CPU with
+   * CONFIG_MM_TLSF_SUBPOOLS.
+   */
+
+  struct mm_subpool_s mm_subpool[MM_NSUBPOOLS];
 
   /* The is a multiple mempool of the heap */
 
@@ -469,14 +528,14 @@ static void mallinfo_task_handler(FAR void *ptr, size_t size, int used,
  *     2.The task/thread free the memory in the exiting process.
  *
  * Input Parameters:
- *   heap  - heap instance want to take mutex
+ *   pool  - pool instance want to take mutex
  *
  * Returned Value:
  *   0 if the lock can be taken, otherwise negative errno.
  *
  ****************************************************************************/
 
-static int mm_lock(FAR struct mm_heap_s *heap)
+static int mm_lock(FAR struct mm_subpool_s *pool)
 {
 #if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
   /* Check current environment */
@@ -488,7 +547,7 @@ static int mm_lock(FAR struct mm_heap_s *heap)
        * Or, touch the heap internal data directly.
        */
 
-      return nxmutex_is_locked(&heap->mm_lock) ? -EAGAIN : 0;
+      return nxmutex_is_locked(&pool->lock) ? -EAGAIN : 0;
 #else
       /* Can't take mutex in SMP interrupt handler */
 
@@ -514,7 +573,7 @@ static int mm_lock(FAR struct mm_heap_s *heap)
     }
   else
     {
-      return nxmutex_lock(&heap->mm_lock);
+      return nxmutex_lock(&pool->lock);
     }
 }
 
@@ -526,7 +585,7 @@ static int mm_lock(FAR struct mm_heap_s *heap)
  *
  ****************************************************************************/
 
-static void mm_unlock(FAR struct mm_heap_s *heap)
+static void mm_unlock(FAR struct mm_subpool_s *pool)
 {
 #if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
   if (up_interrupt_context())
@@ -535,7 +594,275 @@ static void mm_unlock(FAR struct mm_heap_s *heap)
     }
 #endif
 
-  DEBUGVERIFY(nxmutex_unlock(&heap->mm_lock));
+  DEBUGVERIFY(nxmutex_unlock(&pool->lock));
+}
+
+/****************************************************************************
+ * Name: mm_lock_all
+ *
+ * Description:
+ *   Take the mutex of every pool, always in the same order.
+ *
+ ****************************************************************************/
+
+static void mm_lock_all(FAR struct mm_heap_s *heap)
+{
+  int i;
+
+  for (i = 0; i < MM_NSUBPOOLS; i++)
+    {
+      DEBUGVERIFY(mm_lock(&heap->mm_subpool[i]));
+    }
+}
+
+/****************************************************************************
+ * Name: mm_unlock_all
+ ****************************************************************************/
+
+static void mm_unlock_all(FAR struct mm_heap_s *heap)
+{
+  int i;
+
+  for (i = MM_NSUBPOOLS - 1; i >= 0; i--)
+    {
+      mm_unlock(&heap->mm_subpool[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: mm_curused
+ *
+ * Description:
+ *   Return the current used size of the heap.
+ *
+ ****************************************************************************/
+
+static size_t mm_curused(FAR struct mm_heap_s *heap)
+{
+  size_t curused = 0;
+  int i;
+
+  for (i = 0; i < MM_NSUBPOOLS; i++)
+    {
+      curused += heap->mm_subpool[i].curused;
+    }
+
+  return curused;
+}
+
+/****************************************************************************
+ * Name: mm_subpool_this
+ *
+ * Description:
+ *   Return the pool the allocations of the caller are steered to.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_subpool_s *mm_subpool_this(FAR struct mm_heap_s *heap)
+{
+#if defined(MM_REMOTE_FREE)
+  return &heap->mm_subpool[this_cpu()];
+#elif defined(CONFIG_MM_TLSF_SUBPOOLS)
+  /* this_cpu() is not available to user space, spread by thread instead */
+
+  return &heap->mm_subpool[(unsigned int)_SCHED_GETTID() % MM_NSUBPOOLS];
+#else
+  return &heap->mm_subpool[0];
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_subpool_find
+ *
+ * Description:
+ *   Return the pool owning the memory block.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_subpool_s *mm_subpool_find(FAR struct mm_heap_s *heap,
+                                                FAR void *mem)
+{
+#ifdef CONFIG_MM_TLSF_SUBPOOLS
+  FAR struct mm_subpool_s *pool;
+  int region;
+  int i;
+
+  for (i = 0; i < MM_NSUBPOOLS; i++)
+    {
+      pool = &heap->mm_subpool[i];
+      for (region = 0; region < MM_NREGIONS(heap); region++)
+        {
+          if (mem >= pool->start[region] && mem < pool->end[region])
+            {
+              return pool;
+            }
+        }
+    }
+
+  DEBUGPANIC();
+#endif
+
+  return &heap->mm_subpool[0];
+}
+
+/****************************************************************************
+ * Name: mm_walk
+ *
+ * Description:
+ *   Visit every block of the heap, retaking the mutex of the owning pool
+ *   for each region to reduce latencies.
+ *
+ ****************************************************************************/
+
+static void mm_walk(FAR struct mm_heap_s *heap, tlsf_walker walker,
+                    FAR void *arg)
+{
+  FAR struct mm_subpool_s *pool;
+  int region;
+  int i;
+
+  for (i = 0; i < MM_NSUBPOOLS; i++)
+    {
+      pool = &heap->mm_subpool[i];
+      for (region = 0; region < MM_NREGIONS(heap); region++)
+        {
+          if (pool->start[region] != NULL)
+            {
+              DEBUGVERIFY(mm_lock(pool));
+              tlsf_walk_pool(pool->start[region], walker, arg);
+              mm_unlock(pool);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mm_subpool_drain
+ *
+ * Description:
+ *   Return the blocks queued by other CPUs to the pool.  The caller must
+ *   hold the mutex of the pool.
+ *
+ ****************************************************************************/
+
+#ifdef MM_REMOTE_FREE
+static void mm_subpool_drain(FAR struct mm_heap_s *heap,
+                             FAR struct mm_subpool_s *pool)
+{
+  FAR struct mm_delaynode_s *tmp;
+  irqstate_t flags;
+
+  if (pool->remote == NULL)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&pool->remotelock);
+  tmp = pool->remote;
+  pool->remote = NULL;
+  spin_unlock_irqrestore(&pool->remotelock, flags);
+
+  while (tmp != NULL)
+    {
+      FAR void *mem = tmp;
+      size_t size;
+
+      tmp  = tmp->flink;
+      size = mm_malloc_size(heap, mem);
+
+      pool->curused -= size;
+      sched_note_heap(NOTE_HEAP_FREE, heap, mem, size, mm_curused(heap));
+      tlsf_free(pool->tlsf, mem);
+    }
+}
+
+/****************************************************************************
+ * Name: mm_subpool_queue
+ *
+ * Description:
+ *   Queue a block freed by another CPU to the pool owning it.
+ *
+ ****************************************************************************/
+
+static void mm_subpool_queue(FAR struct mm_subpool_s *pool, FAR void *mem)
+{
+  FAR struct mm_delaynode_s *tmp = mem;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&pool->remotelock);
+  tmp->flink   = pool->remote;
+  pool->remote = tmp;
+  pool->nremote++;
+  spin_unlock_irqrestore(&pool->remotelock, flags);
+}
+#else
+#  define mm_subpool_drain(heap, pool)
+#endif
+
+/****************************************************************************
+ * Name: mm_subpool_alloc
+ *
+ * Description:
+ *   Allocate from the pool of the caller first and from the other pools
+ *   when it is exhausted.  The size already includes the backtrace, the
+ *   caller is recorded in the heap note.
+ *
+ ****************************************************************************/
+
+static FAR void *mm_subpool_alloc(FAR struct mm_heap_s *heap,
+                                  size_t alignment, size_t size,
+                                  uintptr_t caller)
+{
+  FAR struct mm_subpool_s *first = mm_subpool_this(heap);
+  FAR struct mm_subpool_s *pool = first;
+  FAR void *ret;
+  size_t nodesize;
+
+  do
+    {
+      DEBUGVERIFY(mm_lock(pool));
+      mm_subpool_drain(heap, pool);
+
+      if (alignment > 0)
+        {
+          ret = tlsf_memalign(pool->tlsf, alignment, size);
+        }
+      else
+        {
+          ret = tlsf_malloc(pool->tlsf, size);
+        }
+
+      if (ret)
+        {
+          nodesize = mm_malloc_size(heap, ret);
+          pool->curused += nodesize;
+          if (pool->curused > pool->maxused)
+            {
+              pool->maxused = pool->curused;
+            }
+
+#ifdef CONFIG_MM_TLSF_SUBPOOLS
+          pool->nalloc++;
+          if (pool != first)
+            {
+              pool->nsteal++;
+            }
+#endif
+
+          sched_note_heap_ip(NOTE_HEAP_ALLOC, heap, ret, nodesize,
+                             mm_curused(heap), alignment, caller);
+        }
+
+      mm_unlock(pool);
+
+      if (++pool == heap->mm_subpool + MM_NSUBPOOLS)
+        {
+          pool = heap->mm_subpool;
+        }
+    }
+  while (ret == NULL && pool != first);
+
+  return ret;
 }
 
 /****************************************************************************
@@ -590,7 +917,18 @@ static void memdump_handler(FAR void *ptr, size_t size, int used,
 static void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem,
                          bool delay)
 {
-  if (mm_lock(heap) == 0)
+  FAR struct mm_subpool_s *pool = mm_subpool_find(heap, mem);
+#ifdef MM_REMOTE_FREE
+  bool remote = pool != mm_subpool_this(heap);
+#else
+  bool remote = false;
+#endif
+
+  /* Blocks owned by the pool of another CPU are queued to that pool
+   * without taking its mutex.
+   */
+
+  if (remote || mm_lock(pool) == 0)
     {
       size_t size = mm_malloc_size(heap, mem);
       UNUSED(size);
@@ -617,16 +955,25 @@ static void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem,
         {
           add_delaylist(heap, mem);
         }
+#ifdef MM_REMOTE_FREE
+      else if (remote)
+        {
+          mm_subpool_queue(pool, mem);
+        }
+#endif
       else
         {
           /* Update heap statistics */
 
-          heap->mm_curused -= size;
-          sched_note_heap(NOTE_HEAP_FREE, heap, mem, size, heap->mm_curused);
-          tlsf_free(heap->mm_tlsf, mem);
+          pool->curused -= size;
+          sched_note_heap(NOTE_HEAP_FREE, heap, mem, size, mm_curused(heap));
+          tlsf_free(pool->tlsf, mem);
         }
 
-      mm_unlock(heap);
+      if (!remote)
+        {
+          mm_unlock(pool);
+        }
     }
   else
     {
@@ -661,6 +1008,10 @@ static void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem,
 void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
                   size_t heapsize)
 {
+  FAR struct mm_subpool_s *pool;
+  size_t share = heapsize;
+  int npools = 1;
+  int i;
 #if CONFIG_MM_REGIONS > 1
   int idx;
 
@@ -688,7 +1039,7 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
 
   kasan_register(heapstart, &heapsize);
 
-  DEBUGVERIFY(mm_lock(heap));
+  mm_lock_all(heap);
 
   minfo("Region %d: base=%p size=%zu\n", idx + 1, heapstart, heapsize);
 
@@ -701,18 +1052,45 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
   heap->mm_heapstart[idx] = heapstart;
   heap->mm_heapend[idx]   = heapstart + heapsize;
 
+  sched_note_heap(NOTE_HEAP_ADD, heap, heapstart, heapsize,
+                  mm_curused(heap));
+
+  /* Split the region into one share for each pool, unless the shares
+   * would be too small to be useful.
+   */
+
+  if (MM_NSUBPOOLS > 1 &&
+      heapsize / MM_NSUBPOOLS >= MM_SUBPOOL_MINSIZE)
+    {
+      npools = MM_NSUBPOOLS;
+      share  = ALIGN_DOWN(heapsize / MM_NSUBPOOLS, tlsf_align_size());
+    }
+
+  for (i = 0; i < npools; i++)
+    {
+      pool = &heap->mm_subpool[i];
+      if (i + 1 == npools)
+        {
+          share = heapsize - share * i;
+        }
+
+      pool->start[idx] = heapstart;
+      pool->end[idx]   = heapstart + share;
+      pool->heapsize  += share;
+
+      /* Add memory to the tlsf pool */
+
+      tlsf_add_pool(pool->tlsf, heapstart, share);
+      heapstart += share;
+    }
+
 #undef idx
 
 #if CONFIG_MM_REGIONS > 1
   heap->mm_nregions++;
 #endif
 
-  /* Add memory to the tlsf pool */
-
-  tlsf_add_pool(heap->mm_tlsf, heapstart, heapsize);
-  sched_note_heap(NOTE_HEAP_ADD, heap, heapstart, heapsize,
-                  heap->mm_curused);
-  mm_unlock(heap);
+  mm_unlock_all(heap);
 }
 
 /****************************************************************************
@@ -776,41 +1154,43 @@ FAR void *mm_calloc(FAR struct mm_heap_s *heap, size_t n, size_t elem_size)
 
 void mm_checkcorruption(FAR struct mm_heap_s *heap)
 {
-#if CONFIG_MM_REGIONS > 1
+  FAR struct mm_subpool_s *pool;
   int region;
-#else
-#  define region 0
-#endif
+  int i;
 
-  /* Visit each region */
+  /* Visit each region of each pool */
 
-#if CONFIG_MM_REGIONS > 1
-  for (region = 0; region < heap->mm_nregions; region++)
-#endif
+  for (i = 0; i < MM_NSUBPOOLS; i++)
     {
-      /* Retake the mutex for each region to reduce latencies */
-
-      if (mm_lock(heap) < 0)
+      pool = &heap->mm_subpool[i];
+      for (region = 0; region < MM_NREGIONS(heap); region++)
         {
-          return;
-        }
+          /* Retake the mutex for each region to reduce latencies */
+
+          if (mm_lock(pool) < 0)
+            {
+              return;
+            }
 
-      /* Check tlsf control block in the first pass */
+          /* Check tlsf control block in the first pass */
 
-      if (region == 0)
-        {
-          tlsf_check(heap->mm_tlsf);
-        }
+          if (region == 0)
+            {
+              tlsf_check(pool->tlsf);
+            }
 
-      /* Check tlsf pool in each iteration temporarily */
+          /* Check tlsf pool in each iteration temporarily */
 
-      tlsf_check_pool(heap->mm_heapstart[region]);
+          if (pool->start[region] != NULL)
+            {
+              tlsf_check_pool(pool->start[region]);
+            }
 
-      /* Release the mutex */
+          /* Release the mutex */
 
-      mm_unlock(heap);
+          mm_unlock(pool);
+        }
     }
-#undef region
 }
 #endif
 
@@ -826,6 +1206,7 @@ void mm_checkcorruption(FAR struct mm_heap_s *heap)
 void mm_extend(FAR struct mm_heap_s *heap, FAR void *mem, size_t size,
                int region)
 {
+  FAR struct mm_subpool_s *pool;
   size_t oldsize;
 
   /* Make sure that we were passed valid parameters */
@@ -839,19 +1220,22 @@ void mm_extend(FAR struct mm_heap_s *heap, FAR void *mem, size_t size,
 
   /* Take the memory manager mutex */
 
-  DEBUGVERIFY(mm_lock(heap));
+  mm_lock_all(heap);
 
-  /* Extend the tlsf pool */
+  /* Extend the tlsf pool owning the end of the region */
 
-  oldsize = heap->mm_heapend[region] - heap->mm_heapstart[region];
-  tlsf_extend_pool(heap->mm_tlsf, heap->mm_heapstart[region], oldsize, size);
+  pool    = mm_subpool_find(heap, (FAR char *)mem - 1);
+  oldsize = pool->end[region] - pool->start[region];
+  tlsf_extend_pool(pool->tlsf, pool->start[region], oldsize, size);
 
   /* Save the new size */
 
+  pool->heapsize += size;
+  pool->end[region] += size;
   heap->mm_heapsize += size;
   heap->mm_heapend[region] += size;
 
-  mm_unlock(heap);
+  mm_unlock_all(heap);
 }
 
 /****************************************************************************
@@ -879,8 +1263,13 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   if (heap->mm_mpool)
     {
+#ifdef CONFIG_SCHED_INSTRUMENTATION_HEAP
+      ssize_t size = mempool_multiple_alloc_size(heap->mm_mpool, mem);
+#endif
+
       if (mempool_multiple_free(heap->mm_mpool, mem) >= 0)
         {
+          sched_note_heap(NOTE_HEAP_FREE, heap, mem, size, mm_curused(heap));
           return;
         }
     }
@@ -969,6 +1358,7 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
                                     FAR void *heapstart, size_t heapsize)
 {
   FAR struct mm_heap_s *heap;
+  int i;
 
   minfo("Heap: name=%s start=%p size=%zu\n", name, heapstart, heapsize);
 
@@ -980,18 +1370,23 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
   heapstart += sizeof(struct mm_heap_s);
   heapsize -= sizeof(struct mm_heap_s);
 
-  /* Allocate and create TLSF context */
+  for (i = 0; i < MM_NSUBPOOLS; i++)
+    {
+      FAR struct mm_subpool_s *pool = &heap->mm_subpool[i];
 
-  DEBUGASSERT(heapsize > tlsf_size());
-  heap->mm_tlsf = tlsf_create(heapstart);
-  heapstart += tlsf_size();
-  heapsize -= tlsf_size();
+      /* Allocate and create TLSF context */
 
-  /* Initialize the malloc mutex (to support one-at-
-   * a-time access to private data sets).
-   */
+      DEBUGASSERT(heapsize > tlsf_size());
+      pool->tlsf = tlsf_create(heapstart);
+      heapstart += tlsf_size();
+      heapsize -= tlsf_size();
+
+      /* Initialize the malloc mutex (to support one-at-
+       * a-time access to private data sets).
+       */
 
-  nxmutex_init(&heap->mm_lock);
+      nxmutex_init(&pool->lock);
+    }
 
   /* Add the initial region of memory to the heap */
 
@@ -1083,32 +1478,25 @@ struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   struct mallinfo poolinfo;
 #endif
-#if CONFIG_MM_REGIONS > 1
-  int region;
-#else
-#  define region 0
-#endif
+  int i;
 
   memset(&info, 0, sizeof(struct mallinfo));
 
   /* Visit each region */
 
-#if CONFIG_MM_REGIONS > 1
-  for (region = 0; region < heap->mm_nregions; region++)
-#endif
-    {
-      /* Retake the mutex for each region to reduce latencies */
-
-      DEBUGVERIFY(mm_lock(heap));
-      tlsf_walk_pool(heap->mm_heapstart[region],
-                     mallinfo_handler, &info);
-      mm_unlock(heap);
-    }
-#undef region
+  mm_walk(heap, mallinfo_handler, &info);
 
   info.arena    = heap->mm_heapsize;
   info.uordblks = info.arena - info.fordblks;
-  info.usmblks  = heap->mm_maxused;
+
+  /* The pools don't reach their maximum at the same time, so the sum is
+   * an upper bound of the heap maximum with more than one pool.
+   */
+
+  for (i = 0; i < MM_NSUBPOOLS; i++)
+    {
+      info.usmblks += heap->mm_subpool[i].maxused;
+    }
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   poolinfo = mempool_multiple_mallinfo(heap->mm_mpool);
@@ -1129,30 +1517,13 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
       0, 0
     };
 
-#if CONFIG_MM_REGIONS > 1
-  int region;
-#else
-#define region 0
-#endif
-
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   info = mempool_multiple_info_task(heap->mm_mpool, task);
 #endif
 
   handle.task = task;
   handle.info = &info;
-#if CONFIG_MM_REGIONS > 1
-  for (region = 0; region < heap->mm_nregions; region++)
-#endif
-    {
-      /* Retake the mutex for each region to reduce latencies */
-
-      DEBUGVERIFY(mm_lock(heap));
-      tlsf_walk_pool(heap->mm_heapstart[region],
-                     mallinfo_task_handler, &handle);
-      mm_unlock(heap);
-    }
-#undef region
+  mm_walk(heap, mallinfo_task_handler, &handle);
 
   return info;
 }
@@ -1171,11 +1542,6 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
 void mm_memdump(FAR struct mm_heap_s *heap,
                 FAR const struct mm_memdump_s *dump)
 {
-#if CONFIG_MM_REGIONS > 1
-  int region;
-#else
-#  define region 0
-#endif
   struct mm_memdump_priv_s priv;
   pid_t pid = dump->pid;
 
@@ -1241,17 +1607,7 @@ void mm_memdump(FAR struct mm_heap_s *heap,
 #endif
 
   memdump_dump_pool(&priv, heap);
-
-#if CONFIG_MM_REGIONS > 1
-  for (region = 0; region < heap->mm_nregions; region++)
-#endif
-    {
-      DEBUGVERIFY(mm_lock(heap));
-      tlsf_walk_pool(heap->mm_heapstart[region],
-                     memdump_handler, &priv);
-      mm_unlock(heap);
-    }
-#undef region
+  mm_walk(heap, memdump_handler, &priv);
 
 #if CONFIG_MM_HEAP_BIGGEST_COUNT > 0
   if (pid == PID_MM_BIGGEST)
@@ -1317,6 +1673,8 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       ret = mempool_multiple_alloc(heap->mm_mpool, size);
       if (ret != NULL)
         {
+          sched_note_heap(NOTE_HEAP_ALLOC, heap, ret, size,
+                          mm_curused(heap));
           return ret;
         }
     }
@@ -1328,35 +1686,21 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   /* Allocate from the tlsf pool */
 
-  DEBUGVERIFY(mm_lock(heap));
 #if CONFIG_MM_BACKTRACE >= 0
-  ret = tlsf_malloc(heap->mm_tlsf, size +
-                    sizeof(struct memdump_backtrace_s));
+  ret = mm_subpool_alloc(heap, 0, size +
+                         sizeof(struct memdump_backtrace_s),
+                         (uintptr_t)return_address(0));
 #else
-  ret = tlsf_malloc(heap->mm_tlsf, size);
+  ret = mm_subpool_alloc(heap, 0, size, (uintptr_t)return_address(0));
 #endif
 
-  nodesize = mm_malloc_size(heap, ret);
-  heap->mm_curused += nodesize;
-  if (heap->mm_curused > heap->mm_maxused)
-    {
-      heap->mm_maxused = heap->mm_curused;
-    }
-
   if (ret)
     {
-      sched_note_heap(NOTE_HEAP_ALLOC, heap, ret, nodesize,
-                      heap->mm_curused);
-    }
-
-  mm_unlock(heap);
+      nodesize = mm_malloc_size(heap, ret);
+      UNUSED(nodesize);
 
-  if (ret)
-    {
 #if CONFIG_MM_BACKTRACE >= 0
-      FAR struct memdump_backtrace_s *buf = ret + nodesize;
-
-      memdump_backtrace(heap, buf);
+      memdump_backtrace(heap, ret + nodesize);
 #endif
 
       ret = kasan_unpoison(ret, nodesize);
@@ -1403,6 +1747,8 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
       ret = mempool_multiple_memalign(heap->mm_mpool, alignment, size);
       if (ret != NULL)
         {
+          sched_note_heap_align(NOTE_HEAP_ALLOC, heap, ret, size,
+                                mm_curused(heap), alignment);
           return ret;
         }
     }
@@ -1414,35 +1760,22 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   /* Allocate from the tlsf pool */
 
-  DEBUGVERIFY(mm_lock(heap));
 #if CONFIG_MM_BACKTRACE >= 0
-  ret = tlsf_memalign(heap->mm_tlsf, alignment, size +
-                      sizeof(struct memdump_backtrace_s));
+  ret = mm_subpool_alloc(heap, alignment, size +
+                         sizeof(struct memdump_backtrace_s),
+                         (uintptr_t)return_address(0));
 #else
-  ret = tlsf_memalign(heap->mm_tlsf, alignment, size);
+  ret = mm_subpool_alloc(heap, alignment, size,
+                         (uintptr_t)return_address(0));
 #endif
 
-  nodesize = mm_malloc_size(heap, ret);
-  heap->mm_curused += nodesize;
-  if (heap->mm_curused > heap->mm_maxused)
-    {
-      heap->mm_maxused = heap->mm_curused;
-    }
-
   if (ret)
     {
-      sched_note_heap(NOTE_HEAP_ALLOC, heap, ret, nodesize,
-                      heap->mm_curused);
-    }
-
-  mm_unlock(heap);
+      nodesize = mm_malloc_size(heap, ret);
+      UNUSED(nodesize);
 
-  if (ret)
-    {
 #if CONFIG_MM_BACKTRACE >= 0
-      FAR struct memdump_backtrace_s *buf = ret + nodesize;
-
-      memdump_backtrace(heap, buf);
+      memdump_backtrace(heap, ret + nodesize);
 #endif
       ret = kasan_unpoison(ret, nodesize);
     }
@@ -1487,6 +1820,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 {
   FAR void *newmem;
 #ifndef CONFIG_MM_KASAN
+  FAR struct mm_subpool_s *pool;
   size_t oldsize;
   size_t newsize;
 #endif
@@ -1513,6 +1847,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       newmem = mempool_multiple_realloc(heap->mm_mpool, oldmem, size);
       if (newmem != NULL)
         {
+          sched_note_heap(NOTE_HEAP_FREE, heap, oldmem, 0, mm_curused(heap));
+          sched_note_heap(NOTE_HEAP_ALLOC, heap, newmem, size,
+                          mm_curused(heap));
           return newmem;
         }
       else if (size <= heap->mm_threshold ||
@@ -1546,34 +1883,36 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
   free_delaylist(heap, false);
 
-  /* Allocate from the tlsf pool */
+  /* Reallocate in the tlsf pool owning the block */
 
-  DEBUGVERIFY(mm_lock(heap));
+  pool = mm_subpool_find(heap, oldmem);
+  DEBUGVERIFY(mm_lock(pool));
+  mm_subpool_drain(heap, pool);
   oldsize = mm_malloc_size(heap, oldmem);
-  heap->mm_curused -= oldsize;
+  pool->curused -= oldsize;
 #if CONFIG_MM_BACKTRACE >= 0
-  newmem = tlsf_realloc(heap->mm_tlsf, oldmem, size +
+  newmem = tlsf_realloc(pool->tlsf, oldmem, size +
                         sizeof(struct memdump_backtrace_s));
 #else
-  newmem = tlsf_realloc(heap->mm_tlsf, oldmem, size);
+  newmem = tlsf_realloc(pool->tlsf, oldmem, size);
 #endif
 
   newsize = mm_malloc_size(heap, newmem);
-  heap->mm_curused += newmem ? newsize : oldsize;
-  if (heap->mm_curused > heap->mm_maxused)
+  pool->curused += newmem ? newsize : oldsize;
+  if (pool->curused > pool->maxused)
     {
-      heap->mm_maxused = heap->mm_curused;
+      pool->maxused = pool->curused;
     }
 
   if (newmem)
     {
       sched_note_heap(NOTE_HEAP_FREE, heap, oldmem, oldsize,
-                      heap->mm_curused - newsize);
+                      mm_curused(heap) - newsize);
       sched_note_heap(NOTE_HEAP_ALLOC, heap, newmem, newsize,
-                      heap->mm_curused);
+                      mm_curused(heap));
     }
 
-  mm_unlock(heap);
+  mm_unlock(pool);
 
   if (newmem)
     {
@@ -1592,6 +1931,20 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
     }
 #endif
 
+#ifdef CONFIG_MM_TLSF_SUBPOOLS
+  /* The pool owning the block is exhausted, move it to another pool */
+
+  if (newmem == NULL)
+    {
+      newmem = mm_malloc(heap, size);
+      if (newmem != NULL)
+        {
+          memcpy(newmem, oldmem, MIN(size, oldsize));
+          mm_free(heap, oldmem);
+        }
+    }
+#endif
+
 #endif
   return newmem;
 }
@@ -1623,7 +1976,7 @@ void mm_uninitialize(FAR struct mm_heap_s *heap)
       kasan_unregister(heap->mm_heapstart[i]);
       sched_note_heap(NOTE_HEAP_REMOVE, heap, heap->mm_heapstart[i],
                       (uintptr_t)heap->mm_heapend[i] -
-                      (uintptr_t)heap->mm_heapstart[i], heap->mm_curused);
+                      (uintptr_t)heap->mm_heapstart[i], mm_curused(heap));
     }
 
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
@@ -1631,8 +1984,11 @@ void mm_uninitialize(FAR struct mm_heap_s *heap)
   procfs_unregister_meminfo(&heap->mm_procfs);
 #  endif
 #endif
-  nxmutex_destroy(&heap->mm_lock);
-  tlsf_destroy(&heap->mm_tlsf);
+  for (i = 0; i < MM_NSUBPOOLS; i++)
+    {
+      nxmutex_destroy(&heap->mm_subpool[i].lock);
+      tlsf_destroy(&heap->mm_subpool[i].tlsf);
+    }
 }
 
 /****************************************************************************
@@ -1665,9 +2021,28 @@ FAR void *mm_zalloc(FAR struct mm_heap_s *heap, size_t size)
 
 void mm_free_delaylist(FAR struct mm_heap_s *heap)
 {
+#ifdef MM_REMOTE_FREE
+  int i;
+#endif
+
   if (heap)
     {
-       free_delaylist(heap, true);
+      free_delaylist(heap, true);
+
+#ifdef MM_REMOTE_FREE
+      /* Also return the blocks queued by other CPUs to their pools */
+
+      for (i = 0; i < MM_NSUBPOOLS; i++)
+        {
+          FAR struct mm_subpool_s *pool = &heap->mm_subpool[i];
+
+          if (mm_lock(pool) == 0)
+            {
+              mm_subpool_drain(heap, pool);
+              mm_unlock(pool);
+            }
+        }
+#endif
     }
 }
 
@@ -1681,7 +2056,7 @@ void mm_free_delaylist(FAR struct mm_heap_s *heap)
 
 size_t mm_heapfree(FAR struct mm_heap_s *heap)
 {
-  return heap->mm_heapsize - heap->mm_curused;
+  return heap->mm_heapsize - mm_curused(heap);
 }
 
 /****************************************************************************
@@ -1696,3 +2071,34 @@ size_t mm_heapfree_largest(FAR struct mm_heap_s *heap)
 {
   return SIZE_MAX;
 }
+
+/****************************************************************************
+ * Name: mm_subpool_info
+ *
+ * Description:
+ *   Return the statistics of one pool of the heap.
+ *
+ * Input Parameters:
+ *   heap  - The heap
+ *   index - The pool, from 0 to CONFIG_SMP_NCPUS - 1
+ *   info  - The location to return the statistics
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_TLSF_SUBPOOLS
+void mm_subpool_info(FAR struct mm_heap_s *heap, int index,
+                     FAR struct mm_subpoolinfo_s *info)
+{
+  FAR struct mm_subpool_s *pool;
+
+  DEBUGASSERT(index >= 0 && index < MM_NSUBPOOLS);
+  pool = &heap->mm_subpool[index];
+
+  info->arena    = pool->heapsize;
+  info->uordblks = pool->curused;
+  info->usmblks  = pool->maxused;
+  info->nalloc   = pool->nalloc;
+  info->nsteal   = pool->nsteal;
+  info->nremote  = pool->nremote;
+}
+#endif
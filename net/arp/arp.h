@@ -518,6 +518,8 @@ void arp_hdr_update(FAR struct net_driver_s *dev, FAR uint16_t *pipaddr,
  *   snapshot  - Location to return the ARP table copy
  *   nentries  - The size of the user provided 'dest' in entries, each of
  *               size sizeof(struct arp_entry_s)
+ *   skip      - The number of entries to skip before the first one copied,
+ *               used to return a large table in several parts
  *
  * Returned Value:
  *   On success, the number of entries actually copied is returned.  Unused
@@ -530,9 +532,9 @@ void arp_hdr_update(FAR struct net_driver_s *dev, FAR uint16_t *pipaddr,
 
 #ifdef CONFIG_NETLINK_ROUTE
 unsigned int arp_snapshot(FAR struct arpreq *snapshot,
-                          unsigned int nentries);
+                          unsigned int nentries, unsigned int skip);
 #else
-#  define arp_snapshot(s,n) (0)
+#  define arp_snapshot(s,n,k) (0)
 #endif
 
 /****************************************************************************
@@ -625,7 +627,7 @@ void arp_acd_setup(FAR struct net_driver_s *dev);
 #  define arp_cleanup(d)
 #  define arp_update(d,i,m);
 #  define arp_hdr_update(d,i,m);
-#  define arp_snapshot(s,n) (0)
+#  define arp_snapshot(s,n,k) (0)
 #  define arp_dump(arp)
 
 #endif /* CONFIG_NET_ARP */
@@ -73,6 +73,13 @@
 
 #define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
 
+#ifdef CONFIG_NET_ARP_HASH
+/* The hash and LRU links hold the table index plus one, zero ends a list */
+
+#  define ARP_NDX(e)      ((uint16_t)((e) - g_arptable + 1))
+#  define ARP_ENTRY(n)    (&g_arptable[(n) - 1])
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -91,6 +98,21 @@ struct arp_table_info_s
 
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
 
+#ifdef CONFIG_NET_ARP_HASH
+/* The hash buckets of the ARP table, keyed by IPv4 address and device */
+
+static uint16_t g_arphead[CONFIG_NET_ARPTAB_SIZE];
+static uint16_t g_arpnext[CONFIG_NET_ARPTAB_SIZE];
+
+/* The entries ever used, from the most to the least recently updated */
+
+static uint16_t g_arpnewer[CONFIG_NET_ARPTAB_SIZE];
+static uint16_t g_arpolder[CONFIG_NET_ARPTAB_SIZE];
+static uint16_t g_arpnewest;
+static uint16_t g_arpoldest;
+static uint16_t g_arpnused;
+#endif
+
 static const struct ether_addr g_zero_ethaddr =
 {
   {
@@ -148,6 +170,7 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
   return 1;
 }
 
+#ifndef CONFIG_NET_ARP_HASH
 /****************************************************************************
  * Name: arp_return_old_entry
  *
@@ -176,6 +199,263 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
       return e2;
     }
 }
+#endif
+
+#ifdef CONFIG_NET_ARP_HASH
+/****************************************************************************
+ * Name: arp_hash
+ *
+ * Description:
+ *   Return the hash bucket of an IPv4 address on a device.
+ *
+ ****************************************************************************/
+
+static unsigned int arp_hash(in_addr_t ipaddr, FAR struct net_driver_s *dev)
+{
+  uint32_t hash = (uint32_t)ipaddr ^ (uint32_t)(uintptr_t)dev;
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+
+  return hash % CONFIG_NET_ARPTAB_SIZE;
+}
+
+/****************************************************************************
+ * Name: arp_hash_find
+ *
+ * Description:
+ *   Find the ARP table entry of an IPv4 address on a device through the
+ *   hash table.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_hash_find(in_addr_t ipaddr,
+                                             FAR struct net_driver_s *dev)
+{
+  uint16_t ndx;
+
+  for (ndx = g_arphead[arp_hash(ipaddr, dev)]; ndx != 0;
+       ndx = g_arpnext[ndx - 1])
+    {
+      FAR struct arp_entry_s *tabptr = ARP_ENTRY(ndx);
+
+      if (tabptr->at_dev == dev &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          return tabptr;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: arp_hash_remove
+ *
+ * Description:
+ *   Remove an ARP table entry from its hash bucket, if it is in one.
+ *
+ ****************************************************************************/
+
+static void arp_hash_remove(FAR struct arp_entry_s *tabptr)
+{
+  FAR uint16_t *link = &g_arphead[arp_hash(tabptr->at_ipaddr,
+                                           tabptr->at_dev)];
+  uint16_t ndx = ARP_NDX(tabptr);
+
+  for (; *link != 0; link = &g_arpnext[*link - 1])
+    {
+      if (*link == ndx)
+        {
+          *link = g_arpnext[ndx - 1];
+          g_arpnext[ndx - 1] = 0;
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: arp_lru_unlink
+ *
+ * Description:
+ *   Remove an ARP table entry from the LRU list.
+ *
+ ****************************************************************************/
+
+static void arp_lru_unlink(uint16_t ndx)
+{
+  uint16_t newer = g_arpnewer[ndx - 1];
+  uint16_t older = g_arpolder[ndx - 1];
+
+  if (newer != 0)
+    {
+      g_arpolder[newer - 1] = older;
+    }
+  else
+    {
+      g_arpnewest = older;
+    }
+
+  if (older != 0)
+    {
+      g_arpnewer[older - 1] = newer;
+    }
+  else
+    {
+      g_arpoldest = newer;
+    }
+}
+
+/****************************************************************************
+ * Name: arp_hash_touch
+ *
+ * Description:
+ *   Make an updated ARP table entry the most recently used one and add it
+ *   to its hash bucket if it is new.
+ *
+ ****************************************************************************/
+
+static void arp_hash_touch(FAR struct arp_entry_s *tabptr, bool found)
+{
+  uint16_t ndx = ARP_NDX(tabptr);
+
+  if (!found)
+    {
+      unsigned int hash = arp_hash(tabptr->at_ipaddr, tabptr->at_dev);
+
+      g_arpnext[ndx - 1] = g_arphead[hash];
+      g_arphead[hash]    = ndx;
+    }
+
+  if (g_arpnewest == ndx)
+    {
+      return;
+    }
+
+  /* A new entry is not in the LRU list yet */
+
+  if (g_arpnewer[ndx - 1] != 0 || g_arpolder[ndx - 1] != 0)
+    {
+      arp_lru_unlink(ndx);
+    }
+
+  g_arpnewer[ndx - 1] = 0;
+  g_arpolder[ndx - 1] = g_arpnewest;
+  if (g_arpnewest != 0)
+    {
+      g_arpnewer[g_arpnewest - 1] = ndx;
+    }
+  else
+    {
+      g_arpoldest = ndx;
+    }
+
+  g_arpnewest = ndx;
+}
+
+/****************************************************************************
+ * Name: arp_hash_release
+ *
+ * Description:
+ *   Remove a deleted ARP table entry from its hash bucket and make it the
+ *   first one to be reused.
+ *
+ ****************************************************************************/
+
+static void arp_hash_release(FAR struct arp_entry_s *tabptr)
+{
+  uint16_t ndx = ARP_NDX(tabptr);
+
+  arp_hash_remove(tabptr);
+
+  if (g_arpoldest == ndx)
+    {
+      return;
+    }
+
+  arp_lru_unlink(ndx);
+
+  g_arpolder[ndx - 1] = 0;
+  g_arpnewer[ndx - 1] = g_arpoldest;
+  g_arpolder[g_arpoldest - 1] = ndx;
+  g_arpoldest = ndx;
+}
+#endif /* CONFIG_NET_ARP_HASH */
+
+/****************************************************************************
+ * Name: arp_get_entry
+ *
+ * Description:
+ *   Return the ARP table entry of an IPv4 address on a device, or the entry
+ *   to replace with it if it is not in the table: an unused entry or the
+ *   one updated least recently.
+ *
+ * Assumptions:
+ *   The network is locked to assure exclusive access to the ARP table.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_get_entry(FAR struct net_driver_s *dev,
+                                             in_addr_t ipaddr,
+                                             FAR bool *found)
+{
+  FAR struct arp_entry_s *tabptr;
+#ifndef CONFIG_NET_ARP_HASH
+  int i;
+#endif
+
+  *found = false;
+
+#ifdef CONFIG_NET_ARP_HASH
+  tabptr = arp_hash_find(ipaddr, dev);
+  if (tabptr != NULL)
+    {
+      *found = true;
+    }
+  else if (g_arpnused < CONFIG_NET_ARPTAB_SIZE)
+    {
+      tabptr = &g_arptable[g_arpnused++];
+    }
+  else
+    {
+      tabptr = ARP_ENTRY(g_arpoldest);
+      arp_hash_remove(tabptr);
+    }
+#else
+  /* Walk through the ARP mapping table and try to find an entry to
+   * update. If none is found, the IP -> MAC address mapping is
+   * inserted in the ARP table.
+   */
+
+  tabptr = &g_arptable[0];
+  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+    {
+      /* Check if the source IP address of the incoming packet matches
+       * the IP address in this ARP table entry.
+       */
+
+      if (g_arptable[i].at_dev == dev &&
+          g_arptable[i].at_ipaddr != 0 &&
+          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
+        {
+          /* An old entry found, break. */
+
+          tabptr = &g_arptable[i];
+          *found = true;
+          break;
+        }
+      else
+        {
+          /* Record the oldest entry. */
+
+          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
+        }
+    }
+#endif
+
+  return tabptr;
+}
 
 /****************************************************************************
  * Name: arp_lookup
@@ -197,10 +477,20 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
                                           FAR struct net_driver_s *dev)
 {
   FAR struct arp_entry_s *tabptr;
+#ifndef CONFIG_NET_ARP_HASH
   int i;
+#endif
 
   /* Check if the IPv4 address is already in the ARP table. */
 
+#ifdef CONFIG_NET_ARP_HASH
+  tabptr = arp_hash_find(ipaddr, dev);
+  if (tabptr != NULL &&
+      clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
+    {
+      return tabptr;
+    }
+#else
   for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
       tabptr = &g_arptable[i];
@@ -211,6 +501,7 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
           return tabptr;
         }
     }
+#endif
 
   /* Not found */
 
@@ -276,44 +567,18 @@ static void arp_get_arpreq(FAR struct arpreq *output,
 int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                FAR const uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
+  FAR struct arp_entry_s *tabptr;
 #ifdef CONFIG_NETLINK_ROUTE
   struct arpreq arp_notify;
-  bool found = false;
   bool new_entry;
 #endif
-  int i;
+  bool found;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Find the entry to update.  If there is none, the IP -> MAC address
+   * mapping is inserted in the ARP table.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
-    {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
-
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
-        {
-          /* An old entry found, break. */
-
-          tabptr = &g_arptable[i];
-#ifdef CONFIG_NETLINK_ROUTE
-          found = true;
-#endif
-          break;
-        }
-      else
-        {
-          /* Record the oldest entry. */
-
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
-        }
-    }
+  tabptr = arp_get_entry(dev, ipaddr, &found);
 
   if (ethaddr == NULL)
     {
@@ -344,6 +609,12 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
   tabptr->at_dev = dev;
   tabptr->at_time = clock_systime_ticks();
 
+#ifdef CONFIG_NET_ARP_HASH
+  arp_hash_touch(tabptr, found);
+#else
+  UNUSED(found);
+#endif
+
   /* Notify the new entry */
 
 #ifdef CONFIG_NETLINK_ROUTE
@@ -498,6 +769,9 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
 
       /* Yes.. Set the IP address to zero to "delete" it */
 
+#ifdef CONFIG_NET_ARP_HASH
+      arp_hash_release(tabptr);
+#endif
       tabptr->at_ipaddr = 0;
       return OK;
     }
@@ -527,6 +801,9 @@ void arp_cleanup(FAR struct net_driver_s *dev)
     {
       if (dev == g_arptable[i].at_dev)
         {
+#ifdef CONFIG_NET_ARP_HASH
+          arp_hash_release(&g_arptable[i]);
+#endif
           memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
         }
     }
@@ -542,6 +819,8 @@ void arp_cleanup(FAR struct net_driver_s *dev)
  *   snapshot  - Location to return the ARP table copy
  *   nentries  - The size of the user provided 'dest' in entries, each of
  *               size sizeof(struct arp_entry_s)
+ *   skip      - The number of entries to skip before the first one copied,
+ *               used to return a large table in several parts
  *
  * Returned Value:
  *   On success, the number of entries actually copied is returned.  Unused
@@ -554,7 +833,7 @@ void arp_cleanup(FAR struct net_driver_s *dev)
 
 #ifdef CONFIG_NETLINK_ROUTE
 unsigned int arp_snapshot(FAR struct arpreq *snapshot,
-                          unsigned int nentries)
+                          unsigned int nentries, unsigned int skip)
 {
   FAR struct arp_entry_s *tabptr;
   clock_t now;
@@ -571,6 +850,12 @@ unsigned int arp_snapshot(FAR struct arpreq *snapshot,
       if (tabptr->at_ipaddr != 0 &&
           now - tabptr->at_time <= ARP_MAXAGE_TICK)
         {
+          if (skip > 0)
+            {
+              skip--;
+              continue;
+            }
+
           arp_get_arpreq(&snapshot[ncopied], tabptr);
           ncopied++;
         }
@@ -46,6 +46,8 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <string.h>
+
 #include <nuttx/net/netstats.h>
 
 #include "devif/devif.h"
@@ -61,13 +63,55 @@
 /* IP/TCP/UDP/ICMP statistics for all network interfaces */
 
 #ifdef CONFIG_NET_STATISTICS
+#  ifdef CONFIG_NET_STATISTICS_PERCPU
+struct net_stats_cpu_s g_netstats_cpu[CONFIG_SMP_NCPUS];
+#  else
 struct net_stats_s g_netstats;
+#  endif
 #endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: net_stats_get
+ *
+ * Description:
+ *   Return the network layer statistics summed up over all CPUs.
+ *
+ * Input Parameters:
+ *   stats - The location to return the statistics in
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_STATISTICS
+void net_stats_get(FAR struct net_stats_s *stats)
+{
+#ifdef CONFIG_NET_STATISTICS_PERCPU
+  FAR net_stats_t *sum = (FAR net_stats_t *)stats;
+  int cpu;
+  int i;
+
+  /* All the statistics are net_stats_t counters */
+
+  memset(stats, 0, sizeof(*stats));
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      FAR const net_stats_t *count =
+        (FAR const net_stats_t *)&g_netstats_cpu[cpu].stats;
+
+      for (i = 0; i < sizeof(*stats) / sizeof(net_stats_t); i++)
+        {
+          sum[i] += count[i];
+        }
+    }
+#else
+  memcpy(stats, &g_netstats, sizeof(*stats));
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: devif_initialize
  *
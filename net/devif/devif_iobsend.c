@@ -59,6 +59,9 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
                    unsigned int len, unsigned int offset,
                    unsigned int target_offset)
 {
+#ifdef CONFIG_NET_CHKSUM_COPY
+  uint16_t sum;
+#endif
   int ret;
 
   if (dev == NULL)
@@ -91,8 +94,20 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
 
   /* Clone the iob to target device buffer */
 
-  ret = iob_clone_partial(iob, len, offset, dev->d_iob,
-                          target_offset, false, false);
+#ifdef CONFIG_NET_CHKSUM_COPY
+  if (!NETDEV_TXCSUM(dev))
+    {
+      sum = 0;
+      ret = iob_clone_partial_chksum(iob, len, offset, dev->d_iob,
+                                     target_offset, false, false, &sum);
+    }
+  else
+#endif
+    {
+      ret = iob_clone_partial(iob, len, offset, dev->d_iob,
+                              target_offset, false, false);
+    }
+
   if (ret != OK)
     {
       netdev_iob_release(dev);
@@ -101,6 +116,13 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
 
   dev->d_sndlen = len;
 
+#ifdef CONFIG_NET_CHKSUM_COPY
+  if (!NETDEV_TXCSUM(dev))
+    {
+      NETDEV_SNDSUM_SET(dev, sum, len);
+    }
+#endif
+
 #ifdef CONFIG_NET_TCP_WRBUFFER_DUMP
   /* Dump the outgoing device buffer */
 
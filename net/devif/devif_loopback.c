@@ -98,8 +98,12 @@ int devif_loopback(FAR struct net_driver_s *dev)
 
   /* Loop while if there is data "sent" to ourself.
    * Sending, of course, just means relaying back through the network.
+   * The checksums of such packets may have been left for the hardware,
+   * there is no need to verify them.
    */
 
+  NETDEV_RXCSUM_SET(dev, true);
+
   do
     {
        NETDEV_TXPACKETS(dev);
@@ -143,5 +147,6 @@ int devif_loopback(FAR struct net_driver_s *dev)
     }
   while (dev->d_len > 0);
 
+  NETDEV_RXCSUM_SET(dev, false);
   return 1;
 }
@@ -494,18 +494,34 @@ static inline int devif_poll_icmpv6(FAR struct net_driver_s *dev,
 static inline int devif_poll_forward(FAR struct net_driver_s *dev,
                                      devif_poll_callback_t callback)
 {
-  /* Perform the forwarding poll */
-
-  ipfwd_poll(dev);
+  int bstop = 0;
 
-  /* NOTE: that 6LoWPAN packet conversions are handled differently for
-   * forwarded packets.  That is because we don't know what the packet
-   * type is at this point; not within peeking into the device's d_buf.
+  /* Hand all of the queued packets to the driver in one poll as long as it
+   * accepts more, instead of one packet per poll.  The IOB chain of each
+   * packet is just moved to the device, nothing is copied.
    */
 
-  /* Call back into the driver */
+  while (!bstop)
+    {
+      /* Perform the forwarding poll */
 
-  return devif_poll_out(dev, callback);
+      ipfwd_poll(dev);
+      if (dev->d_len == 0)
+        {
+          break;
+        }
+
+      /* NOTE: that 6LoWPAN packet conversions are handled differently for
+       * forwarded packets.  That is because we don't know what the packet
+       * type is at this point; not within peeking into the device's d_buf.
+       */
+
+      /* Call back into the driver */
+
+      bstop = devif_poll_out(dev, callback);
+    }
+
+  return bstop;
 }
 #endif /* CONFIG_NET_ICMPv6_SOCKET || CONFIG_NET_ICMPv6_NEIGHBOR*/
 
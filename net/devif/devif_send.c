@@ -71,6 +71,9 @@
 int devif_send(FAR struct net_driver_s *dev, FAR const void *buf,
                int len, int offset)
 {
+#ifdef CONFIG_NET_CHKSUM_COPY
+  uint16_t sum;
+#endif
   int ret;
 
   if (dev == NULL)
@@ -106,7 +109,22 @@ int devif_send(FAR struct net_driver_s *dev, FAR const void *buf,
 
   iob_update_pktlen(dev->d_iob, offset < 0 ? 0 : offset, false);
 
-  ret = iob_trycopyin(dev->d_iob, buf, len, offset, false);
+#ifdef CONFIG_NET_CHKSUM_COPY
+  /* Sum the payload while it is copied, unless the device computes the
+   * transport checksum itself.
+   */
+
+  if (!NETDEV_TXCSUM(dev))
+    {
+      sum = 0;
+      ret = iob_trycopyin_chksum(dev->d_iob, buf, len, offset, false, &sum);
+    }
+  else
+#endif
+    {
+      ret = iob_trycopyin(dev->d_iob, buf, len, offset, false);
+    }
+
   if (ret != len)
     {
       netdev_iob_release(dev);
@@ -115,6 +133,13 @@ int devif_send(FAR struct net_driver_s *dev, FAR const void *buf,
 
   dev->d_sndlen = len;
 
+#ifdef CONFIG_NET_CHKSUM_COPY
+  if (!NETDEV_TXCSUM(dev))
+    {
+      NETDEV_SNDSUM_SET(dev, sum, len);
+    }
+#endif
+
   return dev->d_sndlen;
 
 errout:
@@ -509,6 +509,10 @@ int ipv4_input(FAR struct net_driver_s *dev)
   clock_gettime(CLOCK_REALTIME, &dev->d_rxtime);
 #endif
 
+  /* A received packet never carries the sum of copied send data */
+
+  NETDEV_SNDSUM_CLEAR(dev);
+
   if (dev->d_iob != NULL)
     {
       buf = dev->d_buf;
@@ -114,6 +114,19 @@ static ssize_t    inet_sendfile(FAR struct socket *psock,
                                 FAR struct file *infile, FAR off_t *offset,
                                 size_t count);
 #endif
+static int        inet_sendmmsg(FAR struct socket *psock,
+                                FAR struct mmsghdr *msgvec,
+                                unsigned int vlen, int flags);
+static int        inet_recvmmsg(FAR struct socket *psock,
+                                FAR struct mmsghdr *msgvec,
+                                unsigned int vlen, int flags,
+                                FAR struct timespec *timeout);
+#ifdef CONFIG_NET_RECVIOB
+static ssize_t    inet_recviob(FAR struct socket *psock,
+                               FAR struct iob_s **iob, int flags,
+                               FAR struct sockaddr *from,
+                               FAR socklen_t *fromlen);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -143,6 +156,11 @@ static const struct sock_intf_s g_inet_sockif =
 #endif
 #ifdef CONFIG_NET_SENDFILE
   , inet_sendfile   /* si_sendfile */
+#endif
+  , inet_sendmmsg   /* si_sendmmsg */
+  , inet_recvmmsg   /* si_recvmmsg */
+#ifdef CONFIG_NET_RECVIOB
+  , inet_recviob    /* si_recviob */
 #endif
 };
 
@@ -779,6 +797,27 @@ static int inet_get_socketlevel_option(FAR struct socket *psock, int option,
         break;
 #endif
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+      case SO_ZEROCOPY:
+        {
+          if (*value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          if (psock->s_type == SOCK_STREAM)
+            {
+              FAR struct tcp_conn_s *conn = psock->s_conn;
+              *(FAR int *)value = conn->zerocopy;
+            }
+          else
+            {
+              return -ENOPROTOOPT;
+            }
+        }
+        break;
+#endif
+
       default:
         return -ENOPROTOOPT;
     }
@@ -826,6 +865,11 @@ static int inet_getsockopt(FAR struct socket *psock, int level, int option,
         return tcp_getsockopt(psock, option, value, value_len);
 #endif
 
+#ifdef CONFIG_NET_UDPPROTO_OPTIONS
+      case IPPROTO_UDP:/* UDP protocol socket options (see include/netinet/udp.h) */
+        return udp_getsockopt(psock, option, value, value_len);
+#endif
+
 #ifdef CONFIG_NET_IPv4
       case IPPROTO_IP:/* IPv4 protocol socket options (see include/netinet/in.h) */
         return ipv4_getsockopt(psock, option, value, value_len);
@@ -975,6 +1019,13 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
               /* Save the receive buffer size */
 
               tcp->rcv_bufs = buffersize;
+
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+              /* The application knows better, stop auto-tuning */
+
+              tcp_rcvbuf_release(tcp);
+              tcp->flags |= TCP_RCVBUF_LOCK;
+#endif
             }
           else
 #endif
@@ -1090,6 +1141,30 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
         break;
   #endif
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+      case SO_ZEROCOPY: /* Allow MSG_ZEROCOPY sends */
+        {
+          if (value_len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          if (psock->s_type == SOCK_STREAM)
+            {
+              FAR struct tcp_conn_s *conn = psock->s_conn;
+
+              net_lock();
+              conn->zerocopy = (*((FAR int *)value) != 0);
+              net_unlock();
+            }
+          else
+            {
+              return -ENOPROTOOPT;
+            }
+        }
+        break;
+#endif
+
       default:
         return -ENOPROTOOPT;
     }
@@ -1137,6 +1212,16 @@ static int inet_setsockopt(FAR struct socket *psock, int level, int option,
         return udp_setsockopt(psock, option, value, value_len);
 #endif
 
+#ifdef CONFIG_NET_TCP_TLS
+      case SOL_TLS:    /* Kernel TLS socket options (see include/netinet/tls.h) */
+        if (psock->s_type != SOCK_STREAM)
+          {
+            return -ENOPROTOOPT;
+          }
+
+        return tcp_tls_setsockopt(psock, option, value, value_len);
+#endif
+
 #ifdef CONFIG_NET_IPv4
       case IPPROTO_IP:/* IPv4 protocol socket options (see include/netinet/in.h) */
         return ipv4_setsockopt(psock, option, value, value_len);
@@ -1410,6 +1495,7 @@ static int inet_connect(FAR struct socket *psock,
               conn->flags |= _UDP_FLAG_CONNECTMODE;
             }
 
+          udp_demux_invalidate();
           return ret;
         }
 #endif /* CONFIG_NET_UDP */
@@ -1751,6 +1837,16 @@ static ssize_t inet_send(FAR struct socket *psock, FAR const void *buf,
 #ifdef CONFIG_NET_TCP
       case SOCK_STREAM:
         {
+#ifdef CONFIG_NET_TCP_TLS
+          /* Frame and encrypt the data of a kernel TLS connection */
+
+          if (((FAR struct tcp_conn_s *)psock->s_conn)->tls != NULL)
+            {
+              ret = tcp_tls_send(psock, buf, len, flags);
+              break;
+            }
+#endif
+
 #ifdef CONFIG_NET_6LOWPAN
           /* Try 6LoWPAN TCP packet send */
 
@@ -2232,6 +2328,17 @@ static ssize_t inet_sendfile(FAR struct socket *psock,
 #ifdef NET_TCP_HAVE_STACK
   if (psock->s_type == SOCK_STREAM)
     {
+#ifdef CONFIG_NET_TCP_TLS
+      /* The file data of a kernel TLS connection has to be encrypted, the
+       * generic sendfile() reads it and sends it through inet_send().
+       */
+
+      if (((FAR struct tcp_conn_s *)psock->s_conn)->tls != NULL)
+        {
+          return -ENOSYS;
+        }
+#endif
+
       return tcp_sendfile(psock, infile, offset, count);
     }
 #endif
@@ -2240,6 +2347,100 @@ static ssize_t inet_sendfile(FAR struct socket *psock,
 }
 #endif
 
+/****************************************************************************
+ * Name: inet_sendmmsg
+ *
+ * Description:
+ *   Implements the sendmmsg() operation for the case of the AF_INET and
+ *   AF_INET6 sockets.  Buffered UDP sends the leading messages that have a
+ *   single I/O vector and a usable destination as one batch.  -ENOSYS lets
+ *   psock_sendmmsg() send the messages one at a time otherwise.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msgvec   The messages to send, msg_len is set to the bytes sent
+ *   vlen     The number of messages in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent.  If no message was sent, a negated errno
+ *   value is returned (see sendmsg() for the list of appropriate error
+ *   values).
+ *
+ ****************************************************************************/
+
+static int inet_sendmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec,
+                         unsigned int vlen, int flags)
+{
+#if defined(NET_UDP_HAVE_STACK) && defined(CONFIG_NET_UDP_WRITE_BUFFERS) && \
+    !defined(CONFIG_NET_6LOWPAN)
+  FAR struct socket_conn_s *conn = psock->s_conn;
+  FAR struct msghdr *msg;
+  socklen_t minlen;
+  unsigned int n;
+
+  if (psock->s_type != SOCK_DGRAM)
+    {
+      return -ENOSYS;
+    }
+
+  /* Batch the messages that inet_sendmsg() would pass straight to
+   * psock_udp_sendto(), the first other one is left to psock_sendmsg().
+   */
+
+  for (n = 0; n < vlen; n++)
+    {
+      msg = &msgvec[n].msg_hdr;
+      if (msg->msg_iovlen != 1)
+        {
+          break;
+        }
+
+      if (msg->msg_name == NULL)
+        {
+          if (!_SS_ISCONNECTED(conn->s_flags))
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      switch (((FAR const struct sockaddr *)msg->msg_name)->sa_family)
+        {
+#ifdef CONFIG_NET_IPv4
+        case AF_INET:
+          minlen = sizeof(struct sockaddr_in);
+          break;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+        case AF_INET6:
+          minlen = sizeof(struct sockaddr_in6);
+          break;
+#endif
+
+        default:
+          minlen = 0;
+          break;
+        }
+
+      if (minlen == 0 || msg->msg_namelen < minlen)
+        {
+          break;
+        }
+    }
+
+  if (n > 0)
+    {
+      return psock_udp_sendmmsg(psock, msgvec, n, flags);
+    }
+#endif
+
+  return -ENOSYS;
+}
+
 /****************************************************************************
  * Name: inet_recvmsg
  *
@@ -2321,7 +2522,16 @@ static ssize_t inet_recvmsg(FAR struct socket *psock,
 #ifdef CONFIG_NET_TCP
     case SOCK_STREAM:
       {
-#ifdef NET_TCP_HAVE_STACK
+#if defined(CONFIG_NET_TCP_ZEROCOPY)
+        if ((flags & MSG_ERRQUEUE) != 0)
+          {
+            ret = tcp_zerocopy_recverr(psock, msg);
+          }
+        else
+          {
+            ret = psock_tcp_recvfrom(psock, msg, flags);
+          }
+#elif defined(NET_TCP_HAVE_STACK)
         ret = psock_tcp_recvfrom(psock, msg, flags);
 #else
         ret = -ENOSYS;
@@ -2362,6 +2572,113 @@ static ssize_t inet_recvmsg(FAR struct socket *psock,
   return ret;
 }
 
+/****************************************************************************
+ * Name: inet_recvmmsg
+ *
+ * Description:
+ *   Implements the recvmmsg() operation for the case of the AF_INET and
+ *   AF_INET6 sockets.  UDP receives the whole batch under one acquisition
+ *   of the network lock.  -ENOSYS lets psock_recvmmsg() receive the
+ *   messages one at a time otherwise.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msgvec   The messages to receive, msg_len is set to the bytes received
+ *   vlen     The number of messages in msgvec
+ *   flags    Receive flags
+ *   timeout  The time after which no further message is received or NULL
+ *
+ * Returned Value:
+ *   The number of messages received.  If no message was received, a
+ *   negated errno value is returned (see recvmsg() for the list of
+ *   appropriate error values).
+ *
+ ****************************************************************************/
+
+static int inet_recvmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec,
+                         unsigned int vlen, int flags,
+                         FAR struct timespec *timeout)
+{
+#ifdef NET_UDP_HAVE_STACK
+  FAR struct msghdr *msg;
+  unsigned int n;
+
+  if (psock->s_type != SOCK_DGRAM)
+    {
+      return -ENOSYS;
+    }
+
+  /* The source address buffers must be checked like inet_recvmsg() does,
+   * leave the first message that fails it to psock_recvmsg().
+   */
+
+  for (n = 0; n < vlen; n++)
+    {
+      msg = &msgvec[n].msg_hdr;
+      if (msg->msg_name != NULL &&
+          msg->msg_namelen < (psock->s_domain == PF_INET6 ?
+                              sizeof(struct sockaddr_in6) :
+                              sizeof(struct sockaddr_in)))
+        {
+          break;
+        }
+    }
+
+  if (n > 0)
+    {
+      return psock_udp_recvmmsg(psock, msgvec, n, flags, timeout);
+    }
+#endif
+
+  return -ENOSYS;
+}
+
+/****************************************************************************
+ * Name: inet_recviob
+ *
+ * Description:
+ *   Implements psock_recviob() for the case of the AF_INET and AF_INET6
+ *   sockets.  TCP hands over all of the buffered data, UDP the next
+ *   datagram.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   iob      The location to return the I/O buffer chain in
+ *   flags    Receive flags
+ *   from     Address of source of a datagram (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   The number of bytes in the I/O buffer chain, -EAGAIN if nothing is
+ *   buffered.  Otherwise a negated errno value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECVIOB
+static ssize_t inet_recviob(FAR struct socket *psock,
+                            FAR struct iob_s **iob, int flags,
+                            FAR struct sockaddr *from,
+                            FAR socklen_t *fromlen)
+{
+  switch (psock->s_type)
+    {
+#ifdef NET_TCP_HAVE_STACK
+      case SOCK_STREAM:
+        return psock_tcp_recviob(psock, iob, flags);
+#endif
+
+#ifdef NET_UDP_HAVE_STACK
+      case SOCK_DGRAM:
+        return psock_udp_recviob(psock, iob, flags, from, fromlen);
+#endif
+
+      default:
+        return -EOPNOTSUPP;
+    }
+}
+#endif
+
 #endif /* NET_UDP_HAVE_STACK || NET_TCP_HAVE_STACK */
 
 /****************************************************************************
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
@@ -188,6 +189,58 @@ static bool ipfilter_match_proto(FAR const struct ipfilter_entry_s *entry,
     }
 }
 
+/****************************************************************************
+ * Name: ipfilter_flow_key
+ *
+ * Description:
+ *   Fill in the fields of a flow key that do not depend on the IP version.
+ *   Only the parts of the L4 header that a rule can match on are used, the
+ *   ports of TCP and UDP and the ICMP type.
+ *
+ * Input Parameters:
+ *   key    - The flow key to fill in, zeroed by the caller
+ *   indev  - The network device that the packet comes from
+ *   outdev - The network device that the packet goes to
+ *   l4hdr  - The L4 header
+ *   proto  - The L4 protocol
+ *   chain  - The chain to match the filter entries
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_FLOWCACHE
+static void ipfilter_flow_key(FAR struct ipfilter_flow_s *key,
+                              FAR const struct net_driver_s *indev,
+                              FAR const struct net_driver_s *outdev,
+                              FAR const void *l4hdr, uint8_t proto,
+                              enum ipfilter_chain_e chain)
+{
+  key->indev  = indev;
+  key->outdev = outdev;
+  key->proto  = proto;
+  key->chain  = chain;
+
+  switch (proto)
+    {
+      case IP_PROTO_TCP:
+      case IP_PROTO_UDP:
+        {
+          FAR const struct udp_hdr_s *udp = l4hdr;
+          key->sport = NTOHS(udp->srcport);
+          key->dport = NTOHS(udp->destport);
+        }
+        break;
+
+      case IP_PROTO_ICMP:
+      case IP_PROTO_ICMP6:
+        key->sport = *(FAR const uint8_t *)l4hdr;
+        break;
+
+      default:
+        break;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: ipv4_filter_match / ipv6_filter_match
  *
@@ -219,6 +272,10 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
   FAR const void *l4hdr;
   in_addr_t ipaddr;
   bool matched;
+  int target;
+#ifdef CONFIG_NET_IPFILTER_FLOWCACHE
+  struct ipfilter_flow_s key;
+#endif
 
   /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
@@ -229,6 +286,24 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
 
   l4hdr = IPv4_L4HDR(ipv4);
 
+#ifdef CONFIG_NET_IPFILTER_FLOWCACHE
+  /* The rules only look at the flow, so a flow that was seen recently gets
+   * the same verdict as before.
+   */
+
+  memset(&key, 0, sizeof(key));
+  ipfilter_flow_key(&key, indev, outdev, l4hdr, ipv4->proto, chain);
+  key.domain = PF_INET;
+  net_ipv4addr_hdrcopy(&key.src.ipv4, ipv4->srcipaddr);
+  net_ipv4addr_hdrcopy(&key.dst.ipv4, ipv4->destipaddr);
+
+  target = ipfilter_flow_lookup(&key);
+  if (target != IPFILTER_FLOW_MISS)
+    {
+      return target;
+    }
+#endif
+
   sq_for_every(queue, entry)
     {
       filter = (FAR struct ipv4_filter_entry_s *)entry;
@@ -265,15 +340,27 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
           continue;
         }
 
-      /* Return the target action if matched. */
+      /* Take the target action if matched. */
 
-      return filter->common.target;
+      target = filter->common.target;
+      break;
     }
 
-  /* Normally there should be a default rule in chain, won't reach here. */
+  if (entry == NULL)
+    {
+      /* Normally there should be a default rule in chain, won't reach
+       * here.
+       */
+
+      ninfo("No filter matched, maybe uninitialized.\n");
+      target = IPFILTER_TARGET_ACCEPT;
+    }
 
-  ninfo("No filter matched, maybe uninitialized.\n");
-  return IPFILTER_TARGET_ACCEPT;
+#ifdef CONFIG_NET_IPFILTER_FLOWCACHE
+  ipfilter_flow_add(&key, target);
+#endif
+
+  return target;
 }
 #endif
 
@@ -289,6 +376,10 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
   FAR const void *l4hdr;
   uint8_t proto;
   bool matched;
+  int target;
+#ifdef CONFIG_NET_IPFILTER_FLOWCACHE
+  struct ipfilter_flow_s key;
+#endif
 
   /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
@@ -299,6 +390,20 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
 
   l4hdr = IPv6_L4HDR(ipv6, proto);
 
+#ifdef CONFIG_NET_IPFILTER_FLOWCACHE
+  memset(&key, 0, sizeof(key));
+  ipfilter_flow_key(&key, indev, outdev, l4hdr, proto, chain);
+  key.domain = PF_INET6;
+  net_ipv6addr_copy(key.src.ipv6, ipv6->srcipaddr);
+  net_ipv6addr_copy(key.dst.ipv6, ipv6->destipaddr);
+
+  target = ipfilter_flow_lookup(&key);
+  if (target != IPFILTER_FLOW_MISS)
+    {
+      return target;
+    }
+#endif
+
   sq_for_every(queue, entry)
     {
       filter = (FAR struct ipv6_filter_entry_s *)entry;
@@ -335,15 +440,27 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
           continue;
         }
 
-      /* Return the target action if matched. */
+      /* Take the target action if matched. */
 
-      return filter->common.target;
+      target = filter->common.target;
+      break;
     }
 
-  /* Normally there should be a default rule in chain, won't reach here. */
+  if (entry == NULL)
+    {
+      /* Normally there should be a default rule in chain, won't reach
+       * here.
+       */
+
+      ninfo("No filter matched, maybe uninitialized.\n");
+      target = IPFILTER_TARGET_ACCEPT;
+    }
 
-  ninfo("No filter matched, maybe uninitialized.\n");
-  return IPFILTER_TARGET_ACCEPT;
+#ifdef CONFIG_NET_IPFILTER_FLOWCACHE
+  ipfilter_flow_add(&key, target);
+#endif
+
+  return target;
 }
 #endif
 
@@ -420,6 +537,10 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
       sq_addlast((FAR sq_entry_t *)entry, &g_ipv6_filters[chain]);
     }
 #endif
+
+#ifdef CONFIG_NET_IPFILTER_FLOWCACHE
+  ipfilter_flow_flush();
+#endif
 }
 
 /****************************************************************************
@@ -461,6 +582,10 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
         }
     }
 #endif
+
+#ifdef CONFIG_NET_IPFILTER_FLOWCACHE
+  ipfilter_flow_flush();
+#endif
 }
 
 /****************************************************************************
@@ -31,6 +31,7 @@
 
 #include <stdint.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/compiler.h>
 #include <nuttx/net/ip.h>
 
@@ -44,6 +45,10 @@
 #define IPFILTER_TARGET_DROP   (-1)
 #define IPFILTER_TARGET_REJECT (-2)
 
+/* Returned by ipfilter_flow_lookup() if the flow is not cached */
+
+#define IPFILTER_FLOW_MISS     (1)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -123,6 +128,29 @@ struct ipv6_filter_entry_s
   net_ipv6addr_t dmsk;
 };
 
+#ifdef CONFIG_NET_IPFILTER_FLOWCACHE
+/* A flow in the flow cache, all that the filter rules can match on */
+
+struct ipfilter_flow_s
+{
+  FAR const struct net_driver_s *indev;
+  FAR const struct net_driver_s *outdev;
+
+  union ip_addr_u src; /* Addresses in network byte order */
+  union ip_addr_u dst;
+  uint16_t sport;      /* Source port or ICMP type, in host byte order */
+  uint16_t dport;      /* Destination port, in host byte order */
+  uint8_t  domain;     /* PF_INET or PF_INET6 */
+  uint8_t  proto;      /* L4 protocol */
+  uint8_t  chain;      /* enum ipfilter_chain_e */
+  int8_t   target;     /* The cached verdict */
+
+  uint32_t gen;        /* Rule set generation, zero if unused */
+  uint32_t hits;       /* Packets that used the cached verdict */
+  clock_t  stamp;      /* The time the flow was last used */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -264,5 +292,84 @@ int ipv6_filter_fwd(FAR struct net_driver_s *indev,
                     FAR struct ipv6_hdr_s *ipv6);
 #endif
 
+/****************************************************************************
+ * Name: ipfilter_flow_lookup
+ *
+ * Description:
+ *   Look up the verdict of a flow in the flow cache.
+ *
+ * Input Parameters:
+ *   key - The flow, with all the fields up to target set and the unused
+ *         bytes of the addresses zeroed
+ *
+ * Returned Value:
+ *   The cached IPFILTER_TARGET_* verdict or IPFILTER_FLOW_MISS.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_FLOWCACHE
+int ipfilter_flow_lookup(FAR const struct ipfilter_flow_s *key);
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_flow_add
+ *
+ * Description:
+ *   Cache the verdict the rules gave for a flow, replacing the flow that
+ *   hashes to the same slot.
+ *
+ * Input Parameters:
+ *   key    - The flow, as for ipfilter_flow_lookup()
+ *   target - The verdict of the rules
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_FLOWCACHE
+void ipfilter_flow_add(FAR const struct ipfilter_flow_s *key, int target);
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_flow_flush
+ *
+ * Description:
+ *   Invalidate all cached flows, called when the rules change.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_FLOWCACHE
+void ipfilter_flow_flush(void);
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_flow_next
+ *
+ * Description:
+ *   Iterate over the cached flows, e.g. for procfs.
+ *
+ * Input Parameters:
+ *   index - The slot to start at, updated to the slot after the returned
+ *           flow.  Start with zero.
+ *
+ * Returned Value:
+ *   The next cached flow or NULL when there are no more.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_FLOWCACHE
+FAR const struct ipfilter_flow_s *ipfilter_flow_next(FAR int *index);
+#endif
+
 #endif /* CONFIG_NET_IPFILTER */
 #endif /* __NET_IPFILTER_IPFILTER_H */
@@ -0,0 +1,229 @@
+/****************************************************************************
+ * net/ipfilter/ipfilter_flow.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+
+#include "ipfilter/ipfilter.h"
+
+#ifdef CONFIG_NET_IPFILTER_FLOWCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The bytes of struct ipfilter_flow_s that identify a flow */
+
+#define IPFILTER_FLOW_KEYLEN   offsetof(struct ipfilter_flow_s, target)
+
+#define IPFILTER_FLOW_TIMEOUT  SEC2TICK(CONFIG_NET_IPFILTER_FLOW_TIMEOUT)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct ipfilter_flow_s g_ipfilter_flows[CONFIG_NET_IPFILTER_FLOWS];
+
+/* The generation of the rule set, the flows of older generations are
+ * stale.  Zero marks an unused slot.
+ */
+
+static uint32_t g_ipfilter_flow_gen = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfilter_flow_slot
+ *
+ * Description:
+ *   Hash the identifying bytes of a flow into a slot of the cache.
+ *
+ ****************************************************************************/
+
+static FAR struct ipfilter_flow_s *
+ipfilter_flow_slot(FAR const struct ipfilter_flow_s *key)
+{
+  FAR const uint8_t *ptr = (FAR const uint8_t *)key;
+  uint32_t hash = 2166136261u;
+  size_t i;
+
+  /* FNV-1a, the key is short enough to hash byte by byte */
+
+  for (i = 0; i < IPFILTER_FLOW_KEYLEN; i++)
+    {
+      hash = (hash ^ ptr[i]) * 16777619u;
+    }
+
+  return &g_ipfilter_flows[hash % CONFIG_NET_IPFILTER_FLOWS];
+}
+
+/****************************************************************************
+ * Name: ipfilter_flow_valid
+ *
+ * Description:
+ *   Check if a slot holds a flow that is not stale or idle for too long.
+ *
+ ****************************************************************************/
+
+static bool ipfilter_flow_valid(FAR const struct ipfilter_flow_s *flow,
+                                clock_t now)
+{
+  return flow->gen == g_ipfilter_flow_gen &&
+         now - flow->stamp <= IPFILTER_FLOW_TIMEOUT;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfilter_flow_lookup
+ *
+ * Description:
+ *   Look up the verdict of a flow in the flow cache.
+ *
+ * Input Parameters:
+ *   key - The flow, with all the fields up to target set and the unused
+ *         bytes of the addresses zeroed
+ *
+ * Returned Value:
+ *   The cached IPFILTER_TARGET_* verdict or IPFILTER_FLOW_MISS.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int ipfilter_flow_lookup(FAR const struct ipfilter_flow_s *key)
+{
+  FAR struct ipfilter_flow_s *flow = ipfilter_flow_slot(key);
+  clock_t now = clock_systime_ticks();
+
+  if (!ipfilter_flow_valid(flow, now) ||
+      memcmp(flow, key, IPFILTER_FLOW_KEYLEN) != 0)
+    {
+      return IPFILTER_FLOW_MISS;
+    }
+
+  flow->hits++;
+  flow->stamp = now;
+  return flow->target;
+}
+
+/****************************************************************************
+ * Name: ipfilter_flow_add
+ *
+ * Description:
+ *   Cache the verdict the rules gave for a flow, replacing the flow that
+ *   hashes to the same slot.
+ *
+ * Input Parameters:
+ *   key    - The flow, as for ipfilter_flow_lookup()
+ *   target - The verdict of the rules
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipfilter_flow_add(FAR const struct ipfilter_flow_s *key, int target)
+{
+  FAR struct ipfilter_flow_s *flow = ipfilter_flow_slot(key);
+
+  memcpy(flow, key, IPFILTER_FLOW_KEYLEN);
+  flow->target = target;
+  flow->gen    = g_ipfilter_flow_gen;
+  flow->hits   = 0;
+  flow->stamp  = clock_systime_ticks();
+}
+
+/****************************************************************************
+ * Name: ipfilter_flow_flush
+ *
+ * Description:
+ *   Invalidate all cached flows, called when the rules change.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipfilter_flow_flush(void)
+{
+  /* Clear the slots when the generation wraps around, the flows of the
+   * generation that is reused could come back to life otherwise.
+   */
+
+  if (++g_ipfilter_flow_gen == 0)
+    {
+      memset(g_ipfilter_flows, 0, sizeof(g_ipfilter_flows));
+      g_ipfilter_flow_gen = 1;
+    }
+}
+
+/****************************************************************************
+ * Name: ipfilter_flow_next
+ *
+ * Description:
+ *   Iterate over the cached flows, e.g. for procfs.
+ *
+ * Input Parameters:
+ *   index - The slot to start at, updated to the slot after the returned
+ *           flow.  Start with zero.
+ *
+ * Returned Value:
+ *   The next cached flow or NULL when there are no more.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR const struct ipfilter_flow_s *ipfilter_flow_next(FAR int *index)
+{
+  clock_t now = clock_systime_ticks();
+
+  while (*index < CONFIG_NET_IPFILTER_FLOWS)
+    {
+      FAR const struct ipfilter_flow_s *flow = &g_ipfilter_flows[(*index)++];
+
+      if (ipfilter_flow_valid(flow, now))
+        {
+          return flow;
+        }
+    }
+
+  return NULL;
+}
+
+#endif /* CONFIG_NET_IPFILTER_FLOWCACHE */
@@ -32,6 +32,8 @@
 #include <assert.h>
 #include <stdint.h>
 
+#include <nuttx/net/ip.h>
+
 #undef HAVE_FWDALLOC
 #ifdef CONFIG_NET_IPFORWARD
 
@@ -368,5 +370,78 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4);
 #  define ipv4_dropstats(ipv4)
 #endif
 
+/****************************************************************************
+ * Name: ipfwd_findby_ripv4addr
+ *
+ * Description:
+ *   Find the device to forward an IPv4 packet on, like
+ *   netdev_findby_ripv4addr() but using the flow cache.
+ *
+ * Input Parameters:
+ *   srcipaddr  - The source address of the packet
+ *   destipaddr - The destination address of the packet
+ *
+ * Returned Value:
+ *   The forwarding device or NULL if the destination is not routable.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+FAR struct net_driver_s *ipfwd_findby_ripv4addr(in_addr_t srcipaddr,
+                                                in_addr_t destipaddr);
+#  else
+#    define ipfwd_findby_ripv4addr(srcipaddr, destipaddr) \
+       netdev_findby_ripv4addr(srcipaddr, destipaddr)
+#  endif
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_findby_ripv6addr
+ *
+ * Description:
+ *   Find the device to forward an IPv6 packet on, like
+ *   netdev_findby_ripv6addr() but using the flow cache.
+ *
+ * Input Parameters:
+ *   srcipaddr  - The source address of the packet
+ *   destipaddr - The destination address of the packet
+ *
+ * Returned Value:
+ *   The forwarding device or NULL if the destination is not routable.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+FAR struct net_driver_s *
+ipfwd_findby_ripv6addr(const net_ipv6addr_t srcipaddr,
+                       const net_ipv6addr_t destipaddr);
+#  else
+#    define ipfwd_findby_ripv6addr(srcipaddr, destipaddr) \
+       netdev_findby_ripv6addr(srcipaddr, destipaddr)
+#  endif
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_flowcache_flush
+ *
+ * Description:
+ *   Invalidate the forwarding flow cache.  Called whenever a change of the
+ *   devices, their addresses or state, or of the routing table may change
+ *   the device a destination is forwarded on.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+void ipfwd_flowcache_flush(void);
+#endif
+
 #endif /* CONFIG_NET_IPFORWARD */
 #endif /* __NET_IPFORWARD_IPFORWARD_H */
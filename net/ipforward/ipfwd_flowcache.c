@@ -0,0 +1,252 @@
+/****************************************************************************
+ * net/ipforward/ipfwd_flowcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+#include "ipforward/ipforward.h"
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A destination address and the device the packets to it are forwarded on.
+ * The device is only valid while the generation matches
+ * g_ipfwd_flowcache_gen.
+ */
+
+#ifdef CONFIG_NET_IPv4
+struct ipv4_fwdflow_s
+{
+  FAR struct net_driver_s *dev;
+  uint32_t gen;
+  in_addr_t destipaddr;
+};
+#endif
+
+#ifdef CONFIG_NET_IPv6
+struct ipv6_fwdflow_s
+{
+  FAR struct net_driver_s *dev;
+  uint32_t gen;
+  net_ipv6addr_t destipaddr;
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static struct ipv4_fwdflow_s g_ipv4_fwdflows[CONFIG_NET_IPFORWARD_NFLOWS];
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct ipv6_fwdflow_s g_ipv6_fwdflows[CONFIG_NET_IPFORWARD_NFLOWS];
+#endif
+
+/* Bumped whenever a device, an address or a route changes.  Starts at one
+ * so that the zeroed slots are never valid.
+ */
+
+static uint32_t g_ipfwd_flowcache_gen = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfwd_flowcache_hash
+ *
+ * Description:
+ *   Hash a 32-bit word of a destination address into a slot index.
+ *
+ ****************************************************************************/
+
+static inline unsigned int ipfwd_flowcache_hash(uint32_t word)
+{
+  /* Multiplicative hashing, the high bits are the best mixed ones */
+
+  return ((word * 2654435761u) >> 16) % CONFIG_NET_IPFORWARD_NFLOWS;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfwd_findby_ripv4addr
+ *
+ * Description:
+ *   Find the device to forward an IPv4 packet on, like
+ *   netdev_findby_ripv4addr() but using the flow cache.
+ *
+ * Input Parameters:
+ *   srcipaddr  - The source address of the packet
+ *   destipaddr - The destination address of the packet
+ *
+ * Returned Value:
+ *   The forwarding device or NULL if the destination is not routable.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+FAR struct net_driver_s *ipfwd_findby_ripv4addr(in_addr_t srcipaddr,
+                                                in_addr_t destipaddr)
+{
+  FAR struct ipv4_fwdflow_s *flow;
+  FAR struct net_driver_s *dev;
+  uint32_t gen = g_ipfwd_flowcache_gen;
+
+  /* The device for the broadcast address depends on the source address */
+
+  if (net_ipv4addr_cmp(destipaddr, INADDR_BROADCAST))
+    {
+      return netdev_findby_ripv4addr(srcipaddr, destipaddr);
+    }
+
+  flow = &g_ipv4_fwdflows[ipfwd_flowcache_hash(destipaddr)];
+  if (flow->gen == gen && net_ipv4addr_cmp(flow->destipaddr, destipaddr))
+    {
+      return flow->dev;
+    }
+
+  /* The generation was read before the slow path, so a change while it
+   * runs leaves the new flow stale.
+   */
+
+  dev = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+  if (dev != NULL)
+    {
+      flow->dev        = dev;
+      flow->gen        = gen;
+      flow->destipaddr = destipaddr;
+    }
+
+  return dev;
+}
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_findby_ripv6addr
+ *
+ * Description:
+ *   Find the device to forward an IPv6 packet on, like
+ *   netdev_findby_ripv6addr() but using the flow cache.
+ *
+ * Input Parameters:
+ *   srcipaddr  - The source address of the packet
+ *   destipaddr - The destination address of the packet
+ *
+ * Returned Value:
+ *   The forwarding device or NULL if the destination is not routable.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+FAR struct net_driver_s *
+ipfwd_findby_ripv6addr(const net_ipv6addr_t srcipaddr,
+                       const net_ipv6addr_t destipaddr)
+{
+  FAR struct ipv6_fwdflow_s *flow;
+  FAR struct net_driver_s *dev;
+  uint32_t gen = g_ipfwd_flowcache_gen;
+  uint32_t word;
+
+  /* The device for a multicast address depends on the source address */
+
+  if (net_is_addr_mcast(destipaddr))
+    {
+      return netdev_findby_ripv6addr(srcipaddr, destipaddr);
+    }
+
+  word = ((uint32_t)destipaddr[4] << 16 | destipaddr[5]) ^
+         ((uint32_t)destipaddr[6] << 16 | destipaddr[7]) ^
+         ((uint32_t)destipaddr[2] << 16 | destipaddr[3]);
+
+  flow = &g_ipv6_fwdflows[ipfwd_flowcache_hash(word)];
+  if (flow->gen == gen && net_ipv6addr_cmp(flow->destipaddr, destipaddr))
+    {
+      return flow->dev;
+    }
+
+  dev = netdev_findby_ripv6addr(srcipaddr, destipaddr);
+  if (dev != NULL)
+    {
+      flow->dev = dev;
+      flow->gen = gen;
+      net_ipv6addr_copy(flow->destipaddr, destipaddr);
+    }
+
+  return dev;
+}
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_flowcache_flush
+ *
+ * Description:
+ *   Invalidate the forwarding flow cache.  Called whenever a change of the
+ *   devices, their addresses or state, or of the routing table may change
+ *   the device a destination is forwarded on.
+ *
+ ****************************************************************************/
+
+void ipfwd_flowcache_flush(void)
+{
+  /* Clear the slots when the generation wraps around, the flows of the
+   * generation that is reused could come back to life otherwise.
+   */
+
+  if (++g_ipfwd_flowcache_gen == 0)
+    {
+#ifdef CONFIG_NET_IPv4
+      memset(g_ipv4_fwdflows, 0, sizeof(g_ipv4_fwdflows));
+#endif
+#ifdef CONFIG_NET_IPv6
+      memset(g_ipv6_fwdflows, 0, sizeof(g_ipv6_fwdflows));
+#endif
+      g_ipfwd_flowcache_gen = 1;
+    }
+}
+
+#endif /* CONFIG_NET_IPFORWARD_FLOWCACHE */
@@ -119,11 +119,11 @@ static struct work_s g_wkfragtimeout;
 
 static uint8_t       g_bufoccupy;
 
-/* Queue header definition, it links all fragments of all NICs by ascending
- * ipid.
+/* Queue headers of the hash buckets, they link the fragments of all NICs
+ * by the key of their datagram, see ip_frag_bucket().
  */
 
-static sq_queue_t    g_assemblyhead_ipid;
+static sq_queue_t    g_assemblyhead_hash[CONFIG_NET_IPFRAG_HASHSIZE];
 
 /* Queue header definition, which connects all fragments of all NICs in order
  * of addition time.
@@ -135,7 +135,7 @@ static sq_queue_t    g_assemblyhead_time;
  * Public Data
  ****************************************************************************/
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
+/* Only one thread can access g_assemblyhead_hash and g_assemblyhead_time
  * at a time.
  */
 
@@ -151,6 +151,9 @@ static inline FAR struct ip_fraglink_s *
 ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink);
 static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode);
 static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode);
+#if CONFIG_NET_IPFRAG_SRC_MAXIOB > 0
+static void ip_fragin_srcmonitor(FAR struct ip_fragsnode_s *curnode);
+#endif
 static inline FAR struct iob_s *
 ip_fragout_allocfragbuf(FAR struct iob_queue_s *fragq);
 
@@ -158,6 +161,150 @@ ip_fragout_allocfragbuf(FAR struct iob_queue_s *fragq);
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: ip_frag_bucket
+ *
+ * Description:
+ *   Get the hash bucket of a reassembly node, the IP ID, addresses and
+ *   protocol of the node are hashed.
+ *
+ ****************************************************************************/
+
+static FAR sq_queue_t *ip_frag_bucket(FAR const struct ip_fragsnode_s *node)
+{
+  uint32_t hash = node->ipid ^ node->proto;
+
+#ifdef CONFIG_NET_IPv4
+  if (node->isipv4)
+    {
+      hash ^= node->srcaddr.ipv4 ^ node->destaddr.ipv4;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (!node->isipv4)
+    {
+      int i;
+
+      for (i = 0; i < 8; i += 2)
+        {
+          hash ^= ((uint32_t)node->srcaddr.ipv6[i] << 16) ^
+                  node->srcaddr.ipv6[i + 1];
+          hash ^= ((uint32_t)node->destaddr.ipv6[i] << 16) ^
+                  node->destaddr.ipv6[i + 1];
+        }
+    }
+#endif
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return &g_assemblyhead_hash[hash % CONFIG_NET_IPFRAG_HASHSIZE];
+}
+
+/****************************************************************************
+ * Name: ip_fragin_setkey
+ *
+ * Description:
+ *   Fill the key of a reassembly node from one fragment of its datagram.
+ *
+ ****************************************************************************/
+
+static void ip_fragin_setkey(FAR struct ip_fragsnode_s *node,
+                             FAR struct net_driver_s *dev,
+                             FAR struct ip_fraglink_s *fraglink)
+{
+  FAR struct iob_s *iob = fraglink->frag;
+
+  node->dev    = dev;
+  node->ipid   = fraglink->ipid;
+  node->isipv4 = fraglink->isipv4;
+  node->proto  = 0;
+
+#ifdef CONFIG_NET_IPv4
+  if (fraglink->isipv4)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)
+                                    (iob->io_data + iob->io_offset);
+
+      node->proto          = ipv4->proto;
+      node->srcaddr.ipv4   = net_ip4addr_conv32(ipv4->srcipaddr);
+      node->destaddr.ipv4  = net_ip4addr_conv32(ipv4->destipaddr);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (!fraglink->isipv4)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)
+                                    (iob->io_data + iob->io_offset);
+
+      net_ipv6addr_copy(node->srcaddr.ipv6, ipv6->srcipaddr);
+      net_ipv6addr_copy(node->destaddr.ipv6, ipv6->destipaddr);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: ip_fragin_samesrc
+ *
+ * Description:
+ *   Check whether two reassembly nodes come from the same source.
+ *
+ ****************************************************************************/
+
+static bool ip_fragin_samesrc(FAR const struct ip_fragsnode_s *node1,
+                              FAR const struct ip_fragsnode_s *node2)
+{
+  if (node1->isipv4 != node2->isipv4)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if (node1->isipv4)
+    {
+      return net_ipv4addr_cmp(node1->srcaddr.ipv4, node2->srcaddr.ipv4);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  return net_ipv6addr_cmp(node1->srcaddr.ipv6, node2->srcaddr.ipv6);
+#else
+  return false;
+#endif
+}
+
+/****************************************************************************
+ * Name: ip_fragin_match
+ *
+ * Description:
+ *   Check whether a reassembly node has the key of another one.
+ *
+ ****************************************************************************/
+
+static bool ip_fragin_match(FAR const struct ip_fragsnode_s *node,
+                            FAR const struct ip_fragsnode_s *key)
+{
+  if (node->dev != key->dev || node->ipid != key->ipid ||
+      node->proto != key->proto || !ip_fragin_samesrc(node, key))
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if (node->isipv4)
+    {
+      return net_ipv4addr_cmp(node->destaddr.ipv4, key->destaddr.ipv4);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  return net_ipv6addr_cmp(node->destaddr.ipv6, key->destaddr.ipv6);
+#else
+  return false;
+#endif
+}
+
 /****************************************************************************
  * Name: ip_fragin_timerout_expiry
  *
@@ -474,6 +621,77 @@ static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode)
     }
 }
 
+/****************************************************************************
+ * Name: ip_fragin_srcmonitor
+ *
+ * Description:
+ *   Check the reassembly cache buffer size of the source of a node, if it
+ *   exceeds the configured threshold, the oldest nodes of the source are
+ *   freed.
+ *
+ * Input Parameters:
+ *   curnode - node of the upper-level linked list, it maintains information
+ *             about all fragments belonging to an IP datagram
+ *
+ * Returned Value:
+ *   none
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_IPFRAG_SRC_MAXIOB > 0
+static void ip_fragin_srcmonitor(FAR struct ip_fragsnode_s *curnode)
+{
+  uint32_t        srccnt = 0;
+  FAR sq_entry_t *entry;
+  FAR sq_entry_t *entrynext;
+  FAR struct ip_fragsnode_s *node;
+
+  /* No source can exceed its threshold while the whole cache is below */
+
+  if (g_bufoccupy <= CONFIG_NET_IPFRAG_SRC_MAXIOB)
+    {
+      return;
+    }
+
+  for (entry = sq_peek(&g_assemblyhead_time); entry != NULL;
+       entry = sq_next(entry))
+    {
+      node = (FAR struct ip_fragsnode_s *)
+             container_of(entry, FAR struct ip_fragsnode_s, flinkat);
+      if (ip_fragin_samesrc(node, curnode))
+        {
+          srccnt += node->bufcnt;
+        }
+    }
+
+  entry = sq_peek(&g_assemblyhead_time);
+  while (entry != NULL && srccnt > CONFIG_NET_IPFRAG_SRC_MAXIOB)
+    {
+      entrynext = sq_next(entry);
+
+      node = (FAR struct ip_fragsnode_s *)
+             container_of(entry, FAR struct ip_fragsnode_s, flinkat);
+
+      /* Drop the oldest nodes of the source, except the specified one */
+
+      if (node != curnode && ip_fragin_samesrc(node, curnode))
+        {
+          FAR struct ip_fraglink_s *fraglink = node->frags;
+
+          while (fraglink != NULL)
+            {
+              fraglink = ip_fragin_freelink(fraglink);
+            }
+
+          srccnt -= ip_frag_remnode(node);
+          kmm_free(node);
+        }
+
+      entry = entrynext;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: ip_fragout_allocfragbuf
  *
@@ -530,7 +748,7 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
   g_bufoccupy -= node->bufcnt;
   ASSERT(g_bufoccupy < CONFIG_IOB_NBUFFERS);
 
-  sq_rem((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
+  sq_rem((FAR sq_entry_t *)node, ip_frag_bucket(node));
   sq_rem((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
 
   return node->bufcnt;
@@ -559,34 +777,30 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
                        FAR struct ip_fraglink_s *curfraglink)
 {
   FAR struct ip_fragsnode_s *node;
+  FAR sq_queue_t            *bucket;
   FAR sq_entry_t            *entry;
-  FAR sq_entry_t            *entrylast = NULL;
+  struct ip_fragsnode_s      key;
   bool                       empty;
 
-  /* The linked list is ordered by IP ID value, walk through it and try to
-   * find a node that has the same IP ID value, otherwise need to create a
-   * new node and insert it into the linked list.
+  /* Walk through the hash bucket of the datagram and try to find its node,
+   * otherwise need to create a new node and insert it into the bucket.
    */
 
-  entry = sq_peek(&g_assemblyhead_ipid);
-  empty = (entry == NULL) ? true : false;
+  ip_fragin_setkey(&key, dev, curfraglink);
+  bucket = ip_frag_bucket(&key);
+  empty  = sq_peek(&g_assemblyhead_time) == NULL;
 
-  while (entry != NULL)
+  for (entry = sq_peek(bucket); entry != NULL; entry = sq_next(entry))
     {
-      node = (struct ip_fragsnode_s *)entry;
-
-      if (dev == node->dev && curfraglink->ipid <= node->ipid)
+      if (ip_fragin_match((FAR struct ip_fragsnode_s *)entry, &key))
         {
           break;
         }
-
-      entrylast = entry;
-      entry = sq_next(entry);
     }
 
   node = (FAR struct ip_fragsnode_s *)entry;
 
-  if (node != NULL && curfraglink->ipid == node->ipid)
+  if (node != NULL)
     {
       FAR struct ip_fraglink_s *fraglink;
       FAR struct ip_fraglink_s *lastlink = NULL;
@@ -685,10 +899,9 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
           return -ENOMEM;
         }
 
+      memcpy(node, &key, sizeof(*node));
       node->flink      = NULL;
       node->flinkat    = NULL;
-      node->dev        = dev;
-      node->ipid       = curfraglink->ipid;
       node->frags      = curfraglink;
       node->tick       = clock_systime_ticks();
       node->bufcnt     = IOBUF_CNT(curfraglink->frag);
@@ -696,19 +909,9 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
       node->verifyflag = 0;
       node->outgoframe = NULL;
 
-      /* Insert this new node into linked list identified by
-       * g_assemblyhead_ipid with correct position
-       */
+      /* Insert this new node into its hash bucket */
 
-      if (sq_peek(&g_assemblyhead_ipid) == NULL || entrylast == NULL)
-        {
-          sq_addfirst((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-        }
-      else
-        {
-          sq_addafter(entrylast, (FAR sq_entry_t *)node,
-                      &g_assemblyhead_ipid);
-        }
+      sq_addfirst((FAR sq_entry_t *)node, bucket);
 
       /* Add this new node to the tail of linked list identified by
        * g_assemblyhead_time
@@ -748,6 +951,12 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
 
   ip_fragin_cachemonitor(node);
 
+#if CONFIG_NET_IPFRAG_SRC_MAXIOB > 0
+  /* And when the source of the fragment exceeds its share of the cache */
+
+  ip_fragin_srcmonitor(node);
+#endif
+
   return empty;
 }
 
@@ -1117,13 +1326,14 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = sq_peek(&g_assemblyhead_time);
 
   /* Drop those unassembled incoming fragments belonging to this NIC */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)
+             container_of(entry, FAR struct ip_fragsnode_s, flinkat);
       entrynext = sq_next(entry);
 
       if (dev == node->dev)
@@ -1139,7 +1349,7 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
             }
 
           ip_frag_remnode(node);
-          kmm_free(entry);
+          kmm_free(node);
         }
 
       entry = entrynext;
@@ -1166,40 +1376,38 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
 
 void ip_frag_remallfrags(void)
 {
-  FAR sq_entry_t *entry = NULL;
-  FAR sq_entry_t *entrynext;
+  FAR sq_entry_t *entry;
   FAR struct net_driver_s *dev;
+  int i;
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
-
   /* Drop all unassembled incoming fragments */
 
-  while (entry != NULL)
+  for (i = 0; i < CONFIG_NET_IPFRAG_HASHSIZE; i++)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
-      entrynext = sq_next(entry);
-
-      if (node->frags != NULL)
+      while ((entry = sq_remfirst(&g_assemblyhead_hash[i])) != NULL)
         {
-          FAR struct ip_fraglink_s *fraglink = node->frags;
+          FAR struct ip_fragsnode_s *node =
+            (FAR struct ip_fragsnode_s *)entry;
 
-          while (fraglink != NULL)
+          if (node->frags != NULL)
             {
-              fraglink = ip_fragin_freelink(fraglink);
-            }
-        }
+              FAR struct ip_fraglink_s *fraglink = node->frags;
 
-      /* Because nodes managed by the two queues are the same,
-       * and g_assemblyhead_ipid will be cleared after this loop ends,
-       * so only reset g_assemblyhead_time is needed after this loop ends
-       */
+              while (fraglink != NULL)
+                {
+                  fraglink = ip_fragin_freelink(fraglink);
+                }
+            }
 
-      sq_rem(entry, &g_assemblyhead_ipid);
-      kmm_free(entry);
+          /* Because nodes managed by the two queues are the same,
+           * and the buckets are emptied by this loop, so only reset
+           * g_assemblyhead_time is needed after this loop ends
+           */
 
-      entry = entrynext;
+          kmm_free(node);
+        }
     }
 
   sq_init(&g_assemblyhead_time);
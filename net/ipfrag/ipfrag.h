@@ -94,8 +94,9 @@ struct ip_fraglink_s
 
 struct ip_fragsnode_s
 {
-  /* This link is used to maintain a single-linked list of ip_fragsnode_s.
-   * Must be the first field in the structure due to flink type casting.
+  /* This link is used to maintain a single-linked list of ip_fragsnode_s,
+   * the nodes of a hash bucket.  Must be the first field in the structure
+   * due to flink type casting.
    */
 
   FAR struct ip_fragsnode_s *flink;
@@ -116,6 +117,15 @@ struct ip_fragsnode_s
 
   uint32_t                   ipid;
 
+  /* The rest of the key identifying the datagram, the protocol is only
+   * used for IPv4.
+   */
+
+  uint8_t                    isipv4;
+  uint8_t                    proto;
+  union ip_addr_u            srcaddr;
+  union ip_addr_u            destaddr;
+
   /* Count ticks, used by ressembly timer */
 
   clock_t                    tick;
@@ -149,7 +159,7 @@ extern "C"
 #  define EXTERN extern
 #endif
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
+/* Only one thread can access g_assemblyhead_hash and g_assemblyhead_time
  * at a time
  */
 
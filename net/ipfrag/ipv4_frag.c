@@ -122,6 +122,7 @@ ipv4_fragin_getinfo(FAR struct iob_s *iob,
 static uint32_t ipv4_fragin_reassemble(FAR struct ip_fragsnode_s *node)
 {
   FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
   FAR struct ipv4_hdr_s *ipv4;
   FAR struct ip_fraglink_s *fraglink;
 
@@ -154,15 +155,31 @@ static uint32_t ipv4_fragin_reassemble(FAR struct ip_fragsnode_s *node)
           iob->io_len    -= iphdrlen;
           iob->io_pktlen -= iphdrlen;
 
-          /* Concatenate this iob to the reassembly chain */
+          /* Splice this iob chain to the tail of the reassembly chain, the
+           * tail is remembered so there is no walk through the chain.
+           */
+
+          head->io_pktlen += iob->io_pktlen;
+          iob->io_pktlen   = 0;
+          tail->io_flink   = iob;
+          tail             = iob;
 
-          iob_concat(head, iob);
+          while (tail->io_flink != NULL)
+            {
+              tail = tail->io_flink;
+            }
         }
       else
         {
           /* Remember the head iob */
 
           head = iob;
+          tail = iob;
+
+          while (tail->io_flink != NULL)
+            {
+              tail = tail->io_flink;
+            }
         }
 
       linknext = fraglink->flink;
@@ -174,6 +174,7 @@ static int32_t ipv6_fragin_getinfo(FAR struct iob_s *iob,
 static uint32_t ipv6_fragin_reassemble(FAR struct ip_fragsnode_s *node)
 {
   FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
   FAR struct ipv6_hdr_s *ipv6;
   FAR struct ip_fraglink_s *fraglink;
 
@@ -246,6 +247,12 @@ static uint32_t ipv6_fragin_reassemble(FAR struct ip_fragsnode_s *node)
           /* Remember the head iob */
 
           head = iob;
+          tail = iob;
+
+          while (tail->io_flink != NULL)
+            {
+              tail = tail->io_flink;
+            }
         }
       else
         {
@@ -260,9 +267,19 @@ static uint32_t ipv6_fragin_reassemble(FAR struct ip_fragsnode_s *node)
           iob->io_pktlen -= new_off - iob->io_offset;
           iob->io_offset  = new_off;
 
-          /* Concatenate this iob to the reassembly chain */
+          /* Splice this iob chain to the tail of the reassembly chain, the
+           * tail is remembered so there is no walk through the chain.
+           */
 
-          iob_concat(head, iob);
+          head->io_pktlen += iob->io_pktlen;
+          iob->io_pktlen   = 0;
+          tail->io_flink   = iob;
+          tail             = iob;
+
+          while (tail->io_flink != NULL)
+            {
+              tail = tail->io_flink;
+            }
         }
 
       linknext = fraglink->flink;
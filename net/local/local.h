@@ -110,6 +110,7 @@ enum local_state_s
  */
 
 struct devif_callback_s;       /* Forward reference */
+struct local_ring_s;           /* Forward reference */
 
 struct local_conn_s
 {
@@ -144,6 +145,13 @@ struct local_conn_s
   mutex_t lc_sendlock;           /* Make sending multi-thread safe */
   mutex_t lc_polllock;           /* Lock for net poll */
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* The rings shared with the peer of a connected stream, if any */
+
+  FAR struct local_ring_s *lc_rxring;  /* Written by the peer */
+  FAR struct local_ring_s *lc_txring;  /* Read by the peer */
+#endif
+
 #ifdef CONFIG_NET_LOCAL_STREAM
   /* SOCK_STREAM fields common to both client and server */
 
@@ -672,6 +680,91 @@ int local_open_sender(FAR struct local_conn_s *conn, FAR const char *path,
                       bool nonblock);
 #endif
 
+/****************************************************************************
+ * Name: local_ring_alloc
+ *
+ * Description:
+ *   Create the two rings of a connected stream pair.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+int local_ring_alloc(FAR struct local_conn_s *conn,
+                     FAR struct local_conn_s *peer,
+                     uint32_t rxsize, uint32_t peersize);
+
+/****************************************************************************
+ * Name: local_ring_shutdown
+ *
+ * Description:
+ *   Stop receiving and/or sending through the rings.
+ *
+ ****************************************************************************/
+
+void local_ring_shutdown(FAR struct local_conn_s *conn, int how);
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Drop the references of a connection to its rings.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void local_ring_release(FAR struct local_conn_s *conn);
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Send stream data through the ring of the peer.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_conn_s *conn,
+                        FAR const struct iovec *buf, size_t iovcnt,
+                        bool nonblock);
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Receive stream data from the ring of the connection.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                        size_t len, int flags);
+
+/****************************************************************************
+ * Name: local_ring_poll
+ *
+ * Description:
+ *   Setup or teardown the poll of a connection that uses the rings.
+ *
+ ****************************************************************************/
+
+int local_ring_poll(FAR struct local_conn_s *conn, FAR struct pollfd *fds,
+                    bool setup);
+
+/****************************************************************************
+ * Name: local_ring_ioctl
+ *
+ * Description:
+ *   Answer FIONREAD, FIONWRITE and FIONSPACE from the rings.
+ *
+ ****************************************************************************/
+
+int local_ring_ioctl(FAR struct local_conn_s *conn, int cmd,
+                     unsigned long arg);
+#endif
+
 /****************************************************************************
  * Name: local_event_pollnotify
  ****************************************************************************/
@@ -265,6 +265,13 @@ int local_alloc_accept(FAR struct local_conn_s *server,
   /* Do we have a connection?  Are the FIFOs opened? */
 
   DEBUGASSERT(conn->lc_infile.f_inode != NULL);
+
+#ifdef CONFIG_NET_LOCAL_RING
+  /* The FIFOs are kept for the connection, the data uses the rings */
+
+  local_ring_alloc(conn, client, server->lc_rcvsize, client->lc_rcvsize);
+#endif
+
   *accept = conn;
   return OK;
 
@@ -306,6 +313,12 @@ void local_free(FAR struct local_conn_s *conn)
       conn->lc_peer = NULL;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Let the peer see the end of the stream */
+
+  local_ring_release(conn);
+#endif
+
   /* Make sure that the read-only FIFO is closed */
 
   if (conn->lc_infile.f_inode != NULL)
@@ -176,6 +176,13 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       goto pollerr;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  if (conn->lc_rxring != NULL)
+    {
+      return local_ring_poll(conn, fds, true);
+    }
+#endif
+
   switch (fds->events & (POLLIN | POLLOUT))
     {
       case (POLLIN | POLLOUT):
@@ -324,6 +331,13 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
       return OK;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  if (conn->lc_rxring != NULL)
+    {
+      return local_ring_poll(conn, fds, false);
+    }
+#endif
+
   switch (fds->events & (POLLIN | POLLOUT))
     {
       case (POLLIN | POLLOUT):
@@ -249,6 +249,19 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
       return 0;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  if (conn->lc_rxring != NULL)
+    {
+      ret = local_ring_recv(conn, buf, len, flags);
+      if (ret > 0 && from != NULL)
+        {
+          local_getaddr(conn, from, fromlen);
+        }
+
+      return ret;
+    }
+#endif
+
   /* If it is non-blocking mode, the data in fifo is 0 and
    * returns directly
    */
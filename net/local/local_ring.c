@@ -0,0 +1,607 @@
+/****************************************************************************
+ * net/local/local_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/ioctl.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+#include <poll.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "local/local.h"
+
+#ifdef CONFIG_NET_LOCAL_RING
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The ring that carries one direction of a connected stream.  The sending
+ * peer only moves lr_head and the receiving peer only moves lr_tail, so
+ * the data itself is passed without a lock.  The semaphores and the poll
+ * waiters are only touched when the ring turns non-empty or non-full.
+ */
+
+struct local_ring_s
+{
+  atomic_uint lr_head;                 /* Written by the sending peer */
+  atomic_uint lr_tail;                 /* Written by the receiving peer */
+  uint32_t lr_size;                    /* Size of lr_data, a power of two */
+  uint8_t lr_refs;                     /* Both peers, protected by net_lock */
+  bool lr_wrclosed;                    /* The sending peer is gone */
+  bool lr_rdclosed;                    /* The receiving peer is gone */
+  mutex_t lr_rdlock;                   /* Serializes the receiving threads */
+  sem_t lr_datasem;                    /* The receiver waits for data */
+  sem_t lr_spacesem;                   /* The sender waits for space */
+  mutex_t lr_polllock;                 /* Protects the poll waiters */
+  FAR struct pollfd *lr_rdfds[LOCAL_NPOLLWAITERS];
+  FAR struct pollfd *lr_wrfds[LOCAL_NPOLLWAITERS];
+  uint8_t lr_data[1];
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_create
+ ****************************************************************************/
+
+static FAR struct local_ring_s *local_ring_create(uint32_t size)
+{
+  FAR struct local_ring_s *ring;
+  uint32_t ringsize = 1;
+
+  while (ringsize < size)
+    {
+      ringsize <<= 1;
+    }
+
+  ring = kmm_zalloc(sizeof(struct local_ring_s) + ringsize - 1);
+  if (ring != NULL)
+    {
+      ring->lr_size = ringsize;
+      ring->lr_refs = 2;
+      nxmutex_init(&ring->lr_rdlock);
+      nxmutex_init(&ring->lr_polllock);
+      nxsem_init(&ring->lr_datasem, 0, 0);
+      nxsem_init(&ring->lr_spacesem, 0, 0);
+    }
+
+  return ring;
+}
+
+/****************************************************************************
+ * Name: local_ring_unref
+ ****************************************************************************/
+
+static void local_ring_unref(FAR struct local_ring_s *ring)
+{
+  if (--ring->lr_refs == 0)
+    {
+      nxmutex_destroy(&ring->lr_rdlock);
+      nxmutex_destroy(&ring->lr_polllock);
+      nxsem_destroy(&ring->lr_datasem);
+      nxsem_destroy(&ring->lr_spacesem);
+      kmm_free(ring);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_wakeup
+ *
+ * Description:
+ *   Wake up the threads waiting on one side of the ring and notify its
+ *   poll waiters.
+ *
+ ****************************************************************************/
+
+static void local_ring_wakeup(FAR struct local_ring_s *ring,
+                              FAR sem_t *sem, FAR struct pollfd **fds,
+                              pollevent_t eventset)
+{
+  int semcount;
+
+  nxsem_get_value(sem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(sem);
+    }
+
+  nxmutex_lock(&ring->lr_polllock);
+  poll_notify(fds, LOCAL_NPOLLWAITERS, eventset);
+  nxmutex_unlock(&ring->lr_polllock);
+}
+
+/****************************************************************************
+ * Name: local_ring_wait
+ ****************************************************************************/
+
+static int local_ring_wait(FAR sem_t *sem, unsigned int timeout)
+{
+  int ret;
+
+  ret = net_sem_timedwait(sem, timeout);
+  return ret == -ETIMEDOUT ? -EAGAIN : ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_pollslot
+ ****************************************************************************/
+
+static int local_ring_pollslot(FAR struct local_ring_s *ring,
+                               FAR struct pollfd **slots,
+                               FAR struct pollfd *fds, bool setup)
+{
+  int ret = setup ? -EBUSY : OK;
+  int i;
+
+  nxmutex_lock(&ring->lr_polllock);
+  for (i = 0; i < LOCAL_NPOLLWAITERS; i++)
+    {
+      if (setup && slots[i] == NULL)
+        {
+          slots[i] = fds;
+          ret = OK;
+          break;
+        }
+      else if (!setup && slots[i] == fds)
+        {
+          slots[i] = NULL;
+          break;
+        }
+    }
+
+  nxmutex_unlock(&ring->lr_polllock);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_alloc
+ *
+ * Description:
+ *   Create the two rings of a connected stream pair.  The rings are sized
+ *   like the FIFOs, rounded up to a power of two.
+ *
+ * Input Parameters:
+ *   conn     - One connection of the pair
+ *   peer     - The other connection of the pair
+ *   rxsize   - The receive buffer size of 'conn'
+ *   peersize - The receive buffer size of 'peer'
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOMEM if the rings could not be allocated.  The
+ *   pair keeps passing the data through the FIFOs in that case.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int local_ring_alloc(FAR struct local_conn_s *conn,
+                     FAR struct local_conn_s *peer,
+                     uint32_t rxsize, uint32_t peersize)
+{
+  FAR struct local_ring_s *rx;
+  FAR struct local_ring_s *tx;
+
+  rx = local_ring_create(rxsize);
+  tx = local_ring_create(peersize);
+  if (rx == NULL || tx == NULL)
+    {
+      nerr("ERROR: Failed to allocate the rings\n");
+      kmm_free(rx);
+      kmm_free(tx);
+      return -ENOMEM;
+    }
+
+  conn->lc_rxring = rx;
+  conn->lc_txring = tx;
+  peer->lc_rxring = tx;
+  peer->lc_txring = rx;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_shutdown
+ *
+ * Description:
+ *   Stop receiving and/or sending through the rings and wake up the
+ *   threads waiting on the other side.
+ *
+ * Input Parameters:
+ *   conn - The connection of interest
+ *   how  - SHUT_RD, SHUT_WR or SHUT_RDWR
+ *
+ ****************************************************************************/
+
+void local_ring_shutdown(FAR struct local_conn_s *conn, int how)
+{
+  FAR struct local_ring_s *ring;
+
+  ring = conn->lc_rxring;
+  if ((how & SHUT_RD) != 0 && ring != NULL && !ring->lr_rdclosed)
+    {
+      ring->lr_rdclosed = true;
+      local_ring_wakeup(ring, &ring->lr_datasem, ring->lr_rdfds, POLLHUP);
+      local_ring_wakeup(ring, &ring->lr_spacesem, ring->lr_wrfds, POLLERR);
+    }
+
+  ring = conn->lc_txring;
+  if ((how & SHUT_WR) != 0 && ring != NULL && !ring->lr_wrclosed)
+    {
+      ring->lr_wrclosed = true;
+      local_ring_wakeup(ring, &ring->lr_datasem, ring->lr_rdfds,
+                        POLLIN | POLLHUP);
+      local_ring_wakeup(ring, &ring->lr_spacesem, ring->lr_wrfds, POLLERR);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Shut down both directions and drop the references of the connection
+ *   to the rings.  The peer may still drain the data sent so far.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void local_ring_release(FAR struct local_conn_s *conn)
+{
+  local_ring_shutdown(conn, SHUT_RDWR);
+
+  if (conn->lc_rxring != NULL)
+    {
+      local_ring_unref(conn->lc_rxring);
+      conn->lc_rxring = NULL;
+    }
+
+  if (conn->lc_txring != NULL)
+    {
+      local_ring_unref(conn->lc_txring);
+      conn->lc_txring = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Copy the data into the ring of the peer.  The receiver is only woken
+ *   up if it may have seen the ring empty.
+ *
+ * Input Parameters:
+ *   conn     - The sending connection
+ *   buf      - The data to send
+ *   iovcnt   - The number of entries in 'buf'
+ *   nonblock - Return what fits instead of waiting for space
+ *
+ * Returned Value:
+ *   The number of bytes sent.  Otherwise a negated errno value, -EPIPE if
+ *   the peer does not receive any longer.
+ *
+ * Assumptions:
+ *   The caller holds lc_sendlock.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_conn_s *conn,
+                        FAR const struct iovec *buf, size_t iovcnt,
+                        bool nonblock)
+{
+  FAR struct local_ring_s *ring = conn->lc_txring;
+  FAR const struct iovec *end = buf + iovcnt;
+  uint32_t mask = ring->lr_size - 1;
+  size_t offset = 0;
+  ssize_t written = 0;
+  int ret = OK;
+
+  while (buf != end)
+    {
+      uint32_t head;
+      uint32_t space;
+      uint32_t len;
+
+      if (offset == buf->iov_len)
+        {
+          buf++;
+          offset = 0;
+          continue;
+        }
+
+      if (ring->lr_rdclosed)
+        {
+          ret = -EPIPE;
+          break;
+        }
+
+      head  = atomic_load(&ring->lr_head);
+      space = ring->lr_size - (head - atomic_load(&ring->lr_tail));
+      if (space == 0)
+        {
+          if (nonblock)
+            {
+              ret = -EAGAIN;
+              break;
+            }
+
+          ret = local_ring_wait(&ring->lr_spacesem,
+                                _SO_TIMEOUT(conn->lc_conn.s_sndtimeo));
+          if (ret < 0)
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      len = MIN(space, buf->iov_len - offset);
+      len = MIN(len, ring->lr_size - (head & mask));
+      memcpy(&ring->lr_data[head & mask],
+             (FAR const uint8_t *)buf->iov_base + offset, len);
+
+      atomic_store(&ring->lr_head, head + len);
+      offset  += len;
+      written += len;
+
+      /* The receiver only waits after it found the ring empty, and it
+       * checks the head after it moved the tail.
+       */
+
+      if (atomic_load(&ring->lr_tail) == head)
+        {
+          local_ring_wakeup(ring, &ring->lr_datasem, ring->lr_rdfds,
+                            POLLIN);
+        }
+    }
+
+  return written > 0 ? written : ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Copy the data out of the ring of the connection.  The sender is only
+ *   woken up if it may have seen the ring full.
+ *
+ * Input Parameters:
+ *   conn  - The receiving connection
+ *   buf   - The buffer to receive the data
+ *   len   - The size of 'buf'
+ *   flags - The receive flags, MSG_PEEK and MSG_DONTWAIT are supported
+ *
+ * Returned Value:
+ *   The number of bytes received, zero if the peer does not send any
+ *   longer.  Otherwise a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                        size_t len, int flags)
+{
+  FAR struct local_ring_s *ring = conn->lc_rxring;
+  uint32_t mask = ring->lr_size - 1;
+  uint32_t tail;
+  uint32_t used;
+  uint32_t chunk;
+  int ret;
+
+  ret = nxmutex_lock(&ring->lr_rdlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (; ; )
+    {
+      tail = atomic_load(&ring->lr_tail);
+      used = atomic_load(&ring->lr_head) - tail;
+      if (used > 0 || len == 0)
+        {
+          break;
+        }
+
+      if (ring->lr_wrclosed || ring->lr_rdclosed)
+        {
+          nxmutex_unlock(&ring->lr_rdlock);
+          return 0;
+        }
+
+      if (_SS_ISNONBLOCK(conn->lc_conn.s_flags) ||
+          (flags & MSG_DONTWAIT) != 0)
+        {
+          nxmutex_unlock(&ring->lr_rdlock);
+          return -EAGAIN;
+        }
+
+      ret = local_ring_wait(&ring->lr_datasem,
+                            _SO_TIMEOUT(conn->lc_conn.s_rcvtimeo));
+      if (ret < 0)
+        {
+          nxmutex_unlock(&ring->lr_rdlock);
+          return ret;
+        }
+    }
+
+  len   = MIN(len, used);
+  chunk = MIN(len, ring->lr_size - (tail & mask));
+  memcpy(buf, &ring->lr_data[tail & mask], chunk);
+  memcpy((FAR uint8_t *)buf + chunk, ring->lr_data, len - chunk);
+
+  if ((flags & MSG_PEEK) == 0)
+    {
+      atomic_store(&ring->lr_tail, tail + len);
+
+      /* The sender only waits after it found the ring full, and it checks
+       * the tail after it moved the head.
+       */
+
+      if (atomic_load(&ring->lr_head) - tail == ring->lr_size)
+        {
+          local_ring_wakeup(ring, &ring->lr_spacesem, ring->lr_wrfds,
+                            POLLOUT);
+        }
+    }
+
+  nxmutex_unlock(&ring->lr_rdlock);
+  return len;
+}
+
+/****************************************************************************
+ * Name: local_ring_poll
+ *
+ * Description:
+ *   Setup or teardown the poll of a connection that uses the rings.  The
+ *   poll waits for data on the receive ring and for space on the send
+ *   ring.
+ *
+ ****************************************************************************/
+
+int local_ring_poll(FAR struct local_conn_s *conn, FAR struct pollfd *fds,
+                    bool setup)
+{
+  FAR struct local_ring_s *rx = conn->lc_rxring;
+  FAR struct local_ring_s *tx = conn->lc_txring;
+  pollevent_t eventset = 0;
+  int ret;
+
+  if (!setup)
+    {
+      if (fds->priv != NULL)
+        {
+          local_ring_pollslot(rx, rx->lr_rdfds, fds, false);
+          local_ring_pollslot(tx, tx->lr_wrfds, fds, false);
+          fds->priv = NULL;
+        }
+
+      return OK;
+    }
+
+  ret = local_ring_pollslot(rx, rx->lr_rdfds, fds, true);
+  if (ret >= 0)
+    {
+      ret = local_ring_pollslot(tx, tx->lr_wrfds, fds, true);
+      if (ret < 0)
+        {
+          local_ring_pollslot(rx, rx->lr_rdfds, fds, false);
+        }
+    }
+
+  if (ret < 0)
+    {
+      fds->priv = NULL;
+      return ret;
+    }
+
+  fds->priv = conn;
+
+  /* Check the state only now that the waiters are registered, so that no
+   * transition is missed.
+   */
+
+  if (atomic_load(&rx->lr_head) != atomic_load(&rx->lr_tail))
+    {
+      eventset |= POLLIN;
+    }
+
+  if (rx->lr_wrclosed)
+    {
+      eventset |= POLLIN | POLLHUP;
+    }
+
+  if (tx->lr_rdclosed)
+    {
+      eventset |= POLLERR;
+    }
+  else if (atomic_load(&tx->lr_head) - atomic_load(&tx->lr_tail) <
+           tx->lr_size)
+    {
+      eventset |= POLLOUT;
+    }
+
+  poll_notify(&fds, 1, eventset);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_ioctl
+ *
+ * Description:
+ *   Answer the ioctl commands about the buffered data from the rings.
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOTTY if the command is not about the rings.
+ *
+ ****************************************************************************/
+
+int local_ring_ioctl(FAR struct local_conn_s *conn, int cmd,
+                     unsigned long arg)
+{
+  FAR struct local_ring_s *rx = conn->lc_rxring;
+  FAR struct local_ring_s *tx = conn->lc_txring;
+  FAR int *value = (FAR int *)((uintptr_t)arg);
+
+  switch (cmd)
+    {
+      case FIONREAD:
+        *value = atomic_load(&rx->lr_head) - atomic_load(&rx->lr_tail);
+        break;
+
+      case FIONWRITE:
+        *value = atomic_load(&tx->lr_head) - atomic_load(&tx->lr_tail);
+        break;
+
+      case FIONSPACE:
+        *value = tx->lr_size -
+                 (atomic_load(&tx->lr_head) - atomic_load(&tx->lr_tail));
+        break;
+
+      default:
+        return -ENOTTY;
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_NET_LOCAL_RING */
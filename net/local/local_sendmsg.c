@@ -214,7 +214,19 @@ static ssize_t local_send(FAR struct socket *psock,
               return ret;
             }
 
-          ret = local_send_packet(&conn->lc_outfile, buf, len);
+#ifdef CONFIG_NET_LOCAL_RING
+          if (conn->lc_txring != NULL)
+            {
+              ret = local_ring_send(conn, buf, len,
+                                    _SS_ISNONBLOCK(conn->lc_conn.s_flags) ||
+                                    (flags & MSG_DONTWAIT) != 0);
+            }
+          else
+#endif
+            {
+              ret = local_send_packet(&conn->lc_outfile, buf, len);
+            }
+
           nxmutex_unlock(&conn->lc_sendlock);
         }
         break;
@@ -948,6 +948,19 @@ static int local_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
   FAR struct local_conn_s *conn = psock->s_conn;
   int ret = OK;
 
+#ifdef CONFIG_NET_LOCAL_RING
+  if (conn->lc_rxring != NULL)
+    {
+      ret = local_ring_ioctl(conn, cmd, arg);
+      if (ret != -ENOTTY)
+        {
+          return ret;
+        }
+
+      ret = OK;
+    }
+#endif
+
   switch (cmd)
     {
       case FIONBIO:
@@ -1099,6 +1112,16 @@ static int local_socketpair(FAR struct socket *psocks[2])
   conns[0]->lc_state = conns[1]->lc_state
                      = LOCAL_STATE_CONNECTED;
 
+#ifdef CONFIG_NET_LOCAL_RING
+  if (psocks[0]->s_type == SOCK_STREAM)
+    {
+      net_lock();
+      local_ring_alloc(conns[0], conns[1], conns[0]->lc_rcvsize,
+                       conns[1]->lc_rcvsize);
+      net_unlock();
+    }
+#endif
+
 #ifdef CONFIG_NET_LOCAL_DGRAM
   if (psocks[0]->s_type == SOCK_DGRAM)
     {
@@ -1151,6 +1174,14 @@ static int local_shutdown(FAR struct socket *psock, int how)
       case SOCK_STREAM:
         {
           FAR struct local_conn_s *conn = psock->s_conn;
+
+#ifdef CONFIG_NET_LOCAL_RING
+          if (conn->lc_rxring != NULL)
+            {
+              local_ring_shutdown(conn, how);
+            }
+#endif
+
           if (how & SHUT_RD)
             {
               if (conn->lc_infile.f_inode != NULL)
@@ -28,6 +28,7 @@
  ****************************************************************************/
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include <net/ethernet.h>
 
@@ -72,6 +73,63 @@ struct net_driver_s; /* Forward reference */
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr);
 
+/****************************************************************************
+ * Name: neighbor_hash_find
+ *
+ * Description:
+ *   Find an entry in the Neighbor Table through the hash table.
+ *
+ * Input Parameters:
+ *   ipaddr - The IPv6 address to use in the lookup
+ *   lltype - The link layer type the entry must have, -1 for any
+ *
+ * Returned Value:
+ *   The Neighbor Table entry or NULL if there is none.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_HASH
+FAR struct neighbor_entry_s *neighbor_hash_find(const net_ipv6addr_t ipaddr,
+                                                int lltype);
+#endif
+
+/****************************************************************************
+ * Name: neighbor_hash_alloc
+ *
+ * Description:
+ *   Return the entry to store a new address association in: the first
+ *   unused entry or the least recently used one, which is removed from the
+ *   hash table.
+ *
+ * Returned Value:
+ *   The Neighbor Table entry to overwrite.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_HASH
+FAR struct neighbor_entry_s *neighbor_hash_alloc(void);
+#endif
+
+/****************************************************************************
+ * Name: neighbor_hash_touch
+ *
+ * Description:
+ *   Make an entry the most recently used one and add it to the hash table
+ *   if it was returned by neighbor_hash_alloc().
+ *
+ * Input Parameters:
+ *   neighbor - The Neighbor Table entry
+ *   found    - True if the entry was found by neighbor_hash_find()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_HASH
+void neighbor_hash_touch(FAR struct neighbor_entry_s *neighbor, bool found);
+#endif
+
 /****************************************************************************
  * Name: neighbor_add
  *
@@ -173,6 +231,8 @@ void neighbor_ethernet_out(FAR struct net_driver_s *dev);
  *   snapshot  - Location to return the Neighbor table copy
  *   nentries  - The size of the user provided 'dest' in entries, each of
  *               size sizeof(struct neighbor_entry_s)
+ *   skip      - The number of entries to skip before the first one copied,
+ *               used to return a large table in several parts
  *
  * Returned Value:
  *   On success, the number of entries actually copied is returned.  Unused
@@ -185,7 +245,7 @@ void neighbor_ethernet_out(FAR struct net_driver_s *dev);
 
 #ifdef CONFIG_NETLINK_ROUTE
 unsigned int neighbor_snapshot(FAR struct neighbor_entry_s *snapshot,
-                               unsigned int nentries);
+                               unsigned int nentries, unsigned int skip);
 #endif
 
 /****************************************************************************
@@ -65,78 +65,98 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR struct neighbor_entry_s *neighbor;
   uint8_t lltype;
-  clock_t oldest_time;
-  int     oldest_ndx;
   bool    found = false;
   bool    new_entry;
+#ifndef CONFIG_NET_IPv6_NEIGHBOR_HASH
+  clock_t oldest_time;
   int     i;
+#endif
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
+  lltype = dev->d_lltype;
+
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_HASH
+  /* Find the matching entry, else the first unused entry or the least
+   * recently used one.
+   */
+
+  neighbor = neighbor_hash_find(ipaddr, lltype);
+  if (neighbor != NULL)
+    {
+      found = true;
+    }
+  else
+    {
+      neighbor = neighbor_hash_alloc();
+    }
+#else
   /* Find the matching entry, first unused entry, or the oldest used entry.
    * The unused entry will have ne_time == 0 and should generate the oldest
    * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
    * check might be to compare ne_ipaddr with the IPv6 unspecified address.
    */
 
+  neighbor    = &g_neighbors[0];
   oldest_time = g_neighbors[0].ne_time;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
 
   for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
     {
       if (g_neighbors[i].ne_addr.na_lltype == lltype &&
           net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
         {
-          oldest_ndx = i;
+          neighbor = &g_neighbors[i];
           found = true;
           break;
         }
 
       if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
         {
-          oldest_ndx = i;
+          neighbor = &g_neighbors[i];
           oldest_time = g_neighbors[i].ne_time;
         }
     }
+#endif
 
   /* When overwite old entry, need to notify RTM_DELNEIGH */
 
-  if (!found && g_neighbors[oldest_ndx].ne_time != 0)
+  if (!found && neighbor->ne_time != 0)
     {
-      netlink_neigh_notify(&g_neighbors[oldest_ndx], RTM_DELNEIGH,
-                           AF_INET6);
+      netlink_neigh_notify(neighbor, RTM_DELNEIGH, AF_INET6);
     }
 
   /* Need to notify when entry is not found or changes in table */
 
-  new_entry = !found || memcmp(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-                             g_neighbors[oldest_ndx].ne_addr.na_llsize) != 0;
+  new_entry = !found || memcmp(&neighbor->ne_addr.u, addr,
+                               neighbor->ne_addr.na_llsize) != 0;
 
   /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
+   * "neighbor" variable).
    */
 
-  g_neighbors[oldest_ndx].ne_dev  = dev;
-  g_neighbors[oldest_ndx].ne_time = clock_systime_ticks();
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
+  neighbor->ne_dev  = dev;
+  neighbor->ne_time = clock_systime_ticks();
+  net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
+
+  neighbor->ne_addr.na_lltype = lltype;
+  neighbor->ne_addr.na_llsize = netdev_lladdrsize(dev);
 
-  g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
-  g_neighbors[oldest_ndx].ne_addr.na_llsize = netdev_lladdrsize(dev);
+  memcpy(&neighbor->ne_addr.u, addr, neighbor->ne_addr.na_llsize);
 
-  memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-         g_neighbors[oldest_ndx].ne_addr.na_llsize);
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_HASH
+  neighbor_hash_touch(neighbor, found);
+#endif
 
   /* Notify the new entry */
 
   if (new_entry)
     {
-      netlink_neigh_notify(&g_neighbors[oldest_ndx], RTM_NEWNEIGH,
-                           AF_INET6);
+      netlink_neigh_notify(neighbor, RTM_NEWNEIGH, AF_INET6);
     }
 
   /* Dump the contents of the new entry */
 
-  neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_dumpentry("Added entry", neighbor);
 }
@@ -53,6 +53,15 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_HASH
+  FAR struct neighbor_entry_s *neighbor = neighbor_hash_find(ipaddr, -1);
+
+  if (neighbor != NULL)
+    {
+      neighbor_dumpentry("Entry found", neighbor);
+      return neighbor;
+    }
+#else
   int i;
 
   for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
@@ -65,6 +74,7 @@ FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
           return neighbor;
         }
     }
+#endif
 
   neighbor_dumpipaddr("Not found", ipaddr);
   return NULL;
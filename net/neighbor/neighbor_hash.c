@@ -0,0 +1,257 @@
+/****************************************************************************
+ * net/neighbor/neighbor_hash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "neighbor/neighbor.h"
+
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_HASH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The hash and LRU links hold the table index plus one, zero ends a list */
+
+#define NEIGHBOR_NDX(e)   ((uint16_t)((e) - g_neighbors + 1))
+#define NEIGHBOR_ENTRY(n) (&g_neighbors[(n) - 1])
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The hash buckets of the Neighbor Table, keyed by IPv6 address */
+
+static uint16_t g_neighbor_head[CONFIG_NET_IPv6_NCONF_ENTRIES];
+static uint16_t g_neighbor_next[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
+/* The entries ever used, from the most to the least recently used */
+
+static uint16_t g_neighbor_newer[CONFIG_NET_IPv6_NCONF_ENTRIES];
+static uint16_t g_neighbor_older[CONFIG_NET_IPv6_NCONF_ENTRIES];
+static uint16_t g_neighbor_newest;
+static uint16_t g_neighbor_oldest;
+static uint16_t g_neighbor_nused;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Return the hash bucket of an IPv6 address.
+ *
+ ****************************************************************************/
+
+static unsigned int neighbor_hash(const net_ipv6addr_t ipaddr)
+{
+  uint32_t hash = 0;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      hash = hash * 31 + ipaddr[i];
+    }
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+
+  return hash % CONFIG_NET_IPv6_NCONF_ENTRIES;
+}
+
+/****************************************************************************
+ * Name: neighbor_lru_unlink
+ *
+ * Description:
+ *   Remove an entry from the LRU list.
+ *
+ ****************************************************************************/
+
+static void neighbor_lru_unlink(uint16_t ndx)
+{
+  uint16_t newer = g_neighbor_newer[ndx - 1];
+  uint16_t older = g_neighbor_older[ndx - 1];
+
+  if (newer != 0)
+    {
+      g_neighbor_older[newer - 1] = older;
+    }
+  else
+    {
+      g_neighbor_newest = older;
+    }
+
+  if (older != 0)
+    {
+      g_neighbor_newer[older - 1] = newer;
+    }
+  else
+    {
+      g_neighbor_oldest = newer;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_hash_find
+ *
+ * Description:
+ *   Find an entry in the Neighbor Table through the hash table.
+ *
+ * Input Parameters:
+ *   ipaddr - The IPv6 address to use in the lookup
+ *   lltype - The link layer type the entry must have, -1 for any
+ *
+ * Returned Value:
+ *   The Neighbor Table entry or NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s *neighbor_hash_find(const net_ipv6addr_t ipaddr,
+                                                int lltype)
+{
+  uint16_t ndx;
+
+  for (ndx = g_neighbor_head[neighbor_hash(ipaddr)]; ndx != 0;
+       ndx = g_neighbor_next[ndx - 1])
+    {
+      FAR struct neighbor_entry_s *neighbor = NEIGHBOR_ENTRY(ndx);
+
+      if ((lltype < 0 || neighbor->ne_addr.na_lltype == lltype) &&
+          net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
+        {
+          return neighbor;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: neighbor_hash_alloc
+ *
+ * Description:
+ *   Return the entry to store a new address association in: the first
+ *   unused entry or the least recently used one, which is removed from the
+ *   hash table.
+ *
+ * Returned Value:
+ *   The Neighbor Table entry to overwrite.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s *neighbor_hash_alloc(void)
+{
+  FAR struct neighbor_entry_s *neighbor;
+  FAR uint16_t *link;
+  uint16_t ndx;
+
+  if (g_neighbor_nused < CONFIG_NET_IPv6_NCONF_ENTRIES)
+    {
+      return &g_neighbors[g_neighbor_nused++];
+    }
+
+  ndx      = g_neighbor_oldest;
+  neighbor = NEIGHBOR_ENTRY(ndx);
+
+  for (link = &g_neighbor_head[neighbor_hash(neighbor->ne_ipaddr)];
+       *link != 0; link = &g_neighbor_next[*link - 1])
+    {
+      if (*link == ndx)
+        {
+          *link = g_neighbor_next[ndx - 1];
+          g_neighbor_next[ndx - 1] = 0;
+          break;
+        }
+    }
+
+  return neighbor;
+}
+
+/****************************************************************************
+ * Name: neighbor_hash_touch
+ *
+ * Description:
+ *   Make an entry the most recently used one and add it to the hash table
+ *   if it was returned by neighbor_hash_alloc().
+ *
+ * Input Parameters:
+ *   neighbor - The Neighbor Table entry
+ *   found    - True if the entry was found by neighbor_hash_find()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void neighbor_hash_touch(FAR struct neighbor_entry_s *neighbor, bool found)
+{
+  uint16_t ndx = NEIGHBOR_NDX(neighbor);
+
+  if (!found)
+    {
+      unsigned int hash = neighbor_hash(neighbor->ne_ipaddr);
+
+      g_neighbor_next[ndx - 1] = g_neighbor_head[hash];
+      g_neighbor_head[hash]    = ndx;
+    }
+
+  if (g_neighbor_newest == ndx)
+    {
+      return;
+    }
+
+  /* A new entry is not in the LRU list yet */
+
+  if (g_neighbor_newer[ndx - 1] != 0 || g_neighbor_older[ndx - 1] != 0)
+    {
+      neighbor_lru_unlink(ndx);
+    }
+
+  g_neighbor_newer[ndx - 1] = 0;
+  g_neighbor_older[ndx - 1] = g_neighbor_newest;
+  if (g_neighbor_newest != 0)
+    {
+      g_neighbor_newer[g_neighbor_newest - 1] = ndx;
+    }
+  else
+    {
+      g_neighbor_oldest = ndx;
+    }
+
+  g_neighbor_newest = ndx;
+}
+
+#endif /* CONFIG_NET_IPv6_NEIGHBOR_HASH */
@@ -50,6 +50,8 @@
  *   snapshot  - Location to return the Neighbor table copy
  *   nentries  - The size of the user provided 'dest' in entries, each of
  *               size sizeof(struct neighbor_entry_s)
+ *   skip      - The number of entries to skip before the first one copied,
+ *               used to return a large table in several parts
  *
  * Returned Value:
  *   On success, the number of entries actually copied is returned.  Unused
@@ -61,7 +63,7 @@
  ****************************************************************************/
 
 unsigned int neighbor_snapshot(FAR struct neighbor_entry_s *snapshot,
-                               unsigned int nentries)
+                               unsigned int nentries, unsigned int skip)
 {
   unsigned int ncopied;
   int i;
@@ -81,6 +83,12 @@ unsigned int neighbor_snapshot(FAR struct neighbor_entry_s *snapshot,
 
       if (!net_ipv6addr_cmp(neighbor->ne_ipaddr, g_ipv6_unspecaddr))
         {
+          if (skip > 0)
+            {
+              skip--;
+              continue;
+            }
+
           memcpy(&snapshot[ncopied], neighbor,
                  sizeof(struct neighbor_entry_s));
           ncopied++;
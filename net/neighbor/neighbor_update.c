@@ -56,5 +56,8 @@ void neighbor_update(const net_ipv6addr_t ipaddr)
   if (neighbor != NULL)
     {
       neighbor->ne_time = clock_systime_ticks();
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_HASH
+      neighbor_hash_touch(neighbor, true);
+#endif
     }
 }
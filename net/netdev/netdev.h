@@ -106,6 +106,44 @@ typedef int (*netdev_callback_t)(FAR struct net_driver_s *dev,
 
 bool netdev_verify(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: netdev_demux_lookup
+ *
+ * Description:
+ *   Return the connection that the last packet of a flow was delivered to
+ *   if the packet in the device buffer belongs to the same flow and the
+ *   connections of the protocol did not change since.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_DEMUX_CACHE
+FAR void *netdev_demux_lookup(FAR struct net_driver_s *dev,
+                              FAR struct netdev_demux_s *demux,
+                              uint32_t gen, uint16_t lport, uint16_t rport);
+#endif
+
+/****************************************************************************
+ * Name: netdev_demux_update
+ *
+ * Description:
+ *   Remember the connection that the packet in the device buffer was
+ *   delivered to for the following packets of the same flow.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_DEMUX_CACHE
+void netdev_demux_update(FAR struct net_driver_s *dev,
+                         FAR struct netdev_demux_s *demux,
+                         uint32_t gen, uint16_t lport, uint16_t rport,
+                         FAR void *conn);
+#endif
+
 /****************************************************************************
  * Name: netdev_findbyname
  *
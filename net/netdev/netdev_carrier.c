@@ -38,6 +38,7 @@
 #include <nuttx/net/netdev.h>
 
 #include "ipfrag/ipfrag.h"
+#include "ipforward/ipforward.h"
 #include "netdev/netdev.h"
 #include "netlink/netlink.h"
 #include "arp/arp.h"
@@ -64,6 +65,10 @@ void netdev_carrier_on(FAR struct net_driver_s *dev)
     {
       dev->d_flags |= IFF_RUNNING;
       netlink_device_notify(dev);
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      ipfwd_flowcache_flush();
+#endif
     }
 }
 
@@ -86,6 +91,10 @@ void netdev_carrier_off(FAR struct net_driver_s *dev)
       dev->d_flags &= ~IFF_RUNNING;
       netlink_device_notify(dev);
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      ipfwd_flowcache_flush();
+#endif
+
 #ifdef CONFIG_NET_IPFRAG
       /* Clean up fragment data for this NIC (if any) */
 
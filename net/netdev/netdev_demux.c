@@ -0,0 +1,183 @@
+/****************************************************************************
+ * net/netdev/netdev_demux.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+
+#include "netdev/netdev.h"
+
+#ifdef CONFIG_NETDEV_DEMUX_CACHE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_demux_lookup
+ *
+ * Description:
+ *   Return the connection that the last packet of a flow was delivered to
+ *   if the packet in the device buffer belongs to the same flow and the
+ *   connections of the protocol did not change since.
+ *
+ * Input Parameters:
+ *   dev   - The device that received the packet
+ *   demux - The cache of the protocol on the device
+ *   gen   - The current generation of the connections of the protocol
+ *   lport - The destination port of the packet
+ *   rport - The source port of the packet
+ *
+ * Returned Value:
+ *   The cached connection or NULL on a cache miss.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR void *netdev_demux_lookup(FAR struct net_driver_s *dev,
+                              FAR struct netdev_demux_s *demux,
+                              uint32_t gen, uint16_t lport, uint16_t rport)
+{
+  if (demux->conn == NULL || demux->gen != gen ||
+      demux->lport != lport || demux->rport != rport)
+    {
+      return NULL;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+
+#ifdef CONFIG_NET_IPv4
+      if (!demux->ipv6)
+        {
+          return NULL;
+        }
+#endif
+
+      if (!net_ipv6addr_hdrcmp(ipv6->destipaddr, demux->u.ipv6.laddr) ||
+          !net_ipv6addr_hdrcmp(ipv6->srcipaddr, demux->u.ipv6.raddr))
+        {
+          return NULL;
+        }
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+
+#ifdef CONFIG_NET_IPv6
+      if (demux->ipv6)
+        {
+          return NULL;
+        }
+#endif
+
+      if (!net_ipv4addr_cmp(net_ip4addr_conv32(ipv4->destipaddr),
+                            demux->u.ipv4.laddr) ||
+          !net_ipv4addr_cmp(net_ip4addr_conv32(ipv4->srcipaddr),
+                            demux->u.ipv4.raddr))
+        {
+          return NULL;
+        }
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  return demux->conn;
+}
+
+/****************************************************************************
+ * Name: netdev_demux_update
+ *
+ * Description:
+ *   Remember the connection that the packet in the device buffer was
+ *   delivered to for the following packets of the same flow.
+ *
+ * Input Parameters:
+ *   dev   - The device that received the packet
+ *   demux - The cache of the protocol on the device
+ *   gen   - The current generation of the connections of the protocol
+ *   lport - The destination port of the packet
+ *   rport - The source port of the packet
+ *   conn  - The connection found for the packet
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void netdev_demux_update(FAR struct net_driver_s *dev,
+                         FAR struct netdev_demux_s *demux,
+                         uint32_t gen, uint16_t lport, uint16_t rport,
+                         FAR void *conn)
+{
+  demux->conn  = conn;
+  demux->gen   = gen;
+  demux->lport = lport;
+  demux->rport = rport;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  demux->ipv6  = IFF_IS_IPv6(dev->d_flags);
+  if (demux->ipv6)
+#endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+
+      net_ipv6addr_hdrcopy(demux->u.ipv6.laddr, ipv6->destipaddr);
+      net_ipv6addr_hdrcopy(demux->u.ipv6.raddr, ipv6->srcipaddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+
+      net_ipv4addr_copy(demux->u.ipv4.laddr,
+                        net_ip4addr_conv32(ipv4->destipaddr));
+      net_ipv4addr_copy(demux->u.ipv4.raddr,
+                        net_ip4addr_conv32(ipv4->srcipaddr));
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+
+#endif /* CONFIG_NETDEV_DEMUX_CACHE */
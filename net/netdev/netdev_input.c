@@ -26,10 +26,256 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
 
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+#  define GRO_ETHBUF(iob) \
+     ((FAR struct eth_hdr_s *)(IOB_DATA(iob) - ETH_HDRLEN))
+#  define GRO_SEQ(tcp) \
+     ((uint32_t)(tcp)->seqno[0] << 24 | (uint32_t)(tcp)->seqno[1] << 16 | \
+      (uint32_t)(tcp)->seqno[2] << 8 | (tcp)->seqno[3])
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+/* The headers of a candidate segment */
+
+struct netdev_gro_hdr_s
+{
+  FAR uint8_t *ip;           /* The IPv4 or IPv6 header */
+  FAR struct tcp_hdr_s *tcp; /* The TCP header */
+  uint16_t hdrlen;           /* Size of the IP and TCP headers */
+  uint16_t payload;          /* Size of the TCP payload */
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+
+/****************************************************************************
+ * Name: netdev_gro_parse
+ *
+ * Description:
+ *   Check whether the frame is a TCP data segment for this host that may
+ *   be merged: no IP options or fragments, no VLAN tag, only the ACK and
+ *   PSH flags and a non-empty payload.  The checksums are verified here
+ *   because they are lost once the segment is merged.
+ *
+ ****************************************************************************/
+
+static bool netdev_gro_parse(FAR struct net_driver_s *dev,
+                             FAR struct iob_s *iob,
+                             FAR struct netdev_gro_hdr_s *hdr)
+{
+  FAR struct eth_hdr_s *eth = GRO_ETHBUF(iob);
+  uint16_t iphdrlen;
+  uint16_t iplen;
+  uint16_t tcphdrlen;
+
+  hdr->ip = IOB_DATA(iob);
+
+#ifdef CONFIG_NET_IPv4
+  if (eth->type == HTONS(ETHTYPE_IP))
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)hdr->ip;
+
+      iphdrlen = IPv4_HDRLEN;
+      if (iob->io_len < IPv4_HDRLEN + TCP_HDRLEN ||
+          ipv4->vhl != (IPv4_VERSION | (IPv4_HDRLEN >> 2)) ||
+          ipv4->proto != IP_PROTO_TCP ||
+          (ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0 ||
+          !net_ipv4addr_cmp(net_ip4addr_conv32(ipv4->destipaddr),
+                            dev->d_ipaddr))
+        {
+          return false;
+        }
+
+      iplen = (uint16_t)ipv4->len[0] << 8 | ipv4->len[1];
+
+#ifdef CONFIG_NET_IPV4_CHECKSUMS
+      if (ipv4_chksum(ipv4) != 0xffff)
+        {
+          return false;
+        }
+#endif
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (eth->type == HTONS(ETHTYPE_IP6))
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)hdr->ip;
+
+      /* Extension headers are not handled */
+
+      iphdrlen = IPv6_HDRLEN;
+      if (iob->io_len < IPv6_HDRLEN + TCP_HDRLEN ||
+          (ipv6->vtc & 0xf0) != IPv6_VERSION ||
+          ipv6->proto != IP_PROTO_TCP ||
+          !NETDEV_IS_MY_V6ADDR(dev, ipv6->destipaddr))
+        {
+          return false;
+        }
+
+      iplen = ((uint16_t)ipv6->len[0] << 8 | ipv6->len[1]) + IPv6_HDRLEN;
+    }
+  else
+#endif
+    {
+      return false;
+    }
+
+  hdr->tcp  = (FAR struct tcp_hdr_s *)(hdr->ip + iphdrlen);
+  tcphdrlen = (hdr->tcp->tcpoffset >> 4) << 2;
+  hdr->hdrlen = iphdrlen + tcphdrlen;
+
+  /* Ethernet padding is only added to frames without much payload, such
+   * frames are not worth merging.
+   */
+
+  if (tcphdrlen < TCP_HDRLEN || iob->io_len < hdr->hdrlen ||
+      iplen != iob->io_pktlen || iplen <= hdr->hdrlen ||
+      (hdr->tcp->flags & ~TCP_PSH) != TCP_ACK)
+    {
+      return false;
+    }
+
+  hdr->payload = iplen - hdr->hdrlen;
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+  if (!NETDEV_RXCSUM_OK(dev))
+    {
+      FAR struct iob_s *saved = dev->d_iob;
+      uint16_t chksum;
+
+      dev->d_iob = iob;
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+      chksum = iphdrlen == IPv4_HDRLEN ? tcp_ipv4_chksum(dev) :
+                                         tcp_ipv6_chksum(dev);
+#elif defined(CONFIG_NET_IPv4)
+      chksum = tcp_ipv4_chksum(dev);
+#else
+      chksum = tcp_ipv6_chksum(dev);
+#endif
+      dev->d_iob = saved;
+
+      if (chksum != 0xffff)
+        {
+          return false;
+        }
+    }
+#endif
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: netdev_gro_merge
+ *
+ * Description:
+ *   Append the payload of the segment in d_iob to the held segment if it
+ *   is the next in-order segment of the same flow.  The IP addresses, the
+ *   ports, the ACK number and the TCP options must all match.
+ *
+ ****************************************************************************/
+
+static bool netdev_gro_merge(FAR struct net_driver_s *dev,
+                             FAR struct netdev_gro_hdr_s *hdr)
+{
+  FAR struct netdev_gro_s *gro = &dev->d_gro;
+  struct netdev_gro_hdr_s held;
+  uint16_t iplen;
+
+  held.ip  = IOB_DATA(gro->iob);
+  held.tcp = (FAR struct tcp_hdr_s *)(held.ip + ((FAR uint8_t *)hdr->tcp -
+                                                 hdr->ip));
+  held.hdrlen  = hdr->hdrlen;
+  held.payload = gro->iob->io_pktlen - hdr->hdrlen;
+
+  if (GRO_ETHBUF(gro->iob)->type != GRO_ETHBUF(dev->d_iob)->type ||
+      (held.tcp->tcpoffset >> 4) != (hdr->tcp->tcpoffset >> 4) ||
+      gro->iob->io_pktlen + hdr->payload + NET_LL_HDRLEN(dev) >
+      CONFIG_NETDEV_GRO_MAXSIZE ||
+      GRO_SEQ(held.tcp) + held.payload != GRO_SEQ(hdr->tcp) ||
+      hdr->payload > gro->mss ||
+      held.tcp->srcport != hdr->tcp->srcport ||
+      held.tcp->destport != hdr->tcp->destport ||
+      memcmp(held.tcp->ackno, hdr->tcp->ackno, 4) != 0 ||
+      memcmp(held.tcp->optdata, hdr->tcp->optdata,
+             hdr->hdrlen - (hdr->tcp->optdata - hdr->ip)) != 0)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if (GRO_ETHBUF(dev->d_iob)->type == HTONS(ETHTYPE_IP))
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)held.ip;
+      FAR struct ipv4_hdr_s *next = (FAR struct ipv4_hdr_s *)hdr->ip;
+
+      if (ipv4->tos != next->tos || ipv4->ttl != next->ttl ||
+          memcmp(ipv4->srcipaddr, next->srcipaddr,
+                 sizeof(ipv4->srcipaddr)) != 0)
+        {
+          return false;
+        }
+
+      iplen = ((uint16_t)ipv4->len[0] << 8 | ipv4->len[1]) + hdr->payload;
+      ipv4->len[0] = iplen >> 8;
+      ipv4->len[1] = iplen & 0xff;
+    }
+  else
+#endif
+    {
+#ifdef CONFIG_NET_IPv6
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)held.ip;
+      FAR struct ipv6_hdr_s *next = (FAR struct ipv6_hdr_s *)hdr->ip;
+
+      if (memcmp(ipv6, next, 4) != 0 || ipv6->ttl != next->ttl ||
+          !net_ipv6addr_cmp(ipv6->srcipaddr, next->srcipaddr))
+        {
+          return false;
+        }
+
+      iplen = ((uint16_t)ipv6->len[0] << 8 | ipv6->len[1]) + hdr->payload;
+      ipv6->len[0] = iplen >> 8;
+      ipv6->len[1] = iplen & 0xff;
+#endif
+    }
+
+  /* The latest window and PSH flag apply to the merged segment */
+
+  memcpy(held.tcp->wnd, hdr->tcp->wnd, 2);
+  held.tcp->flags |= hdr->tcp->flags;
+
+  /* Strip the headers and chain the payload to the held segment */
+
+  iob_concat(gro->iob, iob_trimhead(dev->d_iob, hdr->hdrlen));
+  netdev_iob_clear(dev);
+  gro->nsegs++;
+  return true;
+}
+
+#endif /* CONFIG_NETDEV_GRO */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -105,3 +351,133 @@ int netdev_input(FAR struct net_driver_s *dev,
 
   return ret;
 }
+
+#ifdef CONFIG_NETDEV_GRO
+
+/****************************************************************************
+ * Name: netdev_gro_flush
+ *
+ * Description:
+ *   Give the segment held by netdev_gro_input() to 'input'.  The frame
+ *   in d_iob, if any, is preserved.
+ *
+ * Input Parameters:
+ *   dev   - The network device
+ *   input - The link layer input function of the driver
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+void netdev_gro_flush(FAR struct net_driver_s *dev,
+                      CODE void (*input)(FAR struct net_driver_s *dev))
+{
+  FAR struct netdev_gro_s *gro = &dev->d_gro;
+  FAR struct iob_s *iob = dev->d_iob;
+  uint16_t len = dev->d_len;
+  bool csumok = NETDEV_RXCSUM_OK(dev);
+
+  if (gro->iob == NULL)
+    {
+      return;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if (gro->nsegs > 1 && GRO_ETHBUF(gro->iob)->type == HTONS(ETHTYPE_IP))
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)
+                                    IOB_DATA(gro->iob);
+
+      /* The total length was updated, so is the header checksum */
+
+      ipv4->ipchksum = 0;
+      ipv4->ipchksum = ~ipv4_chksum(ipv4);
+    }
+#endif
+
+  /* The checksums of all the segments were verified before merging */
+
+  dev->d_iob = gro->iob;
+  dev->d_len = gro->iob->io_pktlen + NET_LL_HDRLEN(dev);
+  gro->iob   = NULL;
+  NETDEV_RXCSUM_SET(dev, true);
+
+  input(dev);
+
+  netdev_iob_release(dev);
+  gro->nsegs = 0;
+
+  dev->d_iob = iob;
+  dev->d_len = len;
+  NETDEV_RXCSUM_SET(dev, csumok);
+}
+
+/****************************************************************************
+ * Name: netdev_gro_input
+ *
+ * Description:
+ *   Generic receive offload.  Hold the received Ethernet frame in d_iob if
+ *   it is an in-order TCP data segment for this host, merging it into the
+ *   segment already held when both belong to the same flow.  Any other
+ *   frame flushes the held segment and is given to 'input' directly.
+ *
+ * Input Parameters:
+ *   dev   - The network device, d_iob holds the received frame
+ *   input - The link layer input function of the driver
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+void netdev_gro_input(FAR struct net_driver_s *dev,
+                      CODE void (*input)(FAR struct net_driver_s *dev))
+{
+  FAR struct netdev_gro_s *gro = &dev->d_gro;
+  struct netdev_gro_hdr_s hdr;
+  uint8_t flags;
+
+  if (!netdev_gro_parse(dev, dev->d_iob, &hdr))
+    {
+      netdev_gro_flush(dev, input);
+      input(dev);
+      return;
+    }
+
+  /* The headers are freed once the segment is merged */
+
+  flags = hdr.tcp->flags;
+
+  if (gro->iob != NULL && netdev_gro_merge(dev, &hdr))
+    {
+      /* A pushed or short segment ends the burst, there is nothing more
+       * to wait for.
+       */
+
+      if ((flags & TCP_PSH) != 0 || hdr.payload < gro->mss)
+        {
+          netdev_gro_flush(dev, input);
+        }
+
+      return;
+    }
+
+  netdev_gro_flush(dev, input);
+
+  if ((flags & TCP_PSH) != 0)
+    {
+      NETDEV_RXCSUM_SET(dev, true);
+      input(dev);
+      return;
+    }
+
+  /* Hold the segment until the next frame or the end of the batch */
+
+  gro->iob   = dev->d_iob;
+  gro->mss   = hdr.payload;
+  gro->nsegs = 1;
+  netdev_iob_clear(dev);
+}
+
+#endif /* CONFIG_NETDEV_GRO */
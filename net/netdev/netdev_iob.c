@@ -82,6 +82,7 @@ int netdev_iob_prepare(FAR struct net_driver_s *dev, bool throttled,
   /* Set the device buffer to l2 */
 
   dev->d_buf = NETLLBUF;
+  NETDEV_SNDSUM_CLEAR(dev);
 
   return OK;
 }
@@ -167,6 +168,7 @@ void netdev_iob_clear(FAR struct net_driver_s *dev)
   dev->d_iob = NULL;
   dev->d_buf = NULL;
   dev->d_len = 0;
+  NETDEV_SNDSUM_CLEAR(dev);
 }
 
 /****************************************************************************
@@ -191,6 +193,7 @@ void netdev_iob_release(FAR struct net_driver_s *dev)
     }
 
   dev->d_buf = NULL;
+  NETDEV_SNDSUM_CLEAR(dev);
 }
 
 /****************************************************************************
@@ -83,6 +83,7 @@
 #include "devif/devif.h"
 #include "igmp/igmp.h"
 #include "icmpv6/icmpv6.h"
+#include "ipforward/ipforward.h"
 #include "route/route.h"
 #include "netlink/netlink.h"
 #include "utils/utils.h"
@@ -901,6 +902,9 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
 
       case SIOCSIFNETMASK:  /* Set network mask */
         ioctl_set_ipv4addr(&dev->d_netmask, &req->ifr_addr);
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+        ipfwd_flowcache_flush();
+#endif
         break;
 #endif
 
@@ -924,6 +928,10 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
 
           netlink_device_notify_ipaddr(dev, RTM_NEWADDR, AF_INET6,
            dev->d_ipv6[idx].addr, net_ipv6_mask2pref(dev->d_ipv6[idx].mask));
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+          ipfwd_flowcache_flush();
+#endif
         }
         break;
 
@@ -959,6 +967,10 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
           FAR struct lifreq *lreq = (FAR struct lifreq *)req;
           idx = MIN(idx, CONFIG_NETDEV_MAX_IPv6_ADDR - 1);
           ioctl_set_ipv6addr(dev->d_ipv6[idx].mask, &lreq->lifr_addr);
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+          ipfwd_flowcache_flush();
+#endif
         }
         break;
 #endif
@@ -1099,6 +1111,10 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
 #ifdef CONFIG_NET_ARP_ACD
             arp_acd_set_addr(dev);
 #endif /* CONFIG_NET_ARP_ACD */
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+            ipfwd_flowcache_flush();
+#endif
           }
 #endif
 
@@ -1124,6 +1140,10 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
             netlink_device_notify_ipaddr(dev, RTM_DELADDR, AF_INET,
                          &dev->d_ipaddr, net_ipv4_mask2pref(dev->d_netmask));
             dev->d_ipaddr = 0;
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+            ipfwd_flowcache_flush();
+#endif
           }
 #endif
 
@@ -1965,6 +1985,10 @@ int netdev_ifup(FAR struct net_driver_s *dev)
               /* Update the driver status */
 
               netlink_device_notify(dev);
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+              ipfwd_flowcache_flush();
+#endif
             }
         }
       else
@@ -2000,6 +2024,10 @@ int netdev_ifdown(FAR struct net_driver_s *dev)
 
               netlink_device_notify(dev);
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+              ipfwd_flowcache_flush();
+#endif
+
               /* Notify clients that the network has been taken down */
 
               devif_dev_event(dev, NETDEV_DOWN);
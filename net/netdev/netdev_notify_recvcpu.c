@@ -427,6 +427,9 @@ void netdev_notify_recvcpu(FAR struct net_driver_s *dev,
 
       arg.cpu = cpu;
       arg.hash = hash;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+      arg.queue = -1;
+#endif
 
       ret = dev->d_ioctl(dev, SIOCNOTIFYRECVCPU,
                          (unsigned long)(uintptr_t)&arg);
@@ -44,6 +44,7 @@
 #include "utils/utils.h"
 #include "icmpv6/icmpv6.h"
 #include "igmp/igmp.h"
+#include "ipforward/ipforward.h"
 #include "mld/mld.h"
 #include "netdev/netdev.h"
 
@@ -484,6 +485,10 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
       icmpv6_devinit(dev);
 #endif
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      ipfwd_flowcache_flush();
+#endif
+
       net_unlock();
 
 #if defined(CONFIG_NET_ETHERNET) || defined(CONFIG_DRIVERS_IEEE80211)
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
 #include <syslog.h>
 
 #include <nuttx/net/netdev.h>
@@ -41,6 +42,59 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: netdev_statistics_get
+ *
+ * Description:
+ *   Return the statistics of a network device summed up over all CPUs.
+ *
+ * Input Parameters:
+ *   dev   - The network device
+ *   stats - The location to return the statistics in
+ *
+ ****************************************************************************/
+
+void netdev_statistics_get(FAR struct net_driver_s *dev,
+                           FAR struct netdev_statistics_s *stats)
+{
+#ifdef CONFIG_NET_STATISTICS_PERCPU
+  int cpu;
+#endif
+
+  /* The drivers may also count in d_statistics directly */
+
+  memcpy(stats, &dev->d_statistics, sizeof(*stats));
+
+#ifdef CONFIG_NET_STATISTICS_PERCPU
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      FAR const struct netdev_statistics_s *count =
+        &dev->d_statistics_cpu[cpu].stats;
+
+      stats->rx_packets   += count->rx_packets;
+      stats->rx_fragments += count->rx_fragments;
+      stats->rx_errors    += count->rx_errors;
+#ifdef CONFIG_NET_IPv4
+      stats->rx_ipv4      += count->rx_ipv4;
+#endif
+#ifdef CONFIG_NET_IPv6
+      stats->rx_ipv6      += count->rx_ipv6;
+#endif
+#ifdef CONFIG_NET_ARP
+      stats->rx_arp       += count->rx_arp;
+#endif
+      stats->rx_dropped   += count->rx_dropped;
+      stats->rx_bytes     += count->rx_bytes;
+      stats->tx_packets   += count->tx_packets;
+      stats->tx_done      += count->tx_done;
+      stats->tx_errors    += count->tx_errors;
+      stats->tx_timeouts  += count->tx_timeouts;
+      stats->tx_bytes     += count->tx_bytes;
+      stats->errors       += count->errors;
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: netdev_statistics_log
  *
@@ -57,7 +111,12 @@
 void netdev_statistics_log(FAR void *arg)
 {
   FAR struct net_driver_s *dev = arg;
-  FAR struct netdev_statistics_s *stats = &dev->d_statistics;
+  struct netdev_statistics_s devstats;
+  FAR struct netdev_statistics_s *stats = &devstats;
+  struct net_stats_s netstats;
+
+  netdev_statistics_get(dev, &devstats);
+  net_stats_get(&netstats);
 
   stats_log("%s:T%" PRIu32 "/%" PRIu32 "(%" PRIu64 "B)" ",R"
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
@@ -84,18 +143,18 @@ void netdev_statistics_log(FAR void *arg)
 #endif
             , stats->rx_packets, stats->rx_bytes
 #ifdef CONFIG_NET_TCP
-            , g_netstats.tcp.sent, g_netstats.tcp.recv, g_netstats.tcp.drop
+            , netstats.tcp.sent, netstats.tcp.recv, netstats.tcp.drop
 #endif
 #ifdef CONFIG_NET_UDP
-            , g_netstats.udp.sent, g_netstats.udp.recv, g_netstats.udp.drop
+            , netstats.udp.sent, netstats.udp.recv, netstats.udp.drop
 #endif
 #ifdef CONFIG_NET_ICMP
-            , g_netstats.icmp.sent, g_netstats.icmp.recv,
-              g_netstats.icmp.drop
+            , netstats.icmp.sent, netstats.icmp.recv,
+              netstats.icmp.drop
 #endif
 #ifdef CONFIG_NET_ICMPv6
-            , g_netstats.icmpv6.sent, g_netstats.icmpv6.recv,
-              g_netstats.icmpv6.drop
+            , netstats.icmpv6.sent, netstats.icmpv6.recv,
+              netstats.icmpv6.drop
 #endif
             );
 }
@@ -38,6 +38,7 @@
 #include <nuttx/net/netdev.h>
 
 #include "utils/utils.h"
+#include "ipforward/ipforward.h"
 #include "netdev/netdev.h"
 
 /****************************************************************************
@@ -150,6 +151,11 @@ int netdev_unregister(FAR struct net_driver_s *dev)
 #ifdef CONFIG_NETDEV_IFINDEX
       free_ifindex(dev->d_ifindex);
 #endif
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      ipfwd_flowcache_flush();
+#endif
+
       net_unlock();
 
 #if CONFIG_NETDEV_STATISTICS_LOG_PERIOD > 0
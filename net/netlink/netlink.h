@@ -178,6 +178,18 @@
  * Public Type Definitions
  ****************************************************************************/
 
+/* Produce the next part of a dump.  'pos' holds the progress of the dump,
+ * it is zero at the start.  'space' is the size of the buffer of the
+ * receiver, the part should not exceed it but always has at least one
+ * message.  A positive value is returned if more of the dump remains, zero
+ * if the dump is complete or a negated errno value on failure.  The
+ * terminator of the dump is added by the caller.
+ */
+
+typedef CODE int (*netlink_dump_t)(NETLINK_HANDLE handle,
+                                   FAR const struct nlmsghdr *req,
+                                   FAR unsigned int *pos, size_t space);
+
 /* This connection structure describes the underlying state of the socket. */
 
 struct netlink_conn_s
@@ -202,6 +214,14 @@ struct netlink_conn_s
   /* Queued response data */
 
   sq_queue_t resplist;               /* Singly linked list of responses */
+
+#ifdef CONFIG_NETLINK_DUMP_STREAM
+  /* Dump in progress */
+
+  netlink_dump_t dump;               /* Produces the next part of the dump */
+  FAR struct nlmsghdr *dumpreq;      /* Copy of the dump request */
+  unsigned int dumppos;              /* Progress of the dump */
+#endif
 };
 
 /* Standard attribute types to specify validation policy */
@@ -437,6 +457,11 @@ int netlink_add_terminator(NETLINK_HANDLE handle,
  *   Note:  The network will be momentarily locked to support exclusive
  *   access to the pending response list.
  *
+ * Input Parameters:
+ *   conn  - The Netlink connection
+ *   space - The size of the receive buffer.  The next part of a dump in
+ *           progress is sized to it.
+ *
  * Returned Value:
  *   The next response from the head of the pending response list is
  *   returned.  NULL will be returned if the pending response list is
@@ -445,7 +470,7 @@ int netlink_add_terminator(NETLINK_HANDLE handle,
  ****************************************************************************/
 
 FAR struct netlink_response_s *
-netlink_tryget_response(FAR struct netlink_conn_s *conn);
+netlink_tryget_response(FAR struct netlink_conn_s *conn, size_t space);
 
 /****************************************************************************
  * Name: netlink_get_response
@@ -459,6 +484,8 @@ netlink_tryget_response(FAR struct netlink_conn_s *conn);
  *
  * Input Parameters:
  *   conn     - The Netlink connection
+ *   space    - The size of the receive buffer.  The next part of a dump in
+ *              progress is sized to it.
  *   response - The next response from the head of the pending response list
  *              is returned.  This function will block until a response is
  *              received if the pending response list is empty.  NULL will be
@@ -470,7 +497,7 @@ netlink_tryget_response(FAR struct netlink_conn_s *conn);
  *
  ****************************************************************************/
 
-int netlink_get_response(FAR struct netlink_conn_s *conn,
+int netlink_get_response(FAR struct netlink_conn_s *conn, size_t space,
                          FAR struct netlink_response_s **response);
 
 /****************************************************************************
@@ -486,6 +513,51 @@ int netlink_get_response(FAR struct netlink_conn_s *conn,
 
 bool netlink_check_response(FAR struct netlink_conn_s *conn);
 
+/****************************************************************************
+ * Name: netlink_start_dump
+ *
+ * Description:
+ *   Start a dump that is produced piece by piece while it is received,
+ *   replacing any dump still in progress on this connection.  The messages
+ *   of the dump and its NLMSG_DONE terminator are marked with NLM_F_MULTI.
+ *
+ * Input Parameters:
+ *   handle - The handle previously provided to the sendto() implementation
+ *            for the protocol.  This is an opaque reference to the Netlink
+ *            socket state structure.
+ *   req    - The dump request, a copy of it is passed to 'dump'.
+ *   dump   - Produces the parts of the dump.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the dump was started.  A negated error value
+ *   is returned if an unexpected error occurred.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETLINK_DUMP_STREAM
+int netlink_start_dump(NETLINK_HANDLE handle, FAR const struct nlmsghdr *req,
+                       netlink_dump_t dump);
+
+/****************************************************************************
+ * Name: netlink_tryget_part
+ *
+ * Description:
+ *   Return the next part of the multipart message whose previous part was
+ *   just received, if it fits into the rest of the receive buffer.
+ *
+ * Input Parameters:
+ *   conn  - The Netlink connection
+ *   space - The space left in the receive buffer
+ *
+ * Returned Value:
+ *   The next part or NULL if there is none or if it does not fit.
+ *
+ ****************************************************************************/
+
+FAR struct netlink_response_s *
+netlink_tryget_part(FAR struct netlink_conn_s *conn, size_t space);
+#endif
+
 /****************************************************************************
  * Name: netlink_route_sendto()
  *
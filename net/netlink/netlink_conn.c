@@ -132,6 +132,67 @@ netlink_get_terminator(FAR const struct nlmsghdr *req)
   return resp;
 }
 
+/****************************************************************************
+ * Name: netlink_end_dump
+ *
+ * Description:
+ *   Forget the dump in progress on a connection, if any.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETLINK_DUMP_STREAM
+static void netlink_end_dump(FAR struct netlink_conn_s *conn)
+{
+  if (conn->dumpreq != NULL)
+    {
+      kmm_free(conn->dumpreq);
+    }
+
+  conn->dump    = NULL;
+  conn->dumpreq = NULL;
+  conn->dumppos = 0;
+}
+
+/****************************************************************************
+ * Name: netlink_continue_dump
+ *
+ * Description:
+ *   Queue the next part of the dump in progress once the parts produced so
+ *   far have all been received.  The terminator is queued after the last
+ *   part, or after a failure so that the receiver does not wait forever.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void netlink_continue_dump(FAR struct netlink_conn_s *conn,
+                                  size_t space)
+{
+  int ret;
+
+  if (conn->dump == NULL || !sq_empty(&conn->resplist))
+    {
+      return;
+    }
+
+  ret = conn->dump(conn, conn->dumpreq, &conn->dumppos, space);
+  if (ret <= 0)
+    {
+      if (ret < 0)
+        {
+          nerr("ERROR: Dump failed: %d\n", ret);
+        }
+
+      netlink_add_terminator(conn, conn->dumpreq, 0);
+      netlink_end_dump(conn);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -245,6 +306,10 @@ void netlink_free(FAR struct netlink_conn_s *conn)
       kmm_free(resp);
     }
 
+#ifdef CONFIG_NETLINK_DUMP_STREAM
+  netlink_end_dump(conn);
+#endif
+
   /* If this is a preallocated or a batch allocated connection store it in
    * the free connections list. Else free it.
    */
@@ -451,6 +516,11 @@ void netlink_add_broadcast(int group, FAR struct netlink_response_s *data)
  *   Note:  The network will be momentarily locked to support exclusive
  *   access to the pending response list.
  *
+ * Input Parameters:
+ *   conn  - The Netlink connection
+ *   space - The size of the receive buffer.  The next part of a dump in
+ *           progress is sized to it.
+ *
  * Returned Value:
  *   The next response from the head of the pending response list is
  *   returned.  NULL will be returned if the pending response list is
@@ -459,7 +529,7 @@ void netlink_add_broadcast(int group, FAR struct netlink_response_s *data)
  ****************************************************************************/
 
 FAR struct netlink_response_s *
-netlink_tryget_response(FAR struct netlink_conn_s *conn)
+netlink_tryget_response(FAR struct netlink_conn_s *conn, size_t space)
 {
   FAR struct netlink_response_s *resp;
 
@@ -470,6 +540,12 @@ netlink_tryget_response(FAR struct netlink_conn_s *conn)
    */
 
   net_lock();
+#ifdef CONFIG_NETLINK_DUMP_STREAM
+  netlink_continue_dump(conn, space);
+#else
+  UNUSED(space);
+#endif
+
   resp = (FAR struct netlink_response_s *)sq_remfirst(&conn->resplist);
   net_unlock();
 
@@ -488,6 +564,8 @@ netlink_tryget_response(FAR struct netlink_conn_s *conn)
  *
  * Input Parameters:
  *   conn     - The Netlink connection
+ *   space    - The size of the receive buffer.  The next part of a dump in
+ *              progress is sized to it.
  *   response - The next response from the head of the pending response list
  *              is returned.  This function will block until a response is
  *              received if the pending response list is empty.  NULL will be
@@ -499,7 +577,7 @@ netlink_tryget_response(FAR struct netlink_conn_s *conn)
  *
  ****************************************************************************/
 
-int netlink_get_response(FAR struct netlink_conn_s *conn,
+int netlink_get_response(FAR struct netlink_conn_s *conn, size_t space,
                          FAR struct netlink_response_s **response)
 {
   int ret = OK;
@@ -512,7 +590,7 @@ int netlink_get_response(FAR struct netlink_conn_s *conn,
    */
 
   net_lock();
-  while ((*response = netlink_tryget_response(conn)) == NULL)
+  while ((*response = netlink_tryget_response(conn, space)) == NULL)
     {
       sem_t waitsem;
 
@@ -575,7 +653,112 @@ bool netlink_check_response(FAR struct netlink_conn_s *conn)
    * network because the sq_peek() is an atomic operation.
    */
 
+#ifdef CONFIG_NETLINK_DUMP_STREAM
+  /* A dump in progress always has another part to be received */
+
+  if (conn->dump != NULL)
+    {
+      return true;
+    }
+#endif
+
   return (sq_peek(&conn->resplist) != NULL);
 }
 
+/****************************************************************************
+ * Name: netlink_start_dump
+ *
+ * Description:
+ *   Start a dump that is produced piece by piece while it is received,
+ *   replacing any dump still in progress on this connection.  The messages
+ *   of the dump and its NLMSG_DONE terminator are marked with NLM_F_MULTI.
+ *
+ * Input Parameters:
+ *   handle - The handle previously provided to the sendto() implementation
+ *            for the protocol.  This is an opaque reference to the Netlink
+ *            socket state structure.
+ *   req    - The dump request, a copy of it is passed to 'dump'.
+ *   dump   - Produces the parts of the dump.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the dump was started.  A negated error value
+ *   is returned if an unexpected error occurred.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETLINK_DUMP_STREAM
+int netlink_start_dump(NETLINK_HANDLE handle, FAR const struct nlmsghdr *req,
+                       netlink_dump_t dump)
+{
+  FAR struct netlink_conn_s *conn = handle;
+  FAR struct nlmsghdr *copy;
+
+  DEBUGASSERT(conn != NULL && req != NULL && dump != NULL);
+
+  copy = kmm_malloc(req->nlmsg_len);
+  if (copy == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* The responses take their flags from the request */
+
+  memcpy(copy, req, req->nlmsg_len);
+  copy->nlmsg_flags |= NLM_F_MULTI;
+
+  net_lock();
+  netlink_end_dump(conn);
+
+  conn->dump    = dump;
+  conn->dumpreq = copy;
+
+  /* Notify any waiters that the dump can be received */
+
+  netlink_notifier_signal(conn);
+  net_unlock();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netlink_tryget_part
+ *
+ * Description:
+ *   Return the next part of the multipart message whose previous part was
+ *   just received, if it fits into the rest of the receive buffer.
+ *
+ * Input Parameters:
+ *   conn  - The Netlink connection
+ *   space - The space left in the receive buffer
+ *
+ * Returned Value:
+ *   The next part or NULL if there is none or if it does not fit.
+ *
+ ****************************************************************************/
+
+FAR struct netlink_response_s *
+netlink_tryget_part(FAR struct netlink_conn_s *conn, size_t space)
+{
+  FAR struct netlink_response_s *resp;
+
+  DEBUGASSERT(conn != NULL);
+
+  net_lock();
+  netlink_continue_dump(conn, space);
+
+  resp = (FAR struct netlink_response_s *)sq_peek(&conn->resplist);
+  if (resp != NULL && (resp->msg.nlmsg_flags & NLM_F_MULTI) != 0 &&
+      resp->msg.nlmsg_len <= space)
+    {
+      sq_remfirst(&conn->resplist);
+    }
+  else
+    {
+      resp = NULL;
+    }
+
+  net_unlock();
+  return resp;
+}
+#endif
+
 #endif /* CONFIG_NET_NETLINK */
@@ -26,7 +26,9 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
@@ -220,6 +222,12 @@ struct nlroute_info_s
 {
   NETLINK_HANDLE handle;
   FAR const struct nlroute_sendto_request_s *req;
+
+  /* Dump progress, see netlink_dump_t */
+
+  unsigned int skip;    /* Entries returned by earlier parts of the dump */
+  unsigned int index;   /* Entries visited so far */
+  size_t space;         /* Space left for this part of the dump */
 };
 
 /****************************************************************************
@@ -274,6 +282,124 @@ static_assert(sizeof(g_ifa_ipv6_policy) / sizeof(g_ifa_ipv6_policy[0]) ==
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: netlink_dump_init
+ *
+ * Description:
+ *   Prepare the state of a table walk that produces one part of a dump.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NETLINK_DISABLE_GETLINK) || \
+    !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
+static void netlink_dump_init(FAR struct nlroute_info_s *info,
+                              NETLINK_HANDLE handle,
+                              FAR const struct nlmsghdr *req,
+                              unsigned int pos, size_t space)
+{
+  info->handle = handle;
+  info->req    = (FAR const struct nlroute_sendto_request_s *)req;
+  info->skip   = pos;
+  info->index  = 0;
+  info->space  = space;
+}
+
+/****************************************************************************
+ * Name: netlink_dump_skip
+ *
+ * Description:
+ *   Return true if the entry being visited was returned by an earlier part
+ *   of the dump already.
+ *
+ ****************************************************************************/
+
+static bool netlink_dump_skip(FAR struct nlroute_info_s *info)
+{
+  return info->index++ < info->skip;
+}
+
+/****************************************************************************
+ * Name: netlink_dump_full
+ *
+ * Description:
+ *   Account for a response of 'len' bytes added to the part of the dump and
+ *   return true if the part has no space left.
+ *
+ ****************************************************************************/
+
+static bool netlink_dump_full(FAR struct nlroute_info_s *info, size_t len)
+{
+  len = NLMSG_ALIGN(len);
+  if (len >= info->space)
+    {
+      info->space = 0;
+      return true;
+    }
+
+  info->space -= len;
+  return false;
+}
+
+/****************************************************************************
+ * Name: netlink_dump_done
+ *
+ * Description:
+ *   Finish a part of the dump after walking the table, 'ret' is the value
+ *   returned by the walk.
+ *
+ ****************************************************************************/
+
+static int netlink_dump_done(FAR struct nlroute_info_s *info, int ret,
+                             FAR unsigned int *pos)
+{
+  /* The walk stops early with a positive value when the part is full */
+
+  if (ret > 0)
+    {
+      *pos = info->index;
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: netlink_dump
+ *
+ * Description:
+ *   Respond to a dump request.  The dump is either started to be produced
+ *   while it is received or it is queued in its entirety now.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NETLINK_DISABLE_GETLINK) || \
+    !defined(CONFIG_NETLINK_DISABLE_GETNEIGH) || \
+    !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
+static int netlink_dump(NETLINK_HANDLE handle,
+                        FAR const struct nlmsghdr *req, netlink_dump_t dump)
+{
+#ifdef CONFIG_NETLINK_DUMP_STREAM
+  return netlink_start_dump(handle, req, dump);
+#else
+  unsigned int pos = 0;
+  int ret;
+
+  do
+    {
+      ret = dump(handle, req, &pos, SIZE_MAX);
+    }
+  while (ret > 0);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return netlink_add_terminator(handle, req, 0);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: netlink_get_device
  *
@@ -483,6 +609,12 @@ static int netlink_device_callback(FAR struct net_driver_s *dev,
 {
   FAR struct nlroute_info_s *info = arg;
   FAR struct netlink_response_s * resp;
+  bool full;
+
+  if (netlink_dump_skip(info))
+    {
+      return OK;
+    }
 
   resp = netlink_get_device(dev, info->req);
   if (resp == NULL)
@@ -490,266 +622,261 @@ static int netlink_device_callback(FAR struct net_driver_s *dev,
       return -ENOMEM;
     }
 
+  full = netlink_dump_full(info, resp->msg.nlmsg_len);
   netlink_add_response(info->handle, resp);
-  return OK;
+  return full ? 1 : OK;
 }
 
-static int netlink_get_devlist(NETLINK_HANDLE handle,
-                              FAR const struct nlroute_sendto_request_s *req)
+static int netlink_dump_devlist(NETLINK_HANDLE handle,
+                                FAR const struct nlmsghdr *req,
+                                FAR unsigned int *pos, size_t space)
 {
   struct nlroute_info_s info;
   int ret;
 
   /* Visit each device */
 
-  info.handle = handle;
-  info.req    = req;
+  netlink_dump_init(&info, handle, req, *pos, space);
 
   net_lock();
   ret = netdev_foreach(netlink_device_callback, &info);
   net_unlock();
-  if (ret < 0)
-    {
-      return ret;
-    }
 
-  return netlink_add_terminator(handle, &req->hdr, 0);
+  return netlink_dump_done(&info, ret, pos);
 }
 #endif
 
 /****************************************************************************
- * Name: netlink_fill_arptable()
+ * Name: netlink_neighbor_size()
  *
  * Description:
- *   Return the entire ARP table.
+ *   Return the size of one entry and the size of the ARP or neighbor table.
  *
  ****************************************************************************/
 
-#if defined(CONFIG_NET_ARP) && !defined(CONFIG_NETLINK_DISABLE_GETNEIGH)
-static size_t netlink_fill_arptable(
-                              FAR struct getneigh_recvfrom_rsplist_s **entry)
+#if !defined(CONFIG_NETLINK_DISABLE_GETNEIGH)
+static size_t netlink_neighbor_size(int domain, FAR unsigned int *tabnum)
 {
-  unsigned int ncopied;
-  size_t allocsize;
-  size_t tabsize;
-  size_t rspsize;
-
-  /* Lock the network so that the ARP table will be stable, then copy
-   * the ARP table into the allocated memory.
-   */
-
-  net_lock();
-  ncopied = arp_snapshot((FAR struct arpreq *)(*entry)->payload.data,
-                         CONFIG_NET_ARPTAB_SIZE);
-  net_unlock();
-
-  /* Now we have the real number of valid entries in the ARP table and
-   * we can trim the allocation.
-   */
-
-  if (ncopied > 0)
+#if defined(CONFIG_NET_ARP)
+  if (domain == AF_INET)
     {
-      FAR struct getneigh_recvfrom_rsplist_s *newentry;
-
-      tabsize = ncopied * sizeof(struct arpreq);
-      rspsize = SIZEOF_NLROUTE_RECVFROM_RESPONSE_S(tabsize);
-      allocsize = SIZEOF_NLROUTE_RECVFROM_RSPLIST_S(tabsize);
-
-      newentry = kmm_realloc(*entry, allocsize);
-
-      if (newentry != NULL)
-        {
-          *entry = newentry;
-        }
+      *tabnum = CONFIG_NET_ARPTAB_SIZE;
+      return sizeof(struct arpreq);
+    }
+#endif
 
-      (*entry)->payload.hdr.nlmsg_len = rspsize;
-      (*entry)->payload.attr.rta_len  = RTA_LENGTH(tabsize);
+#if defined(CONFIG_NET_IPv6)
+  if (domain == AF_INET6)
+    {
+      *tabnum = CONFIG_NET_IPv6_NCONF_ENTRIES;
+      return sizeof(struct neighbor_entry_s);
     }
+#endif
 
-  return ncopied;
+  return 0;
 }
-#endif
 
 /****************************************************************************
- * Name: netlink_fill_nbtable()
+ * Name: netlink_alloc_neighbor()
  *
  * Description:
- *   Return the entire IPv6 neighbor table.
+ *   Allocate a neighbor response with room for 'tabsize' bytes of entries.
  *
  ****************************************************************************/
 
-#if defined(CONFIG_NET_IPv6) && !defined(CONFIG_NETLINK_DISABLE_GETNEIGH)
-static size_t netlink_fill_nbtable(
-                              FAR struct getneigh_recvfrom_rsplist_s **entry)
+static FAR struct getneigh_recvfrom_rsplist_s *
+netlink_alloc_neighbor(int domain, int type, size_t tabsize,
+                       FAR const struct nlmsghdr *req)
 {
-  unsigned int ncopied;
-  size_t allocsize;
-  size_t tabsize;
-  size_t rspsize;
-
-  /* Lock the network so that the Neighbor table will be stable, then
-   * copy the Neighbor table into the allocated memory.
-   */
-
-  net_lock();
-  ncopied = neighbor_snapshot(
-                      (FAR struct neighbor_entry_s *)(*entry)->payload.data,
-                      CONFIG_NET_IPv6_NCONF_ENTRIES);
-  net_unlock();
+  FAR struct getneigh_recvfrom_rsplist_s *alloc;
+  FAR struct getneigh_recvfrom_response_s *resp;
 
-  /* Now we have the real number of valid entries in the Neighbor table
-   * and we can trim the allocation.
-   */
+  /* Allocate the response buffer */
 
-  if (ncopied > 0)
+  alloc = kmm_zalloc(SIZEOF_NLROUTE_RECVFROM_RSPLIST_S(tabsize));
+  if (alloc == NULL)
     {
-      FAR struct getneigh_recvfrom_rsplist_s *newentry;
-
-      tabsize   = ncopied * sizeof(struct neighbor_entry_s);
-      rspsize   = SIZEOF_NLROUTE_RECVFROM_RESPONSE_S(tabsize);
-      allocsize = SIZEOF_NLROUTE_RECVFROM_RSPLIST_S(tabsize);
+      nerr("ERROR: Failed to allocate response buffer.\n");
+      return NULL;
+    }
 
-      newentry = kmm_realloc(*entry, allocsize);
+  /* Initialize the response buffer */
 
-      if (newentry != NULL)
-        {
-          *entry = newentry;
-        }
+  resp                  = &alloc->payload;
+  resp->hdr.nlmsg_len   = SIZEOF_NLROUTE_RECVFROM_RESPONSE_S(tabsize);
+  resp->hdr.nlmsg_type  = type;
+  resp->hdr.nlmsg_flags = req ? req->nlmsg_flags : 0;
+  resp->hdr.nlmsg_seq   = req ? req->nlmsg_seq : 0;
+  resp->hdr.nlmsg_pid   = req ? req->nlmsg_pid : 0;
 
-      (*entry)->payload.hdr.nlmsg_len = rspsize;
-      (*entry)->payload.attr.rta_len  = RTA_LENGTH(tabsize);
-    }
+  resp->msg.ndm_family = domain;
+  resp->attr.rta_len   = RTA_LENGTH(tabsize);
 
-  return ncopied;
+  return alloc;
 }
-#endif
 
 /****************************************************************************
- * Name: netlink_fill_nbtable()
+ * Name: netlink_get_neighbor()
  *
  * Description:
- *   Return the entire IPv6 neighbor table.
+ *   Generate the response that notifies one neighbor entry.
  *
  ****************************************************************************/
 
-#if !defined(CONFIG_NETLINK_DISABLE_GETNEIGH)
 static FAR struct netlink_response_s *
-netlink_get_neighbor(FAR const void *neigh, int domain, int type,
-                     FAR const struct nlroute_sendto_request_s *req)
+netlink_get_neighbor(FAR const void *neigh, int domain, int type)
 {
   FAR struct getneigh_recvfrom_rsplist_s *alloc;
-  FAR struct getneigh_recvfrom_response_s *resp;
-  size_t allocsize;
-  size_t tabsize;
-  size_t tabnum;
-  size_t rspsize;
-
-  /* Preallocate memory to hold the maximum sized ARP table
-   * REVISIT:  This is probably excessively large and could cause false
-   * memory out conditions.  A better approach would be to actually count
-   * the number of valid entries in the ARP table.
-   */
+  unsigned int tabnum;
+  size_t entsize;
 
-#if defined(CONFIG_NET_ARP)
-  if (domain == AF_INET)
-    {
-      tabnum  = req ? CONFIG_NET_ARPTAB_SIZE : 1;
-      tabsize = tabnum * sizeof(struct arpreq);
-    }
-  else
-#endif
-#if defined(CONFIG_NET_IPv6)
-  if (domain == AF_INET6)
-    {
-      tabnum  = req ? CONFIG_NET_IPv6_NCONF_ENTRIES : 1;
-      tabsize = tabnum * sizeof(struct neighbor_entry_s);
-    }
-  else
-#endif
+  entsize = netlink_neighbor_size(domain, &tabnum);
+  if (entsize == 0 || neigh == NULL)
     {
       return NULL;
     }
 
-  rspsize   = SIZEOF_NLROUTE_RECVFROM_RESPONSE_S(tabsize);
-  allocsize = SIZEOF_NLROUTE_RECVFROM_RSPLIST_S(tabsize);
-
-  /* Allocate the response buffer */
-
-  alloc = kmm_zalloc(allocsize);
+  alloc = netlink_alloc_neighbor(domain, type, entsize, NULL);
   if (alloc == NULL)
     {
-      nerr("ERROR: Failed to allocate response buffer.\n");
       return NULL;
     }
 
-  /* Initialize the response buffer */
-
-  resp                  = &alloc->payload;
-  resp->hdr.nlmsg_len   = rspsize;
-  resp->hdr.nlmsg_type  = type;
-  resp->hdr.nlmsg_flags = req ? req->hdr.nlmsg_flags : 0;
-  resp->hdr.nlmsg_seq   = req ? req->hdr.nlmsg_seq : 0;
-  resp->hdr.nlmsg_pid   = req ? req->hdr.nlmsg_pid : 0;
+  memcpy(alloc->payload.data, neigh, entsize);
+  return (FAR struct netlink_response_s *)alloc;
+}
 
-  resp->msg.ndm_family = domain;
-  resp->attr.rta_len   = RTA_LENGTH(tabsize);
+/****************************************************************************
+ * Name: netlink_dump_neighbor()
+ *
+ * Description:
+ *   Return the next part of the ARP or IPv6 neighbor table, as many entries
+ *   as fit into 'space' in one message.
+ *
+ ****************************************************************************/
 
-  /* Copy neigh or arp entries into resp data */
+static int netlink_dump_neighbor(NETLINK_HANDLE handle,
+                                 FAR const struct nlmsghdr *req,
+                                 FAR unsigned int *pos, size_t space,
+                                 int domain)
+{
+  FAR struct getneigh_recvfrom_rsplist_s *alloc;
+  FAR struct getneigh_recvfrom_rsplist_s *newentry;
+  unsigned int ncopied = 0;
+  unsigned int tabnum;
+  size_t entsize;
+  size_t tabsize;
 
-  if (req == NULL)
+  entsize = netlink_neighbor_size(domain, &tabnum);
+  if (entsize == 0)
     {
-      if (neigh == NULL)
-        {
-          return NULL;
-        }
+      return -EAFNOSUPPORT;
+    }
 
-      /* Only one entry need to notify */
+  /* Take as many entries as fit, but at least one */
 
-      memcpy(resp->data, neigh, tabsize);
+  if (space > SIZEOF_NLROUTE_RECVFROM_RESPONSE_S(entsize))
+    {
+      tabnum = MIN(tabnum, (space - SIZEOF_NLROUTE_RECVFROM_RESPONSE_S(0)) /
+                           entsize);
     }
+  else
+    {
+      tabnum = 1;
+    }
+
+  alloc = netlink_alloc_neighbor(domain, RTM_GETNEIGH, tabnum * entsize,
+                                 req);
+  if (alloc == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Lock the network so that the table will be stable, then copy the
+   * entries that follow those of the earlier parts.
+   */
+
+  net_lock();
 #if defined(CONFIG_NET_ARP)
-  else if (domain == AF_INET)
+  if (domain == AF_INET)
     {
-      tabnum = netlink_fill_arptable(&alloc);
+      ncopied = arp_snapshot((FAR struct arpreq *)alloc->payload.data,
+                             tabnum, *pos);
     }
 #endif
+
 #if defined(CONFIG_NET_IPv6)
-  else if (domain == AF_INET6)
+  if (domain == AF_INET6)
     {
-      tabnum = netlink_fill_nbtable(&alloc);
+      ncopied = neighbor_snapshot(
+                  (FAR struct neighbor_entry_s *)alloc->payload.data,
+                  tabnum, *pos);
     }
 #endif
 
+  net_unlock();
+
   /* If no entry in table, just free alloc */
 
-  if (tabnum <= 0)
+  if (ncopied == 0)
     {
       kmm_free(alloc);
+      if (*pos > 0)
+        {
+          return 0;
+        }
+
       nwarn("WARNING: Failed to get entry in %s table.\n",
             domain == AF_INET ? "ARP" : "neighbor");
-      return NULL;
+      return -ENOENT;
     }
 
-  return (FAR struct netlink_response_s *)alloc;
-}
-
-static int netlink_get_neighborlist(NETLINK_HANDLE handle, int domain,
-                              FAR const struct nlroute_sendto_request_s *req)
-{
-  FAR struct netlink_response_s *resp;
+  /* Now we have the real number of entries and we can trim the
+   * allocation.
+   */
 
-  resp = netlink_get_neighbor(NULL, domain, RTM_GETNEIGH, req);
-  if (resp == NULL)
+  if (ncopied < tabnum)
     {
-      return -ENOENT;
+      tabsize  = ncopied * entsize;
+      newentry = kmm_realloc(alloc,
+                             SIZEOF_NLROUTE_RECVFROM_RSPLIST_S(tabsize));
+      if (newentry != NULL)
+        {
+          alloc = newentry;
+        }
+
+      alloc->payload.hdr.nlmsg_len =
+        SIZEOF_NLROUTE_RECVFROM_RESPONSE_S(tabsize);
+      alloc->payload.attr.rta_len  = RTA_LENGTH(tabsize);
     }
 
-  netlink_add_response(handle, resp);
+  netlink_add_response(handle, (FAR struct netlink_response_s *)alloc);
 
-  return netlink_add_terminator(handle, &req->hdr, 0);
+  /* A part that is not full has reached the end of the table */
+
+  *pos += ncopied;
+  return ncopied < tabnum ? 0 : 1;
 }
 #endif /* CONFIG_NETLINK_DISABLE_GETNEIGH */
 
+#if defined(CONFIG_NET_ARP) && !defined(CONFIG_NETLINK_DISABLE_GETNEIGH)
+static int netlink_dump_arptable(NETLINK_HANDLE handle,
+                                 FAR const struct nlmsghdr *req,
+                                 FAR unsigned int *pos, size_t space)
+{
+  return netlink_dump_neighbor(handle, req, pos, space, AF_INET);
+}
+#endif
+
+#if defined(CONFIG_NET_IPv6) && !defined(CONFIG_NETLINK_DISABLE_GETNEIGH)
+static int netlink_dump_nbtable(NETLINK_HANDLE handle,
+                                FAR const struct nlmsghdr *req,
+                                FAR unsigned int *pos, size_t space)
+{
+  return netlink_dump_neighbor(handle, req, pos, space, AF_INET6);
+}
+#endif
+
 /****************************************************************************
  * Name: netlink_ipv4_route
  *
@@ -820,6 +947,12 @@ static int netlink_ipv4route_callback(FAR struct net_route_ipv4_s *route,
 {
   FAR struct nlroute_info_s *info = arg;
   FAR struct netlink_response_s *resp;
+  bool full;
+
+  if (netlink_dump_skip(info))
+    {
+      return OK;
+    }
 
   resp = netlink_get_ipv4_route(route, RTM_NEWROUTE, info->req);
   if (resp == NULL)
@@ -829,8 +962,9 @@ static int netlink_ipv4route_callback(FAR struct net_route_ipv4_s *route,
 
   /* Finally, add the response to the list of pending responses */
 
+  full = netlink_dump_full(info, resp->msg.nlmsg_len);
   netlink_add_response(info->handle, resp);
-  return OK;
+  return full ? 1 : OK;
 }
 #endif
 
@@ -844,25 +978,18 @@ static int netlink_ipv4route_callback(FAR struct net_route_ipv4_s *route,
 
 #if defined(CONFIG_NET_IPv4) && !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
 static int netlink_list_ipv4_route(NETLINK_HANDLE handle,
-                              FAR const struct nlroute_sendto_request_s *req)
+                                   FAR const struct nlmsghdr *req,
+                                   FAR unsigned int *pos, size_t space)
 {
   struct nlroute_info_s info;
   int ret;
 
   /* Visit each routing table entry */
 
-  info.handle = handle;
-  info.req    = req;
+  netlink_dump_init(&info, handle, req, *pos, space);
 
   ret = net_foreachroute_ipv4(netlink_ipv4route_callback, &info);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  /* Terminate the routing table */
-
-  return netlink_add_terminator(handle, &req->hdr, 0);
+  return netlink_dump_done(&info, ret, pos);
 }
 #endif
 
@@ -939,6 +1066,12 @@ static int netlink_ipv6route_callback(FAR struct net_route_ipv6_s *route,
 {
   FAR struct nlroute_info_s *info = arg;
   FAR struct netlink_response_s *resp;
+  bool full;
+
+  if (netlink_dump_skip(info))
+    {
+      return OK;
+    }
 
   resp = netlink_get_ipv6_route(route, RTM_NEWROUTE, info->req);
   if (resp == NULL)
@@ -948,9 +1081,9 @@ static int netlink_ipv6route_callback(FAR struct net_route_ipv6_s *route,
 
   /* Finally, add the response to the list of pending responses */
 
+  full = netlink_dump_full(info, resp->msg.nlmsg_len);
   netlink_add_response(info->handle, resp);
-
-  return OK;
+  return full ? 1 : OK;
 }
 #endif
 
@@ -964,25 +1097,18 @@ static int netlink_ipv6route_callback(FAR struct net_route_ipv6_s *route,
 
 #if defined(CONFIG_NET_IPv6) && !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
 static int netlink_list_ipv6_route(NETLINK_HANDLE handle,
-                              FAR const struct nlroute_sendto_request_s *req)
+                                   FAR const struct nlmsghdr *req,
+                                   FAR unsigned int *pos, size_t space)
 {
   struct nlroute_info_s info;
   int ret;
 
   /* Visit each routing table entry */
 
-  info.handle = handle;
-  info.req    = req;
+  netlink_dump_init(&info, handle, req, *pos, space);
 
   ret = net_foreachroute_ipv6(netlink_ipv6route_callback, &info);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  /* Terminate the routing table */
-
-  return netlink_add_terminator(handle, &req->hdr, 0);
+  return netlink_dump_done(&info, ret, pos);
 }
 #endif
 
@@ -1369,7 +1495,7 @@ ssize_t netlink_route_sendto(NETLINK_HANDLE handle,
 
         /* Generate the response */
 
-        ret = netlink_get_devlist(handle, req);
+        ret = netlink_dump(handle, nlmsg, netlink_dump_devlist);
         break;
 #endif
 
@@ -1382,7 +1508,7 @@ ssize_t netlink_route_sendto(NETLINK_HANDLE handle,
 
         if (req->gen.rtgen_family == AF_INET)
           {
-            ret = netlink_get_neighborlist(handle, AF_INET, req);
+            ret = netlink_dump(handle, nlmsg, netlink_dump_arptable);
           }
         else
 #endif
@@ -1392,7 +1518,7 @@ ssize_t netlink_route_sendto(NETLINK_HANDLE handle,
 
         if (req->gen.rtgen_family == AF_INET6)
           {
-             ret = netlink_get_neighborlist(handle, AF_INET6, req);
+            ret = netlink_dump(handle, nlmsg, netlink_dump_nbtable);
           }
         else
 #endif
@@ -1409,14 +1535,14 @@ ssize_t netlink_route_sendto(NETLINK_HANDLE handle,
 #ifdef CONFIG_NET_IPv4
         if (req->gen.rtgen_family == AF_INET)
           {
-            ret = netlink_list_ipv4_route(handle, req);
+            ret = netlink_dump(handle, nlmsg, netlink_list_ipv4_route);
           }
         else
 #endif
 #ifdef CONFIG_NET_IPv6
         if (req->gen.rtgen_family == AF_INET6)
           {
-            ret = netlink_list_ipv6_route(handle, req);
+            ret = netlink_dump(handle, nlmsg, netlink_list_ipv6_route);
           }
         else
 #endif
@@ -1652,7 +1778,7 @@ void netlink_neigh_notify(FAR const void *neigh, int type, int domain)
 {
   FAR struct netlink_response_s *resp;
 
-  resp = netlink_get_neighbor(neigh, domain, type, NULL);
+  resp = netlink_get_neighbor(neigh, domain, type);
   if (resp == NULL)
     {
       return;
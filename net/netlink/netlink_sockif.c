@@ -675,6 +675,7 @@ static ssize_t netlink_recvmsg(FAR struct socket *psock,
   FAR socklen_t *fromlen = &msg->msg_namelen;
   FAR struct netlink_response_s *entry;
   FAR struct socket_conn_s *conn;
+  size_t total;
   int ret = OK;
 
   DEBUGASSERT(from == NULL ||
@@ -682,7 +683,7 @@ static ssize_t netlink_recvmsg(FAR struct socket *psock,
 
   /* Find the response to this message.  The return value */
 
-  entry = netlink_tryget_response(psock->s_conn);
+  entry = netlink_tryget_response(psock->s_conn, len);
   if (entry == NULL)
     {
       conn = psock->s_conn;
@@ -698,7 +699,7 @@ static ssize_t netlink_recvmsg(FAR struct socket *psock,
 
       /* Wait for the response. */
 
-      ret = netlink_get_response(psock->s_conn, &entry);
+      ret = netlink_get_response(psock->s_conn, len, &entry);
 
       /* If interrupted by signals, return errno */
 
@@ -708,14 +709,43 @@ static ssize_t netlink_recvmsg(FAR struct socket *psock,
         }
     }
 
-  if (len > entry->msg.nlmsg_len)
+  total = entry->msg.nlmsg_len;
+  if (total > len)
     {
-      len = entry->msg.nlmsg_len;
+      total = len;
     }
 
   /* Copy the payload to the user buffer */
 
-  memcpy(buf, &entry->msg, len);
+  memcpy(buf, &entry->msg, total);
+
+#ifdef CONFIG_NETLINK_DUMP_STREAM
+  /* Return the following parts of a multipart message too, as many as fit
+   * completely into the user buffer.
+   */
+
+  while ((entry->msg.nlmsg_flags & NLM_F_MULTI) != 0 &&
+         entry->msg.nlmsg_type != NLMSG_DONE &&
+         NLMSG_ALIGN(total) < len)
+    {
+      FAR struct netlink_response_s *next;
+      size_t offset = NLMSG_ALIGN(total);
+
+      next = netlink_tryget_part(psock->s_conn, len - offset);
+      if (next == NULL)
+        {
+          break;
+        }
+
+      kmm_free(entry);
+      entry = next;
+
+      memcpy((FAR uint8_t *)buf + offset, &entry->msg,
+             entry->msg.nlmsg_len);
+      total = offset + entry->msg.nlmsg_len;
+    }
+#endif
+
   kmm_free(entry);
 
   if (from != NULL)
@@ -723,7 +753,7 @@ static ssize_t netlink_recvmsg(FAR struct socket *psock,
       netlink_getpeername(psock, from, fromlen);
     }
 
-  return len;
+  return total;
 }
 
 /****************************************************************************
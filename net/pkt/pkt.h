@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <netpacket/packet.h>
 
 #include <nuttx/net/net.h>
 
@@ -53,6 +54,7 @@
 /* Representation of a packet socket connection */
 
 struct devif_callback_s; /* Forward reference */
+struct pkt_ring_s;       /* Forward reference */
 
 struct pkt_conn_s
 {
@@ -69,11 +71,19 @@ struct pkt_conn_s
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the PKT read-ahead data is retained.
-   *
-   * TODO: Maybe support PACKET_MMAP for further optimize.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+
+#ifdef CONFIG_NET_PKT_RXRING
+  /* The memory-mapped RX ring that replaces the read-ahead buffering once
+   * set up, and the threads that poll() the socket.
+   */
+
+  FAR struct pkt_ring_s *ring;
+  FAR struct pollfd *fds[CONFIG_NET_PKT_NPOLLWAITERS];
+  uint8_t    version;  /* PACKET_VERSION, the frame format of the ring */
+#endif
 };
 
 /****************************************************************************
@@ -292,6 +302,95 @@ void pkt_poll(FAR struct net_driver_s *dev, FAR struct pkt_conn_s *conn);
 ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                     int flags);
 
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Set up the memory-mapped RX ring of a packet socket as requested with
+ *   the PACKET_RX_RING socket option, or release it if tp_block_nr is zero.
+ *
+ * Input Parameters:
+ *   conn - The packet socket connection
+ *   req  - The requested ring geometry
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure.  -EBUSY is
+ *   returned if the current ring is mapped.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_RXRING
+int pkt_ring_setup(FAR struct pkt_conn_s *conn,
+                   FAR const struct tpacket_req3 *req);
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Release the RX ring of a packet socket that is closed.
+ *
+ * Assumptions:
+ *   The network is not locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy the frame received by 'dev' into the RX ring of 'conn'.  The frame
+ *   is counted as dropped if the ring is full.
+ *
+ * Assumptions:
+ *   The network is locked and dev->d_buf points to the link layer header.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Map the RX ring of a packet socket into the caller's address space.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct pkt_conn_s *conn,
+                  FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Name: pkt_ring_readable
+ *
+ * Description:
+ *   Return true if a block of the RX ring is owned by user space.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_readable(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_stats
+ *
+ * Description:
+ *   Return and reset the statistics of the RX ring, as PACKET_STATISTICS
+ *   does.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_stats(FAR struct pkt_conn_s *conn,
+                    FAR struct tpacket_stats_v3 *stats);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
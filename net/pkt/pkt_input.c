@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 #if defined(CONFIG_NET) && defined(CONFIG_NET_PKT)
 
+#include <poll.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -93,6 +94,10 @@ static uint16_t pkt_datahandler(FAR struct net_driver_s *dev,
   else
     {
       ninfo("Buffered %d bytes\n", dev->d_len);
+
+#ifdef CONFIG_NET_PKT_RXRING
+      poll_notify(conn->fds, CONFIG_NET_PKT_NPOLLWAITERS, POLLIN);
+#endif
       return dev->d_len;
     }
 
@@ -135,6 +140,17 @@ static int pkt_in(FAR struct net_driver_s *dev)
   int ret = OK;
 
   conn = pkt_active(dev);
+#ifdef CONFIG_NET_PKT_RXRING
+  if (conn && conn->ring)
+    {
+      /* The frame goes to the memory-mapped ring instead of a recvfrom()
+       * waiting or the read-ahead buffering.
+       */
+
+      pkt_ring_input(dev, conn);
+    }
+  else
+#endif
   if (conn)
     {
       uint16_t flags;
@@ -0,0 +1,563 @@
+/****************************************************************************
+ * net/pkt/pkt_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <poll.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <net/ethernet.h>
+#include <net/if_arp.h>
+#include <netpacket/packet.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+
+#include "devif/devif.h"
+#include "pkt/pkt.h"
+
+#ifdef CONFIG_NET_PKT_RXRING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The block timeout if none is requested, in milliseconds */
+
+#define PKT_RING_DEFAULT_TOV  8
+
+/* The block header and the private area that precede the first frame */
+
+#define PKT_RING_BLKHDRLEN    TPACKET_ALIGN(sizeof(struct tpacket_block_desc))
+
+/* The frame header and the address that precede the frame data */
+
+#define PKT_RING_MACOFF       TPACKET_ALIGN(TPACKET3_HDRLEN)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct pkt_ring_s
+{
+  FAR struct pkt_conn_s *conn;          /* The owner of the ring */
+  FAR uint8_t *base;                    /* The blocks, mapped by user space */
+  uint32_t blksize;                     /* The size of a block */
+  uint32_t blknr;                       /* The number of blocks */
+  uint32_t framesize;                   /* The maximum size of a frame */
+  uint32_t first;                       /* Offset of the first frame */
+  uint32_t offset;                      /* The next free byte, 0 if closed */
+  uint32_t last;                        /* Offset of the last frame */
+  unsigned int cur;                     /* The block that is filled */
+  unsigned int tov;                     /* The block timeout in ticks */
+  uint64_t seq;                         /* Sequence number of the block */
+  uint64_t tmoseq;                      /* The block the timeout is for */
+  struct tpacket_stats_v3 stats;        /* PACKET_STATISTICS */
+  bool losing;                          /* Frames dropped since the last */
+  bool mapped;                          /* The ring was mapped */
+  struct work_s work;                   /* The block timeout */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_block
+ ****************************************************************************/
+
+static inline FAR struct tpacket_block_desc *
+pkt_ring_block(FAR struct pkt_ring_s *ring, unsigned int blk)
+{
+  return (FAR struct tpacket_block_desc *)
+         (ring->base + (size_t)blk * ring->blksize);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_retire
+ *
+ * Description:
+ *   Pass the block that is filled to user space and wake up the threads
+ *   that poll the socket.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_retire(FAR struct pkt_ring_s *ring, uint32_t status)
+{
+  FAR struct tpacket_block_desc *blk = pkt_ring_block(ring, ring->cur);
+
+  if (ring->losing)
+    {
+      status      |= TP_STATUS_LOSING;
+      ring->losing = false;
+    }
+
+  /* The block must be complete before user space sees its status */
+
+  SP_DMB();
+  blk->hdr.bh1.block_status = TP_STATUS_USER | status;
+
+  ring->offset = 0;
+  ring->cur    = (ring->cur + 1) % ring->blknr;
+
+  poll_notify(ring->conn->fds, CONFIG_NET_PKT_NPOLLWAITERS, POLLIN);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_timeout
+ *
+ * Description:
+ *   Retire a block that is not full when its timeout expires, so that user
+ *   space does not wait for more frames on a quiet link.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_timeout(FAR void *arg)
+{
+  FAR struct pkt_ring_s *ring = arg;
+
+  net_lock();
+
+  /* The ring may be released meanwhile, the block retired as full or
+   * another block opened.
+   */
+
+  if (ring->conn->ring == ring && ring->offset != 0 &&
+      ring->tmoseq == ring->seq)
+    {
+      pkt_ring_retire(ring, TP_STATUS_BLK_TMO);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: pkt_ring_open
+ *
+ * Description:
+ *   Start filling the next block if user space has handed it back.
+ *
+ ****************************************************************************/
+
+static bool pkt_ring_open(FAR struct pkt_ring_s *ring)
+{
+  FAR struct tpacket_block_desc *blk = pkt_ring_block(ring, ring->cur);
+  FAR struct tpacket_hdr_v1 *bh1 = &blk->hdr.bh1;
+
+  if (bh1->block_status != TP_STATUS_KERNEL)
+    {
+      return false;
+    }
+
+  SP_DMB();
+
+  blk->version        = TPACKET_V3;
+  blk->offset_to_priv = PKT_RING_BLKHDRLEN;
+
+  bh1->num_pkts            = 0;
+  bh1->offset_to_first_pkt = ring->first;
+  bh1->blk_len             = ring->first;
+  bh1->seq_num             = ++ring->seq;
+
+  ring->offset = ring->first;
+  ring->last   = 0;
+
+  ring->tmoseq = ring->seq;
+  work_queue(LPWORK, &ring->work, pkt_ring_timeout, ring, ring->tov);
+  return true;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_address
+ *
+ * Description:
+ *   Fill in the link layer address of the frame in the ring.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_address(FAR struct net_driver_s *dev,
+                             FAR struct sockaddr_ll *addr)
+{
+  memset(addr, 0, sizeof(*addr));
+  addr->sll_family  = AF_PACKET;
+  addr->sll_ifindex = dev->d_ifindex;
+
+#ifdef CONFIG_NET_ETHERNET
+  if (dev->d_lltype == NET_LL_ETHERNET)
+    {
+      FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)dev->d_buf;
+
+      addr->sll_protocol = eth->type;
+      addr->sll_hatype   = ARPHRD_ETHER;
+      addr->sll_halen    = ETHER_ADDR_LEN;
+      memcpy(addr->sll_addr, eth->src, ETHER_ADDR_LEN);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Set up the memory-mapped RX ring of a packet socket as requested with
+ *   the PACKET_RX_RING socket option, or release it if tp_block_nr is zero.
+ *
+ * Input Parameters:
+ *   conn - The packet socket connection
+ *   req  - The requested ring geometry
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure.  -EBUSY is
+ *   returned if the current ring is mapped.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn,
+                   FAR const struct tpacket_req3 *req)
+{
+  FAR struct pkt_ring_s *ring = NULL;
+  FAR struct pkt_ring_s *old;
+  uint32_t first;
+
+  if (conn->version != TPACKET_V3)
+    {
+      return -EINVAL;
+    }
+
+  if (req->tp_block_nr != 0)
+    {
+      /* The blocks must hold at least one frame after the block header and
+       * the private area, and the frames must hold the frame header.
+       */
+
+      first = TPACKET_ALIGN(PKT_RING_BLKHDRLEN + req->tp_sizeof_priv);
+
+      if (req->tp_frame_size <= PKT_RING_MACOFF ||
+          (req->tp_frame_size & (TPACKET_ALIGNMENT - 1)) != 0 ||
+          (req->tp_block_size & (TPACKET_ALIGNMENT - 1)) != 0 ||
+          req->tp_sizeof_priv >= req->tp_block_size ||
+          first + req->tp_frame_size > req->tp_block_size ||
+          req->tp_block_nr > SIZE_MAX / req->tp_block_size ||
+          req->tp_frame_nr != req->tp_block_nr *
+                              (req->tp_block_size / req->tp_frame_size))
+        {
+          return -EINVAL;
+        }
+
+      ring = kmm_zalloc(sizeof(struct pkt_ring_s));
+      if (ring == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      /* The blocks start out zeroed, as TP_STATUS_KERNEL */
+
+      ring->base = kumm_memalign(TPACKET_ALIGNMENT,
+                                 (size_t)req->tp_block_size *
+                                 req->tp_block_nr);
+      if (ring->base == NULL)
+        {
+          kmm_free(ring);
+          return -ENOMEM;
+        }
+
+      memset(ring->base, 0, (size_t)req->tp_block_size * req->tp_block_nr);
+
+      ring->conn      = conn;
+      ring->blksize   = req->tp_block_size;
+      ring->blknr     = req->tp_block_nr;
+      ring->framesize = req->tp_frame_size;
+      ring->first     = first;
+      ring->tov       = MSEC2TICK(req->tp_retire_blk_tov != 0 ?
+                                  req->tp_retire_blk_tov :
+                                  PKT_RING_DEFAULT_TOV);
+    }
+
+  net_lock();
+
+  old = conn->ring;
+  if (old != NULL && old->mapped)
+    {
+      net_unlock();
+
+      if (ring != NULL)
+        {
+          kumm_free(ring->base);
+          kmm_free(ring);
+        }
+
+      return -EBUSY;
+    }
+
+  conn->ring = ring;
+  net_unlock();
+
+  if (old != NULL)
+    {
+      work_cancel_sync(LPWORK, &old->work);
+      kumm_free(old->base);
+      kmm_free(old);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Release the RX ring of a packet socket that is closed.
+ *
+ * Assumptions:
+ *   The network is not locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring;
+
+  net_lock();
+  ring       = conn->ring;
+  conn->ring = NULL;
+  net_unlock();
+
+  if (ring != NULL)
+    {
+      work_cancel_sync(LPWORK, &ring->work);
+      kumm_free(ring->base);
+      kmm_free(ring);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy the frame received by 'dev' into the RX ring of 'conn'.  The frame
+ *   is counted as dropped if the ring is full.
+ *
+ * Assumptions:
+ *   The network is locked and dev->d_buf points to the link layer header.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = conn->ring;
+  FAR struct tpacket_block_desc *blk;
+  FAR struct tpacket3_hdr *hdr;
+  struct timespec ts;
+  uint32_t snaplen;
+  uint32_t need;
+
+  ring->stats.tp_packets++;
+
+  /* Frames longer than the frame size are truncated */
+
+  snaplen = dev->d_len;
+  if (PKT_RING_MACOFF + snaplen > ring->framesize)
+    {
+      snaplen = ring->framesize - PKT_RING_MACOFF;
+    }
+
+  need = TPACKET_ALIGN(PKT_RING_MACOFF + snaplen);
+
+  /* Retire the block if the frame does not fit, then open the next one
+   * unless user space still owns it.
+   */
+
+  if (ring->offset != 0 && ring->offset + need > ring->blksize)
+    {
+      pkt_ring_retire(ring, 0);
+    }
+
+  if (ring->offset == 0 && !pkt_ring_open(ring))
+    {
+      ring->stats.tp_drops++;
+      ring->losing = true;
+      return;
+    }
+
+  blk = pkt_ring_block(ring, ring->cur);
+  hdr = (FAR struct tpacket3_hdr *)((FAR uint8_t *)blk + ring->offset);
+
+  nxclock_gettime(CLOCK_REALTIME, &ts);
+
+  memset(hdr, 0, sizeof(*hdr));
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_nsec    = ts.tv_nsec;
+  hdr->tp_snaplen = snaplen;
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_status  = TP_STATUS_USER;
+  hdr->tp_mac     = PKT_RING_MACOFF;
+  hdr->tp_net     = PKT_RING_MACOFF + NET_LL_HDRLEN(dev);
+
+  pkt_ring_address(dev, (FAR struct sockaddr_ll *)
+                   ((FAR uint8_t *)hdr +
+                    TPACKET_ALIGN(sizeof(struct tpacket3_hdr))));
+
+  iob_copyout((FAR uint8_t *)hdr + PKT_RING_MACOFF, dev->d_iob, snaplen,
+              -NET_LL_HDRLEN(dev));
+
+  /* Link the frame to the previous one of the block */
+
+  if (ring->last != 0)
+    {
+      ((FAR struct tpacket3_hdr *)((FAR uint8_t *)blk + ring->last))->
+        tp_next_offset = ring->offset - ring->last;
+    }
+  else
+    {
+      blk->hdr.bh1.ts_first_pkt.ts_sec  = ts.tv_sec;
+      blk->hdr.bh1.ts_first_pkt.ts_nsec = ts.tv_nsec;
+    }
+
+  blk->hdr.bh1.ts_last_pkt.ts_sec  = ts.tv_sec;
+  blk->hdr.bh1.ts_last_pkt.ts_nsec = ts.tv_nsec;
+  blk->hdr.bh1.num_pkts++;
+
+  ring->last    = ring->offset;
+  ring->offset += need;
+  blk->hdr.bh1.blk_len = ring->offset;
+
+  /* Retire the block at once if not even the smallest frame fits anymore */
+
+  if (ring->offset + TPACKET_ALIGN(PKT_RING_MACOFF + 1) > ring->blksize)
+    {
+      pkt_ring_retire(ring, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Map the RX ring of a packet socket into the caller's address space.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct pkt_conn_s *conn,
+                  FAR struct mm_map_entry_s *map)
+{
+  FAR struct pkt_ring_s *ring;
+  size_t size;
+  int ret = -EINVAL;
+
+  net_lock();
+
+  ring = conn->ring;
+  if (ring != NULL)
+    {
+      size = (size_t)ring->blksize * ring->blknr;
+      if (map->offset >= 0 && map->length != 0 &&
+          map->offset + map->length <= size)
+        {
+          map->vaddr   = ring->base + map->offset;
+          ring->mapped = true;
+          ret          = OK;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_readable
+ *
+ * Description:
+ *   Return true if a block of the RX ring is owned by user space.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_readable(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = conn->ring;
+  unsigned int i;
+
+  for (i = 0; i < ring->blknr; i++)
+    {
+      if ((pkt_ring_block(ring, i)->hdr.bh1.block_status &
+           TP_STATUS_USER) != 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_stats
+ *
+ * Description:
+ *   Return and reset the statistics of the RX ring, as PACKET_STATISTICS
+ *   does.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_stats(FAR struct pkt_conn_s *conn,
+                    FAR struct tpacket_stats_v3 *stats)
+{
+  FAR struct pkt_ring_s *ring = conn->ring;
+
+  if (ring == NULL)
+    {
+      memset(stats, 0, sizeof(*stats));
+      return;
+    }
+
+  *stats = ring->stats;
+  memset(&ring->stats, 0, sizeof(ring->stats));
+}
+
+#endif /* CONFIG_NET_PKT_RXRING */
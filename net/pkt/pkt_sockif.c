@@ -30,6 +30,7 @@
 #include <sys/socket.h>
 #include <stdbool.h>
 #include <string.h>
+#include <poll.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
@@ -55,6 +56,16 @@ static void       pkt_addref(FAR struct socket *psock);
 static int        pkt_bind(FAR struct socket *psock,
                     FAR const struct sockaddr *addr, socklen_t addrlen);
 static int        pkt_close(FAR struct socket *psock);
+#ifdef CONFIG_NET_PKT_RXRING
+static int        pkt_poll_local(FAR struct socket *psock,
+                    FAR struct pollfd *fds, bool setup);
+static int        pkt_getsockopt(FAR struct socket *psock, int level,
+                    int option, FAR void *value, FAR socklen_t *value_len);
+static int        pkt_setsockopt(FAR struct socket *psock, int level,
+                    int option, FAR const void *value, socklen_t value_len);
+static int        pkt_mmap(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -71,10 +82,30 @@ const struct sock_intf_s g_pkt_sockif =
   NULL,            /* si_listen */
   NULL,            /* si_connect */
   NULL,            /* si_accept */
+#ifdef CONFIG_NET_PKT_RXRING
+  pkt_poll_local,  /* si_poll */
+#else
   NULL,            /* si_poll */
+#endif
   pkt_sendmsg,     /* si_sendmsg */
   pkt_recvmsg,     /* si_recvmsg */
   pkt_close        /* si_close */
+#ifdef CONFIG_NET_PKT_RXRING
+  , NULL           /* si_ioctl */
+  , NULL           /* si_socketpair */
+  , NULL           /* si_shutdown */
+  , pkt_getsockopt /* si_getsockopt */
+  , pkt_setsockopt /* si_setsockopt */
+#  ifdef CONFIG_NET_SENDFILE
+  , NULL           /* si_sendfile */
+#  endif
+  , NULL           /* si_sendmmsg */
+  , NULL           /* si_recvmmsg */
+#  ifdef CONFIG_NET_RECVIOB
+  , NULL           /* si_recviob */
+#  endif
+  , pkt_mmap       /* si_mmap */
+#endif
 };
 
 /****************************************************************************
@@ -301,6 +332,12 @@ static int pkt_close(FAR struct socket *psock)
 
               iob_free_queue(&conn->readahead);
 
+#ifdef CONFIG_NET_PKT_RXRING
+              /* And the memory-mapped ring */
+
+              pkt_ring_free(conn);
+#endif
+
               /* Then free the connection structure */
 
               conn->crefs = 0;          /* No more references on the connection */
@@ -321,6 +358,196 @@ static int pkt_close(FAR struct socket *psock)
     }
 }
 
+/****************************************************************************
+ * Name: pkt_poll_local
+ *
+ * Description:
+ *   The standard poll() operation redirects operations on socket descriptors
+ *   to this function.
+ *
+ *     POLLIN:  Reported if a block of the RX ring is owned by user space or,
+ *              without a ring, if read-ahead data is buffered.
+ *     POLLOUT: Always reported if requested.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   fds   - The structure describing the events to be monitored.
+ *   setup - true: Setup up the poll; false: Tear down the poll
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_RXRING
+static int pkt_poll_local(FAR struct socket *psock, FAR struct pollfd *fds,
+                          bool setup)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  pollevent_t eventset = POLLOUT;
+  int ret = -EBUSY;
+  int i;
+
+  net_lock();
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_NET_PKT_NPOLLWAITERS; i++)
+        {
+          if (conn->fds[i] == NULL)
+            {
+              conn->fds[i] = fds;
+              fds->priv    = &conn->fds[i];
+              ret          = OK;
+              break;
+            }
+        }
+
+      if (ret == OK)
+        {
+          if (conn->ring != NULL ? pkt_ring_readable(conn) :
+                                   !IOB_QEMPTY(&conn->readahead))
+            {
+              eventset |= POLLIN;
+            }
+
+          poll_notify(&fds, 1, eventset);
+        }
+    }
+  else
+    {
+      FAR struct pollfd **slot = fds->priv;
+
+      if (slot != NULL)
+        {
+          *slot     = NULL;
+          fds->priv = NULL;
+        }
+
+      ret = OK;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_getsockopt
+ *
+ * Description:
+ *   Get the SOL_PACKET options PACKET_VERSION and PACKET_STATISTICS.
+ *
+ ****************************************************************************/
+
+static int pkt_getsockopt(FAR struct socket *psock, int level, int option,
+                          FAR void *value, FAR socklen_t *value_len)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+
+  if (level != SOL_PACKET)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  switch (option)
+    {
+      case PACKET_VERSION:
+        if (*value_len < sizeof(int))
+          {
+            return -EINVAL;
+          }
+
+        *(FAR int *)value = conn->version;
+        *value_len        = sizeof(int);
+        return OK;
+
+      case PACKET_STATISTICS:
+        if (*value_len < sizeof(struct tpacket_stats_v3))
+          {
+            return -EINVAL;
+          }
+
+        net_lock();
+        pkt_ring_stats(conn, value);
+        net_unlock();
+
+        *value_len = sizeof(struct tpacket_stats_v3);
+        return OK;
+
+      default:
+        return -ENOPROTOOPT;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   Set the SOL_PACKET options PACKET_VERSION and PACKET_RX_RING.
+ *
+ ****************************************************************************/
+
+static int pkt_setsockopt(FAR struct socket *psock, int level, int option,
+                          FAR const void *value, socklen_t value_len)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  int version;
+
+  if (level != SOL_PACKET)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  switch (option)
+    {
+      case PACKET_VERSION:
+        if (value_len != sizeof(int))
+          {
+            return -EINVAL;
+          }
+
+        /* The frame format cannot change under an existing ring */
+
+        version = *(FAR const int *)value;
+        if (version != TPACKET_V1 && version != TPACKET_V3)
+          {
+            return -EINVAL;
+          }
+        else if (conn->ring != NULL)
+          {
+            return -EBUSY;
+          }
+
+        conn->version = version;
+        return OK;
+
+      case PACKET_RX_RING:
+        if (value_len < sizeof(struct tpacket_req3))
+          {
+            return -EINVAL;
+          }
+
+        return pkt_ring_setup(conn, value);
+
+      default:
+        return -ENOPROTOOPT;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_mmap
+ *
+ * Description:
+ *   Map the RX ring set up with PACKET_RX_RING.
+ *
+ ****************************************************************************/
+
+static int pkt_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map)
+{
+  return pkt_ring_mmap(psock->s_conn, map);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -0,0 +1,165 @@
+/****************************************************************************
+ * net/procfs/net_ipfilter.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <debug.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/net.h>
+
+#include "ipfilter/ipfilter.h"
+#include "procfs/procfs.h"
+
+#ifdef CONFIG_NET_IPFILTER_FLOWCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+#  define IPFILTER_LINELEN 140
+#else
+#  define IPFILTER_LINELEN 100
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char *g_ipfilter_chains[IPFILTER_CHAIN_MAX] =
+{
+  "INPUT", "FORWARD", "OUTPUT"
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static FAR const char *ipfilter_target_str(int target)
+{
+  switch (target)
+    {
+      case IPFILTER_TARGET_ACCEPT:
+        return "ACCEPT";
+
+      case IPFILTER_TARGET_DROP:
+        return "DROP";
+
+      case IPFILTER_TARGET_REJECT:
+        return "REJECT";
+
+      default:
+        return "?";
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_read_ipfilter
+ *
+ * Description:
+ *   Read and format the flows in the IP filter flow cache.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which network status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t netprocfs_read_ipfilter(FAR struct netprocfs_file_s *priv,
+                                FAR char *buffer, size_t buflen)
+{
+  FAR const struct ipfilter_flow_s *flow;
+  char src[INET6_ADDRSTRLEN];
+  char dst[INET6_ADDRSTRLEN];
+  clock_t now;
+  int index = 0;
+  int skip = 1;
+  int len = 0;
+
+  if (priv->offset == 0)
+    {
+      len = snprintf(buffer, buflen, "%-7s %5s %*s %*s %-6s %10s %s\n",
+                     "chain", "proto",
+                     -(INET6_ADDRSTRLEN / 2 + 6), "source",
+                     -(INET6_ADDRSTRLEN / 2 + 6), "destination",
+                     "target", "hits", "age");
+      priv->offset = 1;
+    }
+
+  net_lock();
+
+  now = clock_systime_ticks();
+  while ((flow = ipfilter_flow_next(&index)) != NULL)
+    {
+      if (++skip <= priv->offset)
+        {
+          continue;
+        }
+
+      if (buflen - len < IPFILTER_LINELEN)
+        {
+          break;
+        }
+
+      /* The devices are not shown, they may be gone by now */
+
+      inet_ntop(flow->domain, &flow->src, src, sizeof(src));
+      inet_ntop(flow->domain, &flow->dst, dst, sizeof(dst));
+
+      len += snprintf(buffer + len, buflen - len,
+                      "%-7s %5" PRIu8 " %*s:%-5" PRIu16
+                      " %*s:%-5" PRIu16 " %-6s %10" PRIu32 " %lu\n",
+                      g_ipfilter_chains[flow->chain], flow->proto,
+                      INET6_ADDRSTRLEN / 2, src, flow->sport,
+                      INET6_ADDRSTRLEN / 2, dst, flow->dport,
+                      ipfilter_target_str(flow->target), flow->hits,
+                      (unsigned long)TICK2SEC(now - flow->stamp));
+      priv->offset++;
+    }
+
+  net_unlock();
+
+  return len;
+}
+
+#endif /* CONFIG_NET_IPFILTER_FLOWCACHE */
@@ -0,0 +1,143 @@
+/****************************************************************************
+ * net/procfs/net_lockstats.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "procfs/procfs.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NET_LOCK_STATISTICS
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Line generating functions */
+
+static int netprocfs_lock_header(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_lock_net(FAR struct netprocfs_file_s *netfile);
+#ifdef CONFIG_NET_CONN_LOCK
+static int netprocfs_lock_conn(FAR struct netprocfs_file_s *netfile);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Line generating functions */
+
+static const linegen_t g_lock_linegen[] =
+{
+  netprocfs_lock_header,
+  netprocfs_lock_net
+#ifdef CONFIG_NET_CONN_LOCK
+  , netprocfs_lock_conn
+#endif
+};
+
+#define NLOCK_LINES (sizeof(g_lock_linegen) / sizeof(linegen_t))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_lock_line
+ ****************************************************************************/
+
+static int netprocfs_lock_line(FAR struct netprocfs_file_s *netfile,
+                               FAR const char *name,
+                               FAR const struct net_lockstat_s *stat)
+{
+  return snprintf(netfile->line, NET_LINELEN, "%-6s %10" PRIu32
+                  " %10" PRIu32 "\n",
+                  name, stat->acquired, stat->contended);
+}
+
+/****************************************************************************
+ * Name: netprocfs_lock_header
+ ****************************************************************************/
+
+static int netprocfs_lock_header(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN, "%-6s %10s %10s\n",
+                  "LOCK", "ACQUIRED", "CONTENDED");
+}
+
+/****************************************************************************
+ * Name: netprocfs_lock_net
+ ****************************************************************************/
+
+static int netprocfs_lock_net(FAR struct netprocfs_file_s *netfile)
+{
+  return netprocfs_lock_line(netfile, "net", &g_net_lockstats.net);
+}
+
+/****************************************************************************
+ * Name: netprocfs_lock_conn
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CONN_LOCK
+static int netprocfs_lock_conn(FAR struct netprocfs_file_s *netfile)
+{
+  return netprocfs_lock_line(netfile, "conn", &g_net_lockstats.conn);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_read_lockstats
+ *
+ * Description:
+ *   Read and format the network lock contention statistics.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which network status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t netprocfs_read_lockstats(FAR struct netprocfs_file_s *priv,
+                                 FAR char *buffer, size_t buflen)
+{
+  return netprocfs_read_linegen(priv, buffer, buflen,
+                                g_lock_linegen, NLOCK_LINES);
+}
+
+#endif /* CONFIG_NET_LOCK_STATISTICS */
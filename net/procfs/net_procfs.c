@@ -139,6 +139,22 @@ static const struct netprocfs_entry_s g_net_entries[] =
   },
 #  endif
 #endif
+#ifdef CONFIG_NET_LOCK_STATISTICS
+  {
+    DTYPE_FILE, "lock",
+    {
+      netprocfs_read_lockstats
+    }
+  },
+#endif
+#ifdef CONFIG_NET_IPFILTER_FLOWCACHE
+  {
+    DTYPE_FILE, "ipfilter",
+    {
+      netprocfs_read_ipfilter
+    }
+  },
+#endif
 #ifdef CONFIG_NET_ROUTE
   {
     DTYPE_DIRECTORY, "route",
@@ -424,19 +424,19 @@ static int netprocfs_rxstatistics_header(
 #ifdef CONFIG_NETDEV_STATISTICS
 static int netprocfs_rxstatistics(FAR struct netprocfs_file_s *netfile)
 {
-  FAR struct netdev_statistics_s *stats;
+  struct netdev_statistics_s stats;
   FAR struct net_driver_s *dev;
 
   DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
   dev = netfile->dev;
-  stats = &dev->d_statistics;
+  netdev_statistics_get(dev, &stats);
 
   return snprintf(netfile->line, NET_LINELEN, \
                   "\t    %08lx %08lx %08lx %-16llx\n",
-                  (unsigned long)stats->rx_packets,
-                  (unsigned long)stats->rx_fragments,
-                  (unsigned long)stats->rx_errors,
-                  (unsigned long long)stats->rx_bytes);
+                  (unsigned long)stats.rx_packets,
+                  (unsigned long)stats.rx_fragments,
+                  (unsigned long)stats.rx_errors,
+                  (unsigned long long)stats.rx_bytes);
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -484,13 +484,13 @@ static int netprocfs_rxpackets_header(FAR struct netprocfs_file_s *netfile)
 #ifdef CONFIG_NETDEV_STATISTICS
 static int netprocfs_rxpackets(FAR struct netprocfs_file_s *netfile)
 {
-  FAR struct netdev_statistics_s *stats;
+  struct netdev_statistics_s stats;
   FAR struct net_driver_s *dev;
   FAR char *fmt;
 
   DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
   dev = netfile->dev;
-  stats = &dev->d_statistics;
+  netdev_statistics_get(dev, &stats);
 
   fmt = "\t    "
 #ifdef CONFIG_NET_IPv4
@@ -506,15 +506,15 @@ static int netprocfs_rxpackets(FAR struct netprocfs_file_s *netfile)
 
   return snprintf(netfile->line, NET_LINELEN, fmt
 #ifdef CONFIG_NET_IPv4
-        , (unsigned long)stats->rx_ipv4
+        , (unsigned long)stats.rx_ipv4
 #endif
 #ifdef CONFIG_NET_IPv6
-        , (unsigned long)stats->rx_ipv6
+        , (unsigned long)stats.rx_ipv6
 #endif
 #ifdef CONFIG_NET_ARP
-        , (unsigned long)stats->rx_arp
+        , (unsigned long)stats.rx_arp
 #endif
-        , (unsigned long)stats->rx_dropped);
+        , (unsigned long)stats.rx_dropped);
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -541,20 +541,20 @@ static int netprocfs_txstatistics_header(
 #ifdef CONFIG_NETDEV_STATISTICS
 static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile)
 {
-  FAR struct netdev_statistics_s *stats;
+  struct netdev_statistics_s stats;
   FAR struct net_driver_s *dev;
 
   DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
   dev = netfile->dev;
-  stats = &dev->d_statistics;
+  netdev_statistics_get(dev, &stats);
 
   return snprintf(netfile->line, NET_LINELEN,
                   "\t    %08lx %08lx %08lx %08lx %-16llx \n",
-                  (unsigned long)stats->tx_packets,
-                  (unsigned long)stats->tx_done,
-                  (unsigned long)stats->tx_errors,
-                  (unsigned long)stats->tx_timeouts,
-                  (unsigned long long)stats->tx_bytes);
+                  (unsigned long)stats.tx_packets,
+                  (unsigned long)stats.tx_done,
+                  (unsigned long)stats.tx_errors,
+                  (unsigned long)stats.tx_timeouts,
+                  (unsigned long long)stats.tx_bytes);
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -565,16 +565,16 @@ static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile)
 #ifdef CONFIG_NETDEV_STATISTICS
 static int netprocfs_errors(FAR struct netprocfs_file_s *netfile)
 {
-  FAR struct netdev_statistics_s *stats;
+  struct netdev_statistics_s stats;
   FAR struct net_driver_s *dev;
 
   DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
   dev = netfile->dev;
-  stats = &dev->d_statistics;
+  netdev_statistics_get(dev, &stats);
 
   return snprintf(netfile->line, NET_LINELEN,
                   "\tTotal Errors: %08" PRIx32 "\n\n",
-                  stats->errors);
+                  stats.errors);
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -36,6 +36,7 @@
 
 #include <arch/irq.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/ramroute.h"
 #include "route/route.h"
@@ -84,10 +85,27 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   net_lock();
 
+#ifdef HAVE_ROUTE_IPv4_TRIE
+  /* Add the new entry to the lookup trie first, it may run out of memory */
+
+  if (ramroute_ipv4_trie_add(route) < 0)
+    {
+      net_unlock();
+      nerr("ERROR:  Failed to add a route to the trie\n");
+      net_freeroute_ipv4(route);
+      return -ENOMEM;
+    }
+
+#endif
   /* Then add the new entry to the table */
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
                         &g_ipv4_routes);
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  ipfwd_flowcache_flush();
+#endif
+
   net_unlock();
 
   netlink_route_notify(route, RTM_NEWROUTE, AF_INET);
@@ -121,10 +139,27 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   net_lock();
 
+#ifdef HAVE_ROUTE_IPv6_TRIE
+  /* Add the new entry to the lookup trie first, it may run out of memory */
+
+  if (ramroute_ipv6_trie_add(route) < 0)
+    {
+      net_unlock();
+      nerr("ERROR:  Failed to add a route to the trie\n");
+      net_freeroute_ipv6(route);
+      return -ENOMEM;
+    }
+
+#endif
   /* Then add the new entry to the table */
 
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
                         &g_ipv6_routes);
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  ipfwd_flowcache_flush();
+#endif
+
   net_unlock();
 
   netlink_route_notify(route, RTM_NEWROUTE, AF_INET6);
@@ -38,6 +38,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
 #include "route/cacheroute.h"
@@ -318,6 +319,10 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 
   netlink_route_notify(&match, RTM_DELROUTE, AF_INET);
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  ipfwd_flowcache_flush();
+#endif
+
 errout_with_fshandle:
   net_closeroute_ipv4(&fshandle);
 
@@ -471,6 +476,10 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
 
   netlink_route_notify(&match, RTM_DELROUTE, AF_INET6);
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  ipfwd_flowcache_flush();
+#endif
+
 errout_with_fshandle:
   net_closeroute_ipv6(&fshandle);
 
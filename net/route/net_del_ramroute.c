@@ -34,6 +34,7 @@
 #include <arpa/inet.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/ramroute.h"
 #include "route/route.h"
@@ -113,8 +114,16 @@ static int net_del_ipv4route(FAR struct net_route_ipv4_s *route,
           ramroute_ipv4_remfirst(&g_ipv4_routes);
         }
 
+#ifdef HAVE_ROUTE_IPv4_TRIE
+      ramroute_ipv4_trie_del(route);
+#endif
+
       netlink_route_notify(route, RTM_DELROUTE, AF_INET);
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      ipfwd_flowcache_flush();
+#endif
+
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv4(route);
@@ -171,8 +180,16 @@ static int net_del_ipv6route(FAR struct net_route_ipv6_s *route,
           ramroute_ipv6_remfirst(&g_ipv6_routes);
         }
 
+#ifdef HAVE_ROUTE_IPv6_TRIE
+      ramroute_ipv6_trie_del(route);
+#endif
+
       netlink_route_notify(route, RTM_DELROUTE, AF_INET6);
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      ipfwd_flowcache_flush();
+#endif
+
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv6(route);
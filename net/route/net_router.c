@@ -36,6 +36,7 @@
 
 #include "devif/devif.h"
 #include "route/cacheroute.h"
+#include "route/ramroute.h"
 #include "route/route.h"
 #include "utils/utils.h"
 
@@ -248,6 +249,9 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router,
                     int8_t prefixlen)
 {
   struct route_ipv4_match_s match;
+#ifdef HAVE_ROUTE_IPv4_TRIE
+  FAR struct net_route_ipv4_s *route;
+#endif
   int ret;
 
   /* Just early return for long prefix, maybe already got exact match. */
@@ -283,7 +287,12 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router,
        * routing table that can forward to this address
        */
 
+#ifdef HAVE_ROUTE_IPv4_TRIE
+      route = ramroute_ipv4_trie_find(target);
+      ret = route != NULL ? net_ipv4_match(route, &match) : 0;
+#else
       ret = net_foreachroute_ipv4(net_ipv4_match, &match);
+#endif
     }
 
   /* Did we find a route? */
@@ -342,6 +351,9 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router,
                     int16_t prefixlen)
 {
   struct route_ipv6_match_s match;
+#ifdef HAVE_ROUTE_IPv6_TRIE
+  FAR struct net_route_ipv6_s *route;
+#endif
   int ret;
 
   /* Just early return for long prefix, maybe already got exact match. */
@@ -377,7 +389,12 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router,
        * routing table that can forward to this address
        */
 
+#ifdef HAVE_ROUTE_IPv6_TRIE
+      route = ramroute_ipv6_trie_find(target);
+      ret = route != NULL ? net_ipv6_match(route, &match) : 0;
+#else
       ret = net_foreachroute_ipv6(net_ipv6_match, &match);
+#endif
     }
 
   /* Did we find a route? */
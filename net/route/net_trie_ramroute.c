@@ -0,0 +1,535 @@
+/****************************************************************************
+ * net/route/net_trie_ramroute.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/ramroute.h"
+#include "route/route.h"
+#include "utils/utils.h"
+
+#if defined(HAVE_ROUTE_IPv4_TRIE) || defined(HAVE_ROUTE_IPv6_TRIE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The trie consumes the address four bits per level, so a lookup visits at
+ * most 8 nodes for IPv4 and 32 nodes for IPv6, whatever the number of
+ * routes.
+ */
+
+#define TRIE_STRIDE       4
+#define TRIE_FANOUT       (1 << TRIE_STRIDE)
+#define TRIE_MAXDEPTH     (128 / TRIE_STRIDE)
+
+/* The depth of the node a prefix of length 'plen' (> 0) ends in */
+
+#define TRIE_DEPTH(plen)  (((plen) - 1) / TRIE_STRIDE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One level of the trie.  A prefix that ends in the node is expanded to
+ * all of the slots it covers, a slot keeps the longest of them.
+ */
+
+struct ramroute_trie_node_s
+{
+  FAR struct ramroute_trie_node_s *child[TRIE_FANOUT];
+  FAR void *route[TRIE_FANOUT];  /* Longest route covering the slot */
+  uint8_t plen[TRIE_FANOUT];     /* Its prefix bits within the node, 1-4 */
+  uint16_t nprefix;              /* Routes whose prefix ends in the node */
+  uint8_t nchild;                /* Number of non-NULL child[] */
+};
+
+struct ramroute_trie_s
+{
+  FAR struct ramroute_trie_node_s *root;
+  FAR void *dflt;                /* Route with prefix length zero */
+};
+
+/* Refill the slots of the node a deleted route ended in from the remaining
+ * routes ending in the same node.
+ */
+
+typedef CODE void (*ramroute_refill_t)(FAR struct ramroute_trie_s *trie,
+                                       FAR struct ramroute_trie_node_s *node,
+                                       FAR const uint8_t *key, int plen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv4_TRIE
+static struct ramroute_trie_s g_ipv4_trie;
+#endif
+
+#ifdef HAVE_ROUTE_IPv6_TRIE
+static struct ramroute_trie_s g_ipv6_trie;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: trie_nibble
+ *
+ * Description:
+ *   Return the address bits that index the node at the given depth.  The
+ *   address is in network byte order.
+ *
+ ****************************************************************************/
+
+static inline unsigned int trie_nibble(FAR const uint8_t *key, int depth)
+{
+  uint8_t byte = key[depth >> 1];
+
+  return (depth & 1) != 0 ? byte & 0x0f : byte >> 4;
+}
+
+/****************************************************************************
+ * Name: trie_samepath
+ *
+ * Description:
+ *   Check if two addresses lead to the same node at the given depth.
+ *
+ ****************************************************************************/
+
+static bool trie_samepath(FAR const uint8_t *key1, FAR const uint8_t *key2,
+                          int depth)
+{
+  int i;
+
+  for (i = 0; i < depth; i++)
+    {
+      if (trie_nibble(key1, i) != trie_nibble(key2, i))
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: trie_expand
+ *
+ * Description:
+ *   Store a route ending in a node into all of the slots it covers unless
+ *   a longer route does already.  Among routes of the same length the one
+ *   stored first wins, like the first match of the list did.
+ *
+ ****************************************************************************/
+
+static void trie_expand(FAR struct ramroute_trie_node_s *node,
+                        FAR const uint8_t *key, int plen, FAR void *route)
+{
+  int depth = TRIE_DEPTH(plen);
+  int bits  = plen - depth * TRIE_STRIDE;
+  int first = trie_nibble(key, depth) & ~((1 << (TRIE_STRIDE - bits)) - 1);
+  int last  = first + (1 << (TRIE_STRIDE - bits));
+  int i;
+
+  for (i = first; i < last; i++)
+    {
+      if (node->route[i] == NULL || node->plen[i] < bits)
+        {
+          node->route[i] = route;
+          node->plen[i]  = bits;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: trie_prune
+ *
+ * Description:
+ *   Free the nodes at the end of a path that no longer hold any route nor
+ *   children.
+ *
+ ****************************************************************************/
+
+static void trie_prune(FAR struct ramroute_trie_s *trie,
+                       FAR struct ramroute_trie_node_s **path,
+                       FAR const uint8_t *key, int depth)
+{
+  for (; depth >= 0; depth--)
+    {
+      FAR struct ramroute_trie_node_s *node = path[depth];
+
+      if (node->nprefix > 0 || node->nchild > 0)
+        {
+          break;
+        }
+
+      if (depth > 0)
+        {
+          path[depth - 1]->child[trie_nibble(key, depth - 1)] = NULL;
+          path[depth - 1]->nchild--;
+        }
+      else
+        {
+          trie->root = NULL;
+        }
+
+      kmm_free(node);
+    }
+}
+
+/****************************************************************************
+ * Name: trie_add
+ *
+ * Description:
+ *   Add a route to the trie, allocating the nodes on its path as needed.
+ *
+ ****************************************************************************/
+
+static int trie_add(FAR struct ramroute_trie_s *trie,
+                    FAR const uint8_t *key, int plen, FAR void *route)
+{
+  FAR struct ramroute_trie_node_s *path[TRIE_MAXDEPTH];
+  FAR struct ramroute_trie_node_s **link = &trie->root;
+  int depth;
+  int i;
+
+  if (plen == 0)
+    {
+      if (trie->dflt == NULL)
+        {
+          trie->dflt = route;
+        }
+
+      return OK;
+    }
+
+  depth = TRIE_DEPTH(plen);
+  for (i = 0; ; i++)
+    {
+      if (*link == NULL)
+        {
+          *link = kmm_zalloc(sizeof(struct ramroute_trie_node_s));
+          if (*link == NULL)
+            {
+              trie_prune(trie, path, key, i - 1);
+              return -ENOMEM;
+            }
+
+          if (i > 0)
+            {
+              path[i - 1]->nchild++;
+            }
+        }
+
+      path[i] = *link;
+      if (i == depth)
+        {
+          break;
+        }
+
+      link = &path[i]->child[trie_nibble(key, i)];
+    }
+
+  path[depth]->nprefix++;
+  trie_expand(path[depth], key, plen, route);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: trie_del
+ *
+ * Description:
+ *   Remove a route from the trie.  The route must have been removed from
+ *   the routing table list already, 'refill' restores the slots it covered
+ *   from the remaining routes.
+ *
+ ****************************************************************************/
+
+static void trie_del(FAR struct ramroute_trie_s *trie,
+                     FAR const uint8_t *key, int plen, FAR void *route,
+                     ramroute_refill_t refill)
+{
+  FAR struct ramroute_trie_node_s *path[TRIE_MAXDEPTH];
+  FAR struct ramroute_trie_node_s *node = trie->root;
+  int depth;
+  int i;
+
+  if (plen == 0)
+    {
+      if (trie->dflt == route)
+        {
+          trie->dflt = NULL;
+          refill(trie, NULL, key, plen);
+        }
+
+      return;
+    }
+
+  depth = TRIE_DEPTH(plen);
+  for (i = 0; node != NULL; i++)
+    {
+      path[i] = node;
+      if (i == depth)
+        {
+          break;
+        }
+
+      node = node->child[trie_nibble(key, i)];
+    }
+
+  if (node == NULL)
+    {
+      return;
+    }
+
+  DEBUGASSERT(node->nprefix > 0);
+  node->nprefix--;
+
+  for (i = 0; i < TRIE_FANOUT; i++)
+    {
+      if (node->route[i] == route)
+        {
+          node->route[i] = NULL;
+          node->plen[i]  = 0;
+        }
+    }
+
+  refill(trie, node, key, plen);
+  trie_prune(trie, path, key, depth);
+}
+
+/****************************************************************************
+ * Name: trie_find
+ *
+ * Description:
+ *   Return the route with the longest prefix matching an address.
+ *
+ ****************************************************************************/
+
+static FAR void *trie_find(FAR const struct ramroute_trie_s *trie,
+                           FAR const uint8_t *key, int maxdepth)
+{
+  FAR const struct ramroute_trie_node_s *node = trie->root;
+  FAR void *route = trie->dflt;
+  int depth;
+
+  for (depth = 0; node != NULL && depth < maxdepth; depth++)
+    {
+      unsigned int slot = trie_nibble(key, depth);
+
+      if (node->route[slot] != NULL)
+        {
+          route = node->route[slot];
+        }
+
+      node = node->child[slot];
+    }
+
+  return route;
+}
+
+/****************************************************************************
+ * Name: ipv4_trie_refill
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv4_TRIE
+static void ipv4_trie_refill(FAR struct ramroute_trie_s *trie,
+                             FAR struct ramroute_trie_node_s *node,
+                             FAR const uint8_t *key, int plen)
+{
+  FAR struct net_route_ipv4_entry_s *entry;
+  int depth = plen > 0 ? TRIE_DEPTH(plen) : -1;
+
+  for (entry = g_ipv4_routes.head; entry != NULL; entry = entry->flink)
+    {
+      FAR struct net_route_ipv4_s *route = &entry->entry;
+      FAR const uint8_t *rkey = (FAR const uint8_t *)&route->target;
+      int rlen = net_ipv4_mask2pref(route->netmask);
+
+      if (node == NULL)
+        {
+          if (rlen == 0)
+            {
+              trie->dflt = route;
+              return;
+            }
+        }
+      else if (rlen > 0 && TRIE_DEPTH(rlen) == depth &&
+               trie_samepath(rkey, key, depth))
+        {
+          trie_expand(node, rkey, rlen, route);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: ipv6_trie_refill
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv6_TRIE
+static void ipv6_trie_refill(FAR struct ramroute_trie_s *trie,
+                             FAR struct ramroute_trie_node_s *node,
+                             FAR const uint8_t *key, int plen)
+{
+  FAR struct net_route_ipv6_entry_s *entry;
+  int depth = plen > 0 ? TRIE_DEPTH(plen) : -1;
+
+  for (entry = g_ipv6_routes.head; entry != NULL; entry = entry->flink)
+    {
+      FAR struct net_route_ipv6_s *route = &entry->entry;
+      FAR const uint8_t *rkey = (FAR const uint8_t *)route->target;
+      int rlen = net_ipv6_mask2pref(route->netmask);
+
+      if (node == NULL)
+        {
+          if (rlen == 0)
+            {
+              trie->dflt = route;
+              return;
+            }
+        }
+      else if (rlen > 0 && TRIE_DEPTH(rlen) == depth &&
+               trie_samepath(rkey, key, depth))
+        {
+          trie_expand(node, rkey, rlen, route);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ramroute_ipv4_trie_add/ramroute_ipv6_trie_add
+ *
+ * Description:
+ *   Add a route to the lookup trie of the in-memory routing table.
+ *
+ * Input Parameters:
+ *   route - The route, it is added to the routing table list too
+ *
+ * Returned Value:
+ *   OK on success; -ENOMEM if a trie node could not be allocated.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv4_TRIE
+int ramroute_ipv4_trie_add(FAR struct net_route_ipv4_s *route)
+{
+  return trie_add(&g_ipv4_trie, (FAR const uint8_t *)&route->target,
+                  net_ipv4_mask2pref(route->netmask), route);
+}
+#endif
+
+#ifdef HAVE_ROUTE_IPv6_TRIE
+int ramroute_ipv6_trie_add(FAR struct net_route_ipv6_s *route)
+{
+  return trie_add(&g_ipv6_trie, (FAR const uint8_t *)route->target,
+                  net_ipv6_mask2pref(route->netmask), route);
+}
+#endif
+
+/****************************************************************************
+ * Name: ramroute_ipv4_trie_del/ramroute_ipv6_trie_del
+ *
+ * Description:
+ *   Remove a route from the lookup trie of the in-memory routing table.
+ *
+ * Input Parameters:
+ *   route - The route, already removed from the routing table list
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv4_TRIE
+void ramroute_ipv4_trie_del(FAR struct net_route_ipv4_s *route)
+{
+  trie_del(&g_ipv4_trie, (FAR const uint8_t *)&route->target,
+           net_ipv4_mask2pref(route->netmask), route, ipv4_trie_refill);
+}
+#endif
+
+#ifdef HAVE_ROUTE_IPv6_TRIE
+void ramroute_ipv6_trie_del(FAR struct net_route_ipv6_s *route)
+{
+  trie_del(&g_ipv6_trie, (FAR const uint8_t *)route->target,
+           net_ipv6_mask2pref(route->netmask), route, ipv6_trie_refill);
+}
+#endif
+
+/****************************************************************************
+ * Name: ramroute_ipv4_trie_find/ramroute_ipv6_trie_find
+ *
+ * Description:
+ *   Find the route with the longest prefix matching an address.
+ *
+ * Input Parameters:
+ *   target - The address to look up
+ *
+ * Returned Value:
+ *   The matching route or NULL if there is none.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv4_TRIE
+FAR struct net_route_ipv4_s *ramroute_ipv4_trie_find(in_addr_t target)
+{
+  return trie_find(&g_ipv4_trie, (FAR const uint8_t *)&target,
+                   32 / TRIE_STRIDE);
+}
+#endif
+
+#ifdef HAVE_ROUTE_IPv6_TRIE
+FAR struct net_route_ipv6_s *
+ramroute_ipv6_trie_find(const net_ipv6addr_t target)
+{
+  return trie_find(&g_ipv6_trie, (FAR const uint8_t *)target,
+                   128 / TRIE_STRIDE);
+}
+#endif
+
+#endif /* HAVE_ROUTE_IPv4_TRIE || HAVE_ROUTE_IPv6_TRIE */
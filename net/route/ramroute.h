@@ -47,6 +47,15 @@
 #  define CONFIG_ROUTE_MAX_IPv6_RAMROUTES 4
 #endif
 
+#ifdef CONFIG_ROUTE_RAMROUTE_TRIE
+#  ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+#    define HAVE_ROUTE_IPv4_TRIE 1
+#  endif
+#  ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+#    define HAVE_ROUTE_IPv6_TRIE 1
+#  endif
+#endif
+
 /* Routing table initializer */
 
 #define ramroute_init(rr) \
@@ -218,5 +227,82 @@ ramroute_ipv6_remafter(FAR struct net_route_ipv6_entry_s *entry,
                        FAR struct net_route_ipv6_queue_s *list);
 #endif
 
+/****************************************************************************
+ * Name: ramroute_ipv4_trie_add/ramroute_ipv6_trie_add
+ *
+ * Description:
+ *   Add a route to the lookup trie of the in-memory routing table.
+ *
+ * Input Parameters:
+ *   route - The route, it is added to the routing table list too
+ *
+ * Returned Value:
+ *   OK on success; -ENOMEM if a trie node could not be allocated.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv4_TRIE
+int ramroute_ipv4_trie_add(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef HAVE_ROUTE_IPv6_TRIE
+int ramroute_ipv6_trie_add(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: ramroute_ipv4_trie_del/ramroute_ipv6_trie_del
+ *
+ * Description:
+ *   Remove a route from the lookup trie of the in-memory routing table.
+ *
+ * Input Parameters:
+ *   route - The route, already removed from the routing table list
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv4_TRIE
+void ramroute_ipv4_trie_del(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef HAVE_ROUTE_IPv6_TRIE
+void ramroute_ipv6_trie_del(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: ramroute_ipv4_trie_find/ramroute_ipv6_trie_find
+ *
+ * Description:
+ *   Find the route with the longest prefix matching an address.  Among
+ *   routes with the same prefix the first one in the table is returned.
+ *
+ * Input Parameters:
+ *   target - The address to look up
+ *
+ * Returned Value:
+ *   The matching route or NULL if there is none.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv4_TRIE
+FAR struct net_route_ipv4_s *ramroute_ipv4_trie_find(in_addr_t target);
+#endif
+
+#ifdef HAVE_ROUTE_IPv6_TRIE
+FAR struct net_route_ipv6_s *
+ramroute_ipv6_trie_find(const net_ipv6addr_t target);
+#endif
+
 #endif /* CONFIG_ROUTE_IPv4_RAMROUTE || CONFIG_ROUTE_IPv6_RAMROUTE */
 #endif /* __NET_ROUTE_RAMROUTE_H */
@@ -34,8 +34,10 @@
 #include <sys/param.h>
 #include <sys/socket.h>
 
+#include <nuttx/atomic.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/circbuf.h>
+#include <nuttx/clock.h>
 #include <nuttx/crc32.h>
 #include <nuttx/rpmsg/rpmsg.h>
 #include <nuttx/mutex.h>
@@ -54,10 +56,16 @@
 #define RPMSG_SOCKET_CMD_SYNC           1
 #define RPMSG_SOCKET_CMD_DATA           2
 #define RPMSG_SOCKET_CMD_SHUTDOWN       3
+#define RPMSG_SOCKET_CMD_RING           4
+#define RPMSG_SOCKET_CMD_RINGACK        5
 #define RPMSG_SOCKET_NAME_PREFIX        "s:"
 #define RPMSG_SOCKET_NAME_PREFIX_LEN    2
 #define RPMSG_SOCKET_NAME_LEN           10
 
+/* How long close() waits for the peer to let go of the shared memory ring */
+
+#define RPMSG_SOCKET_RING_TIMEOUT       1000
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -88,6 +96,36 @@ begin_packed_struct struct rpmsg_socket_shutdown_s
   uint32_t                       how;
 } end_packed_struct;
 
+#ifdef CONFIG_NET_RPMSG_SHMRING
+/* Offer a shared memory ring for the data of a stream socket, size zero
+ * withdraws the ring again.  Both are answered with a ring ack.
+ */
+
+begin_packed_struct struct rpmsg_socket_ring_msg_s
+{
+  uint32_t                       cmd;
+  uint32_t                       size;
+  uint64_t                       addr;
+} end_packed_struct;
+
+begin_packed_struct struct rpmsg_socket_ringack_s
+{
+  uint32_t                       cmd;
+  int32_t                        result;
+} end_packed_struct;
+
+/* The shared memory ring, written by the sender and read by the receiver.
+ * head and tail are free running, the size of the data is a power of two.
+ */
+
+struct rpmsg_socket_ring_s
+{
+  atomic_uint                    head;
+  atomic_uint                    tail;
+  uint8_t                        data[0];
+};
+#endif
+
 struct rpmsg_socket_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -141,6 +179,22 @@ struct rpmsg_socket_conn_s
 
   uint32_t                       recvpos;
   uint32_t                       lastpos;
+
+#ifdef CONFIG_NET_RPMSG_SHMRING
+  /* Shared memory ring, descript send side */
+
+  FAR struct rpmsg_socket_ring_s *txring;  /* Accepted by the peer */
+  FAR struct rpmsg_socket_ring_s *txpend;  /* Offered to the peer */
+  uint32_t                       txsize;
+  bool                           txtried;
+  bool                           txdetach;
+
+  /* Shared memory ring, descript recv side */
+
+  FAR struct rpmsg_socket_ring_s *rxring;
+  uint32_t                       rxsize;
+  uint32_t                       rxkicked;
+#endif
 };
 
 /****************************************************************************
@@ -288,6 +342,15 @@ static void rpmsg_socket_free(FAR struct rpmsg_socket_conn_s *conn)
   kmm_free(conn);
 }
 
+#ifdef CONFIG_NET_RPMSG_SHMRING
+static inline uint32_t
+rpmsg_socket_ring_used(FAR struct rpmsg_socket_ring_s *ring)
+{
+  return atomic_load(&ring->head) - atomic_load(&ring->tail);
+}
+
+#endif
+
 static int rpmsg_socket_wakeup(FAR struct rpmsg_socket_conn_s *conn)
 {
   struct rpmsg_socket_data_s msg;
@@ -311,6 +374,25 @@ static int rpmsg_socket_wakeup(FAR struct rpmsg_socket_conn_s *conn)
       ret = 1;
     }
 
+#ifdef CONFIG_NET_RPMSG_SHMRING
+  /* Tell the sender about the space read from the ring the same way */
+
+  if (conn->rxring != NULL)
+    {
+      uint32_t tail = atomic_load(&conn->rxring->tail);
+
+      if (tail - conn->rxkicked > conn->rxsize / 2)
+        {
+          conn->rxkicked = tail;
+          conn->lastpos  = conn->recvpos;
+          msg.cmd = RPMSG_SOCKET_CMD_DATA;
+          msg.pos = conn->recvpos;
+          msg.len = 0;
+          ret = 1;
+        }
+    }
+#endif
+
   nxmutex_unlock(&conn->recvlock);
   return ret ? rpmsg_send(&conn->ept, &msg, sizeof(msg)) : 0;
 }
@@ -318,9 +400,334 @@ static int rpmsg_socket_wakeup(FAR struct rpmsg_socket_conn_s *conn)
 static inline uint32_t
 rpmsg_socket_get_space(FAR struct rpmsg_socket_conn_s *conn)
 {
+#ifdef CONFIG_NET_RPMSG_SHMRING
+  if (conn->txring != NULL)
+    {
+      return conn->txsize - rpmsg_socket_ring_used(conn->txring);
+    }
+#endif
+
   return conn->sendsize - (conn->sendpos - conn->ackpos);
 }
 
+#ifdef CONFIG_NET_RPMSG_SHMRING
+static uint32_t rpmsg_socket_ring_read(FAR struct rpmsg_socket_conn_s *conn,
+                                       FAR void *buf, uint32_t len)
+{
+  FAR struct rpmsg_socket_ring_s *ring = conn->rxring;
+  uint32_t tail = atomic_load(&ring->tail);
+  uint32_t off = tail & (conn->rxsize - 1);
+  uint32_t chunk;
+
+  len   = MIN(len, atomic_load(&ring->head) - tail);
+  chunk = MIN(len, conn->rxsize - off);
+
+  memcpy(buf, ring->data + off, chunk);
+  memcpy((FAR uint8_t *)buf + chunk, ring->data, len - chunk);
+
+  /* Hand the space back only after the data was copied out */
+
+  atomic_store(&ring->tail, tail + len);
+  return len;
+}
+
+static void rpmsg_socket_ring_write(FAR struct rpmsg_socket_conn_s *conn,
+                                    FAR const struct iovec **buf,
+                                    FAR uint32_t *offset, uint32_t len)
+{
+  FAR struct rpmsg_socket_ring_s *ring = conn->txring;
+  uint32_t head = atomic_load(&ring->head);
+  uint32_t written = 0;
+
+  while (written < len)
+    {
+      uint32_t off = (head + written) & (conn->txsize - 1);
+      uint32_t chunk = MIN(len - written, (*buf)->iov_len - *offset);
+
+      chunk = MIN(chunk, conn->txsize - off);
+      memcpy(ring->data + off,
+             (FAR const uint8_t *)(*buf)->iov_base + *offset, chunk);
+      *offset += chunk;
+      if (*offset == (*buf)->iov_len)
+        {
+          (*buf)++;
+          *offset = 0;
+        }
+
+      written += chunk;
+    }
+
+  /* Publish the data only after it was copied in */
+
+  atomic_store(&ring->head, head + len);
+}
+
+/* Move the data left in the ring into recvbuf, the peer withdraws it */
+
+static void rpmsg_socket_ring_drain(FAR struct rpmsg_socket_conn_s *conn)
+{
+  uint8_t tmp[64];
+  uint32_t used;
+  uint32_t len;
+
+  used = rpmsg_socket_ring_used(conn->rxring);
+  if (used == 0)
+    {
+      return;
+    }
+
+  if (circbuf_space(&conn->recvbuf) < used &&
+      circbuf_resize(&conn->recvbuf,
+                     circbuf_used(&conn->recvbuf) + used) < 0)
+    {
+      nerr("ERROR: Drop %" PRIu32 " bytes of the ring\n", used);
+    }
+
+  while ((len = rpmsg_socket_ring_read(conn, tmp, sizeof(tmp))) > 0)
+    {
+      circbuf_write(&conn->recvbuf, tmp, len);
+    }
+
+  rpmsg_socket_poll_notify(conn, POLLIN);
+}
+
+/* Offer a ring to the peer on the first send of a stream socket.  The data
+ * goes through the rpmsg buffers until the peer accepts it.
+ */
+
+static void rpmsg_socket_ring_setup(FAR struct rpmsg_socket_conn_s *conn)
+{
+  struct rpmsg_socket_ring_msg_s msg;
+  FAR struct rpmsg_socket_ring_s *ring;
+  uint64_t addr;
+
+  nxmutex_lock(&conn->sendlock);
+  if (conn->txtried)
+    {
+      nxmutex_unlock(&conn->sendlock);
+      return;
+    }
+
+  conn->txtried = true;
+  nxmutex_unlock(&conn->sendlock);
+
+  ring = rpmsg_shm_alloc(&conn->ept, sizeof(*ring) +
+                         CONFIG_NET_RPMSG_SHMRING_SIZE, &addr);
+  if (ring == NULL)
+    {
+      return;
+    }
+
+  atomic_store(&ring->head, 0);
+  atomic_store(&ring->tail, 0);
+
+  nxmutex_lock(&conn->sendlock);
+  conn->txpend = ring;
+  conn->txsize = CONFIG_NET_RPMSG_SHMRING_SIZE;
+  nxmutex_unlock(&conn->sendlock);
+
+  msg.cmd  = RPMSG_SOCKET_CMD_RING;
+  msg.size = CONFIG_NET_RPMSG_SHMRING_SIZE;
+  msg.addr = addr;
+
+  if (rpmsg_send(&conn->ept, &msg, sizeof(msg)) < 0)
+    {
+      nxmutex_lock(&conn->sendlock);
+      ring = conn->txpend;
+      conn->txpend = NULL;
+      nxmutex_unlock(&conn->sendlock);
+
+      rpmsg_shm_free(&conn->ept, ring);
+    }
+}
+
+/* Withdraw the ring before the endpoint goes away and free it once the
+ * peer stopped reading it.  If the peer does not answer, the ring is
+ * leaked rather than freed under its feet.
+ */
+
+static void rpmsg_socket_ring_release(FAR struct rpmsg_socket_conn_s *conn)
+{
+  struct rpmsg_socket_ring_msg_s msg;
+  FAR struct rpmsg_socket_ring_s *ring;
+  clock_t start;
+  int ret = 0;
+
+  nxmutex_lock(&conn->sendlock);
+  ring = conn->txring != NULL ? conn->txring : conn->txpend;
+  conn->txdetach = ring != NULL;
+  nxmutex_unlock(&conn->sendlock);
+
+  if (ring == NULL)
+    {
+      return;
+    }
+
+  if (!conn->unbind)
+    {
+      msg.cmd  = RPMSG_SOCKET_CMD_RING;
+      msg.size = 0;
+      msg.addr = 0;
+
+      ret   = rpmsg_send(&conn->ept, &msg, sizeof(msg));
+      start = clock_systime_ticks();
+      while (ret >= 0 && conn->txdetach && !conn->unbind)
+        {
+          clock_t elapsed = clock_systime_ticks() - start;
+          clock_t timeout = MSEC2TICK(RPMSG_SOCKET_RING_TIMEOUT);
+
+          if (elapsed >= timeout)
+            {
+              ret = -ETIMEDOUT;
+              break;
+            }
+
+          nxsem_tickwait_uninterruptible(&conn->sendsem, timeout - elapsed);
+        }
+    }
+
+  if (ret < 0)
+    {
+      nerr("ERROR: Leak the ring, the peer did not release it %d\n", ret);
+    }
+  else
+    {
+      rpmsg_shm_free(&conn->ept, ring);
+    }
+
+  conn->txring = NULL;
+  conn->txpend = NULL;
+}
+
+static void rpmsg_socket_ring_cb(FAR struct rpmsg_socket_conn_s *conn,
+                                 FAR struct rpmsg_socket_ring_msg_s *msg)
+{
+  struct rpmsg_socket_ringack_s ack;
+  FAR struct rpmsg_socket_ring_s *ring = NULL;
+
+  ack.cmd    = RPMSG_SOCKET_CMD_RINGACK;
+  ack.result = -EINVAL;
+
+  nxmutex_lock(&conn->recvlock);
+  if (msg->size == 0)
+    {
+      if (conn->rxring != NULL)
+        {
+          rpmsg_socket_ring_drain(conn);
+          conn->rxring = NULL;
+        }
+
+      ack.result = 0;
+    }
+  else if ((msg->size & (msg->size - 1)) == 0 && conn->rxring == NULL)
+    {
+      ring = rpmsg_shm_pa2va(&conn->ept, msg->addr);
+      if (ring != NULL)
+        {
+          conn->rxring   = ring;
+          conn->rxsize   = msg->size;
+          conn->rxkicked = 0;
+          ack.result     = 0;
+        }
+    }
+
+  nxmutex_unlock(&conn->recvlock);
+  rpmsg_send(&conn->ept, &ack, sizeof(ack));
+}
+
+static void rpmsg_socket_ringack_cb(FAR struct rpmsg_socket_conn_s *conn,
+                                    FAR struct rpmsg_socket_ringack_s *ack)
+{
+  FAR struct rpmsg_socket_ring_s *ring = NULL;
+
+  /* The acks come in the order of the ring commands */
+
+  nxmutex_lock(&conn->sendlock);
+  if (conn->txpend != NULL)
+    {
+      if (ack->result == 0)
+        {
+          conn->txring = conn->txpend;
+        }
+      else if (!conn->txdetach)
+        {
+          ring = conn->txpend;
+        }
+
+      conn->txpend = NULL;
+    }
+  else if (conn->txdetach)
+    {
+      conn->txdetach = false;
+    }
+
+  rpmsg_socket_post(&conn->sendsem);
+  rpmsg_socket_poll_notify(conn, POLLOUT);
+  nxmutex_unlock(&conn->sendlock);
+
+  if (ring != NULL)
+    {
+      rpmsg_shm_free(&conn->ept, ring);
+    }
+}
+
+static uint32_t rpmsg_socket_ring_send(FAR struct rpmsg_socket_conn_s *conn,
+                                       FAR const struct iovec **buf,
+                                       FAR uint32_t *offset, uint32_t len)
+{
+  struct rpmsg_socket_data_s msg;
+  int ret;
+
+  nxmutex_lock(&conn->sendlock);
+  len = MIN(len, rpmsg_socket_get_space(conn));
+  rpmsg_socket_ring_write(conn, buf, offset, len);
+
+  /* Ring the doorbell with an empty data message, which acks as usual */
+
+  msg.cmd = RPMSG_SOCKET_CMD_DATA;
+  msg.pos = conn->recvpos;
+  msg.len = 0;
+  conn->lastpos = conn->recvpos;
+  nxmutex_unlock(&conn->sendlock);
+
+  /* The data is in the ring already, the next doorbell covers it too */
+
+  ret = rpmsg_send(&conn->ept, &msg, sizeof(msg));
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to ring the doorbell %d\n", ret);
+    }
+
+  return len;
+}
+
+/* The peer rang the doorbell, hand the data of the ring to a waiting
+ * reader or tell the pollers about it.
+ */
+
+static void rpmsg_socket_ring_kick(FAR struct rpmsg_socket_conn_s *conn)
+{
+  nxmutex_lock(&conn->recvlock);
+  if (conn->rxring != NULL && rpmsg_socket_ring_used(conn->rxring) > 0)
+    {
+      if (conn->recvdata && circbuf_is_empty(&conn->recvbuf))
+        {
+          conn->recvlen  = rpmsg_socket_ring_read(conn, conn->recvdata,
+                                                  conn->recvlen);
+          conn->recvdata = NULL;
+          rpmsg_socket_post(&conn->recvsem);
+        }
+
+      if (rpmsg_socket_ring_used(conn->rxring) > 0)
+        {
+          rpmsg_socket_poll_notify(conn, POLLIN);
+        }
+    }
+
+  nxmutex_unlock(&conn->recvlock);
+}
+#endif
+
 static int rpmsg_socket_ept_cb(FAR struct rpmsg_endpoint *ept,
                                FAR void *data, size_t len, uint32_t src,
                                FAR void *priv)
@@ -357,6 +764,13 @@ static int rpmsg_socket_ept_cb(FAR struct rpmsg_endpoint *ept,
         }
 
       nxmutex_unlock(&conn->sendlock);
+#ifdef CONFIG_NET_RPMSG_SHMRING
+      if (len == sizeof(*msg))
+        {
+          rpmsg_socket_ring_kick(conn);
+        }
+#endif
+
       if (len > sizeof(*msg))
         {
           len -= sizeof(*msg);
@@ -405,6 +819,16 @@ static int rpmsg_socket_ept_cb(FAR struct rpmsg_endpoint *ept,
           nxmutex_unlock(&conn->recvlock);
         }
     }
+#ifdef CONFIG_NET_RPMSG_SHMRING
+  else if (head->cmd == RPMSG_SOCKET_CMD_RING)
+    {
+      rpmsg_socket_ring_cb(conn, data);
+    }
+  else if (head->cmd == RPMSG_SOCKET_CMD_RINGACK)
+    {
+      rpmsg_socket_ringack_cb(conn, data);
+    }
+#endif
   else if (head->cmd == RPMSG_SOCKET_CMD_SHUTDOWN)
     {
       FAR struct rpmsg_socket_shutdown_s *msg = data;
@@ -946,6 +1370,14 @@ static int rpmsg_socket_poll(FAR struct socket *psock,
               eventset |= POLLIN;
             }
 
+#ifdef CONFIG_NET_RPMSG_SHMRING
+          if (conn->rxring != NULL &&
+              rpmsg_socket_ring_used(conn->rxring) > 0)
+            {
+              eventset |= POLLIN;
+            }
+#endif
+
           nxmutex_unlock(&conn->recvlock);
         }
       else /* !_SS_ISCONNECTED(conn->sconn.s_flags) */
@@ -1003,6 +1435,10 @@ static ssize_t rpmsg_socket_send_continuous(FAR struct socket *psock,
   uint32_t offset = 0;
   int ret = 0;
 
+#ifdef CONFIG_NET_RPMSG_SHMRING
+  rpmsg_socket_ring_setup(conn);
+#endif
+
   while (written < len)
     {
       FAR struct rpmsg_socket_data_s *msg;
@@ -1037,6 +1473,15 @@ static ssize_t rpmsg_socket_send_continuous(FAR struct socket *psock,
           continue;
         }
 
+#ifdef CONFIG_NET_RPMSG_SHMRING
+      if (conn->txring != NULL)
+        {
+          written += rpmsg_socket_ring_send(conn, &buf, &offset,
+                                            len - written);
+          continue;
+        }
+#endif
+
       msg = rpmsg_get_tx_payload_buffer(&conn->ept, &ipcsize, true);
       if (!msg)
         {
@@ -1282,6 +1727,13 @@ static ssize_t rpmsg_socket_recvmsg(FAR struct socket *psock,
     {
       ret = circbuf_read(&conn->recvbuf, buf, len);
       conn->recvpos += ret > 0 ? ret : 0;
+
+#ifdef CONFIG_NET_RPMSG_SHMRING
+      if (ret == 0 && conn->rxring != NULL)
+        {
+          ret = rpmsg_socket_ring_read(conn, buf, len);
+        }
+#endif
     }
 
   if (ret > 0)
@@ -1365,6 +1817,9 @@ static int rpmsg_socket_close(FAR struct socket *psock)
 
   if (conn->ept.rdev)
     {
+#ifdef CONFIG_NET_RPMSG_SHMRING
+      rpmsg_socket_ring_release(conn);
+#endif
       rpmsg_socket_destroy_ept(conn);
     }
   else
@@ -1404,6 +1859,13 @@ static int rpmsg_socket_ioctl(FAR struct socket *psock,
     {
       case FIONREAD:
         *(FAR int *)((uintptr_t)arg) = circbuf_used(&conn->recvbuf);
+#ifdef CONFIG_NET_RPMSG_SHMRING
+        if (conn->rxring != NULL)
+          {
+            *(FAR int *)((uintptr_t)arg) +=
+              rpmsg_socket_ring_used(conn->rxring);
+          }
+#endif
         break;
 
       case FIONSPACE:
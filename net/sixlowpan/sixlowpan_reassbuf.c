@@ -35,6 +35,8 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/wqueue.h>
 
 #include "sixlowpan_internal.h"
 
@@ -66,6 +68,22 @@ static FAR struct sixlowpan_reassbuf_s *g_active_reass;
 static struct sixlowpan_reassbuf_s
               g_metadata_pool[CONFIG_NET_6LOWPAN_NREASSBUF];
 
+#ifdef CONFIG_SCHED_LPWORK
+/* Reclaims the expired reassembly buffers when the oldest one times out */
+
+static struct work_s g_reass_work;
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+static void sixlowpan_reass_schedule(void);
+#else
+#  define sixlowpan_reass_schedule()
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -156,7 +174,66 @@ static void sixlowpan_reass_expire(void)
             }
         }
     }
+
+  sixlowpan_reass_schedule();
+}
+
+#ifdef CONFIG_SCHED_LPWORK
+/****************************************************************************
+ * Name: sixlowpan_reass_timeout
+ *
+ * Description:
+ *   Free the expired reassembly buffers on the low priority work queue.
+ *
+ ****************************************************************************/
+
+static void sixlowpan_reass_timeout(FAR void *arg)
+{
+  net_lock();
+  sixlowpan_reass_expire();
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: sixlowpan_reass_schedule
+ *
+ * Description:
+ *   Schedule the reclaim of the reassembly buffers for the time when the
+ *   oldest active one expires.  Expired buffers then no longer have to be
+ *   searched for on the reception of every fragment, and they do not hold
+ *   memory while no more fragments arrive.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void sixlowpan_reass_schedule(void)
+{
+  FAR struct sixlowpan_reassbuf_s *reass;
+  sclock_t delay = NET_6LOWPAN_TIMEOUT;
+  sclock_t remain;
+  clock_t now;
+
+  if (g_active_reass == NULL || !work_available(&g_reass_work))
+    {
+      return;
+    }
+
+  now = clock_systime_ticks();
+  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
+    {
+      remain = NET_6LOWPAN_TIMEOUT - (sclock_t)(now - reass->rb_time);
+      if (remain < delay)
+        {
+          delay = remain;
+        }
+    }
+
+  work_queue(LPWORK, &g_reass_work, sixlowpan_reass_timeout, NULL,
+             delay > 0 ? delay : 1);
 }
+#endif /* CONFIG_SCHED_LPWORK */
 
 /****************************************************************************
  * Name: sixlowpan_remove_active
@@ -285,10 +362,17 @@ FAR struct sixlowpan_reassbuf_s *
   uint8_t pool;
 
   /* First, removed any expired or inactive reassembly buffers.  This might
-   * free up a pre-allocated buffer for this allocation.
+   * free up a pre-allocated buffer for this allocation.  With the work
+   * queue reclaiming them in time, that is only needed if no pre-allocated
+   * buffer is left.
    */
 
-  sixlowpan_reass_expire();
+#ifdef CONFIG_SCHED_LPWORK
+  if (g_free_reass == NULL)
+#endif
+    {
+      sixlowpan_reass_expire();
+    }
 
   /* Now, try the free list first */
 
@@ -330,6 +414,8 @@ FAR struct sixlowpan_reassbuf_s *
 
       reass->rb_flink   = g_active_reass;
       g_active_reass    = reass;
+
+      sixlowpan_reass_schedule();
     }
 
   return reass;
@@ -360,14 +446,8 @@ FAR struct sixlowpan_reassbuf_s *
 {
   FAR struct sixlowpan_reassbuf_s *reass;
 
-  /* First, removed any expired or inactive reassembly buffers (we don't want
-   * to return old reassembly buffer with the same tag)
-   */
-
-  sixlowpan_reass_expire();
-
-  /* Now search for the matching reassembly buffer in the remainng, active
-   * reassembly buffers.
+  /* Search for the matching reassembly buffer in the active reassembly
+   * buffers.
    */
 
   for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
@@ -380,6 +460,17 @@ FAR struct sixlowpan_reassbuf_s *
       if (reass->rb_reasstag == reasstag &&
           sixlowpan_compare_fragsrc(reass, fragsrc))
         {
+          /* We don't want to return an old reassembly buffer with the same
+           * tag that was not reclaimed yet.
+           */
+
+          if (!reass->rb_active ||
+              clock_systime_ticks() - reass->rb_time >= NET_6LOWPAN_TIMEOUT)
+            {
+              sixlowpan_reass_free(reass);
+              return NULL;
+            }
+
           return reass;
         }
     }
@@ -0,0 +1,222 @@
+/****************************************************************************
+ * net/socket/recviob.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <limits.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET_RECVIOB
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: recviob_wait
+ *
+ * Description:
+ *   Wait until the socket becomes readable, using the poll interface of the
+ *   socket so that the address families need no blocking logic of their
+ *   own for psock_recviob().
+ *
+ * Input Parameters:
+ *   psock   - The socket to wait for
+ *   timeout - The time to wait in milliseconds or UINT_MAX to wait forever
+ *
+ * Returned Value:
+ *   Zero (OK) if the socket may be readable.  A negated errno value is
+ *   returned on a timeout or if a signal was received.
+ *
+ ****************************************************************************/
+
+static int recviob_wait(FAR struct socket *psock, unsigned int timeout)
+{
+  struct pollfd fds;
+  sem_t sem;
+  int ret;
+
+  nxsem_init(&sem, 0, 0);
+
+  fds.fd      = -1;
+  fds.events  = POLLIN;
+  fds.revents = 0;
+  fds.arg     = &sem;
+  fds.cb      = poll_default_cb;
+  fds.priv    = NULL;
+
+  ret = psock_poll(psock, &fds, true);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (fds.revents == 0)
+    {
+      if (timeout == UINT_MAX)
+        {
+          ret = nxsem_wait(&sem);
+        }
+      else
+        {
+          ret = nxsem_tickwait(&sem, MSEC2TICK(timeout));
+        }
+    }
+
+  psock_poll(psock, &fds, false);
+
+errout:
+  nxsem_destroy(&sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recviob
+ *
+ * Description:
+ *   psock_recviob() receives data from a socket without copying it.  The
+ *   I/O buffer chain that holds the data is handed over to the caller,
+ *   which owns it afterwards and must release it with iob_free_chain().
+ *
+ *   A stream socket hands over all of the data buffered so far, a datagram
+ *   socket hands over one datagram.  This is intended for in-kernel
+ *   consumers, like protocol bridges, that would otherwise copy the data
+ *   out of the I/O buffers only to put it into new ones.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   iob       The location to return the I/O buffer chain in
+ *   flags     Receive flags, MSG_PEEK is not supported
+ *   from      Address of source of a datagram (may be NULL)
+ *   fromlen   The length of the address structure
+ *
+ * Returned Value:
+ *   The number of bytes in the returned I/O buffer chain.  Zero is
+ *   returned with no chain when the peer has performed an orderly
+ *   shutdown.  Otherwise a negated errno value is returned, -EOPNOTSUPP if
+ *   the socket does not support this operation.
+ *
+ ****************************************************************************/
+
+ssize_t psock_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                      int flags, FAR struct sockaddr *from,
+                      FAR socklen_t *fromlen)
+{
+  FAR struct socket_conn_s *conn;
+  unsigned int timeout;
+  unsigned int elapsed;
+  clock_t start;
+  ssize_t ret;
+
+  /* Verify that non-NULL pointers were passed */
+
+  if (iob == NULL || (from != NULL && (fromlen == NULL || *fromlen <= 0)))
+    {
+      return -EINVAL;
+    }
+
+  if ((flags & MSG_PEEK) != 0)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+
+  if (psock->s_sockif->si_recviob == NULL)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  conn    = psock->s_conn;
+  timeout = _SO_TIMEOUT(conn->s_rcvtimeo);
+  start   = clock_systime_ticks();
+  *iob    = NULL;
+
+  /* The address families never block in si_recviob(), they return -EAGAIN
+   * if nothing is buffered yet.
+   */
+
+  for (; ; )
+    {
+      ret = psock->s_sockif->si_recviob(psock, iob, flags, from, fromlen);
+      if (ret != -EAGAIN || _SS_ISNONBLOCK(conn->s_flags) ||
+          (flags & MSG_DONTWAIT) != 0)
+        {
+          break;
+        }
+
+      if (timeout != UINT_MAX)
+        {
+          elapsed = TICK2MSEC(clock_systime_ticks() - start);
+          if (elapsed >= timeout)
+            {
+              break;
+            }
+
+          ret = recviob_wait(psock, timeout - elapsed);
+        }
+      else
+        {
+          ret = recviob_wait(psock, timeout);
+        }
+
+      if (ret == -ETIMEDOUT)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+      else if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_NET_RECVIOB */
@@ -0,0 +1,248 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: recvmmsg_check
+ *
+ * Description:
+ *   Apply the checks of psock_recvmsg() to one message of the batch.
+ *
+ ****************************************************************************/
+
+static int recvmmsg_check(FAR struct msghdr *msg)
+{
+  if (msg->msg_iov == NULL || msg->msg_iov->iov_base == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (msg->msg_name != NULL && msg->msg_namelen <= 0)
+    {
+      return -EINVAL;
+    }
+
+  if (msg->msg_iovlen != 1)
+    {
+      return -ENOTSUP;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives a batch of messages from a socket.  It is the
+ *   internal OS interface of recvmmsg(), see psock_recvmsg() for the
+ *   differences.  The address family handles the whole batch at once if it
+ *   provides si_recvmmsg(), otherwise the messages are received one at a
+ *   time with psock_recvmsg().
+ *
+ *   With MSG_WAITFORONE only the first message may block.  The timeout,
+ *   if not NULL, is checked after each received message as on Linux.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to receive, msg_len is set to the bytes received
+ *   vlen      The number of messages in msgvec
+ *   flags     Receive flags
+ *   timeout   The time after which no further message is received or NULL
+ *
+ * Returned Value:
+ *   The number of messages received, which is less than vlen if an error
+ *   occurred after at least one message was received.  A negated errno
+ *   value is returned if no message was received.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout)
+{
+  unsigned int nrecv;
+  clock_t start;
+  int ret = OK;
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (msgvec == NULL ||
+      (timeout != NULL && (timeout->tv_sec < 0 || timeout->tv_nsec < 0 ||
+                           timeout->tv_nsec >= NSEC_PER_SEC)))
+    {
+      return -EINVAL;
+    }
+
+  /* An invalid message ends the batch, it is reported by the next call
+   * if messages were received before it.
+   */
+
+  for (nrecv = 0; nrecv < vlen; nrecv++)
+    {
+      ret = recvmmsg_check(&msgvec[nrecv].msg_hdr);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  if (nrecv == 0)
+    {
+      return ret;
+    }
+
+  vlen = nrecv;
+
+  /* Let logic specific to this address family handle the whole batch if it
+   * can.
+   */
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+
+  if (psock->s_sockif->si_recvmmsg != NULL)
+    {
+      ret = psock->s_sockif->si_recvmmsg(psock, msgvec, vlen, flags,
+                                         timeout);
+      if (ret != -ENOSYS)
+        {
+          return ret;
+        }
+    }
+
+  /* Otherwise fall back to one message at a time */
+
+  start = clock_systime_ticks();
+
+  for (nrecv = 0; nrecv < vlen; )
+    {
+      ret = psock_recvmsg(psock, &msgvec[nrecv].msg_hdr,
+                          flags & ~MSG_WAITFORONE);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[nrecv++].msg_len = ret;
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      if (timeout != NULL &&
+          clock_systime_ticks() - start >= clock_time2ticks(timeout))
+        {
+          break;
+        }
+    }
+
+  return nrecv > 0 ? nrecv : ret;
+}
+
+/****************************************************************************
+ * Function: recvmmsg
+ *
+ * Description:
+ *   recvmmsg() receives up to 'vlen' messages from a socket with a single
+ *   call.  Apart from handling a vector of messages it behaves like
+ *   recvmsg().
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   The messages to receive
+ *   vlen     The number of messages in msgvec
+ *   flags    Receive flags, MSG_WAITFORONE turns on MSG_DONTWAIT after the
+ *            first message
+ *   timeout  The time after which no further message is received or NULL
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received and the msg_len
+ *   member of each of them is set to the number of bytes received.  On
+ *   error, -1 is returned, and errno is set as described for recvmsg().
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  FAR struct file *filep;
+  int ret;
+
+  /* recvmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  ret = sockfd_socket(sockfd, &filep, &psock);
+
+  /* Let psock_recvmmsg() do all of the work */
+
+  if (ret == OK)
+    {
+      ret = psock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+      fs_putfilep(filep);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
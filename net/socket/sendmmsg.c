@@ -0,0 +1,191 @@
+/****************************************************************************
+ * net/socket/sendmmsg.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends a batch of messages on a socket.  It is the
+ *   internal OS interface of sendmmsg(), see psock_sendmsg() for the
+ *   differences.  The address family handles the whole batch at once if it
+ *   provides si_sendmmsg(), otherwise the messages are sent one at a time
+ *   with psock_sendmsg().
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to send, msg_len is set to the bytes sent
+ *   vlen      The number of messages in msgvec
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent, which is less than vlen if an error
+ *   occurred after at least one message was sent.  A negated errno value
+ *   is returned if the first message could not be sent.
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags)
+{
+  FAR struct msghdr *msg;
+  unsigned int nsent;
+  int ret = OK;
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (msgvec == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* An invalid message ends the batch, it is reported by the next call
+   * if messages were sent before it.
+   */
+
+  for (nsent = 0; nsent < vlen; nsent++)
+    {
+      msg = &msgvec[nsent].msg_hdr;
+      if (msg->msg_iov == NULL || msg->msg_iov->iov_base == NULL)
+        {
+          ret = -EINVAL;
+          break;
+        }
+    }
+
+  if (nsent == 0)
+    {
+      return ret;
+    }
+
+  vlen = nsent;
+
+  /* Let logic specific to this address family handle the whole batch if it
+   * can.
+   */
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+
+  if (psock->s_sockif->si_sendmmsg != NULL)
+    {
+      ret = psock->s_sockif->si_sendmmsg(psock, msgvec, vlen, flags);
+      if (ret != -ENOSYS)
+        {
+          return ret;
+        }
+    }
+
+  /* Otherwise fall back to one message at a time */
+
+  for (nsent = 0; nsent < vlen; nsent++)
+    {
+      ret = psock_sendmsg(psock, &msgvec[nsent].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[nsent].msg_len = ret;
+    }
+
+  return nsent > 0 ? nsent : ret;
+}
+
+/****************************************************************************
+ * Function: sendmmsg
+ *
+ * Description:
+ *   sendmmsg() sends up to 'vlen' messages on a socket with a single call.
+ *   Apart from handling a vector of messages it behaves like sendmsg().
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   The messages to send
+ *   vlen     The number of messages in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent and the msg_len member
+ *   of each of them is set to the number of bytes sent.  On error, -1 is
+ *   returned, and errno is set as described for sendmsg().
+ *
+ ****************************************************************************/
+
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags)
+{
+  FAR struct socket *psock;
+  FAR struct file *filep;
+  int ret;
+
+  /* sendmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  ret = sockfd_socket(sockfd, &filep, &psock);
+
+  /* Let psock_sendmmsg() do all of the work */
+
+  if (ret == OK)
+    {
+      ret = psock_sendmmsg(psock, msgvec, vlen, flags);
+      fs_putfilep(filep);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
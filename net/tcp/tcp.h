@@ -32,6 +32,7 @@
 #include <sys/types.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
@@ -79,6 +80,12 @@
 #  define TCP_WBTRYCOPYIN(wrb,src,n,off) \
      (iob_trycopyin((wrb)->wb_iob,src,(n),(off),true))
 
+#  ifdef CONFIG_NET_TCP_ZEROCOPY
+#    define TCP_WBZEROCOPY(wrb)      ((wrb)->wb_zerocopy)
+#  else
+#    define TCP_WBZEROCOPY(wrb)      false
+#  endif
+
 #  define TCP_WBTRIM(wrb,n) \
      do { (wrb)->wb_iob = iob_trimhead((wrb)->wb_iob,(n)); } while (0)
 
@@ -105,6 +112,7 @@
 #define TCP_WSCALE            0x01U /* Window Scale option enabled */
 #define TCP_SACK              0x02U /* Selective ACKs enabled */
 #define TCP_CLOSE_ARRANGED    0x04U /* Connection is arranged to be freed */
+#define TCP_RCVBUF_LOCK       0x20U /* SO_RCVBUF set, no auto-tuning */
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
 /* The TCP flags for congestion control */
@@ -114,6 +122,12 @@
 
 #endif
 
+#ifdef CONFIG_NET_TCP_CC_BBR
+/* The number of rounds the bottleneck bandwidth of BBR is the maximum of */
+
+#define TCP_BBR_BW_ROUNDS     10
+#endif
+
 /* The Max Range count of TCP Selective ACKs */
 
 #define TCP_SACK_RANGES_MAX   4
@@ -176,6 +190,76 @@ struct tcp_sack_s
   uint32_t right;   /* Right edge of the SACK */
 };
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* A congestion control algorithm.  The common logic in tcp_cc.c does fast
+ * retransmit and fast recovery, and measures the round trip time once per
+ * round trip.  The algorithm decides how the congestion window grows and
+ * how it is reduced on a loss.
+ */
+
+struct tcp_conn_s;
+struct tcp_cc_ops_s
+{
+  FAR const char *name;
+
+  /* Reset the state of the algorithm, on starting a new connection */
+
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+
+  /* Grow the congestion window after 'acked' bytes were acknowledged
+   * outside of fast recovery.
+   */
+
+  CODE void (*cong_avoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+  /* Return the slow start threshold after a loss, on fast retransmit and
+   * on a retransmission timeout.
+   */
+
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+
+  /* A round trip time sample, 'delivered' bytes were acknowledged during
+   * it.  May be NULL.
+   */
+
+  CODE void (*rtt_sample)(FAR struct tcp_conn_s *conn, clock_t rtt,
+                          uint32_t delivered);
+};
+
+/* The state of the congestion control algorithms */
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+struct tcp_cubic_s
+{
+  uint32_t w_max;         /* The window before the last reduction */
+  uint32_t origin;        /* The window the cubic function is centered on */
+  uint32_t w_est;         /* The window of an equivalent Reno flow */
+  uint32_t k;             /* The time to reach the origin (units: msec) */
+  clock_t  epoch;         /* The start of the current congestion epoch */
+  bool     epoch_valid;   /* True: The congestion epoch has started */
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_BBR
+struct tcp_bbr_s
+{
+  /* The delivery rate of the last rounds (units: bytes/sec) */
+
+  uint32_t bw[TCP_BBR_BW_ROUNDS];
+
+  uint32_t full_bw;       /* The bandwidth when the pipe was last growing */
+  clock_t  rtprop;        /* The round-trip propagation time */
+  clock_t  rtprop_stamp;  /* The time rtprop was measured */
+  clock_t  probe_rtt_end; /* The end of PROBE_RTT */
+  uint8_t  round;         /* Index of the current round in bw[] */
+  uint8_t  mode;          /* STARTUP, DRAIN, PROBE_BW or PROBE_RTT */
+  uint8_t  full_cnt;      /* Rounds without bandwidth growth */
+  uint8_t  cycle;         /* The phase of the PROBE_BW gain cycle */
+  bool     filled;        /* True: The pipe was filled in STARTUP */
+};
+#endif
+#endif /* CONFIG_NET_TCP_CC_NEWRENO */
+
 struct tcp_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -208,6 +292,10 @@ struct tcp_conn_s
 
   /* TCP-specific content follows */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hash_node_t hnode;      /* Node in the active connection hashtable */
+  hash_node_t lnode;      /* Node in the listener hashtable */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -252,6 +340,26 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+
+  /* The congestion control algorithm and its state */
+
+  FAR const struct tcp_cc_ops_s *cc;
+
+  bool     cc_sampling;   /* True: A round trip time sample is running */
+  uint32_t cc_rttseq;     /* The sequence number that ends the sample */
+  clock_t  cc_rttstart;   /* The time the sample started */
+  uint32_t cc_delivered;  /* Bytes acknowledged during the sample */
+  clock_t  cc_minrtt;     /* The minimum round trip time seen */
+  union
+  {
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+    struct tcp_cubic_s cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+    struct tcp_bbr_s bbr;
+#endif
+    uint8_t dummy;
+  } cc_priv;
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -267,6 +375,16 @@ struct tcp_conn_s
 #if CONFIG_NET_RECV_BUFSIZE > 0
   int32_t  rcv_bufs;      /* Maximum amount of bytes queued in recv */
 #endif
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+  uint32_t rcv_copied;    /* Bytes drained by the application during the
+                           * current measurement */
+  clock_t  rcv_time;      /* The time the current measurement started */
+  clock_t  rcv_rtt;       /* The round trip time seen by the receiver */
+  clock_t  rcv_rttstart;  /* The time the round trip time sample started */
+  uint32_t rcv_rttseq;    /* The sequence number that ends the sample */
+  bool     rcv_sampling;  /* True: A round trip time sample is running */
+  bool     rcv_grown;     /* True: rcv_bufs grew beyond the default */
+#endif
 #if CONFIG_NET_SEND_BUFSIZE > 0
   int32_t  snd_bufs;      /* Maximum amount of bytes queued in send */
   sem_t    snd_sem;       /* Semaphore signals send completion */
@@ -328,6 +446,17 @@ struct tcp_conn_s
                            * segment (next greater sndseq) */
 #endif
 
+#ifdef CONFIG_NET_TCP_RACK
+  /* RACK loss detection, in units of the system clock tick.  rack_xmit and
+   * rack_endseq describe the most recently sent data that was delivered.
+   */
+
+  clock_t    rack_xmit;   /* The time that data was sent */
+  uint32_t   rack_endseq; /* The sequence number after that data */
+  clock_t    rack_rtt;    /* The round trip time of that data */
+  clock_t    rack_minrtt; /* The minimum round trip time seen */
+#endif
+
 #ifdef CONFIG_NET_TCPBACKLOG
   /* Listen backlog support
    *
@@ -358,6 +487,20 @@ struct tcp_conn_s
 
 #if defined(CONFIG_NET_SENDFILE) && defined(CONFIG_NET_TCP_WRITE_BUFFERS)
   bool       sendfile;    /* True if sendfile operation is in progress */
+#endif
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* MSG_ZEROCOPY sends are numbered from zero.  The completed sends not yet
+   * read from the error queue are zc_lo to zc_hi if zc_ready is set.
+   */
+
+  bool       zerocopy;    /* True: SO_ZEROCOPY enabled */
+  bool       zc_ready;    /* True: zc_lo..zc_hi completed */
+  uint32_t   zc_next;     /* Number of the next zero-copy send */
+  uint32_t   zc_lo;       /* First completed zero-copy send */
+  uint32_t   zc_hi;       /* Last completed zero-copy send */
+#endif
+#ifdef CONFIG_NET_TCP_TLS
+  FAR struct tcp_tls_s *tls; /* Kernel TLS transmission state */
 #endif
   bool       zero_probe;   /* TCP zero window probe timer */
 
@@ -413,6 +556,13 @@ struct tcp_wrbuffer_s
                             * segment sent */
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
   uint8_t    wb_nack;      /* The number of ack count */
+#endif
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  bool       wb_zerocopy;  /* The I/O buffers reference user data */
+#endif
+#ifdef CONFIG_NET_TCP_RACK
+  bool       wb_sacked;    /* All of the data was selectively ACKed */
+  clock_t    wb_xmit;      /* The time the data was last sent */
 #endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
 };
@@ -455,6 +605,18 @@ extern "C"
 {
 #endif
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* The congestion control algorithms */
+
+extern const struct tcp_cc_ops_s g_tcp_cc_newreno;
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+extern const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+extern const struct tcp_cc_ops_s g_tcp_cc_bbr;
+#endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -1066,6 +1228,25 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno);
 #endif
 
+/****************************************************************************
+ * Name: tcp_reuseport
+ *
+ * Description:
+ *   Select the listener of the SO_REUSEPORT group of 'listener' that
+ *   accepts the connection from the remote address in 'uaddr' and port
+ *   'rport'.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+FAR struct tcp_conn_s *tcp_reuseport(FAR struct tcp_conn_s *listener,
+                                     FAR union ip_binding_u *uaddr,
+                                     uint16_t rport);
+#endif
+
 /****************************************************************************
  * Name: tcp_unlisten
  *
@@ -1579,6 +1760,30 @@ int psock_tcp_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
                            int flags);
 
+/****************************************************************************
+ * Name: psock_tcp_recviob
+ *
+ * Description:
+ *   Hand all of the data in the read-ahead buffer of a TCP/IP SOCK_STREAM
+ *   over to the caller without copying it.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_STREAM socket
+ *   iob      The location to return the I/O buffer chain in
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   The number of bytes in the I/O buffer chain, zero if the peer closed
+ *   the connection or -EAGAIN if nothing is buffered.  Otherwise a negated
+ *   errno value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECVIOB
+ssize_t psock_tcp_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                          int flags);
+#endif
+
 /****************************************************************************
  * Name: psock_tcp_send
  *
@@ -1742,6 +1947,67 @@ uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
 
 bool tcp_should_send_recvwindow(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_rcvbuf_rtt
+ *
+ * Description:
+ *   Sample the round trip time seen by the receiver when a window is
+ *   advertised.  The peer can send beyond the advertised window only after
+ *   it got the advertisement, so the data reaching its right edge arrives
+ *   about one round trip time later if the peer has enough to send.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection structure holding connection information.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+void tcp_rcvbuf_rtt(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_rcvbuf_adjust
+ *
+ * Description:
+ *   Account data drained by the application and, once per round trip time,
+ *   resize the receive buffer to twice the amount drained in that time,
+ *   within the limits of the socket and a fair share of the I/O buffers.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection structure holding connection information.
+ *   copied - The number of bytes the application has drained.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+void tcp_rcvbuf_adjust(FAR struct tcp_conn_s *conn, size_t copied);
+#endif
+
+/****************************************************************************
+ * Name: tcp_rcvbuf_release
+ *
+ * Description:
+ *   Stop auto-tuning the receive buffer of the connection, because it is
+ *   freed or the application set SO_RCVBUF.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection structure holding connection information.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+void tcp_rcvbuf_release(FAR struct tcp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: psock_tcp_cansend
  *
@@ -2173,6 +2439,151 @@ int tcp_txdrain(FAR struct socket *psock, unsigned int timeout);
 #  define tcp_txdrain(conn, timeout) (0)
 #endif
 
+/****************************************************************************
+ * Name: tcp_zerocopy_alloc
+ *
+ * Description:
+ *   Start a MSG_ZEROCOPY send of the user data 'buf' and assign it the next
+ *   zero-copy send number of the connection.  The caller holds a reference
+ *   that is dropped with tcp_zerocopy_release() when the send returns.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *   buf  - The user data to send
+ *   len  - The length of the user data
+ *
+ * Returned Value:
+ *   The zero-copy send or NULL if out of memory.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+struct tcp_zerocopy_s;
+FAR struct tcp_zerocopy_s *tcp_zerocopy_alloc(FAR struct tcp_conn_s *conn,
+                                              FAR const void *buf,
+                                              size_t len);
+
+/****************************************************************************
+ * Name: tcp_zerocopy_release
+ *
+ * Description:
+ *   Drop the reference of the caller of tcp_zerocopy_alloc().  The send is
+ *   completed once the I/O buffers that reference its data are all freed.
+ *
+ * Input Parameters:
+ *   zc - The zero-copy send
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_zerocopy_release(FAR struct tcp_zerocopy_s *zc);
+
+/****************************************************************************
+ * Name: tcp_zerocopy_wrbuffer
+ *
+ * Description:
+ *   Fill a new write buffer with I/O buffers that reference 'len' bytes of
+ *   the user data at 'buf' of a zero-copy send instead of copying them.
+ *
+ * Input Parameters:
+ *   zc  - The zero-copy send that 'buf' belongs to
+ *   wrb - The new, empty write buffer
+ *   buf - The user data
+ *   len - The length of the user data
+ *
+ * Returned Value:
+ *   'len' on success.  -ENOMEM if less than 'len' bytes could be
+ *   referenced, the length of the write buffer tells how much was.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_zerocopy_wrbuffer(FAR struct tcp_zerocopy_s *zc,
+                          FAR struct tcp_wrbuffer_s *wrb,
+                          FAR const uint8_t *buf, size_t len);
+
+/****************************************************************************
+ * Name: tcp_zerocopy_recverr
+ *
+ * Description:
+ *   Implement recvmsg(MSG_ERRQUEUE), reporting the completed zero-copy
+ *   sends as a struct sock_extended_err control message.
+ *
+ * Input Parameters:
+ *   psock - The TCP socket of interest
+ *   msg   - Receives the control message
+ *
+ * Returned Value:
+ *   Zero on success, -EAGAIN if no completion is pending.
+ *
+ ****************************************************************************/
+
+ssize_t tcp_zerocopy_recverr(FAR struct socket *psock,
+                             FAR struct msghdr *msg);
+#endif
+
+/****************************************************************************
+ * Name: tcp_tls_setsockopt
+ *
+ * Description:
+ *   Install the transmit keys of a TLS 1.2 session with the SOL_TLS/TLS_TX
+ *   socket option.  The data sent on the socket is then framed into TLS
+ *   records and encrypted by the crypto framework.
+ *
+ * Input Parameters:
+ *   psock     - The TCP socket
+ *   option    - The SOL_TLS socket option
+ *   value     - A struct tls12_crypto_info_* of the cipher
+ *   value_len - The size of the structure
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TLS
+struct tcp_tls_s;
+int tcp_tls_setsockopt(FAR struct socket *psock, int option,
+                       FAR const void *value, socklen_t value_len);
+
+/****************************************************************************
+ * Name: tcp_tls_send
+ *
+ * Description:
+ *   Send user data on a socket with kernel TLS transmission.
+ *
+ * Input Parameters:
+ *   psock - The TCP socket
+ *   buf   - The user data
+ *   len   - The length of the user data
+ *   flags - The send flags
+ *
+ * Returned Value:
+ *   The number of user bytes sent; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t tcp_tls_send(FAR struct socket *psock, FAR const void *buf,
+                     size_t len, int flags);
+
+/****************************************************************************
+ * Name: tcp_tls_free
+ *
+ * Description:
+ *   Release the kernel TLS state of a connection.
+ *
+ ****************************************************************************/
+
+void tcp_tls_free(FAR struct tcp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: tcp_ioctl
  *
@@ -2323,6 +2734,46 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables on a retransmission timeout.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name, for
+ *   the TCP_CONGESTION socket option.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOENT if there is no such algorithm.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name);
 #endif
 
 #ifdef __cplusplus
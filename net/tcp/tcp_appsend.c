@@ -127,10 +127,12 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
        *    differently; they delay the ACKs for many more segments (6 or
        *    more).  Delaying for more segments would provide less network
        *    traffic and better performance but seems non-compliant.
+       * 4. A segment merged by the receive offload already stands for
+       *    several received segments, so it is ACKed right away.
        */
 
       if (conn->rx_unackseg > 0 || dev->d_sndlen > 0 ||
-          result != TCP_SNDACK)
+          result != TCP_SNDACK || NETDEV_GRO_SEGS(dev) > 1)
         {
           /* Reset the delayed ACK state and send the ACK with this packet. */
 
@@ -24,8 +24,15 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <string.h>
+#include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+
 #include "tcp/tcp.h"
 
 /****************************************************************************
@@ -74,10 +81,152 @@
     } \
  } while(0)
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void newreno_init(FAR struct tcp_conn_s *conn);
+static void newreno_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The congestion control algorithms that TCP_CONGESTION can select */
+
+static FAR const struct tcp_cc_ops_s *const g_tcp_cc[] =
+{
+  &g_tcp_cc_newreno,
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  &g_tcp_cc_cubic,
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+  &g_tcp_cc_bbr,
+#endif
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_newreno =
+{
+  "newreno",            /* name */
+  newreno_init,         /* init */
+  newreno_cong_avoid,   /* cong_avoid */
+  newreno_ssthresh,     /* ssthresh */
+  NULL                  /* rtt_sample */
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: newreno_init
+ ****************************************************************************/
+
+static void newreno_init(FAR struct tcp_conn_s *conn)
+{
+}
+
+/****************************************************************************
+ * Name: newreno_cong_avoid
+ *
+ * Description:
+ *   Slow start and congestion avoidance of RFC 5681.
+ *
+ ****************************************************************************/
+
+static void newreno_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  uint32_t increase;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      /* slow start (RFC 5681):
+       * Grow cwnd exponentially by maxseg(smss) per ACK.
+       */
+
+      increase = acked > 0 ? MIN(acked, conn->mss) : conn->mss;
+
+      CC_CWND_INC(conn->cwnd, increase);
+      ninfo("update slow start cwnd to %u\n", conn->cwnd);
+    }
+  else
+    {
+      /* cong avoid (RFC 5681):
+       * Grow cwnd linearly by approximately maxseg per RTT using
+       * maxseg^2 / cwnd per ACK as the increment.
+       * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
+       * avoid capping cwnd.
+       */
+
+      increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+
+      CC_CWND_INC(conn->cwnd, increase);
+      conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
+      ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
+    }
+}
+
+/****************************************************************************
+ * Name: newreno_ssthresh
+ *
+ * Description:
+ *   ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+ *
+ ****************************************************************************/
+
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return MAX(conn->tx_unacked / 2, 2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_rtt
+ *
+ * Description:
+ *   Measure the round trip time once per round trip: the time until the
+ *   data sent when the sample started is acknowledged.  No sample is taken
+ *   across a retransmission.
+ *
+ ****************************************************************************/
+
+static void tcp_cc_rtt(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                       uint32_t acked)
+{
+  clock_t now = clock_systime_ticks();
+  clock_t rtt;
+
+  conn->cc_delivered += acked;
+
+  if (conn->cc_sampling && TCP_SEQ_GTE(ackno, conn->cc_rttseq))
+    {
+      rtt = MAX(now - conn->cc_rttstart, 1);
+      if (conn->cc_minrtt == 0 || rtt < conn->cc_minrtt)
+        {
+          conn->cc_minrtt = rtt;
+        }
+
+      if (conn->cc->rtt_sample != NULL)
+        {
+          conn->cc->rtt_sample(conn, rtt, conn->cc_delivered);
+        }
+
+      conn->cc_sampling = false;
+    }
+
+  if (!conn->cc_sampling)
+    {
+      conn->cc_sampling  = true;
+      conn->cc_rttseq    = tcp_getsequence(conn->sndseq);
+      conn->cc_rttstart  = now;
+      conn->cc_delivered = 0;
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -117,6 +266,22 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
   conn->ssthresh = 2 * TCP_IPV4_DEFAULT_MSS;
   conn->dupacks = 0;
+
+  /* Keep the algorithm selected with TCP_CONGESTION before connect() */
+
+  if (conn->cc == NULL)
+    {
+      tcp_cc_select(conn, CONFIG_NET_TCP_CC_DEFAULT);
+      if (conn->cc == NULL)
+        {
+          conn->cc = &g_tcp_cc_newreno;
+        }
+    }
+
+  conn->cc_sampling = false;
+  conn->cc_minrtt   = 0;
+  memset(&conn->cc_priv, 0, sizeof(conn->cc_priv));
+  conn->cc->init(conn);
 }
 
 /****************************************************************************
@@ -140,16 +305,16 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
 void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 {
-  /* After Fast retransmitted, set ssthresh to the maximum of
-   * the unacked and the 2*SMSS, and enter to Fast Recovery.
-   * ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+  /* After Fast retransmitted, set ssthresh as the algorithm decides and
+   * enter to Fast Recovery.
    * cwnd=ssthresh + 3*SMSS  referring to rfc5681
    */
 
   if (conn->flags & TCP_INFT)
     {
-      conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+      conn->ssthresh = conn->cc->ssthresh(conn);
       conn->cwnd = conn->ssthresh + 3 * conn->mss;
+      conn->cc_sampling = false;
 
       conn->flags &= ~TCP_INFT;
       conn->flags |= TCP_INFR;
@@ -243,6 +408,11 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
       conn->dupacks = 0;
       conn->last_ackno = ackno;
 
+      if ((conn->flags & TCP_INFR) == 0)
+        {
+          tcp_cc_rtt(conn, ackno, acked);
+        }
+
       /* When the ackno covers more than the fr_recover, exit the
        * fast recovery. Then, reset the "IN Fast Recovery" flags.
        * Also reset the congestion window to the slow start threshold.
@@ -269,34 +439,87 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 
       if (conn->tcpstateflags >= TCP_ESTABLISHED)
         {
-          uint32_t increase;
+          conn->cc->cong_avoid(conn, acked);
+        }
+    }
+}
 
-          if (conn->cwnd < conn->ssthresh)
-            {
-              /* slow start (RFC 5681):
-               * Grow cwnd exponentially by maxseg(smss) per ACK.
-               */
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables on a retransmission timeout.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
 
-              increase = acked > 0 ? MIN(acked, conn->mss) : conn->mss;
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  /* If conn is TCP_INFR, it should enter to slow start */
 
-              CC_CWND_INC(conn->cwnd, increase);
-              ninfo("update slow start cwnd to %u\n", conn->cwnd);
-            }
-          else
-            {
-              /* cong avoid (RFC 5681):
-               * Grow cwnd linearly by approximately maxseg per RTT using
-               * maxseg^2 / cwnd per ACK as the increment.
-               * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
-               * avoid capping cwnd.
-               */
+  if (conn->flags & TCP_INFR)
+    {
+      conn->flags &= ~TCP_INFR;
+    }
+
+  /* update the max_cwnd */
+
+  conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
+
+  /* reset cwnd and ssthresh, refers to RFC5861. */
+
+  conn->ssthresh = conn->cc->ssthresh(conn);
+  conn->cwnd = conn->mss;
+  conn->cc_sampling = false;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name, for
+ *   the TCP_CONGESTION socket option.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOENT if there is no such algorithm.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name)
+{
+  int i;
 
-              increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+  for (i = 0; i < nitems(g_tcp_cc); i++)
+    {
+      if (strcmp(g_tcp_cc[i]->name, name) == 0)
+        {
+          if (conn->cc != g_tcp_cc[i])
+            {
+              /* Start the new algorithm from the current window */
 
-              CC_CWND_INC(conn->cwnd, increase);
-              conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
-              ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
+              conn->cc = g_tcp_cc[i];
+              memset(&conn->cc_priv, 0, sizeof(conn->cc_priv));
+              conn->cc->init(conn);
             }
+
+          return OK;
         }
     }
+
+  return -ENOENT;
 }
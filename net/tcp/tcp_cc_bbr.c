@@ -0,0 +1,321 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_bbr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC_BBR
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The states of BBR */
+
+#define BBR_STARTUP           0  /* Grow exponentially to fill the pipe */
+#define BBR_DRAIN             1  /* Drain the queue built in STARTUP */
+#define BBR_PROBE_BW          2  /* Cycle around the bottleneck bandwidth */
+#define BBR_PROBE_RTT         3  /* Drain the queue to measure RTprop */
+
+/* The gains are fixed point numbers with BBR_UNIT as 1.0 */
+
+#define BBR_UNIT              256
+#define BBR_HIGH_GAIN         739  /* 2/ln(2), the STARTUP gain */
+#define BBR_CWND_GAIN         512  /* The PROBE_BW window gain */
+#define BBR_CYCLE_LEN         8
+
+/* RTprop expires after 10 seconds, then PROBE_RTT runs for 200 msec */
+
+#define BBR_RTPROP_EXPIRE     SEC2TICK(10)
+#define BBR_PROBE_RTT_TIME    MSEC2TICK(200)
+
+/* The pipe is full after three rounds with less than 25% growth */
+
+#define BBR_FULL_CNT          3
+
+/* The smallest window, also the window in PROBE_RTT (units: segments) */
+
+#define BBR_MIN_SEGS          4
+
+#define BBR(c)                (&(c)->cc_priv.bbr)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void bbr_init(FAR struct tcp_conn_s *conn);
+static void bbr_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+static uint32_t bbr_ssthresh(FAR struct tcp_conn_s *conn);
+static void bbr_rtt_sample(FAR struct tcp_conn_s *conn, clock_t rtt,
+                           uint32_t delivered);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The PROBE_BW gain cycle.  There is no pacing, so the gains apply to the
+ * congestion window.
+ */
+
+static const uint16_t g_bbr_cycle[BBR_CYCLE_LEN] =
+{
+  320, 192, 256, 256, 256, 256, 256, 256
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_bbr =
+{
+  "bbr",                /* name */
+  bbr_init,             /* init */
+  bbr_cong_avoid,       /* cong_avoid */
+  bbr_ssthresh,         /* ssthresh */
+  bbr_rtt_sample        /* rtt_sample */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bbr_bw
+ *
+ * Description:
+ *   The bottleneck bandwidth, the maximum delivery rate of the last
+ *   TCP_BBR_BW_ROUNDS rounds (units: bytes/sec).
+ *
+ ****************************************************************************/
+
+static uint32_t bbr_bw(FAR struct tcp_bbr_s *bbr)
+{
+  uint32_t bw = 0;
+  int i;
+
+  for (i = 0; i < TCP_BBR_BW_ROUNDS; i++)
+    {
+      bw = MAX(bw, bbr->bw[i]);
+    }
+
+  return bw;
+}
+
+/****************************************************************************
+ * Name: bbr_target
+ *
+ * Description:
+ *   The bandwidth-delay product scaled by 'gain', or zero while there is no
+ *   estimate yet.
+ *
+ ****************************************************************************/
+
+static uint32_t bbr_target(FAR struct tcp_conn_s *conn, uint32_t gain)
+{
+  FAR struct tcp_bbr_s *bbr = BBR(conn);
+  uint64_t bdp;
+
+  bdp = (uint64_t)bbr_bw(bbr) * bbr->rtprop / TICK_PER_SEC;
+  if (bdp == 0)
+    {
+      return 0;
+    }
+
+  bdp = bdp * gain / BBR_UNIT;
+  return MIN(MAX(bdp, BBR_MIN_SEGS * conn->mss), UINT32_MAX / 2);
+}
+
+/****************************************************************************
+ * Name: bbr_init
+ ****************************************************************************/
+
+static void bbr_init(FAR struct tcp_conn_s *conn)
+{
+  BBR(conn)->mode = BBR_STARTUP;
+}
+
+/****************************************************************************
+ * Name: bbr_rtt_sample
+ *
+ * Description:
+ *   Update the model of the path once per round trip and advance the state
+ *   machine.
+ *
+ ****************************************************************************/
+
+static void bbr_rtt_sample(FAR struct tcp_conn_s *conn, clock_t rtt,
+                           uint32_t delivered)
+{
+  FAR struct tcp_bbr_s *bbr = BBR(conn);
+  clock_t now = clock_systime_ticks();
+  uint32_t bw;
+
+  /* Each round replaces the delivery rate of the oldest one */
+
+  bbr->round = (bbr->round + 1) % TCP_BBR_BW_ROUNDS;
+  bbr->bw[bbr->round] = MIN((uint64_t)delivered * TICK_PER_SEC / rtt,
+                            UINT32_MAX);
+
+  /* The queue must be drained now and then to see RTprop again */
+
+  if (bbr->rtprop != 0 && bbr->mode != BBR_PROBE_RTT &&
+      now - bbr->rtprop_stamp > BBR_RTPROP_EXPIRE)
+    {
+      bbr->mode          = BBR_PROBE_RTT;
+      bbr->probe_rtt_end = now + BBR_PROBE_RTT_TIME;
+      bbr->rtprop        = rtt;
+      bbr->rtprop_stamp  = now;
+    }
+  else if (bbr->rtprop == 0 || rtt <= bbr->rtprop)
+    {
+      bbr->rtprop        = rtt;
+      bbr->rtprop_stamp  = now;
+    }
+
+  bw = bbr_bw(bbr);
+
+  switch (bbr->mode)
+    {
+      case BBR_STARTUP:
+        if (bw >= (uint64_t)bbr->full_bw * 5 / 4)
+          {
+            bbr->full_bw  = bw;
+            bbr->full_cnt = 0;
+          }
+        else if (++bbr->full_cnt >= BBR_FULL_CNT)
+          {
+            bbr->filled = true;
+            bbr->mode   = BBR_DRAIN;
+          }
+        break;
+
+      case BBR_DRAIN:
+        if (conn->tx_unacked <= bbr_target(conn, BBR_UNIT))
+          {
+            bbr->mode  = BBR_PROBE_BW;
+            bbr->cycle = 2;
+          }
+        break;
+
+      case BBR_PROBE_BW:
+        bbr->cycle = (bbr->cycle + 1) % BBR_CYCLE_LEN;
+        break;
+
+      case BBR_PROBE_RTT:
+        if ((sclock_t)(now - bbr->probe_rtt_end) >= 0)
+          {
+            bbr->mode = bbr->filled ? BBR_PROBE_BW : BBR_STARTUP;
+          }
+
+        bbr->rtprop_stamp = now;
+        break;
+    }
+
+  ninfo("bbr mode %u bw %" PRIu32 " rtprop %u\n",
+        bbr->mode, bw, (unsigned int)bbr->rtprop);
+}
+
+/****************************************************************************
+ * Name: bbr_cong_avoid
+ *
+ * Description:
+ *   Move the congestion window towards the gain of the current state times
+ *   the estimated bandwidth-delay product.
+ *
+ ****************************************************************************/
+
+static void bbr_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_bbr_s *bbr = BBR(conn);
+  uint32_t target;
+
+  if (acked == 0)
+    {
+      acked = conn->mss;
+    }
+
+  switch (bbr->mode)
+    {
+      case BBR_STARTUP:
+        target = bbr_target(conn, BBR_HIGH_GAIN);
+        break;
+
+      case BBR_DRAIN:
+        target = bbr_target(conn, BBR_UNIT);
+        break;
+
+      case BBR_PROBE_BW:
+        target = bbr_target(conn, BBR_CWND_GAIN *
+                                  g_bbr_cycle[bbr->cycle] / BBR_UNIT);
+        break;
+
+      default:
+        target = BBR_MIN_SEGS * conn->mss;
+        break;
+    }
+
+  if (target == 0)
+    {
+      /* No model of the path yet, grow like slow start */
+
+      conn->cwnd += acked;
+    }
+  else if (bbr->filled || bbr->mode == BBR_PROBE_RTT)
+    {
+      conn->cwnd = MIN(conn->cwnd + acked, target);
+    }
+  else if (conn->cwnd < target)
+    {
+      conn->cwnd += acked;
+    }
+
+  conn->cwnd = MAX(conn->cwnd, BBR_MIN_SEGS * conn->mss);
+}
+
+/****************************************************************************
+ * Name: bbr_ssthresh
+ *
+ * Description:
+ *   BBR does not take a loss as a sign of congestion.  Only the data in
+ *   flight is allowed during the fast recovery (packet conservation).
+ *
+ ****************************************************************************/
+
+static uint32_t bbr_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return MAX(conn->tx_unacked, BBR_MIN_SEGS * conn->mss);
+}
+
+#endif /* CONFIG_NET_TCP_CC_BBR */
@@ -0,0 +1,246 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* RFC 9438: C = 0.4 segments/sec^3 and beta_cubic = 0.7.  The Reno
+ * friendly region grows by alpha_cubic = 3 * (1 - beta) / (1 + beta),
+ * which is 9/17.
+ */
+
+#define CUBIC_BETA_NUM        7
+#define CUBIC_BETA_DEN        10
+#define CUBIC_ALPHA_NUM       9
+#define CUBIC_ALPHA_DEN       17
+
+/* Limit |t - K| so that its cube fits into 63 bits (units: msec) */
+
+#define CUBIC_MAX_DELTA       (1 << 20)
+
+#define CUBIC(c)              (&(c)->cc_priv.cubic)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn);
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",              /* name */
+  cubic_init,           /* init */
+  cubic_cong_avoid,     /* cong_avoid */
+  cubic_ssthresh,       /* ssthresh */
+  NULL                  /* rtt_sample */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_cbrt
+ *
+ * Description:
+ *   Integer cube root, rounded down.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_cbrt(uint64_t x)
+{
+  uint64_t y = 0;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      uint64_t b;
+
+      y <<= 1;
+      b = 3 * y * (y + 1) + 1;
+      if ((x >> s) >= b)
+        {
+          x -= b << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  CUBIC(conn)->epoch_valid = false;
+}
+
+/****************************************************************************
+ * Name: cubic_cong_avoid
+ *
+ * Description:
+ *   Slow start below ssthresh, otherwise grow the congestion window along
+ *   W_cubic(t) = C * (t - K)^3 + W_max, but not slower than a Reno flow
+ *   would (RFC 9438 4.2 - 4.4).
+ *
+ ****************************************************************************/
+
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_cubic_s *cubic = CUBIC(conn);
+  clock_t now = clock_systime_ticks();
+  uint32_t increase;
+  int64_t target;
+  int64_t delta;
+
+  if (acked == 0)
+    {
+      acked = conn->mss;
+    }
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      conn->cwnd += MIN(acked, conn->mss);
+      return;
+    }
+
+  if (!cubic->epoch_valid)
+    {
+      /* A new congestion epoch starts with the first ACK after a loss */
+
+      cubic->epoch       = now;
+      cubic->epoch_valid = true;
+      cubic->w_est       = conn->cwnd;
+
+      if (conn->cwnd < cubic->w_max)
+        {
+          /* K = cbrt((W_max - cwnd) / C) seconds, with the window in
+           * segments and K in milliseconds.
+           */
+
+          cubic->k      = cubic_cbrt((uint64_t)(cubic->w_max - conn->cwnd) *
+                                     1000 / conn->mss * 2500000);
+          cubic->origin = cubic->w_max;
+        }
+      else
+        {
+          cubic->k      = 0;
+          cubic->origin = conn->cwnd;
+        }
+    }
+
+  /* The target window one round trip ahead */
+
+  delta = (int64_t)TICK2MSEC(now - cubic->epoch + conn->cc_minrtt) -
+          cubic->k;
+  delta = MAX(MIN(delta, CUBIC_MAX_DELTA), -CUBIC_MAX_DELTA);
+
+  target = cubic->origin +
+           4 * delta * delta * delta / 10000000000ll * conn->mss;
+  target = MAX(MIN(target, (int64_t)conn->cwnd * 3 / 2), 0);
+
+  if (target > conn->cwnd)
+    {
+      increase = (target - conn->cwnd) * acked / conn->cwnd;
+    }
+  else
+    {
+      increase = conn->mss * acked / (100 * conn->cwnd);
+    }
+
+  /* The Reno-friendly region */
+
+  cubic->w_est += (uint64_t)acked * conn->mss * CUBIC_ALPHA_NUM /
+                  ((uint64_t)CUBIC_ALPHA_DEN * conn->cwnd);
+
+  if (cubic->w_est > conn->cwnd + increase)
+    {
+      conn->cwnd = cubic->w_est;
+    }
+  else
+    {
+      conn->cwnd += MAX(increase, 1);
+    }
+
+  ninfo("update cubic cwnd to %" PRIu32 "\n", conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: cubic_ssthresh
+ *
+ * Description:
+ *   Reduce the window to beta_cubic = 0.7 times its size, with fast
+ *   convergence (RFC 9438 4.6 and 4.7).
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cubic_s *cubic = CUBIC(conn);
+
+  /* Release bandwidth to new flows if the window shrinks */
+
+  if (conn->cwnd < cubic->w_max)
+    {
+      cubic->w_max = (uint64_t)conn->cwnd *
+                     (CUBIC_BETA_DEN + CUBIC_BETA_NUM) /
+                     (2 * CUBIC_BETA_DEN);
+    }
+  else
+    {
+      cubic->w_max = conn->cwnd;
+    }
+
+  cubic->epoch_valid = false;
+
+  return MAX((uint64_t)conn->cwnd * CUBIC_BETA_NUM / CUBIC_BETA_DEN,
+             2 * conn->mss);
+}
+
+#endif /* CONFIG_NET_TCP_CC_CUBIC */
@@ -62,6 +62,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/netstats.h>
 #include <nuttx/net/tcp.h>
 
 #include "devif/devif.h"
@@ -71,6 +72,7 @@
 #include "icmpv6/icmpv6.h"
 #include "nat/nat.h"
 #include "netdev/netdev.h"
+#include "socket/socket.h"
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -91,10 +93,171 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* The connected TCP connections indexed by (lport, rport, raddr) */
+
+static DECLARE_HASHTABLE(g_active_tcp_hashtab,
+                         CONFIG_NET_TCP_CONN_HASH_BITS);
+#endif
+
+#ifdef CONFIG_NETDEV_DEMUX_CACHE
+/* Changed whenever a connection enters or leaves the active list, which
+ * invalidates the connections cached in the network devices.
+ */
+
+static uint32_t g_tcp_demux_gen;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_active_key
+ *
+ * Description:
+ *   Create the active connection hash key from the local port, the remote
+ *   port and (the low 32 bits of) the remote IP address.  The local address
+ *   is not part of the key because a connection bound to INADDR_ANY must
+ *   still be found for any destination address.
+ *
+ ****************************************************************************/
+
+static inline uint32_t tcp_active_key(uint16_t lport, uint16_t rport,
+                                      uint32_t raddr)
+{
+  return raddr ^ (((uint32_t)lport << 16) | rport);
+}
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/****************************************************************************
+ * Name: tcp_conn_key
+ *
+ * Description:
+ *   Create the active connection hash key of a connection structure.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_conn_key(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      return tcp_active_key(conn->lport, conn->rport,
+                            ((uint32_t)conn->u.ipv6.raddr[6] << 16) |
+                            conn->u.ipv6.raddr[7]);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      return tcp_active_key(conn->lport, conn->rport, conn->u.ipv4.raddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+#endif /* CONFIG_NET_TCP_CONN_HASH */
+
+/****************************************************************************
+ * Name: tcp_active_first
+ *
+ * Description:
+ *   Return the first active connection that may match the hash key.  Only
+ *   the connections in the same hash bucket are candidates if the hashtable
+ *   is enabled, otherwise all active connections have to be examined.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tcp_conn_s *tcp_active_first(uint32_t key)
+{
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR hash_node_t *node;
+
+  node = g_active_tcp_hashtab[HASH(key,
+                              hashtable_bits(g_active_tcp_hashtab))].head;
+  return node != NULL ? container_of(node, struct tcp_conn_s, hnode) : NULL;
+#else
+  UNUSED(key);
+  return (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_active_next
+ *
+ * Description:
+ *   Return the next active connection candidate after 'conn'.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tcp_conn_s *
+  tcp_active_next(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR hash_node_t *node = conn->hnode.flink;
+
+  return node != NULL ? container_of(node, struct tcp_conn_s, hnode) : NULL;
+#else
+  return (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_active_add
+ *
+ * Description:
+ *   Put a connection whose addresses and ports are now fixed into the list
+ *   (and the hashtable) of active connections.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_active_add(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hashtable_add(g_active_tcp_hashtab, &conn->hnode, tcp_conn_key(conn));
+#endif
+#ifdef CONFIG_NETDEV_DEMUX_CACHE
+  g_tcp_demux_gen++;
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_active_remove
+ *
+ * Description:
+ *   Remove a connection from the list (and the hashtable) of active
+ *   connections.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_active_remove(FAR struct tcp_conn_s *conn)
+{
+  dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hashtable_delete(g_active_tcp_hashtab, &conn->hnode, tcp_conn_key(conn));
+#endif
+#ifdef CONFIG_NETDEV_DEMUX_CACHE
+  g_tcp_demux_gen++;
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -105,11 +268,14 @@ static dq_queue_t g_active_tcp_connections;
  *   Primary uses: (1) to determine if a port number is available, (2) to
  *   To identify the socket that will accept new connections on a local port.
  *
+ *   The connections that set SO_REUSEPORT are passed over if 'reuseport' is
+ *   true.
+ *
  ****************************************************************************/
 
 static FAR struct tcp_conn_s *
   tcp_listener(uint8_t domain, FAR const union ip_addr_u *ipaddr,
-               uint16_t portno)
+               uint16_t portno, bool reuseport)
 {
   FAR struct tcp_conn_s *conn = NULL;
 
@@ -127,6 +293,15 @@ static FAR struct tcp_conn_s *
 #endif
          )
         {
+#ifdef CONFIG_NET_REUSEPORT
+          /* The members of a SO_REUSEPORT group share the port */
+
+          if (reuseport && _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+            {
+              continue;
+            }
+#endif
+
           /* If there are multiple interface devices, then the local IP
            * address of the connection must also match.  INADDR_ANY is a
            * special case:  There can only be instance of a port number
@@ -168,6 +343,42 @@ static FAR struct tcp_conn_s *
   return NULL;
 }
 
+/****************************************************************************
+ * Name: tcp_bindport
+ *
+ * Description:
+ *   Verify or select the local port that the connection is bound to.  The
+ *   sockets that all set SO_REUSEPORT may bind to the same port, so do the
+ *   connections accepted by them.
+ *
+ * Returned Value:
+ *   Selected or verified port number in network order on success, a negated
+ *   errno on failure.
+ *
+ ****************************************************************************/
+
+static int tcp_bindport(FAR struct tcp_conn_s *conn, uint8_t domain,
+                        FAR const union ip_addr_u *ipaddr, uint16_t portno)
+{
+#ifdef CONFIG_NET_REUSEPORT
+  if (portno != 0 && _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      if (tcp_listener(domain, ipaddr, portno, true) != NULL
+#ifdef CONFIG_NET_NAT
+          || nat_port_inuse(domain, IP_PROTO_TCP, ipaddr, portno)
+#endif
+         )
+        {
+          return -EADDRINUSE;
+        }
+
+      return portno;
+    }
+#endif
+
+  return tcp_selectport(domain, ipaddr, portno);
+}
+
 /****************************************************************************
  * Name: tcp_ipv4_active
  *
@@ -189,11 +400,13 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
-  while (conn)
+  for (conn = tcp_active_first(tcp_active_key(tcp->destport, tcp->srcport,
+                                              srcipaddr));
+       conn != NULL;
+       conn = tcp_active_next(conn))
     {
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
@@ -219,19 +432,13 @@ static inline FAR struct tcp_conn_s *
            net_ipv4addr_cmp(destipaddr, conn->u.ipv4.laddr)) &&
           net_ipv4addr_cmp(srcipaddr, conn->u.ipv4.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -255,12 +462,16 @@ static inline FAR struct tcp_conn_s *
   FAR struct tcp_conn_s *conn;
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
+  uint32_t key;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
+  key        = tcp_active_key(tcp->destport, tcp->srcport,
+                              ((uint32_t)ip->srcipaddr[6] << 16) |
+                              ip->srcipaddr[7]);
 
-  while (conn)
+  for (conn = tcp_active_first(key); conn != NULL;
+       conn = tcp_active_next(conn))
     {
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
@@ -286,19 +497,13 @@ static inline FAR struct tcp_conn_s *
            net_ipv6addr_cmp(*destipaddr, conn->u.ipv6.laddr)) &&
           net_ipv6addr_cmp(*srcipaddr, conn->u.ipv6.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -360,12 +565,12 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   /* Verify or select a local port (network byte order) */
 
-  port = tcp_selectport(PF_INET,
-                       (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
-                       addr->sin_port);
+  port = tcp_bindport(conn, PF_INET,
+                      (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
+                      addr->sin_port);
   if (port < 0)
     {
-      nerr("ERROR: tcp_selectport failed: %d\n", port);
+      nerr("ERROR: tcp_bindport failed: %d\n", port);
       net_unlock();
       return port;
     }
@@ -460,12 +665,12 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   /* The port number must be unique for this address binding */
 
-  port = tcp_selectport(PF_INET6,
+  port = tcp_bindport(conn, PF_INET6,
                 (FAR const union ip_addr_u *)addr->sin6_addr.in6_u.u6_addr16,
                 addr->sin6_port);
   if (port < 0)
     {
-      nerr("ERROR: tcp_selectport failed: %d\n", port);
+      nerr("ERROR: tcp_bindport failed: %d\n", port);
       net_unlock();
       return port;
     }
@@ -610,7 +815,7 @@ int tcp_selectport(uint8_t domain,
               return -EADDRINUSE;
             }
         }
-      while (tcp_listener(domain, ipaddr, portno)
+      while (tcp_listener(domain, ipaddr, portno, false)
 #ifdef CONFIG_NET_NAT
              || nat_port_inuse(domain, IP_PROTO_TCP, ipaddr, portno)
 #endif
@@ -622,7 +827,7 @@ int tcp_selectport(uint8_t domain,
        * connection is using this local port.
        */
 
-      if (tcp_listener(domain, ipaddr, portno)
+      if (tcp_listener(domain, ipaddr, portno, false)
 #ifdef CONFIG_NET_NAT
           || nat_port_inuse(domain, IP_PROTO_TCP, ipaddr, portno)
 #endif
@@ -782,6 +987,7 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
   if (conn)
     {
       memset(conn, 0, sizeof(struct tcp_conn_s));
+      conn_lock_init(&conn->sconn);
       conn->sconn.s_ttl   = IP_TTL_DEFAULT;
       conn->tcpstateflags = TCP_ALLOCATED;
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
@@ -839,8 +1045,10 @@ void tcp_free_rx_buffers(FAR struct tcp_conn_s *conn)
 {
   /* Release any read-ahead buffers attached to the connection */
 
+  conn_lock(&conn->sconn);
   iob_free_chain(conn->readahead);
   conn->readahead = NULL;
+  conn_unlock(&conn->sconn);
 
 #ifdef CONFIG_NET_TCP_OUT_OF_ORDER
   /* Release any out-of-order buffers */
@@ -922,11 +1130,19 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     {
       /* Remove the connection from the active list */
 
-      dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_active_remove(conn);
     }
 
   tcp_free_rx_buffers(conn);
 
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+  tcp_rcvbuf_release(conn);
+#endif
+
+#ifdef CONFIG_NET_TCP_TLS
+  tcp_tls_free(conn);
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
 
@@ -998,6 +1214,9 @@ void tcp_free(FAR struct tcp_conn_s *conn)
  *   Find a connection structure that is the appropriate
  *   connection to be used with the provided TCP/IP header
  *
+ *   If CONFIG_NETDEV_DEMUX_CACHE is enabled, the connection found for the
+ *   previous segment received on the device is tried first.
+ *
  * Assumptions:
  *   This function is called from network logic with the network locked.
  *
@@ -1006,12 +1225,30 @@ void tcp_free(FAR struct tcp_conn_s *conn)
 FAR struct tcp_conn_s *tcp_active(FAR struct net_driver_s *dev,
                                   FAR struct tcp_hdr_s *tcp)
 {
+  FAR struct tcp_conn_s *conn;
+
+#ifdef CONFIG_NETDEV_DEMUX_CACHE
+  conn = netdev_demux_lookup(dev, &dev->d_tcpdemux, g_tcp_demux_gen,
+                             tcp->destport, tcp->srcport);
+  if (conn != NULL && conn->tcpstateflags != TCP_CLOSED)
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.tcp.demuxhit++;
+#endif
+      return conn;
+    }
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.demuxmiss++;
+#endif
+#endif
+
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
   if (IFF_IS_IPv6(dev->d_flags))
 #endif
     {
-      return tcp_ipv6_active(dev, tcp);
+      conn = tcp_ipv6_active(dev, tcp);
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -1020,9 +1257,19 @@ FAR struct tcp_conn_s *tcp_active(FAR struct net_driver_s *dev,
   else
 #endif
     {
-      return tcp_ipv4_active(dev, tcp);
+      conn = tcp_ipv4_active(dev, tcp);
     }
 #endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NETDEV_DEMUX_CACHE
+  if (conn != NULL)
+    {
+      netdev_demux_update(dev, &dev->d_tcpdemux, g_tcp_demux_gen,
+                          tcp->destport, tcp->srcport, conn);
+    }
+#endif
+
+  return conn;
 }
 
 /****************************************************************************
@@ -1170,6 +1417,9 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #  ifdef CONFIG_NET_BINDTODEVICE
       conn->sconn.s_boundto  = listener->sconn.s_boundto;
 #  endif
+#  ifdef CONFIG_NET_REUSEPORT
+      conn->sconn.s_options |= listener->sconn.s_options & _SO_REUSEPORT;
+#  endif
 #endif
 
       conn->sconn.s_tos      = listener->sconn.s_tos;
@@ -1177,10 +1427,16 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #if CONFIG_NET_RECV_BUFSIZE > 0
       conn->rcv_bufs         = listener->rcv_bufs;
 #endif
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+      conn->flags           |= listener->flags & TCP_RCVBUF_LOCK;
+#endif
 #if CONFIG_NET_SEND_BUFSIZE > 0
       conn->snd_bufs         = listener->snd_bufs;
 #endif
       conn->mss              = listener->mss;
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      conn->cc               = listener->cc;
+#endif
 
       /* Fill in the necessary fields for the new connection. */
 
@@ -1231,7 +1487,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        * Interrupts should already be disabled in this context.
        */
 
-      dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_active_add(conn);
       tcp_update_retrantimer(conn, TCP_RTO);
     }
 
@@ -1542,7 +1798,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
   /* And, finally, put the connection structure into the active list. */
 
-  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_active_add(conn);
   ret = OK;
 
 errout_with_lock:
@@ -26,8 +26,10 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/time.h>
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -239,6 +241,19 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        {
+          FAR const char *name = conn->cc != NULL ?
+                                 conn->cc->name : CONFIG_NET_TCP_CC_DEFAULT;
+
+          *value_len = MIN(*value_len, strlen(name) + 1);
+          strlcpy(value, name, *value_len);
+          ret        = OK;
+        }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
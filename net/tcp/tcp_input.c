@@ -726,9 +726,11 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 #ifdef CONFIG_NET_TCP_CHECKSUMS
   /* Start of TCP input header processing code. */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!NETDEV_RXCSUM_OK(dev) && tcp_chksum(dev) != 0xffff)
     {
-      /* Compute and check the TCP checksum. */
+      /* Compute and check the TCP checksum, unless the hardware has
+       * already verified it.
+       */
 
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.tcp.drop++;
@@ -781,6 +783,9 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 #  endif
         {
           net_ipv6addr_copy(&uaddr.ipv6.laddr, IPv6BUF->destipaddr);
+#ifdef CONFIG_NET_REUSEPORT
+          net_ipv6addr_copy(&uaddr.ipv6.raddr, IPv6BUF->srcipaddr);
+#endif
         }
 #endif
 
@@ -791,6 +796,10 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
         {
           net_ipv4addr_copy(uaddr.ipv4.laddr,
                             net_ip4addr_conv32(IPv4BUF->destipaddr));
+#ifdef CONFIG_NET_REUSEPORT
+          net_ipv4addr_copy(uaddr.ipv4.raddr,
+                            net_ip4addr_conv32(IPv4BUF->srcipaddr));
+#endif
         }
 #endif
 
@@ -800,6 +809,12 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
       if ((conn = tcp_findlistener(&uaddr, tmp16)) != NULL)
 #endif
         {
+#ifdef CONFIG_NET_REUSEPORT
+          /* Spread the connections over a SO_REUSEPORT group */
+
+          conn = tcp_reuseport(conn, &uaddr, tcp->srcport);
+#endif
+
           if (!tcp_backlogavailable(conn))
             {
               nerr("ERROR: no free containers for TCP BACKLOG!\n");
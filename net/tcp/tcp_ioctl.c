@@ -126,6 +126,7 @@ int tcp_ioctl(FAR struct tcp_conn_s *conn, int cmd, unsigned long arg)
   switch (cmd)
     {
       case FIONREAD:
+        conn_lock(&conn->sconn);
         if (conn->readahead != NULL)
           {
             *(FAR int *)((uintptr_t)arg) = conn->readahead->io_pktlen;
@@ -134,6 +135,8 @@ int tcp_ioctl(FAR struct tcp_conn_s *conn, int cmd, unsigned long arg)
           {
             *(FAR int *)((uintptr_t)arg) = 0;
           }
+
+        conn_unlock(&conn->sconn);
         break;
       case FIONSPACE:
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
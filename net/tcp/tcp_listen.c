@@ -48,6 +48,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <limits.h>
 #include <debug.h>
 
 #include <nuttx/net/netconfig.h>
@@ -55,94 +56,236 @@
 
 #include "devif/devif.h"
 #include "inet/inet.h"
+#include "socket/socket.h"
 #include "tcp/tcp.h"
+#include "utils/utils.h"
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* The listening connections indexed by their local port number, and the
+ * number of connections in the hashtable.
+ */
+
+static DECLARE_HASHTABLE(g_tcp_listen_hashtab,
+                         CONFIG_NET_TCP_CONN_HASH_BITS);
+static int g_tcp_nlisteners;
+#else
 /* The tcp_listenports list all currently listening ports. */
 
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: tcp_findlistener
+ * Name: tcp_listener_match
  *
  * Description:
- *   Return the connection listener for connections on this port (if any)
- *
- * Assumptions:
- *   This function is called from network logic with the network locked.
+ *   Return true if the listening connection accepts connections on this
+ *   local address and port.
  *
  ****************************************************************************/
 
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
-                                        uint16_t portno,
-                                        uint8_t domain)
-#else
-FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
-                                        uint16_t portno)
-#endif
+static bool tcp_listener_match(FAR struct tcp_conn_s *conn,
+                               FAR union ip_binding_u *uaddr,
+                               uint16_t portno, uint8_t domain)
 {
-  int ndx;
-
-  /* Examine each connection structure in each slot of the listener list */
-
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
-    {
-      /* Is this slot assigned?  If so, does the connection have the same
-       * local port number?
-       */
+  /* Does the connection have the same local port number? */
 
-      FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-      if (conn && conn->lport == portno && conn->domain == domain)
+  if (conn->lport != portno || conn->domain != domain)
 #else
-      if (conn && conn->lport == portno)
+  if (conn->lport != portno)
 #endif
-        {
+    {
+      return false;
+    }
+
 #ifdef CONFIG_NET_IPv6
 #  ifdef CONFIG_NET_IPv4
-          if (domain == PF_INET6)
+  if (domain == PF_INET6)
 #  endif
-            {
-              if (net_ipv6addr_cmp(conn->u.ipv6.laddr, uaddr->ipv6.laddr) ||
-                  net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr))
-                {
-                  /* Yes.. we found a listener on this port */
-
-                  return conn;
-                }
-            }
+    {
+      return net_ipv6addr_cmp(conn->u.ipv6.laddr, uaddr->ipv6.laddr) ||
+             net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr);
+    }
 #endif
 
 #ifdef CONFIG_NET_IPv4
 #  ifdef CONFIG_NET_IPv6
-          if (domain == PF_INET)
+  else
 #  endif
-            {
-              if (net_ipv4addr_cmp(conn->u.ipv4.laddr, uaddr->ipv4.laddr) ||
-                  net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY))
-                {
-                  /* Yes.. we found a listener on this port */
+    {
+      return net_ipv4addr_cmp(conn->u.ipv4.laddr, uaddr->ipv4.laddr) ||
+             net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY);
+    }
+#endif
+}
 
-                  return conn;
-                }
-            }
+/****************************************************************************
+ * Name: tcp_listener_nth
+ *
+ * Description:
+ *   Return true if the listening connection is the 'nth' one to accept
+ *   connections on this local address and port.  'nth' is decremented for
+ *   every matching listener passed over.
+ *
+ ****************************************************************************/
+
+static bool tcp_listener_nth(FAR struct tcp_conn_s *conn,
+                             FAR union ip_binding_u *uaddr,
+                             uint16_t portno, uint8_t domain,
+                             FAR unsigned int *nth, bool reuseport)
+{
+  if (!tcp_listener_match(conn, uaddr, portno, domain))
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_REUSEPORT
+  if (reuseport && !_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      return false;
+    }
 #endif
+
+  return (*nth)-- == 0;
+}
+
+/****************************************************************************
+ * Name: tcp_nthlistener
+ *
+ * Description:
+ *   Return the listener that is the 'nth' one (counted from zero) to accept
+ *   connections on this local address and port.  Only the listeners that
+ *   set SO_REUSEPORT are counted if 'reuseport' is true.  'nth' is
+ *   decremented for every listener passed over, so the number of listeners
+ *   is UINT_MAX less its final value if it starts at UINT_MAX.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_conn_s *tcp_nthlistener(FAR union ip_binding_u *uaddr,
+                                              uint16_t portno,
+                                              uint8_t domain,
+                                              FAR unsigned int *nth,
+                                              bool reuseport)
+{
+  FAR struct tcp_conn_s *conn;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR hash_node_t *node;
+
+  /* Examine the listeners that hash to the same bucket as this port */
+
+  hashtable_for_every_possible(g_tcp_listen_hashtab, node, portno)
+    {
+      conn = container_of(node, struct tcp_conn_s, lnode);
+      if (tcp_listener_nth(conn, uaddr, portno, domain, nth, reuseport))
+        {
+          /* Yes.. we found a listener on this port */
+
+          return conn;
         }
     }
+#else
+  int ndx;
+
+  /* Examine each connection structure in each slot of the listener list */
+
+  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+    {
+      /* Is this slot assigned?  If so, does the connection listen on the
+       * same local address and port number?
+       */
+
+      conn = tcp_listenports[ndx];
+      if (conn != NULL &&
+          tcp_listener_nth(conn, uaddr, portno, domain, nth, reuseport))
+        {
+          /* Yes.. we found a listener on this port */
+
+          return conn;
+        }
+    }
+#endif
 
   /* No listener for this port */
 
   return NULL;
 }
 
+/****************************************************************************
+ * Name: tcp_listen_conflict
+ *
+ * Description:
+ *   Return true if another socket listens on the port of 'conn' already.
+ *   The sockets that all set SO_REUSEPORT may listen on the same port.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static bool tcp_listen_conflict(FAR struct tcp_conn_s *conn)
+{
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  uint8_t domain = conn->domain;
+#else
+  uint8_t domain = 0;
+#endif
+  unsigned int nall = UINT_MAX;
+#ifdef CONFIG_NET_REUSEPORT
+  unsigned int ngroup = UINT_MAX;
+#endif
+
+  tcp_nthlistener(&conn->u, conn->lport, domain, &nall, false);
+
+#ifdef CONFIG_NET_REUSEPORT
+  if (_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      tcp_nthlistener(&conn->u, conn->lport, domain, &ngroup, true);
+      return nall != ngroup;
+    }
+#endif
+
+  return nall != UINT_MAX;
+}
+
+/****************************************************************************
+ * Name: tcp_findlistener
+ *
+ * Description:
+ *   Return the connection listener for connections on this port (if any)
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
+                                        uint16_t portno,
+                                        uint8_t domain)
+#else
+FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
+                                        uint16_t portno)
+#endif
+{
+#if !defined(CONFIG_NET_IPv4) || !defined(CONFIG_NET_IPv6)
+  uint8_t domain = 0;
+#endif
+  unsigned int nth = 0;
+
+  return tcp_nthlistener(uaddr, portno, domain, &nth, false);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -160,10 +303,26 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR hash_node_t *node;
+#else
   int ndx;
+#endif
   int ret = -EINVAL;
 
   net_lock();
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hashtable_for_every_possible(g_tcp_listen_hashtab, node, conn->lport)
+    {
+      if (node == &conn->lnode)
+        {
+          hashtable_delete(g_tcp_listen_hashtab, node, conn->lport);
+          g_tcp_nlisteners--;
+          ret = OK;
+          break;
+        }
+    }
+#else
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
     {
       if (tcp_listenports[ndx] == conn)
@@ -173,6 +332,7 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
           break;
         }
     }
+#endif
 
   net_unlock();
   return ret;
@@ -191,7 +351,9 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
+#ifndef CONFIG_NET_TCP_CONN_HASH
   int ndx;
+#endif
   int ret;
 
   /* This must be done with network locked because the listener table
@@ -202,11 +364,7 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
   /* First, check if there is already a socket listening on this port */
 
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  if (tcp_islistener(&conn->u, conn->lport, conn->domain))
-#else
-  if (tcp_islistener(&conn->u, conn->lport))
-#endif
+  if (tcp_listen_conflict(conn))
     {
       /* Yes, then we must refuse this request */
 
@@ -220,6 +378,16 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
       ret = -ENOBUFS; /* Assume failure */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      /* The hashtable is still bounded by the number of listening ports */
+
+      if (g_tcp_nlisteners < CONFIG_NET_MAX_LISTENPORTS)
+        {
+          hashtable_add(g_tcp_listen_hashtab, &conn->lnode, conn->lport);
+          g_tcp_nlisteners++;
+          ret = OK;
+        }
+#else
       /* Search all slots until an available slot is found */
 
       for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
@@ -235,6 +403,7 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               break;
             }
         }
+#endif
     }
 
   net_unlock();
@@ -265,6 +434,78 @@ bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno)
 }
 #endif
 
+/****************************************************************************
+ * Name: tcp_reuseport
+ *
+ * Description:
+ *   Select the listener of the SO_REUSEPORT group of 'listener' that
+ *   accepts the connection from the remote address in 'uaddr' and port
+ *   'rport'.  The choice depends on a hash of the connection, so all
+ *   segments of the connection select the same listener as long as the
+ *   group does not change.
+ *
+ * Input Parameters:
+ *   listener - A listener found with tcp_findlistener()
+ *   uaddr    - The local and the remote address of the connection
+ *   rport    - The remote port of the connection
+ *
+ * Returned Value:
+ *   The selected listener, 'listener' if it is not in a group.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+FAR struct tcp_conn_s *tcp_reuseport(FAR struct tcp_conn_s *listener,
+                                     FAR union ip_binding_u *uaddr,
+                                     uint16_t rport)
+{
+  FAR const void *raddr;
+  unsigned int count = UINT_MAX;
+  unsigned int nth;
+  uint8_t domain;
+
+  if (!_SO_GETOPT(listener->sconn.s_options, SO_REUSEPORT))
+    {
+      return listener;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (listener->domain == PF_INET6)
+#  endif
+    {
+      domain = PF_INET6;
+      raddr  = uaddr->ipv6.raddr;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  else
+#  endif
+    {
+      domain = PF_INET;
+      raddr  = &uaddr->ipv4.raddr;
+    }
+#endif
+
+  /* Count the listeners of the group */
+
+  tcp_nthlistener(uaddr, listener->lport, domain, &count, true);
+  count = UINT_MAX - count;
+  if (count <= 1)
+    {
+      return listener;
+    }
+
+  nth = net_flowhash(domain, raddr, rport, listener->lport) % count;
+  return tcp_nthlistener(uaddr, listener->lport, domain, &nth, true);
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_accept_connection
  *
@@ -294,6 +535,12 @@ int tcp_accept_connection(FAR struct net_driver_s *dev,
 #endif
   if (listener != NULL)
     {
+#ifdef CONFIG_NET_REUSEPORT
+      /* Pass the connection to the listener that its SYN selected */
+
+      listener = tcp_reuseport(listener, &conn->u, conn->rport);
+#endif
+
       /* Yes, there is a listener.  Is it accepting connections now? */
 
       if (listener->accept)
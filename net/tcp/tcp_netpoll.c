@@ -297,6 +297,15 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       eventset |= POLLRDNORM;
     }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* Completed zero-copy sends wait on the error queue */
+
+  if (conn->zc_ready)
+    {
+      eventset |= POLLERR;
+    }
+#endif
+
   /* Check for a loss of connection events.  We need to be careful here.
    * There are four possibilities:
    *
@@ -250,6 +250,7 @@ static inline void tcp_readahead(struct tcp_recvfrom_s *pstate)
    * buffer.
    */
 
+  conn_lock(&conn->sconn);
   while ((iob = conn->readahead) != NULL &&
           pstate->ir_buflen > 0)
     {
@@ -297,6 +298,8 @@ static inline void tcp_readahead(struct tcp_recvfrom_s *pstate)
           conn->readahead = iob_trimhead(iob, recvlen);
         }
     }
+
+  conn_unlock(&conn->sconn);
 }
 
 /****************************************************************************
@@ -666,10 +669,51 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   struct tcp_callback_s  info;
   int                    ret;
 
-  net_lock();
-
   conn = psock->s_conn;
 
+#ifdef CONFIG_NET_CONN_LOCK
+  /* If data is already buffered and the caller does not insist on waiting
+   * for the whole buffer, copy it out of the read-ahead buffer holding only
+   * the connection lock.  The network lock is taken afterwards just long
+   * enough to announce the reopened receive window.
+   */
+
+  if ((flags & MSG_WAITALL) == 0)
+    {
+      conn_lock(&conn->sconn);
+      tcp_recvfrom_initialize(conn, buf, len, from, fromlen, &state, flags);
+      tcp_readahead(&state);
+      conn_unlock(&conn->sconn);
+
+      if (state.ir_recvlen > 0)
+        {
+          net_lock();
+          if (tcp_should_send_recvwindow(conn))
+            {
+              netdev_txnotify_dev(conn->dev);
+            }
+
+          tcp_notify_recvcpu(conn);
+
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+          if ((flags & MSG_PEEK) == 0)
+            {
+              tcp_rcvbuf_adjust(conn, state.ir_recvlen);
+            }
+
+#endif
+          net_unlock();
+
+          tcp_recvfrom_uninitialize(&state);
+          return state.ir_recvlen;
+        }
+
+      tcp_recvfrom_uninitialize(&state);
+    }
+#endif
+
+  net_lock();
+
   /* Initialize the state structure.  This is done with the network locked
    * because we don't want anything to happen until we are ready.
    */
@@ -811,6 +855,13 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
    * not only this particular connection.
    */
 
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+  if (ret > 0 && (flags & MSG_PEEK) == 0)
+    {
+      tcp_rcvbuf_adjust(conn, ret);
+    }
+
+#endif
   if (tcp_should_send_recvwindow(conn))
     {
       netdev_txnotify_dev(conn->dev);
@@ -823,4 +874,70 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   return (ssize_t)ret;
 }
 
+/****************************************************************************
+ * Name: psock_tcp_recviob
+ *
+ * Description:
+ *   Hand all of the data in the read-ahead buffer of a TCP/IP SOCK_STREAM
+ *   over to the caller without copying it.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_STREAM socket
+ *   iob      The location to return the I/O buffer chain in
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   The number of bytes in the I/O buffer chain, zero if the peer closed
+ *   the connection or -EAGAIN if nothing is buffered.  Otherwise a negated
+ *   errno value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECVIOB
+ssize_t psock_tcp_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                          int flags)
+{
+  FAR struct tcp_conn_s *conn = psock->s_conn;
+  ssize_t ret;
+
+  net_lock();
+
+  conn_lock(&conn->sconn);
+  *iob = conn->readahead;
+  conn->readahead = NULL;
+  conn_unlock(&conn->sconn);
+
+  if (*iob != NULL)
+    {
+      ret = (*iob)->io_pktlen;
+
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+      tcp_rcvbuf_adjust(conn, ret);
+#endif
+
+      /* The read-ahead buffer is empty again, announce the window */
+
+      if (tcp_should_send_recvwindow(conn))
+        {
+          netdev_txnotify_dev(conn->dev);
+        }
+
+      tcp_notify_recvcpu(conn);
+    }
+  else if (!_SS_ISCONNECTED(conn->sconn.s_flags))
+    {
+      /* End-of-file after a graceful close, like psock_tcp_recvfrom() */
+
+      ret = _SS_ISCLOSED(conn->sconn.s_flags) ? 0 : -ENOTCONN;
+    }
+  else
+    {
+      ret = -EAGAIN;
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
 #endif /* CONFIG_NET_TCP */
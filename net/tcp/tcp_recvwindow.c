@@ -26,12 +26,14 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <debug.h>
 
 #include <net/if.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
@@ -39,10 +41,59 @@
 
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+/* The number of connections whose receive buffer grew beyond the default.
+ * They share the I/O buffers available for read-ahead.
+ */
+
+static unsigned int g_tcp_rcvbuf_ngrown;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_rcvbuf_limit
+ *
+ * Description:
+ *   Calculate the largest receive buffer auto-tuning may give the
+ *   connection: its fair share of the I/O buffers available for read-ahead,
+ *   but no more than NET_MAX_RECV_BUFSIZE and no less than the default.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection.
+ *
+ * Returned Value:
+ *   The maximum receive buffer size.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+static uint32_t tcp_rcvbuf_limit(FAR struct tcp_conn_s *conn)
+{
+  unsigned int nshare = g_tcp_rcvbuf_ngrown;
+  uint32_t limit;
+
+  if (!conn->rcv_grown)
+    {
+      nshare++;
+    }
+
+  limit = (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE) * CONFIG_IOB_BUFSIZE /
+          nshare;
+#if CONFIG_NET_MAX_RECV_BUFSIZE > 0
+  limit = MIN(limit, CONFIG_NET_MAX_RECV_BUFSIZE);
+#endif
+
+  return MAX(limit, CONFIG_NET_RECV_BUFSIZE);
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_calc_rcvsize
  *
@@ -65,7 +116,9 @@ static uint32_t tcp_calc_rcvsize(FAR struct tcp_conn_s *conn,
   uint32_t recvsize;
   uint32_t desire;
 
+  conn_lock(&conn->sconn);
   recvsize = conn->readahead ? conn->readahead->io_pktlen : 0;
+  conn_unlock(&conn->sconn);
   if (conn->rcv_bufs > recvsize)
     {
       desire = conn->rcv_bufs - recvsize;
@@ -156,6 +209,7 @@ uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
    * (ignoring competition with other IOB consumers).
    */
 
+  conn_lock(&conn->sconn);
   if (conn->readahead != NULL)
     {
       tailroom = iob_tailroom(conn->readahead);
@@ -165,6 +219,8 @@ uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
       tailroom = 0;
     }
 
+  conn_unlock(&conn->sconn);
+
   niob_avail = iob_navail(true);
 
   /* Is there a a queue entry and IOBs available for read-ahead buffering? */
@@ -344,3 +400,163 @@ bool tcp_should_send_recvwindow(FAR struct tcp_conn_s *conn)
         adv, mss, maxwin);
   return false;
 }
+
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+/****************************************************************************
+ * Name: tcp_rcvbuf_rtt
+ *
+ * Description:
+ *   Sample the round trip time seen by the receiver when a window is
+ *   advertised.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection structure holding connection information.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_rcvbuf_rtt(FAR struct tcp_conn_s *conn)
+{
+  clock_t now = clock_systime_ticks();
+  uint32_t rcvseq;
+  clock_t rtt;
+
+  if ((conn->flags & TCP_RCVBUF_LOCK) != 0)
+    {
+      return;
+    }
+
+  rcvseq = tcp_getsequence(conn->rcvseq);
+  if (conn->rcv_sampling)
+    {
+      if (TCP_SEQ_LT(rcvseq, conn->rcv_rttseq))
+        {
+          return;
+        }
+
+      /* The samples are upper bounds when the peer had less to send, so
+       * a smaller one is taken right away and a larger one only smoothed.
+       */
+
+      rtt = MAX(now - conn->rcv_rttstart, 1);
+      if (conn->rcv_rtt == 0 || rtt < conn->rcv_rtt)
+        {
+          conn->rcv_rtt = rtt;
+        }
+      else
+        {
+          conn->rcv_rtt = (7 * conn->rcv_rtt + rtt) / 8;
+        }
+    }
+
+  /* Start the next sample at the right edge just advertised */
+
+  conn->rcv_sampling = TCP_SEQ_GT(conn->rcv_adv, rcvseq);
+  conn->rcv_rttseq   = conn->rcv_adv;
+  conn->rcv_rttstart = now;
+}
+
+/****************************************************************************
+ * Name: tcp_rcvbuf_adjust
+ *
+ * Description:
+ *   Account data drained by the application and resize the receive buffer
+ *   once per round trip time.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection structure holding connection information.
+ *   copied - The number of bytes the application has drained.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_rcvbuf_adjust(FAR struct tcp_conn_s *conn, size_t copied)
+{
+  clock_t now = clock_systime_ticks();
+  uint32_t rcvbufs = conn->rcv_bufs;
+  uint32_t target;
+  bool grown;
+
+  if ((conn->flags & TCP_RCVBUF_LOCK) != 0)
+    {
+      return;
+    }
+
+  /* Measure only once the round trip time is known */
+
+  if (conn->rcv_rtt == 0)
+    {
+      conn->rcv_copied = 0;
+      conn->rcv_time   = now;
+      return;
+    }
+
+  conn->rcv_copied += copied;
+  if (now - conn->rcv_time < conn->rcv_rtt)
+    {
+      return;
+    }
+
+  /* The buffer has to hold what the application drains in one round trip
+   * time while the window update travels to the peer and its data back.
+   * Grow to that right away, but shrink slowly so that a short stall of
+   * the application does not collapse the window.
+   */
+
+  target = MAX(2 * conn->rcv_copied, CONFIG_NET_RECV_BUFSIZE);
+  if (target > rcvbufs)
+    {
+      rcvbufs = target;
+    }
+  else
+    {
+      rcvbufs -= (rcvbufs - target) / 4;
+    }
+
+  conn->rcv_bufs   = MIN(rcvbufs, tcp_rcvbuf_limit(conn));
+  conn->rcv_copied = 0;
+  conn->rcv_time   = now;
+
+  grown = conn->rcv_bufs > CONFIG_NET_RECV_BUFSIZE;
+  if (grown != conn->rcv_grown)
+    {
+      if (grown)
+        {
+          g_tcp_rcvbuf_ngrown++;
+        }
+      else
+        {
+          g_tcp_rcvbuf_ngrown--;
+        }
+
+      conn->rcv_grown = grown;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_rcvbuf_release
+ *
+ * Description:
+ *   Stop auto-tuning the receive buffer of the connection.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection structure holding connection information.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_rcvbuf_release(FAR struct tcp_conn_s *conn)
+{
+  if (conn->rcv_grown)
+    {
+      g_tcp_rcvbuf_ngrown--;
+      conn->rcv_grown = false;
+    }
+}
+#endif /* CONFIG_NET_TCP_RCVBUF_AUTOTUNE */
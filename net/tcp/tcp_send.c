@@ -164,6 +164,10 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
 
       conn->rcv_adv = rcvseq + recvwndo;
 
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+      tcp_rcvbuf_rtt(conn);
+#endif
+
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
       recvwndo >>= conn->rcv_scale;
 #endif
@@ -195,12 +199,15 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
                         conn->u.ipv6.raddr,
                         conn->sconn.s_ttl, conn->sconn.s_tclass);
 
-      /* Calculate TCP checksum. */
+      /* Calculate TCP checksum, unless the hardware will fill it in. */
 
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!NETDEV_TXCSUM(dev))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
@@ -219,12 +226,15 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
                         &dev->d_ipaddr, &conn->u.ipv4.raddr,
                         conn->sconn.s_ttl, conn->sconn.s_tos, NULL);
 
-      /* Calculate TCP checksum. */
+      /* Calculate TCP checksum, unless the hardware will fill it in. */
 
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!NETDEV_TXCSUM(dev))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
@@ -503,7 +513,10 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!NETDEV_TXCSUM(dev))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
 #endif
     }
 #endif /* CONFIG_NET_IPv6 */
@@ -523,7 +536,10 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!NETDEV_TXCSUM(dev))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
 #endif
     }
 #endif /* CONFIG_NET_IPv4 */
@@ -235,6 +235,9 @@ static void retransmit_segment(FAR struct tcp_conn_s *conn,
         }
 
       TCP_WBSENT(wrb) = 0;
+#ifdef CONFIG_NET_TCP_RACK
+      wrb->wb_sacked = false;
+#endif
 
       /* Insert the write buffer into the write_q (in sequence
        * number order).  The retransmission will occur below
@@ -412,6 +415,172 @@ static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
 }
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
 
+/****************************************************************************
+ * Name: rack_delivered
+ *
+ * Description:
+ *   Update the RACK state with a write buffer that was delivered, either
+ *   selectively or cumulatively acknowledged (RFC8985 6.2).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   wrb    - The write buffer that was delivered
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RACK
+static void rack_delivered(FAR struct tcp_conn_s *conn,
+                           FAR struct tcp_wrbuffer_s *wrb)
+{
+  uint32_t endseq = TCP_WBSEQNO(wrb) + TCP_WBPKTLEN(wrb);
+  clock_t rtt = clock_systime_ticks() - wrb->wb_xmit;
+  bool first = conn->rack_endseq == 0;
+
+  /* An ACK sooner than the minimum RTT after a retransmission is likely
+   * for the original transmission and says nothing about the path.
+   */
+
+  if (TCP_WBNRTX(wrb) > 0 && !first && rtt < conn->rack_minrtt)
+    {
+      return;
+    }
+
+  if (TCP_WBNRTX(wrb) == 0 && (first || rtt < conn->rack_minrtt))
+    {
+      conn->rack_minrtt = rtt;
+    }
+
+  /* Remember the most recently sent data that was delivered, the write
+   * buffers sent within the same tick are ordered by sequence number.
+   */
+
+  if (first || (sclock_t)(wrb->wb_xmit - conn->rack_xmit) > 0 ||
+      (wrb->wb_xmit == conn->rack_xmit &&
+       TCP_SEQ_GT(endseq, conn->rack_endseq)))
+    {
+      conn->rack_xmit   = wrb->wb_xmit;
+      conn->rack_endseq = endseq;
+      conn->rack_rtt    = rtt;
+    }
+}
+
+/****************************************************************************
+ * Name: rack_sacked
+ *
+ * Description:
+ *   Mark the write buffers in the unacked_q that the SACK blocks cover
+ *   completely.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   segs   - The SACK blocks
+ *   nsacks - The number of SACK blocks
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void rack_sacked(FAR struct tcp_conn_s *conn,
+                        FAR struct tcp_ofoseg_s *segs, int nsacks)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  int i;
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)entry;
+      if (wrb->wb_sacked)
+        {
+          continue;
+        }
+
+      for (i = 0; i < nsacks; i++)
+        {
+          if (TCP_SEQ_GTE(TCP_WBSEQNO(wrb), segs[i].left) &&
+              TCP_SEQ_LTE(TCP_WBSEQNO(wrb) + TCP_WBPKTLEN(wrb),
+                          segs[i].right))
+            {
+              wrb->wb_sacked = true;
+              rack_delivered(conn, wrb);
+              break;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: rack_detect_loss
+ *
+ * Description:
+ *   Retransmit the write buffers that were sent before the most recently
+ *   delivered data and that are outstanding for longer than its round trip
+ *   time plus the reordering window of a quarter of the minimum RTT
+ *   (RFC8985 6.2 step 5).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   The number of write buffers that were deemed lost.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int rack_detect_loss(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  FAR sq_entry_t *next;
+  clock_t now = clock_systime_ticks();
+  clock_t reo_wnd = conn->rack_minrtt / 4;
+  int nlost = 0;
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = next)
+    {
+      wrb  = (FAR struct tcp_wrbuffer_s *)entry;
+      next = sq_next(entry);
+
+      if (wrb->wb_sacked)
+        {
+          continue;
+        }
+
+      if ((sclock_t)(conn->rack_xmit - wrb->wb_xmit) < 0 ||
+          (conn->rack_xmit == wrb->wb_xmit &&
+           TCP_SEQ_LTE(conn->rack_endseq,
+                       TCP_WBSEQNO(wrb) + TCP_WBPKTLEN(wrb))))
+        {
+          /* Sent after the delivered data, it may still be on its way */
+
+          continue;
+        }
+
+      if (now - wrb->wb_xmit < conn->rack_rtt + reo_wnd)
+        {
+          /* Possibly reordered, look again on the next ACK */
+
+          continue;
+        }
+
+      ninfo("RACK REXMIT [%" PRIu32 " : %u]\n",
+            TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb));
+
+      sq_rem(entry, &conn->unacked_q);
+      retransmit_segment(conn, wrb);
+      nlost++;
+    }
+
+  return nlost;
+}
+#endif /* CONFIG_NET_TCP_RACK */
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -543,6 +712,13 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                 {
                   ninfo("ACK: wrb=%p Freeing write buffer\n", wrb);
 
+#ifdef CONFIG_NET_TCP_RACK
+                  if (!wrb->wb_sacked)
+                    {
+                      rack_delivered(conn, wrb);
+                    }
+#endif
+
                   /* Yes... Remove the write buffer from ACK waiting queue */
 
                   sq_rem(entry, &conn->unacked_q);
@@ -618,11 +794,13 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                   if ((conn->flags & TCP_SACK) &&
                       (tcp->tcpoffset & 0xf0) > 0x50)
                     {
+#ifndef CONFIG_NET_TCP_RACK
                       /* Parse s-ack from tcp options */
 
                       nsacks = parse_sack(conn, tcp, ofosegs);
 
                       flags |= TCP_REXMIT;
+#endif
                     }
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
                   else
@@ -681,6 +859,16 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           ninfo("ACK: wrb=%p seqno=%" PRIu32 " pktlen=%u sent=%u\n",
                 wrb, TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb));
         }
+
+#ifdef CONFIG_NET_TCP_RACK
+      /* Every ACK that carries SACK blocks may reveal a loss */
+
+      if ((conn->flags & TCP_SACK) && (tcp->tcpoffset & 0xf0) > 0x50)
+        {
+          nsacks = parse_sack(conn, tcp, ofosegs);
+          rack_sacked(conn, ofosegs, nsacks);
+        }
+#endif
     }
 
   /* Check for a loss of connection */
@@ -806,6 +994,25 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
   /* Check if we are being asked to retransmit s-ack data */
 
+#ifdef CONFIG_NET_TCP_RACK
+  if (nsacks > 0)
+    {
+      if (rack_detect_loss(conn) > 0)
+        {
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+          if (conn->flags & TCP_INFT)
+            {
+              tcp_cc_update(conn, NULL);
+            }
+#endif
+
+          /* Reset the retransmission timer. */
+
+          tcp_update_retrantimer(conn, conn->rto);
+        }
+    }
+  else
+#else
   if (nsacks > 0)
     {
       FAR struct tcp_wrbuffer_s *wrb;
@@ -864,6 +1071,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 #endif
     }
   else
+#endif
 #endif
 
   /* Check if we are being asked to retransmit data */
@@ -1141,6 +1349,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           /* Increment the count of bytes sent from this write buffer */
 
           TCP_WBSENT(wrb) += sndlen;
+#ifdef CONFIG_NET_TCP_RACK
+          wrb->wb_xmit = clock_systime_ticks();
+#endif
 
           ninfo("SEND: wrb=%p sent=%u pktlen=%u\n",
                 wrb, TCP_WBSENT(wrb), TCP_WBPKTLEN(wrb));
@@ -1315,6 +1526,9 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 {
   FAR struct tcp_conn_s *conn;
   FAR struct tcp_wrbuffer_s *wrb;
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  FAR struct tcp_zerocopy_s *zc = NULL;
+#endif
   FAR const uint8_t *cp;
   unsigned int timeout;
   ssize_t    result = 0;
@@ -1379,6 +1593,23 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
   BUF_DUMP("psock_tcp_send", buf, len);
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* MSG_ZEROCOPY is ignored unless SO_ZEROCOPY was enabled, as on Linux */
+
+  if ((flags & MSG_ZEROCOPY) != 0 && conn->zerocopy && len > 0)
+    {
+      net_lock();
+      zc = tcp_zerocopy_alloc(conn, buf, len);
+      net_unlock();
+
+      if (zc == NULL)
+        {
+          ret = -ENOBUFS;
+          goto errout;
+        }
+    }
+#endif
+
   cp = buf;
   while (len > 0)
     {
@@ -1467,6 +1698,9 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
       while (true)
         {
           struct iob_s *iob;
+#ifdef CONFIG_NET_CONN_LOCK
+          bool coalesce = false;
+#endif
 
           /* Allocate a write buffer.  Careful, the network will be
            * momentarily unlocked here.
@@ -1485,6 +1719,16 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
           max_wrb_size = tcp_max_wrb_size(conn);
           wrb = (FAR struct tcp_wrbuffer_s *)sq_tail(&conn->write_q);
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+          /* Referenced user data and copied data never share a wrb */
+
+          if (wrb != NULL && (zc != NULL || TCP_WBZEROCOPY(wrb)))
+            {
+              wrb = NULL;
+            }
+#endif
+
           if (wrb != NULL && TCP_WBSENT(wrb) == 0 && TCP_WBNRTX(wrb) == 0 &&
               TCP_WBPKTLEN(wrb) < max_wrb_size &&
               (TCP_WBPKTLEN(wrb) % conn->mss) != 0)
@@ -1493,6 +1737,9 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
               ninfo("coalesce %zu bytes to wrb %p (%" PRIu16 ")\n", len, wrb,
                     TCP_WBPKTLEN(wrb));
               DEBUGASSERT(TCP_WBPKTLEN(wrb) > 0);
+#ifdef CONFIG_NET_CONN_LOCK
+              coalesce = true;
+#endif
             }
           else if (nonblock)
             {
@@ -1547,7 +1794,43 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
            * remaining data.
            */
 
-          chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+          if (zc != NULL)
+            {
+              /* Reference the user data in the new write buffer instead of
+               * copying it.
+               */
+
+              chunk_result = tcp_zerocopy_wrbuffer(zc, wrb, cp, chunk_len);
+            }
+          else
+#endif
+#ifdef CONFIG_NET_CONN_LOCK
+          if (!coalesce)
+            {
+              /* A new write buffer is private to this thread until it is
+               * queued, so copy the user data without blocking the rest of
+               * the network.  The connection may go away meanwhile.
+               */
+
+              net_unlock();
+              chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+              net_lock();
+
+              if (!_SS_ISCONNECTED(conn->sconn.s_flags))
+                {
+                  nerr("ERROR: No longer connected\n");
+                  tcp_wrbuffer_release(wrb);
+                  ret = -ENOTCONN;
+                  goto errout_with_lock;
+                }
+            }
+          else
+#endif
+            {
+              chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+            }
+
           if (chunk_result == -ENOMEM)
             {
               if (TCP_WBPKTLEN(wrb) > 0)
@@ -1662,6 +1945,15 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
       result += chunk_result;
     }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  if (zc != NULL)
+    {
+      net_lock();
+      tcp_zerocopy_release(zc);
+      net_unlock();
+    }
+#endif
+
   /* Check for errors.  Errors are signaled by negative errno values
    * for the send length
    */
@@ -1677,6 +1969,13 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   return result;
 
 errout_with_lock:
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  if (zc != NULL)
+    {
+      tcp_zerocopy_release(zc);
+    }
+#endif
+
   net_unlock();
 
 errout:
@@ -42,9 +42,13 @@
 #include <debug.h>
 
 #include <arch/irq.h>
+#include <nuttx/queue.h>
 #include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/tcp.h>
@@ -90,12 +94,136 @@ struct sendfile_s
 #endif
   int                snd_dup_acks;         /* Duplicate ACK counter */
 #endif
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  dq_entry_t         snd_node;             /* Entry in g_sendfile_xip */
+  FAR const uint8_t *snd_xip;              /* Memory of the input file */
+  size_t             snd_xiplen;           /* Size of the input file */
+  unsigned int       snd_nrefs;            /* I/O buffers referencing it */
+  sem_t              snd_xipsem;           /* Wakes up when they are freed */
+#endif
 };
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+/* The sendfile() calls that reference file memory.  The free callback of
+ * an I/O buffer only gets the data pointer, so the call is looked up by
+ * the address of the data.  The callback may run in interrupt context.
+ */
+
+static dq_queue_t g_sendfile_xip;
+static spinlock_t g_sendfile_lock = SP_UNLOCKED;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sendfile_iob_free
+ *
+ * Description:
+ *   The free callback of the I/O buffers that reference file memory.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+static void sendfile_iob_free(FAR void *data)
+{
+  FAR const uint8_t *ptr = data;
+  FAR dq_entry_t *entry;
+  irqstate_t flags;
+
+  /* Concurrent calls that send the same file share the memory, it does not
+   * matter which one the reference is returned to.  The memory stays valid
+   * as long as any of them waits.
+   */
+
+  flags = spin_lock_irqsave(&g_sendfile_lock);
+  for (entry = dq_peek(&g_sendfile_xip); entry != NULL;
+       entry = dq_next(entry))
+    {
+      FAR struct sendfile_s *pstate =
+        container_of(entry, struct sendfile_s, snd_node);
+
+      if (pstate->snd_nrefs > 0 && ptr >= pstate->snd_xip &&
+          ptr < pstate->snd_xip + pstate->snd_xiplen)
+        {
+          if (--pstate->snd_nrefs == 0)
+            {
+              nxsem_post(&pstate->snd_xipsem);
+            }
+
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_sendfile_lock, flags);
+  DEBUGASSERT(entry != NULL);
+}
+#endif
+
+/****************************************************************************
+ * Name: sendfile_send
+ *
+ * Description:
+ *   Set up 'len' bytes of the file at 'offset' relative to the start of
+ *   the transfer for sending.  If the file can be mapped, these are
+ *   referenced by an I/O buffer instead of being read.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static int sendfile_send(FAR struct net_driver_s *dev,
+                         FAR struct sendfile_s *pstate,
+                         unsigned int len, uint32_t offset)
+{
+  FAR struct tcp_conn_s *conn = pstate->snd_conn;
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  if (pstate->snd_xip != NULL)
+    {
+      FAR struct iob_s *iob;
+      irqstate_t flags;
+
+      iob = iob_alloc_with_data((FAR void *)(pstate->snd_xip +
+                                             pstate->snd_foffset + offset),
+                                len, sendfile_iob_free);
+      if (iob != NULL)
+        {
+          flags = spin_lock_irqsave(&g_sendfile_lock);
+          pstate->snd_nrefs++;
+          spin_unlock_irqrestore(&g_sendfile_lock, flags);
+
+          if (netdev_iob_prepare(dev, false, 0) != OK)
+            {
+              iob_free(iob);
+              return -ENOMEM;
+            }
+
+          iob->io_len    = len;
+          iob->io_pktlen = len;
+
+          iob_update_pktlen(dev->d_iob, tcpip_hdrsize(conn), false);
+          iob_concat(dev->d_iob, iob);
+
+          dev->d_sndlen = len;
+          return len;
+        }
+
+      /* Out of I/O buffer headers, read the data instead */
+    }
+#endif
+
+  return devif_file_send(dev, pstate->snd_file, len,
+                         pstate->snd_foffset + offset,
+                         tcpip_hdrsize(conn));
+}
+
 /****************************************************************************
  * Name: sendfile_eventhandler
  *
@@ -269,9 +397,7 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
        * happen until the polling cycle completes).
        */
 
-      ret = devif_file_send(dev, pstate->snd_file, sndlen,
-                            pstate->snd_foffset + pstate->snd_acked,
-                            tcpip_hdrsize(conn));
+      ret = sendfile_send(dev, pstate, sndlen, pstate->snd_acked);
       if (ret < 0)
         {
           nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
@@ -340,9 +466,7 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          ret = devif_file_send(dev, pstate->snd_file, sndlen,
-                                pstate->snd_foffset + pstate->snd_sent,
-                                tcpip_hdrsize(conn));
+          ret = sendfile_send(dev, pstate, sndlen, pstate->snd_sent);
           if (ret < 0)
             {
               nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
@@ -419,6 +543,11 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   FAR struct tcp_conn_s *conn;
   struct sendfile_s state;
   off_t startpos;
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  uintptr_t xipbase = 0;
+  struct stat buf;
+  irqstate_t flags;
+#endif
   int ret = OK;
 
   conn = psock->s_conn;
@@ -470,6 +599,19 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
       return startpos;
     }
 
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  /* Files in memory, like on romfs in XIP flash or on tmpfs, are sent
+   * from where they are, if the range to send lies within the file.
+   */
+
+  if (file_ioctl(infile, FIOC_XIPBASE, (unsigned long)&xipbase) < 0 ||
+      file_fstat(infile, &buf) < 0 ||
+      (offset ? *offset : startpos) + count > buf.st_size)
+    {
+      xipbase = 0;
+    }
+#endif
+
   /* Initialize the state structure.  This is done with the network
    * locked because we don't want anything to happen until we are
    * ready.
@@ -487,6 +629,19 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   state.snd_flen    = count;                       /* Number of bytes to send */
   state.snd_file    = infile;                      /* File to read from */
 
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  if (xipbase != 0)
+    {
+      state.snd_xip    = (FAR const uint8_t *)xipbase;
+      state.snd_xiplen = buf.st_size;
+      nxsem_init(&state.snd_xipsem, 0, 0);
+
+      flags = spin_lock_irqsave(&g_sendfile_lock);
+      dq_addlast(&state.snd_node, &g_sendfile_xip);
+      spin_unlock_irqrestore(&g_sendfile_lock, flags);
+    }
+#endif
+
   /* Allocate resources to receive a callback */
 
   state.snd_cb = tcp_callback_alloc(conn);
@@ -539,6 +694,27 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   tcp_callback_free(conn, state.snd_cb);
 
 errout_locked:
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  if (state.snd_xip != NULL)
+    {
+      /* The file may be closed or changed once sendfile() returns, so wait
+       * until the network device released the file memory.
+       */
+
+      flags = spin_lock_irqsave(&g_sendfile_lock);
+      while (state.snd_nrefs > 0)
+        {
+          spin_unlock_irqrestore(&g_sendfile_lock, flags);
+          net_sem_wait_uninterruptible(&state.snd_xipsem);
+          flags = spin_lock_irqsave(&g_sendfile_lock);
+        }
+
+      dq_rem(&state.snd_node, &g_sendfile_xip);
+      spin_unlock_irqrestore(&g_sendfile_lock, flags);
+      nxsem_destroy(&state.snd_xipsem);
+    }
+#endif
+
   nxsem_destroy(&state.snd_sem);
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   conn->sendfile = false;
@@ -547,6 +723,25 @@ errout_locked:
 
   /* Return the current file position */
 
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  if (state.snd_xip != NULL)
+    {
+      /* The file was not read, so its position is where the data ends */
+
+      off_t curpos = state.snd_foffset +
+                     (state.snd_sent > 0 ? state.snd_sent : 0);
+
+      if (offset)
+        {
+          *offset = curpos;
+        }
+      else
+        {
+          file_seek(infile, curpos, SEEK_SET);
+        }
+    }
+  else
+#endif
   if (offset)
     {
       /* Use lseek to get the current file position */
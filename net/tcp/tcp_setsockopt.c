@@ -26,8 +26,10 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/time.h>
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -260,6 +262,28 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        {
+          char name[TCP_CA_NAME_MAX];
+
+          if (value_len == 0)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          value_len = MIN(value_len, TCP_CA_NAME_MAX - 1);
+          memcpy(name, value, value_len);
+          name[value_len] = '\0';
+
+          net_lock();
+          ret = tcp_cc_select(conn, name);
+          net_unlock();
+        }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
@@ -540,6 +540,14 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 #else
                   listener = tcp_findlistener(&conn->u, conn->lport);
 #endif
+#ifdef CONFIG_NET_REUSEPORT
+                  if (listener != NULL)
+                    {
+                      listener = tcp_reuseport(listener, &conn->u,
+                                               conn->rport);
+                    }
+#endif
+
                   if (listener != NULL)
                     {
                       /* We call tcp_callback() for the connection with
@@ -652,22 +660,9 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                     tcp_rexmit(dev, conn, result);
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
-                    /* If conn is TCP_INFR, it should enter to slow start */
-
-                    if (conn->flags & TCP_INFR)
-                      {
-                        conn->flags &= ~TCP_INFR;
-                      }
-
-                    /* update the max_cwnd */
-
-                    conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
-
-                    /* reset cwnd and ssthresh, refers to RFC5861. */
+                    /* Reduce the congestion window, refers to RFC5861. */
 
-                    conn->ssthresh =
-                                    MAX(conn->tx_unacked / 2, 2 * conn->mss);
-                    conn->cwnd = conn->mss;
+                    tcp_cc_timeout(conn);
 #endif
                     goto done;
 
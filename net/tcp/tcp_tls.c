@@ -0,0 +1,494 @@
+/****************************************************************************
+ * net/tcp/tcp_tls.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Kernel TLS transmission: once the keys of a TLS 1.2 session are installed
+ * with the SOL_TLS/TLS_TX socket option, the data sent on the socket is
+ * framed into application data records and sealed with AES-GCM or
+ * ChaCha20-Poly1305 by the crypto framework.  Each record is encrypted in
+ * place in a buffer of the connection and then queued like the data of any
+ * other send.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netinet/tls.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/net/net.h>
+
+#include <crypto/cryptodev.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_TLS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TLS_HEADER_SIZE       5    /* Content type, version and length */
+#define TLS_AAD_SIZE          13   /* Sequence number and header */
+#define TLS_TAG_SIZE          16   /* Authentication tag of both ciphers */
+#define TLS_NONCE_MAX         8    /* Explicit nonce of AES-GCM */
+#define TLS_SALT_SIZE         4    /* Implicit part of the nonce */
+#define TLS_KEY_MAX           (32 + TLS_SALT_SIZE)
+
+#define TLS_APPLICATION_DATA  23
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The kernel TLS state of a TCP connection */
+
+struct tcp_tls_s
+{
+  mutex_t  lock;                    /* Serializes the senders */
+  uint64_t sid;                     /* The crypto session */
+  int      cipher;                  /* The crypto algorithm */
+  int      mac;                     /* The authentication algorithm */
+  uint8_t  klen;                    /* Key length including the salt */
+  uint8_t  nlen;                    /* Length of the explicit nonce */
+  uint8_t  key[TLS_KEY_MAX];        /* Key followed by the salt */
+  uint8_t  iv[TLS_NONCE_MAX];       /* Per record part of the nonce */
+  uint8_t  seq[8];                  /* Sequence number of the next record */
+  size_t   off;                     /* Sent bytes of the current record */
+  size_t   len;                     /* Length of the current record */
+  uint8_t  rec[TLS_HEADER_SIZE + TLS_NONCE_MAX +
+               CONFIG_NET_TCP_TLS_RECORD_SIZE + TLS_TAG_SIZE];
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_tls_increment
+ *
+ * Description:
+ *   Increment a big endian 64 bit counter.
+ *
+ ****************************************************************************/
+
+static void tcp_tls_increment(FAR uint8_t *counter)
+{
+  int i;
+
+  for (i = 7; i >= 0 && ++counter[i] == 0; i--)
+    {
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_tls_seal
+ *
+ * Description:
+ *   Frame 'len' bytes of user data into the next record and encrypt it in
+ *   place.
+ *
+ ****************************************************************************/
+
+static int tcp_tls_seal(FAR struct tcp_tls_s *tls, FAR const void *buf,
+                        size_t len)
+{
+  FAR struct cryptodesc *crde;
+  FAR struct cryptodesc *crda;
+  FAR struct cryptop *crp;
+  FAR uint8_t *data;
+  uint8_t aad[TLS_AAD_SIZE];
+  uint8_t iv[TLS_NONCE_MAX];
+  size_t reclen;
+  int retry;
+  int ret;
+  int i;
+
+  data   = tls->rec + TLS_HEADER_SIZE + tls->nlen;
+  reclen = tls->nlen + len + TLS_TAG_SIZE;
+  memcpy(data, buf, len);
+
+  tls->rec[0] = TLS_APPLICATION_DATA;
+  tls->rec[1] = TLS_1_2_VERSION >> 8;
+  tls->rec[2] = TLS_1_2_VERSION & 0xff;
+  tls->rec[3] = reclen >> 8;
+  tls->rec[4] = reclen & 0xff;
+
+  /* The additional data is the sequence number and the header with the
+   * length of the plain text.
+   */
+
+  memcpy(aad, tls->seq, sizeof(tls->seq));
+  memcpy(aad + sizeof(tls->seq), tls->rec, 3);
+  aad[11] = len >> 8;
+  aad[12] = len & 0xff;
+
+  /* AES-GCM sends the per record part of the nonce with the record, the
+   * one of ChaCha20-Poly1305 is the sequence number mixed into the IV.
+   */
+
+  if (tls->nlen > 0)
+    {
+      memcpy(iv, tls->iv, sizeof(iv));
+      memcpy(tls->rec + TLS_HEADER_SIZE, iv, tls->nlen);
+    }
+  else
+    {
+      for (i = 0; i < sizeof(iv); i++)
+        {
+          iv[i] = tls->iv[i] ^ tls->seq[i];
+        }
+    }
+
+  crp = crypto_getreq(2);
+  if (crp == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  crda = crp->crp_desc;
+  crde = crda->crd_next;
+
+  crda->crd_alg    = tls->mac;
+  crda->crd_key    = (caddr_t)tls->key;
+  crda->crd_klen   = tls->klen * 8;
+  crda->crd_len    = TLS_AAD_SIZE;
+
+  crde->crd_alg    = tls->cipher;
+  crde->crd_key    = (caddr_t)tls->key;
+  crde->crd_klen   = tls->klen * 8;
+  crde->crd_len    = len;
+  crde->crd_flags  = CRD_F_ENCRYPT | CRD_F_IV_EXPLICIT | CRD_F_IV_PRESENT;
+  memcpy(crde->crd_iv, iv, sizeof(iv));
+
+  crp->crp_ilen    = len;
+  crp->crp_buf     = data;
+  crp->crp_dst     = (caddr_t)data;
+  crp->crp_aad     = (caddr_t)aad;
+  crp->crp_aadlen  = TLS_AAD_SIZE;
+  crp->crp_mac     = (caddr_t)data + len;
+
+  /* A request on a session whose driver went away migrates the session and
+   * fails with -EAGAIN, it is run once more on the new session.
+   */
+
+  for (retry = 0; retry < 2; retry++)
+    {
+      crp->crp_sid   = tls->sid;
+      crp->crp_etype = 0;
+      ret = crypto_invoke(crp);
+      tls->sid = crp->crp_sid;
+      if (ret == 0)
+        {
+          ret = crp->crp_etype;
+        }
+
+      if (ret != -EAGAIN)
+        {
+          break;
+        }
+    }
+
+  crypto_freereq(crp);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to seal the record: %d\n", ret);
+      return ret;
+    }
+
+  tcp_tls_increment(tls->seq);
+  if (tls->nlen > 0)
+    {
+      tcp_tls_increment(tls->iv);
+    }
+
+  tls->off = 0;
+  tls->len = TLS_HEADER_SIZE + reclen;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tcp_tls_flush
+ *
+ * Description:
+ *   Send the rest of the current record.
+ *
+ ****************************************************************************/
+
+static ssize_t tcp_tls_flush(FAR struct socket *psock,
+                             FAR struct tcp_tls_s *tls, int flags)
+{
+  ssize_t ret;
+
+  /* The record buffer is reused, never reference it from the I/O buffers */
+
+  flags &= ~MSG_ZEROCOPY;
+  while (tls->off < tls->len)
+    {
+      ret = psock_tcp_send(psock, tls->rec + tls->off,
+                           tls->len - tls->off, flags);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      tls->off += ret;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_tls_setsockopt
+ *
+ * Description:
+ *   Install the transmit keys of a TLS session on a TCP socket.
+ *
+ * Input Parameters:
+ *   psock     - The TCP socket
+ *   option    - TLS_TX
+ *   value     - A struct tls12_crypto_info_* of the cipher
+ *   value_len - The size of the structure
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int tcp_tls_setsockopt(FAR struct socket *psock, int option,
+                       FAR const void *value, socklen_t value_len)
+{
+  FAR const struct tls12_crypto_info_aes_gcm_128 *gcm = value;
+  FAR const struct tls12_crypto_info_chacha20_poly1305 *chacha = value;
+  FAR const struct tls_crypto_info *info = value;
+  FAR struct tcp_conn_s *conn = psock->s_conn;
+  FAR struct tcp_tls_s *tls;
+  struct cryptoini crie;
+  struct cryptoini cria;
+  int ret;
+
+  if (option != TLS_TX)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  if (value == NULL || value_len < sizeof(*info))
+    {
+      return -EINVAL;
+    }
+
+  if (info->version != TLS_1_2_VERSION)
+    {
+      return -EINVAL;
+    }
+
+  if (conn->tls != NULL)
+    {
+      return -EBUSY;
+    }
+
+  tls = kmm_zalloc(sizeof(*tls));
+  if (tls == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  switch (info->cipher_type)
+    {
+      case TLS_CIPHER_AES_GCM_128:
+        if (value_len < sizeof(*gcm))
+          {
+            ret = -EINVAL;
+            goto errout;
+          }
+
+        tls->cipher = CRYPTO_AES_GCM_16;
+        tls->mac    = CRYPTO_AES_128_GMAC;
+        tls->klen   = sizeof(gcm->key) + TLS_SALT_SIZE;
+        tls->nlen   = sizeof(gcm->iv);
+        memcpy(tls->key, gcm->key, sizeof(gcm->key));
+        memcpy(tls->key + sizeof(gcm->key), gcm->salt, TLS_SALT_SIZE);
+        memcpy(tls->iv, gcm->iv, sizeof(gcm->iv));
+        memcpy(tls->seq, gcm->rec_seq, sizeof(tls->seq));
+        break;
+
+      case TLS_CIPHER_CHACHA20_POLY1305:
+        if (value_len < sizeof(*chacha))
+          {
+            ret = -EINVAL;
+            goto errout;
+          }
+
+        /* The first bytes of the IV are the salt of the nonce */
+
+        tls->cipher = CRYPTO_CHACHA20_POLY1305;
+        tls->mac    = CRYPTO_CHACHA20_POLY1305_MAC;
+        tls->klen   = sizeof(chacha->key) + TLS_SALT_SIZE;
+        tls->nlen   = 0;
+        memcpy(tls->key, chacha->key, sizeof(chacha->key));
+        memcpy(tls->key + sizeof(chacha->key), chacha->iv, TLS_SALT_SIZE);
+        memcpy(tls->iv, chacha->iv + TLS_SALT_SIZE, sizeof(tls->iv));
+        memcpy(tls->seq, chacha->rec_seq, sizeof(tls->seq));
+        break;
+
+      default:
+        ret = -EINVAL;
+        goto errout;
+    }
+
+  /* Prefer a hardware driver of the ciphers */
+
+  memset(&crie, 0, sizeof(crie));
+  memset(&cria, 0, sizeof(cria));
+
+  crie.cri_alg  = tls->cipher;
+  crie.cri_klen = tls->klen * 8;
+  crie.cri_key  = (caddr_t)tls->key;
+  crie.cri_next = &cria;
+
+  cria.cri_alg  = tls->mac;
+  cria.cri_sid  = -1;
+  cria.cri_klen = tls->klen * 8;
+  cria.cri_key  = (caddr_t)tls->key;
+
+  ret = crypto_newsession(&tls->sid, &crie, 0);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  nxmutex_init(&tls->lock);
+
+  net_lock();
+  if (conn->tls != NULL)
+    {
+      net_unlock();
+      crypto_freesession(tls->sid);
+      nxmutex_destroy(&tls->lock);
+      ret = -EBUSY;
+      goto errout;
+    }
+
+  conn->tls = tls;
+  net_unlock();
+  return OK;
+
+errout:
+  memset(tls->key, 0, sizeof(tls->key));
+  kmm_free(tls);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: tcp_tls_send
+ *
+ * Description:
+ *   Send user data on a socket with kernel TLS transmission, in records of
+ *   up to CONFIG_NET_TCP_TLS_RECORD_SIZE bytes.  The data of a record
+ *   counts as sent once the record is sealed, a record that was sent only
+ *   in part by a non-blocking send is completed by the next send.
+ *
+ * Input Parameters:
+ *   psock - The TCP socket
+ *   buf   - The user data
+ *   len   - The length of the user data
+ *   flags - The send flags
+ *
+ * Returned Value:
+ *   The number of user bytes sent; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t tcp_tls_send(FAR struct socket *psock, FAR const void *buf,
+                     size_t len, int flags)
+{
+  FAR struct tcp_conn_s *conn = psock->s_conn;
+  FAR struct tcp_tls_s *tls = conn->tls;
+  size_t sent = 0;
+  size_t n;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&tls->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = tcp_tls_flush(psock, tls, flags);
+  while (ret >= 0 && sent < len)
+    {
+      n   = MIN(len - sent, CONFIG_NET_TCP_TLS_RECORD_SIZE);
+      ret = tcp_tls_seal(tls, (FAR const uint8_t *)buf + sent, n);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      sent += n;
+      ret = tcp_tls_flush(psock, tls, flags);
+    }
+
+  nxmutex_unlock(&tls->lock);
+  return sent > 0 ? sent : ret;
+}
+
+/****************************************************************************
+ * Name: tcp_tls_free
+ *
+ * Description:
+ *   Release the kernel TLS state of a connection.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ ****************************************************************************/
+
+void tcp_tls_free(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_tls_s *tls = conn->tls;
+
+  if (tls != NULL)
+    {
+      conn->tls = NULL;
+      crypto_freesession(tls->sid);
+      nxmutex_destroy(&tls->lock);
+      memset(tls->key, 0, sizeof(tls->key));
+      kmm_free(tls);
+    }
+}
+
+#endif /* CONFIG_NET_TCP_TLS */
@@ -0,0 +1,402 @@
+/****************************************************************************
+ * net/tcp/tcp_zerocopy.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <poll.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/queue.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "utils/utils.h"
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest user data one I/O buffer can reference */
+
+#define TCP_ZEROCOPY_IOBSIZE UINT16_MAX
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One MSG_ZEROCOPY send in progress */
+
+struct tcp_zerocopy_s
+{
+  dq_entry_t node;                /* Entry in g_tcp_zerocopy */
+  FAR struct tcp_conn_s *conn;    /* The connection that sends the data */
+  FAR const uint8_t *base;        /* The user data */
+  size_t len;                     /* The length of the user data */
+  uint32_t id;                    /* Number of the zero-copy send */
+  unsigned int nrefs;             /* The I/O buffers and the sender */
+  bool queued;                    /* Some data was queued for sending */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The zero-copy sends in progress, oldest first.  The free callback of an
+ * I/O buffer only gets the data pointer, so the send is looked up by the
+ * address of the data.
+ */
+
+static dq_queue_t g_tcp_zerocopy;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_zerocopy_complete
+ *
+ * Description:
+ *   Add a finished send to the completions of its connection and wake up
+ *   the threads that poll the connection.
+ *
+ ****************************************************************************/
+
+static void tcp_zerocopy_complete(FAR struct tcp_zerocopy_s *zc)
+{
+  FAR struct tcp_conn_s *conn = zc->conn;
+  int i;
+
+  dq_rem(&zc->node, &g_tcp_zerocopy);
+
+  /* A send that did not queue anything gives its number back, like on
+   * Linux, unless another send took the next number meanwhile.
+   */
+
+  if (!zc->queued && zc->id == conn->zc_next - 1)
+    {
+      conn->zc_next--;
+      kmm_free(zc);
+      return;
+    }
+
+  /* The data is acknowledged in order so the completions are usually
+   * consecutive.  Otherwise the range is widened to cover them all.
+   */
+
+  if (!conn->zc_ready)
+    {
+      conn->zc_lo    = zc->id;
+      conn->zc_hi    = zc->id;
+      conn->zc_ready = true;
+    }
+  else if ((int32_t)(zc->id - conn->zc_hi) > 0)
+    {
+      conn->zc_hi = zc->id;
+    }
+  else if ((int32_t)(zc->id - conn->zc_lo) < 0)
+    {
+      conn->zc_lo = zc->id;
+    }
+
+  kmm_free(zc);
+
+  for (i = 0; i < CONFIG_NET_TCP_NPOLLWAITERS; i++)
+    {
+      FAR struct tcp_poll_s *info = &conn->pollinfo[i];
+
+      if (info->conn != NULL)
+        {
+          poll_notify(&info->fds, 1, POLLERR);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_free
+ *
+ * Description:
+ *   The free callback of the I/O buffers that reference user data.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_zerocopy_free(FAR void *data)
+{
+  FAR const uint8_t *ptr = data;
+  FAR dq_entry_t *entry;
+
+  /* If the same data is sent twice, the older send takes the reference.
+   * The last of them still completes only when the data is no longer used.
+   */
+
+  for (entry = dq_peek(&g_tcp_zerocopy); entry != NULL;
+       entry = dq_next(entry))
+    {
+      FAR struct tcp_zerocopy_s *zc = (FAR struct tcp_zerocopy_s *)entry;
+
+      if (ptr >= zc->base && ptr < zc->base + zc->len)
+        {
+          if (--zc->nrefs == 0)
+            {
+              tcp_zerocopy_complete(zc);
+            }
+
+          return;
+        }
+    }
+
+  DEBUGPANIC();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_zerocopy_alloc
+ *
+ * Description:
+ *   Start a MSG_ZEROCOPY send of the user data 'buf' and assign it the next
+ *   zero-copy send number of the connection.  The caller holds a reference
+ *   that is dropped with tcp_zerocopy_release() when the send returns.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *   buf  - The user data to send
+ *   len  - The length of the user data
+ *
+ * Returned Value:
+ *   The zero-copy send or NULL if out of memory.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_zerocopy_s *tcp_zerocopy_alloc(FAR struct tcp_conn_s *conn,
+                                              FAR const void *buf,
+                                              size_t len)
+{
+  FAR struct tcp_zerocopy_s *zc;
+
+  zc = kmm_malloc(sizeof(struct tcp_zerocopy_s));
+  if (zc == NULL)
+    {
+      nerr("ERROR: Failed to allocate zero-copy send\n");
+      return NULL;
+    }
+
+  zc->conn   = conn;
+  zc->base   = buf;
+  zc->len    = len;
+  zc->id     = conn->zc_next++;
+  zc->nrefs  = 1;
+  zc->queued = false;
+
+  dq_addlast(&zc->node, &g_tcp_zerocopy);
+  return zc;
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_release
+ *
+ * Description:
+ *   Drop the reference of the caller of tcp_zerocopy_alloc().  The send is
+ *   completed once the I/O buffers that reference its data are all freed.
+ *
+ * Input Parameters:
+ *   zc - The zero-copy send
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_zerocopy_release(FAR struct tcp_zerocopy_s *zc)
+{
+  DEBUGASSERT(zc != NULL && zc->nrefs > 0);
+
+  if (--zc->nrefs == 0)
+    {
+      tcp_zerocopy_complete(zc);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_wrbuffer
+ *
+ * Description:
+ *   Fill a new write buffer with I/O buffers that reference 'len' bytes of
+ *   the user data at 'buf' of a zero-copy send instead of copying them.
+ *
+ * Input Parameters:
+ *   zc  - The zero-copy send that 'buf' belongs to
+ *   wrb - The new, empty write buffer
+ *   buf - The user data
+ *   len - The length of the user data
+ *
+ * Returned Value:
+ *   'len' on success.  -ENOMEM if less than 'len' bytes could be
+ *   referenced, the length of the write buffer tells how much was.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_zerocopy_wrbuffer(FAR struct tcp_zerocopy_s *zc,
+                          FAR struct tcp_wrbuffer_s *wrb,
+                          FAR const uint8_t *buf, size_t len)
+{
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *iob;
+  size_t off = 0;
+
+  DEBUGASSERT(buf >= zc->base && buf + len <= zc->base + zc->len);
+  DEBUGASSERT(TCP_WBPKTLEN(wrb) == 0);
+
+  while (off < len)
+    {
+      uint16_t size = MIN(len - off, TCP_ZEROCOPY_IOBSIZE);
+
+      iob = iob_alloc_with_data((FAR void *)(buf + off), size,
+                                tcp_zerocopy_free);
+      if (iob == NULL)
+        {
+          break;
+        }
+
+      iob->io_len    = size;
+      iob->io_pktlen = size;
+      zc->nrefs++;
+
+      if (head == NULL)
+        {
+          head = iob;
+        }
+      else
+        {
+          iob_concat(head, iob);
+        }
+
+      off += size;
+    }
+
+  if (head == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Replace the empty I/O buffer the write buffer was allocated with */
+
+  iob_free_chain(wrb->wb_iob);
+  wrb->wb_iob      = head;
+  wrb->wb_zerocopy = true;
+  zc->queued       = true;
+
+  return off < len ? -ENOMEM : len;
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_recverr
+ *
+ * Description:
+ *   Implement recvmsg(MSG_ERRQUEUE), reporting the completed zero-copy
+ *   sends as a struct sock_extended_err control message.
+ *
+ * Input Parameters:
+ *   psock - The TCP socket of interest
+ *   msg   - Receives the control message
+ *
+ * Returned Value:
+ *   Zero on success, -EAGAIN if no completion is pending.
+ *
+ ****************************************************************************/
+
+ssize_t tcp_zerocopy_recverr(FAR struct socket *psock,
+                             FAR struct msghdr *msg)
+{
+  FAR struct tcp_conn_s *conn = psock->s_conn;
+  struct sock_extended_err ee;
+  int level = IPPROTO_IP;
+  int type = IP_RECVERR;
+
+  net_lock();
+
+  if (!conn->zc_ready)
+    {
+      net_unlock();
+      return -EAGAIN;
+    }
+
+  memset(&ee, 0, sizeof(ee));
+  ee.ee_origin = SO_EE_ORIGIN_ZEROCOPY;
+  ee.ee_info   = conn->zc_lo;
+  ee.ee_data   = conn->zc_hi;
+
+#ifdef CONFIG_NET_IPv6
+  if (psock->s_domain == PF_INET6)
+    {
+      level = IPPROTO_IPV6;
+      type  = IPV6_RECVERR;
+    }
+#endif
+
+  /* Keep the completions if they do not fit, as recvmsg() may be retried
+   * with a larger control buffer.
+   */
+
+  if (cmsg_append(msg, level, type, &ee, sizeof(ee)) == NULL)
+    {
+      msg->msg_flags |= MSG_CTRUNC;
+    }
+  else
+    {
+      msg->msg_flags |= MSG_ERRQUEUE;
+      conn->zc_ready  = false;
+    }
+
+  net_unlock();
+  return 0;
+}
+
+#endif /* CONFIG_NET_TCP_ZEROCOPY */
@@ -73,6 +73,10 @@
 
 #define _UDP_ISCONNECTMODE(f) (((f) & _UDP_FLAG_CONNECTMODE) != 0)
 
+/* The most datagrams one UDP_SEGMENT send or one UDP_GRO receive holds */
+
+#define UDP_MAX_SEGMENTS      64
+
 /* This is a helper pointer for accessing the contents of the udp header */
 
 #define UDPIPv4BUF ((FAR struct udp_hdr_s *)IPBUF(IPv4_HDRLEN))
@@ -162,6 +166,25 @@ struct udp_conn_s
 #ifdef CONFIG_NET_TIMESTAMP
   int timestamp; /* Nonzero when SO_TIMESTAMP is enabled */
 #endif
+
+#ifdef CONFIG_NET_UDP_GSO
+  uint16_t gso_size;      /* UDP_SEGMENT size, 0 if not segmented */
+#endif
+
+#ifdef CONFIG_NET_UDP_GRO
+  /* Receive coalescing, the last datagram in the read-ahead buffer may be
+   * extended while gro_len is not 0.
+   *
+   *   gro_len     - The length of the last datagram including its header
+   *   gro_segsize - The segment size of the last datagram
+   *   gro_segs    - The number of segments in the last datagram
+   */
+
+  bool     gro;           /* Nonzero when UDP_GRO is enabled */
+  uint8_t  gro_segs;
+  uint16_t gro_len;
+  uint16_t gro_segsize;
+#endif
 };
 
 /* This structure supports UDP write buffering.  It is simply a container
@@ -174,6 +197,9 @@ struct udp_wrbuffer_s
   sq_entry_t wb_node;              /* Supports a singly linked list */
   struct sockaddr_storage wb_dest; /* Destination address */
   FAR struct iob_s *wb_iob;        /* Head of the I/O buffer chain */
+#ifdef CONFIG_NET_CHKSUM_COPY
+  uint16_t wb_sum;                 /* Checksum of the buffered payload */
+#endif
 };
 #endif
 
@@ -234,6 +260,25 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain);
 
 void udp_free(FAR struct udp_conn_s *conn);
 
+/****************************************************************************
+ * Name: udp_demux_invalidate
+ *
+ * Description:
+ *   Invalidate the UDP connections cached in the network devices.  This
+ *   must be called whenever the addresses, the ports or the connection
+ *   mode of a UDP connection change or a connection is freed.
+ *
+ * Assumptions:
+ *   Called with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_DEMUX_CACHE
+void udp_demux_invalidate(void);
+#else
+#  define udp_demux_invalidate()
+#endif
+
 /****************************************************************************
  * Name: udp_active
  *
@@ -250,6 +295,24 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
                                   FAR struct udp_conn_s *conn,
                                   FAR struct udp_hdr_s *udp);
 
+/****************************************************************************
+ * Name: udp_reuseport
+ *
+ * Description:
+ *   Select the socket of the SO_REUSEPORT group of 'conn' that receives
+ *   the datagram in the provided UDP header
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+FAR struct udp_conn_s *udp_reuseport(FAR struct net_driver_s *dev,
+                                     FAR struct udp_conn_s *conn,
+                                     FAR struct udp_hdr_s *udp);
+#endif
+
 /****************************************************************************
  * Name: udp_nextconn
  *
@@ -478,6 +541,33 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn);
 #ifdef CONFIG_NET_UDPPROTO_OPTIONS
 int udp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len);
+
+/****************************************************************************
+ * Name: udp_getsockopt
+ *
+ * Description:
+ *   udp_getsockopt() retrieves the value of the UDP-protocol option
+ *   specified by the 'option' argument for the socket specified by the
+ *   'psock' argument.
+ *
+ *   See <netinet/udp.h> for the a complete list of values of UDP protocol
+ *   options.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of socket to operate on
+ *   option    identifies the option to get
+ *   value     Points to the argument value buffer
+ *   value_len The length of the argument value buffer
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.  See psock_getsockopt() for
+ *   the list of possible error values.
+ *
+ ****************************************************************************/
+
+int udp_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len);
 #endif
 
 /****************************************************************************
@@ -768,6 +858,57 @@ void udp_callback_cleanup(FAR void *arg);
 ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
                            int flags);
 
+/****************************************************************************
+ * Name: psock_udp_recvmmsg
+ *
+ * Description:
+ *   Perform the recvmmsg operation for a UDP SOCK_DGRAM, taking the network
+ *   lock at most once for the whole batch.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec   The messages to receive, msg_len is set to the bytes received
+ *   vlen     The number of messages in msgvec
+ *   flags    Receive flags
+ *   timeout  The time after which no further message is received or NULL
+ *
+ * Returned Value:
+ *   The number of messages received.  If no message was received, -errno
+ *   is returned (see recvfrom for list of errnos).
+ *
+ ****************************************************************************/
+
+int psock_udp_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags,
+                       FAR struct timespec *timeout);
+
+/****************************************************************************
+ * Name: psock_udp_recviob
+ *
+ * Description:
+ *   Hand the next datagram in the read-ahead buffer of a UDP SOCK_DGRAM
+ *   over to the caller without copying it.  No control messages are
+ *   delivered.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_DRAM socket
+ *   iob      The location to return the I/O buffer chain in
+ *   flags    Receive flags
+ *   from     Address of source (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   The length of the datagram, -EAGAIN if no datagram is buffered.
+ *   Otherwise a negated errno value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECVIOB
+ssize_t psock_udp_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                          int flags, FAR struct sockaddr *from,
+                          FAR socklen_t *fromlen);
+#endif
+
 /****************************************************************************
  * Name: psock_udp_sendto
  *
@@ -797,6 +938,33 @@ ssize_t psock_udp_sendto(FAR struct socket *psock,
                          FAR const void *buf, size_t len, int flags,
                          FAR const struct sockaddr *to, socklen_t tolen);
 
+/****************************************************************************
+ * Name: psock_udp_sendmmsg
+ *
+ * Description:
+ *   Perform the sendmmsg operation for a UDP SOCK_DGRAM, queuing the whole
+ *   batch in the write buffer under one acquisition of the network lock.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec   The messages to send, msg_len is set to the bytes sent
+ *   vlen     The number of messages in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent.  If no message was sent, -errno is
+ *   returned (see sendto for list of errnos).
+ *
+ * Assumptions:
+ *   Each message holds exactly one I/O vector.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+int psock_udp_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags);
+#endif
+
 /****************************************************************************
  * Name: udp_pollsetup
  *
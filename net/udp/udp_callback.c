@@ -45,6 +45,101 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_gro_merge
+ *
+ * Description:
+ *   Append the payload of the received datagram to the last datagram in
+ *   the read-ahead buffer if it continues the same run of equal-size
+ *   segments from the same sender.  A segment shorter than the segment
+ *   size ends the run.
+ *
+ * Returned Value:
+ *   True if the datagram was merged into the read-ahead buffer.
+ *
+ * Assumptions:
+ *   This function must be called with the network and the connection
+ *   locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_GRO
+static bool udp_gro_merge(FAR struct net_driver_s *dev,
+                          FAR struct udp_conn_s *conn,
+                          FAR const void *src_addr, uint8_t src_addr_size,
+                          uint16_t buflen)
+{
+#ifdef CONFIG_NET_IPv6
+  uint8_t addr[sizeof(struct sockaddr_in6)];
+#else
+  uint8_t addr[sizeof(struct sockaddr_in)];
+#endif
+  FAR struct iob_s *iob;
+  unsigned int offset;
+  unsigned int hdroff;
+  uint16_t datalen;
+  uint8_t size;
+
+  if (!conn->gro || conn->gro_len == 0 || conn->readahead == NULL ||
+      buflen == 0 || buflen > conn->gro_segsize ||
+      conn->gro_segs >= UDP_MAX_SEGMENTS ||
+      conn->gro_len + buflen > UINT16_MAX)
+    {
+      return false;
+    }
+
+  /* The last datagram is at the end of the read-ahead buffer, see
+   * udp_datahandler() for its layout.
+   */
+
+  hdroff = conn->readahead->io_pktlen - conn->gro_len;
+  offset = hdroff + sizeof(datalen) + sizeof(conn->gro_segsize);
+
+#ifdef CONFIG_NETDEV_IFINDEX
+  iob_copyout(&size, conn->readahead, sizeof(size), offset);
+  offset += sizeof(size);
+  if (size != dev->d_ifindex)
+    {
+      return false;
+    }
+#endif
+
+  iob_copyout(&size, conn->readahead, sizeof(size), offset);
+  offset += sizeof(size);
+  if (size != src_addr_size)
+    {
+      return false;
+    }
+
+  iob_copyout(addr, conn->readahead, size, offset);
+  if (memcmp(addr, src_addr, size) != 0)
+    {
+      return false;
+    }
+
+  /* Extend the last datagram by the payload */
+
+  iob_copyout((FAR uint8_t *)&datalen, conn->readahead, sizeof(datalen),
+              hdroff);
+  datalen += buflen;
+  iob_trycopyin(conn->readahead, (FAR const uint8_t *)&datalen,
+                sizeof(datalen), hdroff, true);
+
+  iob = dev->d_iob;
+  iob = iob_trimhead(iob, (dev->d_appdata - iob->io_data) - iob->io_offset);
+  net_iob_concat(&conn->readahead, &iob);
+
+  conn->gro_segs++;
+  conn->gro_len += buflen;
+  if (buflen < conn->gro_segsize)
+    {
+      conn->gro_len = 0;
+    }
+
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: udp_datahandler
  *
@@ -77,16 +172,23 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
   uint8_t src_addr_size;
   FAR void *src_addr;
   int offset;
+#ifdef CONFIG_NET_UDP_GRO
+  int payload;
+#endif
 
 #if CONFIG_NET_RECV_BUFSIZE > 0
+  conn_lock(&conn->sconn);
   if (conn->readahead && conn->readahead->io_pktlen > conn->rcvbufs)
     {
+      conn_unlock(&conn->sconn);
       netdev_iob_release(dev);
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.udp.drop++;
 #endif
       return 0;
     }
+
+  conn_unlock(&conn->sconn);
 #endif
 
   iob = dev->d_iob;
@@ -155,11 +257,28 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
     }
 #endif /* CONFIG_NET_IPv4 */
 
+#ifdef CONFIG_NET_UDP_GRO
+  /* Try to coalesce the datagram with the last one first */
+
+  conn_lock(&conn->sconn);
+  if (udp_gro_merge(dev, conn, src_addr, src_addr_size, buflen))
+    {
+      conn_unlock(&conn->sconn);
+      goto out;
+    }
+
+  conn_unlock(&conn->sconn);
+#endif
+
   /* Copy the meta info into the I/O buffer chain, just before data.
-   * Layout: |datalen|ifindex|src_addr_size|src_addr|[timestamp]|data|
+   * Layout: |datalen|[segsize]|ifindex|src_addr_size|src_addr|[timestamp]|
+   *         data|
    */
 
   offset = (dev->d_appdata - iob->io_data) - iob->io_offset;
+#ifdef CONFIG_NET_UDP_GRO
+  payload = offset;
+#endif
 
 #ifdef CONFIG_NET_TIMESTAMP
   /* Store timestamp while packet is being queued.
@@ -201,6 +320,20 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
     }
 #endif
 
+#ifdef CONFIG_NET_UDP_GRO
+  /* The segment size, which is the datagram length until more segments
+   * are appended by udp_gro_merge().
+   */
+
+  offset -= sizeof(buflen);
+  ret = iob_trycopyin(iob, (FAR const uint8_t *)&buflen, sizeof(buflen),
+                      offset, true);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+#endif
+
   offset -= sizeof(buflen);
   ret = iob_trycopyin(iob, (FAR const uint8_t *)&buflen, sizeof(buflen),
                       offset, true);
@@ -216,8 +349,29 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
 
   /* Concat the iob to readahead */
 
+  conn_lock(&conn->sconn);
   net_iob_concat(&conn->readahead, &iob);
 
+#ifdef CONFIG_NET_UDP_GRO
+  /* The datagram may be extended by the following ones */
+
+  if (conn->gro && payload - offset + buflen <= UINT16_MAX)
+    {
+      conn->gro_len     = payload - offset + buflen;
+      conn->gro_segsize = buflen;
+      conn->gro_segs    = 1;
+    }
+  else
+    {
+      conn->gro_len     = 0;
+    }
+#endif
+
+  conn_unlock(&conn->sconn);
+
+#ifdef CONFIG_NET_UDP_GRO
+out:
+#endif
 #ifdef CONFIG_NET_UDP_NOTIFIER
   ninfo("Buffered %d bytes\n", buflen);
 
@@ -63,6 +63,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/netstats.h>
 #include <nuttx/net/udp.h>
 
 #include "devif/devif.h"
@@ -74,6 +75,16 @@
 #include "udp/udp.h"
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A connected socket never takes part in a SO_REUSEPORT group */
+
+#define UDP_ISREUSEPORT(c) \
+  (_SO_GETOPT((c)->sconn.s_options, SO_REUSEPORT) && \
+   !_UDP_ISCONNECTMODE((c)->flags))
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -93,6 +104,14 @@ static mutex_t g_free_lock = NXMUTEX_INITIALIZER;
 
 static dq_queue_t g_active_udp_connections;
 
+#ifdef CONFIG_NETDEV_DEMUX_CACHE
+/* Changed whenever a connection is freed or its addresses change, which
+ * invalidates the connections cached in the network devices.
+ */
+
+static uint32_t g_udp_demux_gen;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -109,6 +128,7 @@ static dq_queue_t g_active_udp_connections;
  *   portno - The port to use in the lookup
  *   opt    - The option from another conn to match the conflict conn
  *              SO_REUSEADDR: If both sockets have this, they never confilct.
+ *              SO_REUSEPORT: If both sockets have this, they never confilct.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -123,6 +143,9 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
 #ifdef CONFIG_NET_SOCKOPTS
   bool skip_reusable = _SO_GETOPT(opt, SO_REUSEADDR);
 #endif
+#ifdef CONFIG_NET_REUSEPORT
+  bool skip_reuseport = _SO_GETOPT(opt, SO_REUSEPORT);
+#endif
 
   /* Now search each connection structure. */
 
@@ -139,6 +162,14 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
         }
 #endif
 
+#ifdef CONFIG_NET_REUSEPORT
+      if (skip_reuseport &&
+          _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+        {
+          continue;
+        }
+#endif
+
       /* If the port local port number assigned to the connections matches
        * AND the IP address of the connection matches, then return a
        * reference to the connection structure.  INADDR_ANY is a special
@@ -636,6 +667,7 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
     {
       /* Make sure that the connection is marked as uninitialized */
 
+      conn_lock_init(&conn->sconn);
       conn->sconn.s_ttl = IP_TTL_DEFAULT;
       conn->flags       = 0;
 #if defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6)
@@ -690,6 +722,7 @@ void udp_free(FAR struct udp_conn_s *conn)
   /* Remove the connection from the active list */
 
   dq_rem(&conn->sconn.node, &g_active_udp_connections);
+  udp_demux_invalidate();
 
   /* Release any read-ahead buffers attached to the connection, NULL is ok */
 
@@ -749,12 +782,37 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
                                   FAR struct udp_conn_s *conn,
                                   FAR struct udp_hdr_s *udp)
 {
+#ifdef CONFIG_NETDEV_DEMUX_CACHE
+  FAR struct udp_conn_s *prev = conn;
+
+  /* Only the first connection for a datagram is cached, the search for
+   * more continues after it.
+   */
+
+  if (prev == NULL)
+    {
+      conn = netdev_demux_lookup(dev, &dev->d_udpdemux, g_udp_demux_gen,
+                                 udp->destport, udp->srcport);
+      if (conn != NULL)
+        {
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.udp.demuxhit++;
+#endif
+          return conn;
+        }
+
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.udp.demuxmiss++;
+#endif
+    }
+#endif
+
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
   if (IFF_IS_IPv6(dev->d_flags))
 #endif
     {
-      return udp_ipv6_active(dev, conn, udp);
+      conn = udp_ipv6_active(dev, conn, udp);
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -763,10 +821,120 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
   else
 #endif
     {
-      return udp_ipv4_active(dev, conn, udp);
+      conn = udp_ipv4_active(dev, conn, udp);
     }
 #endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NETDEV_DEMUX_CACHE
+  if (prev == NULL && conn != NULL)
+    {
+      netdev_demux_update(dev, &dev->d_udpdemux, g_udp_demux_gen,
+                          udp->destport, udp->srcport, conn);
+    }
+#endif
+
+  return conn;
+}
+
+/****************************************************************************
+ * Name: udp_demux_invalidate
+ *
+ * Description:
+ *   Invalidate the UDP connections cached in the network devices.  This
+ *   must be called whenever the addresses, the ports or the connection
+ *   mode of a UDP connection change or a connection is freed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_DEMUX_CACHE
+void udp_demux_invalidate(void)
+{
+  g_udp_demux_gen++;
+}
+#endif
+
+/****************************************************************************
+ * Name: udp_reuseport
+ *
+ * Description:
+ *   Select the socket of the SO_REUSEPORT group of 'conn' that receives
+ *   the datagram in the provided UDP header.  The choice depends on a hash
+ *   of the source address and port, so the datagrams of one flow go to the
+ *   same socket as long as the group does not change.  Connected sockets
+ *   are not part of the group.
+ *
+ * Input Parameters:
+ *   dev  - The device that received the datagram
+ *   conn - The first connection found with udp_active()
+ *   udp  - The UDP header of the datagram
+ *
+ * Returned Value:
+ *   The selected connection, 'conn' if it is not in a group.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+FAR struct udp_conn_s *udp_reuseport(FAR struct net_driver_s *dev,
+                                     FAR struct udp_conn_s *conn,
+                                     FAR struct udp_hdr_s *udp)
+{
+  FAR struct udp_conn_s *next;
+  FAR const void *raddr;
+  unsigned int count = 0;
+  unsigned int nth;
+  uint8_t domain;
+
+  /* Count the sockets of the group that match the datagram */
+
+  for (next = conn; next != NULL; next = udp_active(dev, next, udp))
+    {
+      if (UDP_ISREUSEPORT(next))
+        {
+          count++;
+        }
+    }
+
+  if (!UDP_ISREUSEPORT(conn) || count <= 1)
+    {
+      return conn;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#  endif
+    {
+      domain = PF_INET6;
+      raddr  = IPv6BUF->srcipaddr;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  else
+#  endif
+    {
+      domain = PF_INET;
+      raddr  = IPv4BUF->srcipaddr;
+    }
+#endif
+
+  nth = net_flowhash(domain, raddr, udp->srcport, udp->destport) % count;
+
+  for (next = conn; next != NULL; next = udp_active(dev, next, udp))
+    {
+      if (UDP_ISREUSEPORT(next) && nth-- == 0)
+        {
+          break;
+        }
+    }
+
+  return next;
 }
+#endif
 
 /****************************************************************************
  * Name: udp_nextconn
@@ -962,6 +1130,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         }
     }
 
+  udp_demux_invalidate();
   net_unlock();
   return ret;
 }
@@ -1089,6 +1258,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
 #endif /* CONFIG_NET_IPv6 */
     }
 
+  udp_demux_invalidate();
   return OK;
 }
 
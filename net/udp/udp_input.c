@@ -246,7 +246,13 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
   chksum = udp->udpchksum;
-  if (chksum != 0)
+  if (NETDEV_RXCSUM_OK(dev))
+    {
+      /* The checksum was already verified by the hardware */
+
+      chksum = 0;
+    }
+  else if (chksum != 0)
     {
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
@@ -291,6 +297,19 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
         {
           /* We'll only get multiple conn when we support SO_REUSEADDR */
 
+#ifdef CONFIG_NET_REUSEPORT
+          /* A unicast datagram goes to one socket of a SO_REUSEPORT
+           * group.
+           */
+
+#  ifdef CONFIG_NET_BROADCAST
+          if (!udp_is_broadcast(dev))
+#  endif
+            {
+              conn = udp_reuseport(dev, conn, udp);
+            }
+#endif
+
 #if defined(CONFIG_NET_SOCKOPTS) && defined(CONFIG_NET_BROADCAST)
           /* Check if the destination is a broadcast/multicast address */
 
@@ -33,6 +33,7 @@
 #include <assert.h>
 
 #include <sys/time.h>
+#include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
@@ -41,6 +42,7 @@
 #include <nuttx/net/udp.h>
 #include <nuttx/tls.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
 
 #include "netdev/netdev.h"
 #include "devif/devif.h"
@@ -181,11 +183,15 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 
   pstate->ir_recvlen = -1;
 
+  conn_lock(&conn->sconn);
   if ((iob = conn->readahead) != NULL)
     {
       int recvlen;
       int offset = 0;
       uint16_t datalen;
+#ifdef CONFIG_NET_UDP_GRO
+      uint16_t segsize;
+#endif
       uint8_t src_addr_size;
       uint8_t ifindex;
 #ifdef CONFIG_NET_IPv6
@@ -195,7 +201,8 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 #endif
 
       /* Unflatten saved connection information
-       * Layout: |datalen|ifindex|src_addr_size|src_addr|[timestamp]|data|
+       * Layout: |datalen|[segsize]|ifindex|src_addr_size|src_addr|
+       *         [timestamp]|data|
        */
 
       recvlen = iob_copyout((FAR uint8_t *)&datalen, iob,
@@ -203,6 +210,23 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
       offset += sizeof(datalen);
       DEBUGASSERT(recvlen == sizeof(datalen));
 
+#ifdef CONFIG_NET_UDP_GRO
+      recvlen = iob_copyout((FAR uint8_t *)&segsize, iob,
+                            sizeof(segsize), offset);
+      offset += sizeof(segsize);
+      DEBUGASSERT(recvlen == sizeof(segsize));
+
+      /* Report the segment size of coalesced datagrams */
+
+      if (conn->gro && datalen > segsize)
+        {
+          int gso_size = segsize;
+
+          cmsg_append(pstate->ir_msg, SOL_UDP, UDP_GRO, &gso_size,
+                      sizeof(gso_size));
+        }
+#endif
+
 #ifdef CONFIG_NETDEV_IFINDEX
       recvlen = iob_copyout(&ifindex, iob, sizeof(ifindex), offset);
       offset += sizeof(ifindex);
@@ -275,7 +299,84 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
             }
         }
     }
+
+  conn_unlock(&conn->sconn);
+}
+
+/****************************************************************************
+ * Name: udp_recviob_split
+ *
+ * Description:
+ *   Split the read-ahead buffer after the first 'len' bytes.  Only the
+ *   bytes of the next datagram that share an I/O buffer with the end of
+ *   the first one are copied.
+ *
+ * Input Parameters:
+ *   iob   The read-ahead buffer
+ *   len   The length of the first datagram including its header
+ *   rest  The location to return the remaining datagrams in
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOMEM if no I/O buffer is available.  The
+ *   read-ahead buffer is left unchanged on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECVIOB
+static int udp_recviob_split(FAR struct iob_s *iob, unsigned int len,
+                             FAR struct iob_s **rest)
+{
+  FAR struct iob_s *last = iob;
+  FAR struct iob_s *next;
+  unsigned int pktlen = iob->io_pktlen;
+  unsigned int tail;
+  unsigned int n = 0;
+
+  /* Find the I/O buffer that holds the last byte of the first datagram */
+
+  while (n + last->io_len < len)
+    {
+      n   += last->io_len;
+      last = last->io_flink;
+    }
+
+  tail = n + last->io_len - len;
+  next = last->io_flink;
+
+  if (tail == 0)
+    {
+      *rest = next;
+      next->io_pktlen = pktlen - len;
+    }
+  else
+    {
+      *rest = iob_tryalloc(false);
+      if (*rest == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      if (iob_trycopyin(*rest, last->io_data + last->io_offset +
+                        last->io_len - tail, tail, 0, false) != tail)
+        {
+          iob_free_chain(*rest);
+          return -ENOMEM;
+        }
+
+      if (next != NULL)
+        {
+          next->io_pktlen = pktlen - len - tail;
+          iob_concat(*rest, next);
+        }
+
+      last->io_len -= tail;
+    }
+
+  last->io_flink = NULL;
+  iob->io_pktlen = len;
+  return OK;
 }
+#endif
 
 /****************************************************************************
  * Name: udp_sender
@@ -655,48 +756,36 @@ static void udp_notify_recvcpu(FAR struct udp_conn_s *conn)
 #endif /* CONFIG_NETDEV_RSS */
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: psock_udp_recvfrom
+ * Name: udp_recvfrom_wait
  *
  * Description:
- *   Perform the recvfrom operation for a UDP SOCK_DGRAM
+ *   Take a datagram from the read-ahead buffer or wait for one to arrive,
+ *   as requested by the socket and the receive flags.
  *
  * Input Parameters:
- *   psock  Pointer to the socket structure for the SOCK_DRAM socket
- *   msg    Receive info and buffer for receive data
+ *   conn     The UDP connection of interest
+ *   pstate   The initialized recvfrom state structure
+ *   flags    Receive flags
  *
  * Returned Value:
- *   On success, returns the number of characters received.  On  error,
- *   -errno is returned (see recvfrom for list of errnos).
+ *   The number of bytes received or a negated errno value.
  *
  * Assumptions:
+ *   The network is locked.
  *
  ****************************************************************************/
 
-ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
-                           int flags)
+static ssize_t udp_recvfrom_wait(FAR struct udp_conn_s *conn,
+                                 FAR struct udp_recvfrom_s *pstate,
+                                 int flags)
 {
-  FAR struct udp_conn_s *conn = psock->s_conn;
   FAR struct net_driver_s *dev;
   struct udp_callback_s info;
-  struct udp_recvfrom_s state;
-  int ret;
-
-  /* Perform the UDP recvfrom() operation */
-
-  /* Initialize the state structure.  This is done with the network locked
-   * because we don't want anything to happen until we are ready.
-   */
-
-  net_lock();
-  udp_recvfrom_initialize(conn, msg, &state, flags);
+  ssize_t ret;
 
   /* Copy the read-ahead data from the packet */
 
-  udp_readahead(&state);
+  udp_readahead(pstate);
 
   /* The default return value is the number of bytes that we just copied
    * into the user buffer.  We will return this if the socket has become
@@ -704,7 +793,7 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
    * data from the readahead buffers.
    */
 
-  ret = state.ir_recvlen;
+  ret = pstate->ir_recvlen;
 
   /* Handle non-blocking UDP sockets */
 
@@ -727,10 +816,10 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
    * return the number of bytes read from the read-ahead buffer
    * (already in 'ret').
    *
-   * NOTE: that udp_readahead() may set state.ir_recvlen == -1.
+   * NOTE: that udp_readahead() may set pstate->ir_recvlen == -1.
    */
 
-  else if (state.ir_recvlen <= 0)
+  else if (pstate->ir_recvlen <= 0)
     {
       /* Get the device that will handle the packet transfers.  This may be
        * NULL if the UDP socket is bound to INADDR_ANY.  In that case, no
@@ -741,14 +830,14 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
 
       /* Set up the callback in the connection */
 
-      state.ir_cb = udp_callback_alloc(dev, conn);
-      if (state.ir_cb)
+      pstate->ir_cb = udp_callback_alloc(dev, conn);
+      if (pstate->ir_cb)
         {
           /* Set up the callback in the connection */
 
-          state.ir_cb->flags = (UDP_NEWDATA | NETDEV_DOWN);
-          state.ir_cb->priv  = (FAR void *)&state;
-          state.ir_cb->event = udp_eventhandler;
+          pstate->ir_cb->flags = (UDP_NEWDATA | NETDEV_DOWN);
+          pstate->ir_cb->priv  = (FAR void *)pstate;
+          pstate->ir_cb->event = udp_eventhandler;
 
           /* Push a cancellation point onto the stack.  This will be
            * called if the thread is canceled.
@@ -756,8 +845,8 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
 
           info.dev  = dev;
           info.conn = conn;
-          info.udp_cb = state.ir_cb;
-          info.sem = &state.ir_sem;
+          info.udp_cb = pstate->ir_cb;
+          info.sem = &pstate->ir_sem;
           tls_cleanup_push(tls_get_info(), udp_callback_cleanup, &info);
 
           /* Wait for either the receive to complete or for an error/timeout
@@ -765,7 +854,7 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
            * received.
            */
 
-          ret = net_sem_timedwait(&state.ir_sem,
+          ret = net_sem_timedwait(&pstate->ir_sem,
                               _SO_TIMEOUT(conn->sconn.s_rcvtimeo));
           tls_cleanup_pop(tls_get_info(), 0);
           if (ret == -ETIMEDOUT)
@@ -775,8 +864,8 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
 
           /* Make sure that no further events are processed */
 
-          udp_callback_free(dev, conn, state.ir_cb);
-          ret = udp_recvfrom_result(ret, &state);
+          udp_callback_free(dev, conn, pstate->ir_cb);
+          ret = udp_recvfrom_result(ret, pstate);
         }
       else
         {
@@ -784,6 +873,82 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
         }
     }
 
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_udp_recvfrom
+ *
+ * Description:
+ *   Perform the recvfrom operation for a UDP SOCK_DGRAM
+ *
+ * Input Parameters:
+ *   psock  Pointer to the socket structure for the SOCK_DRAM socket
+ *   msg    Receive info and buffer for receive data
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  On  error,
+ *   -errno is returned (see recvfrom for list of errnos).
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
+                           int flags)
+{
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  struct udp_recvfrom_s state;
+  ssize_t ret;
+
+  /* Perform the UDP recvfrom() operation */
+
+#ifdef CONFIG_NET_CONN_LOCK
+  /* If a datagram is already buffered, take it from the read-ahead buffer
+   * holding only the connection lock so that receiving does not contend
+   * for the network lock with the other connections.
+   */
+
+  conn_lock(&conn->sconn);
+  udp_recvfrom_initialize(conn, msg, &state, flags);
+  udp_readahead(&state);
+  conn_unlock(&conn->sconn);
+
+  if (state.ir_recvlen >= 0)
+    {
+#ifdef CONFIG_NETDEV_RSS
+      if (conn->rcvcpu != this_cpu())
+        {
+          net_lock();
+          udp_notify_recvcpu(conn);
+          net_unlock();
+        }
+#endif
+
+      udp_recvfrom_uninitialize(&state);
+      return state.ir_recvlen;
+    }
+
+  udp_recvfrom_uninitialize(&state);
+#endif
+
+  /* Initialize the state structure.  This is done with the network locked
+   * because we don't want anything to happen until we are ready.
+   */
+
+  net_lock();
+  udp_recvfrom_initialize(conn, msg, &state, flags);
+
+  /* Copy the read-ahead data from the packet, it may have arrived since
+   * the check above, or wait for the data.
+   */
+
+  ret = udp_recvfrom_wait(conn, &state, flags);
+
   udp_notify_recvcpu(conn);
 
   net_unlock();
@@ -791,4 +956,223 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   return ret;
 }
 
+/****************************************************************************
+ * Name: psock_udp_recvmmsg
+ *
+ * Description:
+ *   Perform the recvmmsg operation for a UDP SOCK_DGRAM.  The datagrams
+ *   already buffered are taken holding only the connection lock if
+ *   CONFIG_NET_CONN_LOCK is enabled, and the network lock is taken at most
+ *   once for the whole batch.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec   The messages to receive, msg_len is set to the bytes received
+ *   vlen     The number of messages in msgvec
+ *   flags    Receive flags
+ *   timeout  The time after which no further message is received or NULL
+ *
+ * Returned Value:
+ *   The number of messages received.  If no message was received, -errno
+ *   is returned (see recvfrom for list of errnos).
+ *
+ * Assumptions:
+ *   The messages were verified by psock_recvmmsg().
+ *
+ ****************************************************************************/
+
+int psock_udp_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags,
+                       FAR struct timespec *timeout)
+{
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  struct udp_recvfrom_s state;
+  unsigned int nrecv = 0;
+  bool locked = false;
+  clock_t start;
+  ssize_t ret = 0;
+
+  start = clock_systime_ticks();
+
+#ifndef CONFIG_NET_CONN_LOCK
+  net_lock();
+  locked = true;
+#endif
+
+  while (nrecv < vlen)
+    {
+      FAR struct msghdr *msg = &msgvec[nrecv].msg_hdr;
+      FAR void *msg_control = msg->msg_control;
+      unsigned long msg_controllen = msg->msg_controllen;
+
+      /* Take the datagrams already buffered without the network lock, see
+       * psock_udp_recvfrom().
+       */
+
+      if (!locked)
+        {
+          conn_lock(&conn->sconn);
+          udp_recvfrom_initialize(conn, msg, &state,
+                                  flags & ~MSG_WAITFORONE);
+          udp_readahead(&state);
+          conn_unlock(&conn->sconn);
+
+          ret = state.ir_recvlen;
+          if (ret < 0)
+            {
+              udp_recvfrom_uninitialize(&state);
+              net_lock();
+              locked = true;
+            }
+        }
+
+      if (locked)
+        {
+          udp_recvfrom_initialize(conn, msg, &state,
+                                  flags & ~MSG_WAITFORONE);
+          ret = udp_recvfrom_wait(conn, &state, flags & ~MSG_WAITFORONE);
+        }
+
+      udp_recvfrom_uninitialize(&state);
+
+      /* Report the length of the control data like psock_recvmsg() */
+
+      msg->msg_controllen = msg_controllen - msg->msg_controllen;
+      msg->msg_control    = msg_control;
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[nrecv++].msg_len = ret;
+
+      /* MSG_WAITFORONE only blocks for the first message */
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      if (timeout != NULL &&
+          clock_systime_ticks() - start >= clock_time2ticks(timeout))
+        {
+          break;
+        }
+    }
+
+#ifdef CONFIG_NETDEV_RSS
+  if (!locked && conn->rcvcpu != this_cpu())
+    {
+      net_lock();
+      locked = true;
+    }
+#endif
+
+  if (locked)
+    {
+      udp_notify_recvcpu(conn);
+      net_unlock();
+    }
+
+  return nrecv > 0 ? nrecv : ret;
+}
+
+/****************************************************************************
+ * Name: psock_udp_recviob
+ *
+ * Description:
+ *   Hand the next datagram in the read-ahead buffer of a UDP SOCK_DGRAM
+ *   over to the caller without copying it.  No control messages are
+ *   delivered.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_DRAM socket
+ *   iob      The location to return the I/O buffer chain in
+ *   flags    Receive flags
+ *   from     Address of source (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   The length of the datagram, -EAGAIN if no datagram is buffered.
+ *   Otherwise a negated errno value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECVIOB
+ssize_t psock_udp_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                          int flags, FAR struct sockaddr *from,
+                          FAR socklen_t *fromlen)
+{
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  FAR struct iob_s *head;
+  FAR struct iob_s *rest = NULL;
+  unsigned int offset = 0;
+  uint16_t datalen;
+  uint8_t src_addr_size;
+#ifdef CONFIG_NET_IPv6
+  uint8_t srcaddr[sizeof(struct sockaddr_in6)];
+#else
+  uint8_t srcaddr[sizeof(struct sockaddr_in)];
+#endif
+  int ret;
+
+  conn_lock(&conn->sconn);
+  if ((head = conn->readahead) == NULL)
+    {
+      conn_unlock(&conn->sconn);
+      return -EAGAIN;
+    }
+
+  /* Skip the saved connection information, see udp_readahead() */
+
+  iob_copyout((FAR uint8_t *)&datalen, head, sizeof(datalen), offset);
+  offset += sizeof(datalen);
+#ifdef CONFIG_NET_UDP_GRO
+  offset += sizeof(uint16_t);
+#endif
+#ifdef CONFIG_NETDEV_IFINDEX
+  offset += sizeof(uint8_t);
+#endif
+  iob_copyout(&src_addr_size, head, sizeof(src_addr_size), offset);
+  offset += sizeof(src_addr_size);
+  iob_copyout(srcaddr, head, src_addr_size, offset);
+  offset += src_addr_size;
+#ifdef CONFIG_NET_TIMESTAMP
+  offset += sizeof(struct timespec);
+#endif
+
+  if (offset + datalen < head->io_pktlen)
+    {
+      ret = udp_recviob_split(head, offset + datalen, &rest);
+      if (ret < 0)
+        {
+          conn_unlock(&conn->sconn);
+          return ret;
+        }
+    }
+
+  conn->readahead = rest;
+  conn_unlock(&conn->sconn);
+
+  /* Drop the header, the datagram is all that is left */
+
+  *iob = iob_trimhead(head, offset);
+
+  if (from != NULL)
+    {
+      *fromlen = MIN(*fromlen, src_addr_size);
+      memcpy(from, srcaddr, *fromlen);
+    }
+
+#ifdef CONFIG_NETDEV_RSS
+  net_lock();
+  udp_notify_recvcpu(conn);
+  net_unlock();
+#endif
+
+  return datalen;
+}
+#endif
+
 #endif /* CONFIG_NET && CONFIG_NET_UDP */
@@ -93,6 +93,10 @@ static void udp_send_loopback(FAR struct net_driver_s *dev)
       return;
     }
 
+  /* The checksum may have been left for the hardware */
+
+  NETDEV_RXCSUM_SET(dev, true);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   if (IFF_IS_IPv4(dev->d_flags))
@@ -115,6 +119,8 @@ static void udp_send_loopback(FAR struct net_driver_s *dev)
     }
 #endif /* CONFIG_NET_IPv6 */
 
+  NETDEV_RXCSUM_SET(dev, false);
+
   /* Restore device IOB with backup IOB */
 
   netdev_iob_replace(dev, iob);
@@ -248,29 +254,35 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       iob_update_pktlen(dev->d_iob, dev->d_len, false);
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-      /* Calculate UDP checksum. */
+      /* Calculate UDP checksum, unless the hardware will fill it in.  A
+       * datagram that is going to be fragmented cannot be offloaded, the
+       * hardware only sees the individual fragments.
+       */
 
+      if (!NETDEV_TXCSUM(dev) || dev->d_len > devif_get_mtu(dev))
+        {
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
-      if (IFF_IS_IPv4(dev->d_flags))
+          if (IFF_IS_IPv4(dev->d_flags))
 #endif
-        {
-          udp->udpchksum = ~udp_ipv4_chksum(dev);
-        }
+            {
+              udp->udpchksum = ~udp_ipv4_chksum(dev);
+            }
 #endif /* CONFIG_NET_IPv4 */
 
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
-      else
+          else
 #endif
-        {
-          udp->udpchksum = ~udp_ipv6_chksum(dev);
-        }
+            {
+              udp->udpchksum = ~udp_ipv6_chksum(dev);
+            }
 #endif /* CONFIG_NET_IPv6 */
 
-      if (udp->udpchksum == 0)
-        {
-          udp->udpchksum = 0xffff;
+          if (udp->udpchksum == 0)
+            {
+              udp->udpchksum = 0xffff;
+            }
         }
 #endif /* CONFIG_NET_UDP_CHECKSUMS */
 
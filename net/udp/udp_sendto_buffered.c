@@ -264,6 +264,8 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
           nerr("ERROR: Failed to get a local port!\n");
           return -EADDRINUSE;
         }
+
+      udp_demux_invalidate();
     }
 
   /* Get the device that will handle the remote packet transfers.  This
@@ -450,6 +452,7 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
 
       dev->d_sndlen = wrb->wb_iob->io_pktlen - udpiplen;
       ninfo("wrb=%p sndlen=%d\n", wrb, dev->d_sndlen);
+      NETDEV_SNDSUM_SET(dev, wrb->wb_sum, dev->d_sndlen);
 
       /* Do not need to release wb_iob, the life cycle of wb_iob is
        * handed over to the network device
@@ -513,6 +516,232 @@ static unsigned int udp_send_gettimeout(clock_t start, unsigned int timeout)
   return timeout;
 }
 
+/****************************************************************************
+ * Name: sendto_queue
+ *
+ * Description:
+ *   Copy one datagram into a new write buffer and add it to the write
+ *   queue of the connection.
+ *
+ * Input Parameters:
+ *   conn     The UDP connection of interest
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   to       Address of recipient, NULL if connected
+ *   tolen    The length of the address structure
+ *   nonblock Do not wait for write buffers
+ *   start    The start time of the send
+ *   timeout  The send timeout
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static int sendto_queue(FAR struct udp_conn_s *conn, FAR const void *buf,
+                        size_t len, FAR const struct sockaddr *to,
+                        socklen_t tolen, bool nonblock, clock_t start,
+                        unsigned int timeout)
+{
+  FAR struct udp_wrbuffer_s *wrb;
+  uint16_t udpiplen;
+  bool empty;
+  int ret;
+
+  /* Allocate a write buffer.  Careful, the network will be momentarily
+   * unlocked here.
+   */
+
+#ifdef CONFIG_NET_JUMBO_FRAME
+
+  /* alloc iob of gso pkt for udp data */
+
+  wrb = udp_wrbuffer_tryalloc(len + udpip_hdrsize(conn) +
+                              CONFIG_NET_LL_GUARDSIZE);
+#else
+  if (nonblock)
+    {
+      wrb = udp_wrbuffer_tryalloc();
+    }
+  else
+    {
+      wrb = udp_wrbuffer_timedalloc(udp_send_gettimeout(start,
+                                                        timeout));
+    }
+#endif
+
+  if (wrb == NULL)
+    {
+      /* A buffer allocation error occurred */
+
+      nerr("ERROR: Failed to allocate write buffer\n");
+
+      if (nonblock || timeout != UINT_MAX)
+        {
+          ret = -EAGAIN;
+        }
+      else
+        {
+          ret = -ENOMEM;
+        }
+
+      return ret;
+    }
+
+  /* Initialize the write buffer
+   *
+   * Check if the socket is connected
+   */
+
+  if (_SS_ISCONNECTED(conn->sconn.s_flags))
+    {
+      /* Yes.. get the connection address from the connection structure */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      if (conn->domain == PF_INET)
+#endif
+        {
+          FAR struct sockaddr_in *addr4 =
+            (FAR struct sockaddr_in *)&wrb->wb_dest;
+
+          addr4->sin_family = AF_INET;
+          addr4->sin_port   = conn->rport;
+          net_ipv4addr_copy(addr4->sin_addr.s_addr, conn->u.ipv4.raddr);
+          memset(addr4->sin_zero, 0, sizeof(addr4->sin_zero));
+        }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      else
+#endif
+        {
+          FAR struct sockaddr_in6 *addr6 =
+            (FAR struct sockaddr_in6 *)&wrb->wb_dest;
+
+          addr6->sin6_family = AF_INET6;
+          addr6->sin6_port   = conn->rport;
+          net_ipv6addr_copy(addr6->sin6_addr.s6_addr,
+                            conn->u.ipv6.raddr);
+        }
+#endif /* CONFIG_NET_IPv6 */
+    }
+
+  /* Not connected.  Use the provided destination address */
+
+  else
+    {
+      memcpy(&wrb->wb_dest, to, tolen);
+      udp_connect(conn, to);
+    }
+
+  /* Skip l2/l3/l4 offset before copy */
+
+  udpiplen = udpip_hdrsize(conn);
+
+  iob_reserve(wrb->wb_iob, CONFIG_NET_LL_GUARDSIZE);
+  iob_update_pktlen(wrb->wb_iob, udpiplen, false);
+
+  /* Copy the user data into the write buffer.  We cannot wait for
+   * buffer space if the socket was opened non-blocking.
+   */
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+  /* Sum the payload while it is copied anyway, saving a pass over the
+   * data when the datagram is sent.
+   */
+
+  wrb->wb_sum = 0;
+#endif
+
+  if (nonblock)
+    {
+#ifdef CONFIG_NET_CHKSUM_COPY
+      ret = iob_trycopyin_chksum(wrb->wb_iob, (FAR uint8_t *)buf,
+                                 len, udpiplen, false, &wrb->wb_sum);
+#else
+      ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf,
+                          len, udpiplen, false);
+#endif
+    }
+  else
+    {
+      unsigned int count;
+      int blresult;
+
+      /* iob_copyin might wait for buffers to be freed, but if
+       * network is locked this might never happen, since network
+       * driver is also locked, therefore we need to break the lock
+       */
+
+      blresult = net_breaklock(&count);
+#ifdef CONFIG_NET_CHKSUM_COPY
+      ret = iob_copyin_chksum(wrb->wb_iob, (FAR uint8_t *)buf,
+                              len, udpiplen, false, &wrb->wb_sum);
+#else
+      ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)buf,
+                       len, udpiplen, false);
+#endif
+      if (blresult >= 0)
+        {
+          net_restorelock(count);
+        }
+    }
+
+  if (ret < 0)
+    {
+      goto errout_with_wrb;
+    }
+
+  /* Dump I/O buffer chain */
+
+  UDP_WBDUMP("I/O buffer chain", wrb, wrb->wb_iob->io_pktlen, 0);
+
+  /* sendto_eventhandler() will send data in FIFO order from the
+   * conn->write_q.
+   *
+   * REVISIT:  Why FIFO order?  Because it is easy.  In a real world
+   * environment where there are multiple network devices this might
+   * be inefficient because we could be sending data to different
+   * device out-of-queued-order to optimize performance.  Sending
+   * data to different networks from a single UDP socket is probably
+   * not a very common use case, however.
+   */
+
+  empty = sq_empty(&conn->write_q);
+
+  sq_addlast(&wrb->wb_node, &conn->write_q);
+  ninfo("Queued WRB=%p pktlen=%u write_q(%p,%p)\n",
+        wrb, wrb->wb_iob->io_pktlen,
+        conn->write_q.head, conn->write_q.tail);
+
+  if (empty)
+    {
+      /* The new write buffer lies at the head of the write queue.  Set
+       * up for the next packet transfer by setting the connection
+       * address to the address of the next packet now at the header of
+       * the write buffer queue.
+       */
+
+      ret = sendto_next_transfer(conn);
+      if (ret < 0)
+        {
+          sq_remlast(&conn->write_q);
+          goto errout_with_wrb;
+        }
+    }
+
+  return OK;
+
+errout_with_wrb:
+  udp_wrbuffer_release(wrb);
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -546,12 +775,13 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
                          size_t len, int flags,
                          FAR const struct sockaddr *to, socklen_t tolen)
 {
-  FAR struct udp_wrbuffer_s *wrb;
   FAR struct udp_conn_s *conn;
   unsigned int timeout;
-  uint16_t udpiplen;
+#ifdef CONFIG_NET_UDP_GSO
+  size_t segsize;
+  size_t sent;
+#endif
   bool nonblock;
-  bool empty;
   int ret = OK;
   clock_t start;
 
@@ -566,6 +796,14 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
       return -EMSGSIZE;
     }
 
+#ifdef CONFIG_NET_UDP_GSO
+  if (conn->gso_size != 0 &&
+      (len + conn->gso_size - 1) / conn->gso_size > UDP_MAX_SEGMENTS)
+    {
+      return -EINVAL;
+    }
+#endif
+
   /* If the UDP socket was previously assigned a remote peer address via
    * connect(), then as with connection-mode socket, sendto() may not be
    * used with a non-NULL destination address.  Normally send() would be
@@ -718,185 +956,110 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
         }
 #endif /* CONFIG_NET_SEND_BUFSIZE */
 
-      /* Allocate a write buffer.  Careful, the network will be momentarily
-       * unlocked here.
+#ifdef CONFIG_NET_UDP_GSO
+      /* With UDP_SEGMENT, the data is split into datagrams of the segment
+       * size that are all queued while the network stays locked.  The
+       * device is notified only once, when the first one is queued.
        */
 
-#ifdef CONFIG_NET_JUMBO_FRAME
-
-      /* alloc iob of gso pkt for udp data */
-
-      wrb = udp_wrbuffer_tryalloc(len + udpip_hdrsize(conn) +
-                                  CONFIG_NET_LL_GUARDSIZE);
-#else
-      if (nonblock)
-        {
-          wrb = udp_wrbuffer_tryalloc();
-        }
-      else
-        {
-          wrb = udp_wrbuffer_timedalloc(udp_send_gettimeout(start,
-                                                            timeout));
-        }
-#endif
-
-      if (wrb == NULL)
-        {
-          /* A buffer allocation error occurred */
-
-          nerr("ERROR: Failed to allocate write buffer\n");
-
-          if (nonblock || timeout != UINT_MAX)
-            {
-              ret = -EAGAIN;
-            }
-          else
-            {
-              ret = -ENOMEM;
-            }
-
-          goto errout_with_lock;
-        }
-
-      /* Initialize the write buffer
-       *
-       * Check if the socket is connected
-       */
+      segsize = conn->gso_size != 0 ? conn->gso_size : len;
 
-      if (_SS_ISCONNECTED(conn->sconn.s_flags))
+      for (sent = 0; sent < len; sent += segsize)
         {
-          /* Yes.. get the connection address from the connection structure */
-
-#ifdef CONFIG_NET_IPv4
-#ifdef CONFIG_NET_IPv6
-          if (conn->domain == PF_INET)
-#endif
+          ret = sendto_queue(conn, (FAR const uint8_t *)buf + sent,
+                             MIN(segsize, len - sent), to, tolen,
+                             nonblock, start, timeout);
+          if (ret < 0)
             {
-              FAR struct sockaddr_in *addr4 =
-                (FAR struct sockaddr_in *)&wrb->wb_dest;
-
-              addr4->sin_family = AF_INET;
-              addr4->sin_port   = conn->rport;
-              net_ipv4addr_copy(addr4->sin_addr.s_addr, conn->u.ipv4.raddr);
-              memset(addr4->sin_zero, 0, sizeof(addr4->sin_zero));
-            }
-#endif /* CONFIG_NET_IPv4 */
+              /* Report what was queued before the failure */
 
-#ifdef CONFIG_NET_IPv6
-#ifdef CONFIG_NET_IPv4
-          else
-#endif
-            {
-              FAR struct sockaddr_in6 *addr6 =
-                (FAR struct sockaddr_in6 *)&wrb->wb_dest;
+              if (sent > 0)
+                {
+                  len = sent;
+                  break;
+                }
 
-              addr6->sin6_family = AF_INET6;
-              addr6->sin6_port   = conn->rport;
-              net_ipv6addr_copy(addr6->sin6_addr.s6_addr,
-                                conn->u.ipv6.raddr);
+              goto errout_with_lock;
             }
-#endif /* CONFIG_NET_IPv6 */
         }
-
-      /* Not connected.  Use the provided destination address */
-
-      else
+#else
+      ret = sendto_queue(conn, buf, len, to, tolen, nonblock, start,
+                         timeout);
+      if (ret < 0)
         {
-          memcpy(&wrb->wb_dest, to, tolen);
-          udp_connect(conn, to);
+          goto errout_with_lock;
         }
+#endif
 
-      /* Skip l2/l3/l4 offset before copy */
-
-      udpiplen = udpip_hdrsize(conn);
-
-      iob_reserve(wrb->wb_iob, CONFIG_NET_LL_GUARDSIZE);
-      iob_update_pktlen(wrb->wb_iob, udpiplen, false);
-
-      /* Copy the user data into the write buffer.  We cannot wait for
-       * buffer space if the socket was opened non-blocking.
-       */
-
-      if (nonblock)
-        {
-          ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf,
-                              len, udpiplen, false);
-        }
-      else
-        {
-          unsigned int count;
-          int blresult;
+      net_unlock();
+    }
 
-          /* iob_copyin might wait for buffers to be freed, but if
-           * network is locked this might never happen, since network
-           * driver is also locked, therefore we need to break the lock
-           */
+  /* Return the number of bytes that will be sent */
 
-          blresult = net_breaklock(&count);
-          ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)buf,
-                           len, udpiplen, false);
-          if (blresult >= 0)
-            {
-              net_restorelock(count);
-            }
-        }
+  return len;
 
-      if (ret < 0)
-        {
-          goto errout_with_wrb;
-        }
+errout_with_lock:
+  net_unlock();
+  return ret;
+}
 
-      /* Dump I/O buffer chain */
+/****************************************************************************
+ * Name: psock_udp_sendmmsg
+ *
+ * Description:
+ *   Perform the sendmmsg operation for a UDP SOCK_DGRAM.  The network is
+ *   held locked over the whole batch, so the datagrams are queued back to
+ *   back in the write buffer.  Each psock_udp_sendto() still decides on
+ *   its own whether to notify the device: that happens when a datagram is
+ *   queued to an empty write queue.  Usually only the first datagram of a
+ *   batch does that.  If a call has to wait for a free write buffer, the
+ *   network lock is dropped, the driver may empty the queue, and the next
+ *   datagram notifies the device again.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec   The messages to send, msg_len is set to the bytes sent
+ *   vlen     The number of messages in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent.  If no message was sent, -errno is
+ *   returned (see sendto for list of errnos).
+ *
+ * Assumptions:
+ *   Each message holds exactly one I/O vector.
+ *
+ ****************************************************************************/
 
-      UDP_WBDUMP("I/O buffer chain", wrb, wrb->wb_iob->io_pktlen, 0);
+int psock_udp_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags)
+{
+  unsigned int nsent;
+  ssize_t ret = 0;
 
-      /* sendto_eventhandler() will send data in FIFO order from the
-       * conn->write_q.
-       *
-       * REVISIT:  Why FIFO order?  Because it is easy.  In a real world
-       * environment where there are multiple network devices this might
-       * be inefficient because we could be sending data to different
-       * device out-of-queued-order to optimize performance.  Sending
-       * data to different networks from a single UDP socket is probably
-       * not a very common use case, however.
-       */
+  /* psock_udp_sendto() nests the network lock, which only increments the
+   * count of the lock that is already held here.
+   */
 
-      empty = sq_empty(&conn->write_q);
+  net_lock();
 
-      sq_addlast(&wrb->wb_node, &conn->write_q);
-      ninfo("Queued WRB=%p pktlen=%u write_q(%p,%p)\n",
-            wrb, wrb->wb_iob->io_pktlen,
-            conn->write_q.head, conn->write_q.tail);
+  for (nsent = 0; nsent < vlen; nsent++)
+    {
+      FAR struct msghdr *msg = &msgvec[nsent].msg_hdr;
 
-      if (empty)
+      ret = psock_udp_sendto(psock, msg->msg_iov->iov_base,
+                             msg->msg_iov->iov_len, flags,
+                             msg->msg_name, msg->msg_namelen);
+      if (ret < 0)
         {
-          /* The new write buffer lies at the head of the write queue.  Set
-           * up for the next packet transfer by setting the connection
-           * address to the address of the next packet now at the header of
-           * the write buffer queue.
-           */
-
-          ret = sendto_next_transfer(conn);
-          if (ret < 0)
-            {
-              sq_remlast(&conn->write_q);
-              goto errout_with_wrb;
-            }
+          break;
         }
 
-      net_unlock();
+      msgvec[nsent].msg_len = ret;
     }
 
-  /* Return the number of bytes that will be sent */
-
-  return len;
-
-errout_with_wrb:
-  udp_wrbuffer_release(wrb);
-
-errout_with_lock:
   net_unlock();
-  return ret;
+  return nsent > 0 ? nsent : ret;
 }
 
 /****************************************************************************
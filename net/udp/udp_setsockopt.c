@@ -76,7 +76,55 @@
 int udp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len)
 {
-  return -ENOPROTOOPT;
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  int ret = -ENOPROTOOPT;
+  int val;
+
+  if (psock->s_type != SOCK_DGRAM)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  if (value == NULL || value_len < sizeof(int))
+    {
+      return -EINVAL;
+    }
+
+  val = *(FAR const int *)value;
+
+  net_lock();
+
+  switch (option)
+    {
+#ifdef CONFIG_NET_UDP_GSO
+      case UDP_SEGMENT:
+        if (val < 0 || val > UINT16_MAX)
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        conn->gso_size = val;
+        ret = OK;
+        break;
+#endif
+
+#ifdef CONFIG_NET_UDP_GRO
+      case UDP_GRO:
+        conn_lock(&conn->sconn);
+        conn->gro     = val != 0;
+        conn->gro_len = 0;
+        conn_unlock(&conn->sconn);
+        ret = OK;
+        break;
+#endif
+
+      default:
+        break;
+    }
+
+  net_unlock();
+  return ret;
 }
 
 #endif /* CONFIG_NET_UDPPROTO_OPTIONS */
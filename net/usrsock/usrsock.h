@@ -52,6 +52,10 @@
 
 #define USRSOCK_USOCKID_INVALID     (-1)
 
+#ifndef CONFIG_NET_USRSOCK_REQUEST_WINDOW
+#  define CONFIG_NET_USRSOCK_REQUEST_WINDOW 1
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -91,6 +95,9 @@ struct usrsock_conn_s
     sem_t    sem;               /* Request semaphore (only one outstanding request) */
     uint32_t xid;               /* Expected message exchange id */
     bool     inprogress;        /* Request was received but daemon is still processing */
+#if CONFIG_NET_USRSOCK_REQUEST_WINDOW > 1
+    bool     ackpending;        /* Request holds a slot of the request window */
+#endif
     uint16_t valuelen;          /* Length of value from daemon */
     uint16_t valuelen_nontrunc; /* Actual length of value at daemon */
     int      result;            /* Result for request */
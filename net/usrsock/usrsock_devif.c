@@ -62,6 +62,10 @@ struct usrsock_req_s
   /* Connection instance to receive data buffers. */
 
   FAR struct usrsock_conn_s *datain_conn;
+
+#if CONFIG_NET_USRSOCK_REQUEST_WINDOW > 1
+  sem_t    window;            /* Free slots for requests waiting for ack */
+#endif
 };
 
 /****************************************************************************
@@ -80,7 +84,10 @@ static struct usrsock_req_s g_usrsock_req =
   0,
   0,
   0,
-  NULL
+  NULL,
+#if CONFIG_NET_USRSOCK_REQUEST_WINDOW > 1
+  SEM_INITIALIZER(CONFIG_NET_USRSOCK_REQUEST_WINDOW),
+#endif
 };
 
 /****************************************************************************
@@ -484,6 +491,20 @@ static ssize_t usrsock_handle_req_response(FAR const void *buffer,
       goto unlock_out;
     }
 
+#if CONFIG_NET_USRSOCK_REQUEST_WINDOW > 1
+  if (conn->resp.ackpending)
+    {
+      conn->resp.ackpending = false;
+      if (req_done)
+        {
+          *req_done = true;
+        }
+
+      /* The request was acknowledged, free its slot in the window */
+
+      nxsem_post(&req->window);
+    }
+#else
   if (req->ackxid == hdr->xid)
     {
       req->ackxid = 0;
@@ -498,6 +519,7 @@ static ssize_t usrsock_handle_req_response(FAR const void *buffer,
 
       nxsem_post(&req->acksem);
     }
+#endif
 
   conn->resp.events = hdr->head.events | USRSOCK_EVENT_REQ_COMPLETE;
   ret = handle_response(conn, buffer, len);
@@ -648,6 +670,12 @@ int usrsock_do_request(FAR struct usrsock_conn_s *conn,
 
   req_head = iov[0].iov_base;
 
+#if CONFIG_NET_USRSOCK_REQUEST_WINDOW > 1
+  /* Wait for a free slot in the window of the requests in flight */
+
+  net_sem_wait_uninterruptible(&req->window);
+#endif
+
   /* Set outstanding request for daemon to handle. */
 
   net_mutex_lock(&req->lock);
@@ -663,6 +691,23 @@ int usrsock_do_request(FAR struct usrsock_conn_s *conn,
   conn->resp.xid = req_head->xid;
   conn->resp.result = -EACCES;
 
+#if CONFIG_NET_USRSOCK_REQUEST_WINDOW > 1
+  /* The transport has copied the request when usrsock_request() returns,
+   * so the ack is not waited for here.  The caller waits for the response
+   * anyway and the other sockets may send their requests meanwhile.  The
+   * lock still keeps the fragments of large requests together.
+   */
+
+  conn->resp.ackpending = true;
+
+  ret = usrsock_request(iov, iovcnt);
+  if (ret < 0)
+    {
+      nerr("error: usrsock request failed with %d\n", ret);
+      conn->resp.ackpending = false;
+      nxsem_post(&req->window);
+    }
+#else
   req->ackxid = req_head->xid;
 
   ret = usrsock_request(iov, iovcnt);
@@ -678,6 +723,7 @@ int usrsock_do_request(FAR struct usrsock_conn_s *conn,
     {
       nerr("error: usrsock request failed with %d\n", ret);
     }
+#endif
 
   /* Free request line for next command. */
 
@@ -704,6 +750,14 @@ void usrsock_abort(void)
       conn->resp.inprogress = false;
       conn->resp.xid = 0;
       conn->resp.events = USRSOCK_EVENT_ABORT;
+#if CONFIG_NET_USRSOCK_REQUEST_WINDOW > 1
+      if (conn->resp.ackpending)
+        {
+          conn->resp.ackpending = false;
+          nxsem_post(&req->window);
+        }
+#endif
+
       usrsock_event(conn);
     }
 
@@ -27,12 +27,227 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <string.h>
+
+#include <nuttx/arch.h>
+
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A byte in the first or the second position of a 16-bit word, as the
+ * word would be loaded from memory in native byte order.
+ */
+
+#ifdef CONFIG_ENDIAN_BIG
+#  define CHKSUM_BYTE0(b)  ((uint32_t)(b) << 8)
+#  define CHKSUM_BYTE1(b)  ((uint32_t)(b))
+#else
+#  define CHKSUM_BYTE0(b)  ((uint32_t)(b))
+#  define CHKSUM_BYTE1(b)  ((uint32_t)(b) << 8)
+#endif
+
+#define CHKSUM_WORDSIZE    sizeof(uintptr_t)
+#define CHKSUM_WORDMASK    (CHKSUM_WORDSIZE - 1)
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifndef CONFIG_NET_ARCH_CHKSUM
+
+/****************************************************************************
+ * Name: chksum_fold
+ *
+ * Description:
+ *   Fold a 32-bit one's complement sum into 16 bits.  Adding the rotated
+ *   value carries the low half into the high half in a single step, which
+ *   compiles to a rotate on the targets that have one.
+ *
+ ****************************************************************************/
+
+static inline_function uint32_t chksum_fold(uint32_t sum)
+{
+  sum += (sum >> 16) | (sum << 16);
+  return sum >> 16;
+}
+
+/****************************************************************************
+ * Name: chksum_addc
+ *
+ * Description:
+ *   Add one native word to the sum with end-around carry.
+ *
+ ****************************************************************************/
+
+static inline_function uintptr_t chksum_addc(uintptr_t sum, uintptr_t word)
+{
+  sum += word;
+  return sum + (sum < word);
+}
+
+/****************************************************************************
+ * Name: chksum_accumulate
+ *
+ * Description:
+ *   Return the one's complement sum of the 16-bit words of 'src', loaded
+ *   in native byte order and paired from the first byte, copying 'src' to
+ *   'dest' on the way if 'copy' is set.  The bulk of the buffer is summed
+ *   a native word at a time once 'src' is aligned.  An odd start address
+ *   is handled by summing with the pairing shifted by one byte and then
+ *   swapping the bytes of the result.
+ *
+ *   If 'copy' is set, 'dest' and 'src' must have the same alignment.
+ *
+ ****************************************************************************/
+
+static inline_function uint32_t chksum_accumulate(FAR uint8_t *dest,
+                                                  FAR const uint8_t *src,
+                                                  size_t len, bool copy)
+{
+  FAR const uintptr_t *sword;
+  FAR uintptr_t *dword;
+  uintptr_t sum = 0;
+  uint32_t result;
+  bool swap = false;
+
+  if (((uintptr_t)src & 1) != 0 && len > 0)
+    {
+      if (copy)
+        {
+          *dest++ = *src;
+        }
+
+      sum  = CHKSUM_BYTE1(*src++);
+      swap = true;
+      len--;
+    }
+
+  while (len >= 2 && ((uintptr_t)src & CHKSUM_WORDMASK) != 0)
+    {
+      uint16_t half = *(FAR const uint16_t *)src;
+
+      if (copy)
+        {
+          *(FAR uint16_t *)dest = half;
+          dest += 2;
+        }
+
+      sum += half;
+      src += 2;
+      len -= 2;
+    }
+
+  /* Sum four words per iteration to keep the loop overhead down */
+
+  sword = (FAR const uintptr_t *)src;
+  dword = (FAR uintptr_t *)dest;
+
+  while (len >= 4 * CHKSUM_WORDSIZE)
+    {
+      uintptr_t w0 = sword[0];
+      uintptr_t w1 = sword[1];
+      uintptr_t w2 = sword[2];
+      uintptr_t w3 = sword[3];
+
+      if (copy)
+        {
+          dword[0] = w0;
+          dword[1] = w1;
+          dword[2] = w2;
+          dword[3] = w3;
+          dword   += 4;
+        }
+
+      sum    = chksum_addc(sum, w0);
+      sum    = chksum_addc(sum, w1);
+      sum    = chksum_addc(sum, w2);
+      sum    = chksum_addc(sum, w3);
+      sword += 4;
+      len   -= 4 * CHKSUM_WORDSIZE;
+    }
+
+  while (len >= CHKSUM_WORDSIZE)
+    {
+      uintptr_t w0 = *sword++;
+
+      if (copy)
+        {
+          *dword++ = w0;
+        }
+
+      sum  = chksum_addc(sum, w0);
+      len -= CHKSUM_WORDSIZE;
+    }
+
+  src  = (FAR const uint8_t *)sword;
+  dest = (FAR uint8_t *)dword;
+
+#if UINTPTR_MAX > UINT32_MAX
+  sum = (sum & 0xffffffff) + (sum >> 32);
+  sum = (sum & 0xffffffff) + (sum >> 32);
+#endif
+
+  /* Less than a word is left, that cannot overflow the folded sum */
+
+  result = chksum_fold(sum);
+
+  while (len >= 2)
+    {
+      uint16_t half = *(FAR const uint16_t *)src;
+
+      if (copy)
+        {
+          *(FAR uint16_t *)dest = half;
+          dest += 2;
+        }
+
+      result += half;
+      src    += 2;
+      len    -= 2;
+    }
+
+  if (len > 0)
+    {
+      if (copy)
+        {
+          *dest = *src;
+        }
+
+      result += CHKSUM_BYTE0(*src);
+    }
+
+  result = chksum_fold(result);
+  if (swap)
+    {
+      result = ((result & 0xff) << 8) | (result >> 8);
+    }
+
+  return result;
+}
+
+/****************************************************************************
+ * Name: chksum_partial
+ *
+ * Description:
+ *   Return the one's complement sum of the 16-bit words of 'data' in
+ *   native byte order, using up_chksum_partial() if the architecture
+ *   provides it.
+ *
+ ****************************************************************************/
+
+static inline_function uint32_t chksum_partial(FAR const uint8_t *data,
+                                               size_t len)
+{
+#ifdef CONFIG_ARCH_HAVE_NET_CHKSUM
+  return up_chksum_partial(data, len);
+#else
+  return chksum_accumulate(NULL, data, len, false);
+#endif
+}
+
 /****************************************************************************
  * Name: checksum
  *
@@ -53,60 +268,30 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
 uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
                     uint16_t len, bool *odd)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
-
-  dataptr = data;
-  last_byte = data + len - 1;
+  uint32_t acc = sum;
 
-  if (*odd == true)
+  if (len == 0)
     {
-      t = dataptr[0];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      dataptr += 1;
+      return sum;
     }
 
-  while (dataptr < last_byte)
+  if (*odd == true)
     {
-      /* At least two more bytes */
+      /* Complete the word whose first byte ended the previous region */
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      dataptr += 2;
+      acc += *data++;
+      len--;
     }
 
-  *odd = false;
-
-  if (dataptr == last_byte)
-    {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      *odd = true;
-    }
+  acc += NTOHS(chksum_fold(chksum_partial(data, len)));
+  *odd = (len & 1) != 0;
 
   /* Return sum in host byte order. */
 
-  return sum;
+  return chksum_fold(acc);
 }
 
 /****************************************************************************
@@ -139,6 +324,68 @@ uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
   return checksum(sum, data, len, &odd);
 }
 
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy 'len' bytes from 'src' to 'dest' and accumulate the raw change
+ *   sum of the copied data in the same pass.
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call, zero
+ *          on the first call.
+ *   dest - The destination of the copy.
+ *   src  - The data to copy and to include in the checksum.
+ *   len  - Length of the data.
+ *   odd  - Whether the previous call ended in the middle of a 16-bit
+ *          word, updated on return.  Should be false on the first call.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dest,
+                     FAR const uint8_t *src, uint16_t len, FAR bool *odd)
+{
+  uint32_t partial;
+  uint32_t acc = sum;
+
+  if (len == 0)
+    {
+      return sum;
+    }
+
+  if (*odd)
+    {
+      *dest++ = *src;
+      acc    += *src++;
+      len--;
+    }
+
+#ifndef CONFIG_ARCH_HAVE_NET_CHKSUM
+  /* Sum the words on their way through the registers when both buffers
+   * can be aligned together, otherwise copy first and sum the copy while
+   * it is still in the cache.
+   */
+
+  if ((((uintptr_t)dest ^ (uintptr_t)src) & CHKSUM_WORDMASK) == 0)
+    {
+      partial = chksum_accumulate(dest, src, len, true);
+    }
+  else
+#endif
+    {
+      memcpy(dest, src, len);
+      partial = chksum_partial(dest, len);
+    }
+
+  acc += NTOHS(chksum_fold(partial));
+  *odd = (len & 1) != 0;
+
+  return chksum_fold(acc);
+}
+
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
 /****************************************************************************
@@ -0,0 +1,88 @@
+/****************************************************************************
+ * net/utils/net_flowhash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <sys/socket.h>
+
+#include "utils/utils.h"
+
+#ifdef CONFIG_NET_REUSEPORT
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_flowhash
+ *
+ * Description:
+ *   Return a hash of the remote address and the ports of a flow.  It is
+ *   used to spread the flows over the sockets of a SO_REUSEPORT group, the
+ *   packets of one flow always get the same hash.
+ *
+ * Input Parameters:
+ *   domain - PF_INET or PF_INET6
+ *   raddr  - The remote address, an in_addr_t or a net_ipv6addr_t
+ *   rport  - The remote port
+ *   lport  - The local port
+ *
+ * Returned Value:
+ *   The hash of the flow.
+ *
+ ****************************************************************************/
+
+uint32_t net_flowhash(uint8_t domain, FAR const void *raddr,
+                      uint16_t rport, uint16_t lport)
+{
+  FAR const uint16_t *addr = raddr;
+  uint32_t hash = ((uint32_t)rport << 16) | lport;
+  int nwords = domain == PF_INET6 ? 8 : 2;
+  int i;
+
+  /* The addresses in the IP headers are only 16-bit aligned */
+
+  for (i = 0; i < nwords; i++)
+    {
+      hash ^= addr[i];
+      hash *= 0x9e3779b1;
+      hash ^= hash >> 16;
+    }
+
+  /* Mix the bits so that close addresses and ports spread evenly */
+
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6b;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35;
+  hash ^= hash >> 16;
+
+  return hash;
+}
+
+#endif /* CONFIG_NET_REUSEPORT */
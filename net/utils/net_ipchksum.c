@@ -35,6 +35,67 @@
 
 #ifdef CONFIG_NET
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: upperlayer_sndsum
+ *
+ * Description:
+ *   Use the checksum of the application data accumulated while it was
+ *   copied into d_iob, so that only the protocol header has to be summed.
+ *   The sum is only used for TCP and UDP, which never modify the data
+ *   after it was copied, and only if it still covers exactly the trailing
+ *   d_sndlen bytes of the packet behind an even length header that lies
+ *   in the first I/O buffer.
+ *
+ * Input Parameters:
+ *   dev      - The network driver instance.
+ *   proto    - The protocol being supported
+ *   iplen    - The size of the IP header, including extension headers
+ *   upperlen - The length of the upper layer header and data
+ *   sum      - The pseudo-header sum, updated on success
+ *
+ * Returned Value:
+ *   True if 'sum' now covers the upper layer header and data.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_CHKSUM_COPY) && \
+    (defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6))
+static bool upperlayer_sndsum(FAR struct net_driver_s *dev, uint8_t proto,
+                              unsigned int iplen, uint16_t upperlen,
+                              FAR uint16_t *sum)
+{
+  unsigned int hdrlen;
+  uint16_t acc;
+
+  if ((proto != IP_PROTO_TCP && proto != IP_PROTO_UDP) ||
+      dev->d_sndsumlen == 0 || dev->d_sndsumlen != dev->d_sndlen ||
+      dev->d_sndsumlen > upperlen)
+    {
+      return false;
+    }
+
+  hdrlen = upperlen - dev->d_sndsumlen;
+  if ((hdrlen & 1) != 0 || iplen + hdrlen > dev->d_iob->io_len)
+    {
+      return false;
+    }
+
+  acc  = chksum(*sum, IPBUF(iplen), hdrlen);
+  acc += dev->d_sndsum;
+  if (acc < dev->d_sndsum)
+    {
+      acc++; /* carry */
+    }
+
+  *sum = acc;
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -141,12 +202,28 @@ uint16_t ipv4_upperlayer_payload_chksum(FAR struct net_driver_s *dev,
 
 uint16_t ipv4_upperlayer_chksum(FAR struct net_driver_s *dev, uint8_t proto)
 {
+#ifdef CONFIG_NET_CHKSUM_COPY
+  FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+  uint16_t iphdrlen;
+#endif
   uint16_t sum;
 
   /* Sum pseudo-header IP source and destination addresses. */
 
   sum = ipv4_upperlayer_header_chksum(dev, proto);
 
+#ifdef CONFIG_NET_CHKSUM_COPY
+  /* Reuse the sum of the application data taken while it was copied */
+
+  iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+  if (upperlayer_sndsum(dev, proto, iphdrlen,
+                        (((uint16_t)(ipv4->len[0]) << 8) + ipv4->len[1]) -
+                        iphdrlen, &sum))
+    {
+      return (sum == 0) ? 0xffff : HTONS(sum);
+    }
+#endif
+
   /* Sum IP payload data. */
 
   sum = ipv4_upperlayer_payload_chksum(dev, sum);
@@ -262,12 +339,26 @@ uint16_t ipv6_upperlayer_payload_chksum(FAR struct net_driver_s *dev,
 uint16_t ipv6_upperlayer_chksum(FAR struct net_driver_s *dev,
                                 uint8_t proto, unsigned int iplen)
 {
+#ifdef CONFIG_NET_CHKSUM_COPY
+  FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+#endif
   uint16_t sum;
 
   /* Sum IP source and destination addresses. */
 
   sum = ipv6_upperlayer_header_chksum(dev, proto, iplen);
 
+#ifdef CONFIG_NET_CHKSUM_COPY
+  /* Reuse the sum of the application data taken while it was copied */
+
+  if (upperlayer_sndsum(dev, proto, iplen,
+                        (((uint16_t)ipv6->len[0] << 8) + ipv6->len[1]) -
+                        (iplen - IPv6_HDRLEN), &sum))
+    {
+      return (sum == 0) ? 0xffff : HTONS(sum);
+    }
+#endif
+
   /* Sum IP payload data. */
 
   sum = ipv6_upperlayer_payload_chksum(dev, iplen, sum);
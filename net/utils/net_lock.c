@@ -33,6 +33,7 @@
 #include <debug.h>
 #include <time.h>
 
+#include <nuttx/atomic.h>
 #include <nuttx/irq.h>
 #include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
@@ -54,10 +55,47 @@
 
 static rmutex_t g_netlock = NXRMUTEX_INITIALIZER;
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATISTICS
+struct net_lockstats_s g_net_lockstats;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: net_rmutex_lock
+ *
+ * Description:
+ *   Take one of the network locks, accounting for contention if the lock
+ *   statistics are enabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATISTICS
+static int net_rmutex_lock(FAR rmutex_t *lock,
+                           FAR struct net_lockstat_s *stat)
+{
+  atomic_fetch_add(&stat->acquired, 1);
+
+  /* Try the uncontended case first so that blocking can be counted */
+
+  if (nxrmutex_trylock(lock) >= 0)
+    {
+      return OK;
+    }
+
+  atomic_fetch_add(&stat->contended, 1);
+  return nxrmutex_lock(lock);
+}
+#else
+#  define net_rmutex_lock(l, s) nxrmutex_lock(l)
+#endif
+
 /****************************************************************************
  * Name: _net_timedwait
  ****************************************************************************/
@@ -135,7 +173,7 @@ _net_timedwait(FAR sem_t *sem, bool interruptible, unsigned int timeout)
 
 int net_lock(void)
 {
-  return nxrmutex_lock(&g_netlock);
+  return net_rmutex_lock(&g_netlock, &g_net_lockstats.net);
 }
 
 /****************************************************************************
@@ -179,6 +217,48 @@ void net_unlock(void)
   nxrmutex_unlock(&g_netlock);
 }
 
+/****************************************************************************
+ * Name: conn_lock
+ *
+ * Description:
+ *   Take the lock of a socket connection.  The network lock may or may not
+ *   be held, but net_lock() must not be called with the connection lock
+ *   held.
+ *
+ * Input Parameters:
+ *   sconn - The common prologue of the connection to be locked
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CONN_LOCK
+void conn_lock(FAR struct socket_conn_s *sconn)
+{
+  net_rmutex_lock(&sconn->s_lock, &g_net_lockstats.conn);
+}
+
+/****************************************************************************
+ * Name: conn_unlock
+ *
+ * Description:
+ *   Release the lock of a socket connection.
+ *
+ * Input Parameters:
+ *   sconn - The common prologue of the connection to be unlocked
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void conn_unlock(FAR struct socket_conn_s *sconn)
+{
+  nxrmutex_unlock(&sconn->s_lock);
+}
+#endif /* CONFIG_NET_CONN_LOCK */
+
 /****************************************************************************
  * Name: net_breaklock
  *
@@ -89,6 +89,22 @@ enum tv2ds_remainder_e
   TV2DS_CEIL       /* Force to next larger full decisecond */
 };
 
+#ifdef CONFIG_NET_LOCK_STATISTICS
+/* Lock acquisition counts of one class of network locks */
+
+struct net_lockstat_s
+{
+  uint32_t acquired;       /* Number of times the lock was taken */
+  uint32_t contended;      /* Number of times the caller had to block */
+};
+
+struct net_lockstats_s
+{
+  struct net_lockstat_s net;  /* The global network lock */
+  struct net_lockstat_s conn; /* All connection locks */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -101,6 +117,12 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifdef CONFIG_NET_LOCK_STATISTICS
+/* Network lock contention statistics, see /proc/net/lock */
+
+EXTERN struct net_lockstats_s g_net_lockstats;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -441,6 +463,30 @@ uint16_t icmp_chksum_iob(FAR struct iob_s *iob);
 uint16_t icmpv6_chksum(FAR struct net_driver_s *dev, unsigned int iplen);
 #endif
 
+/****************************************************************************
+ * Name: net_flowhash
+ *
+ * Description:
+ *   Return a hash of the remote address and the ports of a flow.  It is
+ *   used to spread the flows over the sockets of a SO_REUSEPORT group, the
+ *   packets of one flow always get the same hash.
+ *
+ * Input Parameters:
+ *   domain - PF_INET or PF_INET6
+ *   raddr  - The remote address, an in_addr_t or a net_ipv6addr_t
+ *   rport  - The remote port
+ *   lport  - The local port
+ *
+ * Returned Value:
+ *   The hash of the flow.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+uint32_t net_flowhash(uint8_t domain, FAR const void *raddr,
+                      uint16_t rport, uint16_t lport);
+#endif
+
 /****************************************************************************
  * Name: cmsg_append
  *
@@ -83,6 +83,12 @@ static void addrenv_destroy(FAR void *arg)
 
   up_addrenv_destroy(&addrenv->addrenv);
 
+#ifdef CONFIG_ARCH_HAVE_ADDRENV_SHARED_TEXT
+  /* Release the address environment that owns the shared .text */
+
+  addrenv_drop(addrenv->text, false);
+#endif
+
   /* Then finally release the memory */
 
   kmm_free(addrenv);
@@ -81,6 +81,12 @@ void clock_timer(void);
 #  define clock_timer()
 #endif
 
+#ifdef CONFIG_CLOCK_VDSO
+void clock_vdso_update(void);
+#else
+#  define clock_vdso_update()
+#endif
+
 /****************************************************************************
  * perf_init
  ****************************************************************************/
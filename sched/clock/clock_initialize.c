@@ -399,5 +399,9 @@ void clock_timer(void)
   /* Increment the per-tick system counter */
 
   g_system_ticks++;
+
+  /* Publish the new time to the user-space clock_gettime() */
+
+  clock_vdso_update();
 }
 #endif
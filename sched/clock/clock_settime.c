@@ -82,6 +82,10 @@ void nxclock_settime(clockid_t clock_id, FAR const struct timespec *tp)
 
   leave_critical_section(flags);
 
+  /* Let the user-space clock_gettime() see the new base time */
+
+  clock_vdso_update();
+
   /* Setup the RTC (lo- or high-res) */
 
 #  ifdef CONFIG_RTC
@@ -0,0 +1,82 @@
+/****************************************************************************
+ * sched/clock/clock_vdso.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/userspace.h>
+
+#include "clock/clock.h"
+
+#ifdef CONFIG_CLOCK_VDSO
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_vdso_update
+ *
+ * Description:
+ *   Publish the current CLOCK_MONOTONIC and the base time of CLOCK_REALTIME
+ *   in the time page of the user blob.  Called from the timer interrupt
+ *   every tick and when the time of day is set.
+ *
+ ****************************************************************************/
+
+void clock_vdso_update(void)
+{
+  FAR struct clock_vdso_s *vdso = USERSPACE->us_vdso;
+  struct timespec ts;
+  irqstate_t flags;
+
+  if (vdso == NULL)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(NULL);
+
+  clock_systime_timespec(&ts);
+
+  vdso->seq++;
+  SP_DMB();
+
+  vdso->mono_sec  = ts.tv_sec;
+  vdso->mono_nsec = ts.tv_nsec;
+  vdso->base_sec  = g_basetime.tv_sec;
+  vdso->base_nsec = g_basetime.tv_nsec;
+
+  SP_DMB();
+  vdso->seq++;
+
+  spin_unlock_irqrestore(NULL, flags);
+}
+
+#endif /* CONFIG_CLOCK_VDSO */
@@ -29,12 +29,20 @@
 
 #include <nuttx/config.h>
 
+#include <strings.h>
+
 #include <nuttx/irq.h>
 #include <nuttx/list.h>
 #include <nuttx/semaphore.h>
 
 #include <nuttx/event.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NXEVENT_BUCKET_MASK ((1ul << CONFIG_SCHED_EVENTS_NBUCKETS) - 1)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -49,4 +57,64 @@ struct nxevent_wait_s
   sem_t                   sem;     /* Wait sem of current task */
 };
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxevent_buckets
+ *
+ * Description:
+ *   Return the set of the buckets that the events belong to.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_EVENTS_NBUCKETS > 0
+static inline_function uint16_t nxevent_buckets(nxevent_mask_t events)
+{
+  nxevent_mask_t buckets = 0;
+
+  while (events != 0)
+    {
+      buckets |= events & NXEVENT_BUCKET_MASK;
+      events >>= CONFIG_SCHED_EVENTS_NBUCKETS;
+    }
+
+  return (uint16_t)buckets;
+}
+#endif
+
+/****************************************************************************
+ * Name: nxevent_waitlist
+ *
+ * Description:
+ *   Return the list to wait on for the expected events: The list of their
+ *   bucket if they all belong to one, or else the list of the event object.
+ *   Called in the critical section.
+ *
+ ****************************************************************************/
+
+static inline_function FAR struct list_node *
+nxevent_waitlist(FAR nxevent_t *event, nxevent_mask_t expect)
+{
+#if CONFIG_SCHED_EVENTS_NBUCKETS > 0
+  uint16_t buckets = nxevent_buckets(expect);
+  int index;
+
+  if (buckets != 0 && (buckets & (buckets - 1)) == 0)
+    {
+      index = ffs(buckets) - 1;
+      if ((event->used & buckets) == 0)
+        {
+          list_initialize(&event->bucket[index]);
+          event->used |= buckets;
+        }
+
+      return &event->bucket[index];
+    }
+#endif
+
+  return &event->list;
+}
+
 #endif /* __SCHED_EVENT_EVENT_H */
@@ -50,4 +50,7 @@ void nxevent_init(FAR nxevent_t *event, nxevent_mask_t events)
 {
   event->events = events;
   list_initialize(&event->list);
+#if CONFIG_SCHED_EVENTS_NBUCKETS > 0
+  event->used = 0;
+#endif
 }
@@ -24,8 +24,11 @@
  * Included Files
  ****************************************************************************/
 
+#include <assert.h>
+
 #include <nuttx/sched.h>
 
+#include "sched/sched.h"
 #include "event.h"
 
 /****************************************************************************
@@ -49,6 +52,67 @@ static inline_function int nxevent_sem_post(FAR sem_t *sem)
   return 0;
 }
 
+/****************************************************************************
+ * Name: nxevent_wake
+ *
+ * Description:
+ *   Wake the tasks of one wait list whose waiting conditions are met.
+ *
+ * Input Parameters:
+ *   event   - Address of the event object
+ *   list    - The wait list
+ *   postall - Wake all the tasks, even after the events are cleared
+ *   clear   - The events to clear, updated
+ *   ret     - The result of the last wake up, updated
+ *
+ * Returned Value:
+ *   True if all the events are cleared and no more task may be woken.
+ *
+ ****************************************************************************/
+
+static bool nxevent_wake(FAR nxevent_t *event, FAR struct list_node *list,
+                         bool postall, FAR nxevent_mask_t *clear,
+                         FAR int *ret)
+{
+  FAR nxevent_wait_t *wait;
+  FAR nxevent_wait_t *tmp;
+  bool waitall;
+
+  list_for_every_entry_safe(list, wait, tmp, nxevent_wait_t, node)
+    {
+      waitall = ((wait->eflags & NXEVENT_WAIT_ALL) != 0);
+
+      if ((!waitall && ((wait->expect & event->events) != 0)) ||
+          (waitall && ((wait->expect & event->events) == wait->expect)))
+        {
+          list_delete(&wait->node);
+
+          *ret = nxevent_sem_post(&wait->sem);
+          if (*ret < 0)
+            {
+              continue;
+            }
+
+          if (!waitall)
+            {
+              wait->expect &= event->events;
+            }
+
+          if ((wait->eflags & NXEVENT_WAIT_NOCLEAR) == 0)
+            {
+              *clear |= wait->expect;
+            }
+
+          if (!postall && (event->events & ~*clear) == 0)
+            {
+              return true;
+            }
+        }
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -86,11 +150,14 @@ int nxevent_post(FAR nxevent_t *event, nxevent_mask_t events,
                  nxevent_flags_t eflags)
 {
   nxevent_mask_t clear = 0;
-  FAR nxevent_wait_t *wait;
-  FAR nxevent_wait_t *tmp;
   irqstate_t flags;
-  bool waitall;
+  bool waiters;
   bool postall;
+  bool done;
+#if CONFIG_SCHED_EVENTS_NBUCKETS > 0
+  uint16_t buckets;
+  int index;
+#endif
   int ret = 0;
 
   if (event == NULL)
@@ -98,18 +165,37 @@ int nxevent_post(FAR nxevent_t *event, nxevent_mask_t events,
       return -EINVAL;
     }
 
+  DEBUGASSERT((eflags & NXEVENT_POST_NOSCHED) == 0 ||
+              up_interrupt_context() || nxsched_islocked_tcb(this_task()));
+
+  if (events == 0)
+    {
+      events = ~0;
+    }
+
   flags = enter_critical_section();
 
   if ((eflags & NXEVENT_POST_SET) != 0)
     {
-      event->events = events ? events : ~0;
+      event->events = events;
     }
   else
     {
-      event->events |= events ? events : ~0;
+      event->events |= events;
     }
 
-  if (!list_is_empty(&event->list))
+  /* Only the waiters that expect some of the posted events may be woken:
+   * The other waiters are not checked unless they wait in the list of the
+   * event object.
+   */
+
+  waiters = !list_is_empty(&event->list);
+#if CONFIG_SCHED_EVENTS_NBUCKETS > 0
+  buckets = nxevent_buckets(events) & event->used;
+  waiters = waiters || buckets != 0;
+#endif
+
+  if (waiters)
     {
       postall = ((eflags & NXEVENT_POST_ALL) != 0);
 
@@ -117,47 +203,34 @@ int nxevent_post(FAR nxevent_t *event, nxevent_mask_t events,
        * priority task.
        */
 
-      sched_lock();
-
-      list_for_every_entry_safe(&event->list, wait, tmp,
-                                nxevent_wait_t, node)
+      if ((eflags & NXEVENT_POST_NOSCHED) == 0)
         {
-          waitall = ((wait->eflags & NXEVENT_WAIT_ALL) != 0);
+          sched_lock();
+        }
 
-          if ((!waitall && ((wait->expect & event->events) != 0)) ||
-              (waitall && ((wait->expect & event->events) == wait->expect)))
-            {
-              list_delete(&wait->node);
-
-              ret = nxevent_sem_post(&wait->sem);
-              if (ret < 0)
-                {
-                  continue;
-                }
-
-              if (!waitall)
-                {
-                  wait->expect &= event->events;
-                }
-
-              if ((wait->eflags & NXEVENT_WAIT_NOCLEAR) == 0)
-                {
-                  clear |= wait->expect;
-                }
-
-              if (!postall && (event->events & ~clear) == 0)
-                {
-                  break;
-                }
-            }
+      done = nxevent_wake(event, &event->list, postall, &clear, &ret);
+
+#if CONFIG_SCHED_EVENTS_NBUCKETS > 0
+      while (!done && buckets != 0)
+        {
+          index    = ffs(buckets) - 1;
+          buckets &= buckets - 1;
+          done     = nxevent_wake(event, &event->bucket[index], postall,
+                                  &clear, &ret);
         }
+#else
+      UNUSED(done);
+#endif
 
       if (clear)
         {
           event->events &= ~clear;
         }
 
-      sched_unlock();
+      if ((eflags & NXEVENT_POST_NOSCHED) == 0)
+        {
+          sched_unlock();
+        }
     }
 
   leave_critical_section(flags);
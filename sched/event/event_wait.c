@@ -121,7 +121,7 @@ nxevent_mask_t nxevent_tickwait(FAR nxevent_t *event, nxevent_mask_t events,
       wait.expect = events;
       wait.eflags = eflags;
 
-      list_add_tail(&event->list, &wait.node);
+      list_add_tail(nxevent_waitlist(event, events), &wait.node);
 
       /* Wait for the event */
 
@@ -0,0 +1,98 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __SCHED_HRTIMER_HRTIMER_H
+#define __SCHED_HRTIMER_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/tree.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/hrtimer.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+RB_HEAD(hrtimer_tree_s, hrtimer_s);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The g_hrtimer_tree is a red-black tree of the active high resolution
+ * timers ordered by expiration time.  Timers with the same expiration time
+ * are ordered by address.  It is protected by the critical section.
+ */
+
+extern struct hrtimer_tree_s g_hrtimer_tree;
+
+/* True while hrtimer_process() runs the expiration functions, the alarm is
+ * started once afterwards instead of on every change of the tree.
+ */
+
+extern bool g_hrtimer_nested;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+RB_PROTOTYPE(hrtimer_tree_s, hrtimer_s, node, hrtimer_compare);
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_reassess
+ *
+ * Description:
+ *   Start the alarm of the architecture for the first active timer, or
+ *   stop it if there is none.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+static inline_function void hrtimer_reassess(void)
+{
+  FAR struct hrtimer_s *first;
+
+  if (!g_hrtimer_nested)
+    {
+      first = RB_MIN(hrtimer_tree_s, &g_hrtimer_tree);
+      up_hrtimer_start(first != NULL ? first->expired : UINT64_MAX);
+    }
+}
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __SCHED_HRTIMER_HRTIMER_H */
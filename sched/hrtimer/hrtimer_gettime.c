@@ -0,0 +1,120 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer_gettime.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/hrtimer.h>
+
+#include "hrtimer/hrtimer.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_curtime
+ *
+ * Description:
+ *   Return the current time of CLOCK_MONOTONIC in nanoseconds, the time
+ *   base of the high resolution timers.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_curtime(void)
+{
+  return up_hrtimer_gettime();
+}
+
+/****************************************************************************
+ * Name: hrtimer_abstime2nsec
+ *
+ * Description:
+ *   Convert an absolute time of a clock to the time base of the high
+ *   resolution timers.  A time in the past is converted to the current
+ *   time.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_abstime2nsec(clockid_t clockid,
+                              FAR const struct timespec *abstime)
+{
+  struct timespec reltime;
+  irqstate_t flags;
+  uint64_t nsec;
+
+  /* CLOCK_MONOTONIC is the time base itself, only with less resolution */
+
+  if (clockid == CLOCK_MONOTONIC)
+    {
+      return clock_time2nsec(abstime);
+    }
+
+  /* The clock and the time base must not change during the conversion */
+
+  flags = enter_critical_section();
+  nxclock_gettime(clockid, &reltime);
+  nsec = hrtimer_curtime();
+  leave_critical_section(flags);
+
+  clock_timespec_subtract(abstime, &reltime, &reltime);
+  return nsec + clock_time2nsec(&reltime);
+}
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   This function returns the time remaining before the specified high
+ *   resolution timer expires.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer
+ *
+ * Returned Value:
+ *   The time in nanoseconds remaining until the timer expires.  Zero means
+ *   either that the timer is not active or that it has already expired.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(FAR struct hrtimer_s *hrtimer)
+{
+  irqstate_t flags;
+  uint64_t expired = 0;
+  uint64_t nsec;
+
+  flags = enter_critical_section();
+  if (hrtimer != NULL && HRTIMER_ISACTIVE(hrtimer))
+    {
+      expired = hrtimer->expired;
+    }
+
+  leave_critical_section(flags);
+
+  nsec = hrtimer_curtime();
+  return expired > nsec ? expired - nsec : 0;
+}
@@ -0,0 +1,89 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer_process.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/hrtimer.h>
+#include <nuttx/sched_note.h>
+
+#include "hrtimer/hrtimer.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_process
+ *
+ * Description:
+ *   Run the expiration functions of the high resolution timers that have
+ *   expired and start the alarm of the next one.  Called by the
+ *   architecture specific logic when the alarm started with
+ *   up_hrtimer_start() expires.
+ *
+ * Input Parameters:
+ *   nsec - The current time in nanoseconds
+ *
+ * Assumptions:
+ *   Called from the interrupt level.
+ *
+ ****************************************************************************/
+
+void hrtimer_process(uint64_t nsec)
+{
+  FAR struct hrtimer_s *hrtimer;
+  irqstate_t flags;
+  wdentry_t func;
+  wdparm_t arg;
+
+  flags = enter_critical_section();
+
+  g_hrtimer_nested = true;
+
+  while ((hrtimer = RB_MIN(hrtimer_tree_s, &g_hrtimer_tree)) != NULL &&
+         hrtimer->expired <= nsec)
+    {
+      /* Remove the timer from the tree and mark it inactive before its
+       * function runs, so that the function may restart it.
+       */
+
+      RB_REMOVE(hrtimer_tree_s, &g_hrtimer_tree, hrtimer);
+
+      func          = hrtimer->func;
+      arg           = hrtimer->arg;
+      hrtimer->func = NULL;
+
+      sched_note_wdog(NOTE_WDOG_ENTER, func, (FAR void *)arg);
+      func(arg);
+      sched_note_wdog(NOTE_WDOG_LEAVE, func, (FAR void *)arg);
+    }
+
+  g_hrtimer_nested = false;
+
+  hrtimer_reassess();
+  leave_critical_section(flags);
+}
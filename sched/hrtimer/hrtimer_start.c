@@ -0,0 +1,149 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer_start.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/hrtimer.h>
+
+#include "hrtimer/hrtimer.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+struct hrtimer_tree_s g_hrtimer_tree = RB_INITIALIZER(&g_hrtimer_tree);
+bool g_hrtimer_nested;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_compare
+ ****************************************************************************/
+
+static int hrtimer_compare(FAR struct hrtimer_s *a, FAR struct hrtimer_s *b)
+{
+  if (a->expired != b->expired)
+    {
+      return a->expired < b->expired ? -1 : 1;
+    }
+
+  return a < b ? -1 : a > b;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+RB_GENERATE(hrtimer_tree_s, hrtimer_s, node, hrtimer_compare);
+
+/****************************************************************************
+ * Name: hrtimer_start_absnsec
+ *
+ * Description:
+ *   This function is the same as hrtimer_start(), except that the timer
+ *   expires at an absolute time in nanoseconds of CLOCK_MONOTONIC.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer
+ *   nsec    - Absolute expiration time in nanoseconds
+ *   func    - Function to call on timeout
+ *   arg     - Parameter to pass to func
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_start_absnsec(FAR struct hrtimer_s *hrtimer, uint64_t nsec,
+                          wdentry_t func, wdparm_t arg)
+{
+  irqstate_t flags;
+  bool reassess = false;
+
+  if (hrtimer == NULL || func == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  if (HRTIMER_ISACTIVE(hrtimer))
+    {
+      reassess = RB_MIN(hrtimer_tree_s, &g_hrtimer_tree) == hrtimer;
+      RB_REMOVE(hrtimer_tree_s, &g_hrtimer_tree, hrtimer);
+    }
+
+  hrtimer->expired = nsec;
+  hrtimer->func    = func;
+  hrtimer->arg     = arg;
+
+  RB_INSERT(hrtimer_tree_s, &g_hrtimer_tree, hrtimer);
+
+  if (reassess || RB_MIN(hrtimer_tree_s, &g_hrtimer_tree) == hrtimer)
+    {
+      hrtimer_reassess();
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   This function adds a high resolution timer to the active timer tree.
+ *   The specified function at 'func' will be called from the interrupt
+ *   level after the specified number of nanoseconds has elapsed.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer
+ *   delay   - Delay in nanoseconds
+ *   func    - Function to call on timeout
+ *   arg     - Parameter to pass to func
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *hrtimer, uint64_t delay,
+                  wdentry_t func, wdparm_t arg)
+{
+  uint64_t nsec = hrtimer_curtime();
+
+  /* Saturate instead of wrapping around for delays that are forever */
+
+  nsec = delay < UINT64_MAX - nsec ? nsec + delay : UINT64_MAX - 1;
+  return hrtimer_start_absnsec(hrtimer, nsec, func, arg);
+}
@@ -322,6 +322,12 @@ static inline void nx_start_application(void)
   board_late_initialize();
 #endif
 
+#ifdef CONFIG_INITCALL_ASYNC
+  /* The application expects all the drivers to be registered */
+
+  nx_initcall_wait_all();
+#endif
+
 #ifndef CONFIG_BOARD_CRASHDUMP_NONE
   coredump_initialize();
 #endif
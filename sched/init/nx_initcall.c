@@ -0,0 +1,236 @@
+/****************************************************************************
+ * sched/init/nx_initcall.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <syslog.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_INITCALL_ASYNC
+/* The calls started by nx_initcall_async() and not waited for by
+ * nx_initcall_wait_all() yet.
+ */
+
+static FAR struct initcall_s *g_initcalls;
+static spinlock_t g_initcall_lock = SP_UNLOCKED;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_INITCALL_ASYNC
+/****************************************************************************
+ * Name: nx_initcall_run
+ ****************************************************************************/
+
+static void nx_initcall_run(FAR struct initcall_s *call)
+{
+  FAR struct initcall_s *const *dep;
+#ifdef CONFIG_INITCALL_DEBUG
+  clock_t start;
+#endif
+
+  for (dep = call->deps; dep != NULL && *dep != NULL; dep++)
+    {
+      nx_initcall_wait(*dep);
+    }
+
+#ifdef CONFIG_INITCALL_DEBUG
+  start = perf_gettime();
+#endif
+
+  call->result = call->func(call->arg);
+
+#ifdef CONFIG_INITCALL_DEBUG
+  nx_initcall_report(call->name, start);
+#endif
+
+  nxsem_post(&call->done);
+}
+
+/****************************************************************************
+ * Name: nx_initcall_thread
+ ****************************************************************************/
+
+static int nx_initcall_thread(int argc, FAR char **argv)
+{
+  nx_initcall_run((FAR struct initcall_s *)
+                  ((uintptr_t)strtoul(argv[1], NULL, 16)));
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_INITCALL_DEBUG
+/****************************************************************************
+ * Name: nx_initcall_report
+ *
+ * Description:
+ *   Report the time spent in an initialization call, see INITCALL().
+ *
+ * Input Parameters:
+ *   name  - The name of the call
+ *   start - The perf_gettime() value when the call started
+ *
+ ****************************************************************************/
+
+void nx_initcall_report(FAR const char *name, clock_t start)
+{
+  struct timespec ts;
+
+  perf_convert(perf_gettime() - start, &ts);
+  syslog(LOG_INFO, "initcall %s took %" PRIu32 " us\n", name,
+         (uint32_t)(ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC));
+}
+#endif
+
+#ifdef CONFIG_INITCALL_ASYNC
+/****************************************************************************
+ * Name: nx_initcall_async
+ *
+ * Description:
+ *   Run an initialization call in a kernel thread, in parallel with the
+ *   rest of the boot.  The thread waits for the calls in deps first.
+ *
+ * Input Parameters:
+ *   call - The call to run, initialized by this function
+ *   name - The name of the call
+ *   func - The initialization function
+ *   arg  - Its argument
+ *   deps - NULL terminated calls that must complete first, or NULL
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if the thread could not be
+ *   started.  The call then ran synchronously.
+ *
+ ****************************************************************************/
+
+int nx_initcall_async(FAR struct initcall_s *call, FAR const char *name,
+                      CODE int (*func)(FAR void *arg), FAR void *arg,
+                      FAR struct initcall_s *const *deps)
+{
+  FAR char *argv[2];
+  irqstate_t flags;
+  char arg1[32];
+  int ret;
+
+  call->deps   = deps;
+  call->name   = name;
+  call->func   = func;
+  call->arg    = arg;
+  call->result = 0;
+  nxsem_init(&call->done, 0, 0);
+
+  flags = spin_lock_irqsave(&g_initcall_lock);
+  call->flink = g_initcalls;
+  g_initcalls = call;
+  spin_unlock_irqrestore(&g_initcall_lock, flags);
+
+  snprintf(arg1, sizeof(arg1), "%p", call);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  ret = kthread_create(name, CONFIG_INITCALL_ASYNC_PRIORITY,
+                       CONFIG_INITCALL_ASYNC_STACKSIZE,
+                       nx_initcall_thread, argv);
+  if (ret < 0)
+    {
+      nx_initcall_run(call);
+      return ret;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nx_initcall_wait
+ *
+ * Description:
+ *   Wait for an initialization call started by nx_initcall_async().
+ *
+ * Returned Value:
+ *   The value returned by the initialization function.
+ *
+ ****************************************************************************/
+
+int nx_initcall_wait(FAR struct initcall_s *call)
+{
+  /* Post the semaphore again for the other waiters of the call */
+
+  nxsem_wait_uninterruptible(&call->done);
+  nxsem_post(&call->done);
+  return call->result;
+}
+
+/****************************************************************************
+ * Name: nx_initcall_wait_all
+ *
+ * Description:
+ *   Wait for all the initialization calls started by nx_initcall_async().
+ *
+ ****************************************************************************/
+
+void nx_initcall_wait_all(void)
+{
+  FAR struct initcall_s *call;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&g_initcall_lock);
+      call  = g_initcalls;
+      if (call != NULL)
+        {
+          g_initcalls = call->flink;
+        }
+
+      spin_unlock_irqrestore(&g_initcall_lock, flags);
+
+      if (call == NULL)
+        {
+          break;
+        }
+
+      nx_initcall_wait(call);
+    }
+}
+#endif
@@ -87,6 +87,12 @@ void nx_idle_trampoline(void)
 
   for (; ; )
     {
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+      /* Pull work from the run queues of busy CPUs */
+
+      nxsched_idle_pull();
+
+#endif
       /* Perform any processor-specific idle state operations */
 
       up_idle();
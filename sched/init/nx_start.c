@@ -94,6 +94,16 @@
 
 dq_queue_t g_readytorun;
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+/* g_readytorun_tail[] holds the last task of each priority level in the
+ * g_readytorun list, g_readytorun_bitmap[] has one bit set for each
+ * priority level having at least one task in the list.
+ */
+
+FAR struct tcb_s *g_readytorun_tail[SCHED_PRIORITY_MAX + 1];
+unsigned long g_readytorun_bitmap[RTR_BITMAP_NWORDS];
+#endif
+
 /* In order to support SMP, the function of the g_readytorun list changes,
  * The g_readytorun is still used but in the SMP case it will contain only:
  *
@@ -404,6 +414,12 @@ static void idle_task_initialize(void)
       tcb->flags = TCB_FLAG_TTYPE_KERNEL;
 #endif
 
+#ifdef CONFIG_SCHED_TIMER_SLACK
+      /* All tasks inherit the timer slack from their parent */
+
+      tcb->timerslack = USEC2TICK(CONFIG_SCHED_TIMER_SLACK_DEFAULT);
+#endif
+
 #if CONFIG_TASK_NAME_SIZE > 0
       /* Set the IDLE task name */
 
@@ -424,7 +440,12 @@ static void idle_task_initialize(void)
 #else
       tasklist = TLIST_HEAD(tcb);
 #endif
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+      UNUSED(tasklist);
+      nxsched_rtr_add(tcb);
+#else
       dq_addfirst((FAR dq_entry_t *)tcb, tasklist);
+#endif
 
       /* Mark the idle task as the running task */
 
@@ -551,7 +572,7 @@ void nx_start(void)
    * because many subsystems depend upon fully functional semaphores.
    */
 
-  nxsem_initialize();
+  INITCALL(nxsem_initialize());
 
 #if defined(MM_KERNEL_USRHEAP_INIT) || defined(CONFIG_MM_KERNEL_HEAP) || \
     defined(CONFIG_MM_PGALLOC)
@@ -594,19 +615,19 @@ void nx_start(void)
 #ifdef CONFIG_MM_KMAP
   /* Initialize the kernel dynamic mapping module */
 
-  kmm_map_initialize();
+  INITCALL(kmm_map_initialize());
 #endif
 
 #ifdef CONFIG_ARCH_HAVE_EXTRA_HEAPS
   /* Initialize any extra heap. */
 
-  up_extraheaps_init();
+  INITCALL(up_extraheaps_init());
 #endif
 
 #ifdef CONFIG_MM_IOB
   /* Initialize IO buffering */
 
-  iob_initialize();
+  INITCALL(iob_initialize());
 #endif
 
   /* Initialize the logic that determine unique process IDs. */
@@ -624,7 +645,7 @@ void nx_start(void)
 
   /* IDLE Group Initialization **********************************************/
 
-  idle_group_initialize();
+  INITCALL(idle_group_initialize());
 
   g_lastpid = CONFIG_SMP_NCPUS - 1;
 
@@ -634,48 +655,48 @@ void nx_start(void)
 
   /* Initialize tasking data structures */
 
-  task_initialize();
+  INITCALL(task_initialize());
 
   /* Initialize the instrument function */
 
-  instrument_initialize();
+  INITCALL(instrument_initialize());
 
   /* Initialize the file system (needed to support device drivers) */
 
-  fs_initialize();
+  INITCALL(fs_initialize());
 
   /* Initialize the interrupt handling subsystem (if included) */
 
-  irq_initialize();
+  INITCALL(irq_initialize());
 
   /* Initialize the POSIX timer facility (if included in the link) */
 
-  clock_initialize();
+  INITCALL(clock_initialize());
 
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
-  timer_initialize();
+  INITCALL(timer_initialize());
 #endif
 
   /* Initialize the signal facility (if in link) */
 
-  nxsig_initialize();
+  INITCALL(nxsig_initialize());
 
 #if !defined(CONFIG_DISABLE_MQUEUE) || !defined(CONFIG_DISABLE_MQUEUE_SYSV)
   /* Initialize the named message queue facility (if in link) */
 
-  nxmq_initialize();
+  INITCALL(nxmq_initialize());
 #endif
 
 #ifdef CONFIG_NET
   /* Initialize the networking system */
 
-  net_initialize();
+  INITCALL(net_initialize());
 #endif
 
 #ifndef CONFIG_BINFMT_DISABLE
   /* Initialize the binfmt system */
 
-  binfmt_initialize();
+  INITCALL(binfmt_initialize());
 #endif
 
   /* Initialize Hardware Facilities *****************************************/
@@ -686,11 +707,11 @@ void nx_start(void)
    * that are different for each  processor and hardware platform.
    */
 
-  up_initialize();
+  INITCALL(up_initialize());
 
   /* Initialize common drivers */
 
-  drivers_initialize();
+  INITCALL(drivers_initialize());
 
 #ifdef CONFIG_BOARD_EARLY_INITIALIZE
   /* Call the board-specific up_initialize() extension to support
@@ -698,7 +719,7 @@ void nx_start(void)
    * that cannot wait until board_late_initialize.
    */
 
-  board_early_initialize();
+  INITCALL(board_early_initialize());
 #endif
 
   /* Hardware resources are now available */
@@ -773,6 +794,12 @@ void nx_start(void)
 #ifndef CONFIG_DISABLE_IDLE_LOOP
   for (; ; )
     {
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+      /* Pull work from the run queues of busy CPUs */
+
+      nxsched_idle_pull();
+
+#endif
       /* Perform any processor-specific idle state operations */
 
       up_idle();
@@ -34,6 +34,10 @@
 extern struct instrument_s g_stack_monitor;
 #endif
 
+#ifdef CONFIG_SCHED_LATENCY_MONITOR
+extern struct instrument_s g_latency_monitor;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -57,4 +61,8 @@ void instrument_initialize(void)
 #if CONFIG_SCHED_STACK_RECORD > 0
   instrument_register(&g_stack_monitor);
 #endif
+
+#ifdef CONFIG_SCHED_LATENCY_MONITOR
+  instrument_register(&g_latency_monitor);
+#endif
 }
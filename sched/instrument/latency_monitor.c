@@ -0,0 +1,568 @@
+/****************************************************************************
+ * sched/instrument/latency_monitor.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/instrument.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bucket n counts the calls that took [2^(n-1), 2^n) perf ticks, bucket 0
+ * those that took less than one tick.  The last bucket takes everything
+ * longer.
+ */
+
+#define LATENCY_NBUCKETS   32
+
+/* Output format:
+ *
+ *   FILTER: 0xXXXXXXXX 0xXXXXXXXX
+ *   FUNCTION           CPU          NS      COUNT
+ *   0xXXXXXXXX         DDD  DDDDDDDDDD DDDDDDDDDD
+ *   DROPPED: DDDDDDDDDD
+ *
+ * NS is the upper bound of the bucket in nanoseconds.
+ */
+
+#define FILTER_FMT         "FILTER: %p %p\n"
+#define HDR_FMT            "FUNCTION           CPU          NS      COUNT\n"
+#define BUCKET_FMT         "%-16p %5d %11llu %10lu\n"
+#define DROPPED_FMT        "DROPPED: %lu\n"
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic (plus a couple of
+ * bytes).
+ */
+
+#define LATENCY_LINELEN    64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The latency histograms of one instrumented function */
+
+struct latency_func_s
+{
+  FAR void *fn;
+  uint32_t hist[CONFIG_SMP_NCPUS][LATENCY_NBUCKETS];
+};
+
+/* This structure describes one open "file" */
+
+struct latency_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  char line[LATENCY_LINELEN];   /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void latency_monitor_enter(FAR void *this_fn, FAR void *call_site,
+                                  FAR void *arg) noinstrument_function;
+static void latency_monitor_leave(FAR void *this_fn, FAR void *call_site,
+                                  FAR void *arg) noinstrument_function;
+
+/* File system methods */
+
+static int     latency_open(FAR struct file *filep,
+                            FAR const char *relpath, int oflags,
+                            mode_t mode);
+static int     latency_close(FAR struct file *filep);
+static ssize_t latency_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+static ssize_t latency_write(FAR struct file *filep,
+                             FAR const char *buffer, size_t buflen);
+static int     latency_dup(FAR const struct file *oldp,
+                           FAR struct file *newp);
+static int     latency_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The functions seen so far in an open addressing hash table.  A slot is
+ * claimed under g_latency_lock and is never given back, so the hooks look
+ * up the functions already known without any lock.
+ */
+
+static struct latency_func_s
+g_latency_funcs[CONFIG_SCHED_LATENCY_MONITOR_NFUNCS];
+static spinlock_t g_latency_lock = SP_UNLOCKED;
+static uint32_t g_latency_dropped;
+
+/* Only the functions in [g_latency_lowpc, g_latency_highpc) are timed */
+
+static uintptr_t g_latency_lowpc;
+static uintptr_t g_latency_highpc = UINTPTR_MAX;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+struct instrument_s g_latency_monitor =
+{
+  .enter = latency_monitor_enter,
+  .leave = latency_monitor_leave
+};
+
+/* See fs_procfs.c -- this structure is explicitly extern'ed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_profile_operations =
+{
+  latency_open,   /* open */
+  latency_close,  /* close */
+  latency_read,   /* read */
+  latency_write,  /* write */
+  NULL,           /* poll */
+
+  latency_dup,    /* dup */
+
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+
+  latency_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: latency_monitor_record
+ *
+ * Description:
+ *   Account one call of 'fn' that took 'elapsed' perf ticks to the
+ *   histogram of the current CPU.
+ *
+ ****************************************************************************/
+
+static void noinstrument_function
+latency_monitor_record(FAR void *fn, clock_t elapsed)
+{
+  FAR struct latency_func_s *func;
+  irqstate_t flags;
+  size_t hash;
+  size_t i;
+  int bucket;
+
+  bucket = flsll((long long)elapsed);
+  if (bucket >= LATENCY_NBUCKETS || bucket < 0)
+    {
+      bucket = LATENCY_NBUCKETS - 1;
+    }
+
+  hash = ((uintptr_t)fn >> 2) % CONFIG_SCHED_LATENCY_MONITOR_NFUNCS;
+  for (i = 0; i < CONFIG_SCHED_LATENCY_MONITOR_NFUNCS; i++)
+    {
+      func = &g_latency_funcs[hash];
+      if (func->fn == fn)
+        {
+          func->hist[this_cpu()][bucket]++;
+          return;
+        }
+
+      if (func->fn == NULL)
+        {
+          /* Claim the slot unless another CPU took it meanwhile */
+
+          flags = spin_lock_irqsave(&g_latency_lock);
+          if (func->fn == NULL)
+            {
+              func->fn = fn;
+            }
+
+          spin_unlock_irqrestore(&g_latency_lock, flags);
+
+          if (func->fn == fn)
+            {
+              func->hist[this_cpu()][bucket]++;
+              return;
+            }
+        }
+
+      hash = (hash + 1) % CONFIG_SCHED_LATENCY_MONITOR_NFUNCS;
+    }
+
+  g_latency_dropped++;
+}
+
+/****************************************************************************
+ * Name: latency_monitor_enter
+ *
+ * Description:
+ *   Push the time a function is entered.  A zero time is pushed for the
+ *   functions that are filtered out and for the functions called by the
+ *   monitor itself, which is recognized by the busy flag of the task.
+ *
+ ****************************************************************************/
+
+static void latency_monitor_enter(FAR void *this_fn, FAR void *call_site,
+                                  FAR void *arg)
+{
+  FAR struct tcb_s *tcb = running_task();
+  FAR clock_t *start;
+
+  if (tcb == NULL)
+    {
+      return;
+    }
+
+  if (tcb->latency_level++ >= CONFIG_SCHED_LATENCY_MONITOR_DEPTH)
+    {
+      return;
+    }
+
+  start  = &tcb->latency_time[tcb->latency_level - 1];
+  *start = 0;
+
+  if (tcb->latency_busy || (uintptr_t)this_fn < g_latency_lowpc ||
+      (uintptr_t)this_fn >= g_latency_highpc)
+    {
+      return;
+    }
+
+  tcb->latency_busy = true;
+  *start = perf_gettime();
+  tcb->latency_busy = false;
+}
+
+/****************************************************************************
+ * Name: latency_monitor_leave
+ ****************************************************************************/
+
+static void latency_monitor_leave(FAR void *this_fn, FAR void *call_site,
+                                  FAR void *arg)
+{
+  FAR struct tcb_s *tcb = running_task();
+  clock_t start;
+
+  if (tcb == NULL || tcb->latency_level == 0)
+    {
+      return;
+    }
+
+  if (--tcb->latency_level >= CONFIG_SCHED_LATENCY_MONITOR_DEPTH)
+    {
+      return;
+    }
+
+  start = tcb->latency_time[tcb->latency_level];
+  if (start == 0 || tcb->latency_busy)
+    {
+      return;
+    }
+
+  tcb->latency_busy = true;
+  latency_monitor_record(this_fn, perf_gettime() - start);
+  tcb->latency_busy = false;
+}
+
+/****************************************************************************
+ * Name: latency_open
+ ****************************************************************************/
+
+static int latency_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct latency_file_s *lfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  lfile = kmm_zalloc(sizeof(struct latency_file_s));
+  if (!lfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)lfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: latency_close
+ ****************************************************************************/
+
+static int latency_close(FAR struct file *filep)
+{
+  FAR struct latency_file_s *lfile;
+
+  /* Recover our private data from the struct file instance */
+
+  lfile = (FAR struct latency_file_s *)filep->f_priv;
+  DEBUGASSERT(lfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(lfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: latency_read
+ ****************************************************************************/
+
+static ssize_t latency_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct latency_file_s *lfile;
+  FAR struct latency_func_s *func;
+  struct timespec ts;
+  unsigned long long ns;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int cpu;
+  int i;
+  int j;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  lfile = (FAR struct latency_file_s *)filep->f_priv;
+  DEBUGASSERT(lfile);
+
+  offset = filep->f_pos;
+
+  /* The first lines to output are the filter and the header */
+
+  linesize  = snprintf(lfile->line, LATENCY_LINELEN, FILTER_FMT,
+                       (FAR void *)g_latency_lowpc,
+                       (FAR void *)g_latency_highpc);
+  copysize  = procfs_memcpy(lfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  linesize   = snprintf(lfile->line, LATENCY_LINELEN, HDR_FMT);
+  copysize   = procfs_memcpy(lfile->line, linesize, buffer + totalsize,
+                             buflen - totalsize, &offset);
+  totalsize += copysize;
+
+  /* Then one line for each non-empty bucket of each function and CPU */
+
+  for (i = 0; i < CONFIG_SCHED_LATENCY_MONITOR_NFUNCS && totalsize < buflen;
+       i++)
+    {
+      func = &g_latency_funcs[i];
+      if (func->fn == NULL)
+        {
+          continue;
+        }
+
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS && totalsize < buflen; cpu++)
+        {
+          for (j = 0; j < LATENCY_NBUCKETS && totalsize < buflen; j++)
+            {
+              if (func->hist[cpu][j] == 0)
+                {
+                  continue;
+                }
+
+              perf_convert((clock_t)1 << j, &ts);
+              ns = (unsigned long long)ts.tv_sec * NSEC_PER_SEC +
+                   ts.tv_nsec;
+
+              linesize   = snprintf(lfile->line, LATENCY_LINELEN,
+                                    BUCKET_FMT, func->fn, cpu, ns,
+                                    (unsigned long)func->hist[cpu][j]);
+              copysize   = procfs_memcpy(lfile->line, linesize,
+                                         buffer + totalsize,
+                                         buflen - totalsize, &offset);
+              totalsize += copysize;
+            }
+        }
+    }
+
+  /* Finally the number of calls of functions that did not fit the table */
+
+  if (totalsize < buflen)
+    {
+      linesize   = snprintf(lfile->line, LATENCY_LINELEN, DROPPED_FMT,
+                            (unsigned long)g_latency_dropped);
+      copysize   = procfs_memcpy(lfile->line, linesize, buffer + totalsize,
+                                 buflen - totalsize, &offset);
+      totalsize += copysize;
+    }
+
+  /* Update the file position */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: latency_write
+ *
+ * Description:
+ *   "filter <lowpc> <highpc>" only times the functions in [lowpc, highpc),
+ *   "reset" clears the histograms.
+ *
+ ****************************************************************************/
+
+static ssize_t latency_write(FAR struct file *filep,
+                             FAR const char *buffer, size_t buflen)
+{
+  char cmd[LATENCY_LINELEN];
+  FAR char *endptr;
+  uintptr_t lowpc;
+  uintptr_t highpc;
+  int cpu;
+  int i;
+
+  if (buflen == 0 || buflen >= sizeof(cmd))
+    {
+      return -EINVAL;
+    }
+
+  memcpy(cmd, buffer, buflen);
+  cmd[buflen] = '\0';
+
+  if (strncmp(cmd, "reset", 5) == 0)
+    {
+      for (i = 0; i < CONFIG_SCHED_LATENCY_MONITOR_NFUNCS; i++)
+        {
+          for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+            {
+              memset(g_latency_funcs[i].hist[cpu], 0,
+                     sizeof(g_latency_funcs[i].hist[cpu]));
+            }
+        }
+
+      g_latency_dropped = 0;
+      return buflen;
+    }
+
+  if (strncmp(cmd, "filter", 6) != 0)
+    {
+      return -EINVAL;
+    }
+
+  lowpc  = strtoul(cmd + 6, &endptr, 0);
+  highpc = strtoul(endptr, &endptr, 0);
+  if (highpc <= lowpc)
+    {
+      return -EINVAL;
+    }
+
+  /* A call that is in progress is still accounted when it returns, only
+   * the calls that start afterwards are filtered differently.
+   */
+
+  g_latency_lowpc  = lowpc;
+  g_latency_highpc = highpc;
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: latency_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int latency_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct latency_file_s *oldattr;
+  FAR struct latency_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct latency_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct latency_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct latency_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: latency_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int latency_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "profile" is the name for a read/write file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
@@ -83,6 +83,17 @@ typedef CODE int (*irq_foreach_t)(int irq, FAR struct irq_info_s *info,
                                   FAR void *arg);
 #endif
 
+#ifdef CONFIG_SCHED_CSECTION_CALLERS
+/* This describes one call site that took the global IRQ lock */
+
+struct csection_caller_s
+{
+  FAR void *caller;   /* Return address of enter_critical_section() */
+  uint32_t count;     /* Number of times the lock was taken */
+  uint32_t contended; /* Number of times another CPU held the lock */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -131,6 +142,14 @@ extern volatile cpu_set_t g_cpu_irqset;
 extern volatile uint8_t g_cpu_nestcount[CONFIG_SMP_NCPUS];
 #endif
 
+#ifdef CONFIG_SCHED_CSECTION_CALLERS
+/* The call sites that took the global IRQ lock */
+
+extern struct csection_caller_s
+g_csection_callers[CONFIG_SCHED_CSECTION_NCALLERS];
+extern uint32_t g_csection_dropped;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -194,6 +213,20 @@ int irq_unexpected_isr(int irq, FAR void *context, FAR void *arg);
 int irq_foreach(irq_foreach_t callback, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: irq_thread_stats
+ *
+ * Description:
+ *   Take a snapshot of the threaded handler counts of an IRQ, by index, and
+ *   reset them.  Returns false if the IRQ is not threaded.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+bool irq_thread_stats(int ndx, FAR uint32_t *nwakeups,
+                      FAR uint32_t *nevents, FAR clock_t *time);
+#endif
+
 #ifdef CONFIG_IRQCHAIN
 void irqchain_initialize(void);
 bool is_irqchain(int ndx, xcpt_t isr);
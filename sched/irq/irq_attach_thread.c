@@ -26,11 +26,15 @@
 
 #include <nuttx/config.h>
 
+#include <assert.h>
 #include <errno.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
 #include <nuttx/kthread.h>
 
 #include "irq/irq.h"
@@ -44,20 +48,43 @@
  * This type provided all of the information necessary to irq_dispatch to
  * transfer control to interrupt handlers after the occurrence of an
  * interrupt.
+ *
+ * Several IRQs may share one handler thread.  The thread, and the
+ * semaphore waking it up, belong to the IRQ that created it, the owner,
+ * the other IRQs served by the thread are linked behind the owner.
  */
 
 struct irq_thread_info_s
 {
   xcpt_t handler;     /* Address of the interrupt handler */
+  xcpt_t isrthread;   /* Address of the threaded interrupt handler */
   FAR void *arg;      /* The argument provided to the interrupt handler. */
-  FAR sem_t *sem;     /* irq sem used to notify irq thread */
+  int irq;            /* Irq id */
+  atomic_int pending; /* Events not yet served by the thread */
+
+  FAR struct irq_thread_info_s *owner; /* IRQ owning the thread */
+  FAR struct irq_thread_info_s *flink; /* Next IRQ served by the thread */
+
+  sem_t sem;          /* irq sem used to notify irq thread (owner only) */
+  pid_t pid;          /* The handler thread (owner only) */
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+  uint32_t nwakeups;  /* Number of times the thread served this IRQ */
+  uint32_t nevents;   /* Number of events served by the thread */
+  clock_t time;       /* Maximum execution time of the thread handler */
+#endif
 };
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static pid_t g_irq_thread_pid[NR_IRQS];
+#ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE
+static struct irq_thread_info_s
+g_irq_thread_vector[CONFIG_ARCH_NUSER_INTERRUPTS];
+#else
+static struct irq_thread_info_s g_irq_thread_vector[NR_IRQS];
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -65,6 +92,10 @@ static pid_t g_irq_thread_pid[NR_IRQS];
 
 /* Default interrupt handler for threaded interrupts.
  * Useful for oneshot interrupts.
+ *
+ * Events raised while the thread has not served the previous ones yet are
+ * coalesced, only the first one posts the semaphore, so the isr may
+ * return IRQ_WAKE_THREAD for every event without a context switch each.
  */
 
 static int irq_default_handler(int irq, FAR void *regs, FAR void *arg)
@@ -72,49 +103,139 @@ static int irq_default_handler(int irq, FAR void *regs, FAR void *arg)
   FAR struct irq_thread_info_s *info = arg;
   int ret = IRQ_WAKE_THREAD;
 
-  DEBUGASSERT(info->handler != NULL);
-  ret = info->handler(irq, regs, info->arg);
+  if (info->handler != NULL)
+    {
+      ret = info->handler(irq, regs, info->arg);
+    }
 
   if (ret == IRQ_WAKE_THREAD)
     {
-      nxsem_post(info->sem);
+      if (atomic_fetch_add(&info->pending, 1) == 0)
+        {
+          nxsem_post(&info->owner->sem);
+        }
+
       ret = OK;
     }
 
   return ret;
 }
 
-static int isr_thread_main(int argc, FAR char *argv[])
+/* Serve the pending events of one IRQ in the handler thread */
+
+static void irq_thread_serve(FAR struct irq_thread_info_s *info)
 {
-  int irq = atoi(argv[1]);
-  xcpt_t isr = (xcpt_t)((uintptr_t)strtoul(argv[2], NULL, 16));
-  xcpt_t isrthread = (xcpt_t)((uintptr_t)strtoul(argv[3], NULL, 16));
-  FAR void *arg = (FAR void *)((uintptr_t)strtoul(argv[4], NULL, 16));
-  struct irq_thread_info_s info;
-  sem_t sem;
+  xcpt_t isrthread = info->isrthread;
+#ifdef CONFIG_SCHED_IRQMONITOR
+  clock_t start;
+  clock_t elapsed;
+#endif
+  int nevents;
 
-  info.sem = &sem;
-  info.arg = arg;
-  info.handler = isr;
+  nevents = atomic_exchange(&info->pending, 0);
+  if (nevents == 0 || isrthread == NULL)
+    {
+      return;
+    }
 
-  nxsem_init(&sem, 0, 0);
+#ifdef CONFIG_SCHED_IRQMONITOR
+  start = perf_gettime();
+#endif
 
-  irq_attach(irq, irq_default_handler, &info);
+  isrthread(info->irq, NULL, info->arg);
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+  elapsed = perf_gettime() - start;
+  if (elapsed > info->time)
+    {
+      info->time = elapsed;
+    }
+
+  info->nwakeups++;
+  info->nevents += nevents;
+#endif
+}
+
+static int isr_thread_main(int argc, FAR char *argv[])
+{
+  FAR struct irq_thread_info_s *info;
+  FAR struct irq_thread_info_s *curr;
+
+  info = &g_irq_thread_vector[atoi(argv[1])];
+
+  irq_attach(info->irq, irq_default_handler, info);
 
 #if !defined(CONFIG_ARCH_NOINTC)
-  up_enable_irq(irq);
+  up_enable_irq(info->irq);
 #endif
 
   for (; ; )
     {
-      if (nxsem_wait_uninterruptible(&sem) < 0)
+      if (nxsem_wait_uninterruptible(&info->sem) < 0)
         {
           continue;
         }
 
-      isrthread(irq, NULL, arg);
+      for (curr = info; curr != NULL; curr = curr->flink)
+        {
+          irq_thread_serve(curr);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irq_thread_detach
+ *
+ * Description:
+ *   Detach a threaded IRQ.  The thread is deleted with the IRQ owning it,
+ *   which fails while other IRQs still share the thread.
+ *
+ ****************************************************************************/
+
+static int irq_thread_detach(int irq, FAR struct irq_thread_info_s *info)
+{
+  FAR struct irq_thread_info_s *prev;
+  irqstate_t flags;
+
+  if (info->owner == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (info->owner == info)
+    {
+      if (info->flink != NULL)
+        {
+          return -EBUSY;
+        }
+
+      irq_detach(irq);
+      DEBUGASSERT(info->pid != 0);
+      kthread_delete(info->pid);
+      nxsem_destroy(&info->sem);
+      memset(info, 0, sizeof(*info));
+      return OK;
     }
 
+  irq_detach(irq);
+
+  /* Unlink the IRQ from the thread.  Its flink is kept, the thread may
+   * be walking the list through it right now.
+   */
+
+  flags = enter_critical_section();
+  for (prev = info->owner; prev->flink != info; prev = prev->flink)
+    {
+      DEBUGASSERT(prev->flink != NULL);
+    }
+
+  prev->flink     = info->flink;
+  info->isrthread = NULL;
+  info->owner     = NULL;
+  leave_critical_section(flags);
+
   return OK;
 }
 
@@ -149,11 +270,9 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
                       int priority, int stack_size)
 {
 #if NR_IRQS > 0
-  FAR char *argv[5];
-  char arg1[32];  /* irq */
-  char arg2[32];  /* isr */
-  char arg3[32];  /* isrthread */
-  char arg4[32];  /* arg */
+  FAR struct irq_thread_info_s *info;
+  FAR char *argv[2];
+  char arg1[32];  /* ndx */
   pid_t pid;
   int ndx;
 
@@ -168,43 +287,233 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
       return ndx;
     }
 
+  info = &g_irq_thread_vector[ndx];
+
   /* If the isrthread is NULL, then the ISR is being detached. */
 
   if (isrthread == NULL)
     {
-      irq_detach(irq);
-      DEBUGASSERT(g_irq_thread_pid[ndx] != 0);
-      kthread_delete(g_irq_thread_pid[ndx]);
-      g_irq_thread_pid[ndx] = 0;
-
-      return OK;
+      return irq_thread_detach(irq, info);
     }
 
-  if (g_irq_thread_pid[ndx] != 0)
+  if (info->owner != NULL)
     {
       return -EINVAL;
     }
 
-  snprintf(arg1, sizeof(arg1), "%d", irq);
-  snprintf(arg2, sizeof(arg2), "%p", isr);
-  snprintf(arg3, sizeof(arg3), "%p", isrthread);
-  snprintf(arg4, sizeof(arg4), "%p", arg);
+  info->handler   = isr;
+  info->isrthread = isrthread;
+  info->arg       = arg;
+  info->irq       = irq;
+  info->owner     = info;
+  info->flink     = NULL;
+  atomic_store(&info->pending, 0);
+  nxsem_init(&info->sem, 0, 0);
+
+  snprintf(arg1, sizeof(arg1), "%d", ndx);
   argv[0] = arg1;
-  argv[1] = arg2;
-  argv[2] = arg3;
-  argv[3] = arg4;
-  argv[4] = NULL;
+  argv[1] = NULL;
 
   pid = kthread_create("isr_thread", priority, stack_size,
                         isr_thread_main, argv);
   if (pid < 0)
     {
+      nxsem_destroy(&info->sem);
+      memset(info, 0, sizeof(*info));
       return pid;
     }
 
-  g_irq_thread_pid[ndx] = pid;
+  info->pid = pid;
+
+#endif /* NR_IRQS */
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irq_attach_thread_shared
+ *
+ * Description:
+ *   Configure the IRQ subsystem so that IRQ number 'irq' is dispatched to
+ *   'isrthread' in the handler thread of 'owner', an IRQ attached by
+ *   irq_attach_thread() before.  Sharing the thread saves its stack for
+ *   IRQs with a low rate.  irq_detach_thread() detaches both kinds of IRQ,
+ *   the owner only after the IRQs sharing its thread.
+ *
+ * Input Parameters:
+ *   irq - Irq num
+ *   isr - Function to be called when the IRQ occurs, called in interrupt
+ *   context.
+ *   If isr is NULL the default handler is installed(irq_default_handler).
+ *   isrthread - called in thread context
+ *   arg - privdate data
+ *   owner - Irq num owning the handler thread
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_attach_thread_shared(int irq, xcpt_t isr, xcpt_t isrthread,
+                             FAR void *arg, int owner)
+{
+#if NR_IRQS > 0
+  FAR struct irq_thread_info_s *info;
+  FAR struct irq_thread_info_s *head;
+  irqstate_t flags;
+  int ndx;
+
+  if ((unsigned)irq >= NR_IRQS || (unsigned)owner >= NR_IRQS ||
+      isrthread == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ndx = IRQ_TO_NDX(irq);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  info = &g_irq_thread_vector[ndx];
+
+  ndx = IRQ_TO_NDX(owner);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  head = &g_irq_thread_vector[ndx];
+  if (info->owner != NULL || head->owner != head)
+    {
+      return -EINVAL;
+    }
+
+  info->handler   = isr;
+  info->isrthread = isrthread;
+  info->arg       = arg;
+  info->irq       = irq;
+  atomic_store(&info->pending, 0);
+
+  flags = enter_critical_section();
+  info->owner = head;
+  info->flink = head->flink;
+  head->flink = info;
+  leave_critical_section(flags);
+
+  irq_attach(irq, irq_default_handler, info);
+
+#if !defined(CONFIG_ARCH_NOINTC)
+  up_enable_irq(irq);
+#endif
+
+#endif /* NR_IRQS */
+
+  return OK;
+}
+
+#ifdef CONFIG_SMP
+/****************************************************************************
+ * Name: irq_thread_affinity
+ *
+ * Description:
+ *   Bind the handler thread of a threaded IRQ to the CPUs of 'cpuset'.
+ *   Where the architecture can route interrupts the IRQs served by the
+ *   thread are routed to the same CPUs, so the top and the bottom half
+ *   share the cache.
+ *
+ * Input Parameters:
+ *   irq    - Irq num, attached with irq_attach_thread() or
+ *            irq_attach_thread_shared()
+ *   cpuset - The CPUs to run on
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_thread_affinity(int irq, cpu_set_t cpuset)
+{
+#if NR_IRQS > 0
+  FAR struct irq_thread_info_s *info;
+  int ndx;
+  int ret;
+
+  if ((unsigned)irq >= NR_IRQS)
+    {
+      return -EINVAL;
+    }
+
+  ndx = IRQ_TO_NDX(irq);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
 
+  info = g_irq_thread_vector[ndx].owner;
+  if (info == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxsched_set_affinity(info->pid, sizeof(cpuset), &cpuset);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#ifdef CONFIG_ARCH_HAVE_IRQ_AFFINITY
+  for (; info != NULL; info = info->flink)
+    {
+      up_affinity_irq(info->irq, cpuset);
+    }
+#endif
 #endif /* NR_IRQS */
 
   return OK;
 }
+#endif
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+/****************************************************************************
+ * Name: irq_thread_stats
+ *
+ * Description:
+ *   Take a snapshot of the threaded handler counts of an IRQ and reset
+ *   them.
+ *
+ * Input Parameters:
+ *   ndx      - The index of the IRQ, as passed by irq_foreach()
+ *   nwakeups - Number of times the thread served the IRQ
+ *   nevents  - Number of events served, nevents / nwakeups is the average
+ *              number of events coalesced into one run of the thread
+ *   time     - Maximum execution time of the thread handler
+ *
+ * Returned Value:
+ *   True if the IRQ is threaded.
+ *
+ ****************************************************************************/
+
+bool irq_thread_stats(int ndx, FAR uint32_t *nwakeups,
+                      FAR uint32_t *nevents, FAR clock_t *time)
+{
+  FAR struct irq_thread_info_s *info = &g_irq_thread_vector[ndx];
+  irqstate_t flags;
+
+  if (info->owner == NULL)
+    {
+      return false;
+    }
+
+  flags = enter_critical_section();
+  *nwakeups      = info->nwakeups;
+  *nevents       = info->nevents;
+  *time          = info->time;
+  info->nwakeups = 0;
+  info->nevents  = 0;
+  info->time     = 0;
+  leave_critical_section(flags);
+
+  return true;
+}
+#endif
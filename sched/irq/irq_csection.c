@@ -49,6 +49,10 @@
       g_cpu_irqset |= (1 << cpu); \
     } \
   while (0)
+
+#  ifndef CONFIG_SCHED_CSECTION_CALLERS
+#    define irq_csection_lock(caller) spin_lock(&g_cpu_irqlock)
+#  endif
 #endif
 
 /****************************************************************************
@@ -71,10 +75,74 @@ volatile cpu_set_t g_cpu_irqset;
 volatile uint8_t g_cpu_nestcount[CONFIG_SMP_NCPUS];
 #endif
 
+#ifdef CONFIG_SCHED_CSECTION_CALLERS
+/* The call sites that took the global IRQ lock.  The table is only
+ * modified while holding g_cpu_irqlock.
+ */
+
+struct csection_caller_s g_csection_callers[CONFIG_SCHED_CSECTION_NCALLERS];
+
+/* Number of acquisitions that did not fit into g_csection_callers[] */
+
+uint32_t g_csection_dropped;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: irq_csection_lock
+ *
+ * Description:
+ *   Take the global IRQ lock and account the acquisition to the call site
+ *   of enter_critical_section().  Acquisitions that had to spin because
+ *   another CPU held the lock are counted as contended.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CSECTION_CALLERS
+static void irq_csection_lock(FAR void *caller)
+{
+  FAR struct csection_caller_s *entry;
+  bool contended = false;
+  int ndx;
+  int i;
+
+  if (!spin_trylock(&g_cpu_irqlock))
+    {
+      spin_lock(&g_cpu_irqlock);
+      contended = true;
+    }
+
+  /* Find the entry of the caller with a simple open addressing hash */
+
+  ndx = ((uintptr_t)caller >> 2) % CONFIG_SCHED_CSECTION_NCALLERS;
+  for (i = 0; i < CONFIG_SCHED_CSECTION_NCALLERS; i++)
+    {
+      entry = &g_csection_callers[ndx];
+      if (entry->caller == caller || entry->caller == NULL)
+        {
+          entry->caller = caller;
+          entry->count++;
+          if (contended)
+            {
+              entry->contended++;
+            }
+
+          return;
+        }
+
+      if (++ndx >= CONFIG_SCHED_CSECTION_NCALLERS)
+        {
+          ndx = 0;
+        }
+    }
+
+  g_csection_dropped++;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -181,7 +249,7 @@ irqstate_t enter_critical_section(void)
                * no longer blocked by the critical section).
                */
 
-              spin_lock(&g_cpu_irqlock);
+              irq_csection_lock(return_address(0));
               cpu_irqlock_set(cpu);
             }
 
@@ -232,7 +300,7 @@ irqstate_t enter_critical_section(void)
 
           DEBUGASSERT((g_cpu_irqset & (1 << cpu)) == 0);
 
-          spin_lock(&g_cpu_irqlock);
+          irq_csection_lock(return_address(0));
 
           /* Then set the lock count to 1.
            *
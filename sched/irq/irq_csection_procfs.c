@@ -0,0 +1,319 @@
+/****************************************************************************
+ * sched/irq/irq_csection_procfs.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "irq/irq.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifdef CONFIG_SCHED_CSECTION_CALLERS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Output format:
+ *
+ *   CALLER                COUNT  CONTENDED
+ *   0xXXXXXXXX       DDDDDDDDDD DDDDDDDDDD
+ *   DROPPED: DDDDDDDDDD
+ */
+
+#define HDR_FMT     "CALLER                COUNT  CONTENDED\n"
+#define CALLER_FMT  "%-16p %10lu %10lu\n"
+#define DROPPED_FMT "DROPPED: %lu\n"
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic (plus a couple of
+ * bytes).
+ */
+
+#define CSECTION_LINELEN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct csection_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  char line[CSECTION_LINELEN];  /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     csection_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     csection_close(FAR struct file *filep);
+static ssize_t csection_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     csection_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     csection_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly extern'ed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_csection_operations =
+{
+  csection_open,  /* open */
+  csection_close, /* close */
+  csection_read,  /* read */
+  NULL,           /* write */
+  NULL,           /* poll */
+
+  csection_dup,   /* dup */
+
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+
+  csection_stat   /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: csection_open
+ ****************************************************************************/
+
+static int csection_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct csection_file_s *csfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* This PROCFS file is read-only.  Any attempt to open with write access
+   * is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  csfile = kmm_zalloc(sizeof(struct csection_file_s));
+  if (!csfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)csfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: csection_close
+ ****************************************************************************/
+
+static int csection_close(FAR struct file *filep)
+{
+  FAR struct csection_file_s *csfile;
+
+  /* Recover our private data from the struct file instance */
+
+  csfile = (FAR struct csection_file_s *)filep->f_priv;
+  DEBUGASSERT(csfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(csfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: csection_read
+ ****************************************************************************/
+
+static ssize_t csection_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct csection_file_s *csfile;
+  struct csection_caller_s copy;
+  irqstate_t flags;
+  uint32_t dropped;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  csfile = (FAR struct csection_file_s *)filep->f_priv;
+  DEBUGASSERT(csfile);
+
+  offset = filep->f_pos;
+
+  /* The first line to output is the header */
+
+  linesize  = snprintf(csfile->line, CSECTION_LINELEN, HDR_FMT);
+  copysize  = procfs_memcpy(csfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  /* Then one line for each call site that took the global lock */
+
+  for (i = 0; i < CONFIG_SCHED_CSECTION_NCALLERS && totalsize < buflen; i++)
+    {
+      /* Take a snapshot of the entry */
+
+      flags = enter_critical_section();
+      memcpy(&copy, &g_csection_callers[i], sizeof(copy));
+      leave_critical_section(flags);
+
+      if (copy.caller == NULL)
+        {
+          continue;
+        }
+
+      linesize   = snprintf(csfile->line, CSECTION_LINELEN, CALLER_FMT,
+                            copy.caller, (unsigned long)copy.count,
+                            (unsigned long)copy.contended);
+      copysize   = procfs_memcpy(csfile->line, linesize, buffer + totalsize,
+                                 buflen - totalsize, &offset);
+      totalsize += copysize;
+    }
+
+  /* Finally the number of acquisitions that could not be accounted */
+
+  if (totalsize < buflen)
+    {
+      flags = enter_critical_section();
+      dropped = g_csection_dropped;
+      leave_critical_section(flags);
+
+      linesize   = snprintf(csfile->line, CSECTION_LINELEN, DROPPED_FMT,
+                            (unsigned long)dropped);
+      copysize   = procfs_memcpy(csfile->line, linesize, buffer + totalsize,
+                                 buflen - totalsize, &offset);
+      totalsize += copysize;
+    }
+
+  /* Update the file position */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: csection_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int csection_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct csection_file_s *oldattr;
+  FAR struct csection_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct csection_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct csection_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct csection_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: csection_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int csection_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "csection" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_SCHED_CSECTION_CALLERS */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
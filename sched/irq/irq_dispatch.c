@@ -47,6 +47,17 @@
 #  define NUSER_IRQS NR_IRQS
 #endif
 
+/* CRITMON_RECORD_IRQ - Account the execution time of an interrupt
+ * handler in the critical section monitor histograms
+ */
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+#  define CRITMON_RECORD_IRQ(elapsed, vector) \
+     nxsched_critmon_record(CRITMON_IRQ, elapsed, (FAR void *)vector)
+#else
+#  define CRITMON_RECORD_IRQ(elapsed, vector)
+#endif
+
 /* CALL_VECTOR - Call the interrupt service routine attached to this
  * interrupt request
  */
@@ -68,6 +79,7 @@
                  g_irqvector[ndx].time = elapsed; \
                } \
            } \
+         CRITMON_RECORD_IRQ(elapsed, vector); \
          if (CONFIG_SCHED_CRITMONITOR_MAXTIME_IRQ > 0 && \
              elapsed > CONFIG_SCHED_CRITMONITOR_MAXTIME_IRQ) \
            { \
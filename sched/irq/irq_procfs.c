@@ -49,26 +49,30 @@
 
 /* Output format:
  *
- *            1111111111222222222233333333334444444444
- *   1234567890123456789012345678901234567890123456789
+ *          1111111111222222222233333333334444444444555555555566666666667777
+ * 1234567890123456789012345678901234567890123456789012345678901234567890123
  *
- *   IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME
- *   DDD XXXXXXXX XXXXXXXX DDDDDDDDDD DDDD.DDD DDDD
+ * IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME     WAKEUP     EVENTS TTIME
+ * DDD XXXXXXXX XXXXXXXX DDDDDDDDDD DDDD.DDD DDDD DDDDDDDDDD DDDDDDDDDD DDDD
+ *
+ * WAKEUP and EVENTS count the runs of the handler thread of a threaded IRQ
+ * and the events they served, TTIME is the maximum time of a run.
  *
  * NOTE:  This assumes that an address can be represented in 32-bits.  In
  * the typical configuration where CONFIG_HAVE_LONG_LONG=y, the COUNT field
  * may not be wide enough.
  */
 
-#define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME\n"
-#define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu\n"
+#define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME" \
+                "     WAKEUP     EVENTS TTIME\n"
+#define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu %10lu %10lu %4lu\n"
 
 /* Determines the size of an intermediate buffer that must be large enough
  * to handle the longest line generated by this logic (plus a couple of
  * bytes).
  */
 
-#define IRQ_LINELEN 50
+#define IRQ_LINELEN 80
 
 /****************************************************************************
  * Private Types
@@ -147,6 +151,10 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   FAR struct irq_file_s *irqfile = (FAR struct irq_file_s *)arg;
   struct irq_info_s copy;
   struct timespec delta;
+  struct timespec tdelta;
+  uint32_t nwakeups = 0;
+  uint32_t nevents = 0;
+  clock_t ttime = 0;
   irqstate_t flags;
   clock_t elapsed;
   clock_t now;
@@ -201,6 +209,9 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   elapsed = now - copy.start;
   perf_convert(copy.time, &delta);
 
+  irq_thread_stats(irq, &nwakeups, &nevents, &ttime);
+  perf_convert(ttime, &tdelta);
+
 #ifdef CONFIG_HAVE_LONG_LONG
   /* elapsed = <current-time> - <start-time>, units=clock ticks
    * rate    = <interrupt-count> * TICKS_PER_SEC / elapsed
@@ -241,7 +252,9 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
                       (unsigned long)((uintptr_t)copy.handler),
                       (unsigned long)((uintptr_t)copy.arg),
                       count, intpart, fracpart,
-                      (unsigned long)delta.tv_nsec / 1000);
+                      (unsigned long)delta.tv_nsec / 1000,
+                      (unsigned long)nwakeups, (unsigned long)nevents,
+                      (unsigned long)tdelta.tv_nsec / 1000);
 
   copysize  = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
                             irqfile->remaining, &irqfile->offset);
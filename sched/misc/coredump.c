@@ -189,6 +189,125 @@ static int elf_emit_align(FAR struct elf_dumpinfo_s *cinfo)
   return ret < 0 ? ret : align;
 }
 
+/****************************************************************************
+ * Name: elf_iszero
+ *
+ * Description:
+ *   Check whether a range of memory only holds zeros
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BOARD_COREDUMP_SKIPZERO
+static bool elf_iszero(uintptr_t start, size_t len)
+{
+  FAR const uint8_t *ptr = (FAR const uint8_t *)start;
+  FAR const uintptr_t *word;
+
+  for (; len > 0 && ((uintptr_t)ptr % sizeof(uintptr_t)) != 0; len--)
+    {
+      if (*ptr++ != 0)
+        {
+          return false;
+        }
+    }
+
+  for (word = (FAR const uintptr_t *)ptr; len >= sizeof(uintptr_t);
+       len -= sizeof(uintptr_t))
+    {
+      if (*word++ != 0)
+        {
+          return false;
+        }
+    }
+
+  for (ptr = (FAR const uint8_t *)word; len > 0; len--)
+    {
+      if (*ptr++ != 0)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: elf_get_segment
+ *
+ * Description:
+ *   Get the next segment of a memory region from start on.  A segment is
+ *   a run of pages with data followed by a run of zero pages, only the
+ *   pages with data are written to the dump.  Returns the memory size of
+ *   the segment and the size to write in filesz.
+ *
+ ****************************************************************************/
+
+static size_t elf_get_segment(FAR const struct memory_region_s *region,
+                              uintptr_t start, FAR size_t *filesz)
+{
+#ifdef CONFIG_BOARD_COREDUMP_SKIPZERO
+  uintptr_t pos = start;
+  size_t len;
+
+  /* The registers are only read once */
+
+  if ((region->flags & PF_REGISTER) == 0)
+    {
+      for (; pos < region->end; pos += len)
+        {
+          len = MIN(ELF_PAGESIZE, region->end - pos);
+          if (elf_iszero(pos, len))
+            {
+              break;
+            }
+        }
+
+      *filesz = pos - start;
+      for (; pos < region->end; pos += len)
+        {
+          len = MIN(ELF_PAGESIZE, region->end - pos);
+          if (!elf_iszero(pos, len))
+            {
+              break;
+            }
+        }
+
+      return pos - start;
+    }
+#endif
+
+  *filesz = region->end - start;
+  return region->end - start;
+}
+
+/****************************************************************************
+ * Name: elf_get_nsegs
+ *
+ * Description:
+ *   Calculate the number of load segments of the memory regions
+ *
+ ****************************************************************************/
+
+static int elf_get_nsegs(FAR struct elf_dumpinfo_s *cinfo, int memsegs)
+{
+  uintptr_t start;
+  size_t filesz;
+  int nsegs = 0;
+  int i;
+
+  for (i = 0; i < memsegs; i++)
+    {
+      for (start = cinfo->regions[i].start; start < cinfo->regions[i].end;
+           start += elf_get_segment(&cinfo->regions[i], start, &filesz))
+        {
+          nsegs++;
+        }
+    }
+
+  return nsegs;
+}
+
 /****************************************************************************
  * Name: elf_emit_hdr
  *
@@ -489,16 +608,27 @@ static void elf_emit_memory(FAR struct elf_dumpinfo_s *cinfo, int memsegs)
             {
               elf_emit(cinfo, buf, offset * sizeof(uintptr_t));
             }
+
+          /* Align to page */
+
+          elf_emit_align(cinfo);
         }
       else
         {
-          elf_emit(cinfo, (FAR void *)cinfo->regions[i].start,
-                   cinfo->regions[i].end - cinfo->regions[i].start);
-        }
+          uintptr_t start = cinfo->regions[i].start;
+          size_t filesz;
+          size_t memsz;
 
-      /* Align to page */
+          for (; start < cinfo->regions[i].end; start += memsz)
+            {
+              memsz = elf_get_segment(&cinfo->regions[i], start, &filesz);
+              elf_emit(cinfo, (FAR void *)start, filesz);
 
-      elf_emit_align(cinfo);
+              /* Align each segment to page */
+
+              elf_emit_align(cinfo);
+            }
+        }
     }
 }
 
@@ -570,10 +700,12 @@ static void elf_emit_tcb_phdr(FAR struct elf_dumpinfo_s *cinfo,
  ****************************************************************************/
 
 static void elf_emit_phdr(FAR struct elf_dumpinfo_s *cinfo,
-                          int stksegs, int memsegs)
+                          int stksegs, int memsegs, int nsegs)
 {
   off_t offset = cinfo->stream->nput +
-                 (stksegs + memsegs + 1) * sizeof(Elf_Phdr);
+                 (stksegs + nsegs + 1) * sizeof(Elf_Phdr);
+  uintptr_t start;
+  size_t filesz;
   Elf_Phdr phdr;
   int i;
 
@@ -607,15 +739,20 @@ static void elf_emit_phdr(FAR struct elf_dumpinfo_s *cinfo,
 
   for (i = 0; i < memsegs; i++)
     {
-      phdr.p_type   = PT_LOAD;
-      phdr.p_offset = ROUNDUP(offset, ELF_PAGESIZE);
-      phdr.p_vaddr  = cinfo->regions[i].start;
-      phdr.p_paddr  = phdr.p_vaddr;
-      phdr.p_filesz = cinfo->regions[i].end - cinfo->regions[i].start;
-      phdr.p_memsz  = phdr.p_filesz;
-      phdr.p_flags  = cinfo->regions[i].flags;
-      offset       += ROUNDUP(phdr.p_memsz, ELF_PAGESIZE);
-      elf_emit(cinfo, &phdr, sizeof(phdr));
+      for (start = cinfo->regions[i].start; start < cinfo->regions[i].end;
+           start += phdr.p_memsz)
+        {
+          phdr.p_type   = PT_LOAD;
+          phdr.p_offset = ROUNDUP(offset, ELF_PAGESIZE);
+          phdr.p_vaddr  = start;
+          phdr.p_paddr  = phdr.p_vaddr;
+          phdr.p_memsz  = elf_get_segment(&cinfo->regions[i], start,
+                                          &filesz);
+          phdr.p_filesz = filesz;
+          phdr.p_flags  = cinfo->regions[i].flags;
+          offset       += ROUNDUP(phdr.p_filesz, ELF_PAGESIZE);
+          elf_emit(cinfo, &phdr, sizeof(phdr));
+        }
     }
 }
 
@@ -924,6 +1061,7 @@ int coredump(FAR const struct memory_region_s *regions,
   irqstate_t flags;
   int memsegs = 0;
   int stksegs;
+  int nsegs;
 
   cinfo.regions = regions;
   cinfo.stream  = stream;
@@ -954,15 +1092,19 @@ int coredump(FAR const struct memory_region_s *regions,
              cinfo.regions[memsegs].end; memsegs++);
     }
 
+  /* Zero pages may split a memory region in several segments */
+
+  nsegs = elf_get_nsegs(&cinfo, memsegs);
+
   /* Fill notes section */
 
-  elf_emit_hdr(&cinfo, stksegs + memsegs + 1);
+  elf_emit_hdr(&cinfo, stksegs + nsegs + 1);
 
   /* Fill all the program information about the process for the
    * notes.  This also sets up the file header.
    */
 
-  elf_emit_phdr(&cinfo, stksegs, memsegs);
+  elf_emit_phdr(&cinfo, stksegs, memsegs, nsegs);
 
   /* Fill note information */
 
@@ -0,0 +1,169 @@
+/****************************************************************************
+ * sched/mqueue/mq_fdpass.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The messages of a queue created with MQ_FDPASS are file descriptors, of
+ * shared memory objects for example.  The queue holds a duplicate of the
+ * file of the sender, the receiver gets a new descriptor of that file.  The
+ * data behind the descriptor is never copied.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_FDPASS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_fdpass_pack
+ *
+ * Description:
+ *   Put a duplicate of the file of the descriptor to send in a message.
+ *
+ * Input Parameters:
+ *   mqmsg  - The message, with room for a pointer
+ *   msg    - The descriptor to send
+ *   msglen - The length of the message, the size of an int
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxmq_fdpass_pack(FAR struct mqueue_msg_s *mqmsg, FAR const char *msg,
+                     size_t msglen)
+{
+  FAR struct file *filep;
+  FAR struct file *dup;
+  int ret;
+  int fd;
+
+  if (msglen != sizeof(int))
+    {
+      return -EMSGSIZE;
+    }
+
+  /* Interrupt handlers have no descriptors to pass */
+
+  if (up_interrupt_context())
+    {
+      return -EINVAL;
+    }
+
+  memcpy(&fd, msg, sizeof(int));
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  dup = kmm_zalloc(sizeof(struct file));
+  if (dup == NULL)
+    {
+      fs_putfilep(filep);
+      return -ENOMEM;
+    }
+
+  ret = file_dup2(filep, dup);
+  fs_putfilep(filep);
+  if (ret < 0)
+    {
+      kmm_free(dup);
+      return ret;
+    }
+
+  memcpy(mqmsg->mail, &dup, sizeof(dup));
+  mqmsg->msglen = sizeof(dup);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_fdpass_unpack
+ *
+ * Description:
+ *   Give the file of a received message a new descriptor of the receiver.
+ *   The file is released from the message in any case.
+ *
+ * Input Parameters:
+ *   mqmsg - The received message
+ *   msg   - The buffer of the receiver, with room for an int
+ *
+ * Returned Value:
+ *   The length of the message, the size of an int, on success; a negated
+ *   errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_fdpass_unpack(FAR struct mqueue_msg_s *mqmsg, FAR char *msg)
+{
+  FAR struct file *filep;
+  int fd;
+
+  memcpy(&filep, mqmsg->mail, sizeof(filep));
+  fd = file_dup(filep, 0, 0);
+  file_close(filep);
+  kmm_free(filep);
+
+  if (fd < 0)
+    {
+      return fd;
+    }
+
+  memcpy(msg, &fd, sizeof(int));
+  return sizeof(int);
+}
+
+/****************************************************************************
+ * Name: nxmq_fdpass_release
+ *
+ * Description:
+ *   Release the file of a message that will not be received.
+ *
+ * Input Parameters:
+ *   mqmsg - The message
+ *
+ ****************************************************************************/
+
+void nxmq_fdpass_release(FAR struct mqueue_msg_s *mqmsg)
+{
+  FAR struct file *filep;
+
+  memcpy(&filep, mqmsg->mail, sizeof(filep));
+  file_close(filep);
+  kmm_free(filep);
+}
+
+#endif /* CONFIG_MQ_FDPASS */
@@ -77,6 +77,13 @@ int file_mq_getattr(FAR struct file *mq, FAR struct mq_attr *mq_stat)
   mq_stat->mq_maxmsg  = msgq->maxmsgs;
   mq_stat->mq_msgsize = msgq->maxmsgsize;
   mq_stat->mq_flags   = mq->f_oflags;
+#ifdef CONFIG_MQ_FDPASS
+  if (msgq->fdpass)
+    {
+      mq_stat->mq_flags |= MQ_FDPASS;
+    }
+#endif
+
   mq_stat->mq_curmsgs = msgq->nmsgs;
 
   return 0;
@@ -58,7 +58,7 @@
  *   returned to indicate the nature of the failure.
  *
  *   EINVAL    attr is NULL or either attr->mq_mqssize or attr->mq_maxmsg
- *             have an invalid value
+ *             have an invalid value, or MQ_FDPASS is not supported
  *   ENOSPC    There is insufficient space for the creation of the new
  *             message queue
  *
@@ -79,6 +79,21 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
       return -EINVAL;
     }
 
+  /* A queue of descriptors keeps a file pointer in each message */
+
+#ifdef CONFIG_MQ_FDPASS
+  if (attr && (attr->mq_flags & MQ_FDPASS) != 0 &&
+      MQ_MAX_BYTES < sizeof(FAR struct file *))
+    {
+      return -EINVAL;
+    }
+#else
+  if (attr && (attr->mq_flags & MQ_FDPASS) != 0)
+    {
+      return -EINVAL;
+    }
+#endif
+
   /* Allocate memory for the new message queue. */
 
   msgq = (FAR struct mqueue_inode_s *)
@@ -93,6 +108,16 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
         {
           msgq->maxmsgs    = (int16_t)attr->mq_maxmsg;
           msgq->maxmsgsize = (int16_t)attr->mq_msgsize;
+
+#ifdef CONFIG_MQ_FDPASS
+          /* The messages are descriptors, the queue keeps their files */
+
+          if ((attr->mq_flags & MQ_FDPASS) != 0)
+            {
+              msgq->fdpass     = true;
+              msgq->maxmsgsize = sizeof(int);
+            }
+#endif
         }
       else
         {
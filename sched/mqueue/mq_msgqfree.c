@@ -65,6 +65,13 @@ void nxmq_free_msgq(FAR struct mqueue_inode_s *msgq)
       /* Deallocate the message structure. */
 
       list_delete(&entry->node);
+#ifdef CONFIG_MQ_FDPASS
+      if (msgq->fdpass)
+        {
+          nxmq_fdpass_release(entry);
+        }
+#endif
+
       nxmq_free_msg(entry);
     }
 
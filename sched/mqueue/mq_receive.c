@@ -173,6 +173,15 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
 
   msgq = mq->f_inode->i_private;
 
+#ifdef CONFIG_MQ_FDPASS
+  /* The message would be lost if the descriptor did not fit */
+
+  if (msgq->fdpass && msglen < sizeof(int))
+    {
+      return -EMSGSIZE;
+    }
+#endif
+
   /* Furthermore, nxmq_wait_receive() expects to have interrupts disabled
    * because messages can be sent from interrupt level.
    */
@@ -222,8 +231,17 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
       *prio = mqmsg->priority;
     }
 
-  memcpy(msg, mqmsg->mail, mqmsg->msglen);
-  ret = mqmsg->msglen;
+#ifdef CONFIG_MQ_FDPASS
+  if (msgq->fdpass)
+    {
+      ret = nxmq_fdpass_unpack(mqmsg, msg);
+    }
+  else
+#endif
+    {
+      memcpy(msg, mqmsg->mail, mqmsg->msglen);
+      ret = mqmsg->msglen;
+    }
 
   /* Free the message structure */
 
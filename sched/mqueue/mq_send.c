@@ -306,17 +306,40 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
 
   msgq = mq->f_inode->i_private;
 
-  /* Pre-allocate a message structure */
+#ifdef CONFIG_MQ_FDPASS
+  if (msgq->fdpass)
+    {
+      /* Only the file of the descriptor is queued, never its data */
 
-  mqmsg = nxmq_alloc_msg(msglen);
-  if (!mqmsg)
+      mqmsg = nxmq_alloc_msg(sizeof(FAR struct file *));
+      if (!mqmsg)
+        {
+          return -ENOMEM;
+        }
+
+      ret = nxmq_fdpass_pack(mqmsg, msg, msglen);
+      if (ret < 0)
+        {
+          nxmq_free_msg(mqmsg);
+          return ret;
+        }
+    }
+  else
+#endif
     {
-      return -ENOMEM;
+      /* Pre-allocate a message structure */
+
+      mqmsg = nxmq_alloc_msg(msglen);
+      if (!mqmsg)
+        {
+          return -ENOMEM;
+        }
+
+      memcpy(mqmsg->mail, msg, msglen);
+      mqmsg->msglen = msglen;
     }
 
-  memcpy(mqmsg->mail, msg, msglen);
   mqmsg->priority = prio;
-  mqmsg->msglen   = msglen;
 
   /* Disable interruption */
 
@@ -363,6 +386,13 @@ out:
 
   if (ret < 0)
     {
+#ifdef CONFIG_MQ_FDPASS
+      if (msgq->fdpass)
+        {
+          nxmq_fdpass_release(mqmsg);
+        }
+#endif
+
       nxmq_free_msg(mqmsg);
     }
 
@@ -135,6 +135,15 @@ int nxmq_wait_send(FAR struct mqueue_inode_s *msgq,
                    sclock_t ticks);
 void nxmq_notify_send(FAR struct mqueue_inode_s *msgq);
 
+/* mq_fdpass.c **************************************************************/
+
+#ifdef CONFIG_MQ_FDPASS
+int nxmq_fdpass_pack(FAR struct mqueue_msg_s *mqmsg, FAR const char *msg,
+                     size_t msglen);
+ssize_t nxmq_fdpass_unpack(FAR struct mqueue_msg_s *mqmsg, FAR char *msg);
+void nxmq_fdpass_release(FAR struct mqueue_msg_s *mqmsg);
+#endif
+
 /* mq_recover.c *************************************************************/
 
 void nxmq_recover(FAR struct tcb_s *tcb);
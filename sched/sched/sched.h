@@ -31,6 +31,7 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <strings.h>
 #include <sched.h>
 
 #include <nuttx/arch.h>
@@ -44,6 +45,14 @@
 
 #define PIDHASH(pid)             ((pid) & (g_npidhash - 1))
 
+/* Geometry of the priority bitmap of the ready-to-run list */
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+#  define RTR_BITMAP_BITS        (8 * sizeof(unsigned long))
+#  define RTR_BITMAP_NWORDS \
+     ((SCHED_PRIORITY_MAX + RTR_BITMAP_BITS) / RTR_BITMAP_BITS)
+#endif
+
 /* The state of a task is indicated both by the task_state field of the TCB
  * and by a series of task lists.  All of these tasks lists are declared
  * below. Although it is not always necessary, most of these lists are
@@ -155,6 +164,16 @@ struct tasklist_s
 
 extern dq_queue_t g_readytorun;
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+/* g_readytorun_tail[] holds the last task of each priority level in the
+ * g_readytorun list, g_readytorun_bitmap[] has one bit set for each
+ * priority level having at least one task in the list.
+ */
+
+extern FAR struct tcb_s *g_readytorun_tail[SCHED_PRIORITY_MAX + 1];
+extern unsigned long g_readytorun_bitmap[RTR_BITMAP_NWORDS];
+#endif
+
 #ifdef CONFIG_SMP
 /* In order to support SMP, the function of the g_readytorun list changes,
  * The g_readytorun is still used but in the SMP case it will contain only:
@@ -310,6 +329,9 @@ int nxthread_create(FAR const char *name, uint8_t ttype, int priority,
 bool nxsched_add_readytorun(FAR struct tcb_s *rtrtcb);
 bool nxsched_remove_readytorun(FAR struct tcb_s *rtrtcb);
 void nxsched_remove_self(FAR struct tcb_s *rtrtcb);
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+void nxsched_idle_pull(void);
+#endif
 void nxsched_merge_prioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
                                uint8_t task_state);
 bool nxsched_merge_pending(void);
@@ -358,6 +380,18 @@ void nxsched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 void nxsched_suspend(FAR struct tcb_s *tcb);
 #endif
 
+/* Stack pool support */
+
+#ifdef CONFIG_SCHED_STACK_POOL
+int  nxsched_create_stack(FAR struct tcb_s *tcb, size_t stack_size,
+                          uint8_t ttype, uintptr_t entry);
+void nxsched_release_stack(FAR struct tcb_s *tcb, uint8_t ttype);
+#else
+#  define nxsched_create_stack(tcb,stack_size,ttype,entry) \
+     up_create_stack(tcb,stack_size,ttype)
+#  define nxsched_release_stack(tcb,ttype) up_release_stack(tcb,ttype)
+#endif
+
 #if defined(up_this_task)
 #  define this_task()            up_this_task()
 #elif !defined(CONFIG_SMP)
@@ -404,6 +438,12 @@ void nxsched_process_cpuload_ticks(clock_t ticks);
 #define nxsched_process_cpuload() nxsched_process_cpuload_ticks(1)
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+void nxsched_cpuload_suspend(FAR struct tcb_s *tcb);
+void nxsched_cpuload_resume(FAR struct tcb_s *tcb);
+void nxsched_cpuload_release(FAR struct tcb_s *tcb);
+#endif
+
 /* Critical section monitor */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
@@ -412,6 +452,17 @@ void nxsched_suspend_critmon(FAR struct tcb_s *tcb);
 void nxsched_update_critmon(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+void nxsched_critmon_record(int type, clock_t elapsed, FAR void *caller);
+#endif
+
+/* Wakeup latency tracer */
+
+#ifdef CONFIG_SCHED_WAKEUP_LATENCY
+void nxsched_wakeup_ready(FAR struct tcb_s *tcb);
+void nxsched_wakeup_running(FAR struct tcb_s *tcb);
+#endif
+
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
 void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
                                 FAR void *caller);
@@ -515,6 +566,173 @@ static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
   return ret;
 }
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+/****************************************************************************
+ * Name: nxsched_rtr_index
+ *
+ * Description:
+ *   Record tcb as the last task of its priority level if it is, the tcb
+ *   must already be linked into the ready-to-run list.
+ *
+ ****************************************************************************/
+
+static inline_function void nxsched_rtr_index(FAR struct tcb_s *tcb)
+{
+  uint8_t prio = tcb->sched_priority;
+
+  if (tcb->flink == NULL || tcb->flink->sched_priority != prio)
+    {
+      g_readytorun_tail[prio] = tcb;
+      g_readytorun_bitmap[prio / RTR_BITMAP_BITS] |=
+        1ul << (prio % RTR_BITMAP_BITS);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_rtr_unindex
+ *
+ * Description:
+ *   Drop tcb from the priority index before it is unlinked from the
+ *   ready-to-run list or its priority is changed.
+ *
+ ****************************************************************************/
+
+static inline_function void nxsched_rtr_unindex(FAR struct tcb_s *tcb)
+{
+  uint8_t prio = tcb->sched_priority;
+  FAR struct tcb_s *prev;
+
+  if (g_readytorun_tail[prio] == tcb)
+    {
+      prev = tcb->blink;
+      if (prev != NULL && prev->sched_priority == prio)
+        {
+          g_readytorun_tail[prio] = prev;
+        }
+      else
+        {
+          g_readytorun_tail[prio] = NULL;
+          g_readytorun_bitmap[prio / RTR_BITMAP_BITS] &=
+            ~(1ul << (prio % RTR_BITMAP_BITS));
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_rtr_add
+ *
+ * Description:
+ *   Add tcb to the ready-to-run list after the last task with the same
+ *   or a higher priority.  The position is found through the priority
+ *   bitmap instead of walking the list.
+ *
+ * Returned Value:
+ *   true if tcb was added at the head of the list.
+ *
+ ****************************************************************************/
+
+static inline_function bool nxsched_rtr_add(FAR struct tcb_s *tcb)
+{
+  FAR dq_queue_t *list = &g_readytorun;
+  FAR struct tcb_s *prev = NULL;
+  uint8_t prio = tcb->sched_priority;
+  unsigned long bits;
+  int word;
+
+  /* Find the lowest occupied priority level at or above prio, the new
+   * task goes after the last task of that level.
+   */
+
+  word = prio / RTR_BITMAP_BITS;
+  bits = g_readytorun_bitmap[word] & (~0ul << (prio % RTR_BITMAP_BITS));
+
+  while (bits == 0 && ++word < RTR_BITMAP_NWORDS)
+    {
+      bits = g_readytorun_bitmap[word];
+    }
+
+  if (bits != 0)
+    {
+      prev = g_readytorun_tail[word * RTR_BITMAP_BITS +
+                               ffsl((long)bits) - 1];
+    }
+
+  if (prev == NULL)
+    {
+      /* Insert at the head of the list */
+
+      tcb->blink = NULL;
+      tcb->flink = (FAR struct tcb_s *)list->head;
+      if (list->head != NULL)
+        {
+          ((FAR struct tcb_s *)list->head)->blink = tcb;
+        }
+      else
+        {
+          list->tail = (FAR dq_entry_t *)tcb;
+        }
+
+      list->head = (FAR dq_entry_t *)tcb;
+    }
+  else
+    {
+      /* Insert just after prev */
+
+      tcb->blink = prev;
+      tcb->flink = prev->flink;
+      if (prev->flink != NULL)
+        {
+          prev->flink->blink = tcb;
+        }
+      else
+        {
+          list->tail = (FAR dq_entry_t *)tcb;
+        }
+
+      prev->flink = tcb;
+    }
+
+  nxsched_rtr_index(tcb);
+  return prev == NULL;
+}
+
+/****************************************************************************
+ * Name: nxsched_rtr_rem
+ *
+ * Description:
+ *   Remove tcb from the ready-to-run list and from the priority index.
+ *
+ ****************************************************************************/
+
+static inline_function void nxsched_rtr_rem(FAR struct tcb_s *tcb)
+{
+  nxsched_rtr_unindex(tcb);
+  dq_rem((FAR dq_entry_t *)tcb, &g_readytorun);
+}
+
+/****************************************************************************
+ * Name: nxsched_rtr_setpriority
+ *
+ * Description:
+ *   Change the priority of a task in the ready-to-run list without moving
+ *   it.  The caller guarantees that the list stays prioritized.
+ *
+ ****************************************************************************/
+
+static inline_function void nxsched_rtr_setpriority(FAR struct tcb_s *tcb,
+                                                    int priority)
+{
+  nxsched_rtr_unindex(tcb);
+  tcb->sched_priority = (uint8_t)priority;
+  nxsched_rtr_index(tcb);
+}
+#else
+#  define nxsched_rtr_add(t)  nxsched_add_prioritized(t, list_readytorun())
+#  define nxsched_rtr_rem(t)  dq_rem((FAR dq_entry_t *)(t), list_readytorun())
+#  define nxsched_rtr_setpriority(t, p) \
+     ((t)->sched_priority = (uint8_t)(p))
+#endif
+
 #  ifdef CONFIG_SMP
 static inline_function int nxsched_select_cpu(cpu_set_t affinity)
 {
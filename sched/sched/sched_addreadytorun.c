@@ -71,6 +71,10 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   FAR struct tcb_s *rtcb = this_task();
   bool ret;
 
+#ifdef CONFIG_SCHED_WAKEUP_LATENCY
+  nxsched_wakeup_ready(btcb);
+#endif
+
   /* Check if pre-emption is disabled for the current running task and if
    * the new ready-to-run task would cause the current running task to be
    * pre-empted.  NOTE that IRQs disabled implies that pre-emption is
@@ -90,7 +94,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
 
   /* Otherwise, add the new task to the ready-to-run task list */
 
-  else if (nxsched_add_prioritized(btcb, list_readytorun()))
+  else if (nxsched_rtr_add(btcb))
     {
       /* The new btcb was added at the head of the ready-to-run list.  It
        * is now the new active task!
@@ -161,6 +165,10 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   int cpu;
   int me;
 
+#ifdef CONFIG_SCHED_WAKEUP_LATENCY
+  nxsched_wakeup_ready(btcb);
+#endif
+
   cpu = nxsched_select_cpu(btcb->affinity);
 
   /* Get the task currently running on the CPU (may be the IDLE task) */
@@ -215,9 +223,21 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
        * Add the task to the ready-to-run (but not running) task list
        */
 
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+      /* Queue the task on the run queue of the selected CPU.  The running
+       * task at the head has at least the same priority, so btcb will be
+       * inserted somewhere in the middle of the list.
+       */
+
+      nxsched_add_prioritized(btcb, &g_assignedtasks[cpu]);
+
+      btcb->cpu        = cpu;
+      btcb->task_state = TSTATE_TASK_ASSIGNED;
+#else
       nxsched_add_prioritized(btcb, list_readytorun());
 
       btcb->task_state = TSTATE_TASK_READYTORUN;
+#endif
       doswitch         = false;
     }
   else /* (task_state == TSTATE_TASK_RUNNING) */
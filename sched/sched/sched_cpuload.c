@@ -26,11 +26,14 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <errno.h>
 #include <assert.h>
+#include <limits.h>
 
 #include <nuttx/clock.h>
 #include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/wdog.h>
 
 #include "sched/sched.h"
@@ -94,10 +97,96 @@ volatile clock_t g_cpuload_total;
 static struct wdog_s g_cpuload_wdog;
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+/* With CONFIG_SCHED_CPULOAD_PERFCOUNT the run time of the threads is
+ * accounted in performance counter units when they are switched out.  The
+ * writers are serialized by g_cpuload_lock and increment g_cpuload_seq
+ * before and after each update, so that clock_cpuload() reads without any
+ * lock and retries if an update happened meanwhile.
+ *
+ * Instead of halving the counts of all threads at the time constant,
+ * g_cpuload_epoch counts the halvings of g_cpuload_total and the count of
+ * a thread is halved for each epoch passed since its last update, when it
+ * is used.
+ */
+
+static spinlock_t g_cpuload_lock = SP_UNLOCKED;
+static volatile unsigned int g_cpuload_seq;
+static volatile unsigned int g_cpuload_epoch;
+static volatile clock_t g_cpuload_start[CONFIG_SMP_NCPUS];
+static clock_t g_cpuload_limit;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: cpuload_decay
+ *
+ * Description:
+ *   Return the count of a thread, halved for each epoch passed since the
+ *   count was updated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+static inline clock_t cpuload_decay(FAR struct tcb_s *tcb,
+                                    unsigned int epoch)
+{
+  unsigned int shift = epoch - tcb->cpuload_epoch;
+
+  return shift < sizeof(clock_t) * 8 ? tcb->ticks >> shift : 0;
+}
+
+/****************************************************************************
+ * Name: cpuload_write_begin/cpuload_write_end
+ *
+ * Description:
+ *   Enclose an update of the counts.
+ *
+ ****************************************************************************/
+
+static inline irqstate_t cpuload_write_begin(void)
+{
+  irqstate_t flags = spin_lock_irqsave(&g_cpuload_lock);
+
+  g_cpuload_seq++;
+  SP_DMB();
+  return flags;
+}
+
+static inline void cpuload_write_end(irqstate_t flags)
+{
+  SP_DMB();
+  g_cpuload_seq++;
+  spin_unlock_irqrestore(&g_cpuload_lock, flags);
+}
+
+/****************************************************************************
+ * Name: cpuload_limit
+ *
+ * Description:
+ *   Return the total count at which the counts are halved: the time
+ *   constant in performance counter units, but low enough that the
+ *   percentages computed by the readers in clock_t do not overflow.
+ *
+ ****************************************************************************/
+
+static clock_t cpuload_limit(void)
+{
+  if (g_cpuload_limit == 0)
+    {
+      uint64_t limit = (uint64_t)perf_getfreq() * CONFIG_SMP_NCPUS *
+                       CONFIG_SCHED_CPULOAD_TIMECONSTANT;
+
+      g_cpuload_limit = MIN(limit, CLOCK_MAX / 1000);
+    }
+
+  return g_cpuload_limit;
+}
+#endif
+
 /****************************************************************************
  * Name: cpuload_callback
  *
@@ -126,6 +215,7 @@ static void cpuload_callback(wdparm_t arg)
  * Public Functions
  ****************************************************************************/
 
+#ifndef CONFIG_SCHED_CPULOAD_PERFCOUNT
 /****************************************************************************
  * Name: nxsched_process_taskload_ticks
  *
@@ -203,6 +293,92 @@ void nxsched_process_cpuload_ticks(clock_t ticks)
       nxsched_process_taskload_ticks(rtcb, ticks);
     }
 }
+#else
+
+/****************************************************************************
+ * Name: nxsched_cpuload_suspend
+ *
+ * Description:
+ *   Account the run time of a thread that is switched out.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is being suspended.
+ *
+ * Assumptions:
+ *   Called by nxsched_suspend_scheduler() with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_cpuload_suspend(FAR struct tcb_s *tcb)
+{
+  clock_t now = perf_gettime();
+  int cpu = this_cpu();
+  irqstate_t flags;
+  clock_t elapsed;
+
+  flags = cpuload_write_begin();
+
+  elapsed = now - g_cpuload_start[cpu];
+  g_cpuload_start[cpu] = now;
+
+  tcb->ticks          = cpuload_decay(tcb, g_cpuload_epoch) + elapsed;
+  tcb->cpuload_epoch  = g_cpuload_epoch;
+  g_cpuload_total    += elapsed;
+
+  /* Halve the counts at the time constant, the count of each thread is
+   * halved the next time it is used.
+   */
+
+  if (g_cpuload_total > cpuload_limit())
+    {
+      g_cpuload_total >>= 1;
+      g_cpuload_epoch++;
+    }
+
+  cpuload_write_end(flags);
+}
+
+/****************************************************************************
+ * Name: nxsched_cpuload_resume
+ *
+ * Description:
+ *   Start the accounting of a thread that is switched in.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread to be restarted.
+ *
+ ****************************************************************************/
+
+void nxsched_cpuload_resume(FAR struct tcb_s *tcb)
+{
+  clock_t now = perf_gettime();
+  irqstate_t flags;
+
+  UNUSED(tcb);
+
+  flags = cpuload_write_begin();
+  g_cpuload_start[this_cpu()] = now;
+  cpuload_write_end(flags);
+}
+
+/****************************************************************************
+ * Name: nxsched_cpuload_release
+ *
+ * Description:
+ *   Remove the count of an exiting thread from the total.
+ *
+ ****************************************************************************/
+
+void nxsched_cpuload_release(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags;
+
+  flags = cpuload_write_begin();
+  g_cpuload_total -= cpuload_decay(tcb, g_cpuload_epoch);
+  tcb->ticks       = 0;
+  cpuload_write_end(flags);
+}
+#endif
 
 /****************************************************************************
  * Name:  clock_cpuload
@@ -224,6 +400,61 @@ void nxsched_process_cpuload_ticks(clock_t ticks)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+int clock_cpuload(int pid, FAR struct cpuload_s *cpuload)
+{
+  FAR struct tcb_s *tcb;
+  unsigned int seq;
+  clock_t elapsed;
+  clock_t active;
+  clock_t total;
+  clock_t now;
+  int hash_index = PIDHASH(pid);
+  int cpu;
+
+  DEBUGASSERT(cpuload);
+
+  do
+    {
+      seq = g_cpuload_seq;
+      SP_DMB();
+
+      tcb = g_pidhash[hash_index];
+      if (tcb == NULL || tcb->pid != pid)
+        {
+          return -ESRCH;
+        }
+
+      now    = perf_gettime();
+      total  = g_cpuload_total;
+      active = cpuload_decay(tcb, g_cpuload_epoch);
+
+      /* Add the time the running threads have run so far */
+
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          elapsed = now - g_cpuload_start[cpu];
+          total  += elapsed;
+          if (current_task(cpu) == tcb)
+            {
+              active += elapsed;
+            }
+        }
+
+      /* The TCB was valid while it was read if it is still in the hash
+       * table, and the counts are consistent if no update happened.
+       */
+
+      SP_DMB();
+    }
+  while ((seq & 1) != 0 || seq != g_cpuload_seq ||
+         g_pidhash[hash_index] != tcb);
+
+  cpuload->total  = total;
+  cpuload->active = active;
+  return OK;
+}
+#else
 int clock_cpuload(int pid, FAR struct cpuload_s *cpuload)
 {
   irqstate_t flags;
@@ -269,6 +500,7 @@ int clock_cpuload(int pid, FAR struct cpuload_s *cpuload)
   leave_critical_section(flags);
   return ret;
 }
+#endif
 
 /****************************************************************************
  * Name: cpuload_init
@@ -28,6 +28,7 @@
 
 #include <sys/types.h>
 #include <sched.h>
+#include <strings.h>
 #include <assert.h>
 #include <debug.h>
 #include <time.h>
@@ -100,6 +101,10 @@ clock_t g_premp_max[CONFIG_SMP_NCPUS];
 clock_t g_crit_max[CONFIG_SMP_NCPUS];
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+struct critmon_hist_s g_critmon_hist[CONFIG_SMP_NCPUS][CRITMON_NTYPES];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -205,6 +210,11 @@ void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
         {
           g_premp_max[cpu] = elapsed;
         }
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+      nxsched_critmon_record(CRITMON_PREEMPTION, elapsed,
+                             tcb->premp_caller);
+#endif
     }
 }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0 */
@@ -257,10 +267,72 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
         {
           g_crit_max[cpu] = elapsed;
         }
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+      nxsched_critmon_record(CRITMON_CSECTION, elapsed, tcb->crit_caller);
+#endif
     }
 }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 */
 
+/****************************************************************************
+ * Name: nxsched_critmon_record
+ *
+ * Description:
+ *   Count a hold of 'elapsed' perf ticks in the histogram of the current
+ *   CPU and remember its call site if it is among the longest ones.
+ *
+ * Assumptions:
+ *   - Called with interrupts disabled on the current CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+void nxsched_critmon_record(int type, clock_t elapsed, FAR void *caller)
+{
+  FAR struct critmon_hist_s *hist = &g_critmon_hist[this_cpu()][type];
+  FAR struct critmon_holder_s *shortest = &hist->top[0];
+  int bucket;
+  int i;
+
+  bucket = flsll((long long)elapsed);
+  if (bucket >= CRITMON_NBUCKETS || bucket < 0)
+    {
+      bucket = CRITMON_NBUCKETS - 1;
+    }
+
+  hist->bucket[bucket]++;
+
+  /* Update the entry of the call site or replace the shortest hold */
+
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_TOPN; i++)
+    {
+      FAR struct critmon_holder_s *holder = &hist->top[i];
+
+      if (holder->caller == caller)
+        {
+          if (elapsed > holder->elapsed)
+            {
+              holder->elapsed = elapsed;
+            }
+
+          return;
+        }
+
+      if (holder->elapsed < shortest->elapsed)
+        {
+          shortest = holder;
+        }
+    }
+
+  if (elapsed > shortest->elapsed)
+    {
+      shortest->caller  = caller;
+      shortest->elapsed = elapsed;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: nxsched_resume_critmon
  *
@@ -365,6 +437,11 @@ void nxsched_suspend_critmon(FAR struct tcb_s *tcb)
         {
           g_premp_max[cpu] = elapsed;
         }
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+      nxsched_critmon_record(CRITMON_PREEMPTION, elapsed,
+                             tcb->premp_caller);
+#endif
     }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION */
 
@@ -389,6 +466,10 @@ void nxsched_suspend_critmon(FAR struct tcb_s *tcb)
         {
           g_crit_max[cpu] = elapsed;
         }
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+      nxsched_critmon_record(CRITMON_CSECTION, elapsed, tcb->crit_caller);
+#endif
     }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION */
 }
@@ -71,7 +71,44 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_SMP
+#if !defined(CONFIG_SMP) && defined(CONFIG_SCHED_READYTORUN_BITMAP)
+bool nxsched_merge_pending(void)
+{
+  FAR struct tcb_s *ptcb;
+  FAR struct tcb_s *rtcb;
+  bool ret = false;
+
+  /* Do nothing if pre-emption is still disabled */
+
+  if (this_task()->lockcount == 0)
+    {
+      /* Move every TCB in the g_pendingtasks list to the ready-to-run list,
+       * the priority index gives the location to insert each one.
+       */
+
+      while ((ptcb = (FAR struct tcb_s *)dq_remfirst(list_pendingtasks()))
+             != NULL)
+        {
+          rtcb = this_task();
+          if (nxsched_rtr_add(ptcb))
+            {
+              /* ptcb was added at the head of the list */
+
+              rtcb->task_state = TSTATE_TASK_READYTORUN;
+              ptcb->task_state = TSTATE_TASK_RUNNING;
+              up_update_task(ptcb);
+              ret = true;
+            }
+          else
+            {
+              ptcb->task_state = TSTATE_TASK_READYTORUN;
+            }
+        }
+    }
+
+  return ret;
+}
+#elif !defined(CONFIG_SMP)
 bool nxsched_merge_pending(void)
 {
   FAR struct tcb_s *ptcb;
@@ -220,6 +220,52 @@ static uint16_t perf_prepare_sample(FAR struct perf_sample_data_s *data,
       size += sizeof(data->tid_entry);
     }
 
+  if (sample_type & PERF_SAMPLE_TIME)
+    {
+      struct timespec ts;
+
+      perf_convert(perf_gettime(), &ts);
+      data->time = (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+      data->sample_flags |= PERF_SAMPLE_TIME;
+      size += sizeof(data->time);
+    }
+
+  if (sample_type & PERF_SAMPLE_CPU)
+    {
+      data->cpu_entry.cpu = this_cpu();
+      data->cpu_entry.reserved = 0;
+      data->sample_flags |= PERF_SAMPLE_CPU;
+      size += sizeof(data->cpu_entry);
+    }
+
+  if ((sample_type & PERF_SAMPLE_CALLCHAIN) && data->callchain)
+    {
+      FAR struct perf_callchain_entry *entry = data->callchain;
+#ifdef CONFIG_ARCH_HAVE_BACKTRACE
+      FAR void *addr[PERF_MAX_STACK_DEPTH - 1];
+      int nr;
+      int i;
+
+      /* In the overflow interrupt, the running task is the interrupted
+       * one and is unwound from the interrupted context.
+       */
+
+      nr = up_backtrace(NULL, addr, PERF_MAX_STACK_DEPTH - 1, 0);
+      for (i = 0; i < nr; i++)
+        {
+          entry->ip[i + 1] = (uintptr_t)addr[i];
+        }
+
+      entry->nr = nr + 1;
+#else
+      entry->nr = 1;
+#endif
+
+      entry->ip[0] = ip;
+      data->sample_flags |= PERF_SAMPLE_CALLCHAIN;
+      size += sizeof(entry->nr) + entry->nr * sizeof(entry->ip[0]);
+    }
+
   return size;
 }
 
@@ -243,16 +289,37 @@ static void perf_output_sample(FAR struct perf_event_header_s *header,
                         sizeof(data->tid_entry));
     }
 
+  if (sample_type & PERF_SAMPLE_TIME)
+    {
+      circbuf_overwrite(&(event->buf->rb), &data->time,
+                        sizeof(data->time));
+    }
+
   if (sample_type & PERF_SAMPLE_ID)
     {
       circbuf_overwrite(&(event->buf->rb), &data->id, sizeof(data->id));
     }
+
+  if (sample_type & PERF_SAMPLE_CPU)
+    {
+      circbuf_overwrite(&(event->buf->rb), &data->cpu_entry,
+                        sizeof(data->cpu_entry));
+    }
+
+  if (sample_type & PERF_SAMPLE_CALLCHAIN)
+    {
+      circbuf_overwrite(&(event->buf->rb), data->callchain,
+                        sizeof(data->callchain->nr) +
+                        data->callchain->nr *
+                        sizeof(data->callchain->ip[0]));
+    }
 }
 
 static int perf_event_data_overflow(FAR struct perf_event_s *event,
                                     FAR struct perf_sample_data_s *data,
                                     uintptr_t ip)
 {
+  struct perf_callchain_entry callchain;
   struct perf_event_header_s header;
   size_t space;
 
@@ -261,6 +328,8 @@ static int perf_event_data_overflow(FAR struct perf_event_s *event,
       return -ENOMEM;
     }
 
+  data->callchain = &callchain;
+
   space = circbuf_space(&(event->buf->rb));
   event->count++;
   header.size = perf_prepare_sample(data, event, ip);
@@ -2473,6 +2542,22 @@ static int perf_swevent_match(FAR struct perf_event_s *event)
 
 int perf_event_overflow(FAR struct perf_event_s *event)
 {
+  struct perf_sample_data_s data;
+  irqstate_t flags;
+
+  /* Counting events have no buffer to record samples into */
+
+  if (event->buf == NULL)
+    {
+      return 0;
+    }
+
+  perf_sample_data_init(&data, event->attr.sample_period);
+
+  flags = spin_lock_irqsave(&event->buf->lock);
+  perf_event_data_overflow(event, &data, up_getusrpc(NULL));
+  spin_unlock_irqrestore(&event->buf->lock, flags);
+
   return 0;
 }
 
@@ -0,0 +1,98 @@
+/****************************************************************************
+ * sched/sched/sched_rcu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/rcu.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: synchronize_rcu_handler
+ *
+ * Description:
+ *   Nothing to do, the CPU runs the function only outside of any read side
+ *   section since the sections disable the interrupts.
+ *
+ ****************************************************************************/
+
+static int synchronize_rcu_handler(FAR void *arg)
+{
+  UNUSED(arg);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: synchronize_rcu
+ *
+ * Description:
+ *   Wait until all read side sections that were running on the other CPUs
+ *   when the function was called have left.
+ *
+ * Assumptions:
+ *   Called from the normal tasking context, not within a read side
+ *   section.
+ *
+ ****************************************************************************/
+
+void synchronize_rcu(void)
+{
+  cpu_set_t cpuset;
+  int me = this_cpu();
+  int cpu;
+
+  DEBUGASSERT(!up_interrupt_context());
+
+  /* No section can be running on this CPU, the caller is not in one and
+   * cannot have preempted one.
+   */
+
+  CPU_ZERO(&cpuset);
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (cpu != me)
+        {
+          CPU_SET(cpu, &cpuset);
+        }
+    }
+
+  if (CPU_COUNT(&cpuset) > 0)
+    {
+      nxsched_smp_call(cpuset, synchronize_rcu_handler, NULL);
+    }
+}
@@ -54,7 +54,9 @@ static void nxsched_releasepid(pid_t pid)
   irqstate_t flags = enter_critical_section();
   int hash_ndx = PIDHASH(pid);
 
-#ifndef CONFIG_SCHED_CPULOAD_NONE
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+  nxsched_cpuload_release(g_pidhash[hash_ndx]);
+#elif !defined(CONFIG_SCHED_CPULOAD_NONE)
   /* Decrement the total CPU load count held by this thread from the
    * total for all threads.
    */
@@ -132,7 +134,7 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       if (tcb->stack_alloc_ptr)
         {
-          up_release_stack(tcb, ttype);
+          nxsched_release_stack(tcb, ttype);
         }
 
 #ifdef CONFIG_PIC
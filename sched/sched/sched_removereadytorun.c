@@ -29,12 +29,141 @@
 #include <stdbool.h>
 #include <assert.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/sched_note.h>
 
 #include "irq/irq.h"
 #include "sched/queue.h"
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_nwaiting
+ *
+ * Description:
+ *   Return the number of tasks waiting on the run queue of a CPU, that is
+ *   all tasks but the running one and the IDLE task.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP) && defined(CONFIG_SMP_PERCPU_RUNQUEUE)
+static int nxsched_nwaiting(int cpu)
+{
+  FAR struct tcb_s *tcb;
+  int nwaiting = 0;
+
+  for (tcb = (FAR struct tcb_s *)g_assignedtasks[cpu].head;
+       !is_idle_task(tcb); tcb = tcb->flink)
+    {
+      if (tcb->task_state != TSTATE_TASK_RUNNING)
+        {
+          nwaiting++;
+        }
+    }
+
+  return nwaiting;
+}
+
+/****************************************************************************
+ * Name: nxsched_steal_task
+ *
+ * Description:
+ *   Find the highest priority waiting task queued on the run queue of some
+ *   other CPU that may run on this CPU and that has a strictly higher
+ *   priority than the next task of this CPU.  If several CPUs offer a task
+ *   of that priority, the task is taken from the busiest run queue.  The
+ *   task is removed from its run queue and returned.
+ *
+ *   This runs when this CPU gives up its running task and, through
+ *   nxsched_idle_pull(), from the idle loop.  Equal priority tasks are not
+ *   balanced between busy CPUs.
+ *
+ * Input Parameters:
+ *   cpu    - The CPU looking for work
+ *   nxttcb - The next task that this CPU would run otherwise
+ *
+ * Returned Value:
+ *   The stolen TCB or NULL if there is no better candidate.
+ *
+ * Assumptions:
+ *   The caller holds the critical section.
+ *
+ ****************************************************************************/
+
+static FAR struct tcb_s *nxsched_steal_task(int cpu,
+                                            FAR struct tcb_s *nxttcb)
+{
+  FAR struct tcb_s *besttcb = NULL;
+  FAR struct tcb_s *rtrtcb;
+  int priority = nxttcb->sched_priority;
+  int nbest = -1;
+  int nwaiting;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (i == cpu)
+        {
+          continue;
+        }
+
+      /* The run queue is sorted, so the first non-running task with a
+       * matching affinity is the only candidate of CPU i.
+       */
+
+      for (rtrtcb = (FAR struct tcb_s *)g_assignedtasks[i].head;
+           !is_idle_task(rtrtcb); rtrtcb = rtrtcb->flink)
+        {
+          if (rtrtcb->task_state != TSTATE_TASK_RUNNING &&
+              CPU_ISSET(cpu, &rtrtcb->affinity))
+            {
+              if (rtrtcb->sched_priority > priority)
+                {
+                  besttcb  = rtrtcb;
+                  priority = rtrtcb->sched_priority;
+                  nbest    = -1;
+                }
+              else if (besttcb != NULL &&
+                       rtrtcb->sched_priority == priority)
+                {
+                  /* Same priority, prefer the longer run queue */
+
+                  if (nbest < 0)
+                    {
+                      nbest = nxsched_nwaiting(besttcb->cpu);
+                    }
+
+                  nwaiting = nxsched_nwaiting(i);
+                  if (nwaiting > nbest)
+                    {
+                      besttcb = rtrtcb;
+                      nbest   = nwaiting;
+                    }
+                }
+
+              break;
+            }
+        }
+    }
+
+  if (besttcb != NULL)
+    {
+      /* The task lies between the running task and the IDLE task of its
+       * CPU, so dq_rem_mid() can be used to unlink it.
+       */
+
+      dq_rem_mid(besttcb);
+      besttcb->cpu = cpu;
+    }
+
+  return besttcb;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -93,7 +222,10 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb)
    * is always the g_readytorun list.
    */
 
-  dq_rem((FAR dq_entry_t *)rtcb, tasklist);
+  DEBUGASSERT(tasklist == list_readytorun());
+  UNUSED(tasklist);
+
+  nxsched_rtr_rem(rtcb);
 
   /* Since the TCB is not in any list, it is now invalid */
 
@@ -184,6 +316,19 @@ void nxsched_remove_running(FAR struct tcb_s *tcb)
 
   dq_rem_head((FAR dq_entry_t *)tcb, tasklist);
 
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+  /* Keep scheduling from our own run queue unless some other CPU has a
+   * higher priority task waiting that may run here.
+   */
+
+  rtrtcb = nxsched_steal_task(cpu, nxttcb);
+  if (rtrtcb != NULL)
+    {
+      dq_addfirst_nonempty((FAR dq_entry_t *)rtrtcb, tasklist);
+      nxttcb = rtrtcb;
+    }
+
+#else
   /* Find the highest priority non-running tasks in the g_assignedtasks
    * list of other CPUs, and also non-idle tasks, place them in the
    * g_readytorun list. so as to find the task with the highest priority,
@@ -224,6 +369,7 @@ void nxsched_remove_running(FAR struct tcb_s *tcb)
             }
         }
     }
+#endif
 
   /* Which task will go at the head of the list?  It will be either the
    * next tcb in the assigned task list (nxttcb) or a TCB in the
@@ -275,6 +421,64 @@ void nxsched_remove_running(FAR struct tcb_s *tcb)
   up_update_task(nxttcb);
 }
 
+/****************************************************************************
+ * Name: nxsched_idle_pull
+ *
+ * Description:
+ *   Called from the idle loop of every CPU.  If this CPU is idle while a
+ *   task that may run here waits on the run queue of another CPU, pull
+ *   that task over and switch to it.  This catches the imbalance that
+ *   placement and the stealing at context switches leave behind, e.g.
+ *   after the affinity or the priority of a queued task changed.  The run
+ *   queues are checked at most once per tick, so that idle CPUs don't
+ *   keep taking the critical section away from the busy ones.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+void nxsched_idle_pull(void)
+{
+  static clock_t lastpull[CONFIG_SMP_NCPUS];
+  FAR struct tcb_s *rtcb;
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  clock_t now;
+  int cpu;
+
+  flags = enter_critical_section();
+  cpu   = this_cpu();
+  rtcb  = this_task();
+  now   = clock_systime_ticks();
+
+  if (now != lastpull[cpu] && is_idle_task(rtcb) &&
+      !nxsched_islocked_tcb(rtcb))
+    {
+      lastpull[cpu] = now;
+      tcb = nxsched_steal_task(cpu, rtcb);
+      if (tcb != NULL)
+        {
+          /* The stolen task is in no list now.  This CPU runs the lowest
+           * possible priority, so the task is started here or on another
+           * idle CPU.
+           */
+
+          if (nxsched_add_readytorun(tcb))
+            {
+              up_switch_context(tcb, rtcb);
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
 void nxsched_remove_self(FAR struct tcb_s *tcb)
 {
   nxsched_remove_running(tcb);
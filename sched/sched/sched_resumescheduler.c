@@ -74,9 +74,15 @@ void nxsched_resume_scheduler(FAR struct tcb_s *tcb)
 
   /* Indicate the task has been resumed */
 
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+  nxsched_cpuload_resume(tcb);
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   nxsched_resume_critmon(tcb);
 #endif
+#ifdef CONFIG_SCHED_WAKEUP_LATENCY
+  nxsched_wakeup_running(tcb);
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_resume(tcb);
 #endif
@@ -217,7 +217,7 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
           /* Change the task priority */
 
-          tcb->sched_priority = (uint8_t)sched_priority;
+          nxsched_rtr_setpriority(tcb, sched_priority);
         }
       else
         {
@@ -263,7 +263,7 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
     {
       /* Change the task priority */
 
-      tcb->sched_priority = (uint8_t)sched_priority;
+      nxsched_rtr_setpriority(tcb, sched_priority);
     }
 }
 
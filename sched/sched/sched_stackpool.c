@@ -0,0 +1,361 @@
+/****************************************************************************
+ * sched/sched/sched_stackpool.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/tls.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_STACK_POOL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define STACK_POOL_SIZE(s) ALIGN_UP(s, CONFIG_SCHED_STACK_POOL_GRANULE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A free stack of the pool, kept at the start of the stack memory */
+
+struct stack_free_s
+{
+  sq_entry_t node;   /* Entry in the list of free stacks */
+  size_t     size;   /* Size class of the stack */
+};
+
+#ifdef CONFIG_SCHED_STACK_POOL_AUTOSIZE
+/* The recorded stack usage of the threads of an entry point */
+
+struct stack_usage_s
+{
+  uintptr_t entry;   /* The entry point of the threads */
+  size_t    used;    /* The largest stack usage of the threads */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sq_queue_t g_stack_pool;
+static unsigned int g_stack_pool_count;
+static spinlock_t g_stack_pool_lock = SP_UNLOCKED;
+
+#ifdef CONFIG_SCHED_STACK_POOL_AUTOSIZE
+static struct stack_usage_s g_stack_usage[CONFIG_SCHED_STACK_POOL_USAGE];
+static unsigned int g_stack_usage_next;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_STACK_POOL_AUTOSIZE
+
+/****************************************************************************
+ * Name: nxsched_stack_autosize
+ *
+ * Description:
+ *   Shrink the requested stack size to the recorded usage of the previous
+ *   threads of the same entry point plus the configured margin.
+ *
+ ****************************************************************************/
+
+static size_t nxsched_stack_autosize(size_t stack_size, uintptr_t entry)
+{
+  irqstate_t flags;
+  size_t used = 0;
+  int i;
+
+  flags = spin_lock_irqsave(&g_stack_pool_lock);
+  for (i = 0; i < CONFIG_SCHED_STACK_POOL_USAGE; i++)
+    {
+      if (g_stack_usage[i].entry == entry)
+        {
+          used = g_stack_usage[i].used;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_stack_pool_lock, flags);
+
+  if (used > 0)
+    {
+      used += used * CONFIG_SCHED_STACK_POOL_MARGIN / 100;
+      stack_size = MIN(stack_size, used);
+    }
+
+  return stack_size;
+}
+
+/****************************************************************************
+ * Name: nxsched_stack_record
+ *
+ * Description:
+ *   Record the stack usage of an exiting thread, including the frame of
+ *   the thread local storage and the arguments.
+ *
+ ****************************************************************************/
+
+static void nxsched_stack_record(FAR struct tcb_s *tcb)
+{
+  uintptr_t entry = (uintptr_t)tcb->entry.main;
+  irqstate_t flags;
+  size_t used;
+  int i;
+
+  used = up_check_tcbstack(tcb) +
+         ((uintptr_t)tcb->stack_base_ptr - (uintptr_t)tcb->stack_alloc_ptr);
+
+  flags = spin_lock_irqsave(&g_stack_pool_lock);
+  for (i = 0; i < CONFIG_SCHED_STACK_POOL_USAGE; i++)
+    {
+      if (g_stack_usage[i].entry == entry)
+        {
+          g_stack_usage[i].used = MAX(g_stack_usage[i].used, used);
+          break;
+        }
+    }
+
+  if (i >= CONFIG_SCHED_STACK_POOL_USAGE)
+    {
+      /* Replace the oldest record */
+
+      i = g_stack_usage_next++ % CONFIG_SCHED_STACK_POOL_USAGE;
+      g_stack_usage[i].entry = entry;
+      g_stack_usage[i].used  = used;
+    }
+
+  spin_unlock_irqrestore(&g_stack_pool_lock, flags);
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsched_stack_take
+ *
+ * Description:
+ *   Take a free stack of a size class out of the pool.  With drain set all
+ *   the other free stacks are returned to the heap, to make room for a new
+ *   stack.
+ *
+ ****************************************************************************/
+
+static FAR void *nxsched_stack_take(size_t size, bool drain)
+{
+  FAR struct stack_free_s *stack = NULL;
+  FAR struct stack_free_s *pooled;
+  FAR sq_entry_t *node;
+  sq_queue_t queue;
+  irqstate_t flags;
+
+  sq_init(&queue);
+
+  flags = spin_lock_irqsave(&g_stack_pool_lock);
+  for (node = sq_peek(&g_stack_pool); node != NULL; node = sq_next(node))
+    {
+      pooled = (FAR struct stack_free_s *)node;
+      if (pooled->size == size)
+        {
+          sq_rem(node, &g_stack_pool);
+          g_stack_pool_count--;
+          stack = pooled;
+          break;
+        }
+    }
+
+  if (drain)
+    {
+      sq_move(&g_stack_pool, &queue);
+      g_stack_pool_count = 0;
+    }
+
+  spin_unlock_irqrestore(&g_stack_pool_lock, flags);
+
+  while ((node = sq_remfirst(&queue)) != NULL)
+    {
+      kumm_free(node);
+    }
+
+  return stack;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_create_stack
+ *
+ * Description:
+ *   Allocate the stack of a new task or pthread.  The stack is reused from
+ *   the pool of the stacks of exited threads of the same size class if
+ *   there is one.  The stacks of kernel threads are allocated by
+ *   up_create_stack().
+ *
+ * Input Parameters:
+ *   tcb        - The TCB of the new thread
+ *   stack_size - The requested stack size
+ *   ttype      - The thread type
+ *   entry      - The entry point of the new thread
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxsched_create_stack(FAR struct tcb_s *tcb, size_t stack_size,
+                         uint8_t ttype, uintptr_t entry)
+{
+  FAR void *stack;
+  size_t size;
+  int ret;
+
+  if (ttype == TCB_FLAG_TTYPE_KERNEL)
+    {
+      return up_create_stack(tcb, stack_size, ttype);
+    }
+
+#ifdef CONFIG_SCHED_STACK_POOL_AUTOSIZE
+  stack_size = nxsched_stack_autosize(stack_size, entry);
+#endif
+
+  size = STACK_POOL_SIZE(stack_size);
+
+#ifdef CONFIG_TLS_ALIGNED
+  if (size > TLS_MAXSTACK)
+    {
+      return up_create_stack(tcb, stack_size, ttype);
+    }
+#endif
+
+  stack = nxsched_stack_take(size, false);
+  if (stack == NULL)
+    {
+#ifdef CONFIG_TLS_ALIGNED
+      stack = kumm_memalign(TLS_STACK_ALIGN, size);
+#else
+      stack = kumm_malloc(size);
+#endif
+    }
+
+  if (stack == NULL)
+    {
+      /* Give the free stacks back to the heap and try again */
+
+      stack = nxsched_stack_take(size, true);
+      if (stack == NULL)
+        {
+#ifdef CONFIG_TLS_ALIGNED
+          stack = kumm_memalign(TLS_STACK_ALIGN, size);
+#else
+          stack = kumm_malloc(size);
+#endif
+          if (stack == NULL)
+            {
+              return -ENOMEM;
+            }
+        }
+    }
+
+  ret = up_use_stack(tcb, stack, size);
+  if (ret < 0)
+    {
+      kumm_free(stack);
+      return ret;
+    }
+
+  tcb->flags |= TCB_FLAG_POOL_STACK;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_release_stack
+ *
+ * Description:
+ *   Release the stack of a thread.  A stack of the pool goes back to the
+ *   pool, unless the pool is full.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB of the thread
+ *   ttype - The thread type
+ *
+ ****************************************************************************/
+
+void nxsched_release_stack(FAR struct tcb_s *tcb, uint8_t ttype)
+{
+  FAR struct stack_free_s *stack = tcb->stack_alloc_ptr;
+  irqstate_t flags;
+
+  if ((tcb->flags & TCB_FLAG_POOL_STACK) == 0)
+    {
+      up_release_stack(tcb, ttype);
+      return;
+    }
+
+#ifdef CONFIG_SCHED_STACK_POOL_AUTOSIZE
+  nxsched_stack_record(tcb);
+#endif
+
+  /* The adjustment of the stack top is less than the granule, so the size
+   * class of the stack is the adjusted size rounded up.
+   */
+
+  stack->size = STACK_POOL_SIZE(tcb->adj_stack_size);
+
+  tcb->flags &= ~TCB_FLAG_POOL_STACK;
+  tcb->stack_alloc_ptr = NULL;
+  tcb->stack_base_ptr  = NULL;
+  tcb->adj_stack_size  = 0;
+
+  flags = spin_lock_irqsave(&g_stack_pool_lock);
+  if (g_stack_pool_count < CONFIG_SCHED_STACK_POOL_DEPTH)
+    {
+      sq_addfirst(&stack->node, &g_stack_pool);
+      g_stack_pool_count++;
+      stack = NULL;
+    }
+
+  spin_unlock_irqrestore(&g_stack_pool_lock, flags);
+
+  if (stack != NULL)
+    {
+      kumm_free(stack);
+    }
+}
+
+#endif /* CONFIG_SCHED_STACK_POOL */
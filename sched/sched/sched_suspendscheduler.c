@@ -79,6 +79,9 @@ void nxsched_suspend_scheduler(FAR struct tcb_s *tcb)
 
   /* Indicate that the task has been suspended */
 
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+  nxsched_cpuload_suspend(tcb);
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   nxsched_suspend_critmon(tcb);
 #endif
@@ -0,0 +1,603 @@
+/****************************************************************************
+ * sched/sched/sched_wakeuplatency.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/note/noteram_driver.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_WAKEUP_LATENCY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bucket n counts the wakeups that took [2^(n-1), 2^n) perf ticks, the
+ * last bucket all longer ones.
+ */
+
+#define WAKEUP_NBUCKETS  32
+
+#define WAKEUP_NPRIOS    (SCHED_PRIORITY_MAX - SCHED_PRIORITY_MIN + 1)
+#define WAKEUP_BAND(p)   (((p) - SCHED_PRIORITY_MIN) * \
+                          CONFIG_SCHED_WAKEUP_LATENCY_NBANDS / WAKEUP_NPRIOS)
+#define WAKEUP_BANDLO(b) (SCHED_PRIORITY_MIN + \
+                          ((b) * WAKEUP_NPRIOS + \
+                           CONFIG_SCHED_WAKEUP_LATENCY_NBANDS - 1) / \
+                          CONFIG_SCHED_WAKEUP_LATENCY_NBANDS)
+
+/* Output format:
+ *
+ *   THRESHOLD: DDDDDDDDDD TRIGGERED: DDDDDDDDDD
+ *   PRIO      COUNT        MIN        AVG        MAX
+ *   DDD+ DDDDDDDDDD DDDDDDDDDD DDDDDDDDDD DDDDDDDDDD
+ *   PRIO          NS      COUNT
+ *   DDD+ DDDDDDDDDDD DDDDDDDDDD
+ *   PID       COUNT        MIN        AVG        MAX
+ *   DDDDD DDDDDDDDDD DDDDDDDDDD DDDDDDDDDD DDDDDDDDDD
+ *
+ * The times are in nanoseconds, the threshold in microseconds.  A band of
+ * priorities is shown by its lowest priority, NS is the upper bound of a
+ * bucket.
+ */
+
+#define TRIGGER_FMT      "THRESHOLD: %lu TRIGGERED: %lu\n"
+#define BAND_HDR_FMT     "PRIO      COUNT        MIN        AVG        MAX\n"
+#define BAND_FMT         "%3d+ %10lu %10llu %10llu %10llu\n"
+#define BUCKET_HDR_FMT   "PRIO          NS      COUNT\n"
+#define BUCKET_FMT       "%3d+ %11llu %10lu\n"
+#define TASK_HDR_FMT     "PID       COUNT        MIN        AVG        MAX\n"
+#define TASK_FMT         "%5d %10lu %10llu %10llu %10llu\n"
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic (plus a couple of
+ * bytes).
+ */
+
+#define WAKEUP_LINELEN   80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The wakeup latencies of one band of priorities */
+
+struct wakeup_band_s
+{
+  struct wakeup_stat_s stat;
+  uint32_t bucket[WAKEUP_NBUCKETS];
+};
+
+/* This structure describes one open "file" */
+
+struct wakeup_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  char line[WAKEUP_LINELEN];    /* Pre-allocated buffer for formatted lines */
+};
+
+/* The state of a read that walks the tasks */
+
+struct wakeup_read_s
+{
+  FAR struct wakeup_file_s *wfile;
+  FAR char *buffer;
+  size_t buflen;
+  size_t totalsize;
+  off_t offset;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     wakeup_open(FAR struct file *filep, FAR const char *relpath,
+                           int oflags, mode_t mode);
+static int     wakeup_close(FAR struct file *filep);
+static ssize_t wakeup_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen);
+static ssize_t wakeup_write(FAR struct file *filep, FAR const char *buffer,
+                            size_t buflen);
+static int     wakeup_dup(FAR const struct file *oldp,
+                          FAR struct file *newp);
+static int     wakeup_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct wakeup_band_s
+g_wakeup_band[CONFIG_SCHED_WAKEUP_LATENCY_NBANDS];
+static spinlock_t g_wakeup_lock = SP_UNLOCKED;
+
+/* A wakeup that takes longer than the threshold freezes the note buffer
+ * once, so that the events that led to it can be read.
+ */
+
+static unsigned long g_wakeup_threshold =
+  CONFIG_SCHED_WAKEUP_LATENCY_THRESHOLD;
+static clock_t g_wakeup_limit;
+static unsigned long g_wakeup_triggered;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_procfs.c -- this structure is explicitly extern'ed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_wakeup_operations =
+{
+  wakeup_open,   /* open */
+  wakeup_close,  /* close */
+  wakeup_read,   /* read */
+  wakeup_write,  /* write */
+  NULL,          /* poll */
+
+  wakeup_dup,    /* dup */
+
+  NULL,          /* opendir */
+  NULL,          /* closedir */
+  NULL,          /* readdir */
+  NULL,          /* rewinddir */
+
+  wakeup_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wakeup_stat_add
+ ****************************************************************************/
+
+static void wakeup_stat_add(FAR struct wakeup_stat_s *stat, clock_t elapsed)
+{
+  if (stat->count == 0 || elapsed < stat->min)
+    {
+      stat->min = elapsed;
+    }
+
+  if (elapsed > stat->max)
+    {
+      stat->max = elapsed;
+    }
+
+  stat->sum += elapsed;
+  stat->count++;
+}
+
+/****************************************************************************
+ * Name: wakeup_ns
+ ****************************************************************************/
+
+static unsigned long long wakeup_ns(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return (unsigned long long)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: wakeup_print
+ ****************************************************************************/
+
+static void wakeup_print(FAR struct wakeup_read_s *rd, FAR const char *fmt,
+                         ...)
+{
+  FAR struct wakeup_file_s *wfile = rd->wfile;
+  size_t linesize;
+  va_list ap;
+
+  if (rd->totalsize >= rd->buflen)
+    {
+      return;
+    }
+
+  va_start(ap, fmt);
+  linesize = vsnprintf(wfile->line, WAKEUP_LINELEN, fmt, ap);
+  va_end(ap);
+
+  rd->totalsize += procfs_memcpy(wfile->line, linesize,
+                                 rd->buffer + rd->totalsize,
+                                 rd->buflen - rd->totalsize, &rd->offset);
+}
+
+/****************************************************************************
+ * Name: wakeup_print_stat
+ ****************************************************************************/
+
+static void wakeup_print_stat(FAR struct wakeup_read_s *rd,
+                              FAR const char *fmt, int id,
+                              FAR const struct wakeup_stat_s *stat)
+{
+  wakeup_print(rd, fmt, id, (unsigned long)stat->count,
+               wakeup_ns(stat->min), wakeup_ns(stat->sum / stat->count),
+               wakeup_ns(stat->max));
+}
+
+/****************************************************************************
+ * Name: wakeup_read_task
+ ****************************************************************************/
+
+static void wakeup_read_task(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  struct wakeup_stat_s stat = tcb->wakeup_stat;
+
+  if (stat.count > 0)
+    {
+      wakeup_print_stat(arg, TASK_FMT, tcb->pid, &stat);
+    }
+}
+
+/****************************************************************************
+ * Name: wakeup_reset_task
+ ****************************************************************************/
+
+static void wakeup_reset_task(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  memset(&tcb->wakeup_stat, 0, sizeof(tcb->wakeup_stat));
+}
+
+/****************************************************************************
+ * Name: wakeup_open
+ ****************************************************************************/
+
+static int wakeup_open(FAR struct file *filep, FAR const char *relpath,
+                       int oflags, mode_t mode)
+{
+  FAR struct wakeup_file_s *wfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  wfile = kmm_zalloc(sizeof(struct wakeup_file_s));
+  if (!wfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)wfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wakeup_close
+ ****************************************************************************/
+
+static int wakeup_close(FAR struct file *filep)
+{
+  FAR struct wakeup_file_s *wfile;
+
+  /* Recover our private data from the struct file instance */
+
+  wfile = (FAR struct wakeup_file_s *)filep->f_priv;
+  DEBUGASSERT(wfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(wfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wakeup_read
+ ****************************************************************************/
+
+static ssize_t wakeup_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  struct wakeup_read_s rd;
+  struct wakeup_band_s band;
+  irqstate_t flags;
+  int i;
+  int j;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  rd.wfile     = (FAR struct wakeup_file_s *)filep->f_priv;
+  rd.buffer    = buffer;
+  rd.buflen    = buflen;
+  rd.totalsize = 0;
+  rd.offset    = filep->f_pos;
+  DEBUGASSERT(rd.wfile);
+
+  wakeup_print(&rd, TRIGGER_FMT, g_wakeup_threshold, g_wakeup_triggered);
+
+  /* The statistics of each band of priorities */
+
+  wakeup_print(&rd, BAND_HDR_FMT);
+  for (i = 0; i < CONFIG_SCHED_WAKEUP_LATENCY_NBANDS; i++)
+    {
+      flags = spin_lock_irqsave_wo_note(&g_wakeup_lock);
+      band.stat = g_wakeup_band[i].stat;
+      spin_unlock_irqrestore_wo_note(&g_wakeup_lock, flags);
+
+      if (band.stat.count > 0)
+        {
+          wakeup_print_stat(&rd, BAND_FMT, WAKEUP_BANDLO(i), &band.stat);
+        }
+    }
+
+  /* The histograms of each band */
+
+  wakeup_print(&rd, BUCKET_HDR_FMT);
+  for (i = 0; i < CONFIG_SCHED_WAKEUP_LATENCY_NBANDS; i++)
+    {
+      flags = spin_lock_irqsave_wo_note(&g_wakeup_lock);
+      memcpy(&band, &g_wakeup_band[i], sizeof(band));
+      spin_unlock_irqrestore_wo_note(&g_wakeup_lock, flags);
+
+      for (j = 0; j < WAKEUP_NBUCKETS; j++)
+        {
+          if (band.bucket[j] != 0)
+            {
+              wakeup_print(&rd, BUCKET_FMT, WAKEUP_BANDLO(i),
+                           wakeup_ns((clock_t)1 << j),
+                           (unsigned long)band.bucket[j]);
+            }
+        }
+    }
+
+  /* The statistics of each task */
+
+  wakeup_print(&rd, TASK_HDR_FMT);
+  nxsched_foreach(wakeup_read_task, &rd);
+
+  /* Update the file position */
+
+  filep->f_pos += rd.totalsize;
+  return rd.totalsize;
+}
+
+/****************************************************************************
+ * Name: wakeup_write
+ *
+ * Description:
+ *   "threshold <us>" sets the latency that freezes the note buffer, zero
+ *   disables it.  "reset" clears the statistics and re-arms the trigger.
+ *
+ ****************************************************************************/
+
+static ssize_t wakeup_write(FAR struct file *filep, FAR const char *buffer,
+                            size_t buflen)
+{
+  char cmd[WAKEUP_LINELEN];
+  irqstate_t flags;
+
+  if (buflen == 0 || buflen >= sizeof(cmd))
+    {
+      return -EINVAL;
+    }
+
+  memcpy(cmd, buffer, buflen);
+  cmd[buflen] = '\0';
+
+  if (strncmp(cmd, "reset", 5) == 0)
+    {
+      flags = spin_lock_irqsave_wo_note(&g_wakeup_lock);
+      memset(g_wakeup_band, 0, sizeof(g_wakeup_band));
+      g_wakeup_triggered = 0;
+      spin_unlock_irqrestore_wo_note(&g_wakeup_lock, flags);
+
+      nxsched_foreach(wakeup_reset_task, NULL);
+      return buflen;
+    }
+
+  if (strncmp(cmd, "threshold", 9) != 0)
+    {
+      return -EINVAL;
+    }
+
+  flags = spin_lock_irqsave_wo_note(&g_wakeup_lock);
+  g_wakeup_threshold = strtoul(cmd + 9, NULL, 0);
+  g_wakeup_limit     = 0;
+  spin_unlock_irqrestore_wo_note(&g_wakeup_lock, flags);
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: wakeup_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int wakeup_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct wakeup_file_s *oldattr;
+  FAR struct wakeup_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct wakeup_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct wakeup_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct wakeup_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wakeup_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int wakeup_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "wakeup" is the name for a read/write file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_wakeup_ready
+ *
+ * Description:
+ *   Called when a thread becomes ready to run.  A thread that is already
+ *   waiting to run keeps the time it became ready first.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_wakeup_ready(FAR struct tcb_s *tcb)
+{
+  if (tcb->wakeup_start == 0)
+    {
+      tcb->wakeup_start = perf_gettime();
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_wakeup_running
+ *
+ * Description:
+ *   Called when a thread resumes execution.  If it became ready to run
+ *   before, the time in between is accounted to the thread and to the
+ *   band of its priority.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_wakeup_running(FAR struct tcb_s *tcb)
+{
+  FAR struct wakeup_band_s *band;
+  irqstate_t flags;
+  clock_t elapsed;
+  bool trigger = false;
+  int bucket;
+
+  if (tcb->wakeup_start == 0)
+    {
+      return;
+    }
+
+  elapsed = perf_gettime() - tcb->wakeup_start;
+  tcb->wakeup_start = 0;
+
+  wakeup_stat_add(&tcb->wakeup_stat, elapsed);
+
+  bucket = flsll((long long)elapsed);
+  if (bucket >= WAKEUP_NBUCKETS || bucket < 0)
+    {
+      bucket = WAKEUP_NBUCKETS - 1;
+    }
+
+  band  = &g_wakeup_band[WAKEUP_BAND(tcb->sched_priority)];
+  flags = spin_lock_irqsave_wo_note(&g_wakeup_lock);
+
+  wakeup_stat_add(&band->stat, elapsed);
+  band->bucket[bucket]++;
+
+  if (g_wakeup_threshold > 0)
+    {
+      if (g_wakeup_limit == 0)
+        {
+          g_wakeup_limit = (clock_t)((uint64_t)g_wakeup_threshold *
+                                     perf_getfreq() / USEC_PER_SEC);
+        }
+
+      if (elapsed > g_wakeup_limit && g_wakeup_triggered++ == 0)
+        {
+          trigger = true;
+        }
+    }
+
+  spin_unlock_irqrestore_wo_note(&g_wakeup_lock, flags);
+
+  if (trigger)
+    {
+      sched_note_printf(NOTE_TAG_ALWAYS, "wakeup latency %d: %lluns",
+                        tcb->pid, wakeup_ns(elapsed));
+#ifdef CONFIG_DRIVERS_NOTERAM
+      noteram_freeze(&g_noteram_driver);
+#endif
+    }
+}
+
+#endif /* CONFIG_SCHED_WAKEUP_LATENCY */
@@ -0,0 +1,273 @@
+/****************************************************************************
+ * sched/semaphore/sem_futex.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/queue.h>
+#include <nuttx/futex.h>
+#include <nuttx/semaphore.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+
+#ifdef CONFIG_FUTEX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The same virtual address in two processes is two futex words, so the
+ * address environment is part of the key.
+ */
+
+#define FUTEX_HASH(as, addr) \
+  ((((uintptr_t)(addr) >> 2) ^ ((uintptr_t)(as) >> 4)) % CONFIG_FUTEX_NHASH)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This describes one thread waiting on a futex word.  It lives on the
+ * stack of the waiting thread.
+ */
+
+struct futex_waiter_s
+{
+  dq_entry_t node;                /* Entry in the hash bucket */
+  FAR const void *as;             /* The address environment of 'addr' */
+  FAR volatile uint32_t *addr;    /* The futex word, NULL once woken */
+  sem_t sem;                      /* The waiting thread blocks here */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Waiting threads hashed by the address environment and the address of
+ * the futex word
+ */
+
+static dq_queue_t g_futex_hash[CONFIG_FUTEX_NHASH];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: futex_addrspace
+ *
+ * Description:
+ *   Return the address environment the futex words of the calling thread
+ *   live in, NULL for the kernel and the flat builds.
+ *
+ ****************************************************************************/
+
+static FAR const void *futex_addrspace(void)
+{
+#ifdef CONFIG_ARCH_ADDRENV
+  return this_task()->addrenv_own;
+#else
+  return NULL;
+#endif
+}
+
+/****************************************************************************
+ * Name: futex_checkaddr
+ *
+ * Description:
+ *   Check the futex word passed by the caller.  A user process may only
+ *   pass an address of its own address environment.
+ *
+ ****************************************************************************/
+
+static int futex_checkaddr(FAR const void *as, FAR volatile uint32_t *addr)
+{
+  if (addr == NULL || ((uintptr_t)addr & (sizeof(uint32_t) - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_ARCH_ADDRENV
+  if (as != NULL && (!up_addrenv_user_vaddr((uintptr_t)addr) ||
+      !up_addrenv_user_vaddr((uintptr_t)addr + sizeof(uint32_t) - 1)))
+    {
+      return -EFAULT;
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxfutex_wait
+ *
+ * Description:
+ *   Atomically check that the 32-bit word at 'addr' still holds 'val' and,
+ *   if so, block the calling thread until nxfutex_wake() is called for the
+ *   same address, a signal is received or the timeout expires.
+ *
+ * Input Parameters:
+ *   addr    - The address of the futex word
+ *   val     - The value the futex word is expected to hold
+ *   clockid - The clock used as the time base for 'abstime'
+ *   abstime - The absolute time of the timeout or NULL to wait forever
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the thread was woken by nxfutex_wake().  A
+ *   negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+int nxfutex_wait(FAR volatile uint32_t *addr, uint32_t val,
+                 clockid_t clockid, FAR const struct timespec *abstime)
+{
+  struct futex_waiter_s waiter;
+  FAR dq_queue_t *bucket;
+  irqstate_t flags;
+  int ret;
+
+  waiter.as = futex_addrspace();
+  ret = futex_checkaddr(waiter.as, addr);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nxsem_init(&waiter.sem, 0, 0);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  nxsem_set_protocol(&waiter.sem, SEM_PRIO_NONE);
+#endif
+
+  bucket = &g_futex_hash[FUTEX_HASH(waiter.as, addr)];
+
+  /* nxfutex_wake() runs in the same critical section, so a wakeup cannot
+   * be lost between the check of the futex word and the wait.
+   */
+
+  flags = enter_critical_section();
+
+  if (*addr != val)
+    {
+      leave_critical_section(flags);
+      nxsem_destroy(&waiter.sem);
+      return -EAGAIN;
+    }
+
+  waiter.addr = addr;
+  dq_addlast(&waiter.node, bucket);
+
+  if (abstime != NULL)
+    {
+      ret = nxsem_clockwait(&waiter.sem, clockid, abstime);
+    }
+  else
+    {
+      ret = nxsem_wait(&waiter.sem);
+    }
+
+  /* Remove the entry if we were not woken by nxfutex_wake() */
+
+  if (waiter.addr != NULL)
+    {
+      dq_rem(&waiter.node, bucket);
+    }
+  else
+    {
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+
+  nxsem_destroy(&waiter.sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxfutex_wake
+ *
+ * Description:
+ *   Wake up to 'nwake' threads waiting in nxfutex_wait() on 'addr'.
+ *
+ * Input Parameters:
+ *   addr  - The address of the futex word
+ *   nwake - The maximum number of threads to wake
+ *
+ * Returned Value:
+ *   The number of threads woken is returned on success.  A negated errno
+ *   value is returned on failure.
+ *
+ ****************************************************************************/
+
+int nxfutex_wake(FAR volatile uint32_t *addr, int nwake)
+{
+  FAR struct futex_waiter_s *waiter;
+  FAR dq_entry_t *next;
+  FAR dq_entry_t *curr;
+  FAR const void *as;
+  FAR dq_queue_t *bucket;
+  irqstate_t flags;
+  int nwoken = 0;
+  int ret;
+
+  as  = futex_addrspace();
+  ret = futex_checkaddr(as, addr);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  bucket = &g_futex_hash[FUTEX_HASH(as, addr)];
+
+  flags = enter_critical_section();
+
+  for (curr = dq_peek(bucket); curr != NULL && nwoken < nwake; curr = next)
+    {
+      next   = dq_next(curr);
+      waiter = (FAR struct futex_waiter_s *)curr;
+
+      if (waiter->addr == addr && waiter->as == as)
+        {
+          dq_rem(curr, bucket);
+          waiter->addr = NULL;
+          nxsem_post(&waiter->sem);
+          nwoken++;
+        }
+    }
+
+  leave_critical_section(flags);
+  return nwoken;
+}
+
+#endif /* CONFIG_FUTEX */
@@ -32,6 +32,7 @@
 
 #include <nuttx/addrenv.h>
 #include <nuttx/arch.h>
+#include <nuttx/mutex.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -75,14 +76,24 @@ nxsem_allocholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
    */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  pholder = g_freeholders;
-  if (pholder != NULL)
+  pholder = &sem->holder;
+  if (pholder->htcb != NULL)
     {
-      /* Remove the holder from the free list and
-       * put it into the semaphore's holder list
+      /* Only further holders of counting semaphores are taken from the
+       * free list.
        */
 
-      g_freeholders  = pholder->flink;
+      pholder = g_freeholders;
+      if (pholder != NULL)
+        {
+          g_freeholders = pholder->flink;
+        }
+    }
+
+  if (pholder != NULL)
+    {
+      /* Put it into the semaphore's holder list */
+
       pholder->flink = sem->hhead;
       sem->hhead     = pholder;
     }
@@ -125,6 +136,13 @@ nxsem_findholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
   FAR struct semholder_s *pholder;
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
+  /* The single holder of a mutex is always the built-in one */
+
+  if (sem->holder.htcb == htcb)
+    {
+      return &sem->holder;
+    }
+
   /* Try to find the holder in the list of holders associated with this
    * semaphore
    */
@@ -215,10 +233,17 @@ static inline void nxsem_freeholder(FAR sem_t *sem,
         }
     }
 
-  /* And put it in the free list */
+  /* And put it in the free list, unless it is the built-in one */
 
-  pholder->flink = g_freeholders;
-  g_freeholders  = pholder;
+  if (pholder != &sem->holder)
+    {
+      pholder->flink = g_freeholders;
+      g_freeholders  = pholder;
+    }
+  else
+    {
+      pholder->flink = NULL;
+    }
 #endif
 }
 
@@ -688,6 +713,24 @@ void nxsem_boost_priority(FAR sem_t *sem)
 {
   FAR struct tcb_s *rtcb = this_task();
 
+#ifdef CONFIG_SEM_PRIO_FASTPATH
+  /* A mutex taken through the fast path has no registered holder.  Register
+   * the holder recorded in the mutex now so that it can be boosted and
+   * will release the mutex through the slow path.
+   */
+
+  if ((sem->flags & SEM_TYPE_MUTEX) != 0 && !NXSEM_HAS_HOLDER(sem))
+    {
+      pid_t pid = ((FAR mutex_t *)sem)->holder;
+      FAR struct tcb_s *htcb = pid >= 0 ? nxsched_get_tcb(pid) : NULL;
+
+      if (htcb != NULL)
+        {
+          nxsem_add_holder_tcb(htcb, sem);
+        }
+    }
+#endif
+
   /* Boost the priority of every thread holding counts on this semaphore
    * that are lower in priority than the new thread that is waiting for a
    * count.
@@ -737,19 +780,16 @@ void nxsem_release_holder(FAR sem_t *sem)
       /* Find the container for this holder */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-      for (pholder = sem->hhead; pholder != NULL; pholder = pholder->flink)
+      pholder = nxsem_findholder(sem, rtcb);
+      if (pholder != NULL)
         {
           DEBUGASSERT(pholder->counts > 0);
 
-          if (pholder->htcb == rtcb)
-            {
-              /* Decrement the counts on this holder -- the holder will be
-               * freed later in nxsem_restore_baseprio.
-               */
+          /* Decrement the counts on this holder -- the holder will be
+           * freed later in nxsem_restore_baseprio.
+           */
 
-              pholder->counts--;
-              return;
-            }
+          pholder->counts--;
         }
 #else
       pholder = &sem->holder;
@@ -256,8 +256,8 @@ int nxsem_post(FAR sem_t *sem)
    * else try to get it in slow mode.
    */
 
-#if !defined(CONFIG_PRIORITY_INHERITANCE) && !defined(CONFIG_PRIORITY_PROTECT)
-  if (sem->flags & SEM_TYPE_MUTEX)
+#ifdef NXSEM_FASTPOST
+  if (NXSEM_FASTPOST(sem))
     {
       short old = 0;
       if (atomic_compare_exchange_weak_explicit(NXSEM_COUNT(sem), &old, 1,
@@ -150,8 +150,8 @@ int nxsem_trywait(FAR sem_t *sem)
    * else try to get it in slow mode.
    */
 
-#if !defined(CONFIG_PRIORITY_INHERITANCE) && !defined(CONFIG_PRIORITY_PROTECT)
-  if (sem->flags & SEM_TYPE_MUTEX)
+#ifdef NXSEM_FASTWAIT
+  if (NXSEM_FASTWAIT(sem))
     {
       short old = 1;
       if (atomic_compare_exchange_weak_explicit(NXSEM_COUNT(sem), &old, 0,
@@ -42,6 +42,35 @@
 
 #define NXSEM_COUNT(s) ((FAR atomic_short *)&(s)->semcount)
 
+/* Check whether a holder of the semaphore is registered */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+#  if CONFIG_SEM_PREALLOCHOLDERS > 0
+#    define NXSEM_HAS_HOLDER(s) ((s)->hhead != NULL)
+#  else
+#    define NXSEM_HAS_HOLDER(s) ((s)->holder.htcb != NULL)
+#  endif
+#else
+#  define NXSEM_HAS_HOLDER(s)   false
+#endif
+
+/* Check whether the semaphore may be taken (NXSEM_FASTWAIT) or given
+ * (NXSEM_FASTPOST) with an atomic operation on the count only.  This is
+ * the case for mutexes that do not need to maintain holders or ceilings.
+ * Holders of a priority inheritance mutex are only registered once a
+ * thread has to wait for it, see nxsem_boost_priority().
+ */
+
+#if !defined(CONFIG_PRIORITY_INHERITANCE) && !defined(CONFIG_PRIORITY_PROTECT)
+#  define NXSEM_FASTWAIT(s)     (((s)->flags & SEM_TYPE_MUTEX) != 0)
+#  define NXSEM_FASTPOST(s)     NXSEM_FASTWAIT(s)
+#elif defined(CONFIG_SEM_PRIO_FASTPATH)
+#  define NXSEM_FASTWAIT(s) \
+     (((s)->flags & SEM_TYPE_MUTEX) != 0 && \
+      ((s)->flags & SEM_PRIO_MASK) != SEM_PRIO_PROTECT)
+#  define NXSEM_FASTPOST(s)     (NXSEM_FASTWAIT(s) && !NXSEM_HAS_HOLDER(s))
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
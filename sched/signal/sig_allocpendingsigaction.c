@@ -42,14 +42,35 @@
  * Name: nxsig_alloc_pendingsigaction
  *
  * Description:
- *   Allocate a new element for the pending signal action queue
+ *   Allocate a new element for the pending signal action queue of stcb
  *
  ****************************************************************************/
 
-FAR sigq_t *nxsig_alloc_pendingsigaction(void)
+FAR sigq_t *nxsig_alloc_pendingsigaction(FAR struct tcb_s *stcb)
 {
   FAR sigq_t    *sigq;
   irqstate_t flags;
+#if CONFIG_SIG_PREALLOC_TCB_ACTIONS > 0
+  int i;
+
+  /* Try the structures pre-allocated in the TCB of the receiver first */
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_SIG_PREALLOC_TCB_ACTIONS; i++)
+    {
+      if ((stcb->sigactionbusy & (UINT32_C(1) << i)) == 0)
+        {
+          stcb->sigactionbusy |= UINT32_C(1) << i;
+          leave_critical_section(flags);
+
+          sigq       = &stcb->sigaction[i];
+          sigq->type = SIG_ALLOC_TCB;
+          return sigq;
+        }
+    }
+
+  leave_critical_section(flags);
+#endif
 
   /* Check if we were called from an interrupt handler. */
 
@@ -51,20 +51,21 @@ void nxsig_cleanup(FAR struct tcb_s *stcb)
 
   while ((sigq = (FAR sigq_t *)sq_remfirst(&stcb->sigpendactionq)) != NULL)
     {
-      nxsig_release_pendingsigaction(sigq);
+      nxsig_release_pendingsigaction(stcb, sigq);
     }
 
   /* Deallocate all entries in the list of posted signal actions */
 
   while ((sigq = (FAR sigq_t *)sq_remfirst(&stcb->sigpostedq)) != NULL)
     {
-      nxsig_release_pendingsigaction(sigq);
+      nxsig_release_pendingsigaction(stcb, sigq);
     }
 
   /* Misc. signal-related clean-up */
 
   sigfillset(&stcb->sigprocmask);
   sigemptyset(&stcb->sigwaitmask);
+  sigemptyset(&stcb->sigpendactionset);
 }
 
 /****************************************************************************
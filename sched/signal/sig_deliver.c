@@ -97,6 +97,10 @@ void nxsig_deliver(FAR struct tcb_s *stcb)
           break;
         }
 
+      /* A standard signal is coalesced while its action is queued */
+
+      nxsig_delset(&stcb->sigpendactionset, sigq->info.si_signo);
+
       /* Indicate that a signal is being delivered */
 
       stcb->flags |= TCB_FLAG_SIGNAL_ACTION;
@@ -206,7 +210,7 @@ void nxsig_deliver(FAR struct tcb_s *stcb)
 
       /* Then deallocate the signal structure */
 
-      nxsig_release_pendingsigaction(sigq);
+      nxsig_release_pendingsigaction(stcb, sigq);
     }
 
   /* Restore the saved errno value */
@@ -127,12 +127,36 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
 
   if ((sigact) && (sigact->act.sa_u._sa_sigaction))
     {
+      /* Standard signals do not queue: if the action of the signal is
+       * still queued, only update the signal information.  This needs
+       * neither an allocation nor another delivery.
+       */
+
+      flags = enter_critical_section();
+      if ((info->si_signo < SIGRTMIN || info->si_signo > SIGRTMAX) &&
+          nxsig_ismember(&stcb->sigpendactionset, info->si_signo) == 1)
+        {
+          for (sigq = (FAR sigq_t *)stcb->sigpendactionq.head;
+               sigq->info.si_signo != info->si_signo;
+               sigq = sigq->flink)
+            {
+              DEBUGASSERT(sigq->flink != NULL);
+            }
+
+          memcpy(&sigq->info, info, sizeof(siginfo_t));
+          sigq->info.si_user = sigact->act.sa_user;
+          leave_critical_section(flags);
+          return OK;
+        }
+
+      leave_critical_section(flags);
+
       /* Allocate a new element for the signal queue. NOTE:
        * nxsig_alloc_pendingsigaction will force a system crash if it is
        * unable to allocate memory for the signal data.
        */
 
-      sigq = nxsig_alloc_pendingsigaction();
+      sigq = nxsig_alloc_pendingsigaction(stcb);
       if (!sigq)
         {
           ret = -ENOMEM;
@@ -155,6 +179,10 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
 
           flags = enter_critical_section();
           sq_addlast((FAR sq_entry_t *)sigq, &(stcb->sigpendactionq));
+          if (info->si_signo < SIGRTMIN || info->si_signo > SIGRTMAX)
+            {
+              nxsig_addset(&stcb->sigpendactionset, info->si_signo);
+            }
 
           /* Then schedule execution of the signal handling action on the
            * recipient's thread. SMP related handling will be done in
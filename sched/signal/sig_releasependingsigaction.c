@@ -40,11 +40,12 @@
  * Name: nxsig_release_pendingsigaction
  *
  * Description:
- *   Deallocate a pending signal action Q entry
+ *   Deallocate a pending signal action Q entry of stcb
  *
  ****************************************************************************/
 
-void nxsig_release_pendingsigaction(FAR sigq_t *sigq)
+void nxsig_release_pendingsigaction(FAR struct tcb_s *stcb,
+                                    FAR sigq_t *sigq)
 {
   irqstate_t flags;
 
@@ -87,4 +88,15 @@ void nxsig_release_pendingsigaction(FAR sigq_t *sigq)
     {
       kmm_free(sigq);
     }
+
+#if CONFIG_SIG_PREALLOC_TCB_ACTIONS > 0
+  /* If this is a structure of the TCB, then mark its slot as free */
+
+  else if (sigq->type == SIG_ALLOC_TCB)
+    {
+      flags = enter_critical_section();
+      stcb->sigactionbusy &= ~(UINT32_C(1) << (sigq - stcb->sigaction));
+      leave_critical_section(flags);
+    }
+#endif
 }
@@ -39,6 +39,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/signal.h>
 #include <nuttx/cancelpt.h>
 #include <nuttx/queue.h>
@@ -254,8 +255,13 @@ int nxsig_clockwait(int clockid, int flags,
 {
   FAR struct tcb_s *rtcb = this_task();
   irqstate_t iflags;
+#ifdef CONFIG_HRTIMER
+  uint64_t expect = 0;
+  uint64_t stop;
+#else
   clock_t expect = 0;
   clock_t stop;
+#endif
 
   if (rqtp && (rqtp->tv_nsec < 0 || rqtp->tv_nsec >= 1000000000))
     {
@@ -300,6 +306,24 @@ int nxsig_clockwait(int clockid, int flags,
 
   if (rqtp)
     {
+#ifdef CONFIG_HRTIMER
+      /* Start the high resolution timer, the sleep is not rounded up to
+       * the system tick.
+       */
+
+      if ((flags & TIMER_ABSTIME) == 0)
+        {
+          expect = hrtimer_curtime() + clock_time2nsec(rqtp);
+          hrtimer_start_absnsec(&rtcb->waithrtimer, expect,
+                                nxsig_timeout, (uintptr_t)rtcb);
+        }
+      else
+        {
+          hrtimer_start_absnsec(&rtcb->waithrtimer,
+                                hrtimer_abstime2nsec(clockid, rqtp),
+                                nxsig_timeout, (uintptr_t)rtcb);
+        }
+#else
       /* Start the watchdog timer */
 
       if ((flags & TIMER_ABSTIME) == 0)
@@ -318,6 +342,7 @@ int nxsig_clockwait(int clockid, int flags,
           wd_start_abstime(&rtcb->waitdog, rqtp,
                            nxsig_timeout, (uintptr_t)rtcb);
         }
+#endif
     }
 
   /* Remove the tcb task from the ready-to-run list. */
@@ -337,15 +362,24 @@ int nxsig_clockwait(int clockid, int flags,
 
   if (rqtp)
     {
+#ifdef CONFIG_HRTIMER
+      hrtimer_cancel(&rtcb->waithrtimer);
+      stop = hrtimer_curtime();
+#else
       wd_cancel(&rtcb->waitdog);
       stop = clock_systime_ticks();
+#endif
     }
 
   leave_critical_section(iflags);
 
   if (rqtp && rmtp && expect)
     {
+#ifdef CONFIG_HRTIMER
+      clock_nsec2time(rmtp, expect > stop ? expect - stop : 0);
+#else
       clock_ticks2time(rmtp, expect > stop ? expect - stop : 0);
+#endif
     }
 
   return 0;
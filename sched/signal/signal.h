@@ -58,7 +58,8 @@ enum sigalloc_e
 {
   SIG_ALLOC_FIXED = 0,  /* pre-allocated; never freed */
   SIG_ALLOC_DYN,        /* dynamically allocated; free when unused */
-  SIG_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  SIG_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  SIG_ALLOC_TCB         /* Preallocated in the TCB of the receiver */
 };
 
 /* The following defines the sigaction queue entry */
@@ -85,24 +86,6 @@ struct sigpendq
 };
 typedef struct sigpendq sigpendq_t;
 
-/* The following defines the queue structure within each TCB to hold queued
- * signal actions that need action by the task
- */
-
-struct sigq_s
-{
-  FAR struct sigq_s *flink;      /* Forward link */
-  union
-  {
-    void (*sighandler)(int signo, siginfo_t *info, void *context);
-  } action;                      /* Signal action */
-  sigset_t  mask;                /* Additional signals to mask while the
-                                  * the signal-catching function executes */
-  siginfo_t info;                /* Signal information */
-  uint8_t   type;                /* (Used to manage allocations) */
-};
-typedef struct sigq_s sigq_t;
-
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -185,12 +168,13 @@ void nxsig_wait_irq(FAR struct tcb_s *wtcb, int errcode);
 
 /* In files of the same name */
 
-FAR sigq_t        *nxsig_alloc_pendingsigaction(void);
+FAR sigq_t        *nxsig_alloc_pendingsigaction(FAR struct tcb_s *stcb);
 void               nxsig_deliver(FAR struct tcb_s *stcb);
 FAR sigactq_t     *nxsig_find_action(FAR struct task_group_s *group,
                                      int signo);
 int                nxsig_lowest(FAR sigset_t *set);
-void               nxsig_release_pendingsigaction(FAR sigq_t *sigq);
+void               nxsig_release_pendingsigaction(FAR struct tcb_s *stcb,
+                                                  FAR sigq_t *sigq);
 void               nxsig_release_pendingsignal(FAR sigpendq_t *sigpend);
 FAR sigpendq_t    *nxsig_remove_pendingsignal(FAR struct tcb_s *stcb,
                                               int signo);
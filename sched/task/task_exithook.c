@@ -428,6 +428,12 @@ void nxtask_exithook(FAR struct tcb_s *tcb, int status)
 
   nxtask_recover(tcb);
 
+#ifdef CONFIG_FS_POLL_CACHE
+  /* Tear down the poll setup kept by the thread */
+
+  poll_cache_release(tcb);
+#endif
+
   /* Disable the scheduling function to prevent other tasks from
    * being deleted after they are awakened
    */
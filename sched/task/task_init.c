@@ -156,7 +156,8 @@ int nxtask_init(FAR struct task_tcb_s *tcb, const char *name, int priority,
     {
       /* Allocate the stack for the TCB */
 
-      ret = up_create_stack(&tcb->cmn, stack_size, ttype);
+      ret = nxsched_create_stack(&tcb->cmn, stack_size, ttype,
+                                 (uintptr_t)entry);
     }
 
   if (ret < OK)
@@ -212,7 +213,7 @@ errout_with_group:
       if (ttype == TCB_FLAG_TTYPE_KERNEL)
 #endif
         {
-          up_release_stack(&tcb->cmn, ttype);
+          nxsched_release_stack(&tcb->cmn, ttype);
         }
     }
 
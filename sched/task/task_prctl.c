@@ -28,6 +28,8 @@
 
 #include <sys/prctl.h>
 #include <stdarg.h>
+#include <stdint.h>
+#include <limits.h>
 #include <string.h>
 #include <errno.h>
 #include <debug.h>
@@ -148,6 +150,40 @@ int prctl(int option, ...)
         goto errout;
 #endif
 
+      case PR_SET_TIMERSLACK:
+      case PR_GET_TIMERSLACK:
+#ifdef CONFIG_SCHED_TIMER_SLACK
+        {
+          FAR struct tcb_s *rtcb = this_task();
+          int ret = OK;
+
+          if (option == PR_SET_TIMERSLACK)
+            {
+              unsigned long slack = va_arg(ap, unsigned long);
+
+              rtcb->timerslack = slack != 0 ? NSEC2TICK(slack) :
+                USEC2TICK(CONFIG_SCHED_TIMER_SLACK_DEFAULT);
+            }
+          else
+            {
+              /* A slack above INT_MAX ns (about 2.1 s) does not fit in the
+               * returned value and is reported as INT_MAX.
+               */
+
+              uint64_t slack = TICK2NSEC((uint64_t)rtcb->timerslack);
+
+              ret = slack > INT_MAX ? INT_MAX : (int)slack;
+            }
+
+          va_end(ap);
+          return ret;
+        }
+#else
+        serr("ERROR: Option not enabled: %d\n", option);
+        errcode = ENOSYS;
+        goto errout;
+#endif
+
       default:
         serr("ERROR: Unrecognized option: %d\n", option);
         errcode = EINVAL;
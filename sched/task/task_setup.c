@@ -463,6 +463,12 @@ static int nxthread_setup_scheduler(FAR struct tcb_s *tcb, int priority,
 
       tcb->sigprocmask = rtcb->sigprocmask;
 
+#ifdef CONFIG_SCHED_TIMER_SLACK
+      /* And the timer slack of the parent thread */
+
+      tcb->timerslack = rtcb->timerslack;
+#endif
+
       /* Initialize the task state.  It does not get a valid state
        * until it is activated.
        */
@@ -33,8 +33,10 @@
 #include <stdint.h>
 
 #include <nuttx/compiler.h>
+#include <nuttx/clock.h>
 #include <nuttx/signal.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
 
@@ -44,10 +46,53 @@
 
 #define PT_FLAGS_PREALLOCATED 0x01 /* Timer comes from a pool of preallocated timers */
 
+/* The POSIX timers are driven by the high resolution timers and count in
+ * nanoseconds with CONFIG_HRTIMER, otherwise by the watchdog timers and
+ * count in system ticks.
+ */
+
+#ifdef CONFIG_HRTIMER
+#  define timer_curtime()           hrtimer_curtime()
+#  define timer_time2delay(ts)      clock_time2nsec(ts)
+#  define timer_delay2time(ts, d)   clock_nsec2time(ts, d)
+#  define timer_abstime2expected(c, ts, e) \
+     (*(e) = hrtimer_abstime2nsec(c, ts))
+#  define timer_start(t, func) \
+     hrtimer_start_absnsec(&(t)->pt_hrtimer, (t)->pt_expected, func, \
+                           (wdparm_t)(t))
+#  define timer_stop(t)             hrtimer_cancel(&(t)->pt_hrtimer)
+#  define timer_remaining(t)        hrtimer_gettime(&(t)->pt_hrtimer)
+#else
+#  define timer_curtime()           clock_systime_ticks()
+#  define timer_time2delay(ts)      clock_time2ticks(ts)
+#  define timer_delay2time(ts, d)   clock_ticks2time(ts, d)
+#  define timer_abstime2expected(c, ts, e) \
+     do \
+       { \
+         clock_abstime2ticks(c, ts, e); \
+         *(e) += clock_systime_ticks(); \
+       } \
+     while (0)
+#  define timer_start(t, func) \
+     wd_start_abstick(&(t)->pt_wdog, (t)->pt_expected, func, (wdparm_t)(t))
+#  define timer_stop(t)             wd_cancel(&(t)->pt_wdog)
+#  define timer_remaining(t)        wd_gettime(&(t)->pt_wdog)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* The time unit of the POSIX timers, see timer_curtime() */
+
+#ifdef CONFIG_HRTIMER
+typedef uint64_t pt_clock_t;
+typedef int64_t  pt_sclock_t;
+#else
+typedef clock_t  pt_clock_t;
+typedef sclock_t pt_sclock_t;
+#endif
+
 /* This structure represents one POSIX timer */
 
 struct posix_timer_s
@@ -59,9 +104,13 @@ struct posix_timer_s
   uint8_t          pt_crefs;       /* Reference count */
   pid_t            pt_owner;       /* Creator of timer */
   int              pt_overrun;     /* Overrun time */
-  sclock_t         pt_delay;       /* If non-zero, used to reset repetitive timers */
-  clock_t          pt_expected;    /* Expected absolute time */
+  pt_sclock_t      pt_delay;       /* If non-zero, used to reset repetitive timers */
+  pt_clock_t       pt_expected;    /* Expected absolute time */
+#ifdef CONFIG_HRTIMER
+  struct hrtimer_s pt_hrtimer;     /* The timer that provides the timing */
+#else
   struct wdog_s    pt_wdog;        /* The watchdog that provides the timing */
+#endif
   struct sigevent  pt_event;       /* Notification information */
 #ifdef CONFIG_SIG_EVTHREAD
   struct sigwork_s pt_work;
@@ -73,7 +73,7 @@
 int timer_gettime(timer_t timerid, FAR struct itimerspec *value)
 {
   FAR struct posix_timer_s *timer = timer_gethandle(timerid);
-  sclock_t ticks;
+  pt_sclock_t ticks;
 
   if (!timer || !value)
     {
@@ -83,12 +83,12 @@ int timer_gettime(timer_t timerid, FAR struct itimerspec *value)
 
   /* Get the number of ticks before the underlying watchdog expires */
 
-  ticks = wd_gettime(&timer->pt_wdog);
+  ticks = timer_remaining(timer);
 
   /* Convert that to a struct timespec and return it */
 
-  clock_ticks2time(&value->it_value, ticks);
-  clock_ticks2time(&value->it_interval, timer->pt_delay);
+  timer_delay2time(&value->it_value, ticks);
+  timer_delay2time(&value->it_interval, timer->pt_delay);
   return OK;
 }
 
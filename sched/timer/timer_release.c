@@ -124,7 +124,7 @@ int timer_release(FAR struct posix_timer_s *timer)
 
   /* Cancel the underlying watchdog instance */
 
-  wd_cancel(&timer->pt_wdog);
+  timer_stop(timer);
 
   /* Cancel any pending notification */
 
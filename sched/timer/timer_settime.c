@@ -101,9 +101,9 @@ static inline void timer_signotify(FAR struct posix_timer_s *timer)
 static inline void timer_restart(FAR struct posix_timer_s *timer,
                                  wdparm_t itimer)
 {
-  clock_t ticks;
-  sclock_t delay;
-  sclock_t frame;
+  pt_clock_t ticks;
+  pt_sclock_t delay;
+  pt_sclock_t frame;
 
   /* If this is a repetitive timer, then restart the watchdog */
 
@@ -111,7 +111,7 @@ static inline void timer_restart(FAR struct posix_timer_s *timer,
     {
       /* Check whether next expected time is reached */
 
-      ticks = clock_systime_ticks();
+      ticks = timer_curtime();
       delay = ticks - timer->pt_expected;
 
       /* Calculate the number of timer overruns and the next expected tick.
@@ -131,8 +131,7 @@ static inline void timer_restart(FAR struct posix_timer_s *timer,
       timer->pt_overrun = frame - 1;
       timer->pt_expected += frame * timer->pt_delay;
 
-      wd_start_abstick(&timer->pt_wdog, timer->pt_expected,
-                       timer_timeout, itimer);
+      timer_start(timer, timer_timeout);
     }
 }
 
@@ -256,7 +255,7 @@ int timer_settime(timer_t timerid, int flags,
                   FAR struct itimerspec *ovalue)
 {
   FAR struct posix_timer_s *timer = timer_gethandle(timerid);
-  sclock_t delay;
+  pt_sclock_t delay;
   int ret = OK;
 
   /* Some sanity checks */
@@ -271,19 +270,19 @@ int timer_settime(timer_t timerid, int flags,
     {
       /* Get the number of ticks before the underlying watchdog expires */
 
-      delay = wd_gettime(&timer->pt_wdog);
+      delay = timer_remaining(timer);
 
       /* Convert that to a struct timespec and return it */
 
-      clock_ticks2time(&ovalue->it_value, delay);
-      clock_ticks2time(&ovalue->it_interval, timer->pt_delay);
+      timer_delay2time(&ovalue->it_value, delay);
+      timer_delay2time(&ovalue->it_interval, timer->pt_delay);
     }
 
   /* Disarm the timer (in case the timer was already armed when
    * timer_settime() is called).
    */
 
-  wd_cancel(&timer->pt_wdog);
+  timer_stop(timer);
 
   /* Cancel any pending notification */
 
@@ -302,7 +301,7 @@ int timer_settime(timer_t timerid, int flags,
 
   if (value->it_interval.tv_sec > 0 || value->it_interval.tv_nsec > 0)
     {
-      delay = clock_time2ticks(&value->it_interval);
+      delay = timer_time2delay(&value->it_interval);
       timer->pt_delay = delay;
     }
   else
@@ -316,9 +315,8 @@ int timer_settime(timer_t timerid, int flags,
     {
       /* Calculate a delay corresponding to the absolute time in 'value' */
 
-      clock_abstime2ticks(timer->pt_clock, &value->it_value,
-                          &timer->pt_expected);
-      timer->pt_expected += clock_systime_ticks();
+      timer_abstime2expected(timer->pt_clock, &value->it_value,
+                             &timer->pt_expected);
     }
   else
     {
@@ -327,14 +325,13 @@ int timer_settime(timer_t timerid, int flags,
        * returns success.
        */
 
-      delay = clock_time2ticks(&value->it_value);
-      timer->pt_expected = clock_systime_ticks() + delay;
+      delay = timer_time2delay(&value->it_value);
+      timer->pt_expected = timer_curtime() + delay;
     }
 
   /* Then start the watchdog */
 
-  ret = wd_start_abstick(&timer->pt_wdog, timer->pt_expected,
-                         timer_timeout, (wdparm_t)timer);
+  ret = timer_start(timer, timer_timeout);
 
   if (ret < 0)
     {
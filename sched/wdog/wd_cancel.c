@@ -38,6 +38,76 @@
 #include "sched/sched.h"
 #include "wdog/wdog.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_dequeue
+ *
+ * Description:
+ *   Remove an active watchdog from the timer queue and mark it inactive.
+ *   With CONFIG_WDOG_SPINLOCK, this also waits until the callback of the
+ *   watchdog has completed if it is being executed by another CPU.
+ *
+ * Input Parameters:
+ *   wdog - ID of the watchdog to cancel.
+ *
+ * Returned Value:
+ *   One if the watchdog was at the head of the timer queue, zero if it was
+ *   not, or -EINVAL if the watchdog was not active.
+ *
+ ****************************************************************************/
+
+static int wd_dequeue(FAR struct wdog_s *wdog)
+{
+  irqstate_t flags;
+  bool head;
+
+  flags = wd_lock();
+
+#ifdef CONFIG_WDOG_SPINLOCK
+  /* The callbacks of all CPUs are serialized by the critical section, so
+   * this can only spin if the caller does not hold it.
+   */
+
+  while (wdog != NULL && g_wdrunning == wdog &&
+         g_wdrunningcpu != this_cpu())
+    {
+      wd_unlock(flags);
+      flags = wd_lock();
+    }
+#endif
+
+  /* Make sure that the watchdog is valid and still active. */
+
+  if (wdog == NULL || !WDOG_ISACTIVE(wdog))
+    {
+      wd_unlock(flags);
+      return -EINVAL;
+    }
+
+  sched_note_wdog(NOTE_WDOG_CANCEL, (FAR void *)wdog->func,
+                  (FAR void *)(uintptr_t)wdog->expired);
+
+  /* Prohibit timer interactions with the timer queue until the
+   * cancellation is complete
+   */
+
+  head = wd_queue_isfirst(wdog);
+
+  /* Now, remove the watchdog from the timer queue */
+
+  wd_queue_del(wdog);
+
+  /* Mark the watchdog inactive */
+
+  wdog->func = NULL;
+
+  wd_unlock(flags);
+  return head ? 1 : 0;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -60,16 +130,27 @@
 
 int wd_cancel(FAR struct wdog_s *wdog)
 {
-  irqstate_t flags;
   int ret;
 
-  flags = enter_critical_section();
+  ret = wd_dequeue(wdog);
+
+#ifdef CONFIG_SCHED_TICKLESS
+  if (ret > 0)
+    {
+      irqstate_t flags;
 
-  ret = wd_cancel_irq(wdog);
+      /* If the watchdog was at the head of the timer queue, then
+       * we will need to re-adjust the interval timer that will
+       * generate the next interval event.
+       */
 
-  leave_critical_section(flags);
+      flags = enter_critical_section();
+      nxsched_reassess_timer();
+      leave_critical_section(flags);
+    }
+#endif
 
-  return ret;
+  return ret < 0 ? ret : OK;
 }
 
 /****************************************************************************
@@ -91,35 +172,12 @@ int wd_cancel(FAR struct wdog_s *wdog)
 
 int wd_cancel_irq(FAR struct wdog_s *wdog)
 {
-  bool head;
-
-  /* Make sure that the watchdog is valid and still active. */
-
-  if (wdog == NULL || !WDOG_ISACTIVE(wdog))
-    {
-      return -EINVAL;
-    }
-
-  sched_note_wdog(NOTE_WDOG_CANCEL, (FAR void *)wdog->func,
-                  (FAR void *)(uintptr_t)wdog->expired);
-
-  /* Prohibit timer interactions with the timer queue until the
-   * cancellation is complete
-   */
-
-  head = list_is_head(&g_wdactivelist, &wdog->node);
-
-  /* Now, remove the watchdog from the timer queue */
-
-  list_delete(&wdog->node);
-
-  /* Mark the watchdog inactive */
-
-  wdog->func = NULL;
+  int ret;
 
-  if (head)
+  ret = wd_dequeue(wdog);
+  if (ret > 0)
     {
-      /* If the watchdog is at the head of the timer queue, then
+      /* If the watchdog was at the head of the timer queue, then
        * we will need to re-adjust the interval timer that will
        * generate the next interval event.
        */
@@ -127,5 +185,5 @@ int wd_cancel_irq(FAR struct wdog_s *wdog)
       nxsched_reassess_timer();
     }
 
-  return OK;
+  return ret < 0 ? ret : OK;
 }
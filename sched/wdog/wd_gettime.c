@@ -65,3 +65,39 @@ sclock_t wd_gettime(FAR struct wdog_s *wdog)
 
   return delay < 0 ? 0 : delay;
 }
+
+/****************************************************************************
+ * Name: wd_nexttime
+ *
+ * Description:
+ *   This function returns the time remaining before the first active
+ *   watchdog timer expires, the next timer event in tickless mode.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the first watchdog expires.
+ *   A negative value means that no watchdog is active.
+ *
+ ****************************************************************************/
+
+sclock_t wd_nexttime(void)
+{
+  irqstate_t flags;
+  sclock_t delay = -1;
+
+  flags = wd_lock();
+
+  if (!wd_queue_empty())
+    {
+      delay = wd_queue_first()->expired - clock_systime_ticks();
+      if (delay < 0)
+        {
+          delay = 0;
+        }
+    }
+
+  wd_unlock(flags);
+  return delay;
+}
@@ -0,0 +1,240 @@
+/****************************************************************************
+ * sched/wdog/wd_heap.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_QUEUE_HEAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* In the heap the list node links a watchdog to its siblings:  node.next
+ * is the next sibling and node.prev is the previous sibling, or the parent
+ * if the watchdog is the first child.
+ */
+
+#define WD_NEXT(w)       ((FAR struct wdog_s *)(w)->node.next)
+#define WD_PREV(w)       ((FAR struct wdog_s *)(w)->node.prev)
+
+#define WD_SETNEXT(w, n) ((w)->node.next = (FAR struct wdlist_node *)(n))
+#define WD_SETPREV(w, p) ((w)->node.prev = (FAR struct wdlist_node *)(p))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_heap_meld
+ *
+ * Description:
+ *   Merge two heaps and return the new root.  Both 'a' and 'b' must be
+ *   roots without siblings.  With equal expiration times, 'a' stays the
+ *   root.
+ *
+ ****************************************************************************/
+
+static FAR struct wdog_s *wd_heap_meld(FAR struct wdog_s *a,
+                                       FAR struct wdog_s *b)
+{
+  FAR struct wdog_s *tmp;
+
+  if ((sclock_t)(b->expired - a->expired) < 0)
+    {
+      tmp = a;
+      a   = b;
+      b   = tmp;
+    }
+
+  /* Make 'b' the first child of 'a' */
+
+  WD_SETPREV(b, a);
+  WD_SETNEXT(b, a->child);
+  if (a->child != NULL)
+    {
+      WD_SETPREV(a->child, b);
+    }
+
+  a->child = b;
+  return a;
+}
+
+/****************************************************************************
+ * Name: wd_heap_merge_pairs
+ *
+ * Description:
+ *   Merge a list of sibling heaps into a single heap using the two-pass
+ *   pairing strategy and return the new root.
+ *
+ ****************************************************************************/
+
+static FAR struct wdog_s *wd_heap_merge_pairs(FAR struct wdog_s *first)
+{
+  FAR struct wdog_s *pairs = NULL;
+  FAR struct wdog_s *root = NULL;
+  FAR struct wdog_s *a;
+  FAR struct wdog_s *b;
+
+  /* First pass:  Meld the siblings pairwise from left to right and push
+   * the results onto a stack linked through node.next.
+   */
+
+  while (first != NULL)
+    {
+      a = first;
+      b = WD_NEXT(a);
+      WD_SETPREV(a, NULL);
+      WD_SETNEXT(a, NULL);
+
+      if (b != NULL)
+        {
+          first = WD_NEXT(b);
+          WD_SETPREV(b, NULL);
+          WD_SETNEXT(b, NULL);
+          a = wd_heap_meld(a, b);
+        }
+      else
+        {
+          first = NULL;
+        }
+
+      WD_SETNEXT(a, pairs);
+      pairs = a;
+    }
+
+  /* Second pass:  Meld the pairs from right to left */
+
+  while (pairs != NULL)
+    {
+      a     = pairs;
+      pairs = WD_NEXT(a);
+      WD_SETNEXT(a, NULL);
+
+      root = root != NULL ? wd_heap_meld(a, root) : a;
+    }
+
+  return root;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_queue_add
+ *
+ * Description:
+ *   Insert the watchdog into the active watchdog heap.  wdog->expired must
+ *   be set by the caller.
+ *
+ * Assumptions:
+ *   Called with the watchdog queue locked.
+ *
+ ****************************************************************************/
+
+void wd_queue_add(FAR struct wdog_s *wdog)
+{
+  WD_SETPREV(wdog, NULL);
+  WD_SETNEXT(wdog, NULL);
+  wdog->child = NULL;
+
+  if (g_wdactiveheap == NULL)
+    {
+      g_wdactiveheap = wdog;
+    }
+  else
+    {
+      g_wdactiveheap = wd_heap_meld(g_wdactiveheap, wdog);
+    }
+}
+
+/****************************************************************************
+ * Name: wd_queue_del
+ *
+ * Description:
+ *   Remove an active watchdog from the active watchdog heap.
+ *
+ * Assumptions:
+ *   Called with the watchdog queue locked.
+ *
+ ****************************************************************************/
+
+void wd_queue_del(FAR struct wdog_s *wdog)
+{
+  FAR struct wdog_s *prev;
+  FAR struct wdog_s *next;
+  FAR struct wdog_s *sub;
+
+  DEBUGASSERT(g_wdactiveheap != NULL);
+
+  sub = wd_heap_merge_pairs(wdog->child);
+
+  if (wdog == g_wdactiveheap)
+    {
+      g_wdactiveheap = sub;
+    }
+  else
+    {
+      /* Cut the watchdog and its subtree out of the heap */
+
+      prev = WD_PREV(wdog);
+      next = WD_NEXT(wdog);
+
+      if (prev->child == wdog)
+        {
+          prev->child = next;
+        }
+      else
+        {
+          WD_SETNEXT(prev, next);
+        }
+
+      if (next != NULL)
+        {
+          WD_SETPREV(next, prev);
+        }
+
+      /* And meld the remaining children back into the heap */
+
+      if (sub != NULL)
+        {
+          g_wdactiveheap = wd_heap_meld(g_wdactiveheap, sub);
+        }
+    }
+
+  WD_SETPREV(wdog, NULL);
+  WD_SETNEXT(wdog, NULL);
+  wdog->child = NULL;
+}
+
+#endif /* CONFIG_WDOG_QUEUE_HEAP */
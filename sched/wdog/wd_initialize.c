@@ -34,12 +34,31 @@
  * Public Data
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_QUEUE_HEAP
+/* The g_wdactiveheap is the root of a pairing heap ordered by watchdog
+ * expiration time.
+ */
+
+FAR struct wdog_s *g_wdactiveheap;
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 struct list_node g_wdactivelist = LIST_INITIAL_VALUE(g_wdactivelist);
+#endif
+
+#ifdef CONFIG_WDOG_SPINLOCK
+/* The spinlock that protects the active watchdog queue */
+
+spinlock_t g_wdspinlock = SP_UNLOCKED;
+
+/* The watchdog whose callback is being executed and the CPU executing it */
+
+FAR struct wdog_s *volatile g_wdrunning;
+volatile int g_wdrunningcpu;
+#endif
 
 /****************************************************************************
  * Public Functions
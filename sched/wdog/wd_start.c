@@ -94,6 +94,73 @@ static unsigned int g_wdtimernested;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: wd_dequeue_expired
+ *
+ * Description:
+ *   Remove the watchdog at the head of the queue if it has expired and
+ *   mark it inactive.
+ *
+ * Input Parameters:
+ *   ticks - current time in ticks
+ *   func  - Location to return the watchdog function
+ *   arg   - Location to return the watchdog argument
+ *
+ * Returned Value:
+ *   The expired watchdog or NULL if there is none.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+static inline_function
+FAR struct wdog_s *wd_dequeue_expired(clock_t ticks, FAR wdentry_t *func,
+                                      FAR wdparm_t *arg)
+{
+  FAR struct wdog_s *wdog = NULL;
+
+#ifdef CONFIG_WDOG_SPINLOCK
+  spin_lock(&g_wdspinlock);
+#endif
+
+  if (!wd_queue_empty())
+    {
+      wdog = wd_queue_first();
+
+      /* Check if expected time is expired */
+
+      if (clock_compare(wdog->expired, ticks))
+        {
+          /* Remove the watchdog from the head of the list */
+
+          wd_queue_del(wdog);
+
+          /* Indicate that the watchdog is no longer active. */
+
+          *func = wdog->func;
+          *arg  = wdog->arg;
+          wdog->func = NULL;
+
+          up_setpicbase(wdog->picbase);
+        }
+      else
+        {
+          wdog = NULL;
+        }
+    }
+
+#ifdef CONFIG_WDOG_SPINLOCK
+  /* Publish the watchdog whose callback is about to run */
+
+  g_wdrunning    = wdog;
+  g_wdrunningcpu = this_cpu();
+  spin_unlock(&g_wdspinlock);
+#endif
+
+  return wdog;
+}
+
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -111,9 +178,13 @@ static unsigned int g_wdtimernested;
 
 static inline_function void wd_expiration(clock_t ticks)
 {
-  FAR struct wdog_s *wdog;
   irqstate_t flags;
   wdentry_t func;
+  wdparm_t arg;
+
+  /* The watchdog functions still run within the critical section, only
+   * the queue itself may be protected by its own lock.
+   */
 
   flags = enter_critical_section();
 
@@ -129,30 +200,11 @@ static inline_function void wd_expiration(clock_t ticks)
    * other watchdogs that became ready to run at this time
    */
 
-  while (!list_is_empty(&g_wdactivelist))
+  while (wd_dequeue_expired(ticks, &func, &arg) != NULL)
     {
-      wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
-
-      /* Check if expected time is expired */
-
-      if (!clock_compare(wdog->expired, ticks))
-        {
-          break;
-        }
-
-      /* Remove the watchdog from the head of the list */
-
-      list_delete(&wdog->node);
-
-      /* Indicate that the watchdog is no longer active. */
-
-      func = wdog->func;
-      wdog->func = NULL;
-
       /* Execute the watchdog function */
 
-      up_setpicbase(wdog->picbase);
-      CALL_FUNC(func, wdog->arg);
+      CALL_FUNC(func, arg);
     }
 
 #ifdef CONFIG_SCHED_TICKLESS
@@ -168,8 +220,8 @@ static inline_function void wd_expiration(clock_t ticks)
  * Name: wd_insert
  *
  * Description:
- *   Insert the timer into the global list to ensure that
- *   the list is sorted in increasing order of expiration absolute time.
+ *   Insert the timer into the active watchdog queue to ensure that
+ *   the queue is sorted in increasing order of expiration absolute time.
  *
  * Input Parameters:
  *   wdog     - Watchdog ID
@@ -189,34 +241,47 @@ static inline_function
 void wd_insert(FAR struct wdog_s *wdog, clock_t expired,
                wdentry_t wdentry, wdparm_t arg)
 {
-  FAR struct wdog_s *curr;
+  wdog->expired = expired;
+  wd_queue_add(wdog);
 
-  /* Traverse the watchdog list */
+  wdog->func = wdentry;
+  up_getpicbase(&wdog->picbase);
+  wdog->arg = arg;
+}
 
-  list_for_every_entry(&g_wdactivelist, curr, struct wdog_s, node)
-    {
-      /* Until curr->expired has not timed out relative to expired */
+/****************************************************************************
+ * Name: wd_slack
+ *
+ * Description:
+ *   Apply the timer slack of the calling task to the expiration time of its
+ *   timed waits, which all use the waitdog of the task.  The expiration is
+ *   rounded up to a multiple of the slack so that the timers falling in
+ *   the same slack window expire on the same tick.
+ *
+ ****************************************************************************/
 
-      if (!clock_compare(curr->expired, expired))
-        {
-          break;
-        }
-    }
+#ifdef CONFIG_SCHED_TIMER_SLACK
+static inline_function clock_t wd_slack(FAR struct wdog_s *wdog,
+                                        clock_t ticks)
+{
+  FAR struct tcb_s *rtcb;
+  clock_t rem;
 
-  /* There are two cases:
-   * - Traverse to the end, where curr == &g_wdactivelist.
-   * - Find a curr such that curr->expected has not timed out
-   * relative to expired.
-   * In either case 1 or 2, we just insert the wdog before curr.
-   */
+  if (up_interrupt_context())
+    {
+      return ticks;
+    }
 
-  list_add_before(&curr->node, &wdog->node);
+  rtcb = this_task();
+  if (wdog != &rtcb->waitdog || rtcb->timerslack <= 1)
+    {
+      return ticks;
+    }
 
-  wdog->func = wdentry;
-  up_getpicbase(&wdog->picbase);
-  wdog->arg = arg;
-  wdog->expired = expired;
+  rem = ticks % rtcb->timerslack;
+  return rem != 0 ? ticks + rtcb->timerslack - rem : ticks;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -288,48 +353,54 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
   ticks++;
 
+#ifdef CONFIG_SCHED_TIMER_SLACK
+  /* Let timed waits of the calling task expire together with others */
+
+  ticks = wd_slack(wdog, ticks);
+#endif
+
   /* NOTE:  There is a race condition here... the caller may receive
    * the watchdog between the time that wd_start_abstick is called and
-   * the critical section is established.
+   * the queue is locked.
    */
 
-  flags = enter_critical_section();
-#ifdef CONFIG_SCHED_TICKLESS
-  /* We need to reassess timer if the watchdog list head has changed. */
+  flags = wd_lock();
+
+  /* Check if the watchdog has been started. If so, delete it.  We need to
+   * reassess timer if the watchdog list head has changed.
+   */
 
   if (WDOG_ISACTIVE(wdog))
     {
-      reassess |= list_is_head(&g_wdactivelist, &wdog->node);
-      list_delete(&wdog->node);
+      reassess |= wd_queue_isfirst(wdog);
+      wd_queue_del(wdog);
       wdog->func = NULL;
     }
 
   wd_insert(wdog, ticks, wdentry, arg);
+  reassess |= wd_queue_isfirst(wdog);
 
-  if (!g_wdtimernested &&
-      (reassess || list_is_head(&g_wdactivelist, &wdog->node)))
+  wd_unlock(flags);
+
+#ifdef CONFIG_SCHED_TICKLESS
+  if (reassess)
     {
       /* Resume the interval timer that will generate the next
        * interval event. If the timer at the head of the list changed,
        * then this will pick that new delay.
        */
 
-      nxsched_reassess_timer();
+      flags = enter_critical_section();
+      if (!g_wdtimernested)
+        {
+          nxsched_reassess_timer();
+        }
+
+      leave_critical_section(flags);
     }
 #else
   UNUSED(reassess);
-
-  /* Check if the watchdog has been started. If so, delete it. */
-
-  if (WDOG_ISACTIVE(wdog))
-    {
-      list_delete(&wdog->node);
-      wdog->func = NULL;
-    }
-
-  wd_insert(wdog, ticks, wdentry, arg);
 #endif
-  leave_critical_section(flags);
 
   sched_note_wdog(NOTE_WDOG_START, wdentry, (FAR void *)(uintptr_t)ticks);
   return OK;
@@ -425,13 +496,13 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
       wd_expiration(ticks);
     }
 
-  flags = enter_critical_section();
+  flags = wd_lock();
 
   /* Return the delay for the next watchdog to expire */
 
-  if (list_is_empty(&g_wdactivelist))
+  if (wd_queue_empty())
     {
-      leave_critical_section(flags);
+      wd_unlock(flags);
       return 0;
     }
 
@@ -439,10 +510,10 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
    * may get negative value.
    */
 
-  wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
+  wdog = wd_queue_first();
   ret = wdog->expired - ticks;
 
-  leave_critical_section(flags);
+  wd_unlock(flags);
 
   /* Return the delay for the next watchdog to expire */
 
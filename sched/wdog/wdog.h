@@ -34,7 +34,9 @@
 
 #include <nuttx/compiler.h>
 #include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/queue.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/wdog.h>
 #include <nuttx/list.h>
 
@@ -46,6 +48,18 @@
 
 #define list_node wdlist_node
 
+/* Lock the active watchdog queue.  With CONFIG_WDOG_SPINLOCK the queue has
+ * its own spinlock, otherwise it is protected by the critical section.
+ */
+
+#ifdef CONFIG_WDOG_SPINLOCK
+#  define wd_lock()             spin_lock_irqsave(&g_wdspinlock)
+#  define wd_unlock(flags)      spin_unlock_irqrestore(&g_wdspinlock, flags)
+#else
+#  define wd_lock()             enter_critical_section()
+#  define wd_unlock(flags)      leave_critical_section(flags)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -58,12 +72,92 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifdef CONFIG_WDOG_QUEUE_HEAP
+/* The g_wdactiveheap is the root of a pairing heap ordered by watchdog
+ * expiration time.  In the heap, node.prev points to the parent (for the
+ * first child) or to the previous sibling, and node.next points to the
+ * next sibling.
+ */
+
+extern FAR struct wdog_s *g_wdactiveheap;
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern struct list_node g_wdactivelist;
+#endif
+
+#ifdef CONFIG_WDOG_SPINLOCK
+/* The spinlock that protects the active watchdog queue */
+
+extern spinlock_t g_wdspinlock;
+
+/* The watchdog whose callback is being executed and the CPU executing it.
+ * wd_cancel() waits for the callback to complete before it returns.
+ */
+
+extern FAR struct wdog_s *volatile g_wdrunning;
+extern volatile int g_wdrunningcpu;
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/* The following helpers hide the data structure that holds the active
+ * watchdogs.  All of them must be called with the queue locked, see
+ * wd_lock().
+ */
+
+#ifdef CONFIG_WDOG_QUEUE_HEAP
+#  define wd_queue_empty()      (g_wdactiveheap == NULL)
+#  define wd_queue_first()      (g_wdactiveheap)
+#  define wd_queue_isfirst(w)   (g_wdactiveheap == (w))
+#else
+#  define wd_queue_empty()      list_is_empty(&g_wdactivelist)
+#  define wd_queue_first() \
+     list_first_entry(&g_wdactivelist, struct wdog_s, node)
+#  define wd_queue_isfirst(w)   list_is_head(&g_wdactivelist, &(w)->node)
+#  define wd_queue_del(w)       list_delete(&(w)->node)
+
+/****************************************************************************
+ * Name: wd_queue_add
+ *
+ * Description:
+ *   Insert the timer into the global list to ensure that the list is sorted
+ *   in increasing order of expiration absolute time.  wdog->expired must be
+ *   set by the caller.
+ *
+ ****************************************************************************/
+
+static inline_function void wd_queue_add(FAR struct wdog_s *wdog)
+{
+  FAR struct wdog_s *curr;
+
+  /* Traverse the watchdog list */
+
+  list_for_every_entry(&g_wdactivelist, curr, struct wdog_s, node)
+    {
+      /* Until curr->expired has not timed out relative to expired */
+
+      if (!clock_compare(curr->expired, wdog->expired))
+        {
+          break;
+        }
+    }
+
+  /* There are two cases:
+   * - Traverse to the end, where curr == &g_wdactivelist.
+   * - Find a curr such that curr->expected has not timed out
+   * relative to expired.
+   * In either case 1 or 2, we just insert the wdog before curr.
+   */
+
+  list_add_before(&curr->node, &wdog->node);
+}
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -101,6 +195,35 @@ clock_t wd_timer(clock_t ticks, bool noswitches);
 void wd_timer(clock_t ticks);
 #endif
 
+/****************************************************************************
+ * Name: wd_queue_add
+ *
+ * Description:
+ *   Insert the watchdog into the active watchdog heap.  wdog->expired must
+ *   be set by the caller.
+ *
+ * Assumptions:
+ *   Called with the watchdog queue locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_QUEUE_HEAP
+void wd_queue_add(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_queue_del
+ *
+ * Description:
+ *   Remove an active watchdog from the active watchdog heap.
+ *
+ * Assumptions:
+ *   Called with the watchdog queue locked.
+ *
+ ****************************************************************************/
+
+void wd_queue_del(FAR struct wdog_s *wdog);
+#endif
+
 /****************************************************************************
  * Name: wd_recover
  *
@@ -53,6 +53,15 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
       return -EINVAL;
     }
 
+  /* The work is on the queue it was last queued on, which is not that of
+   * the caller's CPU for the per-CPU queues.
+   */
+
+  if (work->wq != NULL)
+    {
+      wqueue = work->wq;
+    }
+
   /* Cancelling the work is simply a matter of removing the work structure
    * from the work queue.  This must be done with interrupts disabled because
    * new work is typically added to the work queue from interrupt handlers.
@@ -72,6 +81,9 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
       else
         {
           dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+          wqueue->stats.depth--;
+#endif
         }
 
       work->worker = NULL;
@@ -0,0 +1,459 @@
+/****************************************************************************
+ * sched/wqueue/kwork_procfs.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/allsyms.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/symtab.h>
+
+#include "wqueue/wqueue.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Output format:
+ *
+ *   QUEUE   THREADS SPARES DEPTH MAXDEPTH      COUNT   WAIT_AVG   WAIT_MAX
+ *     RUN_MAX
+ *   SSSSSSS     DDD    DDD DDDDD    DDDDD DDDDDDDDDD DDDDDDDDDD DDDDDDDDDD
+ *   DDDDDDDDDD
+ *
+ * Followed by the worker functions, by symbol name with CONFIG_ALLSYMS:
+ *
+ *   WORKER                        COUNT   WAIT_AVG   WAIT_MAX    RUN_AVG
+ *      RUN_MAX
+ *   SSSSSSSSSSSSSSSSSSSSSSSS DDDDDDDDDD DDDDDDDDDD DDDDDDDDDD DDDDDDDDDD
+ *   DDDDDDDDDD
+ *
+ * The times are in nanoseconds.
+ */
+
+#define HDR_FMT     "QUEUE   THREADS SPARES DEPTH MAXDEPTH      COUNT   " \
+                    "WAIT_AVG   WAIT_MAX    RUN_MAX\n"
+#define QUEUE_FMT   "%-7s     %3u    %3u %5u    %5u %10lu %10llu %10llu " \
+                    "%10llu\n"
+#define FHDR_FMT    "\nWORKER                        COUNT   WAIT_AVG   " \
+                    "WAIT_MAX    RUN_AVG    RUN_MAX\n"
+#define FUNC_FMT    "%-24.24s %10lu %10llu %10llu %10llu %10llu\n"
+#define DROP_FMT    "%-24s %10lu\n"
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic (plus a couple of
+ * bytes).
+ */
+
+#define WQUEUE_LINELEN 96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct wqueue_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  char line[WQUEUE_LINELEN];    /* Pre-allocated buffer for formatted lines */
+};
+
+/* The state of a read */
+
+struct wqueue_read_s
+{
+  FAR struct wqueue_file_s *wfile;
+  FAR char *buffer;
+  size_t buflen;
+  size_t totalsize;
+  off_t offset;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     wqueue_open(FAR struct file *filep, FAR const char *relpath,
+                           int oflags, mode_t mode);
+static int     wqueue_close(FAR struct file *filep);
+static ssize_t wqueue_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen);
+static int     wqueue_dup(FAR const struct file *oldp,
+                          FAR struct file *newp);
+static int     wqueue_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_procfs.c -- this structure is explicitly extern'ed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_wqueue_operations =
+{
+  wqueue_open,   /* open */
+  wqueue_close,  /* close */
+  wqueue_read,   /* read */
+  NULL,          /* write */
+  NULL,          /* poll */
+
+  wqueue_dup,    /* dup */
+
+  NULL,          /* opendir */
+  NULL,          /* closedir */
+  NULL,          /* readdir */
+  NULL,          /* rewinddir */
+
+  wqueue_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wqueue_ns
+ ****************************************************************************/
+
+static unsigned long long wqueue_ns(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return (unsigned long long)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: wqueue_print
+ ****************************************************************************/
+
+static void wqueue_print(FAR struct wqueue_read_s *rd, FAR const char *name,
+                         FAR struct kwork_wqueue_s *wqueue)
+{
+  FAR struct wqueue_file_s *wfile = rd->wfile;
+  struct kwork_stats_s stats;
+  irqstate_t flags;
+  size_t linesize;
+  clock_t waitavg;
+
+  if (rd->totalsize >= rd->buflen)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  stats = wqueue->stats;
+  leave_critical_section(flags);
+
+  waitavg = stats.count > 0 ? stats.waitsum / stats.count : 0;
+  linesize = snprintf(wfile->line, WQUEUE_LINELEN, QUEUE_FMT, name,
+                      wqueue->nthreads - wqueue->nspares, wqueue->nspares,
+                      stats.depth, stats.depthmax,
+                      (unsigned long)stats.count, wqueue_ns(waitavg),
+                      wqueue_ns(stats.waitmax), wqueue_ns(stats.runmax));
+
+  rd->totalsize += procfs_memcpy(wfile->line, linesize,
+                                 rd->buffer + rd->totalsize,
+                                 rd->buflen - rd->totalsize, &rd->offset);
+}
+
+/****************************************************************************
+ * Name: wqueue_print_funcs
+ *
+ * Description:
+ *   Print the statistics of the worker functions, in the order of the hash
+ *   table.  The functions are named by their symbol if CONFIG_ALLSYMS is
+ *   selected, or else by their address.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_WORKQUEUE_NFUNCS > 0
+static void wqueue_print_funcs(FAR struct wqueue_read_s *rd)
+{
+  FAR struct wqueue_file_s *wfile = rd->wfile;
+#ifdef CONFIG_ALLSYMS
+  FAR const struct symtab_s *symbol;
+#endif
+  struct kwork_fstats_s fstats;
+  irqstate_t flags;
+  uint32_t dropped;
+  size_t linesize;
+  char name[32];
+  int i;
+
+  linesize = snprintf(wfile->line, WQUEUE_LINELEN, FHDR_FMT);
+  rd->totalsize += procfs_memcpy(wfile->line, linesize,
+                                 rd->buffer + rd->totalsize,
+                                 rd->buflen - rd->totalsize, &rd->offset);
+
+  for (i = 0; i < CONFIG_SCHED_WORKQUEUE_NFUNCS; i++)
+    {
+      if (rd->totalsize >= rd->buflen)
+        {
+          return;
+        }
+
+      flags  = enter_critical_section();
+      fstats = g_work_fstats[i];
+      leave_critical_section(flags);
+
+      if (fstats.worker == NULL)
+        {
+          continue;
+        }
+
+#ifdef CONFIG_ALLSYMS
+      symbol = allsyms_findbyvalue((FAR void *)fstats.worker, NULL);
+      if (symbol != NULL)
+        {
+          strlcpy(name, symbol->sym_name, sizeof(name));
+        }
+      else
+#endif
+        {
+          snprintf(name, sizeof(name), "%p", fstats.worker);
+        }
+
+      linesize = snprintf(wfile->line, WQUEUE_LINELEN, FUNC_FMT, name,
+                          (unsigned long)fstats.count,
+                          wqueue_ns(fstats.waitsum / fstats.count),
+                          wqueue_ns(fstats.waitmax),
+                          wqueue_ns(fstats.runsum / fstats.count),
+                          wqueue_ns(fstats.runmax));
+
+      rd->totalsize += procfs_memcpy(wfile->line, linesize,
+                                     rd->buffer + rd->totalsize,
+                                     rd->buflen - rd->totalsize,
+                                     &rd->offset);
+    }
+
+  /* The work of the functions that did not fit in the table */
+
+  dropped = g_work_fdropped;
+  if (dropped > 0 && rd->totalsize < rd->buflen)
+    {
+      linesize = snprintf(wfile->line, WQUEUE_LINELEN, DROP_FMT,
+                          "(dropped)", (unsigned long)dropped);
+      rd->totalsize += procfs_memcpy(wfile->line, linesize,
+                                     rd->buffer + rd->totalsize,
+                                     rd->buflen - rd->totalsize,
+                                     &rd->offset);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: wqueue_open
+ ****************************************************************************/
+
+static int wqueue_open(FAR struct file *filep, FAR const char *relpath,
+                       int oflags, mode_t mode)
+{
+  FAR struct wqueue_file_s *wfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* This PROCFS file is read-only.  Any attempt to open with write access
+   * is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  wfile = kmm_zalloc(sizeof(struct wqueue_file_s));
+  if (!wfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)wfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_close
+ ****************************************************************************/
+
+static int wqueue_close(FAR struct file *filep)
+{
+  FAR struct wqueue_file_s *wfile;
+
+  /* Recover our private data from the struct file instance */
+
+  wfile = (FAR struct wqueue_file_s *)filep->f_priv;
+  DEBUGASSERT(wfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(wfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_read
+ ****************************************************************************/
+
+static ssize_t wqueue_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  struct wqueue_read_s rd;
+  size_t linesize;
+#if defined(CONFIG_SCHED_HPWORK) && defined(CONFIG_SCHED_HPWORK_PERCPU)
+  char name[16];
+  int cpu;
+#endif
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  rd.wfile     = (FAR struct wqueue_file_s *)filep->f_priv;
+  rd.buffer    = buffer;
+  rd.buflen    = buflen;
+  rd.totalsize = 0;
+  rd.offset    = filep->f_pos;
+  DEBUGASSERT(rd.wfile);
+
+  /* The first line to output is the header */
+
+  linesize = snprintf(rd.wfile->line, WQUEUE_LINELEN, HDR_FMT);
+  rd.totalsize = procfs_memcpy(rd.wfile->line, linesize, rd.buffer,
+                               rd.buflen, &rd.offset);
+
+#ifdef CONFIG_SCHED_HPWORK
+#  ifdef CONFIG_SCHED_HPWORK_PERCPU
+  for (cpu = 0; cpu < HPWORK_NQUEUES; cpu++)
+    {
+      snprintf(name, sizeof(name), HPWORKNAME "%d", cpu);
+      wqueue_print(&rd, name, (FAR struct kwork_wqueue_s *)&g_hpwork[cpu]);
+    }
+#  else
+  wqueue_print(&rd, HPWORKNAME, (FAR struct kwork_wqueue_s *)&g_hpwork[0]);
+#  endif
+#endif
+
+#ifdef CONFIG_SCHED_LPWORK
+  wqueue_print(&rd, LPWORKNAME, (FAR struct kwork_wqueue_s *)&g_lpwork);
+#endif
+
+#if CONFIG_SCHED_WORKQUEUE_NFUNCS > 0
+  if (rd.totalsize < rd.buflen)
+    {
+      wqueue_print_funcs(&rd);
+    }
+#endif
+
+  /* Update the file position */
+
+  filep->f_pos += rd.totalsize;
+  return rd.totalsize;
+}
+
+/****************************************************************************
+ * Name: wqueue_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int wqueue_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct wqueue_file_s *oldattr;
+  FAR struct wqueue_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct wqueue_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct wqueue_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct wqueue_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int wqueue_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "wqueue" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_WORKQUEUE_STATS */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
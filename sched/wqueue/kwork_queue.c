@@ -36,6 +36,7 @@
 #include <nuttx/queue.h>
 #include <nuttx/wqueue.h>
 
+#include "sched/sched.h"
 #include "wqueue/wqueue.h"
 
 #ifdef CONFIG_SCHED_WORKQUEUE
@@ -44,16 +45,38 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Stamp the work with the time it was queued and track the queue depth */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+#  define work_stamp(wqueue, work) \
+     do \
+       { \
+         (work)->stime = perf_gettime(); \
+         if (++(wqueue)->stats.depth > (wqueue)->stats.depthmax) \
+           { \
+             (wqueue)->stats.depthmax = (wqueue)->stats.depth; \
+           } \
+       } \
+     while (0)
+#else
+#  define work_stamp(wqueue, work)
+#endif
+
 #define queue_work(wqueue, work) \
   do \
     { \
       int sem_count; \
+      work_stamp(wqueue, work); \
       dq_addlast((FAR dq_entry_t *)(work), &(wqueue)->q); \
       nxsem_get_value(&(wqueue)->sem, &sem_count); \
       if (sem_count < 0) /* There are threads waiting for sem. */ \
         { \
           nxsem_post(&(wqueue)->sem); \
         } \
+      else if ((wqueue)->nspares > 0) \
+        { \
+          work_wake_spare(wqueue); \
+        } \
     } \
   while (0)
 
@@ -61,6 +84,38 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_wake_spare
+ *
+ * Description:
+ *   Wake a spare worker if all the workers are blocked, busy with work that
+ *   waits for I/O or a lock for example.  A worker that can run gets to the
+ *   queued work by itself.
+ *
+ ****************************************************************************/
+
+static void work_wake_spare(FAR struct kwork_wqueue_s *wqueue)
+{
+  FAR struct tcb_s *tcb;
+  int semcount;
+  int wndx;
+
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+    {
+      tcb = nxsched_get_tcb(wqueue->worker[wndx].pid);
+      if (tcb == NULL || tcb->task_state < FIRST_BLOCKED_STATE)
+        {
+          return;
+        }
+    }
+
+  nxsem_get_value(&wqueue->spare, &semcount);
+  if (semcount < 0)
+    {
+      nxsem_post(&wqueue->spare);
+    }
+}
+
 /****************************************************************************
  * Name: work_timer_expiry
  ****************************************************************************/
@@ -154,7 +209,12 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
       work_cancel_wq(wqueue, work);
     }
 
-  if (work_is_canceling(wqueue->worker, wqueue->nthreads, work))
+  /* The work may last have been queued on another queue, that of another
+   * CPU for example.
+   */
+
+  if (work->wq != NULL &&
+      work_is_canceling(work->wq->worker, work->wq->nthreads, work))
     {
       goto out;
     }
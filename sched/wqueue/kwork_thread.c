@@ -55,23 +55,27 @@
 #endif
 
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_WQUEUE > 0
-#  define CALL_WORKER(worker, arg) \
+#  define CHECK_WORKER(worker, elapsed) \
      do \
        { \
-         clock_t start; \
-         clock_t elapsed; \
-         start = perf_gettime(); \
-         worker(arg); \
-         elapsed = perf_gettime() - start; \
-         if (elapsed > CONFIG_SCHED_CRITMONITOR_MAXTIME_WQUEUE) \
+         if ((elapsed) > CONFIG_SCHED_CRITMONITOR_MAXTIME_WQUEUE) \
            { \
              CRITMONITOR_PANIC("WORKER %p execute too long %ju\n", \
-                               worker, (uintmax_t)elapsed); \
+                               worker, (uintmax_t)(elapsed)); \
            } \
        } \
      while (0)
 #else
-#  define CALL_WORKER(worker, arg) worker(arg)
+#  define CHECK_WORKER(worker, elapsed)
+#endif
+
+/* The run time of the work is measured for the critical section monitor
+ * and the statistics.
+ */
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_WQUEUE > 0 || \
+    defined(CONFIG_SCHED_WORKQUEUE_STATS)
+#  define WORKER_TIMING
 #endif
 
 /****************************************************************************
@@ -79,14 +83,22 @@
  ****************************************************************************/
 
 #if defined(CONFIG_SCHED_HPWORK)
-/* The state of the kernel mode, high priority work queue(s). */
+/* The state of the kernel mode, high priority work queue(s).  The queues
+ * of the other CPUs are completed by work_start_highpri(), an all zero
+ * queue is empty.
+ */
 
-struct hp_wqueue_s g_hpwork =
+struct hp_wqueue_s g_hpwork[HPWORK_NQUEUES] =
 {
-  {NULL, NULL},
-  SEM_INITIALIZER(0),
-  SEM_INITIALIZER(0),
-  CONFIG_SCHED_HPNTHREADS,
+  {
+    {NULL, NULL},
+    SEM_INITIALIZER(0),
+    SEM_INITIALIZER(0),
+    CONFIG_SCHED_HPNTHREADS + CONFIG_SCHED_HPNSPARES,
+    false,
+    CONFIG_SCHED_HPNSPARES,
+    SEM_INITIALIZER(0),
+  },
 };
 
 #endif /* CONFIG_SCHED_HPWORK */
@@ -99,15 +111,100 @@ struct lp_wqueue_s g_lpwork =
   {NULL, NULL},
   SEM_INITIALIZER(0),
   SEM_INITIALIZER(0),
-  CONFIG_SCHED_LPNTHREADS,
+  CONFIG_SCHED_LPNTHREADS + CONFIG_SCHED_LPNSPARES,
+  false,
+  CONFIG_SCHED_LPNSPARES,
+  SEM_INITIALIZER(0),
 };
 
 #endif /* CONFIG_SCHED_LPWORK */
 
+#if defined(CONFIG_SCHED_WORKQUEUE_STATS) && \
+    CONFIG_SCHED_WORKQUEUE_NFUNCS > 0
+/* The statistics of the worker functions */
+
+struct kwork_fstats_s g_work_fstats[CONFIG_SCHED_WORKQUEUE_NFUNCS];
+uint32_t g_work_fdropped;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_account
+ *
+ * Description:
+ *   Account one work that was performed to the statistics of its queue and
+ *   of its worker function.  The functions are found by open addressing on
+ *   their address, the table is never emptied.  Called in the critical
+ *   section.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue that performed the work
+ *   worker - The worker function
+ *   wait   - The time the work waited in the queue
+ *   run    - The time the work ran
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+static void work_account(FAR struct kwork_wqueue_s *wqueue,
+                         worker_t worker, clock_t wait, clock_t run)
+{
+#if CONFIG_SCHED_WORKQUEUE_NFUNCS > 0
+  FAR struct kwork_fstats_s *fstats;
+  unsigned int index;
+  unsigned int i;
+#endif
+
+  wqueue->stats.count++;
+  wqueue->stats.waitsum += wait;
+  if (wait > wqueue->stats.waitmax)
+    {
+      wqueue->stats.waitmax = wait;
+    }
+
+  if (run > wqueue->stats.runmax)
+    {
+      wqueue->stats.runmax = run;
+    }
+
+#if CONFIG_SCHED_WORKQUEUE_NFUNCS > 0
+  index = ((uintptr_t)worker >> 2) % CONFIG_SCHED_WORKQUEUE_NFUNCS;
+  for (i = 0; i < CONFIG_SCHED_WORKQUEUE_NFUNCS; i++)
+    {
+      fstats = &g_work_fstats[index];
+      if (fstats->worker == worker || fstats->worker == NULL)
+        {
+          fstats->worker = worker;
+          fstats->count++;
+          fstats->waitsum += wait;
+          fstats->runsum  += run;
+          if (wait > fstats->waitmax)
+            {
+              fstats->waitmax = wait;
+            }
+
+          if (run > fstats->runmax)
+            {
+              fstats->runmax = run;
+            }
+
+          return;
+        }
+
+      if (++index >= CONFIG_SCHED_WORKQUEUE_NFUNCS)
+        {
+          index = 0;
+        }
+    }
+
+  g_work_fdropped++;
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: work_thread
  *
@@ -135,10 +232,18 @@ static int work_thread(int argc, FAR char *argv[])
   FAR struct kwork_wqueue_s *wqueue;
   FAR struct kworker_s *kworker;
   FAR struct work_s *work;
+  FAR sem_t *sem;
   worker_t worker;
   irqstate_t flags;
   FAR void *arg;
   int semcount;
+#ifdef WORKER_TIMING
+  clock_t start;
+  clock_t elapsed;
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  clock_t wait;
+#endif
 
   /* Get the handle from argv */
 
@@ -147,6 +252,17 @@ static int work_thread(int argc, FAR char *argv[])
   kworker = (FAR struct kworker_s *)
             ((uintptr_t)strtoul(argv[2], NULL, 16));
 
+  /* The spare workers are only woken when all the others are blocked */
+
+  if (kworker - wqueue->worker >= wqueue->nthreads - wqueue->nspares)
+    {
+      sem = &wqueue->spare;
+    }
+  else
+    {
+      sem = &wqueue->sem;
+    }
+
   flags = enter_critical_section();
 
   /* Loop forever */
@@ -162,6 +278,10 @@ static int work_thread(int argc, FAR char *argv[])
 
       while ((work = (FAR struct work_s *)dq_remfirst(&wqueue->q)) != NULL)
         {
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+          wqueue->stats.depth--;
+#endif
+
           if (work->worker == NULL)
             {
               continue;
@@ -185,14 +305,29 @@ static int work_thread(int argc, FAR char *argv[])
 
           kworker->work = work;
 
+#ifdef WORKER_TIMING
+          start = perf_gettime();
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+          wait  = start - work->stime;
+#endif
+
           /* Do the work.  Re-enable interrupts while the work is being
            * performed... we don't have any idea how long this will take!
            */
 
           leave_critical_section(flags);
-          CALL_WORKER(worker, arg);
+          worker(arg);
+#ifdef WORKER_TIMING
+          elapsed = perf_gettime() - start;
+          CHECK_WORKER(worker, elapsed);
+#endif
           flags = enter_critical_section();
 
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+          work_account(wqueue, worker, wait, elapsed);
+#endif
+
           /* Mark the thread un-busy */
 
           kworker->work = NULL;
@@ -211,7 +346,7 @@ static int work_thread(int argc, FAR char *argv[])
        * posted.
        */
 
-      nxsem_wait_uninterruptible(&wqueue->sem);
+      nxsem_wait_uninterruptible(sem);
     }
 
   leave_critical_section(flags);
@@ -233,6 +368,7 @@ static int work_thread(int argc, FAR char *argv[])
  *   stack_addr - Stack buffer of the new task
  *   stack_size - size (in bytes) of the stack needed
  *   wqueue     - Work queue instance
+ *   cpu        - The CPU that runs the threads, -1 for any CPU
  *
  * Returned Value:
  *   A negated errno value is returned on failure.
@@ -241,8 +377,11 @@ static int work_thread(int argc, FAR char *argv[])
 
 static int work_thread_create(FAR const char *name, int priority,
                               FAR void *stack_addr, int stack_size,
-                              FAR struct kwork_wqueue_s *wqueue)
+                              FAR struct kwork_wqueue_s *wqueue, int cpu)
 {
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+#endif
   FAR char *argv[3];
   char arg0[32];
   char arg1[32];
@@ -277,6 +416,15 @@ static int work_thread_create(FAR const char *name, int priority,
         }
 
       wqueue->worker[wndx].pid = pid;
+
+#ifdef CONFIG_SMP
+      if (cpu >= 0)
+        {
+          CPU_ZERO(&cpuset);
+          CPU_SET(cpu, &cpuset);
+          nxsched_set_affinity(pid, sizeof(cpu_set_t), &cpuset);
+        }
+#endif
     }
 
   sched_unlock();
@@ -336,11 +484,13 @@ FAR struct kwork_wqueue_s *work_queue_create(FAR const char *name,
   dq_init(&wqueue->q);
   nxsem_init(&wqueue->sem, 0, 0);
   nxsem_init(&wqueue->exsem, 0, 0);
+  nxsem_init(&wqueue->spare, 0, 0);
   wqueue->nthreads = nthreads;
 
   /* Create the work queue thread pool */
 
-  ret = work_thread_create(name, priority, stack_addr, stack_size, wqueue);
+  ret = work_thread_create(name, priority, stack_addr, stack_size, wqueue,
+                           -1);
   if (ret < 0)
     {
       kmm_free(wqueue);
@@ -383,7 +533,14 @@ int work_queue_free(FAR struct kwork_wqueue_s *wqueue)
 
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
     {
-      nxsem_post(&wqueue->sem);
+      if (wndx >= wqueue->nthreads - wqueue->nspares)
+        {
+          nxsem_post(&wqueue->spare);
+        }
+      else
+        {
+          nxsem_post(&wqueue->sem);
+        }
     }
 
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
@@ -393,6 +550,7 @@ int work_queue_free(FAR struct kwork_wqueue_s *wqueue)
 
   nxsem_destroy(&wqueue->sem);
   nxsem_destroy(&wqueue->exsem);
+  nxsem_destroy(&wqueue->spare);
   kmm_free(wqueue);
 
   return OK;
@@ -456,13 +614,42 @@ int work_queue_priority(int qid)
 #ifdef CONFIG_SCHED_HPWORK
 int work_start_highpri(void)
 {
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  char name[16];
+  int ret;
+  int cpu;
+
+  /* Start the high-priority, kernel mode worker thread(s) of each CPU */
+
+  sinfo("Starting high-priority kernel worker thread(s)\n");
+
+  for (cpu = 0; cpu < HPWORK_NQUEUES; cpu++)
+    {
+      g_hpwork[cpu].nthreads = CONFIG_SCHED_HPNTHREADS +
+                               CONFIG_SCHED_HPNSPARES;
+      g_hpwork[cpu].nspares  = CONFIG_SCHED_HPNSPARES;
+
+      snprintf(name, sizeof(name), HPWORKNAME "%d", cpu);
+      ret = work_thread_create(name, CONFIG_SCHED_HPWORKPRIORITY, NULL,
+                               CONFIG_SCHED_HPWORKSTACKSIZE,
+                               (FAR struct kwork_wqueue_s *)&g_hpwork[cpu],
+                               cpu);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+#else
   /* Start the high-priority, kernel mode worker thread(s) */
 
   sinfo("Starting high-priority kernel worker thread(s)\n");
 
   return work_thread_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY, NULL,
                             CONFIG_SCHED_HPWORKSTACKSIZE,
-                            (FAR struct kwork_wqueue_s *)&g_hpwork);
+                            (FAR struct kwork_wqueue_s *)&g_hpwork[0], -1);
+#endif
 }
 #endif /* CONFIG_SCHED_HPWORK */
 
@@ -490,7 +677,7 @@ int work_start_lowpri(void)
 
   return work_thread_create(LPWORKNAME, CONFIG_SCHED_LPWORKPRIORITY, NULL,
                             CONFIG_SCHED_LPWORKSTACKSIZE,
-                            (FAR struct kwork_wqueue_s *)&g_lpwork);
+                            (FAR struct kwork_wqueue_s *)&g_lpwork, -1);
 }
 #endif /* CONFIG_SCHED_LPWORK */
 
@@ -34,6 +34,7 @@
 
 #include <nuttx/clock.h>
 #include <nuttx/queue.h>
+#include <nuttx/sched.h>
 #include <nuttx/wqueue.h>
 
 #ifdef CONFIG_SCHED_WORKQUEUE
@@ -47,6 +48,27 @@
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
 
+#ifndef CONFIG_SCHED_HPNSPARES
+#  define CONFIG_SCHED_HPNSPARES 0
+#endif
+
+#ifndef CONFIG_SCHED_LPNSPARES
+#  define CONFIG_SCHED_LPNSPARES 0
+#endif
+
+#if defined(CONFIG_SCHED_WORKQUEUE_STATS) && \
+    !defined(CONFIG_SCHED_WORKQUEUE_NFUNCS)
+#  define CONFIG_SCHED_WORKQUEUE_NFUNCS 0
+#endif
+
+/* The number of high priority work queues */
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+#  define HPWORK_NQUEUES CONFIG_SMP_NCPUS
+#else
+#  define HPWORK_NQUEUES 1
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -60,15 +82,48 @@ struct kworker_s
   sem_t             wait;      /* Sync waiting for worker done */
 };
 
-/* This structure defines the state of one kernel-mode work queue */
+/* The statistics of one work queue, the times in perf_gettime() units */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+struct kwork_stats_s
+{
+  uint32_t          count;     /* Number of work performed */
+  uint64_t          waitsum;   /* Sum of the times work waited to run */
+  clock_t           waitmax;   /* Longest time work waited to run */
+  clock_t           runmax;    /* Longest time work ran */
+  uint16_t          depth;     /* Number of work in the queue */
+  uint16_t          depthmax;  /* Most work in the queue at one time */
+};
+
+/* The statistics of one worker function over all the work queues */
+
+struct kwork_fstats_s
+{
+  worker_t          worker;    /* The worker function, NULL if unused */
+  uint32_t          count;     /* Number of times the function ran */
+  uint64_t          waitsum;   /* Sum of the times it waited to run */
+  uint64_t          runsum;    /* Sum of the times it ran */
+  clock_t           waitmax;   /* Longest time it waited to run */
+  clock_t           runmax;    /* Longest time it ran */
+};
+#endif
+
+/* This structure defines the state of one kernel-mode work queue.  The
+ * last nspares workers are spares that only wait on the spare semaphore.
+ */
 
 struct kwork_wqueue_s
 {
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
   sem_t             exsem;     /* Sync waiting for thread exit */
-  uint8_t           nthreads;  /* Number of worker threads */
+  uint8_t           nthreads;  /* Number of worker threads, with spares */
   bool              exit;      /* A flag to request the thread to exit */
+  uint8_t           nspares;   /* Number of spare worker threads */
+  sem_t             spare;     /* The semaphore of the spare workers */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  struct kwork_stats_s stats;  /* The statistics of the wqueue */
+#endif
   struct kworker_s  worker[0]; /* Describes a worker thread */
 };
 
@@ -82,12 +137,18 @@ struct hp_wqueue_s
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
   sem_t             exsem;     /* Sync waiting for thread exit */
-  uint8_t           nthreads;  /* Number of worker threads */
+  uint8_t           nthreads;  /* Number of worker threads, with spares */
   bool              exit;      /* A flag to request the thread to exit */
+  uint8_t           nspares;   /* Number of spare worker threads */
+  sem_t             spare;     /* The semaphore of the spare workers */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  struct kwork_stats_s stats;  /* The statistics of the wqueue */
+#endif
 
   /* Describes each thread in the high priority queue's thread pool */
 
-  struct kworker_s  worker[CONFIG_SCHED_HPNTHREADS];
+  struct kworker_s  worker[CONFIG_SCHED_HPNTHREADS +
+                           CONFIG_SCHED_HPNSPARES];
 };
 #endif
 
@@ -101,12 +162,18 @@ struct lp_wqueue_s
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
   sem_t             exsem;     /* Sync waiting for thread exit */
-  uint8_t           nthreads;  /* Number of worker threads */
+  uint8_t           nthreads;  /* Number of worker threads, with spares */
   bool              exit;      /* A flag to request the thread to exit */
+  uint8_t           nspares;   /* Number of spare worker threads */
+  sem_t             spare;     /* The semaphore of the spare workers */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  struct kwork_stats_s stats;  /* The statistics of the wqueue */
+#endif
 
   /* Describes each thread in the low priority queue's thread pool */
 
-  struct kworker_s  worker[CONFIG_SCHED_LPNTHREADS];
+  struct kworker_s  worker[CONFIG_SCHED_LPNTHREADS +
+                           CONFIG_SCHED_LPNSPARES];
 };
 #endif
 
@@ -115,9 +182,11 @@ struct lp_wqueue_s
  ****************************************************************************/
 
 #ifdef CONFIG_SCHED_HPWORK
-/* The state of the kernel mode, high priority work queue. */
+/* The state of the kernel mode, high priority work queue(s), one per CPU
+ * with CONFIG_SCHED_HPWORK_PERCPU.
+ */
 
-extern struct hp_wqueue_s g_hpwork;
+extern struct hp_wqueue_s g_hpwork[HPWORK_NQUEUES];
 #endif
 
 #ifdef CONFIG_SCHED_LPWORK
@@ -126,6 +195,16 @@ extern struct hp_wqueue_s g_hpwork;
 extern struct lp_wqueue_s g_lpwork;
 #endif
 
+#if defined(CONFIG_SCHED_WORKQUEUE_STATS) && \
+    CONFIG_SCHED_WORKQUEUE_NFUNCS > 0
+/* The statistics of the worker functions, hashed by their address, and the
+ * number of work whose function did not fit in the table.
+ */
+
+extern struct kwork_fstats_s g_work_fstats[CONFIG_SCHED_WORKQUEUE_NFUNCS];
+extern uint32_t g_work_fdropped;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -135,7 +214,11 @@ static inline_function FAR struct kwork_wqueue_s *work_qid2wq(int qid)
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
-      return (FAR struct kwork_wqueue_s *)&g_hpwork;
+#  ifdef CONFIG_SCHED_HPWORK_PERCPU
+      return (FAR struct kwork_wqueue_s *)&g_hpwork[this_cpu()];
+#  else
+      return (FAR struct kwork_wqueue_s *)&g_hpwork[0];
+#  endif
     }
   else
 #endif
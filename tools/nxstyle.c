@@ -350,6 +350,7 @@ static const char *g_white_content_list[] =
   "RMDIR3args",
   "RMDIR3resok",
   "READDIR3args",
+  "READDIRPLUS3args",
   "READDIR3resok",
   "SETATTR3args",
   "SETATTR3resok",
@@ -617,6 +618,14 @@ static const char *g_white_content_list[] =
   "unzGetCurrentFileInfo64",
   "unzGoToNextFile",
   "unzGoToFirstFile",
+  "unzOpenCurrentFile2",
+  "unzGetCurrentFileZStreamPos64",
+  "inflateInit2",
+  "inflateReset",
+  "inflatePrime",
+  "inflateSetDictionary",
+  "inflateGetDictionary",
+  "uInt",
   NULL
 };
 